@@ -0,0 +1,128 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/allocation_sites.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace pw::allocator {
+namespace {
+
+uint32_t ClampU32(size_t size) {
+  return static_cast<uint32_t>(std::min(
+      size, static_cast<size_t>(std::numeric_limits<uint32_t>::max())));
+}
+
+}  // namespace
+
+AllocationSite::AllocationSite(uint32_t key)
+    : key_(key), group_(key & _PW_METRIC_TOKEN_MASK) {}
+
+void AllocationSite::RecordAllocation(size_t requested) {
+  num_allocations_.Increment();
+  RecordResize(0, requested);
+}
+
+void AllocationSite::RecordResize(size_t old_requested, size_t new_requested) {
+  requested_bytes_.Decrement(ClampU32(old_requested));
+  requested_bytes_.Increment(ClampU32(new_requested));
+  if (peak_requested_bytes_.value() < requested_bytes_.value()) {
+    peak_requested_bytes_.Set(requested_bytes_.value());
+  }
+  if (new_requested > old_requested) {
+    cumulative_requested_bytes_.Increment(
+        ClampU32(new_requested - old_requested));
+  }
+}
+
+void AllocationSite::RecordDeallocation(size_t requested, uint32_t lifetime) {
+  requested_bytes_.Decrement(ClampU32(requested));
+  lifetimes_.Record(lifetime);
+}
+
+AllocationSiteTracker::AllocationSiteTracker(
+    metric::Token token,
+    span<std::optional<AllocationSite>> sites,
+    span<LiveAllocation> live)
+    : group_(token), sites_(sites), live_(live) {}
+
+const AllocationSite* AllocationSiteTracker::Find(uint32_t key) const {
+  for (size_t i = 0; i < num_sites_; ++i) {
+    if (sites_[i]->key() == key) {
+      return &(*sites_[i]);
+    }
+  }
+  return nullptr;
+}
+
+AllocationSite* AllocationSiteTracker::FindOrAddSite(uint32_t key) {
+  if (const AllocationSite* site = Find(key); site != nullptr) {
+    return const_cast<AllocationSite*>(site);
+  }
+  if (num_sites_ == sites_.size()) {
+    return nullptr;
+  }
+  AllocationSite& site = sites_[num_sites_++].emplace(key);
+  group_.Add(site.metric_group());
+  return &site;
+}
+
+AllocationSiteTracker::LiveAllocation* AllocationSiteTracker::FindLive(
+    const void* ptr) {
+  for (size_t i = 0; i < num_live_; ++i) {
+    if (live_[i].ptr == ptr) {
+      return &live_[i];
+    }
+  }
+  return nullptr;
+}
+
+void AllocationSiteTracker::RecordAllocation(uint32_t key,
+                                             const void* ptr,
+                                             size_t requested) {
+  ++clock_;
+  AllocationSite* site = num_live_ < live_.size() ? FindOrAddSite(key)
+                                                  : nullptr;
+  if (site == nullptr) {
+    num_untracked_.Increment();
+    return;
+  }
+  live_[num_live_++] = LiveAllocation{ptr, site, clock_};
+  site->RecordAllocation(requested);
+}
+
+void AllocationSiteTracker::RecordReallocation(const void* old_ptr,
+                                               const void* new_ptr,
+                                               size_t old_requested,
+                                               size_t new_requested) {
+  LiveAllocation* live = FindLive(old_ptr);
+  if (live == nullptr) {
+    return;
+  }
+  live->ptr = new_ptr;
+  live->site->RecordResize(old_requested, new_requested);
+}
+
+void AllocationSiteTracker::RecordDeallocation(const void* ptr,
+                                               size_t requested) {
+  LiveAllocation* live = FindLive(ptr);
+  if (live == nullptr) {
+    return;
+  }
+  live->site->RecordDeallocation(requested, clock_ - live->allocated_at);
+  *live = live_[--num_live_];
+}
+
+}  // namespace pw::allocator
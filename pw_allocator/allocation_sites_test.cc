@@ -0,0 +1,183 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/allocation_sites.h"
+
+#include <array>
+#include <cstdint>
+
+#include "pw_allocator/testing.h"
+#include "pw_allocator/tracking_allocator.h"
+#include "pw_metric/metric.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using ::pw::allocator::AllocationSite;
+using ::pw::allocator::AllocationSites;
+using ::pw::allocator::AllocationSiteTracker;
+using ::pw::allocator::Layout;
+using ::pw::allocator::NoMetrics;
+using ::pw::allocator::TrackingAllocator;
+using ::pw::allocator::test::AllocatorForTest;
+
+constexpr pw::metric::Token kAllocatorToken = 1U;
+constexpr pw::metric::Token kSitesToken = 2U;
+constexpr uint32_t kSiteA = 0x100;
+constexpr uint32_t kSiteB = 0x200;
+
+class AllocationSitesTest : public ::testing::Test {
+ protected:
+  AllocationSitesTest()
+      : tracker_(kAllocatorToken, allocator_), sites_(kSitesToken) {
+    tracker_.TrackAllocationSites(sites_);
+  }
+
+  AllocatorForTest<1024> allocator_;
+  TrackingAllocator<NoMetrics> tracker_;
+  AllocationSites<4, 4> sites_;
+};
+
+TEST_F(AllocationSitesTest, AddsMetricGroupToAllocator) {
+  auto& children = tracker_.metric_group().children();
+  ASSERT_EQ(children.size(), 1U);
+  EXPECT_EQ(&children.front(), &sites_.metric_group());
+}
+
+TEST_F(AllocationSitesTest, AttributesAllocationsToReturnAddress) {
+  std::array<void*, 3> ptrs;
+  for (void*& ptr : ptrs) {
+    ptr = tracker_.Allocate(Layout(16, 1));
+    ASSERT_NE(ptr, nullptr);
+  }
+  EXPECT_EQ(sites_.num_sites(), 1U);
+  auto& children = sites_.metric_group().children();
+  ASSERT_EQ(children.size(), 1U);
+  const AllocationSite* site = sites_.Find(children.front().name());
+  ASSERT_NE(site, nullptr);
+  EXPECT_EQ(site->num_allocations(), 3U);
+  EXPECT_EQ(site->requested_bytes(), 48U);
+
+  for (void* ptr : ptrs) {
+    tracker_.Deallocate(ptr);
+  }
+  EXPECT_EQ(site->requested_bytes(), 0U);
+}
+
+TEST_F(AllocationSitesTest, AttributesAllocationsToScopedSite) {
+  void* ptr1;
+  void* ptr2;
+  void* ptr3;
+  {
+    AllocationSiteTracker::ScopedSite scope(sites_, kSiteA);
+    ptr1 = tracker_.Allocate(Layout(16, 1));
+    {
+      AllocationSiteTracker::ScopedSite nested(sites_, kSiteB);
+      ptr2 = tracker_.Allocate(Layout(32, 1));
+    }
+    ptr3 = tracker_.Allocate(Layout(8, 1));
+  }
+  EXPECT_EQ(sites_.current_site(), 0U);
+
+  const AllocationSite* site_a = sites_.Find(kSiteA);
+  ASSERT_NE(site_a, nullptr);
+  EXPECT_EQ(site_a->num_allocations(), 2U);
+  EXPECT_EQ(site_a->requested_bytes(), 24U);
+  EXPECT_EQ(site_a->peak_requested_bytes(), 24U);
+
+  const AllocationSite* site_b = sites_.Find(kSiteB);
+  ASSERT_NE(site_b, nullptr);
+  EXPECT_EQ(site_b->num_allocations(), 1U);
+  EXPECT_EQ(site_b->requested_bytes(), 32U);
+
+  tracker_.Deallocate(ptr1);
+  tracker_.Deallocate(ptr2);
+  tracker_.Deallocate(ptr3);
+  EXPECT_EQ(site_a->requested_bytes(), 0U);
+  EXPECT_EQ(site_a->peak_requested_bytes(), 24U);
+  EXPECT_EQ(site_a->cumulative_requested_bytes(), 24U);
+  EXPECT_EQ(site_b->requested_bytes(), 0U);
+}
+
+TEST_F(AllocationSitesTest, RecordsLifetimes) {
+  AllocationSiteTracker::ScopedSite scope(sites_, kSiteA);
+  void* ptr1 = tracker_.Allocate(Layout(16, 1));
+  void* ptr2 = tracker_.Allocate(Layout(16, 1));
+  void* ptr3 = tracker_.Allocate(Layout(16, 1));
+
+  // Two allocations were made while `ptr1` was live, and none after `ptr3`.
+  tracker_.Deallocate(ptr1);
+  tracker_.Deallocate(ptr3);
+  tracker_.Deallocate(ptr2);
+
+  const AllocationSite* site = sites_.Find(kSiteA);
+  ASSERT_NE(site, nullptr);
+  const auto& lifetimes = site->lifetimes();
+  EXPECT_EQ(lifetimes.count(lifetimes.BucketIndex(0)), 1U);
+  EXPECT_EQ(lifetimes.count(lifetimes.BucketIndex(1)), 1U);
+  EXPECT_EQ(lifetimes.count(lifetimes.BucketIndex(2)), 1U);
+}
+
+TEST_F(AllocationSitesTest, TracksResizeAndReallocate) {
+  AllocationSiteTracker::ScopedSite scope(sites_, kSiteA);
+  void* ptr = tracker_.Allocate(Layout(16, 1));
+  ASSERT_NE(ptr, nullptr);
+  ASSERT_TRUE(tracker_.Resize(ptr, 8));
+
+  const AllocationSite* site = sites_.Find(kSiteA);
+  ASSERT_NE(site, nullptr);
+  EXPECT_EQ(site->requested_bytes(), 8U);
+
+  void* blocker = tracker_.Allocate(Layout(16, 1));
+  ASSERT_NE(blocker, nullptr);
+  void* new_ptr = tracker_.Reallocate(ptr, Layout(64, 1));
+  ASSERT_NE(new_ptr, nullptr);
+  EXPECT_EQ(site->requested_bytes(), 80U);
+  EXPECT_EQ(site->peak_requested_bytes(), 80U);
+  EXPECT_EQ(site->cumulative_requested_bytes(), 88U);
+
+  tracker_.Deallocate(new_ptr);
+  tracker_.Deallocate(blocker);
+  EXPECT_EQ(site->requested_bytes(), 0U);
+  EXPECT_EQ(site->num_allocations(), 2U);
+}
+
+TEST_F(AllocationSitesTest, CountsUntrackedAllocations) {
+  std::array<void*, 6> ptrs;
+  for (size_t i = 0; i < ptrs.size(); ++i) {
+    AllocationSiteTracker::ScopedSite scope(sites_, kSiteA + i);
+    ptrs[i] = tracker_.Allocate(Layout(8, 1));
+    ASSERT_NE(ptrs[i], nullptr);
+  }
+  EXPECT_EQ(sites_.num_sites(), 4U);
+  EXPECT_EQ(sites_.num_untracked(), 2U);
+  for (void* ptr : ptrs) {
+    tracker_.Deallocate(ptr);
+  }
+
+  // Freeing live allocations makes room, but the site table is still full.
+  {
+    AllocationSiteTracker::ScopedSite scope(sites_, kSiteA);
+    ptrs[0] = tracker_.Allocate(Layout(8, 1));
+  }
+  {
+    AllocationSiteTracker::ScopedSite scope(sites_, kSiteB);
+    ptrs[1] = tracker_.Allocate(Layout(8, 1));
+  }
+  EXPECT_EQ(sites_.num_untracked(), 3U);
+  tracker_.Deallocate(ptrs[0]);
+  tracker_.Deallocate(ptrs[1]);
+}
+
+}  // namespace
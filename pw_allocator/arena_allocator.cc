@@ -0,0 +1,96 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/arena_allocator.h"
+
+#include <algorithm>
+#include <limits>
+#include <new>
+
+#include "pw_allocator/buffer.h"
+#include "pw_bytes/alignment.h"
+
+namespace pw::allocator {
+
+void ArenaAllocator::Init(ByteSpan region) {
+  Reset();
+  region_ = region;
+  next_ = region_.data();
+}
+
+void ArenaAllocator::Release(const Marker& marker) {
+  // Destroy owned objects before the memory they occupy is freed.
+  while (owned_ != marker.owned_) {
+    internal::GenericOwned* owned = owned_;
+    owned_ = owned->next();
+    owned->Destroy();
+  }
+  while (chunk_ != marker.chunk_) {
+    Chunk* chunk = chunk_;
+    chunk_ = chunk->prev;
+    parent_->Deallocate(chunk);
+  }
+  next_ = marker.next_;
+}
+
+void* ArenaAllocator::DoAllocate(Layout layout) {
+  void* ptr = AllocateFromCurrent(layout);
+  if (ptr == nullptr && AddChunk(layout)) {
+    ptr = AllocateFromCurrent(layout);
+  }
+  return ptr;
+}
+
+void ArenaAllocator::DoDeallocate(void*) {}
+
+void* ArenaAllocator::AllocateFromCurrent(Layout layout) {
+  if (next_ == nullptr) {
+    return nullptr;
+  }
+  ByteSpan remaining(next_, static_cast<size_t>(limit() - next_));
+  ByteSpan region = GetAlignedSubspan(remaining, layout.alignment());
+  if (region.size() < layout.size()) {
+    return nullptr;
+  }
+  next_ = region.data() + layout.size();
+  return region.data();
+}
+
+bool ArenaAllocator::AddChunk(Layout layout) {
+  if (parent_ == nullptr) {
+    return false;
+  }
+  // Reserve enough space to align the allocation after the header.
+  size_t overhead = sizeof(Chunk) + layout.alignment();
+  if (layout.size() > std::numeric_limits<size_t>::max() - overhead) {
+    return false;
+  }
+  size_t size = std::max(chunk_size_, layout.size() + overhead);
+  void* ptr = parent_->Allocate(Layout(size, alignof(Chunk)));
+  if (ptr == nullptr) {
+    return false;
+  }
+  chunk_ = new (ptr) Chunk{chunk_, size};
+  next_ = reinterpret_cast<std::byte*>(chunk_ + 1);
+  return true;
+}
+
+std::byte* ArenaAllocator::limit() const {
+  if (chunk_ == nullptr) {
+    return region_.data() + region_.size();
+  }
+  return reinterpret_cast<std::byte*>(chunk_) + chunk_->size;
+}
+
+}  // namespace pw::allocator
@@ -0,0 +1,216 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/arena_allocator.h"
+
+#include <array>
+#include <cstdint>
+
+#include "pw_allocator/testing.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::ArenaAllocator;
+using ::pw::allocator::Layout;
+using AllocatorForTest = ::pw::allocator::test::AllocatorForTest<1024>;
+
+class DestroyCounter final {
+ public:
+  DestroyCounter(size_t* counter) : counter_(counter) {}
+  ~DestroyCounter() { *counter_ += 1; }
+
+ private:
+  size_t* counter_;
+};
+
+// Unit tests.
+
+TEST(ArenaAllocatorTest, AllocateAligned) {
+  alignas(16) std::array<std::byte, 256> buffer;
+  ArenaAllocator allocator(buffer);
+  void* ptr = allocator.Allocate(Layout(1, 1));
+  ASSERT_NE(ptr, nullptr);
+  ptr = allocator.Allocate(Layout(8, 32));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 32, 0U);
+}
+
+TEST(ArenaAllocatorTest, AllocateFailsWhenExhaustedWithoutParent) {
+  alignas(16) std::array<std::byte, 256> buffer;
+  ArenaAllocator allocator(buffer);
+  EXPECT_NE(allocator.Allocate(Layout(256, 16)), nullptr);
+  EXPECT_EQ(allocator.Allocate(Layout(1, 1)), nullptr);
+}
+
+TEST(ArenaAllocatorTest, DeallocateDoesNothing) {
+  alignas(16) std::array<std::byte, 256> buffer;
+  ArenaAllocator allocator(buffer);
+  void* ptr = allocator.Allocate(Layout(256, 16));
+  ASSERT_NE(ptr, nullptr);
+  allocator.Deallocate(ptr);
+  EXPECT_EQ(allocator.Allocate(Layout(1, 1)), nullptr);
+}
+
+TEST(ArenaAllocatorTest, ResetReclaimsRegion) {
+  alignas(16) std::array<std::byte, 256> buffer;
+  ArenaAllocator allocator(buffer);
+  void* ptr1 = allocator.Allocate(Layout(256, 16));
+  ASSERT_NE(ptr1, nullptr);
+  allocator.Reset();
+  void* ptr2 = allocator.Allocate(Layout(256, 16));
+  EXPECT_EQ(ptr1, ptr2);
+}
+
+TEST(ArenaAllocatorTest, ReleaseReclaimsMemoryAfterMarker) {
+  alignas(16) std::array<std::byte, 256> buffer;
+  ArenaAllocator allocator(buffer);
+  ASSERT_NE(allocator.Allocate(Layout(64, 16)), nullptr);
+  ArenaAllocator::Marker marker = allocator.Mark();
+  void* ptr1 = allocator.Allocate(Layout(64, 16));
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(allocator.Allocate(Layout(128, 16)), nullptr);
+  EXPECT_EQ(allocator.Allocate(Layout(1, 1)), nullptr);
+
+  allocator.Release(marker);
+  void* ptr2 = allocator.Allocate(Layout(64, 16));
+  EXPECT_EQ(ptr1, ptr2);
+}
+
+TEST(ArenaAllocatorTest, NestedScopes) {
+  alignas(16) std::array<std::byte, 256> buffer;
+  ArenaAllocator allocator(buffer);
+  void* outer = nullptr;
+  void* inner = nullptr;
+  {
+    ArenaAllocator::Scope outer_scope(allocator);
+    outer = allocator.Allocate(Layout(64, 16));
+    ASSERT_NE(outer, nullptr);
+    {
+      ArenaAllocator::Scope inner_scope(allocator);
+      inner = allocator.Allocate(Layout(64, 16));
+      ASSERT_NE(inner, nullptr);
+    }
+    EXPECT_EQ(allocator.Allocate(Layout(64, 16)), inner);
+  }
+  EXPECT_EQ(allocator.Allocate(Layout(64, 16)), outer);
+}
+
+TEST(ArenaAllocatorTest, GrowsFromParent) {
+  AllocatorForTest parent;
+  alignas(16) std::array<std::byte, 64> buffer;
+  ArenaAllocator allocator(buffer, parent, 256);
+  void* ptr1 = allocator.Allocate(Layout(64, 16));
+  ASSERT_NE(ptr1, nullptr);
+  EXPECT_EQ(parent.metrics().num_allocations.value(), 0U);
+
+  void* ptr2 = allocator.Allocate(Layout(64, 16));
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr2) % 16, 0U);
+  EXPECT_EQ(parent.metrics().num_allocations.value(), 1U);
+
+  // The chunk is shared by later allocations.
+  ASSERT_NE(allocator.Allocate(Layout(64, 16)), nullptr);
+  EXPECT_EQ(parent.metrics().num_allocations.value(), 1U);
+}
+
+TEST(ArenaAllocatorTest, GrowsFromParentForLargeRequests) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, 64);
+  void* ptr = allocator.Allocate(Layout(256, 32));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 32, 0U);
+  EXPECT_EQ(parent.metrics().num_allocations.value(), 1U);
+}
+
+TEST(ArenaAllocatorTest, AllocateFailsWhenParentIsExhausted) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, 64);
+  EXPECT_EQ(allocator.Allocate(Layout(2048, 16)), nullptr);
+}
+
+TEST(ArenaAllocatorTest, ReleaseReturnsChunksToParent) {
+  AllocatorForTest parent;
+  ArenaAllocator allocator(parent, 128);
+  ASSERT_NE(allocator.Allocate(Layout(64, 16)), nullptr);
+  EXPECT_EQ(parent.metrics().num_allocations.value(), 1U);
+  {
+    ArenaAllocator::Scope scope(allocator);
+    ASSERT_NE(allocator.Allocate(Layout(128, 16)), nullptr);
+    ASSERT_NE(allocator.Allocate(Layout(128, 16)), nullptr);
+    EXPECT_EQ(parent.metrics().num_allocations.value(), 3U);
+  }
+  EXPECT_EQ(parent.metrics().num_deallocations.value(), 2U);
+
+  allocator.Reset();
+  EXPECT_EQ(parent.metrics().num_deallocations.value(), 3U);
+  EXPECT_EQ(parent.metrics().allocated_bytes.value(), 0U);
+}
+
+TEST(ArenaAllocatorTest, DestructorReturnsChunksToParent) {
+  AllocatorForTest parent;
+  {
+    ArenaAllocator allocator(parent, 128);
+    ASSERT_NE(allocator.Allocate(Layout(64, 16)), nullptr);
+    ASSERT_NE(allocator.Allocate(Layout(256, 16)), nullptr);
+  }
+  EXPECT_EQ(parent.metrics().num_deallocations.value(), 2U);
+  EXPECT_EQ(parent.metrics().allocated_bytes.value(), 0U);
+}
+
+TEST(ArenaAllocatorTest, NewDoesNotDestroy) {
+  alignas(16) std::array<std::byte, 256> buffer;
+  size_t counter = 0;
+  {
+    ArenaAllocator allocator(buffer);
+    DestroyCounter* dc1 = allocator.New<DestroyCounter>(&counter);
+    allocator.Delete(dc1);
+  }
+  EXPECT_EQ(counter, 0U);
+}
+
+TEST(ArenaAllocatorTest, ReleaseDestroysOwnedObjectsAfterMarker) {
+  alignas(16) std::array<std::byte, 256> buffer;
+  size_t outer = 0;
+  size_t inner = 0;
+  {
+    ArenaAllocator allocator(buffer);
+    allocator.NewOwned<DestroyCounter>(&outer);
+    {
+      ArenaAllocator::Scope scope(allocator);
+      allocator.NewOwned<DestroyCounter>(&inner);
+      allocator.NewOwned<DestroyCounter>(&inner);
+    }
+    EXPECT_EQ(inner, 2U);
+    EXPECT_EQ(outer, 0U);
+  }
+  EXPECT_EQ(outer, 1U);
+}
+
+TEST(ArenaAllocatorTest, MakeUniqueOwnedDestroysOnce) {
+  AllocatorForTest parent;
+  size_t counter = 0;
+  {
+    ArenaAllocator allocator(parent, 128);
+    auto ptr = allocator.MakeUniqueOwned<DestroyCounter>(&counter);
+    ASSERT_NE(ptr.get(), nullptr);
+    ptr.Reset();
+    EXPECT_EQ(counter, 0U);
+  }
+  EXPECT_EQ(counter, 1U);
+}
+
+}  // namespace
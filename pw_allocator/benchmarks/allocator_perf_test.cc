@@ -0,0 +1,133 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <optional>
+
+#include "benchmarks/benchmark.h"
+#include "benchmarks/traces.h"
+#include "pw_allocator/best_fit_block_allocator.h"
+#include "pw_allocator/bucket_block_allocator.h"
+#include "pw_allocator/buddy_allocator.h"
+#include "pw_allocator/bump_allocator.h"
+#include "pw_allocator/chunk_pool.h"
+#include "pw_allocator/dual_first_fit_block_allocator.h"
+#include "pw_allocator/first_fit_block_allocator.h"
+#include "pw_allocator/last_fit_block_allocator.h"
+#include "pw_allocator/slab_allocator.h"
+#include "pw_allocator/worst_fit_block_allocator.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_perf_test/state.h"
+
+namespace pw::allocator::benchmarks {
+namespace {
+
+constexpr size_t kRegionSize = 16384;
+
+// Allocations at least this large are placed at the end of the region by the
+// dual first-fit allocator.
+constexpr size_t kDualFirstFitThreshold = 128;
+
+class DualFirstFitAllocator : public DualFirstFitBlockAllocator<> {
+ public:
+  DualFirstFitAllocator() { set_threshold(kDualFirstFitThreshold); }
+};
+
+// Adapts a `ChunkPool` to the `Allocator` interface. Every request is served
+// by a chunk large enough for any request in the traces, as a pool of packet
+// buffers would be.
+class ChunkPoolAllocator : public Allocator {
+ public:
+  static constexpr Layout kChunkLayout =
+      Layout(kMaxRequestSize, alignof(void*));
+
+  ChunkPoolAllocator() : Allocator(Capabilities()) {}
+
+  void Init(ByteSpan region) { pool_.emplace(region, kChunkLayout); }
+
+ private:
+  void* DoAllocate(Layout layout) override {
+    if (layout.size() > kChunkLayout.size() ||
+        layout.alignment() > kChunkLayout.alignment()) {
+      return nullptr;
+    }
+    return pool_->Allocate();
+  }
+
+  void DoDeallocate(void* ptr) override { pool_->Deallocate(ptr); }
+
+  std::optional<ChunkPool> pool_;
+};
+
+using BuddyAllocatorType = BuddyAllocator<16, 7>;
+using SlabAllocatorType = SlabAllocator<2048, 32, 64, 128, 256, 512>;
+
+// Returns a trace of the given type. Only the most recently requested trace is
+// kept, to limit memory usage on devices.
+const Trace& GetTrace(TraceType type) {
+  static Trace trace;
+  static std::optional<TraceType> generated;
+  if (generated != type) {
+    GenerateTrace(type, trace);
+    generated = type;
+  }
+  return trace;
+}
+
+// Memory region shared by all benchmarks.
+alignas(std::max_align_t) std::array<std::byte, kRegionSize> region;
+
+template <typename AllocatorType>
+void MeasureAllocator(perf_test::State& state,
+                      const char* allocator_name,
+                      TraceType trace_type,
+                      Operation operation) {
+  AllocatorBenchmark<AllocatorType> benchmark(region);
+  benchmark.Measure(state, allocator_name, GetTrace(trace_type), operation);
+}
+
+// Defines a perf test for each combination of trace and operation.
+#define PW_ALLOCATOR_BENCHMARKS(name, AllocatorType)                      \
+  PW_ALLOCATOR_BENCHMARKS_FOR_TRACE(name, AllocatorType, RpcBurst);       \
+  PW_ALLOCATOR_BENCHMARKS_FOR_TRACE(name, AllocatorType, BleSteadyState); \
+  PW_ALLOCATOR_BENCHMARKS_FOR_TRACE(name, AllocatorType, LogChurn)
+
+#define PW_ALLOCATOR_BENCHMARKS_FOR_TRACE(name, AllocatorType, trace) \
+  PW_ALLOCATOR_BENCHMARK(name, AllocatorType, trace, Allocate);       \
+  PW_ALLOCATOR_BENCHMARK(name, AllocatorType, trace, Deallocate);     \
+  PW_ALLOCATOR_BENCHMARK(name, AllocatorType, trace, Resize)
+
+#define PW_ALLOCATOR_BENCHMARK(name, AllocatorType, trace, operation) \
+  PW_PERF_TEST(name##_##trace##_##operation,                          \
+               MeasureAllocator<AllocatorType>,                       \
+               #name,                                                 \
+               TraceType::k##trace,                                   \
+               Operation::k##operation)
+
+// DOCSTAG: [pw_allocator-benchmarks-allocators]
+PW_ALLOCATOR_BENCHMARKS(FirstFit, FirstFitBlockAllocator<>);
+PW_ALLOCATOR_BENCHMARKS(LastFit, LastFitBlockAllocator<>);
+PW_ALLOCATOR_BENCHMARKS(BestFit, BestFitBlockAllocator<>);
+PW_ALLOCATOR_BENCHMARKS(WorstFit, WorstFitBlockAllocator<>);
+PW_ALLOCATOR_BENCHMARKS(DualFirstFit, DualFirstFitAllocator);
+PW_ALLOCATOR_BENCHMARKS(BucketBlock, BucketBlockAllocator<>);
+PW_ALLOCATOR_BENCHMARKS(Buddy, BuddyAllocatorType);
+PW_ALLOCATOR_BENCHMARKS(Bump, BumpAllocator);
+PW_ALLOCATOR_BENCHMARKS(ChunkPool, ChunkPoolAllocator);
+PW_ALLOCATOR_BENCHMARKS(Slab, SlabAllocatorType);
+// DOCSTAG: [pw_allocator-benchmarks-allocators]
+
+}  // namespace
+}  // namespace pw::allocator::benchmarks
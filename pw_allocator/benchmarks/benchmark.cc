@@ -0,0 +1,188 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PW_ALLOCATOR"
+
+#include "benchmarks/benchmark.h"
+
+#include <cmath>
+#include <limits>
+#include <variant>
+
+#include "pw_assert/check.h"
+#include "pw_log/log.h"
+
+namespace pw::allocator::benchmarks {
+
+const char* OperationName(Operation operation) {
+  switch (operation) {
+    case Operation::kAllocate:
+      return "Allocate";
+    case Operation::kDeallocate:
+      return "Deallocate";
+    case Operation::kResize:
+      return "Resize";
+  }
+  return "Unknown";
+}
+
+void AllocatorBenchmarkGeneric::Measure(perf_test::State& state,
+                                        const char* allocator_name,
+                                        const Trace& trace,
+                                        Operation operation) {
+  PW_CHECK(!trace.empty());
+  if (operation == Operation::kAllocate) {
+    LogFragmentation(allocator_name, trace);
+  }
+  Reset();
+  next_ = 0;
+  num_failed_allocations_ = 0;
+  num_failed_resizes_ = 0;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    Perform(Advance(trace, operation), &state);
+  }
+  if (num_failed_allocations_ != 0 || num_failed_resizes_ != 0) {
+    PW_LOG_INFO("%s: %zu allocations failed, %zu resizes were not in place",
+                allocator_name,
+                num_failed_allocations_,
+                num_failed_resizes_);
+  }
+  Reset();
+}
+
+void AllocatorBenchmarkGeneric::Replay(const Trace& trace) {
+  if (allocator_ == nullptr) {
+    allocator_ = &Recreate();
+  }
+  for (const test::Request& request : trace) {
+    Perform(request, nullptr);
+  }
+}
+
+void AllocatorBenchmarkGeneric::Reset() {
+  FreeAll();
+  allocator_ = &Recreate();
+}
+
+void AllocatorBenchmarkGeneric::FreeAll() {
+  for (const Allocation& allocation : live_) {
+    allocator_->Deallocate(allocation.ptr);
+  }
+  live_.clear();
+}
+
+bool AllocatorBenchmarkGeneric::IsMeasurable(const test::Request& request,
+                                             Operation operation) const {
+  switch (operation) {
+    case Operation::kAllocate:
+      return std::holds_alternative<test::AllocationRequest>(request) &&
+             !live_.full();
+    case Operation::kDeallocate:
+      return std::holds_alternative<test::DeallocationRequest>(request) &&
+             !live_.empty();
+    case Operation::kResize:
+      return std::holds_alternative<test::ReallocationRequest>(request) &&
+             !live_.empty();
+  }
+  return false;
+}
+
+const test::Request& AllocatorBenchmarkGeneric::Advance(const Trace& trace,
+                                                        Operation operation) {
+  // Two passes are enough to find a request unless the trace has none of the
+  // measured kind.
+  for (size_t skipped = 0; skipped <= 2 * trace.size(); ++skipped) {
+    if (next_ == trace.size()) {
+      Reset();
+      next_ = 0;
+    }
+    const test::Request& request = trace[next_++];
+    if (IsMeasurable(request, operation)) {
+      return request;
+    }
+    Perform(request, nullptr);
+  }
+  PW_CRASH("Trace has no requests to measure for %s",
+           OperationName(operation));
+}
+
+void AllocatorBenchmarkGeneric::Perform(const test::Request& request,
+                                        perf_test::State* state) {
+  if (const auto* r = std::get_if<test::AllocationRequest>(&request)) {
+    if (live_.full()) {
+      return;
+    }
+    Layout layout(r->size, r->alignment);
+    if (state != nullptr) {
+      state->ResumeTiming();
+    }
+    void* ptr = allocator_->Allocate(layout);
+    if (ptr == nullptr) {
+      ++num_failed_allocations_;
+    } else {
+      live_.push_back({ptr, layout});
+    }
+
+  } else if (const auto* r = std::get_if<test::DeallocationRequest>(&request)) {
+    if (live_.empty()) {
+      return;
+    }
+    // Preserve the order of the remaining allocations, so that indices in the
+    // trace keep referring to the same allocations.
+    auto iter = live_.begin() + (r->index % live_.size());
+    void* ptr = iter->ptr;
+    live_.erase(iter);
+    if (state != nullptr) {
+      state->ResumeTiming();
+    }
+    allocator_->Deallocate(ptr);
+
+  } else if (const auto* r = std::get_if<test::ReallocationRequest>(&request)) {
+    if (live_.empty()) {
+      return;
+    }
+    Allocation& allocation = live_[r->index % live_.size()];
+    if (state != nullptr) {
+      state->ResumeTiming();
+    }
+    if (allocator_->Resize(allocation.ptr, r->new_size)) {
+      allocation.layout = Layout(r->new_size, allocation.layout.alignment());
+    } else {
+      ++num_failed_resizes_;
+    }
+  }
+}
+
+void AllocatorBenchmarkGeneric::LogFragmentation(const char* allocator_name,
+                                                 const Trace& trace) {
+  Reset();
+  Replay(trace);
+  std::optional<Fragmentation> fragmentation = MeasureFragmentation();
+  Reset();
+  if (!fragmentation.has_value() || fragmentation->sum == 0) {
+    return;
+  }
+  double sum_of_squares =
+      std::ldexp(static_cast<double>(fragmentation->sum_of_squares.hi),
+                 std::numeric_limits<size_t>::digits) +
+      static_cast<double>(fragmentation->sum_of_squares.lo);
+  double ratio = 1.0 - std::sqrt(sum_of_squares) /
+                           static_cast<double>(fragmentation->sum);
+  PW_LOG_INFO("%s: fragmentation after one pass is %u/1000",
+              allocator_name,
+              static_cast<unsigned>(ratio * 1000));
+}
+
+}  // namespace pw::allocator::benchmarks
@@ -0,0 +1,170 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "benchmarks/traces.h"
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/fragmentation.h"
+#include "pw_allocator/layout.h"
+#include "pw_bytes/span.h"
+#include "pw_containers/vector.h"
+#include "pw_perf_test/state.h"
+
+namespace pw::allocator::benchmarks {
+
+/// Allocator operations that can be measured.
+enum class Operation {
+  kAllocate,
+  kDeallocate,
+  kResize,
+};
+
+/// Returns a human-readable name for an operation.
+const char* OperationName(Operation operation);
+
+/// Replays traces against an allocator and measures one kind of operation.
+///
+/// The benchmark walks through a trace, performing each request in turn. Only
+/// requests of the measured kind are timed; the others are replayed with the
+/// timer paused, so that the allocator sees the whole trace. Reallocations are
+/// measured as in-place `Resize` calls, which do not copy data.
+///
+/// At the end of each pass through the trace, all live allocations are freed
+/// and the allocator is re-created over the same memory region. This keeps
+/// allocators that never reclaim memory, such as `BumpAllocator`, from
+/// failing every request after the first pass.
+///
+/// This class holds the logic that does not depend on the allocator type.
+class AllocatorBenchmarkGeneric {
+ public:
+  /// Maximum number of live allocations. Traces are generated to stay well
+  /// below this limit.
+  static constexpr size_t kMaxLiveAllocations = 48;
+
+  virtual ~AllocatorBenchmarkGeneric() = default;
+
+  /// Replays `trace` repeatedly, timing each request of the given kind.
+  ///
+  /// Before timing allocations, this also replays the trace once and logs the
+  /// fragmentation of the allocator's memory, if the allocator can measure
+  /// it, e.g. as a `BlockAllocator` can.
+  void Measure(perf_test::State& state,
+               const char* allocator_name,
+               const Trace& trace,
+               Operation operation);
+
+  /// Replays `trace` once without timing it.
+  ///
+  /// Allocations are left live until `Reset` is called.
+  void Replay(const Trace& trace);
+
+  /// Frees all live allocations and re-creates the allocator.
+  void Reset();
+
+  /// Returns the number of allocations that are currently live.
+  size_t num_live() const { return live_.size(); }
+
+  /// Returns the number of allocations that have failed since the last call
+  /// to `Measure`.
+  size_t num_failed_allocations() const { return num_failed_allocations_; }
+
+  /// Returns the number of reallocations that could not be done in place since
+  /// the last call to `Measure`.
+  size_t num_failed_resizes() const { return num_failed_resizes_; }
+
+ protected:
+  AllocatorBenchmarkGeneric() = default;
+
+  /// Frees all live allocations.
+  void FreeAll();
+
+ private:
+  struct Allocation {
+    void* ptr;
+    Layout layout;
+  };
+
+  /// Destroys the allocator, if any, and constructs a new one.
+  virtual Allocator& Recreate() = 0;
+
+  /// Returns the fragmentation of the allocator's memory, if measurable.
+  virtual std::optional<Fragmentation> MeasureFragmentation() const = 0;
+
+  /// Returns whether `request` is of the kind given by `operation`, and can be
+  /// performed with the current live allocations.
+  bool IsMeasurable(const test::Request& request, Operation operation) const;
+
+  /// Returns the next request of the measured kind, replaying any requests
+  /// before it. Starts a new pass, and resets, at the end of the trace.
+  const test::Request& Advance(const Trace& trace, Operation operation);
+
+  /// Performs a request. If `state` is not null, the timer is resumed for
+  /// just the allocator call.
+  void Perform(const test::Request& request, perf_test::State* state);
+
+  void LogFragmentation(const char* allocator_name, const Trace& trace);
+
+  Allocator* allocator_ = nullptr;
+  Vector<Allocation, kMaxLiveAllocations> live_;
+  size_t next_ = 0;
+  size_t num_failed_allocations_ = 0;
+  size_t num_failed_resizes_ = 0;
+};
+
+/// Benchmark for a specific allocator type.
+///
+/// The allocator is default-constructed and initialized with `Init` over the
+/// given region, which must outlive this object.
+template <typename AllocatorType>
+class AllocatorBenchmark : public AllocatorBenchmarkGeneric {
+ public:
+  explicit AllocatorBenchmark(ByteSpan region) : region_(region) {}
+
+  ~AllocatorBenchmark() override { FreeAll(); }
+
+ private:
+  template <typename T, typename = void>
+  struct HasMeasureFragmentation : std::false_type {};
+
+  template <typename T>
+  struct HasMeasureFragmentation<
+      T,
+      std::void_t<decltype(std::declval<const T&>().MeasureFragmentation())>>
+      : std::true_type {};
+
+  Allocator& Recreate() override {
+    allocator_.reset();
+    allocator_.emplace();
+    allocator_->Init(region_);
+    return *allocator_;
+  }
+
+  std::optional<Fragmentation> MeasureFragmentation() const override {
+    if constexpr (HasMeasureFragmentation<AllocatorType>::value) {
+      return allocator_->MeasureFragmentation();
+    } else {
+      return std::nullopt;
+    }
+  }
+
+  ByteSpan region_;
+  std::optional<AllocatorType> allocator_;
+};
+
+}  // namespace pw::allocator::benchmarks
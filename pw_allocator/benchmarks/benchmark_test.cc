@@ -0,0 +1,100 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "benchmarks/benchmark.h"
+
+#include <array>
+#include <cstddef>
+#include <variant>
+
+#include "benchmarks/traces.h"
+#include "pw_allocator/first_fit_block_allocator.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using ::pw::allocator::FirstFitBlockAllocator;
+using ::pw::allocator::benchmarks::AllocatorBenchmark;
+using ::pw::allocator::benchmarks::AllocatorBenchmarkGeneric;
+using ::pw::allocator::benchmarks::GenerateTrace;
+using ::pw::allocator::benchmarks::kMaxRequestSize;
+using ::pw::allocator::benchmarks::Trace;
+using ::pw::allocator::benchmarks::TraceType;
+using ::pw::allocator::test::AllocationRequest;
+using ::pw::allocator::test::DeallocationRequest;
+using ::pw::allocator::test::ReallocationRequest;
+
+constexpr std::array<TraceType, 3> kTraceTypes = {
+    TraceType::kRpcBurst,
+    TraceType::kBleSteadyState,
+    TraceType::kLogChurn,
+};
+
+TEST(TraceTest, TracesAreDeterministic) {
+  for (TraceType type : kTraceTypes) {
+    Trace trace1;
+    Trace trace2;
+    GenerateTrace(type, trace1);
+    GenerateTrace(type, trace2);
+    ASSERT_EQ(trace1.size(), trace2.size());
+    for (size_t i = 0; i < trace1.size(); ++i) {
+      ASSERT_EQ(trace1[i].index(), trace2[i].index());
+      if (const auto* request = std::get_if<AllocationRequest>(&trace1[i])) {
+        EXPECT_EQ(request->size, std::get<AllocationRequest>(trace2[i]).size);
+      }
+    }
+  }
+}
+
+TEST(TraceTest, TracesContainAllRequestKinds) {
+  for (TraceType type : kTraceTypes) {
+    Trace trace;
+    GenerateTrace(type, trace);
+    EXPECT_TRUE(trace.full());
+    size_t num_allocations = 0;
+    size_t num_deallocations = 0;
+    size_t num_reallocations = 0;
+    for (const auto& request : trace) {
+      if (const auto* allocation = std::get_if<AllocationRequest>(&request)) {
+        EXPECT_LE(allocation->size, kMaxRequestSize);
+        ++num_allocations;
+      } else if (std::holds_alternative<DeallocationRequest>(request)) {
+        ++num_deallocations;
+      } else if (std::holds_alternative<ReallocationRequest>(request)) {
+        ++num_reallocations;
+      }
+    }
+    EXPECT_NE(num_allocations, 0u);
+    EXPECT_NE(num_deallocations, 0u);
+    EXPECT_NE(num_reallocations, 0u);
+  }
+}
+
+TEST(AllocatorBenchmarkTest, ReplaysTracesWithoutFailures) {
+  alignas(std::max_align_t) std::array<std::byte, 16384> region;
+  AllocatorBenchmark<FirstFitBlockAllocator<>> benchmark(region);
+  for (TraceType type : kTraceTypes) {
+    Trace trace;
+    GenerateTrace(type, trace);
+    benchmark.Reset();
+    benchmark.Replay(trace);
+    EXPECT_EQ(benchmark.num_failed_allocations(), 0u);
+    EXPECT_LT(benchmark.num_live(),
+              AllocatorBenchmarkGeneric::kMaxLiveAllocations);
+  }
+  benchmark.Reset();
+  EXPECT_EQ(benchmark.num_live(), 0u);
+}
+
+}  // namespace
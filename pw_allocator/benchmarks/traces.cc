@@ -0,0 +1,190 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "benchmarks/traces.h"
+
+#include <cstdint>
+
+#include "pw_random/xor_shift.h"
+
+namespace pw::allocator::benchmarks {
+namespace {
+
+constexpr uint64_t kSeed = 0x5eed;
+constexpr size_t kAlignment = alignof(void*);
+
+// RPC bursts allocate up to this many buffers before freeing them.
+constexpr size_t kMaxRpcBurst = 16;
+
+// Number of long-lived RPC calls that may be pending between bursts.
+constexpr size_t kMaxPendingRpcs = 4;
+
+// Sizes of a BLE ACL data packet. The payload is bounded by the minimum and
+// maximum LE data lengths.
+constexpr size_t kAclHeaderSize = 4;
+constexpr size_t kMinAclPayloadSize = 27;
+constexpr size_t kMaxAclPayloadSize = 251;
+
+// Number of log buffers that may be live at once.
+constexpr size_t kMaxLogBuffers = 32;
+constexpr size_t kMinLogSize = 16;
+constexpr size_t kMaxLogSize = 160;
+
+/// Appends requests to a trace while tracking how many allocations are live.
+class TraceBuilder {
+ public:
+  explicit TraceBuilder(Trace& trace) : trace_(trace), prng_(kSeed) {
+    trace_.clear();
+  }
+
+  bool done() const { return trace_.full(); }
+  size_t live() const { return live_; }
+
+  /// Returns a random value in the inclusive range [min, max].
+  size_t Random(size_t min, size_t max) {
+    size_t value;
+    prng_.GetInt(value, max - min + 1);
+    return min + value;
+  }
+
+  /// Returns true with a probability of 1 in `n`.
+  bool OneIn(size_t n) { return Random(0, n - 1) == 0; }
+
+  void Allocate(size_t size) {
+    if (!done()) {
+      trace_.push_back(test::AllocationRequest{size, kAlignment});
+      ++live_;
+    }
+  }
+
+  void Deallocate(size_t index) {
+    if (!done() && live_ != 0) {
+      trace_.push_back(test::DeallocationRequest{index});
+      --live_;
+    }
+  }
+
+  void Reallocate(size_t index, size_t new_size) {
+    if (!done() && live_ != 0) {
+      trace_.push_back(test::ReallocationRequest{index, new_size});
+    }
+  }
+
+ private:
+  Trace& trace_;
+  random::XorShiftStarRng64 prng_;
+  size_t live_ = 0;
+};
+
+void GenerateRpcBurst(TraceBuilder& builder) {
+  while (!builder.done()) {
+    // Allocations left from previous bursts are long-lived calls, and are
+    // always the oldest.
+    size_t index = builder.live();
+    size_t burst = builder.Random(kMaxRpcBurst / 2, kMaxRpcBurst);
+    for (size_t i = 0; i < burst; ++i) {
+      builder.Allocate(builder.Random(64, kMaxRequestSize));
+      if (builder.OneIn(4)) {
+        builder.Reallocate(builder.live() - 1,
+                           builder.Random(32, kMaxRequestSize));
+      }
+    }
+
+    // Free the burst in order, except for the occasional long-lived call.
+    for (size_t i = 0; i < burst; ++i) {
+      if (builder.OneIn(8)) {
+        ++index;
+      } else {
+        builder.Deallocate(index);
+      }
+    }
+    while (!builder.done() && builder.live() > kMaxPendingRpcs) {
+      builder.Deallocate(0);
+    }
+  }
+}
+
+void GenerateBleSteadyState(TraceBuilder& builder) {
+  while (!builder.done()) {
+    size_t payload_size;
+    switch (builder.Random(0, 3)) {
+      case 0:
+        payload_size = kMinAclPayloadSize;
+        break;
+      case 1:
+        payload_size = builder.Random(kMinAclPayloadSize, kMaxAclPayloadSize);
+        break;
+      default:
+        payload_size = kMaxAclPayloadSize;
+        break;
+    }
+    builder.Allocate(kAclHeaderSize + payload_size);
+
+    // Buffers are occasionally trimmed to the length actually received.
+    if (builder.OneIn(16)) {
+      builder.Reallocate(
+          builder.live() - 1,
+          kAclHeaderSize + builder.Random(kMinAclPayloadSize, payload_size));
+    }
+    while (!builder.done() && builder.live() > builder.Random(4, 8)) {
+      builder.Deallocate(0);
+    }
+  }
+}
+
+void GenerateLogChurn(TraceBuilder& builder) {
+  while (!builder.done()) {
+    size_t live = builder.live();
+    size_t choice = builder.Random(0, 7);
+    if (live == 0 || (live < kMaxLogBuffers && choice < 4)) {
+      builder.Allocate(builder.Random(kMinLogSize, kMaxLogSize));
+    } else if (choice < 6) {
+      builder.Deallocate(builder.Random(0, live - 1));
+    } else {
+      builder.Reallocate(builder.Random(0, live - 1),
+                         builder.Random(kMinLogSize, kMaxLogSize));
+    }
+  }
+}
+
+}  // namespace
+
+const char* TraceName(TraceType type) {
+  switch (type) {
+    case TraceType::kRpcBurst:
+      return "RpcBurst";
+    case TraceType::kBleSteadyState:
+      return "BleSteadyState";
+    case TraceType::kLogChurn:
+      return "LogChurn";
+  }
+  return "Unknown";
+}
+
+void GenerateTrace(TraceType type, Trace& trace) {
+  TraceBuilder builder(trace);
+  switch (type) {
+    case TraceType::kRpcBurst:
+      GenerateRpcBurst(builder);
+      break;
+    case TraceType::kBleSteadyState:
+      GenerateBleSteadyState(builder);
+      break;
+    case TraceType::kLogChurn:
+      GenerateLogChurn(builder);
+      break;
+  }
+}
+
+}  // namespace pw::allocator::benchmarks
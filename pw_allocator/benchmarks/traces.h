@@ -0,0 +1,62 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_allocator/test_harness.h"
+#include "pw_containers/vector.h"
+
+namespace pw::allocator::benchmarks {
+
+/// Maximum number of requests in a trace.
+inline constexpr size_t kMaxTraceLength = 256;
+
+/// Largest allocation requested by any trace.
+inline constexpr size_t kMaxRequestSize = 512;
+
+/// Sequence of allocation requests replayed by a benchmark.
+///
+/// Requests use the types from `pw_allocator/test_harness.h`. The `index` of a
+/// deallocation or reallocation refers to the live allocations in the order
+/// they were made, i.e. index 0 is the oldest live allocation.
+using Trace = Vector<test::Request, kMaxTraceLength>;
+
+/// Allocation patterns modeled after common embedded workloads.
+enum class TraceType {
+  /// Bursts of RPC packet buffers of 64 to 512 bytes that are mostly freed in
+  /// the order they were allocated, with occasional long-lived calls and
+  /// resized responses.
+  kRpcBurst,
+
+  /// A small, steady set of BLE ACL buffers that are freed in order, sized
+  /// mostly for the minimum and maximum LE data lengths.
+  kBleSteadyState,
+
+  /// Short log and string buffers of 16 to 160 bytes with random lifetimes,
+  /// frequently grown or shrunk.
+  kLogChurn,
+};
+
+/// Returns a human-readable name for a type of trace.
+const char* TraceName(TraceType type);
+
+/// Replaces the contents of `trace` with a full-length trace of the given type.
+///
+/// Traces are generated from a fixed seed, and so are identical on every call
+/// and every device. Every trace contains allocations, deallocations, and
+/// reallocations.
+void GenerateTrace(TraceType type, Trace& trace);
+
+}  // namespace pw::allocator::benchmarks
@@ -445,6 +445,29 @@ TEST_FOR_EACH_BLOCK_TYPE(CannotAllocLastIfTooSmallForAlignment) {
   EXPECT_EQ(result.status(), pw::Status::ResourceExhausted());
 }
 
+TEST_FOR_EACH_BLOCK_TYPE(CanAllocLastFromFirstBlockWithSmallPadding) {
+  constexpr Layout kLayout(256, BlockType::kAlignment);
+  constexpr size_t kOuterSize =
+      BlockType::kBlockOverhead + kLayout.size() + BlockType::kAlignment;
+  auto* block = Preallocate<BlockType>(
+      bytes_,
+      {
+          {kOuterSize, Preallocation::kFree},
+          {Preallocation::kSizeRemaining, Preallocation::kUsed},
+      });
+  auto* next = block->Next();
+
+  // There is no previous block to absorb the padding, and the padding is too
+  // small to split off as a new block, so it is left at the end of the block.
+  auto result = BlockType::AllocLast(block, kLayout);
+  ASSERT_EQ(result.status(), pw::OkStatus());
+  EXPECT_EQ(*result, BlockAllocType::kExact);
+  EXPECT_EQ(block->Prev(), nullptr);
+  EXPECT_EQ(block->Next(), next);
+  EXPECT_EQ(block->InnerSize(), kLayout.size() + BlockType::kAlignment);
+  EXPECT_EQ(block->RequestedSize(), kLayout.size());
+}
+
 TEST_FOR_EACH_BLOCK_TYPE(CannotAllocLastFromNull) {
   BlockType* block = nullptr;
   constexpr Layout kLayout(1, 1);
@@ -36,8 +36,10 @@ void* BumpAllocator::DoAllocate(Layout layout) {
 void BumpAllocator::DoDeallocate(void*) {}
 
 void BumpAllocator::Reset() {
-  if (owned_ != nullptr) {
-    owned_->Destroy();
+  while (owned_ != nullptr) {
+    internal::GenericOwned* owned = owned_;
+    owned_ = owned->next();
+    owned->Destroy();
   }
   remaining_ = ByteSpan();
 }
@@ -113,6 +113,19 @@ TEST(BumpAllocatorTest, NewOwnedDestroys) {
   EXPECT_EQ(counter, 1U);
 }
 
+TEST(BumpAllocatorTest, NewOwnedDestroysAll) {
+  alignas(16) std::array<std::byte, 256> buffer;
+  size_t counter = 0;
+  {
+    BumpAllocator allocator(buffer);
+    allocator.NewOwned<DestroyCounter>(&counter);
+    allocator.NewOwned<DestroyCounter>(&counter);
+    allocator.NewOwned<DestroyCounter>(&counter);
+    EXPECT_EQ(counter, 0U);
+  }
+  EXPECT_EQ(counter, 3U);
+}
+
 TEST(BumpAllocatorTest, MakeUniqueDoesNotDestroy) {
   alignas(16) std::array<std::byte, 256> buffer;
   size_t counter = 0;
@@ -0,0 +1,134 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/callable_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/testing.h"
+#include "pw_allocator/typed_pool.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::CallableAllocator;
+using ::pw::allocator::CallbackWithAllocator;
+using ::pw::allocator::FunctionWithAllocator;
+using ::pw::allocator::TypedPool;
+using ::pw::allocator::test::AllocatorForTest;
+
+constexpr size_t kCaptureSize = 32;
+using Capture = std::array<uint8_t, kCaptureSize>;
+
+AllocatorForTest<256> allocator;
+
+using Chunk = std::array<std::byte, kCaptureSize + sizeof(void*)>;
+TypedPool<Chunk>::Buffer<2> pool_buffer;
+TypedPool<Chunk> pool(pool_buffer);
+
+class CallableAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override { allocator.ResetParameters(); }
+};
+
+// Unit tests.
+
+TEST_F(CallableAllocatorTest, StatelessAndAlwaysEqual) {
+  CallableAllocator<allocator> a;
+  CallableAllocator<allocator, uint32_t> b(a);
+  EXPECT_TRUE(a == b);
+  EXPECT_FALSE(a != b);
+  static_assert(std::is_empty_v<CallableAllocator<allocator>>);
+}
+
+TEST_F(CallableAllocatorTest, AllocateAndDeallocate) {
+  CallableAllocator<allocator, uint32_t> alloc;
+  uint32_t* ptr = alloc.allocate(4);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(allocator.allocate_size(), 4 * sizeof(uint32_t));
+
+  alloc.deallocate(ptr, 4);
+  EXPECT_EQ(allocator.deallocate_ptr(), ptr);
+}
+
+TEST_F(CallableAllocatorTest, SmallCallableIsInline) {
+  int value = 0;
+  FunctionWithAllocator<void(), allocator> function = [&value] { ++value; };
+  function();
+  EXPECT_EQ(value, 1);
+  EXPECT_EQ(allocator.allocate_size(), 0u);
+}
+
+TEST_F(CallableAllocatorTest, LargeCallableSpillsToAllocator) {
+  Capture capture{};
+  capture[kCaptureSize - 1] = 42;
+  {
+    FunctionWithAllocator<int(), allocator> function = [capture] {
+      return int{capture[kCaptureSize - 1]};
+    };
+    EXPECT_GE(allocator.allocate_size(), sizeof(capture));
+    EXPECT_EQ(function(), 42);
+    EXPECT_EQ(allocator.deallocate_ptr(), nullptr);
+  }
+  EXPECT_NE(allocator.deallocate_ptr(), nullptr);
+}
+
+TEST_F(CallableAllocatorTest, SpilledCallableMovesWithoutAllocating) {
+  Capture capture{};
+  FunctionWithAllocator<size_t(), allocator> first = [capture] {
+    return capture.size();
+  };
+  allocator.ResetParameters();
+
+  FunctionWithAllocator<size_t(), allocator> second = std::move(first);
+  EXPECT_EQ(allocator.allocate_size(), 0u);
+  EXPECT_EQ(second(), kCaptureSize);
+}
+
+TEST_F(CallableAllocatorTest, CallbackReleasesMemoryWhenCalled) {
+  Capture capture{};
+  CallbackWithAllocator<size_t(), allocator> callback = [capture] {
+    return capture.size();
+  };
+  EXPECT_EQ(callback(), kCaptureSize);
+  EXPECT_NE(allocator.deallocate_ptr(), nullptr);
+  EXPECT_EQ(callback, nullptr);
+}
+
+TEST_F(CallableAllocatorTest, LargeCallableSpillsToPool) {
+  Capture capture{};
+  capture[0] = 7;
+
+  FunctionWithAllocator<int(), pool> first = [capture] {
+    return int{capture[0]};
+  };
+  FunctionWithAllocator<int(), pool> second = [capture] {
+    return int{capture[0]} + 1;
+  };
+  EXPECT_EQ(first(), 7);
+  EXPECT_EQ(second(), 8);
+
+  // Releasing a callable returns its chunk to the pool.
+  first = nullptr;
+  FunctionWithAllocator<int(), pool> third = [capture] {
+    return int{capture[0]} + 2;
+  };
+  EXPECT_EQ(third(), 9);
+}
+
+}  // namespace
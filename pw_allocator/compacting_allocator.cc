@@ -0,0 +1,115 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/compacting_allocator.h"
+
+#include <cstring>
+#include <new>
+
+#include "pw_assert/check.h"
+#include "pw_bytes/alignment.h"
+
+namespace pw::allocator::internal {
+
+void GenericCompactingAllocator::Init(ByteSpan region) {
+  auto* begin = AlignUp(region.data(), kAlignment);
+  auto* end = AlignDown(region.data() + region.size(), kAlignment);
+  begin_ = begin < end ? begin : end;
+  top_ = begin_;
+  end_ = end;
+  reclaimable_bytes_ = 0;
+  for (std::byte*& entry : table_) {
+    entry = nullptr;
+  }
+}
+
+size_t GenericCompactingAllocator::Allocate(Layout layout) {
+  if (layout.alignment() > kAlignment ||
+      layout.size() > contiguous_free_bytes()) {
+    return kInvalidIndex;
+  }
+  size_t size = AlignUp(layout.size(), kAlignment);
+  if (sizeof(Header) + size > contiguous_free_bytes()) {
+    return kInvalidIndex;
+  }
+  size_t index = 0;
+  while (index < table_.size() && table_[index] != nullptr) {
+    ++index;
+  }
+  if (index == table_.size()) {
+    return kInvalidIndex;
+  }
+  auto* header = new (top_) Header{size, index};
+  table_[index] = reinterpret_cast<std::byte*>(header + 1);
+  top_ = table_[index] + size;
+  return index;
+}
+
+void GenericCompactingAllocator::Free(size_t index) {
+  PW_CHECK(Get(index) != nullptr, "Freed an invalid handle");
+  std::byte* ptr = table_[index];
+  table_[index] = nullptr;
+  Header* header = HeaderOf(ptr);
+  header->index = kInvalidIndex;
+  if (ptr + header->size == top_) {
+    top_ = reinterpret_cast<std::byte*>(header);
+  } else {
+    reclaimable_bytes_ += sizeof(Header) + header->size;
+  }
+}
+
+void GenericCompactingAllocator::Compact() {
+  std::byte* src = begin_;
+  std::byte* dst = begin_;
+  while (src < top_) {
+    auto* header = reinterpret_cast<Header*>(src);
+    size_t outer_size = sizeof(Header) + header->size;
+    size_t index = header->index;
+    if (index != kInvalidIndex) {
+      if (dst != src) {
+        std::memmove(dst, src, outer_size);
+        table_[index] = dst + sizeof(Header);
+      }
+      dst += outer_size;
+    }
+    src += outer_size;
+  }
+  top_ = dst;
+  reclaimable_bytes_ = 0;
+}
+
+Fragmentation GenericCompactingAllocator::MeasureFragmentation() const {
+  Fragmentation fragmentation;
+  size_t free_size = 0;
+  std::byte* ptr = begin_;
+  while (ptr < top_) {
+    auto* header = reinterpret_cast<Header*>(ptr);
+    size_t outer_size = sizeof(Header) + header->size;
+    if (header->index == kInvalidIndex) {
+      // Adjacent freed allocations form a single fragment.
+      free_size += outer_size;
+    } else if (free_size != 0) {
+      fragmentation.AddFragment(free_size / kAlignment);
+      free_size = 0;
+    }
+    ptr += outer_size;
+  }
+  free_size += contiguous_free_bytes();
+  if (free_size != 0) {
+    fragmentation.AddFragment(free_size / kAlignment);
+  }
+  return fragmentation;
+}
+
+}  // namespace pw::allocator::internal
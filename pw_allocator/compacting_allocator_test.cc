@@ -0,0 +1,154 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/compacting_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::Layout;
+
+constexpr size_t kAlignment = alignof(std::max_align_t);
+constexpr size_t kCapacity = 64 * kAlignment;
+
+using CompactingAllocator = ::pw::allocator::CompactingAllocator<4>;
+using Handle = CompactingAllocator::Handle;
+
+class CompactingAllocatorTest : public ::testing::Test {
+ protected:
+  CompactingAllocatorTest() : allocator_(buffer_) {}
+
+  alignas(kAlignment) std::array<std::byte, kCapacity> buffer_;
+  CompactingAllocator allocator_;
+};
+
+// Unit tests.
+
+TEST_F(CompactingAllocatorTest, AllocateAligned) {
+  Handle handle = allocator_.Allocate(Layout(1, 1));
+  ASSERT_TRUE(handle);
+  void* ptr = allocator_.Get(handle);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % kAlignment, 0U);
+}
+
+TEST_F(CompactingAllocatorTest, AllocateFailsWithLargeAlignment) {
+  EXPECT_FALSE(allocator_.Allocate(Layout(16, kAlignment * 2)));
+}
+
+TEST_F(CompactingAllocatorTest, AllocateFailsWhenExhausted) {
+  EXPECT_TRUE(allocator_.Allocate(Layout(kCapacity / 2, 1)));
+  EXPECT_FALSE(allocator_.Allocate(Layout(kCapacity / 2, 1)));
+}
+
+TEST_F(CompactingAllocatorTest, AllocateFailsWithoutHandles) {
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(allocator_.Allocate(Layout(1, 1)));
+  }
+  EXPECT_FALSE(allocator_.Allocate(Layout(1, 1)));
+}
+
+TEST_F(CompactingAllocatorTest, GetInvalidHandleReturnsNull) {
+  EXPECT_EQ(allocator_.Get(Handle()), nullptr);
+}
+
+TEST_F(CompactingAllocatorTest, FreeMostRecentAllocationIsReused) {
+  Handle handle1 = allocator_.Allocate(Layout(kAlignment, 1));
+  ASSERT_TRUE(handle1);
+  void* ptr1 = allocator_.Get(handle1);
+  allocator_.Free(handle1);
+  EXPECT_EQ(allocator_.reclaimable_bytes(), 0U);
+
+  Handle handle2 = allocator_.Allocate(Layout(kAlignment, 1));
+  ASSERT_TRUE(handle2);
+  EXPECT_EQ(allocator_.Get(handle2), ptr1);
+}
+
+TEST_F(CompactingAllocatorTest, CompactReclaimsFreedMemory) {
+  constexpr size_t kSize = kCapacity / 4 - kAlignment;
+  Handle handle1 = allocator_.Allocate(Layout(kSize, 1));
+  Handle handle2 = allocator_.Allocate(Layout(kSize, 1));
+  Handle handle3 = allocator_.Allocate(Layout(kSize, 1));
+  ASSERT_TRUE(handle1);
+  ASSERT_TRUE(handle2);
+  ASSERT_TRUE(handle3);
+  std::memset(allocator_.Get(handle1), 0x11, kSize);
+  std::memset(allocator_.Get(handle3), 0x33, kSize);
+
+  // Enough memory is free, but it is not contiguous.
+  allocator_.Free(handle2);
+  EXPECT_EQ(allocator_.reclaimable_bytes(), kSize + kAlignment);
+  EXPECT_FALSE(allocator_.Allocate(Layout(kSize * 2, 1)));
+
+  void* ptr3 = allocator_.Get(handle3);
+  allocator_.Compact();
+  EXPECT_EQ(allocator_.reclaimable_bytes(), 0U);
+  EXPECT_NE(allocator_.Get(handle3), ptr3);
+
+  std::array<std::byte, kSize> expected;
+  expected.fill(std::byte(0x11));
+  EXPECT_EQ(std::memcmp(allocator_.Get(handle1), expected.data(), kSize), 0);
+  expected.fill(std::byte(0x33));
+  EXPECT_EQ(std::memcmp(allocator_.Get(handle3), expected.data(), kSize), 0);
+
+  EXPECT_TRUE(allocator_.Allocate(Layout(kSize * 2, 1)));
+}
+
+TEST_F(CompactingAllocatorTest, FreedHandlesAreReused) {
+  std::array<Handle, 4> handles;
+  for (Handle& handle : handles) {
+    handle = allocator_.Allocate(Layout(1, 1));
+    ASSERT_TRUE(handle);
+  }
+  allocator_.Free(handles[1]);
+  EXPECT_TRUE(allocator_.Allocate(Layout(1, 1)));
+}
+
+TEST_F(CompactingAllocatorTest, MeasureFragmentation) {
+  pw::allocator::Fragmentation fragmentation =
+      allocator_.MeasureFragmentation();
+  EXPECT_EQ(fragmentation.sum, kCapacity / kAlignment);
+
+  std::array<Handle, 4> handles;
+  for (Handle& handle : handles) {
+    handle = allocator_.Allocate(Layout(kAlignment, 1));
+    ASSERT_TRUE(handle);
+  }
+  size_t free_size = allocator_.contiguous_free_bytes() / kAlignment;
+  allocator_.Free(handles[0]);
+  allocator_.Free(handles[2]);
+  size_t reclaimable = allocator_.reclaimable_bytes() / kAlignment;
+
+  // Freed allocations are separate fragments until compacted.
+  fragmentation = allocator_.MeasureFragmentation();
+  EXPECT_EQ(fragmentation.sum, free_size + reclaimable);
+  EXPECT_EQ(fragmentation.sum_of_squares.lo,
+            free_size * free_size + reclaimable * reclaimable / 2);
+
+  allocator_.Compact();
+  fragmentation = allocator_.MeasureFragmentation();
+  EXPECT_EQ(fragmentation.sum, free_size + reclaimable);
+  EXPECT_EQ(fragmentation.sum_of_squares.lo,
+            (free_size + reclaimable) * (free_size + reclaimable));
+}
+
+}  // namespace
@@ -101,8 +101,14 @@ TEST_F(FreeListHeapBufferTest, ReturnsNullWhenFull) {
   FreeListHeapBuffer allocator(buffer_);
 
   auto start = reinterpret_cast<uintptr_t>(buffer_.data());
-  uintptr_t usable =
-      pw::AlignUp(start + BlockType::kBlockOverhead, alignof(std::max_align_t));
+  uintptr_t usable = start + BlockType::kBlockOverhead;
+  if (usable % alignof(std::max_align_t) != 0) {
+    // The first block has no previous block to absorb the padding needed for
+    // alignment, and so a leading block is split off instead.
+    usable = pw::AlignUp(
+        usable + BlockType::kBlockOverhead + BlockType::kAlignment,
+        alignof(std::max_align_t));
+  }
 
   void* ptr1 = allocator.Allocate(kN - (usable - start));
   ASSERT_NE(ptr1, nullptr);
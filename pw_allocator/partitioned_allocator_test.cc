@@ -0,0 +1,128 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/partitioned_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/first_fit_block_allocator.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using ::pw::allocator::Layout;
+
+// Test fixtures.
+
+/// Lock that does nothing, for single-threaded tests.
+class NoLock {
+ public:
+  void lock() {}
+  void unlock() {}
+};
+
+constexpr size_t kNumPartitions = 4;
+constexpr size_t kCapacity = 1024;
+
+using BlockAllocator = ::pw::allocator::FirstFitBlockAllocator<uint16_t>;
+using PartitionedAllocator = ::pw::allocator::
+    PartitionedAllocator<BlockAllocator, NoLock, kNumPartitions>;
+
+size_t home_partition = 0;
+
+size_t GetHomePartition() { return home_partition; }
+
+class PartitionedAllocatorTest : public ::testing::Test {
+ protected:
+  PartitionedAllocatorTest() : allocator_(buffer_, GetHomePartition) {
+    home_partition = 0;
+  }
+
+  alignas(std::max_align_t) std::array<std::byte, kCapacity> buffer_;
+  PartitionedAllocator allocator_;
+};
+
+// Unit tests.
+
+TEST_F(PartitionedAllocatorTest, AllocatesFromHomePartition) {
+  for (size_t i = 0; i < kNumPartitions; ++i) {
+    home_partition = i;
+    void* ptr = allocator_.Allocate(Layout(16, 8));
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(allocator_.PartitionOf(ptr), i);
+    allocator_.Deallocate(ptr);
+  }
+}
+
+TEST_F(PartitionedAllocatorTest, HomePartitionWraps) {
+  home_partition = kNumPartitions + 1;
+  void* ptr = allocator_.Allocate(Layout(16, 8));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(allocator_.PartitionOf(ptr), 1u);
+  allocator_.Deallocate(ptr);
+}
+
+TEST_F(PartitionedAllocatorTest, StealsFromOtherPartitions) {
+  home_partition = 2;
+  constexpr size_t kSize = kCapacity / kNumPartitions / 2;
+  void* ptr1 = allocator_.Allocate(Layout(kSize, 8));
+  ASSERT_NE(ptr1, nullptr);
+  EXPECT_EQ(allocator_.PartitionOf(ptr1), 2u);
+
+  // The home partition does not have room for a second allocation.
+  void* ptr2 = allocator_.Allocate(Layout(kSize, 8));
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_EQ(allocator_.PartitionOf(ptr2), 3u);
+
+  allocator_.Deallocate(ptr1);
+  allocator_.Deallocate(ptr2);
+}
+
+TEST_F(PartitionedAllocatorTest, AllocateFailsWhenNoPartitionFits) {
+  EXPECT_EQ(allocator_.Allocate(Layout(kCapacity / 2, 8)), nullptr);
+}
+
+TEST_F(PartitionedAllocatorTest, DeallocateReturnsMemoryToOwner) {
+  home_partition = 1;
+  void* ptr1 = allocator_.Allocate(Layout(64, 8));
+  ASSERT_NE(ptr1, nullptr);
+
+  // Freeing from a thread with another home partition still returns the
+  // memory to the partition it came from.
+  home_partition = 3;
+  allocator_.Deallocate(ptr1);
+  home_partition = 1;
+  void* ptr2 = allocator_.Allocate(Layout(64, 8));
+  EXPECT_EQ(ptr1, ptr2);
+  allocator_.Deallocate(ptr2);
+}
+
+TEST_F(PartitionedAllocatorTest, ResizeWithinPartition) {
+  void* ptr = allocator_.Allocate(Layout(16, 8));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(allocator_.Resize(ptr, 64));
+  EXPECT_FALSE(allocator_.Resize(ptr, kCapacity));
+  allocator_.Deallocate(ptr);
+}
+
+TEST_F(PartitionedAllocatorTest, GetCapacity) {
+  pw::StatusWithSize capacity = allocator_.GetCapacity();
+  ASSERT_EQ(capacity.status(), pw::OkStatus());
+  EXPECT_LE(capacity.size(), kCapacity);
+  EXPECT_GT(capacity.size(), kCapacity / 2);
+}
+
+}  // namespace
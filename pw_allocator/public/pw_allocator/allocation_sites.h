@@ -0,0 +1,208 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_metric/metric.h"
+#include "pw_span/span.h"
+
+namespace pw::allocator {
+
+/// Metrics for the allocations made from one call site.
+///
+/// The metrics are kept in a group named by the site's key, so that they can be
+/// dumped or exported with the rest of an allocator's metrics, e.g. by
+/// `pw::metric::MetricService`.
+class AllocationSite {
+ public:
+  /// Number of buckets in the lifetime histogram.
+  ///
+  /// Lifetimes are measured in allocations: the number of allocations made
+  /// through the same allocator while an allocation was live. This does not
+  /// depend on a clock, and short lifetimes identify churn regardless of how
+  /// busy the device is.
+  static constexpr size_t kLifetimeBuckets = 16;
+
+  explicit AllocationSite(uint32_t key);
+
+  /// Returns the key of the site: a token, or the return address of the call
+  /// to `Allocate`.
+  uint32_t key() const { return key_; }
+
+  const metric::Group& metric_group() const { return group_; }
+  metric::Group& metric_group() { return group_; }
+
+  /// Returns the number of successful allocations.
+  uint32_t num_allocations() const { return num_allocations_.value(); }
+
+  /// Returns the number of bytes requested by live allocations.
+  uint32_t requested_bytes() const { return requested_bytes_.value(); }
+
+  /// Returns the largest value of `requested_bytes`.
+  uint32_t peak_requested_bytes() const {
+    return peak_requested_bytes_.value();
+  }
+
+  /// Returns the total number of bytes requested by all allocations, including
+  /// growth from resizing.
+  uint32_t cumulative_requested_bytes() const {
+    return cumulative_requested_bytes_.value();
+  }
+
+  /// Returns the histogram of the lifetimes of freed allocations.
+  const metric::Histogram<kLifetimeBuckets>& lifetimes() const {
+    return lifetimes_;
+  }
+
+ private:
+  friend class AllocationSiteTracker;
+
+  void RecordAllocation(size_t requested);
+  void RecordResize(size_t old_requested, size_t new_requested);
+  void RecordDeallocation(size_t requested, uint32_t lifetime);
+
+  uint32_t key_;
+  metric::Group group_;
+  PW_METRIC(group_, num_allocations_, "allocations", 0u);
+  PW_METRIC(group_, requested_bytes_, "requested_bytes", 0u);
+  PW_METRIC(group_, peak_requested_bytes_, "peak_requested_bytes", 0u);
+  PW_METRIC(group_,
+            cumulative_requested_bytes_,
+            "cumulative_requested_bytes",
+            0u);
+  PW_METRIC_HISTOGRAM(group_, lifetimes_, "lifetimes", kLifetimeBuckets);
+};
+
+/// Attributes the allocations made through a `TrackingAllocator` to the code
+/// that made them.
+///
+/// Each allocation is attributed to a site identified by a 32-bit key. By
+/// default, the key is the return address of the call to `Allocate`, i.e. an
+/// address in the function that called it after inlining, which can be mapped
+/// to source with the firmware's symbols. Code can instead attribute its
+/// allocations to a token, e.g. from `PW_TOKENIZE_STRING`, using
+/// `ScopedSite`. Since metric names are 31-bit tokens, the most significant bit
+/// of a key is ignored.
+///
+/// Sites and live allocations are kept in fixed-size tables that are searched
+/// linearly. Allocations that do not fit in these tables are counted as
+/// untracked. The tracker is not thread-safe; the allocator it is attached to
+/// should be synchronized, e.g. by wrapping it in a `SynchronizedAllocator`.
+///
+/// Use `AllocationSites`, which provides the storage for the tables.
+class AllocationSiteTracker {
+ public:
+  /// Attributes allocations made while this object is in scope to a token
+  /// instead of a return address.
+  ///
+  /// Scopes may be nested. Since the tracker has a single current site, scopes
+  /// should only be used by code running on the same thread as all other users
+  /// of the allocator.
+  class ScopedSite {
+   public:
+    ScopedSite(AllocationSiteTracker& tracker, uint32_t key)
+        : tracker_(tracker), previous_(tracker.current_site_) {
+      tracker_.current_site_ = key;
+    }
+
+    ~ScopedSite() { tracker_.current_site_ = previous_; }
+
+    ScopedSite(const ScopedSite&) = delete;
+    ScopedSite& operator=(const ScopedSite&) = delete;
+
+   private:
+    AllocationSiteTracker& tracker_;
+    uint32_t previous_;
+  };
+
+  AllocationSiteTracker(const AllocationSiteTracker&) = delete;
+  AllocationSiteTracker& operator=(const AllocationSiteTracker&) = delete;
+
+  const metric::Group& metric_group() const { return group_; }
+  metric::Group& metric_group() { return group_; }
+
+  /// Returns the site with the given key, or null if it has no allocations.
+  const AllocationSite* Find(uint32_t key) const;
+
+  /// Returns the number of sites that have made allocations.
+  size_t num_sites() const { return num_sites_; }
+
+  /// Returns the number of allocations that were not attributed to a site.
+  uint32_t num_untracked() const { return num_untracked_.value(); }
+
+  /// Returns the key of the current `ScopedSite`, or 0 if there is none.
+  uint32_t current_site() const { return current_site_; }
+
+  /// Records a successful allocation by the given site.
+  void RecordAllocation(uint32_t key, const void* ptr, size_t requested);
+
+  /// Records that an allocation was resized or moved.
+  void RecordReallocation(const void* old_ptr,
+                          const void* new_ptr,
+                          size_t old_requested,
+                          size_t new_requested);
+
+  /// Records that an allocation was freed.
+  void RecordDeallocation(const void* ptr, size_t requested);
+
+ protected:
+  struct LiveAllocation {
+    const void* ptr = nullptr;
+    AllocationSite* site = nullptr;
+    uint32_t allocated_at = 0;
+  };
+
+  AllocationSiteTracker(metric::Token token,
+                        span<std::optional<AllocationSite>> sites,
+                        span<LiveAllocation> live);
+
+ private:
+  AllocationSite* FindOrAddSite(uint32_t key);
+  LiveAllocation* FindLive(const void* ptr);
+
+  metric::Group group_;
+  PW_METRIC(group_, num_untracked_, "untracked", 0u);
+  span<std::optional<AllocationSite>> sites_;
+  span<LiveAllocation> live_;
+  size_t num_sites_ = 0;
+  size_t num_live_ = 0;
+  uint32_t current_site_ = 0;
+
+  // Number of allocations so far, used to measure lifetimes.
+  uint32_t clock_ = 0;
+};
+
+/// Storage for an `AllocationSiteTracker`.
+///
+/// @tparam   kMaxSites     Number of sites that can be tracked.
+/// @tparam   kMaxLive      Number of live allocations that can be attributed
+///                         to sites at once.
+template <size_t kMaxSites, size_t kMaxLive>
+class AllocationSites : public AllocationSiteTracker {
+ public:
+  static_assert(kMaxSites > 0 && kMaxLive > 0);
+
+  explicit AllocationSites(metric::Token token)
+      : AllocationSiteTracker(token, sites_, live_) {}
+
+ private:
+  std::array<std::optional<AllocationSite>, kMaxSites> sites_;
+  std::array<LiveAllocation, kMaxLive> live_;
+};
+
+}  // namespace pw::allocator
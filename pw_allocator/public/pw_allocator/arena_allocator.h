@@ -0,0 +1,194 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/bump_allocator.h"
+#include "pw_allocator/capability.h"
+#include "pw_bytes/span.h"
+
+namespace pw::allocator {
+
+/// Allocator that frees memory in bulk, by scope.
+///
+/// Like `BumpAllocator`, an arena allocator satisfies requests by incrementing
+/// a pointer into a region of memory, and does nothing on deallocation.
+/// Unlike `BumpAllocator`, memory can be reclaimed before the allocator is
+/// destroyed:
+///
+/// - `Mark` records the current state of the arena, and `Release` frees
+///   everything allocated since a given marker. Markers may be nested, e.g.
+///   using `ArenaAllocator::Scope` to free memory at the end of a block.
+/// - `Reset` frees everything that has been allocated.
+///
+/// If the arena is given a parent allocator, it allocates additional chunks of
+/// memory from it when its current region is exhausted, and returns them to
+/// the parent when released.
+///
+/// As with `BumpAllocator`, the destructors for objects allocated using `New`
+/// or `MakeUnique` are NOT called. Objects allocated using `NewOwned` and
+/// `MakeUniqueOwned` have their destructors invoked, in reverse order of
+/// construction, when the memory they occupy is released.
+///
+/// An example of a good use case is handling an RPC or a protocol request:
+/// a handler can make all of its allocations from an arena within a `Scope`,
+/// and have them freed at once when the request completes.
+class ArenaAllocator : public Allocator {
+ private:
+  struct Chunk;
+
+ public:
+  static constexpr Capabilities kCapabilities = kSkipsDestroy;
+
+  /// Records the state of an arena, in order to release memory back to it.
+  ///
+  /// A marker is invalidated when memory is released to an earlier marker.
+  class Marker {
+   private:
+    friend class ArenaAllocator;
+
+    constexpr Marker() = default;
+    constexpr Marker(Chunk* chunk,
+                     std::byte* next,
+                     internal::GenericOwned* owned)
+        : chunk_(chunk), next_(next), owned_(owned) {}
+
+    Chunk* chunk_ = nullptr;
+    std::byte* next_ = nullptr;
+    internal::GenericOwned* owned_ = nullptr;
+  };
+
+  /// Releases all memory allocated from an arena during its lifetime.
+  ///
+  /// Scopes may be nested, but must be destroyed in reverse order of their
+  /// construction.
+  class Scope {
+   public:
+    explicit Scope(ArenaAllocator& arena)
+        : arena_(arena), marker_(arena.Mark()) {}
+
+    ~Scope() { arena_.Release(marker_); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    ArenaAllocator& arena_;
+    Marker marker_;
+  };
+
+  /// Constructs an ArenaAllocator without initializing it.
+  constexpr ArenaAllocator() : Allocator(kCapabilities) {}
+
+  /// Constructs an ArenaAllocator and initializes it.
+  explicit ArenaAllocator(ByteSpan region) : ArenaAllocator() { Init(region); }
+
+  /// Constructs an ArenaAllocator that allocates all of its memory from a
+  /// parent allocator.
+  ///
+  /// @param[in]  parent      Allocator used to allocate additional chunks.
+  /// @param[in]  chunk_size  Minimum size of each additional chunk, including
+  ///                         its bookkeeping overhead.
+  ArenaAllocator(Allocator& parent, size_t chunk_size)
+      : ArenaAllocator(ByteSpan(), parent, chunk_size) {}
+
+  /// Constructs an ArenaAllocator that allocates from the given region first,
+  /// and from a parent allocator once the region is exhausted.
+  ///
+  /// @param[in]  region      Initial region of memory to allocate from.
+  /// @param[in]  parent      Allocator used to allocate additional chunks.
+  /// @param[in]  chunk_size  Minimum size of each additional chunk, including
+  ///                         its bookkeeping overhead.
+  ArenaAllocator(ByteSpan region, Allocator& parent, size_t chunk_size)
+      : ArenaAllocator() {
+    parent_ = &parent;
+    chunk_size_ = chunk_size;
+    Init(region);
+  }
+
+  ~ArenaAllocator() override { Reset(); }
+
+  /// Sets the initial memory region to be used by the allocator.
+  ///
+  /// Any memory previously allocated is released.
+  void Init(ByteSpan region);
+
+  /// Returns a marker that can be used to release all memory allocated after
+  /// this call.
+  Marker Mark() const { return Marker(chunk_, next_, owned_); }
+
+  /// Frees all memory allocated since the given marker was created.
+  ///
+  /// Owned objects allocated since then are destroyed, and any chunks
+  /// allocated from the parent allocator since then are returned to it.
+  void Release(const Marker& marker);
+
+  /// Frees all memory allocated from this arena.
+  void Reset() { Release(Marker(nullptr, region_.data(), nullptr)); }
+
+  /// @copydoc BumpAllocator::NewOwned
+  template <typename T, int&... ExplicitGuard, typename... Args>
+  T* NewOwned(Args&&... args) {
+    internal::Owned<T>* owned = New<internal::Owned<T>>();
+    T* ptr = owned != nullptr ? New<T>(std::forward<Args>(args)...) : nullptr;
+    if (ptr != nullptr) {
+      owned->set_object(ptr);
+      owned->set_next(owned_);
+      owned_ = owned;
+    }
+    return ptr;
+  }
+
+  /// @copydoc BumpAllocator::MakeUniqueOwned
+  template <typename T, int&... ExplicitGuard, typename... Args>
+  [[nodiscard]] UniquePtr<T> MakeUniqueOwned(Args&&... args) {
+    return WrapUnique<T>(NewOwned<T>(std::forward<Args>(args)...));
+  }
+
+ private:
+  /// Header at the start of each chunk allocated from the parent.
+  struct Chunk {
+    Chunk* prev;
+    size_t size;
+  };
+
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override;
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void*) override;
+
+  /// Allocates from the current region or chunk, or returns null if there is
+  /// not enough space.
+  void* AllocateFromCurrent(Layout layout);
+
+  /// Allocates a chunk from the parent allocator large enough to satisfy the
+  /// given layout, and makes it current. Returns whether it succeeded.
+  bool AddChunk(Layout layout);
+
+  /// Returns the end of the current region or chunk.
+  std::byte* limit() const;
+
+  Allocator* parent_ = nullptr;
+  size_t chunk_size_ = 0;
+  ByteSpan region_;
+  Chunk* chunk_ = nullptr;
+  std::byte* next_ = nullptr;
+  internal::GenericOwned* owned_ = nullptr;
+};
+
+}  // namespace pw::allocator
@@ -684,7 +684,17 @@ StatusWithSize Block<OffsetType, kAlign, kCanPoison>::CanAllocLast(
     // Requested size does not fit.
     return StatusWithSize::ResourceExhausted();
   }
-  return StatusWithSize(next - addr);
+  size_t pad_size = next - addr;
+  if (Prev() == nullptr && pad_size != 0 && pad_size <= kBlockOverhead) {
+    // The first block has no previous block to shift a small amount of padding
+    // to, and does not have room to split off a new block. Leave the padding
+    // at the end of the block instead, if the block is already aligned.
+    if (addr % alignment != 0) {
+      return StatusWithSize::ResourceExhausted();
+    }
+    pad_size = 0;
+  }
+  return StatusWithSize(pad_size);
 }
 
 template <typename OffsetType, size_t kAlign, bool kCanPoison>
@@ -776,6 +786,7 @@ Status Block<OffsetType, kAlign, kCanPoison>::Resize(Block*& block,
   new_inner_size = AlignUp(new_inner_size, kAlignment);
 
   if (old_inner_size == new_inner_size) {
+    block->padding_ = old_inner_size - requested_inner_size;
     return OkStatus();
   }
 
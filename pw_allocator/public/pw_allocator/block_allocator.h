@@ -343,16 +343,18 @@ bool BlockAllocator<OffsetType, kPoisonInterval, kAlign>::DoResize(
     ReserveBlock(block->Next());
   }
 
-  if (!BlockType::Resize(block, new_size).ok()) {
-    return false;
+  // On failure, the block is restored, but the next block still needs to be
+  // recycled.
+  bool resized = BlockType::Resize(block, new_size).ok();
+  if (resized) {
+    UpdateLast(block);
   }
-  UpdateLast(block);
 
   if (NextIsFree(block)) {
     RecycleBlock(block->Next());
   }
 
-  return true;
+  return resized;
 }
 
 template <typename OffsetType, uint16_t kPoisonInterval, uint16_t kAlign>
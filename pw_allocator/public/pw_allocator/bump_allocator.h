@@ -24,6 +24,7 @@ namespace internal {
 class GenericOwned {
  public:
   virtual ~GenericOwned() = default;
+  GenericOwned* next() const { return next_; }
   void set_next(GenericOwned* next) { next_ = next; }
   void Destroy() { DoDestroy(); }
 
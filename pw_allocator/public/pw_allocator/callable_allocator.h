@@ -0,0 +1,140 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/layout.h"
+#include "pw_allocator/pool.h"
+#include "pw_assert/assert.h"
+#include "pw_function/function.h"
+#include "pw_preprocessor/compiler.h"
+
+namespace pw::allocator {
+
+/// Standard library-style allocator that allocates from a `pw::Allocator` or
+/// `pw::allocator::Pool`, such as a `TypedPool`, with static storage duration.
+///
+/// The allocator or pool is a template parameter rather than a member, so that
+/// `CallableAllocator` is stateless. This lets it be used as the `Allocator`
+/// parameter of `pw::Function` and `pw::Callback`, which require that any two
+/// allocators of the same type are equal.
+///
+/// NOTE! This class asserts if allocation fails, or if a pool's chunks are too
+/// small for the requested type.
+///
+/// @tparam   kSource   The `pw::Allocator` or `pw::allocator::Pool` to
+///                     allocate from.
+/// @tparam   T         The type of object to allocate memory for.
+template <auto& kSource, typename T = std::byte>
+class CallableAllocator {
+ private:
+  using Source = std::remove_reference_t<decltype(kSource)>;
+
+  static constexpr bool kIsAllocator = std::is_base_of_v<Allocator, Source>;
+  static_assert(kIsAllocator || std::is_base_of_v<Pool, Source>,
+                "CallableAllocator must refer to an Allocator or a Pool");
+
+ public:
+  using value_type = T;
+  using is_always_equal = std::true_type;
+
+  template <typename U>
+  struct rebind {
+    using other = CallableAllocator<kSource, U>;
+  };
+
+  constexpr CallableAllocator() = default;
+
+  template <typename U>
+  constexpr CallableAllocator(const CallableAllocator<kSource, U>&) {}
+
+  T* allocate(size_t n) {
+    size_t size;
+    PW_ASSERT(!PW_MUL_OVERFLOW(sizeof(T), n, &size));
+    const Layout layout(size, alignof(T));
+    void* ptr;
+    if constexpr (kIsAllocator) {
+      ptr = static_cast<Allocator&>(kSource).Allocate(layout);
+    } else {
+      Pool& pool = static_cast<Pool&>(kSource);
+      PW_ASSERT(layout.size() <= pool.layout().size() &&
+                layout.alignment() <= pool.layout().alignment());
+      ptr = pool.Allocate();
+    }
+    PW_ASSERT(ptr != nullptr);
+    return static_cast<T*>(ptr);
+  }
+
+  void deallocate(T* ptr, size_t) {
+    static_cast<Deallocator&>(kSource).Deallocate(ptr);
+  }
+
+  template <typename U>
+  constexpr bool operator==(const CallableAllocator<kSource, U>&) const {
+    return true;
+  }
+
+  template <typename U>
+  constexpr bool operator!=(const CallableAllocator<kSource, U>&) const {
+    return false;
+  }
+};
+
+/// Version of `pw::Function` that stores callables larger than
+/// `inline_target_size` in memory from a specific `pw::Allocator` or
+/// `pw::allocator::Pool`, instead of the default allocator.
+///
+/// This is available regardless of `PW_FUNCTION_ENABLE_DYNAMIC_ALLOCATION`,
+/// so that callbacks which capture more state can spill into a dedicated
+/// allocator without increasing the size of every `pw::Function`.
+///
+/// Example:
+/// @code{.cpp}
+///
+///   struct Request { ... };
+///   TypedPool<std::array<std::byte, 64>>::Buffer<8> buffer;
+///   TypedPool<std::array<std::byte, 64>> pool(buffer);
+///
+///   FunctionWithAllocator<void(), pool> work = [request = Request()] {
+///     ...
+///   };
+///
+/// @endcode
+template <typename FunctionType,
+          auto& kSource,
+          size_t inline_target_size =
+              function_internal::config::kInlineCallableSize>
+using FunctionWithAllocator =
+    fit::function_impl<inline_target_size,
+                       /*require_inline=*/false,
+                       FunctionType,
+                       CallableAllocator<kSource>>;
+
+/// Version of `pw::Callback` that stores callables larger than
+/// `inline_target_size` in memory from a specific `pw::Allocator` or
+/// `pw::allocator::Pool`. The memory is released when the callback is called.
+template <typename FunctionType,
+          auto& kSource,
+          size_t inline_target_size =
+              function_internal::config::kInlineCallableSize>
+using CallbackWithAllocator =
+    fit::callback_impl<inline_target_size,
+                       /*require_inline=*/false,
+                       FunctionType,
+                       CallableAllocator<kSource>>;
+
+}  // namespace pw::allocator
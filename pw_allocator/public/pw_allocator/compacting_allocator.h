@@ -0,0 +1,210 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+
+#include "pw_allocator/fragmentation.h"
+#include "pw_allocator/layout.h"
+#include "pw_bytes/span.h"
+#include "pw_span/span.h"
+
+namespace pw::allocator {
+namespace internal {
+
+/// Size-independent compacting allocator.
+///
+/// Compared to `CompactingAllocator`, this implementation is size-agnostic
+/// with respect to the number of handles.
+class GenericCompactingAllocator final {
+ public:
+  /// Alignment of every allocation.
+  static constexpr size_t kAlignment = alignof(std::max_align_t);
+
+  /// Index returned when an allocation fails.
+  static constexpr size_t kInvalidIndex = std::numeric_limits<size_t>::max();
+
+  /// Constructs a compacting allocator.
+  ///
+  /// @param[in] table  Indirection table holding the current location of each
+  ///                   allocation.
+  explicit GenericCompactingAllocator(span<std::byte*> table) : table_(table) {}
+
+  /// Sets the memory region used by the allocator.
+  void Init(ByteSpan region);
+
+  /// Allocates memory, and returns the index of its entry in the table, or
+  /// `kInvalidIndex` if the request cannot be satisfied.
+  size_t Allocate(Layout layout);
+
+  /// Frees the memory at the given index of the table.
+  void Free(size_t index);
+
+  /// Returns the current location of the memory at the given index of the
+  /// table, or null if the index is not allocated.
+  void* Get(size_t index) const {
+    return index < table_.size() ? table_[index] : nullptr;
+  }
+
+  /// Moves all allocations to the start of the region.
+  void Compact();
+
+  /// Returns the number of bytes that can be reclaimed by compacting.
+  size_t reclaimable_bytes() const { return reclaimable_bytes_; }
+
+  /// Returns the number of bytes at the end of the region that are free.
+  size_t contiguous_free_bytes() const {
+    return static_cast<size_t>(end_ - top_);
+  }
+
+  /// Returns fragmentation information for the allocator's memory region.
+  Fragmentation MeasureFragmentation() const;
+
+ private:
+  /// Record that precedes each allocation.
+  struct alignas(kAlignment) Header {
+    /// Size of the allocation, excluding this header.
+    size_t size;
+
+    /// Index of the allocation in the table, or `kInvalidIndex` if free.
+    size_t index;
+  };
+
+  static Header* HeaderOf(void* ptr) {
+    return reinterpret_cast<Header*>(ptr) - 1;
+  }
+
+  span<std::byte*> table_;
+  std::byte* begin_ = nullptr;
+  std::byte* top_ = nullptr;
+  std::byte* end_ = nullptr;
+
+  /// Bytes used by freed allocations below `top_`, including their headers.
+  size_t reclaimable_bytes_ = 0;
+};
+
+}  // namespace internal
+
+/// Allocator that can defragment its memory by moving allocations.
+///
+/// Long-running programs that make allocations of varying sizes and lifetimes
+/// from a block allocator eventually fragment its memory: the free memory is
+/// split into many small blocks, and large requests fail even though enough
+/// memory is free in total. A compacting allocator avoids this by giving out
+/// handles instead of pointers. Each handle refers to an entry in an
+/// indirection table that holds the current location of its allocation. Since
+/// callers only find allocations through their handles, `Compact` can move
+/// all allocations to the start of the region, e.g. when the system is idle,
+/// and leave all free memory in one contiguous piece.
+///
+/// Allocations are made by incrementing a pointer, and freed memory is only
+/// reused after compacting. As a result:
+///
+/// * Allocating and freeing take constant time, except for finding an unused
+///   table entry, which takes linear time in the number of handles.
+/// * Compacting takes linear time in the number of allocations, and copies
+///   every allocation that follows freed memory.
+/// * Allocations have a small header, and are aligned to
+///   `alignof(std::max_align_t)`. Requests with larger alignments fail.
+///
+/// Since allocations are moved with `memmove`, they MUST only hold trivially
+/// copyable data, and MUST not hold pointers to themselves or to other
+/// allocations. Pointers returned by `Get` are invalidated by `Compact`.
+///
+/// This object is NOT thread-safe.
+///
+/// @tparam   kMaxHandles   Maximum number of outstanding allocations.
+template <size_t kMaxHandles>
+class CompactingAllocator {
+ public:
+  static_assert(kMaxHandles > 0, "at least one handle is required");
+
+  /// Refers to memory allocated from a `CompactingAllocator`.
+  ///
+  /// A default-constructed handle is invalid, as is one returned by a failed
+  /// allocation. A handle MUST not be used after it is freed.
+  class Handle {
+   public:
+    constexpr Handle() = default;
+
+    /// Returns whether this handle refers to an allocation.
+    explicit constexpr operator bool() const {
+      return index_ != internal::GenericCompactingAllocator::kInvalidIndex;
+    }
+
+   private:
+    friend class CompactingAllocator;
+
+    explicit constexpr Handle(size_t index) : index_(index) {}
+
+    size_t index_ = internal::GenericCompactingAllocator::kInvalidIndex;
+  };
+
+  /// Constructs an allocator. Callers must call `Init`.
+  CompactingAllocator() : table_{}, impl_(table_) {}
+
+  /// Constructs an allocator, and initializes it with the given memory region.
+  explicit CompactingAllocator(ByteSpan region) : CompactingAllocator() {
+    Init(region);
+  }
+
+  /// Sets the memory region used by the allocator.
+  ///
+  /// Any outstanding handles are invalidated.
+  void Init(ByteSpan region) { impl_.Init(region); }
+
+  /// Allocates memory with the given layout.
+  ///
+  /// Returns an invalid handle if there is not enough contiguous free memory
+  /// at the end of the region, if no handles are available, or if the
+  /// requested alignment is larger than `alignof(std::max_align_t)`. Callers
+  /// may try to `Compact` and allocate again.
+  Handle Allocate(Layout layout) { return Handle(impl_.Allocate(layout)); }
+
+  /// Frees the memory referred to by a handle.
+  ///
+  /// The memory is not reused until the allocator is compacted, unless it is
+  /// the most recent allocation.
+  void Free(Handle handle) { impl_.Free(handle.index_); }
+
+  /// Returns the current location of the memory referred to by a handle, or
+  /// null if the handle is invalid.
+  ///
+  /// The returned pointer is only valid until the next call to `Compact`.
+  void* Get(Handle handle) const { return impl_.Get(handle.index_); }
+
+  /// Moves all allocations to the start of the region, leaving all free memory
+  /// contiguous at the end.
+  void Compact() { impl_.Compact(); }
+
+  /// Returns the number of bytes that `Compact` would add to the contiguous
+  /// free memory.
+  size_t reclaimable_bytes() const { return impl_.reclaimable_bytes(); }
+
+  /// Returns the number of bytes at the end of the region that are free.
+  size_t contiguous_free_bytes() const { return impl_.contiguous_free_bytes(); }
+
+  /// Returns fragmentation information for the allocator's memory region.
+  Fragmentation MeasureFragmentation() const {
+    return impl_.MeasureFragmentation();
+  }
+
+ private:
+  std::array<std::byte*, kMaxHandles> table_;
+  internal::GenericCompactingAllocator impl_;
+};
+
+}  // namespace pw::allocator
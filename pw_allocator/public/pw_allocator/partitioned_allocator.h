@@ -0,0 +1,181 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/capability.h"
+#include "pw_allocator/layout.h"
+#include "pw_assert/assert.h"
+#include "pw_bytes/alignment.h"
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+
+namespace pw::allocator {
+
+/// Divides a heap into independently locked partitions.
+///
+/// Where `SynchronizedAllocator` serializes every request with a single lock,
+/// this allocator splits its region into `kNumPartitions` equally sized
+/// partitions, each managed by its own block allocator and guarded by its own
+/// lock. Each request is routed to the caller's "home" partition, as given by
+/// a function provided on construction, e.g. one that returns the index of the
+/// current core. If the home partition cannot satisfy a request, the other
+/// partitions are tried in turn.
+///
+/// Threads with different home partitions only contend for a lock when one of
+/// them steals memory from, or frees memory to, the other's partition. Memory
+/// is always returned to the partition it was allocated from, which is found
+/// from its address without locking.
+///
+/// The trade-off is fragmentation: a request may fail if no single partition
+/// has enough contiguous free memory, even if the heap as a whole does.
+///
+/// @tparam BlockAllocatorType  Type of each partition's allocator, e.g. a
+///                             `BlockAllocator`. Must be default-constructible
+///                             and provide `Init(ByteSpan)`.
+/// @tparam LockType            Type of the lock guarding each partition. Must
+///                             be default-constructible.
+/// @tparam kNumPartitions      Number of partitions.
+template <typename BlockAllocatorType,
+          typename LockType,
+          size_t kNumPartitions>
+class PartitionedAllocator : public Allocator {
+ public:
+  static_assert(kNumPartitions > 0);
+
+  static constexpr Capabilities kCapabilities =
+      BlockAllocatorType::kCapabilities;
+
+  /// Returns the index of the calling thread's home partition. Values of
+  /// `kNumPartitions` or more are wrapped.
+  using GetHomePartition = size_t (*)();
+
+  /// Constructs a PartitionedAllocator without initializing it.
+  explicit PartitionedAllocator(GetHomePartition get_home_partition)
+      : Allocator(kCapabilities), get_home_partition_(get_home_partition) {}
+
+  /// Constructs a PartitionedAllocator and initializes it.
+  PartitionedAllocator(ByteSpan region, GetHomePartition get_home_partition)
+      : PartitionedAllocator(get_home_partition) {
+    Init(region);
+  }
+
+  /// Divides the given region into partitions.
+  ///
+  /// This method is NOT thread-safe, and must be called before the allocator
+  /// is used.
+  void Init(ByteSpan region) {
+    base_ = reinterpret_cast<uintptr_t>(region.data());
+    partition_size_ = AlignDown(region.size() / kNumPartitions,
+                                alignof(std::max_align_t));
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+      partitions_[i].allocator.Init(
+          region.subspan(i * partition_size_, partition_size_));
+    }
+  }
+
+  /// Returns the index of the partition that the given memory was allocated
+  /// from, or `kNumPartitions` if it was not allocated from this object.
+  size_t PartitionOf(const void* ptr) const {
+    auto addr = reinterpret_cast<uintptr_t>(ptr);
+    if (addr < base_ || partition_size_ == 0) {
+      return kNumPartitions;
+    }
+    size_t index = (addr - base_) / partition_size_;
+    return index < kNumPartitions ? index : kNumPartitions;
+  }
+
+ private:
+  struct Partition {
+    mutable LockType lock;
+    BlockAllocatorType allocator;
+  };
+
+  /// Returns the partition that the given memory was allocated from. The
+  /// memory MUST have been allocated from this object.
+  Partition& GetOwner(const void* ptr) {
+    size_t index = PartitionOf(ptr);
+    PW_ASSERT(index < kNumPartitions);
+    return partitions_[index];
+  }
+
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override {
+    size_t home = get_home_partition_() % kNumPartitions;
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+      Partition& partition = partitions_[(home + i) % kNumPartitions];
+      std::lock_guard lock(partition.lock);
+      void* ptr = partition.allocator.Allocate(layout);
+      if (ptr != nullptr) {
+        return ptr;
+      }
+    }
+    return nullptr;
+  }
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr) override {
+    Partition& partition = GetOwner(ptr);
+    std::lock_guard lock(partition.lock);
+    partition.allocator.Deallocate(ptr);
+  }
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr, Layout) override { DoDeallocate(ptr); }
+
+  /// @copydoc Allocator::Resize
+  bool DoResize(void* ptr, size_t new_size) override {
+    Partition& partition = GetOwner(ptr);
+    std::lock_guard lock(partition.lock);
+    return partition.allocator.Resize(ptr, new_size);
+  }
+
+  /// @copydoc Deallocator::GetInfo
+  Result<Layout> DoGetInfo(InfoType info_type, const void* ptr) const override {
+    if (info_type == InfoType::kCapacity) {
+      size_t capacity = 0;
+      size_t alignment = 1;
+      for (const Partition& partition : partitions_) {
+        std::lock_guard lock(partition.lock);
+        Result<Layout> result = GetInfo(partition.allocator, info_type, ptr);
+        if (!result.ok()) {
+          return result;
+        }
+        capacity += result->size();
+        alignment = result->alignment();
+      }
+      return Layout(capacity, alignment);
+    }
+    size_t index = PartitionOf(ptr);
+    if (index == kNumPartitions) {
+      return Status::NotFound();
+    }
+    const Partition& partition = partitions_[index];
+    std::lock_guard lock(partition.lock);
+    return GetInfo(partition.allocator, info_type, ptr);
+  }
+
+  GetHomePartition get_home_partition_;
+  uintptr_t base_ = 0;
+  size_t partition_size_ = 0;
+  std::array<Partition, kNumPartitions> partitions_;
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,209 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/capability.h"
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_span/span.h"
+#include "pw_status/try.h"
+
+namespace pw::allocator {
+namespace internal {
+
+/// Size-independent slab allocator.
+///
+/// Compared to `SlabAllocator`, this implementation is size-agnostic with
+/// respect to the number of size classes.
+class GenericSlabAllocator final {
+ private:
+  struct Slab;
+
+ public:
+  static constexpr Capabilities kCapabilities =
+      kImplementsGetUsableLayout | kImplementsGetAllocatedLayout |
+      kImplementsGetCapacity | kImplementsRecognizes;
+
+  /// Slabs holding slots of a single size.
+  class SizeClass {
+   public:
+    explicit constexpr SizeClass(size_t slot_size) : slot_size_(slot_size) {}
+
+   private:
+    friend GenericSlabAllocator;
+
+    size_t slot_size_;
+    size_t slot_alignment_ = 0;
+    uint16_t slots_per_slab_ = 0;
+
+    /// List of slabs with free slots.
+    Slab* partial_ = nullptr;
+  };
+
+  /// Constructs a slab allocator.
+  ///
+  /// @param[in] size_classes   Size classes, by increasing slot size.
+  /// @param[in] slab_size      Size of each slab. Must be a power of two.
+  GenericSlabAllocator(span<SizeClass> size_classes, size_t slab_size);
+
+  /// Sets the memory used to allocate slabs.
+  void Init(ByteSpan region);
+
+  /// @copydoc Allocator::Allocate
+  void* Allocate(Layout layout);
+
+  /// @copydoc Deallocator::Deallocate
+  void Deallocate(void* ptr);
+
+  /// Returns the total capacity of this allocator.
+  size_t GetCapacity() const { return region_.size(); }
+
+  /// Returns the layout of the slot for a given pointer.
+  Result<Layout> GetLayout(const void* ptr) const;
+
+  /// Ensures all allocations have been freed. Crashes with a diagnostic message
+  /// If any allocations remain outstanding.
+  void CrashIfAllocated();
+
+ private:
+  /// Returns the slab containing `ptr`, or null if it is not in the region.
+  Slab* GetSlab(const void* ptr) const;
+
+  /// Returns a slab that is not used by any size class.
+  Slab* TakeFreeSlab();
+
+  /// Returns the slot of `ptr` within `slab`, or an error if `ptr` is not the
+  /// start of an allocated slot.
+  Result<size_t> GetSlot(const Slab& slab, const void* ptr) const;
+
+  std::byte* SlotsOf(Slab& slab) const;
+
+  span<SizeClass> size_classes_;
+  size_t slab_size_;
+  size_t header_size_;
+  ByteSpan region_;
+
+  /// Number of slabs at the start of the region that have ever been used.
+  size_t used_slabs_ = 0;
+
+  /// List of previously used slabs that do not belong to a size class.
+  Slab* free_slabs_ = nullptr;
+};
+
+}  // namespace internal
+
+/// Allocator that carves fixed-size slots out of slabs of memory.
+///
+/// The region of memory is divided into slabs of `kSlabSize` bytes, which are
+/// assigned to size classes as needed. Each slab holds equally sized slots of
+/// one of `kSlotSizes`, and tracks which of them are free using a bitmap. As a
+/// result:
+///
+/// * Allocating and freeing take constant time, and never split or merge
+///   memory.
+/// * There is no external fragmentation within a size class. Slabs that become
+///   empty are returned to be used by any size class, except for the last slab
+///   with free slots in each size class.
+/// * Requests are rounded up to the smallest slot size that fits them.
+/// * The maximum alignment of a slot is the largest power of two dividing its
+///   size, up to `alignof(std::max_align_t)`.
+/// * The maximum size of an allocation is the largest slot size.
+///
+/// Use this allocator for many small objects whose sizes are known, e.g.
+/// messages or connection state.
+///
+/// @tparam   kSlabSize   Size of each slab. Must be a power of two. Each slab
+///                       holds a small header.
+/// @tparam   kSlotSizes  Sizes of the slots of each size class, in increasing
+///                       order.
+template <size_t kSlabSize, size_t... kSlotSizes>
+class SlabAllocator : public Allocator {
+ private:
+  using SizeClass = internal::GenericSlabAllocator::SizeClass;
+
+  static constexpr bool SlotSizesIncrease() {
+    std::array<size_t, sizeof...(kSlotSizes)> sizes = {kSlotSizes...};
+    for (size_t i = 1; i < sizes.size(); ++i) {
+      if (sizes[i] <= sizes[i - 1]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ public:
+  static_assert(sizeof...(kSlotSizes) > 0, "at least one size is required");
+  static_assert((kSlabSize & (kSlabSize - 1)) == 0,
+                "kSlabSize must be a power of 2");
+  static_assert(((kSlotSizes > 0) && ...), "slot sizes must be positive");
+  static_assert(SlotSizesIncrease(), "slot sizes must increase");
+
+  /// Constructs an allocator. Callers must call `Init`.
+  SlabAllocator()
+      : Allocator(internal::GenericSlabAllocator::kCapabilities),
+        size_classes_{SizeClass(kSlotSizes)...},
+        impl_(size_classes_, kSlabSize) {}
+
+  /// Constructs an allocator, and initializes it with the given memory region.
+  ///
+  /// @param[in]  region  Region of memory to use when satisfying allocation
+  ///                     requests. The region MUST be large enough to fit at
+  ///                     least one slab aligned to `kSlabSize`.
+  SlabAllocator(ByteSpan region) : SlabAllocator() { Init(region); }
+
+  /// Sets the memory region used by the allocator.
+  ///
+  /// @param[in]  region  Region of memory to use when satisfying allocation
+  ///                     requests. The region MUST be large enough to fit at
+  ///                     least one slab aligned to `kSlabSize`.
+  void Init(ByteSpan region) { impl_.Init(region); }
+
+  ~SlabAllocator() override { impl_.CrashIfAllocated(); }
+
+ private:
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override { return impl_.Allocate(layout); }
+
+  /// @copydoc Deallocator::DoDeallocate
+  void DoDeallocate(void* ptr) override { impl_.Deallocate(ptr); }
+
+  /// @copydoc Deallocator::GetInfo
+  Result<Layout> DoGetInfo(InfoType info_type, const void* ptr) const override {
+    switch (info_type) {
+      case InfoType::kUsableLayoutOf:
+      case InfoType::kAllocatedLayoutOf:
+        return impl_.GetLayout(ptr);
+      case InfoType::kCapacity:
+        return Layout(impl_.GetCapacity(), kSlabSize);
+      case InfoType::kRecognizes: {
+        Layout layout;
+        PW_TRY_ASSIGN(layout, impl_.GetLayout(ptr));
+        return Layout();
+      }
+      case InfoType::kRequestedLayoutOf:
+      default:
+        return Status::Unimplemented();
+    }
+  }
+
+  std::array<SizeClass, sizeof...(kSlotSizes)> size_classes_;
+  internal::GenericSlabAllocator impl_;
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,227 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/layout.h"
+#include "pw_result/result.h"
+
+namespace pw::allocator {
+
+/// Caches small allocations from a block allocator shared by several threads.
+///
+/// Each thread, or core, that allocates from the shared allocator uses its own
+/// `ThreadCacheAllocator`. Small requests are rounded up to one of
+/// `kNumSizeClasses` power-of-two size classes, starting at `kMinSize`, and
+/// freed memory is kept in a list per size class for reuse. Only refilling an
+/// empty list and flushing a full one acquire the shared lock, and each moves
+/// half a list at once, so most requests do not contend with other threads.
+///
+/// Cached memory remains allocated from the shared allocator until the cache
+/// is flushed or destroyed. Memory may be freed by any cache that shares the
+/// allocator, e.g. when passing objects between threads.
+///
+/// This object itself is NOT thread-safe. It must only be used by one thread
+/// at a time.
+///
+/// @tparam BlockAllocatorType  Type of the shared allocator, e.g. a
+///                             `BlockAllocator`. Must provide a `BlockType`.
+/// @tparam LockType            Type of the lock guarding the shared allocator.
+/// @tparam kNumSizeClasses     Number of cached size classes.
+/// @tparam kMinSize            Size of the smallest size class. Must be a power
+///                             of two large enough to hold a pointer.
+/// @tparam kMaxCachedPerClass  Maximum number of cached chunks per size class.
+template <typename BlockAllocatorType,
+          typename LockType,
+          size_t kNumSizeClasses = 4,
+          size_t kMinSize = 16,
+          size_t kMaxCachedPerClass = 8>
+class ThreadCacheAllocator : public Allocator {
+ private:
+  using BlockType = typename BlockAllocatorType::BlockType;
+
+ public:
+  static_assert(kNumSizeClasses > 0);
+  static_assert((kMinSize & (kMinSize - 1)) == 0,
+                "kMinSize must be a power of two");
+  static_assert(kMinSize >= sizeof(void*),
+                "kMinSize must be large enough to hold a pointer");
+  static_assert(kMaxCachedPerClass > 0);
+
+  /// Size of the largest size class. Larger requests are passed through to the
+  /// shared allocator.
+  static constexpr size_t kMaxCachedSize = kMinSize << (kNumSizeClasses - 1);
+
+  /// Number of chunks moved to or from the shared allocator at once.
+  static constexpr size_t kBatchSize =
+      std::max(kMaxCachedPerClass / 2, size_t(1));
+
+  /// Constructor.
+  ///
+  /// @param[in]  allocator  Allocator shared with other threads.
+  /// @param[in]  lock       Lock that guards every use of `allocator`.
+  ThreadCacheAllocator(BlockAllocatorType& allocator, LockType& lock)
+      : Allocator(allocator.capabilities()),
+        allocator_(allocator),
+        lock_(lock) {}
+
+  ~ThreadCacheAllocator() override { Flush(); }
+
+  /// Returns all cached memory to the shared allocator.
+  void Flush() {
+    std::lock_guard lock(lock_);
+    for (SizeClass& size_class : size_classes_) {
+      Release(size_class, size_class.count);
+    }
+  }
+
+  /// Returns the number of chunks cached for requests of `size` bytes.
+  size_t cached_count(size_t size) const {
+    size_t index = RequestIndex(size);
+    return index < kNumSizeClasses ? size_classes_[index].count : 0;
+  }
+
+ private:
+  /// Freed memory, linked in a list within each size class.
+  struct FreeChunk {
+    FreeChunk* next;
+  };
+
+  struct SizeClass {
+    FreeChunk* head = nullptr;
+    size_t count = 0;
+  };
+
+  static constexpr size_t ChunkSize(size_t index) { return kMinSize << index; }
+
+  /// Returns the index of the smallest size class that holds `size` bytes, or
+  /// `kNumSizeClasses` if none does.
+  static size_t RequestIndex(size_t size) {
+    size_t index = 0;
+    while (index < kNumSizeClasses && ChunkSize(index) < size) {
+      ++index;
+    }
+    return index;
+  }
+
+  /// Returns the index of the size class that memory with `inner_size` usable
+  /// bytes may be cached in, or `kNumSizeClasses` if it is too small or large.
+  static size_t FreeIndex(size_t inner_size) {
+    if (inner_size < kMinSize || inner_size >= 2 * kMaxCachedSize) {
+      return kNumSizeClasses;
+    }
+    size_t index = kNumSizeClasses - 1;
+    while (ChunkSize(index) > inner_size) {
+      --index;
+    }
+    return index;
+  }
+
+  static void Push(SizeClass& size_class, void* ptr) {
+    size_class.head = new (ptr) FreeChunk{size_class.head};
+    ++size_class.count;
+  }
+
+  static void* Pop(SizeClass& size_class) {
+    FreeChunk* chunk = size_class.head;
+    size_class.head = chunk->next;
+    --size_class.count;
+    return chunk;
+  }
+
+  /// Moves up to `kBatchSize` chunks from the shared allocator to the cache.
+  void Refill(size_t index) {
+    std::lock_guard lock(lock_);
+    Layout layout(ChunkSize(index), BlockType::kAlignment);
+    for (size_t i = 0; i < kBatchSize; ++i) {
+      void* ptr = allocator_.Allocate(layout);
+      if (ptr == nullptr) {
+        break;
+      }
+      Push(size_classes_[index], ptr);
+    }
+  }
+
+  /// Moves `count` chunks from the cache to the shared allocator.
+  ///
+  /// The lock MUST be held.
+  void Release(SizeClass& size_class, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      allocator_.Deallocate(Pop(size_class));
+    }
+  }
+
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override {
+    size_t index = RequestIndex(layout.size());
+    if (index == kNumSizeClasses ||
+        layout.alignment() > BlockType::kAlignment) {
+      std::lock_guard lock(lock_);
+      return allocator_.Allocate(layout);
+    }
+    SizeClass& size_class = size_classes_[index];
+    if (size_class.head == nullptr) {
+      Refill(index);
+      if (size_class.head == nullptr) {
+        return nullptr;
+      }
+    }
+    return Pop(size_class);
+  }
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr) override {
+    // Only the owner of an allocated block resizes it, so its size can be read
+    // without the lock.
+    size_t index = FreeIndex(BlockType::FromUsableSpace(ptr)->InnerSize());
+    if (index == kNumSizeClasses) {
+      std::lock_guard lock(lock_);
+      allocator_.Deallocate(ptr);
+      return;
+    }
+    SizeClass& size_class = size_classes_[index];
+    if (size_class.count == kMaxCachedPerClass) {
+      std::lock_guard lock(lock_);
+      Release(size_class, kBatchSize);
+    }
+    Push(size_class, ptr);
+  }
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr, Layout) override { DoDeallocate(ptr); }
+
+  /// @copydoc Allocator::Resize
+  bool DoResize(void* ptr, size_t new_size) override {
+    std::lock_guard lock(lock_);
+    return allocator_.Resize(ptr, new_size);
+  }
+
+  /// @copydoc Deallocator::GetInfo
+  Result<Layout> DoGetInfo(InfoType info_type, const void* ptr) const override {
+    std::lock_guard lock(lock_);
+    return GetInfo(allocator_, info_type, ptr);
+  }
+
+  BlockAllocatorType& allocator_;
+  LockType& lock_;
+  std::array<SizeClass, kNumSizeClasses> size_classes_;
+};
+
+}  // namespace pw::allocator
@@ -0,0 +1,330 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#include "pw_allocator/block_allocator.h"
+#include "pw_assert/assert.h"
+#include "pw_bytes/alignment.h"
+#include "pw_bytes/bit.h"
+
+namespace pw::allocator {
+
+/// Block allocator that uses a "two-level segregated fit" (TLSF) strategy.
+///
+/// In this strategy, free blocks are sorted into size classes. The classes are
+/// arranged in two levels: each first-level class covers a power-of-two range
+/// of sizes, and is evenly divided into `kNumSecondLevels` second-level
+/// classes. Each size class has a doubly linked list of free blocks, and a pair
+/// of bitmaps records which lists are non-empty.
+///
+/// The allocator handles an allocation request by rounding the request up to
+/// the next class boundary, and using the bitmaps to find the first non-empty
+/// class at or above it. Any block from that class is large enough, and so
+/// allocating, freeing, and merging blocks all take constant time, regardless
+/// of how many blocks the allocator has.
+///
+/// As an example, assume the block alignment is 8 and there are 4 first
+/// levels. The size classes would be:
+///
+/// @code{.unparsed}
+/// first level 0: [0, 8), [8, 16), [16, 24), ..., [56, 64)
+/// first level 1: [64, 72), [72, 80), [80, 88), ..., [120, 128)
+/// first level 2: [128, 144), [144, 160), [160, 176), ..., [240, 256)
+/// first level 3: [256, 288), [288, 320), [320, 352), ..., [480, unbounded)
+/// @endcode
+///
+/// The last class is unbounded. Requests that round up to it are satisfied by
+/// searching that class for a large enough block, and so take linear time.
+/// `kNumFirstLevels` should be chosen so that this is rare, i.e. so that
+/// `kMinUnboundedSize` is at least as large as most of the allocations.
+///
+/// Note that since this allocator stores information in free blocks, it does
+/// not currently support poisoning.
+template <typename OffsetType = uintptr_t,
+          size_t kNumFirstLevels = 16,
+          size_t kAlign = std::max(alignof(OffsetType), alignof(std::byte*))>
+class TlsfBlockAllocator
+    : public BlockAllocator<OffsetType,
+                            0,
+                            std::max(kAlign, alignof(std::byte*))> {
+ public:
+  using Base =
+      BlockAllocator<OffsetType, 0, std::max(kAlign, alignof(std::byte*))>;
+  using BlockType = typename Base::BlockType;
+
+  /// Number of second-level size classes in each first-level class.
+  static constexpr size_t kNumSecondLevels = 8;
+
+  /// Smallest inner size that maps to the unbounded size class.
+  static constexpr size_t kMinUnboundedSize =
+      (kNumSecondLevels * 2 - 1) *
+      ((kNumSecondLevels * BlockType::kAlignment) << (kNumFirstLevels - 2)) /
+      kNumSecondLevels;
+
+  /// Constexpr constructor. Callers must explicitly call `Init`.
+  constexpr TlsfBlockAllocator() : Base() {}
+
+  /// Non-constexpr constructor that automatically calls `Init`.
+  ///
+  /// @param[in]  region  Region of memory to use when satisfying allocation
+  ///                     requests. The region MUST be large enough to fit an
+  ///                     aligned block with overhead. It MUST NOT be larger
+  ///                     than what is addressable by `OffsetType`.
+  explicit TlsfBlockAllocator(ByteSpan region) : TlsfBlockAllocator() {
+    Base::Init(region);
+  }
+
+  /// @copydoc BlockAllocator::Init
+  void Init(ByteSpan region) { Base::Init(region); }
+
+  /// @copydoc BlockAllocator::Init
+  void Init(BlockType* begin) { Base::Init(begin); }
+
+  /// @copydoc BlockAllocator::Init
+  void Init(BlockType* begin, BlockType* end) override {
+    Base::Init(begin, end);
+    first_level_bitmap_ = 0;
+    second_level_bitmaps_.fill(0);
+    for (auto& free_lists : free_lists_) {
+      free_lists.fill(nullptr);
+    }
+    for (auto* block : Base::blocks()) {
+      if (!block->Used()) {
+        RecycleBlock(block);
+      }
+    }
+  }
+
+ private:
+  /// When free, each block's usable space holds pointers to the previous and
+  /// next free blocks in its size class.
+  struct FreeBlock {
+    static FreeBlock* From(BlockType* block) {
+      return std::launder(reinterpret_cast<FreeBlock*>(block->UsableSpace()));
+    }
+
+    BlockType* ToBlock() {
+      return BlockType::FromUsableSpace(
+          std::launder(reinterpret_cast<std::byte*>(this)));
+    }
+
+    FreeBlock* prev;
+    FreeBlock* next;
+  };
+
+  /// Identifies a size class by its first and second level indices.
+  struct SizeClass {
+    size_t first;
+    size_t second;
+  };
+
+  static constexpr size_t kSecondLevelShift =
+      cpp20::countr_zero(kNumSecondLevels);
+  static constexpr size_t kSmallSize = kNumSecondLevels * BlockType::kAlignment;
+  static constexpr size_t kSmallShift = cpp20::countr_zero(kSmallSize);
+
+  static_assert(kNumFirstLevels >= 2, "TLSF requires at least 2 first levels");
+  static_assert(kNumFirstLevels <= std::numeric_limits<uint32_t>::digits,
+                "TLSF first-level bitmap is too small");
+  static_assert(kSmallShift + kNumFirstLevels <
+                    std::numeric_limits<size_t>::digits,
+                "TLSF has too many first levels");
+
+  /// Returns the size class containing blocks of the given inner size.
+  static constexpr SizeClass MapToClass(size_t size) {
+    if (size < kSmallSize) {
+      return SizeClass{0, size / BlockType::kAlignment};
+    }
+    auto msb = static_cast<size_t>(cpp20::bit_width(size)) - 1;
+    size_t first = msb - kSmallShift + 1;
+    if (first >= kNumFirstLevels) {
+      return SizeClass{kNumFirstLevels - 1, kNumSecondLevels - 1};
+    }
+    size_t second = (size >> (msb - kSecondLevelShift)) - kNumSecondLevels;
+    return SizeClass{first, second};
+  }
+
+  /// Returns the lowest size class whose blocks all have at least the given
+  /// inner size, or the unbounded size class if there is none.
+  static constexpr SizeClass MapToClassRoundingUp(size_t size) {
+    if (size >= kMinUnboundedSize) {
+      return SizeClass{kNumFirstLevels - 1, kNumSecondLevels - 1};
+    }
+    if (size >= kSmallSize) {
+      auto msb = static_cast<size_t>(cpp20::bit_width(size)) - 1;
+      size += (size_t(1) << (msb - kSecondLevelShift)) - 1;
+    }
+    return MapToClass(size);
+  }
+
+  static constexpr bool IsUnbounded(SizeClass size_class) {
+    return size_class.first == kNumFirstLevels - 1 &&
+           size_class.second == kNumSecondLevels - 1;
+  }
+
+  /// @copydoc BlockAllocator::ChooseBlock
+  BlockType* ChooseBlock(Layout layout) override {
+    layout = Layout(std::max(layout.size(), sizeof(FreeBlock)),
+                    std::max(layout.alignment(), alignof(FreeBlock)));
+
+    // Any block with at least this much usable space can satisfy the request,
+    // no matter where the block is located.
+    size_t min_size = layout.size();
+    if (min_size < kMinUnboundedSize) {
+      min_size = AlignUp(min_size, BlockType::kAlignment);
+      if (layout.alignment() > BlockType::kAlignment) {
+        min_size += layout.alignment() - BlockType::kAlignment;
+      }
+    }
+
+    BlockType* block = FindBlock(min_size, layout);
+    if (block != nullptr && !block->CanAllocLast(layout).ok()) {
+      // Only the first block can fail here, since it has no previous block to
+      // shift a small amount of unaligned padding to. Look for a block with
+      // room to split off the padding instead.
+      min_size += BlockType::kBlockOverhead + BlockType::kAlignment;
+      block = FindBlock(min_size, layout);
+    }
+    if (block == nullptr) {
+      return nullptr;
+    }
+    ReserveBlock(block);
+    auto result = BlockType::AllocLast(block, layout);
+    if (!result.ok()) {
+      RecycleBlock(block);
+      return nullptr;
+    }
+    switch (*result) {
+      case BlockAllocType::kExact:
+        break;
+      case BlockAllocType::kNewPrev:
+        // The new free block needs to be added to a size class.
+        RecycleBlock(block->Prev());
+        break;
+      case BlockAllocType::kShiftToPrev:
+        // The previous block is guaranteed to be in use, and so is not in any
+        // size class, even if its size changes.
+        break;
+      case BlockAllocType::kNewNext:
+      case BlockAllocType::kNewPrevAndNewNext:
+      case BlockAllocType::kShiftToPrevAndNewNext:
+        // `AllocLast` never creates a trailing block.
+        PW_CRASH("unreachable");
+    }
+    return block;
+  }
+
+  /// Returns a free block with at least `min_size` bytes of usable space, or
+  /// null if there is no such block.
+  ///
+  /// If `min_size` rounds up to the unbounded size class, that class is
+  /// searched for a block that can satisfy `layout`.
+  BlockType* FindBlock(size_t min_size, Layout layout) {
+    SizeClass size_class = MapToClassRoundingUp(min_size);
+    if (IsUnbounded(size_class)) {
+      for (FreeBlock* free_block =
+               free_lists_[size_class.first][size_class.second];
+           free_block != nullptr;
+           free_block = free_block->next) {
+        BlockType* block = free_block->ToBlock();
+        if (block->CanAllocLast(layout).ok()) {
+          return block;
+        }
+      }
+      return nullptr;
+    }
+
+    // Look for a non-empty class in the same first level...
+    uint32_t second_level_bitmap =
+        second_level_bitmaps_[size_class.first] &
+        (~uint32_t(0) << size_class.second);
+
+    // ...or else in the next non-empty first level.
+    if (second_level_bitmap == 0) {
+      uint32_t first_level_bitmap =
+          first_level_bitmap_ & ~((uint32_t(2) << size_class.first) - 1);
+      if (first_level_bitmap == 0) {
+        return nullptr;
+      }
+      size_class.first =
+          static_cast<size_t>(cpp20::countr_zero(first_level_bitmap));
+      second_level_bitmap = second_level_bitmaps_[size_class.first];
+    }
+    size_class.second =
+        static_cast<size_t>(cpp20::countr_zero(second_level_bitmap));
+    return free_lists_[size_class.first][size_class.second]->ToBlock();
+  }
+
+  /// @copydoc BlockAllocator::ReserveBlock
+  void ReserveBlock(BlockType* block) override {
+    PW_ASSERT(!block->Used());
+    size_t inner_size = block->InnerSize();
+    if (inner_size < sizeof(FreeBlock)) {
+      return;
+    }
+    SizeClass size_class = MapToClass(inner_size);
+    FreeBlock*& head = free_lists_[size_class.first][size_class.second];
+    FreeBlock* free_block = FreeBlock::From(block);
+    if (free_block->prev != nullptr) {
+      free_block->prev->next = free_block->next;
+    } else {
+      head = free_block->next;
+    }
+    if (free_block->next != nullptr) {
+      free_block->next->prev = free_block->prev;
+    }
+    if (head == nullptr) {
+      second_level_bitmaps_[size_class.first] &=
+          ~(uint32_t(1) << size_class.second);
+      if (second_level_bitmaps_[size_class.first] == 0) {
+        first_level_bitmap_ &= ~(uint32_t(1) << size_class.first);
+      }
+    }
+  }
+
+  /// @copydoc BlockAllocator::RecycleBlock
+  void RecycleBlock(BlockType* block) override {
+    PW_ASSERT(!block->Used());
+    size_t inner_size = block->InnerSize();
+    if (inner_size < sizeof(FreeBlock)) {
+      return;
+    }
+    SizeClass size_class = MapToClass(inner_size);
+    FreeBlock*& head = free_lists_[size_class.first][size_class.second];
+    FreeBlock* free_block = FreeBlock::From(block);
+    free_block->prev = nullptr;
+    free_block->next = head;
+    if (head != nullptr) {
+      head->prev = free_block;
+    }
+    head = free_block;
+    second_level_bitmaps_[size_class.first] |= uint32_t(1)
+                                               << size_class.second;
+    first_level_bitmap_ |= uint32_t(1) << size_class.first;
+  }
+
+  uint32_t first_level_bitmap_ = 0;
+  std::array<uint32_t, kNumFirstLevels> second_level_bitmaps_ = {};
+  std::array<std::array<FreeBlock*, kNumSecondLevels>, kNumFirstLevels>
+      free_lists_ = {};
+};
+
+}  // namespace pw::allocator
@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <cstring>
 
+#include "pw_allocator/allocation_sites.h"
 #include "pw_allocator/allocator.h"
 #include "pw_allocator/capability.h"
 #include "pw_allocator/metrics.h"
@@ -64,6 +65,21 @@ class TrackingAllocator : public Allocator {
 
   const MetricsType& metrics() const { return metrics_.metrics(); }
 
+  /// Attributes allocations to the code that made them.
+  ///
+  /// The tracker's metric group is added as a child of this object's group.
+  /// This may be called at most once, and should be called before any
+  /// allocations are made; earlier allocations are not attributed to sites.
+  ///
+  /// Attribution relies on `GetRequestedLayout`, and so is only accurate if
+  /// the wrapped allocator reports the requested layout of its allocations,
+  /// e.g. as block allocators do.
+  void TrackAllocationSites(AllocationSiteTracker& sites) {
+    PW_ASSERT(sites_ == nullptr);
+    sites_ = &sites;
+    metrics_.group().Add(sites.metric_group());
+  }
+
  private:
   /// @copydoc Allocator::Allocate
   void* DoAllocate(Layout layout) override;
@@ -87,6 +103,7 @@ class TrackingAllocator : public Allocator {
 
   Allocator& allocator_;
   internal::Metrics<MetricsType> metrics_;
+  AllocationSiteTracker* sites_ = nullptr;
 };
 
 // Template method implementation.
@@ -103,6 +120,15 @@ void* TrackingAllocator<MetricsType>::DoAllocate(Layout layout) {
   metrics_.IncrementAllocations();
   metrics_.ModifyRequested(requested.size(), 0);
   metrics_.ModifyAllocated(allocated.size(), 0);
+  if (sites_ != nullptr) {
+    uint32_t site = sites_->current_site();
+    if (site == 0) {
+      // `Allocate` is inlined, so this is an address in its caller.
+      site = static_cast<uint32_t>(
+          reinterpret_cast<uintptr_t>(__builtin_return_address(0)));
+    }
+    sites_->RecordAllocation(site, new_ptr, requested.size());
+  }
   return new_ptr;
 }
 
@@ -114,6 +140,9 @@ void TrackingAllocator<MetricsType>::DoDeallocate(void* ptr) {
   metrics_.IncrementDeallocations();
   metrics_.ModifyRequested(0, requested.size());
   metrics_.ModifyAllocated(0, allocated.size());
+  if (sites_ != nullptr) {
+    sites_->RecordDeallocation(ptr, requested.size());
+  }
 }
 
 template <typename MetricsType>
@@ -129,6 +158,10 @@ bool TrackingAllocator<MetricsType>::DoResize(void* ptr, size_t new_size) {
   metrics_.IncrementResizes();
   metrics_.ModifyRequested(new_requested.size(), requested.size());
   metrics_.ModifyAllocated(new_allocated.size(), allocated.size());
+  if (sites_ != nullptr) {
+    sites_->RecordReallocation(
+        ptr, ptr, requested.size(), new_requested.size());
+  }
   return true;
 }
 
@@ -155,6 +188,10 @@ void* TrackingAllocator<MetricsType>::DoReallocate(void* ptr,
     // Reallocate performed "resize" without additional overhead.
     metrics_.ModifyAllocated(new_allocated.size(), allocated.size());
   }
+  if (sites_ != nullptr) {
+    sites_->RecordReallocation(
+        ptr, new_ptr, requested.size(), new_requested.size());
+  }
   return new_ptr;
 }
 
@@ -0,0 +1,272 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/slab_allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#include "pw_assert/check.h"
+#include "pw_bytes/alignment.h"
+#include "pw_bytes/bit.h"
+#include "pw_status/try.h"
+
+namespace pw::allocator::internal {
+namespace {
+
+using BitmapWord = uint32_t;
+constexpr size_t kBitsPerWord = std::numeric_limits<BitmapWord>::digits;
+constexpr BitmapWord kAllFree = std::numeric_limits<BitmapWord>::max();
+
+}  // namespace
+
+/// Header at the start of each slab, followed by the bitmap of its free slots.
+struct GenericSlabAllocator::Slab {
+  static constexpr uint16_t kUnassigned = std::numeric_limits<uint16_t>::max();
+
+  BitmapWord* bitmap() {
+    return std::launder(reinterpret_cast<BitmapWord*>(this + 1));
+  }
+  const BitmapWord* bitmap() const {
+    return std::launder(reinterpret_cast<const BitmapWord*>(this + 1));
+  }
+
+  /// Neighbors in the list of slabs with free slots, or of unassigned slabs.
+  Slab* prev = nullptr;
+  Slab* next = nullptr;
+
+  uint16_t size_class = kUnassigned;
+  uint16_t free_count = 0;
+};
+
+GenericSlabAllocator::GenericSlabAllocator(span<SizeClass> size_classes,
+                                           size_t slab_size)
+    : size_classes_(size_classes), slab_size_(slab_size) {
+  PW_CHECK_UINT_GT(size_classes_.size(), 0);
+  PW_CHECK_UINT_LT(size_classes_.size(), Slab::kUnassigned);
+
+  // Size the bitmap for the smallest slots, so all slabs share a header size.
+  size_t max_slots = slab_size_ / size_classes_.front().slot_size_;
+  size_t bitmap_words = (max_slots + kBitsPerWord - 1) / kBitsPerWord;
+  header_size_ = AlignUp(sizeof(Slab) + bitmap_words * sizeof(BitmapWord),
+                         alignof(std::max_align_t));
+  PW_CHECK_UINT_LT(header_size_,
+                   slab_size_,
+                   "Slabs of %zu bytes cannot fit a %zu byte header",
+                   slab_size_,
+                   header_size_);
+
+  for (SizeClass& size_class : size_classes_) {
+    size_t slot_size = size_class.slot_size_;
+    size_t slots = (slab_size_ - header_size_) / slot_size;
+    PW_CHECK_UINT_GT(slots,
+                     0,
+                     "Slots of %zu bytes do not fit in a slab of %zu bytes",
+                     slot_size,
+                     slab_size_);
+    size_class.slots_per_slab_ = static_cast<uint16_t>(
+        std::min(slots, size_t(std::numeric_limits<uint16_t>::max())));
+    size_class.slot_alignment_ =
+        std::min(slot_size & (~slot_size + 1), alignof(std::max_align_t));
+  }
+}
+
+void GenericSlabAllocator::Init(ByteSpan region) {
+  CrashIfAllocated();
+  region_ = GetAlignedSubspan(region, slab_size_);
+  PW_CHECK_INT_GE(region_.size(), slab_size_);
+  used_slabs_ = 0;
+  free_slabs_ = nullptr;
+  for (SizeClass& size_class : size_classes_) {
+    size_class.partial_ = nullptr;
+  }
+}
+
+void GenericSlabAllocator::CrashIfAllocated() {
+  size_t allocated = 0;
+  for (size_t i = 0; i < used_slabs_; ++i) {
+    const auto* slab = std::launder(
+        reinterpret_cast<const Slab*>(region_.data() + i * slab_size_));
+    if (slab->size_class != Slab::kUnassigned) {
+      size_t slots = size_classes_[slab->size_class].slots_per_slab_;
+      allocated += slots - slab->free_count;
+    }
+  }
+  PW_CHECK_INT_EQ(allocated,
+                  0,
+                  "%zu allocations were still in use when an allocator was "
+                  "destroyed. All memory allocated by an allocator must be "
+                  "released before the allocator goes out of scope.",
+                  allocated);
+  region_ = ByteSpan();
+  used_slabs_ = 0;
+}
+
+void* GenericSlabAllocator::Allocate(Layout layout) {
+  for (size_t index = 0; index < size_classes_.size(); ++index) {
+    SizeClass& size_class = size_classes_[index];
+    if (size_class.slot_size_ < layout.size() ||
+        size_class.slot_alignment_ < layout.alignment()) {
+      continue;
+    }
+
+    Slab* slab = size_class.partial_;
+    if (slab == nullptr) {
+      slab = TakeFreeSlab();
+      if (slab == nullptr) {
+        return nullptr;
+      }
+      slab->prev = nullptr;
+      slab->next = nullptr;
+      slab->size_class = static_cast<uint16_t>(index);
+      slab->free_count = size_class.slots_per_slab_;
+      BitmapWord* bitmap = slab->bitmap();
+      size_t words = size_class.slots_per_slab_ / kBitsPerWord;
+      std::fill(bitmap, bitmap + words, kAllFree);
+      if (size_t bits = size_class.slots_per_slab_ % kBitsPerWord; bits != 0) {
+        bitmap[words] = (BitmapWord(1) << bits) - 1;
+      }
+      size_class.partial_ = slab;
+    }
+
+    // Take the first free slot. The slab has at least one, so this terminates.
+    BitmapWord* bitmap = slab->bitmap();
+    size_t word = 0;
+    while (bitmap[word] == 0) {
+      ++word;
+    }
+    auto bit = static_cast<size_t>(cpp20::countr_zero(bitmap[word]));
+    bitmap[word] &= ~(BitmapWord(1) << bit);
+
+    // Full slabs are removed from the list, so they are not searched.
+    if (--slab->free_count == 0) {
+      size_class.partial_ = slab->next;
+      if (slab->next != nullptr) {
+        slab->next->prev = nullptr;
+      }
+      slab->next = nullptr;
+    }
+    return SlotsOf(*slab) + (word * kBitsPerWord + bit) * size_class.slot_size_;
+  }
+  return nullptr;
+}
+
+void GenericSlabAllocator::Deallocate(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  Slab* slab = GetSlab(ptr);
+  PW_CHECK_NOTNULL(slab, "Tried to free %p, which is not in any slab", ptr);
+  Result<size_t> slot = GetSlot(*slab, ptr);
+  PW_CHECK(slot.ok(), "Tried to free %p, which is not an allocated slot", ptr);
+
+  SizeClass& size_class = size_classes_[slab->size_class];
+  slab->bitmap()[*slot / kBitsPerWord] |= BitmapWord(1)
+                                          << (*slot % kBitsPerWord);
+
+  // A full slab has free slots again.
+  if (slab->free_count == 0) {
+    slab->prev = nullptr;
+    slab->next = size_class.partial_;
+    if (size_class.partial_ != nullptr) {
+      size_class.partial_->prev = slab;
+    }
+    size_class.partial_ = slab;
+  }
+  ++slab->free_count;
+
+  // Return empty slabs, but keep the last one with free slots to avoid
+  // reassigning a slab each time a single object is allocated and freed.
+  if (slab->free_count != size_class.slots_per_slab_ ||
+      (slab->prev == nullptr && slab->next == nullptr)) {
+    return;
+  }
+  if (slab->prev == nullptr) {
+    size_class.partial_ = slab->next;
+  } else {
+    slab->prev->next = slab->next;
+  }
+  if (slab->next != nullptr) {
+    slab->next->prev = slab->prev;
+  }
+  slab->size_class = Slab::kUnassigned;
+  slab->prev = nullptr;
+  slab->next = free_slabs_;
+  free_slabs_ = slab;
+}
+
+Result<Layout> GenericSlabAllocator::GetLayout(const void* ptr) const {
+  const Slab* slab = GetSlab(ptr);
+  if (slab == nullptr) {
+    return Status::OutOfRange();
+  }
+  PW_TRY(GetSlot(*slab, ptr).status());
+  const SizeClass& size_class = size_classes_[slab->size_class];
+  return Layout(size_class.slot_size_, size_class.slot_alignment_);
+}
+
+GenericSlabAllocator::Slab* GenericSlabAllocator::GetSlab(
+    const void* ptr) const {
+  auto addr = reinterpret_cast<uintptr_t>(ptr);
+  auto base = reinterpret_cast<uintptr_t>(region_.data());
+  if (addr < base || base + used_slabs_ * slab_size_ <= addr) {
+    return nullptr;
+  }
+  std::byte* slab = region_.data() + (addr - base) / slab_size_ * slab_size_;
+  return std::launder(reinterpret_cast<Slab*>(slab));
+}
+
+GenericSlabAllocator::Slab* GenericSlabAllocator::TakeFreeSlab() {
+  Slab* slab = free_slabs_;
+  if (slab != nullptr) {
+    free_slabs_ = slab->next;
+    return slab;
+  }
+  if (region_.size() < (used_slabs_ + 1) * slab_size_) {
+    return nullptr;
+  }
+  slab = new (region_.data() + used_slabs_ * slab_size_) Slab();
+  ++used_slabs_;
+  return slab;
+}
+
+Result<size_t> GenericSlabAllocator::GetSlot(const Slab& slab,
+                                             const void* ptr) const {
+  if (slab.size_class == Slab::kUnassigned) {
+    return Status::OutOfRange();
+  }
+  const SizeClass& size_class = size_classes_[slab.size_class];
+  auto addr = reinterpret_cast<uintptr_t>(ptr);
+  auto slots = reinterpret_cast<uintptr_t>(&slab) + header_size_;
+  if (addr < slots || (addr - slots) % size_class.slot_size_ != 0) {
+    return Status::OutOfRange();
+  }
+  size_t slot = (addr - slots) / size_class.slot_size_;
+  if (size_class.slots_per_slab_ <= slot) {
+    return Status::OutOfRange();
+  }
+  BitmapWord mask = BitmapWord(1) << (slot % kBitsPerWord);
+  if ((slab.bitmap()[slot / kBitsPerWord] & mask) != 0) {
+    return Status::FailedPrecondition();
+  }
+  return slot;
+}
+
+std::byte* GenericSlabAllocator::SlotsOf(Slab& slab) const {
+  return reinterpret_cast<std::byte*>(&slab) + header_size_;
+}
+
+}  // namespace pw::allocator::internal
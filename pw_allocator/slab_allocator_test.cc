@@ -0,0 +1,180 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/slab_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_containers/vector.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::Layout;
+
+constexpr size_t kSlabSize = 256;
+constexpr size_t kNumSlabs = 4;
+using SlabAllocator = ::pw::allocator::SlabAllocator<kSlabSize, 16, 48, 128>;
+
+class AllocatorType : public SlabAllocator {
+ public:
+  using SlabAllocator::SlabAllocator;
+
+  // Expose the protected info methods for test purposes.
+  pw::Result<Layout> GetUsableLayout(const void* ptr) const {
+    return SlabAllocator::GetUsableLayout(ptr);
+  }
+  bool Recognizes(const void* ptr) const {
+    return SlabAllocator::Recognizes(ptr);
+  }
+};
+
+class SlabAllocatorTest : public ::testing::Test {
+ protected:
+  alignas(kSlabSize) std::array<std::byte, kSlabSize * kNumSlabs> buffer_;
+};
+
+// Unit tests.
+
+TEST_F(SlabAllocatorTest, ExplicitlyInit) {
+  AllocatorType allocator;
+  allocator.Init(buffer_);
+}
+
+TEST_F(SlabAllocatorTest, GetCapacity) {
+  AllocatorType allocator(buffer_);
+  pw::StatusWithSize capacity = allocator.GetCapacity();
+  EXPECT_EQ(capacity.status(), pw::OkStatus());
+  EXPECT_EQ(capacity.size(), buffer_.size());
+}
+
+TEST_F(SlabAllocatorTest, AllocateRoundsUpToSlotSize) {
+  AllocatorType allocator(buffer_);
+  void* ptr = allocator.Allocate(Layout(20, 8));
+  ASSERT_NE(ptr, nullptr);
+  pw::Result<Layout> layout = allocator.GetUsableLayout(ptr);
+  ASSERT_EQ(layout.status(), pw::OkStatus());
+  EXPECT_EQ(layout->size(), 48u);
+  EXPECT_EQ(layout->alignment(), 16u);
+  allocator.Deallocate(ptr);
+}
+
+TEST_F(SlabAllocatorTest, AllocateReusesFreedSlot) {
+  AllocatorType allocator(buffer_);
+  void* ptr1 = allocator.Allocate(Layout(16, 1));
+  void* ptr2 = allocator.Allocate(Layout(16, 1));
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_NE(ptr1, ptr2);
+  allocator.Deallocate(ptr1);
+  EXPECT_EQ(allocator.Allocate(Layout(16, 1)), ptr1);
+  allocator.Deallocate(ptr1);
+  allocator.Deallocate(ptr2);
+}
+
+TEST_F(SlabAllocatorTest, AllocateAllSlots) {
+  AllocatorType allocator(buffer_);
+  pw::Vector<void*, kSlabSize * kNumSlabs / 16> ptrs;
+  while (true) {
+    void* ptr = allocator.Allocate(Layout(16, 1));
+    if (ptr == nullptr) {
+      break;
+    }
+    for (void* other : ptrs) {
+      ASSERT_NE(ptr, other);
+    }
+    ptrs.push_back(ptr);
+  }
+  EXPECT_GT(ptrs.size(), kNumSlabs * 12);
+
+  // Every slab is in use, so other size classes cannot allocate.
+  EXPECT_EQ(allocator.Allocate(Layout(48, 1)), nullptr);
+
+  while (!ptrs.empty()) {
+    allocator.Deallocate(ptrs.back());
+    ptrs.pop_back();
+  }
+}
+
+TEST_F(SlabAllocatorTest, EmptySlabsAreReusedByOtherSizeClasses) {
+  AllocatorType allocator(buffer_);
+  pw::Vector<void*, kSlabSize * kNumSlabs / 16> ptrs;
+  while (true) {
+    void* ptr = allocator.Allocate(Layout(16, 1));
+    if (ptr == nullptr) {
+      break;
+    }
+    ptrs.push_back(ptr);
+  }
+  while (!ptrs.empty()) {
+    allocator.Deallocate(ptrs.back());
+    ptrs.pop_back();
+  }
+
+  // One slab is kept for the small slots, and the others are free.
+  size_t count = 0;
+  while (true) {
+    void* ptr = allocator.Allocate(Layout(128, 1));
+    if (ptr == nullptr) {
+      break;
+    }
+    ptrs.push_back(ptr);
+    ++count;
+  }
+  EXPECT_EQ(count, kNumSlabs - 1);
+  while (!ptrs.empty()) {
+    allocator.Deallocate(ptrs.back());
+    ptrs.pop_back();
+  }
+}
+
+TEST_F(SlabAllocatorTest, AllocateExcessiveSize) {
+  AllocatorType allocator(buffer_);
+  EXPECT_EQ(allocator.Allocate(Layout(129, 1)), nullptr);
+}
+
+TEST_F(SlabAllocatorTest, AllocateAligned) {
+  AllocatorType allocator(buffer_);
+  void* ptr = allocator.Allocate(Layout(16, alignof(std::max_align_t)));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t), 0u);
+  allocator.Deallocate(ptr);
+}
+
+TEST_F(SlabAllocatorTest, AllocateExcessiveAlignment) {
+  AllocatorType allocator(buffer_);
+  EXPECT_EQ(allocator.Allocate(Layout(16, 2 * alignof(std::max_align_t))),
+            nullptr);
+}
+
+TEST_F(SlabAllocatorTest, GetInfoForUnknownPointers) {
+  AllocatorType allocator(buffer_);
+  void* ptr = allocator.Allocate(Layout(48, 1));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_TRUE(allocator.Recognizes(ptr));
+
+  auto* bytes = static_cast<std::byte*>(ptr);
+  EXPECT_FALSE(allocator.Recognizes(bytes + 1));
+  EXPECT_FALSE(allocator.Recognizes(bytes + 48));
+  EXPECT_FALSE(allocator.Recognizes(buffer_.data() + buffer_.size() - 1));
+
+  allocator.Deallocate(ptr);
+  EXPECT_FALSE(allocator.Recognizes(ptr));
+}
+
+}  // namespace
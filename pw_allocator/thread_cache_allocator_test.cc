@@ -0,0 +1,182 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/thread_cache_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/testing.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using ::pw::allocator::Layout;
+using ::pw::allocator::test::AllocatorForTest;
+
+// Test fixtures.
+
+/// Lock that counts how often it is acquired.
+class CountingLock {
+ public:
+  void lock() {
+    ++lock_count_;
+    locked_ = true;
+  }
+  void unlock() { locked_ = false; }
+
+  size_t lock_count() const { return lock_count_; }
+  bool locked() const { return locked_; }
+
+ private:
+  size_t lock_count_ = 0;
+  bool locked_ = false;
+};
+
+constexpr size_t kCapacity = 1024;
+
+using SharedAllocator = AllocatorForTest<kCapacity>;
+using CacheAllocator = ::pw::allocator::
+    ThreadCacheAllocator<SharedAllocator, CountingLock, 4, 16, 4>;
+
+class ThreadCacheAllocatorTest : public ::testing::Test {
+ protected:
+  ThreadCacheAllocatorTest() : cache_(shared_, lock_) {}
+
+  size_t allocated_bytes() const {
+    return shared_.metrics().allocated_bytes.value();
+  }
+
+  SharedAllocator shared_;
+  CountingLock lock_;
+  CacheAllocator cache_;
+};
+
+// Unit tests.
+
+TEST_F(ThreadCacheAllocatorTest, AllocateRefillsInBatches) {
+  std::array<void*, CacheAllocator::kBatchSize + 1> ptrs;
+  for (void*& ptr : ptrs) {
+    ptr = cache_.Allocate(Layout(24, 4));
+    ASSERT_NE(ptr, nullptr);
+  }
+  // The first batch served all but the last allocation.
+  EXPECT_EQ(lock_.lock_count(), 2u);
+  EXPECT_EQ(shared_.allocate_size(), 32u);
+  EXPECT_EQ(cache_.cached_count(24), CacheAllocator::kBatchSize - 1);
+
+  for (void* ptr : ptrs) {
+    cache_.Deallocate(ptr);
+  }
+}
+
+TEST_F(ThreadCacheAllocatorTest, DeallocateKeepsMemoryForReuse) {
+  void* ptr = cache_.Allocate(Layout(16, 1));
+  ASSERT_NE(ptr, nullptr);
+  size_t bytes = allocated_bytes();
+  size_t lock_count = lock_.lock_count();
+
+  cache_.Deallocate(ptr);
+  EXPECT_EQ(allocated_bytes(), bytes);
+  EXPECT_EQ(cache_.Allocate(Layout(8, 1)), ptr);
+  EXPECT_EQ(lock_.lock_count(), lock_count);
+  cache_.Deallocate(ptr);
+}
+
+TEST_F(ThreadCacheAllocatorTest, DeallocateReleasesBatchWhenFull) {
+  std::array<void*, 2 * CacheAllocator::kBatchSize + 1> ptrs;
+  for (void*& ptr : ptrs) {
+    ptr = cache_.Allocate(Layout(64, 1));
+    ASSERT_NE(ptr, nullptr);
+  }
+  // The last refill left one chunk cached.
+  EXPECT_EQ(cache_.cached_count(64), 1u);
+  for (size_t i = 0; i < 3; ++i) {
+    cache_.Deallocate(ptrs[i]);
+  }
+  EXPECT_EQ(cache_.cached_count(64), 4u);
+
+  // The full list is halved before the freed memory is cached.
+  size_t lock_count = lock_.lock_count();
+  cache_.Deallocate(ptrs[3]);
+  EXPECT_EQ(lock_.lock_count(), lock_count + 1);
+  EXPECT_EQ(cache_.cached_count(64), 3u);
+  cache_.Deallocate(ptrs[4]);
+}
+
+TEST_F(ThreadCacheAllocatorTest, LargeRequestsBypassCache) {
+  void* ptr = cache_.Allocate(Layout(CacheAllocator::kMaxCachedSize * 2, 1));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(shared_.allocate_size(), CacheAllocator::kMaxCachedSize * 2);
+  EXPECT_EQ(lock_.lock_count(), 1u);
+
+  cache_.Deallocate(ptr);
+  EXPECT_EQ(shared_.deallocate_ptr(), ptr);
+  EXPECT_EQ(lock_.lock_count(), 2u);
+  EXPECT_EQ(allocated_bytes(), 0u);
+}
+
+TEST_F(ThreadCacheAllocatorTest, OverAlignedRequestsBypassCache) {
+  void* ptr = cache_.Allocate(Layout(16, 64));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0u);
+  EXPECT_EQ(cache_.cached_count(16), 0u);
+  cache_.Deallocate(ptr);
+}
+
+TEST_F(ThreadCacheAllocatorTest, FlushReturnsCachedMemory) {
+  void* small = cache_.Allocate(Layout(16, 1));
+  void* medium = cache_.Allocate(Layout(100, 1));
+  ASSERT_NE(small, nullptr);
+  ASSERT_NE(medium, nullptr);
+  cache_.Deallocate(small);
+  cache_.Deallocate(medium);
+  EXPECT_NE(allocated_bytes(), 0u);
+
+  cache_.Flush();
+  EXPECT_EQ(cache_.cached_count(16), 0u);
+  EXPECT_EQ(cache_.cached_count(100), 0u);
+  EXPECT_EQ(allocated_bytes(), 0u);
+}
+
+TEST_F(ThreadCacheAllocatorTest, AllocateFailsWhenSharedAllocatorExhausted) {
+  shared_.Exhaust();
+  EXPECT_EQ(cache_.Allocate(Layout(16, 1)), nullptr);
+  EXPECT_FALSE(lock_.locked());
+}
+
+TEST_F(ThreadCacheAllocatorTest, CachesShareAllocator) {
+  CacheAllocator other(shared_, lock_);
+  void* ptr = cache_.Allocate(Layout(32, 1));
+  ASSERT_NE(ptr, nullptr);
+
+  // Memory may be freed by another thread's cache.
+  other.Deallocate(ptr);
+  EXPECT_EQ(other.cached_count(32), 1u);
+  EXPECT_EQ(other.Allocate(Layout(32, 1)), ptr);
+  other.Deallocate(ptr);
+}
+
+TEST_F(ThreadCacheAllocatorTest, ResizeForwardsToSharedAllocator) {
+  void* ptr = cache_.Allocate(Layout(16, 1));
+  ASSERT_NE(ptr, nullptr);
+  size_t lock_count = lock_.lock_count();
+  EXPECT_TRUE(cache_.Resize(ptr, 8));
+  EXPECT_EQ(shared_.resize_ptr(), ptr);
+  EXPECT_EQ(lock_.lock_count(), lock_count + 1);
+  cache_.Deallocate(ptr);
+}
+
+}  // namespace
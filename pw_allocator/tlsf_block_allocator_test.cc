@@ -0,0 +1,240 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_block_allocator.h"
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/block_allocator_testing.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+constexpr size_t kNumFirstLevels = 4;
+
+using ::pw::allocator::Layout;
+using ::pw::allocator::test::Preallocation;
+using TlsfBlockAllocator =
+    ::pw::allocator::TlsfBlockAllocator<uint16_t, kNumFirstLevels>;
+using BlockAllocatorTest =
+    ::pw::allocator::test::BlockAllocatorTest<TlsfBlockAllocator>;
+
+class TlsfBlockAllocatorTest : public BlockAllocatorTest {
+ public:
+  TlsfBlockAllocatorTest() : BlockAllocatorTest(allocator_) {}
+
+ private:
+  TlsfBlockAllocator allocator_;
+};
+
+// Unit tests.
+
+TEST_F(TlsfBlockAllocatorTest, CanAutomaticallyInit) {
+  TlsfBlockAllocator allocator(GetBytes());
+  CanAutomaticallyInit(allocator);
+}
+
+TEST_F(TlsfBlockAllocatorTest, CanExplicitlyInit) {
+  TlsfBlockAllocator allocator;
+  CanExplicitlyInit(allocator);
+}
+
+TEST_F(TlsfBlockAllocatorTest, GetCapacity) { GetCapacity(); }
+
+TEST_F(TlsfBlockAllocatorTest, AllocateLarge) { AllocateLarge(); }
+
+TEST_F(TlsfBlockAllocatorTest, AllocateSmall) { AllocateSmall(); }
+
+TEST_F(TlsfBlockAllocatorTest, AllocateTooLarge) { AllocateTooLarge(); }
+
+TEST_F(TlsfBlockAllocatorTest, AllocateLargeAlignment) {
+  AllocateLargeAlignment();
+}
+
+TEST_F(TlsfBlockAllocatorTest, AllocateAlignmentFailure) {
+  AllocateAlignmentFailure();
+}
+
+TEST_F(TlsfBlockAllocatorTest, AllocatesFromSmallestSufficientClass) {
+  // With an alignment of 8, the size classes near these blocks are:
+  //   [64, 72), [72, 80), ..., [128, 144), [144, 160), ...
+  auto& allocator = GetAllocator({
+      {kSmallerOuterSize, Preallocation::kUsed},
+      {144 + BlockType::kBlockOverhead, Preallocation::kUsed},
+      {kSmallerOuterSize, Preallocation::kUsed},
+      {72 + BlockType::kBlockOverhead, Preallocation::kUsed},
+      {kSmallerOuterSize, Preallocation::kUsed},
+      {64 + BlockType::kBlockOverhead, Preallocation::kUsed},
+      {Preallocation::kSizeRemaining, Preallocation::kUsed},
+  });
+
+  // Deallocate to fill size classes.
+  void* ptr1 = Fetch(1);
+  Store(1, nullptr);
+  allocator.Deallocate(ptr1);
+
+  void* ptr3 = Fetch(3);
+  Store(3, nullptr);
+  allocator.Deallocate(ptr3);
+
+  void* ptr5 = Fetch(5);
+  Store(5, nullptr);
+  allocator.Deallocate(ptr5);
+
+  // A request of 65 bytes rounds up to the [72, 80) class, and so skips the
+  // block in the [64, 72) class even though it would fit.
+  Store(3, allocator.Allocate(Layout(65, 1)));
+  EXPECT_EQ(Fetch(3), ptr3);
+
+  // A request of 64 bytes exactly matches the [64, 72) class.
+  Store(5, allocator.Allocate(Layout(64, 1)));
+  EXPECT_EQ(Fetch(5), ptr5);
+
+  // A request of 73 bytes rounds up to the [80, 88) class. The next non-empty
+  // class is [144, 160), and the allocation splits a leading block off it.
+  auto* block1 = BlockType::FromUsableSpace(ptr1);
+  Store(1, allocator.Allocate(Layout(73, 1)));
+  EXPECT_FALSE(block1->Used());
+  EXPECT_EQ(Fetch(1), block1->Next()->UsableSpace());
+}
+
+TEST_F(TlsfBlockAllocatorTest, UnusedPortionIsRecycled) {
+  auto& allocator = GetAllocator({
+      {128 + BlockType::kBlockOverhead, Preallocation::kUsed},
+      {Preallocation::kSizeRemaining, Preallocation::kUsed},
+  });
+
+  // Deallocate to fill size classes.
+  allocator.Deallocate(Fetch(0));
+  Store(0, nullptr);
+
+  Store(2, allocator.Allocate(Layout(65, 1)));
+  ASSERT_NE(Fetch(2), nullptr);
+
+  // The remainder should be recycled to a smaller size class.
+  Store(3, allocator.Allocate(Layout(32, 1)));
+  ASSERT_NE(Fetch(3), nullptr);
+}
+
+TEST_F(TlsfBlockAllocatorTest, ExhaustSizeClass) {
+  auto& allocator = GetAllocator({
+      {128 + BlockType::kBlockOverhead, Preallocation::kUsed},
+      {kSmallerOuterSize, Preallocation::kUsed},
+      {128 + BlockType::kBlockOverhead, Preallocation::kUsed},
+      {kSmallerOuterSize, Preallocation::kUsed},
+      {128 + BlockType::kBlockOverhead, Preallocation::kUsed},
+      {Preallocation::kSizeRemaining, Preallocation::kUsed},
+  });
+
+  // Deallocate to fill size classes.
+  allocator.Deallocate(Fetch(0));
+  Store(0, nullptr);
+  allocator.Deallocate(Fetch(2));
+  Store(2, nullptr);
+  allocator.Deallocate(Fetch(4));
+  Store(4, nullptr);
+
+  void* ptr0 = allocator.Allocate(Layout(65, 1));
+  EXPECT_NE(ptr0, nullptr);
+  Store(0, ptr0);
+
+  void* ptr2 = allocator.Allocate(Layout(65, 1));
+  EXPECT_NE(ptr2, nullptr);
+  Store(2, ptr2);
+
+  void* ptr4 = allocator.Allocate(Layout(65, 1));
+  EXPECT_NE(ptr4, nullptr);
+  Store(4, ptr4);
+
+  EXPECT_EQ(allocator.Allocate(Layout(65, 1)), nullptr);
+}
+
+TEST_F(TlsfBlockAllocatorTest, SearchesUnboundedClass) {
+  static_assert(TlsfBlockAllocator::kMinUnboundedSize == 480);
+  auto& allocator = GetAllocator({
+      {500 + BlockType::kBlockOverhead, Preallocation::kUsed},
+      {kSmallerOuterSize, Preallocation::kUsed},
+      {Preallocation::kSizeRemaining, Preallocation::kUsed},
+  });
+
+  // Deallocate to put a block in the unbounded size class.
+  void* ptr0 = Fetch(0);
+  Store(0, nullptr);
+  allocator.Deallocate(ptr0);
+
+  // Requests that round up to the unbounded class search it for a large enough
+  // block.
+  EXPECT_EQ(allocator.Allocate(Layout(512, 1)), nullptr);
+  Store(0, allocator.Allocate(Layout(500, 1)));
+  EXPECT_EQ(Fetch(0), ptr0);
+}
+
+TEST_F(TlsfBlockAllocatorTest, DeallocateNull) { DeallocateNull(); }
+
+TEST_F(TlsfBlockAllocatorTest, DeallocateShuffled) { DeallocateShuffled(); }
+
+TEST_F(TlsfBlockAllocatorTest, IterateOverBlocks) { IterateOverBlocks(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeNull) { ResizeNull(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeLargeSame) { ResizeLargeSame(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeLargeSmaller) { ResizeLargeSmaller(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeLargeLarger) { ResizeLargeLarger(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeLargeLargerFailure) {
+  ResizeLargeLargerFailure();
+}
+
+TEST_F(TlsfBlockAllocatorTest, ResizeSmallSame) { ResizeSmallSame(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeSmallSmaller) { ResizeSmallSmaller(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeSmallLarger) { ResizeSmallLarger(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeSmallLargerFailure) {
+  ResizeSmallLargerFailure();
+}
+
+TEST_F(TlsfBlockAllocatorTest, CanMeasureFragmentation) {
+  CanMeasureFragmentation();
+}
+
+TEST_F(TlsfBlockAllocatorTest, MergedBlocksChangeSizeClass) {
+  auto& allocator = GetAllocator({
+      {64 + BlockType::kBlockOverhead, Preallocation::kUsed},
+      {64, Preallocation::kUsed},
+      {kSmallerOuterSize, Preallocation::kUsed},
+      {Preallocation::kSizeRemaining, Preallocation::kUsed},
+  });
+
+  // Freeing adjacent blocks merges them into a block in a larger size class.
+  void* ptr0 = Fetch(0);
+  allocator.Deallocate(ptr0);
+  Store(0, nullptr);
+  allocator.Deallocate(Fetch(1));
+  Store(1, nullptr);
+
+  Store(0, allocator.Allocate(Layout(128, 1)));
+  EXPECT_EQ(Fetch(0), ptr0);
+
+  auto& tlsf_block_allocator = static_cast<TlsfBlockAllocator&>(allocator);
+  for (auto* block : tlsf_block_allocator.blocks()) {
+    ASSERT_TRUE(block->IsValid());
+  }
+}
+
+}  // namespace
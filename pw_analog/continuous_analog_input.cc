@@ -0,0 +1,136 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_analog/continuous_analog_input.h"
+
+#include <mutex>
+#include <utility>
+
+namespace pw::analog {
+
+Status ContinuousAnalogInput::Start(span<int32_t> first,
+                                    span<int32_t> second) {
+  if (first.empty() || first.size() != second.size()) {
+    return Status::InvalidArgument();
+  }
+  {
+    std::lock_guard lock(lock_);
+    if (running_) {
+      return Status::FailedPrecondition();
+    }
+    running_ = true;
+    buffers_ = {first, second};
+    filling_ = 0;
+    ready_ = kNoBlock;
+    claimed_ = kNoBlock;
+    claimed_overwritten_ = false;
+    completed_ = 0;
+    overruns_ = 0;
+  }
+
+  const Status status = DoStart(first, second);
+  if (!status.ok()) {
+    std::lock_guard lock(lock_);
+    running_ = false;
+  }
+  return status;
+}
+
+void ContinuousAnalogInput::Stop() {
+  {
+    std::lock_guard lock(lock_);
+    if (!running_) {
+      return;
+    }
+  }
+
+  DoStop();
+
+  async2::Waker waker;
+  {
+    std::lock_guard lock(lock_);
+    running_ = false;
+    ready_ = kNoBlock;
+    claimed_ = kNoBlock;
+    waker = std::move(waker_);
+  }
+  std::move(waker).Wake();
+}
+
+async2::Poll<Result<SampleBlock>> ContinuousAnalogInput::PendBlock(
+    async2::Context& cx) {
+  std::lock_guard lock(lock_);
+  if (!running_ || claimed_ != kNoBlock) {
+    return async2::Ready(Status::FailedPrecondition());
+  }
+  if (ready_ == kNoBlock) {
+    waker_ = cx.GetWaker(async2::WaitReason::Unspecified());
+    return async2::Pending();
+  }
+
+  claimed_ = ready_;
+  claimed_overwritten_ = false;
+  ready_ = kNoBlock;
+  return async2::Ready(SampleBlock{
+      .samples = buffers_[claimed_],
+      .timestamp = ready_timestamp_,
+      .sequence = ready_sequence_,
+      .overruns = overruns_,
+  });
+}
+
+Status ContinuousAnalogInput::ReleaseBlock() {
+  std::lock_guard lock(lock_);
+  if (claimed_ == kNoBlock) {
+    return Status::FailedPrecondition();
+  }
+  claimed_ = kNoBlock;
+  return claimed_overwritten_ ? Status::DataLoss() : OkStatus();
+}
+
+uint32_t ContinuousAnalogInput::overruns() const {
+  std::lock_guard lock(lock_);
+  return overruns_;
+}
+
+void ContinuousAnalogInput::BlockComplete(
+    chrono::SystemClock::time_point timestamp) {
+  async2::Waker waker;
+  {
+    std::lock_guard lock(lock_);
+    if (!running_) {
+      return;
+    }
+    const size_t completed = filling_;
+    filling_ = 1 - filling_;
+
+    // The backend is now overwriting the other buffer, so a block in it is
+    // lost if it wasn't claimed, or corrupted if it is still being processed.
+    if (ready_ == filling_) {
+      overruns_ += 1;
+    }
+    if (claimed_ == filling_ && !claimed_overwritten_) {
+      claimed_overwritten_ = true;
+      overruns_ += 1;
+    }
+
+    ready_ = completed;
+    ready_timestamp_ = timestamp;
+    ready_sequence_ = completed_++;
+    waker = std::move(waker_);
+  }
+  std::move(waker).Wake();
+}
+
+}  // namespace pw::analog
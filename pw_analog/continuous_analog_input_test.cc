@@ -0,0 +1,224 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_analog/continuous_analog_input.h"
+
+#include <array>
+#include <optional>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::analog {
+namespace {
+
+using ::pw::async2::Context;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+using ::pw::chrono::SystemClock;
+
+constexpr size_t kBlockSize = 4;
+
+// An input whose blocks are filled by the test, in place of DMA.
+class TestContinuousAnalogInput : public ContinuousAnalogInput {
+ public:
+  bool started() const { return started_; }
+
+  void FailOnStart(Status status) { start_status_ = status; }
+
+  // Fills the buffer being filled with value, and completes it.
+  void Complete(int32_t value, SystemClock::time_point timestamp) {
+    for (int32_t& sample : buffers_[filling_]) {
+      sample = value;
+    }
+    filling_ = 1 - filling_;
+    BlockComplete(timestamp);
+  }
+
+  AnalogInput::Limits GetLimits() const override { return {0, 4095}; }
+
+ private:
+  Status DoStart(span<int32_t> first, span<int32_t> second) override {
+    if (!start_status_.ok()) {
+      return start_status_;
+    }
+    buffers_ = {first, second};
+    filling_ = 0;
+    started_ = true;
+    return OkStatus();
+  }
+
+  void DoStop() override { started_ = false; }
+
+  Status start_status_;
+  bool started_ = false;
+  std::array<span<int32_t>, 2> buffers_;
+  size_t filling_ = 0;
+};
+
+// A task that claims one block.
+class ClaimTask : public async2::Task {
+ public:
+  explicit ClaimTask(ContinuousAnalogInput& input) : input_(input) {}
+
+  const std::optional<Result<SampleBlock>>& block() const { return block_; }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    Poll<Result<SampleBlock>> block = input_.PendBlock(cx);
+    if (block.IsPending()) {
+      return Pending();
+    }
+    block_ = *block;
+    return Ready();
+  }
+
+  ContinuousAnalogInput& input_;
+  std::optional<Result<SampleBlock>> block_;
+};
+
+class ContinuousAnalogInputTest : public ::testing::Test {
+ protected:
+  // Claims a block with a new task, which is expected to complete at once.
+  std::optional<Result<SampleBlock>> Claim() {
+    ClaimTask task(input_);
+    dispatcher_.Post(task);
+    EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+    return task.block();
+  }
+
+  SystemClock::time_point Time(int64_t ticks) {
+    return SystemClock::time_point(SystemClock::duration(ticks));
+  }
+
+  Dispatcher dispatcher_;
+  TestContinuousAnalogInput input_;
+  std::array<int32_t, kBlockSize> first_{};
+  std::array<int32_t, kBlockSize> second_{};
+};
+
+TEST_F(ContinuousAnalogInputTest, StartValidatesBuffers) {
+  std::array<int32_t, kBlockSize + 1> larger{};
+  EXPECT_EQ(input_.Start(first_, larger), Status::InvalidArgument());
+  EXPECT_EQ(input_.Start(span<int32_t>(), span<int32_t>()),
+            Status::InvalidArgument());
+  EXPECT_FALSE(input_.started());
+
+  ASSERT_EQ(input_.Start(first_, second_), OkStatus());
+  EXPECT_TRUE(input_.started());
+  EXPECT_EQ(input_.Start(first_, second_), Status::FailedPrecondition());
+}
+
+TEST_F(ContinuousAnalogInputTest, StartFailure) {
+  input_.FailOnStart(Status::Unavailable());
+  EXPECT_EQ(input_.Start(first_, second_), Status::Unavailable());
+  EXPECT_EQ(Claim()->status(), Status::FailedPrecondition());
+}
+
+TEST_F(ContinuousAnalogInputTest, DeliversBlocksInTurn) {
+  ASSERT_EQ(input_.Start(first_, second_), OkStatus());
+
+  ClaimTask task(input_);
+  dispatcher_.Post(task);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+
+  input_.Complete(1, Time(10));
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  ASSERT_TRUE(task.block().has_value());
+  const SampleBlock& block = task.block()->value();
+  EXPECT_EQ(block.samples.data(), first_.data());
+  EXPECT_EQ(block.samples.size(), kBlockSize);
+  EXPECT_EQ(block.samples[0], 1);
+  EXPECT_EQ(block.timestamp, Time(10));
+  EXPECT_EQ(block.sequence, 0u);
+  EXPECT_EQ(block.overruns, 0u);
+  EXPECT_EQ(input_.ReleaseBlock(), OkStatus());
+
+  input_.Complete(2, Time(20));
+  std::optional<Result<SampleBlock>> second = Claim();
+  ASSERT_TRUE(second.has_value());
+  EXPECT_EQ(second->value().samples.data(), second_.data());
+  EXPECT_EQ(second->value().samples[0], 2);
+  EXPECT_EQ(second->value().timestamp, Time(20));
+  EXPECT_EQ(second->value().sequence, 1u);
+  EXPECT_EQ(input_.ReleaseBlock(), OkStatus());
+  EXPECT_EQ(input_.overruns(), 0u);
+}
+
+TEST_F(ContinuousAnalogInputTest, UnclaimedBlockIsDropped) {
+  ASSERT_EQ(input_.Start(first_, second_), OkStatus());
+  input_.Complete(1, Time(10));
+  input_.Complete(2, Time(20));
+
+  // The backend started refilling the first buffer before it was claimed.
+  std::optional<Result<SampleBlock>> block = Claim();
+  ASSERT_TRUE(block.has_value());
+  EXPECT_EQ(block->value().samples[0], 2);
+  EXPECT_EQ(block->value().sequence, 1u);
+  EXPECT_EQ(block->value().overruns, 1u);
+  EXPECT_EQ(input_.ReleaseBlock(), OkStatus());
+}
+
+TEST_F(ContinuousAnalogInputTest, BlockRefilledWhileClaimedIsDataLoss) {
+  ASSERT_EQ(input_.Start(first_, second_), OkStatus());
+  input_.Complete(1, Time(10));
+  ASSERT_TRUE(Claim().has_value());
+
+  // Completing the second buffer starts refilling the claimed one.
+  input_.Complete(2, Time(20));
+  EXPECT_EQ(input_.overruns(), 1u);
+  EXPECT_EQ(input_.ReleaseBlock(), Status::DataLoss());
+
+  // The second block was completed in time, so it is still delivered.
+  std::optional<Result<SampleBlock>> block = Claim();
+  ASSERT_TRUE(block.has_value());
+  EXPECT_EQ(block->value().samples[0], 2);
+  EXPECT_EQ(block->value().overruns, 1u);
+  EXPECT_EQ(input_.ReleaseBlock(), OkStatus());
+}
+
+TEST_F(ContinuousAnalogInputTest, ClaimRequiresRelease) {
+  ASSERT_EQ(input_.Start(first_, second_), OkStatus());
+  EXPECT_EQ(input_.ReleaseBlock(), Status::FailedPrecondition());
+
+  input_.Complete(1, Time(10));
+  ASSERT_TRUE(Claim().has_value());
+  EXPECT_EQ(Claim()->status(), Status::FailedPrecondition());
+  EXPECT_EQ(input_.ReleaseBlock(), OkStatus());
+}
+
+TEST_F(ContinuousAnalogInputTest, StopWakesWaitingTask) {
+  ASSERT_EQ(input_.Start(first_, second_), OkStatus());
+
+  ClaimTask task(input_);
+  dispatcher_.Post(task);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+
+  input_.Stop();
+  EXPECT_FALSE(input_.started());
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_EQ(task.block()->status(), Status::FailedPrecondition());
+
+  // Acquisition can be restarted.
+  ASSERT_EQ(input_.Start(first_, second_), OkStatus());
+  input_.Complete(3, Time(30));
+  std::optional<Result<SampleBlock>> block = Claim();
+  ASSERT_TRUE(block.has_value());
+  EXPECT_EQ(block->value().sequence, 0u);
+}
+
+}  // namespace
+}  // namespace pw::analog
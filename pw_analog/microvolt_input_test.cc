@@ -13,6 +13,9 @@
 // the License.
 #include "pw_analog/microvolt_input.h"
 
+#include <algorithm>
+#include <array>
+
 #include "pw_unit_test/framework.h"
 
 namespace pw {
@@ -276,6 +279,114 @@ TEST(MicrovoltInputTest, ReadMicrovoltsWithInvertedReferenceAtMin) {
   ASSERT_EQ(result.status(), pw::Status::Internal());
 }
 
+// The conversion MicrovoltInput has always done, computed directly.
+int32_t ExpectedMicrovolts(int32_t sample,
+                           AnalogInput::Limits limits,
+                           MicrovoltInput::References references) {
+  return static_cast<int32_t>(
+      ((static_cast<int64_t>(sample) - limits.min) *
+       (static_cast<int64_t>(references.max_voltage_uv) -
+        references.min_voltage_uv)) /
+          (static_cast<int64_t>(limits.max) - limits.min) +
+      references.min_voltage_uv);
+}
+
+void ExpectConvertsLikeMicrovoltInput(AnalogInput::Limits limits,
+                                      MicrovoltInput::References references,
+                                      int32_t step) {
+  Result<MicrovoltConverter> converter =
+      MicrovoltConverter::Create(limits, references);
+  ASSERT_EQ(converter.status(), OkStatus());
+
+  TestMicrovoltInput voltage_input(limits, references);
+  const int64_t low = std::min(limits.min, limits.max);
+  const int64_t high = std::max(limits.min, limits.max);
+  for (int64_t sample = low; sample <= high; sample += step) {
+    const int32_t expected = ExpectedMicrovolts(
+        static_cast<int32_t>(sample), limits, references);
+    EXPECT_EQ(converter->Convert(static_cast<int32_t>(sample)), expected);
+
+    voltage_input.SetSampleValue(static_cast<int32_t>(sample));
+    EXPECT_EQ(voltage_input.TryReadMicrovoltsFor(kTimeout).value(), expected);
+  }
+}
+
+TEST(MicrovoltConverterTest, PowerOfTwoRange) {
+  ExpectConvertsLikeMicrovoltInput({.min = kLimitsMin, .max = kLimitsMax},
+                                   {.max_voltage_uv = kReferenceMaxVoltageUv,
+                                    .min_voltage_uv = kReferenceMinVoltageUv},
+                                   1);
+}
+
+TEST(MicrovoltConverterTest, OddRange) {
+  ExpectConvertsLikeMicrovoltInput(
+      {.min = 0, .max = 4095},
+      {.max_voltage_uv = 3300000, .min_voltage_uv = 0},
+      1);
+}
+
+TEST(MicrovoltConverterTest, Bipolar) {
+  ExpectConvertsLikeMicrovoltInput(
+      {.min = kBipolarLimitsMin, .max = kBipolarLimitsMax},
+      {.max_voltage_uv = kBipolarReferenceMaxVoltageUv,
+       .min_voltage_uv = kBipolarReferenceMinVoltageUv},
+      1);
+}
+
+TEST(MicrovoltConverterTest, InvertedReferences) {
+  ExpectConvertsLikeMicrovoltInput(
+      {.min = 0, .max = 4095},
+      {.max_voltage_uv = -1250000, .min_voltage_uv = 1250000},
+      1);
+}
+
+TEST(MicrovoltConverterTest, WideRange) {
+  // The products of 24-bit samples don't fit in 32 bits.
+  ExpectConvertsLikeMicrovoltInput(
+      {.min = -8388608, .max = 8388607},
+      {.max_voltage_uv = 1000000000, .min_voltage_uv = -1000000000},
+      997);
+}
+
+TEST(MicrovoltConverterTest, ConvertsInPlace) {
+  Result<MicrovoltConverter> converter =
+      MicrovoltConverter::Create({.min = 0, .max = 4095},
+                                 {.max_voltage_uv = 3300000,
+                                  .min_voltage_uv = 0});
+  ASSERT_EQ(converter.status(), OkStatus());
+
+  std::array<int32_t, 3> samples = {0, 2048, 4095};
+  converter->Convert(samples, samples);
+  EXPECT_EQ(samples[0], 0);
+  EXPECT_EQ(samples[1], 1650402);
+  EXPECT_EQ(samples[2], 3300000);
+}
+
+TEST(MicrovoltConverterTest, CreateFailsForInvalidRanges) {
+  EXPECT_EQ(MicrovoltConverter::Create(
+                {.min = kCornerLimitsMin, .max = kCornerLimitsMax},
+                {.max_voltage_uv = kCornerReferenceMaxVoltageUv,
+                 .min_voltage_uv = kCornerReferenceMinVoltageUv})
+                .status(),
+            Status::Internal());
+  EXPECT_EQ(MicrovoltConverter::Create(
+                {.min = 100, .max = 100},
+                {.max_voltage_uv = kReferenceMaxVoltageUv,
+                 .min_voltage_uv = kReferenceMinVoltageUv})
+                .status(),
+            Status::Internal());
+}
+
+TEST(MicrovoltConverterTest, FromMicrovoltInput) {
+  TestMicrovoltInput voltage_input =
+      TestMicrovoltInput({.min = kLimitsMin, .max = kLimitsMax},
+                         {.max_voltage_uv = kReferenceMaxVoltageUv,
+                          .min_voltage_uv = kReferenceMinVoltageUv});
+  Result<MicrovoltConverter> converter = voltage_input.GetMicrovoltConverter();
+  ASSERT_EQ(converter.status(), OkStatus());
+  EXPECT_EQ(converter->Convert(kLimitsMax / 2), kReferenceMaxVoltageUv / 2);
+}
+
 }  // namespace
 }  // namespace analog
 }  // namespace pw
@@ -0,0 +1,184 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_analog/analog_input.h"
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/poll.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_result/result.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::analog {
+
+/// A block of consecutive samples from a `ContinuousAnalogInput`.
+struct SampleBlock {
+  /// The samples, in the order they were taken.
+  span<const int32_t> samples;
+
+  /// When the last sample in the block was taken, as reported by the backend.
+  chrono::SystemClock::time_point timestamp;
+
+  /// The number of blocks that completed before this one since acquisition
+  /// started, including blocks that were dropped.
+  uint32_t sequence;
+
+  /// The number of overruns since acquisition started. This increases when a
+  /// block is dropped because the previous one wasn't claimed in time, or
+  /// when the backend starts refilling a block before it was released.
+  uint32_t overruns;
+};
+
+/// The base driver interface for continuously sampling one ADC channel into
+/// a pair of buffers, typically with DMA.
+///
+/// The backend fills the two buffers in turn. While it fills one, a
+/// `pw_async2` task processes the samples in the other, which it claims with
+/// `PendBlock` and hands back with `ReleaseBlock`. The task must release each
+/// block before the backend finishes filling the other buffer, since the
+/// backend then starts overwriting it. Overruns are counted rather than
+/// stopping acquisition, so a task that falls behind loses blocks but recovers
+/// on its own.
+///
+/// Backends implement `DoStart` to start sampling without blocking, and call
+/// `BlockComplete` each time a buffer is full, typically from the DMA half
+/// transfer and transfer complete interrupts of a circular transfer over both
+/// buffers.
+///
+/// Samples have the same range as `AnalogInput` samples. Use a
+/// `MicrovoltConverter` to convert them to microvolts in bulk.
+class ContinuousAnalogInput {
+ public:
+  virtual ~ContinuousAnalogInput() = default;
+
+  /// Starts acquisition into `first` and `second`, which must remain valid
+  /// until acquisition is stopped. The backend fills `first` first.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Acquisition started.
+  ///
+  ///    INVALID_ARGUMENT: The buffers are empty or not the same size.
+  ///
+  ///    FAILED_PRECONDITION: Acquisition is already running.
+  ///
+  /// Other statuses left up to the implementer.
+  ///
+  /// @endrst
+  Status Start(span<int32_t> first, span<int32_t> second)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  /// Stops acquisition. Once this returns, the backend no longer writes to
+  /// the buffers, and a task waiting in `PendBlock` is woken.
+  void Stop() PW_LOCKS_EXCLUDED(lock_);
+
+  /// Claims the most recently completed block, or waits for a block to
+  /// complete if it has already been claimed. A block that isn't claimed
+  /// before the backend starts refilling its buffer is dropped, and counted
+  /// as an overrun.
+  ///
+  /// The block's samples remain valid until `ReleaseBlock` is called. The
+  /// previous block must be released before claiming the next one. Only one
+  /// task may claim blocks.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Returns the claimed block.
+  ///
+  ///    FAILED_PRECONDITION: Acquisition isn't running, or the previous block
+  ///    hasn't been released.
+  ///
+  /// @endrst
+  async2::Poll<Result<SampleBlock>> PendBlock(async2::Context& cx)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  /// Releases the block claimed by `PendBlock`, so the backend may refill its
+  /// buffer.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The block was released before the backend started refilling it,
+  ///    so the samples that were processed are valid.
+  ///
+  ///    DATA_LOSS: The backend started refilling the block before it was
+  ///    released, so some of its samples may have been overwritten while
+  ///    they were processed.
+  ///
+  ///    FAILED_PRECONDITION: No block is claimed.
+  ///
+  /// @endrst
+  Status ReleaseBlock() PW_LOCKS_EXCLUDED(lock_);
+
+  /// @returns The number of overruns since acquisition started.
+  uint32_t overruns() const PW_LOCKS_EXCLUDED(lock_);
+
+  /// @returns The range of the samples. These values do not change at
+  /// runtime.
+  virtual AnalogInput::Limits GetLimits() const = 0;
+
+ protected:
+  /// Reports that the backend has filled the buffer it was filling, and has
+  /// moved on to the other buffer. `timestamp` is when the last sample in the
+  /// block was taken.
+  ///
+  /// This may be called from an interrupt.
+  void BlockComplete(chrono::SystemClock::time_point timestamp)
+      PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  static constexpr size_t kNoBlock = 2;
+
+  /// Starts filling `first` and then `second` in turn, calling
+  /// `BlockComplete` after filling each one. The backend must not block.
+  virtual Status DoStart(span<int32_t> first, span<int32_t> second) = 0;
+
+  /// Stops acquisition. Once this returns, the backend must not write to the
+  /// buffers or call `BlockComplete`.
+  virtual void DoStop() = 0;
+
+  mutable sync::InterruptSpinLock lock_;
+  bool running_ PW_GUARDED_BY(lock_) = false;
+  std::array<span<int32_t>, 2> buffers_ PW_GUARDED_BY(lock_);
+
+  // The buffer the backend is filling.
+  size_t filling_ PW_GUARDED_BY(lock_) = 0;
+
+  // The completed buffer waiting to be claimed, and the buffer claimed by the
+  // task, or kNoBlock.
+  size_t ready_ PW_GUARDED_BY(lock_) = kNoBlock;
+  size_t claimed_ PW_GUARDED_BY(lock_) = kNoBlock;
+  bool claimed_overwritten_ PW_GUARDED_BY(lock_) = false;
+
+  chrono::SystemClock::time_point ready_timestamp_ PW_GUARDED_BY(lock_);
+  uint32_t ready_sequence_ PW_GUARDED_BY(lock_) = 0;
+  uint32_t completed_ PW_GUARDED_BY(lock_) = 0;
+  uint32_t overruns_ PW_GUARDED_BY(lock_) = 0;
+
+  async2::Waker waker_;
+};
+
+}  // namespace pw::analog
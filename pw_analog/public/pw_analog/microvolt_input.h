@@ -12,13 +12,24 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 #pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+
 #include "pw_analog/analog_input.h"
+#include "pw_assert/assert.h"
 #include "pw_chrono/system_clock.h"
 #include "pw_result/result.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
 #include "pw_status/try.h"
 
 namespace pw::analog {
 
+class MicrovoltConverter;
+
 /// The common interface for obtaining voltage samples in microvolts. This
 /// interface represents a single voltage input or channel. Users will need to
 /// supply their own ADC driver implementation in order to provide the reference
@@ -82,30 +93,142 @@ class MicrovoltInput : public AnalogInput {
   ///
   /// @endrst
   Result<int32_t> TryReadMicrovoltsUntil(
-      chrono::SystemClock::time_point deadline) {
-    PW_TRY_ASSIGN(const int32_t sample, TryReadUntil(deadline));
+      chrono::SystemClock::time_point deadline);
+
+  /// @returns A converter from this input's samples to microvolts, for
+  /// converting many samples at once.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Returns the converter.
+  ///
+  ///    INTERNAL: The references or limits can't be converted between.
+  ///
+  /// @endrst
+  Result<MicrovoltConverter> GetMicrovoltConverter() const;
 
-    const References reference = GetReferences();
-    const AnalogInput::Limits limits = GetLimits();
+ private:
+  // Returns the reference voltage needed to calculate the voltage.
+  // These values do not change at run time.
+  virtual References GetReferences() const = 0;
+};
 
+/// Converts samples to microvolts, with the same results as
+/// `pw::analog::MicrovoltInput::TryReadMicrovoltsUntil()`.
+///
+/// The references and limits are checked and reduced to a fraction once, when
+/// the converter is created, so each conversion is a multiplication and a
+/// division. The division is a shift when the reduced fraction has a power of
+/// two denominator, and a 32-bit division when the product fits in 32 bits,
+/// as it does for most ADCs. This makes converting blocks of samples, e.g.
+/// from a `pw::analog::ContinuousAnalogInput`, much faster than converting
+/// samples one at a time.
+class MicrovoltConverter {
+ public:
+  /// Creates a converter for the given limits and references.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Returns the converter.
+  ///
+  ///    INTERNAL: The reference voltage difference doesn't fit in an
+  ///    ``int32_t``, or the limits are equal.
+  ///
+  /// @endrst
+  static Result<MicrovoltConverter> Create(
+      AnalogInput::Limits limits, MicrovoltInput::References references) {
     constexpr int64_t kMaxReferenceDiffUv = std::numeric_limits<int32_t>::max();
 
-    if (std::abs(static_cast<int64_t>(reference.max_voltage_uv) -
-                 static_cast<int64_t>(reference.min_voltage_uv)) >
-        kMaxReferenceDiffUv) {
-      return pw::Status::Internal();
+    const int64_t voltage_range =
+        static_cast<int64_t>(references.max_voltage_uv) -
+        static_cast<int64_t>(references.min_voltage_uv);
+    const int64_t sample_range =
+        static_cast<int64_t>(limits.max) - static_cast<int64_t>(limits.min);
+    if (std::abs(voltage_range) > kMaxReferenceDiffUv || sample_range == 0) {
+      return Status::Internal();
     }
+    return MicrovoltConverter(
+        limits.min, references.min_voltage_uv, voltage_range, sample_range);
+  }
+
+  /// @returns The voltage of `sample` in microvolts.
+  int32_t Convert(int32_t sample) const {
+    const int64_t product =
+        (static_cast<int64_t>(sample) - sample_min_) * numerator_;
 
-    return (((static_cast<int64_t>(sample) - static_cast<int64_t>(limits.min)) *
-             (reference.max_voltage_uv - reference.min_voltage_uv)) /
-            (limits.max - limits.min)) +
-           reference.min_voltage_uv;
+    int64_t voltage;
+    if (shift_ >= 0) {
+      // Shift the magnitude, so negative products round towards zero like a
+      // division does.
+      voltage = product < 0 ? -((-product) >> shift_) : product >> shift_;
+    } else if (denominator_ <= kInt32Max && product >= -kInt32Max &&
+               product <= kInt32Max) {
+      voltage = static_cast<int32_t>(product) /
+                static_cast<int32_t>(denominator_);
+    } else {
+      voltage = product / denominator_;
+    }
+    return static_cast<int32_t>(voltage + min_voltage_uv_);
+  }
+
+  /// Converts each sample in `samples` to microvolts in `microvolts`, which
+  /// must be the same size. `samples` and `microvolts` may be the same span.
+  void Convert(span<const int32_t> samples, span<int32_t> microvolts) const {
+    PW_ASSERT(samples.size() == microvolts.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+      microvolts[i] = Convert(samples[i]);
+    }
   }
 
  private:
-  // Returns the reference voltage needed to calculate the voltage.
-  // These values do not change at run time.
-  virtual References GetReferences() const = 0;
+  static constexpr int64_t kInt32Max = std::numeric_limits<int32_t>::max();
+
+  MicrovoltConverter(int32_t sample_min,
+                     int32_t min_voltage_uv,
+                     int64_t voltage_range,
+                     int64_t sample_range)
+      : sample_min_(sample_min), min_voltage_uv_(min_voltage_uv) {
+    // Reducing the fraction doesn't change the truncated quotient, but keeps
+    // products small and often makes the denominator a power of two.
+    if (sample_range < 0) {
+      voltage_range = -voltage_range;
+      sample_range = -sample_range;
+    }
+    const int64_t divisor = std::gcd(voltage_range, sample_range);
+    numerator_ = voltage_range / divisor;
+    denominator_ = sample_range / divisor;
+
+    if ((denominator_ & (denominator_ - 1)) == 0) {
+      shift_ = 0;
+      while ((int64_t{1} << shift_) != denominator_) {
+        ++shift_;
+      }
+    }
+  }
+
+  int32_t sample_min_;
+  int32_t min_voltage_uv_;
+  int64_t numerator_;
+  int64_t denominator_;
+
+  // log2(denominator_) if it is a power of two, or -1.
+  int shift_ = -1;
 };
 
+inline Result<int32_t> MicrovoltInput::TryReadMicrovoltsUntil(
+    chrono::SystemClock::time_point deadline) {
+  PW_TRY_ASSIGN(const int32_t sample, TryReadUntil(deadline));
+  PW_TRY_ASSIGN(const MicrovoltConverter converter, GetMicrovoltConverter());
+  return converter.Convert(sample);
+}
+
+inline Result<MicrovoltConverter> MicrovoltInput::GetMicrovoltConverter()
+    const {
+  return MicrovoltConverter::Create(GetLimits(), GetReferences());
+}
+
 }  // namespace pw::analog
@@ -0,0 +1,156 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/coro_frame_pool.h"
+
+#include <algorithm>
+#include <new>
+
+#include "pw_assert/check.h"
+
+namespace pw::async2::internal {
+
+void* GenericCoroFramePool::Allocate(allocator::Layout layout) {
+  size_t size = layout.size();
+  RecordFrameSize(size);
+  size_t index = IndexOf(size);
+  if (index < size_classes_.size() && layout.alignment() <= kHeaderSize) {
+    SizeClass& size_class = size_classes_[index];
+    ++size_class.allocations;
+    void* frame;
+    if (size_class.head != nullptr) {
+      ++size_class.cache_hits;
+      frame = Pop(size_class);
+    } else {
+      frame = AllocateChunk(index);
+      if (frame == nullptr) {
+        return nullptr;
+      }
+    }
+    ++size_class.live;
+    size_class.peak_live = std::max(size_class.peak_live, size_class.live);
+    return frame;
+  }
+
+  ++uncached_allocations_;
+  size_t offset = std::max(layout.alignment(), kHeaderSize);
+  PW_CHECK_UINT_LT(offset, kUncached);
+  auto* chunk = static_cast<std::byte*>(
+      allocator_.Allocate(allocator::Layout(offset + size, offset)));
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+  void* frame = chunk + offset;
+  HeaderOf(frame) = Header{kUncached, static_cast<uint16_t>(offset)};
+  return frame;
+}
+
+void GenericCoroFramePool::Deallocate(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  Header header = HeaderOf(ptr);
+  if (header.index == kUncached) {
+    allocator_.Deallocate(static_cast<std::byte*>(ptr) - header.offset);
+    return;
+  }
+  SizeClass& size_class = size_classes_[header.index];
+  --size_class.live;
+  if (size_class.cached >= max_cached_per_class_) {
+    allocator_.Deallocate(static_cast<std::byte*>(ptr) - kHeaderSize);
+    return;
+  }
+  Push(size_class, ptr);
+}
+
+size_t GenericCoroFramePool::Reserve(size_t frame_size, size_t count) {
+  size_t index = IndexOf(frame_size);
+  if (index == size_classes_.size()) {
+    return 0;
+  }
+  SizeClass& size_class = size_classes_[index];
+  while (size_class.cached < count) {
+    void* frame = AllocateChunk(index);
+    if (frame == nullptr) {
+      break;
+    }
+    Push(size_class, frame);
+  }
+  return size_class.cached;
+}
+
+void GenericCoroFramePool::Flush() {
+  for (SizeClass& size_class : size_classes_) {
+    while (size_class.head != nullptr) {
+      allocator_.Deallocate(static_cast<std::byte*>(Pop(size_class)) -
+                            kHeaderSize);
+    }
+  }
+}
+
+span<const GenericCoroFramePool::FrameSize> GenericCoroFramePool::frame_sizes()
+    const {
+  size_t count = 0;
+  while (count < frame_sizes_.size() && frame_sizes_[count].allocations != 0) {
+    ++count;
+  }
+  return frame_sizes_.first(count);
+}
+
+size_t GenericCoroFramePool::IndexOf(size_t size) const {
+  size_t index = 0;
+  while (index < size_classes_.size() && ChunkSize(index) < size) {
+    ++index;
+  }
+  return index;
+}
+
+void* GenericCoroFramePool::AllocateChunk(size_t index) {
+  auto* chunk = static_cast<std::byte*>(allocator_.Allocate(
+      allocator::Layout(kHeaderSize + ChunkSize(index), kHeaderSize)));
+  if (chunk == nullptr) {
+    return nullptr;
+  }
+  void* frame = chunk + kHeaderSize;
+  HeaderOf(frame) =
+      Header{static_cast<uint16_t>(index), static_cast<uint16_t>(kHeaderSize)};
+  return frame;
+}
+
+void GenericCoroFramePool::Push(SizeClass& size_class, void* frame) {
+  size_class.head = new (frame) SizeClass::FreeFrame{size_class.head};
+  ++size_class.cached;
+}
+
+void* GenericCoroFramePool::Pop(SizeClass& size_class) {
+  SizeClass::FreeFrame* frame = size_class.head;
+  size_class.head = frame->next;
+  --size_class.cached;
+  return frame;
+}
+
+void GenericCoroFramePool::RecordFrameSize(size_t size) {
+  largest_frame_ = std::max(largest_frame_, size);
+  for (FrameSize& frame_size : frame_sizes_) {
+    if (frame_size.allocations == 0) {
+      frame_size.size = size;
+    }
+    if (frame_size.size == size) {
+      ++frame_size.allocations;
+      return;
+    }
+  }
+}
+
+}  // namespace pw::async2::internal
@@ -0,0 +1,166 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/coro_frame_pool.h"
+
+#include <array>
+#include <cstdint>
+
+#include "pw_allocator/testing.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using ::pw::allocator::Layout;
+using ::pw::allocator::test::AllocatorForTest;
+using ::pw::async2::CoroFramePool;
+
+using Pool = CoroFramePool<3, 64, 2, 4>;
+
+class CoroFramePoolTest : public ::testing::Test {
+ protected:
+  CoroFramePoolTest() : pool_(allocator_) {}
+
+  size_t upstream_allocations() const {
+    return allocator_.metrics().num_allocations.value();
+  }
+
+  size_t upstream_deallocations() const {
+    return allocator_.metrics().num_deallocations.value();
+  }
+
+  AllocatorForTest<4096> allocator_;
+  Pool pool_;
+};
+
+TEST_F(CoroFramePoolTest, ReusesFreedFrames) {
+  void* first = pool_.Allocate(Layout(100));
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(upstream_allocations(), 1u);
+  pool_.Deallocate(first);
+  EXPECT_EQ(upstream_deallocations(), 0u);
+
+  // Any frame of the same size class reuses the cached frame.
+  void* second = pool_.Allocate(Layout(128));
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(upstream_allocations(), 1u);
+  pool_.Deallocate(second);
+
+  Pool::SizeClassStats stats = pool_.size_class_stats(1);
+  EXPECT_EQ(stats.frame_size, 128u);
+  EXPECT_EQ(stats.allocations, 2u);
+  EXPECT_EQ(stats.cache_hits, 1u);
+  EXPECT_EQ(stats.live, 0u);
+  EXPECT_EQ(stats.peak_live, 1u);
+  EXPECT_EQ(stats.cached, 1u);
+}
+
+TEST_F(CoroFramePoolTest, FramesAreAligned) {
+  constexpr std::array<size_t, 3> kSizes = {1, 100, 1000};
+  std::array<void*, 3> frames;
+  for (size_t i = 0; i < kSizes.size(); ++i) {
+    frames[i] = pool_.Allocate(Layout(kSizes[i]));
+    ASSERT_NE(frames[i], nullptr);
+    EXPECT_EQ(
+        reinterpret_cast<uintptr_t>(frames[i]) % alignof(std::max_align_t),
+        0u);
+  }
+  for (void* frame : frames) {
+    pool_.Deallocate(frame);
+  }
+}
+
+TEST_F(CoroFramePoolTest, LimitsCachedFrames) {
+  std::array<void*, 3> frames;
+  for (void*& frame : frames) {
+    frame = pool_.Allocate(Layout(64));
+    ASSERT_NE(frame, nullptr);
+  }
+  for (void* frame : frames) {
+    pool_.Deallocate(frame);
+  }
+  EXPECT_EQ(pool_.size_class_stats(0).cached, 2u);
+  EXPECT_EQ(pool_.size_class_stats(0).peak_live, 3u);
+  EXPECT_EQ(upstream_deallocations(), 1u);
+}
+
+TEST_F(CoroFramePoolTest, PassesThroughLargeFrames) {
+  void* frame = pool_.Allocate(Layout(257));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_EQ(pool_.uncached_allocations(), 1u);
+  pool_.Deallocate(frame);
+  EXPECT_EQ(upstream_deallocations(), 1u);
+  EXPECT_EQ(pool_.largest_frame(), 257u);
+}
+
+TEST_F(CoroFramePoolTest, PassesThroughOveralignedFrames) {
+  constexpr size_t kAlignment = alignof(std::max_align_t) * 4;
+  void* frame = pool_.Allocate(Layout(64, kAlignment));
+  ASSERT_NE(frame, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(frame) % kAlignment, 0u);
+  EXPECT_EQ(pool_.uncached_allocations(), 1u);
+  pool_.Deallocate(frame);
+  EXPECT_EQ(upstream_deallocations(), 1u);
+}
+
+TEST_F(CoroFramePoolTest, ReserveAvoidsAllocation) {
+  EXPECT_EQ(pool_.Reserve(200, 3), 3u);
+  EXPECT_EQ(upstream_allocations(), 3u);
+
+  std::array<void*, 3> frames;
+  for (void*& frame : frames) {
+    frame = pool_.Allocate(Layout(200));
+    ASSERT_NE(frame, nullptr);
+  }
+  EXPECT_EQ(upstream_allocations(), 3u);
+  EXPECT_EQ(pool_.size_class_stats(2).cache_hits, 3u);
+  for (void* frame : frames) {
+    pool_.Deallocate(frame);
+  }
+  EXPECT_EQ(pool_.size_class_stats(2).cached, 2u);
+}
+
+TEST_F(CoroFramePoolTest, ReserveTooLargeFrames) {
+  EXPECT_EQ(pool_.Reserve(1000, 1), 0u);
+  EXPECT_EQ(upstream_allocations(), 0u);
+}
+
+TEST_F(CoroFramePoolTest, ReserveStopsWhenExhausted) {
+  allocator_.Exhaust();
+  EXPECT_EQ(pool_.Reserve(64, 2), 0u);
+  EXPECT_EQ(pool_.Allocate(Layout(64)), nullptr);
+}
+
+TEST_F(CoroFramePoolTest, FlushReleasesCachedFrames) {
+  EXPECT_EQ(pool_.Reserve(64, 2), 2u);
+  pool_.Flush();
+  EXPECT_EQ(pool_.size_class_stats(0).cached, 0u);
+  EXPECT_EQ(upstream_deallocations(), 2u);
+}
+
+TEST_F(CoroFramePoolTest, CountsFrameSizes) {
+  for (size_t size : {100, 40, 100, 1, 2, 3, 100}) {
+    pool_.Deallocate(pool_.Allocate(Layout(size)));
+  }
+  auto stats = pool_.frame_size_stats();
+  ASSERT_EQ(stats.size(), 4u);
+  EXPECT_EQ(stats[0].size, 100u);
+  EXPECT_EQ(stats[0].allocations, 3u);
+  EXPECT_EQ(stats[1].size, 40u);
+  EXPECT_EQ(stats[1].allocations, 1u);
+  EXPECT_EQ(stats[3].size, 2u);
+  EXPECT_EQ(pool_.largest_frame(), 100u);
+}
+
+}  // namespace
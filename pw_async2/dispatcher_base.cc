@@ -14,12 +14,58 @@
 
 #include "pw_async2/dispatcher_base.h"
 
+#include <algorithm>
+#include <chrono>
 #include <mutex>
 
 #include "pw_assert/check.h"
-#include "pw_sync/lock_annotations.h"
 
 namespace pw::async2 {
+namespace {
+
+using chrono::SystemClock;
+
+constexpr SystemClock::duration kTimerResolution = SystemClock::for_at_least(
+    std::chrono::milliseconds(PW_ASYNC2_CONFIG_TIMER_RESOLUTION_MS));
+static_assert(kTimerResolution.count() > 0,
+              "PW_ASYNC2_CONFIG_TIMER_RESOLUTION_MS must be positive");
+
+constexpr auto kTicksPerTimerTick =
+    static_cast<uint64_t>(kTimerResolution.count());
+
+// Returns the last timer wheel tick that starts no later than `time`.
+uint64_t TimerTickAtOrBefore(SystemClock::time_point time) {
+  auto count = time.time_since_epoch().count();
+  if (count <= 0) {
+    return 0;
+  }
+  return static_cast<uint64_t>(count) / kTicksPerTimerTick;
+}
+
+// Returns the first timer wheel tick that starts no earlier than `time`.
+uint64_t TimerTickAtOrAfter(SystemClock::time_point time) {
+  auto count = time.time_since_epoch().count();
+  if (count <= 0) {
+    return 0;
+  }
+  auto ticks = static_cast<uint64_t>(count);
+  return ticks / kTicksPerTimerTick + (ticks % kTicksPerTimerTick != 0 ? 1 : 0);
+}
+
+// Returns the time at which a timer wheel tick starts, or `std::nullopt` if it
+// is not representable by the system clock.
+std::optional<SystemClock::time_point> TimerTickStart(uint64_t tick) {
+  constexpr uint64_t kMaxTick =
+      static_cast<uint64_t>(SystemClock::duration::max().count()) /
+      kTicksPerTimerTick;
+  if (tick > kMaxTick) {
+    return std::nullopt;
+  }
+  return SystemClock::time_point(SystemClock::duration(
+      static_cast<SystemClock::rep>(tick * kTicksPerTimerTick)));
+}
+
+}  // namespace
 
 void Context::ReEnqueue() { waker_->Clone(WaitReason::Unspecified()).Wake(); }
 
@@ -60,25 +106,28 @@ bool Task::IsRegistered() const {
 }
 
 void Task::Deregister() {
-  pw::sync::Mutex* task_execution_lock;
-  {
-    // Fast path: the task is not running.
-    std::lock_guard lock(dispatcher_lock());
-    if (TryDeregister()) {
-      return;
+  while (true) {
+    DispatcherBase* dispatcher;
+    {
+      // Fast path: the task is not running.
+      std::lock_guard lock(dispatcher_lock());
+      if (TryDeregister()) {
+        return;
+      }
+      // The task was running, so we have to wait for the task to stop being
+      // run by the dispatcher.
+      dispatcher = dispatcher_;
+      ++dispatcher->deregister_waiters_;
     }
-    // The task was running, so we have to wait for the task to stop being
-    // run by acquiring the `task_lock`.
-    task_execution_lock = &dispatcher_->task_execution_lock_;
-  }
 
-  // NOTE: there is a race here where `task_execution_lock_` may be
-  // invalidated by concurrent destruction of the dispatcher.
-  //
-  // This restriction is documented above, but is still fairly footgun-y.
-  std::lock_guard task_lock(*task_execution_lock);
-  std::lock_guard lock(dispatcher_lock());
-  PW_CHECK(TryDeregister());
+    // NOTE: there is a race here where `task_stopped_` may be invalidated by
+    // concurrent destruction of the dispatcher.
+    //
+    // This restriction is documented above, but is still fairly footgun-y.
+    //
+    // Another task may have stopped, so check again once woken.
+    dispatcher->task_stopped_.acquire();
+  }
 }
 
 bool Task::TryDeregister() {
@@ -89,6 +138,7 @@ bool Task::TryDeregister() {
       dispatcher_->RemoveSleepingTaskLocked(*this);
       break;
     case Task::State::kRunning:
+    case Task::State::kWokenWhileRunning:
       return false;
     case Task::State::kWoken:
       dispatcher_->RemoveWokenTaskLocked(*this);
@@ -99,15 +149,14 @@ bool Task::TryDeregister() {
 
   // Wake the dispatcher up if this was the last task so that it can see that
   // all tasks have completed.
-  if (dispatcher_->first_woken_ == nullptr &&
-      dispatcher_->sleeping_ == nullptr && dispatcher_->wants_wake_) {
-    dispatcher_->DoWake();
+  if (dispatcher_->AllTasksCompleteLocked()) {
+    dispatcher_->WakeWaitingRunnersLocked(dispatcher_->waiting_runners_);
   }
   dispatcher_ = nullptr;
   return true;
 }
 
-Waker::Waker(Waker&& other) noexcept {
+Waker::Waker(Waker&& other) noexcept : lock_index_(other.lock_index_) {
   std::lock_guard lock(dispatcher_lock());
   if (other.task_ == nullptr) {
     return;
@@ -118,8 +167,10 @@ Waker::Waker(Waker&& other) noexcept {
 }
 
 Waker& Waker::operator=(Waker&& other) noexcept {
+  // The wakers may belong to different dispatchers, and therefore locks.
+  RemoveFromTaskWakerList();
+  lock_index_ = other.lock_index_;
   std::lock_guard lock(dispatcher_lock());
-  RemoveFromTaskWakerListLocked();
   if (other.task_ == nullptr) {
     return *this;
   }
@@ -139,6 +190,7 @@ void Waker::Wake() && {
 
 Waker Waker::Clone(WaitReason) & {
   Waker waker;
+  waker.lock_index_ = lock_index_;
   {
     std::lock_guard lock(dispatcher_lock());
     if (task_ != nullptr) {
@@ -176,6 +228,49 @@ void Waker::RemoveFromTaskWakerListLocked() {
   }
 }
 
+Poll<> Timer::PendUntil(Context& cx, SystemClock::time_point deadline) {
+  Cancel();
+  if (SystemClock::now() >= deadline) {
+    return Ready();
+  }
+  waker_ = cx.GetWaker(WaitReason::Unspecified());
+  lock_index_ = waker_.lock_index_;
+  std::lock_guard lock(dispatcher_lock());
+  // The task may have been deregistered by another thread.
+  if (waker_.task_ != nullptr) {
+    dispatcher_ = waker_.task_->dispatcher_;
+    dispatcher_->AddTimerLocked(*this, deadline);
+  }
+  return Pending();
+}
+
+void Timer::Cancel() {
+  {
+    std::lock_guard lock(dispatcher_lock());
+    // Timers are unlinked without clearing `dispatcher_` when they expire or
+    // when their dispatcher is destroyed.
+    if (is_linked()) {
+      dispatcher_->timers_.Remove(*this);
+    }
+    dispatcher_ = nullptr;
+  }
+  waker_.Clear();
+}
+
+bool Timer::IsArmed() const {
+  std::lock_guard lock(dispatcher_lock());
+  return is_linked();
+}
+
+uint8_t DispatcherBase::NextLockIndex() {
+  static uint8_t next_lock_index = 0;
+  std::lock_guard lock(internal::dispatcher_lock(0));
+  uint8_t lock_index = next_lock_index;
+  next_lock_index = static_cast<uint8_t>((next_lock_index + 1) %
+                                         internal::kNumDispatcherLocks);
+  return lock_index;
+}
+
 void DispatcherBase::Deregister() {
   std::lock_guard lock(dispatcher_lock());
   UnpostTaskList(first_woken_);
@@ -183,6 +278,7 @@ void DispatcherBase::Deregister() {
   last_woken_ = nullptr;
   UnpostTaskList(sleeping_);
   sleeping_ = nullptr;
+  timers_.Clear();
 }
 
 void DispatcherBase::UnpostTaskList(Task* task) {
@@ -209,20 +305,20 @@ void DispatcherBase::RemoveTaskFromList(Task& task) {
 }
 
 void DispatcherBase::RemoveWokenTaskLocked(Task& task) {
-  RemoveTaskFromList(task);
   if (first_woken_ == &task) {
     first_woken_ = task.next_;
   }
   if (last_woken_ == &task) {
     last_woken_ = task.prev_;
   }
+  RemoveTaskFromList(task);
 }
 
 void DispatcherBase::RemoveSleepingTaskLocked(Task& task) {
-  RemoveTaskFromList(task);
   if (sleeping_ == &task) {
     sleeping_ = task.next_;
   }
+  RemoveTaskFromList(task);
 }
 
 void DispatcherBase::AddTaskToWokenList(Task& task) {
@@ -251,28 +347,49 @@ void DispatcherBase::WakeTask(Task& task) {
     case Task::State::kUnposted:
       // This should be unreachable.
       PW_CHECK(false);
+    case Task::State::kWokenWhileRunning:
+      // Do nothing-- this will already be run again.
+      return;
     case Task::State::kRunning:
       // Wake again to indicate that this task should be run once more,
       // as the state of the world may have changed since the task
-      // started running.
-      break;
+      // started running. The task is queued once its current run ends, so
+      // that no other thread runs it concurrently.
+      task.state_ = Task::State::kWokenWhileRunning;
+      RecordWakeLocked(task);
+      return;
     case Task::State::kSleeping:
       RemoveSleepingTaskLocked(task);
       // Wake away!
       break;
   }
   task.state_ = Task::State::kWoken;
+  RecordWakeLocked(task);
   AddTaskToWokenList(task);
-  if (wants_wake_) {
-    // Note: it's quite annoying to make this call under the lock, as it can
-    // result in extra thread wakeup/sleep cycles.
-    //
-    // However, releasing the lock first would allow for the possibility that
-    // the ``Dispatcher`` has been destroyed, making the call invalid.
+
+  // Note: it's quite annoying to make this call under the lock, as it can
+  // result in extra thread wakeup/sleep cycles.
+  //
+  // However, releasing the lock first would allow for the possibility that
+  // the ``Dispatcher`` has been destroyed, making the call invalid.
+  WakeWaitingRunnersLocked(1);
+}
+
+void DispatcherBase::WakeWaitingRunnersLocked(size_t count) {
+  count = std::min(count, waiting_runners_);
+  waiting_runners_ -= count;
+  for (size_t i = 0; i < count; ++i) {
     DoWake();
   }
 }
 
+void DispatcherBase::NotifyTaskStoppedLocked() {
+  if (deregister_waiters_ != 0) {
+    task_stopped_.release(static_cast<ptrdiff_t>(deregister_waiters_));
+    deregister_waiters_ = 0;
+  }
+}
+
 Task* DispatcherBase::PopWokenTask() {
   if (first_woken_ == nullptr) {
     return nullptr;
@@ -289,4 +406,37 @@ Task* DispatcherBase::PopWokenTask() {
   return &task;
 }
 
+void DispatcherBase::AddTimerLocked(Timer& timer,
+                                    SystemClock::time_point deadline) {
+  // An empty wheel may not have been advanced in a long time. Catch it up so
+  // the timer is stored relative to the current time. This expires nothing.
+  if (timers_.empty()) {
+    timers_.Advance(TimerTickAtOrBefore(SystemClock::now()));
+  }
+  timers_.Insert(timer, TimerTickAtOrAfter(deadline));
+}
+
+void DispatcherBase::ExpireTimersLocked(SystemClock::time_point now) {
+  internal::TimerWheel::Entry* expired =
+      timers_.Advance(TimerTickAtOrBefore(now));
+  while (expired != nullptr) {
+    Timer& timer = static_cast<Timer&>(*expired);
+    expired = expired->next_expired();
+    if (timer.waker_.task_ != nullptr) {
+      WakeTask(*timer.waker_.task_);
+      timer.waker_.RemoveFromTaskWakerListLocked();
+    }
+  }
+}
+
+std::optional<SystemClock::time_point> DispatcherBase::NextTimerDeadlineLocked()
+    const {
+  std::optional<uint64_t> tick = timers_.NextEventTick();
+  if (!tick.has_value()) {
+    return std::nullopt;
+  }
+  // Deadlines too far in the future to represent are never reached.
+  return TimerTickStart(*tick);
+}
+
 }  // namespace pw::async2
@@ -14,7 +14,10 @@
 
 #include "pw_async2/dispatcher.h"
 
+#include <chrono>
+
 #include "gtest/gtest.h"
+#include "pw_chrono/system_clock.h"
 #include "pw_containers/vector.h"
 
 namespace pw::async2 {
@@ -173,5 +176,140 @@ TEST(Dispatcher, RunToCompletionIgnoresDeregisteredTask) {
   EXPECT_EQ(task.destroyed, 0);
 }
 
+TEST(Dispatcher, WakerMovesBetweenDispatchers) {
+  Dispatcher dispatcher1;
+  Dispatcher dispatcher2;
+  MockTask task1;
+  MockTask task2;
+  dispatcher1.Post(task1);
+  dispatcher2.Post(task2);
+  EXPECT_TRUE(dispatcher1.RunUntilStalled().IsPending());
+  EXPECT_TRUE(dispatcher2.RunUntilStalled().IsPending());
+
+  // Replace a waker for one dispatcher's task with one for the other's.
+  Waker waker = std::move(*task1.last_waker);
+  waker = std::move(*task2.last_waker);
+  EXPECT_TRUE(task1.last_waker->IsEmpty());
+  EXPECT_TRUE(task2.last_waker->IsEmpty());
+
+  std::move(waker).Wake();
+  EXPECT_TRUE(dispatcher1.RunUntilStalled().IsPending());
+  EXPECT_TRUE(dispatcher2.RunUntilStalled().IsPending());
+  EXPECT_EQ(task1.polled, 1);
+  EXPECT_EQ(task2.polled, 2);
+
+  task1.Deregister();
+  task2.Deregister();
+}
+
+TEST(Dispatcher, WakerOutlivesDispatcher) {
+  MockTask task;
+  {
+    Dispatcher dispatcher;
+    dispatcher.Post(task);
+    EXPECT_TRUE(dispatcher.RunUntilStalled().IsPending());
+  }
+  EXPECT_FALSE(task.IsRegistered());
+  ASSERT_TRUE(task.last_waker.has_value());
+  EXPECT_TRUE(task.last_waker->IsEmpty());
+  std::move(*task.last_waker).Wake();
+}
+
+
+using ::pw::chrono::SystemClock;
+using namespace std::chrono_literals;
+
+class TimerTask : public Task {
+ public:
+  explicit TimerTask(SystemClock::time_point deadline) : deadline_(deadline) {}
+
+  Timer timer;
+  int polled = 0;
+  std::optional<SystemClock::time_point> completed_at;
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    ++polled;
+    if (timer.PendUntil(cx, deadline_).IsPending()) {
+      return Pending();
+    }
+    completed_at = SystemClock::now();
+    return Ready();
+  }
+
+  SystemClock::time_point deadline_;
+};
+
+TEST(Timer, ReadyWhenDeadlineHasPassed) {
+  TimerTask task(SystemClock::now());
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+  EXPECT_TRUE(dispatcher.RunUntilStalled(task).IsReady());
+  EXPECT_EQ(task.polled, 1);
+  EXPECT_FALSE(task.timer.IsArmed());
+}
+
+TEST(Timer, WakesTaskAfterDeadline) {
+  SystemClock::time_point deadline = SystemClock::now() + 10ms;
+  TimerTask task(deadline);
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+  EXPECT_FALSE(dispatcher.RunUntilStalled(task).IsReady());
+  EXPECT_TRUE(task.timer.IsArmed());
+
+  dispatcher.RunToCompletion(task);
+  ASSERT_TRUE(task.completed_at.has_value());
+  EXPECT_GE(*task.completed_at, deadline);
+  EXPECT_EQ(task.polled, 2);
+  EXPECT_FALSE(task.timer.IsArmed());
+}
+
+TEST(Timer, CancelledTimerDoesNotWakeTask) {
+  SystemClock::time_point deadline = SystemClock::now() + 1ms;
+  TimerTask task(deadline);
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+  EXPECT_FALSE(dispatcher.RunUntilStalled(task).IsReady());
+  task.timer.Cancel();
+  EXPECT_FALSE(task.timer.IsArmed());
+
+  while (SystemClock::now() < deadline + 2ms) {
+  }
+  EXPECT_FALSE(dispatcher.RunUntilStalled(task).IsReady());
+  EXPECT_EQ(task.polled, 1);
+  task.Deregister();
+}
+
+TEST(Timer, ManyTimersWakeTheirTasks) {
+  constexpr size_t kNumTasks = 20;
+  SystemClock::time_point start = SystemClock::now();
+  pw::Vector<TimerTask, kNumTasks> tasks;
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    tasks.emplace_back(start + std::chrono::milliseconds(kNumTasks - i));
+  }
+  Dispatcher dispatcher;
+  for (TimerTask& task : tasks) {
+    dispatcher.Post(task);
+  }
+  dispatcher.RunToCompletion();
+  for (size_t i = 0; i < kNumTasks; ++i) {
+    ASSERT_TRUE(tasks[i].completed_at.has_value());
+    EXPECT_GE(*tasks[i].completed_at,
+              start + std::chrono::milliseconds(kNumTasks - i));
+  }
+}
+
+TEST(Timer, OutlivesDispatcher) {
+  TimerTask task(SystemClock::now() + 1h);
+  {
+    Dispatcher dispatcher;
+    dispatcher.Post(task);
+    EXPECT_FALSE(dispatcher.RunUntilStalled(task).IsReady());
+    EXPECT_TRUE(task.timer.IsArmed());
+  }
+  EXPECT_FALSE(task.timer.IsArmed());
+  EXPECT_FALSE(task.IsRegistered());
+}
+
 }  // namespace
 }  // namespace pw::async2
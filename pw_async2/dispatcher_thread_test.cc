@@ -12,13 +12,16 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
 #include <atomic>
 
 #include "gtest/gtest.h"
 #include "pw_async2/dispatcher.h"
+#include "pw_chrono/system_clock.h"
 #include "pw_function/function.h"
 #include "pw_thread/sleep.h"
 #include "pw_thread/thread.h"
+#include "pw_thread/yield.h"
 #include "pw_thread_stl/options.h"
 
 namespace pw::async2 {
@@ -79,5 +82,152 @@ TEST(Dispatcher, RunToCompletion_SleepsUntilWoken) {
   EXPECT_EQ(task.destroyed, 1);
 }
 
+/// Task that requeues itself until it has been polled a number of times,
+/// checking that it is never polled by two threads at once.
+class RequeueingTask : public Task {
+ public:
+  static constexpr int kPollsToComplete = 100;
+
+  std::atomic_int polled = 0;
+  std::atomic_bool polled_concurrently = false;
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    if (pending_.exchange(true)) {
+      polled_concurrently = true;
+    }
+    this_thread::yield();
+    // Wake before returning, so the task may be woken while running.
+    cx.ReEnqueue();
+    pending_ = false;
+    return ++polled == kPollsToComplete ? Ready() : Pending();
+  }
+
+  std::atomic_bool pending_ = false;
+};
+
+TEST(Dispatcher, RunToCompletion_MultipleThreads) {
+  Dispatcher dispatcher;
+  std::array<RequeueingTask, 8> tasks;
+  for (RequeueingTask& task : tasks) {
+    dispatcher.Post(task);
+  }
+
+  FunctionThread runner([&dispatcher]() { dispatcher.RunToCompletion(); });
+  thread::Thread thread1(thread::stl::Options(), runner);
+  thread::Thread thread2(thread::stl::Options(), runner);
+  dispatcher.RunToCompletion();
+  thread1.join();
+  thread2.join();
+
+  for (RequeueingTask& task : tasks) {
+    EXPECT_EQ(task.polled, RequeueingTask::kPollsToComplete);
+    EXPECT_FALSE(task.polled_concurrently);
+    EXPECT_FALSE(task.IsRegistered());
+  }
+}
+
+TEST(Dispatcher, RunToCompletion_MultipleThreadsSleepUntilWoken) {
+  MockTask task;
+  task.should_complete = false;
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+
+  FunctionThread runner([&dispatcher]() { dispatcher.RunToCompletion(); });
+  thread::Thread thread1(thread::stl::Options(), runner);
+  thread::Thread thread2(thread::stl::Options(), runner);
+
+  // Both threads sleep while the task waits, and both return after it
+  // completes.
+  this_thread::sleep_for(100ms);
+  task.should_complete = true;
+  std::move(task.last_waker).Wake();
+  thread1.join();
+  thread2.join();
+
+  EXPECT_EQ(task.polled, 2);
+  EXPECT_EQ(task.destroyed, 1);
+}
+
+TEST(Dispatcher, Deregister_WaitsForRunningTask) {
+  Dispatcher dispatcher;
+  RequeueingTask task;
+  dispatcher.Post(task);
+
+  FunctionThread runner([&dispatcher]() { dispatcher.RunToCompletion(); });
+  thread::Thread thread1(thread::stl::Options(), runner);
+  while (task.polled == 0) {
+    this_thread::yield();
+  }
+  task.Deregister();
+  EXPECT_FALSE(task.IsRegistered());
+  int polled = task.polled;
+  thread1.join();
+  EXPECT_EQ(task.polled, polled);
+}
+
+TEST(Dispatcher, IndependentDispatchersRunConcurrently) {
+  Dispatcher dispatcher1;
+  Dispatcher dispatcher2;
+  RequeueingTask task1;
+  RequeueingTask task2;
+  dispatcher1.Post(task1);
+  dispatcher2.Post(task2);
+
+  FunctionThread runner([&dispatcher2]() { dispatcher2.RunToCompletion(); });
+  thread::Thread thread2(thread::stl::Options(), runner);
+  dispatcher1.RunToCompletion();
+  thread2.join();
+
+  EXPECT_EQ(task1.polled, RequeueingTask::kPollsToComplete);
+  EXPECT_EQ(task2.polled, RequeueingTask::kPollsToComplete);
+}
+
+// A task that waits on a timer several times before completing.
+class PeriodicTask : public Task {
+ public:
+  static constexpr int kPeriods = 5;
+
+  std::atomic_int fired = 0;
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    while (fired < kPeriods) {
+      if (!deadline_.has_value()) {
+        deadline_ = chrono::SystemClock::now() + 2ms;
+      }
+      if (timer_.PendUntil(cx, *deadline_).IsPending()) {
+        return Pending();
+      }
+      EXPECT_GE(chrono::SystemClock::now(), *deadline_);
+      deadline_.reset();
+      ++fired;
+    }
+    return Ready();
+  }
+
+  Timer timer_;
+  std::optional<chrono::SystemClock::time_point> deadline_;
+};
+
+TEST(Dispatcher, RunToCompletion_MultipleThreadsWakeForTimers) {
+  Dispatcher dispatcher;
+  std::array<PeriodicTask, 4> tasks;
+  for (PeriodicTask& task : tasks) {
+    dispatcher.Post(task);
+  }
+
+  FunctionThread runner([&dispatcher]() { dispatcher.RunToCompletion(); });
+  thread::Thread thread1(thread::stl::Options(), runner);
+  thread::Thread thread2(thread::stl::Options(), runner);
+  dispatcher.RunToCompletion();
+  thread1.join();
+  thread2.join();
+
+  for (PeriodicTask& task : tasks) {
+    EXPECT_EQ(task.fired, PeriodicTask::kPeriods);
+  }
+}
+
 }  // namespace
 }  // namespace pw::async2
@@ -0,0 +1,111 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/mpmc_queue.h"
+
+#include "pw_async2/dispatcher.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using ::pw::async2::Context;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::MpmcQueue;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+using ::pw::async2::Task;
+
+class PopTask : public Task {
+ public:
+  PopTask(MpmcQueue<int, 4>& queue, int values_to_pop)
+      : queue_(queue), remaining_(values_to_pop) {}
+
+  int sum() const { return sum_; }
+  int polls() const { return polls_; }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    polls_ += 1;
+    while (remaining_ > 0) {
+      Poll<int> value = queue_.PendPop(cx);
+      if (value.IsPending()) {
+        return Pending();
+      }
+      sum_ += *value;
+      remaining_ -= 1;
+    }
+    return Ready();
+  }
+
+  MpmcQueue<int, 4>& queue_;
+  int remaining_;
+  int sum_ = 0;
+  int polls_ = 0;
+};
+
+TEST(MpmcQueue, PushAndPopWithoutTasks) {
+  MpmcQueue<int, 4> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_TRUE(queue.TryPush(1));
+  EXPECT_TRUE(queue.TryEmplace(2));
+  EXPECT_EQ(queue.size(), 2u);
+  EXPECT_EQ(queue.TryPop(), 1);
+  EXPECT_EQ(queue.TryPop(), 2);
+  EXPECT_FALSE(queue.TryPop().has_value());
+}
+
+TEST(MpmcQueue, PendPopReturnsQueuedValue) {
+  MpmcQueue<int, 4> queue;
+  ASSERT_TRUE(queue.TryPush(5));
+
+  Dispatcher dispatcher;
+  PopTask task(queue, 1);
+  dispatcher.Post(task);
+  EXPECT_TRUE(dispatcher.RunUntilStalled(task).IsReady());
+  EXPECT_EQ(task.sum(), 5);
+}
+
+TEST(MpmcQueue, PushWakesWaitingTask) {
+  MpmcQueue<int, 4> queue;
+  Dispatcher dispatcher;
+  PopTask task(queue, 3);
+  dispatcher.Post(task);
+  EXPECT_TRUE(dispatcher.RunUntilStalled(task).IsPending());
+  EXPECT_EQ(task.polls(), 1);
+
+  // The task is not polled again until a value is pushed.
+  EXPECT_TRUE(dispatcher.RunUntilStalled(task).IsPending());
+  EXPECT_EQ(task.polls(), 1);
+
+  ASSERT_TRUE(queue.TryPush(10));
+  ASSERT_TRUE(queue.TryPush(20));
+  EXPECT_TRUE(dispatcher.RunUntilStalled(task).IsPending());
+  EXPECT_EQ(task.polls(), 2);
+  EXPECT_EQ(task.sum(), 30);
+
+  ASSERT_TRUE(queue.TryPush(30));
+  EXPECT_TRUE(dispatcher.RunUntilStalled(task).IsReady());
+  EXPECT_EQ(task.sum(), 60);
+}
+
+TEST(MpmcQueue, FullQueueRejectsPush) {
+  MpmcQueue<int, 2> queue;
+  EXPECT_TRUE(queue.TryPush(1));
+  EXPECT_TRUE(queue.TryPush(2));
+  EXPECT_FALSE(queue.TryPush(3));
+  EXPECT_EQ(queue.size(), 2u);
+}
+
+}  // namespace
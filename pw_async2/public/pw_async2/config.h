@@ -0,0 +1,30 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// PW_ASYNC2_CONFIG_NUM_DISPATCHER_LOCKS sets the number of locks shared by all
+// dispatchers. Each dispatcher is assigned one of these locks in turn when it
+// is constructed, so up to this many dispatchers run without contending on a
+// lock. Setting this to 1 makes all dispatchers share a single lock.
+#ifndef PW_ASYNC2_CONFIG_NUM_DISPATCHER_LOCKS
+#define PW_ASYNC2_CONFIG_NUM_DISPATCHER_LOCKS 4
+#endif  // PW_ASYNC2_CONFIG_NUM_DISPATCHER_LOCKS
+
+// PW_ASYNC2_CONFIG_TIMER_RESOLUTION_MS sets the granularity, in milliseconds,
+// of the timer wheel used by each dispatcher for ``Timer`` deadlines.
+// Deadlines are rounded up to a multiple of this resolution, so a coarser
+// resolution lets timers with nearby deadlines expire together.
+#ifndef PW_ASYNC2_CONFIG_TIMER_RESOLUTION_MS
+#define PW_ASYNC2_CONFIG_TIMER_RESOLUTION_MS 1
+#endif  // PW_ASYNC2_CONFIG_TIMER_RESOLUTION_MS
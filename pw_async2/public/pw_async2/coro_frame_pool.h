@@ -0,0 +1,273 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/layout.h"
+#include "pw_span/span.h"
+
+namespace pw::async2 {
+namespace internal {
+
+/// Size-independent implementation of `CoroFramePool`.
+class GenericCoroFramePool {
+ public:
+  /// Freed frames of a single size class, and their statistics.
+  struct SizeClass {
+    struct FreeFrame {
+      FreeFrame* next;
+    };
+
+    FreeFrame* head = nullptr;
+    size_t cached = 0;
+    size_t live = 0;
+    size_t peak_live = 0;
+    size_t allocations = 0;
+    size_t cache_hits = 0;
+  };
+
+  /// Number of allocations of frames of one size.
+  struct FrameSize {
+    size_t size = 0;
+    size_t allocations = 0;
+  };
+
+  GenericCoroFramePool(allocator::Allocator& allocator,
+                       span<SizeClass> size_classes,
+                       span<FrameSize> frame_sizes,
+                       size_t min_size,
+                       size_t max_cached_per_class)
+      : allocator_(allocator),
+        size_classes_(size_classes),
+        frame_sizes_(frame_sizes),
+        min_size_(min_size),
+        max_cached_per_class_(max_cached_per_class) {}
+
+  /// @copydoc Allocator::Allocate
+  void* Allocate(allocator::Layout layout);
+
+  /// @copydoc Deallocator::Deallocate
+  void Deallocate(void* ptr);
+
+  /// @copydoc CoroFramePool::Reserve
+  size_t Reserve(size_t frame_size, size_t count);
+
+  /// @copydoc CoroFramePool::Flush
+  void Flush();
+
+  size_t ChunkSize(size_t index) const { return min_size_ << index; }
+
+  const SizeClass& size_class(size_t index) const {
+    return size_classes_[index];
+  }
+
+  /// Returns the frame sizes that have been requested.
+  span<const FrameSize> frame_sizes() const;
+
+  size_t largest_frame() const { return largest_frame_; }
+  size_t uncached_allocations() const { return uncached_allocations_; }
+
+ private:
+  /// Stored immediately before each frame.
+  struct Header {
+    /// Index of the size class of the frame, or `kUncached`.
+    uint16_t index;
+
+    /// Offset of the frame from the start of its allocation.
+    uint16_t offset;
+  };
+
+  static constexpr uint16_t kUncached = UINT16_MAX;
+  static constexpr size_t kHeaderSize = alignof(std::max_align_t);
+  static_assert(sizeof(Header) <= kHeaderSize);
+
+  static Header& HeaderOf(void* frame) {
+    return *(static_cast<Header*>(frame) - 1);
+  }
+
+  /// Returns the index of the smallest size class that holds `size` bytes, or
+  /// the number of size classes if none does.
+  size_t IndexOf(size_t size) const;
+
+  /// Allocates a frame for the size class at `index` from the upstream
+  /// allocator.
+  void* AllocateChunk(size_t index);
+
+  static void Push(SizeClass& size_class, void* frame);
+  static void* Pop(SizeClass& size_class);
+
+  void RecordFrameSize(size_t size);
+
+  allocator::Allocator& allocator_;
+  span<SizeClass> size_classes_;
+  span<FrameSize> frame_sizes_;
+  size_t min_size_;
+  size_t max_cached_per_class_;
+  size_t largest_frame_ = 0;
+  size_t uncached_allocations_ = 0;
+};
+
+}  // namespace internal
+
+/// Allocator that caches coroutine frames for reuse.
+///
+/// Every `Coro` allocates its frame from the allocator of the `CoroContext` it
+/// is started with, and frees it once it completes. For coroutines that are
+/// started repeatedly, e.g. one per request, using a `CoroFramePool` for their
+/// `CoroContext` makes starting them allocation-free in steady state. Frames
+/// are rounded up to one of `kNumSizeClasses` power-of-two size classes,
+/// starting at `kMinSize`, and freed frames are kept in a list per size class
+/// rather than returned to the upstream allocator. `Reserve` fills the cache
+/// ahead of time, so that even the first coroutines do not allocate.
+///
+/// Frames larger than the largest size class, or aligned to more than
+/// `alignof(std::max_align_t)`, are passed through to the upstream allocator.
+/// Each frame is preceded by a header of `alignof(std::max_align_t)` bytes.
+///
+/// The pool keeps statistics to help choose its parameters:
+///
+/// * For each size class, the number of frames allocated, how many of them
+///   came from the cache, and the peak number of frames in use at once.
+/// * The number of allocations of each of the first `kMaxFrameSizes` distinct
+///   frame sizes requested. Each coroutine function has a fixed frame size, so
+///   distinct frame sizes typically correspond to distinct coroutines.
+///
+/// This object is NOT thread-safe. If coroutines are started or completed on
+/// several threads, wrap it in a `pw::allocator::SynchronizedAllocator`.
+///
+/// @tparam kNumSizeClasses     Number of cached size classes.
+/// @tparam kMinSize            Size of the smallest size class. Must be a power
+///                             of two large enough to hold a pointer.
+/// @tparam kMaxCachedPerClass  Maximum number of freed frames cached per size
+///                             class.
+/// @tparam kMaxFrameSizes      Number of distinct frame sizes to keep
+///                             statistics for.
+template <size_t kNumSizeClasses = 4,
+          size_t kMinSize = 64,
+          size_t kMaxCachedPerClass = 8,
+          size_t kMaxFrameSizes = 8>
+class CoroFramePool : public allocator::Allocator {
+ public:
+  static_assert(kNumSizeClasses > 0);
+  static_assert(kNumSizeClasses < UINT16_MAX);
+  static_assert((kMinSize & (kMinSize - 1)) == 0,
+                "kMinSize must be a power of two");
+  static_assert(kMinSize >= sizeof(void*),
+                "kMinSize must be large enough to hold a pointer");
+
+  /// Statistics of the frames allocated from one size class.
+  struct SizeClassStats {
+    /// Size of the largest frame the size class holds.
+    size_t frame_size;
+
+    /// Number of frames allocated.
+    size_t allocations;
+
+    /// Number of frames allocated from the cache.
+    size_t cache_hits;
+
+    /// Number of frames currently allocated.
+    size_t live;
+
+    /// Largest number of frames allocated at once.
+    size_t peak_live;
+
+    /// Number of freed frames currently cached.
+    size_t cached;
+  };
+
+  /// Number of allocations of frames of one size.
+  using FrameSizeStats = internal::GenericCoroFramePool::FrameSize;
+
+  /// Constructor.
+  ///
+  /// @param[in]  allocator  Allocator that frames are allocated from.
+  explicit CoroFramePool(allocator::Allocator& allocator)
+      : allocator::Allocator(kCapabilities),
+        impl_(allocator,
+              size_classes_,
+              frame_sizes_,
+              kMinSize,
+              kMaxCachedPerClass) {}
+
+  ~CoroFramePool() override { Flush(); }
+
+  /// Caches frames that hold `frame_size` bytes until `count` are cached, so
+  /// that as many coroutines with frames of that size may start without
+  /// allocating. `count` may exceed `kMaxCachedPerClass`, in which case frames
+  /// are returned to the upstream allocator as they are freed until no more
+  /// than `kMaxCachedPerClass` are cached.
+  ///
+  /// @returns The number of frames cached for `frame_size`. This is less than
+  /// `count` if the upstream allocator is exhausted, and zero if `frame_size`
+  /// is larger than the largest size class.
+  size_t Reserve(size_t frame_size, size_t count) {
+    return impl_.Reserve(frame_size, count);
+  }
+
+  /// Returns all cached frames to the upstream allocator.
+  void Flush() { impl_.Flush(); }
+
+  /// Returns the statistics of the size class at `index`.
+  SizeClassStats size_class_stats(size_t index) const {
+    const internal::GenericCoroFramePool::SizeClass& size_class =
+        impl_.size_class(index);
+    return SizeClassStats{impl_.ChunkSize(index),
+                          size_class.allocations,
+                          size_class.cache_hits,
+                          size_class.live,
+                          size_class.peak_live,
+                          size_class.cached};
+  }
+
+  /// Returns the number of allocations of each distinct frame size requested,
+  /// in the order the sizes were first requested.
+  span<const FrameSizeStats> frame_size_stats() const {
+    return impl_.frame_sizes();
+  }
+
+  /// Returns the size of the largest frame requested.
+  size_t largest_frame() const { return impl_.largest_frame(); }
+
+  /// Returns the number of frames passed through to the upstream allocator
+  /// because no size class holds them.
+  size_t uncached_allocations() const { return impl_.uncached_allocations(); }
+
+ private:
+  static constexpr Capabilities kCapabilities = 0;
+
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(allocator::Layout layout) override {
+    return impl_.Allocate(layout);
+  }
+
+  /// @copydoc Deallocator::Deallocate
+  void DoDeallocate(void* ptr) override { impl_.Deallocate(ptr); }
+
+  /// @copydoc Deallocator::Deallocate
+  void DoDeallocate(void* ptr, allocator::Layout) override {
+    DoDeallocate(ptr);
+  }
+
+  std::array<internal::GenericCoroFramePool::SizeClass, kNumSizeClasses>
+      size_classes_;
+  std::array<FrameSizeStats, kMaxFrameSizes> frame_sizes_;
+  internal::GenericCoroFramePool impl_;
+};
+
+}  // namespace pw::async2
@@ -13,34 +13,54 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <mutex>
 #include <optional>
 
 #include "pw_assert/assert.h"
+#include "pw_async2/config.h"
+#include "pw_async2/internal/timer_wheel.h"
 #include "pw_async2/poll.h"
+#include "pw_async2/task_metrics.h"
 #include "pw_chrono/system_clock.h"
+#include "pw_sync/counting_semaphore.h"
 #include "pw_sync/interrupt_spin_lock.h"
-#include "pw_sync/lock_annotations.h"
-#include "pw_sync/mutex.h"
 #include "pw_toolchain/no_destructor.h"
 
 namespace pw::async2 {
+namespace internal {
 
-/// A lock guarding the ``Task`` queue and ``Waker`` lists.
+inline constexpr size_t kNumDispatcherLocks =
+    PW_ASYNC2_CONFIG_NUM_DISPATCHER_LOCKS;
+static_assert(kNumDispatcherLocks > 0 && kNumDispatcherLocks <= UINT8_MAX + 1,
+              "PW_ASYNC2_CONFIG_NUM_DISPATCHER_LOCKS must be in [1, 256]");
+
+/// Returns one of the locks guarding ``Task`` queues and ``Waker`` lists.
 ///
-/// This is an ``InterruptSpinLock`` in order to allow posting work from ISR
+/// These are ``InterruptSpinLock`` s in order to allow posting work from ISR
 /// contexts.
 ///
-/// This lock is global rather than per-dispatcher in order to allow ``Task``
-/// and ``Waker`` to take out the lock without dereferencing their
-/// ``Dispatcher*`` fields, which are themselves guarded by the lock in order
-/// to allow the ``Dispatcher`` to ``Deregister`` itself upon destruction.
-inline pw::sync::InterruptSpinLock& dispatcher_lock() {
-  static NoDestructor<pw::sync::InterruptSpinLock> lock;
-  return *lock;
+/// Each ``Dispatcher`` is assigned one of these locks, which guards its
+/// ``Task`` queues and the ``Task`` s and ``Waker`` s linked to it, so that
+/// independent dispatchers do not contend with one another.
+///
+/// The locks are statically allocated rather than owned by each dispatcher in
+/// order to allow ``Task`` and ``Waker`` to take out the lock without
+/// dereferencing their ``Dispatcher*`` fields, which are themselves guarded by
+/// the lock in order to allow the ``Dispatcher`` to ``Deregister`` itself upon
+/// destruction.
+inline pw::sync::InterruptSpinLock& dispatcher_lock(uint8_t index) {
+  static NoDestructor<
+      std::array<pw::sync::InterruptSpinLock, kNumDispatcherLocks>>
+      locks;
+  return (*locks)[index];
 }
 
+}  // namespace internal
+
 class DispatcherBase;
+class Timer;
 class Waker;
 class WaitReason;
 
@@ -118,6 +138,7 @@ class Context {
 ///   ``Deregister`` may not be called from inside the ``Task``'s own ``Pend``
 ///   method.
 class Task {
+  friend class Timer;
   friend class Waker;
   friend class DispatcherBase;
   template <typename T>
@@ -181,6 +202,13 @@ class Task {
   /// Note that this will *not* destroy the underlying ``Task``.
   void Deregister();
 
+  /// Attaches ``metrics`` to record this ``Task`` 's execution statistics,
+  /// or detaches any attached metrics if ``metrics`` is null.
+  ///
+  /// This must not be called while this ``Task`` is registered with a
+  /// ``Dispatcher``, and ``metrics`` must outlive its registration.
+  void set_metrics(TaskMetrics* metrics) { metrics_ = metrics; }
+
   /// A public interface for ``DoDestroy``.
   ///
   /// ``DoDestroy`` is normally invoked by a ``Dispatcher`` after a ``Post`` ed
@@ -194,7 +222,7 @@ class Task {
   ///
   /// If the task is currently running, this will return false and the task
   /// will not be deregistered.
-  bool TryDeregister() PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  bool TryDeregister();
 
   /// Attempts to advance this ``Task`` to completion.
   ///
@@ -224,28 +252,38 @@ class Task {
   /// here.
   virtual void DoDestroy() {}
 
+  // Returns the lock guarding the fields below, i.e. the lock of the
+  // dispatcher this task is posted to.
+  pw::sync::InterruptSpinLock& dispatcher_lock() const {
+    return internal::dispatcher_lock(lock_index_);
+  }
+
   // Unlinks all ``Waker`` objects associated with this ``Task.``
-  void RemoveAllWakersLocked() PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  void RemoveAllWakersLocked();
 
   // Adds a ``Waker`` to the linked list of ``Waker`` s tracked by this
   // ``Task``.
-  void AddWakerLocked(Waker&) PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  void AddWakerLocked(Waker&);
 
   // Removes a ``Waker`` from the linked list of ``Waker`` s tracked by this
   // ``Task``
   //
   // Precondition: the provided waker *must* be in the list of ``Waker`` s
   // tracked by this ``Task``.
-  void RemoveWakerLocked(Waker&) PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  void RemoveWakerLocked(Waker&);
 
   enum class State {
     kUnposted,
     kRunning,
+    // The task was woken while running, and will be added to the woken list
+    // once its current ``Pend`` returns. This ensures that a task is never
+    // ``Pend``'d by more than one thread at a time.
+    kWokenWhileRunning,
     kWoken,
     kSleeping,
   };
   // The current state of the task.
-  State state_ PW_GUARDED_BY(dispatcher_lock()) = State::kUnposted;
+  State state_ = State::kUnposted;
 
   // A pointer to the dispatcher this task is associated with.
   //
@@ -253,16 +291,25 @@ class Task {
   //
   // This value must be cleared by the dispatcher upon destruction in order to
   // prevent null access.
-  DispatcherBase* dispatcher_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
+  DispatcherBase* dispatcher_ = nullptr;
 
   // Pointers for whatever linked-list this ``Task`` is in.
   // These are controlled by the ``Dispatcher``.
-  Task* prev_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
-  Task* next_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
+  Task* prev_ = nullptr;
+  Task* next_ = nullptr;
 
   // A pointer to the first element of the linked list of ``Waker`` s that may
   // awaken this ``Task``.
-  Waker* wakers_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
+  Waker* wakers_ = nullptr;
+
+  // Execution statistics recorded by the dispatcher, if any.
+  TaskMetrics* metrics_ = nullptr;
+
+  // The index of the lock of the dispatcher this task was last posted to.
+  //
+  // This is only modified by ``Post``, which must not be called concurrently
+  // with other methods of this ``Task``.
+  uint8_t lock_index_ = 0;
 };
 
 /// An identifier indicating the kind of event a ``Waker`` is waiting for.
@@ -292,18 +339,19 @@ class WaitReason {
 /// into ``Task::Pend`` via its ``Context`` argument.
 class Waker {
   friend class Task;
+  friend class Timer;
   friend class DispatcherBase;
   template <typename T>
   friend class DispatcherImpl;
 
  public:
   constexpr Waker() = default;
-  Waker(Waker&& other) noexcept PW_LOCKS_EXCLUDED(dispatcher_lock());
+  Waker(Waker&& other) noexcept;
 
   /// Replace this ``Waker`` with another.
   ///
   /// This operation is guaranteed to be thread-safe.
-  Waker& operator=(Waker&& other) noexcept PW_LOCKS_EXCLUDED(dispatcher_lock());
+  Waker& operator=(Waker&& other) noexcept;
 
   ~Waker() noexcept { RemoveFromTaskWakerList(); }
 
@@ -316,7 +364,7 @@ class Waker {
   /// wake up and make progress.
   ///
   /// This operation is guaranteed to be thread-safe.
-  void Wake() && PW_LOCKS_EXCLUDED(dispatcher_lock());
+  void Wake() &&;
 
   /// Creates a second ``Waker`` from this ``Waker``.
   ///
@@ -328,7 +376,7 @@ class Waker {
   /// debugging purposes.
   ///
   /// This operation is guaranteed to be thread-safe.
-  Waker Clone(WaitReason reason) & PW_LOCKS_EXCLUDED(dispatcher_lock());
+  Waker Clone(WaitReason reason) &;
 
   /// Returns whether this ``Waker`` is empty.
   ///
@@ -338,7 +386,7 @@ class Waker {
   /// moved-from ``Waker`` will be empty.
   ///
   /// This operation is guaranteed to be thread-safe.
-  [[nodiscard]] bool IsEmpty() const PW_LOCKS_EXCLUDED(dispatcher_lock());
+  [[nodiscard]] bool IsEmpty() const;
 
   /// Clears this ``Waker``.
   ///
@@ -346,28 +394,100 @@ class Waker {
   /// ``IsEmpty`` will return ``true``.
   ///
   /// This operation is guaranteed to be thread-safe.
-  void Clear() PW_LOCKS_EXCLUDED(dispatcher_lock()) {
-    RemoveFromTaskWakerList();
-  }
+  void Clear() { RemoveFromTaskWakerList(); }
 
  private:
-  Waker(Task& task) PW_LOCKS_EXCLUDED(dispatcher_lock()) : task_(&task) {
+  Waker(Task& task) : task_(&task), lock_index_(task.lock_index_) {
     InsertIntoTaskWakerList();
   }
 
+  // Returns the lock guarding the fields below, i.e. the lock of the
+  // dispatcher of the ``Task`` to wake.
+  pw::sync::InterruptSpinLock& dispatcher_lock() const {
+    return internal::dispatcher_lock(lock_index_);
+  }
+
   void InsertIntoTaskWakerList();
-  void InsertIntoTaskWakerListLocked()
-      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  void InsertIntoTaskWakerListLocked();
   void RemoveFromTaskWakerList();
-  void RemoveFromTaskWakerListLocked()
-      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  void RemoveFromTaskWakerListLocked();
 
   // The ``Task`` to poll when awoken.
-  Task* task_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
+  Task* task_ = nullptr;
 
   // The next ``Waker`` that may awaken this ``Task``.
   // This list is controlled by the corresponding ``Task``.
-  Waker* next_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
+  Waker* next_ = nullptr;
+
+  // The index of the lock of the ``Task`` this was last linked to.
+  //
+  // Unlike ``task_``, this is not cleared when the ``Task`` or its
+  // dispatcher unlinks this ``Waker``, so it is only modified by the owner
+  // of this ``Waker``. The lock is statically allocated, so it remains valid
+  // after the dispatcher is destroyed.
+  uint8_t lock_index_ = 0;
+};
+
+/// A deadline that wakes a ``Task`` once it passes.
+///
+/// ``Timer`` s are stored in a timer wheel owned by the ``Dispatcher`` of the
+/// ``Task`` that arms them, so arming and cancelling a ``Timer`` take constant
+/// time regardless of how many are pending, and a sleeping ``Dispatcher``
+/// wakes up only for the earliest deadline.
+///
+/// Deadlines are rounded up to a multiple of
+/// ``PW_ASYNC2_CONFIG_TIMER_RESOLUTION_MS``. A ``Task`` is never woken before
+/// its deadline, but may be woken up to one resolution period after it, or
+/// later if the ``Dispatcher`` is busy running other tasks.
+///
+/// ``Timer`` s are typically stored as fields of the ``Task`` that uses them:
+///
+/// .. code-block:: cpp
+///
+///    Poll<> DoPend(Context& cx) override {
+///      if (timeout_.PendUntil(cx, deadline_).IsReady()) {
+///        return Ready();  // Timed out.
+///      }
+///      ...
+///    }
+///
+/// A ``Timer`` may be used by one ``Task`` at a time, and must not be armed
+/// or cancelled concurrently from several threads.
+class Timer : private internal::TimerWheel::Entry {
+ public:
+  constexpr Timer() = default;
+  Timer(const Timer&) = delete;
+  Timer& operator=(const Timer&) = delete;
+
+  ~Timer() { Cancel(); }
+
+  /// Returns ``Ready`` once ``deadline`` has passed. Otherwise, arms this
+  /// ``Timer`` to wake the current ``Task`` at ``deadline``, replacing any
+  /// deadline it was previously armed with, and returns ``Pending``.
+  Poll<> PendUntil(Context& cx, chrono::SystemClock::time_point deadline);
+
+  /// Disarms this ``Timer``, if it is armed.
+  void Cancel();
+
+  /// Returns whether this ``Timer`` is waiting for its deadline.
+  [[nodiscard]] bool IsArmed() const;
+
+ private:
+  friend class DispatcherBase;
+
+  pw::sync::InterruptSpinLock& dispatcher_lock() const {
+    return internal::dispatcher_lock(lock_index_);
+  }
+
+  // The ``Task`` to wake when the deadline passes.
+  Waker waker_;
+
+  // The dispatcher whose timer wheel this is linked into, if it is linked.
+  DispatcherBase* dispatcher_ = nullptr;
+
+  // The index of the lock of ``dispatcher_``, which guards the fields of this
+  // ``Timer``.
+  uint8_t lock_index_ = 0;
 };
 
 /// A base class used by ``Dispatcher`` implementations.
@@ -379,7 +499,7 @@ class Waker {
 /// to the ``Dispatcher`` class.
 class DispatcherBase {
  public:
-  DispatcherBase() = default;
+  DispatcherBase() : lock_index_(NextLockIndex()) {}
   DispatcherBase(DispatcherBase&) = delete;
   DispatcherBase(DispatcherBase&&) = delete;
   DispatcherBase& operator=(DispatcherBase&) = delete;
@@ -387,12 +507,15 @@ class DispatcherBase {
   virtual ~DispatcherBase() {}
 
  protected:
-  /// Check that a task is posted on this ``Dispatcher``.
-  bool HasPostedTask(Task& task)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock()) {
-    return task.dispatcher_ == this;
+  /// Returns the lock guarding this ``Dispatcher``'s ``Task`` queues and the
+  /// ``Task`` s and ``Waker`` s linked to it.
+  pw::sync::InterruptSpinLock& dispatcher_lock() const {
+    return internal::dispatcher_lock(lock_index_);
   }
 
+  /// Check that a task is posted on this ``Dispatcher``.
+  bool HasPostedTask(Task& task) { return task.dispatcher_ == this; }
+
   /// Removes references to this ``DispatcherBase`` from all linked ``Task`` s
   /// and ``Waker`` s.
   ///
@@ -400,10 +523,11 @@ class DispatcherBase {
   /// destructors. It is not called by the ``DispatcherBase`` destructor, as
   /// doing so would allow the ``Dispatcher`` to be referenced between the
   /// calls to ``~Dispatcher`` and ``~DispatcherBase``.
-  void Deregister() PW_LOCKS_EXCLUDED(dispatcher_lock());
+  void Deregister();
 
  private:
   friend class Task;
+  friend class Timer;
   friend class Waker;
   template <typename Impl>
   friend class DispatcherImpl;
@@ -413,51 +537,93 @@ class DispatcherBase {
   /// This method's implementation should ensure that the ``Dispatcher`` comes
   /// back from sleep and begins invoking ``RunOneTask`` again.
   ///
+  /// Each call corresponds to exactly one prior call to ``AttemptRequestWake``
+  /// that returned that the ``Dispatcher`` should sleep. When several threads
+  /// run the same ``Dispatcher``, each call must wake at most one of them.
+  ///
   /// Note: the ``dispatcher_lock()`` may or may not be held here, so it must
   /// not be acquired by ``DoWake``, nor may ``DoWake`` assume that it has been
   /// acquired.
   virtual void DoWake() = 0;
 
-  static void UnpostTaskList(Task*)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
-  static void RemoveTaskFromList(Task&)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
-  void RemoveWokenTaskLocked(Task&)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
-  void RemoveSleepingTaskLocked(Task&)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  // Returns the index of the lock to use for a new dispatcher. Dispatchers
+  // are assigned locks in turn, so up to ``kNumDispatcherLocks`` dispatchers
+  // never contend with one another.
+  static uint8_t NextLockIndex();
+
+  // The methods below must be called with ``dispatcher_lock()`` held.
+
+  static void UnpostTaskList(Task*);
+  static void RemoveTaskFromList(Task&);
+  void RemoveWokenTaskLocked(Task&);
+  void RemoveSleepingTaskLocked(Task&);
 
   // For use by ``WakeTask`` and ``DispatcherImpl::Post``.
-  void AddTaskToWokenList(Task&) PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  void AddTaskToWokenList(Task&);
+
+  // Records when ``task`` was posted or woken, if it has ``TaskMetrics``.
+  static void RecordWakeLocked(Task& task) {
+    if (task.metrics_ != nullptr) {
+      task.metrics_->woken_at_ = chrono::SystemClock::now();
+    }
+  }
 
   // For use by ``RunOneTask``.
-  void AddTaskToSleepingList(Task&)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  void AddTaskToSleepingList(Task&);
 
   // For use by ``Waker``.
-  void WakeTask(Task&) PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  void WakeTask(Task&);
+
+  // Calls ``DoWake`` for up to ``count`` threads that are waiting for work.
+  void WakeWaitingRunnersLocked(size_t count);
+
+  // Wakes any ``Task::Deregister`` calls waiting for a task to stop running.
+  void NotifyTaskStoppedLocked();
+
+  // Returns whether no tasks are posted to this ``Dispatcher``.
+  bool AllTasksCompleteLocked() const {
+    return first_woken_ == nullptr && sleeping_ == nullptr &&
+           running_count_ == 0;
+  }
 
   // For use by ``RunOneTask``.
-  Task* PopWokenTask() PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  Task* PopWokenTask();
 
-  // A lock guarding ``Task`` execution.
-  //
-  // This will be acquired prior to pulling any tasks off of the ``Task``
-  // queue, and only released after they have been run and possibly
-  // destroyed.
-  //
-  // If acquiring this lock and ``dispatcher_lock()``, this lock must
-  // be acquired first in order to avoid deadlocks.
-  //
-  // Acquiring this lock may be a slow process, as it must wait until
-  // the running task has finished executing ``Task::Pend``.
-  pw::sync::Mutex task_execution_lock_;
+  // For use by ``Timer``. Arms ``timer`` to expire at ``deadline``.
+  void AddTimerLocked(Timer& timer, chrono::SystemClock::time_point deadline);
+
+  // Wakes the tasks of all ``Timer`` s whose deadlines are no later than
+  // ``now``.
+  void ExpireTimersLocked(chrono::SystemClock::time_point now);
 
-  Task* first_woken_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
-  Task* last_woken_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
+  // Returns the time at which ``ExpireTimersLocked`` should next be called, or
+  // ``std::nullopt`` if no ``Timer`` s are armed with a reachable deadline.
+  //
+  // This may be earlier than any deadline while timers move between levels of
+  // the timer wheel, in which case no timers expire at that time.
+  std::optional<chrono::SystemClock::time_point> NextTimerDeadlineLocked()
+      const;
+
+  // Released whenever a task stops running while ``Task::Deregister`` calls
+  // are waiting for it, once per waiting call.
+  pw::sync::CountingSemaphore task_stopped_;
+  size_t deregister_waiters_ = 0;
+
+  Task* first_woken_ = nullptr;
+  Task* last_woken_ = nullptr;
   // Note: the sleeping list's order is not significant.
-  Task* sleeping_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
-  bool wants_wake_ PW_GUARDED_BY(dispatcher_lock()) = false;
+  Task* sleeping_ = nullptr;
+
+  // The number of tasks currently being ``Pend``'d.
+  size_t running_count_ = 0;
+
+  // The number of threads that are sleeping until ``DoWake`` is called.
+  size_t waiting_runners_ = 0;
+
+  // Armed ``Timer`` s, by deadline.
+  internal::TimerWheel timers_;
+
+  const uint8_t lock_index_;
 };
 
 /// Information about whether and when to sleep until as returned by
@@ -471,14 +637,31 @@ class [[nodiscard]] SleepInfo {
  public:
   bool should_sleep() const { return should_sleep_; }
 
+  /// Returns the time at which the ``Dispatcher`` should wake up even if it
+  /// has not received a ``DoWake`` call, or ``std::nullopt`` if it should
+  /// sleep until woken.
+  ///
+  /// ``Dispatcher`` s that wake up before receiving a ``DoWake`` call must
+  /// call ``AbandonRequestWake``.
+  std::optional<chrono::SystemClock::time_point> wake_time() const {
+    return wake_time_;
+  }
+
  private:
-  SleepInfo(bool should_sleep) : should_sleep_(should_sleep) {}
+  SleepInfo(bool should_sleep,
+            std::optional<chrono::SystemClock::time_point> wake_time)
+      : should_sleep_(should_sleep), wake_time_(wake_time) {}
+
+  static SleepInfo DontSleep() { return SleepInfo(false, std::nullopt); }
 
-  static SleepInfo DontSleep() { return SleepInfo(false); }
+  static SleepInfo Indefinitely() { return SleepInfo(true, std::nullopt); }
 
-  static SleepInfo Indefinitely() { return SleepInfo(true); }
+  static SleepInfo Until(chrono::SystemClock::time_point wake_time) {
+    return SleepInfo(true, wake_time);
+  }
 
   bool should_sleep_;
+  std::optional<chrono::SystemClock::time_point> wake_time_;
 };
 
 /// Information about the result of a call to ``RunOneTask``.
@@ -525,7 +708,7 @@ class DispatcherImpl : public DispatcherBase {
   /// If ``Task::Pend`` does not complete, the ``Dispatcher`` will wait
   /// until the ``Task`` is "awoken", at which point it will call ``Pend``
   /// again until the ``Task`` completes.
-  void Post(Task& task) PW_LOCKS_EXCLUDED(dispatcher_lock()) {
+  void Post(Task& task) {
     bool wake_dispatcher = false;
     {
       std::lock_guard lock(dispatcher_lock());
@@ -533,10 +716,12 @@ class DispatcherImpl : public DispatcherBase {
       PW_DASSERT(task.dispatcher_ == nullptr);
       task.state_ = Task::State::kWoken;
       task.dispatcher_ = this;
+      task.lock_index_ = lock_index_;
+      RecordWakeLocked(task);
       AddTaskToWokenList(task);
-      if (wants_wake_) {
+      if (waiting_runners_ != 0) {
         wake_dispatcher = true;
-        wants_wake_ = false;
+        --waiting_runners_;
       }
     }
     // Note: unlike in ``WakeTask``, here we know that the ``Dispatcher`` will
@@ -548,7 +733,7 @@ class DispatcherImpl : public DispatcherBase {
   }
 
   /// Runs tasks until none are able to make immediate progress.
-  Poll<> RunUntilStalled() PW_LOCKS_EXCLUDED(dispatcher_lock()) {
+  Poll<> RunUntilStalled() {
     return self().DoRunUntilStalled(nullptr);
   }
 
@@ -556,17 +741,21 @@ class DispatcherImpl : public DispatcherBase {
   /// ``task`` completes.
   ///
   /// Returns whether ``task`` completed.
-  Poll<> RunUntilStalled(Task& task) PW_LOCKS_EXCLUDED(dispatcher_lock()) {
+  Poll<> RunUntilStalled(Task& task) {
     return self().DoRunUntilStalled(&task);
   }
 
   /// Runs until all tasks complete.
-  void RunToCompletion() PW_LOCKS_EXCLUDED(dispatcher_lock()) {
+  ///
+  /// Backends may allow several threads to call this method concurrently, in
+  /// which case posted tasks are run by whichever thread is available. A task
+  /// is never ``Pend``'d by more than one thread at a time.
+  void RunToCompletion() {
     self().DoRunToCompletion(nullptr);
   }
 
   /// Runs until ``task`` completes.
-  void RunToCompletion(Task& task) PW_LOCKS_EXCLUDED(dispatcher_lock()) {
+  void RunToCompletion(Task& task) {
     self().DoRunToCompletion(&task);
   }
 
@@ -575,7 +764,9 @@ class DispatcherImpl : public DispatcherBase {
   /// requests that it be awoken when more work is available in the future.
   ///
   /// Dispatchers must invoke this method before sleeping in order to ensure
-  /// that they receive a ``DoWake`` call when there is more work to do.
+  /// that they receive a ``DoWake`` call when there is more work to do. Each
+  /// thread running the ``Dispatcher`` that is told to sleep receives its own
+  /// ``DoWake`` call.
   ///
   /// The returned ``SleepInfo`` will describe whether and for how long the
   /// ``Dispatcher`` implementation should go to sleep. Notably it will return
@@ -584,47 +775,86 @@ class DispatcherImpl : public DispatcherBase {
   ///
   /// @param  allow_empty Whether or not to allow sleeping when no tasks are
   ///                     registered.
-  SleepInfo AttemptRequestWake(bool allow_empty)
-      PW_LOCKS_EXCLUDED(dispatcher_lock()) {
+  SleepInfo AttemptRequestWake(bool allow_empty) {
     std::lock_guard lock(dispatcher_lock());
+    std::optional<chrono::SystemClock::time_point> wake_time;
+    if (!timers_.empty()) {
+      ExpireTimersLocked(chrono::SystemClock::now());
+      wake_time = NextTimerDeadlineLocked();
+    }
     // Don't allow sleeping if there are already tasks waiting to be run.
     if (first_woken_ != nullptr) {
       return SleepInfo::DontSleep();
     }
-    if (!allow_empty && sleeping_ == nullptr) {
+    // Tasks being run by other threads may still be woken or complete.
+    if (!allow_empty && sleeping_ == nullptr && running_count_ == 0) {
       return SleepInfo::DontSleep();
     }
     /// Indicate that the ``Dispatcher`` is sleeping and will need a ``DoWake``
     /// call once more work can be done.
-    wants_wake_ = true;
-    // Once timers are added, this should check them.
+    ++waiting_runners_;
+    if (wake_time.has_value()) {
+      return SleepInfo::Until(*wake_time);
+    }
     return SleepInfo::Indefinitely();
   }
 
+  /// Withdraws a request made by ``AttemptRequestWake`` that returned that
+  /// the ``Dispatcher`` should sleep, e.g. once its ``wake_time`` has passed.
+  ///
+  /// Returns ``true`` if a ``DoWake`` call for the request has already been
+  /// made or is in progress, in which case it must still be consumed.
+  bool AbandonRequestWake() {
+    std::lock_guard lock(dispatcher_lock());
+    if (waiting_runners_ == 0) {
+      return true;
+    }
+    --waiting_runners_;
+    return false;
+  }
+
   /// Attempts to run a single task, returning whether any tasks were
   /// run, and whether `task_to_look_for` was run.
-  [[nodiscard]] RunOneTaskResult RunOneTask(Task* task_to_look_for)
-      PW_LOCKS_EXCLUDED(dispatcher_lock()) {
-    std::lock_guard task_lock(task_execution_lock_);
+  ///
+  /// This may be called by several threads concurrently.
+  [[nodiscard]] RunOneTaskResult RunOneTask(Task* task_to_look_for) {
     Task* task;
+    TaskMetrics* metrics;
+    chrono::SystemClock::time_point woken_at;
     {
       std::lock_guard lock(dispatcher_lock());
+      if (!timers_.empty()) {
+        ExpireTimersLocked(chrono::SystemClock::now());
+      }
       task = PopWokenTask();
       if (task == nullptr) {
-        bool all_complete = first_woken_ == nullptr && sleeping_ == nullptr;
         return RunOneTaskResult(
-            /*completed_all_tasks=*/all_complete,
+            /*completed_all_tasks=*/AllTasksCompleteLocked(),
             /*completed_main_task=*/false,
             /*ran_a_task=*/false);
       }
       task->state_ = Task::State::kRunning;
+      ++running_count_;
+      metrics = task->metrics_;
+      if (metrics != nullptr) {
+        woken_at = metrics->woken_at_;
+      }
     }
 
     bool complete;
     {
+      chrono::SystemClock::time_point start;
+      if (metrics != nullptr) {
+        start = chrono::SystemClock::now();
+      }
       Waker waker(*task);
       Context context(self(), waker);
       complete = task->Pend(context).IsReady();
+      // Record before the task may be destroyed, which may destroy
+      // ``metrics``.
+      if (metrics != nullptr) {
+        metrics->RecordPend(woken_at, start, chrono::SystemClock::now());
+      }
     }
     if (complete) {
       bool all_complete;
@@ -632,19 +862,25 @@ class DispatcherImpl : public DispatcherBase {
         std::lock_guard lock(dispatcher_lock());
         switch (task->state_) {
           case Task::State::kUnposted:
+          case Task::State::kWoken:
           case Task::State::kSleeping:
             PW_DASSERT(false);
             PW_UNREACHABLE;
           case Task::State::kRunning:
-            break;
-          case Task::State::kWoken:
-            RemoveWokenTaskLocked(*task);
+          case Task::State::kWokenWhileRunning:
             break;
         }
         task->state_ = Task::State::kUnposted;
         task->dispatcher_ = nullptr;
         task->RemoveAllWakersLocked();
-        all_complete = first_woken_ == nullptr && sleeping_ == nullptr;
+        --running_count_;
+        NotifyTaskStoppedLocked();
+        all_complete = AllTasksCompleteLocked();
+        if (all_complete) {
+          // Let other threads running this dispatcher see that all tasks
+          // have completed.
+          WakeWaitingRunnersLocked(waiting_runners_);
+        }
       }
       task->DoDestroy();
       return RunOneTaskResult(
@@ -656,7 +892,13 @@ class DispatcherImpl : public DispatcherBase {
       if (task->state_ == Task::State::kRunning) {
         task->state_ = Task::State::kSleeping;
         AddTaskToSleepingList(*task);
+      } else {
+        PW_DASSERT(task->state_ == Task::State::kWokenWhileRunning);
+        task->state_ = Task::State::kWoken;
+        AddTaskToWokenList(*task);
       }
+      --running_count_;
+      NotifyTaskStoppedLocked();
       return RunOneTaskResult(
           /*completed_all_tasks=*/false,
           /*completed_main_task=*/false,
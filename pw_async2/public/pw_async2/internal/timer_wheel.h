@@ -0,0 +1,168 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace pw::async2::internal {
+
+/// A hierarchical timer wheel.
+///
+/// Entries are stored by the tick at which they expire. The wheel has
+/// ``kNumLevels`` levels of ``kSlotsPerLevel`` slots, where each slot of a
+/// level spans as many ticks as all the slots of the level below it. Entries
+/// that expire far in the future are stored in coarse upper levels, and are
+/// moved to finer levels as the wheel advances towards their expiration.
+/// Entries beyond the range of the top level are kept in an overflow list.
+///
+/// As a result, inserting and removing an entry take constant time, and
+/// advancing the wheel only visits slots that contain entries.
+///
+/// This class is not thread-safe.
+class TimerWheel {
+ public:
+  static constexpr size_t kSlotBits = 4;
+  static constexpr size_t kSlotsPerLevel = size_t(1) << kSlotBits;
+  static constexpr size_t kNumLevels = 6;
+
+  /// An intrusive item stored in a ``TimerWheel``.
+  class Entry {
+   public:
+    constexpr Entry() = default;
+    Entry(const Entry&) = delete;
+    Entry& operator=(const Entry&) = delete;
+
+    /// Returns whether this entry is stored in a wheel.
+    bool is_linked() const { return level_ != kUnlinked; }
+
+    /// Returns the tick at which this entry expires.
+    uint64_t expiration() const { return expiration_; }
+
+    /// Returns the next entry in a list returned by ``TimerWheel::Advance``.
+    Entry* next_expired() const { return next_; }
+
+   private:
+    friend TimerWheel;
+
+    static constexpr uint8_t kUnlinked = UINT8_MAX;
+
+    Entry* prev_ = nullptr;
+    Entry* next_ = nullptr;
+    uint64_t expiration_ = 0;
+
+    // Level of the slot holding this entry, or ``kOverflow`` or ``kExpired``
+    // for the lists of entries that are too far from or no later than
+    // ``now_``.
+    uint8_t level_ = kUnlinked;
+    uint8_t slot_ = 0;
+  };
+
+  constexpr TimerWheel() = default;
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  /// Returns whether no entries are stored.
+  bool empty() const { return size_ == 0; }
+
+  /// Returns the number of stored entries.
+  size_t size() const { return size_; }
+
+  /// Returns the tick the wheel was last advanced to.
+  uint64_t now() const { return now_; }
+
+  /// Adds an entry that expires at the given tick.
+  ///
+  /// Entries that have already expired are returned by the next call to
+  /// ``Advance``.
+  ///
+  /// @pre ``entry`` must not be linked.
+  void Insert(Entry& entry, uint64_t expiration);
+
+  /// Removes an entry from the wheel.
+  ///
+  /// @pre ``entry`` must be linked into this wheel.
+  void Remove(Entry& entry);
+
+  /// Returns a tick no later than the earliest expiration of any stored
+  /// entry, or ``std::nullopt`` if the wheel is empty.
+  ///
+  /// This may be earlier than any expiration when entries need to move to a
+  /// finer level, in which case advancing to it returns no entries.
+  std::optional<uint64_t> NextEventTick() const;
+
+  /// Advances the wheel to ``tick``, and removes all entries that expire at or
+  /// before it.
+  ///
+  /// @returns  The removed entries, linked by ``Entry::next_expired``, or null
+  ///           if none expired.
+  Entry* Advance(uint64_t tick);
+
+  /// Removes all entries from the wheel.
+  void Clear();
+
+ private:
+  using Bitmap = uint32_t;
+  static_assert(kSlotsPerLevel <= sizeof(Bitmap) * 8);
+  static_assert(kSlotBits * kNumLevels < 64);
+
+  static constexpr uint8_t kOverflow = kNumLevels;
+  static constexpr uint8_t kExpired = kNumLevels + 1;
+
+  // Returns the first tick of the slot of ``level`` that ``tick`` falls in.
+  static constexpr uint64_t SlotStart(uint64_t tick, size_t level) {
+    return tick & ~((uint64_t(1) << (kSlotBits * level)) - 1);
+  }
+
+  static constexpr uint8_t SlotIndex(uint64_t tick, size_t level) {
+    return static_cast<uint8_t>((tick >> (kSlotBits * level)) &
+                                (kSlotsPerLevel - 1));
+  }
+
+  // Returns the list that holds ``entry``.
+  Entry*& ListOf(const Entry& entry) {
+    if (entry.level_ == kOverflow) {
+      return overflow_;
+    }
+    if (entry.level_ == kExpired) {
+      return expired_;
+    }
+    return slots_[entry.level_][entry.slot_];
+  }
+
+  // Returns the first tick of the earliest occupied slot or overflow list
+  // boundary after ``now_``, or ``std::nullopt`` if there are none.
+  std::optional<uint64_t> NextSlotTick() const;
+
+  // Links an entry into the list for its expiration relative to ``now_``.
+  void Link(Entry& entry);
+
+  // Unlinks an entry from its list without marking it as unlinked.
+  void Unlink(Entry& entry);
+
+  // Moves the entries of a list to the lists for their expirations relative
+  // to ``now_``.
+  void Relink(Entry*& head);
+
+  std::array<std::array<Entry*, kSlotsPerLevel>, kNumLevels> slots_{};
+  std::array<Bitmap, kNumLevels> occupied_{};
+  Entry* overflow_ = nullptr;
+  Entry* expired_ = nullptr;
+  uint64_t now_ = 0;
+  size_t size_ = 0;
+};
+
+}  // namespace pw::async2::internal
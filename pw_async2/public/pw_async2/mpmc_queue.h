@@ -0,0 +1,105 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_containers/inline_mpmc_queue.h"
+#include "pw_sync/interrupt_spin_lock.h"
+
+namespace pw::async2 {
+
+/// A bounded multi-producer, multi-consumer queue whose values a ``Task`` can
+/// wait for with ``PendPop``.
+///
+/// Values are stored in a lock-free ``pw::InlineMpmcQueue``, so threads and
+/// interrupts may push and pop at any time. Pushing only takes a lock when a
+/// task is waiting for a value, in order to wake it.
+///
+/// Only one task should wait in ``PendPop`` at a time, since each call
+/// replaces the ``Waker`` of the previous one.
+template <typename T, size_t kCapacity>
+class MpmcQueue {
+ public:
+  MpmcQueue() = default;
+
+  MpmcQueue(const MpmcQueue&) = delete;
+  MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+  /// Adds a value to the back of the queue and wakes the waiting task, if
+  /// any. Returns false if the queue is full.
+  bool TryPush(const T& value) { return TryEmplace(value); }
+  bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+  /// Constructs a value at the back of the queue and wakes the waiting task,
+  /// if any. Returns false if the queue is full.
+  template <typename... Args>
+  bool TryEmplace(Args&&... args) {
+    if (!queue_.TryEmplace(std::forward<Args>(args)...)) {
+      return false;
+    }
+    // Pairs with the fence in PendPop, so that either this sees the waiting
+    // task or the task sees the new value.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_.load(std::memory_order_relaxed)) {
+      Waker waker;
+      {
+        std::lock_guard lock(lock_);
+        waiting_.store(false, std::memory_order_relaxed);
+        waker = std::move(waker_);
+      }
+      std::move(waker).Wake();
+    }
+    return true;
+  }
+
+  /// Removes and returns the value at the front of the queue, or
+  /// ``std::nullopt`` if the queue is empty.
+  std::optional<T> TryPop() { return queue_.TryPop(); }
+
+  /// Returns ``Ready`` with the value at the front of the queue, or
+  /// ``Pending`` and wakes the task when a value is pushed.
+  Poll<T> PendPop(Context& cx) {
+    if (std::optional<T> value = queue_.TryPop(); value.has_value()) {
+      return Ready(std::move(*value));
+    }
+    {
+      std::lock_guard lock(lock_);
+      waker_ = cx.GetWaker(WaitReason::Unspecified());
+      waiting_.store(true, std::memory_order_relaxed);
+    }
+    // Check again, in case a value was pushed before the waker was stored.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (std::optional<T> value = queue_.TryPop(); value.has_value()) {
+      return Ready(std::move(*value));
+    }
+    return Pending();
+  }
+
+  size_t size() const { return queue_.size(); }
+  [[nodiscard]] bool empty() const { return queue_.empty(); }
+  static constexpr size_t capacity() { return kCapacity; }
+
+ private:
+  InlineMpmcQueue<T, kCapacity> queue_;
+  std::atomic<bool> waiting_ = false;
+  sync::InterruptSpinLock lock_;
+  Waker waker_ PW_GUARDED_BY(lock_);
+};
+
+}  // namespace pw::async2
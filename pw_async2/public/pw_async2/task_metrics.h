@@ -0,0 +1,83 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_metric/metric.h"
+
+namespace pw::async2 {
+
+/// Execution statistics of a ``Task``, exposed as a ``pw::metric::Group``.
+///
+/// Once attached to a ``Task`` with ``Task::set_metrics``, the ``Dispatcher``
+/// running the ``Task`` records:
+///
+/// - ``polls``: the number of times the ``Task`` was ``Pend`` ed.
+/// - ``pend_time_us`` and ``max_pend_time_us``: the cumulative and longest
+///   durations of its ``Pend`` calls, in microseconds.
+/// - ``wake_latency_us`` and ``max_wake_latency_us``: the cumulative and
+///   longest delays between the ``Task`` being posted or woken and it being
+///   ``Pend`` ed, in microseconds.
+///
+/// A long ``Pend`` call delays every other ``Task`` on the same
+/// ``Dispatcher``. A long wake latency means the ``Task`` was starved by
+/// others.
+///
+/// The metrics may be exported by adding ``group()`` to a group served by
+/// ``pw::metric::MetricService``, or by dumping it with
+/// ``pw::metric::Group::Dump``.
+class TaskMetrics {
+ public:
+  explicit TaskMetrics(metric::Token token);
+
+  TaskMetrics(const TaskMetrics&) = delete;
+  TaskMetrics& operator=(const TaskMetrics&) = delete;
+
+  const metric::Group& group() const { return group_; }
+  metric::Group& group() { return group_; }
+
+  uint32_t polls() const { return polls_.value(); }
+  uint32_t pend_time_us() const { return pend_time_us_.value(); }
+  uint32_t max_pend_time_us() const { return max_pend_time_us_.value(); }
+  uint32_t wake_latency_us() const { return wake_latency_us_.value(); }
+  uint32_t max_wake_latency_us() const {
+    return max_wake_latency_us_.value();
+  }
+
+ private:
+  template <typename Impl>
+  friend class DispatcherImpl;
+  friend class DispatcherBase;
+
+  // Records a ``Pend`` call that started at ``start`` and returned at ``end``,
+  // after the ``Task`` was woken at ``woken_at``.
+  void RecordPend(chrono::SystemClock::time_point woken_at,
+                  chrono::SystemClock::time_point start,
+                  chrono::SystemClock::time_point end);
+
+  metric::Group group_;
+  PW_METRIC(polls_, "polls", 0u);
+  PW_METRIC(pend_time_us_, "pend_time_us", 0u);
+  PW_METRIC(max_pend_time_us_, "max_pend_time_us", 0u);
+  PW_METRIC(wake_latency_us_, "wake_latency_us", 0u);
+  PW_METRIC(max_wake_latency_us_, "max_wake_latency_us", 0u);
+
+  // When the ``Task`` was last posted or woken. Guarded by the lock of its
+  // ``Dispatcher``.
+  chrono::SystemClock::time_point woken_at_;
+};
+
+}  // namespace pw::async2
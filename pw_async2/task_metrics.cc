@@ -0,0 +1,55 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/task_metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace pw::async2 {
+namespace {
+
+uint32_t ToMicroseconds(chrono::SystemClock::duration duration) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+  return static_cast<uint32_t>(std::clamp<int64_t>(
+      us.count(), 0, std::numeric_limits<uint32_t>::max()));
+}
+
+}  // namespace
+
+TaskMetrics::TaskMetrics(metric::Token token) : group_(token) {
+  group_.Add(polls_);
+  group_.Add(pend_time_us_);
+  group_.Add(max_pend_time_us_);
+  group_.Add(wake_latency_us_);
+  group_.Add(max_wake_latency_us_);
+}
+
+void TaskMetrics::RecordPend(chrono::SystemClock::time_point woken_at,
+                             chrono::SystemClock::time_point start,
+                             chrono::SystemClock::time_point end) {
+  polls_.Increment();
+
+  uint32_t pend_time = ToMicroseconds(end - start);
+  pend_time_us_.Increment(pend_time);
+  max_pend_time_us_.Set(std::max(max_pend_time_us_.value(), pend_time));
+
+  uint32_t wake_latency = ToMicroseconds(start - woken_at);
+  wake_latency_us_.Increment(wake_latency);
+  max_wake_latency_us_.Set(
+      std::max(max_wake_latency_us_.value(), wake_latency));
+}
+
+}  // namespace pw::async2
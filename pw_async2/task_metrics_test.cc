@@ -0,0 +1,145 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/task_metrics.h"
+
+#include "pw_async2/dispatcher.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::async2 {
+namespace {
+
+using namespace std::chrono_literals;
+
+using chrono::SystemClock;
+
+constexpr metric::Token kTaskToken = 0x7a5c;
+
+void BusyWait(SystemClock::duration duration) {
+  const SystemClock::time_point end = SystemClock::now() + duration;
+  while (SystemClock::now() < end) {
+  }
+}
+
+// A task that stays pending until told to complete, spinning for a while
+// each time it is polled.
+class SpinningTask : public Task {
+ public:
+  SystemClock::duration spin_for = SystemClock::duration::zero();
+  bool should_complete = false;
+  Waker last_waker;
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    BusyWait(spin_for);
+    if (should_complete) {
+      return Ready();
+    }
+    last_waker = cx.GetWaker(WaitReason::Unspecified());
+    return Pending();
+  }
+};
+
+TEST(TaskMetrics, GroupContainsMetrics) {
+  TaskMetrics metrics(kTaskToken);
+  size_t count = 0;
+  for (const metric::Metric& metric : metrics.group().metrics()) {
+    static_cast<void>(metric);
+    ++count;
+  }
+  EXPECT_EQ(count, 5u);
+  EXPECT_EQ(metrics.polls(), 0u);
+  EXPECT_EQ(metrics.pend_time_us(), 0u);
+  EXPECT_EQ(metrics.wake_latency_us(), 0u);
+}
+
+TEST(TaskMetrics, CountsPolls) {
+  TaskMetrics metrics(kTaskToken);
+  SpinningTask task;
+  task.set_metrics(&metrics);
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+  EXPECT_EQ(metrics.polls(), 1u);
+
+  std::move(task.last_waker).Wake();
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+  EXPECT_EQ(metrics.polls(), 2u);
+
+  task.should_complete = true;
+  std::move(task.last_waker).Wake();
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Ready());
+  EXPECT_EQ(metrics.polls(), 3u);
+}
+
+TEST(TaskMetrics, RecordsPendTime) {
+  TaskMetrics metrics(kTaskToken);
+  SpinningTask task;
+  task.set_metrics(&metrics);
+  task.spin_for = 2ms;
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+  EXPECT_GE(metrics.pend_time_us(), 2000u);
+  EXPECT_GE(metrics.max_pend_time_us(), 2000u);
+
+  task.spin_for = 1ms;
+  task.should_complete = true;
+  std::move(task.last_waker).Wake();
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Ready());
+  EXPECT_GE(metrics.pend_time_us(), 3000u);
+  EXPECT_GE(metrics.max_pend_time_us(), 2000u);
+  EXPECT_LT(metrics.max_pend_time_us(), metrics.pend_time_us());
+}
+
+TEST(TaskMetrics, RecordsWakeLatency) {
+  TaskMetrics metrics(kTaskToken);
+  SpinningTask task;
+  task.set_metrics(&metrics);
+  Dispatcher dispatcher;
+
+  // The latency of the first poll is measured from ``Post``.
+  dispatcher.Post(task);
+  BusyWait(2ms);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+  EXPECT_GE(metrics.wake_latency_us(), 2000u);
+  EXPECT_GE(metrics.max_wake_latency_us(), 2000u);
+
+  std::move(task.last_waker).Wake();
+  BusyWait(3ms);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+  EXPECT_GE(metrics.wake_latency_us(), 5000u);
+  EXPECT_GE(metrics.max_wake_latency_us(), 3000u);
+
+  task.Deregister();
+}
+
+TEST(TaskMetrics, DetachedMetricsAreNotUpdated) {
+  TaskMetrics metrics(kTaskToken);
+  SpinningTask task;
+  task.set_metrics(&metrics);
+  task.set_metrics(nullptr);
+  task.should_complete = true;
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Ready());
+  EXPECT_EQ(metrics.polls(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::async2
@@ -0,0 +1,186 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/internal/timer_wheel.h"
+
+#include <algorithm>
+
+#include "pw_assert/assert.h"
+#include "pw_bytes/bit.h"
+
+namespace pw::async2::internal {
+
+void TimerWheel::Insert(Entry& entry, uint64_t expiration) {
+  PW_DASSERT(!entry.is_linked());
+  entry.expiration_ = expiration;
+  Link(entry);
+  ++size_;
+}
+
+void TimerWheel::Remove(Entry& entry) {
+  PW_DASSERT(entry.is_linked());
+  Unlink(entry);
+  entry.level_ = Entry::kUnlinked;
+  --size_;
+}
+
+std::optional<uint64_t> TimerWheel::NextEventTick() const {
+  if (size_ == 0) {
+    return std::nullopt;
+  }
+  if (expired_ != nullptr) {
+    return now_;
+  }
+  return NextSlotTick();
+}
+
+std::optional<uint64_t> TimerWheel::NextSlotTick() const {
+  // Every entry in a level is in a later slot than `now_`, so the lowest
+  // occupied slot of each level is the next one to process.
+  std::optional<uint64_t> next;
+  for (size_t level = 0; level < kNumLevels; ++level) {
+    if (occupied_[level] == 0) {
+      continue;
+    }
+    auto slot = static_cast<uint64_t>(cpp20::countr_zero(occupied_[level]));
+    uint64_t start =
+        SlotStart(now_, level + 1) | (slot << (kSlotBits * level));
+    next = std::min(next.value_or(start), start);
+  }
+  if (overflow_ != nullptr) {
+    uint64_t start = SlotStart(now_, kNumLevels) +
+                     (uint64_t(1) << (kSlotBits * kNumLevels));
+    next = std::min(next.value_or(start), start);
+  }
+  return next;
+}
+
+TimerWheel::Entry* TimerWheel::Advance(uint64_t tick) {
+  while (now_ < tick) {
+    std::optional<uint64_t> next = NextSlotTick();
+    if (!next.has_value() || *next > tick) {
+      now_ = tick;
+      break;
+    }
+    now_ = *next;
+
+    // Move the entries of every slot starting at the new tick to finer
+    // levels, starting from the coarsest. Entries of the finest level all
+    // expire at this tick.
+    if (SlotStart(now_, kNumLevels) == now_) {
+      Relink(overflow_);
+    }
+    for (size_t level = kNumLevels; level-- > 0;) {
+      if (SlotStart(now_, level) != now_) {
+        continue;
+      }
+      uint8_t slot = SlotIndex(now_, level);
+      if ((occupied_[level] & (Bitmap(1) << slot)) != 0) {
+        occupied_[level] &= ~(Bitmap(1) << slot);
+        Relink(slots_[level][slot]);
+      }
+    }
+  }
+
+  Entry* expired = expired_;
+  expired_ = nullptr;
+  for (Entry* entry = expired; entry != nullptr; entry = entry->next_) {
+    entry->prev_ = nullptr;
+    entry->level_ = Entry::kUnlinked;
+    --size_;
+  }
+  return expired;
+}
+
+void TimerWheel::Clear() {
+  auto clear = [](Entry*& head) {
+    while (head != nullptr) {
+      Entry& entry = *head;
+      head = entry.next_;
+      entry.prev_ = nullptr;
+      entry.next_ = nullptr;
+      entry.level_ = Entry::kUnlinked;
+    }
+  };
+  for (auto& level : slots_) {
+    for (Entry*& head : level) {
+      clear(head);
+    }
+  }
+  occupied_.fill(0);
+  clear(overflow_);
+  clear(expired_);
+  size_ = 0;
+}
+
+void TimerWheel::Link(Entry& entry) {
+  Entry** head;
+  if (entry.expiration_ <= now_) {
+    entry.level_ = kExpired;
+    head = &expired_;
+  } else {
+    // The most significant digit in which the expiration differs from `now_`
+    // selects the level. The entry is in a later slot of that level than
+    // `now_`, and is moved to a finer level once `now_` reaches that slot.
+    uint64_t diff = entry.expiration_ ^ now_;
+    size_t level = 0;
+    while (level < kNumLevels && (diff >> (kSlotBits * (level + 1))) != 0) {
+      ++level;
+    }
+    if (level == kNumLevels) {
+      entry.level_ = kOverflow;
+      head = &overflow_;
+    } else {
+      entry.level_ = static_cast<uint8_t>(level);
+      entry.slot_ = SlotIndex(entry.expiration_, level);
+      occupied_[level] |= Bitmap(1) << entry.slot_;
+      head = &slots_[level][entry.slot_];
+    }
+  }
+  entry.prev_ = nullptr;
+  entry.next_ = *head;
+  if (*head != nullptr) {
+    (*head)->prev_ = &entry;
+  }
+  *head = &entry;
+}
+
+void TimerWheel::Unlink(Entry& entry) {
+  Entry*& head = ListOf(entry);
+  if (entry.prev_ == nullptr) {
+    head = entry.next_;
+  } else {
+    entry.prev_->next_ = entry.next_;
+  }
+  if (entry.next_ != nullptr) {
+    entry.next_->prev_ = entry.prev_;
+  }
+  if (head == nullptr && entry.level_ < kNumLevels) {
+    occupied_[entry.level_] &= ~(Bitmap(1) << entry.slot_);
+  }
+  entry.prev_ = nullptr;
+  entry.next_ = nullptr;
+}
+
+void TimerWheel::Relink(Entry*& head) {
+  Entry* entry = head;
+  head = nullptr;
+  while (entry != nullptr) {
+    Entry* next = entry->next_;
+    Link(*entry);
+    entry = next;
+  }
+}
+
+}  // namespace pw::async2::internal
@@ -0,0 +1,196 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/internal/timer_wheel.h"
+
+#include <array>
+#include <cstdint>
+
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using ::pw::async2::internal::TimerWheel;
+using Entry = TimerWheel::Entry;
+
+constexpr uint64_t kTopRange = uint64_t(1)
+                               << (TimerWheel::kSlotBits *
+                                   TimerWheel::kNumLevels);
+
+size_t CountExpired(Entry* expired) {
+  size_t count = 0;
+  for (Entry* entry = expired; entry != nullptr;
+       entry = entry->next_expired()) {
+    ++count;
+  }
+  return count;
+}
+
+TEST(TimerWheel, EmptyWheelHasNoEvents) {
+  TimerWheel wheel;
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.NextEventTick().has_value());
+  EXPECT_EQ(wheel.Advance(1000), nullptr);
+  EXPECT_EQ(wheel.now(), 1000u);
+}
+
+TEST(TimerWheel, ExpiresAtExactTick) {
+  TimerWheel wheel;
+  Entry entry;
+  wheel.Insert(entry, 5);
+  EXPECT_TRUE(entry.is_linked());
+  EXPECT_EQ(wheel.NextEventTick(), 5u);
+
+  EXPECT_EQ(wheel.Advance(4), nullptr);
+  EXPECT_TRUE(entry.is_linked());
+  EXPECT_EQ(wheel.Advance(5), &entry);
+  EXPECT_FALSE(entry.is_linked());
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, ExpiresWhenAdvancedPastTick) {
+  TimerWheel wheel;
+  Entry entry;
+  wheel.Insert(entry, 1000);
+  EXPECT_EQ(wheel.Advance(5000), &entry);
+  EXPECT_EQ(wheel.now(), 5000u);
+}
+
+TEST(TimerWheel, InsertExpiredEntry) {
+  TimerWheel wheel;
+  wheel.Advance(100);
+  Entry entry;
+  wheel.Insert(entry, 50);
+  EXPECT_EQ(wheel.NextEventTick(), 100u);
+  EXPECT_EQ(wheel.Advance(100), &entry);
+}
+
+TEST(TimerWheel, RemoveEntry) {
+  TimerWheel wheel;
+  std::array<Entry, 3> entries;
+  wheel.Insert(entries[0], 10);
+  wheel.Insert(entries[1], 300);
+  wheel.Insert(entries[2], 300);
+  EXPECT_EQ(wheel.size(), 3u);
+
+  wheel.Remove(entries[1]);
+  EXPECT_FALSE(entries[1].is_linked());
+  EXPECT_EQ(wheel.size(), 2u);
+
+  EXPECT_EQ(wheel.Advance(10), &entries[0]);
+  EXPECT_EQ(wheel.Advance(300), &entries[2]);
+  EXPECT_EQ(entries[2].next_expired(), nullptr);
+  EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, NextEventTickIsNoLaterThanExpiration) {
+  TimerWheel wheel;
+  Entry entry;
+  wheel.Insert(entry, 12345);
+  Entry* expired = nullptr;
+  size_t events = 0;
+  while (expired == nullptr) {
+    std::optional<uint64_t> next = wheel.NextEventTick();
+    ASSERT_TRUE(next.has_value());
+    EXPECT_LE(*next, 12345u);
+    expired = wheel.Advance(*next);
+    ++events;
+  }
+  EXPECT_EQ(expired, &entry);
+  EXPECT_EQ(wheel.now(), 12345u);
+
+  // The entry is moved down at most once per level.
+  EXPECT_LE(events, TimerWheel::kNumLevels);
+}
+
+TEST(TimerWheel, EntriesBeyondTopLevel) {
+  TimerWheel wheel;
+  Entry near;
+  Entry far;
+  wheel.Insert(near, 7);
+  wheel.Insert(far, 3 * kTopRange + 7);
+
+  EXPECT_EQ(wheel.Advance(kTopRange), &near);
+  EXPECT_TRUE(far.is_linked());
+  EXPECT_EQ(wheel.Advance(3 * kTopRange + 6), nullptr);
+  EXPECT_EQ(wheel.Advance(3 * kTopRange + 7), &far);
+}
+
+TEST(TimerWheel, ClearUnlinksEntries) {
+  TimerWheel wheel;
+  std::array<Entry, 3> entries;
+  wheel.Insert(entries[0], 1);
+  wheel.Insert(entries[1], 1000);
+  wheel.Insert(entries[2], 2 * kTopRange);
+  wheel.Clear();
+  EXPECT_TRUE(wheel.empty());
+  for (Entry& entry : entries) {
+    EXPECT_FALSE(entry.is_linked());
+  }
+  EXPECT_EQ(wheel.Advance(3 * kTopRange), nullptr);
+}
+
+TEST(TimerWheel, MatchesNaiveTimers) {
+  constexpr size_t kNumEntries = 64;
+  std::array<Entry, kNumEntries> entries;
+  std::array<bool, kNumEntries> expired{};
+  TimerWheel wheel;
+
+  uint64_t state = 0x12345678;
+  auto next_random = [&state]() {
+    state = state * 6364136223846793005u + 1442695040888963407u;
+    return state >> 33;
+  };
+
+  for (size_t round = 0; round < 200; ++round) {
+    // Randomly arm, cancel, or leave each entry.
+    for (size_t i = 0; i < kNumEntries; ++i) {
+      switch (next_random() % 4) {
+        case 0:
+          if (entries[i].is_linked()) {
+            wheel.Remove(entries[i]);
+          }
+          wheel.Insert(entries[i], wheel.now() + next_random() % 100000);
+          expired[i] = false;
+          break;
+        case 1:
+          if (entries[i].is_linked()) {
+            wheel.Remove(entries[i]);
+          }
+          break;
+        default:
+          break;
+      }
+    }
+
+    uint64_t tick = wheel.now() + next_random() % 5000;
+    for (Entry* entry = wheel.Advance(tick); entry != nullptr;
+         entry = entry->next_expired()) {
+      size_t i = static_cast<size_t>(entry - entries.data());
+      EXPECT_LE(entry->expiration(), tick);
+      EXPECT_FALSE(expired[i]);
+      expired[i] = true;
+    }
+    for (size_t i = 0; i < kNumEntries; ++i) {
+      if (entries[i].is_linked()) {
+        EXPECT_GT(entries[i].expiration(), tick);
+      }
+    }
+  }
+  size_t remaining = wheel.size();
+  EXPECT_EQ(CountExpired(wheel.Advance(UINT64_MAX / 2)), remaining);
+  EXPECT_TRUE(wheel.empty());
+}
+
+}  // namespace
@@ -53,7 +53,16 @@ void Dispatcher::DoRunToCompletion(Task* task) {
     }
     if (!result.ran_a_task()) {
       SleepInfo sleep_info = AttemptRequestWake(/*allow_empty=*/false);
-      if (sleep_info.should_sleep()) {
+      if (!sleep_info.should_sleep()) {
+        continue;
+      }
+      std::optional<chrono::SystemClock::time_point> wake_time =
+          sleep_info.wake_time();
+      if (!wake_time.has_value()) {
+        notify_.acquire();
+      } else if (!notify_.try_acquire_until(*wake_time) &&
+                 AbandonRequestWake()) {
+        // A ``DoWake`` call raced with the timeout, so consume its release.
         notify_.acquire();
       }
     }
@@ -14,7 +14,7 @@
 #pragma once
 
 #include "pw_async2/dispatcher_base.h"
-#include "pw_sync/timed_thread_notification.h"
+#include "pw_sync/counting_semaphore.h"
 
 namespace pw::async2 {
 
@@ -22,6 +22,10 @@ namespace pw::async2 {
 //
 // This class defines the "basic" backend for the ``Dispatcher`` facade.
 //
+// Any number of threads may run this ``Dispatcher`` concurrently, e.g. by each
+// calling ``RunToCompletion``. Threads waiting for work sleep on a semaphore
+// that is released once for each thread to wake.
+//
 // All public and private methods here are necessary when implementing a
 // ``Dispatcher`` backend. The private methods are invoked via the
 // ``DispatcherImpl` via CRTP.
@@ -52,7 +56,7 @@ class Dispatcher final : public DispatcherImpl<Dispatcher> {
   void DoRunToCompletion(Task* task);
   friend class DispatcherImpl<Dispatcher>;
 
-  pw::sync::TimedThreadNotification notify_;
+  pw::sync::CountingSemaphore notify_;
 };
 
 }  // namespace pw::async2
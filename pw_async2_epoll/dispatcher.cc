@@ -16,7 +16,10 @@
 #include <sys/epoll.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
+#include <limits>
 #include <mutex>
 
 #include "pw_assert/check.h"
@@ -92,7 +95,7 @@ void Dispatcher::DoRunToCompletion(Task* task) {
     if (!result.ran_a_task()) {
       SleepInfo sleep_info = AttemptRequestWake(/*allow_empty=*/false);
       if (sleep_info.should_sleep()) {
-        if (!NativeWaitForWake().ok()) {
+        if (!NativeWaitForWake(sleep_info.wake_time()).ok()) {
           break;
         }
       }
@@ -100,11 +103,26 @@ void Dispatcher::DoRunToCompletion(Task* task) {
   }
 }
 
-Status Dispatcher::NativeWaitForWake() {
+Status Dispatcher::NativeWaitForWake(
+    std::optional<chrono::SystemClock::time_point> wake_time) {
   std::array<epoll_event, kMaxEventsToProcessAtOnce> events;
 
+  int timeout_ms = -1;
+  if (wake_time.has_value()) {
+    auto remaining = *wake_time - chrono::SystemClock::now();
+    timeout_ms = static_cast<int>(std::clamp<int64_t>(
+        std::chrono::ceil<std::chrono::milliseconds>(remaining).count(),
+        0,
+        std::numeric_limits<int>::max()));
+  }
+
   int num_events =
-      epoll_wait(epoll_fd_, events.data(), events.size(), /*timeout=*/-1);
+      epoll_wait(epoll_fd_, events.data(), events.size(), timeout_ms);
+  if (num_events <= 0) {
+    // No ``DoWake`` call woke the dispatcher. If one was made after the wait
+    // ended, its notification is consumed by the next wait.
+    static_cast<void>(AbandonRequestWake());
+  }
   if (num_events < 0) {
     if (errno == EINTR) {
       return OkStatus();
@@ -115,33 +133,46 @@ Status Dispatcher::NativeWaitForWake() {
     return Status::Internal();
   }
 
+  std::lock_guard lock(fds_lock_);
   for (int i = 0; i < num_events; ++i) {
     epoll_event& event = events[i];
     if (event.data.fd == wait_fd_) {
-      // Consume the wake notification.
+      // Consume the wake notification. When several threads run this
+      // dispatcher, another one may have consumed it first.
       char unused;
       ssize_t bytes_read = read(wait_fd_, &unused, 1);
+      if (bytes_read == -1 && errno == EAGAIN) {
+        continue;
+      }
       PW_CHECK_INT_EQ(
           bytes_read, 1, "Dispatcher failed to read wake notification");
       PW_DCHECK_INT_EQ(unused, kNotificationSignal);
       continue;
     }
 
-    // Debug log for missed events.
-    if (PW_LOG_LEVEL >= PW_LOG_LEVEL_DEBUG &&
-        wakers_[event.data.fd].read.IsEmpty() &&
-        wakers_[event.data.fd].write.IsEmpty()) {
-      PW_LOG_DEBUG(
-          "Received an event for registered file descriptor %d, but there is "
-          "no task to wake",
-          event.data.fd);
+    // Skip events for file descriptors unregistered by another thread.
+    auto it = fds_.find(event.data.fd);
+    if (it == fds_.end()) {
+      continue;
     }
-
-    if ((event.events & (EPOLLIN | EPOLLRDHUP)) != 0) {
-      std::move(wakers_[event.data.fd].read).Wake();
+    FileDescriptorState& state = it->second;
+
+    // Errors and hangups are reported regardless of the requested events, and
+    // make both reads and writes return immediately.
+    constexpr uint32_t kErrorEvents = EPOLLERR | EPOLLHUP;
+    if ((event.events & (EPOLLIN | EPOLLRDHUP | kErrorEvents)) != 0) {
+      if (state.read.IsEmpty()) {
+        state.readable = true;
+      } else {
+        std::move(state.read).Wake();
+      }
     }
-    if ((event.events & EPOLLOUT) != 0) {
-      std::move(wakers_[event.data.fd].write).Wake();
+    if ((event.events & (EPOLLOUT | kErrorEvents)) != 0) {
+      if (state.write.IsEmpty()) {
+        state.writable = true;
+      } else {
+        std::move(state.write).Wake();
+      }
     }
   }
 
@@ -161,6 +192,13 @@ Status Dispatcher::NativeRegisterFileDescriptor(int fd,
     event.events |= EPOLLOUT;
   }
 
+  // Registering reports the current readiness as the first edge, so discard
+  // any earlier state before it can be reported.
+  {
+    std::lock_guard lock(fds_lock_);
+    fds_[fd] = FileDescriptorState();
+  }
+
   if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
     PW_LOG_ERROR("Failed to register epoll event: %s", std::strerror(errno));
     return Status::Internal();
@@ -176,10 +214,33 @@ Status Dispatcher::NativeUnregisterFileDescriptor(int fd) {
     PW_LOG_ERROR("Failed to unregister epoll event: %s", std::strerror(errno));
     return Status::Internal();
   }
-  wakers_.erase(fd);
+  std::lock_guard lock(fds_lock_);
+  fds_.erase(fd);
   return OkStatus();
 }
 
+void Dispatcher::NativeAddReadWakerForFileDescriptor(int fd, Waker&& waker) {
+  std::lock_guard lock(fds_lock_);
+  FileDescriptorState& state = fds_[fd];
+  if (state.readable) {
+    state.readable = false;
+    std::move(waker).Wake();
+    return;
+  }
+  state.read = std::move(waker);
+}
+
+void Dispatcher::NativeAddWriteWakerForFileDescriptor(int fd, Waker&& waker) {
+  std::lock_guard lock(fds_lock_);
+  FileDescriptorState& state = fds_[fd];
+  if (state.writable) {
+    state.writable = false;
+    std::move(waker).Wake();
+    return;
+  }
+  state.write = std::move(waker);
+}
+
 void Dispatcher::DoWake() {
   // Perform a write to unblock the waiting dispatcher.
   //
@@ -0,0 +1,22 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// PW_ASYNC2_EPOLL_CONFIG_MAX_EVENTS sets the maximum number of epoll events
+// the dispatcher retrieves with each call to ``epoll_wait``. Larger batches
+// need fewer system calls when many file descriptors are active, at the cost
+// of stack space for the event array.
+#ifndef PW_ASYNC2_EPOLL_CONFIG_MAX_EVENTS
+#define PW_ASYNC2_EPOLL_CONFIG_MAX_EVENTS 16
+#endif  // PW_ASYNC2_EPOLL_CONFIG_MAX_EVENTS
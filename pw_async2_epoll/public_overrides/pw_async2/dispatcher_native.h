@@ -13,10 +13,13 @@
 // the License.
 #pragma once
 
+#include <optional>
 #include <unordered_map>
 
 #include "pw_assert/assert.h"
 #include "pw_async2/dispatcher_base.h"
+#include "pw_async2_epoll/config.h"
+#include "pw_sync/mutex.h"
 
 namespace pw::async2 {
 
@@ -37,23 +40,43 @@ class Dispatcher final : public DispatcherImpl<Dispatcher> {
     kReadWrite = kReadable | kWritable,
   };
 
+  // Registers a file descriptor for edge-triggered notifications.
+  //
+  // A file descriptor only needs to be registered once. Afterwards, each wait
+  // only stores a ``Waker`` with ``NativeAdd...WakerForFileDescriptor``,
+  // without making any system calls.
   Status NativeRegisterFileDescriptor(int fd, FileDescriptorType type);
   Status NativeUnregisterFileDescriptor(int fd);
 
-  void NativeAddReadWakerForFileDescriptor(int fd, Waker&& waker) {
-    wakers_[fd].read = std::move(waker);
-  }
+  // Stores a ``Waker`` to wake when ``fd`` becomes readable.
+  //
+  // If ``fd`` became readable since the previous read ``Waker`` was woken, the
+  // ``Waker`` is woken immediately, so no edge is missed between a read
+  // returning ``EAGAIN`` and this call.
+  void NativeAddReadWakerForFileDescriptor(int fd, Waker&& waker);
 
-  void NativeAddWriteWakerForFileDescriptor(int fd, Waker&& waker) {
-    wakers_[fd].write = std::move(waker);
-  }
+  // Stores a ``Waker`` to wake when ``fd`` becomes writable.
+  //
+  // If ``fd`` became writable since the previous write ``Waker`` was woken,
+  // the ``Waker`` is woken immediately.
+  void NativeAddWriteWakerForFileDescriptor(int fd, Waker&& waker);
 
  private:
-  static constexpr size_t kMaxEventsToProcessAtOnce = 5;
-
-  struct ReadWriteWaker {
+  static constexpr size_t kMaxEventsToProcessAtOnce =
+      PW_ASYNC2_EPOLL_CONFIG_MAX_EVENTS;
+  static_assert(kMaxEventsToProcessAtOnce > 0,
+                "PW_ASYNC2_EPOLL_CONFIG_MAX_EVENTS must be positive");
+
+  // Wakers and readiness of a registered file descriptor.
+  //
+  // As file descriptors are registered as edge-triggered, each readiness
+  // change is only reported once. Changes reported while no ``Waker`` is
+  // stored are recorded until one is.
+  struct FileDescriptorState {
     Waker read;
     Waker write;
+    bool readable = false;
+    bool writable = false;
   };
 
   void DoWake() final;
@@ -61,14 +84,18 @@ class Dispatcher final : public DispatcherImpl<Dispatcher> {
   void DoRunToCompletion(Task* task);
   friend class DispatcherImpl<Dispatcher>;
 
-  Status NativeWaitForWake();
-  void NativeFindAndWakeFileDescriptor(int fd, FileDescriptorType type);
+  // Waits for a ``DoWake`` call, a file descriptor event, or ``wake_time``.
+  Status NativeWaitForWake(
+      std::optional<chrono::SystemClock::time_point> wake_time);
 
   int epoll_fd_;
   int notify_fd_;
   int wait_fd_;
 
-  std::unordered_map<int, ReadWriteWaker> wakers_;
+  // Guards ``fds_``, which may be accessed by tasks and by each thread running
+  // this ``Dispatcher``.
+  pw::sync::Mutex fds_lock_;
+  std::unordered_map<int, FileDescriptorState> fds_;
 };
 
 }  // namespace pw::async2
@@ -0,0 +1,557 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <mutex>
+
+#include "pw_assert/check.h"
+#include "pw_async2/dispatcher_native.h"
+#include "pw_log/log.h"
+#include "pw_status/status.h"
+#include "pw_thread/yield.h"
+
+namespace pw::async2 {
+namespace {
+
+// ``user_data`` of entries that do not belong to a ``NativeOperation``.
+constexpr uint64_t kWakeReadUserData = 0;
+constexpr uint64_t kCancelUserData = 1;
+
+// The ring indices are shared with the kernel, which reads and writes them
+// concurrently.
+uint32_t LoadAcquire(const uint32_t* index) {
+  return __atomic_load_n(index, __ATOMIC_ACQUIRE);
+}
+
+void StoreRelease(uint32_t* index, uint32_t value) {
+  __atomic_store_n(index, value, __ATOMIC_RELEASE);
+}
+
+}  // namespace
+
+Poll<int> Dispatcher::NativeOperation::Pend(Context& cx) {
+  PW_DASSERT(dispatcher_ != nullptr);
+  std::lock_guard lock(dispatcher_->ring_lock_);
+  if (complete_) {
+    complete_ = false;
+    return result_;
+  }
+  PW_DASSERT(in_flight_);
+  waker_ = cx.GetWaker(WaitReason::Unspecified());
+  return Pending();
+}
+
+bool Dispatcher::NativeOperation::in_flight() const {
+  if (dispatcher_ == nullptr) {
+    return false;
+  }
+  std::lock_guard lock(dispatcher_->ring_lock_);
+  return in_flight_;
+}
+
+Status Dispatcher::NativeInit() {
+  io_uring_params params{};
+  params.flags = IORING_SETUP_CLAMP;
+  ring_fd_ = static_cast<int>(
+      syscall(__NR_io_uring_setup, kQueueDepth, &params));
+  if (ring_fd_ < 0) {
+    PW_LOG_ERROR("Failed to set up io_uring: %s", std::strerror(errno));
+    return Status::Internal();
+  }
+
+  // Timed waits pass their timeout through ``io_uring_getevents_arg``, which
+  // implies a kernel that maps both queues at once.
+  if ((params.features & IORING_FEAT_EXT_ARG) == 0) {
+    PW_LOG_ERROR("io_uring does not support waiting with a timeout");
+    return Status::Unimplemented();
+  }
+
+  rings_size_ =
+      std::max(params.sq_off.array + params.sq_entries * sizeof(uint32_t),
+               params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  rings_ = mmap(nullptr,
+                rings_size_,
+                PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE,
+                ring_fd_,
+                IORING_OFF_SQ_RING);
+  if (rings_ == MAP_FAILED) {
+    rings_ = nullptr;
+    PW_LOG_ERROR("Failed to map io_uring queues: %s", std::strerror(errno));
+    return Status::Internal();
+  }
+
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(nullptr,
+                    sqes_size_,
+                    PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE,
+                    ring_fd_,
+                    IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    PW_LOG_ERROR("Failed to map io_uring submission queue entries: %s",
+                 std::strerror(errno));
+    return Status::Internal();
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+  auto* rings = static_cast<std::byte*>(rings_);
+  sq_head_ = reinterpret_cast<const uint32_t*>(rings + params.sq_off.head);
+  sq_tail_ = reinterpret_cast<uint32_t*>(rings + params.sq_off.tail);
+  sq_mask_ = *reinterpret_cast<uint32_t*>(rings + params.sq_off.ring_mask);
+  sq_entries_ = params.sq_entries;
+  cq_head_ = reinterpret_cast<uint32_t*>(rings + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<const uint32_t*>(rings + params.cq_off.tail);
+  cq_mask_ = *reinterpret_cast<uint32_t*>(rings + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<const io_uring_cqe*>(rings + params.cq_off.cqes);
+
+  // Entries are always submitted in order, so each slot of the submission
+  // queue refers to the entry with the same index.
+  auto* sq_array = reinterpret_cast<uint32_t*>(rings + params.sq_off.array);
+  for (uint32_t i = 0; i < sq_entries_; ++i) {
+    sq_array[i] = i;
+  }
+
+  // Each ``DoWake`` call writes 1, and each read consumes one of them.
+  wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+  if (wake_fd_ == -1) {
+    PW_LOG_ERROR("Failed to create eventfd: %s", std::strerror(errno));
+    return Status::Internal();
+  }
+
+  std::lock_guard lock(ring_lock_);
+  QueueWakeReadLocked();
+  return OkStatus();
+}
+
+Dispatcher::~Dispatcher() {
+  Deregister();
+  // Closing the ring cancels all operations still in flight.
+  if (sqes_ != nullptr) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (rings_ != nullptr) {
+    munmap(rings_, rings_size_);
+  }
+  if (ring_fd_ != -1) {
+    close(ring_fd_);
+  }
+  if (wake_fd_ != -1) {
+    close(wake_fd_);
+  }
+}
+
+Poll<> Dispatcher::DoRunUntilStalled(Task* task) {
+  {
+    std::lock_guard lock(dispatcher_lock());
+    PW_CHECK(task == nullptr || HasPostedTask(*task),
+             "Attempted to run a dispatcher until a task was stalled, "
+             "but that task has not been `Post`ed to that `Dispatcher`.");
+  }
+  while (true) {
+    RunOneTaskResult result = RunOneTask(task);
+    if (result.completed_main_task() || result.completed_all_tasks()) {
+      return Ready();
+    }
+    // Operations that have already completed may wake more tasks.
+    if (!result.ran_a_task() && SubmitAndReap() == 0) {
+      return Pending();
+    }
+  }
+}
+
+void Dispatcher::DoRunToCompletion(Task* task) {
+  {
+    std::lock_guard lock(dispatcher_lock());
+    PW_CHECK(task == nullptr || HasPostedTask(*task),
+             "Attempted to run a dispatcher until a task was complete, "
+             "but that task has not been `Post`ed to that `Dispatcher`.");
+  }
+  while (true) {
+    RunOneTaskResult result = RunOneTask(task);
+    if (result.completed_main_task() || result.completed_all_tasks()) {
+      return;
+    }
+    if (!result.ran_a_task()) {
+      SleepInfo sleep_info = AttemptRequestWake(/*allow_empty=*/false);
+      if (sleep_info.should_sleep()) {
+        if (!NativeWaitForWake(sleep_info.wake_time()).ok()) {
+          break;
+        }
+      }
+    }
+  }
+}
+
+Status Dispatcher::NativeWaitForWake(
+    std::optional<chrono::SystemClock::time_point> wake_time) {
+  bool poll;
+  {
+    std::lock_guard lock(wake_lock_);
+    if (wakes_ != 0) {
+      // The poller already received this thread's ``DoWake`` call.
+      --wakes_;
+      return OkStatus();
+    }
+    poll = !polling_;
+    if (poll) {
+      polling_ = true;
+    } else {
+      ++sleeping_threads_;
+    }
+  }
+
+  if (!poll) {
+    bool woken = true;
+    if (!wake_time.has_value()) {
+      waiting_threads_.acquire();
+    } else if (!waiting_threads_.try_acquire_until(*wake_time)) {
+      std::lock_guard lock(wake_lock_);
+      woken = waiting_threads_.try_acquire();
+      if (!woken) {
+        --sleeping_threads_;
+      }
+    }
+    if (woken) {
+      std::lock_guard lock(wake_lock_);
+      if (handoffs_ != 0) {
+        --handoffs_;
+        woken = false;
+      }
+    }
+    if (!woken) {
+      // If a ``DoWake`` call raced with the timeout or handoff, it wakes
+      // another thread, which then finds no work.
+      static_cast<void>(AbandonRequestWake());
+    }
+    return OkStatus();
+  }
+
+  uint32_t to_submit;
+  {
+    std::lock_guard lock(ring_lock_);
+    to_submit = UnsubmittedLocked();
+  }
+
+  // Another thread may submit the queued entries first, in which case this
+  // returns without waiting and the caller simply tries again.
+  Status status;
+  int result = Enter(to_submit, 1, wake_time);
+  if (result < 0 && result != -EINTR && result != -ETIME &&
+      result != -EBUSY) {
+    PW_LOG_ERROR("Dispatcher failed to wait for completions: %s",
+                 std::strerror(-result));
+    status = Status::Internal();
+  }
+
+  ReapCompletions();
+  bool woken = TryConsumeWake();
+  StopPolling();
+  if (!woken) {
+    // If a ``DoWake`` call is made after the wait ended, its completion is
+    // consumed by the next wait.
+    static_cast<void>(AbandonRequestWake());
+  }
+  return status;
+}
+
+size_t Dispatcher::SubmitAndReap() {
+  if (!TryStartPolling()) {
+    // The poller submits queued entries, and wakes when operations complete.
+    return 0;
+  }
+  {
+    std::lock_guard lock(ring_lock_);
+    uint32_t to_submit = UnsubmittedLocked();
+    if (to_submit != 0) {
+      static_cast<void>(Enter(to_submit, 0, std::nullopt));
+    }
+  }
+  size_t completed = ReapCompletions();
+  StopPolling();
+  return completed;
+}
+
+int Dispatcher::Enter(
+    uint32_t to_submit,
+    uint32_t min_complete,
+    std::optional<chrono::SystemClock::time_point> wake_time) {
+  unsigned flags = 0;
+  __kernel_timespec timeout{};
+  io_uring_getevents_arg arg{};
+  void* argp = nullptr;
+  size_t arg_size = 0;
+
+  if (min_complete != 0) {
+    flags |= IORING_ENTER_GETEVENTS;
+  }
+  if (min_complete != 0 && wake_time.has_value()) {
+    auto remaining = std::max(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            *wake_time - chrono::SystemClock::now()),
+        std::chrono::nanoseconds(0));
+    auto seconds = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+    timeout.tv_sec = seconds.count();
+    timeout.tv_nsec = (remaining - seconds).count();
+    arg.ts = reinterpret_cast<uintptr_t>(&timeout);
+    flags |= IORING_ENTER_EXT_ARG;
+    argp = &arg;
+    arg_size = sizeof(arg);
+  }
+
+  long result = syscall(__NR_io_uring_enter,
+                        ring_fd_,
+                        to_submit,
+                        min_complete,
+                        flags,
+                        argp,
+                        arg_size);
+  return result < 0 ? -errno : static_cast<int>(result);
+}
+
+bool Dispatcher::TryStartPolling() {
+  std::lock_guard lock(wake_lock_);
+  if (polling_) {
+    return false;
+  }
+  polling_ = true;
+  return true;
+}
+
+void Dispatcher::StopPolling() {
+  std::lock_guard lock(wake_lock_);
+  polling_ = false;
+  if (sleeping_threads_ != 0) {
+    --sleeping_threads_;
+    ++handoffs_;
+    waiting_threads_.release();
+  }
+}
+
+bool Dispatcher::TryConsumeWake() {
+  std::lock_guard lock(wake_lock_);
+  if (wakes_ == 0) {
+    return false;
+  }
+  --wakes_;
+  return true;
+}
+
+size_t Dispatcher::ReapCompletions() {
+  std::lock_guard lock(ring_lock_);
+  size_t completed = 0;
+  uint32_t head = *cq_head_;
+  const uint32_t tail = LoadAcquire(cq_tail_);
+  for (; head != tail; ++head) {
+    const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+    if (cqe.user_data == kWakeReadUserData) {
+      if (cqe.res > 0) {
+        std::lock_guard wake_lock(wake_lock_);
+        ++wakes_;
+      } else if (cqe.res != -EINTR && cqe.res != -EAGAIN) {
+        PW_LOG_ERROR("Dispatcher failed to read wake notification: %s",
+                     std::strerror(-cqe.res));
+      }
+      QueueWakeReadLocked();
+      continue;
+    }
+    if (cqe.user_data == kCancelUserData) {
+      continue;
+    }
+
+    auto& operation =
+        *reinterpret_cast<NativeOperation*>(static_cast<uintptr_t>(
+            cqe.user_data));
+    operation.result_ = cqe.res;
+    operation.complete_ = true;
+    if ((cqe.flags & IORING_CQE_F_MORE) == 0) {
+      operation.in_flight_ = false;
+    }
+    if (!operation.waker_.IsEmpty()) {
+      std::move(operation.waker_).Wake();
+    }
+    ++completed;
+  }
+  StoreRelease(cq_head_, head);
+  return completed;
+}
+
+uint32_t Dispatcher::UnsubmittedLocked() const {
+  return *sq_tail_ - LoadAcquire(sq_head_);
+}
+
+io_uring_sqe* Dispatcher::NextSqeLocked() {
+  if (UnsubmittedLocked() == sq_entries_) {
+    int result = Enter(sq_entries_, 0, std::nullopt);
+    if (result < 0 || UnsubmittedLocked() == sq_entries_) {
+      return nullptr;
+    }
+  }
+  io_uring_sqe* sqe = &sqes_[*sq_tail_ & sq_mask_];
+  std::memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+void Dispatcher::QueueSqeLocked() { StoreRelease(sq_tail_, *sq_tail_ + 1); }
+
+void Dispatcher::QueueWakeReadLocked() {
+  io_uring_sqe* sqe = NextSqeLocked();
+  PW_CHECK_NOTNULL(sqe, "Dispatcher failed to queue wake notification read");
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = wake_fd_;
+  sqe->addr = reinterpret_cast<uintptr_t>(&wake_value_);
+  sqe->len = sizeof(wake_value_);
+  sqe->user_data = kWakeReadUserData;
+  QueueSqeLocked();
+}
+
+Status Dispatcher::NativeSubmit(NativeOperation& operation,
+                                const io_uring_sqe& sqe) {
+  std::lock_guard lock(ring_lock_);
+  if (operation.in_flight_) {
+    return Status::FailedPrecondition();
+  }
+  io_uring_sqe* next = NextSqeLocked();
+  if (next == nullptr) {
+    return Status::ResourceExhausted();
+  }
+  *next = sqe;
+  next->user_data = reinterpret_cast<uintptr_t>(&operation);
+  operation.dispatcher_ = this;
+  operation.waker_.Clear();
+  operation.in_flight_ = true;
+  operation.complete_ = false;
+  QueueSqeLocked();
+
+  // A thread that is already waiting does not submit entries queued since,
+  // so submit them now.
+  bool polling;
+  {
+    std::lock_guard wake_lock(wake_lock_);
+    polling = polling_;
+  }
+  if (polling) {
+    static_cast<void>(Enter(UnsubmittedLocked(), 0, std::nullopt));
+  }
+  return OkStatus();
+}
+
+void Dispatcher::NativeCancel(NativeOperation& operation) {
+  {
+    std::lock_guard lock(ring_lock_);
+    if (!operation.in_flight_) {
+      return;
+    }
+    io_uring_sqe* sqe = NextSqeLocked();
+    PW_CHECK_NOTNULL(sqe, "Dispatcher failed to queue cancellation");
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = reinterpret_cast<uintptr_t>(&operation);
+    sqe->user_data = kCancelUserData;
+    QueueSqeLocked();
+    static_cast<void>(Enter(UnsubmittedLocked(), 0, std::nullopt));
+  }
+
+  // The cancellation itself completes, so waiting for one completion at a
+  // time cannot block indefinitely.
+  while (operation.in_flight()) {
+    if (TryStartPolling()) {
+      static_cast<void>(Enter(0, 1, std::nullopt));
+      ReapCompletions();
+      StopPolling();
+    } else {
+      this_thread::yield();
+    }
+  }
+}
+
+Status Dispatcher::NativeRegisterBuffers(span<const ByteSpan> buffers) {
+  if (buffers.size() > kMaxRegisteredBuffers) {
+    return Status::ResourceExhausted();
+  }
+
+  std::lock_guard lock(ring_lock_);
+  if (!registered_buffers_.empty()) {
+    if (syscall(__NR_io_uring_register,
+                ring_fd_,
+                IORING_UNREGISTER_BUFFERS,
+                nullptr,
+                0) < 0) {
+      PW_LOG_ERROR("Failed to unregister io_uring buffers: %s",
+                   std::strerror(errno));
+      return Status::Internal();
+    }
+    registered_buffers_.clear();
+  }
+  if (buffers.empty()) {
+    return OkStatus();
+  }
+
+  std::array<iovec, kMaxRegisteredBuffers> iovecs;
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    iovecs[i].iov_base = buffers[i].data();
+    iovecs[i].iov_len = buffers[i].size();
+  }
+  if (syscall(__NR_io_uring_register,
+              ring_fd_,
+              IORING_REGISTER_BUFFERS,
+              iovecs.data(),
+              buffers.size()) < 0) {
+    PW_LOG_ERROR("Failed to register io_uring buffers: %s",
+                 std::strerror(errno));
+    return Status::Internal();
+  }
+  registered_buffers_.assign(buffers.begin(), buffers.end());
+  return OkStatus();
+}
+
+std::optional<uint16_t> Dispatcher::NativeFindRegisteredBuffer(
+    ConstByteSpan data) {
+  std::lock_guard lock(ring_lock_);
+  for (size_t i = 0; i < registered_buffers_.size(); ++i) {
+    const ByteSpan& buffer = registered_buffers_[i];
+    if (data.data() >= buffer.data() &&
+        data.data() + data.size() <= buffer.data() + buffer.size()) {
+      return static_cast<uint16_t>(i);
+    }
+  }
+  return std::nullopt;
+}
+
+void Dispatcher::DoWake() {
+  std::lock_guard lock(wake_lock_);
+  if (sleeping_threads_ != 0) {
+    --sleeping_threads_;
+    waiting_threads_.release();
+    return;
+  }
+
+  // Wake the poller. Nonblocking writes only fail if the counter would
+  // overflow, in which case the poller is already due to wake.
+  const uint64_t value = 1;
+  static_cast<void>(write(wake_fd_, &value, sizeof(value)));
+}
+
+}  // namespace pw::async2
@@ -0,0 +1,28 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// PW_ASYNC2_URING_CONFIG_QUEUE_DEPTH sets the number of entries in the
+// submission queue of each dispatcher's io_uring. Operations submitted by
+// tasks are queued here and submitted together, so this bounds how many
+// operations may be submitted between two waits.
+#ifndef PW_ASYNC2_URING_CONFIG_QUEUE_DEPTH
+#define PW_ASYNC2_URING_CONFIG_QUEUE_DEPTH 64
+#endif  // PW_ASYNC2_URING_CONFIG_QUEUE_DEPTH
+
+// PW_ASYNC2_URING_CONFIG_MAX_REGISTERED_BUFFERS sets the maximum number of
+// buffers that may be registered with a dispatcher's io_uring at once.
+#ifndef PW_ASYNC2_URING_CONFIG_MAX_REGISTERED_BUFFERS
+#define PW_ASYNC2_URING_CONFIG_MAX_REGISTERED_BUFFERS 8
+#endif  // PW_ASYNC2_URING_CONFIG_MAX_REGISTERED_BUFFERS
@@ -0,0 +1,246 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <linux/io_uring.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_assert/assert.h"
+#include "pw_async2/dispatcher_base.h"
+#include "pw_async2_uring/config.h"
+#include "pw_bytes/span.h"
+#include "pw_containers/vector.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_sync/counting_semaphore.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::async2 {
+
+// Implementor's note:
+//
+// This class defines the io_uring backend for the ``Dispatcher`` facade.
+//
+// Tasks start I/O with ``NativeSubmit``, which only adds an entry to the
+// submission queue of the ring. Queued entries are submitted by the same
+// ``io_uring_enter`` call that waits for completions, so the operations
+// started by a batch of tasks cost a single system call.
+//
+// Any number of threads may run this ``Dispatcher`` concurrently. At most one
+// of them, the poller, waits for and processes completions. The others wait
+// on a semaphore until they are woken or the poller stops polling. ``DoWake``
+// wakes either a waiting thread or, through an eventfd read kept in flight on
+// the ring, the poller.
+class Dispatcher final : public DispatcherImpl<Dispatcher> {
+ public:
+  /// An asynchronous operation submitted to the io_uring of a ``Dispatcher``.
+  ///
+  /// Operations are referred to by the kernel until they complete, so they
+  /// must not be destroyed while in flight. Use ``NativeCancel`` to stop an
+  /// operation early.
+  class NativeOperation {
+   public:
+    constexpr NativeOperation() = default;
+    NativeOperation(const NativeOperation&) = delete;
+    NativeOperation& operator=(const NativeOperation&) = delete;
+
+    /// Returns ``Ready`` with the result of the operation once it completes,
+    /// i.e. the ``res`` field of its completion queue entry. This is
+    /// non-negative on success, or a negated ``errno`` value.
+    ///
+    /// Otherwise, arranges for the current task to be woken on completion.
+    ///
+    /// @pre The operation must have been submitted with ``NativeSubmit``, and
+    ///      its result not yet returned.
+    Poll<int> Pend(Context& cx);
+
+    /// Returns whether the operation has been submitted and has not yet
+    /// completed.
+    [[nodiscard]] bool in_flight() const;
+
+   private:
+    friend class Dispatcher;
+
+    Dispatcher* dispatcher_ = nullptr;
+    Waker waker_;
+    int result_ = 0;
+    bool in_flight_ = false;
+    bool complete_ = false;
+  };
+
+  Dispatcher() { PW_ASSERT_OK(NativeInit()); }
+  Dispatcher(Dispatcher&) = delete;
+  Dispatcher(Dispatcher&&) = delete;
+  Dispatcher& operator=(Dispatcher&) = delete;
+  Dispatcher& operator=(Dispatcher&&) = delete;
+  ~Dispatcher() final;
+
+  Status NativeInit();
+
+  /// Queues an operation described by a submission queue entry.
+  ///
+  /// The ``user_data`` field of ``sqe`` is overwritten to refer to
+  /// ``operation``. The entry is submitted once the ``Dispatcher`` next waits
+  /// for completions, or immediately if another thread is already waiting.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The operation was queued.
+  ///
+  ///    FAILED_PRECONDITION: ``operation`` is already in flight.
+  ///
+  ///    RESOURCE_EXHAUSTED: The submission queue is full.
+  ///
+  /// @endrst
+  Status NativeSubmit(NativeOperation& operation, const io_uring_sqe& sqe);
+
+  /// Cancels an in-flight operation, and blocks until it completes.
+  ///
+  /// Once this returns, the operation is no longer referred to by the kernel
+  /// and may be destroyed. Its result, typically ``-ECANCELED``, is returned
+  /// by its next ``Pend``.
+  void NativeCancel(NativeOperation& operation);
+
+  /// Registers buffers with the kernel, so operations on them may use
+  /// ``IORING_OP_READ_FIXED`` and ``IORING_OP_WRITE_FIXED``. This avoids
+  /// mapping the buffers for each operation.
+  ///
+  /// Typically, these are the regions that back a ``MultiBufAllocator``, so
+  /// that every chunk it allocates is within a registered buffer.
+  ///
+  /// This replaces any previously registered buffers, or unregisters them if
+  /// ``buffers`` is empty. It must not be called while operations on
+  /// registered buffers are in flight.
+  Status NativeRegisterBuffers(span<const ByteSpan> buffers);
+
+  /// Returns the index of the registered buffer that contains ``data``, or
+  /// ``std::nullopt`` if none does.
+  std::optional<uint16_t> NativeFindRegisteredBuffer(ConstByteSpan data);
+
+ private:
+  static constexpr uint32_t kQueueDepth = PW_ASYNC2_URING_CONFIG_QUEUE_DEPTH;
+  static constexpr size_t kMaxRegisteredBuffers =
+      PW_ASYNC2_URING_CONFIG_MAX_REGISTERED_BUFFERS;
+  static_assert(kQueueDepth > 0,
+                "PW_ASYNC2_URING_CONFIG_QUEUE_DEPTH must be positive");
+
+  void DoWake() final;
+  Poll<> DoRunUntilStalled(Task* task);
+  void DoRunToCompletion(Task* task);
+  friend class DispatcherImpl<Dispatcher>;
+
+  // Waits for a ``DoWake`` call, an operation to complete, or ``wake_time``.
+  Status NativeWaitForWake(
+      std::optional<chrono::SystemClock::time_point> wake_time);
+
+  // Submits queued entries and processes available completions without
+  // waiting, unless another thread is polling. Returns the number of
+  // operations that completed.
+  size_t SubmitAndReap();
+
+  // Calls ``io_uring_enter``, waiting for ``min_complete`` completions until
+  // ``wake_time`` if it has a value. Returns the result of the call, or a
+  // negated ``errno`` value.
+  int Enter(uint32_t to_submit,
+            uint32_t min_complete,
+            std::optional<chrono::SystemClock::time_point> wake_time);
+
+  // Makes the calling thread the poller if there is none. Only the poller may
+  // call ``ReapCompletions``.
+  bool TryStartPolling();
+
+  // Stops polling. If other threads are waiting, wakes one to take over.
+  void StopPolling();
+
+  // Consumes a wake recorded from the eventfd, if there is one.
+  bool TryConsumeWake();
+
+  // Processes all available completions, waking the tasks of completed
+  // operations. Returns the number of operations that completed.
+  size_t ReapCompletions();
+
+  // The methods below must be called with ``ring_lock_`` held.
+
+  // Returns the number of entries queued but not yet consumed by the kernel.
+  uint32_t UnsubmittedLocked() const;
+
+  // Returns the next free submission queue entry, cleared, or null if the
+  // queue is full even after submitting the queued entries.
+  io_uring_sqe* NextSqeLocked();
+
+  // Makes the entry returned by ``NextSqeLocked`` visible to the kernel.
+  void QueueSqeLocked();
+
+  // Queues a read of ``wake_fd_``, which completes once ``DoWake`` writes to
+  // it.
+  void QueueWakeReadLocked();
+
+  int ring_fd_ = -1;
+  int wake_fd_ = -1;
+
+  // Guards the submission queue, registered buffers, and all
+  // ``NativeOperation`` s submitted to the ring.
+  //
+  // May be held while acquiring ``dispatcher_lock()`` and ``wake_lock_``.
+  pw::sync::Mutex ring_lock_;
+
+  // Mappings of the rings shared with the kernel. The submission and
+  // completion queues share a single mapping.
+  void* rings_ = nullptr;
+  size_t rings_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+
+  const uint32_t* sq_head_ = nullptr;
+  uint32_t* sq_tail_ = nullptr;
+  uint32_t sq_mask_ = 0;
+  uint32_t sq_entries_ = 0;
+  uint32_t* cq_head_ = nullptr;
+  const uint32_t* cq_tail_ = nullptr;
+  uint32_t cq_mask_ = 0;
+  const io_uring_cqe* cqes_ = nullptr;
+
+  // Destination of the read of ``wake_fd_`` kept in flight.
+  uint64_t wake_value_ = 0;
+
+  pw::Vector<ByteSpan, kMaxRegisteredBuffers> registered_buffers_;
+
+  // Guards the members below. As ``DoWake`` may be called with
+  // ``dispatcher_lock()`` held, this is a spin lock, and must not be held while
+  // acquiring other locks.
+  pw::sync::InterruptSpinLock wake_lock_;
+
+  // Whether a thread is the poller.
+  bool polling_ = false;
+
+  // The number of threads waiting on ``waiting_threads_``.
+  size_t sleeping_threads_ = 0;
+
+  // The number of releases of ``waiting_threads_`` that hand polling over to
+  // another thread rather than correspond to a ``DoWake`` call.
+  size_t handoffs_ = 0;
+
+  // The number of eventfd reads completed but not yet consumed.
+  size_t wakes_ = 0;
+
+  pw::sync::CountingSemaphore waiting_threads_;
+};
+
+}  // namespace pw::async2
@@ -64,13 +64,13 @@ void BasicDispatcher::RunFor(chrono::SystemClock::duration duration) {
 }
 
 void BasicDispatcher::MaybeSleep() {
-  if (task_queue_.empty() || task_queue_.front().due_time_ > now()) {
+  if (task_queue_.empty() || task_queue_.begin()->due_time_ > now()) {
     // Sleep until a notification is received or until the due time of the
     // next task. Notifications are sent when tasks are posted or 'stop' is
     // requested.
     std::optional<chrono::SystemClock::time_point> wake_time = std::nullopt;
     if (!task_queue_.empty()) {
-      wake_time = task_queue_.front().due_time_;
+      wake_time = task_queue_.begin()->due_time_;
     }
     lock_.unlock();
     if (wake_time.has_value()) {
@@ -83,10 +83,10 @@ void BasicDispatcher::MaybeSleep() {
 }
 
 void BasicDispatcher::ExecuteDueTasks() {
-  while (!task_queue_.empty() && task_queue_.front().due_time_ <= now() &&
+  while (!task_queue_.empty() && task_queue_.begin()->due_time_ <= now() &&
          !stop_requested_) {
-    backend::NativeTask& task = task_queue_.front();
-    task_queue_.pop_front();
+    backend::NativeTask& task = *task_queue_.begin();
+    task_queue_.erase(task);
 
     lock_.unlock();
     Context ctx{this, &task.task_};
@@ -105,8 +105,8 @@ void BasicDispatcher::RequestStop() {
 
 void BasicDispatcher::DrainTaskQueue() {
   while (!task_queue_.empty()) {
-    backend::NativeTask& task = task_queue_.front();
-    task_queue_.pop_front();
+    backend::NativeTask& task = *task_queue_.begin();
+    task_queue_.erase(task);
 
     lock_.unlock();
     Context ctx{this, &task.task_};
@@ -121,22 +121,29 @@ void BasicDispatcher::PostAt(Task& task, chrono::SystemClock::time_point time) {
 
 bool BasicDispatcher::Cancel(Task& task) {
   std::lock_guard lock(lock_);
-  return task_queue_.remove(task.native_type());
+  backend::NativeTask& native_task = task.native_type();
+  if (native_task.unlisted()) {
+    return false;
+  }
+  task_queue_.erase(native_task);
+  return true;
 }
 
 void BasicDispatcher::PostTaskInternal(
     backend::NativeTask& task, chrono::SystemClock::time_point time_due) {
   lock_.lock();
-  task.due_time_ = time_due;
-  // Insert the new task in the queue after all tasks with the same or earlier
-  // deadline to ensure FIFO execution order.
-  auto it_front = task_queue_.begin();
-  auto it_behind = task_queue_.before_begin();
-  while (it_front != task_queue_.end() && time_due >= it_front->due_time_) {
-    ++it_front;
-    ++it_behind;
+  if (!task.unlisted()) {
+    if (task.due_time_ <= time_due) {
+      // No need to repost a task that was already queued to run.
+      lock_.unlock();
+      return;
+    }
+    task_queue_.erase(task);
   }
-  task_queue_.insert_after(it_behind, task);
+  task.due_time_ = time_due;
+  // Tasks with the same deadline run in the order they were posted.
+  task.sequence_ = next_sequence_++;
+  task_queue_.insert(task);
   lock_.unlock();
   timed_notification_.release();
 }
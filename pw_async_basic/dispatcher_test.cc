@@ -13,6 +13,7 @@
 // the License.
 #include "pw_async_basic/dispatcher.h"
 
+#include <array>
 #include <vector>
 
 #include "pw_chrono/system_clock.h"
@@ -127,6 +128,47 @@ TEST(DispatcherBasic, TaskOrdering) {
   EXPECT_EQ(state.tasks[1], 2);
 }
 
+TEST(DispatcherBasic, ManyTasksRunInDueTimeOrder) {
+  static constexpr int kTaskCount = 30;
+  struct TestState {
+    std::array<Task, kTaskCount> tasks;
+    std::vector<int> ran;
+  };
+
+  TestState state;
+  auto& tasks = state.tasks;
+  for (Task& task : tasks) {
+    task.set_function([&state](Context& c, Status status) {
+      ASSERT_OK(status);
+      state.ran.push_back(static_cast<int>(c.task - state.tasks.data()));
+    });
+  }
+
+  // Tasks i and i + 10 share a due time, with earlier groups due later.
+  BasicDispatcher dispatcher;
+  const auto now = chrono::SystemClock::now();
+  for (int i = 0; i < kTaskCount; ++i) {
+    dispatcher.PostAt(tasks[i], now - std::chrono::milliseconds(i % 10));
+  }
+
+  // Cancelling and reposting for a later time do not disturb the order.
+  EXPECT_TRUE(dispatcher.Cancel(tasks[15]));
+  EXPECT_FALSE(dispatcher.Cancel(tasks[15]));
+  dispatcher.PostAt(tasks[9], now);
+
+  dispatcher.RunUntilIdle();
+
+  std::vector<int> expected;
+  for (int group = 9; group >= 0; --group) {
+    for (int i = group; i < kTaskCount; i += 10) {
+      if (i != 15) {
+        expected.push_back(i);
+      }
+    }
+  }
+  EXPECT_EQ(state.ran, expected);
+}
+
 // Test RequestStop() from inside task.
 TEST(DispatcherBasic, RequestStopInsideTask) {
   BasicDispatcher dispatcher;
@@ -39,9 +39,9 @@ bool NativeFakeDispatcher::RunUntilIdle() {
 
 bool NativeFakeDispatcher::RunUntil(chrono::SystemClock::time_point end_time) {
   bool tasks_ran = false;
-  while (!task_queue_.empty() && task_queue_.front().due_time() <= end_time &&
+  while (!task_queue_.empty() && task_queue_.begin()->due_time() <= end_time &&
          !stop_requested_) {
-    now_ = task_queue_.front().due_time();
+    now_ = task_queue_.begin()->due_time();
     tasks_ran |= ExecuteDueTasks();
   }
 
@@ -62,10 +62,10 @@ bool NativeFakeDispatcher::RunFor(chrono::SystemClock::duration duration) {
 
 bool NativeFakeDispatcher::ExecuteDueTasks() {
   bool task_ran = false;
-  while (!task_queue_.empty() && task_queue_.front().due_time() <= now() &&
+  while (!task_queue_.empty() && task_queue_.begin()->due_time() <= now() &&
          !stop_requested_) {
-    ::pw::async::backend::NativeTask& task = task_queue_.front();
-    task_queue_.pop_front();
+    ::pw::async::backend::NativeTask& task = *task_queue_.begin();
+    task_queue_.erase(task);
 
     Context ctx{&dispatcher_, &task.task_};
     task(ctx, OkStatus());
@@ -83,8 +83,8 @@ void NativeFakeDispatcher::RequestStop() {
 bool NativeFakeDispatcher::DrainTaskQueue() {
   bool task_ran = false;
   while (!task_queue_.empty()) {
-    ::pw::async::backend::NativeTask& task = task_queue_.front();
-    task_queue_.pop_front();
+    ::pw::async::backend::NativeTask& task = *task_queue_.begin();
+    task_queue_.erase(task);
 
     PW_LOG_DEBUG("running cancelled task");
     Context ctx{&dispatcher_, &task.task_};
@@ -109,7 +109,12 @@ void NativeFakeDispatcher::PostAt(Task& task,
 }
 
 bool NativeFakeDispatcher::Cancel(Task& task) {
-  return task_queue_.remove(task.native_type());
+  ::pw::async::backend::NativeTask& native_task = task.native_type();
+  if (native_task.unlisted()) {
+    return false;
+  }
+  task_queue_.erase(native_task);
+  return true;
 }
 
 void NativeFakeDispatcher::PostTaskInternal(
@@ -121,17 +126,13 @@ void NativeFakeDispatcher::PostTaskInternal(
       return;
     }
     // The task needs its time updated, so we have to move it to
-    // a different part of the list.
-    task.unlist();
+    // a different part of the queue.
+    task_queue_.erase(task);
   }
   task.set_due_time(time_due);
-  auto it_front = task_queue_.begin();
-  auto it_behind = task_queue_.before_begin();
-  while (it_front != task_queue_.end() && time_due >= it_front->due_time()) {
-    ++it_front;
-    ++it_behind;
-  }
-  task_queue_.insert_after(it_behind, task);
+  // Tasks with the same deadline run in the order they were posted.
+  task.sequence_ = next_sequence_++;
+  task_queue_.insert(task);
 }
 
 }  // namespace pw::async::test::backend
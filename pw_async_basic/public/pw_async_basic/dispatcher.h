@@ -62,8 +62,8 @@ class BasicDispatcher final : public Dispatcher, public thread::ThreadCore {
   }
 
  private:
-  // Insert |task| into task_queue_ maintaining its min-heap property, keyed by
-  // |time_due|.
+  // Insert |task| into task_queue_, ordered by |time_due|. If |task| is already
+  // queued to run at or before |time_due|, it is left in place.
   void PostTaskInternal(backend::NativeTask& task,
                         chrono::SystemClock::time_point time_due)
       PW_LOCKS_EXCLUDED(lock_);
@@ -83,7 +83,9 @@ class BasicDispatcher final : public Dispatcher, public thread::ThreadCore {
   sync::TimedThreadNotification timed_notification_;
   bool stop_requested_ PW_GUARDED_BY(lock_) = false;
   // A priority queue of scheduled Tasks sorted by earliest due times first.
-  IntrusiveList<backend::NativeTask> task_queue_ PW_GUARDED_BY(lock_);
+  backend::TaskQueue task_queue_ PW_GUARDED_BY(lock_);
+  // Orders tasks that are posted with the same due time.
+  uint64_t next_sequence_ PW_GUARDED_BY(lock_) = 0;
 };
 
 }  // namespace pw::async
@@ -13,9 +13,10 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 #include "pw_async/dispatcher.h"
 #include "pw_async/task.h"
-#include "pw_containers/intrusive_list.h"
 
 namespace pw::async::test::backend {
 
@@ -43,8 +44,8 @@ class NativeFakeDispatcher final {
   chrono::SystemClock::time_point now() { return now_; }
 
  private:
-  // Insert |task| into task_queue_ maintaining its min-heap property, keyed by
-  // |time_due|.
+  // Insert |task| into task_queue_, ordered by |time_due|. If |task| is already
+  // queued to run at or before |time_due|, it is left in place.
   void PostTaskInternal(::pw::async::backend::NativeTask& task,
                         chrono::SystemClock::time_point time_due);
 
@@ -61,7 +62,10 @@ class NativeFakeDispatcher final {
   bool stop_requested_ = false;
 
   // A priority queue of scheduled tasks sorted by earliest due times first.
-  IntrusiveList<::pw::async::backend::NativeTask> task_queue_;
+  ::pw::async::backend::TaskQueue task_queue_;
+
+  // Orders tasks that are posted with the same due time.
+  uint64_t next_sequence_ = 0;
 
   // Tracks the current time as viewed by the test dispatcher.
   chrono::SystemClock::time_point now_;
@@ -13,10 +13,12 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 #include "pw_async/context.h"
 #include "pw_async/task_function.h"
 #include "pw_chrono/system_clock.h"
-#include "pw_containers/intrusive_list.h"
+#include "pw_containers/intrusive_map.h"
 
 namespace pw::async {
 class BasicDispatcher;
@@ -27,12 +29,32 @@ class NativeFakeDispatcher;
 
 namespace pw::async::backend {
 
+// Orders queued tasks by due time. Tasks with the same due time are ordered by
+// a sequence number that the dispatcher increments for each post, so that
+// they run in the order they were posted.
+struct TaskQueueKey {
+  chrono::SystemClock::time_point due_time;
+  uint64_t sequence;
+
+  bool operator<(const TaskQueueKey& other) const {
+    return due_time != other.due_time ? due_time < other.due_time
+                                      : sequence < other.sequence;
+  }
+};
+
+class NativeTask;
+
+// Queue of tasks waiting to run, with the earliest due task first. Inserting
+// and removing a task is O(log n).
+using TaskQueue = IntrusiveMap<TaskQueueKey, NativeTask>;
+
 // Task backend for BasicDispatcher.
-class NativeTask final : public IntrusiveList<NativeTask>::Item {
+class NativeTask final : public TaskQueue::Item {
  private:
   friend class ::pw::async::Task;
   friend class ::pw::async::BasicDispatcher;
   friend class ::pw::async::test::backend::NativeFakeDispatcher;
+  friend TaskQueue;
 
   NativeTask(::pw::async::Task& task) : task_(task) {}
   explicit NativeTask(::pw::async::Task& task, TaskFunction&& f)
@@ -45,6 +67,8 @@ class NativeTask final : public IntrusiveList<NativeTask>::Item {
     due_time_ = due_time;
   }
 
+  TaskQueueKey key() const { return {due_time_, sequence_}; }
+
   TaskFunction func_ = nullptr;
   // task_ is placed after func_ to take advantage of the padding that would
   // otherwise be added here. On 32-bit systems, func_ and due_time_ have an
@@ -52,6 +76,7 @@ class NativeTask final : public IntrusiveList<NativeTask>::Item {
   // padding would be added here, which is just enough for a pointer.
   Task& task_;
   pw::chrono::SystemClock::time_point due_time_;
+  uint64_t sequence_ = 0;
 };
 
 using NativeTaskHandle = NativeTask&;
@@ -15,9 +15,34 @@
 #include "pw_base64/base64.h"
 
 #include <cstdint>
+#include <cstring>
 
 #include "pw_assert/check.h"
 
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#define _PW_BASE64_X86_SSSE3 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define _PW_BASE64_ARM_NEON 1
+#endif
+
+#if defined(__AVX2__) && defined(__SSSE3__)
+#define _PW_BASE64_X86_AVX2 1
+#endif
+
+#ifndef _PW_BASE64_X86_SSSE3
+#define _PW_BASE64_X86_SSSE3 0
+#endif  // _PW_BASE64_X86_SSSE3
+
+#ifndef _PW_BASE64_X86_AVX2
+#define _PW_BASE64_X86_AVX2 0
+#endif  // _PW_BASE64_X86_AVX2
+
+#ifndef _PW_BASE64_ARM_NEON
+#define _PW_BASE64_ARM_NEON 0
+#endif  // _PW_BASE64_ARM_NEON
+
 namespace pw::base64 {
 namespace {
 
@@ -84,6 +109,330 @@ constexpr uint8_t Byte2(uint8_t bits2, uint8_t bits3) {
   return static_cast<uint8_t>((bits2 & 0b000011) << 6) | bits3;
 }
 
+// Vectorized kernels
+//
+// The kernels encode and decode whole blocks of input and leave the remainder
+// to the scalar loops. Each returns the number of input bytes it consumed,
+// which is a multiple of 3 for encoding and 4 for decoding. The x86 kernels
+// follow Muła and Lemire, "Faster Base64 Encoding and Decoding using AVX2
+// Instructions" (2018). Decoding accepts both the standard and URL-safe
+// alphabets, like kDecodeTable. The output for invalid characters is
+// unspecified, as it is for the scalar decoder.
+
+#if _PW_BASE64_X86_SSSE3
+
+// Converts bytes 0-11 of the input to sixteen 6-bit indices.
+__m128i EncodeSplitSsse3(__m128i in) {
+  in = _mm_shuffle_epi8(
+      in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(t1, t3);
+}
+
+// Maps 6-bit indices to characters by adding a per-range offset.
+__m128i EncodeTranslateSsse3(__m128i indices) {
+  // 0 for indices 26-51, 1-12 for 52-63, and 13 for 0-25.
+  __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  const __m128i is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  range = _mm_or_si128(range, _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+
+  const __m128i offsets = _mm_setr_epi8('a' - 26,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        kChar62 - 62,
+                                        kChar63 - 63,
+                                        'A',
+                                        0,
+                                        0);
+  return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+}
+
+// Returns a mask of the characters in [low, high].
+__m128i InRangeSsse3(__m128i chars, char low, char high) {
+  return _mm_and_si128(
+      _mm_cmpgt_epi8(chars, _mm_set1_epi8(static_cast<char>(low - 1))),
+      _mm_cmplt_epi8(chars, _mm_set1_epi8(static_cast<char>(high + 1))));
+}
+
+__m128i MaskedOffsetSsse3(__m128i mask, int offset) {
+  return _mm_and_si128(mask, _mm_set1_epi8(static_cast<char>(offset)));
+}
+
+// Maps characters to their 6-bit values.
+__m128i DecodeTranslateSsse3(__m128i chars) {
+  __m128i offset = MaskedOffsetSsse3(InRangeSsse3(chars, 'A', 'Z'), -'A');
+  offset = _mm_or_si128(
+      offset, MaskedOffsetSsse3(InRangeSsse3(chars, 'a', 'z'), 26 - 'a'));
+  offset = _mm_or_si128(
+      offset, MaskedOffsetSsse3(InRangeSsse3(chars, '0', '9'), 52 - '0'));
+  offset = _mm_or_si128(
+      offset,
+      MaskedOffsetSsse3(_mm_cmpeq_epi8(chars, _mm_set1_epi8('+')), 62 - '+'));
+  offset = _mm_or_si128(
+      offset,
+      MaskedOffsetSsse3(_mm_cmpeq_epi8(chars, _mm_set1_epi8('-')), 62 - '-'));
+  offset = _mm_or_si128(
+      offset,
+      MaskedOffsetSsse3(_mm_cmpeq_epi8(chars, _mm_set1_epi8('/')), 63 - '/'));
+  offset = _mm_or_si128(
+      offset,
+      MaskedOffsetSsse3(_mm_cmpeq_epi8(chars, _mm_set1_epi8('_')), 63 - '_'));
+  return _mm_add_epi8(chars, offset);
+}
+
+// Packs sixteen 6-bit values into bytes 0-11 of the result.
+__m128i DecodePackSsse3(__m128i values) {
+  const __m128i pairs =
+      _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+  return _mm_shuffle_epi8(
+      words,
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+#endif  // _PW_BASE64_X86_SSSE3
+
+#if _PW_BASE64_X86_AVX2
+
+// AVX2 versions of the SSSE3 functions, which process each 128-bit lane
+// independently.
+
+__m256i EncodeSplitAvx2(__m256i in) {
+  in = _mm256_shuffle_epi8(in,
+                           _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4,
+                                            7, 6, 8, 7, 10, 9, 11, 10,
+                                            1, 0, 2, 1, 4, 3, 5, 4,
+                                            7, 6, 8, 7, 10, 9, 11, 10));
+  const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+  const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+  const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+  const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+  return _mm256_or_si256(t1, t3);
+}
+
+__m256i EncodeTranslateAvx2(__m256i indices) {
+  __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+  const __m256i is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+  range = _mm256_or_si256(range,
+                          _mm256_and_si256(is_upper, _mm256_set1_epi8(13)));
+
+  const __m256i offsets = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8('a' - 26,
+                    '0' - 52,
+                    '0' - 52,
+                    '0' - 52,
+                    '0' - 52,
+                    '0' - 52,
+                    '0' - 52,
+                    '0' - 52,
+                    '0' - 52,
+                    '0' - 52,
+                    '0' - 52,
+                    kChar62 - 62,
+                    kChar63 - 63,
+                    'A',
+                    0,
+                    0));
+  return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+}
+
+__m256i InRangeAvx2(__m256i chars, char low, char high) {
+  return _mm256_and_si256(
+      _mm256_cmpgt_epi8(chars, _mm256_set1_epi8(static_cast<char>(low - 1))),
+      _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(high + 1)), chars));
+}
+
+__m256i MaskedOffsetAvx2(__m256i mask, int offset) {
+  return _mm256_and_si256(mask, _mm256_set1_epi8(static_cast<char>(offset)));
+}
+
+__m256i EqualsAvx2(__m256i chars, char value) {
+  return _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(value));
+}
+
+__m256i DecodeTranslateAvx2(__m256i chars) {
+  __m256i offset = MaskedOffsetAvx2(InRangeAvx2(chars, 'A', 'Z'), -'A');
+  offset = _mm256_or_si256(
+      offset, MaskedOffsetAvx2(InRangeAvx2(chars, 'a', 'z'), 26 - 'a'));
+  offset = _mm256_or_si256(
+      offset, MaskedOffsetAvx2(InRangeAvx2(chars, '0', '9'), 52 - '0'));
+  offset = _mm256_or_si256(
+      offset, MaskedOffsetAvx2(EqualsAvx2(chars, '+'), 62 - '+'));
+  offset = _mm256_or_si256(
+      offset, MaskedOffsetAvx2(EqualsAvx2(chars, '-'), 62 - '-'));
+  offset = _mm256_or_si256(
+      offset, MaskedOffsetAvx2(EqualsAvx2(chars, '/'), 63 - '/'));
+  offset = _mm256_or_si256(
+      offset, MaskedOffsetAvx2(EqualsAvx2(chars, '_'), 63 - '_'));
+  return _mm256_add_epi8(chars, offset);
+}
+
+__m256i DecodePackAvx2(__m256i values) {
+  const __m256i pairs =
+      _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+  const __m256i words =
+      _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+  return _mm256_shuffle_epi8(
+      words,
+      _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                       2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+#endif  // _PW_BASE64_X86_AVX2
+
+#if _PW_BASE64_ARM_NEON
+
+// Maps 6-bit indices to characters by adding a per-range offset.
+uint8x16_t EncodeTranslateNeon(uint8x16_t indices) {
+  uint8x16_t offset = vdupq_n_u8('A');
+  offset = vbslq_u8(vcgeq_u8(indices, vdupq_n_u8(26)),
+                    vdupq_n_u8('a' - 26),
+                    offset);
+  offset = vbslq_u8(vcgeq_u8(indices, vdupq_n_u8(52)),
+                    vdupq_n_u8(static_cast<uint8_t>('0' - 52)),
+                    offset);
+  offset = vbslq_u8(vceqq_u8(indices, vdupq_n_u8(62)),
+                    vdupq_n_u8(static_cast<uint8_t>(kChar62 - 62)),
+                    offset);
+  offset = vbslq_u8(vceqq_u8(indices, vdupq_n_u8(63)),
+                    vdupq_n_u8(static_cast<uint8_t>(kChar63 - 63)),
+                    offset);
+  return vaddq_u8(indices, offset);
+}
+
+uint8x16_t InRangeNeon(uint8x16_t chars, uint8_t low, uint8_t high) {
+  return vandq_u8(vcgeq_u8(chars, vdupq_n_u8(low)),
+                  vcleq_u8(chars, vdupq_n_u8(high)));
+}
+
+uint8x16_t MaskedOffsetNeon(uint8x16_t mask, int offset) {
+  return vandq_u8(mask, vdupq_n_u8(static_cast<uint8_t>(offset)));
+}
+
+uint8x16_t EqualsNeon(uint8x16_t chars, uint8_t value) {
+  return vceqq_u8(chars, vdupq_n_u8(value));
+}
+
+// Maps characters to their 6-bit values.
+uint8x16_t DecodeTranslateNeon(uint8x16_t chars) {
+  uint8x16_t offset = MaskedOffsetNeon(InRangeNeon(chars, 'A', 'Z'), -'A');
+  offset = vorrq_u8(offset,
+                    MaskedOffsetNeon(InRangeNeon(chars, 'a', 'z'), 26 - 'a'));
+  offset = vorrq_u8(offset,
+                    MaskedOffsetNeon(InRangeNeon(chars, '0', '9'), 52 - '0'));
+  offset = vorrq_u8(offset, MaskedOffsetNeon(EqualsNeon(chars, '+'), 62 - '+'));
+  offset = vorrq_u8(offset, MaskedOffsetNeon(EqualsNeon(chars, '-'), 62 - '-'));
+  offset = vorrq_u8(offset, MaskedOffsetNeon(EqualsNeon(chars, '/'), 63 - '/'));
+  offset = vorrq_u8(offset, MaskedOffsetNeon(EqualsNeon(chars, '_'), 63 - '_'));
+  return vaddq_u8(chars, offset);
+}
+
+#endif  // _PW_BASE64_ARM_NEON
+
+size_t EncodeVectorized([[maybe_unused]] const uint8_t* bytes,
+                        [[maybe_unused]] size_t size_bytes,
+                        [[maybe_unused]] char* output) {
+  size_t consumed = 0;
+#if _PW_BASE64_X86_AVX2
+  // Each lane loads 16 bytes and encodes 12, so 28 bytes must be readable.
+  for (; size_bytes - consumed >= 28u; consumed += 24u, output += 32) {
+    const __m128i low =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + consumed));
+    const __m128i high = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(bytes + consumed + 12));
+    const __m256i in =
+        _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(output),
+                        EncodeTranslateAvx2(EncodeSplitAvx2(in)));
+  }
+#endif  // _PW_BASE64_X86_AVX2
+#if _PW_BASE64_X86_SSSE3
+  // Loads 16 bytes and encodes 12, so 16 bytes must be readable.
+  for (; size_bytes - consumed >= 16u; consumed += 12u, output += 16) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + consumed));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+                     EncodeTranslateSsse3(EncodeSplitSsse3(in)));
+  }
+#endif  // _PW_BASE64_X86_SSSE3
+#if _PW_BASE64_ARM_NEON
+  for (; size_bytes - consumed >= 48u; consumed += 48u, output += 64) {
+    const uint8x16x3_t in = vld3q_u8(bytes + consumed);
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+    uint8x16x4_t out;
+    out.val[0] = vshrq_n_u8(in.val[0], 2);
+    out.val[1] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+    out.val[2] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+    out.val[3] = vandq_u8(in.val[2], mask);
+    for (uint8x16_t& value : out.val) {
+      value = EncodeTranslateNeon(value);
+    }
+    vst4q_u8(reinterpret_cast<uint8_t*>(output), out);
+  }
+#endif  // _PW_BASE64_ARM_NEON
+  return consumed;
+}
+
+// Decodes whole blocks, always leaving the final group, which may be padded,
+// to the scalar loop.
+size_t DecodeVectorized([[maybe_unused]] const char* base64,
+                        [[maybe_unused]] size_t base64_size_bytes,
+                        [[maybe_unused]] uint8_t* binary) {
+  size_t consumed = 0;
+#if _PW_BASE64_X86_AVX2
+  for (; base64_size_bytes - consumed >= 32u + kEncodedGroupSize;
+       consumed += 32u, binary += 24) {
+    const __m256i in = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(base64 + consumed));
+    const __m256i out = DecodePackAvx2(DecodeTranslateAvx2(in));
+    uint8_t bytes[32];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(bytes), out);
+    std::memcpy(binary, bytes, 12);
+    std::memcpy(binary + 12, bytes + 16, 12);
+  }
+#endif  // _PW_BASE64_X86_AVX2
+#if _PW_BASE64_X86_SSSE3
+  for (; base64_size_bytes - consumed >= 16u + kEncodedGroupSize;
+       consumed += 16u, binary += 12) {
+    const __m128i in =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(base64 + consumed));
+    const __m128i out = DecodePackSsse3(DecodeTranslateSsse3(in));
+    uint8_t bytes[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes), out);
+    std::memcpy(binary, bytes, 12);
+  }
+#endif  // _PW_BASE64_X86_SSSE3
+#if _PW_BASE64_ARM_NEON
+  for (; base64_size_bytes - consumed >= 64u + kEncodedGroupSize;
+       consumed += 64u, binary += 48) {
+    uint8x16x4_t in =
+        vld4q_u8(reinterpret_cast<const uint8_t*>(base64 + consumed));
+    for (uint8x16_t& value : in.val) {
+      value = DecodeTranslateNeon(value);
+    }
+    uint8x16x3_t out;
+    out.val[0] = vorrq_u8(vshlq_n_u8(in.val[0], 2), vshrq_n_u8(in.val[1], 4));
+    out.val[1] = vorrq_u8(vshlq_n_u8(in.val[1], 4), vshrq_n_u8(in.val[2], 2));
+    out.val[2] = vorrq_u8(vshlq_n_u8(in.val[2], 6), in.val[3]);
+    vst3q_u8(binary, out);
+  }
+#endif  // _PW_BASE64_ARM_NEON
+  return consumed;
+}
+
 }  // namespace
 
 extern "C" void pw_Base64Encode(const void* binary_data,
@@ -91,8 +440,13 @@ extern "C" void pw_Base64Encode(const void* binary_data,
                                 char* output) {
   const uint8_t* bytes = static_cast<const uint8_t*>(binary_data);
 
+  const size_t vectorized =
+      EncodeVectorized(bytes, binary_size_bytes, output);
+  bytes += vectorized;
+  output += vectorized / 3 * kEncodedGroupSize;
+
   // Encode groups of 3 source bytes into 4 output characters.
-  size_t remaining = binary_size_bytes;
+  size_t remaining = binary_size_bytes - vectorized;
   for (; remaining >= 3u; remaining -= 3u, bytes += 3) {
     *output++ = BitGroup0Char(bytes[0]);
     *output++ = BitGroup1Char(bytes[0], bytes[1]);
@@ -124,7 +478,12 @@ extern "C" size_t pw_Base64Decode(const char* base64,
   }
 
   uint8_t* binary = static_cast<uint8_t*>(output);
-  for (size_t ch = 0; ch < base64_size_bytes; ch += kEncodedGroupSize) {
+  const size_t vectorized =
+      DecodeVectorized(base64, base64_size_bytes, binary);
+  binary += vectorized / kEncodedGroupSize * 3;
+
+  for (size_t ch = vectorized; ch < base64_size_bytes;
+       ch += kEncodedGroupSize) {
     const uint8_t char0 = CharToBits(base64[ch + 0]);
     const uint8_t char1 = CharToBits(base64[ch + 1]);
     const uint8_t char2 = CharToBits(base64[ch + 2]);
@@ -0,0 +1,79 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "pw_base64/base64.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+
+namespace pw::base64 {
+namespace {
+
+// A short message, such as a tokenized log entry.
+constexpr std::array<std::byte, 12> kShort = [] {
+  std::array<std::byte, 12> data{};
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<std::byte>(i * 37u);
+  }
+  return data;
+}();
+
+// A long message, such as a large HDLC frame.
+constexpr std::array<std::byte, 1024> kLong = [] {
+  std::array<std::byte, 1024> data{};
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<std::byte>(i * 37u);
+  }
+  return data;
+}();
+
+template <size_t kSize>
+struct Encoded {
+  Encoded(const std::array<std::byte, kSize>& data) : buffer{} {
+    Encode(data, buffer.data());
+  }
+
+  std::string_view view() const { return {buffer.data(), buffer.size()}; }
+
+  std::array<char, EncodedSize(kSize)> buffer;
+};
+
+const Encoded kShortEncoded(kShort);
+const Encoded kLongEncoded(kLong);
+
+void EncodeTest(perf_test::State& state, span<const std::byte> data) {
+  std::array<char, EncodedSize(kLong.size())> output;
+  while (state.KeepRunning()) {
+    Encode(data, output.data());
+  }
+}
+
+void DecodeTest(perf_test::State& state, std::string_view base64) {
+  std::array<std::byte, MaxDecodedSize(EncodedSize(kLong.size()))> output;
+  while (state.KeepRunning()) {
+    Decode(base64, output.data());
+  }
+}
+
+PW_PERF_TEST(EncodeShortTest, EncodeTest, kShort);
+PW_PERF_TEST(EncodeLongTest, EncodeTest, kLong);
+
+PW_PERF_TEST(DecodeShortTest, DecodeTest, kShortEncoded.view());
+PW_PERF_TEST(DecodeLongTest, DecodeTest, kLongEncoded.view());
+
+}  // namespace
+}  // namespace pw::base64
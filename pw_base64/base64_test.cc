@@ -14,7 +14,11 @@
 
 #include "pw_base64/base64.h"
 
+#include <array>
+#include <cstdint>
 #include <cstring>
+#include <string>
+#include <string_view>
 
 #include "pw_unit_test/framework.h"
 
@@ -394,6 +398,93 @@ bool pw_Base64CallIsValid(const char* base64_data, size_t base64_size);
 constexpr const char kBase64[] = "aaaabbbbcc#%";
 
 // Ensure that the C API works correctly from a C-only context.
+// Inputs long enough to use the vectorized encoder and decoder, if any.
+constexpr std::string_view kLongText =
+    "Tokenized log entries and HDLC frames are often encoded as Base64, so "
+    "the encoder and decoder should handle long inputs quickly.";
+constexpr std::string_view kLongBase64 =
+    "VG9rZW5pemVkIGxvZyBlbnRyaWVzIGFuZCBIRExDIGZyYW1lcyBhcmUgb2Z0ZW4gZW5jb2Rl"
+    "ZCBhcyBCYXNlNjQsIHNvIHRoZSBlbmNvZGVyIGFuZCBkZWNvZGVyIHNob3VsZCBoYW5kbGUg"
+    "bG9uZyBpbnB1dHMgcXVpY2tseS4=";
+
+// Encodes one byte at a time, for comparison with the block encoders.
+std::string ReferenceEncode(span<const uint8_t> data) {
+  constexpr std::string_view kAlphabet =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string encoded;
+  uint32_t bits = 0;
+  int bit_count = 0;
+  for (uint8_t byte : data) {
+    bits = (bits << 8) | byte;
+    bit_count += 8;
+    while (bit_count >= 6) {
+      bit_count -= 6;
+      encoded.push_back(kAlphabet[(bits >> bit_count) & 0x3f]);
+    }
+  }
+  if (bit_count > 0) {
+    encoded.push_back(kAlphabet[(bits << (6 - bit_count)) & 0x3f]);
+  }
+  while (encoded.size() % 4 != 0) {
+    encoded.push_back('=');
+  }
+  return encoded;
+}
+
+TEST(Base64, Encode_LongText) {
+  char output[EncodedSize(kLongText.size())];
+  ASSERT_EQ(kLongBase64.size(),
+            Encode(as_bytes(span(kLongText)), span(output)));
+  EXPECT_EQ(kLongBase64, std::string_view(output, sizeof(output)));
+}
+
+TEST(Base64, Decode_LongText) {
+  char output[MaxDecodedSize(kLongBase64.size())];
+  ASSERT_EQ(kLongText.size(), Decode(kLongBase64, output));
+  EXPECT_EQ(kLongText, std::string_view(output, kLongText.size()));
+}
+
+TEST(Base64, Decode_LongTextInPlace) {
+  char buffer[kLongBase64.size()];
+  std::memcpy(buffer, kLongBase64.data(), kLongBase64.size());
+  ASSERT_EQ(kLongText.size(), Decode(std::string_view(buffer, sizeof(buffer)),
+                                     buffer));
+  EXPECT_EQ(kLongText, std::string_view(buffer, kLongText.size()));
+}
+
+TEST(Base64, Decode_LongUrlSafe) {
+  constexpr std::string_view kUrlSafe =
+      "__79_Pv6-fj39vX08_Lx8O_u7ezr6uno5-bl5OPi4eDf3t3c29rZ2NfW1dTT0tHQz87NzMvK"
+      "ycjHxsXEw8LBwL--vby7urm4t7a1tLOysbCvrq2sq6qpqKempaSjoqGgn56dnA==";
+  uint8_t output[MaxDecodedSize(kUrlSafe.size())];
+  ASSERT_EQ(100u, Decode(kUrlSafe, output));
+  for (size_t i = 0; i < 100u; ++i) {
+    EXPECT_EQ(output[i], 255u - i);
+  }
+}
+
+TEST(Base64, EncodeAndDecode_AllLengths) {
+  std::array<uint8_t, 256> data;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i * 167u + 13u);
+  }
+
+  for (size_t length = 0; length <= data.size(); ++length) {
+    const span<const uint8_t> input = span(data).first(length);
+    const std::string expected = ReferenceEncode(input);
+
+    char encoded[EncodedSize(data.size())];
+    ASSERT_EQ(expected.size(), Encode(as_bytes(input), span(encoded)));
+    ASSERT_EQ(expected, std::string_view(encoded, expected.size()))
+        << "length " << length;
+
+    uint8_t decoded[MaxDecodedSize(EncodedSize(data.size()))];
+    ASSERT_EQ(length, Decode(expected, decoded));
+    EXPECT_EQ(0, std::memcmp(decoded, data.data(), length))
+        << "length " << length;
+  }
+}
+
 TEST(Base64, IsValid_Ok) {
   EXPECT_TRUE(IsValid(std::string_view(kBase64, 4)));
   EXPECT_TRUE(IsValid(std::string_view(kBase64, 8)));
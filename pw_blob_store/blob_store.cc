@@ -173,6 +173,9 @@ StatusWithSize BlobStore::ResumeWrite() {
 
   flash_address_ = written_bytes_on_resume;
   write_address_ = written_bytes_on_resume;
+  // As when the write was started, the rest of the partition is expected to be
+  // erased.
+  erased_address_ = partition_.size_bytes();
   valid_data_ = true;
   writer_open_ = true;
 
@@ -258,43 +261,48 @@ Status BlobStore::Write(ConstByteSpan data) {
     return Status::DataLoss();
   }
 
-  // Write in (up to) 3 steps:
-  // 1) Finish filling write buffer and if full write it to flash.
-  // 2) Write as many whole block-sized chunks as the data has remaining
-  //    after 1.
-  // 3) Put any remaining bytes less than flash write size in the write buffer.
+  // Small writes are coalesced in the write buffer, so that flash is programmed
+  // with as many whole flash_write_size_bytes_ chunks at a time as the buffer
+  // holds rather than one chunk at a time.
+  const size_t coalesce_size_bytes =
+      (write_buffer_.size_bytes() / flash_write_size_bytes_) *
+      flash_write_size_bytes_;
 
-  // Step 1) If there is any data in the write buffer, finish filling write
-  //         buffer and if full write it to flash.
+  // Write in (up to) 3 steps:
+  // 1) Add to the write buffer. If the data does not fit, fill the buffer up to
+  //    a flash write size boundary and write it to flash.
+  // 2) Write as many block-sized chunks as the data has remaining after 1,
+  //    unless they fit in the write buffer.
+  // 3) Put any remaining bytes in the write buffer.
+
+  // Step 1) If there is any data in the write buffer, add to it and if the data
+  //         does not fit write the buffer to flash.
   if (!WriteBufferEmpty()) {
     PW_DCHECK(!write_buffer_.empty());
     size_t bytes_in_buffer = WriteBufferBytesUsed();
+    PW_CHECK_UINT_GT(coalesce_size_bytes, bytes_in_buffer);
 
-    // Non-deferred writes only use the first flash_write_size_bytes_ of the
-    // write buffer to buffer writes less than flash_write_size_bytes_.
-    PW_CHECK_UINT_GT(flash_write_size_bytes_, bytes_in_buffer);
-
-    // Not using WriteBufferBytesFree() because non-deferred writes (which
-    // is this method) only use the first flash_write_size_bytes_ of the write
-    // buffer.
-    size_t buffer_remaining = flash_write_size_bytes_ - bytes_in_buffer;
+    if (data.size_bytes() < coalesce_size_bytes - bytes_in_buffer) {
+      std::memcpy(write_buffer_.data() + bytes_in_buffer,
+                  data.data(),
+                  data.size_bytes());
+      write_address_ += data.size_bytes();
+      return OkStatus();
+    }
 
-    // Add bytes up to filling the flash write size.
-    size_t add_bytes = std::min(buffer_remaining, data.size_bytes());
+    // Only fill up to the next flash write size boundary, the rest of the data
+    // is written directly by step 2.
+    const size_t boundary_bytes =
+        ((bytes_in_buffer + flash_write_size_bytes_ - 1) /
+         flash_write_size_bytes_) *
+        flash_write_size_bytes_;
+    const size_t add_bytes = boundary_bytes - bytes_in_buffer;
+    PW_DCHECK_UINT_LE(add_bytes, data.size_bytes());
     std::memcpy(write_buffer_.data() + bytes_in_buffer, data.data(), add_bytes);
     write_address_ += add_bytes;
-    bytes_in_buffer += add_bytes;
     data = data.subspan(add_bytes);
 
-    if (bytes_in_buffer != flash_write_size_bytes_) {
-      // If there was not enough bytes to finish filling the write buffer, there
-      // should not be any bytes left.
-      PW_DCHECK(data.size_bytes() == 0);
-      return OkStatus();
-    }
-
-    // The write buffer is full, flush to flash.
-    if (!CommitToFlash(write_buffer_.first(flash_write_size_bytes_)).ok()) {
+    if (!CommitToFlash(write_buffer_.first(boundary_bytes)).ok()) {
       return Status::DataLoss();
     }
   }
@@ -303,15 +311,12 @@ Status BlobStore::Write(ConstByteSpan data) {
   // This invariant is checked as part of of steps 2 & 3.
 
   // Step 2) Write as many block-sized chunks as the data has remaining after
-  //         step 1.
+  //         step 1, unless all of the data fits in the write buffer.
   PW_DCHECK(WriteBufferEmpty());
 
-  const size_t final_partial_write_size_bytes =
-      data.size_bytes() % flash_write_size_bytes_;
-
-  if (data.size_bytes() >= flash_write_size_bytes_) {
+  if (data.size_bytes() >= coalesce_size_bytes) {
     const size_t write_size_bytes =
-        data.size_bytes() - final_partial_write_size_bytes;
+        data.size_bytes() - (data.size_bytes() % flash_write_size_bytes_);
     write_address_ += write_size_bytes;
     if (!CommitToFlash(data.first(write_size_bytes)).ok()) {
       return Status::DataLoss();
@@ -323,8 +328,8 @@ Status BlobStore::Write(ConstByteSpan data) {
   //         the begining of the buffer, since it must be empty if there are
   //         still bytes due to step 1 either cleaned out the buffer or didn't
   //         have any more data to write.
-  if (final_partial_write_size_bytes > 0) {
-    PW_DCHECK_INT_LT(data.size_bytes(), flash_write_size_bytes_);
+  if (data.size_bytes() > 0) {
+    PW_DCHECK_INT_LT(data.size_bytes(), coalesce_size_bytes);
     PW_DCHECK(!write_buffer_.empty());
 
     // Don't need to DCHECK that buffer is empty, nothing writes to it since the
@@ -428,6 +433,12 @@ Status BlobStore::CommitToFlash(ConstByteSpan source, size_t data_bytes) {
     data_bytes = source.size_bytes();
   }
 
+  if (Status status = EraseUntil(flash_address_ + source.size_bytes());
+      !status.ok()) {
+    valid_data_ = false;
+    return status;
+  }
+
   flash_erased_ = false;
   StatusWithSize result = partition_.Write(flash_address_, source);
   flash_address_ += data_bytes;
@@ -456,13 +467,53 @@ size_t BlobStore::WriteBufferBytesFree() const {
 }
 
 Status BlobStore::EraseIfNeeded() {
-  if (flash_address_ == 0) {
+  if (flash_address_ == 0 && erased_address_ == 0) {
     // Always just erase. Erase is smart enough to only erase if needed.
     return Erase();
   }
+  // Either the partition was already erased or erase-ahead is in use, in
+  // which case CommitToFlash() erases any sectors not yet erased ahead.
+  return OkStatus();
+}
+
+Status BlobStore::EraseUntil(kvs::FlashPartition::Address end_address) {
+  if (end_address <= erased_address_) {
+    return OkStatus();
+  }
+
+  const size_t sector_size = partition_.sector_size_bytes();
+  const size_t sector_count =
+      (end_address - erased_address_ + sector_size - 1) / sector_size;
+  PW_TRY(partition_.Erase(erased_address_, sector_count));
+  erased_address_ += sector_count * sector_size;
+
+  if (flash_address_ == 0) {
+    // As with a full erase, a new blob is valid as soon as flash is erased.
+    valid_data_ = true;
+    flash_erased_ = erased_address_ == partition_.size_bytes();
+  }
   return OkStatus();
 }
 
+StatusWithSize BlobStore::EraseAhead(size_t sector_count) {
+  if (!ValidToWrite()) {
+    return StatusWithSize::DataLoss();
+  }
+
+  const size_t sector_size = partition_.sector_size_bytes();
+  const size_t sectors_remaining =
+      (partition_.size_bytes() - erased_address_) / sector_size;
+  sector_count = std::min(sector_count, sectors_remaining);
+  if (sector_count == 0) {
+    return StatusWithSize(0);
+  }
+
+  PW_TRY_WITH_SIZE(EraseUntil(erased_address_ + sector_count * sector_size));
+  PW_LOG_DEBUG("Blob erased ahead to %u bytes",
+               static_cast<unsigned>(erased_address_));
+  return StatusWithSize(sector_count);
+}
+
 StatusWithSize BlobStore::Read(size_t offset, ByteSpan dest) const {
   if (!HasData()) {
     return StatusWithSize::FailedPrecondition();
@@ -518,6 +569,7 @@ Status BlobStore::Erase() {
   PW_TRY(partition_.Erase());
 
   flash_erased_ = true;
+  erased_address_ = partition_.size_bytes();
 
   // Blob data is considered valid as soon as the flash is erased. Even though
   // there are 0 bytes written, they are valid.
@@ -526,9 +578,15 @@ Status BlobStore::Erase() {
 }
 
 Status BlobStore::Invalidate() {
+  if (flash_address_ != 0) {
+    // The written data is not erased, so the erased region no longer follows
+    // the start of the blob.
+    erased_address_ = 0;
+  }
+
   // Blob data is considered valid if the flash is erased. Even though
   // there are 0 bytes written, they are valid.
-  valid_data_ = flash_erased_;
+  valid_data_ = flash_erased_ || erased_address_ != 0;
   ResetChecksum();
   write_address_ = 0;
   flash_address_ = 0;
@@ -221,6 +221,60 @@ TEST_F(BlobStoreTest, OversizedWriteBuffer) {
   VerifyBlob(blob, original_source.size_bytes());
 }
 
+// Write operations smaller than flash_write_size_bytes are coalesced in the
+// write buffer until it is full.
+TEST_F(BlobStoreTest, CoalescesSmallWrites) {
+  constexpr size_t kFlashWriteSize = 64;
+  constexpr size_t kBufferSize = 4 * kFlashWriteSize;
+  constexpr size_t kWriteSize = 8;
+  if (kFlashAlignment > kFlashWriteSize) {
+    return;
+  }
+  kvs::ChecksumCrc16 checksum;
+
+  InitSourceBufferToRandom(0x5eed);
+  ConstByteSpan write_data = span(source_buffer_);
+
+  EXPECT_EQ(OkStatus(), partition_.Erase());
+
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kFlashWriteSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  EXPECT_EQ(OkStatus(), writer.Open());
+
+  // Nothing is written to flash until the write buffer is full.
+  for (size_t i = 0; i < kBufferSize - kWriteSize; i += kWriteSize) {
+    ASSERT_EQ(OkStatus(), writer.Write(write_data.first(kWriteSize)));
+    write_data = write_data.subspan(kWriteSize);
+  }
+  EXPECT_EQ(0u, partition_.EndOfWrittenData().size());
+
+  ASSERT_EQ(OkStatus(), writer.Write(write_data.first(kWriteSize)));
+  write_data = write_data.subspan(kWriteSize);
+  EXPECT_EQ(kBufferSize, partition_.EndOfWrittenData().size());
+  VerifyFlash(flash_.buffer().first(kBufferSize));
+
+  // A write that does not fit in the write buffer goes directly to flash,
+  // except for the unaligned remainder.
+  ASSERT_EQ(OkStatus(), writer.Write(write_data.first(kWriteSize)));
+  write_data = write_data.subspan(kWriteSize);
+  const size_t large_write_size = kBufferSize + kFlashWriteSize + kWriteSize;
+  ASSERT_EQ(OkStatus(), writer.Write(write_data.first(large_write_size)));
+  write_data = write_data.subspan(large_write_size);
+  EXPECT_EQ(2 * kBufferSize + kFlashWriteSize,
+            partition_.EndOfWrittenData().size());
+
+  while (write_data.size_bytes() > 0) {
+    ASSERT_EQ(OkStatus(), writer.Write(write_data.first(kWriteSize)));
+    write_data = write_data.subspan(kWriteSize);
+  }
+  EXPECT_EQ(OkStatus(), writer.Close());
+
+  VerifyBlob(blob, source_buffer_.size());
+}
+
 TEST_F(BlobStoreTest, Reader_ConservativeLimits) {
   InitSourceBufferToRandom(0x11309);
   WriteTestBlock();
@@ -870,6 +924,80 @@ TEST_F(BlobStoreTest, MultipleWrites) {
   WriteTestBlock();
 }
 
+TEST_F(BlobStoreTest, EraseAheadErasesOnlyWhatIsNeeded) {
+  // Start with flash that is not erased.
+  std::array<std::byte, kBlobDataSize> not_erased;
+  not_erased.fill(std::byte{0x5a});
+  InitFlashTo(not_erased);
+  InitSourceBufferToRandom(0x8af5);
+
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 16;
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  EXPECT_EQ(Status::FailedPrecondition(), writer.EraseAhead(1).status());
+  EXPECT_EQ(OkStatus(), writer.Open());
+
+  StatusWithSize erase_sws = writer.EraseAhead(2);
+  EXPECT_EQ(OkStatus(), erase_sws.status());
+  EXPECT_EQ(2u, erase_sws.size());
+  EXPECT_EQ(std::byte{0x5a}, flash_.buffer()[2 * kSectorSize]);
+
+  // Writes within the erased sectors don't erase any more.
+  ConstByteSpan write_data = span(source_buffer_);
+  ASSERT_EQ(OkStatus(), writer.Write(write_data.first(2 * kSectorSize)));
+  write_data = write_data.subspan(2 * kSectorSize);
+  EXPECT_EQ(std::byte{0x5a}, flash_.buffer()[2 * kSectorSize]);
+
+  // Writes past the erased sectors erase the sectors they need.
+  ASSERT_EQ(OkStatus(), writer.Write(write_data.first(kSectorSize / 2)));
+  write_data = write_data.subspan(kSectorSize / 2);
+  EXPECT_EQ(std::byte{0x5a}, flash_.buffer()[3 * kSectorSize]);
+
+  erase_sws = writer.EraseAhead(kSectorCount);
+  EXPECT_EQ(OkStatus(), erase_sws.status());
+  EXPECT_EQ(kSectorCount - 3, erase_sws.size());
+  erase_sws = writer.EraseAhead(1);
+  EXPECT_EQ(OkStatus(), erase_sws.status());
+  EXPECT_EQ(0u, erase_sws.size());
+
+  ASSERT_EQ(OkStatus(), writer.Write(write_data));
+  EXPECT_EQ(OkStatus(), writer.Close());
+
+  VerifyBlob(blob, kBlobDataSize);
+}
+
+TEST_F(BlobStoreTest, DiscardAfterEraseAhead) {
+  InitSourceBufferToRandom(0x6e1c);
+
+  kvs::ChecksumCrc16 checksum;
+  constexpr size_t kBufferSize = 16;
+  BlobStoreBuffer<kBufferSize> blob(
+      kBlobTitle, partition_, &checksum, kvs::TestKvs(), kBufferSize);
+  EXPECT_EQ(OkStatus(), blob.Init());
+
+  BlobStore::BlobWriterWithBuffer writer(blob);
+  EXPECT_EQ(OkStatus(), writer.Open());
+
+  // Discarding a blob that has data requires erasing it again.
+  EXPECT_EQ(OkStatus(), writer.EraseAhead(1).status());
+  ASSERT_EQ(OkStatus(), writer.Write(span(source_buffer_).first(kSectorSize)));
+  EXPECT_EQ(OkStatus(), writer.Discard());
+  EXPECT_EQ(OkStatus(), writer.EraseAhead(1).status());
+
+  // Discarding an empty blob keeps the erased sectors.
+  EXPECT_EQ(OkStatus(), writer.Discard());
+  EXPECT_EQ(1u, writer.EraseAhead(1).size());
+
+  ASSERT_EQ(OkStatus(), writer.Write(source_buffer_));
+  EXPECT_EQ(OkStatus(), writer.Close());
+
+  VerifyBlob(blob, kBlobDataSize);
+}
+
 TEST_F(BlobStoreTest, ResumeEmptyAbandonBlob) {
   InitSourceBufferToRandom(0x11309);
 
@@ -165,6 +165,26 @@ class BlobStore {
       return open_ ? store_.Erase() : Status::FailedPrecondition();
     }
 
+    // Erase up to sector_count sectors past the data written so far, so that
+    // later writes into them do not wait for an erase. Intended to be called
+    // while the writer is otherwise idle, for example between the chunks of a
+    // transfer. Like all writer methods, it must not be called concurrently
+    // with other BlobStore operations.
+    //
+    // Without erase-ahead, the first write of a blob erases the whole
+    // partition. Once erase-ahead has been used, writes instead erase only the
+    // sectors they need that were not already erased ahead. Returns:
+    //
+    // OK, size - number of sectors erased. Zero if the rest of the partition
+    //     is already erased.
+    // FAILED_PRECONDITION - not open.
+    // DATA_LOSS - previous write error, the blob is not valid to write to.
+    // [error status] - flash erase failed.
+    StatusWithSize EraseAhead(size_t sector_count) {
+      return open_ ? store_.EraseAhead(sector_count)
+                   : StatusWithSize::FailedPrecondition();
+    }
+
     // Discard the current blob write and keep the writer in the opened state,
     // ready to start a new/clean blob write. Any written bytes to this point
     // are considered invalid and discarded.
@@ -420,8 +440,8 @@ class BlobStore {
   // checksum_algo - Optional checksum for blob integrity checking. Use nullptr
   //     for no check.
   // kvs - KVS used for storing blob metadata.
-  // write_buffer - Used for buffering writes. Needs to be at least
-  //     flash_write_size_bytes.
+  // write_buffer - Used for buffering and coalescing writes. Needs to be at
+  //     least flash_write_size_bytes.
   // flash_write_size_bytes - Size in bytes to use for flash write operations.
   //     This should be chosen to balance optimal write size and required buffer
   //     size. Must be greater than or equal to flash write alignment, less than
@@ -445,6 +465,7 @@ class BlobStore {
         readers_open_(0),
         write_address_(0),
         flash_address_(0),
+        erased_address_(0),
         file_name_length_(0) {}
 
   BlobStore(const BlobStore&) = delete;
@@ -503,7 +524,9 @@ class BlobStore {
 
   // Write/append data to the in-progress blob write. Data is written
   // sequentially, with each append added directly after the previous. Data is
-  // not guaranteed to be fully written out to storage on Write return. Returns:
+  // not guaranteed to be fully written out to storage on Write return: data
+  // that fits in the write buffer is coalesced there until the buffer is full.
+  // Returns:
   //
   // OK - successful write/enqueue of data.
   // RESOURCE_EXHAUSTED - unable to write all of requested data at this time. No
@@ -575,6 +598,12 @@ class BlobStore {
 
   Status EraseIfNeeded();
 
+  // Erase sectors starting at erased_address_ until at least end_address is
+  // erased.
+  Status EraseUntil(kvs::FlashPartition::Address end_address);
+
+  StatusWithSize EraseAhead(size_t sector_count);
+
   // Read valid data. Attempts to read the lesser of output.size_bytes() or
   // available bytes worth of data. Returns:
   //
@@ -672,6 +701,10 @@ class BlobStore {
   // bytes is write_address_ - flash_address_.
   kvs::FlashPartition::Address flash_address_;
 
+  // End of the erased region that follows flash_address_, always at a sector
+  // boundary. Zero when no part of the partition is known to be erased.
+  kvs::FlashPartition::Address erased_address_;
+
   // Length of the stored blob's filename.
   size_t file_name_length_;
 };
@@ -685,8 +718,8 @@ class BlobStore {
 // checksum_algo - Optional checksum for blob integrity checking. Use nullptr
 //     for no check.
 // kvs - KVS used for storing blob metadata.
-// write_buffer - Used for buffering writes. Needs to be at least
-//     flash_write_size_bytes.
+// write_buffer - Used for buffering and coalescing writes. Needs to be at
+//     least flash_write_size_bytes.
 // flash_write_size_bytes - Size in bytes to use for flash write operations.
 //     This should be chosen to balance optimal write size and required buffer
 //     size. Must be greater than or equal to flash write alignment, less than
@@ -114,6 +114,16 @@ class Controller {
   // Sends an ACL data packet to the controller.
   virtual void SendAclData(span<const std::byte> data) = 0;
 
+  // Sends several ACL data packets to the controller, in order. Transports
+  // with a high per-call overhead, such as USB and UART, should override this
+  // to submit all of the packets at once. The default implementation calls
+  // `SendAclData` for each packet.
+  virtual void SendAclDataBatch(span<const span<const std::byte>> packets) {
+    for (span<const std::byte> packet : packets) {
+      SendAclData(packet);
+    }
+  }
+
   // Sends a SCO data packet to the controller.
   virtual void SendScoData(span<const std::byte> data) = 0;
 
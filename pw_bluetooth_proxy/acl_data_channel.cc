@@ -15,6 +15,7 @@
 #include "pw_bluetooth_proxy/acl_data_channel.h"
 
 #include <cstdint>
+#include <optional>
 
 #include "lib/stdcompat/utility.h"
 #include "pw_bluetooth/hci_data.emb.h"
@@ -80,6 +81,13 @@ AclDataChannel::ProcessSpecificLEReadBufferSizeCommandCompleteEvent<
 
 void AclDataChannel::HandleNumberOfCompletedPacketsEvent(
     H4PacketWithHci&& h4_packet) {
+  if (!HasActiveConnections()) {
+    // None of the completed packets can be the proxy's, so the event is passed
+    // on without being parsed.
+    hci_transport_.SendToHost(std::move(h4_packet));
+    return;
+  }
+
   emboss::NumberOfCompletedPacketsEventWriter nocp_event =
       MakeEmboss<emboss::NumberOfCompletedPacketsEventWriter>(
           h4_packet.GetHciSpan());
@@ -132,10 +140,15 @@ void AclDataChannel::HandleNumberOfCompletedPacketsEvent(
 
 void AclDataChannel::HandleDisconnectionCompleteEvent(
     H4PacketWithHci&& h4_packet) {
-  emboss::DisconnectionCompleteEventWriter dc_event =
-      MakeEmboss<emboss::DisconnectionCompleteEventWriter>(
+  if (!HasActiveConnections()) {
+    hci_transport_.SendToHost(std::move(h4_packet));
+    return;
+  }
+
+  std::optional<emboss::DisconnectionCompleteEventView> dc_event =
+      MakeFixedSizeEmboss<emboss::DisconnectionCompleteEventView>(
           h4_packet.GetHciSpan());
-  if (!dc_event.IsComplete()) {
+  if (!dc_event) {
     PW_LOG_ERROR(
         "Buffer is too small for DISCONNECTION_COMPLETE event. So will not "
         "process.");
@@ -144,15 +157,15 @@ void AclDataChannel::HandleDisconnectionCompleteEvent(
   }
   credit_allocation_mutex_.lock();
 
-  uint16_t conn_handle = dc_event.connection_handle().Read();
+  uint16_t conn_handle = dc_event->connection_handle().Read();
   AclConnection* connection_ptr = FindConnection(conn_handle);
   if (connection_ptr && connection_ptr->num_pending_packets > 0) {
-    emboss::StatusCode status = dc_event.status().Read();
+    emboss::StatusCode status = dc_event->status().Read();
     if (status == emboss::StatusCode::SUCCESS) {
       PW_LOG_WARN(
           "Proxy viewed disconnect (reason: %#.2hhx) for connection %#.4hx "
           "with packets in flight. Releasing associated credits",
-          cpp23::to_underlying(dc_event.reason().Read()),
+          cpp23::to_underlying(dc_event->reason().Read()),
           conn_handle);
       proxy_pending_le_acl_packets_ -= connection_ptr->num_pending_packets;
       active_connections_.erase(connection_ptr);
@@ -181,32 +194,52 @@ uint16_t AclDataChannel::GetNumFreeLeAclPackets() const {
 }
 
 bool AclDataChannel::SendAcl(H4PacketWithH4&& h4_packet) {
+  return SendAclBatch(span(&h4_packet, 1)) == 1;
+}
+
+size_t AclDataChannel::SendAclBatch(span<H4PacketWithH4> h4_packets) {
   credit_allocation_mutex_.lock();
-  if (proxy_pending_le_acl_packets_ == proxy_max_le_acl_packets_) {
-    credit_allocation_mutex_.unlock();
-    return false;
-  }
-  ++proxy_pending_le_acl_packets_;
-
-  emboss::AclDataFrameHeaderView acl_view =
-      MakeEmboss<emboss::AclDataFrameHeaderView>(h4_packet.GetHciSpan());
-  if (!acl_view.Ok()) {
-    PW_LOG_ERROR("Received invalid ACL packet. So will not send.");
-    credit_allocation_mutex_.unlock();
-    return false;
-  }
-  uint16_t handle = acl_view.handle().Read();
+  size_t num_sent = 0;
+  for (H4PacketWithH4& h4_packet : h4_packets) {
+    if (proxy_pending_le_acl_packets_ == proxy_max_le_acl_packets_) {
+      break;
+    }
+
+    std::optional<emboss::AclDataFrameHeaderView> acl_view =
+        MakeFixedSizeEmboss<emboss::AclDataFrameHeaderView>(
+            h4_packet.GetHciSpan());
+    if (!acl_view) {
+      PW_LOG_ERROR("Received invalid ACL packet. So will not send.");
+      break;
+    }
+    uint16_t handle = acl_view->handle().Read();
 
-  AclConnection* connection_ptr = FindConnection(handle);
-  if (!connection_ptr) {
-    active_connections_.push_back({handle, /*num_pending_packets=*/1});
-  } else {
+    AclConnection* connection_ptr = FindConnection(handle);
+    if (!connection_ptr) {
+      if (active_connections_.full()) {
+        PW_LOG_ERROR(
+            "Proxy is already tracking the maximum number of connections. So "
+            "will not send.");
+        break;
+      }
+      active_connections_.push_back({handle, /*num_pending_packets=*/0});
+      connection_ptr = &active_connections_.back();
+    }
     ++connection_ptr->num_pending_packets;
+    ++proxy_pending_le_acl_packets_;
+
+    hci_transport_.SendToController(std::move(h4_packet));
+    ++num_sent;
   }
+  credit_allocation_mutex_.unlock();
+  return num_sent;
+}
 
-  hci_transport_.SendToController(std::move(h4_packet));
+bool AclDataChannel::HasActiveConnections() const {
+  credit_allocation_mutex_.lock();
+  bool has_active_connections = !active_connections_.empty();
   credit_allocation_mutex_.unlock();
-  return true;
+  return has_active_connections;
 }
 
 AclDataChannel::AclConnection* AclDataChannel::FindConnection(uint16_t handle) {
@@ -58,5 +58,42 @@ TEST(EmbossUtilTest, MakeWriterFromSubspan) {
   EXPECT_EQ(view.payload().Read(), 0x04);
 }
 
+TEST(EmbossUtilTest, FixedSizeIsCompileTimeConstant) {
+  // A 3-byte command header and a 1-byte payload.
+  static_assert(EmbossFixedSizeInBytes<emboss::TestCommandPacketView>() == 4);
+  static_assert(EmbossFixedSizeInBytes<emboss::TestCommandPacketWriter>() ==
+                EmbossFixedSizeInBytes<emboss::TestCommandPacketView>());
+}
+
+TEST(EmbossUtilTest, MakeFixedSizeViewFromSpan) {
+  std::array<uint8_t, 4> buffer = {0x00, 0x01, 0x02, 0x03};
+  std::optional<emboss::TestCommandPacketView> view =
+      MakeFixedSizeEmboss<emboss::TestCommandPacketView>(pw::span(buffer));
+  ASSERT_TRUE(view.has_value());
+  EXPECT_TRUE(view->IsComplete());
+  EXPECT_EQ(view->payload().Read(), 0x03);
+}
+
+TEST(EmbossUtilTest, MakeFixedSizeWriterFromLargerSpan) {
+  std::array<uint8_t, 6> buffer = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05};
+  std::optional<emboss::TestCommandPacketWriter> view =
+      MakeFixedSizeEmboss<emboss::TestCommandPacketWriter>(pw::span(buffer));
+  ASSERT_TRUE(view.has_value());
+  EXPECT_EQ(view->BackingStorage().SizeInBytes(), 4u);
+  view->payload().Write(0x7f);
+  EXPECT_EQ(buffer[3], 0x7f);
+  EXPECT_EQ(buffer[4], 0x04);
+}
+
+TEST(EmbossUtilTest, MakeFixedSizeViewFromShortSpan) {
+  std::array<uint8_t, 3> buffer = {0x00, 0x01, 0x02};
+  EXPECT_FALSE(
+      MakeFixedSizeEmboss<emboss::TestCommandPacketView>(pw::span(buffer))
+          .has_value());
+  EXPECT_FALSE(MakeFixedSizeEmboss<emboss::TestCommandPacketView>(
+                   pw::span(buffer).first(0))
+                   .has_value());
+}
+
 }  // namespace
 }  // namespace pw::bluetooth::proxy
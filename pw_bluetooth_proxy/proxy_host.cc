@@ -14,6 +14,9 @@
 
 #include "pw_bluetooth_proxy/proxy_host.h"
 
+#include <optional>
+
+#include "lib/stdcompat/utility.h"
 #include "pw_assert/check.h"  // IWYU pragma: keep
 #include "pw_bluetooth/hci_common.emb.h"
 #include "pw_bluetooth/hci_h4.emb.h"
@@ -23,6 +26,20 @@
 
 namespace pw::bluetooth::proxy {
 
+namespace {
+
+// Returns true if `event_code` identifies an event that the proxy processes.
+constexpr bool IsProcessedEvent(uint8_t event_code) {
+  return event_code == cpp23::to_underlying(
+                           emboss::EventCode::NUMBER_OF_COMPLETED_PACKETS) ||
+         event_code ==
+             cpp23::to_underlying(emboss::EventCode::DISCONNECTION_COMPLETE) ||
+         event_code ==
+             cpp23::to_underlying(emboss::EventCode::COMMAND_COMPLETE);
+}
+
+}  // namespace
+
 std::array<containers::Pair<uint8_t*, bool>, ProxyHost::kNumH4Buffs>
 ProxyHost::InitOccupiedMap() {
   std::array<containers::Pair<uint8_t*, bool>, kNumH4Buffs> arr;
@@ -49,8 +66,17 @@ void ProxyHost::HandleH4HciFromHost(H4PacketWithH4&& h4_packet) {
 
 void ProxyHost::HandleH4HciFromController(H4PacketWithHci&& h4_packet) {
   pw::span<uint8_t> hci_buffer = h4_packet.GetHciSpan();
-  auto event = MakeEmboss<emboss::EventHeaderView>(hci_buffer);
-  if (!event.IsComplete()) {
+  // Fast path: most traffic from the controller is not processed by the proxy,
+  // so recognize it from the H4 type and event code alone and pass it on.
+  if (h4_packet.GetH4Type() != emboss::H4PacketType::EVENT ||
+      (!hci_buffer.empty() && !IsProcessedEvent(hci_buffer[0]))) {
+    hci_transport_.SendToHost(std::move(h4_packet));
+    return;
+  }
+
+  std::optional<emboss::EventHeaderView> event =
+      MakeFixedSizeEmboss<emboss::EventHeaderView>(hci_buffer);
+  if (!event) {
     PW_LOG_ERROR(
         "Buffer is too small for EventHeader. So will pass on to host without "
         "processing.");
@@ -60,7 +86,7 @@ void ProxyHost::HandleH4HciFromController(H4PacketWithHci&& h4_packet) {
 
   PW_MODIFY_DIAGNOSTICS_PUSH();
   PW_MODIFY_DIAGNOSTIC(ignored, "-Wswitch-enum");
-  switch (event.event_code_enum().Read()) {
+  switch (event->event_code_enum().Read()) {
     case emboss::EventCode::NUMBER_OF_COMPLETED_PACKETS: {
       acl_data_channel_.HandleNumberOfCompletedPacketsEvent(
           std::move(h4_packet));
@@ -84,9 +110,9 @@ void ProxyHost::HandleH4HciFromController(H4PacketWithHci&& h4_packet) {
 
 void ProxyHost::HandleCommandCompleteEvent(H4PacketWithHci&& h4_packet) {
   pw::span<uint8_t> hci_buffer = h4_packet.GetHciSpan();
-  emboss::CommandCompleteEventView command_complete_event =
-      MakeEmboss<emboss::CommandCompleteEventView>(hci_buffer);
-  if (!command_complete_event.IsComplete()) {
+  std::optional<emboss::CommandCompleteEventView> command_complete_event =
+      MakeFixedSizeEmboss<emboss::CommandCompleteEventView>(hci_buffer);
+  if (!command_complete_event) {
     PW_LOG_ERROR(
         "Buffer is too small for COMMAND_COMPLETE event. So will not process.");
     hci_transport_.SendToHost(std::move(h4_packet));
@@ -95,31 +121,31 @@ void ProxyHost::HandleCommandCompleteEvent(H4PacketWithHci&& h4_packet) {
 
   PW_MODIFY_DIAGNOSTICS_PUSH();
   PW_MODIFY_DIAGNOSTIC(ignored, "-Wswitch-enum");
-  switch (command_complete_event.command_opcode_enum().Read()) {
+  switch (command_complete_event->command_opcode_enum().Read()) {
     case emboss::OpCode::LE_READ_BUFFER_SIZE_V1: {
-      auto read_event =
-          MakeEmboss<emboss::LEReadBufferSizeV1CommandCompleteEventWriter>(
-              hci_buffer);
-      if (!read_event.IsComplete()) {
+      auto read_event = MakeFixedSizeEmboss<
+          emboss::LEReadBufferSizeV1CommandCompleteEventWriter>(hci_buffer);
+      if (!read_event) {
         PW_LOG_ERROR(
             "Buffer is too small for LE_READ_BUFFER_SIZE_V1 command complete "
             "event. So will not process.");
         return;
       }
-      acl_data_channel_.ProcessLEReadBufferSizeCommandCompleteEvent(read_event);
+      acl_data_channel_.ProcessLEReadBufferSizeCommandCompleteEvent(
+          *read_event);
       break;
     }
     case emboss::OpCode::LE_READ_BUFFER_SIZE_V2: {
-      auto read_event =
-          MakeEmboss<emboss::LEReadBufferSizeV2CommandCompleteEventWriter>(
-              hci_buffer);
-      if (!read_event.IsComplete()) {
+      auto read_event = MakeFixedSizeEmboss<
+          emboss::LEReadBufferSizeV2CommandCompleteEventWriter>(hci_buffer);
+      if (!read_event) {
         PW_LOG_ERROR(
             "Buffer is too small for LE_READ_BUFFER_SIZE_V2 command complete "
             "event. So will not process.");
         return;
       }
-      acl_data_channel_.ProcessLEReadBufferSizeCommandCompleteEvent(read_event);
+      acl_data_channel_.ProcessLEReadBufferSizeCommandCompleteEvent(
+          *read_event);
       break;
     }
     default:
@@ -20,10 +20,13 @@
 #include "pw_bluetooth/att.emb.h"
 #include "pw_bluetooth/hci_commands.emb.h"
 #include "pw_bluetooth/hci_common.emb.h"
+#include "pw_bluetooth/hci_data.emb.h"
 #include "pw_bluetooth/hci_events.emb.h"
 #include "pw_bluetooth/hci_h4.emb.h"
+#include "pw_bluetooth_proxy/acl_data_channel.h"
 #include "pw_bluetooth_proxy/emboss_util.h"
 #include "pw_bluetooth_proxy/h4_packet.h"
+#include "pw_bluetooth_proxy/hci_transport.h"
 #include "pw_containers/flat_map.h"
 #include "pw_function/function.h"
 #include "pw_unit_test/framework.h"  // IWYU pragma: keep
@@ -324,6 +327,58 @@ TEST(PassthroughTest, ToHostPassesEqualCommandComplete) {
   EXPECT_EQ(send_capture.sends_called, 1);
 }
 
+// ACL data from the controller is passed on unprocessed, even if its contents
+// happen to look like an event that the proxy processes.
+TEST(PassthroughTest, ToHostAclDataIsNotProcessedAsEvent) {
+  constexpr uint16_t kConnectionHandle = 0x123;
+  struct {
+    uint8_t sends_called = 0;
+  } capture;
+
+  pw::Function<void(H4PacketWithHci && packet)> send_to_host_fn(
+      [&capture](H4PacketWithHci&& packet) {
+        capture.sends_called++;
+        if (packet.GetH4Type() != emboss::H4PacketType::ACL_DATA) {
+          return;
+        }
+        auto view = MakeEmboss<emboss::NumberOfCompletedPacketsEventView>(
+            packet.GetHciSpan());
+        EXPECT_EQ(view.nocp_data()[0].num_completed_packets().Read(), 1);
+      });
+  pw::Function<void(H4PacketWithH4 && packet)> send_to_controller_fn(
+      []([[maybe_unused]] H4PacketWithH4&& packet) {});
+
+  ProxyHost proxy = ProxyHost(
+      std::move(send_to_host_fn), std::move(send_to_controller_fn), 2);
+  SendReadBufferResponseFromController(proxy, 2);
+  EXPECT_EQ(capture.sends_called, 1);
+
+  std::array<uint8_t, 1> attribute_value = {0};
+  EXPECT_TRUE(
+      proxy.SendGattNotify(kConnectionHandle, 1, pw::span(attribute_value))
+          .ok());
+  EXPECT_EQ(proxy.GetNumFreeLeAclPackets(), 1);
+
+  std::array<
+      uint8_t,
+      emboss::NumberOfCompletedPacketsEvent::MinSizeInBytes() +
+          emboss::NumberOfCompletedPacketsEventData::IntrinsicSizeInBytes()>
+      hci_arr;
+  H4PacketWithHci h4_packet{emboss::H4PacketType::ACL_DATA, hci_arr};
+  auto view = MakeEmboss<emboss::NumberOfCompletedPacketsEventWriter>(
+      h4_packet.GetHciSpan());
+  view.header().event_code_enum().Write(
+      emboss::EventCode::NUMBER_OF_COMPLETED_PACKETS);
+  view.num_handles().Write(1);
+  view.nocp_data()[0].connection_handle().Write(kConnectionHandle);
+  view.nocp_data()[0].num_completed_packets().Write(1);
+  proxy.HandleH4HciFromController(std::move(h4_packet));
+
+  // Packet was passed on and no credits were reclaimed.
+  EXPECT_EQ(capture.sends_called, 2);
+  EXPECT_EQ(proxy.GetNumFreeLeAclPackets(), 1);
+}
+
 // ########## BadPacketTest
 // The proxy should not affect buffers it can't process (it should just pass
 // them on).
@@ -1838,5 +1893,90 @@ TEST(MultiSendTest, ResetClearsBuffOccupiedFlags) {
   }
 }
 
+// ########## SendAclBatchTest
+
+// Reserve `num_credits` LE ACL send credits for `acl_data_channel`.
+void ReserveChannelLeAclCredits(AclDataChannel& acl_data_channel,
+                         uint16_t num_credits) {
+  std::array<
+      uint8_t,
+      emboss::LEReadBufferSizeV2CommandCompleteEventWriter::SizeInBytes()>
+      hci_arr;
+  H4PacketWithHci h4_packet{emboss::H4PacketType::UNKNOWN, hci_arr};
+  emboss::LEReadBufferSizeV2CommandCompleteEventWriter view =
+      CreateAndPopulateToHostEventView<
+          emboss::LEReadBufferSizeV2CommandCompleteEventWriter>(
+          h4_packet, emboss::EventCode::COMMAND_COMPLETE);
+  view.command_complete().command_opcode_enum().Write(
+      emboss::OpCode::LE_READ_BUFFER_SIZE_V2);
+  view.total_num_le_acl_data_packets().Write(num_credits);
+  acl_data_channel.ProcessLEReadBufferSizeCommandCompleteEvent(view);
+}
+
+TEST(SendAclBatchTest, SendsAsManyPacketsAsThereAreCredits) {
+  constexpr uint16_t kNumCredits = 2;
+  constexpr size_t kNumPackets = kNumCredits + 1;
+  struct {
+    uint16_t sends_called = 0;
+  } capture;
+
+  HciTransport hci_transport(
+      []([[maybe_unused]] H4PacketWithHci&& packet) {},
+      [&capture]([[maybe_unused]] H4PacketWithH4&& packet) {
+        ++capture.sends_called;
+      });
+  AclDataChannel acl_data_channel(hci_transport, kNumCredits);
+  ReserveChannelLeAclCredits(acl_data_channel, kNumCredits);
+  EXPECT_EQ(acl_data_channel.GetNumFreeLeAclPackets(), kNumCredits);
+
+  std::array<
+      std::array<uint8_t,
+                 sizeof(emboss::H4PacketType) +
+                     emboss::AclDataFrameHeader::IntrinsicSizeInBytes()>,
+      kNumPackets>
+      h4_arrs{};
+  std::array<H4PacketWithH4, kNumPackets> h4_packets;
+  for (size_t i = 0; i < kNumPackets; ++i) {
+    h4_packets[i] =
+        H4PacketWithH4(emboss::H4PacketType::ACL_DATA, pw::span(h4_arrs[i]));
+    MakeEmboss<emboss::AclDataFrameHeaderWriter>(h4_packets[i].GetHciSpan())
+        .handle()
+        .Write(static_cast<uint16_t>(0x123 + i));
+  }
+
+  // Only the packets that credits are available for are sent.
+  EXPECT_EQ(acl_data_channel.SendAclBatch(h4_packets), kNumCredits);
+  EXPECT_EQ(capture.sends_called, kNumCredits);
+  EXPECT_EQ(acl_data_channel.GetNumFreeLeAclPackets(), 0);
+
+  // The unsent packet is left for the caller to retry.
+  EXPECT_EQ(h4_packets[kNumPackets - 1].GetH4Span().data(),
+            h4_arrs[kNumPackets - 1].data());
+  EXPECT_EQ(acl_data_channel.SendAclBatch(
+                pw::span(h4_packets).subspan(kNumPackets - 1)),
+            0u);
+}
+
+TEST(SendAclBatchTest, InvalidPacketDoesNotConsumeCredit) {
+  struct {
+    uint16_t sends_called = 0;
+  } capture;
+
+  HciTransport hci_transport(
+      []([[maybe_unused]] H4PacketWithHci&& packet) {},
+      [&capture]([[maybe_unused]] H4PacketWithH4&& packet) {
+        ++capture.sends_called;
+      });
+  AclDataChannel acl_data_channel(hci_transport, 1);
+  ReserveChannelLeAclCredits(acl_data_channel, 1);
+
+  // Packet is too short to contain an ACL header.
+  std::array<uint8_t, 2> h4_arr{};
+  EXPECT_FALSE(acl_data_channel.SendAcl(
+      H4PacketWithH4(emboss::H4PacketType::ACL_DATA, pw::span(h4_arr))));
+  EXPECT_EQ(capture.sends_called, 0);
+  EXPECT_EQ(acl_data_channel.GetNumFreeLeAclPackets(), 1);
+}
+
 }  // namespace
 }  // namespace pw::bluetooth::proxy
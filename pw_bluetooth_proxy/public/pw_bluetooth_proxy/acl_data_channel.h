@@ -19,6 +19,7 @@
 #include "pw_bluetooth/hci_events.emb.h"
 #include "pw_bluetooth_proxy/hci_transport.h"
 #include "pw_containers/vector.h"
+#include "pw_span/span.h"
 #include "pw_sync/lock_annotations.h"
 #include "pw_sync/mutex.h"
 
@@ -78,12 +79,24 @@ class AclDataChannel {
   // Returns false if no LE ACL send credits were available to send the packet.
   bool SendAcl(H4PacketWithH4&& h4_packet);
 
+  // Send the ACL data packets contained in `h4_packets` to the controller, in
+  // order, acquiring their LE ACL send credits in a single pass. Stops at the
+  // first packet that cannot be sent, either because no credits remain or
+  // because the packet is invalid. Returns the number of packets sent; packets
+  // that were not sent are left in `h4_packets` so the caller can retry them
+  // once credits are reclaimed.
+  size_t SendAclBatch(span<H4PacketWithH4> h4_packets);
+
  private:
   struct AclConnection {
     uint16_t handle = 0;
     uint16_t num_pending_packets = 0;
   };
 
+  // Returns true if the proxy has packets in flight on any connection. Events
+  // about other connections need not be parsed.
+  bool HasActiveConnections() const;
+
   // Returns iterator to AclConnection with provided `handle` in
   // `active_connections_`. Returns active_connections_.end() if no such
   // connection exists.
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <optional>
 #include <type_traits>
 
 #include "pw_span/span.h"
@@ -40,4 +42,32 @@ constexpr inline EmbossT MakeEmboss(ContainerT&& buffer) {
   return EmbossT(buffer.data(), buffer.size());
 }
 
+/// Returns the size in bytes of a fixed-size Emboss struct. The size is a
+/// compile-time constant. This fails to compile for structs whose size depends
+/// on their contents, such as those with variable-length arrays.
+template <typename EmbossT>
+constexpr size_t EmbossFixedSizeInBytes() {
+  constexpr size_t kSize =
+      static_cast<size_t>(EmbossT::IntrinsicSizeInBytes().Read());
+  return kSize;
+}
+
+/// Creates an Emboss View or Writer for a fixed-size struct at the start of
+/// `buffer`. Returns `std::nullopt` if `buffer` is too small to hold it.
+///
+/// The only run-time check is a comparison of the buffer size against a
+/// compile-time constant. `IsComplete()` computes the size of the struct at
+/// run time, and `Ok()` also validates every field, including fields that the
+/// caller never reads. All fields of the returned view are within bounds.
+/// Callers that rely on a field's `[requires]` constraint must check that
+/// field with its own `Ok()`.
+template <typename EmbossT, typename ContainerT>
+constexpr std::optional<EmbossT> MakeFixedSizeEmboss(ContainerT&& buffer) {
+  constexpr size_t kSize = EmbossFixedSizeInBytes<EmbossT>();
+  if (buffer.size() < kSize) {
+    return std::nullopt;
+  }
+  return EmbossT(buffer.data(), kSize);
+}
+
 }  // namespace pw::bluetooth::proxy
@@ -24,36 +24,42 @@
 #include "pw_bluetooth_sapphire/internal/host/common/log.h"
 
 namespace bt::att {
-namespace {
-
-bool StartLessThan(const AttributeGrouping& grp, const Handle handle) {
-  return grp.start_handle() < handle;
-}
-
-bool EndLessThan(const AttributeGrouping& grp, const Handle handle) {
-  return grp.end_handle() < handle;
-}
-
-}  // namespace
 
 Database::Iterator::Iterator(GroupingList* list,
+                             const GroupingIndex* index,
+                             const std::vector<Handle>* typed_handles,
                              Handle start,
                              Handle end,
                              const UUID* type,
                              bool groups_only)
-    : start_(start), end_(end), grp_only_(groups_only), attr_offset_(0u) {
+    : start_(start),
+      end_(end),
+      grp_only_(groups_only),
+      index_(index),
+      typed_handles_(typed_handles),
+      attr_offset_(0u) {
   BT_DEBUG_ASSERT(list);
+  BT_DEBUG_ASSERT(index);
   grp_end_ = list->end();
 
-  if (type)
+  if (type) {
     type_filter_ = *type;
 
-  // Initialize the iterator by performing a binary search over the attributes.
-  // If we were asked to iterate over groupings only, then look strictly within
-  // the range. Otherwise we allow the first grouping to partially overlap the
-  // range.
-  grp_iter_ = std::lower_bound(
-      list->begin(), grp_end_, start_, grp_only_ ? StartLessThan : EndLessThan);
+    // Only visit the attributes of the given type.
+    SeekTypedHandle(start_);
+    return;
+  }
+
+  // Initialize the iterator by looking up the first grouping that ends at or
+  // after |start_|. If we were asked to iterate over groupings only, then look
+  // strictly within the range. Otherwise we allow the first grouping to
+  // partially overlap the range.
+  auto index_iter = index_->lower_bound(start_);
+  if (grp_only_ && index_iter != index_->end() &&
+      index_iter->second->start_handle() < start_) {
+    index_iter++;
+  }
+  grp_iter_ = index_iter == index_->end() ? grp_end_ : index_iter->second;
 
   if (AtEnd())
     return;
@@ -68,15 +74,45 @@ Database::Iterator::Iterator(GroupingList* list,
     attr_offset_ = start_ - grp_iter_->start_handle();
   }
 
-  // If the first is inactive or if it doesn't match the current filter then
-  // skip ahead.
-  if (!grp_iter_->active() ||
-      (type_filter_ &&
-       grp_iter_->attributes()[attr_offset_].type() != *type_filter_)) {
+  // If the first is inactive then skip ahead.
+  if (!grp_iter_->active()) {
     Advance();
   }
 }
 
+void Database::Iterator::SeekTypedHandle(Handle handle) {
+  if (!typed_handles_) {
+    MarkEnd();
+    return;
+  }
+
+  auto iter =
+      std::lower_bound(typed_handles_->begin(), typed_handles_->end(), handle);
+  while (iter != typed_handles_->end() && *iter <= end_) {
+    auto index_iter = index_->lower_bound(*iter);
+    BT_DEBUG_ASSERT(index_iter != index_->end());
+    GroupingList::iterator grouping = index_iter->second;
+
+    // Skip the rest of the grouping if it cannot be visited.
+    if (!grouping->active() || !grouping->complete()) {
+      iter = std::upper_bound(
+          iter, typed_handles_->end(), grouping->end_handle());
+      continue;
+    }
+
+    if (grp_only_ && *iter != grouping->start_handle()) {
+      ++iter;
+      continue;
+    }
+
+    grp_iter_ = grouping;
+    attr_offset_ = *iter - grouping->start_handle();
+    return;
+  }
+
+  MarkEnd();
+}
+
 const Attribute* Database::Iterator::get() const {
   if (AtEnd() || !grp_iter_->active())
     return nullptr;
@@ -89,6 +125,16 @@ void Database::Iterator::Advance() {
   if (AtEnd())
     return;
 
+  if (type_filter_) {
+    const Handle handle = grp_iter_->start_handle() + attr_offset_;
+    if (handle >= end_) {
+      MarkEnd();
+      return;
+    }
+    SeekTypedHandle(static_cast<Handle>(handle + 1));
+    return;
+  }
+
   do {
     if (!grp_only_ && grp_iter_->active()) {
       // If this grouping has more attributes to look at.
@@ -98,22 +144,14 @@ void Database::Iterator::Advance() {
 
         // Advance.
         attr_offset_++;
+        BT_DEBUG_ASSERT(attr_offset_ <= end_offset);
 
-        for (; attr_offset_ <= end_offset; ++attr_offset_) {
-          const auto& attr = grp_iter_->attributes()[attr_offset_];
-
-          // If |end_| is within this grouping and we go past it, the iterator
-          // is done.
-          if (attr.handle() > end_) {
-            MarkEnd();
-            return;
-          }
-
-          // If there is no filter then we're done. Otherwise, loop until an
-          // attribute is found that matches the filter.
-          if (!type_filter_ || attr.type() == *type_filter_)
-            return;
+        // If |end_| is within this grouping and we go past it, the iterator
+        // is done.
+        if (grp_iter_->attributes()[attr_offset_].handle() > end_) {
+          MarkEnd();
         }
+        return;
       }
 
       // We are done with the current grouping. Fall through and move to the
@@ -133,13 +171,7 @@ void Database::Iterator::Advance() {
       return;
     }
 
-    if (!grp_iter_->active() || !grp_iter_->complete())
-      continue;
-
-    // If there is no filter then we're done. Otherwise, loop until an
-    // attribute is found that matches the filter. (NOTE: the group type is the
-    // type of the first attribute).
-    if (!type_filter_ || (*type_filter_ == grp_iter_->group_type()))
+    if (grp_iter_->active() && grp_iter_->complete())
       return;
   } while (true);
 }
@@ -159,7 +191,43 @@ Database::Iterator Database::GetIterator(Handle start,
   BT_DEBUG_ASSERT(end <= range_end_);
   BT_DEBUG_ASSERT(start <= end);
 
-  return Iterator(&groupings_, start, end, type, groups_only);
+  const std::vector<Handle>* typed_handles = nullptr;
+  if (type) {
+    MaybeRebuildTypeIndex();
+    auto iter = type_index_.find(*type);
+    if (iter != type_index_.end()) {
+      typed_handles = &iter->second;
+    }
+  }
+
+  return Iterator(&groupings_,
+                  &grouping_index_,
+                  typed_handles,
+                  start,
+                  end,
+                  type,
+                  groups_only);
+}
+
+void Database::MaybeRebuildTypeIndex() {
+  if (!type_index_stale_) {
+    return;
+  }
+
+  type_index_.clear();
+  type_index_stale_ = false;
+
+  // Groupings are sorted by handle, so each list of handles is sorted.
+  for (const AttributeGrouping& grouping : groupings_) {
+    if (!grouping.complete()) {
+      // Index the grouping once it has been populated.
+      type_index_stale_ = true;
+      continue;
+    }
+    for (const Attribute& attr : grouping.attributes()) {
+      type_index_[attr.type()].push_back(attr.handle());
+    }
+  }
 }
 
 AttributeGrouping* Database::NewGrouping(const UUID& group_type,
@@ -209,18 +277,21 @@ AttributeGrouping* Database::NewGrouping(const UUID& group_type,
   auto iter =
       groupings_.emplace(pos, group_type, start_handle, attr_count, decl_value);
   BT_DEBUG_ASSERT(iter != groupings_.end());
+  grouping_index_.emplace(iter->end_handle(), iter);
+  type_index_stale_ = true;
 
   return &*iter;
 }
 
 bool Database::RemoveGrouping(Handle start_handle) {
-  auto iter = std::lower_bound(
-      groupings_.begin(), groupings_.end(), start_handle, StartLessThan);
-
-  if (iter == groupings_.end() || iter->start_handle() != start_handle)
+  auto index_iter = grouping_index_.lower_bound(start_handle);
+  if (index_iter == grouping_index_.end() ||
+      index_iter->second->start_handle() != start_handle)
     return false;
 
-  groupings_.erase(iter);
+  groupings_.erase(index_iter->second);
+  grouping_index_.erase(index_iter);
+  type_index_stale_ = true;
   return true;
 }
 
@@ -228,10 +299,13 @@ const Attribute* Database::FindAttribute(Handle handle) {
   if (handle == kInvalidHandle)
     return nullptr;
 
-  // Do a binary search to find the grouping that this handle is in.
-  auto iter = std::lower_bound(
-      groupings_.begin(), groupings_.end(), handle, EndLessThan);
-  if (iter == groupings_.end() || iter->start_handle() > handle)
+  // Look up the grouping that this handle is in.
+  auto index_iter = grouping_index_.lower_bound(handle);
+  if (index_iter == grouping_index_.end())
+    return nullptr;
+
+  auto iter = index_iter->second;
+  if (iter->start_handle() > handle)
     return nullptr;
 
   if (!iter->active() || !iter->complete())
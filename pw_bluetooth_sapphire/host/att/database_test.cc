@@ -499,6 +499,28 @@ TEST_F(DatabaseIteratorManyTest, FilterTestType3) {
   EXPECT_TRUE(iter.AtEnd());
 }
 
+TEST_F(DatabaseIteratorManyTest, FilterAfterModification) {
+  // Populate the type index before modifying the database.
+  auto iter = db()->GetIterator(kTestRangeStart, kTestRangeEnd, &kTestType1);
+  EXPECT_EQ(4u, IterHandles(&iter).size());
+
+  EXPECT_TRUE(db()->RemoveGrouping(5));
+  iter = db()->GetIterator(kTestRangeStart, kTestRangeEnd, &kTestType1);
+  auto handles = IterHandles(&iter);
+  const std::array<Handle, 3> kExpected = {1, 4, 10};
+  ASSERT_EQ(kExpected.size(), handles.size());
+  for (size_t i = 0; i < handles.size(); i++) {
+    EXPECT_EQ(kExpected[i], handles[i]);
+  }
+
+  auto grp = db()->NewGrouping(kTestType3, 0, kTestValue1);
+  grp->set_active(true);
+  iter = db()->GetIterator(kTestRangeStart, kTestRangeEnd, &kTestType3);
+  handles = IterHandles(&iter);
+  ASSERT_EQ(1u, handles.size());
+  EXPECT_EQ(grp->start_handle(), handles[0]);
+}
+
 TEST_F(DatabaseIteratorManyTest, UnaryRange) {
   // Test ranges with a single attribute. Test group begin, middle, and end
   // cases.
@@ -493,6 +493,11 @@ std::unordered_set<UUID> AdvertisingData::service_uuids() const {
   return out;
 }
 
+bool AdvertisingData::HasServiceUuid(const UUID& uuid) const {
+  auto iter = service_uuids_.find(uuid.CompactSize());
+  return iter != service_uuids_.end() && iter->second.set().count(uuid) != 0;
+}
+
 [[nodiscard]] bool AdvertisingData::SetServiceData(const UUID& uuid,
                                                    const ByteBuffer& data) {
   size_t encoded_size = EncodedServiceDataSize(uuid, data.view());
@@ -518,6 +523,10 @@ std::unordered_set<UUID> AdvertisingData::service_data_uuids() const {
   return uuids;
 }
 
+bool AdvertisingData::HasServiceData(const UUID& uuid) const {
+  return service_data_.count(uuid) != 0;
+}
+
 BufferView AdvertisingData::service_data(const UUID& uuid) const {
   auto iter = service_data_.find(uuid);
   if (iter == service_data_.end())
@@ -551,6 +560,10 @@ std::unordered_set<uint16_t> AdvertisingData::manufacturer_data_ids() const {
   return manuf_ids;
 }
 
+bool AdvertisingData::HasManufacturerData(uint16_t company_id) const {
+  return manufacturer_data_.count(company_id) != 0;
+}
+
 BufferView AdvertisingData::manufacturer_data(const uint16_t company_id) const {
   auto iter = manufacturer_data_.find(company_id);
   if (iter == manufacturer_data_.end())
@@ -132,6 +132,17 @@ TEST(AdvertisingDataTest, CompressServiceUUIDs) {
   EXPECT_TRUE(uuids.find(to_uuid(block, 4)) != uuids.end());
 }
 
+TEST(AdvertisingDataTest, HasServiceUuid) {
+  AdvertisingData data;
+  EXPECT_FALSE(data.HasServiceUuid(UUID(kId1As16)));
+
+  EXPECT_TRUE(data.AddServiceUuid(UUID(kId1As16)));
+  EXPECT_TRUE(data.HasServiceUuid(UUID(kId1As16)));
+  // The UUID is found regardless of the size it is represented with.
+  EXPECT_TRUE(data.HasServiceUuid(UUID(uint32_t{kId1As16})));
+  EXPECT_FALSE(data.HasServiceUuid(UUID(kId2As16)));
+}
+
 TEST(AdvertisingDataTest, ParseBlock) {
   StaticByteBuffer bytes(
       // Complete 16-bit UUIDs
@@ -283,6 +294,8 @@ TEST(AdvertisingDataTest, ManufacturerZeroLength) {
   ASSERT_EQ(fit::ok(), data);
 
   EXPECT_EQ(1u, data->manufacturer_data_ids().count(0x1234));
+  EXPECT_TRUE(data->HasManufacturerData(0x1234));
+  EXPECT_FALSE(data->HasManufacturerData(0x4321));
   EXPECT_EQ(0u, data->manufacturer_data(0x1234).size());
 }
 
@@ -322,6 +335,8 @@ TEST(AdvertisingDataTest, ServiceData) {
   UUID eddystone(uint16_t{0xFEAA});
 
   EXPECT_EQ(1u, data->service_data_uuids().size());
+  EXPECT_TRUE(data->HasServiceData(eddystone));
+  EXPECT_FALSE(data->HasServiceData(UUID(kId1As16)));
   EXPECT_EQ(13u, data->service_data(eddystone).size());
 
   EXPECT_TRUE(ContainersEqual(bytes.view(8), data->service_data(eddystone)));
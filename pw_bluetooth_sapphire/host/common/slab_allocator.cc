@@ -15,15 +15,68 @@
 #include "pw_bluetooth_sapphire/internal/host/common/slab_allocator.h"
 
 #include <memory>
+#include <new>
 
 #include "pw_bluetooth_sapphire/internal/host/common/byte_buffer.h"
 #include "pw_bluetooth_sapphire/internal/host/common/slab_buffer.h"
 
 namespace bt {
+namespace {
+
+pw::Allocator* slab_allocator = nullptr;
+
+// Precedes each slab-allocated object to record which allocator it came from.
+// A null allocator means the system heap.
+struct alignas(std::max_align_t) SlabObjectHeader {
+  pw::Allocator* allocator;
+};
+
+}  // namespace
+
+void SetSlabAllocator(pw::Allocator* allocator) { slab_allocator = allocator; }
+
+pw::Allocator* GetSlabAllocator() { return slab_allocator; }
+
+namespace internal {
+
+void* AllocateSlabObject(size_t size) {
+  pw::Allocator* allocator = slab_allocator;
+  void* ptr = nullptr;
+  if (allocator) {
+    ptr = allocator->Allocate(pw::allocator::Layout(
+        sizeof(SlabObjectHeader) + size, alignof(SlabObjectHeader)));
+  }
+  if (!ptr) {
+    allocator = nullptr;
+    ptr = ::operator new(sizeof(SlabObjectHeader) + size);
+  }
+  auto* header = new (ptr) SlabObjectHeader{allocator};
+  return header + 1;
+}
+
+void DeallocateSlabObject(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  auto* header = static_cast<SlabObjectHeader*>(ptr) - 1;
+  if (header->allocator) {
+    header->allocator->Deallocate(header);
+  } else {
+    ::operator delete(header);
+  }
+}
+
+}  // namespace internal
 
 MutableByteBufferPtr NewBuffer(size_t size) {
-  // TODO(fxbug.dev/42058160): Use Pigweed's slab allocator
-  return std::make_unique<DynamicByteBuffer>(size);
+  // Without a slab allocator, allocate exactly |size| bytes from the heap.
+  if (!slab_allocator || size == 0 || size > kLargeBufferSize) {
+    return std::make_unique<DynamicByteBuffer>(size);
+  }
+  if (size <= kSmallBufferSize) {
+    return std::make_unique<SlabBuffer<kSmallBufferSize>>(size);
+  }
+  return std::make_unique<SlabBuffer<kLargeBufferSize>>(size);
 }
 
 }  // namespace bt
@@ -14,6 +14,7 @@
 
 #include "pw_bluetooth_sapphire/internal/host/common/slab_allocator.h"
 
+#include "pw_allocator/testing.h"
 #include "pw_unit_test/framework.h"
 
 namespace bt {
@@ -45,5 +46,37 @@ TEST(SlabAllocatorTest, NewBuffer) {
   EXPECT_EQ(0U, buffer->size());
 }
 
+TEST(SlabAllocatorTest, NewBufferFromSlabAllocator) {
+  pw::allocator::test::AllocatorForTest<4096> allocator;
+  SetSlabAllocator(&allocator);
+
+  auto buffer = NewBuffer(kSmallBufferSize / 2);
+  ASSERT_TRUE(buffer);
+  EXPECT_EQ(kSmallBufferSize / 2, buffer->size());
+  EXPECT_GT(allocator.allocate_size(), kSmallBufferSize);
+  buffer->Fill(0xAB);
+  EXPECT_EQ(0xAB, (*buffer)[kSmallBufferSize / 2 - 1]);
+
+  allocator.ResetParameters();
+  buffer = NewBuffer(kLargeBufferSize / 2);
+  ASSERT_TRUE(buffer);
+  EXPECT_EQ(kLargeBufferSize / 2, buffer->size());
+  EXPECT_NE(allocator.deallocate_ptr(), nullptr);
+  EXPECT_GT(allocator.allocate_size(), kLargeBufferSize);
+
+  // Buffers fall back to the heap once the allocator is exhausted, and are
+  // freed to where they were allocated from.
+  allocator.Exhaust();
+  auto heap_buffer = NewBuffer(kSmallBufferSize);
+  ASSERT_TRUE(heap_buffer);
+  EXPECT_EQ(kSmallBufferSize, heap_buffer->size());
+  allocator.ResetParameters();
+  heap_buffer.reset();
+  EXPECT_EQ(allocator.deallocate_ptr(), nullptr);
+
+  buffer.reset();
+  SetSlabAllocator(nullptr);
+}
+
 }  // namespace
 }  // namespace bt
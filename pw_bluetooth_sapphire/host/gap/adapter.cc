@@ -938,6 +938,10 @@ void AdapterImpl::InitializeStep1() {
   // NOTE: It's safe to pass capture |this| directly in the callbacks as
   // |init_seq_runner_| will internally invalidate the callbacks if it ever gets
   // deleted.
+  //
+  // The informational reads after HCI_Reset do not depend on each other, so
+  // they are queued with |wait| false and sent back to back, as far as the
+  // controller's Num_HCI_Command_Packets allows.
 
   // HCI_Reset
   auto reset_command =
@@ -978,7 +982,8 @@ void AdapterImpl::InitializeStep1() {
         std::memcpy(state_.supported_commands,
                     params->supported_commands,
                     sizeof(params->supported_commands));
-      });
+      },
+      /*wait=*/false);
 
   // HCI_Read_Local_Supported_Features
   InitQueueReadLMPFeatureMaskPage(0);
@@ -994,7 +999,8 @@ void AdapterImpl::InitializeStep1() {
         auto params =
             cmd_complete.return_params<hci_spec::ReadBDADDRReturnParams>();
         state_.controller_address = params->bd_addr;
-      });
+      },
+      /*wait=*/false);
 
   if (state().IsControllerFeatureSupported(
           pw::bluetooth::Controller::FeaturesBits::kAndroidVendorExtensions)) {
@@ -1016,7 +1022,8 @@ void AdapterImpl::InitializeStep1() {
           }
 
           ParseLEGetVendorCapabilitiesCommandComplete(event);
-        });
+        },
+        /*wait=*/false);
   }
 
   init_seq_runner_->RunCommands([this](hci::Result<> status) mutable {
@@ -1055,6 +1062,9 @@ void AdapterImpl::InitializeStep2() {
 
   BT_DEBUG_ASSERT(init_seq_runner_->IsReady());
 
+  // As in step 1, the reads below are sent without waiting for each other. The
+  // writes that follow them still wait for all previous commands.
+
   // If the controller supports the Read Buffer Size command then send it.
   // Otherwise we'll default to 0 when initializing the ACLDataChannel.
   if (state_.IsCommandSupported(/*octet=*/14,
@@ -1089,7 +1099,8 @@ void AdapterImpl::InitializeStep2() {
             state_.sco_buffer_info =
                 hci::DataBufferInfo(sco_mtu, sco_max_count);
           }
-        });
+        },
+        /*wait=*/false);
   }
 
   // HCI_LE_Read_Local_Supported_Features
@@ -1109,7 +1120,8 @@ void AdapterImpl::InitializeStep2() {
         state_.low_energy_state.supported_features_ =
             pw::bytes::ConvertOrderFrom(cpp20::endian::little,
                                         params->le_features);
-      });
+      },
+      /*wait=*/false);
 
   // HCI_LE_Read_Supported_States
   init_seq_runner_->QueueCommand(
@@ -1128,7 +1140,8 @@ void AdapterImpl::InitializeStep2() {
                 .return_params<hci_spec::LEReadSupportedStatesReturnParams>();
         state_.low_energy_state.supported_states_ = pw::bytes::ConvertOrderFrom(
             cpp20::endian::little, params->le_states);
-      });
+      },
+      /*wait=*/false);
 
   if (state_.IsCommandSupported(
           /*octet=*/36,
@@ -1155,7 +1168,8 @@ void AdapterImpl::InitializeStep2() {
                  "gap",
                  "maximum advertising data length: %d",
                  state_.low_energy_state.max_advertising_data_length_);
-        });
+        },
+        /*wait=*/false);
   } else {
     bt_log(INFO,
            "gap",
@@ -1196,7 +1210,8 @@ void AdapterImpl::InitializeStep2() {
             state_.low_energy_state.iso_data_buffer_info_ =
                 hci::DataBufferInfo(iso_mtu, iso_max_count);
           }
-        });
+        },
+        /*wait=*/false);
   } else {
     // HCI_LE_Read_Buffer_Size [v1]
     init_seq_runner_->QueueCommand(
@@ -1218,7 +1233,8 @@ void AdapterImpl::InitializeStep2() {
             state_.low_energy_state.acl_data_buffer_info_ =
                 hci::DataBufferInfo(mtu, max_count);
           }
-        });
+        },
+        /*wait=*/false);
   }
 
   if (state_.features.HasBit(
@@ -1626,7 +1642,8 @@ void AdapterImpl::InitQueueReadLMPFeatureMaskPage(uint8_t page) {
               page,
               pw::bytes::ConvertOrderFrom(cpp20::endian::little,
                                           params->lmp_features));
-        });
+        },
+        /*wait=*/false);
     return;
   }
 
@@ -256,6 +256,37 @@ TEST_F(AdapterTest, InitializeSuccess) {
   EXPECT_FALSE(transport_closed_called());
 }
 
+TEST_F(AdapterTest, InitializeSendsIndependentReadsWithoutWaiting) {
+  FakeController::Settings settings;
+  settings.ApplyLEOnlyDefaults();
+  test_device()->set_settings(settings);
+
+  fit::closure resume_version_info;
+  test_device()->pause_responses_for_opcode(
+      hci_spec::kReadLocalVersionInfo,
+      [&](fit::closure resume) { resume_version_info = std::move(resume); });
+  bool read_bd_addr_received = false;
+  test_device()->pause_responses_for_opcode(hci_spec::kReadBDADDR,
+                                            [&](fit::closure resume) {
+                                              read_bd_addr_received = true;
+                                              resume();
+                                            });
+
+  std::optional<bool> success;
+  InitializeAdapter([&](bool cb_success) { success = cb_success; });
+
+  // HCI_Read_BD_ADDR is sent while HCI_Read_Local_Version_Information is still
+  // pending.
+  EXPECT_TRUE(read_bd_addr_received);
+  EXPECT_FALSE(success.has_value());
+
+  ASSERT_TRUE(resume_version_info);
+  resume_version_info();
+  RunUntilIdle();
+  ASSERT_TRUE(success.has_value());
+  EXPECT_TRUE(*success);
+}
+
 TEST_F(AdapterTest, InitializeFailureHCICommandError) {
   bool success;
   int init_cb_count = 0;
@@ -16,6 +16,8 @@
 
 #include <pw_bytes/endian.h>
 
+#include <algorithm>
+
 #include "pw_bluetooth_sapphire/internal/host/common/advertising_data.h"
 #include "pw_bluetooth_sapphire/internal/host/common/assert.h"
 #include "pw_bluetooth_sapphire/internal/host/common/log.h"
@@ -116,39 +118,29 @@ bool DiscoveryFilter::MatchLowEnergyResult(
     }
   }
 
-  if (manufacturer_code_) {
-    if (ad.manufacturer_data_ids().find(*manufacturer_code_) ==
-        ad.manufacturer_data_ids().end()) {
-      return false;
-    }
+  // Look up each filter value in |ad| directly rather than through its set
+  // accessors, which copy the advertised values for every call. This keeps the
+  // per-report cost of each discovery session to a few hash lookups.
+  if (manufacturer_code_ && !ad.HasManufacturerData(*manufacturer_code_)) {
+    return false;
   }
 
-  if (!service_uuids_.empty()) {
-    bool service_found = false;
-    const auto& ad_service_uuids = ad.service_uuids();
-    for (auto uuid : service_uuids_) {
-      if (ad_service_uuids.count(uuid) != 0) {
-        service_found = true;
-        break;
-      }
-    }
-    if (!service_found) {
-      return false;
-    }
+  auto has_service = [&ad](const UUID& uuid) {
+    return ad.HasServiceUuid(uuid);
+  };
+  if (!service_uuids_.empty() &&
+      std::none_of(service_uuids_.begin(), service_uuids_.end(), has_service)) {
+    return false;
   }
 
-  if (!service_data_uuids_.empty()) {
-    bool service_data_found = false;
-    const auto& ad_data_uuids = ad.service_data_uuids();
-    for (auto uuid : service_data_uuids_) {
-      if (ad_data_uuids.count(uuid) != 0) {
-        service_data_found = true;
-        break;
-      }
-    }
-    if (!service_data_found) {
-      return false;
-    }
+  auto has_service_data = [&ad](const UUID& uuid) {
+    return ad.HasServiceData(uuid);
+  };
+  if (!service_data_uuids_.empty() &&
+      std::none_of(service_data_uuids_.begin(),
+                   service_data_uuids_.end(),
+                   has_service_data)) {
+    return false;
   }
 
   // We haven't filtered it out, so it matches.
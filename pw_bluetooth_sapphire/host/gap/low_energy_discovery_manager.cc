@@ -31,6 +31,7 @@ constexpr uint16_t kLEPassiveScanWindow = kLEScanSlowWindow1;
 const char* kInspectPausedCountPropertyName = "paused";
 const char* kInspectStatePropertyName = "state";
 const char* kInspectFailedCountPropertyName = "failed_count";
+const char* kInspectCoalescedReportCountPropertyName = "coalesced_report_count";
 const char* kInspectScanIntervalPropertyName = "scan_interval_ms";
 const char* kInspectScanWindowPropertyName = "scan_window_ms";
 
@@ -210,6 +211,8 @@ void LowEnergyDiscoveryManager::AttachInspect(inspect::Node& parent,
   state_.AttachInspect(inspect_.node, kInspectStatePropertyName);
   inspect_.failed_count =
       inspect_.node.CreateUint(kInspectFailedCountPropertyName, 0);
+  inspect_.coalesced_report_count =
+      inspect_.node.CreateUint(kInspectCoalescedReportCountPropertyName, 0);
   inspect_.scan_interval_ms =
       inspect_.node.CreateDouble(kInspectScanIntervalPropertyName, 0);
   inspect_.scan_window_ms =
@@ -273,6 +276,27 @@ void LowEnergyDiscoveryManager::RemoveSession(
   }
 }
 
+bool LowEnergyDiscoveryManager::IsRepeatedReport(
+    const Peer& peer, const hci::LowEnergyScanResult& result) const {
+  if (result_coalescing_window_ <= pw::chrono::SystemClock::duration::zero() ||
+      !peer.le()) {
+    return false;
+  }
+
+  const std::optional<pw::chrono::SystemClock::time_point> last_report =
+      peer.le()->parsed_advertising_data_timestamp();
+  if (!last_report ||
+      dispatcher_.now() - *last_report >= result_coalescing_window_) {
+    return false;
+  }
+
+  // A peer that becomes connectable is always reported.
+  if (result.connectable() && !peer.connectable()) {
+    return false;
+  }
+  return peer.le()->AdvertisingDataMatches(result.data());
+}
+
 void LowEnergyDiscoveryManager::OnPeerFound(
     const hci::LowEnergyScanResult& result) {
   bt_log(DEBUG,
@@ -295,6 +319,11 @@ void LowEnergyDiscoveryManager::OnPeerFound(
     return;
   }
 
+  if (peer && IsRepeatedReport(*peer, result)) {
+    inspect_.coalesced_report_count.Add(1);
+    return;
+  }
+
   // Create a new entry if we found the device during general discovery.
   if (!peer) {
     peer = peer_cache_->NewPeer(result.address(), result.connectable());
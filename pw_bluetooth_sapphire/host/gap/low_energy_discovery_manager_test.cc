@@ -1532,6 +1532,7 @@ TEST_F(LowEnergyDiscoveryManagerTest, Inspect) {
               UnorderedElementsAre(StringIs("state", "Idle"),
                                    IntIs("paused", 0),
                                    UintIs("failed_count", 0u),
+                                   UintIs("coalesced_report_count", 0u),
                                    DoubleIs("scan_interval_ms", 0.0),
                                    DoubleIs("scan_window_ms", 0.0)));
 
@@ -1587,6 +1588,41 @@ TEST_F(LowEnergyDiscoveryManagerTest, Inspect) {
 }
 #endif  // NINSPECT
 
+TEST_F(LowEnergyDiscoveryManagerTest, CoalescesRepeatedReportsWithinWindow) {
+  constexpr pw::chrono::SystemClock::duration kWindow = std::chrono::seconds(1);
+  discovery_manager()->set_result_coalescing_window(kWindow);
+
+  auto fake_peer = std::make_unique<FakePeer>(
+      kAddress0, dispatcher(), /*connectable=*/true, /*scannable=*/false);
+  fake_peer->set_advertising_data(StaticByteBuffer(0x02, 0x01, 0x02));
+  test_device()->AddPeer(std::move(fake_peer));
+  const FakePeer* peer = test_device()->FindPeer(kAddress0);
+
+  size_t result_count = 0;
+  auto session = StartDiscoverySession();
+  session->SetResultCallback([&](const Peer&) { result_count++; });
+  RunUntilIdle();
+  ASSERT_EQ(result_count, 1u);
+
+  // A repeated report within the window is dropped.
+  test_device()->SendAdvertisingReport(*peer);
+  RunUntilIdle();
+  EXPECT_EQ(result_count, 1u);
+
+  // The next report after the window is processed.
+  RunFor(kWindow);
+  test_device()->SendAdvertisingReport(*peer);
+  RunUntilIdle();
+  EXPECT_EQ(result_count, 2u);
+
+  // A report with new data is processed even within the window.
+  test_device()->FindPeer(kAddress0)->set_advertising_data(
+      StaticByteBuffer(0x02, 0x01, 0x06));
+  test_device()->SendAdvertisingReport(*peer);
+  RunUntilIdle();
+  EXPECT_EQ(result_count, 3u);
+}
+
 TEST_F(LowEnergyDiscoveryManagerTest, SetResultCallbackIgnoresRemovedPeers) {
   auto fake_peer_0 = std::make_unique<FakePeer>(kAddress0, dispatcher());
   test_device()->AddPeer(std::move(fake_peer_0));
@@ -113,6 +113,15 @@ void Peer::LowEnergyData::SetAdvertisingData(
 
   peer_->SetRssiInternal(rssi);
 
+  // Repeated reports from an advertiser usually carry the same data, which
+  // does not need to be copied and parsed again.
+  if (AdvertisingDataMatches(data)) {
+    adv_timestamp_ = timestamp;
+    peer_->UpdatePeerAndNotifyListeners(
+        NotifyListenersChange::kBondNotUpdated);
+    return;
+  }
+
   // Update the advertising data
   adv_data_buffer_ = DynamicByteBuffer(data.size());
   data.Copy(&adv_data_buffer_);
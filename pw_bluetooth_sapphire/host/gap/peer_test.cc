@@ -574,6 +574,22 @@ TEST_F(PeerTest, LowEnergyAdvertisingDataTimestamp) {
             pw::chrono::SystemClock::time_point(std::chrono::nanoseconds(2)));
 }
 
+TEST_F(PeerTest, LowEnergySetUnchangedAdvertisingDataUpdatesRssi) {
+  peer().MutLe().SetAdvertisingData(
+      /*rssi=*/-10, kAdvData, pw::chrono::SystemClock::time_point());
+  ASSERT_TRUE(peer().le()->AdvertisingDataMatches(kAdvData));
+  EXPECT_FALSE(peer().le()->AdvertisingDataMatches(kInvalidAdvData));
+
+  bool listener_notified = false;
+  set_notify_listeners_cb(
+      [&](auto&, Peer::NotifyListenersChange) { listener_notified = true; });
+  peer().MutLe().SetAdvertisingData(
+      /*rssi=*/-20, kAdvData, pw::chrono::SystemClock::time_point());
+  EXPECT_TRUE(listener_notified);
+  EXPECT_EQ(peer().rssi(), -20);
+  EXPECT_TRUE(peer().le()->parsed_advertising_data());
+}
+
 TEST_F(PeerTest, SettingLowEnergyAdvertisingDataUpdatesLastUpdated) {
   EXPECT_EQ(peer().last_updated(),
             pw::chrono::SystemClock::time_point(std::chrono::nanoseconds(0)));
@@ -49,6 +49,12 @@ ByteBufferPtr CreditBasedFlowControlRxEngine::ProcessPdu(PDU pdu) {
     auto sdu_size =
         emboss::MakeKFrameSduHeaderView(&sdu_size_buffer).sdu_length().Read();
 
+    // An SDU that is contained in a single K-Frame is returned without copying
+    // it.
+    if (sdu_size == pdu.length() - kSduHeaderSize) {
+      return pdu.ReleasePayload(kSduHeaderSize);
+    }
+
     next_sdu_ = std::make_unique<DynamicByteBuffer>(sdu_size);
 
     // Skip the SDU header when copying the payload.
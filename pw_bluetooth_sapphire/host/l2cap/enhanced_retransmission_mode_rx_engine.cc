@@ -166,9 +166,7 @@ ByteBufferPtr Engine::ProcessFrame(const SimpleInformationFrameHeader header,
     return nullptr;
   }
   const auto payload_len = pdu.length() - header_len - footer_len;
-  auto sdu = std::make_unique<DynamicByteBuffer>(payload_len);
-  pdu.Copy(sdu.get(), header_len, payload_len);
-  return sdu;
+  return pdu.ReleasePayload(header_len, payload_len);
 }
 
 ByteBufferPtr Engine::ProcessFrame(const SimpleStartOfSduFrameHeader, PDU pdu) {
@@ -337,6 +337,25 @@ bool LogicalLink::HasAvailablePacket() const {
   return false;
 }
 
+size_t LogicalLink::scheduling_weight() const {
+  for (auto& [_, channel] : channels_) {
+    if (channel->requested_acl_priority() != AclPriority::kNormal) {
+      return kPrioritySchedulingWeight;
+    }
+  }
+  return 1;
+}
+
+ChannelImpl* LogicalLink::NextPriorityChannelWithPDUs() const {
+  for (auto& [_, channel] : channels_) {
+    if (channel->requested_acl_priority() != AclPriority::kNormal &&
+        channel->HasPDUs()) {
+      return channel.get();
+    }
+  }
+  return nullptr;
+}
+
 void LogicalLink::RoundRobinChannels() {
   // Go through all channels in map
   if (next(current_channel_) == channels_.end()) {
@@ -352,6 +371,18 @@ bool LogicalLink::IsNextPacketContinuingFragment() const {
 }
 
 std::unique_ptr<hci::ACLDataPacket> LogicalLink::GetNextOutboundPacket() {
+  // Prioritized channels start their next PDU ahead of round robin, until they
+  // have used their share and a channel must be picked by round robin.
+  if (!IsNextPacketContinuingFragment()) {
+    ChannelImpl* priority_channel = NextPriorityChannelWithPDUs();
+    if (priority_channel && priority_pdus_sent_ < kPrioritySchedulingWeight) {
+      priority_pdus_sent_++;
+      current_pdus_channel_ = priority_channel->GetWeakPtr();
+      return current_pdus_channel_->GetNextOutboundPacket();
+    }
+    priority_pdus_sent_ = 0;
+  }
+
   for (size_t i = 0; i < channels_.size(); i++) {
     if (!IsNextPacketContinuingFragment()) {
       current_pdus_channel_ = ChannelImpl::WeakPtr();
@@ -14,10 +14,34 @@
 
 #include "pw_bluetooth_sapphire/internal/host/l2cap/pdu.h"
 
+#include <memory>
+
 #include "pw_bluetooth_sapphire/internal/host/common/log.h"
 #include "pw_bluetooth_sapphire/internal/host/transport/acl_data_packet.h"
 
 namespace bt::l2cap {
+namespace {
+
+// A read-only view of part of an ACL data fragment's payload that owns the
+// fragment.
+class FragmentPayloadBuffer final : public ByteBuffer {
+ public:
+  FragmentPayloadBuffer(hci::ACLDataPacketPtr fragment, size_t pos, size_t size)
+      : fragment_(std::move(fragment)),
+        view_(fragment_->view().payload_data().view(pos, size)) {}
+
+  // ByteBuffer overrides:
+  const uint8_t* data() const override { return view_.data(); }
+  size_t size() const override { return view_.size(); }
+  const_iterator cbegin() const override { return view_.cbegin(); }
+  const_iterator cend() const override { return view_.cend(); }
+
+ private:
+  hci::ACLDataPacketPtr fragment_;
+  BufferView view_;
+};
+
+}  // namespace
 
 // NOTE: The order in which these are initialized matters, as
 // other.ReleaseFragments() resets |other.fragment_count_|.
@@ -89,6 +113,24 @@ PDU::FragmentList PDU::ReleaseFragments() {
   return out_list;
 }
 
+ByteBufferPtr PDU::ReleasePayload(size_t pos, size_t size) {
+  BT_DEBUG_ASSERT(is_valid());
+  BT_DEBUG_ASSERT(pos <= length());
+
+  size = std::min(size, length() - pos);
+  if (fragments_.size() == 1) {
+    auto payload = std::make_unique<FragmentPayloadBuffer>(
+        std::move(fragments_.front()), sizeof(BasicHeader) + pos, size);
+    fragments_.clear();
+    return payload;
+  }
+
+  auto payload = std::make_unique<DynamicByteBuffer>(size);
+  Copy(payload.get(), pos, size);
+  fragments_.clear();
+  return payload;
+}
+
 const BasicHeader& PDU::basic_header() const {
   BT_DEBUG_ASSERT(!fragments_.empty());
   const auto& fragment = *fragments_.begin();
@@ -300,5 +300,71 @@ TEST(PduTest, ReadMultipleFragments) {
   EXPECT_EQ("is a tesXXXXXXX", pdu_data.AsString());
 }
 
+TEST(PduTest, ReleasePayloadSingleFragment) {
+  Recombiner recombiner(0x0001);
+
+  // clang-format off
+
+  auto packet = PacketFromBytes(
+    // ACL data header
+    0x01, 0x00, 0x08, 0x00,
+
+    // Basic l2cap header
+    0x04, 0x00, 0xFF, 0xFF, 'T', 'e', 's', 't'
+  );
+
+  // clang-format on
+
+  const uint8_t* const payload_data =
+      packet->view().payload_data().data() + sizeof(BasicHeader);
+  auto result = recombiner.ConsumeFragment(std::move(packet));
+  ASSERT_TRUE(result.pdu);
+
+  PDU pdu = std::move(*result.pdu);
+  ByteBufferPtr payload = pdu.ReleasePayload(1, 2);
+  EXPECT_FALSE(pdu.is_valid());
+  ASSERT_TRUE(payload);
+  EXPECT_EQ("es", payload->AsString());
+
+  // The payload refers to the fragment instead of a copy.
+  EXPECT_EQ(payload_data + 1, payload->data());
+}
+
+TEST(PduTest, ReleasePayloadMultipleFragments) {
+  Recombiner recombiner(0x0001);
+
+  // clang-format off
+
+  // Partial initial fragment
+  auto packet0 = PacketFromBytes(
+    // ACL data header (PBF: initial fragment)
+    0x01, 0x00, 0x06, 0x00,
+
+    // Basic l2cap header
+    0x04, 0x00, 0xFF, 0xFF, 'T', 'e'
+  );
+
+  // Continuation fragment
+  auto packet1 = PacketFromBytes(
+    // ACL data header (PBF: continuing fragment)
+    0x01, 0x10, 0x02, 0x00,
+
+    // L2CAP PDU fragment
+    's', 't'
+  );
+
+  // clang-format on
+
+  EXPECT_FALSE(recombiner.ConsumeFragment(std::move(packet0)).frames_dropped);
+  auto result = recombiner.ConsumeFragment(std::move(packet1));
+  ASSERT_TRUE(result.pdu);
+
+  PDU pdu = std::move(*result.pdu);
+  ByteBufferPtr payload = pdu.ReleasePayload();
+  EXPECT_FALSE(pdu.is_valid());
+  ASSERT_TRUE(payload);
+  EXPECT_EQ("Test", payload->AsString());
+}
+
 }  // namespace
 }  // namespace bt
@@ -66,6 +66,28 @@ void Swap128(const UInt128& in, UInt128* out) {
   }
 }
 
+// Expands the little-endian |key| into an AES encryption key schedule. A
+// schedule can be reused for every block encrypted with the same key.
+void ExpandKey(const UInt128& key, AES_KEY* out) {
+  UInt128 be_k;
+  Swap128(key, &be_k);
+  AES_set_encrypt_key(be_k.data(), 128, out);
+}
+
+// Encrypts one little-endian block with an expanded key.
+void EncryptBlock(const AES_KEY& key,
+                  const UInt128& plaintext_data,
+                  UInt128* out_encrypted_data) {
+  UInt128 be_pt, be_enc;
+  Swap128(plaintext_data, &be_pt);
+  AES_encrypt(be_pt.data(), be_enc.data(), &key);
+  Swap128(be_enc, out_encrypted_data);
+}
+
+// AesCmac() messages up to this size are reversed on the stack. This covers
+// every SMP cryptographic function; G2 has the longest message.
+constexpr size_t kMaxStackCmacMessageSize = 2 * kUInt256Size + kUInt128Size;
+
 // XOR two 128-bit integers and return the result in |out|. It is possible to
 // pass a pointer to one of the inputs as |out|.
 void Xor128(const UInt128& int1, const UInt128& int2, UInt128* out) {
@@ -261,20 +283,14 @@ PairingMethod SelectPairingMethod(
 void Encrypt(const UInt128& key,
              const UInt128& plaintext_data,
              UInt128* out_encrypted_data) {
-  // Swap the bytes since "the most significant octet of key corresponds to
-  // key[0], the most significant octet of plaintextData corresponds to in[0]
-  // and the most significant octet of encryptedData corresponds to out[0] using
-  // the notation specified in FIPS-197" for the security function "e" (Vol 3,
-  // Part H, 2.2.1).
-  UInt128 be_k, be_pt, be_enc;
-  Swap128(key, &be_k);
-  Swap128(plaintext_data, &be_pt);
-
+  // ExpandKey() and EncryptBlock() swap the bytes since "the most significant
+  // octet of key corresponds to key[0], the most significant octet of
+  // plaintextData corresponds to in[0] and the most significant octet of
+  // encryptedData corresponds to out[0] using the notation specified in
+  // FIPS-197" for the security function "e" (Vol 3, Part H, 2.2.1).
   AES_KEY k;
-  AES_set_encrypt_key(be_k.data(), 128, &k);
-  AES_encrypt(be_pt.data(), be_enc.data(), &k);
-
-  Swap128(be_enc, out_encrypted_data);
+  ExpandKey(key, &k);
+  EncryptBlock(k, plaintext_data, out_encrypted_data);
 }
 
 void C1(const UInt128& tk,
@@ -309,12 +325,15 @@ void C1(const UInt128& tk,
               0,
               p2.size() - ra.size() - ia.size());  // Pad 0s for the remainder
 
-  // Calculate the confirm value: e(tk, e(tk, rand XOR p1) XOR p2)
+  // Calculate the confirm value: e(tk, e(tk, rand XOR p1) XOR p2). Both
+  // encryptions use |tk|, so its key schedule is only expanded once.
+  AES_KEY k;
+  ExpandKey(tk, &k);
   UInt128 tmp;
   Xor128(rand, p1, &p1);
-  Encrypt(tk, p1, &tmp);
+  EncryptBlock(k, p1, &tmp);
   Xor128(tmp, p2, &tmp);
-  Encrypt(tk, tmp, out_confirm_value);
+  EncryptBlock(k, tmp, out_confirm_value);
 }
 
 void S1(const UInt128& tk,
@@ -437,16 +456,22 @@ std::optional<UInt128> AesCmac(const UInt128& hash_key, const ByteBuffer& msg) {
   // BoringSSL.
   UInt128 big_endian_key;
   Swap128(hash_key, &big_endian_key);
-  DynamicByteBuffer big_endian_msg(msg);
-  uint8_t* msg_begin = big_endian_msg.mutable_data();
-  std::reverse(msg_begin, msg_begin + big_endian_msg.size());
+  // Only fall back to the heap for messages longer than any SMP function uses.
+  StaticByteBuffer<kMaxStackCmacMessageSize> stack_msg;
+  DynamicByteBuffer heap_msg;
+  uint8_t* msg_begin = stack_msg.mutable_data();
+  if (msg.size() > stack_msg.size()) {
+    heap_msg = DynamicByteBuffer(msg.size());
+    msg_begin = heap_msg.mutable_data();
+  }
+  std::reverse_copy(msg.begin(), msg.end(), msg_begin);
   UInt128 big_endian_out, little_endian_out;
   // 0 is the failure error code for AES_CMAC
   if (AES_CMAC(big_endian_out.data(),
                big_endian_key.data(),
                big_endian_key.size(),
                msg_begin,
-               big_endian_msg.size()) == 0) {
+               msg.size()) == 0) {
     return std::nullopt;
   }
   Swap128(big_endian_out, &little_endian_out);
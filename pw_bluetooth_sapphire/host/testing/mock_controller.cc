@@ -295,6 +295,11 @@ void MockController::SendAclData(pw::span<const std::byte> data) {
         }
       });
 }
+void MockController::SendAclDataBatch(
+    pw::span<const pw::span<const std::byte>> packets) {
+  acl_data_batch_count_++;
+  ControllerTestDoubleBase::SendAclDataBatch(packets);
+}
 void MockController::SendScoData(pw::span<const std::byte> data) {
   // Post task to simulate async
   DynamicByteBuffer buffer(BufferView(data.data(), data.size()));
@@ -16,6 +16,8 @@
 
 #include <pw_bytes/endian.h>
 
+#include <algorithm>
+#include <array>
 #include <iterator>
 
 #include "lib/fit/function.h"
@@ -56,6 +58,10 @@ class AclDataChannelImpl final : public AclDataChannel {
   using ConnectionMap = std::unordered_map<hci_spec::ConnectionHandle,
                                            WeakPtr<ConnectionInterface>>;
 
+  // Maximum number of packets passed to the controller in a single
+  // SendAclDataBatch() call.
+  static constexpr size_t kMaxAclBatchSize = 16;
+
   struct PendingPacketData {
     bt::LinkType ll_type = bt::LinkType::kACL;
     size_t count = 0;
@@ -104,9 +110,12 @@ class AclDataChannelImpl final : public AclDataChannel {
   // on |connection|.
   void IncrementPendingPacketsForLink(WeakPtr<ConnectionInterface>& connection);
 
-  // Sends queued packets from links in a round-robin fashion, starting with
-  // |current_link|. |current_link| will be incremented to the next link that
-  // should send packets (according to the round-robin policy).
+  // Sends queued packets from links in a weighted round-robin fashion,
+  // starting with |current_link|. Each visit sends up to the link's
+  // scheduling_weight() packets. |current_link| will be incremented to the next
+  // link that should send packets (according to the round-robin policy).
+  // Packets are
+  // passed to the controller in batches of up to |kMaxAclBatchSize|.
   void SendPackets(ConnectionMap::iterator& current_link);
 
   // Handler for HCI_Buffer_Overflow_event.
@@ -306,6 +315,23 @@ void AclDataChannelImpl::SendPackets(ConnectionMap::iterator& current_link) {
   size_t free_buffer_packets = GetNumFreePacketsForLinkType(link_type);
   bool is_packet_queued = true;
 
+  // Packets are handed to the controller in batches, so that transports with a
+  // high per-write overhead can submit them together. The packets must outlive
+  // the SendAclDataBatch() call.
+  std::array<ACLDataPacketPtr, kMaxAclBatchSize> batch;
+  std::array<pw::span<const std::byte>, kMaxAclBatchSize> batch_data;
+  size_t batch_size = 0;
+  auto flush_batch = [&] {
+    if (batch_size == 0) {
+      return;
+    }
+    hci_->SendAclDataBatch(pw::span(batch_data).first(batch_size));
+    for (size_t i = 0; i < batch_size; ++i) {
+      batch[i].reset();
+    }
+    batch_size = 0;
+  };
+
   // Send packets as long as a link may have a packet queued and buffer space is
   // available.
   for (; free_buffer_packets != 0;
@@ -318,19 +344,28 @@ void AclDataChannelImpl::SendPackets(ConnectionMap::iterator& current_link) {
       is_packet_queued = false;
     }
 
-    if (!current_link->second->HasAvailablePacket()) {
-      continue;
-    }
-
-    // If there is an available packet, send and update packet counts
-    ACLDataPacketPtr packet = current_link->second->GetNextOutboundPacket();
-    BT_DEBUG_ASSERT(packet);
-    hci_->SendAclData(packet->view().data().subspan());
+    // Send up to the link's scheduling weight of available packets before
+    // moving on to the next link, adding them to the batch and updating packet
+    // counts
+    WeakPtr<ConnectionInterface>& connection = current_link->second;
+    const size_t weight = std::max<size_t>(connection->scheduling_weight(), 1);
+    for (size_t sent = 0; sent < weight && free_buffer_packets != 0 &&
+                          connection->HasAvailablePacket();
+         sent++) {
+      ACLDataPacketPtr packet = connection->GetNextOutboundPacket();
+      BT_DEBUG_ASSERT(packet);
+      batch_data[batch_size] = packet->view().data().subspan();
+      batch[batch_size] = std::move(packet);
+      if (++batch_size == kMaxAclBatchSize) {
+        flush_batch();
+      }
 
-    is_packet_queued = true;
-    free_buffer_packets--;
-    IncrementPendingPacketsForLink(current_link->second);
+      is_packet_queued = true;
+      free_buffer_packets--;
+      IncrementPendingPacketsForLink(connection);
+    }
   }
+  flush_batch();
 }
 
 void AclDataChannelImpl::TrySendNextPackets() {
@@ -356,6 +356,54 @@ TEST_F(AclDataChannelOnlyBREDRBufferAvailable,
   EXPECT_TRUE(test_device()->AllExpectedDataPacketsSent());
 }
 
+TEST_F(AclDataChannelOnlyBREDRBufferAvailable,
+       QueuedPacketsAreSentToControllerInOneBatch) {
+  FakeAclConnection connection_0(
+      acl_data_channel(), kConnectionHandle0, bt::LinkType::kACL);
+
+  acl_data_channel()->RegisterConnection(connection_0.GetWeakPtr());
+
+  FillControllerBufferThenQueuePacket(connection_0);
+
+  // Queue a second packet behind the one already waiting for buffer space
+  ACLDataPacketPtr packet =
+      ACLDataPacket::New(kConnectionHandle0,
+                         hci_spec::ACLPacketBoundaryFlag::kFirstNonFlushable,
+                         hci_spec::ACLBroadcastFlag::kPointToPoint,
+                         /*payload_size=*/1);
+  packet->mutable_view()->mutable_payload_data()[0] =
+      static_cast<uint8_t>(kBufferMaxNumPackets + 1);
+  connection_0.QueuePacket(std::move(packet));
+  RunUntilIdle();
+  EXPECT_EQ(connection_0.queued_packets().size(), 2u);
+  EXPECT_TRUE(test_device()->AllExpectedDataPacketsSent());
+
+  for (size_t i = kBufferMaxNumPackets; i <= kBufferMaxNumPackets + 1; i++) {
+    EXPECT_ACL_PACKET_OUT(test_device(),
+                          StaticByteBuffer(
+                              // ACL data header (handle: 0, length 1)
+                              LowerBits(kConnectionHandle0),
+                              UpperBits(kConnectionHandle0),
+                              // payload length
+                              0x01,
+                              0x00,
+                              // payload
+                              static_cast<uint8_t>(i)));
+  }
+
+  // Freeing the whole buffer should send both queued packets with a single
+  // call to the controller
+  const size_t batch_count = test_device()->acl_data_batch_count();
+  test_device()->SendCommandChannelPacket(
+      bt::testing::NumberOfCompletedPacketsPacket(kConnectionHandle0,
+                                                  kBufferMaxNumPackets));
+  RunUntilIdle();
+
+  EXPECT_EQ(test_device()->acl_data_batch_count(), batch_count + 1);
+  EXPECT_EQ(connection_0.queued_packets().size(), 0u);
+  EXPECT_TRUE(test_device()->AllExpectedDataPacketsSent());
+}
+
 TEST_F(AclDataChannelOnlyBREDRBufferAvailable,
        UnregisterLinkDropsFutureSentPackets) {
   constexpr size_t kMaxNumPackets = 1;
@@ -986,6 +1034,75 @@ TEST_F(AclDataChannelTest,
   EXPECT_TRUE(test_device()->AllExpectedDataPacketsSent());
 }
 
+TEST_F(AclDataChannelTest, LinkSchedulingWeightIsUsedForRoundRobin) {
+  constexpr size_t kBufferMaxPackets = 4;
+  constexpr size_t kWeight = 3;
+
+  InitializeACLDataChannel(DataBufferInfo(kMaxMtu, kBufferMaxPackets),
+                           DataBufferInfo());
+
+  FakeAclConnection connection_0(
+      acl_data_channel(), kConnectionHandle0, bt::LinkType::kACL);
+  FakeAclConnection connection_1(
+      acl_data_channel(), kConnectionHandle1, bt::LinkType::kACL);
+  connection_0.set_scheduling_weight(kWeight);
+
+  acl_data_channel()->RegisterConnection(connection_0.GetWeakPtr());
+  acl_data_channel()->RegisterConnection(connection_1.GetWeakPtr());
+
+  auto queue_packet = [](FakeAclConnection& connection, uint8_t payload) {
+    ACLDataPacketPtr packet =
+        ACLDataPacket::New(connection.handle(),
+                           hci_spec::ACLPacketBoundaryFlag::kFirstNonFlushable,
+                           hci_spec::ACLBroadcastFlag::kPointToPoint,
+                           /*payload_size=*/1);
+    packet->mutable_view()->mutable_payload_data()[0] = payload;
+    connection.QueuePacket(std::move(packet));
+  };
+  auto expect_packet = [this](FakeAclConnection& connection, uint8_t payload) {
+    EXPECT_ACL_PACKET_OUT(test_device(),
+                          StaticByteBuffer(
+                              // ACL data header
+                              LowerBits(connection.handle()),
+                              UpperBits(connection.handle()),
+                              // payload length
+                              0x01,
+                              0x00,
+                              // payload
+                              payload));
+  };
+
+  // Fill the controller buffer from |connection_0|. The round-robin iterator
+  // then points at |connection_1|.
+  for (uint8_t i = 0; i < kBufferMaxPackets; i++) {
+    expect_packet(connection_0, i);
+    queue_packet(connection_0, i);
+    RunUntilIdle();
+  }
+  EXPECT_TRUE(test_device()->AllExpectedDataPacketsSent());
+
+  for (uint8_t i = 0; i < kBufferMaxPackets; i++) {
+    queue_packet(connection_0, 0x10 + i);
+    queue_packet(connection_1, 0x20 + i);
+  }
+  RunUntilIdle();
+
+  // |connection_1| sends one packet per turn, while |connection_0| sends up to
+  // |kWeight| packets
+  expect_packet(connection_1, 0x20);
+  expect_packet(connection_0, 0x10);
+  expect_packet(connection_0, 0x11);
+  expect_packet(connection_0, 0x12);
+  test_device()->SendCommandChannelPacket(
+      bt::testing::NumberOfCompletedPacketsPacket(kConnectionHandle0,
+                                                  kBufferMaxPackets));
+  RunUntilIdle();
+
+  EXPECT_EQ(connection_0.queued_packets().size(), 1u);
+  EXPECT_EQ(connection_1.queued_packets().size(), 3u);
+  EXPECT_TRUE(test_device()->AllExpectedDataPacketsSent());
+}
+
 TEST_F(AclDataChannelTest, SendMoreBREDRAndLEPacketsThanMaximumLEBufferSpace) {
   constexpr size_t kBufferMaxPackets = 3;
 
@@ -14,7 +14,10 @@
 
 #pragma once
 #include <list>
+#include <map>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "pw_bluetooth_sapphire/internal/host/att/att.h"
 #include "pw_bluetooth_sapphire/internal/host/att/attribute.h"
@@ -37,12 +40,18 @@ namespace bt::att {
 class Database final : public WeakSelf<Database> {
   using GroupingList = std::list<AttributeGrouping>;
 
+  // Groupings keyed by their end handle.
+  using GroupingIndex = std::map<Handle, GroupingList::iterator>;
+
  public:
   // This type allows iteration over the attributes in a database. An iterator
   // is always initialzed with a handle range and options to skip attributes or
   // groupings based on attribute type. An iterator always skips
   // inactive/incomplete groupings.
   //
+  // An iterator with a type filter only visits the attributes of that type,
+  // using the database's type index.
+  //
   // Modifying a database invalidates its iterators.
   class Iterator final {
    public:
@@ -55,10 +64,6 @@ class Database final : public WeakSelf<Database> {
     // reached.
     void Advance();
 
-    // If set, |next()| will only return attributes with the given |type|. No
-    // filter is set by default.
-    void set_type_filter(const UUID& type) { type_filter_ = type; }
-
     // Returns true if the iterator cannot be advanced any further.
     inline bool AtEnd() const { return grp_iter_ == grp_end_; }
 
@@ -67,14 +72,24 @@ class Database final : public WeakSelf<Database> {
 
     friend class Database;
     Iterator(GroupingList* list,
+             const GroupingIndex* index,
+             const std::vector<Handle>* typed_handles,
              Handle start,
              Handle end,
              const UUID* type,
              bool groups_only);
 
+    // Moves to the first attribute in |typed_handles_| that has a handle
+    // greater than or equal to |handle| and is in range. Skips inactive and
+    // incomplete groupings and, if |grp_only_| is set, attributes that are not
+    // group declarations.
+    void SeekTypedHandle(Handle handle);
+
     Handle start_;
     Handle end_;
     bool grp_only_;
+    const GroupingIndex* index_;
+    const std::vector<Handle>* typed_handles_;
     GroupingList::iterator grp_end_;
     GroupingList::iterator grp_iter_;
     uint16_t attr_offset_;
@@ -133,7 +148,7 @@ class Database final : public WeakSelf<Database> {
 
   // Finds and returns the attribute with the given handle. Returns nullptr if
   // the attribute cannot be found or is part of a grouping that is inactive
-  // or incomplete.
+  // or incomplete. This takes O(log n) time in the number of groupings.
   const Attribute* FindAttribute(Handle handle);
 
   // Applies all write requests in |write_queue| and reports the result in
@@ -164,6 +179,9 @@ class Database final : public WeakSelf<Database> {
                          WriteCallback callback);
 
  private:
+  // Rebuilds |type_index_| if it is stale.
+  void MaybeRebuildTypeIndex();
+
   Handle range_start_;
   Handle range_end_;
 
@@ -172,6 +190,17 @@ class Database final : public WeakSelf<Database> {
   // represent contiguous handle ranges as any grouping can be removed.
   GroupingList groupings_;
 
+  // Index over |groupings_| for handle lookups. std::lower_bound() over the
+  // list itself would walk the list linearly.
+  GroupingIndex grouping_index_;
+
+  // Sorted handles of the attributes in complete groupings, keyed by attribute
+  // type. This is rebuilt lazily when an iterator with a type filter is
+  // created after the database was modified, or while a grouping was still
+  // being populated.
+  std::unordered_map<UUID, std::vector<Handle>> type_index_;
+  bool type_index_stale_ = false;
+
   BT_DISALLOW_COPY_AND_ASSIGN_ALLOW_MOVE(Database);
 };
 
@@ -182,6 +182,10 @@ class AdvertisingData {
   // Get the service UUIDs represented in this advertisement.
   std::unordered_set<UUID> service_uuids() const;
 
+  // Returns true if |uuid| is among the advertised services. Unlike
+  // service_uuids(), this does not copy the advertised UUIDs.
+  bool HasServiceUuid(const UUID& uuid) const;
+
   // Set service data for the service specified by |uuid|. Returns true if the
   // data was set, false otherwise. Failure occurs if |uuid| + |data| exceed
   // kMaxEncodedServiceDataLength when encoded.
@@ -190,6 +194,9 @@ class AdvertisingData {
   // Get a set of which UUIDs have service data in this advertisement.
   std::unordered_set<UUID> service_data_uuids() const;
 
+  // Returns true if this advertisement has service data for |uuid|.
+  bool HasServiceData(const UUID& uuid) const;
+
   // View the currently set service data for |uuid|.
   // This view is not stable; it should be used only ephemerally.
   // Returns an empty BufferView if no service data is set for |uuid|
@@ -204,11 +211,15 @@ class AdvertisingData {
   // Get a set of which IDs have manufacturer data in this advertisement.
   std::unordered_set<uint16_t> manufacturer_data_ids() const;
 
+  // Returns true if this advertisement has manufacturer data for the company
+  // |company_id|, even if that data is empty.
+  bool HasManufacturerData(uint16_t company_id) const;
+
   // View the currently set manufacturer data for the company |company_id|.
   // Returns an empty BufferView if no manufacturer data is set for
   // |company_id|.
   // NOTE: it is valid to send a manufacturer data with no data. Check that one
-  // exists using manufacturer_data_ids() first.
+  // exists using HasManufacturerData() first.
   // This view is not stable; it should be used only ephemerally.
   BufferView manufacturer_data(uint16_t company_id) const;
 
@@ -13,6 +13,9 @@
 // the License.
 
 #pragma once
+#include <cstddef>
+
+#include "pw_allocator/allocator.h"
 #include "pw_bluetooth_sapphire/internal/host/common/byte_buffer.h"
 
 namespace bt {
@@ -24,9 +27,45 @@ constexpr size_t kLargeBufferSize = 2048;
 constexpr size_t kMaxNumSlabs = 100;
 constexpr size_t kSlabSize = 32767;
 
-// Returns a slab-allocated byte buffer with |size| bytes of capacity. The
-// underlying allocation occupies |kSmallBufferSize| or |kLargeBufferSize| bytes
-// of memory, unless:
+// Sets the allocator that slab-allocated objects (NewBuffer() buffers and HCI
+// packets) are allocated from. Embedded builds should pass an allocator backed
+// by fixed memory, e.g. a pw::allocator::SlabAllocator whose slot sizes fit the
+// buffer and packet sizes, so that these allocations do not use the heap.
+//
+// If no allocator is set (the default), or the allocator is exhausted, objects
+// are allocated from the system heap. Objects record where they were allocated,
+// so the allocator may be changed at any time, but it must outlive every
+// object allocated from it. The allocator must be thread-safe if objects are
+// allocated or freed on multiple threads.
+void SetSlabAllocator(pw::Allocator* allocator);
+
+// Returns the allocator set with SetSlabAllocator(), or nullptr.
+pw::Allocator* GetSlabAllocator();
+
+namespace internal {
+
+void* AllocateSlabObject(size_t size);
+void DeallocateSlabObject(void* ptr);
+
+}  // namespace internal
+
+// Base class for types whose instances are allocated with the allocator set by
+// SetSlabAllocator(). The class-specific operators are also used when an
+// instance is deleted through a pointer to a base class with a virtual
+// destructor.
+class SlabAllocated {
+ public:
+  static void* operator new(size_t size) {
+    return internal::AllocateSlabObject(size);
+  }
+  static void operator delete(void* ptr) {
+    internal::DeallocateSlabObject(ptr);
+  }
+};
+
+// Returns a slab-allocated byte buffer with |size| bytes of capacity. If a slab
+// allocator was set, the underlying allocation occupies |kSmallBufferSize| or
+// |kLargeBufferSize| bytes of memory, unless:
 //  * |size| is 0, which returns a zero-sized byte buffer with no underlying
 //  slab allocation.
 //  * |size| exceeds |kLargeBufferSize|, which falls back to the system
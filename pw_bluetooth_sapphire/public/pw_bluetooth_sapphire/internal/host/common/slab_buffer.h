@@ -15,11 +15,12 @@
 #pragma once
 #include "pw_bluetooth_sapphire/internal/host/common/assert.h"
 #include "pw_bluetooth_sapphire/internal/host/common/byte_buffer.h"
+#include "pw_bluetooth_sapphire/internal/host/common/slab_allocator.h"
 
 namespace bt {
 
 template <size_t BackingBufferSize>
-class SlabBuffer : public MutableByteBuffer {
+class SlabBuffer : public MutableByteBuffer, public SlabAllocated {
  public:
   explicit SlabBuffer(size_t size) : size_(size) {
     BT_ASSERT(size);
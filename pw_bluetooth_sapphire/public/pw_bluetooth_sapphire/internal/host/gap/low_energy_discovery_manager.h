@@ -151,6 +151,19 @@ class LowEnergyDiscoveryManager final
     scan_period_ = period;
   }
 
+  // Sets the window within which repeated advertising reports from a known
+  // peer are coalesced. A report that carries the same data as the last report
+  // processed for the peer less than |window| ago is dropped without updating
+  // the peer cache or notifying sessions, so RSSI is also updated at most once
+  // per window. Reports with new data are always processed.
+  //
+  // Controllers can run out of duplicate filter entries when there are many
+  // advertisers nearby and then forward every report. A zero window (the
+  // default) disables coalescing.
+  void set_result_coalescing_window(pw::chrono::SystemClock::duration window) {
+    result_coalescing_window_ = window;
+  }
+
   // Returns whether there is an active scan in progress.
   bool discovering() const;
 
@@ -184,6 +197,7 @@ class LowEnergyDiscoveryManager final
   struct InspectProperties {
     inspect::Node node;
     inspect::UintProperty failed_count;
+    inspect::UintProperty coalesced_report_count;
     inspect::DoubleProperty scan_interval_ms;
     inspect::DoubleProperty scan_window_ms;
   };
@@ -201,6 +215,11 @@ class LowEnergyDiscoveryManager final
   // to.
   void RemoveSession(LowEnergyDiscoverySession* session);
 
+  // Returns true if |result| repeats the last report processed for |peer|
+  // within the result coalescing window.
+  bool IsRepeatedReport(const Peer& peer,
+                        const hci::LowEnergyScanResult& result) const;
+
   // hci::LowEnergyScanner::Delegate override:
   void OnPeerFound(const hci::LowEnergyScanResult& result) override;
   void OnDirectedAdvertisement(const hci::LowEnergyScanResult& result) override;
@@ -280,6 +299,11 @@ class LowEnergyDiscoveryManager final
   // The value (in ms) that we use for the duration of each scan period.
   pw::chrono::SystemClock::duration scan_period_ = kLEGeneralDiscoveryScanMin;
 
+  // Repeated reports from a peer within this window are dropped. Zero disables
+  // coalescing.
+  pw::chrono::SystemClock::duration result_coalescing_window_ =
+      pw::chrono::SystemClock::duration::zero();
+
   // Count of the number of outstanding PauseTokens. When |paused_count_| is 0,
   // discovery is unpaused.
   IntInspectable<int> paused_count_;
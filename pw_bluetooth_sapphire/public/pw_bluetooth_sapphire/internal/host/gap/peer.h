@@ -207,6 +207,12 @@ class Peer final {
       }
       return std::cref(parsed_adv_data_.value());
     }
+    // Returns true if |data| is identical to the most recently received
+    // advertising and scan response data, and that data parsed successfully.
+    bool AdvertisingDataMatches(const ByteBuffer& data) const {
+      return parsed_adv_data_.is_ok() && adv_data_buffer_ == data;
+    }
+
     // Returns the timestamp associated with the most recently successfully
     // parsed AdvertisingData.
     std::optional<pw::chrono::SystemClock::time_point>
@@ -178,6 +178,7 @@ class LogicalLink : public hci::AclDataChannel::ConnectionInterface {
   bt::LinkType type() const override { return type_; }
   std::unique_ptr<hci::ACLDataPacket> GetNextOutboundPacket() override;
   bool HasAvailablePacket() const override;
+  size_t scheduling_weight() const override;
 
  private:
   friend class ChannelImpl;
@@ -257,6 +258,10 @@ class LogicalLink : public hci::AclDataChannel::ConnectionInterface {
   // Returns nullptr if there are no connections with pending packets
   void RoundRobinChannels();
 
+  // Returns a channel that requested a non-normal ACL priority and has PDUs
+  // queued, or nullptr if there is none.
+  ChannelImpl* NextPriorityChannelWithPDUs() const;
+
   pw::async::Dispatcher& pw_dispatcher_;
 
   sm::SecurityProperties security_;
@@ -299,6 +304,14 @@ class LogicalLink : public hci::AclDataChannel::ConnectionInterface {
   // Channel that Logical Link is currently sending PDUs from
   ChannelImpl::WeakPtr current_pdus_channel_;
 
+  // Number of PDUs that have been sent from prioritized channels since a
+  // channel was last picked by round robin. Channels that requested a
+  // non-normal ACL priority (e.g. A2DP streams) send up to
+  // |kPrioritySchedulingWeight| PDUs for every PDU picked by round robin, and
+  // the link asks AclDataChannel for the same share of controller buffers.
+  static constexpr size_t kPrioritySchedulingWeight = 4;
+  size_t priority_pdus_sent_ = 0;
+
   // Manages the L2CAP signaling channel on this logical link. Depending on
   // |type_| this will either implement the LE or BR/EDR signaling commands.
   std::unique_ptr<SignalingChannel> signaling_channel_;
@@ -93,6 +93,16 @@ class PDU final {
   // this is called, the PDU will become invalid.
   FragmentList ReleaseFragments();
 
+  // Returns up to |size| bytes of the basic-frame information payload starting
+  // at offset |pos| as a buffer, releasing the fragments. Once this is called,
+  // the PDU will become invalid.
+  //
+  // If the PDU consists of a single fragment, the returned buffer refers to the
+  // fragment's payload and keeps the fragment alive, so no data is copied.
+  // Otherwise the fragments are copied into a new contiguous buffer.
+  ByteBufferPtr ReleasePayload(
+      size_t pos = 0, size_t size = std::numeric_limits<std::size_t>::max());
+
   void set_trace_id(trace_flow_id_t id) { trace_id_ = id; }
   trace_flow_id_t trace_id() { return trace_id_; }
 
@@ -218,6 +218,10 @@ class MockController final : public ControllerTestDoubleBase,
   // been received.
   bool AllExpectedIsoPacketsSent() const;
 
+  // Returns the number of batches of ACL data packets that have been sent to
+  // the controller with SendAclDataBatch().
+  size_t acl_data_batch_count() const { return acl_data_batch_count_; }
+
   // Callback to invoke when a packet is received over the data channel. Care
   // should be taken to ensure that a callback with a reference to test case
   // variables is not invoked when tearing down.
@@ -242,6 +246,8 @@ class MockController final : public ControllerTestDoubleBase,
   // Controller overrides:
   void SendCommand(pw::span<const std::byte> data) override;
   void SendAclData(pw::span<const std::byte> data) override;
+  void SendAclDataBatch(
+      pw::span<const pw::span<const std::byte>> packets) override;
   void SendScoData(pw::span<const std::byte> data) override;
   void SendIsoData(pw::span<const std::byte> data) override;
 
@@ -251,6 +257,7 @@ class MockController final : public ControllerTestDoubleBase,
   std::queue<IsoTransaction> iso_transactions_;
   DataCallback data_callback_;
   TransactionCallback transaction_callback_;
+  size_t acl_data_batch_count_ = 0;
 
   BT_DISALLOW_COPY_AND_ASSIGN_ALLOW_MOVE(MockController);
 };
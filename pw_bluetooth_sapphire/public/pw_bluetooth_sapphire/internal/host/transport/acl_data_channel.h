@@ -60,6 +60,12 @@ class AclDataChannel {
 
     // Returns true if link has a queued packet
     virtual bool HasAvailablePacket() const = 0;
+
+    // Returns the maximum number of packets that may be sent from this link
+    // each time the round-robin scheduler visits it. Links carrying
+    // latency-sensitive traffic (e.g. audio) use a larger weight so that bulk
+    // transfers on other links take a smaller share of the controller buffer.
+    virtual size_t scheduling_weight() const { return 1; }
   };
 
   // Registers a connection. Failure to register a connection before sending
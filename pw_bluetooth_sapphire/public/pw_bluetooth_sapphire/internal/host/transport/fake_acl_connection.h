@@ -42,6 +42,8 @@ class FakeAclConnection : public AclDataChannel::ConnectionInterface {
     return queued_packets_;
   }
 
+  void set_scheduling_weight(size_t weight) { scheduling_weight_ = weight; }
+
   WeakPtr<ConnectionInterface> GetWeakPtr() {
     return weak_interface_.GetWeakPtr();
   }
@@ -62,11 +64,14 @@ class FakeAclConnection : public AclDataChannel::ConnectionInterface {
 
   bool HasAvailablePacket() const override { return !queued_packets_.empty(); }
 
+  size_t scheduling_weight() const override { return scheduling_weight_; }
+
  private:
   hci_spec::ConnectionHandle handle_;
   bt::LinkType type_;
   AclDataChannel* data_channel_;
   std::queue<ACLDataPacketPtr> queued_packets_;
+  size_t scheduling_weight_ = 1;
   WeakSelf<ConnectionInterface> weak_interface_;
 };
 }  // namespace
@@ -16,6 +16,7 @@
 #include <memory>
 
 #include "pw_bluetooth_sapphire/internal/host/common/macros.h"
+#include "pw_bluetooth_sapphire/internal/host/common/slab_allocator.h"
 #include "pw_bluetooth_sapphire/internal/host/hci-spec/constants.h"
 #include "pw_bluetooth_sapphire/internal/host/hci-spec/protocol.h"
 #include "pw_bluetooth_sapphire/internal/host/transport/packet.h"
@@ -84,10 +85,12 @@ class FixedSizePacketStorage {
 
 // A FixedSizePacket provides fixed-size buffer storage for Packets and is the
 // basis for a slab-allocated Packet. Multiple inheritance is required to
-// initialize the underlying buffer before PacketBase.
+// initialize the underlying buffer before PacketBase. Instances are allocated
+// with the allocator set by bt::SetSlabAllocator().
 template <typename HeaderType, size_t BufferSize>
 class FixedSizePacket : public FixedSizePacketStorage<BufferSize>,
-                        public Packet<HeaderType> {
+                        public Packet<HeaderType>,
+                        public SlabAllocated {
  public:
   explicit FixedSizePacket(size_t payload_size = 0u)
       : Packet<HeaderType>(
@@ -40,7 +40,7 @@
 //   3. pw_boot_Entry()
 //     3.0. Initialize critical registers (VTOR, SP)
 //     3.1. pw_boot_PreStaticMemoryInit();
-//     3.2. Static-init memory (.data, .bss)
+//     3.2. Static-init memory (.data, .bss, but not deferred zero-init memory)
 //     3.3. pw_boot_PreStaticConstructorInit();
 //     3.4. Static C++ constructors
 //     3.5. pw_boot_PreMainInit()
@@ -53,6 +53,7 @@
 
 #include "pw_boot/boot.h"
 #include "pw_boot_cortex_m/boot.h"
+#include "pw_boot_cortex_m/config.h"
 #include "pw_preprocessor/arch.h"
 #include "pw_preprocessor/compiler.h"
 
@@ -67,6 +68,10 @@
 #error "Your selected Cortex-M arch is not yet supported by this module."
 #endif
 
+#if PW_BOOT_CORTEX_M_MEASURE_STATIC_MEMORY_INIT && _PW_ARCH_ARM_V6M
+#error "ARMv6-M cores have no cycle counter to measure static memory init with"
+#endif
+
 // Extern symbols provided by linker script.
 // These symbols tell us where various memory sections start and end.
 extern uint8_t _pw_static_init_ram_start;
@@ -75,23 +80,145 @@ extern uint8_t _pw_static_init_flash_start;
 extern uint8_t _pw_zero_init_ram_start;
 extern uint8_t _pw_zero_init_ram_end;
 
+// These are weak so that linker scripts without a deferred zero-init section
+// still link, in which case both addresses are 0.
+extern uint8_t _pw_deferred_zero_init_ram_start PW_WEAK;
+extern uint8_t _pw_deferred_zero_init_ram_end PW_WEAK;
+
 // Functions called as part of firmware initialization.
 void __libc_init_array(void);
 
+// Written after static memory is initialized, so it isn't zeroed by it.
+static uint32_t static_memory_init_cycles;
+
+// Copies words four at a time with load/store multiple instructions. This is
+// used instead of memcpy(), which is a byte loop in size-optimized C libraries
+// such as newlib-nano.
+static void CopyWords(uint32_t* dst, const uint32_t* src, size_t words) {
+  uint32_t* const end = dst + words;
+  uint32_t* const blocks_end = dst + (words & ~(size_t)3);
+  if (dst != blocks_end) {
+    asm volatile(
+        "1:                        \n"
+        "ldmia %[src]!, {r0-r3}    \n"
+        "stmia %[dst]!, {r0-r3}    \n"
+        "cmp %[dst], %[blocks_end] \n"
+        "bne 1b                    \n"
+        : [src] "+l"(src), [dst] "+l"(dst)
+        : [blocks_end] "l"(blocks_end)
+        : "r0", "r1", "r2", "r3", "cc", "memory");
+  }
+  while (dst != end) {
+    *dst++ = *src++;
+  }
+}
+
+// Zeroes words four at a time with store multiple instructions.
+static void ZeroWords(uint32_t* dst, size_t words) {
+  uint32_t* const end = dst + words;
+  uint32_t* const blocks_end = dst + (words & ~(size_t)3);
+  if (dst != blocks_end) {
+    asm volatile(
+        "movs r0, #0               \n"
+        "movs r1, #0               \n"
+        "movs r2, #0               \n"
+        "movs r3, #0               \n"
+        "1:                        \n"
+        "stmia %[dst]!, {r0-r3}    \n"
+        "cmp %[dst], %[blocks_end] \n"
+        "bne 1b                    \n"
+        : [dst] "+l"(dst)
+        : [blocks_end] "l"(blocks_end)
+        : "r0", "r1", "r2", "r3", "cc", "memory");
+  }
+  while (dst != end) {
+    *dst++ = 0;
+  }
+}
+
+static bool IsWordAligned(uintptr_t value) {
+  return value % sizeof(uint32_t) == 0;
+}
+
+// The linker script aligns the static memory sections to words, but fall back
+// to the C library for custom linker scripts that don't.
+static void CopyMemory(uint8_t* dst, const uint8_t* src, size_t size) {
+  if (IsWordAligned((uintptr_t)dst | (uintptr_t)src | size)) {
+    CopyWords((uint32_t*)dst, (const uint32_t*)src, size / sizeof(uint32_t));
+  } else {
+    memcpy(dst, src, size);
+  }
+}
+
+static void ZeroMemory(uint8_t* dst, size_t size) {
+  if (IsWordAligned((uintptr_t)dst | size)) {
+    ZeroWords((uint32_t*)dst, size / sizeof(uint32_t));
+  } else {
+    memset(dst, 0, size);
+  }
+}
+
+#if PW_BOOT_CORTEX_M_MEASURE_STATIC_MEMORY_INIT
+
+// ARMv7-M Architecture Reference Manual DDI 0403E.b sections C1.6.5 and C1.8.
+static volatile uint32_t* const kDemcr = (volatile uint32_t*)0xE000EDFCu;
+static volatile uint32_t* const kDwtCtrl = (volatile uint32_t*)0xE0001000u;
+static volatile uint32_t* const kDwtCyccnt = (volatile uint32_t*)0xE0001004u;
+
+static uint32_t StartCycleCounter(void) {
+  *kDemcr |= 1u << 24;   // TRCENA
+  *kDwtCtrl |= 1u << 0;  // CYCCNTENA
+  return *kDwtCyccnt;
+}
+
+static uint32_t CycleCount(void) { return *kDwtCyccnt; }
+
+#endif  // PW_BOOT_CORTEX_M_MEASURE_STATIC_MEMORY_INIT
+
 // WARNING: Be EXTREMELY careful when running code before this function
 // completes. The context before this function violates the C spec
 // (Section 6.7.8, paragraph 10 for example, which requires uninitialized static
 // values to be zero-initialized).
 void StaticMemoryInit(void) {
-  // Static-init RAM (load static values into ram, .data section init).
-  memcpy(&_pw_static_init_ram_start,
-         &_pw_static_init_flash_start,
-         &_pw_static_init_ram_end - &_pw_static_init_ram_start);
+  const size_t static_init_size =
+      &_pw_static_init_ram_end - &_pw_static_init_ram_start;
+
+  // Static-init RAM (load static values into ram, .data section init). If the
+  // target starts copying with DMA, the copy overlaps with zeroing .bss.
+#if PW_BOOT_CORTEX_M_STATIC_DATA_COPY_HOOKS
+  const bool copy_started =
+      static_init_size != 0 &&
+      pw_boot_StartStaticDataCopy(&_pw_static_init_ram_start,
+                                  &_pw_static_init_flash_start,
+                                  static_init_size);
+#else
+  const bool copy_started = false;
+#endif  // PW_BOOT_CORTEX_M_STATIC_DATA_COPY_HOOKS
+  if (!copy_started) {
+    CopyMemory(&_pw_static_init_ram_start,
+               &_pw_static_init_flash_start,
+               static_init_size);
+  }
 
   // Zero-init RAM (.bss section init).
-  memset(&_pw_zero_init_ram_start,
-         0,
-         &_pw_zero_init_ram_end - &_pw_zero_init_ram_start);
+  ZeroMemory(&_pw_zero_init_ram_start,
+             &_pw_zero_init_ram_end - &_pw_zero_init_ram_start);
+
+#if PW_BOOT_CORTEX_M_STATIC_DATA_COPY_HOOKS
+  if (copy_started) {
+    pw_boot_FinishStaticDataCopy();
+  }
+#endif  // PW_BOOT_CORTEX_M_STATIC_DATA_COPY_HOOKS
+}
+
+void pw_boot_ZeroInitDeferredMemory(void) {
+  ZeroMemory(&_pw_deferred_zero_init_ram_start,
+             &_pw_deferred_zero_init_ram_end -
+                 &_pw_deferred_zero_init_ram_start);
+}
+
+uint32_t pw_boot_StaticMemoryInitCycles(void) {
+  return static_memory_init_cycles;
 }
 
 // WARNING: This code is run immediately upon boot, and performs initialization
@@ -162,7 +289,13 @@ void _pw_boot_Entry(void) {
   // example, which requires uninitialized static values to be
   // zero-initialized). Be EXTREMELY careful when running code before this
   // function finishes static memory initialization.
+#if PW_BOOT_CORTEX_M_MEASURE_STATIC_MEMORY_INIT
+  const uint32_t static_memory_init_start = StartCycleCounter();
+  StaticMemoryInit();
+  static_memory_init_cycles = CycleCount() - static_memory_init_start;
+#else
   StaticMemoryInit();
+#endif  // PW_BOOT_CORTEX_M_MEASURE_STATIC_MEMORY_INIT
 
   // Reenable interrupts.
   //
@@ -41,6 +41,8 @@
 // In pw_boot_Entry():
 //   Initialize memory -> pw_PreMainInit() -> main()
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "pw_preprocessor/compiler.h"
@@ -75,4 +77,52 @@ extern uint8_t pw_boot_heap_high_addr;
 // can be used to set VTOR (vector table offset register) by the bootloader.
 extern uint8_t pw_boot_vector_table_addr;
 
+// Places a zero-initialized variable in RAM that isn't zeroed during boot, to
+// shorten the time until main() starts. Such variables MUST NOT be accessed
+// until pw_boot_ZeroInitDeferredMemory() has zeroed them, so this is only
+// suitable for large buffers that are not needed during early initialization.
+// Variables with constructors must not be deferred, since their constructors
+// run before they are zeroed.
+//
+// Example:
+//   PW_BOOT_DEFERRED_ZERO_INIT std::array<std::byte, 64 * 1024> log_buffer;
+//
+// Deferring requires a linker script that places the
+// .bss.pw_boot_deferred_zero_init section outside .bss and defines
+// _pw_deferred_zero_init_ram_[start/end], such as basic_cortex_m.ld. Other
+// linker scripts place the variables in .bss, where they are zeroed during
+// boot like any other variable.
+#define PW_BOOT_DEFERRED_ZERO_INIT \
+  PW_PLACE_IN_SECTION(".bss.pw_boot_deferred_zero_init")
+
+// Zeroes the variables declared with PW_BOOT_DEFERRED_ZERO_INIT. This should
+// be called once, after time-critical initialization and before any of the
+// variables are used. This may be called with interrupts enabled, but not
+// concurrently with any use of the variables.
+void pw_boot_ZeroInitDeferredMemory(void);
+
+// Returns the number of CPU cycles pw_boot_Entry() spent initializing static
+// memory, or 0 if PW_BOOT_CORTEX_M_MEASURE_STATIC_MEMORY_INIT is disabled.
+//
+// This can be exported as a metric after boot:
+//   PW_METRIC_GLOBAL(boot_static_memory_init_cycles,
+//                    "static_memory_init_cycles",
+//                    0u);
+//   boot_static_memory_init_cycles.Set(pw_boot_StaticMemoryInitCycles());
+uint32_t pw_boot_StaticMemoryInitCycles(void);
+
+// The following functions are only called when
+// PW_BOOT_CORTEX_M_STATIC_DATA_COPY_HOOKS is enabled, in which case the target
+// must implement them. They run before static memory is initialized, so they
+// MUST NOT access static or global variables. Interrupts are disabled.
+
+// Starts copying |size| bytes of .data from |src| in flash to |dst| in RAM,
+// typically with a DMA controller. The CPU zero-initializes .bss while the
+// copy is in progress. Returns false if the copy was not started, in which
+// case the CPU copies .data instead.
+bool pw_boot_StartStaticDataCopy(void* dst, const void* src, size_t size);
+
+// Blocks until the copy started by pw_boot_StartStaticDataCopy() completes.
+void pw_boot_FinishStaticDataCopy(void);
+
 PW_EXTERN_C_END
@@ -0,0 +1,31 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// When enabled, pw_boot_Entry() offers the copy of .data from flash to RAM to
+// pw_boot_StartStaticDataCopy(), so that it can be done by a DMA controller
+// while the CPU zero-initializes .bss. Targets that enable this must implement
+// pw_boot_StartStaticDataCopy() and pw_boot_FinishStaticDataCopy().
+#ifndef PW_BOOT_CORTEX_M_STATIC_DATA_COPY_HOOKS
+#define PW_BOOT_CORTEX_M_STATIC_DATA_COPY_HOOKS 0
+#endif  // PW_BOOT_CORTEX_M_STATIC_DATA_COPY_HOOKS
+
+// When enabled, pw_boot_Entry() counts the CPU cycles spent initializing
+// static memory with the DWT cycle counter, which is enabled if it isn't
+// already. The count is returned by pw_boot_StaticMemoryInitCycles().
+//
+// ARMv6-M cores don't have a cycle counter, so this is not supported on them.
+#ifndef PW_BOOT_CORTEX_M_MEASURE_STATIC_MEMORY_INIT
+#define PW_BOOT_CORTEX_M_MEASURE_STATIC_MEMORY_INIT 0
+#endif  // PW_BOOT_CORTEX_M_MEASURE_STATIC_MEMORY_INIT
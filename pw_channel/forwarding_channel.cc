@@ -107,6 +107,7 @@ Result<channel::WriteToken> ForwardingChannel<DataType::kByte>::DoWrite(
 
   write_token_ += data.size();
   sibling_.read_queue_.PushSuffix(std::move(data));
+  std::move(sibling_.read_waker_).Wake();
   return CreateWriteToken(write_token_);
 }
 
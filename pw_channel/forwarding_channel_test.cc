@@ -377,6 +377,39 @@ TEST(ForwardingByteChannel, WriteData) {
   EXPECT_EQ(test_task.test_completed, 1);
 }
 
+TEST(ForwardingByteChannel, WriteAwakensReader) {
+  class ReadOnce : public Task {
+   public:
+    ReadOnce(ByteReader& reader) : reader_(reader) {}
+
+    pw::InlineString<128> contents;
+
+   private:
+    pw::async2::Poll<> DoPend(Context& cx) final {
+      Poll<Result<MultiBuf>> read = reader_.PendRead(cx);
+      if (read.IsPending()) {
+        return Pending();
+      }
+      EXPECT_EQ(read->status(), pw::OkStatus());
+      contents = CopyToString(**read);
+      return Ready();
+    }
+    ByteReader& reader_;
+  };
+
+  pw::async2::Dispatcher dispatcher;
+  TestChannelPair<pw::channel::DataType::kByte> pair;
+  ReadOnce read_task(pair->first());
+  dispatcher.Post(read_task);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+
+  InitializedMultiBuf data("hello");
+  EXPECT_EQ(pw::OkStatus(), pair->second().Write(data.Take()).status());
+
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Ready());
+  EXPECT_EQ(read_task.contents, "hello");
+}
+
 TEST(ForwardingByteChannel, PendCloseAwakensAndClosesPeer) {
   class TryToReadUntilClosed : public Task {
    public:
@@ -0,0 +1,214 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_channel/io_uring_channel.h"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "pw_log/log.h"
+#include "pw_status/try.h"
+
+namespace pw::channel {
+namespace {
+
+// Prepares an entry for reading into or writing from ``data`` at the current
+// file position, using a registered buffer if one contains ``data``.
+io_uring_sqe PrepareReadWrite(async2::Dispatcher& dispatcher,
+                              uint8_t opcode,
+                              uint8_t fixed_opcode,
+                              int fd,
+                              ConstByteSpan data) {
+  io_uring_sqe sqe{};
+  sqe.opcode = opcode;
+  sqe.fd = fd;
+  sqe.off = static_cast<uint64_t>(-1);
+  sqe.addr = reinterpret_cast<uintptr_t>(data.data());
+  sqe.len = static_cast<uint32_t>(data.size());
+  std::optional<uint16_t> buf_index =
+      dispatcher.NativeFindRegisteredBuffer(data);
+  if (buf_index.has_value()) {
+    sqe.opcode = fixed_opcode;
+    sqe.buf_index = *buf_index;
+  }
+  return sqe;
+}
+
+}  // namespace
+
+void IoUringChannel::Register() {
+  // io_uring completes operations once the file descriptor is ready, but
+  // returns EAGAIN for nonblocking file descriptors instead.
+  int flags = fcntl(channel_fd_, F_GETFL);
+  if (flags == -1 || fcntl(channel_fd_, F_SETFL, flags & ~O_NONBLOCK) != 0) {
+    PW_LOG_ERROR("Failed to make channel file descriptor blocking: %s",
+                 std::strerror(errno));
+    set_closed();
+  }
+}
+
+async2::Poll<Result<multibuf::MultiBuf>> IoUringChannel::DoPendRead(
+    async2::Context& cx) {
+  if (!read_buffer_.has_value()) {
+    if (!allocation_future_.has_value()) {
+      allocation_future_ = allocator_->AllocateContiguousAsync(
+          kMinimumReadSize, kDesiredReadSize);
+    }
+    async2::Poll<std::optional<multibuf::MultiBuf>> maybe_multibuf =
+        allocation_future_->Pend(cx);
+    if (maybe_multibuf.IsPending()) {
+      return async2::Pending();
+    }
+
+    allocation_future_ = std::nullopt;
+
+    if (!maybe_multibuf->has_value()) {
+      PW_LOG_ERROR("Failed to allocate multibuf for reading");
+      return Status::ResourceExhausted();
+    }
+
+    multibuf::MultiBuf buf = std::move(**maybe_multibuf);
+    multibuf::Chunk& chunk = *buf.ChunkBegin();
+    PW_TRY(dispatcher_->NativeSubmit(
+        read_op_,
+        PrepareReadWrite(*dispatcher_,
+                         IORING_OP_READ,
+                         IORING_OP_READ_FIXED,
+                         channel_fd_,
+                         ConstByteSpan(chunk.data(), chunk.size()))));
+    read_buffer_ = std::move(buf);
+  }
+
+  async2::Poll<int> result = read_op_.Pend(cx);
+  if (result.IsPending()) {
+    return async2::Pending();
+  }
+
+  multibuf::MultiBuf buf = std::move(*read_buffer_);
+  read_buffer_ = std::nullopt;
+
+  if (*result < 0) {
+    PW_LOG_ERROR("io_uring channel read failed: %s", std::strerror(-*result));
+    return Status::Internal();
+  }
+  if (*result == 0) {
+    return Status::OutOfRange();
+  }
+  buf.Truncate(static_cast<size_t>(*result));
+  return async2::Ready(std::move(buf));
+}
+
+async2::Poll<Status> IoUringChannel::DoPendReadyToWrite(async2::Context& cx) {
+  // Only one write is in flight at a time.
+  return PendWrites(cx);
+}
+
+Result<channel::WriteToken> IoUringChannel::DoWrite(
+    multibuf::MultiBuf&& data) {
+  if (write_data_.has_value()) {
+    return Status::Unavailable();
+  }
+
+  const uint32_t token = write_token_++;
+  write_data_ = std::move(data);
+  write_offset_ = 0;
+  Status status = SubmitWrite();
+  if (!status.ok()) {
+    write_data_ = std::nullopt;
+    return status;
+  }
+  if (!write_data_.has_value()) {
+    flushed_write_token_ = token;
+  }
+  return CreateWriteToken(token);
+}
+
+async2::Poll<Result<channel::WriteToken>> IoUringChannel::DoPendFlush(
+    async2::Context& cx) {
+  async2::Poll<Status> status = PendWrites(cx);
+  if (status.IsPending()) {
+    return async2::Pending();
+  }
+  PW_TRY(*status);
+  return CreateWriteToken(flushed_write_token_);
+}
+
+Status IoUringChannel::SubmitWrite() {
+  size_t offset = write_offset_;
+  for (multibuf::Chunk& chunk : write_data_->Chunks()) {
+    if (offset >= chunk.size()) {
+      offset -= chunk.size();
+      continue;
+    }
+    return dispatcher_->NativeSubmit(
+        write_op_,
+        PrepareReadWrite(*dispatcher_,
+                         IORING_OP_WRITE,
+                         IORING_OP_WRITE_FIXED,
+                         channel_fd_,
+                         ConstByteSpan(chunk.data(), chunk.size())
+                             .subspan(offset)));
+  }
+  // Everything has been written.
+  write_data_ = std::nullopt;
+  return OkStatus();
+}
+
+async2::Poll<Status> IoUringChannel::PendWrites(async2::Context& cx) {
+  while (write_data_.has_value()) {
+    async2::Poll<int> result = write_op_.Pend(cx);
+    if (result.IsPending()) {
+      return async2::Pending();
+    }
+    if (*result < 0) {
+      PW_LOG_ERROR("io_uring channel write failed: %s",
+                   std::strerror(-*result));
+      write_data_ = std::nullopt;
+      return Status::Internal();
+    }
+
+    // Writes may be partial, in which case the rest is submitted next.
+    write_offset_ += static_cast<size_t>(*result);
+    Status status = SubmitWrite();
+    if (!status.ok()) {
+      write_data_ = std::nullopt;
+      return status;
+    }
+    if (!write_data_.has_value()) {
+      flushed_write_token_ = write_token_ - 1;
+    }
+  }
+  return OkStatus();
+}
+
+void IoUringChannel::Cleanup() {
+  if (is_read_or_write_open()) {
+    set_closed();
+  }
+  // The kernel refers to the operations and their buffers until they
+  // complete.
+  dispatcher_->NativeCancel(read_op_);
+  dispatcher_->NativeCancel(write_op_);
+  read_buffer_ = std::nullopt;
+  write_data_ = std::nullopt;
+  if (channel_fd_ != -1) {
+    close(channel_fd_);
+    channel_fd_ = -1;
+  }
+}
+
+}  // namespace pw::channel
@@ -0,0 +1,127 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/poll.h"
+#include "pw_channel/channel.h"
+#include "pw_multibuf/allocator.h"
+#include "pw_multibuf/multibuf.h"
+
+namespace pw::channel {
+
+/// @defgroup pw_channel_io_uring
+/// @{
+
+/// Channel implementation which writes to and reads from a file descriptor
+/// through the io_uring of a ``Dispatcher``.
+///
+/// Reads and writes are submitted to the kernel as asynchronous operations,
+/// so the file descriptor never needs to be polled for readiness. Buffers
+/// within those registered with ``Dispatcher::NativeRegisterBuffers`` are read
+/// and written without being mapped for each operation.
+///
+/// This channel depends on APIs provided by the io_uring ``Dispatcher`` and
+/// cannot be used with any other dispatcher backend.
+///
+/// An instantiated IoUringChannel takes ownership of the file descriptor it is
+/// given, and will close it if the channel is closed or destroyed. Users should
+/// not close a channel's file descriptor from outside.
+///
+/// As the kernel refers to a channel while its operations are in flight,
+/// channels cannot be moved.
+class IoUringChannel : public ByteReaderWriter {
+ public:
+  IoUringChannel(int channel_fd,
+                 async2::Dispatcher& dispatcher,
+                 multibuf::MultiBufAllocator& allocator)
+      : channel_fd_(channel_fd),
+        dispatcher_(&dispatcher),
+        allocator_(&allocator) {
+    Register();
+  }
+
+  ~IoUringChannel() override { Cleanup(); }
+
+  IoUringChannel(const IoUringChannel&) = delete;
+  IoUringChannel& operator=(const IoUringChannel&) = delete;
+
+  IoUringChannel(IoUringChannel&&) = delete;
+  IoUringChannel& operator=(IoUringChannel&&) = delete;
+
+ private:
+  static constexpr size_t kMinimumReadSize = 64;
+  static constexpr size_t kDesiredReadSize = 1024;
+
+  void Register();
+
+  async2::Poll<Result<multibuf::MultiBuf>> DoPendRead(
+      async2::Context& cx) override;
+
+  async2::Poll<Status> DoPendReadyToWrite(async2::Context& cx) final;
+
+  multibuf::MultiBufAllocator& DoGetWriteAllocator() final {
+    return *allocator_;
+  }
+
+  Result<channel::WriteToken> DoWrite(multibuf::MultiBuf&& data) final;
+
+  async2::Poll<Result<channel::WriteToken>> DoPendFlush(
+      async2::Context& cx) final;
+
+  async2::Poll<Status> DoPendClose(async2::Context&) final {
+    Cleanup();
+    return async2::Ready(OkStatus());
+  }
+
+  void set_closed() {
+    set_read_closed();
+    set_write_closed();
+  }
+
+  // Submits a write of the unwritten part of the chunk of ``write_data_``
+  // at ``write_offset_``, if any.
+  Status SubmitWrite();
+
+  // Waits for the in-flight write, submitting the next ones until all of
+  // ``write_data_`` is written.
+  async2::Poll<Status> PendWrites(async2::Context& cx);
+
+  void Cleanup();
+
+  int channel_fd_;
+  async2::Dispatcher* dispatcher_;
+  multibuf::MultiBufAllocator* allocator_;
+  std::optional<multibuf::MultiBufAllocationFuture> allocation_future_;
+
+  async2::Dispatcher::NativeOperation read_op_;
+  // The buffer being read into by ``read_op_``.
+  std::optional<multibuf::MultiBuf> read_buffer_;
+
+  async2::Dispatcher::NativeOperation write_op_;
+  // The data being written, and how much of it has been written.
+  std::optional<multibuf::MultiBuf> write_data_;
+  size_t write_offset_ = 0;
+
+  uint32_t write_token_ = 0;
+  uint32_t flushed_write_token_ = 0;
+};
+
+/// @}
+
+}  // namespace pw::channel
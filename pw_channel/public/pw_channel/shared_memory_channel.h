@@ -0,0 +1,232 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_allocator/allocator.h"
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/poll.h"
+#include "pw_bytes/span.h"
+#include "pw_channel/channel.h"
+#include "pw_multibuf/allocator.h"
+#include "pw_multibuf/chunk.h"
+#include "pw_multibuf/multibuf.h"
+#include "pw_multibuf/simple_allocator.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::channel {
+
+/// @defgroup pw_channel_shared_memory
+/// @{
+
+/// Descriptor ring for the datagrams sent in one direction of a
+/// `SharedMemoryChannel`.
+///
+/// The ring is a single-producer, single-consumer queue of descriptors, each
+/// of which refers to a datagram in the sender's shared data region. The
+/// sender publishes descriptors, and the receiver releases them once it is
+/// done with their data, in the same order.
+///
+/// Each ring must be placed in memory that both cores can access, and that is
+/// either uncached or kept coherent between them. It must be constructed once,
+/// before either core's channel uses it.
+class SharedMemoryRing {
+ public:
+  /// The number of datagrams that may be in flight in one direction.
+  static constexpr uint32_t kCapacity = 16;
+
+  constexpr SharedMemoryRing() = default;
+
+  SharedMemoryRing(const SharedMemoryRing&) = delete;
+  SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+ private:
+  friend class SharedMemoryChannel;
+
+  struct Descriptor {
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  // Number of datagrams published so far. Only the sender stores this.
+  std::atomic<uint32_t> published_ = 0;
+
+  // Number of datagrams released so far. Only the receiver stores this.
+  std::atomic<uint32_t> released_ = 0;
+
+  std::array<Descriptor, kCapacity> descriptors_ = {};
+};
+
+/// Datagram channel between two cores that share memory.
+///
+/// Each core has a `SharedMemoryChannel`. Datagrams are passed between them
+/// without copying:
+///
+/// - Writers allocate datagrams from the channel's write allocator, which
+///   places them in this core's shared data region (`tx_data`).
+/// - `Write` publishes the datagram's location in the shared `tx_ring` and
+///   rings the peer's doorbell. The channel holds the datagram until the peer
+///   releases it.
+/// - The peer's `PendRead` returns a `MultiBuf` that refers to the datagram in
+///   place. Destroying that `MultiBuf` releases the datagram back to the
+///   sender.
+///
+/// Datagrams that were not allocated from the write allocator are copied into
+/// the shared data region when they are written.
+///
+/// Derived classes implement `DoRingDoorbell` with an inter-core interrupt,
+/// such as a mailbox or software-triggered interrupt, and call
+/// `HandleDoorbell` from that interrupt's handler on the peer core.
+class SharedMemoryChannel : public ReliableDatagramReaderWriter {
+ public:
+  /// @param tx_ring  The ring for datagrams sent by this core. This is the
+  ///                 peer's `rx_ring`.
+  /// @param tx_data  Shared memory that datagrams written to this channel are
+  ///                 allocated from. This is the peer's `rx_data`.
+  /// @param rx_ring  The ring for datagrams sent by the peer.
+  /// @param rx_data  This core's view of the peer's `tx_data`. Its address may
+  ///                 differ from the peer's view of the same memory.
+  /// @param metadata_allocator Allocates bookkeeping for the write
+  ///                 allocator's buffers. It must be thread-safe if datagrams
+  ///                 are written from more than one thread.
+  SharedMemoryChannel(SharedMemoryRing& tx_ring,
+                      ByteSpan tx_data,
+                      SharedMemoryRing& rx_ring,
+                      ByteSpan rx_data,
+                      allocator::Allocator& metadata_allocator);
+
+  SharedMemoryChannel(const SharedMemoryChannel&) = delete;
+  SharedMemoryChannel& operator=(const SharedMemoryChannel&) = delete;
+
+  /// Handles a doorbell from the peer, which indicates that it has published
+  /// or released datagrams. Wakes any pending reader or writer. May be called
+  /// from an interrupt.
+  void HandleDoorbell() PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  static constexpr uint32_t kCapacity = SharedMemoryRing::kCapacity;
+
+  // Allocates datagrams from tx_data. Allocations first reclaim the buffers
+  // of datagrams that the peer has released.
+  class WriteAllocator final : public multibuf::MultiBufAllocator {
+   public:
+    WriteAllocator(SharedMemoryChannel& channel,
+                   ByteSpan data,
+                   allocator::Allocator& metadata_allocator)
+        : channel_(channel), allocator_(data, metadata_allocator) {}
+
+    // Allocates a contiguous buffer without reclaiming released datagrams.
+    std::optional<multibuf::MultiBuf> AllocateContiguousBuffer(size_t size) {
+      return allocator_.AllocateContiguous(size);
+    }
+
+    // Wakes any pending allocations so that they retry.
+    void NotifyMemoryAvailable();
+
+   private:
+    Result<multibuf::MultiBuf> DoAllocate(size_t min_size,
+                                          size_t desired_size,
+                                          bool needs_contiguous) override;
+
+    SharedMemoryChannel& channel_;
+    multibuf::SimpleAllocator allocator_;
+  };
+
+  // Tracks a received datagram, and releases it to the peer once all chunks
+  // that refer to it are freed.
+  class ReceivedDatagram final : public multibuf::ChunkRegionTracker {
+   public:
+    ReceivedDatagram() = default;
+    ~ReceivedDatagram() override = default;
+
+    // Starts tracking a received datagram. Must not be called while a
+    // previous datagram in this slot is in use.
+    void Reset(SharedMemoryChannel& channel, uint32_t slot, ByteSpan region) {
+      channel_ = &channel;
+      slot_ = slot;
+      region_ = region;
+    }
+
+   private:
+    void Destroy() override { channel_->Release(slot_); }
+    ByteSpan Region() const override { return region_; }
+    void* AllocateChunkClass() override;
+    void DeallocateChunkClass(void*) override { chunk_in_use_ = false; }
+
+    SharedMemoryChannel* channel_ = nullptr;
+    uint32_t slot_ = 0;
+    ByteSpan region_;
+    std::atomic<bool> chunk_in_use_ = false;
+    alignas(multibuf::Chunk) std::array<std::byte, sizeof(multibuf::Chunk)>
+        chunk_storage_ = {};
+  };
+
+  /// Notifies the peer core that datagrams were published or released. The
+  /// peer's interrupt handler must call `HandleDoorbell` on its channel.
+  virtual void DoRingDoorbell() = 0;
+
+  // pw::channel::ReliableDatagramReaderWriter implementation.
+  async2::Poll<Result<multibuf::MultiBuf>> DoPendRead(
+      async2::Context& cx) override;
+  multibuf::MultiBufAllocator& DoGetWriteAllocator() override {
+    return write_allocator_;
+  }
+  async2::Poll<Status> DoPendReadyToWrite(async2::Context& cx) override;
+  Result<WriteToken> DoWrite(multibuf::MultiBuf&& data) override;
+  async2::Poll<Result<WriteToken>> DoPendFlush(async2::Context& cx) override;
+  async2::Poll<Status> DoPendClose(async2::Context& cx) override;
+
+  // Frees the buffers of datagrams that the peer has released. Returns
+  // whether any were freed.
+  bool ReclaimWritten() PW_LOCKS_EXCLUDED(lock_);
+
+  // Releases the received datagram in the slot. The peer is notified once all
+  // earlier datagrams are released too.
+  void Release(uint32_t slot) PW_LOCKS_EXCLUDED(lock_);
+
+  // Returns whether a datagram buffer lies within tx_data_.
+  bool IsInSharedRegion(ConstByteSpan buffer) const;
+
+  sync::InterruptSpinLock lock_;
+
+  // Write state.
+  SharedMemoryRing& tx_ring_;
+  const ByteSpan tx_data_;
+  WriteAllocator write_allocator_;
+  std::array<multibuf::MultiBuf, kCapacity> in_flight_ PW_GUARDED_BY(lock_);
+  uint32_t tx_published_ PW_GUARDED_BY(lock_) = 0;
+  uint32_t tx_reclaimed_ PW_GUARDED_BY(lock_) = 0;
+  async2::Waker write_waker_ PW_GUARDED_BY(lock_);
+
+  // Read state.
+  SharedMemoryRing& rx_ring_;
+  const ByteSpan rx_data_;
+  std::array<ReceivedDatagram, kCapacity> received_;
+  std::array<bool, kCapacity> rx_done_ PW_GUARDED_BY(lock_) = {};
+  uint32_t rx_read_ PW_GUARDED_BY(lock_) = 0;
+  uint32_t rx_released_ PW_GUARDED_BY(lock_) = 0;
+  async2::Waker read_waker_ PW_GUARDED_BY(lock_);
+};
+
+/// @}
+
+}  // namespace pw::channel
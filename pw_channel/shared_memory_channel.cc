@@ -0,0 +1,244 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_channel/shared_memory_channel.h"
+
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::channel {
+
+using ::pw::async2::Context;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+using ::pw::async2::WaitReason;
+using ::pw::async2::Waker;
+using ::pw::multibuf::MultiBuf;
+using ::pw::multibuf::OwnedChunk;
+
+// The rings are accessed from both cores, so their counters must not rely on
+// a lock that only one core can take.
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+// Counters wrap around, so slots must divide the counter range evenly.
+static_assert(
+    (SharedMemoryRing::kCapacity & (SharedMemoryRing::kCapacity - 1)) == 0);
+
+SharedMemoryChannel::SharedMemoryChannel(
+    SharedMemoryRing& tx_ring,
+    ByteSpan tx_data,
+    SharedMemoryRing& rx_ring,
+    ByteSpan rx_data,
+    allocator::Allocator& metadata_allocator)
+    : tx_ring_(tx_ring),
+      tx_data_(tx_data),
+      write_allocator_(*this, tx_data, metadata_allocator),
+      rx_ring_(rx_ring),
+      rx_data_(rx_data) {}
+
+void SharedMemoryChannel::HandleDoorbell() {
+  Waker read_waker;
+  Waker write_waker;
+  bool released;
+  {
+    std::lock_guard lock(lock_);
+    read_waker = std::move(read_waker_);
+    write_waker = std::move(write_waker_);
+    released =
+        tx_reclaimed_ != tx_ring_.released_.load(std::memory_order_acquire);
+  }
+  if (released) {
+    // Pending allocations reclaim the released datagrams when they retry.
+    write_allocator_.NotifyMemoryAvailable();
+  }
+  std::move(read_waker).Wake();
+  std::move(write_waker).Wake();
+}
+
+Poll<Result<MultiBuf>> SharedMemoryChannel::DoPendRead(Context& cx) {
+  uint32_t slot;
+  SharedMemoryRing::Descriptor descriptor;
+  {
+    std::lock_guard lock(lock_);
+    if (rx_ring_.published_.load(std::memory_order_acquire) == rx_read_) {
+      read_waker_ = cx.GetWaker(WaitReason::Unspecified());
+      return Pending();
+    }
+    slot = rx_read_ % kCapacity;
+    descriptor = rx_ring_.descriptors_[slot];
+    rx_read_ += 1;
+  }
+
+  if (descriptor.offset > rx_data_.size() ||
+      descriptor.size > rx_data_.size() - descriptor.offset) {
+    Release(slot);
+    return Status::DataLoss();
+  }
+  if (descriptor.size == 0) {
+    Release(slot);
+    return MultiBuf();
+  }
+
+  ReceivedDatagram& datagram = received_[slot];
+  datagram.Reset(
+      *this, slot, rx_data_.subspan(descriptor.offset, descriptor.size));
+  std::optional<OwnedChunk> chunk = datagram.CreateFirstChunk();
+  // The slot's previous chunk was freed before the slot was released.
+  PW_CHECK(chunk.has_value());
+  return MultiBuf::FromChunk(std::move(*chunk));
+}
+
+Poll<Status> SharedMemoryChannel::DoPendReadyToWrite(Context& cx) {
+  std::lock_guard lock(lock_);
+  // Check the ring rather than the reclaimed buffers, so that a release that
+  // races with this check rings the doorbell after the waker is stored.
+  if (tx_published_ - tx_ring_.released_.load(std::memory_order_acquire) <
+      kCapacity) {
+    return Ready(OkStatus());
+  }
+  write_waker_ = cx.GetWaker(WaitReason::Unspecified());
+  return Pending();
+}
+
+Result<WriteToken> SharedMemoryChannel::DoWrite(MultiBuf&& data) {
+  ReclaimWritten();
+
+  SharedMemoryRing::Descriptor descriptor = {0, 0};
+  if (!data.empty()) {
+    std::optional<ByteSpan> contiguous = data.ContiguousSpan();
+    if (!contiguous.has_value() || !IsInSharedRegion(*contiguous)) {
+      // The datagram did not come from the write allocator, so copy it into
+      // shared memory.
+      std::optional<MultiBuf> copy =
+          write_allocator_.AllocateContiguousBuffer(data.size());
+      if (!copy.has_value()) {
+        return Status::ResourceExhausted();
+      }
+      data.CopyTo(*copy->ContiguousSpan()).IgnoreError();  // Sized to fit.
+      data = std::move(*copy);
+      contiguous = data.ContiguousSpan();
+    }
+    descriptor.offset =
+        static_cast<uint32_t>(contiguous->data() - tx_data_.data());
+    descriptor.size = static_cast<uint32_t>(contiguous->size());
+  }
+
+  uint32_t token;
+  {
+    std::lock_guard lock(lock_);
+    if (tx_published_ - tx_reclaimed_ >= kCapacity) {
+      return Status::Unavailable();  // PendReadyToWrite was not Ready.
+    }
+    const uint32_t slot = tx_published_ % kCapacity;
+    in_flight_[slot] = std::move(data);
+    tx_ring_.descriptors_[slot] = descriptor;
+    tx_published_ += 1;
+    tx_ring_.published_.store(tx_published_, std::memory_order_release);
+    token = tx_published_;
+  }
+  DoRingDoorbell();
+  return CreateWriteToken(token);
+}
+
+Poll<Result<WriteToken>> SharedMemoryChannel::DoPendFlush(Context&) {
+  // Written datagrams are published to the peer immediately.
+  std::lock_guard lock(lock_);
+  return Ready(CreateWriteToken(tx_published_));
+}
+
+Poll<Status> SharedMemoryChannel::DoPendClose(Context&) {
+  // Datagrams in flight remain valid until the peer releases them.
+  return Ready(OkStatus());
+}
+
+bool SharedMemoryChannel::ReclaimWritten() {
+  bool reclaimed = false;
+  while (true) {
+    MultiBuf buffer;
+    {
+      std::lock_guard lock(lock_);
+      if (tx_reclaimed_ == tx_ring_.released_.load(std::memory_order_acquire)) {
+        break;
+      }
+      buffer = std::move(in_flight_[tx_reclaimed_ % kCapacity]);
+      tx_reclaimed_ += 1;
+    }
+    // Free the datagram's memory outside of the lock.
+    buffer.Release();
+    reclaimed = true;
+  }
+  if (reclaimed) {
+    write_allocator_.NotifyMemoryAvailable();
+  }
+  return reclaimed;
+}
+
+void SharedMemoryChannel::Release(uint32_t slot) {
+  bool released = false;
+  {
+    std::lock_guard lock(lock_);
+    rx_done_[slot] = true;
+    // The peer reuses slots in order, so only release up to the oldest
+    // datagram that is still in use.
+    while (rx_released_ != rx_read_ && rx_done_[rx_released_ % kCapacity]) {
+      rx_done_[rx_released_ % kCapacity] = false;
+      rx_released_ += 1;
+      released = true;
+    }
+    if (released) {
+      rx_ring_.released_.store(rx_released_, std::memory_order_release);
+    }
+  }
+  if (released) {
+    DoRingDoorbell();
+  }
+}
+
+bool SharedMemoryChannel::IsInSharedRegion(ConstByteSpan buffer) const {
+  return buffer.data() >= tx_data_.data() &&
+         buffer.data() + buffer.size() <= tx_data_.data() + tx_data_.size();
+}
+
+void SharedMemoryChannel::WriteAllocator::NotifyMemoryAvailable() {
+  const size_t size = channel_.tx_data_.size();
+  MoreMemoryAvailable(size, size);
+}
+
+Result<MultiBuf> SharedMemoryChannel::WriteAllocator::DoAllocate(
+    size_t min_size, size_t desired_size, bool) {
+  channel_.ReclaimWritten();
+  if (min_size > channel_.tx_data_.size()) {
+    return Status::OutOfRange();
+  }
+  // Always allocate contiguous buffers, so that they can be written without
+  // copying.
+  std::optional<MultiBuf> buffer =
+      allocator_.AllocateContiguous(min_size, desired_size);
+  if (!buffer.has_value()) {
+    return Status::ResourceExhausted();
+  }
+  return std::move(*buffer);
+}
+
+void* SharedMemoryChannel::ReceivedDatagram::AllocateChunkClass() {
+  bool in_use = false;
+  if (!chunk_in_use_.compare_exchange_strong(in_use, true)) {
+    return nullptr;
+  }
+  return chunk_storage_.data();
+}
+
+}  // namespace pw::channel
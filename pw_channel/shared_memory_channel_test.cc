@@ -0,0 +1,327 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_channel/shared_memory_channel.h"
+
+#include <array>
+#include <cstddef>
+#include <optional>
+
+#include "pw_allocator/testing.h"
+#include "pw_async2/dispatcher.h"
+#include "pw_bytes/span.h"
+#include "pw_multibuf/multibuf.h"
+#include "pw_status/status.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using ::pw::ByteSpan;
+using ::pw::ConstByteSpan;
+using ::pw::OkStatus;
+using ::pw::Result;
+using ::pw::Status;
+using ::pw::async2::Context;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+using ::pw::async2::Task;
+using ::pw::channel::SharedMemoryChannel;
+using ::pw::channel::SharedMemoryRing;
+using ::pw::multibuf::MultiBuf;
+
+// Rings the peer's doorbell by calling its handler directly.
+class TestChannel : public SharedMemoryChannel {
+ public:
+  using SharedMemoryChannel::SharedMemoryChannel;
+
+  void set_peer(TestChannel& peer) { peer_ = &peer; }
+  int doorbells() const { return doorbells_; }
+
+ private:
+  void DoRingDoorbell() override {
+    ++doorbells_;
+    peer_->HandleDoorbell();
+  }
+
+  TestChannel* peer_ = nullptr;
+  int doorbells_ = 0;
+};
+
+// Reads datagrams and keeps them until they are discarded.
+class ReaderTask : public Task {
+ public:
+  explicit ReaderTask(SharedMemoryChannel& channel) : channel_(channel) {}
+
+  std::array<std::optional<MultiBuf>, 20> received;
+  size_t read_count = 0;
+
+ private:
+  Poll<> DoPend(Context& cx) final {
+    while (read_count < received.size()) {
+      Poll<Result<MultiBuf>> result = channel_.PendRead(cx);
+      if (result.IsPending()) {
+        return Pending();
+      }
+      if (!result->ok()) {
+        return Ready();
+      }
+      received[read_count++] = std::move(**result);
+    }
+    return Ready();
+  }
+
+  SharedMemoryChannel& channel_;
+};
+
+// Writes size-byte datagrams with increasing values, either allocated from the
+// channel or from other memory.
+class WriterTask : public Task {
+ public:
+  WriterTask(SharedMemoryChannel& channel, size_t count, size_t size)
+      : channel_(channel), count_(count), size_(size) {}
+
+  void set_external(ByteSpan buffer) { external_ = buffer; }
+
+  size_t write_count = 0;
+
+ private:
+  Poll<> DoPend(Context& cx) final {
+    while (write_count < count_) {
+      if (channel_.PendReadyToWrite(cx).IsPending()) {
+        return Pending();
+      }
+      std::optional<MultiBuf> buffer;
+      if (external_.empty()) {
+        if (!future_.has_value()) {
+          future_ = channel_.GetWriteAllocator().AllocateContiguousAsync(size_);
+        }
+        Poll<std::optional<MultiBuf>> allocation = future_->Pend(cx);
+        if (allocation.IsPending()) {
+          return Pending();
+        }
+        future_.reset();
+        buffer = std::move(*allocation);
+        if (!buffer.has_value()) {
+          return Ready();
+        }
+      } else {
+        buffer = ExternalBuffer();
+      }
+      for (std::byte& b : *buffer) {
+        b = static_cast<std::byte>(write_count);
+      }
+      EXPECT_EQ(channel_.Write(std::move(*buffer)).status(), OkStatus());
+      ++write_count;
+    }
+    return Ready();
+  }
+
+  MultiBuf ExternalBuffer() {
+    return MultiBuf::FromChunk(
+        external_tracker_.Create(external_.first(size_)));
+  }
+
+  // Tracks a buffer outside of the shared memory.
+  class ExternalTracker : public pw::multibuf::ChunkRegionTracker {
+   public:
+    pw::multibuf::OwnedChunk Create(ByteSpan region) {
+      region_ = region;
+      return *CreateFirstChunk();
+    }
+
+   private:
+    void Destroy() override {}
+    ByteSpan Region() const override { return region_; }
+    void* AllocateChunkClass() override { return storage_.data(); }
+    void DeallocateChunkClass(void*) override {}
+
+    ByteSpan region_;
+    alignas(pw::multibuf::Chunk)
+        std::array<std::byte, sizeof(pw::multibuf::Chunk)> storage_;
+  };
+
+  SharedMemoryChannel& channel_;
+  const size_t count_;
+  const size_t size_;
+  ByteSpan external_;
+  ExternalTracker external_tracker_;
+  std::optional<pw::multibuf::MultiBufAllocationFuture> future_;
+};
+
+class SharedMemoryChannelTest : public ::testing::Test {
+ protected:
+  SharedMemoryChannelTest()
+      : core_a_(a_to_b_, a_data_, b_to_a_, b_data_, metadata_a_),
+        core_b_(b_to_a_, b_data_, a_to_b_, a_data_, metadata_b_) {
+    core_a_.set_peer(core_b_);
+    core_b_.set_peer(core_a_);
+  }
+
+  // Returns whether the datagram refers to data in the region.
+  static bool IsIn(const MultiBuf& datagram, ConstByteSpan region) {
+    std::optional<ConstByteSpan> data = datagram.ContiguousSpan();
+    return data.has_value() && data->data() >= region.data() &&
+           data->data() + data->size() <= region.data() + region.size();
+  }
+
+  SharedMemoryRing a_to_b_;
+  SharedMemoryRing b_to_a_;
+  std::array<std::byte, 256> a_data_{};
+  std::array<std::byte, 256> b_data_{};
+  pw::allocator::test::AllocatorForTest<4096> metadata_a_;
+  pw::allocator::test::AllocatorForTest<4096> metadata_b_;
+  TestChannel core_a_;
+  TestChannel core_b_;
+};
+
+TEST_F(SharedMemoryChannelTest, PassesDatagramsWithoutCopying) {
+  ReaderTask reader(core_b_);
+  WriterTask writer(core_a_, 3, 16);
+
+  Dispatcher dispatcher;
+  dispatcher.Post(reader);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+  dispatcher.Post(writer);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+
+  EXPECT_EQ(writer.write_count, 3u);
+  ASSERT_EQ(reader.read_count, 3u);
+  for (size_t i = 0; i < 3; ++i) {
+    const MultiBuf& datagram = *reader.received[i];
+    EXPECT_EQ(datagram.size(), 16u);
+    EXPECT_TRUE(IsIn(datagram, a_data_));
+    EXPECT_EQ(*datagram.begin(), static_cast<std::byte>(i));
+  }
+}
+
+TEST_F(SharedMemoryChannelTest, ReleasesDatagramsInOrder) {
+  ReaderTask reader(core_b_);
+  WriterTask writer(core_a_, 3, 16);
+
+  Dispatcher dispatcher;
+  dispatcher.Post(reader);
+  dispatcher.Post(writer);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+  ASSERT_EQ(reader.read_count, 3u);
+
+  // Releasing a later datagram waits for the earlier ones.
+  const int doorbells = core_b_.doorbells();
+  reader.received[1].reset();
+  EXPECT_EQ(core_b_.doorbells(), doorbells);
+  reader.received[0].reset();
+  EXPECT_EQ(core_b_.doorbells(), doorbells + 1);
+  reader.received[2].reset();
+  EXPECT_EQ(core_b_.doorbells(), doorbells + 2);
+}
+
+TEST_F(SharedMemoryChannelTest, WriterWaitsForReleasedMemory) {
+  ReaderTask reader(core_b_);
+  WriterTask writer(core_a_, 6, 64);
+
+  Dispatcher dispatcher;
+  dispatcher.Post(reader);
+  dispatcher.Post(writer);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+
+  // Only four datagrams fit in the shared memory.
+  EXPECT_EQ(writer.write_count, 4u);
+  EXPECT_EQ(reader.read_count, 4u);
+
+  reader.received[0].reset();
+  reader.received[1].reset();
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+  EXPECT_EQ(writer.write_count, 6u);
+  ASSERT_EQ(reader.read_count, 6u);
+  EXPECT_EQ(*reader.received[5]->begin(), std::byte{5});
+}
+
+TEST_F(SharedMemoryChannelTest, WriterWaitsForFreeDescriptors) {
+  ReaderTask reader(core_b_);
+  WriterTask writer(core_a_, 20, 1);
+
+  Dispatcher dispatcher;
+  dispatcher.Post(reader);
+  dispatcher.Post(writer);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+  EXPECT_EQ(writer.write_count, SharedMemoryRing::kCapacity);
+
+  reader.received[0].reset();
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+  EXPECT_EQ(writer.write_count, SharedMemoryRing::kCapacity + 1);
+
+  for (auto& datagram : reader.received) {
+    datagram.reset();
+  }
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Ready());
+  EXPECT_EQ(writer.write_count, 20u);
+  EXPECT_EQ(reader.read_count, 20u);
+}
+
+TEST_F(SharedMemoryChannelTest, CopiesExternalDatagrams) {
+  std::array<std::byte, 32> external{};
+  ReaderTask reader(core_b_);
+  WriterTask writer(core_a_, 2, 32);
+  writer.set_external(external);
+
+  Dispatcher dispatcher;
+  dispatcher.Post(reader);
+  dispatcher.Post(writer);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+
+  ASSERT_EQ(reader.read_count, 2u);
+  EXPECT_TRUE(IsIn(*reader.received[1], a_data_));
+  EXPECT_EQ(*reader.received[1]->begin(), std::byte{1});
+}
+
+TEST_F(SharedMemoryChannelTest, PassesDatagramsInBothDirections) {
+  ReaderTask reader_a(core_a_);
+  ReaderTask reader_b(core_b_);
+  WriterTask writer_a(core_a_, 2, 8);
+  WriterTask writer_b(core_b_, 3, 8);
+
+  Dispatcher dispatcher;
+  dispatcher.Post(reader_a);
+  dispatcher.Post(reader_b);
+  dispatcher.Post(writer_a);
+  dispatcher.Post(writer_b);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Pending());
+
+  EXPECT_EQ(reader_b.read_count, 2u);
+  ASSERT_EQ(reader_a.read_count, 3u);
+  EXPECT_TRUE(IsIn(*reader_a.received[0], b_data_));
+}
+
+TEST_F(SharedMemoryChannelTest, RejectsCorruptDescriptors) {
+  std::array<std::byte, 16> small{};
+  TestChannel receiver(b_to_a_, b_data_, a_to_b_, small, metadata_b_);
+  receiver.set_peer(core_a_);
+  core_a_.set_peer(receiver);
+
+  ReaderTask reader(receiver);
+  WriterTask writer(core_a_, 1, 32);
+
+  Dispatcher dispatcher;
+  dispatcher.Post(reader);
+  dispatcher.Post(writer);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Ready());
+  EXPECT_EQ(reader.read_count, 0u);
+
+  // The datagram was released back to the sender.
+  EXPECT_EQ(core_a_.doorbells(), 1);
+  EXPECT_EQ(receiver.doorbells(), 1);
+}
+
+}  // namespace
@@ -15,6 +15,26 @@
 #include "pw_checksum/crc32.h"
 
 #include <array>
+#include <cstring>
+
+#include "pw_bytes/endian.h"
+
+#if defined(__ARM_FEATURE_CRC32) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_acle.h>
+#define _PW_CHECKSUM_CRC32_ARM_CRC32 1
+#elif defined(__PCLMUL__) && defined(__SSE2__)
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#define _PW_CHECKSUM_CRC32_X86_PCLMUL 1
+#endif
+
+#ifndef _PW_CHECKSUM_CRC32_ARM_CRC32
+#define _PW_CHECKSUM_CRC32_ARM_CRC32 0
+#endif  // _PW_CHECKSUM_CRC32_ARM_CRC32
+
+#ifndef _PW_CHECKSUM_CRC32_X86_PCLMUL
+#define _PW_CHECKSUM_CRC32_X86_PCLMUL 0
+#endif  // _PW_CHECKSUM_CRC32_X86_PCLMUL
 
 namespace pw::checksum {
 namespace {
@@ -49,12 +69,208 @@ constexpr std::array<uint32_t, (1 << kBits)> GenerateCrc32Table() {
   return table;
 }
 
+// Generates the lookup tables for a slicing-by-kSlices CRC32 implementation.
+// Entry i of table n is the CRC of byte i followed by n zero bytes, which
+// allows kSlices bytes to be processed with kSlices independent lookups.
+template <std::size_t kSlices, uint32_t kPolynomial>
+constexpr std::array<std::array<uint32_t, 256>, kSlices>
+GenerateCrc32SlicingTables() {
+  std::array<std::array<uint32_t, 256>, kSlices> tables{};
+  tables[0] = GenerateCrc32Table<8, kPolynomial>();
+  for (std::size_t slice = 1; slice < kSlices; ++slice) {
+    for (std::size_t i = 0; i < 256; ++i) {
+      const uint32_t previous = tables[slice - 1][i];
+      tables[slice][i] = (previous >> 8) ^ tables[0][previous & 0xFFu];
+    }
+  }
+  return tables;
+}
+
 // Reversed polynomial for the commonly used CRC32 variant. See:
 // https://en.wikipedia.org/wiki/Cyclic_redundancy_check#Polynomial_representations_of_cyclic_redundancy_checks
 constexpr uint32_t kCrc32Polynomial = 0xEDB88320;
 
+// Multiplies two polynomials modulo the CRC32 polynomial. As in CRC32 values,
+// the most significant bit holds the coefficient of x^0.
+constexpr uint32_t MultiplyModCrc32Polynomial(uint32_t a, uint32_t b) {
+  uint32_t product = 0;
+  for (uint32_t bit = 1u << 31; bit != 0; bit >>= 1) {
+    if ((a & bit) != 0) {
+      product ^= b;
+    }
+    b = (b >> 1) ^ ((b & 1u) != 0 ? kCrc32Polynomial : 0);
+  }
+  return product;
+}
+
+// Entry k is x^(2^k) modulo the CRC32 polynomial. The powers repeat after 32
+// entries, since the polynomial's order divides 2^32 - 1.
+constexpr std::array<uint32_t, 32> kCrc32PowersOfX = []() {
+  std::array<uint32_t, 32> powers{};
+  uint32_t power = 1u << 30;  // x^1
+  for (uint32_t& entry : powers) {
+    entry = power;
+    power = MultiplyModCrc32Polynomial(power, power);
+  }
+  return powers;
+}();
+
+// Returns x^(8 * size_bytes) modulo the CRC32 polynomial. Multiplying a CRC32
+// by this appends size_bytes zero bytes to the data it covers, without the
+// initial value and final inversion.
+uint32_t Crc32ShiftFactor(size_t size_bytes) {
+  uint32_t factor = 1u << 31;  // x^0
+  for (size_t k = 3; size_bytes != 0; size_bytes >>= 1, ++k) {
+    if ((size_bytes & 1u) != 0) {
+      factor = MultiplyModCrc32Polynomial(kCrc32PowersOfX[k % 32], factor);
+    }
+  }
+  return factor;
+}
+
+// Processes kSlices bytes per iteration using kSlices lookup tables, then
+// finishes any remaining bytes one at a time.
+template <std::size_t kSlices>
+uint32_t Crc32SlicingBy(
+    const std::array<std::array<uint32_t, 256>, kSlices>& tables,
+    const uint8_t* data_bytes,
+    size_t size_bytes,
+    uint32_t state) {
+  static_assert(kSlices % sizeof(uint32_t) == 0);
+
+  for (; size_bytes >= kSlices; size_bytes -= kSlices) {
+    uint32_t next = 0;
+    for (std::size_t word = 0; word < kSlices; word += sizeof(uint32_t)) {
+      uint32_t value = bytes::ReadInOrder<uint32_t>(endian::little, data_bytes);
+      data_bytes += sizeof(uint32_t);
+      if (word == 0) {
+        value ^= state;
+      }
+      for (std::size_t byte = 0; byte < sizeof(uint32_t); ++byte) {
+        const uint32_t index = (value >> (8 * byte)) & 0xFFu;
+        next ^= tables[kSlices - 1 - word - byte][index];
+      }
+    }
+    state = next;
+  }
+
+  for (size_t i = 0; i < size_bytes; ++i) {
+    state = tables[0][(state ^ data_bytes[i]) & 0xFFu] ^ (state >> 8);
+  }
+
+  return state;
+}
+
+constexpr std::array<std::array<uint32_t, 256>, 8> kCrc32SlicingBy8Tables =
+    GenerateCrc32SlicingTables<8, kCrc32Polynomial>();
+
+#if _PW_CHECKSUM_CRC32_X86_PCLMUL
+
+// Folds 16-byte blocks with carry-less multiplication and reduces the result
+// with a Barrett reduction. size_bytes must be a multiple of 16 and at least
+// 64. The constants are powers of x modulo the CRC32 polynomial; see Intel's
+// "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+uint32_t Crc32Pclmul(const uint8_t* data_bytes,
+                     size_t size_bytes,
+                     uint32_t state) {
+  alignas(16) static constexpr uint64_t kK1K2[2] = {0x0154442bd4,
+                                                    0x01c6e41596};
+  alignas(16) static constexpr uint64_t kK3K4[2] = {0x01751997d0,
+                                                    0x00ccaa009e};
+  alignas(16) static constexpr uint64_t kK5K0[2] = {0x0163cd6124, 0};
+  alignas(16) static constexpr uint64_t kPoly[2] = {0x01db710641,
+                                                    0x01f7011641};
+
+  const auto load = [](const uint8_t* bytes) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+  };
+  const auto fold = [](__m128i value, __m128i next, __m128i constants) {
+    const __m128i low = _mm_clmulepi64_si128(value, constants, 0x00);
+    const __m128i high = _mm_clmulepi64_si128(value, constants, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(high, low), next);
+  };
+
+  // Fold four blocks in parallel while at least 64 bytes remain.
+  __m128i x1 = _mm_xor_si128(load(data_bytes),
+                             _mm_cvtsi32_si128(static_cast<int>(state)));
+  __m128i x2 = load(data_bytes + 16);
+  __m128i x3 = load(data_bytes + 32);
+  __m128i x4 = load(data_bytes + 48);
+  data_bytes += 64;
+  size_bytes -= 64;
+
+  __m128i constants = _mm_load_si128(reinterpret_cast<const __m128i*>(kK1K2));
+  for (; size_bytes >= 64; size_bytes -= 64, data_bytes += 64) {
+    x1 = fold(x1, load(data_bytes), constants);
+    x2 = fold(x2, load(data_bytes + 16), constants);
+    x3 = fold(x3, load(data_bytes + 32), constants);
+    x4 = fold(x4, load(data_bytes + 48), constants);
+  }
+
+  // Fold the four blocks into one, then fold in any remaining blocks.
+  constants = _mm_load_si128(reinterpret_cast<const __m128i*>(kK3K4));
+  x1 = fold(x1, x2, constants);
+  x1 = fold(x1, x3, constants);
+  x1 = fold(x1, x4, constants);
+  for (; size_bytes >= 16; size_bytes -= 16, data_bytes += 16) {
+    x1 = fold(x1, load(data_bytes), constants);
+  }
+
+  // Reduce 128 bits to 64 bits.
+  const __m128i low_32_mask = _mm_setr_epi32(-1, 0, -1, 0);
+  x2 = _mm_clmulepi64_si128(x1, constants, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  constants = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(kK5K0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, low_32_mask);
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, constants, 0x00), x2);
+
+  // Barrett reduction to 32 bits.
+  constants = _mm_load_si128(reinterpret_cast<const __m128i*>(kPoly));
+  x2 = _mm_and_si128(x1, low_32_mask);
+  x2 = _mm_clmulepi64_si128(x2, constants, 0x10);
+  x2 = _mm_and_si128(x2, low_32_mask);
+  x2 = _mm_clmulepi64_si128(x2, constants, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+}
+
+#endif  // _PW_CHECKSUM_CRC32_X86_PCLMUL
+
 }  // namespace
 
+// The initial value and final inversion cancel out: the CRC32 of A followed by
+// B is the CRC32 of A shifted past B's bytes, plus the CRC32 of B.
+extern "C" uint32_t pw_checksum_Crc32Combine(uint32_t crc_a,
+                                             uint32_t crc_b,
+                                             size_t size_b) {
+  return MultiplyModCrc32Polynomial(Crc32ShiftFactor(size_b), crc_a) ^ crc_b;
+}
+
+namespace internal {
+
+uint32_t Crc32CombineChunks(span<const uint32_t> chunk_crcs,
+                            size_t chunk_size,
+                            size_t size_bytes) {
+  if (chunk_crcs.empty()) {
+    return PW_CHECKSUM_EMPTY_CRC32;
+  }
+
+  // All chunks but the last are the same size, so they share a shift factor.
+  const uint32_t factor = Crc32ShiftFactor(chunk_size);
+  uint32_t crc = chunk_crcs[0];
+  for (size_t i = 1; i + 1 < chunk_crcs.size(); ++i) {
+    crc = MultiplyModCrc32Polynomial(factor, crc) ^ chunk_crcs[i];
+  }
+  if (chunk_crcs.size() > 1) {
+    const size_t last_size = size_bytes - chunk_size * (chunk_crcs.size() - 1);
+    crc = pw_checksum_Crc32Combine(crc, chunk_crcs.back(), last_size);
+  }
+  return crc;
+}
+
+}  // namespace internal
+
 extern "C" uint32_t _pw_checksum_InternalCrc32EightBit(const void* data,
                                                        size_t size_bytes,
                                                        uint32_t state) {
@@ -97,4 +313,51 @@ extern "C" uint32_t _pw_checksum_InternalCrc32OneBit(const void* data,
   return state;
 }
 
+extern "C" uint32_t _pw_checksum_InternalCrc32SlicingBy8(const void* data,
+                                                         size_t size_bytes,
+                                                         uint32_t state) {
+  return Crc32SlicingBy(kCrc32SlicingBy8Tables,
+                        static_cast<const uint8_t*>(data),
+                        size_bytes,
+                        state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32SlicingBy16(const void* data,
+                                                          size_t size_bytes,
+                                                          uint32_t state) {
+  static constexpr std::array<std::array<uint32_t, 256>, 16> kTables =
+      GenerateCrc32SlicingTables<16, kCrc32Polynomial>();
+  return Crc32SlicingBy(
+      kTables, static_cast<const uint8_t*>(data), size_bytes, state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32Hardware(const void* data,
+                                                       size_t size_bytes,
+                                                       uint32_t state) {
+  const uint8_t* data_bytes = static_cast<const uint8_t*>(data);
+
+#if _PW_CHECKSUM_CRC32_ARM_CRC32
+  for (; size_bytes >= sizeof(uint64_t); size_bytes -= sizeof(uint64_t)) {
+    uint64_t value;
+    std::memcpy(&value, data_bytes, sizeof(value));
+    state = __crc32d(state, value);
+    data_bytes += sizeof(value);
+  }
+  for (size_t i = 0; i < size_bytes; ++i) {
+    state = __crc32b(state, data_bytes[i]);
+  }
+  return state;
+#else
+#if _PW_CHECKSUM_CRC32_X86_PCLMUL
+  if (size_bytes >= 64) {
+    const size_t folded_bytes = size_bytes & ~size_t{15};
+    state = Crc32Pclmul(data_bytes, folded_bytes, state);
+    data_bytes += folded_bytes;
+    size_bytes -= folded_bytes;
+  }
+#endif  // _PW_CHECKSUM_CRC32_X86_PCLMUL
+  return Crc32SlicingBy(kCrc32SlicingBy8Tables, data_bytes, size_bytes, state);
+#endif  // _PW_CHECKSUM_CRC32_ARM_CRC32
+}
+
 }  // namespace pw::checksum
@@ -12,6 +12,7 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
 #include <cstdint>
 #include <string_view>
 
@@ -46,13 +47,51 @@ void Crc32EightBitTest(perf_test::State& state, span<const std::byte> data) {
   }
 }
 
+void Crc32SlicingBy8Test(perf_test::State& state, span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc32SlicingBy8::Calculate(data);
+  }
+}
+
+void Crc32SlicingBy16Test(perf_test::State& state,
+                          span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc32SlicingBy16::Calculate(data);
+  }
+}
+
+void Crc32HardwareTest(perf_test::State& state, span<const std::byte> data) {
+  while (state.KeepRunning()) {
+    Crc32Hardware::Calculate(data);
+  }
+}
+
 PW_PERF_TEST(CrcOneBitStringTest, Crc32OneBitTest, as_bytes(span(kString)));
 PW_PERF_TEST(CrcFourBitStringTest, Crc32FourBitTest, as_bytes(span(kString)));
 PW_PERF_TEST(CrcEightBitStringTest, Crc32EightBitTest, as_bytes(span(kString)));
+PW_PERF_TEST(CrcSlicingBy8StringTest,
+             Crc32SlicingBy8Test,
+             as_bytes(span(kString)));
+PW_PERF_TEST(CrcSlicingBy16StringTest,
+             Crc32SlicingBy16Test,
+             as_bytes(span(kString)));
+PW_PERF_TEST(CrcHardwareStringTest, Crc32HardwareTest, as_bytes(span(kString)));
 
 PW_PERF_TEST(CrcOneBitBytesTest, Crc32OneBitTest, kBytes);
 PW_PERF_TEST(CrcFourBitBytesTest, Crc32FourBitTest, kBytes);
 PW_PERF_TEST(CrcEightBitBytesTest, Crc32EightBitTest, kBytes);
+PW_PERF_TEST(CrcSlicingBy8BytesTest, Crc32SlicingBy8Test, kBytes);
+PW_PERF_TEST(CrcSlicingBy16BytesTest, Crc32SlicingBy16Test, kBytes);
+PW_PERF_TEST(CrcHardwareBytesTest, Crc32HardwareTest, kBytes);
+
+// Large buffers, such as KVS entries and transfer chunks, are where the
+// multi-byte implementations pay for their larger tables.
+constexpr std::array<std::byte, 4096> kLargeBuffer{};
+
+PW_PERF_TEST(CrcEightBitLargeTest, Crc32EightBitTest, kLargeBuffer);
+PW_PERF_TEST(CrcSlicingBy8LargeTest, Crc32SlicingBy8Test, kLargeBuffer);
+PW_PERF_TEST(CrcSlicingBy16LargeTest, Crc32SlicingBy16Test, kLargeBuffer);
+PW_PERF_TEST(CrcHardwareLargeTest, Crc32HardwareTest, kLargeBuffer);
 
 }  // namespace
 }  // namespace pw::checksum
@@ -13,6 +13,8 @@
 // the License.
 #include "pw_checksum/crc32.h"
 
+#include <algorithm>
+#include <array>
 #include <string_view>
 
 #include "public/pw_checksum/crc32.h"
@@ -46,6 +48,12 @@ TEST(Crc32, Empty) {
   EXPECT_EQ(Crc32FourBit::Calculate(span<std::byte>()),
             PW_CHECKSUM_EMPTY_CRC32);
   EXPECT_EQ(Crc32OneBit::Calculate(span<std::byte>()), PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32SlicingBy8::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32SlicingBy16::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32Hardware::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
 }
 
 TEST(Crc32, Buffer) {
@@ -53,6 +61,9 @@ TEST(Crc32, Buffer) {
   EXPECT_EQ(Crc32EightBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
   EXPECT_EQ(Crc32FourBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
   EXPECT_EQ(Crc32OneBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32SlicingBy8::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32SlicingBy16::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32Hardware::Calculate(as_bytes(span(kBytes))), kBufferCrc);
 }
 
 TEST(Crc32, String) {
@@ -60,6 +71,9 @@ TEST(Crc32, String) {
   EXPECT_EQ(Crc32EightBit::Calculate(as_bytes(span(kString))), kStringCrc);
   EXPECT_EQ(Crc32FourBit::Calculate(as_bytes(span(kString))), kStringCrc);
   EXPECT_EQ(Crc32OneBit::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32SlicingBy8::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32SlicingBy16::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32Hardware::Calculate(as_bytes(span(kString))), kStringCrc);
 }
 
 template <typename CrcVariant>
@@ -76,6 +90,9 @@ TEST(Crc32Class, ByteByByte) {
   TestByByte<Crc32EightBit>();
   TestByByte<Crc32FourBit>();
   TestByByte<Crc32OneBit>();
+  TestByByte<Crc32SlicingBy8>();
+  TestByByte<Crc32SlicingBy16>();
+  TestByByte<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -90,6 +107,9 @@ TEST(Crc32Class, Buffer) {
   TestBuffer<Crc32EightBit>();
   TestBuffer<Crc32FourBit>();
   TestBuffer<Crc32OneBit>();
+  TestBuffer<Crc32SlicingBy8>();
+  TestBuffer<Crc32SlicingBy16>();
+  TestBuffer<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -105,6 +125,9 @@ TEST(Crc32Class, BufferAppend) {
   TestBufferAppend<Crc32EightBit>();
   TestBufferAppend<Crc32FourBit>();
   TestBufferAppend<Crc32OneBit>();
+  TestBufferAppend<Crc32SlicingBy8>();
+  TestBufferAppend<Crc32SlicingBy16>();
+  TestBufferAppend<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -119,12 +142,97 @@ TEST(Crc32Class, String) {
   TestString<Crc32EightBit>();
   TestString<Crc32FourBit>();
   TestString<Crc32OneBit>();
+  TestString<Crc32SlicingBy8>();
+  TestString<Crc32SlicingBy16>();
+  TestString<Crc32Hardware>();
+}
+
+// Checks that the multi-byte implementations match the bytewise one across
+// lengths and alignments that exercise both the bulk and tail loops.
+constexpr auto kLongData = []() {
+  std::array<std::byte, 300> data{};
+  uint32_t value = 1;
+  for (std::byte& b : data) {
+    value = value * 1103515245u + 12345u;
+    b = static_cast<std::byte>(value >> 16);
+  }
+  return data;
+}();
+
+template <typename CrcVariant>
+void TestMatchesEightBit() {
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t size = 0; size + offset <= kLongData.size(); ++size) {
+      const auto data = span(kLongData).subspan(offset, size);
+      ASSERT_EQ(CrcVariant::Calculate(data), Crc32EightBit::Calculate(data));
+    }
+  }
+
+  CrcVariant crc;
+  crc.Update(span(kLongData).first(77));
+  crc.Update(span(kLongData).subspan(77));
+  EXPECT_EQ(crc.value(), Crc32EightBit::Calculate(kLongData));
+}
+
+TEST(Crc32, LongBufferMatchesEightBit) {
+  TestMatchesEightBit<Crc32>();
+  TestMatchesEightBit<Crc32SlicingBy8>();
+  TestMatchesEightBit<Crc32SlicingBy16>();
+  TestMatchesEightBit<Crc32Hardware>();
+}
+
+TEST(Crc32, Combine) {
+  EXPECT_EQ(Crc32::Combine(Crc32::Calculate(kBytesPart0),
+                           Crc32::Calculate(kBytesPart1),
+                           kBytesPart1.size()),
+            kBufferCrc);
+  EXPECT_EQ(Crc32::Combine(kBufferCrc, PW_CHECKSUM_EMPTY_CRC32, 0), kBufferCrc);
+  EXPECT_EQ(Crc32::Combine(PW_CHECKSUM_EMPTY_CRC32, kBufferCrc, kBytes.size()),
+            kBufferCrc);
+
+  for (size_t split = 0; split <= kLongData.size(); split += 7) {
+    const auto data = span(kLongData);
+    ASSERT_EQ(Crc32::Combine(Crc32::Calculate(data.first(split)),
+                             Crc32::Calculate(data.subspan(split)),
+                             data.size() - split),
+              Crc32::Calculate(data));
+  }
+}
+
+TEST(Crc32Class, Append) {
+  Crc32 crc;
+  crc.Update(span(kLongData).first(100));
+  crc.Append(Crc32::Calculate(span(kLongData).subspan(100, 150)), 150);
+  crc.Update(span(kLongData).subspan(250));
+  EXPECT_EQ(crc.value(), Crc32::Calculate(kLongData));
+}
+
+TEST(Crc32, CombineChunks) {
+  for (size_t chunk_size : {1u, 3u, 64u, 100u, 299u, 300u, 512u}) {
+    std::array<uint32_t, kLongData.size()> crcs{};
+    const size_t count = Crc32::ChunkCount(kLongData.size(), chunk_size);
+    ASSERT_LE(count, crcs.size());
+
+    // Calculate the chunks' CRCs in reverse order, as if in parallel.
+    for (size_t i = count; i > 0; --i) {
+      crcs[i - 1] = Crc32::Calculate(
+          span(kLongData).subspan((i - 1) * chunk_size).first(std::min(
+              chunk_size, kLongData.size() - (i - 1) * chunk_size)));
+    }
+    EXPECT_EQ(Crc32::CombineChunks(
+                  span(crcs).first(count), chunk_size, kLongData.size()),
+              Crc32::Calculate(kLongData));
+  }
+  EXPECT_EQ(Crc32::CombineChunks({}, 16, 0), PW_CHECKSUM_EMPTY_CRC32);
 }
 
 extern "C" uint32_t CallChecksumCrc32(const void* data, size_t size_bytes);
 extern "C" uint32_t CallChecksumCrc32Append(const void* data,
                                             size_t size_bytes,
                                             uint32_t value);
+extern "C" uint32_t CallChecksumCrc32Combine(uint32_t crc_a,
+                                             uint32_t crc_b,
+                                             size_t size_b);
 
 TEST(Crc32FromC, Buffer) {
   EXPECT_EQ(CallChecksumCrc32(kBytes.data(), kBytes.size()), kBufferCrc);
@@ -149,5 +257,13 @@ TEST(Crc32AppendFromC, String) {
             kStringCrc);
 }
 
+TEST(Crc32CombineFromC, Buffer) {
+  EXPECT_EQ(CallChecksumCrc32Combine(
+                CallChecksumCrc32(kBytesPart0.data(), kBytesPart0.size()),
+                CallChecksumCrc32(kBytesPart1.data(), kBytesPart1.size()),
+                kBytesPart1.size()),
+            kBufferCrc);
+}
+
 }  // namespace
 }  // namespace pw::checksum
@@ -23,3 +23,9 @@ uint32_t CallChecksumCrc32Append(const void* data,
                                  uint32_t value) {
   return pw_checksum_Crc32Append(data, size_bytes, value);
 }
+
+uint32_t CallChecksumCrc32Combine(uint32_t crc_a,
+                                  uint32_t crc_b,
+                                  size_t size_b) {
+  return pw_checksum_Crc32Combine(crc_a, crc_b, size_b);
+}
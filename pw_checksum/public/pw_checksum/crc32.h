@@ -45,6 +45,15 @@ uint32_t _pw_checksum_InternalCrc32FourBit(const void* data,
 uint32_t _pw_checksum_InternalCrc32OneBit(const void* data,
                                           size_t size_bytes,
                                           uint32_t state);
+uint32_t _pw_checksum_InternalCrc32SlicingBy8(const void* data,
+                                              size_t size_bytes,
+                                              uint32_t state);
+uint32_t _pw_checksum_InternalCrc32SlicingBy16(const void* data,
+                                               size_t size_bytes,
+                                               uint32_t state);
+uint32_t _pw_checksum_InternalCrc32Hardware(const void* data,
+                                            size_t size_bytes,
+                                            uint32_t state);
 
 #if PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_8BITS
 #define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32EightBit
@@ -52,6 +61,12 @@ uint32_t _pw_checksum_InternalCrc32OneBit(const void* data,
 #define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32FourBit
 #elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS
 #define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32OneBit
+#elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICING_BY_8
+#define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32SlicingBy8
+#elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICING_BY_16
+#define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32SlicingBy16
+#elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_HARDWARE
+#define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32Hardware
 #endif
 
 // Calculates the CRC32 for the provided data.
@@ -71,12 +86,26 @@ static inline uint32_t pw_checksum_Crc32Append(const void* data,
   return ~_pw_checksum_InternalCrc32(data, size_bytes, ~previous_result);
 }
 
+// Returns the CRC32 of two blocks of data concatenated, given the CRC32 of each
+// block and the size of the second block. This allows blocks to be checksummed
+// independently, for example in parallel, and combined afterwards.
+uint32_t pw_checksum_Crc32Combine(uint32_t crc_a,
+                                  uint32_t crc_b,
+                                  size_t size_b);
+
 #ifdef __cplusplus
 }  // extern "C"
 
 #include "pw_span/span.h"
 
 namespace pw::checksum {
+namespace internal {
+
+uint32_t Crc32CombineChunks(span<const uint32_t> chunk_crcs,
+                            size_t chunk_size,
+                            size_t size_bytes);
+
+}  // namespace internal
 
 // Calculates the CRC32 for all data passed to Update.
 //
@@ -92,6 +121,32 @@ class Crc32Impl {
         data.data(), data.size_bytes(), _PW_CHECKSUM_CRC32_INITIAL_STATE);
   }
 
+  // Returns the CRC32 of data A followed by data B, given the CRC32 of each and
+  // the size of B.
+  static uint32_t Combine(uint32_t crc_a, uint32_t crc_b, size_t size_b) {
+    return pw_checksum_Crc32Combine(crc_a, crc_b, size_b);
+  }
+
+  // Returns the number of chunks of chunk_size bytes that size_bytes of data is
+  // split into for CombineChunks. chunk_size must not be zero.
+  static constexpr size_t ChunkCount(size_t size_bytes, size_t chunk_size) {
+    return (size_bytes + chunk_size - 1) / chunk_size;
+  }
+
+  // Returns the CRC32 of data split into consecutive chunks of chunk_size
+  // bytes, where only the last chunk may be shorter, given the CRC32 of each
+  // chunk. size_bytes is the size of all of the data, and chunk_crcs must have
+  // ChunkCount(size_bytes, chunk_size) entries.
+  //
+  // The chunks' CRC32s may be calculated in any order and in parallel, such as
+  // on worker threads or hardware CRC engines. Combining them costs a few
+  // hundred operations per chunk, regardless of the chunk size.
+  static uint32_t CombineChunks(span<const uint32_t> chunk_crcs,
+                                size_t chunk_size,
+                                size_t size_bytes) {
+    return internal::Crc32CombineChunks(chunk_crcs, chunk_size, size_bytes);
+  }
+
   constexpr Crc32Impl() : state_(kInitialValue) {}
 
   void Update(span<const std::byte> data) {
@@ -100,6 +155,12 @@ class Crc32Impl {
 
   void Update(std::byte data) { Update(span(&data, 1)); }
 
+  // Updates the CRC as if by passing data of size_bytes bytes with the given
+  // CRC32 to Update. The data's CRC32 may have been calculated separately.
+  void Append(uint32_t crc, size_t size_bytes) {
+    state_ = ~Combine(~state_, crc, size_bytes);
+  }
+
   // Returns the value of the CRC32 for all data passed to Update.
   uint32_t value() const { return ~state_; }
 
@@ -116,6 +177,9 @@ using Crc32 = Crc32Impl<_pw_checksum_InternalCrc32>;
 using Crc32EightBit = Crc32Impl<_pw_checksum_InternalCrc32EightBit>;
 using Crc32FourBit = Crc32Impl<_pw_checksum_InternalCrc32FourBit>;
 using Crc32OneBit = Crc32Impl<_pw_checksum_InternalCrc32OneBit>;
+using Crc32SlicingBy8 = Crc32Impl<_pw_checksum_InternalCrc32SlicingBy8>;
+using Crc32SlicingBy16 = Crc32Impl<_pw_checksum_InternalCrc32SlicingBy16>;
+using Crc32Hardware = Crc32Impl<_pw_checksum_InternalCrc32Hardware>;
 
 }  // namespace pw::checksum
 
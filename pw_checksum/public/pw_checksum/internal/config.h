@@ -17,6 +17,12 @@
 #define PW_CHECKSUM_CRC32_8BITS 8
 #define PW_CHECKSUM_CRC32_4BITS 4
 #define PW_CHECKSUM_CRC32_1BITS 1
+#define PW_CHECKSUM_CRC32_SLICING_BY_8 64
+#define PW_CHECKSUM_CRC32_SLICING_BY_16 128
+
+// Uses the ARMv8 CRC32 instructions or x86 PCLMULQDQ folding when the compiler
+// targets them, and slicing-by-8 otherwise.
+#define PW_CHECKSUM_CRC32_HARDWARE (-1)
 
 #ifndef PW_CHECKSUM_CRC32_DEFAULT_IMPL
 #define PW_CHECKSUM_CRC32_DEFAULT_IMPL PW_CHECKSUM_CRC32_8BITS
@@ -25,5 +31,10 @@
 #ifdef __cplusplus
 static_assert(PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_8BITS ||
               PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_4BITS ||
-              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS);
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC32_SLICING_BY_8 ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL ==
+                  PW_CHECKSUM_CRC32_SLICING_BY_16 ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_HARDWARE);
 #endif  // __cplusplus
@@ -14,18 +14,92 @@
 
 #include "chre/platform/memory.h"
 
+#include <cstddef>
 #include <cstdlib>
+#include <mutex>
+
+#include "pw_allocator/chunk_pool.h"
+#include "pw_allocator/layout.h"
+#include "pw_chre/internal/config.h"
+#include "pw_sync/interrupt_spin_lock.h"
 
 namespace chre {
+namespace {
+
+// CHRE allocates an event, and often its payload, for every event it delivers
+// to a nanoapp. Small allocations are served from a fixed-size block pool,
+// which takes constant time and doesn't fragment the heap. Larger allocations,
+// and small ones once the pool is exhausted, still use malloc.
+#if PW_CHRE_CONFIG_POOL_BLOCK_COUNT > 0
+
+constexpr size_t kBlockSize = PW_CHRE_CONFIG_POOL_BLOCK_SIZE;
+constexpr size_t kBlockCount = PW_CHRE_CONFIG_POOL_BLOCK_COUNT;
+
+static_assert(kBlockSize >= pw::allocator::ChunkPool::kMinSize &&
+                  kBlockSize % alignof(std::max_align_t) == 0,
+              "PW_CHRE_CONFIG_POOL_BLOCK_SIZE must be a multiple of the "
+              "maximum alignment");
+
+class BlockPool {
+ public:
+  BlockPool()
+      : pool_(buffer_,
+              pw::allocator::Layout(kBlockSize, alignof(std::max_align_t))) {}
+
+  void* Allocate(size_t size) {
+    if (size > kBlockSize) {
+      return nullptr;
+    }
+    std::lock_guard lock(lock_);
+    return pool_.Allocate();
+  }
+
+  // Returns false if `ptr` was not allocated from this pool.
+  bool Free(void* ptr) {
+    std::byte* bytes = static_cast<std::byte*>(ptr);
+    if (bytes < buffer_ || bytes >= buffer_ + sizeof(buffer_)) {
+      return false;
+    }
+    std::lock_guard lock(lock_);
+    pool_.Deallocate(ptr);
+    return true;
+  }
+
+ private:
+  alignas(std::max_align_t) std::byte buffer_[kBlockSize * kBlockCount];
+  pw::sync::InterruptSpinLock lock_;
+  pw::allocator::ChunkPool pool_;
+};
+
+BlockPool block_pool;
+
+void* Allocate(size_t size) {
+  void* ptr = block_pool.Allocate(size);
+  return ptr != nullptr ? ptr : malloc(size);
+}
+
+void Free(void* pointer) {
+  if (!block_pool.Free(pointer)) {
+    free(pointer);
+  }
+}
+
+#else
+
+void* Allocate(size_t size) { return malloc(size); }
+
+void Free(void* pointer) { free(pointer); }
+
+#endif  // PW_CHRE_CONFIG_POOL_BLOCK_COUNT > 0
+
+}  // namespace
 
-// TODO: b/301477067 - Today these APIs call the system malloc and free, but
-// they should be updated to use pw_allocator.
-void* memoryAlloc(size_t size) { return malloc(size); }
+void* memoryAlloc(size_t size) { return Allocate(size); }
 
-void* palSystemApiMemoryAlloc(size_t size) { return malloc(size); }
+void* palSystemApiMemoryAlloc(size_t size) { return Allocate(size); }
 
-void memoryFree(void* pointer) { free(pointer); }
+void memoryFree(void* pointer) { Free(pointer); }
 
-void palSystemApiMemoryFree(void* pointer) { free(pointer); }
+void palSystemApiMemoryFree(void* pointer) { Free(pointer); }
 
 }  // namespace chre
@@ -0,0 +1,41 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Configuration macros for the pw_chre module.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// The size in bytes of each block in the pool that backs small CHRE
+// allocations, such as events and their payloads. Allocations larger than this
+// fall back to malloc.
+#ifndef PW_CHRE_CONFIG_POOL_BLOCK_SIZE
+#define PW_CHRE_CONFIG_POOL_BLOCK_SIZE 64
+#endif  // PW_CHRE_CONFIG_POOL_BLOCK_SIZE
+
+// The number of blocks in the pool that backs small CHRE allocations. Once all
+// blocks are in use, allocations fall back to malloc. Set this to 0 to disable
+// the pool.
+#ifndef PW_CHRE_CONFIG_POOL_BLOCK_COUNT
+#define PW_CHRE_CONFIG_POOL_BLOCK_COUNT 64
+#endif  // PW_CHRE_CONFIG_POOL_BLOCK_COUNT
+
+// The granularity in nanoseconds that CHRE timer deadlines are rounded up to.
+// Timers that expire within the same interval are then handled by a single
+// wakeup of the CHRE event loop, at the cost of firing up to this much late.
+// Set this to 0 to fire timers at their exact deadlines.
+#ifndef PW_CHRE_CONFIG_TIMER_COALESCING_NS
+#define PW_CHRE_CONFIG_TIMER_COALESCING_NS 0
+#endif  // PW_CHRE_CONFIG_TIMER_COALESCING_NS
@@ -15,10 +15,33 @@
 
 #include "chre/platform/log.h"
 #include "chre/util/time.h"
+#include "pw_chre/internal/config.h"
 
 namespace chre {
+namespace {
+
+// CHRE multiplexes all of its timers onto one SystemTimer, and handles every
+// timer that has expired when it fires. Rounding deadlines up to a common
+// granularity makes timers that expire close together fire in one wakeup.
+pw::chrono::SystemClock::time_point CoalesceDeadline(
+    pw::chrono::SystemClock::time_point deadline) {
+  using pw::chrono::SystemClock;
+  constexpr SystemClock::duration kGranularity = SystemClock::for_at_least(
+      std::chrono::nanoseconds(PW_CHRE_CONFIG_TIMER_COALESCING_NS));
+  if constexpr (kGranularity.count() <= 1) {
+    return deadline;
+  } else {
+    const SystemClock::duration remainder =
+        deadline.time_since_epoch() % kGranularity;
+    return remainder.count() == 0 ? deadline
+                                  : deadline + (kGranularity - remainder);
+  }
+}
+
+}  // namespace
 
 void SystemTimerBase::OnExpired() {
+  is_active_ = false;
   SystemTimer* timer = static_cast<SystemTimer*>(this);
   timer->mCallback(timer->mData);
 }
@@ -50,7 +73,8 @@ bool SystemTimer::set(SystemTimerCallback* callback,
       std::chrono::nanoseconds(delay.toRawNanoseconds());
   const pw::chrono::SystemClock::time_point now =
       pw::chrono::SystemClock::now();
-  timer_.InvokeAt(now + interval);
+  is_active_ = true;
+  timer_.InvokeAt(CoalesceDeadline(now + interval));
   return true;
 }
 
@@ -59,6 +83,7 @@ bool SystemTimer::cancel() {
     return false;
   }
   timer_.Cancel();
+  is_active_ = false;
   return true;
 }
 
@@ -20,3 +20,6 @@ pw_add_backend_variable(pw_chrono.system_clock_BACKEND)
 
 # Backend for the pw_chrono module's system_timer.
 pw_add_backend_variable(pw_chrono.system_timer_BACKEND)
+
+# Backend for the pw_chrono module's high_resolution_clock.
+pw_add_backend_variable(pw_chrono.high_resolution_clock_BACKEND)
@@ -0,0 +1,73 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/counter_extender.h"
+
+#include <cstdint>
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::chrono {
+namespace {
+
+class CounterExtenderTest : public ::testing::Test {
+ protected:
+  int64_t Read(uint32_t count) {
+    return extender_.Extend([count] { return count; });
+  }
+
+  CounterExtender32 extender_;
+};
+
+TEST_F(CounterExtenderTest, StartsAtZero) {
+  EXPECT_EQ(Read(0), 0);
+  EXPECT_EQ(Read(12345), 12345);
+}
+
+TEST_F(CounterExtenderTest, ExtendsAcrossWraps) {
+  constexpr int64_t kPeriod = int64_t{1} << 32;
+  EXPECT_EQ(Read(0x7fff'ffff), 0x7fff'ffff);
+  EXPECT_EQ(Read(0xffff'fff0), 0xffff'fff0);
+  EXPECT_EQ(Read(0x10), kPeriod + 0x10);
+  EXPECT_EQ(Read(0x8000'0000), kPeriod + 0x8000'0000);
+  EXPECT_EQ(Read(0x5), 2 * kPeriod + 0x5);
+}
+
+TEST_F(CounterExtenderTest, HandlesReadsOncePerHalfPeriod) {
+  constexpr uint32_t kHalfPeriod = uint32_t{1} << 31;
+  uint32_t count = 3;
+  for (int64_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(Read(count), i * kHalfPeriod + 3);
+    count += kHalfPeriod;
+  }
+}
+
+TEST_F(CounterExtenderTest, StaleReadsAfterAdvanceAreConsistent) {
+  constexpr int64_t kPeriod = int64_t{1} << 32;
+  EXPECT_EQ(Read(0xffff'0000), 0xffff'0000);
+
+  // A reader that loaded the half-period count before another reader advanced
+  // it still computes the same extended count.
+  int64_t nested = 0;
+  const int64_t outer = extender_.Extend([&] {
+    nested = Read(0x20);
+    return uint32_t{0x10};
+  });
+  EXPECT_EQ(nested, kPeriod + 0x20);
+  EXPECT_EQ(outer, kPeriod + 0x10);
+  EXPECT_EQ(Read(0x30), kPeriod + 0x30);
+}
+
+}  // namespace
+}  // namespace pw::chrono
@@ -0,0 +1,82 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/high_resolution_clock.h"
+
+#include <chrono>
+
+#include "pw_assert/check.h"
+
+namespace pw::chrono {
+namespace {
+
+// Spins until SystemClock ticks at or after `target`, and returns the time of
+// that tick.
+SystemClock::time_point WaitForTickEdge(SystemClock::time_point target) {
+  SystemClock::time_point now = SystemClock::now();
+  while (now < target) {
+    now = SystemClock::now();
+  }
+  return now;
+}
+
+// Keeps the scaled remainder in CalculateTickRate below 2^63.
+constexpr int64_t kMaxCalibrationNanoseconds = int64_t{1} << 33;
+
+uint32_t CalculateTickRate(int64_t ticks, int64_t nanoseconds) {
+  while (nanoseconds > kMaxCalibrationNanoseconds) {
+    ticks /= 2;
+    nanoseconds /= 2;
+  }
+  constexpr int64_t kNanosecondsPerSecond = 1'000'000'000;
+  const int64_t rate =
+      (ticks / nanoseconds) * kNanosecondsPerSecond +
+      ((ticks % nanoseconds) * kNanosecondsPerSecond + nanoseconds / 2) /
+          nanoseconds;
+  PW_CHECK(rate > 0 && rate <= int64_t{UINT32_MAX},
+           "The measured tick rate does not fit in 32 bits");
+  return static_cast<uint32_t>(rate);
+}
+
+}  // namespace
+
+internal::TickConversion HighResolutionClock::conversion_(
+    backend::kHighResolutionClockNominalTickRateHz);
+
+void HighResolutionClock::SetTickRate(uint32_t tick_rate_hz) {
+  PW_CHECK_UINT_NE(tick_rate_hz, 0);
+  conversion_ = internal::TickConversion(tick_rate_hz);
+}
+
+uint32_t HighResolutionClock::Calibrate(
+    SystemClock::duration measurement_period) {
+  PW_CHECK_INT_GT(measurement_period.count(), 0);
+
+  // Start and stop right after SystemClock ticks, which removes the
+  // quantization error of the coarser clock.
+  const SystemClock::time_point start =
+      WaitForTickEdge(SystemClock::now() + SystemClock::duration(1));
+  const int64_t start_ticks = ticks();
+  const SystemClock::time_point end =
+      WaitForTickEdge(start + measurement_period);
+  const int64_t end_ticks = ticks();
+
+  const uint32_t tick_rate_hz = CalculateTickRate(
+      end_ticks - start_ticks,
+      std::chrono::floor<std::chrono::nanoseconds>(end - start).count());
+  SetTickRate(tick_rate_hz);
+  return tick_rate_hz;
+}
+
+}  // namespace pw::chrono
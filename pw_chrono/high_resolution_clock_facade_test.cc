@@ -0,0 +1,96 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_chrono/high_resolution_clock.h"
+
+#include <chrono>
+#include <cstdint>
+
+#include "pw_unit_test/framework.h"
+
+using namespace std::chrono_literals;
+
+namespace pw::chrono {
+namespace {
+
+using internal::TickConversion;
+
+constexpr int64_t kNanosecondsPerSecond = 1'000'000'000;
+
+TEST(TickConversion, ConvertsExactRates) {
+  constexpr TickConversion kGigahertz(1'000'000'000);
+  static_assert(kGigahertz.ToNanoseconds(1) == 1);
+  EXPECT_EQ(kGigahertz.ToNanoseconds(int64_t{1} << 40), int64_t{1} << 40);
+
+  constexpr TickConversion kHundredMegahertz(100'000'000);
+  EXPECT_EQ(kHundredMegahertz.ToNanoseconds(100'000'000),
+            kNanosecondsPerSecond);
+  EXPECT_EQ(kHundredMegahertz.ToNanoseconds(-7), -70);
+
+  constexpr TickConversion kOneHertz(1);
+  EXPECT_EQ(kOneHertz.ToNanoseconds(3), 3 * kNanosecondsPerSecond);
+}
+
+TEST(TickConversion, ConvertsInexactRatesAccurately) {
+  // One hour and one week of ticks, checked against the exact value.
+  for (uint32_t rate : {32'768u, 48'000'000u, 168'000'000u, 4'000'000'000u}) {
+    const TickConversion conversion(rate);
+    for (int64_t seconds : {int64_t{3600}, int64_t{604800}}) {
+      const int64_t ticks = seconds * rate;
+      const int64_t error =
+          conversion.ToNanoseconds(ticks) - seconds * kNanosecondsPerSecond;
+      // Less than one part in 2^31, plus rounding.
+      EXPECT_LE(error < 0 ? -error : error, seconds / 2 + 1) << rate;
+    }
+  }
+}
+
+TEST(TickConversion, IsMonotonicAcrossHalves) {
+  const TickConversion conversion(48'000'000);
+  const int64_t boundary = int64_t{1} << 32;
+  EXPECT_LE(conversion.ToNanoseconds(boundary - 1),
+            conversion.ToNanoseconds(boundary));
+  EXPECT_LT(conversion.ToNanoseconds(boundary - 48),
+            conversion.ToNanoseconds(boundary + 48));
+}
+
+TEST(HighResolutionClock, Ticks) {
+  const HighResolutionClock::time_point start = HighResolutionClock::now();
+  HighResolutionClock::time_point now = start;
+  for (int i = 0; i < 1'000'000 && now == start; ++i) {
+    now = HighResolutionClock::now();
+  }
+  EXPECT_GT(now, start);
+}
+
+TEST(HighResolutionClock, TicksToDuration) {
+  const uint32_t rate = HighResolutionClock::tick_rate_hz();
+  EXPECT_EQ(HighResolutionClock::TicksToDuration(rate), 1s);
+}
+
+TEST(HighResolutionClock, CalibratesAgainstSystemClock) {
+  const uint32_t rate = HighResolutionClock::Calibrate(
+      SystemClock::for_at_least(std::chrono::milliseconds(20)));
+  EXPECT_EQ(HighResolutionClock::tick_rate_hz(), rate);
+
+  // The measurement should land within 5% of the nominal rate.
+  const int64_t nominal = HighResolutionClock::kNominalTickRateHz;
+  EXPECT_GT(int64_t{rate}, nominal - nominal / 20);
+  EXPECT_LT(int64_t{rate}, nominal + nominal / 20);
+
+  HighResolutionClock::SetTickRate(HighResolutionClock::kNominalTickRateHz);
+}
+
+}  // namespace
+}  // namespace pw::chrono
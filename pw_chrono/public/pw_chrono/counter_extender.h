@@ -0,0 +1,64 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace pw::chrono {
+
+/// Extends a free-running 32-bit hardware counter to a 64-bit count without
+/// locks.
+///
+/// The extender tracks the number of half-periods of the counter that have
+/// elapsed. Each read compares the most significant bit of the counter with the
+/// parity of that count; on a mismatch the counter has crossed into the next
+/// half-period and the count is advanced with a single compare-and-swap. A
+/// reader that loses the race computes the same result as the winner, so the
+/// extender is thread, IRQ, and NMI safe wherever a 32-bit compare-and-swap is
+/// lock-free.
+///
+/// `Extend()` must be called at least once every 2^31 counts of the hardware
+/// counter, e.g. from a periodic timer, or wraps will be missed.
+class CounterExtender32 {
+ public:
+  constexpr CounterExtender32() = default;
+
+  CounterExtender32(const CounterExtender32&) = delete;
+  CounterExtender32& operator=(const CounterExtender32&) = delete;
+
+  /// Reads the counter through `read_counter` and returns the extended count.
+  ///
+  /// `read_counter` is invoked after the half-period count is loaded, which is
+  /// what makes concurrent readers safe.
+  template <typename ReadCounter>
+  int64_t Extend(ReadCounter&& read_counter) {
+    uint32_t half_periods = half_periods_.load(std::memory_order_acquire);
+    const uint32_t count = read_counter();
+    if (((count >> 31) ^ half_periods) & 1u) {
+      uint32_t expected = half_periods;
+      half_periods_.compare_exchange_strong(expected,
+                                            half_periods + 1,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire);
+      half_periods += 1;
+    }
+    return static_cast<int64_t>((uint64_t{half_periods >> 1} << 32) | count);
+  }
+
+ private:
+  std::atomic<uint32_t> half_periods_ = 0;
+};
+
+}  // namespace pw::chrono
@@ -0,0 +1,175 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+
+#include "pw_chrono/system_clock.h"
+
+// The backend implements this header to provide the following
+// HighResolutionClock parameters, for more detail on the parameters see the
+// HighResolutionClock usage of them below:
+//   constexpr uint32_t
+//       pw::chrono::backend::kHighResolutionClockNominalTickRateHz;
+//   constexpr bool pw::chrono::backend::kHighResolutionClockNmiSafe;
+#include "pw_chrono_backend/high_resolution_clock_config.h"
+
+namespace pw::chrono {
+namespace backend {
+
+/// Returns the raw tick count of the high resolution counter, extended to
+/// 64 bits. The count must be monotonic, and reading it should cost no more
+/// than a few instructions. This must be thread and IRQ safe and provided by
+/// the backend.
+int64_t GetHighResolutionTickCount();
+
+}  // namespace backend
+
+namespace internal {
+
+/// Converts ticks of a counter running at `tick_rate_hz` to nanoseconds with a
+/// multiply and shift.
+///
+/// The tick count is split into 32-bit halves so that both products fit in
+/// 64 bits. The multiplier is chosen to use 32 bits, so the conversion is off
+/// by less than one part in 2^31.
+class TickConversion {
+ public:
+  constexpr explicit TickConversion(uint32_t tick_rate_hz)
+      : tick_rate_hz_(tick_rate_hz), multiplier_(0), shift_(32) {
+    // Use the largest shift whose multiplier still fits in 32 bits.
+    while (shift_ > 0 && Multiplier(tick_rate_hz, shift_) > UINT32_MAX) {
+      --shift_;
+    }
+    multiplier_ = static_cast<uint32_t>(Multiplier(tick_rate_hz, shift_));
+  }
+
+  constexpr uint32_t tick_rate_hz() const { return tick_rate_hz_; }
+
+  constexpr int64_t ToNanoseconds(int64_t ticks) const {
+    if (ticks < 0) {
+      return -ToNanoseconds(-ticks);
+    }
+    const uint64_t high = static_cast<uint64_t>(ticks) >> 32;
+    const uint64_t low = static_cast<uint64_t>(ticks) & UINT32_MAX;
+    return static_cast<int64_t>(((high * multiplier_) << (32 - shift_)) +
+                                ((low * multiplier_) >> shift_));
+  }
+
+ private:
+  // Rounds 1e9 * 2^shift / tick_rate_hz to the nearest integer.
+  static constexpr uint64_t Multiplier(uint32_t tick_rate_hz, uint32_t shift) {
+    return ((uint64_t{1'000'000'000} << shift) + tick_rate_hz / 2) /
+           tick_rate_hz;
+  }
+
+  uint32_t tick_rate_hz_;
+  uint32_t multiplier_;
+  uint32_t shift_;
+};
+
+}  // namespace internal
+
+/// The `HighResolutionClock` is a monotonic clock for timestamps that need
+/// sub-microsecond resolution and must be cheap to read, such as tracing, perf
+/// tests, and latency metrics.
+///
+/// It is backed by a free-running hardware counter (e.g. the Cortex-M DWT
+/// cycle counter) rather than the scheduler tick, and reading it never takes a
+/// lock or critical section. The counter's tick rate is provided by the backend
+/// as a nominal value, and may be measured against `SystemClock` with
+/// `Calibrate()` when the counter's clock is not known at compile time.
+///
+/// `HighResolutionClock` is compatible with C++'s `Clock` & `TrivialClock`,
+/// with a duration of nanoseconds. Raw counter ticks are also available through
+/// `ticks()`, which skips the conversion.
+///
+/// Example:
+///
+/// @code
+///   const HighResolutionClock::time_point start = HighResolutionClock::now();
+///   HandleInterrupt();
+///   const auto latency = HighResolutionClock::now() - start;
+/// @endcode
+///
+/// Depending on the backend, the counter may stop while the core sleeps.
+///
+/// This code is thread & IRQ safe, it may be NMI safe depending on is_nmi_safe.
+class HighResolutionClock {
+ public:
+  using rep = int64_t;
+  using period = std::nano;
+  using duration = std::chrono::duration<rep, period>;
+  using time_point = std::chrono::time_point<HighResolutionClock>;
+
+  static constexpr bool is_monotonic = true;
+  static constexpr bool is_steady = false;
+
+  /// The now() function may work in non-maskable interrupt contexts (e.g.
+  /// exception/fault handlers), depending on the backend. This must be provided
+  /// by the backend.
+  static constexpr bool is_nmi_safe = backend::kHighResolutionClockNmiSafe;
+
+  /// The tick rate assumed until `SetTickRate()` or `Calibrate()` is called.
+  static constexpr uint32_t kNominalTickRateHz =
+      backend::kHighResolutionClockNominalTickRateHz;
+
+  /// Returns the current time. This is thread and IRQ safe.
+  static time_point now() noexcept {
+    return time_point(duration(conversion_.ToNanoseconds(ticks())));
+  }
+
+  /// Returns the raw tick count of the underlying counter. This is thread and
+  /// IRQ safe.
+  static int64_t ticks() noexcept {
+    return backend::GetHighResolutionTickCount();
+  }
+
+  /// Converts a number of counter ticks to a duration.
+  static duration TicksToDuration(int64_t ticks) {
+    return duration(conversion_.ToNanoseconds(ticks));
+  }
+
+  /// Returns the tick rate used to convert ticks to time.
+  static uint32_t tick_rate_hz() { return conversion_.tick_rate_hz(); }
+
+  /// Sets the tick rate used to convert ticks to time.
+  ///
+  /// This is not safe to call concurrently with `now()`; it is meant to be
+  /// called during initialization, e.g. after the core clock is configured.
+  ///
+  /// @pre `tick_rate_hz` must be non-zero.
+  static void SetTickRate(uint32_t tick_rate_hz);
+
+  /// Measures the tick rate of the counter against `SystemClock` over (at
+  /// least) `measurement_period`, sets it with `SetTickRate()`, and returns it.
+  ///
+  /// Both ends of the measurement are aligned to `SystemClock` tick edges, so
+  /// the error is roughly one counter read over the measurement period. The
+  /// caller busy-waits for the duration of the measurement. This has the same
+  /// restrictions as `SetTickRate()`.
+  static uint32_t Calibrate(SystemClock::duration measurement_period);
+
+ private:
+  static internal::TickConversion conversion_;
+};
+
+}  // namespace pw::chrono
+
+// The backend can opt to include an inline implementation.
+#if __has_include("pw_chrono_backend/high_resolution_clock_inline.h")
+#include "pw_chrono_backend/high_resolution_clock_inline.h"
+#endif  // __has_include("pw_chrono_backend/high_resolution_clock_inline.h")
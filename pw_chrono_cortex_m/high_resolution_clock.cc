@@ -0,0 +1,48 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <cstdint>
+
+#include "pw_chrono/high_resolution_clock.h"
+
+namespace pw::chrono::cortex_m {
+namespace {
+
+// Debug Exception and Monitor Control Register.
+volatile uint32_t& kDemcr = *reinterpret_cast<volatile uint32_t*>(0xE000EDFC);
+constexpr uint32_t kDemcrTraceEnable = 1u << 24;
+
+// DWT Control Register.
+volatile uint32_t& kDwtCtrl = *reinterpret_cast<volatile uint32_t*>(0xE0001000);
+constexpr uint32_t kDwtCtrlCycleCounterEnable = 1u << 0;
+constexpr uint32_t kDwtCtrlNoCycleCounter = 1u << 25;
+
+}  // namespace
+
+namespace internal {
+
+CounterExtender32 cycle_counter_extender;
+
+}  // namespace internal
+
+bool EnableCycleCounter() {
+  kDemcr = kDemcr | kDemcrTraceEnable;
+  if ((kDwtCtrl & kDwtCtrlNoCycleCounter) != 0) {
+    return false;
+  }
+  kDwtCtrl = kDwtCtrl | kDwtCtrlCycleCounterEnable;
+  return (kDwtCtrl & kDwtCtrlCycleCounterEnable) != 0;
+}
+
+}  // namespace pw::chrono::cortex_m
@@ -0,0 +1,25 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// The nominal frequency of the Cortex-M core clock, which the DWT cycle counter
+// counts. Targets whose core clock is only known at runtime should call
+// pw::chrono::HighResolutionClock::SetTickRate() or Calibrate() during
+// initialization instead.
+#ifndef PW_CHRONO_CORTEX_M_CORE_CLOCK_HZ
+#define PW_CHRONO_CORTEX_M_CORE_CLOCK_HZ 100000000
+#endif  // PW_CHRONO_CORTEX_M_CORE_CLOCK_HZ
+
+static_assert(PW_CHRONO_CORTEX_M_CORE_CLOCK_HZ > 0,
+              "The core clock frequency must be non-zero");
@@ -0,0 +1,29 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_chrono_cortex_m/config.h"
+
+namespace pw::chrono::backend {
+
+// The DWT cycle counter counts core clock cycles.
+constexpr inline uint32_t kHighResolutionClockNominalTickRateHz =
+    PW_CHRONO_CORTEX_M_CORE_CLOCK_HZ;
+
+// Reading the cycle counter and extending it is lock-free.
+constexpr inline bool kHighResolutionClockNmiSafe = true;
+
+}  // namespace pw::chrono::backend
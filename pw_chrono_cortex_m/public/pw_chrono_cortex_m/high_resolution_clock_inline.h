@@ -0,0 +1,51 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_chrono/counter_extender.h"
+#include "pw_chrono/high_resolution_clock.h"
+
+namespace pw::chrono {
+namespace cortex_m {
+
+/// Enables the DWT cycle counter that backs `HighResolutionClock`.
+///
+/// This must be called once before the clock is read, and is safe to call
+/// again (e.g. after a debugger disabled the counter). The counter is not
+/// reset.
+///
+/// @returns Whether the core implements the cycle counter.
+bool EnableCycleCounter();
+
+namespace internal {
+
+inline volatile uint32_t& kDwtCyccnt =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001004);
+
+extern CounterExtender32 cycle_counter_extender;
+
+}  // namespace internal
+}  // namespace cortex_m
+
+namespace backend {
+
+inline int64_t GetHighResolutionTickCount() {
+  return cortex_m::internal::cycle_counter_extender.Extend(
+      [] { return cortex_m::internal::kDwtCyccnt; });
+}
+
+}  // namespace backend
+}  // namespace pw::chrono
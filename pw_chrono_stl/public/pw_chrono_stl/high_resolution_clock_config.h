@@ -0,0 +1,32 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+
+namespace pw::chrono::backend {
+
+static_assert(std::is_same_v<std::chrono::steady_clock::period, std::nano>,
+              "The std::chrono::steady_clock must count nanoseconds");
+
+// The std::chrono::steady_clock counts nanoseconds.
+constexpr inline uint32_t kHighResolutionClockNominalTickRateHz = 1'000'000'000;
+
+// The std::chrono::steady_clock can be used by signal handlers.
+constexpr inline bool kHighResolutionClockNmiSafe = true;
+
+}  // namespace pw::chrono::backend
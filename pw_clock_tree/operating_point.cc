@@ -0,0 +1,118 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_clock_tree/operating_point.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "pw_status/try.h"
+
+namespace pw::clock_tree {
+
+size_t OperatingPointManager::operating_point() const {
+  std::lock_guard lock(mutex_);
+  return current_;
+}
+
+Status OperatingPointManager::Request(PerformanceRequest& request,
+                                      uint32_t min_frequency_hz) {
+  std::lock_guard lock(mutex_);
+  request.min_frequency_hz_ = min_frequency_hz;
+  if (!request.active()) {
+    requests_.push_front(request);
+  }
+  return Update();
+}
+
+Status OperatingPointManager::CancelRequest(PerformanceRequest& request) {
+  std::lock_guard lock(mutex_);
+  if (!requests_.remove(request)) {
+    return OkStatus();
+  }
+  return Update();
+}
+
+Status OperatingPointManager::ReportLoad(uint32_t load_percent) {
+  std::lock_guard lock(mutex_);
+  if (load_percent >= config_.raise_load_percent) {
+    // Race to idle: finishing the work quickly at the fastest operating point
+    // also keeps the latency of raising the frequency to one transition.
+    load_floor_ = num_operating_points_ - 1;
+    low_load_reports_ = 0;
+  } else if (load_percent <= config_.lower_load_percent) {
+    if (++low_load_reports_ >= config_.lower_after_reports) {
+      low_load_reports_ = 0;
+      // Lower from the current operating point, which may have been raised
+      // above the load floor by a request that has since been cancelled.
+      if (current_ > 0) {
+        load_floor_ = std::min(load_floor_, current_ - 1);
+      }
+    }
+  } else {
+    low_load_reports_ = 0;
+  }
+  return Update();
+}
+
+size_t OperatingPointManager::RequestFloor() const {
+  uint32_t min_frequency_hz = 0;
+  for (const PerformanceRequest& request : requests_) {
+    min_frequency_hz = std::max(min_frequency_hz, request.min_frequency_hz_);
+  }
+  for (size_t index = 0; index < num_operating_points_; ++index) {
+    if (FrequencyHz(index) >= min_frequency_hz) {
+      return index;
+    }
+  }
+  return num_operating_points_ - 1;
+}
+
+Status OperatingPointManager::Update() {
+  const size_t target = std::max(RequestFloor(), load_floor_);
+  if (target == current_) {
+    return OkStatus();
+  }
+  PW_TRY(DoSetOperatingPoint(current_, target));
+  current_ = target;
+  return OkStatus();
+}
+
+Status ClockDividerOperatingPointManager::DoSetOperatingPoint(size_t from,
+                                                             size_t to) {
+  const uint32_t frequency_hz = FrequencyHz(to);
+
+  // The voltage must support the faster of the two frequencies throughout the
+  // transition, so it is raised first and lowered last.
+  if (to > from) {
+    PW_TRY(DoSetVoltage(frequency_hz));
+  }
+  const Status status =
+      clock_tree_.SetDividerValue(divider_, divider_values_[to]);
+  if (!status.ok()) {
+    if (to > from) {
+      DoSetVoltage(FrequencyHz(from)).IgnoreError();
+    }
+    return status;
+  }
+  DoFrequencyChanged(frequency_hz);
+  if (to < from) {
+    // Running at the lower frequency at the higher voltage is safe, so a
+    // failure to lower the voltage does not fail the transition.
+    DoSetVoltage(frequency_hz).IgnoreError();
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::clock_tree
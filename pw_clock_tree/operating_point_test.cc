@@ -0,0 +1,272 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_clock_tree/operating_point.h"
+
+#include <array>
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::clock_tree {
+namespace {
+
+constexpr std::array<uint32_t, 4> kFrequenciesHz = {
+    12'000'000, 48'000'000, 96'000'000, 200'000'000};
+
+class TestOperatingPointManager : public OperatingPointManager {
+ public:
+  TestOperatingPointManager(size_t initial_operating_point = 0,
+                            const GovernorConfig& config = {})
+      : OperatingPointManager(
+            kFrequenciesHz.size(), initial_operating_point, config) {}
+
+  uint32_t FrequencyHz(size_t index) const override {
+    return kFrequenciesHz[index];
+  }
+
+  size_t num_transitions() const { return num_transitions_; }
+  void set_status(Status status) { status_ = status; }
+
+ private:
+  Status DoSetOperatingPoint(size_t from, size_t to) override {
+    EXPECT_NE(from, to);
+    if (status_.ok()) {
+      ++num_transitions_;
+    }
+    return status_;
+  }
+
+  size_t num_transitions_ = 0;
+  Status status_;
+};
+
+TEST(OperatingPointManager, RequestRaisesFrequency) {
+  TestOperatingPointManager manager;
+  OperatingPointManager::PerformanceRequest request;
+
+  EXPECT_EQ(manager.Request(request, 90'000'000), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 2u);
+  EXPECT_EQ(manager.num_transitions(), 1u);
+  EXPECT_EQ(request.min_frequency_hz(), 90'000'000u);
+
+  EXPECT_EQ(manager.CancelRequest(request), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 0u);
+  EXPECT_EQ(manager.num_transitions(), 2u);
+}
+
+TEST(OperatingPointManager, HighestRequestWins) {
+  TestOperatingPointManager manager;
+  OperatingPointManager::PerformanceRequest low;
+  OperatingPointManager::PerformanceRequest high;
+
+  EXPECT_EQ(manager.Request(low, 40'000'000), OkStatus());
+  EXPECT_EQ(manager.Request(high, 150'000'000), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 3u);
+
+  // Updating a request replaces its previous frequency.
+  EXPECT_EQ(manager.Request(high, 20'000'000), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 1u);
+
+  EXPECT_EQ(manager.CancelRequest(low), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 1u);
+  EXPECT_EQ(manager.CancelRequest(high), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 0u);
+}
+
+TEST(OperatingPointManager, RequestAboveFastestSelectsFastest) {
+  TestOperatingPointManager manager;
+  OperatingPointManager::PerformanceRequest request;
+
+  EXPECT_EQ(manager.Request(request, 500'000'000), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 3u);
+  EXPECT_EQ(manager.CancelRequest(request), OkStatus());
+}
+
+TEST(OperatingPointManager, CancelUnregisteredRequest) {
+  TestOperatingPointManager manager(1);
+  OperatingPointManager::PerformanceRequest request;
+
+  EXPECT_EQ(manager.CancelRequest(request), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 1u);
+  EXPECT_EQ(manager.num_transitions(), 0u);
+}
+
+TEST(OperatingPointManager, HighLoadRaisesToFastest) {
+  TestOperatingPointManager manager;
+
+  EXPECT_EQ(manager.ReportLoad(50), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 0u);
+
+  EXPECT_EQ(manager.ReportLoad(90), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 3u);
+  EXPECT_EQ(manager.num_transitions(), 1u);
+}
+
+TEST(OperatingPointManager, SustainedLowLoadLowersOneStepAtATime) {
+  OperatingPointManager::GovernorConfig config;
+  config.lower_after_reports = 2;
+  TestOperatingPointManager manager(3, config);
+
+  EXPECT_EQ(manager.ReportLoad(10), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 3u);
+  EXPECT_EQ(manager.ReportLoad(10), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 2u);
+
+  // Moderate load resets the count of low load reports.
+  EXPECT_EQ(manager.ReportLoad(10), OkStatus());
+  EXPECT_EQ(manager.ReportLoad(50), OkStatus());
+  EXPECT_EQ(manager.ReportLoad(10), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 2u);
+  EXPECT_EQ(manager.ReportLoad(10), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 1u);
+
+  EXPECT_EQ(manager.ReportLoad(0), OkStatus());
+  EXPECT_EQ(manager.ReportLoad(0), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 0u);
+
+  // The slowest operating point can't be lowered further.
+  EXPECT_EQ(manager.ReportLoad(0), OkStatus());
+  EXPECT_EQ(manager.ReportLoad(0), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 0u);
+  EXPECT_EQ(manager.num_transitions(), 3u);
+}
+
+TEST(OperatingPointManager, RequestHoldsFrequencyUnderLowLoad) {
+  OperatingPointManager::GovernorConfig config;
+  config.lower_after_reports = 1;
+  TestOperatingPointManager manager(0, config);
+  OperatingPointManager::PerformanceRequest request;
+
+  EXPECT_EQ(manager.Request(request, 48'000'000), OkStatus());
+  EXPECT_EQ(manager.ReportLoad(90), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 3u);
+
+  EXPECT_EQ(manager.ReportLoad(0), OkStatus());
+  EXPECT_EQ(manager.ReportLoad(0), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 1u);
+  EXPECT_EQ(manager.ReportLoad(0), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 1u);
+
+  EXPECT_EQ(manager.CancelRequest(request), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 0u);
+}
+
+TEST(OperatingPointManager, FailedTransitionKeepsOperatingPoint) {
+  TestOperatingPointManager manager;
+  OperatingPointManager::PerformanceRequest request;
+
+  manager.set_status(Status::Unavailable());
+  EXPECT_EQ(manager.Request(request, 200'000'000), Status::Unavailable());
+  EXPECT_EQ(manager.operating_point(), 0u);
+
+  // The request remains registered, so the next update applies it.
+  manager.set_status(OkStatus());
+  EXPECT_EQ(manager.ReportLoad(50), OkStatus());
+  EXPECT_EQ(manager.operating_point(), 3u);
+  EXPECT_EQ(manager.CancelRequest(request), OkStatus());
+}
+
+class TestDivider : public ClockDividerNonBlockingMightFail {
+ public:
+  TestDivider(ElementNonBlockingMightFail& source, uint32_t divider)
+      : ClockDividerNonBlockingMightFail(source, divider) {}
+
+  uint32_t value() const { return divider(); }
+  void set_status(Status status) { status_ = status; }
+
+ private:
+  Status DoEnable() override { return status_; }
+
+  Status status_;
+};
+
+class TestSource : public ClockSource<ElementNonBlockingMightFail> {
+ private:
+  Status DoEnable() override { return OkStatus(); }
+};
+
+class TestDividerManager : public ClockDividerOperatingPointManager {
+ public:
+  static constexpr std::array<uint32_t, 3> kDividers = {8, 4, 1};
+
+  TestDividerManager(ClockTree& clock_tree, ClockDivider& divider)
+      : ClockDividerOperatingPointManager(
+            clock_tree, divider, 192'000'000, kDividers, 0) {}
+
+  // Voltage, in units of the frequency it supports, when the divider changed.
+  uint32_t voltage_at_change() const { return voltage_at_change_; }
+  uint32_t voltage() const { return voltage_; }
+
+ private:
+  Status DoSetVoltage(uint32_t frequency_hz) override {
+    voltage_ = frequency_hz;
+    return OkStatus();
+  }
+
+  void DoFrequencyChanged(uint32_t frequency_hz) override {
+    voltage_at_change_ = voltage_;
+    EXPECT_GE(voltage_, frequency_hz);
+  }
+
+  uint32_t voltage_ = 24'000'000;
+  uint32_t voltage_at_change_ = 0;
+};
+
+TEST(ClockDividerOperatingPointManager, SetsDividerAndVoltage) {
+  ClockTree clock_tree;
+  TestSource source;
+  TestDivider divider(source, 8);
+  TestDividerManager manager(clock_tree, divider);
+  ASSERT_EQ(clock_tree.Acquire(divider), OkStatus());
+
+  EXPECT_EQ(manager.FrequencyHz(0), 24'000'000u);
+  EXPECT_EQ(manager.FrequencyHz(2), 192'000'000u);
+
+  OperatingPointManager::PerformanceRequest request;
+  EXPECT_EQ(manager.Request(request, 192'000'000), OkStatus());
+  EXPECT_EQ(divider.value(), 1u);
+  // The voltage was raised before the frequency.
+  EXPECT_EQ(manager.voltage_at_change(), 192'000'000u);
+
+  EXPECT_EQ(manager.Request(request, 48'000'000), OkStatus());
+  EXPECT_EQ(divider.value(), 4u);
+  // The voltage was lowered after the frequency.
+  EXPECT_EQ(manager.voltage_at_change(), 192'000'000u);
+  EXPECT_EQ(manager.voltage(), 48'000'000u);
+
+  EXPECT_EQ(manager.CancelRequest(request), OkStatus());
+  EXPECT_EQ(clock_tree.Release(divider), OkStatus());
+}
+
+TEST(ClockDividerOperatingPointManager, FailedDividerChangeRestoresVoltage) {
+  ClockTree clock_tree;
+  TestSource source;
+  TestDivider divider(source, 8);
+  TestDividerManager manager(clock_tree, divider);
+  ASSERT_EQ(clock_tree.Acquire(divider), OkStatus());
+
+  divider.set_status(Status::Internal());
+  OperatingPointManager::PerformanceRequest request;
+  EXPECT_EQ(manager.Request(request, 192'000'000), Status::Internal());
+  EXPECT_EQ(divider.value(), 8u);
+  EXPECT_EQ(manager.operating_point(), 0u);
+  EXPECT_EQ(manager.voltage(), 24'000'000u);
+
+  divider.set_status(OkStatus());
+  EXPECT_EQ(manager.CancelRequest(request), OkStatus());
+  EXPECT_EQ(clock_tree.Release(divider), OkStatus());
+}
+
+}  // namespace
+}  // namespace pw::clock_tree
@@ -0,0 +1,217 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/assert.h"
+#include "pw_clock_tree/clock_tree.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+
+namespace pw::clock_tree {
+
+/// Abstract class that selects the operating point, i.e. the frequency, that
+/// the system runs at.
+///
+/// Operating points are numbered from 0, the slowest, to
+/// `num_operating_points() - 1`, the fastest. The manager runs at the slowest
+/// operating point that satisfies both of the following:
+///
+/// - **Performance requests**: A driver that needs a minimum frequency, e.g.
+///   for a DMA burst, registers a `PerformanceRequest`. The frequency is
+///   raised before `Request` returns, and may be lowered once the request is
+///   cancelled.
+/// - **Load**: The owner of a dispatcher or work queue periodically reports
+///   how busy it was with `ReportLoad`. High load raises the frequency to the
+///   fastest operating point at once. Sustained low load lowers it one
+///   operating point at a time.
+///
+/// Each call changes the operating point at most once, going directly to the
+/// selected operating point, so the latency of any call is bounded by the
+/// duration of a single transition.
+///
+/// Class implementations must implement `FrequencyHz` and
+/// `DoSetOperatingPoint`.
+///
+/// Note: The methods of this class may block, and may not be called from
+/// inside an interrupt context or with interrupts disabled.
+class OperatingPointManager {
+ public:
+  /// Thresholds that control how `ReportLoad` changes the operating point.
+  struct GovernorConfig {
+    /// Load, in percent, at or above which the fastest operating point is
+    /// selected.
+    uint32_t raise_load_percent = 80;
+
+    /// Load, in percent, at or below which the load counts as low.
+    uint32_t lower_load_percent = 30;
+
+    /// Number of consecutive low load reports after which the operating point
+    /// is lowered by one. This prevents short idle periods from causing
+    /// frequent transitions.
+    uint32_t lower_after_reports = 4;
+  };
+
+  /// A minimum frequency that a driver needs the system to run at.
+  ///
+  /// A request must be cancelled with `CancelRequest` before it is destroyed.
+  class PerformanceRequest : public IntrusiveList<PerformanceRequest>::Item {
+   public:
+    constexpr PerformanceRequest() = default;
+
+    /// Returns the requested minimum frequency in Hz.
+    uint32_t min_frequency_hz() const { return min_frequency_hz_; }
+
+   private:
+    friend class OperatingPointManager;
+
+    bool active() const { return !unlisted(); }
+
+    uint32_t min_frequency_hz_ = 0;
+  };
+
+  virtual ~OperatingPointManager() = default;
+
+  // Not copyable or movable
+  OperatingPointManager(const OperatingPointManager&) = delete;
+  OperatingPointManager& operator=(const OperatingPointManager&) = delete;
+
+  /// Returns the number of operating points.
+  size_t num_operating_points() const { return num_operating_points_; }
+
+  /// Returns the frequency in Hz of operating point `index`.
+  ///
+  /// Frequencies must increase with the operating point index.
+  virtual uint32_t FrequencyHz(size_t index) const = 0;
+
+  /// Returns the index of the current operating point.
+  size_t operating_point() const PW_LOCKS_EXCLUDED(mutex_);
+
+  /// Registers `request`, or updates it if it is already registered, and
+  /// raises the frequency to at least `min_frequency_hz` before returning.
+  ///
+  /// If no operating point is fast enough, the fastest is selected.
+  ///
+  /// If the transition fails, the request remains registered, the operating
+  /// point is unchanged, and the error from `DoSetOperatingPoint` is returned.
+  Status Request(PerformanceRequest& request, uint32_t min_frequency_hz)
+      PW_LOCKS_EXCLUDED(mutex_);
+
+  /// Cancels `request`, which allows the frequency to be lowered to what the
+  /// load and the remaining requests need.
+  ///
+  /// Cancelling a request that is not registered does nothing.
+  Status CancelRequest(PerformanceRequest& request) PW_LOCKS_EXCLUDED(mutex_);
+
+  /// Reports the load since the previous report, in percent of the time that
+  /// the dispatcher or work queue was busy.
+  ///
+  /// Reports should be made at a regular interval, which together with
+  /// `GovernorConfig::lower_after_reports` determines how quickly the
+  /// frequency is lowered after a burst of work.
+  Status ReportLoad(uint32_t load_percent) PW_LOCKS_EXCLUDED(mutex_);
+
+ protected:
+  /// Creates a manager for `num_operating_points` operating points, which
+  /// assumes that the system currently runs at `initial_operating_point`.
+  OperatingPointManager(size_t num_operating_points,
+                        size_t initial_operating_point,
+                        const GovernorConfig& config)
+      : num_operating_points_(num_operating_points),
+        config_(config),
+        current_(initial_operating_point),
+        load_floor_(initial_operating_point) {
+    PW_ASSERT(initial_operating_point < num_operating_points);
+  }
+
+  /// Switches the system from operating point `from` to operating point `to`.
+  ///
+  /// If this fails, the system must still run at operating point `from`.
+  virtual Status DoSetOperatingPoint(size_t from, size_t to) = 0;
+
+ private:
+  // Returns the slowest operating point that satisfies all requests.
+  size_t RequestFloor() const PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Switches to the operating point selected by the requests and the load.
+  Status Update() PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t num_operating_points_;
+  const GovernorConfig config_;
+
+  mutable sync::Mutex mutex_;
+  IntrusiveList<PerformanceRequest> requests_ PW_GUARDED_BY(mutex_);
+  size_t current_ PW_GUARDED_BY(mutex_);
+
+  // The slowest operating point the load allows.
+  size_t load_floor_ PW_GUARDED_BY(mutex_);
+  uint32_t low_load_reports_ PW_GUARDED_BY(mutex_) = 0;
+};
+
+/// Operating point manager that scales the frequency with a clock divider,
+/// such as the divider of the CPU clock.
+///
+/// Each operating point is a divider value of `divider`, whose source runs at
+/// `source_frequency_hz`. Divider values must be given in decreasing order, so
+/// that frequencies increase with the operating point index.
+///
+/// Derived classes can override `DoSetVoltage` to scale the supply voltage
+/// with the frequency, and `DoFrequencyChanged` to update state that depends
+/// on the frequency, such as a global core clock variable.
+class ClockDividerOperatingPointManager : public OperatingPointManager {
+ public:
+  ClockDividerOperatingPointManager(
+      ClockTree& clock_tree,
+      ClockDivider& divider,
+      uint32_t source_frequency_hz,
+      span<const uint32_t> divider_values,
+      size_t initial_operating_point,
+      const GovernorConfig& config = {})
+      : OperatingPointManager(
+            divider_values.size(), initial_operating_point, config),
+        clock_tree_(clock_tree),
+        divider_(divider),
+        source_frequency_hz_(source_frequency_hz),
+        divider_values_(divider_values) {}
+
+  uint32_t FrequencyHz(size_t index) const final {
+    return source_frequency_hz_ / divider_values_[index];
+  }
+
+ protected:
+  /// Sets the supply voltage for running at `frequency_hz`.
+  ///
+  /// This is called before the frequency is raised, and after it is lowered.
+  virtual Status DoSetVoltage(uint32_t /* frequency_hz */) {
+    return OkStatus();
+  }
+
+  /// Called after the frequency has changed to `frequency_hz`.
+  virtual void DoFrequencyChanged(uint32_t /* frequency_hz */) {}
+
+ private:
+  Status DoSetOperatingPoint(size_t from, size_t to) final;
+
+  ClockTree& clock_tree_;
+  ClockDivider& divider_;
+  const uint32_t source_frequency_hz_;
+  const span<const uint32_t> divider_values_;
+};
+
+}  // namespace pw::clock_tree
@@ -0,0 +1,77 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "fsl_clock.h"
+#include "fsl_power.h"
+#include "pw_clock_tree/operating_point.h"
+
+namespace pw::clock_tree {
+
+/// Operating point manager that scales the CPU frequency with a divider of
+/// the main clock, such as `kCLOCK_DivSysCpuAhbClk`.
+///
+/// Before the frequency is raised, and after it is lowered, the core supply
+/// voltage is set for the new frequency with `POWER_SetPmicVoltageForFreq`.
+/// The board must have registered a PMIC callback with
+/// `POWER_SetPmicCallback` before the first transition. After each transition
+/// `SystemCoreClock` is updated.
+class ClockMcuxpressoOperatingPointManager
+    : public ClockDividerOperatingPointManager {
+ public:
+  /// Constructor specifying the CPU clock divider and its source frequency,
+  /// the divider value of each operating point in decreasing order, the
+  /// operating point the CPU clock is currently configured for, and the
+  /// temperature and voltage ranges used to select the core voltage.
+  ClockMcuxpressoOperatingPointManager(
+      ClockTree& clock_tree,
+      ClockDivider& cpu_divider,
+      uint32_t main_clock_frequency_hz,
+      span<const uint32_t> divider_values,
+      size_t initial_operating_point,
+      power_part_temp_range_t temp_range,
+      power_volt_op_range_t volt_op_range,
+      const GovernorConfig& config = {})
+      : ClockDividerOperatingPointManager(clock_tree,
+                                          cpu_divider,
+                                          main_clock_frequency_hz,
+                                          divider_values,
+                                          initial_operating_point,
+                                          config),
+        temp_range_(temp_range),
+        volt_op_range_(volt_op_range) {}
+
+ private:
+  /// Set the core voltage for running the CPU at `frequency_hz`.
+  Status DoSetVoltage(uint32_t frequency_hz) final {
+    if (!POWER_SetPmicVoltageForFreq(temp_range_,
+                                     volt_op_range_,
+                                     frequency_hz,
+                                     CLOCK_GetFreq(kCLOCK_DspCpuClk))) {
+      // The frequency is not supported in the voltage range.
+      return Status::OutOfRange();
+    }
+    return OkStatus();
+  }
+
+  /// Update the SystemCoreClock global.
+  void DoFrequencyChanged(uint32_t) final { SystemCoreClockUpdate(); }
+
+  /// Part temperature range.
+  const power_part_temp_range_t temp_range_;
+  /// Core voltage operating range.
+  const power_volt_op_range_t volt_op_range_;
+};
+
+}  // namespace pw::clock_tree
@@ -0,0 +1,242 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/inline_hash_map.h"
+
+#include <cstdint>
+
+#include "pw_containers_private/test_helpers.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::containers {
+namespace {
+
+using test::Counter;
+
+// Sends every key to the same home slot, so that entries collide.
+struct CollidingHash {
+  size_t operator()(int) const { return 3; }
+};
+
+// Sends keys to the slot equal to the key divided by 10, so that the tests
+// choose which keys collide.
+struct TensHash {
+  size_t operator()(int key) const { return static_cast<size_t>(key / 10); }
+};
+
+TEST(InlineHashMap, Empty) {
+  InlineHashMap<int, int, 8> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_FALSE(map.full());
+  EXPECT_EQ(map.size(), 0u);
+  EXPECT_EQ(map.capacity(), 8u);
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.find(1), map.end());
+  EXPECT_FALSE(map.contains(1));
+}
+
+TEST(InlineHashMap, InsertAndFind) {
+  InlineHashMap<uint32_t, char, 4> map;
+  auto [it, inserted] = map.insert({10, 'a'});
+  ASSERT_TRUE(inserted);
+  EXPECT_EQ(it->first, 10u);
+  EXPECT_EQ(it->second, 'a');
+
+  EXPECT_TRUE(map.insert({20, 'b'}).second);
+  EXPECT_EQ(map.size(), 2u);
+  EXPECT_EQ(map.at(10), 'a');
+  EXPECT_EQ(map.at(20), 'b');
+  EXPECT_EQ(map.find(20)->second, 'b');
+  EXPECT_EQ(map.count(20), 1u);
+  EXPECT_EQ(map.count(30), 0u);
+}
+
+TEST(InlineHashMap, InsertExistingKeyKeepsValue) {
+  InlineHashMap<int, int, 4> map;
+  EXPECT_TRUE(map.insert({1, 100}).second);
+  auto [it, inserted] = map.insert({1, 200});
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it->second, 100);
+  EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(InlineHashMap, InsertOrAssign) {
+  InlineHashMap<int, int, 4> map;
+  EXPECT_TRUE(map.insert_or_assign(1, 100).second);
+  auto [it, inserted] = map.insert_or_assign(1, 200);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it->second, 200);
+  EXPECT_EQ(map.at(1), 200);
+}
+
+TEST(InlineHashMap, SubscriptInsertsValueInitialized) {
+  InlineHashMap<int, int, 4> map;
+  EXPECT_EQ(map[5], 0);
+  map[5] = 50;
+  map[6] += 1;
+  EXPECT_EQ(map.at(5), 50);
+  EXPECT_EQ(map.at(6), 1);
+  EXPECT_EQ(map.size(), 2u);
+}
+
+TEST(InlineHashMap, FullMapRejectsNewKeys) {
+  InlineHashMap<int, int, 3> map = {{1, 1}, {2, 2}, {3, 3}};
+  EXPECT_TRUE(map.full());
+
+  auto [it, inserted] = map.insert({4, 4});
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(it, map.end());
+
+  // Existing keys are still found.
+  EXPECT_EQ(map.insert({2, 20}).first->second, 2);
+  EXPECT_EQ(map.insert_or_assign(3, 30).first->second, 30);
+}
+
+TEST(InlineHashMap, CollidingKeys) {
+  InlineHashMap<int, int, 8, CollidingHash> map;
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(map.insert({i, i * 10}).second);
+  }
+  EXPECT_TRUE(map.full());
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(map.at(i), i * 10);
+  }
+  EXPECT_FALSE(map.contains(8));
+}
+
+TEST(InlineHashMap, EraseShiftsCollidingEntriesBack) {
+  InlineHashMap<int, int, 8, CollidingHash> map;
+  for (int i = 0; i < 6; ++i) {
+    ASSERT_TRUE(map.insert({i, i}).second);
+  }
+
+  EXPECT_EQ(map.erase(0), 1u);
+  EXPECT_EQ(map.erase(0), 0u);
+  EXPECT_EQ(map.erase(3), 1u);
+  EXPECT_EQ(map.size(), 4u);
+  for (int i : {1, 2, 4, 5}) {
+    EXPECT_EQ(map.at(i), i);
+  }
+
+  // Erased slots are reused.
+  EXPECT_TRUE(map.insert({6, 6}).second);
+  EXPECT_TRUE(map.insert({7, 7}).second);
+  EXPECT_EQ(map.at(7), 7);
+}
+
+TEST(InlineHashMap, RobinHoodDisplacesEntriesCloserToHome) {
+  // Keys 20, 21, and 22 share slot 2, and push 30 and 50 past their home
+  // slots.
+  InlineHashMap<int, int, 6, TensHash> map;
+  ASSERT_TRUE(map.insert({20, 20}).second);
+  ASSERT_TRUE(map.insert({21, 21}).second);
+  ASSERT_TRUE(map.insert({30, 30}).second);
+  ASSERT_TRUE(map.insert({22, 22}).second);
+  ASSERT_TRUE(map.insert({50, 50}).second);
+  for (int key : {20, 21, 22, 30, 50}) {
+    EXPECT_EQ(map.at(key), key);
+  }
+
+  // Entries wrap around the end of the slots.
+  ASSERT_TRUE(map.insert({51, 51}).second);
+  EXPECT_EQ(map.at(51), 51);
+  EXPECT_EQ(map.erase(50), 1u);
+  EXPECT_EQ(map.at(51), 51);
+  EXPECT_EQ(map.erase(20), 1u);
+  for (int key : {21, 22, 30, 51}) {
+    EXPECT_EQ(map.at(key), key);
+  }
+}
+
+TEST(InlineHashMap, Iteration) {
+  InlineHashMap<int, int, 8> map = {{1, 10}, {2, 20}, {3, 30}};
+  int key_sum = 0;
+  int value_sum = 0;
+  for (const auto& [key, value] : map) {
+    key_sum += key;
+    value_sum += value;
+  }
+  EXPECT_EQ(key_sum, 6);
+  EXPECT_EQ(value_sum, 60);
+
+  for (auto& entry : map) {
+    entry.second += 1;
+  }
+  EXPECT_EQ(map.at(3), 31);
+
+  const auto& const_map = map;
+  InlineHashMap<int, int, 8>::const_iterator it = map.begin();
+  EXPECT_EQ(it, const_map.begin());
+}
+
+TEST(InlineHashMap, EraseIterator) {
+  InlineHashMap<int, int, 4> map = {{1, 10}, {2, 20}};
+  map.erase(map.find(1));
+  EXPECT_FALSE(map.contains(1));
+  EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(InlineHashMap, CopyAndMove) {
+  InlineHashMap<int, int, 4, CollidingHash> map = {{1, 10}, {2, 20}};
+
+  InlineHashMap<int, int, 4, CollidingHash> copy(map);
+  EXPECT_EQ(copy.size(), 2u);
+  EXPECT_EQ(copy.at(2), 20);
+  copy.erase(1);
+  EXPECT_TRUE(map.contains(1));
+
+  InlineHashMap<int, int, 4, CollidingHash> moved(std::move(copy));
+  EXPECT_EQ(moved.size(), 1u);
+  EXPECT_EQ(moved.at(2), 20);
+
+  moved = map;
+  EXPECT_EQ(moved.size(), 2u);
+  EXPECT_EQ(moved.at(1), 10);
+}
+
+TEST(InlineHashMap, ConstructsAndDestroysValues) {
+  Counter::Reset();
+  {
+    InlineHashMap<int, Counter, 4, CollidingHash> map;
+    map.try_emplace(1, 100);
+    map.try_emplace(2, 200);
+    map.try_emplace(1, 300);  // Not constructed, since the key exists.
+    EXPECT_EQ(Counter::created, 2);
+    EXPECT_EQ(map.at(1).value, 100);
+
+    map.erase(1);
+    EXPECT_EQ(map.at(2).value, 200);
+  }
+  EXPECT_EQ(Counter::created + Counter::moved, Counter::destroyed);
+}
+
+TEST(InlineHashMap, ManyInsertionsAndErasures) {
+  InlineHashMap<uint32_t, uint32_t, 31> map;
+  for (uint32_t round = 0; round < 20; ++round) {
+    for (uint32_t i = 0; i < 31; ++i) {
+      ASSERT_TRUE(map.insert({round * 1000 + i * 7, i}).second);
+    }
+    for (uint32_t i = 0; i < 31; i += 2) {
+      EXPECT_EQ(map.erase(round * 1000 + i * 7), 1u);
+    }
+    for (uint32_t i = 1; i < 31; i += 2) {
+      EXPECT_EQ(map.at(round * 1000 + i * 7), i);
+    }
+    map.clear();
+    EXPECT_TRUE(map.empty());
+  }
+}
+
+}  // namespace
+}  // namespace pw::containers
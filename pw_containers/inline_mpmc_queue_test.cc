@@ -0,0 +1,102 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/inline_mpmc_queue.h"
+
+#include <cstdint>
+
+#include "pw_containers_private/test_helpers.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::containers {
+namespace {
+
+using test::Counter;
+using test::MoveOnly;
+
+TEST(InlineMpmcQueue, Empty) {
+  InlineMpmcQueue<int, 4> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.size(), 0u);
+  EXPECT_EQ(queue.capacity(), 4u);
+  EXPECT_FALSE(queue.TryPop().has_value());
+}
+
+TEST(InlineMpmcQueue, PushAndPopInOrder) {
+  InlineMpmcQueue<uint32_t, 4> queue;
+  EXPECT_TRUE(queue.TryPush(1));
+  EXPECT_TRUE(queue.TryPush(2));
+  EXPECT_TRUE(queue.TryEmplace(3u));
+  EXPECT_EQ(queue.size(), 3u);
+
+  EXPECT_EQ(queue.TryPop(), 1u);
+  EXPECT_EQ(queue.TryPop(), 2u);
+  EXPECT_EQ(queue.TryPop(), 3u);
+  EXPECT_FALSE(queue.TryPop().has_value());
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(InlineMpmcQueue, FullQueueRejectsPush) {
+  InlineMpmcQueue<int, 2> queue;
+  EXPECT_TRUE(queue.TryPush(1));
+  EXPECT_TRUE(queue.TryPush(2));
+  EXPECT_FALSE(queue.TryPush(3));
+  EXPECT_EQ(queue.size(), 2u);
+
+  EXPECT_EQ(queue.TryPop(), 1);
+  EXPECT_TRUE(queue.TryPush(3));
+  EXPECT_EQ(queue.TryPop(), 2);
+  EXPECT_EQ(queue.TryPop(), 3);
+}
+
+TEST(InlineMpmcQueue, WrapsAroundManyTimes) {
+  InlineMpmcQueue<uint32_t, 8> queue;
+  uint32_t next_push = 0;
+  uint32_t next_pop = 0;
+  for (uint32_t round = 0; round < 100; ++round) {
+    while (queue.TryPush(next_push)) {
+      next_push += 1;
+    }
+    EXPECT_EQ(queue.size(), 8u);
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_EQ(queue.TryPop(), next_pop);
+      next_pop += 1;
+    }
+  }
+}
+
+TEST(InlineMpmcQueue, MoveOnlyValues) {
+  InlineMpmcQueue<MoveOnly, 4> queue;
+  EXPECT_TRUE(queue.TryPush(MoveOnly(5)));
+  EXPECT_TRUE(queue.TryEmplace(6));
+  EXPECT_EQ(queue.TryPop()->value, 5);
+  EXPECT_EQ(queue.TryPop()->value, 6);
+}
+
+TEST(InlineMpmcQueue, DestroysValues) {
+  Counter::Reset();
+  {
+    InlineMpmcQueue<Counter, 4> queue;
+    EXPECT_TRUE(queue.TryEmplace(1));
+    EXPECT_TRUE(queue.TryEmplace(2));
+    EXPECT_TRUE(queue.TryEmplace(3));
+    EXPECT_EQ(Counter::created, 3);
+    EXPECT_EQ(queue.TryPop()->value, 1);
+  }
+  // The values left in the queue are destroyed with it.
+  EXPECT_EQ(Counter::created + Counter::moved, Counter::destroyed);
+}
+
+}  // namespace
+}  // namespace pw::containers
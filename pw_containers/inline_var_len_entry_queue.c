@@ -176,6 +176,96 @@ void pw_InlineVarLenEntryQueue_PushOverwrite(
   AppendEntryKnownToFit(queue, prefix, prefix_size, data, data_size_bytes);
 }
 
+// Sets up a reservation for an entry of up to max_data_size_bytes at the tail.
+static void ReserveKnownToFit(
+    pw_InlineVarLenEntryQueue_Handle queue,
+    uint32_t prefix_size,
+    uint32_t max_data_size_bytes,
+    pw_InlineVarLenEntryQueue_Reservation* reservation) {
+  const uint32_t offset_1 = WrapIndex(queue, TAIL(queue) + prefix_size);
+  const uint32_t first_chunk = BufferSize(queue) - offset_1;
+
+  if (max_data_size_bytes <= first_chunk) {
+    reservation->size_1 = max_data_size_bytes;
+    reservation->size_2 = 0;
+  } else {
+    reservation->size_1 = first_chunk;
+    reservation->size_2 = max_data_size_bytes - first_chunk;
+  }
+
+  reservation->data_1 = WritableData(queue) + offset_1;
+  reservation->data_2 = WritableData(queue);
+  reservation->_pw_prefix_size = prefix_size;
+}
+
+void pw_InlineVarLenEntryQueue_Reserve(
+    pw_InlineVarLenEntryQueue_Handle queue,
+    uint32_t max_data_size_bytes,
+    pw_InlineVarLenEntryQueue_Reservation* reservation) {
+  uint8_t prefix[PW_VARINT_MAX_INT32_SIZE_BYTES];
+  uint32_t prefix_size = EncodePrefix(queue, prefix, max_data_size_bytes);
+
+  PW_CHECK(prefix_size + max_data_size_bytes <= AvailableBytes(queue),
+           "Insufficient remaining space for entry");
+
+  ReserveKnownToFit(queue, prefix_size, max_data_size_bytes, reservation);
+}
+
+bool pw_InlineVarLenEntryQueue_TryReserve(
+    pw_InlineVarLenEntryQueue_Handle queue,
+    uint32_t max_data_size_bytes,
+    pw_InlineVarLenEntryQueue_Reservation* reservation) {
+  uint8_t prefix[PW_VARINT_MAX_INT32_SIZE_BYTES];
+  uint32_t prefix_size = EncodePrefix(queue, prefix, max_data_size_bytes);
+
+  if (prefix_size + max_data_size_bytes > AvailableBytes(queue)) {
+    return false;
+  }
+
+  ReserveKnownToFit(queue, prefix_size, max_data_size_bytes, reservation);
+  return true;
+}
+
+void pw_InlineVarLenEntryQueue_ReserveOverwrite(
+    pw_InlineVarLenEntryQueue_Handle queue,
+    uint32_t max_data_size_bytes,
+    pw_InlineVarLenEntryQueue_Reservation* reservation) {
+  uint8_t prefix[PW_VARINT_MAX_INT32_SIZE_BYTES];
+  uint32_t prefix_size = EncodePrefix(queue, prefix, max_data_size_bytes);
+
+  uint32_t available_bytes = AvailableBytes(queue);
+  while (max_data_size_bytes + prefix_size > available_bytes) {
+    available_bytes += PopNonEmpty(queue);
+  }
+
+  ReserveKnownToFit(queue, prefix_size, max_data_size_bytes, reservation);
+}
+
+void pw_InlineVarLenEntryQueue_Commit(
+    pw_InlineVarLenEntryQueue_Handle queue,
+    const pw_InlineVarLenEntryQueue_Reservation* reservation,
+    uint32_t data_size_bytes) {
+  PW_CHECK_UINT_LE(data_size_bytes,
+                   reservation->size_1 + reservation->size_2,
+                   "Committed entry is larger than its reservation");
+
+  // The data was written after a prefix sized for the reserved size. If the
+  // final size encodes to fewer bytes, pad the varint with continuation bytes
+  // so that the data does not have to move. Padded varints decode normally.
+  uint8_t prefix[PW_VARINT_MAX_INT32_SIZE_BYTES];
+  uint32_t prefix_size = (uint32_t)pw_varint_Encode32(
+      data_size_bytes, prefix, PW_VARINT_MAX_INT32_SIZE_BYTES);
+
+  while (prefix_size < reservation->_pw_prefix_size) {
+    prefix[prefix_size - 1] |= 0x80u;
+    prefix[prefix_size++] = 0u;
+  }
+
+  // Write the prefix, then publish the entry with a single update to the tail.
+  const uint32_t tail = CopyAndWrap(queue, TAIL(queue), prefix, prefix_size);
+  TAIL(queue) = WrapIndex(queue, tail + data_size_bytes);
+}
+
 void pw_InlineVarLenEntryQueue_Pop(pw_InlineVarLenEntryQueue_Handle queue) {
   PW_CHECK(!pw_InlineVarLenEntryQueue_Empty(queue));
   PopNonEmpty(queue);
@@ -14,7 +14,9 @@
 
 #include "pw_containers/inline_var_len_entry_queue.h"
 
+#include <algorithm>
 #include <cstring>
+#include <optional>
 #include <string_view>
 #include <variant>
 
@@ -462,4 +464,140 @@ TEST(InlineVarLenEntryQueueClass, Entry) {
   EXPECT_TRUE(std::equal(front.begin(), front.end(), "ABCDE"));
 }
 
+TEST(InlineVarLenEntryQueueClass, ReserveAndCommit) {
+  pw::BasicInlineVarLenEntryQueue<char, 8> queue;
+  auto reservation = queue.reserve(5);
+  EXPECT_EQ(reservation.max_size(), 5u);
+  EXPECT_TRUE(queue.empty());
+
+  auto [span_1, span_2] = reservation.contiguous_data();
+  ASSERT_EQ(span_1.size(), 5u);
+  EXPECT_TRUE(span_2.empty());
+  std::memcpy(span_1.data(), "Gelu!", 5);
+  EXPECT_TRUE(queue.empty());
+
+  reservation.commit(4);
+  ASSERT_EQ(queue.size(), 1u);
+  EXPECT_EQ(queue.size_bytes(), 4u);
+  EXPECT_TRUE(std::equal(queue.front().begin(), queue.front().end(), "Gelu"));
+}
+
+TEST(InlineVarLenEntryQueueClass, ReserveAcrossTheEnd) {
+  pw::BasicInlineVarLenEntryQueue<char, 5> queue;
+  queue.push("12");  // Split the next entry across the end.
+  queue.pop();
+
+  auto reservation = queue.reserve(5);
+  auto [span_1, span_2] = reservation.contiguous_data();
+  ASSERT_EQ(span_1.size(), 2u);
+  ASSERT_EQ(span_2.size(), 3u);
+  std::memcpy(span_1.data(), "AB", 2);
+  std::memcpy(span_2.data(), "CDE", 3);
+  reservation.commit(5);
+
+  const auto [entry_1, entry_2] = queue.front().contiguous_data();
+  EXPECT_EQ(entry_1.size(), 2u);
+  EXPECT_EQ(entry_2.size(), 3u);
+  EXPECT_TRUE(std::equal(queue.front().begin(), queue.front().end(), "ABCDE"));
+}
+
+TEST(InlineVarLenEntryQueueClass, CommitFewerBytesThanReservedPadsPrefix) {
+  pw::BasicInlineVarLenEntryQueue<char, 200> queue;
+  auto reservation = queue.reserve(150);  // Two-byte prefix
+  std::memcpy(reservation.contiguous_data().first.data(), "Tazar", 5);
+  reservation.commit(5);  // Would normally have a one-byte prefix
+
+  queue.push(std::string_view("Kyrre"));
+
+  ASSERT_EQ(queue.size(), 2u);
+  EXPECT_EQ(queue.size_bytes(), 10u);
+  auto it = queue.begin();
+  EXPECT_TRUE(std::equal(it->begin(), it->end(), "Tazar"));
+  ++it;
+  EXPECT_TRUE(std::equal(it->begin(), it->end(), "Kyrre"));
+
+  queue.pop();
+  ASSERT_EQ(queue.size(), 1u);
+  EXPECT_TRUE(std::equal(queue.front().begin(), queue.front().end(), "Kyrre"));
+}
+
+TEST(InlineVarLenEntryQueueClass, CommitEmptyEntry) {
+  pw::InlineVarLenEntryQueue<8> queue;
+  queue.reserve(8).commit(0);
+  ASSERT_EQ(queue.size(), 1u);
+  EXPECT_TRUE(queue.front().empty());
+}
+
+TEST(InlineVarLenEntryQueueClass, UncommittedReservationHasNoEffect) {
+  pw::BasicInlineVarLenEntryQueue<char, 8> queue;
+  queue.push(std::string_view("Crag"));
+  auto reservation = queue.reserve(3);
+  std::memcpy(reservation.contiguous_data().first.data(), "Hag", 3);
+
+  ASSERT_EQ(queue.size(), 1u);
+  EXPECT_TRUE(std::equal(queue.front().begin(), queue.front().end(), "Crag"));
+
+  // Space for the reservation is available to later pushes.
+  queue.pop();
+  queue.push(std::string_view("Mutare"));
+  ASSERT_EQ(queue.size(), 1u);
+  EXPECT_TRUE(
+      std::equal(queue.front().begin(), queue.front().end(), "Mutare"));
+}
+
+TEST(InlineVarLenEntryQueueClass, TryReserveFailsWhenFull) {
+  pw::BasicInlineVarLenEntryQueue<char, 6> queue;
+  queue.push(std::string_view("abc"));
+
+  EXPECT_FALSE(queue.try_reserve(4).has_value());
+
+  std::optional reservation = queue.try_reserve(2);
+  ASSERT_TRUE(reservation.has_value());
+  std::memcpy(reservation->contiguous_data().first.data(), "de", 2);
+  reservation->commit(2);
+  EXPECT_EQ(queue.size(), 2u);
+}
+
+TEST(InlineVarLenEntryQueueClass, ReserveOverwriteRemovesOldEntries) {
+  pw::BasicInlineVarLenEntryQueue<char, 7> queue;
+  queue.push(std::string_view("ab"));
+  queue.push(std::string_view("cd"));
+
+  auto reservation = queue.reserve_overwrite(4);
+  EXPECT_EQ(queue.size(), 1u);
+  auto [span_1, span_2] = reservation.contiguous_data();
+  std::memcpy(span_1.data(), "wxyz", span_1.size());
+  std::memcpy(span_2.data(), "wxyz" + span_1.size(), span_2.size());
+  reservation.commit(4);
+
+  ASSERT_EQ(queue.size(), 2u);
+  auto it = queue.begin();
+  EXPECT_TRUE(std::equal(it->begin(), it->end(), "cd"));
+  ++it;
+  EXPECT_TRUE(std::equal(it->begin(), it->end(), "wxyz"));
+}
+
+TEST(InlineVarLenEntryQueue, CReserveAndCommit) {
+  PW_VARIABLE_LENGTH_ENTRY_QUEUE_DECLARE(queue, 10);
+
+  pw_InlineVarLenEntryQueue_Reservation reservation;
+  ASSERT_TRUE(pw_InlineVarLenEntryQueue_TryReserve(queue, 10, &reservation));
+  ASSERT_EQ(reservation.size_1, 10u);
+  EXPECT_EQ(reservation.size_2, 0u);
+  std::memcpy(reservation.data_1, "Sandro", 6);
+  pw_InlineVarLenEntryQueue_Commit(queue, &reservation, 6);
+
+  EXPECT_FALSE(pw_InlineVarLenEntryQueue_TryReserve(queue, 5, &reservation));
+
+  ASSERT_EQ(pw_InlineVarLenEntryQueue_Size(queue), 1u);
+  pw_InlineVarLenEntryQueue_Iterator it =
+      pw_InlineVarLenEntryQueue_Begin(queue);
+  pw_InlineVarLenEntryQueue_Entry entry =
+      pw_InlineVarLenEntryQueue_GetEntry(&it);
+  char value[8]{};
+  EXPECT_EQ(pw_InlineVarLenEntryQueue_Entry_Copy(&entry, value, sizeof(value)),
+            6u);
+  EXPECT_STREQ(value, "Sandro");
+}
+
 }  // namespace
@@ -0,0 +1,192 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_hash_set.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_unit_test/framework.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public IntrusiveHashSet<uint32_t, TestItem>::Item {
+ public:
+  constexpr TestItem() = default;
+  constexpr explicit TestItem(uint32_t key) : key_(key) {}
+
+  uint32_t key() const { return key_; }
+  void set_key(uint32_t key) { key_ = key; }
+
+ private:
+  uint32_t key_ = 0;
+};
+
+using Set = IntrusiveHashSet<uint32_t, TestItem>;
+
+// Sends every key to the same bucket.
+struct CollidingHash {
+  size_t operator()(uint32_t) const { return 1; }
+};
+
+class CollidingItem
+    : public IntrusiveHashSet<uint32_t, CollidingItem, CollidingHash>::Item {
+ public:
+  constexpr explicit CollidingItem(uint32_t key) : key_(key) {}
+
+  uint32_t key() const { return key_; }
+
+ private:
+  uint32_t key_;
+};
+
+TEST(IntrusiveHashSet, Empty) {
+  std::array<Set::Bucket, 4> buckets;
+  Set set(buckets);
+  EXPECT_TRUE(set.empty());
+  EXPECT_EQ(set.size(), 0u);
+  EXPECT_EQ(set.bucket_count(), 4u);
+  EXPECT_EQ(set.begin(), set.end());
+  EXPECT_FALSE(set.contains(1));
+}
+
+TEST(IntrusiveHashSet, InsertAndFind) {
+  std::array<Set::Bucket, 4> buckets;
+  Set set(buckets);
+  TestItem one(1);
+  TestItem two(2);
+  TestItem five(5);
+
+  auto [it, inserted] = set.insert(one);
+  EXPECT_TRUE(inserted);
+  EXPECT_EQ(&*it, &one);
+  EXPECT_TRUE(set.insert(two).second);
+  EXPECT_TRUE(set.insert(five).second);
+
+  EXPECT_FALSE(set.empty());
+  EXPECT_EQ(set.size(), 3u);
+  EXPECT_EQ(&*set.find(1), &one);
+  EXPECT_EQ(&*set.find(5), &five);
+  EXPECT_EQ(set.find(3), set.end());
+  EXPECT_EQ(set.count(2), 1u);
+  set.clear();
+}
+
+TEST(IntrusiveHashSet, InsertDuplicateKey) {
+  std::array<Set::Bucket, 2> buckets;
+  Set set(buckets);
+  TestItem first(7);
+  TestItem second(7);
+  ASSERT_TRUE(set.insert(first).second);
+  auto [it, inserted] = set.insert(second);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(&*it, &first);
+  EXPECT_EQ(set.size(), 1u);
+  set.clear();
+}
+
+TEST(IntrusiveHashSet, CollidingKeys) {
+  using CollidingSet = IntrusiveHashSet<uint32_t, CollidingItem, CollidingHash>;
+  std::array<CollidingSet::Bucket, 3> buckets;
+  CollidingSet set(buckets);
+  CollidingItem a(1);
+  CollidingItem b(2);
+  CollidingItem c(3);
+  set.insert(a);
+  set.insert(b);
+  set.insert(c);
+
+  EXPECT_EQ(&*set.find(2), &b);
+  EXPECT_EQ(set.erase(uint32_t{2}), 1u);
+  EXPECT_EQ(set.erase(uint32_t{2}), 0u);
+  EXPECT_FALSE(set.erase(b));
+  EXPECT_EQ(&*set.find(1), &a);
+  EXPECT_EQ(&*set.find(3), &c);
+  EXPECT_EQ(set.size(), 2u);
+  set.clear();
+}
+
+TEST(IntrusiveHashSet, EraseItem) {
+  std::array<Set::Bucket, 4> buckets;
+  Set set(buckets);
+  TestItem one(1);
+  TestItem two(2);
+  set.insert(one);
+  set.insert(two);
+
+  EXPECT_TRUE(set.erase(one));
+  EXPECT_FALSE(set.erase(one));
+  EXPECT_FALSE(set.contains(1));
+  EXPECT_TRUE(set.contains(2));
+  set.clear();
+}
+
+TEST(IntrusiveHashSet, IteratesOverAllItems) {
+  std::array<Set::Bucket, 5> buckets;
+  Set set(buckets);
+  std::array<TestItem, 8> items;
+  for (uint32_t i = 0; i < items.size(); ++i) {
+    items[i].set_key(i * 3);
+    set.insert(items[i]);
+  }
+
+  uint32_t key_sum = 0;
+  size_t count = 0;
+  for (const TestItem& item : set) {
+    key_sum += item.key();
+    count += 1;
+  }
+  EXPECT_EQ(count, items.size());
+  EXPECT_EQ(key_sum, 3u * (0 + 1 + 2 + 3 + 4 + 5 + 6 + 7));
+
+  const Set& const_set = set;
+  Set::const_iterator it = set.begin();
+  EXPECT_EQ(it, const_set.begin());
+  set.clear();
+}
+
+TEST(IntrusiveHashSet, DestroyedItemRemovesItself) {
+  std::array<Set::Bucket, 2> buckets;
+  Set set(buckets);
+  TestItem first(1);
+  set.insert(first);
+  {
+    TestItem second(2);
+    set.insert(second);
+    EXPECT_EQ(set.size(), 2u);
+  }
+  EXPECT_EQ(set.size(), 1u);
+  EXPECT_TRUE(set.contains(1));
+  set.clear();
+}
+
+TEST(IntrusiveHashSet, DestroyedSetUnlistsItems) {
+  std::array<Set::Bucket, 2> buckets;
+  TestItem item(1);
+  {
+    Set set(buckets);
+    set.insert(item);
+  }
+
+  // The item may be added to another set.
+  std::array<Set::Bucket, 2> other_buckets;
+  Set other(other_buckets);
+  EXPECT_TRUE(other.insert(item).second);
+  other.clear();
+}
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,230 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/intrusive_map.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "pw_unit_test/framework.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public IntrusiveMap<uint32_t, TestItem>::Item {
+ public:
+  constexpr TestItem() = default;
+  constexpr explicit TestItem(uint32_t key) : key_(key) {}
+
+  uint32_t key() const { return key_; }
+  void set_key(uint32_t key) { key_ = key; }
+
+ private:
+  uint32_t key_ = 0;
+};
+
+using Map = IntrusiveMap<uint32_t, TestItem>;
+
+// Returns whether the map's keys are the expected keys, in order.
+template <size_t kSize>
+bool KeysAre(const Map& map, const std::array<uint32_t, kSize>& keys) {
+  auto it = map.begin();
+  for (uint32_t key : keys) {
+    if (it == map.end() || it->key() != key) {
+      return false;
+    }
+    ++it;
+  }
+  return it == map.end();
+}
+
+TEST(IntrusiveMap, Empty) {
+  Map map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.size(), 0u);
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.find(1), map.end());
+  EXPECT_EQ(map.lower_bound(1), map.end());
+}
+
+TEST(IntrusiveMap, InsertIteratesInOrder) {
+  std::array<TestItem, 5> items = {
+      TestItem(30), TestItem(10), TestItem(50), TestItem(20), TestItem(40)};
+  Map map;
+  for (TestItem& item : items) {
+    auto [it, inserted] = map.insert(item);
+    EXPECT_TRUE(inserted);
+    EXPECT_EQ(&*it, &item);
+  }
+  EXPECT_FALSE(map.empty());
+  EXPECT_EQ(map.size(), 5u);
+  EXPECT_TRUE(KeysAre<5>(map, {10, 20, 30, 40, 50}));
+  map.clear();
+}
+
+TEST(IntrusiveMap, InsertDuplicateKey) {
+  TestItem first(1);
+  TestItem second(1);
+  Map map;
+  ASSERT_TRUE(map.insert(first).second);
+  auto [it, inserted] = map.insert(second);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(&*it, &first);
+  EXPECT_TRUE(second.unlisted());
+  map.clear();
+}
+
+TEST(IntrusiveMap, FindAndBounds) {
+  std::array<TestItem, 3> items = {TestItem(10), TestItem(20), TestItem(30)};
+  Map map;
+  for (TestItem& item : items) {
+    map.insert(item);
+  }
+
+  EXPECT_EQ(&*map.find(20), &items[1]);
+  EXPECT_EQ(map.find(25), map.end());
+  EXPECT_TRUE(map.contains(30));
+  EXPECT_EQ(map.count(31), 0u);
+
+  EXPECT_EQ(&*map.lower_bound(20), &items[1]);
+  EXPECT_EQ(&*map.lower_bound(21), &items[2]);
+  EXPECT_EQ(map.lower_bound(31), map.end());
+  EXPECT_EQ(&*map.upper_bound(20), &items[2]);
+  EXPECT_EQ(&*map.upper_bound(0), &items[0]);
+  EXPECT_EQ(map.upper_bound(30), map.end());
+
+  const Map& const_map = map;
+  Map::const_iterator it = const_map.find(10);
+  EXPECT_EQ(it->key(), 10u);
+  EXPECT_EQ(it, map.begin());
+  map.clear();
+}
+
+TEST(IntrusiveMap, IterateBackward) {
+  std::array<TestItem, 4> items = {
+      TestItem(4), TestItem(2), TestItem(3), TestItem(1)};
+  Map map;
+  for (TestItem& item : items) {
+    map.insert(item);
+  }
+
+  uint32_t expected = 4;
+  for (auto it = map.end(); it != map.begin();) {
+    --it;
+    EXPECT_EQ(it->key(), expected);
+    expected -= 1;
+  }
+  EXPECT_EQ(expected, 0u);
+  map.clear();
+}
+
+TEST(IntrusiveMap, Erase) {
+  std::array<TestItem, 5> items = {
+      TestItem(1), TestItem(2), TestItem(3), TestItem(4), TestItem(5)};
+  Map map;
+  for (TestItem& item : items) {
+    map.insert(item);
+  }
+
+  map.erase(items[2]);
+  EXPECT_TRUE(items[2].unlisted());
+  EXPECT_EQ(map.erase(uint32_t{1}), 1u);
+  EXPECT_EQ(map.erase(uint32_t{1}), 0u);
+  auto next = map.erase(map.find(4));
+  EXPECT_EQ(next->key(), 5u);
+  EXPECT_TRUE(KeysAre<2>(map, {2, 5}));
+
+  // Erased items may be added again.
+  map.insert(items[2]);
+  EXPECT_TRUE(KeysAre<3>(map, {2, 3, 5}));
+  map.clear();
+}
+
+TEST(IntrusiveMap, DestroyedItemRemovesItself) {
+  Map map;
+  TestItem first(1);
+  map.insert(first);
+  {
+    TestItem second(2);
+    map.insert(second);
+    EXPECT_EQ(map.size(), 2u);
+  }
+  EXPECT_EQ(map.size(), 1u);
+  EXPECT_EQ(&*map.begin(), &first);
+  map.clear();
+}
+
+TEST(IntrusiveMap, DestroyedMapUnlistsItems) {
+  TestItem item(1);
+  {
+    Map map;
+    map.insert(item);
+    EXPECT_FALSE(item.unlisted());
+  }
+  EXPECT_TRUE(item.unlisted());
+}
+
+TEST(IntrusiveMap, CustomCompare) {
+  class Item : public IntrusiveMap<int, Item, std::greater<int>>::Item {
+   public:
+    explicit Item(int key) : key_(key) {}
+    int key() const { return key_; }
+
+   private:
+    int key_;
+  };
+
+  Item a(1);
+  Item b(3);
+  Item c(2);
+  IntrusiveMap<int, Item, std::greater<int>> map;
+  map.insert(a);
+  map.insert(b);
+  map.insert(c);
+  auto it = map.begin();
+  EXPECT_EQ((it++)->key(), 3);
+  EXPECT_EQ((it++)->key(), 2);
+  EXPECT_EQ((it++)->key(), 1);
+  EXPECT_EQ(it, map.end());
+  map.clear();
+}
+
+TEST(IntrusiveMap, ManyInsertionsAndErasures) {
+  constexpr uint32_t kItems = 200;
+  std::array<TestItem, kItems> items;
+  Map map;
+
+  // Insert the items in a scrambled order, and erase every third key.
+  for (uint32_t i = 0; i < kItems; ++i) {
+    uint32_t key = (i * 73) % kItems;
+    items[i].set_key(key);
+    ASSERT_TRUE(map.insert(items[i]).second);
+  }
+  for (uint32_t key = 0; key < kItems; key += 3) {
+    EXPECT_EQ(map.erase(key), 1u);
+  }
+
+  uint32_t expected = 1;
+  for (const TestItem& item : map) {
+    EXPECT_EQ(item.key(), expected);
+    expected += expected % 3 == 1 ? 1 : 2;
+  }
+  EXPECT_EQ(map.size(), kItems - (kItems + 2) / 3);
+  map.clear();
+}
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,231 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <algorithm>
+
+#include "pw_assert/check.h"
+#include "pw_containers/internal/intrusive_tree_impl.h"
+
+namespace pw::intrusive_tree_impl {
+
+using Item = Tree::Item;
+
+// The AVL tree operations, which Item allows to access its links.
+class TreeOps {
+ public:
+  static uint8_t Height(const Item* item) {
+    return item == nullptr ? 0 : item->height_;
+  }
+
+  static void UpdateHeight(Item& item) {
+    item.height_ = static_cast<uint8_t>(
+        1 + std::max(Height(item.left_), Height(item.right_)));
+  }
+
+  // Points the parent's link to `old_child` at `new_child`. The sentinel only
+  // has a left child.
+  static void ReplaceChild(Item& parent, Item* old_child, Item* new_child) {
+    if (parent.left_ == old_child) {
+      parent.left_ = new_child;
+    } else {
+      parent.right_ = new_child;
+    }
+    if (new_child != nullptr) {
+      new_child->parent_ = &parent;
+    }
+  }
+
+  static Item& RotateLeft(Item& item) {
+    Item& pivot = *item.right_;
+    ReplaceChild(*item.parent_, &item, &pivot);
+    item.right_ = pivot.left_;
+    if (item.right_ != nullptr) {
+      item.right_->parent_ = &item;
+    }
+    pivot.left_ = &item;
+    item.parent_ = &pivot;
+    UpdateHeight(item);
+    UpdateHeight(pivot);
+    return pivot;
+  }
+
+  static Item& RotateRight(Item& item) {
+    Item& pivot = *item.left_;
+    ReplaceChild(*item.parent_, &item, &pivot);
+    item.left_ = pivot.right_;
+    if (item.left_ != nullptr) {
+      item.left_->parent_ = &item;
+    }
+    pivot.right_ = &item;
+    item.parent_ = &pivot;
+    UpdateHeight(item);
+    UpdateHeight(pivot);
+    return pivot;
+  }
+
+  // Restores the AVL property at the item, whose subtrees differ in height by
+  // at most two. Returns the root of the rebalanced subtree.
+  static Item& Balance(Item& item) {
+    const int balance = Height(item.left_) - Height(item.right_);
+    if (balance > 1) {
+      if (Height(item.left_->left_) < Height(item.left_->right_)) {
+        RotateLeft(*item.left_);
+      }
+      return RotateRight(item);
+    }
+    if (balance < -1) {
+      if (Height(item.right_->right_) < Height(item.right_->left_)) {
+        RotateRight(*item.right_);
+      }
+      return RotateLeft(item);
+    }
+    UpdateHeight(item);
+    return item;
+  }
+
+  // Rebalances each item from `item` up to the root.
+  static void Rebalance(Item* item) {
+    while (!item->IsSentinel()) {
+      item = Balance(*item).parent_;
+    }
+  }
+
+  static void Remove(Item& item) {
+    Item& parent = *item.parent_;
+    Item* rebalance_from;
+    if (item.left_ != nullptr && item.right_ != nullptr) {
+      // Replace the item with its successor, which has no left child.
+      Item* successor = item.right_;
+      while (successor->left_ != nullptr) {
+        successor = successor->left_;
+      }
+      if (successor->parent_ == &item) {
+        rebalance_from = successor;
+      } else {
+        rebalance_from = successor->parent_;
+        ReplaceChild(*successor->parent_, successor, successor->right_);
+        successor->right_ = item.right_;
+        successor->right_->parent_ = successor;
+      }
+      successor->left_ = item.left_;
+      successor->left_->parent_ = successor;
+      successor->height_ = item.height_;
+      ReplaceChild(parent, &item, successor);
+    } else {
+      ReplaceChild(
+          parent, &item, item.left_ != nullptr ? item.left_ : item.right_);
+      rebalance_from = &parent;
+    }
+    Rebalance(rebalance_from);
+    Reset(item);
+  }
+
+  static void Reset(Item& item) {
+    item.parent_ = nullptr;
+    item.left_ = nullptr;
+    item.right_ = nullptr;
+    item.height_ = 0;
+  }
+};
+
+void Item::unlist() {
+  if (!unlisted()) {
+    TreeOps::Remove(*this);
+  }
+}
+
+Item* Item::Next() {
+  Item* item = this;
+  if (item->right_ != nullptr) {
+    item = item->right_;
+    while (item->left_ != nullptr) {
+      item = item->left_;
+    }
+    return item;
+  }
+  // Go up until coming from a left child. The root is the sentinel's left
+  // child, so this ends at the sentinel after the last item.
+  while (item->parent_->right_ == item) {
+    item = item->parent_;
+  }
+  return item->parent_;
+}
+
+Item* Item::Previous() {
+  Item* item = this;
+  if (item->left_ != nullptr) {
+    // The sentinel's left child is the root, so this finds the last item when
+    // decrementing end().
+    item = item->left_;
+    while (item->right_ != nullptr) {
+      item = item->right_;
+    }
+    return item;
+  }
+  while (item->parent_->left_ == item) {
+    item = item->parent_;
+  }
+  return item->parent_;
+}
+
+Item* Tree::begin() noexcept {
+  Item* item = &sentinel_;
+  while (item->left_ != nullptr) {
+    item = item->left_;
+  }
+  return item;
+}
+
+void Tree::InsertChild(Item* parent, bool left, Item& item) {
+  PW_CHECK(item.unlisted(),
+           "Cannot add an item to a pw::IntrusiveMap that is already in one");
+  if (parent == nullptr) {
+    parent = &sentinel_;
+    left = true;
+  }
+  Item*& link = left ? parent->left_ : parent->right_;
+  PW_DCHECK(link == nullptr);
+  link = &item;
+  item.parent_ = parent;
+  item.height_ = 1;
+  TreeOps::Rebalance(parent);
+}
+
+void Tree::clear() {
+  // Unlink the items from the bottom up, so each is O(1).
+  Item* item = sentinel_.left_;
+  while (item != nullptr) {
+    if (item->left_ != nullptr) {
+      item = item->left_;
+    } else if (item->right_ != nullptr) {
+      item = item->right_;
+    } else {
+      Item* parent = item->parent_;
+      TreeOps::ReplaceChild(*parent, item, nullptr);
+      TreeOps::Reset(*item);
+      item = parent->IsSentinel() ? nullptr : parent;
+    }
+  }
+}
+
+size_t Tree::size() const {
+  size_t total = 0;
+  for (const Item* item = begin(); item != end();
+       item = const_cast<Item*>(item)->Next()) {
+    total += 1;
+  }
+  return total;
+}
+
+}  // namespace pw::intrusive_tree_impl
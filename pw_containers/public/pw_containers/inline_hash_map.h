@@ -0,0 +1,432 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "pw_assert/assert.h"
+#include "pw_containers/internal/raw_storage.h"
+
+namespace pw {
+
+/// The `InlineHashMap` class is similar to the STL's `std::unordered_map`,
+/// except it is backed by a fixed-size buffer and never allocates. Keys may be
+/// inserted and erased at any time, up to `kCapacity` entries.
+///
+/// Entries are stored in a single array using open addressing with Robin Hood
+/// hashing: an entry that is further from its home slot takes the slot of an
+/// entry that is closer to its own, which keeps probe sequences short even
+/// when the map is nearly full. Erasing shifts the following entries back
+/// instead of leaving tombstones, so lookups do not slow down as keys come and
+/// go. Besides the entries, each slot takes one byte (two bytes if
+/// `kCapacity` is 255 or more) to hold its entry's distance from its home
+/// slot.
+///
+/// The map does not grow: `insert` and `try_emplace` return `end()` if the map
+/// is full, and `operator[]` asserts.
+///
+/// Inserting or erasing entries invalidates all iterators, since entries are
+/// moved between slots.
+template <typename Key,
+          typename Value,
+          size_t kCapacity,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class InlineHashMap {
+ private:
+  template <bool kIsConst>
+  class Iterator;
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<const Key, Value>;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  /// Constructs an empty map.
+  constexpr InlineHashMap() noexcept = default;
+
+  /// Constructs a map from a list of entries. Later duplicate keys are
+  /// ignored.
+  InlineHashMap(std::initializer_list<value_type> list) {
+    for (const value_type& entry : list) {
+      PW_ASSERT(insert(entry).first != end());
+    }
+  }
+
+  InlineHashMap(const InlineHashMap& other) { CopyFrom(other); }
+
+  InlineHashMap(InlineHashMap&& other) noexcept { MoveFrom(other); }
+
+  InlineHashMap& operator=(const InlineHashMap& other) {
+    if (this != &other) {
+      clear();
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  InlineHashMap& operator=(InlineHashMap&& other) noexcept {
+    if (this != &other) {
+      clear();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  ~InlineHashMap() { clear(); }
+
+  // Iterators
+
+  iterator begin() noexcept { return iterator(this, 0); }
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(this, kCapacity); }
+  const_iterator end() const noexcept {
+    return const_iterator(this, kCapacity);
+  }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Capacity
+
+  [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+  bool full() const noexcept { return size_ == kCapacity; }
+  size_type size() const noexcept { return size_; }
+  static constexpr size_type max_size() noexcept { return capacity(); }
+  static constexpr size_type capacity() noexcept { return kCapacity; }
+
+  // Lookup
+
+  /// Returns an iterator to the entry with the key, or `end()` if there is
+  /// none.
+  iterator find(const key_type& key) { return iterator(this, Find(key)); }
+  const_iterator find(const key_type& key) const {
+    return const_iterator(this, Find(key));
+  }
+
+  bool contains(const key_type& key) const { return Find(key) != kCapacity; }
+  size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+  /// Accesses the value mapped to a key.
+  ///
+  /// @pre The key must exist.
+  mapped_type& at(const key_type& key) {
+    const size_type index = Find(key);
+    PW_ASSERT(index != kCapacity);
+    return Slot(index).second;
+  }
+  const mapped_type& at(const key_type& key) const {
+    const size_type index = Find(key);
+    PW_ASSERT(index != kCapacity);
+    return Slot(index).second;
+  }
+
+  /// Accesses the value mapped to a key, inserting a value-initialized one if
+  /// the key does not exist.
+  ///
+  /// @pre The key must exist, or the map must not be full.
+  mapped_type& operator[](const key_type& key) {
+    auto [it, inserted] = try_emplace(key);
+    PW_ASSERT(it != end());
+    return it->second;
+  }
+
+  // Modifiers
+
+  /// Inserts an entry if its key does not exist.
+  ///
+  /// @returns An iterator to the entry with the key and `true` if the entry
+  /// was inserted. If the map is full, returns `end()` and `false`.
+  std::pair<iterator, bool> insert(const value_type& entry) {
+    return try_emplace(entry.first, entry.second);
+  }
+  std::pair<iterator, bool> insert(value_type&& entry) {
+    return try_emplace(entry.first, std::move(entry.second));
+  }
+
+  /// Inserts an entry constructed from `args` if the key does not exist.
+  /// Nothing is constructed if the key exists.
+  ///
+  /// @returns An iterator to the entry with the key and `true` if the entry
+  /// was inserted. If the map is full, returns `end()` and `false`.
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+    const size_type index = Find(key);
+    if (index != kCapacity) {
+      return {iterator(this, index), false};
+    }
+    if (full()) {
+      return {end(), false};
+    }
+    return {iterator(this,
+                     Insert(std::piecewise_construct,
+                            std::forward_as_tuple(key),
+                            std::forward_as_tuple(std::forward<Args>(args)...))),
+            true};
+  }
+
+  /// Inserts an entry, or assigns the value if the key exists.
+  ///
+  /// @returns An iterator to the entry with the key and `true` if the entry
+  /// was inserted. If the map is full, returns `end()` and `false`.
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& value) {
+    auto result = try_emplace(key, std::forward<M>(value));
+    if (!result.second && result.first != end()) {
+      result.first->second = std::forward<M>(value);
+    }
+    return result;
+  }
+
+  /// Removes the entry with the key, if any.
+  ///
+  /// @returns The number of entries removed, 0 or 1.
+  size_type erase(const key_type& key) {
+    const size_type index = Find(key);
+    if (index == kCapacity) {
+      return 0;
+    }
+    Erase(index);
+    return 1;
+  }
+
+  /// Removes the entry at the iterator, which must not be `end()`.
+  void erase(const_iterator position) {
+    PW_ASSERT(position.map_ == this && position.index_ < kCapacity);
+    Erase(position.index_);
+  }
+
+  /// Removes all entries.
+  void clear() noexcept {
+    for (size_type i = 0; i < kCapacity; ++i) {
+      if (distances_[i] != kEmpty) {
+        Slot(i).~value_type();
+        distances_[i] = kEmpty;
+      }
+    }
+    size_ = 0;
+  }
+
+ private:
+  // Each slot's distance from its entry's home slot, plus one, or kEmpty.
+  using Distance =
+      std::conditional_t<(kCapacity < std::numeric_limits<uint8_t>::max()),
+                         uint8_t,
+                         uint16_t>;
+  static constexpr Distance kEmpty = 0;
+
+  static_assert(kCapacity > 0u, "InlineHashMap must have a capacity");
+  static_assert(kCapacity < std::numeric_limits<uint16_t>::max(),
+                "InlineHashMap capacity must be less than 65535");
+
+  template <bool kIsConst>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = InlineHashMap::value_type;
+    using difference_type = ptrdiff_t;
+    using pointer = std::conditional_t<kIsConst, const value_type*, value_type*>;
+    using reference =
+        std::conditional_t<kIsConst, const value_type&, value_type&>;
+
+    constexpr Iterator() = default;
+
+    // Allow converting non-const iterators to const iterators.
+    template <bool kOtherIsConst,
+              typename = std::enable_if_t<kIsConst && !kOtherIsConst>>
+    constexpr Iterator(const Iterator<kOtherIsConst>& other)
+        : map_(other.map_), index_(other.index_) {}
+
+    reference operator*() const { return map_->Slot(index_); }
+    pointer operator->() const { return &map_->Slot(index_); }
+
+    Iterator& operator++() {
+      index_ = map_->NextOccupied(index_ + 1);
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator original = *this;
+      operator++();
+      return original;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+      return lhs.map_ == rhs.map_ && lhs.index_ == rhs.index_;
+    }
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class InlineHashMap;
+
+    using Map =
+        std::conditional_t<kIsConst, const InlineHashMap, InlineHashMap>;
+
+    constexpr Iterator(Map* map, size_type index)
+        : map_(map), index_(map->NextOccupied(index)) {}
+
+    Map* map_ = nullptr;
+    size_type index_ = 0;
+  };
+
+  value_type& Slot(size_type index) { return slots_.data()[index]; }
+  const value_type& Slot(size_type index) const {
+    return slots_.data()[index];
+  }
+
+  static size_type Home(const key_type& key) {
+    return static_cast<size_type>(hasher()(key)) % kCapacity;
+  }
+
+  static size_type Next(size_type index) {
+    return index + 1 == kCapacity ? 0 : index + 1;
+  }
+
+  constexpr size_type NextOccupied(size_type index) const {
+    while (index < kCapacity && distances_[index] == kEmpty) {
+      index += 1;
+    }
+    return index;
+  }
+
+  // Returns the index of the entry with the key, or kCapacity.
+  size_type Find(const key_type& key) const {
+    size_type index = Home(key);
+    // Entries are ordered by distance from their home slot along each probe
+    // sequence, so the key is absent once an entry is closer to its home than
+    // the key would be.
+    for (size_type distance = 1; distance <= kCapacity; ++distance) {
+      if (distances_[index] < distance) {
+        break;
+      }
+      if (key_equal()(Slot(index).first, key)) {
+        return index;
+      }
+      index = Next(index);
+    }
+    return kCapacity;
+  }
+
+  // Inserts an entry with a key that is not in the map. Returns its index.
+  //
+  // Precondition: the map is not full.
+  template <typename... Args>
+  size_type Insert(Args&&... args) {
+    containers::internal::RawStorage<value_type, 1> carry_storage;
+    value_type& carry = *new (carry_storage.data())
+        value_type(std::forward<Args>(args)...);
+
+    size_type index = Home(carry.first);
+    size_type inserted_index = kCapacity;
+    size_type distance = 1;
+    while (distances_[index] != kEmpty) {
+      if (distances_[index] < distance) {
+        // Take the slot from the entry that is closer to its home, and find a
+        // slot for that entry instead.
+        SwapWithSlot(index, carry);
+        const size_type displaced_distance = distances_[index];
+        distances_[index] = static_cast<Distance>(distance);
+        distance = displaced_distance;
+        if (inserted_index == kCapacity) {
+          inserted_index = index;
+        }
+      }
+      index = Next(index);
+      distance += 1;
+    }
+
+    new (&Slot(index)) value_type(std::move(carry));
+    carry.~value_type();
+    distances_[index] = static_cast<Distance>(distance);
+    size_ += 1;
+    return inserted_index == kCapacity ? index : inserted_index;
+  }
+
+  void SwapWithSlot(size_type index, value_type& carry) {
+    value_type& slot = Slot(index);
+    containers::internal::RawStorage<value_type, 1> temp_storage;
+    value_type& temp = *new (temp_storage.data()) value_type(std::move(slot));
+    slot.~value_type();
+    new (&slot) value_type(std::move(carry));
+    carry.~value_type();
+    new (&carry) value_type(std::move(temp));
+    temp.~value_type();
+  }
+
+  // Removes the entry at the index and shifts the entries after it that are
+  // away from their home slot back by one.
+  void Erase(size_type index) {
+    Slot(index).~value_type();
+    size_type next = Next(index);
+    while (distances_[next] > 1) {
+      new (&Slot(index)) value_type(std::move(Slot(next)));
+      Slot(next).~value_type();
+      distances_[index] = static_cast<Distance>(distances_[next] - 1);
+      index = next;
+      next = Next(next);
+    }
+    distances_[index] = kEmpty;
+    size_ -= 1;
+  }
+
+  // The other map has the same capacity and hash, so entries keep their slots.
+  void CopyFrom(const InlineHashMap& other) {
+    for (size_type i = 0; i < kCapacity; ++i) {
+      if (other.distances_[i] != kEmpty) {
+        new (&Slot(i)) value_type(other.Slot(i));
+      }
+    }
+    distances_ = other.distances_;
+    size_ = other.size_;
+  }
+
+  void MoveFrom(InlineHashMap& other) {
+    for (size_type i = 0; i < kCapacity; ++i) {
+      if (other.distances_[i] != kEmpty) {
+        new (&Slot(i)) value_type(std::move(other.Slot(i)));
+      }
+    }
+    distances_ = other.distances_;
+    size_ = other.size_;
+    other.clear();
+  }
+
+  std::array<Distance, kCapacity> distances_{};
+  size_type size_ = 0;
+  containers::internal::RawStorage<value_type, kCapacity> slots_;
+};
+
+}  // namespace pw
@@ -0,0 +1,163 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace pw {
+
+/// A bounded, lock-free queue that any number of threads or interrupts may
+/// push to and pop from concurrently.
+///
+/// Each slot holds a sequence number that tells producers and consumers
+/// whether the slot is free or holds a value for the current lap around the
+/// queue. Pushing or popping claims a position with one compare-and-swap and
+/// publishes the slot with a release store, so threads never wait on each
+/// other. The counters that producers and consumers contend on are aligned to
+/// separate cache lines.
+///
+/// `TryPush` and `TryPop` never block, so they may be called from interrupts.
+/// A pop may briefly see the queue as empty while a preempted producer is in
+/// the middle of a push.
+///
+/// @tparam T The type of the queued values.
+/// @tparam kCapacity The maximum number of values. Must be a power of two and
+///   at least 2.
+/// @tparam kCacheLineSize The alignment that keeps the producer and consumer
+///   positions apart. Targets without a data cache may reduce this to save
+///   memory.
+template <typename T, size_t kCapacity, size_t kCacheLineSize = 64>
+class InlineMpmcQueue {
+ public:
+  static_assert(kCapacity >= 2 && (kCapacity & (kCapacity - 1)) == 0,
+                "InlineMpmcQueue capacity must be a power of two");
+  static_assert(std::atomic<size_t>::is_always_lock_free);
+
+  using value_type = T;
+  using size_type = size_t;
+
+  InlineMpmcQueue() {
+    for (size_t i = 0; i < kCapacity; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  InlineMpmcQueue(const InlineMpmcQueue&) = delete;
+  InlineMpmcQueue& operator=(const InlineMpmcQueue&) = delete;
+
+  /// Destroys any values still in the queue. No other thread may be using the
+  /// queue.
+  ~InlineMpmcQueue() {
+    while (TryPop().has_value()) {
+    }
+  }
+
+  /// Adds a value to the back of the queue. Returns false if the queue is
+  /// full.
+  bool TryPush(const T& value) { return TryEmplace(value); }
+  bool TryPush(T&& value) { return TryEmplace(std::move(value)); }
+
+  /// Constructs a value in place at the back of the queue. Returns false,
+  /// without constructing a value, if the queue is full.
+  template <typename... Args>
+  bool TryEmplace(Args&&... args) {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[position & kMask];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const auto lap = static_cast<std::ptrdiff_t>(sequence - position);
+      if (lap == 0) {
+        if (enqueue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (lap < 0) {
+        return false;  // The slot has not been popped since the last lap.
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+    new (slot->storage) T(std::forward<Args>(args)...);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Removes and returns the value at the front of the queue, or
+  /// `std::nullopt` if the queue is empty.
+  std::optional<T> TryPop() {
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[position & kMask];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const auto lap = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+      if (lap == 0) {
+        if (dequeue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (lap < 0) {
+        return std::nullopt;  // The slot has not been pushed to on this lap.
+      } else {
+        position = dequeue_position_.load(std::memory_order_relaxed);
+      }
+    }
+    T& stored = *std::launder(reinterpret_cast<T*>(slot->storage));
+    std::optional<T> value(std::move(stored));
+    stored.~T();
+    slot->sequence.store(position + kCapacity, std::memory_order_release);
+    return value;
+  }
+
+  /// Returns the number of values in the queue. If other threads are pushing
+  /// or popping, the result is only a snapshot.
+  size_t size() const {
+    const size_t dequeued = dequeue_position_.load(std::memory_order_acquire);
+    const size_t enqueued = enqueue_position_.load(std::memory_order_acquire);
+    const auto count = static_cast<std::ptrdiff_t>(enqueued - dequeued);
+    if (count < 0) {
+      return 0;
+    }
+    return static_cast<size_t>(count) > kCapacity ? kCapacity
+                                                  : static_cast<size_t>(count);
+  }
+
+  /// Returns whether the queue is empty. If other threads are pushing or
+  /// popping, the result is only a snapshot.
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  static constexpr size_t capacity() { return kCapacity; }
+
+ private:
+  static constexpr size_t kMask = kCapacity - 1;
+
+  // A slot is free for the push at position `p` when its sequence is `p`, and
+  // holds the value for the pop at position `p` when its sequence is `p + 1`.
+  struct Slot {
+    std::atomic<size_t> sequence;
+    alignas(T) std::byte storage[sizeof(T)];
+  };
+
+  alignas(kCacheLineSize) std::atomic<size_t> enqueue_position_{0};
+  alignas(kCacheLineSize) std::atomic<size_t> dequeue_position_{0};
+  alignas(kCacheLineSize) std::array<Slot, kCapacity> slots_;
+};
+
+}  // namespace pw
@@ -117,6 +117,70 @@ void pw_InlineVarLenEntryQueue_PushOverwrite(
     const void* data,
     uint32_t data_size_bytes);
 
+/// Space in the queue for an entry that is written in place. The space may be
+/// split into two segments at the end of the ring buffer, so this struct
+/// includes pointers to both portions. Write the entry to `data_1`, then to
+/// `data_2`, and add it to the queue with
+/// @cpp_func{pw_InlineVarLenEntryQueue_Commit}.
+typedef struct {
+  uint8_t* data_1;
+  uint32_t size_1;
+  uint8_t* data_2;
+  uint32_t size_2;
+
+  // Private: do not access this field directly!
+  uint32_t _pw_prefix_size;
+} pw_InlineVarLenEntryQueue_Reservation;
+
+/// Reserves space at the end of the queue for an entry of up to
+/// `max_data_size_bytes` bytes, which the caller writes in place. The entry is
+/// not added to the queue until it is committed. A reservation that is never
+/// committed has no effect.
+///
+/// Any other push, reserve, or clear operation invalidates the reservation.
+/// Popping entries does not.
+///
+/// @pre The entry MUST NOT be larger than `max_size_bytes()`.
+/// @pre There must be sufficient space in the queue for this entry.
+void pw_InlineVarLenEntryQueue_Reserve(
+    pw_InlineVarLenEntryQueue_Handle queue,
+    uint32_t max_data_size_bytes,
+    pw_InlineVarLenEntryQueue_Reservation* reservation);
+
+/// Reserves space at the end of the queue for an entry of up to
+/// `max_data_size_bytes` bytes, but only if there is sufficient space for it.
+///
+/// @returns true if the space was reserved; false if it did not fit
+/// @pre The entry MUST NOT be larger than `max_size_bytes()`.
+bool pw_InlineVarLenEntryQueue_TryReserve(
+    pw_InlineVarLenEntryQueue_Handle queue,
+    uint32_t max_data_size_bytes,
+    pw_InlineVarLenEntryQueue_Reservation* reservation);
+
+/// Reserves space at the end of the queue for an entry of up to
+/// `max_data_size_bytes` bytes, removing entries with `Pop` as necessary to
+/// make room. Entries are removed when the space is reserved, even if the
+/// reservation is never committed.
+///
+/// @pre The entry MUST NOT be larger than `max_size_bytes()`.
+void pw_InlineVarLenEntryQueue_ReserveOverwrite(
+    pw_InlineVarLenEntryQueue_Handle queue,
+    uint32_t max_data_size_bytes,
+    pw_InlineVarLenEntryQueue_Reservation* reservation);
+
+/// Appends the entry written to a reservation to the end of the queue. The
+/// entry is the first `data_size_bytes` of the reserved space.
+///
+/// Entries committed with fewer bytes than were reserved may use a longer size
+/// prefix than entries that are pushed, so reserve no more than is needed.
+///
+/// @pre `data_size_bytes` MUST NOT be larger than the reserved size.
+/// @pre The reservation must not have been invalidated.
+void pw_InlineVarLenEntryQueue_Commit(
+    pw_InlineVarLenEntryQueue_Handle queue,
+    const pw_InlineVarLenEntryQueue_Reservation* reservation,
+    uint32_t data_size_bytes);
+
 /// Removes the first entry from queue.
 ///
 /// @pre The queue MUST have at least one entry.
@@ -312,6 +376,7 @@ static inline bool pw_InlineVarLenEntryQueue_Empty(
 
 #include <cstddef>
 #include <limits>
+#include <optional>
 #include <type_traits>
 #include <utility>
 
@@ -375,6 +440,9 @@ class BasicInlineVarLenEntryQueue<T, containers::internal::kGenericSized> {
   // Refers to an entry in-place in the queue. Entries may not be contiguous.
   class iterator;
 
+  // Writable space for an entry that has not been added to the queue yet.
+  class Reservation;
+
   // Currently, iterators provide read-only access.
   // TODO: b/303046109 - Provide a non-const iterator.
   using const_iterator = iterator;
@@ -466,6 +534,32 @@ class BasicInlineVarLenEntryQueue<T, containers::internal::kGenericSized> {
   /// @copydoc pw_InlineVarLenEntryQueue_Pop
   void pop() { pw_InlineVarLenEntryQueue_Pop(array_); }
 
+  /// @copydoc pw_InlineVarLenEntryQueue_Reserve
+  Reservation reserve(size_type max_size_bytes) {
+    Reservation reservation(array_);
+    pw_InlineVarLenEntryQueue_Reserve(
+        array_, max_size_bytes, &reservation.reservation_);
+    return reservation;
+  }
+
+  /// @copydoc pw_InlineVarLenEntryQueue_TryReserve
+  std::optional<Reservation> try_reserve(size_type max_size_bytes) {
+    Reservation reservation(array_);
+    if (!pw_InlineVarLenEntryQueue_TryReserve(
+            array_, max_size_bytes, &reservation.reservation_)) {
+      return std::nullopt;
+    }
+    return reservation;
+  }
+
+  /// @copydoc pw_InlineVarLenEntryQueue_ReserveOverwrite
+  Reservation reserve_overwrite(size_type max_size_bytes) {
+    Reservation reservation(array_);
+    pw_InlineVarLenEntryQueue_ReserveOverwrite(
+        array_, max_size_bytes, &reservation.reservation_);
+    return reservation;
+  }
+
  protected:
   constexpr BasicInlineVarLenEntryQueue(uint32_t max_size_bytes)
       : array_{_PW_VAR_QUEUE_DATA_SIZE_BYTES(max_size_bytes), 0, 0} {}
@@ -604,6 +698,51 @@ class BasicInlineVarLenEntryQueue<T>::Entry {
   pw_InlineVarLenEntryQueue_Entry entry_;
 };
 
+/// Space reserved at the end of the queue for an entry that is written in
+/// place, such as by an encoder. The space may be discontiguous. The entry is
+/// added to the queue by `commit()`.
+///
+/// A `Reservation` is invalidated by any other push, reserve, or clear
+/// operation on its queue.
+template <typename T>
+class BasicInlineVarLenEntryQueue<T>::Reservation {
+ public:
+  using value_type = T;
+  using size_type = std::uint32_t;
+
+  constexpr Reservation(const Reservation&) = default;
+  constexpr Reservation& operator=(const Reservation&) = default;
+
+  /// Returns the writable spans of the reserved space. If the space is
+  /// contiguous, the second span is empty.
+  std::pair<span<value_type>, span<value_type>> contiguous_data() const {
+    return std::make_pair(
+        span(reinterpret_cast<value_type*>(reservation_.data_1),
+             reservation_.size_1),
+        span(reinterpret_cast<value_type*>(reservation_.data_2),
+             reservation_.size_2));
+  }
+
+  /// The number of bytes reserved.
+  size_type max_size() const {
+    return reservation_.size_1 + reservation_.size_2;
+  }
+
+  /// @copydoc pw_InlineVarLenEntryQueue_Commit
+  void commit(size_type size_bytes) const {
+    pw_InlineVarLenEntryQueue_Commit(queue_, &reservation_, size_bytes);
+  }
+
+ private:
+  friend class BasicInlineVarLenEntryQueue;
+
+  explicit constexpr Reservation(pw_InlineVarLenEntryQueue_Handle queue)
+      : queue_(queue), reservation_{} {}
+
+  pw_InlineVarLenEntryQueue_Handle queue_;
+  pw_InlineVarLenEntryQueue_Reservation reservation_;
+};
+
 /// Iterator object for a `InlineVarLenEntryQueue`.
 ///
 /// Iterators are invalidated by any operations that change the container or
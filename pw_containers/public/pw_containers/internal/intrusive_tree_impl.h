@@ -0,0 +1,202 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+namespace pw {
+
+template <typename, typename, typename>
+class IntrusiveMap;
+
+namespace intrusive_tree_impl {
+
+template <typename T, typename I>
+class Iterator;
+
+class TreeOps;
+
+// An AVL tree of items, which are ordered by the class that uses the tree.
+// The tree's operations do not depend on the item type, so that they are only
+// compiled once.
+class Tree {
+ public:
+  class Item {
+   public:
+    /// Items are not copyable.
+    Item(const Item&) = delete;
+
+    /// Items are not copyable.
+    Item& operator=(const Item&) = delete;
+
+    /// Returns whether this object is not part of a tree.
+    bool unlisted() const { return parent_ == nullptr; }
+
+    /// Removes this object from the tree it is a part of, if any.
+    ///
+    /// This is O(log n), where "n" is the number of items in the tree.
+    void unlist();
+
+   protected:
+    constexpr Item() = default;
+
+    /// Destructor.
+    ///
+    /// Removes the item from its tree. This is O(log n), where "n" is the
+    /// number of items in the tree.
+    ~Item() { unlist(); }
+
+   private:
+    friend class Tree;
+    friend class TreeOps;
+
+    template <typename, typename>
+    friend class Iterator;
+
+    // Used to mark the tree's sentinel item.
+    static constexpr uint8_t kSentinelHeight = UINT8_MAX;
+
+    explicit constexpr Item(uint8_t height) : height_(height) {}
+
+    bool IsSentinel() const { return height_ == kSentinelHeight; }
+
+    // In-order traversal. The tree's sentinel follows the last item.
+    Item* Next();
+    Item* Previous();
+
+    // The root's parent is the tree's sentinel, whose left child is the root.
+    // Unlisted items have no parent.
+    Item* parent_ = nullptr;
+    Item* left_ = nullptr;
+    Item* right_ = nullptr;
+    uint8_t height_ = 0;
+  };
+
+  constexpr Tree() : sentinel_(Item::kSentinelHeight) {}
+
+  // Trees cannot be copied, since each Item can only be in one tree.
+  Tree(const Tree&) = delete;
+  Tree& operator=(const Tree&) = delete;
+
+  ~Tree() { clear(); }
+
+  bool empty() const noexcept { return sentinel_.left_ == nullptr; }
+
+  /// Returns a pointer to the root item, or nullptr if the tree is empty.
+  Item* root() const { return sentinel_.left_; }
+
+  /// Returns the left or right child of an item, or nullptr.
+  static Item* left(const Item& item) { return item.left_; }
+  static Item* right(const Item& item) { return item.right_; }
+
+  /// Returns a pointer to the first item, or end() if the tree is empty.
+  Item* begin() noexcept;
+  const Item* begin() const noexcept {
+    return const_cast<Tree*>(this)->begin();
+  }
+
+  /// Returns a pointer to the sentinel item.
+  constexpr Item* end() noexcept { return &sentinel_; }
+  constexpr const Item* end() const noexcept { return &sentinel_; }
+
+  /// Adds an item as the left or right child of `parent`, which must not have
+  /// a child on that side, and rebalances the tree. A null `parent` adds the
+  /// item as the root of an empty tree.
+  ///
+  /// This is O(log n), where "n" is the number of items in the tree.
+  void InsertChild(Item* parent, bool left, Item& item);
+
+  /// Removes all items from the tree. This is O(n).
+  void clear();
+
+  /// Returns the number of items in the tree. This is O(n).
+  size_t size() const;
+
+ private:
+  Item sentinel_;
+};
+
+// A bidirectional iterator over the items of a tree, in order.
+template <typename T, typename I>
+class Iterator {
+ public:
+  using difference_type = std::ptrdiff_t;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using iterator_category = std::bidirectional_iterator_tag;
+
+  constexpr Iterator() : item_(nullptr) {}
+
+  // Allow converting non-const iterators to const iterators.
+  template <typename U,
+            typename J,
+            typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+  constexpr Iterator(const Iterator<U, J>& other) : item_(other.item_) {}
+
+  Iterator& operator++() {
+    item_ = item_->Next();
+    return *this;
+  }
+
+  Iterator operator++(int) {
+    Iterator previous_value = *this;
+    operator++();
+    return previous_value;
+  }
+
+  Iterator& operator--() {
+    item_ = item_->Previous();
+    return *this;
+  }
+
+  Iterator operator--(int) {
+    Iterator previous_value = *this;
+    operator--();
+    return previous_value;
+  }
+
+  T& operator*() const { return *static_cast<T*>(static_cast<I*>(item_)); }
+  T* operator->() const { return static_cast<T*>(static_cast<I*>(item_)); }
+
+  template <typename U, typename J>
+  bool operator==(const Iterator<U, J>& rhs) const {
+    return item_ == rhs.item_;
+  }
+
+  template <typename U, typename J>
+  bool operator!=(const Iterator<U, J>& rhs) const {
+    return item_ != rhs.item_;
+  }
+
+ private:
+  template <typename, typename>
+  friend class Iterator;
+
+  template <typename, typename, typename>
+  friend class ::pw::IntrusiveMap;
+
+  // Iterators over const items still traverse the tree through their items'
+  // non-const links, so the item pointer is not const.
+  constexpr explicit Iterator(const Tree::Item* item)
+      : item_(const_cast<Tree::Item*>(item)) {}
+
+  Tree::Item* item_;
+};
+
+}  // namespace intrusive_tree_impl
+}  // namespace pw
@@ -0,0 +1,258 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "pw_assert/assert.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_span/span.h"
+
+namespace pw {
+
+// IntrusiveHashSet provides average O(1) lookup of derived class items by key.
+// Items are chained in buckets, each of which is an IntrusiveList<T>. The
+// buckets are provided by the user, so the set does not allocate.
+//
+// Items must provide a `key()` method that returns their key, which must not
+// change while the item is in a set. Keys are unique within a set.
+//
+// Since items are list items, an item that is destroyed while in a set removes
+// itself from it, and an item can be in a set or a list, but not both.
+//
+// Usage:
+//
+//   class Channel : public IntrusiveHashSet<uint32_t, Channel>::Item {
+//    public:
+//     uint32_t key() const { return id_; }
+//     ...
+//   };
+//
+//   std::array<IntrusiveHashSet<uint32_t, Channel>::Bucket, 8> buckets;
+//   IntrusiveHashSet<uint32_t, Channel> channels(buckets);
+//   channels.insert(channel);
+//
+template <typename Key,
+          typename T,
+          typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class IntrusiveHashSet {
+ public:
+  using Item = typename IntrusiveList<T>::Item;
+  using Bucket = IntrusiveList<T>;
+
+ private:
+  // Iterators over const items still traverse the buckets through their
+  // non-const iterators, since the items' links are not const.
+  template <typename U>
+  class Iterator {
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = std::remove_cv_t<U>;
+    using pointer = U*;
+    using reference = U&;
+    using iterator_category = std::forward_iterator_tag;
+
+    constexpr Iterator() = default;
+
+    // Allow converting non-const iterators to const iterators.
+    template <typename V,
+              typename = std::enable_if_t<std::is_convertible_v<V*, U*>>>
+    constexpr Iterator(const Iterator<V>& other)
+        : buckets_(other.buckets_),
+          bucket_(other.bucket_),
+          item_(other.item_) {}
+
+    Iterator& operator++() {
+      ++item_;
+      SkipEmptyBuckets();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      Iterator previous_value = *this;
+      operator++();
+      return previous_value;
+    }
+
+    U& operator*() const { return *BucketIterator(item_); }
+    U* operator->() const { return &operator*(); }
+
+    template <typename V>
+    bool operator==(const Iterator<V>& rhs) const {
+      return bucket_ == rhs.bucket_ && (AtEnd() || item_ == rhs.item_);
+    }
+
+    template <typename V>
+    bool operator!=(const Iterator<V>& rhs) const {
+      return !(*this == rhs);
+    }
+
+   private:
+    template <typename>
+    friend class Iterator;
+
+    friend class IntrusiveHashSet;
+
+    using BucketIterator = typename Bucket::iterator;
+
+    // Returns an iterator to the first item in the buckets.
+    static Iterator First(span<Bucket> buckets) {
+      Iterator it(buckets, 0, buckets[0].begin());
+      it.SkipEmptyBuckets();
+      return it;
+    }
+
+    constexpr Iterator(span<Bucket> buckets,
+                       size_t bucket,
+                       BucketIterator item = BucketIterator())
+        : buckets_(buckets), bucket_(bucket), item_(item) {}
+
+    bool AtEnd() const { return bucket_ == buckets_.size(); }
+
+    void SkipEmptyBuckets() {
+      while (item_ == buckets_[bucket_].end()) {
+        if (++bucket_ == buckets_.size()) {
+          return;
+        }
+        item_ = buckets_[bucket_].begin();
+      }
+    }
+
+    span<Bucket> buckets_;
+    size_t bucket_ = 0;
+    BucketIterator item_;
+  };
+
+ public:
+  using key_type = Key;
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using iterator = Iterator<T>;
+  using const_iterator = Iterator<std::add_const_t<T>>;
+
+  // Constructs a set that chains items in the provided buckets, which must
+  // outlive the set. Lookups are fastest when there are at least as many
+  // buckets as items.
+  explicit IntrusiveHashSet(span<Bucket> buckets) : buckets_(buckets) {
+    PW_ASSERT(!buckets_.empty());
+  }
+
+  // Sets cannot be copied, since each Item can only be in one set.
+  IntrusiveHashSet(const IntrusiveHashSet&) = delete;
+  IntrusiveHashSet& operator=(const IntrusiveHashSet&) = delete;
+
+  // Removes all items from the set, so that they may be added to other sets.
+  ~IntrusiveHashSet() { clear(); }
+
+  [[nodiscard]] bool empty() const noexcept { return begin() == end(); }
+
+  // Operation is O(size + bucket_count).
+  size_t size() const {
+    size_t total = 0;
+    for (const Bucket& bucket : buckets_) {
+      total += bucket.size();
+    }
+    return total;
+  }
+
+  size_t bucket_count() const { return buckets_.size(); }
+
+  iterator begin() noexcept { return iterator::First(buckets_); }
+  const_iterator begin() const noexcept {
+    return const_iterator::First(buckets_);
+  }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(buckets_, buckets_.size()); }
+  const_iterator end() const noexcept {
+    return const_iterator(buckets_, buckets_.size());
+  }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Adds an item to the set, unless an item with the same key is in the set.
+  // Returns an iterator to the item with the key, and whether the item was
+  // added. The item must not be in a set or list.
+  std::pair<iterator, bool> insert(T& item) {
+    const size_t index = BucketIndex(item.key());
+    iterator it = FindInBucket(index, item.key());
+    if (it != end()) {
+      return {it, false};
+    }
+    buckets_[index].push_front(item);
+    return {iterator(buckets_, index, buckets_[index].begin()), true};
+  }
+
+  // Removes an item from the set, and returns whether it was in the set. The
+  // item is not destructed.
+  bool erase(T& item) { return buckets_[BucketIndex(item.key())].remove(item); }
+
+  // Removes the item with the key from the set, if any. Returns the number of
+  // items removed.
+  size_t erase(const Key& key) {
+    Bucket& bucket = buckets_[BucketIndex(key)];
+    for (auto prev = bucket.before_begin(), it = bucket.begin();
+         it != bucket.end();
+         prev = it++) {
+      if (KeyEqual()(it->key(), key)) {
+        bucket.erase_after(prev);
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+  // Removes all items from the set. The items themselves are not destructed.
+  void clear() {
+    for (Bucket& bucket : buckets_) {
+      bucket.clear();
+    }
+  }
+
+  // Returns an iterator to the item with the key, or end().
+  iterator find(const Key& key) { return FindInBucket(BucketIndex(key), key); }
+  const_iterator find(const Key& key) const {
+    return const_cast<IntrusiveHashSet*>(this)->find(key);
+  }
+
+  bool contains(const Key& key) const { return find(key) != end(); }
+  size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+ private:
+  size_t BucketIndex(const Key& key) const {
+    return Hash()(key) % buckets_.size();
+  }
+
+  iterator FindInBucket(size_t index, const Key& key) {
+    Bucket& bucket = buckets_[index];
+    for (auto it = bucket.begin(); it != bucket.end(); ++it) {
+      if (KeyEqual()(it->key(), key)) {
+        return iterator(buckets_, index, it);
+      }
+    }
+    return end();
+  }
+
+  span<Bucket> buckets_;
+};
+
+}  // namespace pw
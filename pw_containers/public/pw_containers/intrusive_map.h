@@ -0,0 +1,203 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "pw_containers/internal/intrusive_tree_impl.h"
+
+namespace pw {
+
+// IntrusiveMap provides ordered lookup of derived class items by key, using a
+// balanced (AVL) binary search tree. As with IntrusiveList, items inherit from
+// IntrusiveMap<Key, T>::Item, and the map never allocates or copies them.
+//
+// Items must provide a `key()` method that returns their key, which must not
+// change while the item is in a map. Keys are unique within a map.
+//
+// Lookup, insertion, and removal are O(log n). An item that is destroyed while
+// in a map removes itself from it.
+//
+// Usage:
+//
+//   class Call : public IntrusiveMap<uint32_t, Call>::Item {
+//    public:
+//     uint32_t key() const { return id_; }
+//     ...
+//   };
+//
+//   IntrusiveMap<uint32_t, Call> calls;
+//   calls.insert(call);
+//   auto it = calls.find(id);
+//
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class IntrusiveMap {
+ public:
+  class Item : public intrusive_tree_impl::Tree::Item {
+   protected:
+    constexpr Item() = default;
+  };
+
+  using key_type = Key;
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using pointer = T*;
+  using reference = T&;
+  using key_compare = Compare;
+  using iterator = intrusive_tree_impl::Iterator<T, Item>;
+  using const_iterator =
+      intrusive_tree_impl::Iterator<std::add_const_t<T>, const Item>;
+
+  constexpr IntrusiveMap() { CheckItemType(); }
+
+  // Maps cannot be copied, since each Item can only be in one map.
+  IntrusiveMap(const IntrusiveMap&) = delete;
+  IntrusiveMap& operator=(const IntrusiveMap&) = delete;
+
+  // Removes all items from the map, so that they may be added to other maps.
+  ~IntrusiveMap() = default;
+
+  [[nodiscard]] bool empty() const noexcept { return tree_.empty(); }
+
+  // Operation is O(size).
+  size_t size() const { return tree_.size(); }
+
+  iterator begin() noexcept { return iterator(tree_.begin()); }
+  const_iterator begin() const noexcept { return const_iterator(tree_.begin()); }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return iterator(tree_.end()); }
+  const_iterator end() const noexcept { return const_iterator(tree_.end()); }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Adds an item to the map, unless an item with the same key is in the map.
+  // Returns an iterator to the item with the key, and whether the item was
+  // added. The item must not be in a map.
+  std::pair<iterator, bool> insert(T& item) {
+    const Key& key = KeyOf(item);
+    Tree::Item* parent = nullptr;
+    bool left = false;
+    for (Tree::Item* node = tree_.root(); node != nullptr;) {
+      parent = node;
+      if (Compare()(key, KeyOf(*node))) {
+        left = true;
+        node = Tree::left(*node);
+      } else if (Compare()(KeyOf(*node), key)) {
+        left = false;
+        node = Tree::right(*node);
+      } else {
+        return {iterator(node), false};
+      }
+    }
+    tree_.InsertChild(parent, left, item);
+    return {iterator(&static_cast<Item&>(item)), true};
+  }
+
+  // Removes an item from the map. The item is not destructed.
+  //
+  // Precondition: the item is in this map.
+  void erase(T& item) { static_cast<Item&>(item).unlist(); }
+
+  // Removes the item at the iterator from the map, and returns an iterator to
+  // the item that followed it.
+  iterator erase(iterator pos) {
+    iterator next = pos;
+    ++next;
+    erase(*pos);
+    return next;
+  }
+
+  // Removes the item with the key from the map, if any. Returns the number of
+  // items removed.
+  size_t erase(const Key& key) {
+    iterator it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  // Removes all items from the map. The items themselves are not destructed.
+  void clear() { tree_.clear(); }
+
+  // Returns an iterator to the item with the key, or end().
+  iterator find(const Key& key) {
+    iterator it = lower_bound(key);
+    return it == end() || Compare()(key, KeyOf(*it.item_)) ? end() : it;
+  }
+  const_iterator find(const Key& key) const {
+    return const_cast<IntrusiveMap*>(this)->find(key);
+  }
+
+  bool contains(const Key& key) const { return find(key) != end(); }
+  size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+  // Returns an iterator to the first item whose key is not less than `key`.
+  iterator lower_bound(const Key& key) {
+    Tree::Item* result = tree_.end();
+    for (Tree::Item* node = tree_.root(); node != nullptr;) {
+      if (Compare()(KeyOf(*node), key)) {
+        node = Tree::right(*node);
+      } else {
+        result = node;
+        node = Tree::left(*node);
+      }
+    }
+    return iterator(result);
+  }
+  const_iterator lower_bound(const Key& key) const {
+    return const_cast<IntrusiveMap*>(this)->lower_bound(key);
+  }
+
+  // Returns an iterator to the first item whose key is greater than `key`.
+  iterator upper_bound(const Key& key) {
+    Tree::Item* result = tree_.end();
+    for (Tree::Item* node = tree_.root(); node != nullptr;) {
+      if (Compare()(key, KeyOf(*node))) {
+        result = node;
+        node = Tree::left(*node);
+      } else {
+        node = Tree::right(*node);
+      }
+    }
+    return iterator(result);
+  }
+  const_iterator upper_bound(const Key& key) const {
+    return const_cast<IntrusiveMap*>(this)->upper_bound(key);
+  }
+
+ private:
+  using Tree = intrusive_tree_impl::Tree;
+
+  // Check that T is an Item in a function, since the class T will not be fully
+  // defined when the IntrusiveMap<Key, T> class is instantiated.
+  static constexpr void CheckItemType() {
+    static_assert(std::is_base_of<Item, T>(),
+                  "IntrusiveMap items must be derived from "
+                  "IntrusiveMap<Key, T>::Item");
+  }
+
+  static decltype(auto) KeyOf(const T& item) { return item.key(); }
+  static decltype(auto) KeyOf(const Tree::Item& item) {
+    return KeyOf(static_cast<const T&>(static_cast<const Item&>(item)));
+  }
+
+  Tree tree_;
+};
+
+}  // namespace pw
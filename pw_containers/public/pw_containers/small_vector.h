@@ -0,0 +1,375 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "pw_allocator/allocator.h"
+#include "pw_assert/assert.h"
+#include "pw_containers/internal/raw_storage.h"
+
+namespace pw {
+
+/// The `SmallVector` class is similar to `std::vector`, except that it stores
+/// up to `kInlineCapacity` elements inline, and only allocates from a
+/// `pw::Allocator` once it grows beyond that. Most instances of a container
+/// whose size is usually small but occasionally large can then stay small,
+/// without failing on the rare large input.
+///
+/// When the vector outgrows its storage, its capacity at least doubles, so
+/// appending elements takes amortized constant time. The allocator is first
+/// asked to resize the allocation in place; otherwise, the elements are moved
+/// to a new allocation. Elements are never copied, so `T` may be move-only.
+///
+/// Allocation failures are not exceptions: `push_back`, `emplace_back`,
+/// `reserve`, and `resize` assert if the allocator cannot provide the memory,
+/// and `try_push_back`, `try_emplace_back`, and `try_reserve` return `false`
+/// instead, leaving the vector unchanged.
+///
+/// Growing the vector invalidates all iterators, pointers, and references to
+/// its elements. A `SmallVector` may be moved, but not copied, since a copy
+/// could fail to allocate.
+template <typename T, size_t kInlineCapacity>
+class SmallVector {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = ptrdiff_t;
+  using reference = value_type&;
+  using const_reference = const value_type&;
+  using pointer = value_type*;
+  using const_pointer = const value_type*;
+  using iterator = value_type*;
+  using const_iterator = const value_type*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /// Constructs an empty vector that allocates from `allocator` once it holds
+  /// more than `kInlineCapacity` elements.
+  explicit SmallVector(Allocator& allocator) noexcept
+      : allocator_(&allocator) {}
+
+  SmallVector(const SmallVector&) = delete;
+  SmallVector& operator=(const SmallVector&) = delete;
+
+  /// Takes the elements of `other`, which is left empty. If `other` had
+  /// allocated its elements, the allocation is taken without moving them.
+  SmallVector(SmallVector&& other) noexcept : allocator_(other.allocator_) {
+    MoveFrom(other);
+  }
+
+  SmallVector& operator=(SmallVector&& other) noexcept {
+    if (&other != this) {
+      clear();
+      Deallocate();
+      allocator_ = other.allocator_;
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  ~SmallVector() {
+    clear();
+    Deallocate();
+  }
+
+  Allocator& allocator() const { return *allocator_; }
+
+  // Access
+
+  reference at(size_type index) {
+    PW_ASSERT(index < size());
+    return data()[index];
+  }
+  const_reference at(size_type index) const {
+    PW_ASSERT(index < size());
+    return data()[index];
+  }
+
+  reference operator[](size_type index) {
+    PW_DASSERT(index < size());
+    return data()[index];
+  }
+  const_reference operator[](size_type index) const {
+    PW_DASSERT(index < size());
+    return data()[index];
+  }
+
+  reference front() { return data()[0]; }
+  const_reference front() const { return data()[0]; }
+
+  reference back() { return data()[size() - 1]; }
+  const_reference back() const { return data()[size() - 1]; }
+
+  T* data() noexcept { return data_; }
+  const T* data() const noexcept { return data_; }
+
+  // Iterate
+
+  iterator begin() noexcept { return data(); }
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator cbegin() const noexcept { return begin(); }
+
+  iterator end() noexcept { return data() + size(); }
+  const_iterator end() const noexcept { return data() + size(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const { return reverse_iterator(end()); }
+  const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const { return reverse_iterator(begin()); }
+  const_reverse_iterator crend() const noexcept { return rend(); }
+
+  // Size
+
+  [[nodiscard]] bool empty() const noexcept { return size() == 0u; }
+
+  size_type size() const noexcept { return size_; }
+
+  /// Returns the number of elements the vector can hold without allocating.
+  size_type capacity() const noexcept { return capacity_; }
+
+  static constexpr size_type inline_capacity() noexcept {
+    return kInlineCapacity;
+  }
+
+  static constexpr size_type max_size() noexcept {
+    return std::numeric_limits<size_type>::max() / sizeof(T);
+  }
+
+  /// Returns true if the elements are stored inline rather than in memory
+  /// from the allocator.
+  bool is_inline() const noexcept { return data_ == inline_data(); }
+
+  /// Ensures the vector can hold `new_capacity` elements without allocating.
+  /// Returns false, leaving the vector unchanged, if the allocator cannot
+  /// provide the memory.
+  [[nodiscard]] bool try_reserve(size_type new_capacity) {
+    return new_capacity <= capacity() || Reallocate(new_capacity);
+  }
+
+  /// Ensures the vector can hold `new_capacity` elements without allocating.
+  /// Asserts if the allocator cannot provide the memory.
+  void reserve(size_type new_capacity) { PW_ASSERT(try_reserve(new_capacity)); }
+
+  /// Moves the elements back inline if they fit, or into a smaller allocation
+  /// if the allocator can shrink the current one in place.
+  void shrink_to_fit();
+
+  // Modify
+
+  void clear() noexcept {
+    std::destroy(begin(), end());
+    size_ = 0;
+  }
+
+  void push_back(const T& value) { emplace_back(value); }
+
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    const bool added = try_emplace_back(std::forward<Args>(args)...);
+    PW_ASSERT(added);
+    return back();
+  }
+
+  [[nodiscard]] bool try_push_back(const T& value) {
+    return try_emplace_back(value);
+  }
+
+  [[nodiscard]] bool try_push_back(T&& value) {
+    return try_emplace_back(std::move(value));
+  }
+
+  template <typename... Args>
+  [[nodiscard]] bool try_emplace_back(Args&&... args) {
+    if (size() < capacity()) {
+      new (end()) T(std::forward<Args>(args)...);
+    } else {
+      // Construct the element before growing, since the arguments may refer
+      // to elements of this vector.
+      T value(std::forward<Args>(args)...);
+      if (!GrowFor(size() + 1)) {
+        return false;
+      }
+      new (end()) T(std::move(value));
+    }
+    size_ += 1;
+    return true;
+  }
+
+  void pop_back() {
+    PW_DASSERT(!empty());
+    back().~T();
+    size_ -= 1;
+  }
+
+  void resize(size_type new_size) { Resize(new_size); }
+
+  void resize(size_type new_size, const T& value) { Resize(new_size, value); }
+
+  iterator erase(const_iterator index) { return erase(index, index + 1); }
+
+  iterator erase(const_iterator first, const_iterator last);
+
+ private:
+  T* inline_data() { return inline_.data(); }
+  const T* inline_data() const { return inline_.data(); }
+
+  static allocator::Layout LayoutFor(size_type capacity) {
+    return allocator::Layout(capacity * sizeof(T), alignof(T));
+  }
+
+  // Ensures there is room for `min_capacity` elements, growing geometrically
+  // so that repeated appends allocate O(log n) times.
+  bool GrowFor(size_type min_capacity) {
+    if (min_capacity <= capacity()) {
+      return true;
+    }
+    if (min_capacity > max_size()) {
+      return false;
+    }
+    const size_type doubled =
+        capacity() > max_size() / 2 ? max_size() : capacity() * 2;
+    return Reallocate(std::max(min_capacity, doubled));
+  }
+
+  // Moves the elements into storage for exactly `new_capacity` elements.
+  bool Reallocate(size_type new_capacity);
+
+  // Moves the elements to `destination` and releases the current storage.
+  void Relocate(T* destination, size_type new_capacity);
+
+  void Deallocate() {
+    if (!is_inline()) {
+      allocator_->Deallocate(data_);
+      data_ = inline_data();
+      capacity_ = kInlineCapacity;
+    }
+  }
+
+  void MoveFrom(SmallVector& other);
+
+  template <typename... Args>
+  void Resize(size_type new_size, const Args&... value);
+
+  Allocator* allocator_;
+  containers::internal::RawStorage<T, kInlineCapacity> inline_;
+  T* data_ = inline_data();
+  size_type size_ = 0;
+  size_type capacity_ = kInlineCapacity;
+};
+
+// Implementations
+
+template <typename T, size_t kInlineCapacity>
+void SmallVector<T, kInlineCapacity>::shrink_to_fit() {
+  if (is_inline() || size() == capacity()) {
+    return;
+  }
+  if (size() <= kInlineCapacity) {
+    Relocate(inline_data(), kInlineCapacity);
+  } else if (allocator_->Resize(data_, LayoutFor(size()).size())) {
+    capacity_ = size();
+  }
+}
+
+template <typename T, size_t kInlineCapacity>
+typename SmallVector<T, kInlineCapacity>::iterator
+SmallVector<T, kInlineCapacity>::erase(const_iterator first,
+                                       const_iterator last) {
+  PW_DASSERT(first >= cbegin() && first <= last && last <= cend());
+  iterator destination = begin() + (first - cbegin());
+  iterator source = begin() + (last - cbegin());
+  if (first != last) {
+    iterator new_end = std::move(source, end(), destination);
+    std::destroy(new_end, end());
+    size_ = static_cast<size_type>(new_end - begin());
+  }
+  return destination;
+}
+
+template <typename T, size_t kInlineCapacity>
+bool SmallVector<T, kInlineCapacity>::Reallocate(size_type new_capacity) {
+  if (new_capacity > max_size()) {
+    return false;
+  }
+  const allocator::Layout layout = LayoutFor(new_capacity);
+  if (!is_inline() && allocator_->Resize(data_, layout.size())) {
+    capacity_ = new_capacity;
+    return true;
+  }
+  void* ptr = allocator_->Allocate(layout);
+  if (ptr == nullptr) {
+    return false;
+  }
+  Relocate(static_cast<T*>(ptr), new_capacity);
+  return true;
+}
+
+template <typename T, size_t kInlineCapacity>
+void SmallVector<T, kInlineCapacity>::Relocate(T* destination,
+                                               size_type new_capacity) {
+  std::uninitialized_move(begin(), end(), destination);
+  std::destroy(begin(), end());
+  if (!is_inline()) {
+    allocator_->Deallocate(data_);
+  }
+  data_ = destination;
+  capacity_ = new_capacity;
+}
+
+template <typename T, size_t kInlineCapacity>
+void SmallVector<T, kInlineCapacity>::MoveFrom(SmallVector& other) {
+  if (other.is_inline()) {
+    std::uninitialized_move(other.begin(), other.end(), inline_data());
+    size_ = other.size();
+    other.clear();
+    return;
+  }
+  data_ = other.data_;
+  size_ = other.size_;
+  capacity_ = other.capacity_;
+  other.data_ = other.inline_data();
+  other.size_ = 0;
+  other.capacity_ = kInlineCapacity;
+}
+
+template <typename T, size_t kInlineCapacity>
+template <typename... Args>
+void SmallVector<T, kInlineCapacity>::Resize(size_type new_size,
+                                             const Args&... value) {
+  if (new_size < size()) {
+    std::destroy(begin() + new_size, end());
+    size_ = new_size;
+    return;
+  }
+  PW_ASSERT(try_reserve(new_size));
+  while (size() < new_size) {
+    new (end()) T(value...);
+    size_ += 1;
+  }
+}
+
+}  // namespace pw
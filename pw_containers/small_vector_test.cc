@@ -0,0 +1,162 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_containers/small_vector.h"
+
+#include <cstdint>
+
+#include "pw_allocator/testing.h"
+#include "pw_containers_private/test_helpers.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw {
+namespace {
+
+using containers::test::Counter;
+using containers::test::MoveOnly;
+
+class SmallVectorTest : public ::testing::Test {
+ protected:
+  SmallVectorTest() { Counter::Reset(); }
+
+  allocator::test::AllocatorForTest<512> allocator_;
+};
+
+TEST_F(SmallVectorTest, StaysInline_UpToInlineCapacity) {
+  SmallVector<int, 4> vector(allocator_);
+  for (int i = 0; i < 4; ++i) {
+    vector.push_back(i);
+  }
+  EXPECT_TRUE(vector.is_inline());
+  EXPECT_EQ(vector.size(), 4u);
+  EXPECT_EQ(vector.capacity(), 4u);
+  EXPECT_EQ(allocator_.allocate_size(), 0u);
+}
+
+TEST_F(SmallVectorTest, SpillsToAllocator_WithGeometricGrowth) {
+  SmallVector<uint32_t, 4> vector(allocator_);
+  for (uint32_t i = 0; i < 5; ++i) {
+    vector.push_back(i);
+  }
+  EXPECT_FALSE(vector.is_inline());
+  EXPECT_EQ(vector.capacity(), 8u);
+
+  for (uint32_t i = 5; i < 17; ++i) {
+    vector.push_back(i);
+  }
+  EXPECT_EQ(vector.capacity(), 32u);
+  ASSERT_EQ(vector.size(), 17u);
+  for (uint32_t i = 0; i < 17; ++i) {
+    EXPECT_EQ(vector[i], i);
+  }
+}
+
+TEST_F(SmallVectorTest, Relocation_MovesElements) {
+  {
+    SmallVector<Counter, 2> vector(allocator_);
+    vector.emplace_back(1);
+    vector.emplace_back(2);
+    vector.emplace_back(3);
+
+    EXPECT_EQ(Counter::created, 3);
+    EXPECT_EQ(Counter::moved, 3);  // Two relocated, one constructed aside.
+    EXPECT_EQ(vector[0].value, 1);
+    EXPECT_EQ(vector[1].value, 2);
+    EXPECT_EQ(vector[2].value, 3);
+  }
+  EXPECT_EQ(Counter::created + Counter::moved, Counter::destroyed);
+  EXPECT_EQ(allocator_.deallocate_size(), 4 * sizeof(Counter));
+}
+
+TEST_F(SmallVectorTest, MoveOnlyElements) {
+  SmallVector<MoveOnly, 1> vector(allocator_);
+  vector.emplace_back(1);
+  vector.push_back(MoveOnly(2));
+  ASSERT_EQ(vector.size(), 2u);
+  EXPECT_EQ(vector[0].value, 1);
+  EXPECT_EQ(vector[1].value, 2);
+}
+
+TEST_F(SmallVectorTest, PushBackElementOfSelf_WhileGrowing) {
+  SmallVector<Counter, 1> vector(allocator_);
+  vector.emplace_back(7);
+  vector.push_back(vector[0]);
+  ASSERT_EQ(vector.size(), 2u);
+  EXPECT_EQ(vector[1].value, 7);
+}
+
+TEST_F(SmallVectorTest, TryPushBack_FailsWhenAllocatorIsExhausted) {
+  SmallVector<int, 2> vector(allocator_);
+  EXPECT_TRUE(vector.try_push_back(1));
+  EXPECT_TRUE(vector.try_push_back(2));
+
+  allocator_.Exhaust();
+  EXPECT_FALSE(vector.try_push_back(3));
+  EXPECT_FALSE(vector.try_reserve(16));
+  EXPECT_TRUE(vector.is_inline());
+  ASSERT_EQ(vector.size(), 2u);
+  EXPECT_EQ(vector[1], 2);
+}
+
+TEST_F(SmallVectorTest, Move_TakesAllocation) {
+  SmallVector<int, 2> vector(allocator_);
+  vector.resize(5, 3);
+  const int* data = vector.data();
+
+  SmallVector<int, 2> moved(std::move(vector));
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(moved.size(), 5u);
+  EXPECT_TRUE(vector.empty());  // NOLINT(bugprone-use-after-move)
+  EXPECT_TRUE(vector.is_inline());
+
+  SmallVector<int, 2> inline_vector(allocator_);
+  inline_vector.push_back(9);
+  moved = std::move(inline_vector);
+  EXPECT_TRUE(moved.is_inline());
+  ASSERT_EQ(moved.size(), 1u);
+  EXPECT_EQ(moved[0], 9);
+  EXPECT_EQ(allocator_.deallocate_ptr(), data);
+}
+
+TEST_F(SmallVectorTest, ShrinkToFit_ReturnsInline) {
+  SmallVector<int, 4> vector(allocator_);
+  vector.resize(10);
+  void* allocation = vector.data();
+  vector.resize(3);
+  EXPECT_EQ(vector.capacity(), 10u);
+
+  vector.shrink_to_fit();
+  EXPECT_TRUE(vector.is_inline());
+  EXPECT_EQ(vector.capacity(), 4u);
+  EXPECT_EQ(allocator_.deallocate_ptr(), allocation);
+}
+
+TEST_F(SmallVectorTest, Erase) {
+  SmallVector<int, 8> vector(allocator_);
+  for (int i = 0; i < 6; ++i) {
+    vector.push_back(i);
+  }
+  auto it = vector.erase(vector.begin() + 1, vector.begin() + 3);
+  EXPECT_EQ(*it, 3);
+  it = vector.erase(vector.end() - 1);
+  EXPECT_EQ(it, vector.end());
+
+  ASSERT_EQ(vector.size(), 3u);
+  EXPECT_EQ(vector[0], 0);
+  EXPECT_EQ(vector[1], 3);
+  EXPECT_EQ(vector[2], 4);
+}
+
+}  // namespace
+}  // namespace pw
@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstdint>
+
 #include "pw_cpu_exception_cortex_m/cpu_state.h"
 
 namespace pw::cpu_exception::cortex_m {
@@ -34,4 +36,16 @@ inline bool ProcessStackActive(const pw_cpu_exception_State& cpu_state) {
   return !MainStackActive(cpu_state);
 }
 
+// Returns whether a word found on the stack is likely a return address pushed
+// by a function call: it must be a Thumb address within the code region
+// [code_start, code_end) that immediately follows a BL or BLX instruction.
+//
+// The instruction preceding the address is read from the code region, so the
+// region must be readable. Intended for use with
+// pw::thread::SnapshotStackScanBacktrace() to capture backtraces in place of
+// full stacks.
+bool IsLikelyReturnAddress(uintptr_t address,
+                           uintptr_t code_start,
+                           uintptr_t code_end);
+
 }  // namespace pw::cpu_exception::cortex_m
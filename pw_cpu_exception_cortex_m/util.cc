@@ -15,6 +15,7 @@
 #include "pw_cpu_exception_cortex_m/util.h"
 
 #include <cinttypes>
+#include <cstring>
 
 #include "pw_cpu_exception_cortex_m/cpu_state.h"
 #include "pw_cpu_exception_cortex_m_private/config.h"
@@ -25,6 +26,13 @@
 namespace pw::cpu_exception::cortex_m {
 namespace {
 
+uint16_t ReadHalfword(uintptr_t address) {
+  uint16_t halfword;
+  std::memcpy(&halfword, reinterpret_cast<const void*>(address),
+              sizeof(halfword));
+  return halfword;
+}
+
 [[maybe_unused]] void LogCfsrAnalysis(const uint32_t cfsr) {
   if (cfsr == 0) {
     return;
@@ -179,4 +187,29 @@ bool MainStackActive(const pw_cpu_exception_State& cpu_state) {
   return (cpu_state.extended.exc_return & kExcReturnStackMask) == 0;
 }
 
+bool IsLikelyReturnAddress(uintptr_t address,
+                           uintptr_t code_start,
+                           uintptr_t code_end) {
+  // Return addresses have the Thumb bit set.
+  if ((address & 1) == 0) {
+    return false;
+  }
+  const uintptr_t pc = address & ~uintptr_t{1};
+  if (pc < code_start + sizeof(uint16_t) || pc > code_end) {
+    return false;
+  }
+
+  // BLX <Rm>: 0100 0111 1xxx x000.
+  if ((ReadHalfword(pc - 2) & 0xff87) == 0x4780) {
+    return true;
+  }
+
+  // BL <label>: 1111 0xxx xxxx xxxx, 11x1 xxxx xxxx xxxx.
+  if (pc < code_start + 2 * sizeof(uint16_t)) {
+    return false;
+  }
+  return (ReadHalfword(pc - 4) & 0xf800) == 0xf000 &&
+         (ReadHalfword(pc - 2) & 0xd000) == 0xd000;
+}
+
 }  // namespace pw::cpu_exception::cortex_m
@@ -14,6 +14,9 @@
 
 #include "pw_cpu_exception_cortex_m/util.h"
 
+#include <array>
+#include <cstdint>
+
 #include "pw_cpu_exception_cortex_m/cpu_state.h"
 #include "pw_unit_test/framework.h"
 
@@ -110,5 +113,58 @@ TEST(ProcessStackActive, ThreadModeProcess) {
   EXPECT_TRUE(ProcessStackActive(cpu_state));
 }
 
+class IsLikelyReturnAddressTest : public ::testing::Test {
+ protected:
+  // Thumb return address of the instruction at the given halfword index.
+  uintptr_t ReturnAddress(size_t index) const {
+    return (reinterpret_cast<uintptr_t>(kCode.data()) +
+            index * sizeof(uint16_t)) |
+           1;
+  }
+
+  bool IsLikely(uintptr_t address) const {
+    return IsLikelyReturnAddress(address,
+                                 reinterpret_cast<uintptr_t>(kCode.data()),
+                                 reinterpret_cast<uintptr_t>(kCode.end()));
+  }
+
+  static constexpr std::array<uint16_t, 8> kCode = {
+      0xf000,  // 0: bl (first half)
+      0xf800,  // 1: bl (second half)
+      0x2000,  // 2: movs r0, #0
+      0x4798,  // 3: blx r3
+      0x4618,  // 4: mov r0, r3
+      0xbf00,  // 5: nop
+      0xf7ff,  // 6: bl (first half)
+      0xfffe,  // 7: bl (second half)
+  };
+};
+
+TEST_F(IsLikelyReturnAddressTest, AfterBl) {
+  EXPECT_TRUE(IsLikely(ReturnAddress(2)));
+  EXPECT_TRUE(IsLikely(ReturnAddress(8)));
+}
+
+TEST_F(IsLikelyReturnAddressTest, AfterBlx) {
+  EXPECT_TRUE(IsLikely(ReturnAddress(4)));
+}
+
+TEST_F(IsLikelyReturnAddressTest, NotAfterCall) {
+  EXPECT_FALSE(IsLikely(ReturnAddress(3)));
+  EXPECT_FALSE(IsLikely(ReturnAddress(5)));
+  EXPECT_FALSE(IsLikely(ReturnAddress(6)));
+}
+
+TEST_F(IsLikelyReturnAddressTest, RequiresThumbBit) {
+  EXPECT_FALSE(IsLikely(ReturnAddress(2) & ~uintptr_t{1}));
+}
+
+TEST_F(IsLikelyReturnAddressTest, OutsideCodeRegion) {
+  EXPECT_FALSE(IsLikely(ReturnAddress(0)));
+  EXPECT_FALSE(IsLikely(ReturnAddress(1)));
+  EXPECT_FALSE(IsLikely(ReturnAddress(10)));
+  EXPECT_FALSE(IsLikely(0x1));
+}
+
 }  // namespace
 }  // namespace pw::cpu_exception::cortex_m
@@ -0,0 +1,38 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pw::crypto::sha256::backend {
+
+// Size of a SHA256 message block.
+inline constexpr size_t kBlockSizeBytes = 64;
+
+struct NativeSha256Context {
+  // Intermediate hash value H(i), as eight 32-bit words.
+  std::array<uint32_t, 8> state;
+
+  // Message bytes that do not yet fill a whole block.
+  std::array<std::byte, kBlockSizeBytes> block;
+  size_t block_size;
+
+  // Total number of message bytes consumed so far.
+  uint64_t message_size;
+};
+
+}  // namespace pw::crypto::sha256::backend
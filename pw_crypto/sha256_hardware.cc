@@ -0,0 +1,305 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "SHA256-HW"
+#define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_bytes/endian.h"
+#include "pw_crypto/sha256.h"
+#include "pw_status/status.h"
+
+#if defined(__ARM_FEATURE_SHA2) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_neon.h>
+#define _PW_CRYPTO_SHA256_ARM_SHA2 1
+#elif defined(__SHA__) && defined(__SSE4_1__)
+#include <immintrin.h>
+#define _PW_CRYPTO_SHA256_X86_SHA 1
+#endif
+
+#ifndef _PW_CRYPTO_SHA256_ARM_SHA2
+#define _PW_CRYPTO_SHA256_ARM_SHA2 0
+#endif  // _PW_CRYPTO_SHA256_ARM_SHA2
+
+#ifndef _PW_CRYPTO_SHA256_X86_SHA
+#define _PW_CRYPTO_SHA256_X86_SHA 0
+#endif  // _PW_CRYPTO_SHA256_X86_SHA
+
+namespace pw::crypto::sha256::backend {
+namespace {
+
+// Initial hash value H(0), from FIPS 180-4 section 5.3.3.
+constexpr std::array<uint32_t, 8> kInitialState = {
+    0x6a09e667,
+    0xbb67ae85,
+    0x3c6ef372,
+    0xa54ff53a,
+    0x510e527f,
+    0x9b05688c,
+    0x1f83d9ab,
+    0x5be0cd19,
+};
+
+// Round constants K, from FIPS 180-4 section 4.2.2.
+alignas(16) constexpr uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#if _PW_CRYPTO_SHA256_ARM_SHA2
+
+// Processes whole blocks with the ARMv8 SHA256 instructions. Each iteration of
+// the inner loop performs four rounds and, past the first four iterations,
+// extends the message schedule by four words.
+void ProcessBlocks(uint32_t* state, const std::byte* data, size_t num_blocks) {
+  uint32x4_t abcd = vld1q_u32(&state[0]);
+  uint32x4_t efgh = vld1q_u32(&state[4]);
+
+  for (; num_blocks > 0; --num_blocks, data += kBlockSizeBytes) {
+    const uint32x4_t abcd_saved = abcd;
+    const uint32x4_t efgh_saved = efgh;
+
+    uint32x4_t schedule[4];
+    for (size_t i = 0; i < 4; ++i) {
+      schedule[i] = vreinterpretq_u32_u8(vrev32q_u8(
+          vld1q_u8(reinterpret_cast<const uint8_t*>(data) + 16 * i)));
+    }
+
+    for (size_t i = 0; i < 16; ++i) {
+      uint32x4_t& words = schedule[i % 4];
+      if (i >= 4) {
+        words = vsha256su1q_u32(vsha256su0q_u32(words, schedule[(i + 1) % 4]),
+                                schedule[(i + 2) % 4],
+                                schedule[(i + 3) % 4]);
+      }
+      const uint32x4_t words_plus_k =
+          vaddq_u32(words, vld1q_u32(&kRoundConstants[4 * i]));
+      const uint32x4_t abcd_prev = abcd;
+      abcd = vsha256hq_u32(abcd, efgh, words_plus_k);
+      efgh = vsha256h2q_u32(efgh, abcd_prev, words_plus_k);
+    }
+
+    abcd = vaddq_u32(abcd, abcd_saved);
+    efgh = vaddq_u32(efgh, efgh_saved);
+  }
+
+  vst1q_u32(&state[0], abcd);
+  vst1q_u32(&state[4], efgh);
+}
+
+#elif _PW_CRYPTO_SHA256_X86_SHA
+
+// Processes whole blocks with the x86 SHA extensions. The SHA256RNDS2
+// instruction operates on the state split into ABEF and CDGH halves, so the
+// state is rearranged on entry and exit.
+void ProcessBlocks(uint32_t* state, const std::byte* data, size_t num_blocks) {
+  const __m128i byte_swap =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+  const __m128i cdab = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);
+  const __m128i efgh = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+  __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+  __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xF0);
+
+  for (; num_blocks > 0; --num_blocks, data += kBlockSizeBytes) {
+    const __m128i abef_saved = abef;
+    const __m128i cdgh_saved = cdgh;
+
+    __m128i schedule[4];
+    for (size_t i = 0; i < 4; ++i) {
+      schedule[i] = _mm_shuffle_epi8(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(data) + i),
+          byte_swap);
+    }
+
+    for (size_t i = 0; i < 16; ++i) {
+      __m128i& words = schedule[i % 4];
+      if (i >= 4) {
+        const __m128i w7 =
+            _mm_alignr_epi8(schedule[(i + 3) % 4], schedule[(i + 2) % 4], 4);
+        words = _mm_sha256msg2_epu32(
+            _mm_add_epi32(_mm_sha256msg1_epu32(words, schedule[(i + 1) % 4]),
+                          w7),
+            schedule[(i + 3) % 4]);
+      }
+      __m128i words_plus_k = _mm_add_epi32(
+          words,
+          _mm_load_si128(
+              reinterpret_cast<const __m128i*>(&kRoundConstants[4 * i])));
+      cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words_plus_k);
+      words_plus_k = _mm_shuffle_epi32(words_plus_k, 0x0E);
+      abef = _mm_sha256rnds2_epu32(abef, cdgh, words_plus_k);
+    }
+
+    abef = _mm_add_epi32(abef, abef_saved);
+    cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+  }
+
+  const __m128i feba = _mm_shuffle_epi32(abef, 0x1B);
+  const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xB1);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state),
+                   _mm_blend_epi16(feba, dchg, 0xF0));  // DCBA
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4),
+                   _mm_alignr_epi8(dchg, feba, 8));  // HGFE
+}
+
+#else
+
+constexpr uint32_t RotateRight(uint32_t value, int bits) {
+  return (value >> bits) | (value << (32 - bits));
+}
+
+// Processes whole blocks as described in FIPS 180-4 section 6.2.2, keeping
+// only the last 16 words of the message schedule.
+void ProcessBlocks(uint32_t* state, const std::byte* data, size_t num_blocks) {
+  for (; num_blocks > 0; --num_blocks, data += kBlockSizeBytes) {
+    uint32_t w[16];
+    for (size_t i = 0; i < 16; ++i) {
+      w[i] = bytes::ReadInOrder<uint32_t>(endian::big, data + 4 * i);
+    }
+
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+    uint32_t f = state[5];
+    uint32_t g = state[6];
+    uint32_t h = state[7];
+
+    for (size_t t = 0; t < 64; ++t) {
+      if (t >= 16) {
+        const uint32_t w15 = w[(t - 15) % 16];
+        const uint32_t w2 = w[(t - 2) % 16];
+        const uint32_t s0 =
+            RotateRight(w15, 7) ^ RotateRight(w15, 18) ^ (w15 >> 3);
+        const uint32_t s1 =
+            RotateRight(w2, 17) ^ RotateRight(w2, 19) ^ (w2 >> 10);
+        w[t % 16] += s0 + w[(t - 7) % 16] + s1;
+      }
+
+      const uint32_t sum1 =
+          RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+      const uint32_t choose = (e & f) ^ (~e & g);
+      const uint32_t temp1 = h + sum1 + choose + kRoundConstants[t] + w[t % 16];
+      const uint32_t sum0 =
+          RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+      const uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+      const uint32_t temp2 = sum0 + majority;
+
+      h = g;
+      g = f;
+      f = e;
+      e = d + temp1;
+      d = c;
+      c = b;
+      b = a;
+      a = temp1 + temp2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+}
+
+#endif  // _PW_CRYPTO_SHA256_ARM_SHA2
+
+}  // namespace
+
+Status DoInit(NativeSha256Context& ctx) {
+  ctx.state = kInitialState;
+  ctx.block_size = 0;
+  ctx.message_size = 0;
+  return OkStatus();
+}
+
+Status DoUpdate(NativeSha256Context& ctx, ConstByteSpan data) {
+  if (data.empty()) {
+    return OkStatus();
+  }
+  ctx.message_size += data.size();
+
+  // Top up a partially filled block first.
+  if (ctx.block_size > 0) {
+    const size_t to_copy =
+        std::min(data.size(), kBlockSizeBytes - ctx.block_size);
+    std::memcpy(&ctx.block[ctx.block_size], data.data(), to_copy);
+    ctx.block_size += to_copy;
+    data = data.subspan(to_copy);
+    if (ctx.block_size < kBlockSizeBytes) {
+      return OkStatus();
+    }
+    ProcessBlocks(ctx.state.data(), ctx.block.data(), 1);
+    ctx.block_size = 0;
+  }
+
+  // Hash whole blocks directly from the input, so large updates are not copied.
+  const size_t num_blocks = data.size() / kBlockSizeBytes;
+  if (num_blocks > 0) {
+    ProcessBlocks(ctx.state.data(), data.data(), num_blocks);
+    data = data.subspan(num_blocks * kBlockSizeBytes);
+  }
+
+  std::memcpy(ctx.block.data(), data.data(), data.size());
+  ctx.block_size = data.size();
+  return OkStatus();
+}
+
+Status DoFinal(NativeSha256Context& ctx, ByteSpan out_digest) {
+  constexpr size_t kLengthSizeBytes = sizeof(uint64_t);
+  const uint64_t message_size_bits = ctx.message_size * 8;
+
+  // Pad with a single 1 bit, then zeros up to the length field, which may
+  // require an additional block.
+  ctx.block[ctx.block_size++] = std::byte{0x80};
+  if (ctx.block_size > kBlockSizeBytes - kLengthSizeBytes) {
+    std::fill(
+        ctx.block.begin() + ctx.block_size, ctx.block.end(), std::byte{0});
+    ProcessBlocks(ctx.state.data(), ctx.block.data(), 1);
+    ctx.block_size = 0;
+  }
+  std::fill(ctx.block.begin() + ctx.block_size,
+            ctx.block.end() - kLengthSizeBytes,
+            std::byte{0});
+  const auto length = bytes::CopyInOrder(endian::big, message_size_bits);
+  std::copy(length.begin(), length.end(), ctx.block.end() - kLengthSizeBytes);
+  ProcessBlocks(ctx.state.data(), ctx.block.data(), 1);
+
+  for (size_t i = 0; i < ctx.state.size(); ++i) {
+    const auto word = bytes::CopyInOrder(endian::big, ctx.state[i]);
+    std::copy(word.begin(), word.end(), out_digest.begin() + 4 * i);
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::crypto::sha256::backend
@@ -0,0 +1,72 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "pw_crypto/sha256.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+
+namespace pw::crypto::sha256 {
+namespace {
+
+// Hashing the same message of several sizes with each backend shows both the
+// per-call overhead and the sustained throughput of the backend.
+constexpr std::array<std::byte, 4096> kMessage = [] {
+  std::array<std::byte, 4096> message{};
+  for (size_t i = 0; i < message.size(); ++i) {
+    message[i] = static_cast<std::byte>(i);
+  }
+  return message;
+}();
+
+void HashTest(perf_test::State& state, span<const std::byte> message) {
+  std::array<std::byte, kDigestSizeBytes> digest;
+  while (state.KeepRunning()) {
+    Hash(message, digest).IgnoreError();
+  }
+}
+
+void UpdateTest(perf_test::State& state,
+                span<const std::byte> message,
+                size_t chunk_size) {
+  std::array<std::byte, kDigestSizeBytes> digest;
+  while (state.KeepRunning()) {
+    Sha256 sha256;
+    for (size_t i = 0; i < message.size(); i += chunk_size) {
+      sha256.Update(
+          message.subspan(i, std::min(chunk_size, message.size() - i)));
+    }
+    sha256.Final(digest).IgnoreError();
+  }
+}
+
+PW_PERF_TEST(Sha256Hash16Bytes, HashTest, span(kMessage).first(16));
+PW_PERF_TEST(Sha256Hash64Bytes, HashTest, span(kMessage).first(64));
+PW_PERF_TEST(Sha256Hash1024Bytes, HashTest, span(kMessage).first(1024));
+PW_PERF_TEST(Sha256Hash4096Bytes, HashTest, span(kMessage));
+
+PW_PERF_TEST(Sha256Update4096BytesIn13ByteChunks,
+             UpdateTest,
+             span(kMessage),
+             13);
+PW_PERF_TEST(Sha256Update4096BytesIn256ByteChunks,
+             UpdateTest,
+             span(kMessage),
+             256);
+
+}  // namespace
+}  // namespace pw::crypto::sha256
@@ -38,6 +38,17 @@ namespace {
   "\xe3\xb0\xc4\x42\x98\xfc\x1c\x14\x9a\xfb\xf4\xc8\x99\x6f\xb9\x24" \
   "\x27\xae\x41\xe4\x64\x9b\x93\x4c\xa4\x95\x99\x1b\x78\x52\xb8\x55"
 
+// A 56-byte message whose padding spills into a second block, from the
+// FIPS 180-4 examples.
+#define TWO_BLOCK_MESSAGE \
+  "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"
+
+// Generated in Python with
+// `hashlib.sha256(TWO_BLOCK_MESSAGE.encode('ascii')).hexdigest()`.
+#define SHA256_HASH_OF_TWO_BLOCK_MESSAGE                             \
+  "\x24\x8d\x6a\x61\xd2\x06\x38\xb8\xe5\xc0\x26\x93\x0c\x3e\x60\x39" \
+  "\xa3\x3c\xe4\x59\x64\xff\x21\x67\xf6\xec\xed\xd4\x19\xdb\x06\xc1"
+
 TEST(Hash, ComputesCorrectDigest) {
   std::byte digest[kDigestSizeBytes];
 
@@ -56,6 +67,14 @@ TEST(Hash, ComputesCorrectDigestFromReader) {
             std::memcmp(digest, SHA256_HASH_OF_HELLO_PIGWEED, sizeof(digest)));
 }
 
+TEST(Hash, ComputesCorrectDigestOfMultipleBlocks) {
+  std::byte digest[kDigestSizeBytes];
+
+  ASSERT_OK(Hash(AS_BYTES(TWO_BLOCK_MESSAGE), digest));
+  ASSERT_EQ(
+      0, std::memcmp(digest, SHA256_HASH_OF_TWO_BLOCK_MESSAGE, sizeof(digest)));
+}
+
 TEST(Hash, ComputesCorrectDigestOnEmptyMessage) {
   std::byte digest[kDigestSizeBytes];
 
@@ -124,6 +143,27 @@ TEST(Sha256, AllowsMultipleUpdates) {
             std::memcmp(digest, SHA256_HASH_OF_HELLO_PIGWEED, sizeof(digest)));
 }
 
+TEST(Sha256, AllowsUpdatesAcrossBlockBoundaries) {
+  constexpr char kMessage[] = TWO_BLOCK_MESSAGE TWO_BLOCK_MESSAGE;
+  // Generated in Python with
+  // `hashlib.sha256(2 * TWO_BLOCK_MESSAGE.encode('ascii')).hexdigest()`.
+  constexpr char kExpected[] =
+      "\x59\xf1\x09\xd9\x53\x3b\x2b\x70\xe7\xc3\xb8\x14\xa2\xbd\x21\x8f"
+      "\x78\xea\x5d\x37\x14\x45\x5b\xc6\x79\x87\xcf\x0d\x66\x43\x99\xcf";
+
+  // Split the message at every offset so that each update leaves a different
+  // amount of data buffered.
+  const ConstByteSpan message = AS_BYTES(kMessage);
+  for (size_t split = 0; split <= message.size(); ++split) {
+    std::byte digest[kDigestSizeBytes];
+    ASSERT_OK(Sha256()
+                  .Update(message.first(split))
+                  .Update(message.subspan(split))
+                  .Final(digest));
+    ASSERT_EQ(0, std::memcmp(digest, kExpected, sizeof(digest)));
+  }
+}
+
 TEST(Sha256, NoFinalAfterFinal) {
   std::byte digest[kDigestSizeBytes];
   auto h = Sha256();
@@ -19,8 +19,12 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <linux/gpio.h>
+#include <poll.h>
 
+#include <algorithm>
+#include <array>
 #include <memory>
+#include <optional>
 
 #include "log_errno.h"
 #include "pw_digital_io/digital_io.h"
@@ -36,6 +40,12 @@ namespace {
 
 using internal::OwnedFd;
 
+static_assert(kLinuxMaxGroupLines == GPIOHANDLES_MAX);
+
+// The kernel buffers up to 16 events per line event handle, so reading more
+// at once never returns more.
+constexpr size_t kMaxEventsPerRead = 16;
+
 Result<State> FdGetState(OwnedFd& fd) {
   struct gpiohandle_data req = {};
 
@@ -47,6 +57,71 @@ Result<State> FdGetState(OwnedFd& fd) {
   return req.values[0] ? State::kActive : State::kInactive;
 }
 
+Status FdGetStates(OwnedFd& fd, span<State> states) {
+  struct gpiohandle_data req = {};
+
+  if (fd.ioctl(GPIOHANDLE_GET_LINE_VALUES_IOCTL, &req) < 0) {
+    LOG_ERROR_WITH_ERRNO("GPIOHANDLE_GET_LINE_VALUES_IOCTL failed:", errno);
+    return Status::Internal();
+  }
+
+  for (size_t i = 0; i < states.size(); ++i) {
+    states[i] = req.values[i] ? State::kActive : State::kInactive;
+  }
+  return OkStatus();
+}
+
+uint32_t GetEventFlags(Polarity polarity, InterruptTrigger trigger) {
+  switch (trigger) {
+    case InterruptTrigger::kActivatingEdge:
+      return (polarity == Polarity::kActiveHigh)
+                 ? GPIOEVENT_REQUEST_RISING_EDGE
+                 : GPIOEVENT_REQUEST_FALLING_EDGE;
+    case InterruptTrigger::kDeactivatingEdge:
+      return (polarity == Polarity::kActiveHigh)
+                 ? GPIOEVENT_REQUEST_FALLING_EDGE
+                 : GPIOEVENT_REQUEST_RISING_EDGE;
+    case InterruptTrigger::kBothEdges:
+      return GPIOEVENT_REQUEST_BOTH_EDGES;
+  }
+  return 0;
+}
+
+// Returns the state of the line after the event.
+std::optional<State> GetEventState(const struct gpioevent_data& event) {
+  PW_LOG_DEBUG("Got GPIO event: timestamp=%llu, id=%s",
+               static_cast<unsigned long long>(event.timestamp),
+               event.id == GPIOEVENT_EVENT_RISING_EDGE    ? "RISING_EDGE"
+               : event.id == GPIOEVENT_EVENT_FALLING_EDGE ? "FALLING_EDGE"
+                                                          : "<unknown>");
+
+  // Note that polarity (ACTIVE_LOW) is already accounted for
+  // by the kernel; see gpiod_get_value_cansleep().
+  switch (event.id) {
+    case GPIOEVENT_EVENT_RISING_EDGE:
+      // "RISING_EDGE" always means inactive -> active.
+      return State::kActive;
+    case GPIOEVENT_EVENT_FALLING_EDGE:
+      // "FALLING_EDGE" always means active -> inactive.
+      return State::kInactive;
+    default:
+      PW_LOG_ERROR("Unexpected event.id = %u", event.id);
+      return std::nullopt;
+  }
+}
+
+// Reads up to `events.size()` events with one read. The kernel only returns
+// whole events.
+Result<size_t> FdReadEvents(OwnedFd& fd, span<struct gpioevent_data> events) {
+  errno = 0;
+  ssize_t nread = fd.read(events.data(), events.size_bytes());
+  if (nread < static_cast<ssize_t>(sizeof(struct gpioevent_data))) {
+    LOG_ERROR_WITH_ERRNO("Failed to read from line event handle:", errno);
+    return Status::Internal();
+  }
+  return static_cast<size_t>(nread) / sizeof(struct gpioevent_data);
+}
+
 }  // namespace
 
 // TODO(jrreinhart): Support other flags, e.g.:
@@ -82,6 +157,14 @@ uint32_t LinuxOutputConfig::GetFlags() const {
   return flags;
 }
 
+uint32_t LinuxInputGroupConfig::GetFlags() const {
+  return LinuxInputConfig(0, polarity).GetFlags();
+}
+
+uint32_t LinuxOutputGroupConfig::GetFlags() const {
+  return LinuxOutputConfig(0, polarity, default_state).GetFlags();
+}
+
 //
 // LinuxDigitalIoChip
 //
@@ -99,14 +182,26 @@ Result<LinuxDigitalIoChip> LinuxDigitalIoChip::Open(const char* path) {
 Result<OwnedFd> LinuxDigitalIoChip::Impl::GetLineHandle(uint32_t offset,
                                                         uint32_t flags,
                                                         uint8_t default_value) {
+  return GetLinesHandle(span(&offset, 1), flags, default_value);
+}
+
+Result<OwnedFd> LinuxDigitalIoChip::Impl::GetLinesHandle(
+    span<const uint32_t> offsets, uint32_t flags, uint8_t default_value) {
+  if (offsets.empty() || offsets.size() > GPIOHANDLES_MAX) {
+    return Status::InvalidArgument();
+  }
   struct gpiohandle_request req = {
-      .lineoffsets = {offset},
+      .lineoffsets = {},
       .flags = flags,
-      .default_values = {default_value},
+      .default_values = {},
       .consumer_label = "pw_digital_io_linux",
-      .lines = 1,
+      .lines = static_cast<uint32_t>(offsets.size()),
       .fd = -1,
   };
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    req.lineoffsets[i] = offsets[i];
+    req.default_values[i] = default_value;
+  }
   if (fd_.ioctl(GPIO_GET_LINEHANDLE_IOCTL, &req) < 0) {
     LOG_ERROR_WITH_ERRNO("GPIO_GET_LINEHANDLE_IOCTL failed:", errno);
     return Status::Internal();
@@ -161,6 +256,36 @@ Result<LinuxDigitalOut> LinuxDigitalIoChip::GetOutputLine(
   return LinuxDigitalOut(impl_, config);
 }
 
+Result<LinuxDigitalInGroup> LinuxDigitalIoChip::GetInputLines(
+    const LinuxInputGroupConfig& config) {
+  if (!impl_) {
+    return Status::FailedPrecondition();
+  }
+  if (config.indices.empty() || config.indices.size() > kLinuxMaxGroupLines) {
+    return Status::InvalidArgument();
+  }
+  return LinuxDigitalInGroup(impl_, config);
+}
+
+Result<LinuxDigitalOutGroup> LinuxDigitalIoChip::GetOutputLines(
+    const LinuxOutputGroupConfig& config) {
+  if (!impl_) {
+    return Status::FailedPrecondition();
+  }
+  if (config.indices.empty() || config.indices.size() > kLinuxMaxGroupLines) {
+    return Status::InvalidArgument();
+  }
+  return LinuxDigitalOutGroup(impl_, config);
+}
+
+Result<LinuxDigitalInEvents> LinuxDigitalIoChip::GetEventLine(
+    const LinuxInputConfig& config, InterruptTrigger trigger) {
+  if (!impl_) {
+    return Status::FailedPrecondition();
+  }
+  return LinuxDigitalInEvents(impl_, config, trigger);
+}
+
 //
 // LinuxDigitalInInterrupt
 //
@@ -176,18 +301,7 @@ uint32_t LinuxDigitalInInterrupt::Impl::GetEventFlags() const {
   if (handler_ == nullptr) {
     return 0;
   }
-  switch (trigger_) {
-    case InterruptTrigger::kActivatingEdge:
-      return (config_.polarity == Polarity::kActiveHigh)
-                 ? GPIOEVENT_REQUEST_RISING_EDGE
-                 : GPIOEVENT_REQUEST_FALLING_EDGE;
-    case InterruptTrigger::kDeactivatingEdge:
-      return (config_.polarity == Polarity::kActiveHigh)
-                 ? GPIOEVENT_REQUEST_FALLING_EDGE
-                 : GPIOEVENT_REQUEST_RISING_EDGE;
-    case InterruptTrigger::kBothEdges:
-      return GPIOEVENT_REQUEST_BOTH_EDGES;
-  }
+  return digital_io::GetEventFlags(config_.polarity, trigger_);
 }
 
 Status LinuxDigitalInInterrupt::Impl::SubscribeEvents() {
@@ -307,7 +421,8 @@ Status LinuxDigitalInInterrupt::Impl::DoSetInterruptHandler(
 void LinuxDigitalInInterrupt::Impl::HandleEvents() {
   InterruptHandler saved_handler{};
   uint32_t current_handler_generation{};
-  State state{};
+  std::array<State, kMaxEventsPerRead> states;
+  size_t state_count = 0;
 
   {
     std::lock_guard lock(mutex_);
@@ -318,35 +433,19 @@ void LinuxDigitalInInterrupt::Impl::HandleEvents() {
       return;
     }
 
-    // Consume the event from the event handle.
-    errno = 0;
-    struct gpioevent_data event;
-    ssize_t nread = fd_.read(&event, sizeof(event));
-    if (nread < static_cast<ssize_t>(sizeof(event))) {
-      LOG_ERROR_WITH_ERRNO("Failed to read from line event handle:", errno);
+    // Consume all pending events from the event handle with one read.
+    std::array<struct gpioevent_data, kMaxEventsPerRead> events;
+    Result<size_t> count = FdReadEvents(fd_, events);
+    if (!count.ok()) {
       return;
     }
-
-    PW_LOG_DEBUG("Got GPIO event: timestamp=%llu, id=%s",
-                 static_cast<unsigned long long>(event.timestamp),
-                 event.id == GPIOEVENT_EVENT_RISING_EDGE    ? "RISING_EDGE"
-                 : event.id == GPIOEVENT_EVENT_FALLING_EDGE ? "FALLING_EDGE"
-                                                            : "<unknown>");
-
-    // Note that polarity (ACTIVE_LOW) is already accounted for
-    // by the kernel; see gpiod_get_value_cansleep().
-    switch (event.id) {
-      case GPIOEVENT_EVENT_RISING_EDGE:
-        // "RISING_EDGE" always means inactive -> active.
-        state = State::kActive;
-        break;
-      case GPIOEVENT_EVENT_FALLING_EDGE:
-        // "FALLING_EDGE" always means active -> inactive.
-        state = State::kInactive;
-        break;
-      default:
-        PW_LOG_ERROR("Unexpected event.id = %u", event.id);
-        return;
+    for (size_t i = 0; i < *count; ++i) {
+      if (std::optional<State> state = GetEventState(events[i])) {
+        states[state_count++] = *state;
+      }
+    }
+    if (state_count == 0) {
+      return;
     }
 
     // Borrow the handler while we handle the interrupt, so we can invoked it
@@ -357,7 +456,9 @@ void LinuxDigitalInInterrupt::Impl::HandleEvents() {
 
   // Invoke the handler without holding the mutex.
   if (saved_handler) {
-    saved_handler(state);
+    for (size_t i = 0; i < state_count; ++i) {
+      saved_handler(states[i]);
+    }
   }
 
   // Restore the saved handler.
@@ -432,4 +533,143 @@ Status LinuxDigitalOut::DoSetState(State level) {
   return OkStatus();
 }
 
+//
+// LinuxDigitalInGroup
+//
+
+Status LinuxDigitalInGroup::Enable() {
+  if (fd_.valid()) {
+    return OkStatus();
+  }
+  PW_TRY_ASSIGN(fd_,
+                chip_->GetLinesHandle(config_.indices, config_.GetFlags()));
+  return OkStatus();
+}
+
+Status LinuxDigitalInGroup::Disable() {
+  // Close the open file handle and release the line request.
+  fd_.Close();
+  return OkStatus();
+}
+
+Status LinuxDigitalInGroup::GetStates(span<State> states) {
+  if (!fd_.valid()) {
+    return Status::FailedPrecondition();
+  }
+  if (states.size() != size()) {
+    return Status::InvalidArgument();
+  }
+  return FdGetStates(fd_, states);
+}
+
+//
+// LinuxDigitalOutGroup
+//
+
+Status LinuxDigitalOutGroup::Enable() {
+  if (fd_.valid()) {
+    return OkStatus();
+  }
+  uint8_t default_value = config_.default_state == State::kActive;
+  PW_TRY_ASSIGN(fd_,
+                chip_->GetLinesHandle(
+                    config_.indices, config_.GetFlags(), default_value));
+  return OkStatus();
+}
+
+Status LinuxDigitalOutGroup::Disable() {
+  // Close the open file handle and release the line request.
+  fd_.Close();
+  return OkStatus();
+}
+
+Status LinuxDigitalOutGroup::GetStates(span<State> states) {
+  if (!fd_.valid()) {
+    return Status::FailedPrecondition();
+  }
+  if (states.size() != size()) {
+    return Status::InvalidArgument();
+  }
+  return FdGetStates(fd_, states);
+}
+
+Status LinuxDigitalOutGroup::SetStates(span<const State> states) {
+  if (!fd_.valid()) {
+    return Status::FailedPrecondition();
+  }
+  if (states.size() != size()) {
+    return Status::InvalidArgument();
+  }
+
+  struct gpiohandle_data req = {};
+  for (size_t i = 0; i < states.size(); ++i) {
+    req.values[i] = (states[i] == State::kActive) ? uint8_t(1) : uint8_t(0);
+  }
+
+  if (fd_.ioctl(GPIOHANDLE_SET_LINE_VALUES_IOCTL, &req) < 0) {
+    LOG_ERROR_WITH_ERRNO("GPIOHANDLE_SET_LINE_VALUES_IOCTL failed:", errno);
+    return Status::Internal();
+  }
+
+  return OkStatus();
+}
+
+//
+// LinuxDigitalInEvents
+//
+
+Status LinuxDigitalInEvents::Enable() {
+  if (fd_.valid()) {
+    return OkStatus();
+  }
+  PW_TRY_ASSIGN(fd_,
+                chip_->GetLineEventHandle(
+                    config_.index,
+                    config_.GetFlags(),
+                    GetEventFlags(config_.polarity, trigger_)));
+  return OkStatus();
+}
+
+Status LinuxDigitalInEvents::Disable() {
+  // Close the open file handle and release the line request.
+  fd_.Close();
+  return OkStatus();
+}
+
+Result<size_t> LinuxDigitalInEvents::ReadEvents(span<LinuxGpioEvent> events) {
+  if (!fd_.valid()) {
+    return Status::FailedPrecondition();
+  }
+  if (events.empty()) {
+    return size_t{0};
+  }
+
+  // Line event handles always block, so check for pending events first.
+  struct pollfd pfd = {.fd = fd_.fd(), .events = POLLIN, .revents = 0};
+  int ready = poll(&pfd, 1, 0);
+  if (ready < 0) {
+    LOG_ERROR_WITH_ERRNO("Failed to poll line event handle:", errno);
+    return Status::Internal();
+  }
+  if (ready == 0) {
+    return size_t{0};
+  }
+
+  std::array<struct gpioevent_data, kMaxEventsPerRead> raw_events;
+  PW_TRY_ASSIGN(
+      size_t count,
+      FdReadEvents(fd_,
+                   span(raw_events).first(
+                       std::min(events.size(), raw_events.size()))));
+
+  size_t read = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (std::optional<State> state = GetEventState(raw_events[i])) {
+      events[read++] = {.state = *state,
+                        .timestamp_ns = raw_events[i].timestamp};
+    }
+  }
+  return read;
+}
+
 }  // namespace pw::digital_io
@@ -16,6 +16,7 @@
 #include <linux/gpio.h>
 
 #include <algorithm>
+#include <array>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -153,18 +154,23 @@ class Line {
 // GPIO_GET_LINEHANDLE_IOCTL to an open chip file.
 class LineHandleFile : public MockFile {
  public:
-  LineHandleFile(MockVfs& vfs, int eventfd, const std::string& name, Line& line)
-      : MockFile(vfs, eventfd, name), line_(line) {}
+  LineHandleFile(MockVfs& vfs,
+                 int eventfd,
+                 const std::string& name,
+                 std::vector<Line*> lines)
+      : MockFile(vfs, eventfd, name), lines_(std::move(lines)) {}
 
  private:
-  Line& line_;
+  std::vector<Line*> lines_;
 
   //
   // MockFile impl.
   //
 
   int DoClose() override {
-    line_.ClearRequest();
+    for (Line* line : lines_) {
+      line->ClearRequest();
+    }
     return 0;
   }
 
@@ -182,22 +188,24 @@ class LineHandleFile : public MockFile {
 
   // Handle GPIOHANDLE_GET_LINE_VALUES_IOCTL
   int DoIoctlGetValues(struct gpiohandle_data* data) {
-    auto result = line_.GetValue();
-    if (!result.ok()) {
-      return -1;
+    for (size_t i = 0; i < lines_.size(); ++i) {
+      auto result = lines_[i]->GetValue();
+      if (!result.ok()) {
+        return -1;
+      }
+      data->values[i] = *result;
     }
-
-    data->values[0] = *result;
     return 0;
   }
 
   // Handle GPIOHANDLE_SET_LINE_VALUES_IOCTL
   int DoIoctlSetValues(struct gpiohandle_data* data) {
-    auto status = line_.SetValue(data->values[0]);
-    if (!status.ok()) {
-      return -1;
+    for (size_t i = 0; i < lines_.size(); ++i) {
+      auto status = lines_[i]->SetValue(data->values[i]);
+      if (!status.ok()) {
+        return -1;
+      }
     }
-
     return 0;
   }
 };
@@ -272,21 +280,22 @@ class LineEventFile final : public MockFile {
   }
 
   ssize_t DoRead(void* buf, size_t count) override {
-    // Consume the readable state of the eventfd (one token).
-    PW_CHECK_INT_EQ(ReadEventfd(), 1);  // EFD_SEMAPHORE
-
     std::lock_guard lock(mutex_);
 
-    // Pop the event from the queue.
+    // Like the kernel, return as many whole events as fit.
     PW_CHECK(!event_queue_.empty());
-    struct gpioevent_data event = event_queue_.front();
-    if (count < sizeof(event)) {
+    if (count < sizeof(struct gpioevent_data)) {
       return -1;
     }
-    event_queue_.pop();
-
-    memcpy(buf, &event, sizeof(event));
-    return sizeof(event);
+    auto* out = static_cast<struct gpioevent_data*>(buf);
+    size_t nevents = 0;
+    while (!event_queue_.empty() && (nevents + 1) * sizeof(*out) <= count) {
+      // Consume the readable state of the eventfd (one token per event).
+      PW_CHECK_INT_EQ(ReadEventfd(), 1);  // EFD_SEMAPHORE
+      out[nevents++] = event_queue_.front();
+      event_queue_.pop();
+    }
+    return static_cast<ssize_t>(nevents * sizeof(*out));
   }
 };
 
@@ -329,35 +338,45 @@ class ChipFile : public MockFile {
       return -1;
     }
 
-    // Only support requesting one line at at time.
-    if (req->lines != 1) {
+    if (req->lines == 0 || req->lines > GPIOHANDLES_MAX) {
       PW_LOG_ERROR("%s: Unsupported req->lines=%u", __FUNCTION__, req->lines);
       return -1;
     }
 
-    uint32_t const offset = req->lineoffsets[0];
-    uint8_t const default_value = req->default_values[0];
     bool const active_low = req->flags & GPIOHANDLE_REQUEST_ACTIVE_LOW;
 
-    if (offset >= lines_.size()) {
-      PW_LOG_ERROR("%s: Invalid line offset: %u", __FUNCTION__, offset);
-      return -1;
+    std::vector<Line*> lines;
+    for (uint32_t i = 0; i < req->lines; ++i) {
+      uint32_t const offset = req->lineoffsets[i];
+      if (offset >= lines_.size()) {
+        PW_LOG_ERROR("%s: Invalid line offset: %u", __FUNCTION__, offset);
+        return -1;
+      }
+      lines.push_back(&lines_[offset]);
     }
-    Line& line = lines_[offset];
 
-    auto file = vfs().MakeFile<LineHandleFile>("line-handle", line);
-    // Ownership: The vfs owns this file, but the line borrows a reference to
+    auto file = vfs().MakeFile<LineHandleFile>("line-handle", lines);
+    // Ownership: The vfs owns this file, but the lines borrow a reference to
     // it. This is safe because the file's Close() method undoes that borrow.
 
     Status status = OkStatus();
-    switch (direction) {
-      case GPIOHANDLE_REQUEST_OUTPUT:
-        status.Update(line.RequestOutput(file.get(), active_low));
-        status.Update(line.SetValue(default_value));
-        break;
-      case GPIOHANDLE_REQUEST_INPUT:
-        status.Update(line.RequestInput(file.get(), active_low));
-        break;
+    for (uint32_t i = 0; i < req->lines && status.ok(); ++i) {
+      Line& line = *lines[i];
+      switch (direction) {
+        case GPIOHANDLE_REQUEST_OUTPUT:
+          status.Update(line.RequestOutput(file.get(), active_low));
+          status.Update(line.SetValue(req->default_values[i]));
+          break;
+        case GPIOHANDLE_REQUEST_INPUT:
+          status.Update(line.RequestInput(file.get(), active_low));
+          break;
+      }
+      if (!status.ok()) {
+        // Release the lines requested so far.
+        for (uint32_t j = 0; j < i; ++j) {
+          lines[j]->ClearRequest();
+        }
+      }
     }
     if (!status.ok()) {
       return -1;
@@ -413,11 +432,15 @@ class DigitalIoTest : public ::testing::Test {
 
   Line& line0() { return lines_[0]; }
   Line& line1() { return lines_[1]; }
+  Line& line2() { return lines_[2]; }
+  Line& line3() { return lines_[3]; }
 
  private:
   std::vector<Line> lines_ = std::vector<Line>{
       Line(0),  // Input
       Line(1),  // Output
+      Line(2),  // Group
+      Line(3),  // Group
   };
 };
 
@@ -784,5 +807,195 @@ TEST_F(DigitalIoTest, DoInputInterruptsThread) {
   }
 }
 
+//
+// Line groups
+//
+
+TEST_F(DigitalIoTest, InputGroupReadsAllLines) {
+  LinuxDigitalIoChip chip = OpenChip();
+
+  constexpr uint32_t kIndices[] = {2, 0, 3};
+  LinuxInputGroupConfig config(kIndices, Polarity::kActiveHigh);
+  ASSERT_OK_AND_ASSIGN(auto inputs, chip.GetInputLines(config));
+  EXPECT_EQ(inputs.size(), 3u);
+
+  ASSERT_OK(inputs.Enable());
+  EXPECT_LINE_REQUESTED_INPUT(line0());
+  EXPECT_LINE_REQUESTED_INPUT(line2());
+  EXPECT_LINE_REQUESTED_INPUT(line3());
+  EXPECT_LINE_NOT_REQUESTED(line1());
+
+  line0().ForcePhysicalState(true);
+  line2().ForcePhysicalState(false);
+  line3().ForcePhysicalState(true);
+
+  std::array<State, 3> states;
+  ASSERT_OK(inputs.GetStates(states));
+  EXPECT_EQ(states[0], State::kInactive);
+  EXPECT_EQ(states[1], State::kActive);
+  EXPECT_EQ(states[2], State::kActive);
+
+  // The span must match the group size.
+  std::array<State, 2> too_few;
+  EXPECT_EQ(inputs.GetStates(too_few), Status::InvalidArgument());
+
+  ASSERT_OK(inputs.Disable());
+  EXPECT_LINE_NOT_REQUESTED(line0());
+  EXPECT_LINE_NOT_REQUESTED(line2());
+  EXPECT_LINE_NOT_REQUESTED(line3());
+  EXPECT_EQ(inputs.GetStates(states), Status::FailedPrecondition());
+}
+
+TEST_F(DigitalIoTest, OutputGroupSetsAllLines) {
+  LinuxDigitalIoChip chip = OpenChip();
+
+  constexpr uint32_t kIndices[] = {1, 2, 3};
+  LinuxOutputGroupConfig config(
+      kIndices, Polarity::kActiveLow, State::kInactive);
+  ASSERT_OK_AND_ASSIGN(auto outputs, chip.GetOutputLines(config));
+
+  ASSERT_OK(outputs.Enable());
+  EXPECT_LINE_REQUESTED_OUTPUT(line1());
+  EXPECT_LINE_REQUESTED_OUTPUT(line2());
+  EXPECT_LINE_REQUESTED_OUTPUT(line3());
+
+  // Inactive and active low: all lines start high.
+  EXPECT_TRUE(line1().physical_state());
+  EXPECT_TRUE(line2().physical_state());
+  EXPECT_TRUE(line3().physical_state());
+
+  constexpr std::array<State, 3> kStates = {
+      State::kActive, State::kInactive, State::kActive};
+  ASSERT_OK(outputs.SetStates(kStates));
+  EXPECT_FALSE(line1().physical_state());
+  EXPECT_TRUE(line2().physical_state());
+  EXPECT_FALSE(line3().physical_state());
+
+  std::array<State, 3> states;
+  ASSERT_OK(outputs.GetStates(states));
+  EXPECT_EQ(states, kStates);
+
+  ASSERT_OK(outputs.Disable());
+  EXPECT_LINE_NOT_REQUESTED(line1());
+  EXPECT_LINE_NOT_REQUESTED(line2());
+  EXPECT_LINE_NOT_REQUESTED(line3());
+}
+
+TEST_F(DigitalIoTest, GroupRequestFailsIfAnyLineIsBusy) {
+  LinuxDigitalIoChip chip = OpenChip();
+
+  LinuxInputConfig single_config(/* index= */ 2, Polarity::kActiveHigh);
+  ASSERT_OK_AND_ASSIGN(auto single, chip.GetInputLine(single_config));
+  ASSERT_OK(single.Enable());
+
+  constexpr uint32_t kIndices[] = {0, 2};
+  LinuxInputGroupConfig config(kIndices, Polarity::kActiveHigh);
+  ASSERT_OK_AND_ASSIGN(auto inputs, chip.GetInputLines(config));
+  EXPECT_EQ(inputs.Enable(), Status::Internal());
+  EXPECT_LINE_NOT_REQUESTED(line0());
+  EXPECT_LINE_REQUESTED_INPUT(line2());
+}
+
+TEST_F(DigitalIoTest, GroupSizeIsChecked) {
+  LinuxDigitalIoChip chip = OpenChip();
+
+  EXPECT_EQ(chip.GetInputLines(LinuxInputGroupConfig({}, Polarity::kActiveHigh))
+                .status(),
+            Status::InvalidArgument());
+
+  std::array<uint32_t, kLinuxMaxGroupLines + 1> too_many{};
+  EXPECT_EQ(
+      chip.GetOutputLines(LinuxOutputGroupConfig(
+                              too_many, Polarity::kActiveHigh, State::kActive))
+          .status(),
+      Status::InvalidArgument());
+}
+
+//
+// Batched edge events
+//
+
+TEST_F(DigitalIoTest, EventLineReadsEventsInBatches) {
+  LinuxDigitalIoChip chip = OpenChip();
+
+  auto& line = line0();
+  LinuxInputConfig config(
+      /* index= */ 0,
+      /* polarity= */ Polarity::kActiveHigh);
+  ASSERT_OK_AND_ASSIGN(auto input,
+                       chip.GetEventLine(config, InterruptTrigger::kBothEdges));
+
+  std::array<LinuxGpioEvent, 4> events;
+  EXPECT_EQ(input.ReadEvents(events).status(), Status::FailedPrecondition());
+
+  ASSERT_OK(input.Enable());
+  EXPECT_LINE_REQUESTED_INPUT_INTERRUPT(line);
+  LineEventFile* evt = line.current_event_handle();
+  ASSERT_NE(evt, nullptr);
+
+  // Nothing pending; does not block.
+  ASSERT_OK_AND_ASSIGN(size_t count, input.ReadEvents(events));
+  EXPECT_EQ(count, 0u);
+
+  for (uint64_t i = 0; i < 6; i++) {
+    evt->EnqueueEvent({
+        .timestamp = 1000 + i,
+        .id = (i % 2) ? GPIOEVENT_EVENT_FALLING_EDGE
+                      : GPIOEVENT_EVENT_RISING_EDGE,
+    });
+  }
+
+  ASSERT_OK_AND_ASSIGN(count, input.ReadEvents(events));
+  ASSERT_EQ(count, 4u);
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_EQ(events[i].timestamp_ns, 1000 + i);
+    EXPECT_EQ(events[i].state, (i % 2) ? State::kInactive : State::kActive);
+  }
+
+  ASSERT_OK_AND_ASSIGN(count, input.ReadEvents(events));
+  ASSERT_EQ(count, 2u);
+  EXPECT_EQ(events[0].timestamp_ns, 1004u);
+  EXPECT_EQ(events[1].timestamp_ns, 1005u);
+
+  ASSERT_OK(input.Disable());
+  EXPECT_LINE_NOT_REQUESTED(line);
+}
+
+TEST_F(DigitalIoTest, DoInputInterruptsReadsPendingEventsTogether) {
+  LinuxDigitalIoChip chip = OpenChip();
+  ASSERT_OK_AND_ASSIGN(auto notifier, LinuxGpioNotifier::Create());
+
+  auto& line = line0();
+  LinuxInputConfig config(
+      /* index= */ 0,
+      /* polarity= */ Polarity::kActiveHigh);
+
+  ASSERT_OK_AND_ASSIGN(auto input, chip.GetInterruptLine(config, notifier));
+
+  std::vector<State> interrupts;
+  ASSERT_OK(input.SetInterruptHandler(
+      InterruptTrigger::kBothEdges,
+      [&interrupts](State state) { interrupts.push_back(state); }));
+  ASSERT_OK(input.EnableInterruptHandler());
+  ASSERT_OK(input.Enable());
+
+  LineEventFile* evt = line.current_event_handle();
+  ASSERT_NE(evt, nullptr);
+  evt->EnqueueEvent({.timestamp = 1, .id = GPIOEVENT_EVENT_RISING_EDGE});
+  evt->EnqueueEvent({.timestamp = 2, .id = GPIOEVENT_EVENT_FALLING_EDGE});
+  evt->EnqueueEvent({.timestamp = 3, .id = GPIOEVENT_EVENT_RISING_EDGE});
+
+  // One wakeup delivers all three events.
+  constexpr int timeout = 0;  // Don't block
+  ASSERT_OK_AND_ASSIGN(unsigned int count, notifier->WaitForEvents(timeout));
+  EXPECT_EQ(count, 1u);
+  EXPECT_EQ(interrupts,
+            std::vector<State>({
+                State::kActive,
+                State::kInactive,
+                State::kActive,
+            }));
+}
+
 }  // namespace
 }  // namespace pw::digital_io
@@ -14,14 +14,17 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "pw_digital_io/digital_io.h"
 #include "pw_digital_io/polarity.h"
 #include "pw_digital_io_linux/internal/owned_fd.h"
 #include "pw_digital_io_linux/notifier.h"
 #include "pw_result/result.h"
+#include "pw_span/span.h"
 #include "pw_sync/lock_annotations.h"
 #include "pw_sync/mutex.h"
 
@@ -50,15 +53,59 @@ struct LinuxOutputConfig final : LinuxConfig {
   uint32_t GetFlags() const;
 };
 
+/// The maximum number of lines in a line group (GPIOHANDLES_MAX).
+inline constexpr size_t kLinuxMaxGroupLines = 64;
+
+/// Configuration for a group of input lines that are read together. All lines
+/// share the same polarity.
+struct LinuxInputGroupConfig {
+  std::vector<uint32_t> indices;
+  Polarity polarity;
+
+  LinuxInputGroupConfig(span<const uint32_t> indices, Polarity polarity)
+      : indices(indices.begin(), indices.end()), polarity(polarity) {}
+  uint32_t GetFlags() const;
+};
+
+/// Configuration for a group of output lines that are set together. All lines
+/// share the same polarity and default state.
+struct LinuxOutputGroupConfig {
+  std::vector<uint32_t> indices;
+  Polarity polarity;
+  State default_state;
+
+  LinuxOutputGroupConfig(span<const uint32_t> indices,
+                         Polarity polarity,
+                         State default_state)
+      : indices(indices.begin(), indices.end()),
+        polarity(polarity),
+        default_state(default_state) {}
+  uint32_t GetFlags() const;
+};
+
+/// An edge event read from a `LinuxDigitalInEvents` line.
+struct LinuxGpioEvent {
+  /// The state of the line after the edge, accounting for polarity.
+  State state;
+  /// The kernel's timestamp of the edge, in nanoseconds.
+  uint64_t timestamp_ns;
+};
+
 class LinuxDigitalInInterrupt;
 class LinuxDigitalIn;
 class LinuxDigitalOut;
+class LinuxDigitalInGroup;
+class LinuxDigitalOutGroup;
+class LinuxDigitalInEvents;
 
 /// Represents an open handle to a Linux GPIO chip (e.g. /dev/gpiochip0).
 class LinuxDigitalIoChip final {
   friend class LinuxDigitalInInterrupt;
   friend class LinuxDigitalIn;
   friend class LinuxDigitalOut;
+  friend class LinuxDigitalInGroup;
+  friend class LinuxDigitalOutGroup;
+  friend class LinuxDigitalInEvents;
   using OwnedFd = internal::OwnedFd;
 
  private:
@@ -71,6 +118,12 @@ class LinuxDigitalIoChip final {
                                   uint32_t flags,
                                   uint8_t default_value = 0);
 
+    // Requests all lines with one handle, so their values can be read or set
+    // with a single ioctl.
+    Result<OwnedFd> GetLinesHandle(span<const uint32_t> offsets,
+                                   uint32_t flags,
+                                   uint8_t default_value = 0);
+
     Result<OwnedFd> GetLineEventHandle(uint32_t offset,
                                        uint32_t handle_flags,
                                        uint32_t event_flags);
@@ -95,6 +148,23 @@ class LinuxDigitalIoChip final {
   Result<LinuxDigitalIn> GetInputLine(const LinuxInputConfig& config);
 
   Result<LinuxDigitalOut> GetOutputLine(const LinuxOutputConfig& config);
+
+  /// Returns a group of input lines whose states are read with one ioctl.
+  /// Fails with INVALID_ARGUMENT if the group is empty or has more than
+  /// `kLinuxMaxGroupLines` lines.
+  Result<LinuxDigitalInGroup> GetInputLines(
+      const LinuxInputGroupConfig& config);
+
+  /// Returns a group of output lines whose states are set with one ioctl.
+  /// Fails with INVALID_ARGUMENT if the group is empty or has more than
+  /// `kLinuxMaxGroupLines` lines.
+  Result<LinuxDigitalOutGroup> GetOutputLines(
+      const LinuxOutputGroupConfig& config);
+
+  /// Returns an input line whose edge events are read in batches by the
+  /// caller, rather than delivered one at a time to a handler.
+  Result<LinuxDigitalInEvents> GetEventLine(const LinuxInputConfig& config,
+                                            InterruptTrigger trigger);
 };
 
 class LinuxDigitalInInterrupt final : public DigitalInInterrupt {
@@ -243,4 +313,90 @@ class LinuxDigitalOut final : public DigitalInOut {
   internal::OwnedFd fd_;
 };
 
+/// A group of input lines that are read together.
+class LinuxDigitalInGroup final {
+  friend class LinuxDigitalIoChip;
+
+ public:
+  Status Enable();
+  Status Disable();
+
+  /// Returns the number of lines in the group.
+  size_t size() const { return config_.indices.size(); }
+
+  /// Reads the states of all lines with one ioctl. `states[i]` receives the
+  /// state of the i-th line in the config. `states` must have `size()`
+  /// elements.
+  Status GetStates(span<State> states);
+
+ private:
+  explicit LinuxDigitalInGroup(std::shared_ptr<LinuxDigitalIoChip::Impl> chip,
+                               const LinuxInputGroupConfig& config)
+      : chip_(std::move(chip)), config_(config) {}
+
+  std::shared_ptr<LinuxDigitalIoChip::Impl> chip_;
+  LinuxInputGroupConfig const config_;
+  internal::OwnedFd fd_;
+};
+
+/// A group of output lines that are set together.
+class LinuxDigitalOutGroup final {
+  friend class LinuxDigitalIoChip;
+
+ public:
+  Status Enable();
+  Status Disable();
+
+  /// Returns the number of lines in the group.
+  size_t size() const { return config_.indices.size(); }
+
+  /// Reads the states of all lines with one ioctl. `states` must have
+  /// `size()` elements.
+  Status GetStates(span<State> states);
+
+  /// Sets the states of all lines with one ioctl. `states[i]` is the new state
+  /// of the i-th line in the config. `states` must have `size()` elements.
+  Status SetStates(span<const State> states);
+
+ private:
+  explicit LinuxDigitalOutGroup(std::shared_ptr<LinuxDigitalIoChip::Impl> chip,
+                                const LinuxOutputGroupConfig& config)
+      : chip_(std::move(chip)), config_(config) {}
+
+  std::shared_ptr<LinuxDigitalIoChip::Impl> chip_;
+  LinuxOutputGroupConfig const config_;
+  internal::OwnedFd fd_;
+};
+
+/// An input line whose edge events are read in batches, with the kernel's
+/// timestamps. Unlike `LinuxDigitalInInterrupt`, no notifier thread is
+/// involved: a control loop can drain all edges since its last cycle with a
+/// single read, or wait for `fd()` to become readable with `poll()`.
+class LinuxDigitalInEvents final {
+  friend class LinuxDigitalIoChip;
+
+ public:
+  Status Enable();
+  Status Disable();
+
+  /// Returns the line event file descriptor, or -1 if disabled.
+  int fd() const { return fd_.fd(); }
+
+  /// Reads up to `events.size()` pending edge events with one read, oldest
+  /// first, and returns how many were read. Returns 0 without blocking if no
+  /// events are pending.
+  Result<size_t> ReadEvents(span<LinuxGpioEvent> events);
+
+ private:
+  explicit LinuxDigitalInEvents(std::shared_ptr<LinuxDigitalIoChip::Impl> chip,
+                                const LinuxInputConfig& config,
+                                InterruptTrigger trigger)
+      : chip_(std::move(chip)), config_(config), trigger_(trigger) {}
+
+  std::shared_ptr<LinuxDigitalIoChip::Impl> chip_;
+  LinuxInputConfig const config_;
+  InterruptTrigger const trigger_;
+  internal::OwnedFd fd_;
+};
+
 }  // namespace pw::digital_io
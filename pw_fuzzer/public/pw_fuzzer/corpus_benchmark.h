@@ -0,0 +1,76 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+/// @file corpus_benchmark.h
+/// Replays a fuzzing corpus as a throughput benchmark.
+///
+/// @rst
+/// A fuzz test's seed corpus is a set of realistic inputs for the code under
+/// test. Replaying the same corpus in a unit test and in a
+/// :ref:`module-pw_perf_test` benchmark lets these inputs guard against both
+/// correctness and performance regressions.
+/// @endrst
+
+#include <cstddef>
+
+#include "pw_log/log.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::fuzzer {
+
+/// Returns the total size of the inputs in a corpus.
+///
+/// Each input must be a container of bytes or characters, e.g. a
+/// `pw::ConstByteSpan` or a `std::string_view`.
+template <typename Corpus>
+size_t CorpusSizeBytes(const Corpus& corpus) {
+  size_t size_bytes = 0;
+  for (const auto& input : corpus) {
+    size_bytes += input.size();
+  }
+  return size_bytes;
+}
+
+/// Measures how long `target` takes to process every input in `corpus`.
+///
+/// Each run of the test body passes each input to `target` once, in order, so
+/// the throughput of the target is `CorpusSizeBytes(corpus)` divided by the
+/// reported duration. The corpus size is logged before it is measured.
+///
+/// @code{.cpp}
+///   void HdlcDecoderCorpus(pw::perf_test::State& state) {
+///     pw::fuzzer::MeasureCorpus(state, kDecoderCorpus, DecodeAll);
+///   }
+///   PW_PERF_TEST(HdlcDecoderCorpus, HdlcDecoderCorpus);
+/// @endcode
+template <typename Corpus, typename TargetFunction>
+void MeasureCorpus(perf_test::State& state,
+                   const Corpus& corpus,
+                   TargetFunction&& target) {
+  size_t num_inputs = 0;
+  for ([[maybe_unused]] const auto& input : corpus) {
+    ++num_inputs;
+  }
+  PW_LOG_INFO("Replaying %u corpus inputs (%u bytes) per run",
+              static_cast<unsigned>(num_inputs),
+              static_cast<unsigned>(CorpusSizeBytes(corpus)));
+  while (state.KeepRunning()) {
+    for (const auto& input : corpus) {
+      target(input);
+    }
+  }
+}
+
+}  // namespace pw::fuzzer
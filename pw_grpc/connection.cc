@@ -14,14 +14,16 @@
 
 #include "pw_grpc/connection.h"
 
+#include <array>
 #include <cinttypes>
 #include <cstring>
+#include <optional>
 #include <string_view>
 #include <type_traits>
 
 #include "pw_assert/check.h"
 #include "pw_chrono/system_clock.h"
-#include "pw_grpc_private/hpack.h"
+#include "pw_grpc/internal/hpack.h"
 #include "pw_log/log.h"
 #include "pw_preprocessor/compiler.h"
 #include "pw_status/try.h"
@@ -161,71 +163,55 @@ ConstByteSpan AsBytes(T& object) {
   return as_bytes(span<T, 1>{&object, 1});
 }
 
-// RFC 9113 §6.1
-Status SendData(SendQueue& send_queue,
-                StreamId stream_id,
-                ConstByteSpan payload1,
-                ConstByteSpan payload2) {
-  PW_LOG_DEBUG("Conn.Send DATA with id=%" PRIu32 " len1=%" PRIu32
-               " len2=%" PRIu32,
-               stream_id,
-               static_cast<uint32_t>(payload1.size()),
-               static_cast<uint32_t>(payload2.size()));
-  WireFrameHeader frame(FrameHeader{
-      .payload_length =
-          static_cast<uint32_t>(payload1.size() + payload2.size()),
-      .type = FrameType::DATA,
-      .flags = 0,
-      .stream_id = stream_id,
-  });
-  std::array<ConstByteSpan, 3> data_vector = {AsBytes(frame)};
-  size_t i = 1;
-  if (!payload1.empty()) {
-    data_vector[i++] = payload1;
-  }
-  if (!payload2.empty()) {
-    data_vector[i++] = payload2;
+// A HEADERS (RFC 9113 §6.2) or DATA (RFC 9113 §6.1) frame that is queued on
+// the SendQueue. This allows frames to be queued in order while holding the
+// connection state lock, and then waited for after releasing it, so that one
+// stream's large response does not block other streams.
+class QueuedFrame {
+ public:
+  QueuedFrame(FrameType type,
+              uint8_t flags,
+              StreamId stream_id,
+              ConstByteSpan payload1,
+              ConstByteSpan payload2)
+      : header_(FrameHeader{
+            .payload_length =
+                static_cast<uint32_t>(payload1.size() + payload2.size()),
+            .type = type,
+            .flags = flags,
+            .stream_id = stream_id,
+        }),
+        request_(span<ConstByteSpan>()) {
+    PW_LOG_DEBUG("Conn.Send %s with id=%" PRIu32 " len1=%" PRIu32
+                 " len2=%" PRIu32 " flags=0x%x",
+                 type == FrameType::HEADERS ? "HEADERS" : "DATA",
+                 stream_id,
+                 static_cast<uint32_t>(payload1.size()),
+                 static_cast<uint32_t>(payload2.size()),
+                 flags);
+    size_t i = 0;
+    buffers_[i++] = AsBytes(header_);
+    if (!payload1.empty()) {
+      buffers_[i++] = payload1;
+    }
+    if (!payload2.empty()) {
+      buffers_[i++] = payload2;
+    }
+    request_.messages = span(buffers_.data(), i);
   }
-  PW_TRY(send_queue.SendBytesVector(span{data_vector.data(), i}));
-  return OkStatus();
-}
 
-// RFC 9113 §6.2
-Status SendHeaders(SendQueue& send_queue,
-                   StreamId stream_id,
-                   ConstByteSpan payload1,
-                   ConstByteSpan payload2,
-                   bool end_stream) {
-  PW_LOG_DEBUG("Conn.Send HEADERS with id=%" PRIu32 " len1=%" PRIu32
-               " len2=%" PRIu32 " end=%d",
-               stream_id,
-               static_cast<uint32_t>(payload1.size()),
-               static_cast<uint32_t>(payload2.size()),
-               end_stream);
-  WireFrameHeader frame(FrameHeader{
-      .payload_length =
-          static_cast<uint32_t>(payload1.size() + payload2.size()),
-      .type = FrameType::HEADERS,
-      .flags = FLAGS_END_HEADERS,
-      .stream_id = stream_id,
-  });
+  QueuedFrame(const QueuedFrame&) = delete;
+  QueuedFrame& operator=(const QueuedFrame&) = delete;
 
-  if (end_stream) {
-    frame.flags |= FLAGS_END_STREAM;
-  }
+  void Queue(SendQueue& send_queue) { send_queue.QueueSendRequest(request_); }
 
-  std::array<ConstByteSpan, 3> headers_vector = {AsBytes(frame)};
-  size_t i = 1;
-  if (!payload1.empty()) {
-    headers_vector[i++] = payload1;
-  }
-  if (!payload2.empty()) {
-    headers_vector[i++] = payload2;
-  }
-  PW_TRY(send_queue.SendBytesVector(span{headers_vector.data(), i}));
+  Status Wait() { return request_.Wait(); }
 
-  return OkStatus();
-}
+ private:
+  WireFrameHeader header_;
+  std::array<ConstByteSpan, 3> buffers_;
+  SendQueue::SendRequest request_;
+};
 
 // RFC 9113 §6.4
 Status SendRstStream(SendQueue& send_queue,
@@ -291,7 +277,7 @@ Status SendWindowUpdates(SendQueue& send_queue,
           .increment = ToNetworkOrder(increment),
       },
   };
-  PW_TRY(send_queue.SendBytes(as_bytes(span{frames})));
+  PW_TRY(send_queue.SendUrgentBytes(as_bytes(span{frames})));
   return OkStatus();
 }
 
@@ -381,97 +367,120 @@ Connection::SharedState::LookupStream(StreamId id) {
 
 Status Connection::Writer::SendResponseMessage(StreamId stream_id,
                                                ConstByteSpan message) {
-  auto state = connection_.LockState();
-  auto stream = state->LookupStream(stream_id);
-  if (!stream.ok()) {
-    return Status::NotFound();
-  }
+  // Write a Length-Prefixed-Message payload.
+  ByteBuffer<5> prefix;
+  prefix.PutUint8(0);
+  prefix.PutUint32(message.size(), endian::big);
+
+  ByteBuffer<kHpackMaxResponseBlockSize> headers_block;
+  std::optional<QueuedFrame> headers;
+  std::optional<QueuedFrame> data;
+  {
+    auto state = connection_.LockState();
+    auto stream = state->LookupStream(stream_id);
+    if (!stream.ok()) {
+      return Status::NotFound();
+    }
 
-  if (message.size() > kMaxGrpcMessageSize) {
-    PW_LOG_WARN("Message %" PRIu32 " bytes on id=%" PRIu32
-                " exceeds maximum message size",
-                static_cast<uint32_t>(message.size()),
-                stream_id);
-    return Status::InvalidArgument();
-  }
+    if (message.size() > kMaxGrpcMessageSize) {
+      PW_LOG_WARN("Message %" PRIu32 " bytes on id=%" PRIu32
+                  " exceeds maximum message size",
+                  static_cast<uint32_t>(message.size()),
+                  stream_id);
+      return Status::InvalidArgument();
+    }
 
-  // This should block until there is enough send window.
-  if (static_cast<int32_t>(message.size()) > stream->get().send_window ||
-      static_cast<int32_t>(message.size()) > state->connection_send_window) {
-    PW_LOG_WARN("Not enough window to send %" PRIu32 " bytes on id=%" PRIu32,
-                static_cast<uint32_t>(message.size()),
-                stream_id);
-    return Status::ResourceExhausted();
-  }
+    // This should block until there is enough send window.
+    if (static_cast<int32_t>(message.size()) > stream->get().send_window ||
+        static_cast<int32_t>(message.size()) > state->connection_send_window) {
+      PW_LOG_WARN("Not enough window to send %" PRIu32 " bytes on id=%" PRIu32,
+                  static_cast<uint32_t>(message.size()),
+                  stream_id);
+      return Status::ResourceExhausted();
+    }
+
+    if (!stream->get().started_response) {
+      stream->get().started_response = true;
+      if (!state->hpack_encoder.EncodeResponseHeaders(headers_block).ok()) {
+        return Status::Unavailable();
+      }
+      headers.emplace(FrameType::HEADERS,
+                      FLAGS_END_HEADERS,
+                      stream_id,
+                      span(headers_block.data(), headers_block.size()),
+                      ConstByteSpan());
+      headers->Queue(connection_.send_queue_);
+    }
+    data.emplace(FrameType::DATA, 0, stream_id, prefix, message);
+    data->Queue(connection_.send_queue_);
 
-  auto status = OkStatus();
-  if (!stream->get().started_response) {
-    stream->get().started_response = true;
-    status = SendHeaders(connection_.send_queue_,
-                         stream_id,
-                         ResponseHeadersPayload(),
-                         ConstByteSpan(),
-                         /*end_stream=*/false);
+    stream->get().send_window -= message.size();
+    state->connection_send_window -= message.size();
   }
-  if (status.ok()) {
-    // Write a Length-Prefixed-Message payload.
-    ByteBuffer<5> prefix;
-    prefix.PutUint8(0);
-    prefix.PutUint32(message.size(), endian::big);
-    status = SendData(connection_.send_queue_, stream_id, prefix, message);
+
+  // Wait without holding the lock, so that other streams can queue frames to
+  // be sent along with these.
+  Status status;
+  if (headers.has_value()) {
+    status.Update(headers->Wait());
   }
+  status.Update(data->Wait());
   if (!status.ok()) {
     PW_LOG_WARN("Failed sending response message on id=%" PRIu32 " error=%d",
                 stream_id,
                 status.code());
     return Status::Unavailable();
   }
-  stream->get().send_window -= message.size();
-  state->connection_send_window -= message.size();
   return OkStatus();
 }
 
 Status Connection::Writer::SendResponseComplete(StreamId stream_id,
                                                 Status response_code) {
-  auto state = connection_.LockState();
-  auto stream = state->LookupStream(stream_id);
-  if (!stream.ok()) {
-    return Status::NotFound();
-  }
+  ByteBuffer<kHpackMaxResponseBlockSize> headers_block;
+  std::optional<QueuedFrame> headers;
+  {
+    auto state = connection_.LockState();
+    auto stream = state->LookupStream(stream_id);
+    if (!stream.ok()) {
+      return Status::NotFound();
+    }
 
-  Status status;
-  if (!stream->get().started_response) {
-    // If the response has not started yet, we need to include the initial
-    // headers.
-    PW_LOG_DEBUG("Conn.SendResponseWithTrailers id=%" PRIu32 " code=%d",
-                 stream_id,
-                 response_code.code());
-    status = SendHeaders(connection_.send_queue_,
-                         stream_id,
-                         ResponseHeadersPayload(),
-                         ResponseTrailersPayload(response_code),
-                         /*end_stream=*/true);
-  } else {
-    PW_LOG_DEBUG("Conn.SendTrailers id=%" PRIu32 " code=%d",
-                 stream_id,
-                 response_code.code());
-    status = SendHeaders(connection_.send_queue_,
-                         stream_id,
-                         ConstByteSpan(),
-                         ResponseTrailersPayload(response_code),
-                         /*end_stream=*/true);
+    Status status;
+    if (!stream->get().started_response) {
+      // If the response has not started yet, we need to include the initial
+      // headers.
+      PW_LOG_DEBUG("Conn.SendResponseWithTrailers id=%" PRIu32 " code=%d",
+                   stream_id,
+                   response_code.code());
+      status = state->hpack_encoder.EncodeResponseHeadersAndTrailers(
+          headers_block, response_code);
+    } else {
+      PW_LOG_DEBUG("Conn.SendTrailers id=%" PRIu32 " code=%d",
+                   stream_id,
+                   response_code.code());
+      status = state->hpack_encoder.EncodeResponseTrailers(headers_block,
+                                                           response_code);
+    }
+    if (!status.ok()) {
+      return Status::Unavailable();
+    }
+    headers.emplace(FrameType::HEADERS,
+                    FLAGS_END_HEADERS | FLAGS_END_STREAM,
+                    stream_id,
+                    span(headers_block.data(), headers_block.size()),
+                    ConstByteSpan());
+    headers->Queue(connection_.send_queue_);
+
+    PW_LOG_DEBUG("Conn.CloseStream id=%" PRIu32, stream_id);
+    stream->get().Reset();
   }
 
-  if (!status.ok()) {
+  if (const Status status = headers->Wait(); !status.ok()) {
     PW_LOG_WARN("Failed sending response complete on id=%" PRIu32 " error=%d",
                 stream_id,
                 status.code());
     return Status::Unavailable();
   }
-
-  PW_LOG_DEBUG("Conn.CloseStream id=%" PRIu32, stream_id);
-  stream->get().Reset();
-
   return OkStatus();
 }
 
@@ -793,25 +802,6 @@ Status Connection::Reader::ProcessHeadersFrame(const FrameHeader& frame) {
 
   last_stream_id_ = frame.stream_id;
 
-  {
-    auto state = connection_.LockState();
-    if (auto stream = state->LookupStream(frame.stream_id); stream.ok()) {
-      PW_LOG_DEBUG("Client sent HEADERS after the first stream message");
-      // grpc requests cannot contain trailers.
-      // See: https://github.com/grpc/grpc/blob/v1.60.x/doc/PROTOCOL-HTTP2.md.
-      PW_TRY(SendRstStreamAndClose(stream->get(), Http2Error::PROTOCOL_ERROR));
-      return OkStatus();
-    }
-  }
-
-  if ((frame.flags & FLAGS_END_STREAM) != 0) {
-    PW_LOG_DEBUG("Client sent HEADERS with END_STREAM");
-    // grpc requests must send END_STREAM in an empty DATA frame.
-    // See: https://github.com/grpc/grpc/blob/v1.60.x/doc/PROTOCOL-HTTP2.md.
-    PW_TRY(SendRstStream(
-        connection_.send_queue_, frame.stream_id, Http2Error::PROTOCOL_ERROR));
-    return OkStatus();
-  }
   if ((frame.flags & FLAGS_END_HEADERS) == 0) {
     PW_LOG_ERROR("Client sent HEADERS frame without END_HEADERS: unsupported");
     SendGoAway(Http2Error::INTERNAL_ERROR);
@@ -852,14 +842,44 @@ Status Connection::Reader::ProcessHeadersFrame(const FrameHeader& frame) {
     payload = payload.subspan(5);
   }
 
-  PW_TRY_ASSIGN(auto method_name, HpackParseRequestHeaders(payload));
+  // RFC 9113 §4.3: "A receiver MUST terminate the connection with a connection
+  // error of type COMPRESSION_ERROR if it does not decompress a field block."
+  // The block is decoded even if the stream is rejected below, since it may
+  // update the dynamic table.
+  auto method_name = HpackParseRequestHeaders(payload, hpack_table_);
+  if (!method_name.ok() && !method_name.status().IsNotFound()) {
+    SendGoAway(Http2Error::COMPRESSION_ERROR);
+    return Status::Internal();
+  }
+
+  {
+    auto state = connection_.LockState();
+    if (auto stream = state->LookupStream(frame.stream_id); stream.ok()) {
+      PW_LOG_DEBUG("Client sent HEADERS after the first stream message");
+      // grpc requests cannot contain trailers.
+      // See: https://github.com/grpc/grpc/blob/v1.60.x/doc/PROTOCOL-HTTP2.md.
+      PW_TRY(SendRstStreamAndClose(stream->get(), Http2Error::PROTOCOL_ERROR));
+      return OkStatus();
+    }
+  }
+
+  if ((frame.flags & FLAGS_END_STREAM) != 0) {
+    PW_LOG_DEBUG("Client sent HEADERS with END_STREAM");
+    // grpc requests must send END_STREAM in an empty DATA frame.
+    // See: https://github.com/grpc/grpc/blob/v1.60.x/doc/PROTOCOL-HTTP2.md.
+    PW_TRY(SendRstStream(
+        connection_.send_queue_, frame.stream_id, Http2Error::PROTOCOL_ERROR));
+    return OkStatus();
+  }
+
+  PW_TRY(method_name.status());
   if (!CreateStream(frame.stream_id).ok()) {
     PW_LOG_WARN("Too many streams, rejecting id=%" PRIu32, frame.stream_id);
     return SendRstStream(
         connection_.send_queue_, frame.stream_id, Http2Error::REFUSED_STREAM);
   }
 
-  if (const auto status = callbacks_.OnNew(frame.stream_id, method_name);
+  if (const auto status = callbacks_.OnNew(frame.stream_id, *method_name);
       !status.ok()) {
     auto state = connection_.LockState();
     if (auto stream = state->LookupStream(frame.stream_id); stream.ok()) {
@@ -995,8 +1015,11 @@ Status Connection::Reader::ProcessSettingsFrame(const FrameHeader& frame,
         // We never send frame payloads larger than 16384, so we don't need to
         // track the client's preference.
         break;
+      case SETTINGS_HEADER_TABLE_SIZE:
+        // RFC 7541 §4.2: limits the dynamic table used by our responses.
+        connection_.LockState()->hpack_encoder.SetPeerTableSize(value);
+        break;
       // Ignore these.
-      // SETTINGS_HEADER_TABLE_SIZE: our responses don't use the dynamic table
       // SETTINGS_ENABLE_PUSH: we don't support push
       // SETTINGS_MAX_CONCURRENT_STREAMS: we don't support push
       // SETTINGS_MAX_HEADER_LIST_SIZE: we send very tiny response HEADERS
@@ -1054,7 +1077,7 @@ Status Connection::Reader::ProcessPingFrame(const FrameHeader& frame) {
       // exactly as-is.
       .opaque_data = builder.begin().ReadUint64(endian::native),
   };
-  PW_TRY(connection_.send_queue_.SendBytes(AsBytes(ack_frame)));
+  PW_TRY(connection_.send_queue_.SendUrgentBytes(AsBytes(ack_frame)));
   return OkStatus();
 }
 
@@ -12,9 +12,12 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
-#include "pw_grpc_private/hpack.h"
+#include "pw_grpc/internal/hpack.h"
 
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <optional>
 
 #include "pw_assert/check.h"
 #include "pw_bytes/byte_builder.h"
@@ -28,8 +31,100 @@ namespace pw::grpc {
 
 namespace {
 #include "hpack.autogen.inc"
+
+// RFC 7541 Appendix A
+constexpr std::array<HpackDynamicTable::Entry, 61> kStaticTable = {{
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+}};
+
+// RFC 7541 §2.3.3
+Result<HpackDynamicTable::Entry> LookupField(int index,
+                                             const HpackDynamicTable& table) {
+  if (index <= 0) {
+    return Status::InvalidArgument();
+  }
+  const size_t i = static_cast<size_t>(index) - 1;
+  if (i < kStaticTable.size()) {
+    return kStaticTable[i];
+  }
+  return table.Get(i - kStaticTable.size());
 }
 
+// Index of the first dynamic table entry.
+constexpr size_t kFirstDynamicIndex = kStaticTable.size() + 1;
+
+// RFC 7541 Appendix A: index of "content-type".
+constexpr uint32_t kContentTypeIndex = 31;
+
+constexpr size_t kContentTypeEntrySize = sizeof("content-type") - 1 +
+                                         sizeof("application/grpc") - 1 +
+                                         HpackDynamicTable::kEntryOverhead;
+constexpr size_t kGrpcStatusOkEntrySize = sizeof("grpc-status") - 1 +
+                                          sizeof("0") - 1 +
+                                          HpackDynamicTable::kEntryOverhead;
+
+}  // namespace
+
 // RFC 7541 §5.1
 Result<int> HpackIntegerDecode(ConstByteSpan& input, int bits_in_first_byte) {
   if (input.empty()) {
@@ -63,6 +158,29 @@ Result<int> HpackIntegerDecode(ConstByteSpan& input, int bits_in_first_byte) {
   }
 }
 
+// RFC 7541 §5.1
+Status HpackIntegerEncode(ByteBuilder& output,
+                          uint32_t value,
+                          int bits_in_first_byte,
+                          uint8_t first_byte) {
+  const uint32_t max_prefix = (1u << bits_in_first_byte) - 1;
+  first_byte &= static_cast<uint8_t>(~max_prefix);
+
+  if (value < max_prefix) {
+    output.PutUint8(first_byte | static_cast<uint8_t>(value));
+    return output.status();
+  }
+
+  output.PutUint8(first_byte | static_cast<uint8_t>(max_prefix));
+  value -= max_prefix;
+  while (value >= 128) {
+    output.PutUint8(static_cast<uint8_t>((value & 127) | 128));
+    value >>= 7;
+  }
+  output.PutUint8(static_cast<uint8_t>(value));
+  return output.status();
+}
+
 // RFC 7541 §5.2
 Result<InlineString<kHpackMaxStringSize>> HpackStringDecode(
     ConstByteSpan& input) {
@@ -120,33 +238,33 @@ Result<InlineString<kHpackMaxStringSize>> HpackHuffmanDecode(
 
 // RFC 7541 §6
 Result<InlineString<kHpackMaxStringSize>> HpackParseRequestHeaders(
-    ConstByteSpan input) {
+    ConstByteSpan input, HpackDynamicTable& table) {
+  std::optional<InlineString<kHpackMaxStringSize>> path;
+
   while (!input.empty()) {
     int first = static_cast<int>(input[0]);
 
     // RFC 7541 §6.1
     if ((first & 0b1000'0000) != 0) {
       PW_TRY_ASSIGN(int index, HpackIntegerDecode(input, 7));
-      // RFC 7541 Appendix A: these are the only static table entries for :path.
-      if (index == 4) {
-        return "/";
-      }
-      if (index == 5) {
-        return "/index.html";
+      PW_TRY_ASSIGN(auto field, LookupField(index, table));
+      if (field.name == ":path") {
+        path = field.value;
       }
       continue;
     }
 
     // RFC 7541 §6.3: dynamic table size update
     if ((first & 0b1110'0000) == 0b0010'0000) {
-      // Ignore: we don't use the dynamic table.
-      PW_TRY(HpackIntegerDecode(input, 5));
+      PW_TRY_ASSIGN(int max_size, HpackIntegerDecode(input, 5));
+      PW_TRY(table.SetMaxSize(static_cast<uint32_t>(max_size)));
       continue;
     }
 
     // RFC 7541 §6.2
     int index;
-    if ((first & 0b1100'0000) == 0b0100'0000) {
+    const bool add_to_table = (first & 0b1100'0000) == 0b0100'0000;
+    if (add_to_table) {
       PW_TRY_ASSIGN(index, HpackIntegerDecode(input, 6));
     } else {
       PW_CHECK((first & 0b1111'0000) == 0b0000'0000 ||
@@ -154,24 +272,194 @@ Result<InlineString<kHpackMaxStringSize>> HpackParseRequestHeaders(
       PW_TRY_ASSIGN(index, HpackIntegerDecode(input, 4));
     }
 
-    // Check if the name is ":path".
-    bool is_path;
+    // The name is copied out of the table, since adding the field to the table
+    // may evict the entry it refers to.
+    InlineString<kHpackMaxStringSize> name;
     if (index == 0) {
-      PW_TRY_ASSIGN(auto name, HpackStringDecode(input));
-      is_path = (name == ":path");
+      PW_TRY_ASSIGN(name, HpackStringDecode(input));
     } else {
-      // RFC 7541 Appendix A: these are the only static table entries for :path.
-      is_path = (index == 4 || index == 5);
+      PW_TRY_ASSIGN(auto field, LookupField(index, table));
+      name = field.name;
     }
-
-    // Always extract the value to advance the `input` span.
     PW_TRY_ASSIGN(auto value, HpackStringDecode(input));
-    if (is_path) {
-      return value;
+
+    if (add_to_table) {
+      table.Add(name, value);
+    }
+    if (name == ":path") {
+      path = value;
+    }
+  }
+
+  if (!path.has_value()) {
+    return Status::NotFound();
+  }
+  return *path;
+}
+
+Status HpackDynamicTable::SetMaxSize(uint32_t max_size) {
+  if (max_size > kHpackDynamicHeaderTableSize) {
+    return Status::InvalidArgument();
+  }
+  max_size_ = max_size;
+  while (size_ > max_size_) {
+    EvictOldest();
+  }
+  return OkStatus();
+}
+
+void HpackDynamicTable::Add(std::string_view name, std::string_view value) {
+  const size_t entry_size = name.size() + value.size() + kEntryOverhead;
+  while (num_entries_ > 0 && size_ + entry_size > max_size_) {
+    EvictOldest();
+  }
+  if (entry_size > max_size_) {
+    return;
+  }
+
+  // Since each entry's size includes kEntryOverhead, an entry that fits within
+  // max_size_ always fits in data_ and slots_.
+  std::memcpy(data_.data() + data_size_, name.data(), name.size());
+  data_size_ += name.size();
+  std::memcpy(data_.data() + data_size_, value.data(), value.size());
+  data_size_ += value.size();
+  slots_[num_entries_++] = {static_cast<uint16_t>(name.size()),
+                            static_cast<uint16_t>(value.size())};
+  size_ += entry_size;
+}
+
+Result<HpackDynamicTable::Entry> HpackDynamicTable::Get(size_t index) const {
+  if (index >= num_entries_) {
+    return Status::InvalidArgument();
+  }
+  const size_t slot = num_entries_ - 1 - index;
+  size_t offset = data_size_;
+  for (size_t i = num_entries_; i > slot; --i) {
+    offset -= slots_[i - 1].name_size + slots_[i - 1].value_size;
+  }
+  const char* name = data_.data() + offset;
+  return Entry{
+      .name = std::string_view(name, slots_[slot].name_size),
+      .value = std::string_view(name + slots_[slot].name_size,
+                                slots_[slot].value_size),
+  };
+}
+
+void HpackDynamicTable::EvictOldest() {
+  PW_DCHECK_UINT_NE(num_entries_, 0);
+  const size_t length = slots_[0].name_size + slots_[0].value_size;
+  std::memmove(data_.data(), data_.data() + length, data_size_ - length);
+  std::copy(slots_.begin() + 1, slots_.begin() + num_entries_, slots_.begin());
+  data_size_ -= length;
+  size_ -= length + kEntryOverhead;
+  --num_entries_;
+}
+
+void HpackResponseEncoder::SetPeerTableSize(uint32_t size) {
+  if (size != max_table_size_) {
+    max_table_size_ = size;
+    size_update_pending_ = true;
+  }
+}
+
+Status HpackResponseEncoder::EncodeResponseHeaders(ByteBuilder& block) {
+  StartBlock(block);
+  AppendResponseHeaders(block);
+  return block.status();
+}
+
+Status HpackResponseEncoder::EncodeResponseHeadersAndTrailers(
+    ByteBuilder& block, Status response_code) {
+  StartBlock(block);
+  AppendResponseHeaders(block);
+  AppendResponseTrailers(block, response_code);
+  return block.status();
+}
+
+Status HpackResponseEncoder::EncodeResponseTrailers(ByteBuilder& block,
+                                                    Status response_code) {
+  StartBlock(block);
+  AppendResponseTrailers(block, response_code);
+  return block.status();
+}
+
+// RFC 7541 §4.2
+void HpackResponseEncoder::StartBlock(ByteBuilder& block) {
+  if (!size_update_pending_) {
+    return;
+  }
+  // Shrinking the table to zero evicts every entry, so the peer's table is
+  // known to be empty regardless of the new size.
+  HpackIntegerEncode(block, 0, 5, 0b0010'0000).IgnoreError();
+  if (max_table_size_ != 0) {
+    HpackIntegerEncode(block, max_table_size_, 5, 0b0010'0000).IgnoreError();
+  }
+  size_update_pending_ = false;
+  table_size_ = 0;
+  num_added_ = 0;
+  added_order_ = {};
+}
+
+void HpackResponseEncoder::AppendResponseHeaders(ByteBuilder& block) {
+  // The cached fields are ":status 200" (static index 8) followed by
+  // "content-type application/grpc" with incremental indexing.
+  const ConstByteSpan cached = ResponseHeadersPayload();
+  block.push_back(cached[0]);
+  if (AppendIndexed(block, kContentType)) {
+    return;
+  }
+  if (AddToTable(kContentType)) {
+    block.append(cached.subspan(1));
+    return;
+  }
+  // RFC 7541 §6.2.2: literal without indexing, with an indexed name.
+  HpackIntegerEncode(block, kContentTypeIndex, 4).IgnoreError();
+  block.append(cached.subspan(2));
+}
+
+void HpackResponseEncoder::AppendResponseTrailers(ByteBuilder& block,
+                                                  Status response_code) {
+  // The cached fields are "grpc-status <code>" with incremental indexing and a
+  // literal name.
+  const ConstByteSpan cached = ResponseTrailersPayload(response_code);
+  if (response_code.ok()) {
+    if (AppendIndexed(block, kGrpcStatusOk)) {
+      return;
     }
+    if (AddToTable(kGrpcStatusOk)) {
+      block.append(cached);
+      return;
+    }
+  }
+  // RFC 7541 §6.2.2: literal without indexing, with a literal name. Other
+  // status codes are not indexed, since they are rarely repeated.
+  block.PutUint8(0);
+  block.append(cached.subspan(1));
+}
+
+bool HpackResponseEncoder::AddToTable(CachedField field) {
+  const size_t entry_size =
+      field == kContentType ? kContentTypeEntrySize : kGrpcStatusOkEntrySize;
+  // Entries are only added if they fit without evicting other entries, so
+  // that the peer never evicts an entry this encoder refers to.
+  if (table_size_ + entry_size > max_table_size_) {
+    return false;
   }
+  table_size_ += entry_size;
+  added_order_[field] = ++num_added_;
+  return true;
+}
 
-  return Status::NotFound();
+bool HpackResponseEncoder::AppendIndexed(ByteBuilder& block,
+                                         CachedField field) {
+  if (added_order_[field] == 0) {
+    return false;
+  }
+  // RFC 7541 §2.3.3: the newest entry has the lowest dynamic index.
+  const size_t index = kFirstDynamicIndex + num_added_ - added_order_[field];
+  HpackIntegerEncode(block, static_cast<uint32_t>(index), 7, 0b1000'0000)
+      .IgnoreError();
+  return true;
 }
 
 ConstByteSpan ResponseHeadersPayload() {
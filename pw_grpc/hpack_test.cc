@@ -12,10 +12,14 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
-#include "pw_grpc_private/hpack.h"
+#include "pw_grpc/internal/hpack.h"
+
+#include <algorithm>
+#include <iterator>
 
 #include "gtest/gtest.h"
 #include "pw_bytes/array.h"
+#include "pw_bytes/byte_builder.h"
 
 namespace pw::grpc {
 namespace {
@@ -27,6 +31,16 @@ void TestIntegerDecode(ConstByteSpan input, int bits, int expected) {
   EXPECT_TRUE(input.empty());  // input has advanced past the integer
 }
 
+void TestIntegerEncode(uint32_t value,
+                       int bits,
+                       uint8_t first_byte,
+                       ConstByteSpan expected) {
+  ByteBuffer<8> output;
+  ASSERT_EQ(HpackIntegerEncode(output, value, bits, first_byte), OkStatus());
+  EXPECT_TRUE(std::equal(
+      output.begin(), output.end(), expected.begin(), expected.end()));
+}
+
 void TestHuffmanDecode(ConstByteSpan input, std::string_view expected) {
   auto result = HpackHuffmanDecode(input);
   ASSERT_TRUE(result.ok());
@@ -47,6 +61,17 @@ TEST(HpackTest, HpackIntegerDecodeC13) {
   TestIntegerDecode(kInput, /*bits_in_first_byte=*/8, /*expected=*/42);
 }
 
+TEST(HpackTest, HpackIntegerEncodeC11) {
+  TestIntegerEncode(10, 5, 0b1110'0000, bytes::Array<0b11101010>());
+}
+TEST(HpackTest, HpackIntegerEncodeC12) {
+  TestIntegerEncode(
+      1337, 5, 0, bytes::Array<0b00011111, 0b10011010, 0b00001010>());
+}
+TEST(HpackTest, HpackIntegerEncodeC13) {
+  TestIntegerEncode(42, 8, 0, bytes::Array<0b00101010>());
+}
+
 // Huffman test cases from RFC 7541 Appendix C.4.
 // clang-format off
 const auto kHuffmanC41 = bytes::Array<0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff>();
@@ -72,14 +97,16 @@ TEST(HpackTest, HpackHuffmanDecodeC43b) {
 TEST(HpackTest, HpackParseRequestHeadersFoundIndexedSlash) {
   // Appendix C.3.1.
   const auto kInput = bytes::Array<0x84>();
-  auto result = HpackParseRequestHeaders(kInput);
+  HpackDynamicTable table;
+  auto result = HpackParseRequestHeaders(kInput, table);
   ASSERT_TRUE(result.ok());
   EXPECT_EQ(*result, "/");
 }
 TEST(HpackTest, HpackParseRequestHeadersFoundIndexedHtml) {
   // Appendix C.3.3.
   const auto kInput = bytes::Array<0x85>();
-  auto result = HpackParseRequestHeaders(kInput);
+  HpackDynamicTable table;
+  auto result = HpackParseRequestHeaders(kInput, table);
   ASSERT_TRUE(result.ok());
   EXPECT_EQ(*result, "/index.html");
 }
@@ -96,7 +123,8 @@ TEST(HpackTest, HpackParseRequestHeadersFoundNotIndexed) {
       0x04, 0x0c, 0x2f, 0x73, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2f, 0x70, 0x61, 0x74, 0x68
   >();
   // clang-format on
-  auto result = HpackParseRequestHeaders(kInput);
+  HpackDynamicTable table;
+  auto result = HpackParseRequestHeaders(kInput, table);
   ASSERT_TRUE(result.ok());
   EXPECT_EQ(*result, "/sample/path");
 }
@@ -111,10 +139,185 @@ TEST(HpackTest, HpackParseRequestHeadersNotFound) {
       0x72, 0x65, 0x74
   >();
   // clang-format on
-  auto result = HpackParseRequestHeaders(kInput);
+  HpackDynamicTable table;
+  auto result = HpackParseRequestHeaders(kInput, table);
   ASSERT_FALSE(result.ok());
   EXPECT_EQ(result.status().code(), PW_STATUS_NOT_FOUND);
 }
 
+// Requests from RFC 7541 Appendix C.3, which share a dynamic table.
+TEST(HpackTest, HpackParseRequestHeadersUsesDynamicTable) {
+  // clang-format off
+  const auto kFirstRequest = bytes::Array<
+      0x82, 0x86, 0x84, 0x41, 0x0f, 0x77, 0x77, 0x77, 0x2e, 0x65, 0x78, 0x61,
+      0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x63, 0x6f, 0x6d>();
+  const auto kSecondRequest = bytes::Array<
+      0x82, 0x86, 0x84, 0xbe, 0x58, 0x08, 0x6e, 0x6f, 0x2d, 0x63, 0x61, 0x63,
+      0x68, 0x65>();
+  const auto kThirdRequest = bytes::Array<
+      0x82, 0x87, 0x85, 0xbf, 0x40, 0x0a, 0x63, 0x75, 0x73, 0x74, 0x6f, 0x6d,
+      0x2d, 0x6b, 0x65, 0x79, 0x0c, 0x63, 0x75, 0x73, 0x74, 0x6f, 0x6d, 0x2d,
+      0x76, 0x61, 0x6c, 0x75, 0x65>();
+  // clang-format on
+  HpackDynamicTable table;
+
+  auto result = HpackParseRequestHeaders(kFirstRequest, table);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(*result, "/");
+  EXPECT_EQ(table.size(), 57u);
+
+  result = HpackParseRequestHeaders(kSecondRequest, table);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(table.size(), 110u);
+  ASSERT_EQ(table.num_entries(), 2u);
+  EXPECT_EQ(table.Get(0)->name, "cache-control");
+  EXPECT_EQ(table.Get(1)->value, "www.example.com");
+
+  result = HpackParseRequestHeaders(kThirdRequest, table);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(*result, "/index.html");
+  EXPECT_EQ(table.size(), 164u);
+  EXPECT_EQ(table.Get(0)->value, "custom-value");
+}
+
+TEST(HpackTest, HpackParseRequestHeadersFoundIndexedPath) {
+  // ":path" with incremental indexing, then the same field by index.
+  // clang-format off
+  const auto kFirstRequest = bytes::Array<
+      0x44, 0x0c, 0x2f, 0x73, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2f, 0x70, 0x61,
+      0x74, 0x68>();
+  // clang-format on
+  const auto kSecondRequest = bytes::Array<0xbe>();
+  HpackDynamicTable table;
+
+  auto result = HpackParseRequestHeaders(kFirstRequest, table);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(*result, "/sample/path");
+  result = HpackParseRequestHeaders(kSecondRequest, table);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(*result, "/sample/path");
+}
+
+TEST(HpackTest, HpackParseRequestHeadersInvalidIndex) {
+  HpackDynamicTable table;
+  EXPECT_EQ(HpackParseRequestHeaders(bytes::Array<0xbe>(), table).status(),
+            Status::InvalidArgument());
+  EXPECT_EQ(HpackParseRequestHeaders(bytes::Array<0x80>(), table).status(),
+            Status::InvalidArgument());
+}
+
+TEST(HpackTest, HpackParseRequestHeadersTableSizeUpdate) {
+  HpackDynamicTable table;
+  table.Add("custom-key", "custom-value");
+  EXPECT_EQ(table.num_entries(), 1u);
+
+  // Size update to 0, which evicts every entry.
+  auto result = HpackParseRequestHeaders(bytes::Array<0x20, 0x84>(), table);
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(table.num_entries(), 0u);
+  EXPECT_EQ(table.max_size(), 0u);
+
+  // Size updates larger than the advertised table size are errors.
+  EXPECT_EQ(HpackParseRequestHeaders(bytes::Array<0x3f, 0xe1, 0x1f>(), table)
+                .status(),
+            Status::InvalidArgument());
+}
+
+TEST(HpackDynamicTableTest, EvictsOldestEntries) {
+  HpackDynamicTable table;
+  ASSERT_EQ(table.SetMaxSize(100), OkStatus());
+
+  table.Add("a", "1");  // 34 bytes
+  table.Add("b", "2");
+  EXPECT_EQ(table.size(), 68u);
+  table.Add("c", "3");
+  EXPECT_EQ(table.size(), 68u);
+  ASSERT_EQ(table.num_entries(), 2u);
+  EXPECT_EQ(table.Get(0)->name, "c");
+  EXPECT_EQ(table.Get(1)->name, "b");
+  EXPECT_FALSE(table.Get(2).ok());
+
+  // An entry larger than the table empties it.
+  table.Add(std::string_view("0123456789012345678901234567890123456789"),
+            std::string_view("0123456789012345678901234567890123456789"));
+  EXPECT_EQ(table.num_entries(), 0u);
+  EXPECT_EQ(table.size(), 0u);
+}
+
+template <typename T>
+void ExpectBlock(ConstByteSpan block, const T& expected) {
+  EXPECT_TRUE(std::equal(
+      block.begin(), block.end(), std::begin(expected), std::end(expected)));
+}
+
+template <typename T>
+void ExpectBlock(const ByteBuilder& block, const T& expected) {
+  ExpectBlock(ConstByteSpan(block.data(), block.size()), expected);
+}
+
+TEST(HpackResponseEncoderTest, IndexesRepeatedFields) {
+  HpackResponseEncoder encoder;
+  ByteBuffer<kHpackMaxResponseBlockSize> block;
+
+  // The first response sends the fields with incremental indexing.
+  ASSERT_EQ(encoder.EncodeResponseHeaders(block), OkStatus());
+  ExpectBlock(block, ResponseHeadersPayload());
+  block.clear();
+  ASSERT_EQ(encoder.EncodeResponseTrailers(block, OkStatus()), OkStatus());
+  ExpectBlock(block, ResponseTrailersPayload(OkStatus()));
+
+  // Later responses refer to them by index. "grpc-status: 0" is the newest
+  // entry, at index 62.
+  block.clear();
+  ASSERT_EQ(encoder.EncodeResponseHeadersAndTrailers(block, OkStatus()),
+            OkStatus());
+  ExpectBlock(block, bytes::Array<0x88, 0xbf, 0xbe>());
+}
+
+TEST(HpackResponseEncoderTest, ErrorTrailersAreNotIndexed) {
+  HpackResponseEncoder encoder;
+  ByteBuffer<kHpackMaxResponseBlockSize> block;
+
+  ASSERT_EQ(encoder.EncodeResponseTrailers(block, Status::NotFound()),
+            OkStatus());
+  const ConstByteSpan cached = ResponseTrailersPayload(Status::NotFound());
+  ASSERT_EQ(block.size(), cached.size());
+  EXPECT_EQ(block.data()[0], std::byte{0});
+  EXPECT_TRUE(std::equal(block.begin() + 1, block.end(), cached.begin() + 1));
+}
+
+TEST(HpackResponseEncoderTest, PeerTableSizeChange) {
+  HpackResponseEncoder encoder;
+  ByteBuffer<kHpackMaxResponseBlockSize> block;
+  ASSERT_EQ(encoder.EncodeResponseHeaders(block), OkStatus());
+
+  // A zero-sized table is signaled once, and then nothing is indexed.
+  encoder.SetPeerTableSize(0);
+  block.clear();
+  ASSERT_EQ(encoder.EncodeResponseTrailers(block, OkStatus()), OkStatus());
+  ASSERT_GT(block.size(), 1u);
+  EXPECT_EQ(block.data()[0], std::byte{0x20});
+  EXPECT_EQ(block.data()[1], std::byte{0});
+
+  block.clear();
+  ASSERT_EQ(encoder.EncodeResponseHeaders(block), OkStatus());
+  // clang-format off
+  ExpectBlock(block, bytes::Array<
+      0x88, 0x0f, 0x10, 0x10, 0x61, 0x70, 0x70, 0x6c, 0x69, 0x63, 0x61, 0x74,
+      0x69, 0x6f, 0x6e, 0x2f, 0x67, 0x72, 0x70, 0x63>());
+  // clang-format on
+
+  // A new size empties the table, and fields are indexed again.
+  encoder.SetPeerTableSize(100);
+  block.clear();
+  ASSERT_EQ(encoder.EncodeResponseHeaders(block), OkStatus());
+  ASSERT_EQ(block.size(), 3 + ResponseHeadersPayload().size());
+  ExpectBlock(ConstByteSpan(block.data(), 3),
+              bytes::Array<0x20, 0x3f, 0x45>());
+  block.clear();
+  ASSERT_EQ(encoder.EncodeResponseHeaders(block), OkStatus());
+  ExpectBlock(block, bytes::Array<0x88, 0xbe>());
+}
+
 }  // namespace
 }  // namespace pw::grpc
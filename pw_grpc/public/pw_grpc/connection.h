@@ -20,6 +20,7 @@
 #include "pw_bytes/byte_builder.h"
 #include "pw_bytes/span.h"
 #include "pw_function/function.h"
+#include "pw_grpc/internal/hpack.h"
 #include "pw_grpc/send_queue.h"
 #include "pw_result/result.h"
 #include "pw_status/status.h"
@@ -220,6 +221,10 @@ class Connection {
     std::array<Stream, internal::kMaxConcurrentStreams> streams{};
     int32_t connection_send_window = kDefaultInitialWindowSize;
 
+    // Encodes response header blocks. Header blocks must be sent in the order
+    // they are encoded, so this is only used while sending.
+    HpackResponseEncoder hpack_encoder;
+
     // Allocator for fragmented grpc message reassembly
     allocator::Allocator* message_assembly_allocator_;
   };
@@ -267,6 +272,9 @@ class Connection {
 
     std::array<std::byte, internal::kMaxFramePayloadSize> payload_scratch_{};
     StreamId last_stream_id_ = 0;
+
+    // Decodes request header blocks.
+    HpackDynamicTable hpack_table_;
   };
 
   sync::BorrowedPointer<SharedState> LockState() {
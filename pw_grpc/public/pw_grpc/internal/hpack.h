@@ -0,0 +1,173 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_bytes/byte_builder.h"
+#include "pw_bytes/span.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_string/string.h"
+
+namespace pw::grpc {
+
+// Size of the HPACK dynamic header table used to decode requests. This is
+// advertised to clients with SETTINGS_HEADER_TABLE_SIZE.
+inline constexpr uint32_t kHpackDynamicHeaderTableSize = 512;
+
+// Maximum size of a string that can be returned by this API.
+inline constexpr uint32_t kHpackMaxStringSize = 127;
+
+// Maximum size of a header block returned by HpackResponseEncoder.
+inline constexpr size_t kHpackMaxResponseBlockSize = 64;
+
+// RFC 7541 §2.3.2: the dynamic table used to decode header blocks from one
+// peer. Entries are evicted oldest first once the table exceeds its maximum
+// size.
+class HpackDynamicTable {
+ public:
+  struct Entry {
+    std::string_view name;
+    std::string_view value;
+  };
+
+  // RFC 7541 §4.1
+  static constexpr size_t kEntryOverhead = 32;
+
+  // RFC 7541 §6.3: sets the maximum size of the table, evicting entries as
+  // needed. Returns INVALID_ARGUMENT if the size exceeds
+  // kHpackDynamicHeaderTableSize.
+  Status SetMaxSize(uint32_t max_size);
+
+  // RFC 7541 §4.4: adds an entry, evicting old entries to make room for it. An
+  // entry larger than the maximum size empties the table. The name and value
+  // must not refer to memory owned by the table.
+  void Add(std::string_view name, std::string_view value);
+
+  // Returns the entry at the given dynamic table index, where 0 is the newest
+  // entry. The entry is valid until the table is next modified.
+  Result<Entry> Get(size_t index) const;
+
+  // Size of the table, as defined by RFC 7541 §4.1.
+  size_t size() const { return size_; }
+  size_t max_size() const { return max_size_; }
+  size_t num_entries() const { return num_entries_; }
+
+ private:
+  struct Slot {
+    uint16_t name_size;
+    uint16_t value_size;
+  };
+
+  void EvictOldest();
+
+  // Entries are stored oldest first, with their names and values packed in
+  // `data_` in the same order.
+  std::array<Slot, kHpackDynamicHeaderTableSize / kEntryOverhead> slots_{};
+  std::array<char, kHpackDynamicHeaderTableSize> data_{};
+  size_t num_entries_ = 0;
+  size_t data_size_ = 0;
+  size_t size_ = 0;
+  size_t max_size_ = kHpackDynamicHeaderTableSize;
+};
+
+// Encodes the header blocks of grpc responses on one connection.
+//
+// The first response on a connection adds "content-type: application/grpc"
+// and "grpc-status: 0" to the peer's dynamic table. Later responses refer to
+// these entries with single-byte indexed fields instead of resending them.
+class HpackResponseEncoder {
+ public:
+  // Applies the peer's SETTINGS_HEADER_TABLE_SIZE. The change is signaled at
+  // the start of the next header block.
+  void SetPeerTableSize(uint32_t size);
+
+  // Encodes a header block with grpc Response-Headers.
+  Status EncodeResponseHeaders(ByteBuilder& block);
+
+  // Encodes a header block with grpc Response-Headers followed by Trailers, for
+  // a response without any messages.
+  Status EncodeResponseHeadersAndTrailers(ByteBuilder& block,
+                                          Status response_code);
+
+  // Encodes a header block with grpc Trailers.
+  Status EncodeResponseTrailers(ByteBuilder& block, Status response_code);
+
+ private:
+  enum CachedField : size_t {
+    kContentType,
+    kGrpcStatusOk,
+    kNumCachedFields,
+  };
+
+  void StartBlock(ByteBuilder& block);
+  void AppendResponseHeaders(ByteBuilder& block);
+  void AppendResponseTrailers(ByteBuilder& block, Status response_code);
+
+  // Returns true if the field should be encoded with incremental indexing, and
+  // records it as added to the peer's table.
+  bool AddToTable(CachedField field);
+
+  // Appends an indexed field for the field, if it is in the peer's table.
+  bool AppendIndexed(ByteBuilder& block, CachedField field);
+
+  // RFC 9113 §6.5.2: the initial value of SETTINGS_HEADER_TABLE_SIZE.
+  uint32_t max_table_size_ = 4096;
+  bool size_update_pending_ = false;
+  size_t table_size_ = 0;
+  size_t num_added_ = 0;
+  // The order in which each field was added to the table, starting at 1, or 0
+  // if the field is not in the table.
+  std::array<size_t, kNumCachedFields> added_order_{};
+};
+
+// Parses a request header field block, returning the grpc method name. All
+// fields are decoded, and the dynamic table is updated as the block requires.
+// Returns NOT_FOUND if the block does not include a ":path", or another error
+// if the block cannot be decoded.
+Result<InlineString<kHpackMaxStringSize>> HpackParseRequestHeaders(
+    ConstByteSpan payload, HpackDynamicTable& table);
+
+// Decodes an HPACK integer.
+// Consumed bytes are removed from the `input` span.
+Result<int> HpackIntegerDecode(ConstByteSpan& input, int bits_in_first_byte);
+
+// Encodes an HPACK integer. The high bits of `first_byte` are kept as the
+// representation's prefix.
+Status HpackIntegerEncode(ByteBuilder& output,
+                          uint32_t value,
+                          int bits_in_first_byte,
+                          uint8_t first_byte = 0);
+
+// Decodes an HPACK string.
+// Consumed bytes are removed from the `input` span.
+Result<InlineString<kHpackMaxStringSize>> HpackStringDecode(
+    ConstByteSpan& input);
+
+// Decodes a Huffman-encoded string.
+Result<InlineString<kHpackMaxStringSize>> HpackHuffmanDecode(
+    ConstByteSpan input);
+
+// Returns a HEADERS payload to use for grpc Response-Headers.
+ConstByteSpan ResponseHeadersPayload();
+
+// Returns a HEADERS payload to use for grpc Trailers.
+ConstByteSpan ResponseTrailersPayload(Status response_code);
+
+}  // namespace pw::grpc
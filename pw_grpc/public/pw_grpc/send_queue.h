@@ -13,7 +13,8 @@
 // the License.
 #pragma once
 
-#include <optional>
+#include <array>
+#include <cstddef>
 
 #include "pw_async/dispatcher.h"
 #include "pw_async_basic/dispatcher.h"
@@ -30,8 +31,34 @@ namespace pw::grpc {
 
 // SendQueue is a queue+thread that serializes sending lists of bytes to
 // a stream.
+//
+// Requests are sent in the order they are queued, except for urgent requests,
+// which are sent ahead of any queued normal requests. All requests that are
+// queued while a write is in progress are coalesced into a single vectored
+// write, so that many small frames from different streams cost one write to
+// the socket.
 class SendQueue : public thread::ThreadCore {
  public:
+  // Maximum number of buffers passed to a single socket write.
+  static constexpr size_t kMaxCoalescedBuffers = 16;
+
+  // A request to send a list of bytes. The request and the bytes it refers to
+  // must remain valid until Wait() returns.
+  struct SendRequest : public IntrusiveList<SendRequest>::Item {
+    SendRequest(span<ConstByteSpan> m) : messages(m) {}
+
+    // Blocks till the request is sent. Returns union of Status's from stream
+    // writes.
+    Status Wait() {
+      notify.acquire();
+      return status;
+    }
+
+    sync::TimedThreadNotification notify;
+    Status status = OkStatus();
+    span<ConstByteSpan> messages;
+  };
+
   SendQueue(stream::ReaderWriter& socket)
       : socket_(socket),
         send_task_(pw::bind_member<&SendQueue::ProcessSendQueue>(this)) {}
@@ -40,35 +67,49 @@ class SendQueue : public thread::ThreadCore {
   // write.
   Status SendBytes(ConstByteSpan message) PW_LOCKS_EXCLUDED(send_mutex_);
 
+  // Thread safe. Like SendBytes(), but the message is sent ahead of queued
+  // normal requests. See QueueUrgentSendRequest().
+  Status SendUrgentBytes(ConstByteSpan message) PW_LOCKS_EXCLUDED(send_mutex_);
+
   // Thread safe. Blocks till send is complete. All messages are sent
   // atomically. Returns union of Status's from stream writes.
   Status SendBytesVector(span<ConstByteSpan> messages)
       PW_LOCKS_EXCLUDED(send_mutex_);
 
+  // Thread safe. Queues a request without waiting for it to be sent. This
+  // allows a caller to queue requests in order while holding a lock, and then
+  // to wait for them after releasing it.
+  void QueueSendRequest(SendRequest& request) PW_LOCKS_EXCLUDED(send_mutex_);
+
+  // Thread safe. Queues a request ahead of all queued normal requests. Only
+  // use this for frames whose order relative to other frames does not matter,
+  // such as PING acknowledgements and WINDOW_UPDATE frames.
+  void QueueUrgentSendRequest(SendRequest& request)
+      PW_LOCKS_EXCLUDED(send_mutex_);
+
   // ThreadCore impl.
   void Run() override { send_dispatcher_.Run(); }
   // Call before attempting to join thread.
   void RequestStop() { send_dispatcher_.RequestStop(); }
 
  private:
-  struct SendRequest : public IntrusiveList<SendRequest>::Item {
-    SendRequest(span<ConstByteSpan> m) : messages(m) {}
-    sync::TimedThreadNotification notify;
-    Status status = OkStatus();
-    span<ConstByteSpan> messages;
-  };
-
-  std::optional<std::reference_wrapper<SendRequest>> NextSendRequest()
+  // Removes the next requests to send from the queue, up to
+  // kMaxCoalescedBuffers buffers in total. Returns the number of requests.
+  size_t NextSendRequests(span<SendRequest*> requests)
+      PW_LOCKS_EXCLUDED(send_mutex_);
+  void QueueSendRequest(SendRequest& request,
+                        IntrusiveList<SendRequest>& list)
       PW_LOCKS_EXCLUDED(send_mutex_);
-  void QueueSendRequest(SendRequest& request) PW_LOCKS_EXCLUDED(send_mutex_);
   void CancelSendRequest(SendRequest& request) PW_LOCKS_EXCLUDED(send_mutex_);
   void ProcessSendQueue(async::Context& context, Status status)
       PW_LOCKS_EXCLUDED(send_mutex_);
+  Status WriteRequests(span<SendRequest*> requests);
 
   stream::ReaderWriter& socket_;
   async::BasicDispatcher send_dispatcher_;
   async::Task send_task_;
   sync::Mutex send_mutex_;
+  IntrusiveList<SendRequest> urgent_send_requests_ PW_GUARDED_BY(send_mutex_);
   IntrusiveList<SendRequest> send_requests_ PW_GUARDED_BY(send_mutex_);
 };
 
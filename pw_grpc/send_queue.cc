@@ -16,15 +16,45 @@
 
 namespace pw::grpc {
 
-std::optional<std::reference_wrapper<SendQueue::SendRequest>>
-SendQueue::NextSendRequest() {
+size_t SendQueue::NextSendRequests(span<SendRequest*> requests) {
   std::lock_guard lock(send_mutex_);
-  if (send_requests_.empty()) {
-    return std::nullopt;
+  size_t count = 0;
+  size_t num_buffers = 0;
+  for (IntrusiveList<SendRequest>* list :
+       {&urgent_send_requests_, &send_requests_}) {
+    while (!list->empty() && count < requests.size()) {
+      SendRequest& front = list->front();
+      // A request with more buffers than a single write allows is sent on its
+      // own.
+      if (count != 0 &&
+          num_buffers + front.messages.size() > kMaxCoalescedBuffers) {
+        return count;
+      }
+      list->pop_front();
+      requests[count++] = &front;
+      num_buffers += front.messages.size();
+    }
   }
-  auto& front = send_requests_.front();
-  send_requests_.pop_front();
-  return front;
+  return count;
+}
+
+Status SendQueue::WriteRequests(span<SendRequest*> requests) {
+  std::array<ConstByteSpan, kMaxCoalescedBuffers> buffers;
+  size_t num_buffers = 0;
+  for (SendRequest* request : requests) {
+    if (num_buffers + request->messages.size() > buffers.size()) {
+      // Only possible for a single oversized request.
+      Status status;
+      for (auto message : request->messages) {
+        status.Update(socket_.Write(message));
+      }
+      return status;
+    }
+    for (auto message : request->messages) {
+      buffers[num_buffers++] = message;
+    }
+  }
+  return socket_.Write(span(buffers.data(), num_buffers));
 }
 
 void SendQueue::ProcessSendQueue(async::Context&, Status status) {
@@ -32,25 +62,38 @@ void SendQueue::ProcessSendQueue(async::Context&, Status status) {
     return;
   }
 
-  auto request = NextSendRequest();
-  while (request.has_value()) {
-    for (auto message : request->get().messages) {
-      request->get().status.Update(socket_.Write(message));
+  std::array<SendRequest*, kMaxCoalescedBuffers> requests;
+  size_t count = NextSendRequests(requests);
+  while (count != 0) {
+    // The requests are written together, so they share one status.
+    const Status write_status = WriteRequests(span(requests.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+      requests[i]->status.Update(write_status);
+      requests[i]->notify.release();
     }
-    request->get().notify.release();
-    request = NextSendRequest();
+    count = NextSendRequests(requests);
   }
 }
 
 void SendQueue::QueueSendRequest(SendRequest& request) {
+  QueueSendRequest(request, send_requests_);
+}
+
+void SendQueue::QueueUrgentSendRequest(SendRequest& request) {
+  QueueSendRequest(request, urgent_send_requests_);
+}
+
+void SendQueue::QueueSendRequest(SendRequest& request,
+                                 IntrusiveList<SendRequest>& list) {
   std::lock_guard lock(send_mutex_);
-  send_requests_.push_back(request);
+  list.push_back(request);
   send_dispatcher_.Cancel(send_task_);
   send_dispatcher_.Post(send_task_);
 }
 
 void SendQueue::CancelSendRequest(SendRequest& request) {
   std::lock_guard lock(send_mutex_);
+  urgent_send_requests_.remove(request);
   send_requests_.remove(request);
 }
 
@@ -59,12 +102,18 @@ Status SendQueue::SendBytes(ConstByteSpan message) {
   return SendBytesVector(messages);
 }
 
+Status SendQueue::SendUrgentBytes(ConstByteSpan message) {
+  std::array<ConstByteSpan, 1> messages = {message};
+  SendRequest request(messages);
+  QueueUrgentSendRequest(request);
+  return request.Wait();
+}
+
 Status SendQueue::SendBytesVector(span<ConstByteSpan> messages) {
   SendRequest request(messages);
   QueueSendRequest(request);
   // TODO: b/345088816 - Add timeout error support to this blocking call.
-  request.notify.acquire();
-  return request.status;
+  return request.Wait();
 }
 
 }  // namespace pw::grpc
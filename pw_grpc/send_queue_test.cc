@@ -0,0 +1,139 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_grpc/send_queue.h"
+
+#include <array>
+#include <vector>
+
+#include "pw_bytes/array.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::grpc {
+namespace {
+
+// A stream that records each vectored write.
+class RecordingStream : public stream::NonSeekableReaderWriter {
+ public:
+  const std::vector<std::byte>& data() const { return data_; }
+  size_t num_writes() const { return num_writes_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan) override { return StatusWithSize(0); }
+
+  Status DoWrite(ConstByteSpan data) override {
+    data_.insert(data_.end(), data.begin(), data.end());
+    return OkStatus();
+  }
+
+  Status DoWriteVectored(span<const ConstByteSpan> buffers) override {
+    ++num_writes_;
+    for (ConstByteSpan buffer : buffers) {
+      data_.insert(data_.end(), buffer.begin(), buffer.end());
+    }
+    return OkStatus();
+  }
+
+  std::vector<std::byte> data_;
+  size_t num_writes_ = 0;
+};
+
+class SendQueueTest : public ::testing::Test {
+ protected:
+  SendQueueTest() : send_queue_(stream_) {}
+
+  // Runs the send thread until all queued requests have been sent.
+  void SendAll(span<SendQueue::SendRequest*> requests) {
+    thread::Thread send_thread(context_.options(), send_queue_);
+    for (SendQueue::SendRequest* request : requests) {
+      EXPECT_EQ(request->Wait(), OkStatus());
+    }
+    send_queue_.RequestStop();
+    send_thread.join();
+  }
+
+  RecordingStream stream_;
+  SendQueue send_queue_;
+  thread::test::TestThreadContext context_;
+};
+
+TEST_F(SendQueueTest, CoalescesQueuedRequests) {
+  constexpr auto kFirst = bytes::Array<1, 2>();
+  constexpr auto kSecond = bytes::Array<3>();
+  constexpr auto kThird = bytes::Array<4, 5, 6>();
+  std::array<ConstByteSpan, 2> first = {span(kFirst).first(1),
+                                        span(kFirst).subspan(1)};
+  std::array<ConstByteSpan, 1> second = {kSecond};
+  std::array<ConstByteSpan, 1> third = {kThird};
+  SendQueue::SendRequest request1(first);
+  SendQueue::SendRequest request2(second);
+  SendQueue::SendRequest request3(third);
+  send_queue_.QueueSendRequest(request1);
+  send_queue_.QueueSendRequest(request2);
+  send_queue_.QueueSendRequest(request3);
+
+  std::array<SendQueue::SendRequest*, 3> requests = {
+      &request1, &request2, &request3};
+  SendAll(requests);
+
+  EXPECT_EQ(stream_.num_writes(), 1u);
+  constexpr auto kExpected = bytes::Array<1, 2, 3, 4, 5, 6>();
+  EXPECT_TRUE(std::equal(stream_.data().begin(),
+                         stream_.data().end(),
+                         kExpected.begin(),
+                         kExpected.end()));
+}
+
+TEST_F(SendQueueTest, UrgentRequestsAreSentFirst) {
+  constexpr auto kNormal = bytes::Array<1, 2>();
+  constexpr auto kUrgent = bytes::Array<3, 4>();
+  std::array<ConstByteSpan, 1> normal = {kNormal};
+  std::array<ConstByteSpan, 1> urgent = {kUrgent};
+  SendQueue::SendRequest normal_request(normal);
+  SendQueue::SendRequest urgent_request(urgent);
+  send_queue_.QueueSendRequest(normal_request);
+  send_queue_.QueueUrgentSendRequest(urgent_request);
+
+  std::array<SendQueue::SendRequest*, 2> requests = {&normal_request,
+                                                     &urgent_request};
+  SendAll(requests);
+
+  constexpr auto kExpected = bytes::Array<3, 4, 1, 2>();
+  EXPECT_TRUE(std::equal(stream_.data().begin(),
+                         stream_.data().end(),
+                         kExpected.begin(),
+                         kExpected.end()));
+}
+
+TEST_F(SendQueueTest, LimitsBuffersPerWrite) {
+  constexpr auto kData = bytes::Array<1>();
+  std::array<ConstByteSpan, SendQueue::kMaxCoalescedBuffers - 1> many;
+  many.fill(kData);
+  std::array<ConstByteSpan, 2> two = {kData, kData};
+  SendQueue::SendRequest request1(many);
+  SendQueue::SendRequest request2(two);
+  send_queue_.QueueSendRequest(request1);
+  send_queue_.QueueSendRequest(request2);
+
+  std::array<SendQueue::SendRequest*, 2> requests = {&request1, &request2};
+  SendAll(requests);
+
+  EXPECT_EQ(stream_.num_writes(), 2u);
+  EXPECT_EQ(stream_.data().size(), SendQueue::kMaxCoalescedBuffers + 1);
+}
+
+}  // namespace
+}  // namespace pw::grpc
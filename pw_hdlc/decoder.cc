@@ -14,6 +14,9 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "pw_assert/check.h"
 #include "pw_bytes/endian.h"
 #include "pw_hdlc/internal/protocol.h"
@@ -23,6 +26,37 @@
 using std::byte;
 
 namespace pw::hdlc {
+namespace {
+
+// Returns the number of leading bytes in data that are neither flag nor escape
+// bytes. Checks eight bytes at a time by testing whether the word XORed with
+// each control byte contains a zero byte.
+size_t CountUnescapedBytes(ConstByteSpan data) {
+  constexpr uint64_t kOnes = 0x0101010101010101u;
+  constexpr uint64_t kHighBits = 0x8080808080808080u;
+  constexpr uint64_t kFlags = kOnes * static_cast<uint8_t>(kFlag);
+  constexpr uint64_t kEscapes = kOnes * static_cast<uint8_t>(kEscape);
+
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= data.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data.data() + i, sizeof(word));
+
+    const uint64_t flags = word ^ kFlags;
+    const uint64_t escapes = word ^ kEscapes;
+    if ((((flags - kOnes) & ~flags) | ((escapes - kOnes) & ~escapes)) &
+        kHighBits) {
+      break;
+    }
+  }
+
+  while (i < data.size() && !NeedsEscaping(data[i])) {
+    ++i;
+  }
+  return i;
+}
+
+}  // namespace
 
 Result<Frame> Frame::Parse(ConstByteSpan frame) {
   uint64_t address;
@@ -100,6 +134,24 @@ Result<Frame> Decoder::Process(const byte new_byte) {
   PW_CRASH("Bad decoder state");
 }
 
+Result<Frame> Decoder::ProcessUntilFrame(ConstByteSpan data,
+                                         size_t& bytes_processed) {
+  bytes_processed = 0;
+  while (bytes_processed < data.size()) {
+    bytes_processed += ConsumeRun(data.subspan(bytes_processed));
+    if (bytes_processed == data.size()) {
+      break;
+    }
+
+    Result<Frame> result = Process(data[bytes_processed]);
+    bytes_processed += 1;
+    if (result.status() != Status::Unavailable()) {
+      return result;
+    }
+  }
+  return Status::Unavailable();
+}
+
 void Decoder::AppendByte(byte new_byte) {
   if (current_frame_size_ < max_size()) {
     buffer_[current_frame_size_] = new_byte;
@@ -118,6 +170,59 @@ void Decoder::AppendByte(byte new_byte) {
   current_frame_size_ += 1;
 }
 
+void Decoder::AppendBytes(ConstByteSpan run) {
+  // Short runs do not replace the whole FCS ring buffer.
+  if (run.size() < last_read_bytes_.size()) {
+    for (byte b : run) {
+      AppendByte(b);
+    }
+    return;
+  }
+
+  if (current_frame_size_ < max_size()) {
+    const size_t to_copy =
+        std::min(run.size(), max_size() - current_frame_size_);
+    std::memcpy(&buffer_[current_frame_size_], run.data(), to_copy);
+  }
+
+  // Every byte except the last four of the run is now part of the checksum:
+  // first the bytes held in the ring buffer, oldest first, then the run.
+  if (current_frame_size_ < last_read_bytes_.size()) {
+    fcs_.Update(span(last_read_bytes_).first(current_frame_size_));
+  } else {
+    fcs_.Update(span(last_read_bytes_).subspan(last_read_bytes_index_));
+    fcs_.Update(span(last_read_bytes_).first(last_read_bytes_index_));
+  }
+  fcs_.Update(run.first(run.size() - last_read_bytes_.size()));
+
+  std::memcpy(last_read_bytes_.data(),
+              run.last(last_read_bytes_.size()).data(),
+              last_read_bytes_.size());
+  last_read_bytes_index_ = 0;
+
+  current_frame_size_ += run.size();
+}
+
+size_t Decoder::ConsumeRun(ConstByteSpan data) {
+  switch (state_) {
+    case State::kInterFrame: {
+      // Bytes between frames are only counted until the next flag.
+      const size_t skipped = static_cast<size_t>(
+          std::find(data.begin(), data.end(), kFlag) - data.begin());
+      current_frame_size_ += skipped;
+      return skipped;
+    }
+    case State::kFrame: {
+      const size_t run = CountUnescapedBytes(data);
+      AppendBytes(data.first(run));
+      return run;
+    }
+    case State::kFrameEscape:
+      break;
+  }
+  return 0;
+}
+
 Status Decoder::CheckFrame() const {
   // Empty frames are not an error; repeated flag characters are okay.
   if (current_frame_size_ == 0u) {
@@ -0,0 +1,83 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Seed corpus of encoded HDLC data for the decoder, shared by the decoder's
+// unit tests and its corpus benchmark.
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/array.h"
+#include "pw_bytes/span.h"
+
+namespace pw::hdlc::test {
+
+// A single RPC request.
+inline constexpr auto kRpcRequestFrame = bytes::String(
+    "\x7e\xa5\x03\x08\x00\x10\x01\x1d\x19\xc6\x69\x21"
+    "\x25\x12\x45\x1e\xb7\x2a\x09\x08\x2a\x12\x05\x68"
+    "\x65\x6c\x6c\x6f\x4c\x12\xd0\xe9\x7e");
+
+// Several RPC responses received together, including escaped bytes.
+inline constexpr auto kRpcResponseFrames = bytes::String(
+    "\x7e\xa5\x03\x08\x00\x10\x01\x1d\xf3\x69\xcd\xd0"
+    "\x25\xec\x60\xbf\x15\x2a\x02\x08\x01\x74\x74\xa4"
+    "\xef\x7e\x7e\xa5\x03\x08\x00\x10\x01\x1d\xd3\x8e"
+    "\x64\xe1\x25\xac\x46\x6a\xa9\x2a\x06\x0a\x04\x7d"
+    "\x5e\x7d\x5d\x7d\x5e\x7d\x5d\xf6\x82\xb4\x2c\x7e"
+    "\x7e\xa5\x03\x08\x00\x10\x01\x1d\xd6\x67\x95\x62"
+    "\x25\xaf\x37\x70\xba\x2a\x03\x10\x80\x01\x1c\x8a"
+    "\xc1\x9e\x7e");
+
+// An RPC packet with a large payload.
+inline constexpr auto kLargeFrame = bytes::String(
+    "\x7e\xa5\x03\x08\x00\x10\x01\x1d\x05\x91\x05\xb1"
+    "\x25\x92\x40\xe4\x9c\x2a\x78\xfa\xd0\xcc\x46\x87"
+    "\x66\xcd\x60\x5b\x4d\x25\x32\x3c\x0c\x53\xf8\xd8"
+    "\xa7\xb6\x14\x09\x48\xa8\x4c\x6f\xfe\xfe\x36\x51"
+    "\x68\x2a\x2e\x94\xf9\xb6\x33\x5a\x0e\x10\xb6\xc7"
+    "\x3e\x95\xda\xfd\x25\x58\x51\xd2\xd8\xcf\x30\x64"
+    "\x38\xa9\x1c\xaa\x97\xaa\x30\x95\xa6\xab\x15\x37"
+    "\x33\x8b\xed\xe9\x6f\x38\x8f\xec\x56\xca\xea\x88"
+    "\x67\x1c\x6c\x1b\xe9\x26\x1a\x14\x03\x93\x88\x19"
+    "\xf2\xa2\x52\xf1\x3c\xa7\xa8\xe2\x5f\x16\xfd\xbf"
+    "\x0d\x24\xdc\x2e\x21\xfa\x63\xfb\xb8\x8e\x36\x8c"
+    "\xb1\xac\xa0\x34\xca\x2a\xe1\xb3\xd4\xb5\x37\x7e");
+
+// Plain text log messages on the default log address.
+inline constexpr auto kLogFrames = bytes::String(
+    "\x7e\x03\x03\x49\x4e\x46\x20\x20\x42\x6f\x6f\x74"
+    "\x69\x6e\x67\x20\x75\x70\x5d\xf7\xa2\x9b\x7e\x7e"
+    "\x03\x03\x57\x52\x4e\x20\x20\x42\x61\x74\x74\x65"
+    "\x72\x79\x20\x6c\x6f\x77\x3a\x20\x33\x25\xe0\xf1"
+    "\xe2\xd0\x7e");
+
+// A frame with a multi-byte address.
+inline constexpr auto kMultibyteAddressFrame = bytes::String(
+    "\x7e\xd0\x0f\x03\x00\x01\x02\x03\x04\x05\x06\x07"
+    "\xe9\x89\xd6\x41\x7e");
+
+inline constexpr std::array<ConstByteSpan, 5> kDecoderCorpus = {
+    kRpcRequestFrame,
+    kRpcResponseFrames,
+    kLargeFrame,
+    kLogFrames,
+    kMultibyteAddressFrame,
+};
+
+// Number of frames in kDecoderCorpus.
+inline constexpr size_t kDecoderCorpusFrames = 8;
+
+}  // namespace pw::hdlc::test
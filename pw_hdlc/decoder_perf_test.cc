@@ -0,0 +1,41 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+#include "decoder_corpus.h"
+#include "pw_assert/assert.h"
+#include "pw_fuzzer/corpus_benchmark.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::hdlc {
+namespace {
+
+void DecodeCorpus(perf_test::State& state) {
+  DecoderBuffer<256> decoder;
+  size_t frames = 0;
+  fuzzer::MeasureCorpus(state, test::kDecoderCorpus, [&](ConstByteSpan input) {
+    decoder.Process(input, [&frames](const Result<Frame>& result) {
+      if (result.ok()) {
+        frames += 1;
+      }
+    });
+  });
+  PW_ASSERT(frames % test::kDecoderCorpusFrames == 0);
+}
+
+PW_PERF_TEST(HdlcDecoderCorpus, DecodeCorpus);
+
+}  // namespace
+}  // namespace pw::hdlc
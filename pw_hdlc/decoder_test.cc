@@ -16,10 +16,14 @@
 
 #include <array>
 #include <cstddef>
+#include <cstring>
 
+#include "decoder_corpus.h"
 #include "pw_bytes/array.h"
 #include "pw_fuzzer/fuzztest.h"
+#include "pw_hdlc/encoder.h"
 #include "pw_hdlc/internal/protocol.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_unit_test/framework.h"
 
 namespace pw::hdlc {
@@ -154,6 +158,148 @@ TEST(Decoder, TooLargeForBuffer_DecodesNextFrame) {
   EXPECT_EQ(OkStatus(), decoder.Process(kFlag).status());
 }
 
+// Results of decoding a stream, recorded so that the bulk span decoder can be
+// compared with the byte-at-a-time decoder.
+struct DecodedFrames {
+  std::array<Status, 16> statuses;
+  std::array<size_t, 16> data_sizes;
+  std::array<uint64_t, 16> addresses;
+  size_t count = 0;
+
+  void Add(const Result<Frame>& result) {
+    ASSERT_LT(count, statuses.size());
+    statuses[count] = result.status();
+    data_sizes[count] = result.ok() ? result.value().data().size() : 0u;
+    addresses[count] = result.ok() ? result.value().address() : 0u;
+    count += 1;
+  }
+
+  bool operator==(const DecodedFrames& other) const {
+    if (count != other.count) {
+      return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (statuses[i] != other.statuses[i] ||
+          data_sizes[i] != other.data_sizes[i] ||
+          addresses[i] != other.addresses[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+TEST(Decoder, ProcessSpan_MatchesProcessByte) {
+  // Payloads with long unescaped runs, runs broken up by control bytes, and
+  // frames too large for the decoder buffer.
+  std::array<byte, 200> long_payload = bytes::Initialized<200>('a');
+  long_payload[37] = kFlag;
+  long_payload[38] = kEscape;
+  long_payload[120] = kFlag;
+
+  stream::MemoryWriterBuffer<1024> stream;
+  ASSERT_EQ(OkStatus(), WriteUIFrame(1, bytes::String("hello"), stream));
+  ASSERT_EQ(OkStatus(), stream.Write(bytes::String("garbage")));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(0x7e7e, long_payload, stream));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(2, span(long_payload).first(90), stream));
+  ASSERT_EQ(OkStatus(), stream.Write(bytes::String("~bad}}frame~~")));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(3, bytes::String("\x7d\x7e}~"), stream));
+  ASSERT_EQ(OkStatus(), WriteUIFrame(4, bytes::String("abc"), stream));
+  const ConstByteSpan data = stream.WrittenData();
+
+  DecodedFrames expected;
+  DecoderBuffer<100> byte_decoder;
+  for (byte b : data) {
+    auto result = byte_decoder.Process(b);
+    if (result.status() != Status::Unavailable()) {
+      expected.Add(result);
+    }
+  }
+  ASSERT_GE(expected.count, 6u);
+
+  for (size_t chunk_size : {size_t{1}, size_t{3}, size_t{7}, size_t{64},
+                            size_t{1024}}) {
+    DecodedFrames actual;
+    DecoderBuffer<100> span_decoder;
+    for (size_t i = 0; i < data.size(); i += chunk_size) {
+      span_decoder.Process(
+          data.subspan(i, std::min(chunk_size, data.size() - i)),
+          [&actual](const Result<Frame>& result) { actual.Add(result); });
+    }
+    EXPECT_TRUE(actual == expected);
+  }
+}
+
+TEST(Decoder, ProcessSpan_DecodesFrameContents) {
+  std::array<byte, 64> payload = bytes::Initialized<64>('x');
+  payload[20] = kEscape;
+
+  stream::MemoryWriterBuffer<256> stream;
+  ASSERT_EQ(OkStatus(), WriteUIFrame(123, payload, stream));
+
+  DecoderBuffer<128> decoder;
+  size_t frames = 0;
+  decoder.Process(stream.WrittenData(), [&](const Result<Frame>& result) {
+    ASSERT_EQ(OkStatus(), result.status());
+    EXPECT_EQ(result.value().address(), 123u);
+    ASSERT_EQ(result.value().data().size(), payload.size());
+    EXPECT_EQ(std::memcmp(result.value().data().data(),
+                          payload.data(),
+                          payload.size()),
+              0);
+    frames += 1;
+  });
+  EXPECT_EQ(frames, 1u);
+}
+
+TEST(Decoder, ProcessUntilFrame_StopsAfterEachFrame) {
+  stream::MemoryWriterBuffer<256> stream;
+  ASSERT_EQ(OkStatus(), WriteUIFrame(1, bytes::String("first"), stream));
+  const size_t first_frame_size = stream.bytes_written();
+  ASSERT_EQ(OkStatus(), WriteUIFrame(2, bytes::String("second"), stream));
+  ASSERT_EQ(OkStatus(), stream.Write(bytes::String("~partial")));
+  ConstByteSpan data = stream.WrittenData();
+
+  DecoderBuffer<64> decoder;
+  size_t bytes_processed;
+  Result<Frame> result = decoder.ProcessUntilFrame(data, bytes_processed);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(bytes_processed, first_frame_size);
+  EXPECT_EQ(result.value().address(), 1u);
+  data = data.subspan(bytes_processed);
+
+  result = decoder.ProcessUntilFrame(data, bytes_processed);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(result.value().address(), 2u);
+  EXPECT_EQ(std::memcmp(result.value().data().data(), "second", 6), 0);
+  data = data.subspan(bytes_processed);
+
+  result = decoder.ProcessUntilFrame(data, bytes_processed);
+  EXPECT_EQ(Status::Unavailable(), result.status());
+  EXPECT_EQ(bytes_processed, data.size());
+}
+
+TEST(Decoder, ProcessUntilFrame_ReportsErrors) {
+  DecoderBuffer<64> decoder;
+  size_t bytes_processed;
+  constexpr auto kBadFrame = bytes::String("~abcdefg~");
+  EXPECT_EQ(Status::DataLoss(),
+            decoder.ProcessUntilFrame(kBadFrame, bytes_processed).status());
+  EXPECT_EQ(bytes_processed, kBadFrame.size());
+}
+
+TEST(Decoder, Corpus_DecodesAllFrames) {
+  DecoderBuffer<256> decoder;
+  size_t frames = 0;
+  for (ConstByteSpan input : test::kDecoderCorpus) {
+    decoder.Process(input, [&frames](const Result<Frame>& result) {
+      EXPECT_EQ(OkStatus(), result.status());
+      frames += 1;
+    });
+  }
+  EXPECT_EQ(frames, test::kDecoderCorpusFrames);
+}
+
 void ProcessNeverCrashes(ConstByteSpan data) {
   DecoderBuffer<1024> decoder;
   for (byte b : data) {
@@ -166,5 +312,11 @@ void ProcessNeverCrashes(ConstByteSpan data) {
 FUZZ_TEST(Decoder, ProcessNeverCrashes)
     .WithDomains(VectorOf<1024>(Arbitrary<byte>()));
 
+TEST(Decoder, Corpus_ProcessNeverCrashes) {
+  for (ConstByteSpan input : test::kDecoderCorpus) {
+    ProcessNeverCrashes(input);
+  }
+}
+
 }  // namespace
 }  // namespace pw::hdlc
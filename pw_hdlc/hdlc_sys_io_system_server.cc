@@ -20,6 +20,7 @@
 #include "pw_hdlc/encoded_size.h"
 #include "pw_hdlc/rpc_channel.h"
 #include "pw_log_basic/log_basic.h"
+#include "pw_rpc/latency.h"
 #include "pw_rpc_system_server/rpc_server.h"
 #include "pw_status/try.h"
 #include "pw_stream/sys_io_stream.h"
@@ -69,6 +70,7 @@ Status Start() {
     if (auto result = decoder.Process(byte); result.ok()) {
       hdlc::Frame& frame = result.value();
       if (frame.address() == hdlc::kDefaultRpcAddress) {
+        RecordFrameReceived();
         PW_TRY(server.ProcessPacket(frame.data()));
       }
     }
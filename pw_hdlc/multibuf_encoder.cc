@@ -0,0 +1,190 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_hdlc/multibuf_encoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "pw_bytes/endian.h"
+#include "pw_checksum/crc32.h"
+#include "pw_hdlc/encoded_size.h"
+#include "pw_hdlc/internal/protocol.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw::hdlc {
+namespace {
+
+using multibuf::MultiBuf;
+
+// Holds the address and control fields of a UI frame.
+class FrameHeader {
+ public:
+  explicit FrameHeader(uint64_t address) {
+    size_ = varint::Encode(address, buffer_, kAddressFormat);
+    if (size_ != 0) {
+      buffer_[size_++] = UFrameControl::UnnumberedInformation().data();
+    }
+  }
+
+  bool ok() const { return size_ != 0; }
+
+  ConstByteSpan bytes() const { return span(buffer_).first(size_); }
+
+ private:
+  std::array<std::byte, kMaxAddressSize + kControlSize> buffer_;
+  size_t size_;
+};
+
+// Copies bytes into the chunks of a MultiBuf in order, crossing chunk
+// boundaries as needed.
+class ChunkWriter {
+ public:
+  explicit ChunkWriter(MultiBuf& output)
+      : chunk_(output.ChunkBegin()), end_(output.ChunkEnd()) {}
+
+  Status Write(ConstByteSpan data) {
+    while (!data.empty()) {
+      while (chunk_ != end_ && offset_ == chunk_->size()) {
+        ++chunk_;
+        offset_ = 0;
+      }
+      if (chunk_ == end_) {
+        return Status::ResourceExhausted();
+      }
+
+      const size_t to_copy = std::min(chunk_->size() - offset_, data.size());
+      std::memcpy(chunk_->data() + offset_, data.data(), to_copy);
+      data = data.subspan(to_copy);
+      offset_ += to_copy;
+      written_ += to_copy;
+    }
+    return OkStatus();
+  }
+
+  Status Write(std::byte b) { return Write(span(&b, 1)); }
+
+  size_t written() const { return written_; }
+
+ private:
+  MultiBuf::ChunkIterator chunk_;
+  MultiBuf::ChunkIterator end_;
+  size_t offset_ = 0;
+  size_t written_ = 0;
+};
+
+// Writes data with HDLC escaping, copying unescaped runs in bulk.
+Status WriteEscaped(ConstByteSpan data, ChunkWriter& writer) {
+  auto begin = data.begin();
+  while (true) {
+    auto end = std::find_if(begin, data.end(), NeedsEscaping);
+    if (Status status = writer.Write(span(begin, end)); !status.ok()) {
+      return status;
+    }
+    if (end == data.end()) {
+      return OkStatus();
+    }
+    const auto& escaped = *end == kFlag ? kEscapedFlag : kEscapedEscape;
+    if (Status status = writer.Write(escaped); !status.ok()) {
+      return status;
+    }
+    begin = end + 1;
+  }
+}
+
+template <typename Payload>
+size_t CalculateEncodedSize(uint64_t address, const Payload& payload) {
+  const FrameHeader header(address);
+  checksum::Crc32 fcs;
+  fcs.Update(header.bytes());
+
+  size_t size = 2 * sizeof(kFlag) + EscapedSize(header.bytes());
+  for (const auto& piece : payload) {
+    const ConstByteSpan data = piece;
+    fcs.Update(data);
+    size += EscapedSize(data);
+  }
+  return size +
+         EscapedSize(bytes::CopyInOrder(endian::little, fcs.value()));
+}
+
+template <typename Payload>
+Status Encode(uint64_t address, const Payload& payload, MultiBuf& output) {
+  const FrameHeader header(address);
+  if (!header.ok()) {
+    return Status::InvalidArgument();
+  }
+
+  ChunkWriter writer(output);
+  checksum::Crc32 fcs;
+  fcs.Update(header.bytes());
+
+  PW_TRY(writer.Write(kFlag));
+  PW_TRY(WriteEscaped(header.bytes(), writer));
+  for (const auto& piece : payload) {
+    const ConstByteSpan data = piece;
+    fcs.Update(data);
+    PW_TRY(WriteEscaped(data, writer));
+  }
+  PW_TRY(
+      WriteEscaped(bytes::CopyInOrder(endian::little, fcs.value()), writer));
+  PW_TRY(writer.Write(kFlag));
+
+  output.Truncate(writer.written());
+  return OkStatus();
+}
+
+}  // namespace
+
+size_t MaxEncodedUIFrameSize(uint64_t address, size_t payload_size) {
+  const FrameHeader header(address);
+  return 2 * sizeof(kFlag) + EscapedSize(header.bytes()) + payload_size * 2 +
+         kMaxEscapedFcsSize;
+}
+
+size_t EncodedUIFrameSize(uint64_t address, const MultiBuf& payload) {
+  return CalculateEncodedSize(address, payload.Chunks());
+}
+
+size_t EncodedUIFrameSize(uint64_t address, span<const ConstByteSpan> payload) {
+  return CalculateEncodedSize(address, payload);
+}
+
+Status EncodeUIFrame(uint64_t address,
+                     const MultiBuf& payload,
+                     MultiBuf& output) {
+  return Encode(address, payload.Chunks(), output);
+}
+
+Status EncodeUIFrame(uint64_t address,
+                     span<const ConstByteSpan> payload,
+                     MultiBuf& output) {
+  return Encode(address, payload, output);
+}
+
+Result<MultiBuf> EncodeUIFrame(uint64_t address,
+                               const MultiBuf& payload,
+                               multibuf::MultiBufAllocator& allocator) {
+  std::optional<MultiBuf> output =
+      allocator.Allocate(EncodedUIFrameSize(address, payload));
+  if (!output.has_value()) {
+    return Status::ResourceExhausted();
+  }
+  PW_TRY(EncodeUIFrame(address, payload, *output));
+  return std::move(*output);
+}
+
+}  // namespace pw::hdlc
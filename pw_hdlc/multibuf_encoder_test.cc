@@ -0,0 +1,176 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_hdlc/multibuf_encoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <optional>
+
+#include "pw_bytes/array.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_hdlc/internal/protocol.h"
+#include "pw_multibuf/simple_allocator_for_test.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::hdlc {
+namespace {
+
+using multibuf::MultiBuf;
+
+constexpr uint64_t kAddress = 0x3fff;
+
+// Payload with bytes that need escaping, including at a chunk boundary.
+constexpr auto kPayload =
+    bytes::Concat(bytes::String("hello"),
+                  kFlag,
+                  bytes::String("world"),
+                  kEscape,
+                  kFlag,
+                  bytes::String("0123456789abcdef0123456789"));
+
+class MultiBufEncoderTest : public ::testing::Test {
+ protected:
+  // Returns the frame produced by the stream encoder, for comparison.
+  ConstByteSpan ExpectedFrame(uint64_t address, ConstByteSpan payload) {
+    EXPECT_EQ(OkStatus(), WriteUIFrame(address, payload, expected_));
+    return expected_.WrittenData();
+  }
+
+  // Allocates a MultiBuf made of chunks of the given sizes.
+  MultiBuf AllocateChunks(std::initializer_list<size_t> sizes) {
+    MultiBuf buffer;
+    for (size_t size : sizes) {
+      std::optional<MultiBuf> chunk = allocator_.AllocateContiguous(size);
+      if (!chunk.has_value()) {
+        ADD_FAILURE();
+        break;
+      }
+      buffer.PushSuffix(std::move(*chunk));
+    }
+    return buffer;
+  }
+
+  MultiBuf PayloadIn(std::initializer_list<size_t> sizes) {
+    MultiBuf payload = AllocateChunks(sizes);
+    EXPECT_EQ(payload.size(), kPayload.size());
+    EXPECT_EQ(OkStatus(), payload.CopyFrom(kPayload).status());
+    return payload;
+  }
+
+  static bool Equal(const MultiBuf& actual, ConstByteSpan expected) {
+    if (actual.size() != expected.size()) {
+      return false;
+    }
+    return std::equal(actual.begin(), actual.end(), expected.begin());
+  }
+
+  multibuf::test::SimpleAllocatorForTest<1024, 4096> allocator_;
+  stream::MemoryWriterBuffer<128> expected_;
+};
+
+TEST_F(MultiBufEncoderTest, EncodedSizeIsExact) {
+  const ConstByteSpan expected = ExpectedFrame(kAddress, kPayload);
+  EXPECT_EQ(EncodedUIFrameSize(kAddress, PayloadIn({kPayload.size()})),
+            expected.size());
+
+  const std::array<ConstByteSpan, 2> pieces = {span(kPayload).first(6),
+                                               span(kPayload).subspan(6)};
+  EXPECT_EQ(EncodedUIFrameSize(kAddress, pieces), expected.size());
+}
+
+TEST_F(MultiBufEncoderTest, MaxEncodedSizeIsUpperBound) {
+  constexpr auto kAllFlags = bytes::Initialized<16>(0x7e);
+  for (ConstByteSpan payload : {ConstByteSpan(kPayload),
+                                ConstByteSpan(kAllFlags),
+                                ConstByteSpan()}) {
+    expected_.clear();
+    const ConstByteSpan expected = ExpectedFrame(kAddress, payload);
+    EXPECT_GE(MaxEncodedUIFrameSize(kAddress, payload.size()),
+              expected.size());
+  }
+}
+
+TEST_F(MultiBufEncoderTest, EncodesIntoWorstCaseBuffer) {
+  const ConstByteSpan expected = ExpectedFrame(kAddress, kPayload);
+  MultiBuf payload = PayloadIn({kPayload.size()});
+
+  MultiBuf output =
+      AllocateChunks({MaxEncodedUIFrameSize(kAddress, kPayload.size())});
+  ASSERT_EQ(OkStatus(), EncodeUIFrame(kAddress, payload, output));
+  EXPECT_TRUE(Equal(output, expected));
+}
+
+TEST_F(MultiBufEncoderTest, MatchesStreamEncoder_ContiguousOutput) {
+  const ConstByteSpan expected = ExpectedFrame(kAddress, kPayload);
+  MultiBuf payload = PayloadIn({kPayload.size()});
+
+  std::optional<MultiBuf> output = allocator_.AllocateContiguous(128);
+  ASSERT_TRUE(output.has_value());
+  ASSERT_EQ(OkStatus(), EncodeUIFrame(kAddress, payload, *output));
+  EXPECT_TRUE(Equal(*output, expected));
+}
+
+TEST_F(MultiBufEncoderTest, MatchesStreamEncoder_ScatteredPayloadAndOutput) {
+  const ConstByteSpan expected = ExpectedFrame(kAddress, kPayload);
+  MultiBuf payload = PayloadIn({5, 1, 7, kPayload.size() - 13});
+
+  MultiBuf output = AllocateChunks({3, 1, 10, 64});
+  ASSERT_EQ(OkStatus(), EncodeUIFrame(kAddress, payload, output));
+  EXPECT_TRUE(Equal(output, expected));
+}
+
+TEST_F(MultiBufEncoderTest, MatchesStreamEncoder_SpanList) {
+  const ConstByteSpan expected = ExpectedFrame(kAddress, kPayload);
+  const std::array<ConstByteSpan, 3> pieces = {span(kPayload).first(5),
+                                               span(kPayload).subspan(5, 1),
+                                               span(kPayload).subspan(6)};
+
+  MultiBuf output = AllocateChunks({16, 64});
+  ASSERT_EQ(OkStatus(), EncodeUIFrame(kAddress, pieces, output));
+  EXPECT_TRUE(Equal(output, expected));
+}
+
+TEST_F(MultiBufEncoderTest, EmptyPayload) {
+  const ConstByteSpan expected = ExpectedFrame(1, ConstByteSpan());
+
+  MultiBuf output = AllocateChunks({16});
+  ASSERT_EQ(OkStatus(), EncodeUIFrame(1, MultiBuf(), output));
+  EXPECT_TRUE(Equal(output, expected));
+}
+
+TEST_F(MultiBufEncoderTest, OutputTooSmall) {
+  const size_t frame_size =
+      EncodedUIFrameSize(kAddress, PayloadIn({kPayload.size()}));
+  MultiBuf payload = PayloadIn({kPayload.size()});
+
+  MultiBuf output = AllocateChunks({4, frame_size - 5});
+  EXPECT_EQ(Status::ResourceExhausted(),
+            EncodeUIFrame(kAddress, payload, output));
+}
+
+TEST_F(MultiBufEncoderTest, AllocatesExactSize) {
+  const ConstByteSpan expected = ExpectedFrame(kAddress, kPayload);
+  MultiBuf payload = PayloadIn({9, kPayload.size() - 9});
+
+  Result<MultiBuf> frame = EncodeUIFrame(kAddress, payload, allocator_);
+  ASSERT_EQ(OkStatus(), frame.status());
+  EXPECT_TRUE(Equal(*frame, expected));
+}
+
+}  // namespace
+}  // namespace pw::hdlc
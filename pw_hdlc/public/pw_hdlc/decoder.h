@@ -112,16 +112,37 @@ class Decoder {
 
   /// @brief Processes a span of data and calls the provided callback with each
   /// frame or error.
+  ///
+  /// Runs of bytes that cannot change the decoder's state, such as unescaped
+  /// frame contents, are consumed in bulk. Only flag and escape bytes go
+  /// through the byte-at-a-time state machine.
   template <typename F, typename... Args>
   void Process(ConstByteSpan data, F&& callback, Args&&... args) {
-    for (std::byte b : data) {
-      auto result = Process(b);
+    while (!data.empty()) {
+      size_t bytes_processed;
+      auto result = ProcessUntilFrame(data, bytes_processed);
+      data = data.subspan(bytes_processed);
       if (result.status() != Status::Unavailable()) {
         callback(std::forward<Args>(args)..., result);
       }
     }
   }
 
+  /// @brief Processes a span of data up to and including the byte that
+  /// completes the next frame or error.
+  ///
+  /// Like the callback overload, runs of bytes that cannot change the
+  /// decoder's state are consumed in bulk. Stopping at each frame allows the
+  /// caller to handle the ``Frame`` before the rest of ``data`` is processed.
+  ///
+  /// @param[out] bytes_processed The number of bytes of ``data`` that were
+  /// consumed. All of ``data`` is consumed unless a frame or error completes.
+  ///
+  /// @returns The same as the single-byte ``Process()``, for the last byte
+  /// processed. ``UNAVAILABLE`` means all of ``data`` was consumed without
+  /// completing a frame.
+  Result<Frame> ProcessUntilFrame(ConstByteSpan data, size_t& bytes_processed);
+
   // Returns the maximum size of the Decoder's frame buffer.
   size_t max_size() const { return buffer_.size(); }
 
@@ -147,6 +168,13 @@ class Decoder {
 
   void AppendByte(std::byte new_byte);
 
+  // Appends a run of unescaped frame bytes, updating the FCS over the run.
+  void AppendBytes(ConstByteSpan run);
+
+  // Consumes leading bytes of data that do not complete a frame or change the
+  // decoder state. Returns the number of bytes consumed.
+  size_t ConsumeRun(ConstByteSpan data);
+
   Status CheckFrame() const;
 
   bool VerifyFrameCheckSequence() const;
@@ -0,0 +1,99 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_multibuf/allocator.h"
+#include "pw_multibuf/multibuf.h"
+#include "pw_result/result.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw::hdlc {
+
+/// @brief Returns the exact on-the-wire size of an HDLC UI frame.
+///
+/// Unlike ``MaxEncodedFrameSize()``, this accounts for the escaping of the
+/// address, control field, and frame check sequence, so it requires a pass
+/// over the payload to compute the CRC-32.
+size_t EncodedUIFrameSize(uint64_t address, const multibuf::MultiBuf& payload);
+
+/// Returns the exact size of an HDLC UI frame whose payload is gathered from a
+/// list of spans.
+size_t EncodedUIFrameSize(uint64_t address, span<const ConstByteSpan> payload);
+
+/// @brief Returns an upper bound on the on-the-wire size of an HDLC UI frame
+/// with a payload of ``payload_size`` bytes.
+///
+/// The address and control fields are measured exactly, while every payload
+/// and frame check sequence byte is assumed to need escaping. Computing this
+/// does not read the payload, so a buffer of this size can be allocated and
+/// the frame encoded into it in a single pass; ``EncodeUIFrame()`` truncates
+/// the buffer to the actual frame size.
+size_t MaxEncodedUIFrameSize(uint64_t address, size_t payload_size);
+
+/// @brief Encodes an HDLC UI frame directly into the chunks of a ``MultiBuf``.
+///
+/// The payload is gathered from each of its chunks. Runs of bytes that do not
+/// need escaping are copied with a single ``memcpy`` each, so no per-byte
+/// ``pw::stream`` calls are made. ``output`` may span several chunks, such as
+/// a chain of DMA descriptors; on success, it is truncated to the frame size.
+///
+/// @returns @rst
+///
+/// .. pw-status-codes::
+///
+///    OK: The frame was encoded into ``output``.
+///
+///    RESOURCE_EXHAUSTED: ``output`` is smaller than
+///    ``EncodedUIFrameSize()``. Its contents are unspecified.
+///
+///    INVALID_ARGUMENT: The address could not be encoded.
+///
+/// @endrst
+Status EncodeUIFrame(uint64_t address,
+                     const multibuf::MultiBuf& payload,
+                     multibuf::MultiBuf& output);
+
+/// Encodes an HDLC UI frame whose payload is gathered from a list of spans.
+/// Otherwise identical to the ``MultiBuf`` payload overload.
+Status EncodeUIFrame(uint64_t address,
+                     span<const ConstByteSpan> payload,
+                     multibuf::MultiBuf& output);
+
+/// @brief Allocates a ``MultiBuf`` of exactly the encoded size and encodes an
+/// HDLC UI frame into it.
+///
+/// The allocation is not required to be contiguous.
+///
+/// @returns @rst
+///
+/// .. pw-status-codes::
+///
+///    OK: Returns the encoded frame.
+///
+///    RESOURCE_EXHAUSTED: The allocator could not provide the buffer.
+///
+///    INVALID_ARGUMENT: The address could not be encoded.
+///
+/// @endrst
+Result<multibuf::MultiBuf> EncodeUIFrame(
+    uint64_t address,
+    const multibuf::MultiBuf& payload,
+    multibuf::MultiBufAllocator& allocator);
+
+}  // namespace pw::hdlc
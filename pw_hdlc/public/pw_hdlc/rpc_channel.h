@@ -20,6 +20,8 @@
 #include "pw_hdlc/encoder.h"
 #include "pw_rpc/channel.h"
 #include "pw_span/span.h"
+#include "pw_status/try.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_stream/stream.h"
 
 namespace pw::hdlc {
@@ -78,4 +80,78 @@ class FixedMtuChannelOutput : public RpcChannelOutput {
   size_t MaximumTransmissionUnit() override { return MaxSafePayloadSize(); }
 };
 
+// A ChannelOutput that coalesces HDLC-encoded RPC packets into one buffer and
+// writes several frames to the stream at once. This reduces the per-write cost
+// of transports such as UARTs when an RPC sends many small packets, e.g. a
+// server stream. Each packet is still its own HDLC frame, so receivers handle
+// the output like any other HDLC stream.
+//
+// Buffered frames are written when:
+//
+//   - the next frame would not fit in the buffer,
+//   - the buffered frames reach flush_threshold_bytes, or
+//   - Flush() is called.
+//
+// Packets may stay buffered until one of these happens, so Flush() should be
+// called regularly, such as once per iteration of the loop that processes RPC
+// packets. Frames that are too large for the buffer are written directly.
+//
+// WARNING: Like RpcChannelOutput, this ChannelOutput is not thread-safe.
+// Flush() must not be called concurrently with pw_rpc sending packets.
+template <size_t kBufferSizeBytes>
+class BatchingRpcChannelOutput : public rpc::ChannelOutput {
+ public:
+  constexpr BatchingRpcChannelOutput(
+      stream::Writer& writer,
+      uint64_t address,
+      const char* channel_name,
+      size_t flush_threshold_bytes = kBufferSizeBytes)
+      : ChannelOutput(channel_name),
+        writer_(writer),
+        address_(address),
+        flush_threshold_bytes_(flush_threshold_bytes),
+        buffer_{} {}
+
+  Status Send(span<const std::byte> buffer) override {
+    const size_t max_frame_size = hdlc::MaxEncodedFrameSize(address_, buffer);
+    if (max_frame_size > buffer_.size() - buffered_bytes_) {
+      PW_TRY(Flush());
+    }
+
+    if (max_frame_size > buffer_.size()) {
+      return hdlc::WriteUIFrame(address_, buffer, writer_);
+    }
+
+    stream::MemoryWriter frame_writer(
+        span(buffer_).subspan(buffered_bytes_));
+    PW_TRY(hdlc::WriteUIFrame(address_, buffer, frame_writer));
+    buffered_bytes_ += frame_writer.bytes_written();
+
+    if (buffered_bytes_ >= flush_threshold_bytes_) {
+      return Flush();
+    }
+    return OkStatus();
+  }
+
+  // Writes any buffered frames to the stream.
+  Status Flush() {
+    if (buffered_bytes_ == 0) {
+      return OkStatus();
+    }
+    const size_t size = buffered_bytes_;
+    buffered_bytes_ = 0;
+    return writer_.Write(span(buffer_).first(size));
+  }
+
+  // Returns the number of encoded bytes waiting to be written.
+  size_t buffered_bytes() const { return buffered_bytes_; }
+
+ private:
+  stream::Writer& writer_;
+  const uint64_t address_;
+  const size_t flush_threshold_bytes_;
+  size_t buffered_bytes_ = 0;
+  std::array<std::byte, kBufferSizeBytes> buffer_;
+};
+
 }  // namespace pw::hdlc
@@ -18,12 +18,10 @@
 
 #include <algorithm>
 
-#include "pw_hdlc/encoder.h"
+#include "pw_hdlc/multibuf_encoder.h"
 #include "pw_log/log.h"
 #include "pw_multibuf/multibuf.h"
-#include "pw_multibuf/stream.h"
 #include "pw_result/result.h"
-#include "pw_stream/null_stream.h"
 
 namespace pw::hdlc {
 
@@ -33,55 +31,32 @@ using ::pw::async2::Poll;
 using ::pw::async2::Ready;
 using ::pw::channel::ByteReaderWriter;
 using ::pw::channel::DatagramReaderWriter;
-using ::pw::multibuf::Chunk;
 using ::pw::multibuf::MultiBuf;
-using ::pw::stream::CountingNullStream;
 
 namespace {
 
-/// HDLC encodes the contents of ``payload`` to ``writer``.
-Status WriteMultiBufUIFrame(uint64_t address,
-                            const MultiBuf& payload,
-                            stream::Writer& writer) {
-  Encoder encoder(writer);
-  if (Status status = encoder.StartUnnumberedFrame(address); !status.ok()) {
-    return status;
-  }
-  for (const Chunk& chunk : payload.Chunks()) {
-    if (Status status = encoder.WriteData(chunk); !status.ok()) {
-      return status;
-    }
-  }
-  return encoder.FinishFrame();
-}
-
-/// Calculates the size of ``payload`` once HDLC-encoded.
-Result<size_t> CalculateSizeOnceEncoded(uint64_t address,
-                                        const MultiBuf& payload) {
-  CountingNullStream null_stream;
-  Status encode_status = WriteMultiBufUIFrame(address, payload, null_stream);
-  if (!encode_status.ok()) {
-    return encode_status;
-  }
-  return null_stream.bytes_written();
-}
-
 /// Attempts to decode a frame from ``data``, advancing ``data`` forwards by
 /// any bytes that are consumed.
 std::optional<Frame> DecodeFrame(Decoder& decoder, MultiBuf& data) {
   size_t processed = 0;
-  for (std::byte byte : data) {
-    Result<Frame> frame_result = decoder.Process(byte);
-    ++processed;
-    if (frame_result.status().IsUnavailable()) {
-      // No frame is yet available.
-    } else if (frame_result.ok()) {
-      data.DiscardPrefix(processed);
-      return std::move(*frame_result);
-    } else if (frame_result.status().IsDataLoss()) {
-      PW_LOG_ERROR("Discarding invalid incoming HDLC frame.");
-    } else if (frame_result.status().IsResourceExhausted()) {
-      PW_LOG_ERROR("Discarding incoming HDLC frame: too large for buffer.");
+  for (const multibuf::Chunk& chunk : data.Chunks()) {
+    ConstByteSpan bytes(chunk.data(), chunk.size());
+    while (!bytes.empty()) {
+      size_t bytes_processed;
+      Result<Frame> frame_result =
+          decoder.ProcessUntilFrame(bytes, bytes_processed);
+      bytes = bytes.subspan(bytes_processed);
+      processed += bytes_processed;
+      if (frame_result.status().IsUnavailable()) {
+        // No frame is yet available.
+      } else if (frame_result.ok()) {
+        data.DiscardPrefix(processed);
+        return std::move(*frame_result);
+      } else if (frame_result.status().IsDataLoss()) {
+        PW_LOG_ERROR("Discarding invalid incoming HDLC frame.");
+      } else if (frame_result.status().IsResourceExhausted()) {
+        PW_LOG_ERROR("Discarding incoming HDLC frame: too large for buffer.");
+      }
     }
   }
   data.DiscardPrefix(processed);
@@ -264,20 +239,13 @@ void Router::WriteOutgoingMessages(Context& cx) {
       return;
     }
     if (!outgoing_allocation_future_.has_value()) {
-      Result<size_t> encoded_size = CalculateSizeOnceEncoded(
-          address_to_encode_and_send_to_, *buffer_to_encode_and_send_);
-      if (!encoded_size.ok()) {
-        PW_LOG_ERROR(
-            "Unable to compute size of encoded packet for outgoing buffer of "
-            "size %zu destined for outgoing HDLC address %" PRIu64
-            ". Packet will be discarded.",
-            buffer_to_encode_and_send_->size(),
-            address_to_encode_and_send_to_);
-        buffer_to_encode_and_send_ = std::nullopt;
-        continue;
-      }
+      // Allocate for the worst case so that the frame is escaped in a single
+      // pass. The encoder truncates the buffer to the encoded size.
+      const size_t max_encoded_size =
+          MaxEncodedUIFrameSize(address_to_encode_and_send_to_,
+                                buffer_to_encode_and_send_->size());
       outgoing_allocation_future_ =
-          io_channel_.GetWriteAllocator().AllocateAsync(*encoded_size);
+          io_channel_.GetWriteAllocator().AllocateAsync(max_encoded_size);
     }
     Poll<std::optional<MultiBuf>> maybe_write_buffer =
         outgoing_allocation_future_->Pend(cx);
@@ -300,10 +268,9 @@ void Router::WriteOutgoingMessages(Context& cx) {
       continue;
     }
     MultiBuf write_buffer = std::move(**maybe_write_buffer);
-    Status encode_status =
-        WriteMultiBufUIFrame(address_to_encode_and_send_to_,
-                             *buffer_to_encode_and_send_,
-                             pw::multibuf::Stream(write_buffer));
+    Status encode_status = EncodeUIFrame(address_to_encode_and_send_to_,
+                                         *buffer_to_encode_and_send_,
+                                         write_buffer);
     buffer_to_encode_and_send_ = std::nullopt;
     if (!encode_status.ok()) {
       PW_LOG_ERROR(
@@ -313,12 +280,13 @@ void Router::WriteOutgoingMessages(Context& cx) {
           encode_status.code());
       continue;
     }
+    const size_t frame_size = write_buffer.size();
     Status write_status = io_channel_.Write(std::move(write_buffer)).status();
     if (!write_status.ok()) {
       PW_LOG_ERROR(
           "Failed to write a buffer of size %zu destined for outgoing HDLC "
           "address %" PRIu64 ". Status: %d",
-          buffer_size,
+          frame_size,
           address_to_encode_and_send_to_,
           write_status.code());
     }
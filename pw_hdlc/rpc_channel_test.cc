@@ -152,5 +152,91 @@ TEST(RpcChannelOutputBuffer, MultibyteAddress) {
       0);
 }
 
+// Records how many writes are made to the underlying stream.
+class CountingWriter : public stream::NonSeekableWriter {
+ public:
+  size_t writes() const { return writes_; }
+  const stream::MemoryWriterBuffer<256>& data() const { return data_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return data_.Write(data);
+  }
+
+  size_t writes_ = 0;
+  stream::MemoryWriterBuffer<256> data_;
+};
+
+constexpr auto kExpectedFrame = bytes::Concat(
+    kFlag, kEncodedAddress, kControl, 'A', uint32_t{0x653c9e82}, kFlag);
+
+constexpr auto kOneBytePayload = bytes::Array<'A'>();
+
+TEST(BatchingRpcChannelOutput, FramesBufferedUntilFlush) {
+  CountingWriter writer;
+  BatchingRpcChannelOutput<64> output(writer, kAddress, "Batching");
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(OkStatus(), output.Send(kOneBytePayload));
+  }
+  EXPECT_EQ(writer.writes(), 0u);
+  EXPECT_EQ(output.buffered_bytes(), 3 * kExpectedFrame.size());
+
+  EXPECT_EQ(OkStatus(), output.Flush());
+  EXPECT_EQ(output.buffered_bytes(), 0u);
+  ASSERT_EQ(writer.writes(), 1u);
+  ASSERT_EQ(writer.data().bytes_written(), 3 * kExpectedFrame.size());
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(std::memcmp(writer.data().data() + i * kExpectedFrame.size(),
+                          kExpectedFrame.data(),
+                          kExpectedFrame.size()),
+              0);
+  }
+
+  EXPECT_EQ(OkStatus(), output.Flush());
+  EXPECT_EQ(writer.writes(), 1u);
+}
+
+TEST(BatchingRpcChannelOutput, FlushesAtThreshold) {
+  CountingWriter writer;
+  BatchingRpcChannelOutput<64> output(
+      writer, kAddress, "Batching", 2 * kExpectedFrame.size());
+
+  EXPECT_EQ(OkStatus(), output.Send(kOneBytePayload));
+  EXPECT_EQ(writer.writes(), 0u);
+  EXPECT_EQ(OkStatus(), output.Send(kOneBytePayload));
+  EXPECT_EQ(writer.writes(), 1u);
+  EXPECT_EQ(writer.data().bytes_written(), 2 * kExpectedFrame.size());
+  EXPECT_EQ(output.buffered_bytes(), 0u);
+}
+
+TEST(BatchingRpcChannelOutput, FlushesWhenNextFrameDoesNotFit) {
+  constexpr size_t kBufferSize =
+      MaxEncodedFrameSize(kAddress, kOneBytePayload) + 5;
+  CountingWriter writer;
+  BatchingRpcChannelOutput<kBufferSize> output(writer, kAddress, "Batching");
+
+  EXPECT_EQ(OkStatus(), output.Send(kOneBytePayload));
+  EXPECT_EQ(writer.writes(), 0u);
+  EXPECT_EQ(OkStatus(), output.Send(kOneBytePayload));
+  EXPECT_EQ(writer.writes(), 1u);
+  EXPECT_EQ(writer.data().bytes_written(), kExpectedFrame.size());
+  EXPECT_EQ(output.buffered_bytes(), kExpectedFrame.size());
+}
+
+TEST(BatchingRpcChannelOutput, OversizedFrameWrittenDirectly) {
+  CountingWriter writer;
+  BatchingRpcChannelOutput<8> output(writer, kAddress, "Batching");
+
+  EXPECT_EQ(OkStatus(), output.Send(kOneBytePayload));
+  EXPECT_EQ(output.buffered_bytes(), 0u);
+  ASSERT_EQ(writer.data().bytes_written(), kExpectedFrame.size());
+  EXPECT_EQ(std::memcmp(writer.data().data(),
+                        kExpectedFrame.data(),
+                        kExpectedFrame.size()),
+            0);
+}
+
 }  // namespace
 }  // namespace pw::hdlc
@@ -0,0 +1,92 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/async_initiator.h"
+
+#include <mutex>
+#include <utility>
+
+#include "pw_assert/check.h"
+
+namespace pw::i2c {
+
+async2::Poll<Status> AsyncInitiator::PendWriteRead(
+    async2::Context& cx, AsyncTransaction& transaction) {
+  {
+    std::lock_guard lock(lock_);
+    switch (transaction.state_) {
+      case AsyncTransaction::State::kComplete:
+        transaction.state_ = AsyncTransaction::State::kIdle;
+        return async2::Ready(Status(transaction.status_));
+      case AsyncTransaction::State::kQueued:
+      case AsyncTransaction::State::kActive:
+        transaction.waker_ = cx.GetWaker(async2::WaitReason::Unspecified());
+        return async2::Pending();
+      case AsyncTransaction::State::kIdle:
+        break;
+    }
+
+    transaction.waker_ = cx.GetWaker(async2::WaitReason::Unspecified());
+    if (active_ != nullptr) {
+      transaction.state_ = AsyncTransaction::State::kQueued;
+      queue_.push_back(transaction);
+      return async2::Pending();
+    }
+    transaction.state_ = AsyncTransaction::State::kActive;
+    active_ = &transaction;
+  }
+
+  DoStartTransaction(transaction);
+  return async2::Pending();
+}
+
+bool AsyncInitiator::Cancel(AsyncTransaction& transaction) {
+  std::lock_guard lock(lock_);
+  if (transaction.state_ != AsyncTransaction::State::kQueued) {
+    return false;
+  }
+  queue_.remove(transaction);
+  transaction.state_ = AsyncTransaction::State::kIdle;
+  transaction.waker_.Clear();
+  return true;
+}
+
+void AsyncInitiator::CompleteTransaction(Status status) {
+  async2::Waker waker;
+  AsyncTransaction* next = nullptr;
+  {
+    std::lock_guard lock(lock_);
+    PW_CHECK_NOTNULL(active_, "No I2C transaction is active");
+    AsyncTransaction& completed = *active_;
+    completed.status_ = status;
+    completed.state_ = AsyncTransaction::State::kComplete;
+    waker = std::move(completed.waker_);
+
+    if (!queue_.empty()) {
+      next = &queue_.front();
+      queue_.pop_front();
+      next->state_ = AsyncTransaction::State::kActive;
+    }
+    active_ = next;
+  }
+
+  // Start the next transaction before waking the task, so the bus is idle for
+  // as little time as possible.
+  if (next != nullptr) {
+    DoStartTransaction(*next);
+  }
+  std::move(waker).Wake();
+}
+
+}  // namespace pw::i2c
@@ -0,0 +1,198 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_i2c/async_initiator.h"
+
+#include <array>
+#include <optional>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/pend_func_task.h"
+#include "pw_containers/vector.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::i2c {
+namespace {
+
+using ::pw::async2::Context;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+
+constexpr Address kAddress = Address::SevenBit<0x42>();
+
+// An initiator whose transactions are completed by the test.
+class TestAsyncInitiator : public AsyncInitiator {
+ public:
+  const Vector<AsyncTransaction*, 8>& started() const { return started_; }
+
+  // Fails transactions as soon as they are started.
+  void FailOnStart(Status status) { start_status_ = status; }
+
+  void Complete(Status status) { CompleteTransaction(status); }
+
+ private:
+  void DoStartTransaction(AsyncTransaction& transaction) override {
+    started_.push_back(&transaction);
+    if (start_status_.has_value()) {
+      CompleteTransaction(*start_status_);
+    }
+  }
+
+  Vector<AsyncTransaction*, 8> started_;
+  std::optional<Status> start_status_;
+};
+
+// A task that submits a transaction and records its result.
+class TransactionTask : public async2::Task {
+ public:
+  TransactionTask(AsyncInitiator& initiator, AsyncTransaction& transaction)
+      : initiator_(initiator), transaction_(transaction) {}
+
+  const std::optional<Status>& result() const { return result_; }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    Poll<Status> status = initiator_.PendWriteRead(cx, transaction_);
+    if (status.IsPending()) {
+      return Pending();
+    }
+    result_ = *status;
+    return Ready();
+  }
+
+  AsyncInitiator& initiator_;
+  AsyncTransaction& transaction_;
+  std::optional<Status> result_;
+};
+
+class AsyncInitiatorTest : public ::testing::Test {
+ protected:
+  AsyncInitiatorTest()
+      : transaction_1_(kAddress, tx_buffer_, rx_buffer_),
+        transaction_2_(kAddress, tx_buffer_, ByteSpan()),
+        transaction_3_(kAddress, ConstByteSpan(), rx_buffer_),
+        task_1_(initiator_, transaction_1_),
+        task_2_(initiator_, transaction_2_),
+        task_3_(initiator_, transaction_3_) {}
+
+  Dispatcher dispatcher_;
+  TestAsyncInitiator initiator_;
+  std::array<std::byte, 2> tx_buffer_{};
+  std::array<std::byte, 4> rx_buffer_{};
+  AsyncTransaction transaction_1_;
+  AsyncTransaction transaction_2_;
+  AsyncTransaction transaction_3_;
+  TransactionTask task_1_;
+  TransactionTask task_2_;
+  TransactionTask task_3_;
+};
+
+TEST_F(AsyncInitiatorTest, CompletesTransaction) {
+  dispatcher_.Post(task_1_);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  ASSERT_EQ(initiator_.started().size(), 1u);
+  EXPECT_EQ(initiator_.started()[0], &transaction_1_);
+  EXPECT_EQ(initiator_.started()[0]->tx_buffer().size(), tx_buffer_.size());
+  EXPECT_EQ(initiator_.started()[0]->rx_buffer().size(), rx_buffer_.size());
+  EXPECT_FALSE(task_1_.result().has_value());
+
+  initiator_.Complete(OkStatus());
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_EQ(task_1_.result(), OkStatus());
+}
+
+TEST_F(AsyncInitiatorTest, StartsQueuedTransactionsOnCompletion) {
+  dispatcher_.Post(task_1_);
+  dispatcher_.Post(task_2_);
+  dispatcher_.Post(task_3_);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  EXPECT_EQ(initiator_.started().size(), 1u);
+
+  // The next transaction starts as soon as the previous one completes, before
+  // the dispatcher runs again.
+  initiator_.Complete(OkStatus());
+  ASSERT_EQ(initiator_.started().size(), 2u);
+  EXPECT_EQ(initiator_.started()[1], &transaction_2_);
+  initiator_.Complete(Status::Unavailable());
+  ASSERT_EQ(initiator_.started().size(), 3u);
+  EXPECT_EQ(initiator_.started()[2], &transaction_3_);
+  initiator_.Complete(OkStatus());
+
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_EQ(task_1_.result(), OkStatus());
+  EXPECT_EQ(task_2_.result(), Status::Unavailable());
+  EXPECT_EQ(task_3_.result(), OkStatus());
+}
+
+TEST_F(AsyncInitiatorTest, FailsTransactionsThatCannotStart) {
+  initiator_.FailOnStart(Status::FailedPrecondition());
+  dispatcher_.Post(task_1_);
+  dispatcher_.Post(task_2_);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_EQ(initiator_.started().size(), 2u);
+  EXPECT_EQ(task_1_.result(), Status::FailedPrecondition());
+  EXPECT_EQ(task_2_.result(), Status::FailedPrecondition());
+}
+
+TEST_F(AsyncInitiatorTest, CancelRemovesQueuedTransaction) {
+  dispatcher_.Post(task_1_);
+  dispatcher_.Post(task_2_);
+  dispatcher_.Post(task_3_);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+
+  EXPECT_FALSE(initiator_.Cancel(transaction_1_));  // Already started.
+  EXPECT_TRUE(initiator_.Cancel(transaction_2_));
+  EXPECT_FALSE(initiator_.Cancel(transaction_2_));
+
+  initiator_.Complete(OkStatus());
+  ASSERT_EQ(initiator_.started().size(), 2u);
+  EXPECT_EQ(initiator_.started()[1], &transaction_3_);
+  initiator_.Complete(OkStatus());
+
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  EXPECT_EQ(task_1_.result(), OkStatus());
+  EXPECT_FALSE(task_2_.result().has_value());
+  EXPECT_EQ(task_3_.result(), OkStatus());
+  task_2_.Deregister();
+}
+
+TEST_F(AsyncInitiatorTest, CompletedTransactionCanBeSubmittedAgain) {
+  int polls = 0;
+  async2::PendFuncTask poller([&](Context& cx) -> Poll<> {
+    while (polls < 2) {
+      Poll<Status> status = initiator_.PendWriteRead(cx, transaction_1_);
+      if (status.IsPending()) {
+        return Pending();
+      }
+      EXPECT_EQ(*status, OkStatus());
+      ++polls;
+    }
+    return Ready();
+  });
+  dispatcher_.Post(poller);
+
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  initiator_.Complete(OkStatus());
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  ASSERT_EQ(initiator_.started().size(), 2u);
+  EXPECT_EQ(initiator_.started()[1], &transaction_1_);
+  initiator_.Complete(OkStatus());
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_EQ(polls, 2);
+}
+
+}  // namespace
+}  // namespace pw::i2c
@@ -0,0 +1,144 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/poll.h"
+#include "pw_bytes/span.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_i2c/address.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::i2c {
+
+/// An I2C transaction that can be queued on an `AsyncInitiator`.
+///
+/// A transaction writes `tx_buffer` to the device, reads `rx_buffer` from it,
+/// or does both, in the same way as `Initiator::WriteReadFor`.
+///
+/// The transaction and its buffers must remain valid until it completes or is
+/// cancelled. A completed transaction may be submitted again, e.g. to poll a
+/// sensor periodically.
+class AsyncTransaction : public IntrusiveList<AsyncTransaction>::Item {
+ public:
+  constexpr AsyncTransaction(Address device_address,
+                             ConstByteSpan tx_buffer,
+                             ByteSpan rx_buffer)
+      : device_address_(device_address),
+        tx_buffer_(tx_buffer),
+        rx_buffer_(rx_buffer) {}
+
+  AsyncTransaction(const AsyncTransaction&) = delete;
+  AsyncTransaction& operator=(const AsyncTransaction&) = delete;
+
+  Address device_address() const { return device_address_; }
+  ConstByteSpan tx_buffer() const { return tx_buffer_; }
+  ByteSpan rx_buffer() const { return rx_buffer_; }
+
+ private:
+  friend class AsyncInitiator;
+
+  enum class State : uint8_t {
+    kIdle,
+    kQueued,
+    kActive,
+    kComplete,
+  };
+
+  const Address device_address_;
+  const ConstByteSpan tx_buffer_;
+  const ByteSpan rx_buffer_;
+
+  // Guarded by the lock of the AsyncInitiator the transaction is submitted to.
+  State state_ = State::kIdle;
+  Status status_;
+  async2::Waker waker_;
+};
+
+/// @brief The base driver interface for asynchronous, queued transactions with
+/// devices on an I2C bus.
+///
+/// Unlike `Initiator`, which blocks the calling thread until each transaction
+/// completes, an `AsyncInitiator` lets `pw_async2` tasks submit transactions
+/// and be woken when they complete. Transactions from any number of tasks are
+/// queued, and each one is started by the backend as soon as the previous one
+/// completes, typically from the transfer complete interrupt. This keeps the
+/// bus busy without a thread per device or a context switch between
+/// transactions.
+///
+/// Backends implement `DoStartTransaction` to start a transfer without
+/// blocking, and call `CompleteTransaction` when it finishes.
+class AsyncInitiator {
+ public:
+  virtual ~AsyncInitiator() = default;
+
+  /// Submits `transaction` to the queue if it is not already queued, and
+  /// returns its result once it has completed.
+  ///
+  /// The task is woken when the transaction completes. Only one task may wait
+  /// for a given transaction.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The transaction succeeded.
+  ///
+  ///    INVALID_ARGUMENT: Both buffers are empty, or the device address is not
+  ///    supported by the backend.
+  ///
+  ///    UNAVAILABLE: A NACK condition occurred, meaning the addressed device
+  ///    didn't respond or was unable to process the request.
+  ///
+  ///    FAILED_PRECONDITION: The interface isn't initialized or enabled.
+  ///
+  /// @endrst
+  async2::Poll<Status> PendWriteRead(async2::Context& cx,
+                                     AsyncTransaction& transaction)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  /// Removes a transaction from the queue before it is started.
+  ///
+  /// Returns true if the transaction was removed, in which case it will not
+  /// complete and no task will be woken for it. Returns false if the
+  /// transaction is not queued, or has already been started.
+  bool Cancel(AsyncTransaction& transaction) PW_LOCKS_EXCLUDED(lock_);
+
+ protected:
+  /// Reports the result of the transaction most recently passed to
+  /// `DoStartTransaction`, starts the next queued transaction, if any, and
+  /// wakes the task waiting for the completed one.
+  ///
+  /// This may be called from an interrupt, or from within
+  /// `DoStartTransaction`, e.g. to fail a transaction that cannot be started.
+  void CompleteTransaction(Status status) PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  /// Starts the given transaction. The backend must not block, and must call
+  /// `CompleteTransaction` exactly once when the transaction finishes.
+  ///
+  /// Only one transaction is active at a time. This is called either from
+  /// `PendWriteRead` when the bus is idle, or from `CompleteTransaction`.
+  virtual void DoStartTransaction(AsyncTransaction& transaction) = 0;
+
+  sync::InterruptSpinLock lock_;
+  IntrusiveList<AsyncTransaction> queue_ PW_GUARDED_BY(lock_);
+  AsyncTransaction* active_ PW_GUARDED_BY(lock_) = nullptr;
+};
+
+}  // namespace pw::i2c
@@ -13,6 +13,10 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 #include "pw_bytes/endian.h"
 #include "pw_bytes/span.h"
 #include "pw_chrono/system_clock.h"
@@ -32,6 +36,124 @@ enum class RegisterAddressSize {
   k4Bytes = 4,
 };
 
+/// How a `pw::i2c::GenericRegisterCache` treats a register.
+enum class RegisterCachePolicy {
+  /// The register only changes when it is written, like most configuration
+  /// registers. Reads are served from the cache once the value is known.
+  kCached,
+
+  /// The device may change the register at any time, like status and data
+  /// registers. Accesses always go to the bus.
+  kVolatile,
+};
+
+/// A write-through cache of a contiguous block of a device's registers, which
+/// is attached to a `pw::i2c::RegisterDevice` with
+/// `pw::i2c::RegisterDevice::set_cache()`.
+///
+/// Registers are cached when they are written or read, and later reads of
+/// cached registers don't access the bus. Writes always go to the bus. A
+/// failed write invalidates the registers it targeted, since their state on
+/// the device is unknown.
+///
+/// Registers hold the data as it is sent on the bus, so the cache works with
+/// any data endianness. Each register address holds `register_size()` bytes,
+/// which must match the register width of the device. Reads that don't cover
+/// whole registers always go to the bus.
+///
+/// The cache is not synchronized, so it must only be used by one thread, or
+/// with external locking.
+///
+/// `GenericRegisterCache` is the size-independent interface to
+/// `pw::i2c::RegisterCache`.
+class GenericRegisterCache {
+ public:
+  GenericRegisterCache(const GenericRegisterCache&) = delete;
+  GenericRegisterCache& operator=(const GenericRegisterCache&) = delete;
+
+  /// Sets the policy of `register_count` registers starting at
+  /// `register_address`. Registers that aren't in the cache are ignored.
+  ///
+  /// All registers are `RegisterCachePolicy::kCached` initially.
+  void SetPolicy(uint32_t register_address,
+                 RegisterCachePolicy policy,
+                 size_t register_count = 1);
+
+  /// Invalidates `register_count` registers starting at `register_address`,
+  /// so the next reads of them go to the bus. Call this when the device may
+  /// have changed registers on its own.
+  void Invalidate(uint32_t register_address, size_t register_count = 1);
+
+  /// Invalidates every register, for example after resetting the device.
+  void InvalidateAll();
+
+  /// @returns The address of the first register in the cache.
+  uint32_t first_register() const { return first_register_; }
+
+  /// @returns The number of registers in the cache.
+  size_t register_count() const { return flags_.size(); }
+
+  /// @returns The size of each register in bytes.
+  size_t register_size() const { return register_size_; }
+
+ protected:
+  GenericRegisterCache(uint32_t first_register,
+                       size_t register_size,
+                       ByteSpan values,
+                       span<uint8_t> flags)
+      : first_register_(first_register),
+        register_size_(register_size),
+        values_(values),
+        flags_(flags) {}
+
+  ~GenericRegisterCache() = default;
+
+ private:
+  friend class RegisterDevice;
+
+  // Copies the registers that data covers into data and returns true, if they
+  // are all cached and valid. Otherwise, leaves data unchanged.
+  bool Read(uint32_t register_address, ByteSpan data) const;
+
+  // Stores the registers that data covers, after they were written or read.
+  void Update(uint32_t register_address, ConstByteSpan data);
+
+  // Invalidates the registers that size bytes of data cover.
+  void Discard(uint32_t register_address, size_t size);
+
+  // Finds the index in the cache of the register offset registers after
+  // register_address. Returns false if that register isn't in the cache.
+  bool Index(uint32_t register_address, size_t offset, size_t& index) const;
+
+  uint32_t first_register_;
+  size_t register_size_;
+  ByteSpan values_;
+  span<uint8_t> flags_;
+};
+
+/// A `pw::i2c::GenericRegisterCache` for `kRegisterCount` registers of
+/// `kRegisterSize` bytes, starting at `first_register`.
+///
+/// @code{.cpp}
+///   // Caches registers 0x00-0x1F, except for the interrupt status register.
+///   pw::i2c::RegisterCache<0x20> cache(0x00);
+///   cache.SetPolicy(kIntStatus, pw::i2c::RegisterCachePolicy::kVolatile);
+///   device.set_cache(&cache);
+/// @endcode
+template <size_t kRegisterCount, size_t kRegisterSize = 1>
+class RegisterCache final : public GenericRegisterCache {
+ public:
+  static_assert(kRegisterSize == 1 || kRegisterSize == 2 || kRegisterSize == 4,
+                "Registers must be 1, 2, or 4 bytes");
+
+  explicit RegisterCache(uint32_t first_register)
+      : GenericRegisterCache(first_register, kRegisterSize, values_, flags_) {}
+
+ private:
+  std::array<std::byte, kRegisterCount * kRegisterSize> values_{};
+  std::array<uint8_t, kRegisterCount> flags_{};
+};
+
 /// The common interface for I2C register devices. Contains methods to help
 /// read and write the device's registers.
 ///
@@ -322,6 +444,91 @@ class RegisterDevice : public Device {
   Result<uint32_t> ReadRegister32(uint32_t register_address,
                                   chrono::SystemClock::duration timeout);
 
+  /// A register address and the value of an 8-bit register, for burst
+  /// accesses.
+  struct Register8 {
+    uint32_t address;
+    uint8_t value;
+  };
+
+  /// Writes the values of several 8-bit registers, coalescing each run of
+  /// consecutive registers into a single transaction. This relies on the
+  /// device incrementing the register address after each byte, so list
+  /// registers in ascending order to minimize the number of transactions.
+  ///
+  /// Registers are written in the order they are listed. Runs that don't fit
+  /// in `buffer` are split into several transactions.
+  ///
+  /// @param[in] registers The registers to write and their values.
+  ///
+  /// @param[in] buffer A buffer for constructing the write data. It must be
+  /// larger than the register address size.
+  ///
+  /// @param[in] timeout The maximum duration to block waiting for both
+  /// exclusive bus access and the completion of each I2C transaction.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Every register was written.
+  ///
+  ///    OUT_OF_RANGE: ``buffer`` is too small to write a register.
+  ///
+  /// @endrst
+  ///
+  /// Otherwise, returns the status of the first transaction that failed, as
+  /// described for `pw::i2c::RegisterDevice::WriteRegisters()`. Later
+  /// registers aren't written.
+  Status WriteRegisterBurst8(span<const Register8> registers,
+                             ByteSpan buffer,
+                             chrono::SystemClock::duration timeout);
+
+  /// Reads the values of several 8-bit registers, coalescing each run of
+  /// consecutive registers into a single transaction. This relies on the
+  /// device incrementing the register address after each byte, so list
+  /// registers in ascending order to minimize the number of transactions.
+  ///
+  /// Runs that are longer than `buffer` are split into several transactions.
+  /// With a cache attached, a run is read from the cache if all of its
+  /// registers are cached.
+  ///
+  /// @param[in,out] registers The registers to read. Their values are set
+  /// to the register values.
+  ///
+  /// @param[in] buffer A buffer for the read data. It must not be empty.
+  ///
+  /// @param[in] timeout The maximum duration to block waiting for both
+  /// exclusive bus access and the completion of each I2C transaction.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Every register was read.
+  ///
+  ///    OUT_OF_RANGE: ``buffer`` is empty.
+  ///
+  /// @endrst
+  ///
+  /// Otherwise, returns the status of the first transaction that failed, as
+  /// described for `pw::i2c::RegisterDevice::ReadRegisters()`. Later
+  /// registers aren't read.
+  Status ReadRegisterBurst8(span<Register8> registers,
+                            ByteSpan buffer,
+                            chrono::SystemClock::duration timeout);
+
+  /// Attaches a `pw::i2c::GenericRegisterCache`, which caches the registers
+  /// that this device reads and writes. Passing `nullptr` detaches the
+  /// current cache.
+  ///
+  /// Attaching a cache doesn't invalidate it, so a cache may be reattached
+  /// later if its registers haven't changed in the meantime.
+  void set_cache(GenericRegisterCache* cache) { cache_ = cache; }
+
+  /// @returns The attached `pw::i2c::GenericRegisterCache`, or `nullptr`.
+  GenericRegisterCache* cache() const { return cache_; }
+
  private:
   // Helper write registers.
   Status WriteRegisters(uint32_t register_address,
@@ -330,9 +537,16 @@ class RegisterDevice : public Device {
                         ByteSpan buffer,
                         chrono::SystemClock::duration timeout);
 
+  // Writes a buffer of a register address followed by data, and updates the
+  // cache with the data.
+  Status WriteThrough(uint32_t register_address,
+                      ConstByteSpan write_buffer,
+                      chrono::SystemClock::duration timeout);
+
   const endian register_address_order_;
   const endian data_order_;
   const RegisterAddressSize register_address_size_;
+  GenericRegisterCache* cache_ = nullptr;
 };
 
 inline Status RegisterDevice::WriteRegisters(
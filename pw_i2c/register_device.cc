@@ -14,6 +14,8 @@
 
 #include "pw_i2c/register_device.h"
 
+#include <cstring>
+
 #include "pw_assert/check.h"
 #include "pw_bytes/byte_builder.h"
 
@@ -82,8 +84,113 @@ Status PutRegisterData32InByteBuilder(ByteBuilder& byte_builder,
   }
 }
 
+// Flags for each register in a GenericRegisterCache.
+constexpr uint8_t kValid = 1 << 0;
+constexpr uint8_t kVolatile = 1 << 1;
+
+// Counts the registers from the start of registers that have consecutive
+// addresses, up to max_count.
+template <typename Register>
+size_t RunLength(span<Register> registers, size_t max_count) {
+  size_t count = 1;
+  while (count < registers.size() && count < max_count &&
+         registers[count].address == registers[0].address + count) {
+    ++count;
+  }
+  return count;
+}
+
 }  // namespace
 
+void GenericRegisterCache::SetPolicy(uint32_t register_address,
+                                     RegisterCachePolicy policy,
+                                     size_t register_count) {
+  for (size_t i = 0; i < register_count; ++i) {
+    size_t index;
+    if (!Index(register_address, i, index)) {
+      continue;
+    }
+    // Volatile registers are never valid, so they are never read from the
+    // cache.
+    flags_[index] = policy == RegisterCachePolicy::kVolatile ? kVolatile : 0;
+  }
+}
+
+void GenericRegisterCache::Invalidate(uint32_t register_address,
+                                      size_t register_count) {
+  for (size_t i = 0; i < register_count; ++i) {
+    size_t index;
+    if (Index(register_address, i, index)) {
+      flags_[index] &= static_cast<uint8_t>(~kValid);
+    }
+  }
+}
+
+void GenericRegisterCache::InvalidateAll() {
+  for (uint8_t& flags : flags_) {
+    flags &= static_cast<uint8_t>(~kValid);
+  }
+}
+
+bool GenericRegisterCache::Read(uint32_t register_address,
+                                ByteSpan data) const {
+  if (data.empty() || data.size() % register_size_ != 0) {
+    return false;
+  }
+  const size_t register_count = data.size() / register_size_;
+  size_t first_index;
+  if (!Index(register_address, 0, first_index) ||
+      register_count > flags_.size() - first_index) {
+    return false;
+  }
+  for (size_t i = 0; i < register_count; ++i) {
+    if ((flags_[first_index + i] & kValid) == 0) {
+      return false;
+    }
+  }
+  std::memcpy(data.data(),
+              values_.data() + first_index * register_size_,
+              data.size());
+  return true;
+}
+
+void GenericRegisterCache::Update(uint32_t register_address,
+                                  ConstByteSpan data) {
+  if (data.size() % register_size_ != 0) {
+    Discard(register_address, data.size());
+    return;
+  }
+  for (size_t i = 0; i < data.size() / register_size_; ++i) {
+    size_t index;
+    if (!Index(register_address, i, index) ||
+        (flags_[index] & kVolatile) != 0) {
+      continue;
+    }
+    std::memcpy(values_.data() + index * register_size_,
+                data.data() + i * register_size_,
+                register_size_);
+    flags_[index] |= kValid;
+  }
+}
+
+void GenericRegisterCache::Discard(uint32_t register_address, size_t size) {
+  Invalidate(register_address, (size + register_size_ - 1) / register_size_);
+}
+
+bool GenericRegisterCache::Index(uint32_t register_address,
+                                 size_t offset,
+                                 size_t& index) const {
+  // Computed in 64 bits so that offsets past the end of the address space
+  // don't wrap around into the cache.
+  const uint64_t address = uint64_t{register_address} + offset;
+  if (address < first_register_ ||
+      address - first_register_ >= flags_.size()) {
+    return false;
+  }
+  index = static_cast<size_t>(address - first_register_);
+  return true;
+}
+
 Status RegisterDevice::WriteRegisters(const uint32_t register_address,
                                       ConstByteSpan register_data,
                                       const size_t register_data_size,
@@ -124,12 +231,94 @@ Status RegisterDevice::WriteRegisters(const uint32_t register_address,
   }
 
   ConstByteSpan write_buffer(builder.data(), builder.size());
-  return WriteFor(write_buffer, timeout);
+  return WriteThrough(register_address, write_buffer, timeout);
+}
+
+Status RegisterDevice::WriteThrough(uint32_t register_address,
+                                    ConstByteSpan write_buffer,
+                                    chrono::SystemClock::duration timeout) {
+  const Status status = WriteFor(write_buffer, timeout);
+  if (cache_ == nullptr) {
+    return status;
+  }
+
+  ConstByteSpan register_data =
+      write_buffer.subspan(static_cast<size_t>(register_address_size_));
+  if (status.ok()) {
+    cache_->Update(register_address, register_data);
+  } else {
+    // The write may have partially completed, so the registers' values are
+    // unknown.
+    cache_->Discard(register_address, register_data.size());
+  }
+  return status;
+}
+
+Status RegisterDevice::WriteRegisterBurst8(
+    span<const Register8> registers,
+    ByteSpan buffer,
+    chrono::SystemClock::duration timeout) {
+  const size_t address_size = static_cast<size_t>(register_address_size_);
+  if (buffer.size() <= address_size) {
+    return Status::OutOfRange();
+  }
+
+  size_t i = 0;
+  while (i < registers.size()) {
+    const span<const Register8> run =
+        registers.subspan(i).first(RunLength(registers.subspan(i),
+                                             buffer.size() - address_size));
+
+    ByteBuilder builder(buffer);
+    PutRegisterAddressInByteBuilder(builder,
+                                    run.front().address,
+                                    register_address_order_,
+                                    register_address_size_);
+    for (const Register8& reg : run) {
+      builder.PutUint8(reg.value);
+    }
+    if (!builder.ok()) {
+      return Status::Internal();
+    }
+
+    PW_TRY(WriteThrough(run.front().address,
+                        ConstByteSpan(builder.data(), builder.size()),
+                        timeout));
+    i += run.size();
+  }
+  return OkStatus();
+}
+
+Status RegisterDevice::ReadRegisterBurst8(
+    span<Register8> registers,
+    ByteSpan buffer,
+    chrono::SystemClock::duration timeout) {
+  if (buffer.empty()) {
+    return Status::OutOfRange();
+  }
+
+  size_t i = 0;
+  while (i < registers.size()) {
+    const span<Register8> run = registers.subspan(i).first(
+        RunLength(registers.subspan(i), buffer.size()));
+
+    ByteSpan data = buffer.first(run.size());
+    PW_TRY(ReadRegisters(run.front().address, data, timeout));
+    for (size_t j = 0; j < run.size(); ++j) {
+      run[j].value = static_cast<uint8_t>(data[j]);
+    }
+    i += run.size();
+  }
+  return OkStatus();
 }
 
 Status RegisterDevice::ReadRegisters(uint32_t register_address,
                                      ByteSpan return_data,
                                      chrono::SystemClock::duration timeout) {
+  if (cache_ != nullptr && cache_->Read(register_address, return_data)) {
+    return OkStatus();
+  }
+
   ByteBuffer<sizeof(register_address)> byte_buffer;
 
   PutRegisterAddressInByteBuilder(byte_buffer,
@@ -141,11 +330,16 @@ Status RegisterDevice::ReadRegisters(uint32_t register_address,
     return pw::Status::Internal();
   }
 
-  return WriteReadFor(byte_buffer.data(),
+  PW_TRY(WriteReadFor(byte_buffer.data(),
                       byte_buffer.size(),
                       return_data.data(),
                       return_data.size(),
-                      timeout);
+                      timeout));
+
+  if (cache_ != nullptr) {
+    cache_->Update(register_address, return_data);
+  }
+  return OkStatus();
 }
 
 }  // namespace i2c
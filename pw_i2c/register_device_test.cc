@@ -808,6 +808,285 @@ TEST(RegisterDevice, WriteRegister16with2ByteBigEndianAddress) {
   }
 }
 
+// Emulates a device with 1-byte register addresses that increments the
+// register address after each byte that is read or written.
+class RegisterFileInitiator : public Initiator {
+ public:
+  std::array<uint8_t, 256>& registers() { return registers_; }
+
+  size_t transactions() const { return transactions_; }
+
+  void FailNextTransaction() { fail_next_ = true; }
+
+ private:
+  Status DoWriteReadFor(Address,
+                        ConstByteSpan tx_data,
+                        ByteSpan rx_data,
+                        chrono::SystemClock::duration) override {
+    ++transactions_;
+    if (fail_next_) {
+      fail_next_ = false;
+      return Status::Unavailable();
+    }
+
+    PW_CHECK(!tx_data.empty(), "Every transaction sets the register address");
+    uint8_t address = static_cast<uint8_t>(tx_data[0]);
+    for (std::byte data : tx_data.subspan(1)) {
+      registers_[address++] = static_cast<uint8_t>(data);
+    }
+    for (std::byte& data : rx_data) {
+      data = static_cast<std::byte>(registers_[address++]);
+    }
+    return OkStatus();
+  }
+
+  std::array<uint8_t, 256> registers_{};
+  size_t transactions_ = 0;
+  bool fail_next_ = false;
+};
+
+class RegisterDeviceCacheTest : public ::testing::Test {
+ protected:
+  RegisterDeviceCacheTest()
+      : device_(initiator_,
+                kTestDeviceAddress,
+                endian::big,
+                RegisterAddressSize::k1Byte),
+        cache_(0x10) {
+    device_.set_cache(&cache_);
+  }
+
+  RegisterFileInitiator initiator_;
+  RegisterDevice device_;
+  RegisterCache<0x10> cache_;
+};
+
+TEST_F(RegisterDeviceCacheTest, ReadsCachedRegisterOnce) {
+  initiator_.registers()[0x12] = 0xAB;
+
+  EXPECT_EQ(device_.ReadRegister8(0x12, kTimeout).value(), 0xAB);
+  initiator_.registers()[0x12] = 0xCD;
+  EXPECT_EQ(device_.ReadRegister8(0x12, kTimeout).value(), 0xAB);
+  EXPECT_EQ(initiator_.transactions(), 1u);
+}
+
+TEST_F(RegisterDeviceCacheTest, WriteThrough) {
+  ASSERT_EQ(device_.WriteRegister8(0x1F, 0x42, kTimeout), OkStatus());
+  EXPECT_EQ(initiator_.registers()[0x1F], 0x42);
+
+  EXPECT_EQ(device_.ReadRegister8(0x1F, kTimeout).value(), 0x42);
+  EXPECT_EQ(initiator_.transactions(), 1u);
+}
+
+TEST_F(RegisterDeviceCacheTest, VolatileRegistersAlwaysReadFromBus) {
+  cache_.SetPolicy(0x13, RegisterCachePolicy::kVolatile);
+  ASSERT_EQ(device_.WriteRegister8(0x13, 0x01, kTimeout), OkStatus());
+
+  initiator_.registers()[0x13] = 0x02;
+  EXPECT_EQ(device_.ReadRegister8(0x13, kTimeout).value(), 0x02);
+  initiator_.registers()[0x13] = 0x03;
+  EXPECT_EQ(device_.ReadRegister8(0x13, kTimeout).value(), 0x03);
+  EXPECT_EQ(initiator_.transactions(), 3u);
+}
+
+TEST_F(RegisterDeviceCacheTest, RegistersOutsideCacheReadFromBus) {
+  std::array<std::byte, 2> data;
+  // 0x0F is before the cache and 0x20 is after it.
+  ASSERT_EQ(device_.ReadRegisters(0x0F, data, kTimeout), OkStatus());
+  ASSERT_EQ(device_.ReadRegisters(0x0F, data, kTimeout), OkStatus());
+  ASSERT_EQ(device_.ReadRegister8(0x20, kTimeout).status(), OkStatus());
+  ASSERT_EQ(device_.ReadRegister8(0x20, kTimeout).status(), OkStatus());
+  EXPECT_EQ(initiator_.transactions(), 4u);
+
+  // The read of 0x0F-0x10 cached 0x10.
+  ASSERT_EQ(device_.ReadRegister8(0x10, kTimeout).status(), OkStatus());
+  EXPECT_EQ(initiator_.transactions(), 4u);
+}
+
+TEST_F(RegisterDeviceCacheTest, Invalidate) {
+  ASSERT_EQ(device_.WriteRegister8(0x10, 0x01, kTimeout), OkStatus());
+  ASSERT_EQ(device_.WriteRegister8(0x11, 0x01, kTimeout), OkStatus());
+  initiator_.registers()[0x10] = 0x02;
+  initiator_.registers()[0x11] = 0x02;
+
+  cache_.Invalidate(0x10);
+  EXPECT_EQ(device_.ReadRegister8(0x10, kTimeout).value(), 0x02);
+  EXPECT_EQ(device_.ReadRegister8(0x11, kTimeout).value(), 0x01);
+
+  cache_.InvalidateAll();
+  EXPECT_EQ(device_.ReadRegister8(0x11, kTimeout).value(), 0x02);
+  EXPECT_EQ(initiator_.transactions(), 4u);
+}
+
+TEST_F(RegisterDeviceCacheTest, FailedWriteInvalidates) {
+  ASSERT_EQ(device_.WriteRegister8(0x14, 0x01, kTimeout), OkStatus());
+  initiator_.FailNextTransaction();
+  EXPECT_EQ(device_.WriteRegister8(0x14, 0x02, kTimeout),
+            Status::Unavailable());
+
+  initiator_.registers()[0x14] = 0x03;
+  EXPECT_EQ(device_.ReadRegister8(0x14, kTimeout).value(), 0x03);
+}
+
+TEST_F(RegisterDeviceCacheTest, DetachedCacheIsNotUsed) {
+  ASSERT_EQ(device_.ReadRegister8(0x10, kTimeout).status(), OkStatus());
+  device_.set_cache(nullptr);
+  EXPECT_EQ(device_.cache(), nullptr);
+  ASSERT_EQ(device_.ReadRegister8(0x10, kTimeout).status(), OkStatus());
+  EXPECT_EQ(initiator_.transactions(), 2u);
+}
+
+TEST(RegisterDeviceCache, WideRegisters) {
+  RegisterFileInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        endian::big,
+                        RegisterAddressSize::k1Byte);
+  RegisterCache<4, 2> cache(0x00);
+  device.set_cache(&cache);
+
+  // Emulates 2-byte registers at consecutive addresses by reading them in
+  // one transaction, so each register's bytes are on the bus back to back.
+  initiator.registers()[0x00] = 0x12;
+  initiator.registers()[0x01] = 0x34;
+  initiator.registers()[0x02] = 0x56;
+  initiator.registers()[0x03] = 0x78;
+  std::array<uint16_t, 2> values;
+  ASSERT_EQ(device.ReadRegisters16(0x00, values, kTimeout), OkStatus());
+  EXPECT_EQ(values[0], 0x1234);
+  EXPECT_EQ(values[1], 0x5678);
+
+  // Registers 0x00 and 0x01 are cached with the data in bus order.
+  EXPECT_EQ(device.ReadRegister16(0x01, kTimeout).value(), 0x5678);
+  EXPECT_EQ(initiator.transactions(), 1u);
+
+  // A read of part of a register goes to the bus.
+  ASSERT_EQ(device.ReadRegister8(0x00, kTimeout).status(), OkStatus());
+  EXPECT_EQ(initiator.transactions(), 2u);
+}
+
+TEST(RegisterDevice, WriteRegisterBurst8CoalescesConsecutiveRegisters) {
+  RegisterFileInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        endian::little,
+                        RegisterAddressSize::k1Byte);
+
+  constexpr std::array<RegisterDevice::Register8, 5> kRegisters = {{
+      {0x10, 0xA0},
+      {0x11, 0xA1},
+      {0x12, 0xA2},
+      {0x20, 0xB0},
+      {0x21, 0xB1},
+  }};
+  std::array<std::byte, 8> buffer;
+  ASSERT_EQ(device.WriteRegisterBurst8(kRegisters, buffer, kTimeout),
+            OkStatus());
+
+  EXPECT_EQ(initiator.transactions(), 2u);
+  for (const RegisterDevice::Register8& reg : kRegisters) {
+    EXPECT_EQ(initiator.registers()[reg.address], reg.value);
+  }
+}
+
+TEST(RegisterDevice, WriteRegisterBurst8SplitsRunsLongerThanBuffer) {
+  RegisterFileInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        endian::little,
+                        RegisterAddressSize::k1Byte);
+
+  std::array<RegisterDevice::Register8, 5> registers;
+  for (uint8_t i = 0; i < registers.size(); ++i) {
+    registers[i] = {0x30u + i, static_cast<uint8_t>(0xC0 + i)};
+  }
+  // Fits the address and two registers.
+  std::array<std::byte, 3> buffer;
+  ASSERT_EQ(device.WriteRegisterBurst8(registers, buffer, kTimeout),
+            OkStatus());
+
+  EXPECT_EQ(initiator.transactions(), 3u);
+  for (const RegisterDevice::Register8& reg : registers) {
+    EXPECT_EQ(initiator.registers()[reg.address], reg.value);
+  }
+}
+
+TEST(RegisterDevice, WriteRegisterBurst8BufferTooSmall) {
+  RegisterFileInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        endian::little,
+                        RegisterAddressSize::k1Byte);
+
+  constexpr std::array<RegisterDevice::Register8, 1> kRegisters = {
+      {{0x10, 0xA0}}};
+  std::array<std::byte, 1> buffer;
+  EXPECT_EQ(device.WriteRegisterBurst8(kRegisters, buffer, kTimeout),
+            Status::OutOfRange());
+  EXPECT_EQ(initiator.transactions(), 0u);
+}
+
+TEST(RegisterDevice, ReadRegisterBurst8CoalescesConsecutiveRegisters) {
+  RegisterFileInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        endian::little,
+                        RegisterAddressSize::k1Byte);
+  for (size_t i = 0; i < initiator.registers().size(); ++i) {
+    initiator.registers()[i] = static_cast<uint8_t>(~i);
+  }
+
+  std::array<RegisterDevice::Register8, 6> registers = {{
+      {0x01, 0},
+      {0x02, 0},
+      {0x03, 0},
+      {0x05, 0},
+      {0x40, 0},
+      {0x41, 0},
+  }};
+  std::array<std::byte, 2> buffer;
+  ASSERT_EQ(device.ReadRegisterBurst8(registers, buffer, kTimeout),
+            OkStatus());
+
+  // 0x01-0x02, 0x03, 0x05, and 0x40-0x41.
+  EXPECT_EQ(initiator.transactions(), 4u);
+  for (const RegisterDevice::Register8& reg : registers) {
+    EXPECT_EQ(reg.value, static_cast<uint8_t>(~reg.address));
+  }
+}
+
+TEST(RegisterDevice, ReadRegisterBurst8FromCache) {
+  RegisterFileInitiator initiator;
+  RegisterDevice device(initiator,
+                        kTestDeviceAddress,
+                        endian::little,
+                        RegisterAddressSize::k1Byte);
+  RegisterCache<4> cache(0x00);
+  device.set_cache(&cache);
+
+  constexpr std::array<RegisterDevice::Register8, 4> kConfig = {{
+      {0x00, 0x10},
+      {0x01, 0x11},
+      {0x02, 0x12},
+      {0x03, 0x13},
+  }};
+  std::array<std::byte, 5> buffer;
+  ASSERT_EQ(device.WriteRegisterBurst8(kConfig, buffer, kTimeout), OkStatus());
+
+  std::array<RegisterDevice::Register8, 4> registers = {{
+      {0x00, 0},
+      {0x01, 0},
+      {0x02, 0},
+      {0x03, 0},
+  }};
+  ASSERT_EQ(device.ReadRegisterBurst8(registers, buffer, kTimeout),
+            OkStatus());
+  EXPECT_EQ(initiator.transactions(), 1u);
+  for (size_t i = 0; i < registers.size(); ++i) {
+    EXPECT_EQ(registers[i].value, kConfig[i].value);
+  }
+}
+
 }  // namespace
 }  // namespace i2c
 }  // namespace pw
@@ -14,6 +14,7 @@
 #include "pw_i2c_mcuxpresso/initiator.h"
 
 #include <mutex>
+#include <utility>
 
 #include "fsl_i2c.h"
 #include "pw_chrono/system_clock.h"
@@ -163,5 +164,99 @@ Status McuxpressoInitiator::DoWriteReadFor(
     return Status::InvalidArgument();
   }
 }
+
+void McuxpressoAsyncInitiator::Enable() {
+  i2c_master_config_t master_config;
+  I2C_MasterGetDefaultConfig(&master_config);
+  master_config.baudRate_Bps = config_.baud_rate_bps;
+  I2C_MasterInit(base_, &master_config, CLOCK_GetFreq(config_.clock_name));
+
+  I2C_MasterTransferCreateHandle(
+      base_,
+      &handle_,
+      McuxpressoAsyncInitiator::TransferCompleteCallback,
+      this);
+
+  enabled_ = true;
+}
+
+void McuxpressoAsyncInitiator::Disable() {
+  I2C_MasterDeinit(base_);
+  enabled_ = false;
+}
+
+McuxpressoAsyncInitiator::~McuxpressoAsyncInitiator() { Disable(); }
+
+void McuxpressoAsyncInitiator::DoStartTransaction(
+    AsyncTransaction& transaction) {
+  if (!enabled_) {
+    CompleteTransaction(Status::FailedPrecondition());
+    return;
+  }
+
+  const uint8_t address = transaction.device_address().GetSevenBit();
+  const ConstByteSpan tx_buffer = transaction.tx_buffer();
+  const ByteSpan rx_buffer = transaction.rx_buffer();
+
+  status_t status;
+  if (!tx_buffer.empty()) {
+    read_address_ = address;
+    pending_read_ = rx_buffer;
+    i2c_master_transfer_t transfer{
+        rx_buffer.empty() ? kI2C_TransferDefaultFlag : kI2C_TransferNoStopFlag,
+        address,
+        kI2C_Write,
+        0,
+        0,
+        const_cast<std::byte*>(tx_buffer.data()),
+        tx_buffer.size()};
+    status = I2C_MasterTransferNonBlocking(base_, &handle_, &transfer);
+  } else if (!rx_buffer.empty()) {
+    pending_read_ = ByteSpan();
+    i2c_master_transfer_t transfer{kI2C_TransferDefaultFlag,
+                                   address,
+                                   kI2C_Read,
+                                   0,
+                                   0,
+                                   rx_buffer.data(),
+                                   rx_buffer.size()};
+    status = I2C_MasterTransferNonBlocking(base_, &handle_, &transfer);
+  } else {
+    CompleteTransaction(Status::InvalidArgument());
+    return;
+  }
+
+  if (status != kStatus_Success) {
+    pending_read_ = ByteSpan();
+    CompleteTransaction(HalStatusToPwStatus(status));
+  }
+}
+
+void McuxpressoAsyncInitiator::TransferCompleteCallback(I2C_Type*,
+                                                        i2c_master_handle_t*,
+                                                        status_t status,
+                                                        void* initiator_ptr) {
+  McuxpressoAsyncInitiator& initiator =
+      *static_cast<McuxpressoAsyncInitiator*>(initiator_ptr);
+
+  // Chain the read phase of a write-read without returning to the task.
+  const ByteSpan rx_buffer = std::exchange(initiator.pending_read_, ByteSpan());
+  if (status == kStatus_Success && !rx_buffer.empty()) {
+    i2c_master_transfer_t transfer{kI2C_TransferRepeatedStartFlag,
+                                   initiator.read_address_,
+                                   kI2C_Read,
+                                   0,
+                                   0,
+                                   rx_buffer.data(),
+                                   rx_buffer.size()};
+    status = I2C_MasterTransferNonBlocking(
+        initiator.base_, &initiator.handle_, &transfer);
+    if (status == kStatus_Success) {
+      return;
+    }
+  }
+
+  initiator.CompleteTransaction(HalStatusToPwStatus(status));
+}
 // inclusive-language: enable
 }  // namespace pw::i2c
@@ -15,6 +15,7 @@
 
 #include "fsl_clock.h"
 #include "fsl_i2c.h"
+#include "pw_i2c/async_initiator.h"
 #include "pw_i2c/initiator.h"
 #include "pw_sync/interrupt_spin_lock.h"
 #include "pw_sync/lock_annotations.h"
@@ -78,4 +79,50 @@ class McuxpressoInitiator final : public Initiator {
   // inclusive-language: enable
 };
 
+// AsyncInitiator implementation based on the I2C driver in NXP MCUXpresso SDK.
+// Transactions run entirely from the driver's interrupt: a write-read is a
+// write followed by a repeated-start read, and the next queued transaction is
+// started from the same interrupt that completes the previous one. Currently
+// supports only devices with 7 bit adresses.
+class McuxpressoAsyncInitiator final : public AsyncInitiator {
+ public:
+  using Config = McuxpressoInitiator::Config;
+
+  McuxpressoAsyncInitiator(const Config& config)
+      : config_(config),
+        base_(reinterpret_cast<I2C_Type*>(config_.flexcomm_address)) {}
+
+  // Should be called before submitting any transactions. Neither may be
+  // called while a transaction is in progress.
+  void Enable();
+  void Disable();
+
+  ~McuxpressoAsyncInitiator() final;
+
+ private:
+  void DoStartTransaction(AsyncTransaction& transaction) override;
+
+  // inclusive-language: disable
+  static void TransferCompleteCallback(I2C_Type* base,
+                                       i2c_master_handle_t* handle,
+                                       status_t status,
+                                       void* initiator_ptr);
+  // inclusive-language: enable
+
+  Config const config_;
+  I2C_Type* const base_;
+  bool enabled_ = false;
+
+  // The read phase of the active write-read transaction, started with a
+  // repeated start once the write phase completes. Only accessed while a
+  // transaction is active, which serializes access between the starting
+  // thread and the interrupt.
+  uint8_t read_address_ = 0;
+  ByteSpan pending_read_;
+
+  // inclusive-language: disable
+  i2c_master_handle_t handle_;
+  // inclusive-language: enable
+};
+
 }  // namespace pw::i2c
@@ -0,0 +1,51 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_interrupt/instrumentation.h"
+
+namespace pw::interrupt {
+
+void EnableInstrumentationCycleCounter() {
+#if _PW_INTERRUPT_DWT_CYCLE_COUNTER
+  // Set DEMCR.TRCENA to enable the DWT, then DWT_CTRL.CYCCNTENA.
+  volatile uint32_t& demcr = *reinterpret_cast<volatile uint32_t*>(0xE000EDFCu);
+  volatile uint32_t& dwt_ctrl =
+      *reinterpret_cast<volatile uint32_t*>(0xE0001000u);
+  demcr = demcr | (1u << 24);
+  dwt_ctrl = dwt_ctrl | 1u;
+#endif  // _PW_INTERRUPT_DWT_CYCLE_COUNTER
+}
+
+uint32_t InstrumentedNestingDepth() {
+  return internal::instrumented_nesting_depth;
+}
+
+void IrqMetrics::RecordRun(uint32_t duration, uint32_t nesting_depth) {
+  count_.Increment();
+  durations_.Record(duration);
+  if (duration > max_duration_.value()) {
+    max_duration_.Set(duration);
+  }
+  if (nesting_depth > max_nesting_depth_.value()) {
+    max_nesting_depth_.Set(nesting_depth);
+  }
+}
+
+void IrqMetrics::RecordLatency(uint32_t latency) {
+  if (latency > max_latency_.value()) {
+    max_latency_.Set(latency);
+  }
+}
+
+}  // namespace pw::interrupt
@@ -0,0 +1,150 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_interrupt/instrumentation.h"
+
+#include <cstdint>
+
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+uint32_t fake_cycles = 0;
+
+}  // namespace
+
+extern "C" uint32_t pw_interrupt_InstrumentationCycles(void) {
+  return fake_cycles;
+}
+
+namespace pw::interrupt {
+namespace {
+
+class InstrumentationTest : public ::testing::Test {
+ protected:
+  InstrumentationTest() { fake_cycles = 0; }
+};
+
+TEST_F(InstrumentationTest, RecordRun_UpdatesCountMaximumsAndHistogram) {
+  IrqMetrics metrics(7);
+  metrics.RecordRun(100, 1);
+  metrics.RecordRun(3, 2);
+  metrics.RecordRun(50, 1);
+
+  EXPECT_EQ(metrics.count(), 3u);
+  EXPECT_EQ(metrics.max_duration(), 100u);
+  EXPECT_EQ(metrics.max_nesting_depth(), 2u);
+  EXPECT_EQ(metrics.max_latency(), 0u);
+  EXPECT_EQ(metrics.durations().count(2), 1u);  // [2, 4)
+  EXPECT_EQ(metrics.durations().count(6), 1u);  // [32, 64)
+  EXPECT_EQ(metrics.durations().count(7), 1u);  // [64, 128)
+}
+
+TEST_F(InstrumentationTest, RecordRun_LongDurationsInLastBucket) {
+  IrqMetrics metrics(7);
+  metrics.RecordRun(0xFFFFFFFFu, 1);
+  EXPECT_EQ(metrics.durations().count(IrqMetrics::kDurationBuckets - 1), 1u);
+}
+
+TEST_F(InstrumentationTest, RecordLatency_KeepsMaximum) {
+  IrqMetrics metrics(7);
+  metrics.RecordLatency(12);
+  metrics.RecordLatency(40);
+  metrics.RecordLatency(8);
+  EXPECT_EQ(metrics.max_latency(), 40u);
+  EXPECT_EQ(metrics.count(), 0u);
+}
+
+TEST_F(InstrumentationTest, MetricsNamedByIrqInParentGroup) {
+  metric::Group parent(1234);
+  IrqMetrics metrics(42, parent);
+
+  EXPECT_EQ(metrics.irq(), 42u);
+  ASSERT_EQ(parent.children().size(), 1u);
+  EXPECT_EQ(&parent.children().front(), &metrics.metric_group());
+  EXPECT_EQ(metrics.metric_group().metrics().size(), 4u);
+  EXPECT_EQ(metrics.metric_group().children().size(), 1u);
+}
+
+TEST_F(InstrumentationTest, ScopedIrq_RecordsDuration) {
+  IrqMetrics metrics(7);
+  fake_cycles = 1000;
+  {
+    ScopedIrq irq(metrics);
+    EXPECT_EQ(InstrumentedNestingDepth(), 1u);
+    fake_cycles += 250;
+  }
+  EXPECT_EQ(InstrumentedNestingDepth(), 0u);
+  EXPECT_EQ(metrics.count(), 1u);
+  EXPECT_EQ(metrics.max_duration(), 250u);
+  EXPECT_EQ(metrics.max_nesting_depth(), 1u);
+}
+
+TEST_F(InstrumentationTest, ScopedIrq_DurationAcrossCounterWrap) {
+  IrqMetrics metrics(7);
+  fake_cycles = 0xFFFFFFF0u;
+  {
+    ScopedIrq irq(metrics);
+    fake_cycles += 0x20;
+  }
+  EXPECT_EQ(metrics.max_duration(), 0x20u);
+}
+
+TEST_F(InstrumentationTest, ScopedIrq_RecordsLatency) {
+  IrqMetrics metrics(7);
+  { ScopedIrq irq(metrics, 36); }
+  EXPECT_EQ(metrics.max_latency(), 36u);
+  EXPECT_EQ(metrics.count(), 1u);
+}
+
+TEST_F(InstrumentationTest, ScopedIrq_Nested) {
+  IrqMetrics outer_metrics(1);
+  IrqMetrics inner_metrics(2);
+  {
+    ScopedIrq outer(outer_metrics);
+    fake_cycles += 10;
+    {
+      ScopedIrq inner(inner_metrics);
+      EXPECT_EQ(InstrumentedNestingDepth(), 2u);
+      fake_cycles += 5;
+    }
+    EXPECT_EQ(InstrumentedNestingDepth(), 1u);
+    fake_cycles += 10;
+  }
+  EXPECT_EQ(InstrumentedNestingDepth(), 0u);
+
+  EXPECT_EQ(outer_metrics.max_duration(), 25u);
+  EXPECT_EQ(outer_metrics.max_nesting_depth(), 1u);
+  EXPECT_EQ(inner_metrics.max_duration(), 5u);
+  EXPECT_EQ(inner_metrics.max_nesting_depth(), 2u);
+}
+
+PW_INTERRUPT_IRQ_METRICS(macro_metrics, 99);
+
+void InstrumentedHandler() {
+  PW_INTERRUPT_INSTRUMENT_IRQ_WITH_LATENCY(macro_metrics, 3);
+  fake_cycles += 8;
+}
+
+TEST_F(InstrumentationTest, Macros) {
+  InstrumentedHandler();
+#if PW_INTERRUPT_INSTRUMENTATION_ENABLED
+  EXPECT_EQ(macro_metrics.count(), 1u);
+  EXPECT_EQ(macro_metrics.max_duration(), 8u);
+  EXPECT_EQ(macro_metrics.max_latency(), 3u);
+#endif  // PW_INTERRUPT_INSTRUMENTATION_ENABLED
+}
+
+}  // namespace
+}  // namespace pw::interrupt
@@ -0,0 +1,29 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// When enabled, the PW_INTERRUPT_INSTRUMENT_IRQ macros in
+// pw_interrupt/instrumentation.h record the duration, entry latency, and
+// nesting depth of the handlers they are placed in. When disabled, the macros
+// expand to nothing, so instrumented handlers have no overhead.
+#ifndef PW_INTERRUPT_INSTRUMENTATION_ENABLED
+#define PW_INTERRUPT_INSTRUMENTATION_ENABLED 0
+#endif  // PW_INTERRUPT_INSTRUMENTATION_ENABLED
+
+// The number of power-of-two buckets in each handler's histogram of durations
+// in cycles. The last bucket counts all durations of at least 2^(buckets - 2)
+// cycles; the default of 20 buckets resolves durations of up to 262144 cycles.
+#ifndef PW_INTERRUPT_INSTRUMENTATION_DURATION_BUCKETS
+#define PW_INTERRUPT_INSTRUMENTATION_DURATION_BUCKETS 20
+#endif  // PW_INTERRUPT_INSTRUMENTATION_DURATION_BUCKETS
@@ -0,0 +1,232 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_interrupt/config.h"
+#include "pw_metric/metric.h"
+#include "pw_preprocessor/arch.h"
+
+#if _PW_ARCH_ARM_V7M || _PW_ARCH_ARM_V7EM || _PW_ARCH_ARM_V8M_MAINLINE || \
+    _PW_ARCH_ARM_V8_1M_MAINLINE
+#define _PW_INTERRUPT_DWT_CYCLE_COUNTER 1
+#else
+#define _PW_INTERRUPT_DWT_CYCLE_COUNTER 0
+#endif
+
+#if !_PW_INTERRUPT_DWT_CYCLE_COUNTER && !defined(__riscv)
+
+// Returns a free-running 32-bit count of CPU cycles. Targets without a cycle
+// counter that instrumentation reads directly must provide this.
+extern "C" uint32_t pw_interrupt_InstrumentationCycles(void);
+
+#endif
+
+namespace pw::interrupt {
+
+/// Returns the cycle count that instrumented handlers are timed with.
+///
+/// On Cortex-M cores with a DWT, this is `DWT_CYCCNT`; on RISC-V, this is the
+/// `mcycle` CSR. Other targets must provide
+/// `pw_interrupt_InstrumentationCycles()`.
+inline uint32_t InstrumentationCycles() {
+#if _PW_INTERRUPT_DWT_CYCLE_COUNTER
+  return *reinterpret_cast<volatile uint32_t*>(0xE0001004u);  // DWT_CYCCNT
+#elif defined(__riscv)
+  uint32_t cycles;
+  asm volatile("csrr %0, mcycle" : "=r"(cycles));
+  return cycles;
+#else
+  return pw_interrupt_InstrumentationCycles();
+#endif
+}
+
+/// Starts the cycle counter returned by `InstrumentationCycles()`, if it is
+/// not already running. On Cortex-M, this enables the DWT; the counter of
+/// other targets runs from reset.
+void EnableInstrumentationCycleCounter();
+
+#if _PW_ARCH_ARM_CORTEX_M
+
+/// Returns the number of cycles since the SysTick counter last wrapped, which
+/// is the entry latency of the SysTick handler when read at its start.
+///
+/// This is only accurate if SysTick is clocked by the CPU.
+inline uint32_t SysTickLatencyCycles() {
+  const uint32_t reload = *reinterpret_cast<volatile uint32_t*>(0xE000E014u);
+  const uint32_t current = *reinterpret_cast<volatile uint32_t*>(0xE000E018u);
+  return reload - current;
+}
+
+#endif  // _PW_ARCH_ARM_CORTEX_M
+
+/// Returns the number of instrumented handlers that are running, including
+/// handlers that have been preempted.
+uint32_t InstrumentedNestingDepth();
+
+/// Metrics for the handler of one interrupt.
+///
+/// The metrics are kept in a group named by the IRQ number, so that they can be
+/// dumped or exported with `pw::metric::MetricService` like any other group.
+/// Durations and latencies are in the cycles of `InstrumentationCycles()`.
+///
+/// Metrics are updated by the handler of their interrupt, which cannot preempt
+/// itself, so they need no synchronization. Readers may see a partial update.
+class IrqMetrics {
+ public:
+  static constexpr size_t kDurationBuckets =
+      PW_INTERRUPT_INSTRUMENTATION_DURATION_BUCKETS;
+
+  explicit IrqMetrics(uint32_t irq) : group_(irq) {}
+
+  /// Creates the metrics as a child of `parent`.
+  IrqMetrics(uint32_t irq, metric::Group& parent)
+      : group_(irq, parent.children()) {}
+
+  IrqMetrics(const IrqMetrics&) = delete;
+  IrqMetrics& operator=(const IrqMetrics&) = delete;
+
+  /// Returns the IRQ number that names the metrics.
+  uint32_t irq() const { return group_.name(); }
+
+  const metric::Group& metric_group() const { return group_; }
+  metric::Group& metric_group() { return group_; }
+
+  /// Returns the number of times the handler ran.
+  uint32_t count() const { return count_.value(); }
+
+  /// Returns the longest duration of the handler, including the time it spent
+  /// preempted by other handlers.
+  uint32_t max_duration() const { return max_duration_.value(); }
+
+  /// Returns the longest time from the interrupt being raised to the start of
+  /// its handler, of the latencies that were recorded.
+  uint32_t max_latency() const { return max_latency_.value(); }
+
+  /// Returns the largest number of instrumented handlers that were running
+  /// when the handler ran, including itself.
+  uint32_t max_nesting_depth() const { return max_nesting_depth_.value(); }
+
+  /// Returns the histogram of the handler's durations.
+  const metric::Histogram<kDurationBuckets>& durations() const {
+    return durations_;
+  }
+
+  /// Records a run of the handler.
+  void RecordRun(uint32_t duration, uint32_t nesting_depth);
+
+  /// Records the entry latency of the handler.
+  void RecordLatency(uint32_t latency);
+
+ private:
+  metric::Group group_;
+  PW_METRIC(group_, count_, "count", 0u);
+  PW_METRIC(group_, max_duration_, "max_duration", 0u);
+  PW_METRIC(group_, max_latency_, "max_latency", 0u);
+  PW_METRIC(group_, max_nesting_depth_, "max_nesting_depth", 0u);
+  PW_METRIC_HISTOGRAM(group_, durations_, "durations", kDurationBuckets);
+};
+
+namespace internal {
+
+// Only modified by instrumented handlers. A handler that preempts another
+// restores the depth before returning, so the increments and decrements don't
+// need to be atomic.
+inline volatile uint32_t instrumented_nesting_depth = 0;
+
+}  // namespace internal
+
+/// Records the run of an interrupt handler in `IrqMetrics`, from construction
+/// to destruction. Use the `PW_INTERRUPT_INSTRUMENT_IRQ` macros instead, which
+/// compile to nothing when instrumentation is disabled.
+class ScopedIrq {
+ public:
+  explicit ScopedIrq(IrqMetrics& metrics)
+      : metrics_(metrics),
+        nesting_depth_(internal::instrumented_nesting_depth + 1) {
+    internal::instrumented_nesting_depth = nesting_depth_;
+    start_ = InstrumentationCycles();
+  }
+
+  /// Also records the entry latency of the handler.
+  ScopedIrq(IrqMetrics& metrics, uint32_t latency) : ScopedIrq(metrics) {
+    metrics_.RecordLatency(latency);
+  }
+
+  ~ScopedIrq() {
+    const uint32_t duration = InstrumentationCycles() - start_;
+    metrics_.RecordRun(duration, nesting_depth_);
+    internal::instrumented_nesting_depth = nesting_depth_ - 1;
+  }
+
+  ScopedIrq(const ScopedIrq&) = delete;
+  ScopedIrq& operator=(const ScopedIrq&) = delete;
+
+ private:
+  IrqMetrics& metrics_;
+  uint32_t nesting_depth_;
+  uint32_t start_;
+};
+
+}  // namespace pw::interrupt
+
+/// Declares `pw::interrupt::IrqMetrics` for an IRQ number, optionally as a
+/// child of a metric group. Expands to nothing when instrumentation is
+/// disabled, so it must be used on its own at namespace scope.
+///
+/// @code{.cpp}
+///   PW_INTERRUPT_IRQ_METRICS(uart0_irq_metrics, UART0_IRQn, irq_group);
+///
+///   extern "C" void UART0_IRQHandler() {
+///     PW_INTERRUPT_INSTRUMENT_IRQ(uart0_irq_metrics);
+///     ...
+///   }
+/// @endcode
+#define PW_INTERRUPT_IRQ_METRICS(variable, ...) \
+  _PW_INTERRUPT_IRQ_METRICS(variable, __VA_ARGS__)
+
+/// Records the run of the enclosing handler, from this statement to the end of
+/// the scope, in `IrqMetrics` declared by `PW_INTERRUPT_IRQ_METRICS`.
+#define PW_INTERRUPT_INSTRUMENT_IRQ(metrics) \
+  _PW_INTERRUPT_INSTRUMENT_IRQ(metrics)
+
+/// Like `PW_INTERRUPT_INSTRUMENT_IRQ`, but also records the entry latency of
+/// the handler. `latency` is not evaluated when instrumentation is disabled.
+#define PW_INTERRUPT_INSTRUMENT_IRQ_WITH_LATENCY(metrics, latency) \
+  _PW_INTERRUPT_INSTRUMENT_IRQ_WITH_LATENCY(metrics, latency)
+
+#if PW_INTERRUPT_INSTRUMENTATION_ENABLED
+
+#define _PW_INTERRUPT_IRQ_METRICS(variable, ...) \
+  ::pw::interrupt::IrqMetrics variable(__VA_ARGS__)
+
+#define _PW_INTERRUPT_INSTRUMENT_IRQ(metrics) \
+  ::pw::interrupt::ScopedIrq _pw_interrupt_scoped_irq(metrics)
+
+#define _PW_INTERRUPT_INSTRUMENT_IRQ_WITH_LATENCY(metrics, latency) \
+  ::pw::interrupt::ScopedIrq _pw_interrupt_scoped_irq(metrics, latency)
+
+#else
+
+#define _PW_INTERRUPT_IRQ_METRICS(variable, ...) \
+  static_assert(true, "Interrupt instrumentation is disabled")
+
+#define _PW_INTERRUPT_INSTRUMENT_IRQ(metrics) static_cast<void>(0)
+
+#define _PW_INTERRUPT_INSTRUMENT_IRQ_WITH_LATENCY(metrics, latency) \
+  static_cast<void>(0)
+
+#endif  // PW_INTERRUPT_INSTRUMENTATION_ENABLED
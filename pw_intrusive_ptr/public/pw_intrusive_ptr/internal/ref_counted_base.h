@@ -34,6 +34,10 @@ class RefCountedBase {
   // Increments reference counter.
   void AddRef() const;
 
+  // Increments reference counter unless it is zero. Returns false if the
+  // counter was zero.
+  [[nodiscard]] bool TryAddRef() const;
+
   // Decrements reference count and returns true if the object should be
   // deleted.
   [[nodiscard]] bool ReleaseRef() const;
@@ -47,4 +51,29 @@ class RefCountedBase {
   mutable std::atomic_int32_t ref_count_{0};
 };
 
+// Reference counter base for objects with weak references.
+//
+// Weak references keep the object, including its counters, alive, but only
+// strong references may access it. All strong references together hold one
+// weak reference, which is released with the last strong reference.
+class WeakRefCountedBase : public RefCountedBase {
+ protected:
+  constexpr WeakRefCountedBase() = default;
+  ~WeakRefCountedBase();
+
+  // Decrements reference count and returns true if the object should be
+  // deleted, i.e. if there are no strong or weak references left.
+  [[nodiscard]] bool ReleaseRef() const;
+
+  // Increments weak reference counter.
+  void AddWeakRef() const;
+
+  // Decrements weak reference count and returns true if the object should be
+  // deleted.
+  [[nodiscard]] bool ReleaseWeakRef() const;
+
+ private:
+  mutable std::atomic_int32_t weak_ref_count_{1};
+};
+
 }  // namespace pw::internal
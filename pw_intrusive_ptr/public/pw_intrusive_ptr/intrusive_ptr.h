@@ -22,14 +22,17 @@
 
 namespace pw {
 
+template <typename T>
+class WeakPtr;
+
 // Shared pointer that relies on the stored object for the refcounting.
 //
 // T should be either a subclass of `RefCounted` (preferred way) or
 // implement AddRef()/ReleaseRef() by itself.
 //
-// IntrusivePtr API follows the std::shared_ptr API, but doesn't provide weak
-// pointers and some of the functionality such as reset(), owner_before(),
-// operator[] or unique().
+// IntrusivePtr API follows the std::shared_ptr API, but doesn't provide some
+// of the functionality such as reset(), owner_before(), operator[] or unique().
+// Weak pointers are provided by pw::WeakPtr for subclasses of `WeakRefCounted`.
 //
 // Similar to the std::make_shared for the std::shared_ptr, IntrusivePtr
 // provides the MakeRefCounted() helper.
@@ -125,6 +128,14 @@ class IntrusivePtr final {
   template <typename U>
   friend class IntrusivePtr;
 
+  template <typename U>
+  friend class WeakPtr;
+
+  struct AdoptRef {};
+
+  // Takes over a reference that was already added.
+  IntrusivePtr(T* p, AdoptRef) : ptr_(p) {}
+
   // Compilation-time verification that we can convert from IntrusivePtr<U> to
   // IntrusivePtr<T>.
   template <typename U>
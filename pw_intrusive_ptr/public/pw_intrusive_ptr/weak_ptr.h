@@ -0,0 +1,128 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "pw_intrusive_ptr/internal/ref_counted_base.h"
+#include "pw_intrusive_ptr/intrusive_ptr.h"
+
+namespace pw {
+
+// Weak pointer to an object owned by IntrusivePtrs.
+//
+// T must be a subclass of `WeakRefCounted`. WeakPtr API follows the
+// std::weak_ptr API: a WeakPtr doesn't give access to the object, but lock()
+// returns an IntrusivePtr to it as long as any IntrusivePtr to it exists.
+//
+// Since the reference counters are stored in the object, a WeakPtr keeps the
+// object's memory alive. The object is destroyed, or recycled if it is
+// Recyclable, once both the last IntrusivePtr and the last WeakPtr to it are
+// gone. Keep WeakPtrs to objects that hold other resources short-lived.
+//
+// Like IntrusivePtr, WeakPtr doesn't provide any thread-safety guarantees for
+// the pointer object itself, but its reference counting is atomic.
+template <typename T>
+class WeakPtr final {
+ public:
+  using element_type = T;
+
+  // Constructs an empty WeakPtr.
+  constexpr WeakPtr() : ptr_(nullptr) {}
+
+  // Constructs an empty WeakPtr.
+  //
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  constexpr WeakPtr(std::nullptr_t) : WeakPtr() {}
+
+  // Constructs a WeakPtr to the object owned by an IntrusivePtr.
+  //
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  WeakPtr(const IntrusivePtr<T>& ptr) : WeakPtr(ptr.get()) {}
+
+  WeakPtr(const WeakPtr& other) : WeakPtr(other.ptr_) {}
+
+  WeakPtr(WeakPtr&& other) noexcept
+      : ptr_(std::exchange(other.ptr_, nullptr)) {}
+
+  WeakPtr& operator=(const WeakPtr& other) {
+    if (&other == this) {
+      return *this;
+    }
+    WeakPtr(other).swap(*this);
+    return *this;
+  }
+
+  WeakPtr& operator=(WeakPtr&& other) noexcept {
+    if (&other == this) {
+      return *this;
+    }
+    WeakPtr(std::move(other)).swap(*this);
+    return *this;
+  }
+
+  ~WeakPtr() {
+    T* ptr = std::exchange(ptr_, nullptr);
+    if (ptr && ptr->ReleaseWeakRef()) {
+      IntrusivePtr<T>::recycle_or_delete(ptr);
+    }
+  }
+
+  void swap(WeakPtr& other) { std::swap(ptr_, other.ptr_); }
+
+  // Returns an IntrusivePtr to the object, or an empty IntrusivePtr if the
+  // object has expired.
+  IntrusivePtr<T> lock() const {
+    if (ptr_ == nullptr || !ptr_->TryAddRef()) {
+      return nullptr;
+    }
+    return IntrusivePtr<T>(ptr_, typename IntrusivePtr<T>::AdoptRef());
+  }
+
+  // Returns true if no IntrusivePtr to the object is left.
+  bool expired() const { return ptr_ == nullptr || ptr_->ref_count() == 0; }
+
+ private:
+  explicit WeakPtr(T* ptr) : ptr_(ptr) {
+    if (ptr_) {
+      ptr_->AddWeakRef();
+    }
+  }
+
+  T* ptr_;
+};
+
+// Base class to be used with the IntrusivePtr and WeakPtr. Doesn't provide any
+// public methods.
+//
+// Like `RefCounted`, provides atomic reference counting, with an additional
+// weak reference counter. WeakRefCounted MUST never be used as a pointer type
+// to store derived objects - it doesn't provide a virtual destructor.
+template <typename T>
+class WeakRefCounted : private internal::WeakRefCountedBase {
+ public:
+  // Type aliases for the IntrusivePtr and WeakPtr of ref-counted type.
+  using Ptr = IntrusivePtr<T>;
+  using WeakPtr = ::pw::WeakPtr<T>;
+
+ private:
+  template <typename U>
+  friend class IntrusivePtr;
+
+  template <typename U>
+  friend class ::pw::WeakPtr;
+};
+
+}  // namespace pw
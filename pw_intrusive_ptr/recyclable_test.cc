@@ -18,7 +18,9 @@
 
 #include <utility>
 
+#include "pw_allocator/typed_pool.h"
 #include "pw_intrusive_ptr/intrusive_ptr.h"
+#include "pw_intrusive_ptr/weak_ptr.h"
 #include "pw_unit_test/framework.h"
 
 namespace pw {
@@ -53,6 +55,21 @@ class TestItemNonRecyclable : public RefCounted<TestItemNonRecyclable> {
   void pw_recycle() { recycle_counter++; }
 };
 
+// Class that returns itself to the pool it was allocated from.
+class PooledItem : public WeakRefCounted<PooledItem>,
+                   public Recyclable<PooledItem> {
+ public:
+  using Pool = allocator::TypedPool<PooledItem>;
+
+  explicit PooledItem(Pool& pool) : pool_(pool) {}
+
+ private:
+  friend class Recyclable<PooledItem>;
+  void pw_recycle() { pool_.Delete(this); }
+
+  Pool& pool_;
+};
+
 class RecyclableTest : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -85,5 +102,22 @@ TEST_F(RecyclableTest, NonRecyclableWithPwRecycleMethod) {
   EXPECT_EQ(TestItemNonRecyclable::recycle_counter, 0);
 }
 
+TEST_F(RecyclableTest, RecyclesIntoPool) {
+  PooledItem::Pool::Buffer<1> buffer;
+  PooledItem::Pool pool(buffer);
+
+  PooledItem::Ptr ptr(pool.New(pool));
+  ASSERT_NE(ptr, nullptr);
+  PooledItem::WeakPtr weak(ptr);
+  EXPECT_EQ(pool.New(pool), nullptr);
+
+  // The pool's only slot is returned once the last reference is gone.
+  ptr = nullptr;
+  EXPECT_EQ(pool.New(pool), nullptr);
+  weak = nullptr;
+  PooledItem::Ptr reused(pool.New(pool));
+  EXPECT_NE(reused, nullptr);
+}
+
 }  // namespace
 }  // namespace pw
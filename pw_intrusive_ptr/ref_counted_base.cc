@@ -41,6 +41,19 @@ void RefCountedBase::AddRef() const {
   PW_DCHECK(refs >= 0);
 }
 
+bool RefCountedBase::TryAddRef() const {
+  auto refs = ref_count_.load(std::memory_order_relaxed);
+  do {
+    // Once the count reaches zero, the object is being destroyed and must not
+    // be revived.
+    if (refs <= 0) {
+      return false;
+    }
+  } while (!ref_count_.compare_exchange_weak(
+      refs, refs + 1, std::memory_order_relaxed));
+  return true;
+}
+
 bool RefCountedBase::ReleaseRef() const {
   // We don't follow the boost::intrusive_ptr/fit::RefPtr approach here with a
   // release fetch_sub and acquire fence afterwards due to TSAN not supporting
@@ -58,4 +71,29 @@ bool RefCountedBase::ReleaseRef() const {
   return refs == 1;
 }
 
+WeakRefCountedBase::~WeakRefCountedBase() {
+  // Poison the weak count as well; see ~RefCountedBase().
+  weak_ref_count_.store(static_cast<int32_t>(0xC0000000),
+                        std::memory_order_release);
+}
+
+bool WeakRefCountedBase::ReleaseRef() const {
+  return RefCountedBase::ReleaseRef() && ReleaseWeakRef();
+}
+
+void WeakRefCountedBase::AddWeakRef() const {
+  const auto refs = weak_ref_count_.fetch_add(1, std::memory_order_relaxed);
+
+  // Weak references are only created from live objects, which hold a weak
+  // reference through their strong references.
+  PW_DCHECK(refs >= 1);
+}
+
+bool WeakRefCountedBase::ReleaseWeakRef() const {
+  // See RefCountedBase::ReleaseRef() for the memory order.
+  const auto refs = weak_ref_count_.fetch_sub(1, std::memory_order_acq_rel);
+  PW_DCHECK(refs >= 1);
+  return refs == 1;
+}
+
 }  // namespace pw::internal
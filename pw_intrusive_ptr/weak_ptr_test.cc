@@ -0,0 +1,138 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_intrusive_ptr/weak_ptr.h"
+
+#include <stdint.h>
+
+#include <utility>
+
+#include "pw_intrusive_ptr/recyclable.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw {
+namespace {
+
+class TestItem : public WeakRefCounted<TestItem> {
+ public:
+  TestItem() { ++instance_counter; }
+  ~TestItem() { --instance_counter; }
+
+  inline static int32_t instance_counter = 0;
+
+  int32_t value = 0;
+};
+
+class RecyclableTestItem : public WeakRefCounted<RecyclableTestItem>,
+                           public Recyclable<RecyclableTestItem> {
+ public:
+  inline static int32_t recycle_counter = 0;
+
+ private:
+  friend class Recyclable<RecyclableTestItem>;
+  void pw_recycle() {
+    recycle_counter++;
+    delete this;
+  }
+};
+
+class WeakPtrTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    TestItem::instance_counter = 0;
+    RecyclableTestItem::recycle_counter = 0;
+  }
+};
+
+TEST_F(WeakPtrTest, EmptyWeakPtrIsExpired) {
+  WeakPtr<TestItem> weak;
+  EXPECT_TRUE(weak.expired());
+  EXPECT_EQ(weak.lock(), nullptr);
+}
+
+TEST_F(WeakPtrTest, LockReturnsObjectWhileStrongRefsExist) {
+  TestItem::Ptr ptr = MakeRefCounted<TestItem>();
+  ptr->value = 42;
+  TestItem::WeakPtr weak(ptr);
+
+  EXPECT_FALSE(weak.expired());
+  EXPECT_EQ(ptr.use_count(), 1);
+  {
+    TestItem::Ptr locked = weak.lock();
+    ASSERT_EQ(locked, ptr);
+    EXPECT_EQ(locked->value, 42);
+    EXPECT_EQ(ptr.use_count(), 2);
+  }
+  EXPECT_EQ(ptr.use_count(), 1);
+}
+
+TEST_F(WeakPtrTest, WeakPtrExpiresWithLastStrongRef) {
+  TestItem::Ptr ptr = MakeRefCounted<TestItem>();
+  TestItem::WeakPtr weak(ptr);
+  ptr = nullptr;
+
+  EXPECT_TRUE(weak.expired());
+  EXPECT_EQ(weak.lock(), nullptr);
+}
+
+TEST_F(WeakPtrTest, LastWeakPtrDeletesExpiredObject) {
+  TestItem::Ptr ptr = MakeRefCounted<TestItem>();
+  TestItem::WeakPtr weak(ptr);
+  TestItem::WeakPtr weak_copy = weak;
+  ptr = nullptr;
+  EXPECT_EQ(TestItem::instance_counter, 1);
+
+  weak = nullptr;
+  EXPECT_EQ(TestItem::instance_counter, 1);
+  weak_copy = nullptr;
+  EXPECT_EQ(TestItem::instance_counter, 0);
+}
+
+TEST_F(WeakPtrTest, LastStrongPtrDeletesObjectWithoutWeakPtrs) {
+  TestItem::Ptr ptr = MakeRefCounted<TestItem>();
+  { TestItem::WeakPtr weak(ptr); }
+  EXPECT_EQ(TestItem::instance_counter, 1);
+  ptr = nullptr;
+  EXPECT_EQ(TestItem::instance_counter, 0);
+}
+
+TEST_F(WeakPtrTest, MovingWeakPtrKeepsReference) {
+  TestItem::Ptr ptr = MakeRefCounted<TestItem>();
+  TestItem::WeakPtr weak(ptr);
+  TestItem::WeakPtr moved = std::move(weak);
+
+  EXPECT_EQ(moved.lock(), ptr);
+  ptr = nullptr;
+  EXPECT_EQ(TestItem::instance_counter, 1);
+  moved = nullptr;
+  EXPECT_EQ(TestItem::instance_counter, 0);
+}
+
+TEST_F(WeakPtrTest, ConstWeakPtr) {
+  IntrusivePtr<const TestItem> ptr = MakeRefCounted<TestItem>();
+  WeakPtr<const TestItem> weak(ptr);
+  EXPECT_EQ(weak.lock(), ptr);
+}
+
+TEST_F(WeakPtrTest, LastWeakPtrRecyclesExpiredObject) {
+  RecyclableTestItem::Ptr ptr = MakeRefCounted<RecyclableTestItem>();
+  RecyclableTestItem::WeakPtr weak(ptr);
+  ptr = nullptr;
+  EXPECT_EQ(RecyclableTestItem::recycle_counter, 0);
+  weak = nullptr;
+  EXPECT_EQ(RecyclableTestItem::recycle_counter, 1);
+}
+
+}  // namespace
+}  // namespace pw
@@ -0,0 +1,458 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_json/parser.h"
+
+#include <cstring>
+#include <limits>
+
+#include "pw_status/try.h"
+
+namespace pw {
+namespace {
+
+constexpr bool IsWhitespace(int c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+constexpr bool IsDigit(int c) { return c >= '0' && c <= '9'; }
+
+constexpr int HexDigitValue(int c) {
+  if (IsDigit(c)) {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+// Reads the four hex digits of a \u escape, which the parser has validated.
+uint32_t ReadHex4(std::string_view digits) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    value = (value << 4) | static_cast<uint32_t>(HexDigitValue(digits[i]));
+  }
+  return value;
+}
+
+constexpr bool IsHighSurrogate(uint32_t value) {
+  return value >= 0xD800 && value <= 0xDBFF;
+}
+
+constexpr bool IsLowSurrogate(uint32_t value) {
+  return value >= 0xDC00 && value <= 0xDFFF;
+}
+
+// Encodes a code point as UTF-8. Returns the number of bytes written.
+size_t EncodeUtf8(uint32_t code_point, char* out) {
+  if (code_point < 0x80) {
+    out[0] = static_cast<char>(code_point);
+    return 1;
+  }
+  if (code_point < 0x800) {
+    out[0] = static_cast<char>(0xC0 | (code_point >> 6));
+    out[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+    return 2;
+  }
+  if (code_point < 0x10000) {
+    out[0] = static_cast<char>(0xE0 | (code_point >> 12));
+    out[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+    return 3;
+  }
+  out[0] = static_cast<char>(0xF0 | (code_point >> 18));
+  out[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+  out[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+  out[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+  return 4;
+}
+
+}  // namespace
+
+Status JsonParser::Next() {
+  PW_TRY(status_);
+  has_escapes_ = false;
+
+  while (true) {
+    const int c = SkipWhitespace();
+    PW_TRY(status_);
+
+    switch (expect_) {
+      case Expect::kDone:
+        if (c != kEndOfInput) {
+          return Fail(Status::DataLoss());  // Characters after the JSON.
+        }
+        return Status::OutOfRange();
+      case Expect::kColon:
+        if (c != ':') {
+          return Fail(Status::DataLoss());
+        }
+        position_ += 1;
+        expect_ = Expect::kValue;
+        continue;
+      case Expect::kCommaOrEnd:
+        if (c == ',') {
+          position_ += 1;
+          expect_ = in_object() ? Expect::kKey : Expect::kValue;
+          continue;
+        }
+        return Close(c);
+      case Expect::kFirstKeyOrEnd:
+        if (c == '}') {
+          return Close(c);
+        }
+        [[fallthrough]];
+      case Expect::kKey:
+        if (c != '"') {
+          return Fail(Status::DataLoss());
+        }
+        return String(JsonToken::kKey);
+      case Expect::kFirstValueOrEnd:
+        if (c == ']') {
+          return Close(c);
+        }
+        [[fallthrough]];
+      case Expect::kValue:
+        return Value(c);
+    }
+  }
+}
+
+Status JsonParser::SkipValue() {
+  PW_TRY(status_);
+  if (token_ != JsonToken::kStartObject && token_ != JsonToken::kStartArray) {
+    return OkStatus();
+  }
+
+  const size_t start_depth = depth();
+  const JsonToken end = token_ == JsonToken::kStartObject
+                            ? JsonToken::kEndObject
+                            : JsonToken::kEndArray;
+  do {
+    PW_TRY(Next());
+  } while (token_ != end || depth() != start_depth);
+  return OkStatus();
+}
+
+StatusWithSize JsonParser::UnescapeString(span<char> buffer) const {
+  if (token_ != JsonToken::kKey && token_ != JsonToken::kString) {
+    return StatusWithSize::FailedPrecondition();
+  }
+
+  const std::string_view escaped = text();
+  size_t written = 0;
+  for (size_t i = 0; i < escaped.size();) {
+    char c = escaped[i++];
+    if (c != '\\') {
+      if (written == buffer.size()) {
+        return StatusWithSize::ResourceExhausted(written);
+      }
+      buffer[written++] = c;
+      continue;
+    }
+
+    // The parser checked that escape sequences are complete and valid.
+    char utf8[4];
+    size_t utf8_size = 1;
+    switch (c = escaped[i++]) {
+      case 'b':
+        utf8[0] = '\b';
+        break;
+      case 'f':
+        utf8[0] = '\f';
+        break;
+      case 'n':
+        utf8[0] = '\n';
+        break;
+      case 'r':
+        utf8[0] = '\r';
+        break;
+      case 't':
+        utf8[0] = '\t';
+        break;
+      case 'u': {
+        uint32_t code_point = ReadHex4(escaped.substr(i));
+        i += 4;
+        if (IsHighSurrogate(code_point)) {
+          if (escaped.substr(i, 2) != "\\u") {
+            return StatusWithSize::DataLoss(written);
+          }
+          const uint32_t low = ReadHex4(escaped.substr(i + 2));
+          if (!IsLowSurrogate(low)) {
+            return StatusWithSize::DataLoss(written);
+          }
+          i += 6;
+          code_point =
+              0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        } else if (IsLowSurrogate(code_point)) {
+          return StatusWithSize::DataLoss(written);
+        }
+        utf8_size = EncodeUtf8(code_point, utf8);
+        break;
+      }
+      default:  // ", \, or /
+        utf8[0] = c;
+        break;
+    }
+
+    if (utf8_size > buffer.size() - written) {
+      return StatusWithSize::ResourceExhausted(written);
+    }
+    std::memcpy(&buffer[written], utf8, utf8_size);
+    written += utf8_size;
+  }
+  return StatusWithSize(written);
+}
+
+Result<int64_t> JsonParser::IntValue() const {
+  if (token_ != JsonToken::kNumber) {
+    return Status::FailedPrecondition();
+  }
+
+  const std::string_view number = text();
+  const bool negative = number.front() == '-';
+  uint64_t magnitude = 0;
+  for (size_t i = negative ? 1 : 0; i < number.size(); ++i) {
+    if (!IsDigit(number[i])) {
+      return Status::InvalidArgument();  // Fraction or exponent
+    }
+    const uint64_t digit = static_cast<uint64_t>(number[i] - '0');
+    if (magnitude > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+      return Status::OutOfRange();
+    }
+    magnitude = magnitude * 10 + digit;
+  }
+
+  constexpr uint64_t kMaxPositive = std::numeric_limits<int64_t>::max();
+  if (magnitude > kMaxPositive + (negative ? 1 : 0)) {
+    return Status::OutOfRange();
+  }
+  if (negative) {
+    return magnitude == 0 ? 0 : -static_cast<int64_t>(magnitude - 1) - 1;
+  }
+  return static_cast<int64_t>(magnitude);
+}
+
+bool JsonParser::Fill() {
+  if (reader_ == nullptr || end_of_stream_ || !status_.ok()) {
+    return false;
+  }
+
+  // Move the token being parsed to the start of the buffer, discarding the
+  // characters before it.
+  if (token_start_ != 0) {
+    std::memmove(buffer_.data(), data_ + token_start_, size_ - token_start_);
+    size_ -= token_start_;
+    position_ -= token_start_;
+    token_start_ = 0;
+  }
+  if (size_ == buffer_.size()) {
+    Fail(Status::ResourceExhausted());  // The token does not fit.
+    return false;
+  }
+
+  while (true) {
+    Result<ByteSpan> read =
+        reader_->Read(as_writable_bytes(buffer_.subspan(size_)));
+    if (read.status().IsOutOfRange()) {
+      end_of_stream_ = true;
+      return false;
+    }
+    if (!read.ok()) {
+      Fail(read.status());
+      return false;
+    }
+    if (!read->empty()) {
+      size_ += read->size();
+      return true;
+    }
+  }
+}
+
+int JsonParser::SkipWhitespace() {
+  while (true) {
+    token_start_ = position_;
+    const int c = Peek();
+    if (!IsWhitespace(c)) {
+      return c;
+    }
+    position_ += 1;
+  }
+}
+
+Status JsonParser::Value(int c) {
+  switch (c) {
+    case '{':
+      return Open(JsonToken::kStartObject, /*object=*/true);
+    case '[':
+      return Open(JsonToken::kStartArray, /*object=*/false);
+    case '"':
+      return String(JsonToken::kString);
+    case 't':
+      return Literal(JsonToken::kTrue, "true");
+    case 'f':
+      return Literal(JsonToken::kFalse, "false");
+    case 'n':
+      return Literal(JsonToken::kNull, "null");
+    default:
+      if (c == '-' || IsDigit(c)) {
+        return Number();
+      }
+      return Fail(Status::DataLoss());
+  }
+}
+
+Status JsonParser::Open(JsonToken token, bool object) {
+  if (depth_ == kMaxDepth) {
+    return Fail(Status::ResourceExhausted());
+  }
+  position_ += 1;
+  if (object) {
+    objects_ |= 1u << depth_;
+  } else {
+    objects_ &= ~(1u << depth_);
+  }
+  depth_ += 1;
+  SetToken(token);
+  expect_ = object ? Expect::kFirstKeyOrEnd : Expect::kFirstValueOrEnd;
+  return OkStatus();
+}
+
+Status JsonParser::Close(int c) {
+  const bool object = in_object();
+  if (c != (object ? '}' : ']')) {
+    return Fail(Status::DataLoss());
+  }
+  position_ += 1;
+  SetToken(object ? JsonToken::kEndObject : JsonToken::kEndArray);
+  depth_ -= 1;
+  AfterValue();
+  return OkStatus();
+}
+
+Status JsonParser::String(JsonToken token) {
+  position_ += 1;  // Opening quote
+  while (true) {
+    int c = Peek();
+    if (c == kEndOfInput) {
+      return Fail(Status::DataLoss());
+    }
+    position_ += 1;
+    if (c == '"') {
+      break;
+    }
+    if (c < 0x20) {
+      return Fail(Status::DataLoss());  // Control characters must be escaped.
+    }
+    if (c != '\\') {
+      continue;
+    }
+
+    has_escapes_ = true;
+    c = Peek();
+    position_ += 1;
+    switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+      case 'b':
+      case 'f':
+      case 'n':
+      case 'r':
+      case 't':
+        break;
+      case 'u':
+        for (int i = 0; i < 4; ++i) {
+          if (HexDigitValue(Peek()) < 0) {
+            return Fail(Status::DataLoss());
+          }
+          position_ += 1;
+        }
+        break;
+      default:
+        return Fail(Status::DataLoss());
+    }
+  }
+
+  SetToken(token, /*trim=*/1);
+  if (token == JsonToken::kKey) {
+    expect_ = Expect::kColon;
+  } else {
+    AfterValue();
+  }
+  return OkStatus();
+}
+
+Status JsonParser::Number() {
+  if (Peek() == '-') {
+    position_ += 1;
+  }
+
+  // A number may not have leading zeros.
+  if (Peek() == '0') {
+    position_ += 1;
+  } else if (IsDigit(Peek())) {
+    while (IsDigit(Peek())) {
+      position_ += 1;
+    }
+  } else {
+    return Fail(Status::DataLoss());
+  }
+
+  if (Peek() == '.') {
+    position_ += 1;
+    if (!IsDigit(Peek())) {
+      return Fail(Status::DataLoss());
+    }
+    while (IsDigit(Peek())) {
+      position_ += 1;
+    }
+  }
+
+  if (const int c = Peek(); c == 'e' || c == 'E') {
+    position_ += 1;
+    if (const int sign = Peek(); sign == '+' || sign == '-') {
+      position_ += 1;
+    }
+    if (!IsDigit(Peek())) {
+      return Fail(Status::DataLoss());
+    }
+    while (IsDigit(Peek())) {
+      position_ += 1;
+    }
+  }
+
+  PW_TRY(status_);  // The number may have ended due to a read error.
+  SetToken(JsonToken::kNumber);
+  AfterValue();
+  return OkStatus();
+}
+
+Status JsonParser::Literal(JsonToken token, std::string_view literal) {
+  for (char expected : literal) {
+    if (Peek() != expected) {
+      return Fail(Status::DataLoss());
+    }
+    position_ += 1;
+  }
+  SetToken(token);
+  AfterValue();
+  return OkStatus();
+}
+
+}  // namespace pw
@@ -0,0 +1,98 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "pw_json/parser.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw {
+namespace {
+
+// A device configuration, typical of what an embedded device receives.
+constexpr std::string_view kConfig = R"({
+  "device": {"name": "sensor-hub", "serial": "SH-0042", "revision": 3},
+  "sampling": {"rate_hz": 200, "oversample": 4, "filter": "lowpass"},
+  "channels": [
+    {"id": 0, "enabled": true, "gain": 1.25, "offset": -12},
+    {"id": 1, "enabled": true, "gain": 0.75, "offset": 8},
+    {"id": 2, "enabled": false, "gain": 1.0, "offset": 0},
+    {"id": 3, "enabled": true, "gain": 2.5e-1, "offset": 1024}
+  ],
+  "network": {"ssid": "lab\tnet", "retries": 5, "proxy": null},
+  "labels": ["temperature", "humidity", "pressure", "light"]
+})";
+
+// Strings with escape sequences, to measure unescaping.
+constexpr std::string_view kEscapedStrings = R"([
+  "line one\nline two\nline three",
+  "tab\tseparated\tvalues\there",
+  "quoted \"text\" and a backslash \\",
+  "caf\u00e9 \u20ac5 \ud83d\ude00"
+])";
+
+void ParseTest(perf_test::State& state, std::string_view json) {
+  while (state.KeepRunning()) {
+    JsonParser parser(json);
+    while (parser.Next().ok()) {
+    }
+  }
+}
+
+void StreamParseTest(perf_test::State& state, std::string_view json) {
+  std::array<char, 32> buffer;
+  while (state.KeepRunning()) {
+    stream::MemoryReader reader(as_bytes(span(json)));
+    JsonStreamParser parser(reader, buffer);
+    while (parser.Next().ok()) {
+    }
+  }
+}
+
+void SkipValuesTest(perf_test::State& state, std::string_view json) {
+  while (state.KeepRunning()) {
+    JsonParser parser(json);
+    if (!parser.Next().ok()) {
+      continue;
+    }
+    while (parser.Next().ok() && parser.token() == JsonToken::kKey) {
+      if (!parser.Next().ok() || !parser.SkipValue().ok()) {
+        break;
+      }
+    }
+  }
+}
+
+void UnescapeTest(perf_test::State& state, std::string_view json) {
+  std::array<char, 64> buffer;
+  while (state.KeepRunning()) {
+    JsonParser parser(json);
+    while (parser.Next().ok()) {
+      if (parser.token() == JsonToken::kString) {
+        parser.UnescapeString(buffer).IgnoreError();
+      }
+    }
+  }
+}
+
+PW_PERF_TEST(ParseConfig, ParseTest, kConfig);
+PW_PERF_TEST(StreamParseConfig, StreamParseTest, kConfig);
+PW_PERF_TEST(SkipConfigValues, SkipValuesTest, kConfig);
+PW_PERF_TEST(UnescapeStrings, UnescapeTest, kEscapedStrings);
+
+}  // namespace
+}  // namespace pw
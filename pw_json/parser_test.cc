@@ -0,0 +1,276 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_json/parser.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#include "pw_status/try.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using namespace std::string_view_literals;
+
+using ::pw::JsonParser;
+using ::pw::JsonStreamParser;
+using ::pw::JsonToken;
+using ::pw::OkStatus;
+using ::pw::Status;
+
+struct Expected {
+  JsonToken token;
+  std::string_view text;
+  size_t depth;
+};
+
+constexpr std::string_view kConfig = R"({
+  "name": "sensor\tA",
+  "rate_hz": 100,
+  "gain": -1.5e3,
+  "channels": [1, 2, {"enabled": true}],
+  "calibration": null,
+  "empty": {},
+  "flags": [false, []]
+})";
+
+constexpr Expected kConfigTokens[] = {
+    {JsonToken::kStartObject, "{", 1},
+    {JsonToken::kKey, "name", 1},
+    {JsonToken::kString, "sensor\\tA", 1},
+    {JsonToken::kKey, "rate_hz", 1},
+    {JsonToken::kNumber, "100", 1},
+    {JsonToken::kKey, "gain", 1},
+    {JsonToken::kNumber, "-1.5e3", 1},
+    {JsonToken::kKey, "channels", 1},
+    {JsonToken::kStartArray, "[", 2},
+    {JsonToken::kNumber, "1", 2},
+    {JsonToken::kNumber, "2", 2},
+    {JsonToken::kStartObject, "{", 3},
+    {JsonToken::kKey, "enabled", 3},
+    {JsonToken::kTrue, "true", 3},
+    {JsonToken::kEndObject, "}", 3},
+    {JsonToken::kEndArray, "]", 2},
+    {JsonToken::kKey, "calibration", 1},
+    {JsonToken::kNull, "null", 1},
+    {JsonToken::kKey, "empty", 1},
+    {JsonToken::kStartObject, "{", 2},
+    {JsonToken::kEndObject, "}", 2},
+    {JsonToken::kKey, "flags", 1},
+    {JsonToken::kStartArray, "[", 2},
+    {JsonToken::kFalse, "false", 2},
+    {JsonToken::kStartArray, "[", 3},
+    {JsonToken::kEndArray, "]", 3},
+    {JsonToken::kEndArray, "]", 2},
+    {JsonToken::kEndObject, "}", 1},
+};
+
+void ExpectTokens(JsonParser& json, pw::span<const Expected> expected) {
+  for (const Expected& token : expected) {
+    ASSERT_EQ(json.Next(), OkStatus()) << token.text;
+    EXPECT_EQ(json.token(), token.token) << token.text;
+    EXPECT_EQ(json.text(), token.text);
+    EXPECT_EQ(json.depth(), token.depth) << token.text;
+  }
+  EXPECT_EQ(json.Next(), Status::OutOfRange());
+  EXPECT_EQ(json.status(), OkStatus());
+}
+
+TEST(JsonParser, ParsesAllTokens) {
+  JsonParser json(kConfig);
+  ExpectTokens(json, kConfigTokens);
+}
+
+// DOCSTAG: [pw-json-parser-example]
+pw::Status ReadRate(std::string_view config, int64_t& rate_hz) {
+  pw::JsonParser json(config);
+  while (json.Next().ok()) {
+    if (json.token() == JsonToken::kKey && json.text() == "rate_hz") {
+      PW_TRY(json.Next());
+      PW_TRY_ASSIGN(rate_hz, json.IntValue());
+    } else if (json.token() == JsonToken::kKey) {
+      PW_TRY(json.Next());
+      PW_TRY(json.SkipValue());  // Skip nested arrays and objects.
+    }
+  }
+  return json.status();
+}
+// DOCSTAG: [pw-json-parser-example]
+
+TEST(JsonParser, Example) {
+  int64_t rate_hz = 0;
+  ASSERT_EQ(ReadRate(kConfig, rate_hz), OkStatus());
+  EXPECT_EQ(rate_hz, 100);
+}
+
+TEST(JsonParser, StringsAreViewsOfTheInput) {
+  JsonParser json(kConfig);
+  ASSERT_EQ(json.Next(), OkStatus());
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.text().data(), kConfig.data() + kConfig.find("name"));
+  EXPECT_FALSE(json.has_escapes());
+
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_TRUE(json.has_escapes());
+}
+
+TEST(JsonParser, TopLevelValues) {
+  constexpr Expected kNumber[] = {{JsonToken::kNumber, "-0", 0}};
+  JsonParser number("  -0\n");
+  ExpectTokens(number, kNumber);
+
+  constexpr Expected kString[] = {{JsonToken::kString, "", 0}};
+  JsonParser string(R"("")");
+  ExpectTokens(string, kString);
+
+  constexpr Expected kFalse[] = {{JsonToken::kFalse, "false", 0}};
+  JsonParser literal("false");
+  ExpectTokens(literal, kFalse);
+}
+
+TEST(JsonParser, UnescapeString) {
+  JsonParser json(R"("a\"\\\/\b\f\n\r\t\u00e9\u20AC\ud83d\ude00")");
+  ASSERT_EQ(json.Next(), OkStatus());
+
+  std::array<char, 32> buffer;
+  pw::StatusWithSize result = json.UnescapeString(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(std::string_view(buffer.data(), result.size()),
+            "a\"\\/\b\f\n\r\t\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80"sv);
+
+  result = json.UnescapeString(pw::span(buffer).first(10));
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+}
+
+TEST(JsonParser, UnescapeString_UnpairedSurrogate) {
+  JsonParser json(R"(["\ud83d", "\ude00"])");
+  std::array<char, 8> buffer;
+
+  ASSERT_EQ(json.Next(), OkStatus());
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.UnescapeString(buffer).status(), Status::DataLoss());
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.UnescapeString(buffer).status(), Status::DataLoss());
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.UnescapeString(buffer).status(),
+            Status::FailedPrecondition());
+}
+
+TEST(JsonParser, IntValue) {
+  JsonParser json(
+      "[0, -42, 9223372036854775807, -9223372036854775808, "
+      "9223372036854775808, 99999999999999999999, 1.0, 1e2, true]");
+  ASSERT_EQ(json.Next(), OkStatus());
+
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.IntValue().value(), 0);
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.IntValue().value(), -42);
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.IntValue().value(), std::numeric_limits<int64_t>::max());
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.IntValue().value(), std::numeric_limits<int64_t>::min());
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.IntValue().status(), Status::OutOfRange());
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.IntValue().status(), Status::OutOfRange());
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.IntValue().status(), Status::InvalidArgument());
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.IntValue().status(), Status::InvalidArgument());
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.IntValue().status(), Status::FailedPrecondition());
+}
+
+TEST(JsonParser, SkipValue) {
+  JsonParser json(R"({"skip": {"a": [1, {"b": 2}]}, "keep": 3})");
+  ASSERT_EQ(json.Next(), OkStatus());
+  ASSERT_EQ(json.Next(), OkStatus());
+  ASSERT_EQ(json.Next(), OkStatus());
+  ASSERT_EQ(json.SkipValue(), OkStatus());
+  EXPECT_EQ(json.token(), JsonToken::kEndObject);
+
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.text(), "keep");
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.SkipValue(), OkStatus());  // Not an array or object.
+  EXPECT_EQ(json.text(), "3");
+}
+
+TEST(JsonParser, MalformedJson) {
+  constexpr std::string_view kMalformed[] = {
+      "",          " ",         "{",          "[1,]",        "[1 2]",
+      "{\"a\" 1}", "{\"a\":}",  "{\"a\":1,}", "{1:2}",       "{,}",
+      "[1]]",      "[1}",       "01",         "-",           "1.",
+      "1e",        "+1",        "tru",        "nul",         "\"abc",
+      "\"\\x\"",   "\"\\u12\"", "\"\x01\"",   "[\"a\":1]",   "{} {}",
+      "'a'",       "[,1]",      "{\"a\"}",    "[true false]"};
+
+  for (std::string_view malformed : kMalformed) {
+    JsonParser json(malformed);
+    Status status;
+    while ((status = json.Next()).ok()) {
+    }
+    EXPECT_EQ(status, Status::DataLoss()) << malformed;
+    EXPECT_EQ(json.status(), Status::DataLoss()) << malformed;
+    EXPECT_EQ(json.Next(), Status::DataLoss()) << malformed;
+  }
+}
+
+TEST(JsonParser, NestingLimit) {
+  std::array<char, JsonParser::kMaxDepth + 1> deep;
+  deep.fill('[');
+
+  JsonParser json(std::string_view(deep.data(), deep.size()));
+  for (size_t i = 0; i < JsonParser::kMaxDepth; ++i) {
+    ASSERT_EQ(json.Next(), OkStatus());
+  }
+  EXPECT_EQ(json.Next(), Status::ResourceExhausted());
+}
+
+TEST(JsonStreamParser, ParsesAllTokens) {
+  pw::stream::MemoryReader reader(pw::as_bytes(pw::span(kConfig)));
+  std::array<char, 16> buffer;
+  JsonStreamParser json(reader, buffer);
+  ExpectTokens(json, kConfigTokens);
+}
+
+TEST(JsonStreamParser, BufferOneLargerThanLongestToken) {
+  constexpr Expected kTokens[] = {
+      {JsonToken::kStartArray, "[", 1},
+      {JsonToken::kNumber, "7", 1},
+      {JsonToken::kEndArray, "]", 1},
+  };
+  pw::stream::MemoryReader reader(pw::as_bytes(pw::span(" [ 7 ] "sv)));
+  std::array<char, 2> buffer;
+  JsonStreamParser json(reader, buffer);
+  ExpectTokens(json, kTokens);
+}
+
+TEST(JsonStreamParser, TokenLargerThanBuffer) {
+  constexpr std::string_view kJson = R"({"a_long_key": 1})";
+  pw::stream::MemoryReader reader(pw::as_bytes(pw::span(kJson)));
+  std::array<char, 8> buffer;
+  JsonStreamParser json(reader, buffer);
+
+  ASSERT_EQ(json.Next(), OkStatus());
+  EXPECT_EQ(json.Next(), Status::ResourceExhausted());
+  EXPECT_EQ(json.status(), Status::ResourceExhausted());
+}
+
+}  // namespace
@@ -0,0 +1,270 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+/// @file pw_json/parser.h
+///
+/// `pw::JsonParser` is a pull parser that reads JSON one token at a time,
+/// without allocating memory or copying the input. Each call to `Next()`
+/// advances to the next key, value, or array or object boundary. Keys and
+/// string values are reported as views of the input, so they can be compared
+/// or used without first being copied into a buffer.
+///
+/// `pw::JsonStreamParser` parses JSON from a `pw::stream::Reader`, through a
+/// caller-provided buffer that only needs to fit the largest single token.
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_result/result.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw {
+
+/// @defgroup pw_json_parser_api
+/// @{
+
+/// The kinds of tokens reported by a `JsonParser`.
+enum class JsonToken : uint8_t {
+  kStartObject,  ///< `{`
+  kEndObject,    ///< `}`
+  kStartArray,   ///< `[`
+  kEndArray,     ///< `]`
+  kKey,          ///< A key in an object. `text()` is the key.
+  kString,       ///< A string value. `text()` is the string.
+  kNumber,       ///< A number. `text()` is the number as written.
+  kTrue,         ///< `true`
+  kFalse,        ///< `false`
+  kNull,         ///< `null`
+};
+
+/// Parses a single JSON value, array, or object from a string, one token at a
+/// time.
+///
+/// @code{.cpp}
+///   pw::JsonParser json(R"({"rate_hz": 100, "channels": [1, 2]})");
+///   while (json.Next().ok()) {
+///     if (json.token() == pw::JsonToken::kKey && json.text() == "rate_hz") {
+///       PW_TRY(json.Next());
+///       PW_TRY_ASSIGN(rate_hz, json.IntValue());
+///     }
+///   }
+///   PW_TRY(json.status());
+/// @endcode
+///
+/// The parser checks that the input is well-formed JSON as it goes, but does
+/// not check that strings are valid UTF-8. Errors are sticky: once `Next()`
+/// fails, it returns the same error from then on.
+class JsonParser {
+ public:
+  /// Arrays and objects may be nested at most this many levels deep,
+  /// including the top-level array or object.
+  static constexpr size_t kMaxDepth = 32;
+
+  /// Parses `json`, which must outlive the parser.
+  explicit constexpr JsonParser(std::string_view json)
+      : data_(json.data()), size_(json.size()) {}
+
+  JsonParser(const JsonParser&) = delete;
+  JsonParser& operator=(const JsonParser&) = delete;
+
+  /// Advances to the next token. Views returned by `text()` for the previous
+  /// token are invalidated.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Advanced to the next token.
+  ///
+  ///    OUT_OF_RANGE: The top-level value is complete, and the input ends.
+  ///
+  ///    DATA_LOSS: The input is not well-formed JSON.
+  ///
+  ///    RESOURCE_EXHAUSTED: Arrays and objects are nested more than
+  ///    ``kMaxDepth`` levels deep, or a ``JsonStreamParser`` token does not
+  ///    fit in its buffer.
+  ///
+  /// @endrst
+  ///
+  /// A `JsonStreamParser` may also return any error from its reader.
+  Status Next();
+
+  /// Skips the current value. If the current token starts an array or object,
+  /// advances to the token that ends it; otherwise does nothing.
+  Status SkipValue();
+
+  /// The current token. Only valid after `Next()` returns OK.
+  JsonToken token() const { return token_; }
+
+  /// The text of the current token. For keys and strings, this is the
+  /// characters between the quotes, with escape sequences left as they are.
+  /// For numbers and literals, this is the token as written. For array and
+  /// object boundaries, this is the `[`, `]`, `{`, or `}`.
+  ///
+  /// The view refers to the input, or to the buffer of a `JsonStreamParser`,
+  /// and is valid until the next call to `Next()`.
+  std::string_view text() const {
+    return std::string_view(data_ + text_start_, text_size_);
+  }
+
+  /// Whether the current key or string contains escape sequences. If not,
+  /// `text()` is the string itself and need not be unescaped.
+  bool has_escapes() const { return has_escapes_; }
+
+  /// Copies the current key or string to `buffer`, replacing escape sequences
+  /// with the characters they represent. `\u` escapes are written as UTF-8.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The string was written; its size in bytes is returned.
+  ///
+  ///    RESOURCE_EXHAUSTED: The string does not fit in ``buffer``.
+  ///
+  ///    FAILED_PRECONDITION: The current token is not a key or string.
+  ///
+  ///    DATA_LOSS: A ``\u`` escape is an unpaired UTF-16 surrogate.
+  ///
+  /// @endrst
+  StatusWithSize UnescapeString(span<char> buffer) const;
+
+  /// Converts the current number to an integer.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Returns the number.
+  ///
+  ///    FAILED_PRECONDITION: The current token is not a number.
+  ///
+  ///    INVALID_ARGUMENT: The number has a fraction or exponent.
+  ///
+  ///    OUT_OF_RANGE: The number does not fit in an ``int64_t``.
+  ///
+  /// @endrst
+  Result<int64_t> IntValue() const;
+
+  /// The number of arrays and objects that contain the current token. Tokens
+  /// that start or end an array or object are counted as inside it.
+  size_t depth() const { return token_depth_; }
+
+  /// The first error that occurred, or OK. Reaching the end of the input
+  /// after the top-level value is not an error.
+  Status status() const { return status_; }
+
+ protected:
+  // Parses from a reader through `buffer`.
+  constexpr JsonParser(stream::Reader& reader, span<char> buffer)
+      : data_(buffer.data()), size_(0), reader_(&reader), buffer_(buffer) {}
+
+ private:
+  // What the parser expects next.
+  enum class Expect : uint8_t {
+    kValue,
+    kFirstValueOrEnd,  // After [
+    kFirstKeyOrEnd,    // After {
+    kKey,              // After a comma in an object
+    kColon,            // After a key
+    kCommaOrEnd,       // After a value in an array or object
+    kDone,             // After the top-level value
+  };
+
+  static constexpr int kEndOfInput = -1;
+
+  Status Fail(Status error) {
+    if (status_.ok()) {
+      status_ = error;
+    }
+    return status_;
+  }
+
+  // Returns the next character without consuming it, or kEndOfInput.
+  int Peek() {
+    if (position_ == size_ && !Fill()) {
+      return kEndOfInput;
+    }
+    return static_cast<unsigned char>(data_[position_]);
+  }
+
+  // Reads more input from the reader, keeping the current token. Returns
+  // false at the end of the input or if an error occurred.
+  bool Fill();
+
+  // Skips whitespace and returns the next character, or kEndOfInput.
+  int SkipWhitespace();
+
+  Status Value(int c);
+  Status Open(JsonToken token, bool object);
+  Status Close(int c);
+  Status String(JsonToken token);
+  Status Number();
+  Status Literal(JsonToken token, std::string_view literal);
+
+  // Sets the current token to the characters since token_start_, excluding
+  // `trim` characters on each end.
+  void SetToken(JsonToken token, size_t trim = 0) {
+    token_ = token;
+    text_start_ = token_start_ + trim;
+    text_size_ = position_ - token_start_ - 2 * trim;
+    token_depth_ = depth_;
+  }
+
+  void AfterValue() {
+    expect_ = depth_ == 0 ? Expect::kDone : Expect::kCommaOrEnd;
+  }
+
+  bool in_object() const { return ((objects_ >> (depth_ - 1)) & 1u) != 0; }
+
+  const char* data_;
+  size_t size_;  // Characters available in data_
+  size_t position_ = 0;
+  size_t token_start_ = 0;
+  size_t text_start_ = 0;
+  size_t text_size_ = 0;
+
+  // Only set for a JsonStreamParser.
+  stream::Reader* reader_ = nullptr;
+  span<char> buffer_;
+  bool end_of_stream_ = false;
+
+  uint32_t objects_ = 0;  // Bit N is set if depth N + 1 is an object.
+  uint8_t depth_ = 0;
+  uint8_t token_depth_ = 0;
+  Expect expect_ = Expect::kValue;
+  JsonToken token_ = JsonToken::kNull;
+  bool has_escapes_ = false;
+  Status status_;
+};
+
+/// Parses JSON from a `pw::stream::Reader`. Input is read into a
+/// caller-provided buffer as the parser advances. The buffer must be at least
+/// one character larger than the longest token in the JSON, counting the
+/// quotes around keys and strings. The extra character is needed to find the
+/// end of a number.
+class JsonStreamParser : public JsonParser {
+ public:
+  JsonStreamParser(stream::Reader& reader, span<char> buffer)
+      : JsonParser(reader, buffer) {}
+};
+
+/// @}
+
+}  // namespace pw
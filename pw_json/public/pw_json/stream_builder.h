@@ -0,0 +1,432 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+/// @file pw_json/stream_builder.h
+///
+/// `pw::JsonStreamBuilder` serializes JSON incrementally to a
+/// `pw::stream::Writer`. Characters are collected in a small staging buffer
+/// and written to the stream whenever it fills, so the size of the JSON is not
+/// limited by the amount of RAM available.
+///
+/// The nesting API matches `pw::JsonBuilder`, but since serialized output
+/// cannot be revised, an array or object is closed when its handle is
+/// destroyed, when `Close()` is called, or when a value is added to an
+/// enclosing array or object.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+#include "pw_json/builder.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw {
+
+class JsonStreamBuilder;
+class JsonStreamObject;
+
+namespace json_impl {
+
+// Refers to an array or object that is open in a JsonStreamBuilder.
+class StreamNesting {
+ public:
+  StreamNesting(const StreamNesting&) = delete;
+  StreamNesting& operator=(const StreamNesting&) = delete;
+
+  StreamNesting(StreamNesting&& other)
+      : builder_(other.builder_), depth_(other.depth_), id_(other.id_) {
+    other.builder_ = nullptr;
+  }
+
+  StreamNesting& operator=(StreamNesting&& other) = delete;
+
+  JsonStreamBuilder& builder() const { return *builder_; }
+  bool has_builder() const { return builder_ != nullptr; }
+  uint8_t depth() const { return depth_; }
+  uint16_t id() const { return id_; }
+
+ private:
+  friend class pw::JsonStreamBuilder;
+
+  StreamNesting(JsonStreamBuilder& builder, uint8_t depth, uint16_t id)
+      : builder_(&builder), depth_(depth), id_(id) {}
+
+  JsonStreamBuilder* builder_;
+  uint8_t depth_;  // 1 for the top-level array or object
+  uint16_t id_;
+};
+
+}  // namespace json_impl
+
+/// @defgroup pw_json_stream_builder_api
+/// @{
+
+/// An array that is open in a `JsonStreamBuilder`. Provides functions for
+/// appending values to the array. The closing `]` is written when the
+/// `JsonStreamArray` is destroyed or `Close()` is called.
+///
+/// Appending to an enclosing array or object closes this array. Attempting to
+/// append to a closed array fails an assertion.
+class [[nodiscard]] JsonStreamArray {
+ public:
+  JsonStreamArray(const JsonStreamArray&) = delete;
+  JsonStreamArray& operator=(const JsonStreamArray&) = delete;
+
+  JsonStreamArray(JsonStreamArray&&) = default;
+  JsonStreamArray& operator=(JsonStreamArray&&) = delete;
+
+  ~JsonStreamArray() { Close(); }
+
+  /// Appends a value to the array. Any nested arrays or objects that are still
+  /// open are closed first.
+  template <typename T>
+  JsonStreamArray& Append(const T& value);
+
+  /// Appends a new nested array to this array.
+  JsonStreamArray AppendNestedArray();
+
+  /// Appends a new nested object to this array.
+  JsonStreamObject AppendNestedObject();
+
+  /// Appends all elements from an iterable container. Unlike
+  /// `JsonArray::Extend`, elements that were written before an error are not
+  /// reverted.
+  template <typename Iterable>
+  JsonStreamArray& Extend(const Iterable& iterable);
+
+  /// Appends all elements from an array.
+  template <typename T, size_t kSize>
+  JsonStreamArray& Extend(const T (&iterable)[kSize]);
+
+  /// Writes the closing `]`, after closing any nested arrays or objects. Does
+  /// nothing if the array was already closed.
+  void Close();
+
+  /// The status of the `JsonStreamBuilder`.
+  Status status() const;
+  [[nodiscard]] bool ok() const { return status().ok(); }
+
+ private:
+  friend class JsonStreamBuilder;
+  friend class JsonStreamObject;
+
+  JsonStreamArray(json_impl::StreamNesting&& nesting)
+      : nesting_(std::move(nesting)) {}
+
+  json_impl::StreamNesting nesting_;
+};
+
+/// An object that is open in a `JsonStreamBuilder`. Provides functions for
+/// adding key-value pairs to the object. The closing `}` is written when the
+/// `JsonStreamObject` is destroyed or `Close()` is called.
+///
+/// Adding to an enclosing array or object closes this object. Attempting to
+/// add to a closed object fails an assertion.
+class [[nodiscard]] JsonStreamObject {
+ public:
+  JsonStreamObject(const JsonStreamObject&) = delete;
+  JsonStreamObject& operator=(const JsonStreamObject&) = delete;
+
+  JsonStreamObject(JsonStreamObject&&) = default;
+  JsonStreamObject& operator=(JsonStreamObject&&) = delete;
+
+  ~JsonStreamObject() { Close(); }
+
+  /// Adds a key-value pair to the object. Any nested arrays or objects that
+  /// are still open are closed first.
+  template <typename T>
+  JsonStreamObject& Add(std::string_view key, const T& value);
+
+  template <typename T>
+  JsonStreamObject& Add(std::nullptr_t, const T& value) = delete;
+
+  /// Adds a nested array to this object.
+  JsonStreamArray AddNestedArray(std::string_view key);
+
+  /// Adds a nested object to this object.
+  JsonStreamObject AddNestedObject(std::string_view key);
+
+  /// Writes the closing `}`, after closing any nested arrays or objects. Does
+  /// nothing if the object was already closed.
+  void Close();
+
+  /// The status of the `JsonStreamBuilder`.
+  Status status() const;
+  [[nodiscard]] bool ok() const { return status().ok(); }
+
+ private:
+  friend class JsonStreamBuilder;
+  friend class JsonStreamArray;
+
+  JsonStreamObject(json_impl::StreamNesting&& nesting)
+      : nesting_(std::move(nesting)) {}
+
+  json_impl::StreamNesting nesting_;
+};
+
+/// `JsonStreamBuilder` serializes a single JSON value, array, or object to a
+/// `pw::stream::Writer`. Its output is identical to the equivalent
+/// `JsonBuilder`.
+///
+/// Output is staged in a caller-provided buffer, which may be as small as one
+/// character. Larger buffers result in fewer, larger writes to the stream.
+/// Call `Finish()` once the JSON is complete to close any open arrays or
+/// objects and write out the remaining characters.
+///
+/// @code{.cpp}
+///   std::array<char, 32> staging;
+///   pw::JsonStreamBuilder json(writer, staging);
+///   {
+///     pw::JsonStreamObject object = json.StartObject();
+///     object.Add("name", "metrics");
+///     pw::JsonStreamArray values = object.AddNestedArray("values");
+///     for (int value : values_to_export) {
+///       values.Append(value);
+///     }
+///   }
+///   PW_TRY(json.Finish());
+/// @endcode
+class JsonStreamBuilder {
+ public:
+  /// Arrays and objects may be nested at most this many levels deep, including
+  /// the top-level array or object.
+  static constexpr size_t kMaxDepth = 16;
+
+  /// Writes to `writer`, staging output in `buffer`, which must not be empty.
+  JsonStreamBuilder(stream::Writer& writer, span<char> buffer);
+
+  JsonStreamBuilder(const JsonStreamBuilder&) = delete;
+  JsonStreamBuilder& operator=(const JsonStreamBuilder&) = delete;
+
+  /// Serializes a single JSON value: a boolean, number, string, `null`, or
+  /// the contents of a `JsonBuilder`. Only one top-level value, array, or
+  /// object may be written.
+  template <typename T>
+  Status SetValue(const T& value) {
+    Start();
+    WriteValue(value);
+    return status();
+  }
+
+  /// Writes `[` and returns a `JsonStreamArray` for appending to the array.
+  JsonStreamArray StartArray() {
+    Start();
+    return Open(json_impl::Nesting::kArray);
+  }
+
+  /// Writes `{` and returns a `JsonStreamObject` for adding to the object.
+  JsonStreamObject StartObject() {
+    Start();
+    return Open(json_impl::Nesting::kObject);
+  }
+
+  /// Closes all open arrays and objects and writes any staged characters to
+  /// the stream.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: All JSON was written to the stream.
+  ///
+  ///    RESOURCE_EXHAUSTED: A number could not be serialized.
+  ///
+  /// @endrst
+  ///
+  /// Any other status is the first error returned by the stream.
+  Status Finish();
+
+  /// Writes any staged characters to the stream, without closing open arrays
+  /// or objects.
+  Status Flush();
+
+  /// The first error that occurred. Once an error occurs, nothing more is
+  /// written to the stream.
+  Status status() const { return status_; }
+  [[nodiscard]] bool ok() const { return status_.ok(); }
+
+  /// The number of characters serialized so far, including characters that
+  /// are staged but not yet written to the stream.
+  size_t size() const { return size_; }
+
+ private:
+  friend class JsonStreamArray;
+  friend class JsonStreamObject;
+
+  // Enough for any integer, or any float written with FloatAsIntToString.
+  static constexpr size_t kNumberBufferSize = 24;
+
+  void Start() {
+    PW_ASSERT(!started_);  // Only one top-level JSON entity may be written.
+    started_ = true;
+  }
+
+  json_impl::StreamNesting Open(json_impl::Nesting::Type type);
+
+  // Checks that the nesting is still open and closes anything nested within
+  // it. Then, writes a comma if needed, followed by the key, if any.
+  void StartEntry(const json_impl::StreamNesting& nesting);
+  void StartEntry(const json_impl::StreamNesting& nesting,
+                  std::string_view key);
+
+  void Close(const json_impl::StreamNesting& nesting);
+  void CloseInnermost();
+
+  bool IsOpen(const json_impl::StreamNesting& nesting) const {
+    return nesting.depth() <= depth_ &&
+           ids_[nesting.depth() - 1] == nesting.id();
+  }
+
+  template <typename T>
+  void WriteValue(const T& value);
+
+  void Put(char c);
+  void PutRaw(std::string_view value);
+  void PutQuoted(std::string_view value);
+
+  void UpdateStatus(Status status) {
+    if (status_.ok()) {
+      status_ = status;
+    }
+  }
+
+  stream::Writer& writer_;
+  span<char> buffer_;
+  size_t buffered_ = 0;
+  size_t size_ = 0;
+  Status status_;
+
+  bool started_ = false;
+  bool first_entry_ = false;  // The innermost array or object is empty.
+  uint8_t depth_ = 0;
+  uint16_t types_ = 0;  // Bit N is set if depth N + 1 is an object.
+  uint16_t next_id_ = 0;
+  std::array<uint16_t, kMaxDepth> ids_{};
+};
+
+/// @}
+
+// Template and inline function implementations.
+
+template <typename T>
+void JsonStreamBuilder::WriteValue(const T& value) {
+  if constexpr (json_impl::kIsJson<T>) {  // JsonBuilder, JsonArray, JsonObject
+    PutRaw(value);
+  } else if constexpr (std::is_null_pointer_v<T>) {
+    PutRaw("null");
+  } else if constexpr (std::is_same_v<T, char*> ||  // C strings
+                       std::is_same_v<T, const char*>) {
+    if (value == nullptr) {
+      PutRaw("null");
+    } else {
+      PutQuoted(value);
+    }
+  } else if constexpr (std::is_convertible_v<T, std::string_view>) {  // strings
+    PutQuoted(value);
+  } else {  // numbers and booleans
+    char number[kNumberBufferSize];
+    const StatusWithSize written =
+        json_impl::SerializeJson(value, number, sizeof(number));
+    if (written.ok()) {
+      PutRaw(std::string_view(number, written.size()));
+    } else {
+      UpdateStatus(written.status());
+    }
+  }
+}
+
+template <typename T>
+JsonStreamArray& JsonStreamArray::Append(const T& value) {
+  JsonStreamBuilder& builder = nesting_.builder();
+  builder.StartEntry(nesting_);
+  builder.WriteValue(value);
+  return *this;
+}
+
+inline JsonStreamArray JsonStreamArray::AppendNestedArray() {
+  JsonStreamBuilder& builder = nesting_.builder();
+  builder.StartEntry(nesting_);
+  return builder.Open(json_impl::Nesting::kArray);
+}
+
+inline JsonStreamObject JsonStreamArray::AppendNestedObject() {
+  JsonStreamBuilder& builder = nesting_.builder();
+  builder.StartEntry(nesting_);
+  return builder.Open(json_impl::Nesting::kObject);
+}
+
+template <typename Iterable>
+JsonStreamArray& JsonStreamArray::Extend(const Iterable& iterable) {
+  for (const auto& value : iterable) {
+    Append(value);
+  }
+  return *this;
+}
+
+template <typename T, size_t kSize>
+JsonStreamArray& JsonStreamArray::Extend(const T (&iterable)[kSize]) {
+  for (const T& value : iterable) {
+    Append(value);
+  }
+  return *this;
+}
+
+inline void JsonStreamArray::Close() {
+  if (nesting_.has_builder()) {
+    nesting_.builder().Close(nesting_);
+  }
+}
+
+inline Status JsonStreamArray::status() const {
+  return nesting_.builder().status();
+}
+
+template <typename T>
+JsonStreamObject& JsonStreamObject::Add(std::string_view key, const T& value) {
+  JsonStreamBuilder& builder = nesting_.builder();
+  builder.StartEntry(nesting_, key);
+  builder.WriteValue(value);
+  return *this;
+}
+
+inline JsonStreamArray JsonStreamObject::AddNestedArray(std::string_view key) {
+  JsonStreamBuilder& builder = nesting_.builder();
+  builder.StartEntry(nesting_, key);
+  return builder.Open(json_impl::Nesting::kArray);
+}
+
+inline JsonStreamObject JsonStreamObject::AddNestedObject(
+    std::string_view key) {
+  JsonStreamBuilder& builder = nesting_.builder();
+  builder.StartEntry(nesting_, key);
+  return builder.Open(json_impl::Nesting::kObject);
+}
+
+inline void JsonStreamObject::Close() {
+  if (nesting_.has_builder()) {
+    nesting_.builder().Close(nesting_);
+  }
+}
+
+inline Status JsonStreamObject::status() const {
+  return nesting_.builder().status();
+}
+
+}  // namespace pw
@@ -0,0 +1,130 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_json/stream_builder.h"
+
+#include <algorithm>
+
+#include "pw_assert/check.h"
+
+namespace pw {
+
+JsonStreamBuilder::JsonStreamBuilder(stream::Writer& writer, span<char> buffer)
+    : writer_(writer), buffer_(buffer) {
+  PW_CHECK(!buffer.empty(), "JsonStreamBuilder requires a staging buffer");
+}
+
+Status JsonStreamBuilder::Finish() {
+  while (depth_ > 0) {
+    CloseInnermost();
+  }
+  return Flush();
+}
+
+Status JsonStreamBuilder::Flush() {
+  if (buffered_ != 0 && status_.ok()) {
+    UpdateStatus(writer_.Write(as_bytes(buffer_.first(buffered_))));
+  }
+  buffered_ = 0;
+  return status_;
+}
+
+json_impl::StreamNesting JsonStreamBuilder::Open(
+    json_impl::Nesting::Type type) {
+  PW_CHECK_UINT_LT(depth_, kMaxDepth, "JSON is nested too deeply");
+  Put(type == json_impl::Nesting::kArray ? '[' : '{');
+
+  types_ = static_cast<uint16_t>(types_ | (type << depth_));
+  ids_[depth_] = ++next_id_;
+  depth_ += 1;
+  first_entry_ = true;
+  return json_impl::StreamNesting(*this, depth_, next_id_);
+}
+
+void JsonStreamBuilder::StartEntry(const json_impl::StreamNesting& nesting) {
+  // Appending to a closed array or object is an error.
+  PW_CHECK(IsOpen(nesting), "The JSON array or object was already closed");
+
+  while (depth_ > nesting.depth()) {
+    CloseInnermost();
+  }
+
+  if (first_entry_) {
+    first_entry_ = false;
+  } else {
+    PutRaw(", ");
+  }
+}
+
+void JsonStreamBuilder::StartEntry(const json_impl::StreamNesting& nesting,
+                                   std::string_view key) {
+  StartEntry(nesting);
+  PutQuoted(key);
+  PutRaw(": ");
+}
+
+void JsonStreamBuilder::Close(const json_impl::StreamNesting& nesting) {
+  if (!IsOpen(nesting)) {
+    return;  // Already closed, possibly by a write to an enclosing structure.
+  }
+  while (depth_ >= nesting.depth()) {
+    CloseInnermost();
+  }
+}
+
+void JsonStreamBuilder::CloseInnermost() {
+  depth_ -= 1;
+  Put((types_ & (1u << depth_)) == 0 ? ']' : '}');
+  types_ = static_cast<uint16_t>(types_ & ~(1u << depth_));
+  first_entry_ = false;
+}
+
+void JsonStreamBuilder::Put(char c) {
+  if (!status_.ok() || (buffered_ == buffer_.size() && !Flush().ok())) {
+    return;
+  }
+  buffer_[buffered_++] = c;
+  size_ += 1;
+}
+
+void JsonStreamBuilder::PutRaw(std::string_view value) {
+  while (!value.empty() && status_.ok()) {
+    if (buffered_ == buffer_.size() && !Flush().ok()) {
+      return;
+    }
+    const size_t count = std::min(value.size(), buffer_.size() - buffered_);
+    std::copy_n(value.begin(), count, buffer_.begin() + buffered_);
+    buffered_ += count;
+    size_ += count;
+    value.remove_prefix(count);
+  }
+}
+
+void JsonStreamBuilder::PutQuoted(std::string_view value) {
+  Put('"');
+  for (char c : value) {
+    if (c >= ' ' && c <= '~' && c != '"' && c != '\\') {
+      Put(c);
+      continue;
+    }
+    // Escape the character the same way as JsonBuilder: \", \\, \n, \u0001.
+    char escaped[6];
+    const int size = json_impl::EscapedStringCopy(
+        escaped, sizeof(escaped), std::string_view(&c, 1));
+    PutRaw(std::string_view(escaped, static_cast<size_t>(size)));
+  }
+  Put('"');
+}
+
+}  // namespace pw
@@ -0,0 +1,229 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_json/stream_builder.h"
+
+#include <array>
+#include <string_view>
+
+#include "pw_json/builder.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_stream/null_stream.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+using namespace std::string_view_literals;
+
+class JsonStreamBuilderTest : public ::testing::Test {
+ protected:
+  std::string_view output() const {
+    return std::string_view(
+        reinterpret_cast<const char*>(writer_.WrittenData().data()),
+        writer_.WrittenData().size());
+  }
+
+  pw::stream::MemoryWriterBuffer<512> writer_;
+  std::array<char, 8> staging_;
+};
+
+TEST_F(JsonStreamBuilderTest, Example) {
+  constexpr int kSamples[] = {12, 34, 56};
+
+  // DOCSTAG: [pw-json-stream-builder-example]
+  std::array<char, 16> staging_buffer;
+  pw::JsonStreamBuilder json(writer_, staging_buffer);
+  {
+    pw::JsonStreamObject object = json.StartObject();
+    object.Add("name", "temperature").Add("unit", "C");
+
+    pw::JsonStreamArray samples = object.AddNestedArray("samples");
+    for (int sample : kSamples) {
+      samples.Append(sample);
+    }
+  }  // Destroying the JsonStreamObject writes the closing }.
+  pw::Status status = json.Finish();
+  // DOCSTAG: [pw-json-stream-builder-example]
+
+  EXPECT_EQ(status, pw::OkStatus());
+  EXPECT_EQ(
+      output(),
+      R"({"name": "temperature", "unit": "C", "samples": [12, 34, 56]})"sv);
+}
+
+TEST_F(JsonStreamBuilderTest, Value) {
+  pw::JsonStreamBuilder json(writer_, staging_);
+  EXPECT_EQ(json.SetValue("hello \"world\""), pw::OkStatus());
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  EXPECT_EQ(output(), R"("hello \"world\"")"sv);
+  EXPECT_EQ(json.size(), output().size());
+}
+
+TEST_F(JsonStreamBuilderTest, NullAndNumbers) {
+  pw::JsonStreamBuilder json(writer_, staging_);
+  json.StartArray()
+      .Append(nullptr)
+      .Append(static_cast<const char*>(nullptr))
+      .Append(-1234567890123LL)
+      .Append(1.5f)
+      .Append(true)
+      .Append(false);
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  EXPECT_EQ(output(), "[null, null, -1234567890123, 2, true, false]"sv);
+}
+
+TEST_F(JsonStreamBuilderTest, EmptyArrayAndObject) {
+  pw::JsonStreamBuilder json(writer_, staging_);
+  {
+    pw::JsonStreamArray array = json.StartArray();
+    array.AppendNestedArray().Close();
+    array.AppendNestedObject().Close();
+  }
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  EXPECT_EQ(output(), "[[], {}]"sv);
+}
+
+TEST_F(JsonStreamBuilderTest, Nesting) {
+  pw::JsonStreamBuilder json(writer_, staging_);
+  {
+    pw::JsonStreamObject object = json.StartObject();
+    object.Add("name", "metrics");
+    {
+      pw::JsonStreamArray values = object.AddNestedArray("values");
+      values.Extend({1, 2, 3});
+      values.AppendNestedObject()
+          .Add("deep", "\n")
+          .AddNestedArray("deeper")
+          .Close();
+    }
+    object.Add("done", true);
+  }
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  EXPECT_EQ(
+      output(),
+      R"({"name": "metrics", "values": [1, 2, 3, {"deep": "\n", "deeper": []}],)"
+      R"( "done": true})"sv);
+}
+
+TEST_F(JsonStreamBuilderTest, AddingToParentClosesNested) {
+  pw::JsonStreamBuilder json(writer_, staging_);
+  pw::JsonStreamObject object = json.StartObject();
+  pw::JsonStreamArray first = object.AddNestedArray("first");
+  first.Append(1);
+  pw::JsonStreamObject second = object.AddNestedObject("second");
+  second.Add("a", 'a' == 'a');
+  object.Add("third", 3);
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  EXPECT_EQ(output(), R"({"first": [1], "second": {"a": true}, "third": 3})"sv);
+}
+
+TEST_F(JsonStreamBuilderTest, FinishClosesEverything) {
+  pw::JsonStreamBuilder json(writer_, staging_);
+  pw::JsonStreamArray array = json.StartArray();
+  pw::JsonStreamObject object = array.AppendNestedObject();
+  pw::JsonStreamArray nested = object.AddNestedArray("x");
+  nested.Append("y");
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  EXPECT_EQ(output(), R"([{"x": ["y"]}])"sv);
+
+  // Handles closed by Finish() do not write anything when destroyed.
+  nested.Close();
+  object.Close();
+  array.Close();
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  EXPECT_EQ(output(), R"([{"x": ["y"]}])"sv);
+}
+
+TEST_F(JsonStreamBuilderTest, MatchesJsonBuilder) {
+  pw::JsonBuffer<256> buffer;
+  pw::JsonObject& object = buffer.StartObject();
+  object.Add("tagline", "Easy, \"efficient\"\tJSON serialization!\x01")
+      .Add("simple", true)
+      .Add("safe", 100);
+  pw::NestedJsonArray features = object.AddNestedArray("features");
+  features.Append("values").AppendNestedObject().Add("nested", nullptr);
+  ASSERT_TRUE(buffer.ok());
+
+  std::array<char, 1> tiny_staging;
+  pw::JsonStreamBuilder json(writer_, tiny_staging);
+  {
+    pw::JsonStreamObject stream_object = json.StartObject();
+    stream_object
+        .Add("tagline", "Easy, \"efficient\"\tJSON serialization!\x01")
+        .Add("simple", true)
+        .Add("safe", 100);
+    pw::JsonStreamArray stream_features =
+        stream_object.AddNestedArray("features");
+    stream_features.Append("values").AppendNestedObject().Add("nested",
+                                                              nullptr);
+  }
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  EXPECT_EQ(output(), std::string_view(buffer));
+}
+
+TEST_F(JsonStreamBuilderTest, AppendJsonBuilder) {
+  pw::JsonBuffer<32> buffer;
+  buffer.StartArray().Append(1).Append("two");
+
+  pw::JsonStreamBuilder json(writer_, staging_);
+  json.StartObject().Add("array", buffer);
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  EXPECT_EQ(output(), R"({"array": [1, "two"]})"sv);
+}
+
+TEST_F(JsonStreamBuilderTest, OutputLargerThanStagingBuffer) {
+  pw::stream::CountingNullStream counter;
+  pw::JsonStreamBuilder json(counter, staging_);
+  {
+    pw::JsonStreamArray array = json.StartArray();
+    for (int i = 0; i < 10000; ++i) {
+      array.Append(i % 10);
+    }
+  }
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  // 10000 digits, 9999 ", " separators, and []
+  EXPECT_EQ(counter.bytes_written(), 10000u + 9999u * 2u + 2u);
+  EXPECT_EQ(json.size(), counter.bytes_written());
+}
+
+TEST_F(JsonStreamBuilderTest, StreamErrorIsSticky) {
+  pw::stream::MemoryWriterBuffer<16> small_writer;
+  pw::JsonStreamBuilder json(small_writer, staging_);
+  {
+    pw::JsonStreamArray array = json.StartArray();
+    for (int i = 0; i < 100; ++i) {
+      array.Append(i);
+    }
+    EXPECT_FALSE(array.ok());
+  }
+  EXPECT_EQ(json.Finish(), pw::Status::OutOfRange());
+  EXPECT_EQ(json.status(), pw::Status::OutOfRange());
+  EXPECT_EQ(small_writer.bytes_written(), 16u);
+}
+
+TEST_F(JsonStreamBuilderTest, FlushWritesStagedCharacters) {
+  std::array<char, 64> staging;
+  pw::JsonStreamBuilder json(writer_, staging);
+  pw::JsonStreamArray array = json.StartArray();
+  array.Append(1);
+  EXPECT_EQ(output(), ""sv);
+  EXPECT_EQ(json.Flush(), pw::OkStatus());
+  EXPECT_EQ(output(), "[1"sv);
+  array.Append(2);
+  array.Close();
+  EXPECT_EQ(json.Finish(), pw::OkStatus());
+  EXPECT_EQ(output(), "[1, 2]"sv);
+}
+
+}  // namespace
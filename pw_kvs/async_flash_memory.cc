@@ -0,0 +1,173 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/async_flash_memory.h"
+
+#include <mutex>
+#include <utility>
+
+#include "pw_assert/check.h"
+
+namespace pw::kvs {
+
+size_t AsyncFlashOperation::size_bytes(size_t sector_size_bytes) const {
+  switch (type_) {
+    case Type::kErase:
+      return num_sectors_ * sector_size_bytes;
+    case Type::kRead:
+      return output_.size();
+    case Type::kWrite:
+      return data_.size();
+  }
+  return 0;
+}
+
+AsyncFlashMemory::AsyncFlashMemory(FlashMemory& flash, span<Bank> banks)
+    : flash_(flash),
+      banks_(banks),
+      bank_size_bytes_(banks.empty() ? 0 : flash.size_bytes() / banks.size()) {
+  PW_CHECK(!banks.empty(), "Flash must have at least one bank");
+  PW_CHECK_UINT_EQ(bank_size_bytes_ * banks.size(),
+                   flash.size_bytes(),
+                   "Flash must divide into equally sized banks");
+  const size_t partial_sector = bank_size_bytes_ % flash.sector_size_bytes();
+  PW_CHECK_UINT_EQ(
+      partial_sector, 0u, "Banks must contain a whole number of sectors");
+}
+
+size_t AsyncFlashMemory::BankOf(FlashMemory::Address address) const {
+  PW_DCHECK_UINT_GE(address, flash_.start_address());
+  return (address - flash_.start_address()) / bank_size_bytes_;
+}
+
+bool AsyncFlashMemory::IsBankBusy(size_t bank) const {
+  std::lock_guard lock(lock_);
+  return banks_[bank].active_ != nullptr;
+}
+
+Result<size_t> AsyncFlashMemory::Validate(
+    const AsyncFlashOperation& operation) const {
+  const size_t size = operation.size_bytes(flash_.sector_size_bytes());
+  const FlashMemory::Address address = operation.address();
+
+  if (address < flash_.start_address() ||
+      address - flash_.start_address() > flash_.size_bytes() ||
+      size > flash_.size_bytes() - (address - flash_.start_address())) {
+    return Status::OutOfRange();
+  }
+
+  switch (operation.type()) {
+    case AsyncFlashOperation::Type::kErase:
+      if (address % flash_.sector_size_bytes() != 0) {
+        return Status::InvalidArgument();
+      }
+      break;
+    case AsyncFlashOperation::Type::kWrite:
+      if (address % flash_.alignment_bytes() != 0 ||
+          size % flash_.alignment_bytes() != 0) {
+        return Status::InvalidArgument();
+      }
+      break;
+    case AsyncFlashOperation::Type::kRead:
+      break;
+  }
+
+  const size_t bank = BankOf(address);
+  if (size != 0u && BankOf(address + size - 1) != bank) {
+    return Status::InvalidArgument();
+  }
+  return bank;
+}
+
+async2::Poll<StatusWithSize> AsyncFlashMemory::PendOperation(
+    async2::Context& cx, AsyncFlashOperation& operation) {
+  using State = AsyncFlashOperation::State;
+
+  size_t bank_index;
+  {
+    std::lock_guard lock(lock_);
+    switch (operation.state_) {
+      case State::kComplete:
+        operation.state_ = State::kIdle;
+        return async2::Ready(StatusWithSize(operation.result_));
+      case State::kQueued:
+      case State::kActive:
+        operation.waker_ = cx.GetWaker(async2::WaitReason::Unspecified());
+        return async2::Pending();
+      case State::kIdle:
+        break;
+    }
+
+    Result<size_t> bank = Validate(operation);
+    if (!bank.ok()) {
+      return async2::Ready(StatusWithSize(bank.status(), 0));
+    }
+    bank_index = *bank;
+
+    operation.waker_ = cx.GetWaker(async2::WaitReason::Unspecified());
+    Bank& target = banks_[bank_index];
+    if (target.active_ != nullptr) {
+      operation.state_ = State::kQueued;
+      target.queue_.push_back(operation);
+      return async2::Pending();
+    }
+    operation.state_ = State::kActive;
+    target.active_ = &operation;
+  }
+
+  DoStartOperation(bank_index, operation);
+  return async2::Pending();
+}
+
+bool AsyncFlashMemory::Cancel(AsyncFlashOperation& operation) {
+  std::lock_guard lock(lock_);
+  if (operation.state_ != AsyncFlashOperation::State::kQueued) {
+    return false;
+  }
+  banks_[BankOf(operation.address())].queue_.remove(operation);
+  operation.state_ = AsyncFlashOperation::State::kIdle;
+  operation.waker_.Clear();
+  return true;
+}
+
+void AsyncFlashMemory::CompleteOperation(size_t bank, StatusWithSize result) {
+  async2::Waker waker;
+  AsyncFlashOperation* next = nullptr;
+  {
+    std::lock_guard lock(lock_);
+    Bank& completed_bank = banks_[bank];
+    PW_CHECK_NOTNULL(completed_bank.active_,
+                     "No flash operation is active on the bank");
+    AsyncFlashOperation& completed = *completed_bank.active_;
+    completed.result_ = result;
+    completed.state_ = AsyncFlashOperation::State::kComplete;
+    waker = std::move(completed.waker_);
+
+    if (!completed_bank.queue_.empty()) {
+      next = &completed_bank.queue_.front();
+      completed_bank.queue_.pop_front();
+      next->state_ = AsyncFlashOperation::State::kActive;
+    }
+    completed_bank.active_ = next;
+  }
+
+  // Start the next operation before waking the task, so the bank is idle for
+  // as little time as possible.
+  if (next != nullptr) {
+    DoStartOperation(bank, *next);
+  }
+  std::move(waker).Wake();
+}
+
+}  // namespace pw::kvs
@@ -0,0 +1,260 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/async_flash_memory.h"
+
+#include <array>
+#include <optional>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_containers/vector.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::kvs {
+namespace {
+
+using ::pw::async2::Context;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+
+constexpr size_t kSectorSize = 512;
+constexpr size_t kBankSize = 2 * kSectorSize;
+constexpr size_t kAlignment = 16;
+
+// Holds the fake flash, so it is constructed before the AsyncFlashMemory.
+struct FakeDualBankFlash {
+  FakeFlashMemoryBuffer<kSectorSize, 4> fake_flash_{kAlignment};
+  std::array<AsyncFlashMemory::Bank, 2> bank_queues_;
+};
+
+// A dual-bank flash whose operations run when the test completes them.
+class TestAsyncFlashMemory : private FakeDualBankFlash,
+                             public AsyncFlashMemory {
+ public:
+  TestAsyncFlashMemory() : AsyncFlashMemory(fake_flash_, bank_queues_) {}
+
+  const Vector<AsyncFlashOperation*, 8>& started() const { return started_; }
+
+  // Runs the active operation of the bank on the fake flash and completes it.
+  void Complete(size_t bank) {
+    AsyncFlashOperation& operation = *active_[bank];
+    StatusWithSize result;
+    switch (operation.type()) {
+      case AsyncFlashOperation::Type::kErase:
+        result = StatusWithSize(
+            fake_flash_.Erase(operation.address(), operation.num_sectors()),
+            0);
+        break;
+      case AsyncFlashOperation::Type::kRead:
+        result = fake_flash_.Read(operation.address(), operation.output());
+        break;
+      case AsyncFlashOperation::Type::kWrite:
+        result = fake_flash_.Write(operation.address(), operation.data());
+        break;
+    }
+    CompleteOperation(bank, result);
+  }
+
+ private:
+  void DoStartOperation(size_t bank, AsyncFlashOperation& operation) override {
+    started_.push_back(&operation);
+    active_[bank] = &operation;
+  }
+
+  Vector<AsyncFlashOperation*, 8> started_;
+  std::array<AsyncFlashOperation*, 2> active_{};
+};
+
+// A task that submits an operation and records its result.
+class OperationTask : public async2::Task {
+ public:
+  OperationTask(AsyncFlashMemory& flash, AsyncFlashOperation& operation)
+      : flash_(flash), operation_(operation) {}
+
+  const std::optional<StatusWithSize>& result() const { return result_; }
+
+  bool SucceededWith(size_t bytes) const {
+    return result_.has_value() && result_->ok() && result_->size() == bytes;
+  }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    Poll<StatusWithSize> result = flash_.PendOperation(cx, operation_);
+    if (result.IsPending()) {
+      return Pending();
+    }
+    result_ = *result;
+    return Ready();
+  }
+
+  AsyncFlashMemory& flash_;
+  AsyncFlashOperation& operation_;
+  std::optional<StatusWithSize> result_;
+};
+
+class AsyncFlashMemoryTest : public ::testing::Test {
+ protected:
+  AsyncFlashMemoryTest() {
+    for (size_t i = 0; i < data_.size(); ++i) {
+      data_[i] = std::byte(i);
+    }
+  }
+
+  Dispatcher dispatcher_;
+  TestAsyncFlashMemory flash_;
+  std::array<std::byte, 32> data_;
+  std::array<std::byte, 32> read_buffer_{};
+};
+
+TEST_F(AsyncFlashMemoryTest, Banks) {
+  EXPECT_EQ(flash_.bank_count(), 2u);
+  EXPECT_EQ(flash_.bank_size_bytes(), kBankSize);
+  EXPECT_EQ(flash_.BankOf(0), 0u);
+  EXPECT_EQ(flash_.BankOf(kBankSize - 1), 0u);
+  EXPECT_EQ(flash_.BankOf(kBankSize), 1u);
+}
+
+TEST_F(AsyncFlashMemoryTest, WriteThenRead) {
+  AsyncFlashOperation write = AsyncFlashOperation::Write(kSectorSize, data_);
+  AsyncFlashOperation read =
+      AsyncFlashOperation::Read(kSectorSize, read_buffer_);
+  OperationTask write_task(flash_, write);
+  OperationTask read_task(flash_, read);
+
+  dispatcher_.Post(write_task);
+  dispatcher_.Post(read_task);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  ASSERT_EQ(flash_.started().size(), 1u);
+  EXPECT_TRUE(flash_.IsBankBusy(0));
+  EXPECT_FALSE(flash_.IsBankBusy(1));
+
+  // The read is queued behind the write on the same bank, and starts as soon
+  // as the write completes.
+  flash_.Complete(0);
+  ASSERT_EQ(flash_.started().size(), 2u);
+  EXPECT_EQ(flash_.started()[1], &read);
+  flash_.Complete(0);
+  EXPECT_FALSE(flash_.IsBankBusy(0));
+
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_TRUE(write_task.SucceededWith(data_.size()));
+  EXPECT_TRUE(read_task.SucceededWith(read_buffer_.size()));
+  EXPECT_EQ(read_buffer_, data_);
+}
+
+TEST_F(AsyncFlashMemoryTest, BanksRunConcurrently) {
+  AsyncFlashOperation erase = AsyncFlashOperation::Erase(0, 2);
+  AsyncFlashOperation write = AsyncFlashOperation::Write(kBankSize, data_);
+  OperationTask erase_task(flash_, erase);
+  OperationTask write_task(flash_, write);
+
+  dispatcher_.Post(erase_task);
+  dispatcher_.Post(write_task);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  ASSERT_EQ(flash_.started().size(), 2u);
+  EXPECT_TRUE(flash_.IsBankBusy(0));
+  EXPECT_TRUE(flash_.IsBankBusy(1));
+
+  // The write on bank 1 finishes while the erase of bank 0 is still running.
+  flash_.Complete(1);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  EXPECT_TRUE(write_task.SucceededWith(data_.size()));
+  EXPECT_FALSE(erase_task.result().has_value());
+
+  flash_.Complete(0);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_TRUE(erase_task.SucceededWith(0));
+}
+
+TEST_F(AsyncFlashMemoryTest, InvalidOperations_CompleteImmediately) {
+  AsyncFlashOperation unaligned_erase = AsyncFlashOperation::Erase(16, 1);
+  AsyncFlashOperation unaligned_write =
+      AsyncFlashOperation::Write(8, span(data_).first(16));
+  AsyncFlashOperation crosses_banks =
+      AsyncFlashOperation::Read(kBankSize - 16, read_buffer_);
+  AsyncFlashOperation past_end = AsyncFlashOperation::Erase(kBankSize, 3);
+  OperationTask task_1(flash_, unaligned_erase);
+  OperationTask task_2(flash_, unaligned_write);
+  OperationTask task_3(flash_, crosses_banks);
+  OperationTask task_4(flash_, past_end);
+
+  dispatcher_.Post(task_1);
+  dispatcher_.Post(task_2);
+  dispatcher_.Post(task_3);
+  dispatcher_.Post(task_4);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_TRUE(flash_.started().empty());
+  EXPECT_EQ(task_1.result()->status(), Status::InvalidArgument());
+  EXPECT_EQ(task_2.result()->status(), Status::InvalidArgument());
+  EXPECT_EQ(task_3.result()->status(), Status::InvalidArgument());
+  EXPECT_EQ(task_4.result()->status(), Status::OutOfRange());
+}
+
+TEST_F(AsyncFlashMemoryTest, CancelRemovesQueuedOperation) {
+  AsyncFlashOperation erase = AsyncFlashOperation::Erase(0, 1);
+  AsyncFlashOperation write = AsyncFlashOperation::Write(0, data_);
+  AsyncFlashOperation read = AsyncFlashOperation::Read(0, read_buffer_);
+  OperationTask erase_task(flash_, erase);
+  OperationTask write_task(flash_, write);
+  OperationTask read_task(flash_, read);
+
+  dispatcher_.Post(erase_task);
+  dispatcher_.Post(write_task);
+  dispatcher_.Post(read_task);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+
+  EXPECT_FALSE(flash_.Cancel(erase));  // Already started.
+  EXPECT_TRUE(flash_.Cancel(write));
+  EXPECT_FALSE(flash_.Cancel(write));
+
+  flash_.Complete(0);
+  ASSERT_EQ(flash_.started().size(), 2u);
+  EXPECT_EQ(flash_.started()[1], &read);
+  flash_.Complete(0);
+
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  EXPECT_TRUE(erase_task.SucceededWith(0));
+  EXPECT_FALSE(write_task.result().has_value());
+  EXPECT_TRUE(read_task.SucceededWith(read_buffer_.size()));
+  write_task.Deregister();
+
+  // The write was cancelled, so the sector is still erased.
+  for (std::byte b : read_buffer_) {
+    EXPECT_EQ(b, std::byte{0xFF});
+  }
+}
+
+TEST_F(AsyncFlashMemoryTest, CompletedOperationCanBeSubmittedAgain) {
+  AsyncFlashOperation read = AsyncFlashOperation::Read(0, read_buffer_);
+  OperationTask first_task(flash_, read);
+  OperationTask second_task(flash_, read);
+
+  dispatcher_.Post(first_task);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  flash_.Complete(0);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+
+  dispatcher_.Post(second_task);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  ASSERT_EQ(flash_.started().size(), 2u);
+  flash_.Complete(0);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_TRUE(second_task.SucceededWith(read_buffer_.size()));
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -0,0 +1,150 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/caching_flash_partition.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::kvs {
+
+CachingFlashPartition::CachingFlashPartition(span<CacheLine> lines,
+                                             span<std::byte> pages,
+                                             size_t ways,
+                                             FlashMemory* flash,
+                                             uint32_t flash_start_sector_index,
+                                             uint32_t flash_sector_count,
+                                             uint32_t alignment_bytes,
+                                             PartitionPermission permission)
+    : FlashPartition(flash,
+                     flash_start_sector_index,
+                     flash_sector_count,
+                     alignment_bytes,
+                     permission),
+      lines_(lines),
+      pages_(pages),
+      ways_(ways),
+      page_size_bytes_(pages.size() / lines.size()),
+      use_counter_(0),
+      cache_hits_(0),
+      cache_misses_(0) {
+  const size_t ways_remainder = lines_.size() % ways_;
+  PW_CHECK_UINT_EQ(ways_remainder, 0u);
+  const size_t page_remainder =
+      FlashPartition::sector_size_bytes() % page_size_bytes_;
+  PW_CHECK_UINT_EQ(page_remainder,
+                   0u,
+                   "The cache page size must evenly divide the sector size");
+  InvalidateCache();
+}
+
+Status CachingFlashPartition::Erase(Address address, size_t num_sectors) {
+  InvalidateRange(address, num_sectors * sector_size_bytes());
+  return FlashPartition::Erase(address, num_sectors);
+}
+
+StatusWithSize CachingFlashPartition::Read(Address address,
+                                           span<std::byte> output) {
+  PW_TRY_WITH_SIZE(CheckBounds(address, output.size()));
+
+  size_t offset = 0;
+  while (offset < output.size()) {
+    const Address current = address + offset;
+    const uint32_t page = current / page_size_bytes_;
+    const size_t page_offset = current % page_size_bytes_;
+    size_t chunk_size =
+        std::min(page_size_bytes_ - page_offset, output.size() - offset);
+
+    CacheLine* line = FindLine(page);
+    if (line == nullptr && chunk_size == page_size_bytes_) {
+      // Read runs of whole, uncached pages directly into the output.
+      while (offset + chunk_size + page_size_bytes_ <= output.size() &&
+             FindLine(page + chunk_size / page_size_bytes_) == nullptr) {
+        chunk_size += page_size_bytes_;
+      }
+      cache_misses_ += chunk_size / page_size_bytes_;
+      PW_TRY_WITH_SIZE(
+          FlashPartition::Read(current, output.subspan(offset, chunk_size)));
+    } else {
+      if (line == nullptr) {
+        cache_misses_ += 1;
+        PW_TRY_WITH_SIZE(FillLine(page, line));
+      } else {
+        cache_hits_ += 1;
+      }
+      line->last_used = ++use_counter_;
+      std::memcpy(output.data() + offset,
+                  LineData(*line).data() + page_offset,
+                  chunk_size);
+    }
+    offset += chunk_size;
+  }
+  return StatusWithSize(output.size());
+}
+
+StatusWithSize CachingFlashPartition::Write(Address address,
+                                            span<const std::byte> data) {
+  InvalidateRange(address, data.size());
+  return FlashPartition::Write(address, data);
+}
+
+void CachingFlashPartition::InvalidateCache() {
+  for (CacheLine& line : lines_) {
+    line.valid = false;
+  }
+}
+
+CachingFlashPartition::CacheLine* CachingFlashPartition::FindLine(
+    uint32_t page) {
+  for (CacheLine& line : Set(page)) {
+    if (line.valid && line.page == page) {
+      return &line;
+    }
+  }
+  return nullptr;
+}
+
+Status CachingFlashPartition::FillLine(uint32_t page, CacheLine*& line) {
+  const span<CacheLine> set = Set(page);
+  line = &*std::min_element(
+      set.begin(), set.end(), [](const CacheLine& a, const CacheLine& b) {
+        // Invalid lines are replaced before any valid line.
+        return !a.valid || (b.valid && a.last_used < b.last_used);
+      });
+
+  line->valid = false;
+  PW_TRY(
+      FlashPartition::Read(page * page_size_bytes_, LineData(*line)).status());
+  line->page = page;
+  line->valid = true;
+  return OkStatus();
+}
+
+void CachingFlashPartition::InvalidateRange(Address address, size_t size) {
+  if (size == 0u) {
+    return;
+  }
+  const uint32_t first_page = address / page_size_bytes_;
+  const uint32_t last_page = (address + size - 1) / page_size_bytes_;
+  for (CacheLine& line : lines_) {
+    if (line.page >= first_page && line.page <= last_page) {
+      line.valid = false;
+    }
+  }
+}
+
+}  // namespace pw::kvs
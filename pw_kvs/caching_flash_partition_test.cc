@@ -0,0 +1,191 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/caching_flash_partition.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kSectorSize = 256;
+constexpr size_t kPageSize = 32;
+
+ChecksumCrc16 checksum;
+constexpr EntryFormat kFormat{.magic = 0x4a1dc0fe, .checksum = &checksum};
+
+// Counts the reads that reach the flash memory.
+class CountingFlash : public FakeFlashMemoryBuffer<kSectorSize, 8> {
+ public:
+  CountingFlash() : FakeFlashMemoryBuffer(16) {}
+
+  StatusWithSize Read(Address address, span<std::byte> output) override {
+    reads += 1;
+    return FakeFlashMemoryBuffer::Read(address, output);
+  }
+
+  size_t reads = 0;
+};
+
+class CachingFlashPartitionTest : public ::testing::Test {
+ protected:
+  CachingFlashPartitionTest() : partition_(&flash_) {
+    for (size_t i = 0; i < flash_.buffer().size(); ++i) {
+      flash_.buffer()[i] = std::byte(i);
+    }
+  }
+
+  // Reads through the cache and checks the data against the flash contents.
+  void ExpectRead(FlashPartition::Address address, size_t size) {
+    std::array<std::byte, 2 * kSectorSize> buffer{};
+    ASSERT_LE(size, buffer.size());
+    const StatusWithSize result =
+        partition_.Read(address, span(buffer).first(size));
+    ASSERT_EQ(OkStatus(), result.status());
+    EXPECT_EQ(size, result.size());
+    EXPECT_EQ(0,
+              std::memcmp(buffer.data(), &flash_.buffer()[address], size));
+  }
+
+  CountingFlash flash_;
+  // 4 sets of 2 ways of 32 bytes.
+  CachingFlashPartitionBuffer<kPageSize, 4, 2> partition_;
+};
+
+TEST_F(CachingFlashPartitionTest, RepeatedReads_HitCache) {
+  ExpectRead(40, 8);
+  EXPECT_EQ(1u, flash_.reads);
+  EXPECT_EQ(1u, partition_.cache_misses());
+
+  ExpectRead(32, 4);
+  ExpectRead(60, 4);
+  EXPECT_EQ(1u, flash_.reads);
+  EXPECT_EQ(2u, partition_.cache_hits());
+}
+
+TEST_F(CachingFlashPartitionTest, ReadAcrossPages) {
+  ExpectRead(20, 50);
+  EXPECT_EQ(3u, flash_.reads);
+
+  // The first and last pages are cached; the middle page is read again.
+  ExpectRead(0, 96);
+  EXPECT_EQ(4u, flash_.reads);
+}
+
+TEST_F(CachingFlashPartitionTest, WholePageReads_BypassCache) {
+  ExpectRead(0, 4 * kPageSize);
+  EXPECT_EQ(1u, flash_.reads);
+  EXPECT_EQ(4u, partition_.cache_misses());
+
+  // Nothing was cached.
+  ExpectRead(0, 4);
+  EXPECT_EQ(2u, flash_.reads);
+
+  // Only the uncached pages are read from flash.
+  ExpectRead(0, 2 * kPageSize);
+  EXPECT_EQ(3u, flash_.reads);
+}
+
+TEST_F(CachingFlashPartitionTest, LeastRecentlyUsedWayIsReplaced) {
+  // Pages 0, 4, and 8 map to the same set.
+  ExpectRead(0 * kPageSize, 1);
+  ExpectRead(4 * kPageSize, 1);
+  ExpectRead(0 * kPageSize, 1);
+  ExpectRead(8 * kPageSize, 1);  // Replaces page 4.
+  EXPECT_EQ(3u, flash_.reads);
+
+  ExpectRead(0 * kPageSize, 1);
+  ExpectRead(8 * kPageSize, 1);
+  EXPECT_EQ(3u, flash_.reads);
+
+  ExpectRead(4 * kPageSize, 1);
+  EXPECT_EQ(4u, flash_.reads);
+}
+
+TEST_F(CachingFlashPartitionTest, Write_InvalidatesPage) {
+  ASSERT_EQ(OkStatus(), partition_.Erase(0, 1));
+  ExpectRead(16, 16);
+  ExpectRead(32, 16);
+  EXPECT_EQ(2u, flash_.reads);
+
+  std::array<std::byte, 16> data;
+  data.fill(std::byte{0x5a});
+  ASSERT_EQ(OkStatus(), partition_.Write(16, data).status());
+  ExpectRead(16, 16);
+  EXPECT_EQ(3u, flash_.reads);
+
+  // The page after the write is still cached.
+  ExpectRead(32, 16);
+  EXPECT_EQ(3u, flash_.reads);
+}
+
+TEST_F(CachingFlashPartitionTest, Erase_InvalidatesSector) {
+  ExpectRead(16, 16);
+  ExpectRead(kSectorSize, 16);
+  EXPECT_EQ(2u, flash_.reads);
+
+  ASSERT_EQ(OkStatus(), partition_.Erase(0, 1));
+  ExpectRead(16, 16);
+  EXPECT_EQ(3u, flash_.reads);
+
+  ExpectRead(kSectorSize, 16);
+  EXPECT_EQ(3u, flash_.reads);
+}
+
+TEST_F(CachingFlashPartitionTest, InvalidateCache) {
+  ExpectRead(0, 16);
+  flash_.buffer()[4] = std::byte{0xab};
+  partition_.InvalidateCache();
+  ExpectRead(0, 16);
+  EXPECT_EQ(2u, flash_.reads);
+}
+
+TEST_F(CachingFlashPartitionTest, ReadOutOfRange) {
+  std::array<std::byte, 16> buffer;
+  EXPECT_EQ(Status::OutOfRange(),
+            partition_.Read(partition_.size_bytes() - 8, buffer).status());
+  EXPECT_EQ(0u, flash_.reads);
+}
+
+TEST_F(CachingFlashPartitionTest, KeyValueStore) {
+  KeyValueStoreBuffer<32, 8> kvs(&partition_, kFormat);
+
+  ASSERT_EQ(OkStatus(), partition_.Erase());
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  for (uint32_t i = 0; i < 10; ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put("key", i));
+    ASSERT_EQ(OkStatus(), kvs.Put("other", i * 2));
+  }
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  flash_.reads = 0;
+  for (int i = 0; i < 3; ++i) {
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), kvs.Get("key", &value));
+    EXPECT_EQ(9u, value);
+    ASSERT_EQ(OkStatus(), kvs.Get("other", &value));
+    EXPECT_EQ(18u, value);
+  }
+  EXPECT_LE(flash_.reads, 2u);
+}
+
+}  // namespace
+}  // namespace pw::kvs
@@ -45,7 +45,8 @@ Status Entry::Read(FlashPartition& partition,
   if (partition.AppearsErased(as_bytes(span(&header.magic, 1)))) {
     return Status::NotFound();
   }
-  if (header.key_length_bytes > kMaxKeyLength) {
+  if ((header.key_length_bytes & ~(kKeyLengthMask | kChunkManifestFlag)) !=
+      0u) {
     return Status::DataLoss();
   }
 
@@ -79,7 +80,8 @@ Entry::Entry(FlashPartition& partition,
              Key key,
              span<const byte> value,
              uint16_t value_size_bytes,
-             uint32_t transaction_id)
+             uint32_t transaction_id,
+             uint8_t key_flags)
     : Entry(&partition,
             address,
             format,
@@ -87,7 +89,7 @@ Entry::Entry(FlashPartition& partition,
              .checksum = 0,
              .alignment_units =
                  alignment_bytes_to_units(partition.alignment_bytes()),
-             .key_length_bytes = static_cast<uint8_t>(key.size()),
+             .key_length_bytes = static_cast<uint8_t>(key.size() | key_flags),
              .value_size_bytes = value_size_bytes,
              .transaction_id = transaction_id}) {
   if (checksum_algo_ != nullptr) {
@@ -106,6 +108,35 @@ StatusWithSize Entry::Write(Key key, span<const byte> value) const {
       {as_bytes(span(&header_, 1)), as_bytes(span(key)), value});
 }
 
+StatusWithSize Entry::Write(AlignedWriter& writer,
+                            Key key,
+                            span<const byte> value) const {
+  constexpr byte padding[kMinAlignmentBytes - 1] = {};
+  size_t written = 0;
+
+  for (span<const byte> data :
+       {as_bytes(span(&header_, 1)), as_bytes(span(key)), value}) {
+    const StatusWithSize result = writer.Write(data);
+    written += result.size();
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), written);
+    }
+  }
+
+  for (size_t padding_to_add = Padding(content_size(), alignment_bytes());
+       padding_to_add != 0u;) {
+    const size_t chunk_size = std::min(padding_to_add, sizeof(padding));
+    const StatusWithSize result = writer.Write(padding, chunk_size);
+    written += result.size();
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), written);
+    }
+    padding_to_add -= chunk_size;
+  }
+
+  return StatusWithSize(written);
+}
+
 Status Entry::Update(const EntryFormat& new_format,
                      uint32_t new_transaction_id) {
   checksum_algo_ = new_format.checksum;
@@ -148,9 +179,8 @@ StatusWithSize Entry::ReadValue(span<byte> buffer, size_t offset_bytes) const {
   const size_t remaining_bytes = value_size() - offset_bytes;
   const size_t read_size = std::min(buffer.size(), remaining_bytes);
 
-  StatusWithSize result = partition().Read(
-      address_ + sizeof(EntryHeader) + key_length() + offset_bytes,
-      buffer.subspan(0, read_size));
+  StatusWithSize result = partition().Read(value_address() + offset_bytes,
+                                           buffer.subspan(0, read_size));
   PW_TRY_WITH_SIZE(result);
 
   if (read_size != remaining_bytes) {
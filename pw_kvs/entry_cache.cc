@@ -17,6 +17,7 @@
 
 #include "pw_kvs/internal/entry_cache.h"
 
+#include <algorithm>
 #include <cinttypes>
 
 #include "pw_assert/check.h"
@@ -69,53 +70,59 @@ StatusWithSize EntryCache::Find(FlashPartition& partition,
   Entry::KeyBuffer key_buffer;
   bool error_detected = false;
 
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == hash) {
-      bool key_found = false;
-      Key read_key;
-
-      for (Address address : addresses(i)) {
-        Status read_result =
-            Entry::ReadKey(partition, address, key.size(), key_buffer.data());
-
-        read_key = Key(key_buffer.data(), key.size());
-
-        if (read_result.ok() && hash == internal::Hash(read_key)) {
-          key_found = true;
-          break;
-        } else {
-          // A hash mismatch can be caused by reading invalid data or a key hash
-          // collision of keys with differing size. To verify the data read from
-          // flash is good, validate the entry.
-          Entry entry;
-          read_result = Entry::Read(partition, address, formats, &entry);
-          if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
-            key_found = true;
-            break;
-          }
-
-          PW_LOG_WARN(
-              "   Found corrupt entry, invalidating this copy of the key");
-          error_detected = true;
-          sectors.FromAddress(address).mark_corrupt();
-        }
-      }
-      size_t error_val = error_detected ? 1 : 0;
-
-      if (!key_found) {
-        PW_LOG_ERROR("No valid entries for key. Data has been lost!");
-        return StatusWithSize::DataLoss(error_val);
-      } else if (key == read_key) {
-        PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
-        *metadata = EntryMetadata(descriptors_[i], addresses(i));
-        return StatusWithSize(error_val);
-      } else {
-        PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
-        return StatusWithSize::AlreadyExists(error_val);
+  const int index = FindIndex(hash);
+  if (index == -1) {
+    return StatusWithSize::NotFound();
+  }
+
+  const size_t i = index;
+  bool key_found = false;
+  Key read_key;
+
+  for (Address address : addresses(i)) {
+    Status read_result =
+        Entry::ReadKey(partition, address, key.size(), key_buffer.data());
+
+    read_key = Key(key_buffer.data(), key.size());
+
+    if (read_result.ok() && hash == internal::Hash(read_key)) {
+      key_found = true;
+      break;
+    } else {
+      // A hash mismatch can be caused by reading invalid data or a key hash
+      // collision of keys with differing size. To verify the data read from
+      // flash is good, validate the entry.
+      Entry entry;
+      read_result = Entry::Read(partition, address, formats, &entry);
+      if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
+        key_found = true;
+        break;
       }
+
+      PW_LOG_WARN(
+          "   Found corrupt entry, invalidating this copy of the key");
+      error_detected = true;
+      sectors.FromAddress(address).mark_corrupt();
     }
   }
-  return StatusWithSize::NotFound();
+  size_t error_val = error_detected ? 1 : 0;
+
+  if (!key_found) {
+    PW_LOG_ERROR("No valid entries for key. Data has been lost!");
+    return StatusWithSize::DataLoss(error_val);
+  } else if (key == read_key) {
+    PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
+    *metadata = EntryMetadata(descriptors_[i], addresses(i));
+    return StatusWithSize(error_val);
+  } else {
+    PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
+    return StatusWithSize::AlreadyExists(error_val);
+  }
+}
+
+void EntryCache::Reset() const {
+  descriptors_.clear();
+  std::fill(index_.begin(), index_.end(), IndexSlot(0));
 }
 
 EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
@@ -123,6 +130,7 @@ EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
   // TODO(hepler): DCHECK(!full());
   Address* first_address = ResetAddresses(descriptors_.size(), address);
   descriptors_.push_back(descriptor);
+  IndexInsert(descriptors_.size() - 1);
   return EntryMetadata(descriptors_.back(), span(first_address, 1));
 }
 
@@ -134,6 +142,8 @@ EntryCache::iterator EntryCache::RemoveEntry(iterator& entry_it) {
       entry_it.metadata_.descriptor_ - &descriptors_.front();
   const KeyDescriptor last_desc = descriptors_[descriptors_.size() - 1];
 
+  IndexErase(descriptors_[index_to_remove].key_hash);
+
   // Since order is not important, this copies the last descriptor into the
   // deleted descriptor's space and then pops the last entry.
   Address* addresses_at_end = first_address(descriptors_.size() - 1);
@@ -144,6 +154,9 @@ EntryCache::iterator EntryCache::RemoveEntry(iterator& entry_it) {
       addresses_to_remove[i] = addresses_at_end[i];
     }
     descriptors_[index_to_remove] = last_desc;
+    if (!index_.empty()) {
+      index_[FindSlot(last_desc.key_hash)] = IndexSlot(index_to_remove + 1);
+    }
   }
 
   // Erase the last entry since it was copied over the entry being deleted.
@@ -152,10 +165,9 @@ EntryCache::iterator EntryCache::RemoveEntry(iterator& entry_it) {
   return {this, descriptors_.data() + index_to_remove};
 }
 
-// TODO(hepler): This method is the trigger of the O(valid_entries *
-// all_entries) time complexity for reading. At some cost to memory, this could
-// be optimized by using a hash table instead of scanning, but in practice this
-// should be fine for a small number of keys
+// Without a hash index, this method is the trigger of the O(valid_entries *
+// all_entries) time complexity for reading. This is fine for a small number of
+// keys; larger caches should provide an index to the EntryCache.
 Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
                                           Address address,
                                           size_t sector_size_bytes) const {
@@ -220,6 +232,17 @@ size_t EntryCache::present_entries() const {
 }
 
 int EntryCache::FindIndex(uint32_t key_hash) const {
+  if (!index_.empty()) {
+    for (size_t slot = HomeSlot(key_hash); index_[slot] != 0u;
+         slot = NextSlot(slot)) {
+      const size_t i = index_[slot] - 1;
+      if (descriptors_[i].key_hash == key_hash) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
   for (size_t i = 0; i < descriptors_.size(); ++i) {
     if (descriptors_[i].key_hash == key_hash) {
       return i;
@@ -228,6 +251,54 @@ int EntryCache::FindIndex(uint32_t key_hash) const {
   return -1;
 }
 
+size_t EntryCache::FindSlot(uint32_t key_hash) const {
+  size_t slot = HomeSlot(key_hash);
+  while (descriptors_[index_[slot] - 1].key_hash != key_hash) {
+    slot = NextSlot(slot);
+  }
+  return slot;
+}
+
+void EntryCache::IndexInsert(size_t descriptor_index) const {
+  if (index_.empty()) {
+    return;
+  }
+
+  // The index has more slots than there are descriptors, so an empty slot is
+  // always found.
+  size_t slot = HomeSlot(descriptors_[descriptor_index].key_hash);
+  while (index_[slot] != 0u) {
+    slot = NextSlot(slot);
+  }
+  index_[slot] = IndexSlot(descriptor_index + 1);
+}
+
+void EntryCache::IndexErase(uint32_t key_hash) const {
+  if (index_.empty()) {
+    return;
+  }
+
+  // Remove the slot, then shift later entries in the probe sequence back into
+  // the gap so that lookups never stop early at an empty slot.
+  size_t empty = FindSlot(key_hash);
+  index_[empty] = 0;
+
+  for (size_t slot = NextSlot(empty); index_[slot] != 0u;
+       slot = NextSlot(slot)) {
+    const size_t home = HomeSlot(descriptors_[index_[slot] - 1].key_hash);
+
+    // The entry can move to the gap unless its home slot lies cyclically
+    // within (empty, slot].
+    const bool stays = empty < slot ? (empty < home && home <= slot)
+                                    : (empty < home || home <= slot);
+    if (!stays) {
+      index_[empty] = index_[slot];
+      index_[slot] = 0;
+      empty = slot;
+    }
+  }
+}
+
 void EntryCache::AddAddressIfRoom(size_t descriptor_index,
                                   Address address) const {
   Address* const existing = first_address(descriptor_index);
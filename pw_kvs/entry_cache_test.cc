@@ -14,6 +14,8 @@
 
 #include "pw_kvs/internal/entry_cache.h"
 
+#include <array>
+
 #include "pw_bytes/array.h"
 #include "pw_kvs/fake_flash_memory.h"
 #include "pw_kvs/flash_memory.h"
@@ -391,5 +393,93 @@ TEST_F(InitializedEntryCache, Find_Collision) {
   CheckForCorruptSectors();
 }
 
+class IndexedEntryCache : public ::testing::Test {
+ protected:
+  static constexpr size_t kMaxEntries = 16;
+  static constexpr size_t kIndexSlots = 19;
+
+  IndexedEntryCache()
+      : entries_(descriptors_, addresses_, kRedundancy, key_index_) {}
+
+  // Returns a key hash whose home slot is near the end of the index, so that
+  // probe sequences collide and wrap around.
+  static constexpr uint32_t CollidingHash(uint32_t i) {
+    return (kIndexSlots - 2 + i % 3) + kIndexSlots * (i + 1);
+  }
+
+  // Adds a descriptor for the hash, returning true if it updated an existing
+  // descriptor rather than adding a new one.
+  bool Updated(uint32_t key_hash) {
+    const size_t entries_before = entries_.total_entries();
+    EXPECT_EQ(OkStatus(),
+              entries_.AddNewOrUpdateExisting(
+                  {key_hash, ++transaction_id_, EntryState::kValid}, 0, 1));
+    return entries_.total_entries() == entries_before;
+  }
+
+  static constexpr size_t kRedundancy = 1;
+
+  Vector<KeyDescriptor, kMaxEntries> descriptors_;
+  EntryCache::AddressList<kMaxEntries, kRedundancy> addresses_;
+  std::array<EntryCache::IndexSlot, kIndexSlots> key_index_{};
+  uint32_t transaction_id_ = 0;
+
+  EntryCache entries_;
+};
+
+TEST_F(IndexedEntryCache, FindsEntriesWithCollidingSlots) {
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_FALSE(Updated(CollidingHash(i)));
+  }
+  ASSERT_TRUE(entries_.full());
+
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    EXPECT_TRUE(Updated(CollidingHash(i)));
+  }
+  EXPECT_EQ(kMaxEntries, entries_.total_entries());
+  EXPECT_EQ(Status::ResourceExhausted(),
+            entries_.AddNewOrUpdateExisting(
+                {CollidingHash(kMaxEntries), 1, EntryState::kValid}, 0, 1));
+}
+
+TEST_F(IndexedEntryCache, RemoveEntry_KeepsIndexConsistent) {
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    ASSERT_FALSE(Updated(CollidingHash(i)));
+  }
+
+  // Remove every third entry, which moves other descriptors and shifts index
+  // slots back across the wrap-around point.
+  for (EntryCache::iterator it = entries_.begin(); it != entries_.end();) {
+    if (it->hash() % 3 == 0) {
+      it = entries_.RemoveEntry(it);
+    } else {
+      ++it;
+    }
+  }
+
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    const uint32_t hash = CollidingHash(i);
+    if (hash % 3 != 0) {
+      EXPECT_TRUE(Updated(hash));
+    }
+  }
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    const uint32_t hash = CollidingHash(i);
+    if (hash % 3 == 0) {
+      EXPECT_FALSE(Updated(hash));
+    }
+  }
+  EXPECT_EQ(kMaxEntries, entries_.total_entries());
+}
+
+TEST_F(IndexedEntryCache, Reset_ClearsIndex) {
+  ASSERT_FALSE(Updated(CollidingHash(0)));
+  entries_.Reset();
+
+  EXPECT_EQ(0u, entries_.total_entries());
+  EXPECT_FALSE(Updated(CollidingHash(0)));
+  EXPECT_EQ(1u, entries_.total_entries());
+}
+
 }  // namespace
 }  // namespace pw::kvs::internal
@@ -0,0 +1,76 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Seed corpus of KVS writes, shared by the KVS unit tests and the entry parsing
+// corpus benchmark. Writing the corpus leaves a realistic mix of current,
+// stale and deleted entries in flash for `KeyValueStore::Init()` to parse.
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "pw_kvs/key_value_store.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/try.h"
+
+namespace pw::kvs::test {
+
+using namespace std::literals::string_view_literals;
+
+// A put of `value` to `key`, or a deletion of `key` if `value` is empty.
+struct CorpusWrite {
+  std::string_view key;
+  std::string_view value;
+};
+
+// clang-format off
+inline constexpr std::array<CorpusWrite, 16> kEntryCorpus = {{
+    {"device_name", "pigweed-sensor-01"},
+    {"boot_count", "\x01\x00\x00\x00"sv},
+    {"wifi_ssid", "pigweed-ap"},
+    {"wifi_psk", "correct horse battery staple"},
+    {"calibration", "\x3f\x80\x00\x00\x3e\x4c\xcc\xcd\x00\x00\x00\x00"
+                    "\xbd\xcc\xcc\xcd\x3f\x7f\xbe\x77\x00\x00\x00\x00"sv},
+    {"log_level", "\x02"sv},
+    {"tz", "America/Los_Angeles"},
+    {"boot_count", "\x02\x00\x00\x00"sv},
+    {"last_error", "\x0b\x00\x00\x00\x2a\x00\x00\x00"sv},
+    {"fw_version", "1.4.2"},
+    {"boot_count", "\x03\x00\x00\x00"sv},
+    {"last_error", ""},
+    {"wifi_ssid", "pigweed-ap-5g"},
+    {"features", "\xff\x0f\x00\x00\x00\x00\x00\x80"sv},
+    {"device_name", "pigweed-sensor-01a"},
+    {"boot_count", "\x04\x00\x00\x00"sv},
+}};
+// clang-format on
+
+// Number of keys in the KVS after writing kEntryCorpus.
+inline constexpr size_t kEntryCorpusKeys = 9;
+
+// Applies each write in kEntryCorpus to an initialized KVS.
+inline Status WriteEntryCorpus(KeyValueStore& kvs) {
+  for (const CorpusWrite& write : kEntryCorpus) {
+    if (write.value.empty()) {
+      PW_TRY(kvs.Delete(write.key));
+    } else {
+      PW_TRY(kvs.Put(write.key, as_bytes(span(write.value))));
+    }
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::kvs::test
@@ -18,11 +18,14 @@
 #include "pw_kvs/key_value_store.h"
 
 #include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cstring>
+#include <limits>
 #include <type_traits>
 
 #include "pw_assert/check.h"
+#include "pw_checksum/crc32.h"
 #include "pw_kvs_private/config.h"
 #include "pw_log/log.h"
 #include "pw_status/try.h"
@@ -36,6 +39,183 @@ constexpr bool InvalidKey(Key key) {
   return key.empty() || (key.size() > internal::Entry::kMaxKeyLength);
 }
 
+// A checkpoint of the KVS index is stored at the start of one sector of the
+// checkpoint partition. It consists of a CheckpointHeader, a CheckpointSector
+// for each KVS sector, a CheckpointEntry and redundancy() addresses for each
+// entry, and a CRC-32 of all of the preceding bytes.
+//
+// For KVS magic value always use a random 32 bit integer rather than a human
+// readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr uint32_t kCheckpointMagic = 0x2b6d10e4;
+
+struct CheckpointHeader {
+  uint32_t magic;
+  uint32_t generation;  // Incremented for each checkpoint written.
+  uint32_t last_transaction_id;
+  uint32_t format_magic;
+  uint32_t sector_size_bytes;
+  uint16_t sector_count;
+  uint16_t redundancy;
+  uint32_t entry_count;
+};
+
+// Records the state of a KVS sector. The transaction ID of the first entry in
+// the sector and whether the sector is erased after its last entry are used
+// to detect whether the sector has changed since the checkpoint. The erase
+// count is carried over to the next checkpoint for wear leveling.
+struct CheckpointSector {
+  uint32_t first_transaction_id;
+  uint16_t valid_bytes;
+  uint16_t writable_bytes;
+  uint32_t erase_count;
+};
+
+struct CheckpointEntry {
+  uint32_t key_hash;
+  uint32_t transaction_id;
+  uint32_t state;
+};
+
+// Transaction ID recorded for sectors with no entries.
+constexpr uint32_t kNoTransactionId = 0xffffffff;
+
+constexpr size_t CheckpointSize(size_t sectors,
+                                size_t entries,
+                                size_t redundancy) {
+  return sizeof(CheckpointHeader) + sectors * sizeof(CheckpointSector) +
+         entries * (sizeof(CheckpointEntry) +
+                    redundancy * sizeof(FlashPartition::Address)) +
+         sizeof(uint32_t);
+}
+
+// Reads the checkpoint header at the address and verifies the checkpoint's
+// checksum.
+Status ReadCheckpoint(FlashPartition& partition,
+                      FlashPartition::Address address,
+                      CheckpointHeader& header) {
+  PW_TRY(partition.Read(address, sizeof(header), &header));
+  if (header.magic != kCheckpointMagic) {
+    return Status::NotFound();
+  }
+
+  const size_t size = CheckpointSize(
+      header.sector_count, header.entry_count, header.redundancy);
+  if (size > partition.sector_size_bytes()) {
+    return Status::DataLoss();
+  }
+
+  checksum::Crc32 crc;
+  std::array<byte, 64> buffer;
+  for (size_t offset = 0; offset < size - sizeof(uint32_t);) {
+    const size_t chunk_size =
+        std::min(buffer.size(), size - sizeof(uint32_t) - offset);
+    PW_TRY(partition.Read(address + offset, span(buffer).first(chunk_size)));
+    crc.Update(span(buffer).first(chunk_size));
+    offset += chunk_size;
+  }
+
+  uint32_t expected_crc;
+  PW_TRY(partition.Read(
+      address + size - sizeof(uint32_t), sizeof(expected_crc), &expected_crc));
+  return crc.value() == expected_crc ? OkStatus() : Status::DataLoss();
+}
+
+// Finds the valid checkpoint with the highest generation in the partition.
+Status FindNewestCheckpoint(FlashPartition& partition,
+                            CheckpointHeader& header,
+                            FlashPartition::Address& address) {
+  const size_t checkpoint_sector_size = partition.sector_size_bytes();
+  bool found = false;
+  for (size_t i = 0; i < partition.sector_count(); ++i) {
+    CheckpointHeader candidate;
+    if (ReadCheckpoint(partition, i * checkpoint_sector_size, candidate).ok() &&
+        (!found || candidate.generation > header.generation)) {
+      header = candidate;
+      address = i * checkpoint_sector_size;
+      found = true;
+    }
+  }
+  return found ? OkStatus() : Status::NotFound();
+}
+
+// Buffer used to combine the flash writes for the entries in a WriteBatch.
+constexpr size_t kBatchWriteBufferSize =
+    std::max(kMaxFlashAlignment, 4 * internal::Entry::kMinAlignmentBytes);
+
+// A value that is too large for a single entry is stored as a series of chunk
+// entries followed by a manifest entry. The manifest is stored under the
+// value's key with the chunk manifest flag set in its header. It is written
+// last, so it atomically replaces the key's previous value.
+//
+// Chunks are stored under reserved keys derived from the hash of the value's
+// key, a generation, and the chunk's index. Consecutive chunked values of a
+// key alternate between two generations, so the chunks of a new value never
+// overwrite the chunks of the value it replaces.
+constexpr char kChunkKeyPrefix = '\x1f';
+
+struct ChunkManifest {
+  uint32_t value_size;
+  uint16_t chunk_size;  // The size of every chunk except the last.
+  uint8_t generation;
+  uint8_t reserved;
+};
+
+static_assert(sizeof(ChunkManifest) == 8,
+              "ChunkManifest must not have padding");
+
+// Chunk indices are 16 bits, and a value size of 0xFFFF marks a tombstone.
+constexpr size_t kMaxChunks = 0xFFFF;
+constexpr size_t kMaxChunkSize = 0xFFFE;
+constexpr size_t kMaxChunkedValueSize = std::numeric_limits<uint32_t>::max();
+
+// The key of a chunk, which is the prefix, followed by the value key's hash,
+// the generation, and the chunk index in hexadecimal.
+class ChunkKey {
+ public:
+  static constexpr size_t kLength = 14;
+
+  ChunkKey(uint32_t key_hash, uint8_t generation, size_t index) {
+    key_[0] = kChunkKeyPrefix;
+    WriteHex(key_hash, span(key_).subspan(1, 8));
+    WriteHex(generation, span(key_).subspan(9, 1));
+    WriteHex(index, span(key_).subspan(10, 4));
+  }
+
+  operator Key() const { return Key(key_.data(), key_.size()); }
+
+ private:
+  static void WriteHex(size_t value, span<char> digits) {
+    for (auto digit = digits.rbegin(); digit != digits.rend(); ++digit) {
+      *digit = "0123456789abcdef"[value % 16];
+      value /= 16;
+    }
+  }
+
+  std::array<char, kLength> key_;
+};
+
+constexpr bool IsChunkKey(Key key) {
+  return key.size() == ChunkKey::kLength && key.front() == kChunkKeyPrefix;
+}
+
+Status ReadManifest(const internal::Entry& entry,
+                    bool verify,
+                    ChunkManifest& manifest) {
+  if (entry.value_size() != sizeof(manifest)) {
+    return Status::DataLoss();
+  }
+  if (verify) {
+    PW_TRY(entry.VerifyChecksumInFlash());
+  }
+  PW_TRY(entry.ReadValue(as_writable_bytes(span(&manifest, 1))).status());
+
+  if (manifest.chunk_size == 0u || manifest.generation > 1u ||
+      manifest.value_size / manifest.chunk_size > kMaxChunks) {
+    return Status::DataLoss();
+  }
+  return OkStatus();
+}
+
 }  // namespace
 
 KeyValueStore::KeyValueStore(FlashPartition* partition,
@@ -45,52 +225,28 @@ KeyValueStore::KeyValueStore(FlashPartition* partition,
                              Vector<SectorDescriptor>& sector_descriptor_list,
                              const SectorDescriptor** temp_sectors_to_skip,
                              Vector<KeyDescriptor>& key_descriptor_list,
-                             Address* addresses)
+                             Address* addresses,
+                             span<internal::EntryCache::IndexSlot> key_index)
     : partition_(*partition),
       formats_(formats),
       sectors_(sector_descriptor_list, *partition, temp_sectors_to_skip),
-      entry_cache_(key_descriptor_list, addresses, redundancy),
+      entry_cache_(key_descriptor_list, addresses, redundancy, key_index),
       options_(options),
       initialized_(InitializationState::kNotInitialized),
       error_detected_(false),
       internal_stats_({}),
-      last_transaction_id_(0) {}
+      last_transaction_id_(0),
+      incremental_gc_sector_(nullptr),
+      chunks_present_(false) {}
 
 Status KeyValueStore::Init() {
   initialized_ = InitializationState::kNotInitialized;
   error_detected_ = false;
   last_transaction_id_ = 0;
+  incremental_gc_sector_ = nullptr;
 
   PW_LOG_INFO("Initializing key value store");
-  if (partition_.sector_count() > sectors_.max_size()) {
-    PW_LOG_ERROR(
-        "KVS init failed: kMaxUsableSectors (=%u) must be at least as "
-        "large as the number of sectors in the flash partition (=%u)",
-        unsigned(sectors_.max_size()),
-        unsigned(partition_.sector_count()));
-    return Status::FailedPrecondition();
-  }
-
-  if (partition_.sector_count() < 2) {
-    PW_LOG_ERROR(
-        "KVS init failed: FlashParition sector count (=%u) must be at 2. KVS "
-        "requires at least 1 working sector + 1 free/reserved sector",
-        unsigned(partition_.sector_count()));
-    return Status::FailedPrecondition();
-  }
-
-  const size_t sector_size_bytes = partition_.sector_size_bytes();
-
-  // TODO(davidrogers): investigate doing this as a static assert/compile-time
-  // check.
-  if (sector_size_bytes > SectorDescriptor::max_sector_size()) {
-    PW_LOG_ERROR(
-        "KVS init failed: sector_size_bytes (=%u) is greater than maximum "
-        "allowed sector size (=%u)",
-        unsigned(sector_size_bytes),
-        unsigned(SectorDescriptor::max_sector_size()));
-    return Status::FailedPrecondition();
-  }
+  PW_TRY(CheckPartitionGeometry());
 
   Status metadata_result = InitializeMetadata();
 
@@ -143,11 +299,45 @@ Status KeyValueStore::Init() {
   return OkStatus();
 }
 
+Status KeyValueStore::CheckPartitionGeometry() const {
+  if (partition_.sector_count() > sectors_.max_size()) {
+    PW_LOG_ERROR(
+        "KVS init failed: kMaxUsableSectors (=%u) must be at least as "
+        "large as the number of sectors in the flash partition (=%u)",
+        unsigned(sectors_.max_size()),
+        unsigned(partition_.sector_count()));
+    return Status::FailedPrecondition();
+  }
+
+  if (partition_.sector_count() < 2) {
+    PW_LOG_ERROR(
+        "KVS init failed: FlashParition sector count (=%u) must be at 2. KVS "
+        "requires at least 1 working sector + 1 free/reserved sector",
+        unsigned(partition_.sector_count()));
+    return Status::FailedPrecondition();
+  }
+
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+
+  // TODO(davidrogers): investigate doing this as a static assert/compile-time
+  // check.
+  if (sector_size_bytes > SectorDescriptor::max_sector_size()) {
+    PW_LOG_ERROR(
+        "KVS init failed: sector_size_bytes (=%u) is greater than maximum "
+        "allowed sector size (=%u)",
+        unsigned(sector_size_bytes),
+        unsigned(SectorDescriptor::max_sector_size()));
+    return Status::FailedPrecondition();
+  }
+  return OkStatus();
+}
+
 Status KeyValueStore::InitializeMetadata() {
   const size_t sector_size_bytes = partition_.sector_size_bytes();
 
   sectors_.Reset();
   entry_cache_.Reset();
+  chunks_present_ = false;
 
   PW_LOG_DEBUG("First pass: Read all entries from all sectors");
   Address sector_address = 0;
@@ -307,6 +497,251 @@ Status KeyValueStore::InitializeMetadata() {
   return OkStatus();
 }
 
+Status KeyValueStore::InitFromCheckpoint(FlashPartition& checkpoint_partition) {
+  initialized_ = InitializationState::kNotInitialized;
+  error_detected_ = false;
+  last_transaction_id_ = 0;
+  incremental_gc_sector_ = nullptr;
+
+  PW_LOG_INFO("Initializing key value store from checkpoint");
+  PW_TRY(CheckPartitionGeometry());
+
+  const Status status = LoadCheckpoint(checkpoint_partition);
+  if (!status.ok()) {
+    PW_LOG_INFO("KVS checkpoint not usable (%s); scanning all sectors",
+                status.str());
+    // A stale checkpoint still holds the erase counts as of when it was
+    // written, which is better for wear leveling than starting from zero.
+    LoadEraseCounts(checkpoint_partition).IgnoreError();
+    return Init();
+  }
+
+  initialized_ = InitializationState::kReady;
+  PW_LOG_INFO(
+      "KeyValueStore init from checkpoint complete: active keys %u, deleted "
+      "keys %u",
+      unsigned(size()),
+      unsigned(entry_cache_.total_entries() - size()));
+  return OkStatus();
+}
+
+Status KeyValueStore::WriteCheckpoint(FlashPartition& checkpoint_partition) {
+  if (initialized_ != InitializationState::kReady || error_detected_) {
+    return Status::FailedPrecondition();
+  }
+  if (checkpoint_partition.alignment_bytes() > kMaxFlashAlignment) {
+    return Status::InvalidArgument();
+  }
+
+  const size_t size = CheckpointSize(
+      sectors_.size(), entry_cache_.total_entries(), redundancy());
+  if (size > checkpoint_partition.sector_size_bytes()) {
+    PW_LOG_ERROR("KVS checkpoint of %u B does not fit in a %u B sector",
+                 unsigned(size),
+                 unsigned(checkpoint_partition.sector_size_bytes()));
+    return Status::ResourceExhausted();
+  }
+
+  // The checkpoint only describes fully redundant, uncorrupted entries.
+  for (const EntryMetadata& metadata : entry_cache_) {
+    if (metadata.addresses().size() != redundancy()) {
+      return Status::FailedPrecondition();
+    }
+  }
+
+  // Write to the sector after the newest valid checkpoint, so the newest
+  // checkpoint survives if this write is interrupted.
+  const size_t checkpoint_sector_size =
+      checkpoint_partition.sector_size_bytes();
+  size_t slot = 0;
+  uint32_t generation = 1;
+  for (size_t i = 0; i < checkpoint_partition.sector_count(); ++i) {
+    CheckpointHeader header;
+    if (ReadCheckpoint(checkpoint_partition, i * checkpoint_sector_size, header)
+            .ok() &&
+        header.generation >= generation) {
+      generation = header.generation + 1;
+      slot = (i + 1) % checkpoint_partition.sector_count();
+    }
+  }
+
+  const Address address = slot * checkpoint_sector_size;
+  PW_TRY(checkpoint_partition.Erase(address, 1));
+
+  FlashPartition::Output output(checkpoint_partition, address);
+  AlignedWriterBuffer<kBatchWriteBufferSize> writer(
+      checkpoint_partition.alignment_bytes(), output);
+  checksum::Crc32 crc;
+  auto write = [&writer, &crc](const auto& value) {
+    const span<const byte> data = as_bytes(span(&value, 1));
+    crc.Update(data);
+    return writer.Write(data).status();
+  };
+
+  PW_TRY(write(CheckpointHeader{
+      .magic = kCheckpointMagic,
+      .generation = generation,
+      .last_transaction_id = last_transaction_id_,
+      .format_magic = formats_.primary().magic,
+      .sector_size_bytes = uint32_t(partition_.sector_size_bytes()),
+      .sector_count = uint16_t(sectors_.size()),
+      .redundancy = uint16_t(redundancy()),
+      .entry_count = uint32_t(entry_cache_.total_entries()),
+  }));
+
+  for (const SectorDescriptor& sector : sectors_) {
+    uint32_t first_transaction_id;
+    PW_TRY(ReadFirstTransactionId(sector, first_transaction_id));
+    PW_TRY(write(CheckpointSector{
+        .first_transaction_id = first_transaction_id,
+        .valid_bytes = uint16_t(sector.valid_bytes()),
+        .writable_bytes = uint16_t(sector.writable_bytes()),
+        .erase_count = sector.erase_count(),
+    }));
+  }
+
+  for (const EntryMetadata& metadata : entry_cache_) {
+    PW_TRY(write(CheckpointEntry{
+        .key_hash = metadata.hash(),
+        .transaction_id = metadata.transaction_id(),
+        .state = uint32_t(metadata.state()),
+    }));
+    for (Address entry_address : metadata.addresses()) {
+      PW_TRY(write(entry_address));
+    }
+  }
+
+  const uint32_t checksum = crc.value();
+  PW_TRY(writer.Write(&checksum, sizeof(checksum)));
+  PW_TRY(writer.Flush());
+
+  PW_LOG_INFO("Wrote KVS checkpoint %u (%u B)",
+              unsigned(generation),
+              unsigned(size));
+  return OkStatus();
+}
+
+Status KeyValueStore::LoadCheckpoint(FlashPartition& checkpoint_partition) {
+  CheckpointHeader header{};
+  Address address = 0;
+  PW_TRY(FindNewestCheckpoint(checkpoint_partition, header, address));
+
+  if (header.sector_count != partition_.sector_count() ||
+      header.sector_size_bytes != partition_.sector_size_bytes() ||
+      header.redundancy != redundancy() ||
+      header.format_magic != formats_.primary().magic ||
+      header.entry_count > entry_cache_.max_entries()) {
+    return Status::FailedPrecondition();
+  }
+
+  sectors_.Reset();
+  entry_cache_.Reset();
+
+  // Checkpoints don't record keys, so assume that chunks may be present.
+  chunks_present_ = true;
+  FlashPartition::Input input(checkpoint_partition,
+                              address + sizeof(CheckpointHeader));
+
+  // Restore each sector, checking that nothing was written to or erased from
+  // the sector since the checkpoint.
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  bool empty_sector_found = false;
+  for (SectorDescriptor& sector : sectors_) {
+    CheckpointSector record;
+    PW_TRY(input.Read(as_writable_bytes(span(&record, 1))));
+
+    uint32_t first_transaction_id;
+    PW_TRY(ReadFirstTransactionId(sector, first_transaction_id));
+    if (first_transaction_id != record.first_transaction_id ||
+        record.writable_bytes > sector_size_bytes ||
+        record.valid_bytes > sector_size_bytes - record.writable_bytes) {
+      return Status::DataLoss();
+    }
+
+    if (record.writable_bytes != 0u &&
+        record.writable_bytes != sector_size_bytes) {
+      uint32_t magic;
+      PW_TRY(partition_.Read(sectors_.BaseAddress(sector) + sector_size_bytes -
+                                 record.writable_bytes,
+                             sizeof(magic),
+                             &magic));
+      if (!partition_.AppearsErased(as_bytes(span(&magic, 1)))) {
+        return Status::DataLoss();
+      }
+    }
+
+    sector.set_writable_bytes(record.writable_bytes);
+    sector.AddValidBytes(record.valid_bytes);
+    sector.set_erase_count(record.erase_count);
+    empty_sector_found |= sector.Empty(sector_size_bytes);
+  }
+
+  if (!empty_sector_found) {
+    return Status::DataLoss();
+  }
+
+  // Restore the key descriptors.
+  Address newest_key = 0;
+  for (size_t i = 0; i < header.entry_count; ++i) {
+    CheckpointEntry record;
+    PW_TRY(input.Read(as_writable_bytes(span(&record, 1))));
+    if (record.state != uint32_t(EntryState::kValid) &&
+        record.state != uint32_t(EntryState::kDeleted)) {
+      return Status::DataLoss();
+    }
+
+    Address entry_address;
+    PW_TRY(input.Read(as_writable_bytes(span(&entry_address, 1))));
+    EntryMetadata metadata = entry_cache_.AddNew(
+        {record.key_hash, record.transaction_id, EntryState(record.state)},
+        entry_address);
+    for (size_t copy = 1; copy < redundancy(); ++copy) {
+      PW_TRY(input.Read(as_writable_bytes(span(&entry_address, 1))));
+      metadata.AddNewAddress(entry_address);
+    }
+
+    if (metadata.IsNewerThan(last_transaction_id_)) {
+      last_transaction_id_ = metadata.transaction_id();
+      newest_key = metadata.addresses().back();
+    }
+  }
+
+  sectors_.set_last_new_sector(newest_key);
+  last_transaction_id_ = header.last_transaction_id;
+  return OkStatus();
+}
+
+Status KeyValueStore::LoadEraseCounts(FlashPartition& checkpoint_partition) {
+  CheckpointHeader header{};
+  Address address = 0;
+  PW_TRY(FindNewestCheckpoint(checkpoint_partition, header, address));
+  if (header.sector_count != partition_.sector_count() ||
+      header.sector_size_bytes != partition_.sector_size_bytes()) {
+    return Status::FailedPrecondition();
+  }
+
+  sectors_.Reset();
+  FlashPartition::Input input(checkpoint_partition,
+                              address + sizeof(CheckpointHeader));
+  for (SectorDescriptor& sector : sectors_) {
+    CheckpointSector record;
+    PW_TRY(input.Read(as_writable_bytes(span(&record, 1))));
+    sector.set_erase_count(record.erase_count);
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::ReadFirstTransactionId(const SectorDescriptor& sector,
+                                             uint32_t& transaction_id) {
+  internal::EntryHeader header;
+  PW_TRY(
+      partition_.Read(sectors_.BaseAddress(sector), sizeof(header), &header));
+  transaction_id = partition_.AppearsErased(as_bytes(span(&header.magic, 1)))
+                       ? kNoTransactionId
+                       : header.transaction_id;
+  return OkStatus();
+}
+
 KeyValueStore::StorageStats KeyValueStore::GetStorageStats() const {
   StorageStats stats{};
   const size_t sector_size = partition_.sector_size_bytes();
@@ -316,9 +751,14 @@ KeyValueStore::StorageStats KeyValueStore::GetStorageStats() const {
   stats.missing_redundant_entries_recovered =
       internal_stats_.missing_redundant_entries_recovered;
 
+  stats.min_sector_erase_count = sectors_.size() == 0 ? 0 : UINT32_MAX;
   for (const SectorDescriptor& sector : sectors_) {
     stats.in_use_bytes += sector.valid_bytes();
     stats.reclaimable_bytes += sector.RecoverableBytes(sector_size);
+    stats.min_sector_erase_count =
+        std::min(stats.min_sector_erase_count, sector.erase_count());
+    stats.max_sector_erase_count =
+        std::max(stats.max_sector_erase_count, sector.erase_count());
 
     if (!found_empty_sector && sector.Empty(sector_size)) {
       // The KVS tries to always keep an empty sector for GC, so don't count
@@ -372,6 +812,10 @@ Status KeyValueStore::LoadEntry(Address entry_address,
 
   PW_TRY(entry.VerifyChecksumInFlash());
 
+  if (IsChunkKey(key)) {
+    chunks_present_ = true;
+  }
+
   // A valid entry was found, so update the next entry address before doing any
   // of the checks that happen in AddNewOrUpdateExisting.
   *next_entry_address = entry.next_address();
@@ -455,6 +899,40 @@ StatusWithSize KeyValueStore::Get(Key key,
   return Get(key, metadata, value_buffer, offset_bytes);
 }
 
+Result<ConstByteSpan> KeyValueStore::GetView(Key key) const {
+  PW_TRY(CheckReadOperation(key));
+
+  EntryMetadata metadata;
+  PW_TRY(FindExisting(key, &metadata));
+
+  Entry entry;
+  PW_TRY(ReadEntry(metadata, entry));
+
+  if (entry.chunk_manifest()) {
+    return Status::Unimplemented();
+  }
+
+  const byte* value = partition_.PartitionAddressToMcuAddress(
+      entry.value_address());
+  if (value == nullptr) {
+    return Status::Unimplemented();
+  }
+  const ConstByteSpan view(value, entry.value_size());
+
+  // The value must also be contiguous in the MCU address space.
+  if (!view.empty() &&
+      partition_.PartitionAddressToMcuAddress(entry.value_address() +
+                                              view.size() - 1) !=
+          &view.back()) {
+    return Status::Unimplemented();
+  }
+
+  if (options_.verify_on_read) {
+    PW_TRY(entry.VerifyChecksum(key, view));
+  }
+  return view;
+}
+
 Status KeyValueStore::PutBytes(Key key, span<const byte> value) {
   PW_TRY(CheckWriteOperation(key));
   PW_LOG_DEBUG("Writing key/value; key length=%u, value length=%u",
@@ -462,12 +940,21 @@ Status KeyValueStore::PutBytes(Key key, span<const byte> value) {
                unsigned(value.size()));
 
   if (Entry::size(partition_, key, value) > partition_.sector_size_bytes()) {
+    if (options_.chunk_large_values) {
+      return PutChunked(key, value);
+    }
     PW_LOG_DEBUG("%u B value with %u B key cannot fit in one sector",
                  unsigned(value.size()),
                  unsigned(key.size()));
     return Status::InvalidArgument();
   }
 
+  return WriteValue(key, value, ValueKind::kValue);
+}
+
+Status KeyValueStore::WriteValue(Key key,
+                                 span<const byte> value,
+                                 ValueKind kind) {
   EntryMetadata metadata;
   Status status = FindEntry(key, &metadata);
 
@@ -477,16 +964,156 @@ Status KeyValueStore::PutBytes(Key key, span<const byte> value) {
                  unsigned(metadata.hash()),
                  unsigned(metadata.addresses().size()),
                  sectors_.Index(metadata.first_address()));
-    return WriteEntryForExistingKey(metadata, EntryState::kValid, key, value);
+
+    // Read the original entry to get the size for sector accounting purposes.
+    Entry prior_entry;
+    PW_TRY(ReadEntry(metadata, prior_entry));
+    const bool replaces_chunks = kind == ValueKind::kValue &&
+                                 metadata.state() == EntryState::kValid &&
+                                 prior_entry.chunk_manifest();
+
+    PW_TRY(WriteEntry(
+        key, value, EntryState::kValid, &metadata, &prior_entry, kind));
+
+    // The new value is stored, so failing to remove the old chunks is not an
+    // error. Stale chunks are removed the next time the key is written with
+    // chunks or deleted.
+    if (replaces_chunks) {
+      status = DeleteAllChunks(internal::Hash(key));
+      if (!status.ok()) {
+        PW_LOG_WARN("Failed to remove stale chunks: %s", status.str());
+      }
+    }
+    return OkStatus();
   }
 
   if (status.IsNotFound()) {
-    return WriteEntryForNewKey(key, value);
+    return WriteEntryForNewKey(key, value, kind);
   }
 
   return status;
 }
 
+size_t KeyValueStore::max_chunk_size() const {
+  return std::min(max_key_value_size_bytes() - ChunkKey::kLength,
+                  kMaxChunkSize);
+}
+
+Status KeyValueStore::PutChunked(Key key, span<const byte> value) {
+  const size_t chunk_size = max_chunk_size();
+  const size_t chunk_count = (value.size() + chunk_size - 1) / chunk_size;
+  if (value.size() > kMaxChunkedValueSize || chunk_count > kMaxChunks) {
+    PW_LOG_DEBUG("%u B value is too large to store in chunks",
+                 unsigned(value.size()));
+    return Status::InvalidArgument();
+  }
+
+  uint8_t generation;
+  PW_TRY(NextChunkGeneration(key, generation));
+
+  const uint32_t key_hash = internal::Hash(key);
+  for (size_t i = 0; i < chunk_count; ++i) {
+    const size_t offset = i * chunk_size;
+    PW_TRY(WriteChunk(
+        key_hash,
+        generation,
+        i,
+        value.subspan(offset, std::min(chunk_size, value.size() - offset))));
+  }
+  return CommitChunkedValue(
+      key, value.size(), chunk_size, chunk_count, generation);
+}
+
+Status KeyValueStore::NextChunkGeneration(Key key, uint8_t& generation) const {
+  generation = 0;
+
+  // A key whose hash collides with another key can't be written, and must not
+  // overwrite that key's chunks, so report the collision before any chunks
+  // are written.
+  EntryMetadata metadata;
+  const Status status = FindEntry(key, &metadata);
+  if (status.IsNotFound() ||
+      (status.ok() && metadata.state() == EntryState::kDeleted)) {
+    return OkStatus();
+  }
+  PW_TRY(status);
+
+  Entry entry;
+  PW_TRY(ReadEntry(metadata, entry));
+  if (entry.chunk_manifest()) {
+    ChunkManifest manifest;
+    PW_TRY(ReadManifest(entry, options_.verify_on_read, manifest));
+    generation = manifest.generation ^ 1u;
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::WriteChunk(uint32_t key_hash,
+                                 uint8_t generation,
+                                 size_t index,
+                                 span<const byte> data) {
+  chunks_present_ = true;
+  return WriteValue(
+      ChunkKey(key_hash, generation, index), data, ValueKind::kValue);
+}
+
+Status KeyValueStore::CommitChunkedValue(Key key,
+                                         size_t value_size,
+                                         size_t chunk_size,
+                                         size_t chunk_count,
+                                         uint8_t generation) {
+  const ChunkManifest manifest{static_cast<uint32_t>(value_size),
+                               static_cast<uint16_t>(chunk_size),
+                               generation,
+                               0};
+  PW_TRY(WriteValue(
+      key, as_bytes(span(&manifest, 1)), ValueKind::kChunkManifest));
+
+  // Remove the chunks of the previous value, and any chunks left over from
+  // interrupted writes. As in WriteValue(), failing to do so is not an error.
+  const uint32_t key_hash = internal::Hash(key);
+  Status status = DeleteChunks(key_hash, generation, chunk_count);
+  if (status.ok()) {
+    status = DeleteChunks(key_hash, generation ^ 1u, 0);
+  }
+  if (!status.ok()) {
+    PW_LOG_WARN("Failed to remove stale chunks: %s", status.str());
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::DeleteChunks(uint32_t key_hash,
+                                   uint8_t generation,
+                                   size_t first_index) {
+  EntryMetadata metadata;
+  size_t end_index = first_index;
+  while (end_index < kMaxChunks &&
+         FindChunk(key_hash, generation, end_index, &metadata).ok()) {
+    end_index += 1;
+  }
+
+  while (end_index > first_index) {
+    end_index -= 1;
+    const ChunkKey chunk_key(key_hash, generation, end_index);
+    PW_TRY(FindExisting(chunk_key, &metadata));
+    PW_TRY(WriteEntryForExistingKey(
+        metadata, EntryState::kDeleted, chunk_key, {}));
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::DeleteAllChunks(uint32_t key_hash) {
+  PW_TRY(DeleteChunks(key_hash, 0, 0));
+  return DeleteChunks(key_hash, 1, 0);
+}
+
+Status KeyValueStore::FindChunk(uint32_t key_hash,
+                                uint8_t generation,
+                                size_t index,
+                                EntryMetadata* metadata_out) const {
+  return FindExisting(ChunkKey(key_hash, generation, index), metadata_out);
+}
+
 Status KeyValueStore::Delete(Key key) {
   PW_TRY(CheckWriteOperation(key));
 
@@ -498,7 +1125,325 @@ Status KeyValueStore::Delete(Key key) {
                unsigned(metadata.hash()),
                unsigned(metadata.addresses().size()),
                sectors_.Index(metadata.first_address()));
-  return WriteEntryForExistingKey(metadata, EntryState::kDeleted, key, {});
+
+  Entry entry;
+  PW_TRY(ReadEntry(metadata, entry));
+  PW_TRY(WriteEntry(key, {}, EntryState::kDeleted, &metadata, &entry));
+
+  // As in WriteValue(), failing to remove the chunks is not an error.
+  if (entry.chunk_manifest()) {
+    const Status status = DeleteAllChunks(internal::Hash(key));
+    if (!status.ok()) {
+      PW_LOG_WARN("Failed to remove stale chunks: %s", status.str());
+    }
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::Commit(WriteBatch& batch) {
+  size_t batch_size = 0;
+  size_t new_keys = 0;
+  bool replaces_chunked_value = false;
+
+  // Validate every put and find the values that are already stored before
+  // writing anything.
+  for (WriteBatch::StagedPut& put : batch.puts_) {
+    PW_TRY(CheckWriteOperation(put.key));
+
+    const size_t entry_size = Entry::size(partition_, put.key, put.value);
+    if (entry_size > partition_.sector_size_bytes()) {
+      PW_LOG_DEBUG("%u B value with %u B key cannot fit in one sector",
+                   unsigned(put.value.size()),
+                   unsigned(put.key.size()));
+      return Status::InvalidArgument();
+    }
+
+    put.unchanged = false;
+    EntryMetadata metadata;
+    const Status status = FindEntry(put.key, &metadata);
+    if (status.ok()) {
+      Entry prior_entry;
+      PW_TRY(ReadEntry(metadata, prior_entry));
+      const bool prior_valid = metadata.state() == EntryState::kValid;
+      replaces_chunked_value |= prior_valid && prior_entry.chunk_manifest();
+      put.unchanged = prior_valid && !prior_entry.chunk_manifest() &&
+                      prior_entry.value_size() == put.value.size() &&
+                      prior_entry.ValueMatches(put.value).ok();
+    } else if (status.IsNotFound()) {
+      new_keys += 1;
+    } else {
+      return status;
+    }
+
+    if (!put.unchanged) {
+      batch_size += entry_size;
+    }
+  }
+
+  if (batch_size == 0u) {
+    return OkStatus();
+  }
+
+  if (entry_cache_.total_entries() + new_keys > entry_cache_.max_entries()) {
+    PW_LOG_WARN("KVS full: batch needs %u new entries, but only %u remain",
+                unsigned(new_keys),
+                unsigned(entry_cache_.max_entries() -
+                         entry_cache_.total_entries()));
+    return Status::ResourceExhausted();
+  }
+
+  // Replacing a chunked value also removes its chunks, which PutBytes() does.
+  if (batch_size > partition_.sector_size_bytes() || replaces_chunked_value) {
+    return CommitEachPut(batch);
+  }
+
+  // Find a sector with room for the whole batch for each copy. If there is no
+  // such sector, the entries may still fit individually.
+  Address* reserved_addresses = entry_cache_.TempReservedAddressesForWrite();
+  const Status reserve_status =
+      GetAddressesForWrite(reserved_addresses, batch_size);
+  if (reserve_status.IsResourceExhausted()) {
+    return CommitEachPut(batch);
+  }
+  PW_TRY(reserve_status);
+
+  // Always burn the transaction IDs, as CreateEntry() does.
+  const uint32_t first_transaction_id = last_transaction_id_ + 1;
+  for (const WriteBatch::StagedPut& put : batch.puts_) {
+    if (!put.unchanged) {
+      last_transaction_id_ += 1;
+    }
+  }
+
+  for (size_t i = 0; i < redundancy(); ++i) {
+    PW_TRY(AppendBatch(batch, reserved_addresses[i], first_transaction_id));
+
+    // After the first copy is written, update the key descriptors, which
+    // invalidates the old entries. Later copies add redundant addresses.
+    uint32_t transaction_id = first_transaction_id;
+    Address address = reserved_addresses[i];
+    for (const WriteBatch::StagedPut& put : batch.puts_) {
+      if (put.unchanged) {
+        continue;
+      }
+
+      EntryMetadata metadata;
+      const Status status = FindEntry(put.key, &metadata);
+      if (i != 0u) {
+        PW_TRY(status);
+        metadata.AddNewAddress(address);
+      } else if (status.ok()) {
+        Entry prior_entry;
+        PW_TRY(ReadEntry(metadata, prior_entry));
+        for (Address prior_address : metadata.addresses()) {
+          sectors_.FromAddress(prior_address)
+              .RemoveValidBytes(prior_entry.size());
+        }
+        metadata.Reset({internal::Hash(put.key),
+                        transaction_id,
+                        EntryState::kValid},
+                       address);
+      } else {
+        entry_cache_.AddNew(
+            {internal::Hash(put.key), transaction_id, EntryState::kValid},
+            address);
+      }
+
+      transaction_id += 1;
+      address += Entry::size(partition_, put.key, put.value);
+    }
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::CommitEachPut(const WriteBatch& batch) {
+  for (const WriteBatch::StagedPut& put : batch.puts_) {
+    if (!put.unchanged) {
+      PW_TRY(PutBytes(put.key, put.value));
+    }
+  }
+  return OkStatus();
+}
+
+Status KeyValueStore::ValueReader::Open(Key key) {
+  if (open_) {
+    return Status::FailedPrecondition();
+  }
+  PW_TRY(kvs_.CheckReadOperation(key));
+
+  EntryMetadata metadata;
+  PW_TRY(kvs_.FindExisting(key, &metadata));
+
+  Entry entry;
+  PW_TRY(kvs_.ReadEntry(metadata, entry));
+  return Open(metadata.hash(), entry);
+}
+
+Status KeyValueStore::ValueReader::Open(uint32_t key_hash, const Entry& entry) {
+  if (entry.chunk_manifest()) {
+    ChunkManifest manifest;
+    PW_TRY(ReadManifest(entry, kvs_.options_.verify_on_read, manifest));
+    value_size_ = manifest.value_size;
+    chunk_size_ = manifest.chunk_size;
+    generation_ = manifest.generation;
+    entry_loaded_ = false;
+  } else {
+    if (kvs_.options_.verify_on_read) {
+      PW_TRY(entry.VerifyChecksumInFlash());
+    }
+    value_size_ = entry.value_size();
+    chunk_size_ = 0;
+    entry_ = entry;
+    entry_offset_ = 0;
+    entry_loaded_ = true;
+  }
+
+  key_hash_ = key_hash;
+  position_ = 0;
+  open_ = true;
+  return OkStatus();
+}
+
+Status KeyValueStore::ValueReader::LoadChunk() {
+  const size_t index = position_ / chunk_size_;
+  const size_t offset = index * chunk_size_;
+
+  // The manifest is only written after all of its chunks, so a missing chunk
+  // means that the value is corrupt.
+  EntryMetadata metadata;
+  const Status status =
+      kvs_.FindChunk(key_hash_, generation_, index, &metadata);
+  if (status.IsNotFound()) {
+    return Status::DataLoss();
+  }
+  PW_TRY(status);
+
+  Entry entry;
+  PW_TRY(kvs_.ReadEntry(metadata, entry));
+  if (entry.value_size() != std::min(chunk_size_, value_size_ - offset)) {
+    return Status::DataLoss();
+  }
+  if (kvs_.options_.verify_on_read) {
+    PW_TRY(entry.VerifyChecksumInFlash());
+  }
+
+  entry_ = entry;
+  entry_offset_ = offset;
+  entry_loaded_ = true;
+  return OkStatus();
+}
+
+StatusWithSize KeyValueStore::ValueReader::DoRead(ByteSpan destination) {
+  if (!open_) {
+    return StatusWithSize::FailedPrecondition();
+  }
+  if (position_ >= value_size_) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  size_t bytes_read = 0;
+  while (bytes_read < destination.size() && position_ < value_size_) {
+    if (!entry_loaded_ || position_ < entry_offset_ ||
+        position_ >= entry_offset_ + entry_.value_size()) {
+      const Status status = LoadChunk();
+      if (!status.ok()) {
+        return StatusWithSize(status, bytes_read);
+      }
+    }
+
+    const StatusWithSize result = entry_.ReadValue(
+        destination.subspan(bytes_read), position_ - entry_offset_);
+    if (!result.ok() && !result.IsResourceExhausted()) {
+      return StatusWithSize(result.status(), bytes_read);
+    }
+    bytes_read += result.size();
+    position_ += result.size();
+  }
+  return StatusWithSize(bytes_read);
+}
+
+Status KeyValueStore::ValueWriter::Open(Key key) {
+  if (open_) {
+    return Status::FailedPrecondition();
+  }
+  PW_TRY(kvs_.CheckWriteOperation(key));
+
+  chunk_size_ = std::min(buffer_.size(), kvs_.max_chunk_size());
+  if (chunk_size_ == 0u) {
+    return Status::InvalidArgument();
+  }
+  PW_TRY(kvs_.NextChunkGeneration(key, generation_));
+
+  std::copy(key.begin(), key.end(), key_buffer_.begin());
+  key_length_ = key.size();
+  buffered_ = 0;
+  chunk_count_ = 0;
+  value_size_ = 0;
+  open_ = true;
+  return OkStatus();
+}
+
+Status KeyValueStore::ValueWriter::Close() {
+  if (!open_) {
+    return Status::FailedPrecondition();
+  }
+  open_ = false;
+
+  // A value that was never split into chunks is stored as a regular entry if
+  // it fits in one.
+  const span<const byte> buffered = buffer_.first(buffered_);
+  if (chunk_count_ == 0u && Entry::size(kvs_.partition_, key(), buffered) <=
+                                kvs_.partition_.sector_size_bytes()) {
+    return kvs_.WriteValue(key(), buffered, ValueKind::kValue);
+  }
+
+  if (buffered_ != 0u) {
+    PW_TRY(WriteChunk());
+  }
+  return kvs_.CommitChunkedValue(
+      key(), value_size_, chunk_size_, chunk_count_, generation_);
+}
+
+Status KeyValueStore::ValueWriter::WriteChunk() {
+  PW_TRY(kvs_.WriteChunk(internal::Hash(key()),
+                         generation_,
+                         chunk_count_,
+                         buffer_.first(buffered_)));
+  chunk_count_ += 1;
+  buffered_ = 0;
+  return OkStatus();
+}
+
+size_t KeyValueStore::ValueWriter::ConservativeLimit(LimitType type) const {
+  if (!open_ || type != LimitType::kWrite) {
+    return 0;
+  }
+  return std::min(kMaxChunkedValueSize, kMaxChunks * chunk_size_) -
+         value_size_;
+}
+
+Status KeyValueStore::ValueWriter::DoWrite(ConstByteSpan data) {
+  if (!open_) {
+    return Status::FailedPrecondition();
+  }
+  if (data.size() > ConservativeLimit(LimitType::kWrite)) {
+    return Status::OutOfRange();
+  }
+
+  // Chunks are written when more data arrives for a full buffer, rather than
+  // as soon as it fills, so that Close() can store a value that fits in the
+  // buffer as a regular entry.
+  while (!data.empty()) {
+    if (buffered_ == chunk_size_) {
+      PW_TRY(WriteChunk());
+    }
+    const size_t to_copy = std::min(data.size(), chunk_size_ - buffered_);
+    std::memcpy(buffer_.data() + buffered_, data.data(), to_copy);
+    buffered_ += to_copy;
+    value_size_ += to_copy;
+    data = data.subspan(to_copy);
+  }
+  return OkStatus();
 }
 
 void KeyValueStore::Item::ReadKey() {
@@ -512,23 +1457,41 @@ void KeyValueStore::Item::ReadKey() {
 }
 
 KeyValueStore::iterator& KeyValueStore::iterator::operator++() {
-  // Skip to the next entry that is valid (not deleted).
+  // Skip to the next entry that is valid (not deleted) and not a chunk.
   while (++item_.iterator_ != item_.kvs_.entry_cache_.end() &&
-         item_.iterator_->state() != EntryState::kValid) {
+         item_.kvs_.HiddenFromIteration(*item_.iterator_)) {
   }
   return *this;
 }
 
 KeyValueStore::iterator KeyValueStore::begin() const {
   internal::EntryCache::const_iterator cache_iterator = entry_cache_.begin();
-  // Skip over any deleted entries at the start of the descriptor list.
+  // Skip over any deleted or chunk entries at the start of the descriptor list.
   while (cache_iterator != entry_cache_.end() &&
-         cache_iterator->state() != EntryState::kValid) {
+         HiddenFromIteration(*cache_iterator)) {
     ++cache_iterator;
   }
   return iterator(*this, cache_iterator);
 }
 
+bool KeyValueStore::HiddenFromIteration(const EntryMetadata& metadata) const {
+  if (metadata.state() != EntryState::kValid) {
+    return true;
+  }
+  if (!chunks_present_) {
+    return false;
+  }
+
+  Entry entry;
+  Entry::KeyBuffer key_buffer;
+  if (!ReadEntry(metadata, entry).ok()) {
+    return false;
+  }
+  const StatusWithSize key_length = entry.ReadKey(key_buffer);
+  return key_length.ok() &&
+         IsChunkKey(Key(key_buffer.data(), key_length.size()));
+}
+
 StatusWithSize KeyValueStore::ValueSize(Key key) const {
   PW_TRY_WITH_SIZE(CheckReadOperation(key));
 
@@ -587,6 +1550,25 @@ StatusWithSize KeyValueStore::Get(Key key,
 
   PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
 
+  if (entry.chunk_manifest()) {
+    ValueReader reader(*this);
+    PW_TRY_WITH_SIZE(reader.Open(metadata.hash(), entry));
+    if (offset_bytes > reader.value_size()) {
+      return StatusWithSize::OutOfRange();
+    }
+
+    const size_t remaining_bytes = reader.value_size() - offset_bytes;
+    if (remaining_bytes == 0u) {
+      return StatusWithSize(0);
+    }
+    reader.position_ = offset_bytes;
+    const StatusWithSize result = reader.DoRead(value_buffer);
+    if (result.ok() && result.size() != remaining_bytes) {
+      return StatusWithSize::ResourceExhausted(result.size());
+    }
+    return result;
+  }
+
   StatusWithSize result = entry.ReadValue(value_buffer, offset_bytes);
   if (result.ok() && options_.verify_on_read && offset_bytes == 0u) {
     Status verify_result =
@@ -637,11 +1619,17 @@ StatusWithSize KeyValueStore::ValueSize(const EntryMetadata& metadata) const {
   Entry entry;
   PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
 
+  if (entry.chunk_manifest()) {
+    ChunkManifest manifest;
+    PW_TRY_WITH_SIZE(ReadManifest(entry, options_.verify_on_read, manifest));
+    return StatusWithSize(manifest.value_size);
+  }
   return StatusWithSize(entry.value_size());
 }
 
 Status KeyValueStore::CheckWriteOperation(Key key) const {
-  if (InvalidKey(key)) {
+  // Keys that start with the chunk key prefix are reserved for chunks.
+  if (InvalidKey(key) || key.front() == kChunkKeyPrefix) {
     return Status::InvalidArgument();
   }
 
@@ -676,7 +1664,9 @@ Status KeyValueStore::WriteEntryForExistingKey(EntryMetadata& metadata,
   return WriteEntry(key, value, new_state, &metadata, &entry);
 }
 
-Status KeyValueStore::WriteEntryForNewKey(Key key, span<const byte> value) {
+Status KeyValueStore::WriteEntryForNewKey(Key key,
+                                          span<const byte> value,
+                                          ValueKind kind) {
   // If there is no room in the cache for a new entry, it is possible some cache
   // entries could be freed by removing deleted keys. If deleted key removal is
   // enabled and the KVS is configured to make all possible writes succeed,
@@ -700,20 +1690,22 @@ Status KeyValueStore::WriteEntryForNewKey(Key key, span<const byte> value) {
     return Status::ResourceExhausted();
   }
 
-  return WriteEntry(key, value, EntryState::kValid);
+  return WriteEntry(key, value, EntryState::kValid, nullptr, nullptr, kind);
 }
 
 Status KeyValueStore::WriteEntry(Key key,
                                  span<const byte> value,
                                  EntryState new_state,
                                  EntryMetadata* prior_metadata,
-                                 const Entry* prior_entry) {
+                                 const Entry* prior_entry,
+                                 ValueKind kind) {
   // If new entry and prior entry have matching value size, state, and checksum,
   // check if the values match. Directly compare the prior and new values
   // because the checksum can not be depended on to establish equality, it can
   // only be depended on to establish inequality.
   if (prior_entry != nullptr && prior_entry->value_size() == value.size() &&
       prior_metadata->state() == new_state &&
+      prior_entry->chunk_manifest() == (kind == ValueKind::kChunkManifest) &&
       prior_entry->ValueMatches(value).ok()) {
     // The new value matches the prior value, don't need to write anything. Just
     // keep the existing entry.
@@ -731,7 +1723,8 @@ Status KeyValueStore::WriteEntry(Key key,
   PW_TRY(GetAddressesForWrite(reserved_addresses, entry_size));
 
   // Write the entry at the first address that was found.
-  Entry entry = CreateEntry(reserved_addresses[0], key, value, new_state);
+  Entry entry =
+      CreateEntry(reserved_addresses[0], key, value, new_state, kind);
   PW_TRY(AppendEntry(entry, key, value));
 
   // After writing the first entry successfully, update the key descriptors.
@@ -876,6 +1869,54 @@ Status KeyValueStore::AppendEntry(const Entry& entry,
   return OkStatus();
 }
 
+Status KeyValueStore::AppendBatch(const WriteBatch& batch,
+                                  Address address,
+                                  uint32_t first_transaction_id) {
+  SectorDescriptor& sector = sectors_.FromAddress(address);
+  FlashPartition::Output output(partition_, address);
+  AlignedWriterBuffer<kBatchWriteBufferSize> writer(
+      partition_.alignment_bytes(), output);
+
+  uint32_t transaction_id = first_transaction_id;
+  Address entry_address = address;
+  for (const WriteBatch::StagedPut& put : batch.puts_) {
+    if (put.unchanged) {
+      continue;
+    }
+
+    const Entry entry = Entry::Valid(partition_,
+                                     entry_address,
+                                     formats_.primary(),
+                                     put.key,
+                                     put.value,
+                                     transaction_id++);
+    const StatusWithSize result = entry.Write(writer, put.key, put.value);
+    if (!result.ok()) {
+      PW_LOG_ERROR("Failed to write %u byte batch entry at %#x",
+                   unsigned(entry.size()),
+                   unsigned(entry_address));
+      PW_TRY(MarkSectorCorruptIfNotOk(result.status(), &sector));
+    }
+    entry_address += entry.size();
+  }
+  PW_TRY(MarkSectorCorruptIfNotOk(writer.Flush().status(), &sector));
+
+  if (options_.verify_on_write) {
+    for (Address verify_address = address; verify_address < entry_address;) {
+      Entry entry;
+      PW_TRY(MarkSectorCorruptIfNotOk(
+          Entry::Read(partition_, verify_address, formats_, &entry), &sector));
+      PW_TRY(MarkSectorCorruptIfNotOk(entry.VerifyChecksumInFlash(), &sector));
+      verify_address = entry.next_address();
+    }
+  }
+
+  const size_t written = entry_address - address;
+  sector.RemoveWritableBytes(written);
+  sector.AddValidBytes(written);
+  return OkStatus();
+}
+
 StatusWithSize KeyValueStore::CopyEntryToSector(Entry& entry,
                                                 SectorDescriptor* new_sector,
                                                 Address new_address) {
@@ -1030,6 +2071,78 @@ Status KeyValueStore::PartialMaintenance() {
   return GarbageCollect(span<const Address>());
 }
 
+StatusWithSize KeyValueStore::IncrementalMaintenance(
+    size_t max_relocation_bytes) {
+  if (initialized_ == InitializationState::kNotInitialized) {
+    return StatusWithSize::FailedPrecondition();
+  }
+
+  CheckForErrors();
+  // Do automatic repair, if KVS options allow for it.
+  if (error_detected_ && options_.recovery != ErrorRecovery::kManual) {
+    PW_TRY_WITH_SIZE(Repair());
+  }
+
+  // Select a new sector if there is none in progress or if the one in progress
+  // was already collected, e.g. by a write that needed space.
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  if (incremental_gc_sector_ == nullptr ||
+      incremental_gc_sector_->RecoverableBytes(sector_size_bytes) == 0) {
+    incremental_gc_sector_ =
+        sectors_.FindSectorToGarbageCollect(span<const Address>());
+  }
+
+  // Only collect sectors that have space to reclaim. Unlike GarbageCollect(),
+  // this does not shuffle valid entries between otherwise full sectors.
+  if (incremental_gc_sector_ == nullptr ||
+      incremental_gc_sector_->RecoverableBytes(sector_size_bytes) == 0) {
+    incremental_gc_sector_ = nullptr;
+    return StatusWithSize::NotFound();
+  }
+
+  SectorDescriptor& sector = *incremental_gc_sector_;
+  if (sector.valid_bytes() != 0) {
+    return RelocateEntriesInSector(sector, max_relocation_bytes);
+  }
+
+  // The sector holds only stale entries; erase it.
+  incremental_gc_sector_ = nullptr;
+  PW_TRY_WITH_SIZE(GarbageCollectSector(sector, span<const Address>()));
+  return StatusWithSize(0);
+}
+
+StatusWithSize KeyValueStore::RelocateEntriesInSector(
+    SectorDescriptor& sector_to_gc, size_t max_bytes) {
+  PW_LOG_DEBUG("  Incremental relocation from sector %u",
+               sectors_.Index(sector_to_gc));
+  size_t relocated_bytes = 0;
+
+  for (EntryMetadata& metadata : entry_cache_) {
+    for (FlashPartition::Address& address : metadata.addresses()) {
+      if (!sectors_.AddressInSector(sector_to_gc, address)) {
+        continue;
+      }
+
+      const size_t valid_bytes = sector_to_gc.valid_bytes();
+      PW_TRY_WITH_SIZE(
+          RelocateEntry(metadata, address, span<const Address>()));
+      relocated_bytes += valid_bytes - sector_to_gc.valid_bytes();
+
+      if (relocated_bytes >= max_bytes) {
+        return StatusWithSize(relocated_bytes);
+      }
+    }
+  }
+
+  if (relocated_bytes == 0) {
+    PW_LOG_ERROR("  No entries found for %u valid bytes in sector %u",
+                 unsigned(sector_to_gc.valid_bytes()),
+                 sectors_.Index(sector_to_gc));
+    return StatusWithSize::Internal();
+  }
+  return StatusWithSize(relocated_bytes);
+}
+
 Status KeyValueStore::GarbageCollect(span<const Address> reserved_addresses) {
   PW_LOG_DEBUG("Garbage Collect a single sector");
   for ([[maybe_unused]] Address address : reserved_addresses) {
@@ -1088,6 +2201,7 @@ Status KeyValueStore::GarbageCollectSector(
   // Step 2: Reinitialize the sector
   if (!sector_to_gc.Empty(partition_.sector_size_bytes())) {
     sector_to_gc.mark_corrupt();
+    sector_to_gc.RecordErase();
     internal_stats_.sector_erase_count++;
     PW_TRY(partition_.Erase(sectors_.BaseAddress(sector_to_gc), 1));
     sector_to_gc.set_writable_bytes(partition_.sector_size_bytes());
@@ -1307,7 +2421,8 @@ Status KeyValueStore::Repair() {
 KeyValueStore::Entry KeyValueStore::CreateEntry(Address address,
                                                 Key key,
                                                 span<const byte> value,
-                                                EntryState state) {
+                                                EntryState state,
+                                                ValueKind kind) {
   // Always bump the transaction ID when creating a new entry.
   //
   // Burning transaction IDs prevents inconsistencies between flash and memory
@@ -1326,6 +2441,14 @@ KeyValueStore::Entry KeyValueStore::CreateEntry(Address address,
     return Entry::Tombstone(
         partition_, address, formats_.primary(), key, last_transaction_id_);
   }
+  if (kind == ValueKind::kChunkManifest) {
+    return Entry::ChunkManifest(partition_,
+                                address,
+                                formats_.primary(),
+                                key,
+                                value,
+                                last_transaction_id_);
+  }
   return Entry::Valid(partition_,
                       address,
                       formats_.primary(),
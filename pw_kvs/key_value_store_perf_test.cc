@@ -0,0 +1,55 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+#include "entry_corpus.h"
+#include "pw_assert/check.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kMaxEntries = 64;
+constexpr size_t kMaxUsableSectors = 4;
+
+ChecksumCrc16 checksum;
+// For KVS magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x3b4a5c6d, .checksum = &checksum};
+
+FakeFlashMemoryBuffer<4096, kMaxUsableSectors> flash(16);
+FlashPartition partition(&flash);
+
+// Measures how long Init() takes to read and verify the entries left in flash
+// by writing the entry corpus.
+void InitFromEntryCorpus(perf_test::State& state) {
+  PW_CHECK_OK(partition.Erase());
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&partition, kFormat);
+  PW_CHECK_OK(kvs.Init());
+  PW_CHECK_OK(test::WriteEntryCorpus(kvs));
+
+  while (state.KeepRunning()) {
+    PW_CHECK_OK(kvs.Init());
+  }
+  PW_CHECK_UINT_EQ(kvs.size(), test::kEntryCorpusKeys);
+}
+
+PW_PERF_TEST(KvsInitFromEntryCorpus, InitFromEntryCorpus);
+
+}  // namespace
+}  // namespace pw::kvs
@@ -29,6 +29,7 @@
 
 #include "pw_assert/check.h"
 #include "pw_bytes/array.h"
+#include "entry_corpus.h"
 #include "pw_checksum/crc16_ccitt.h"
 #include "pw_kvs/crc16_checksum.h"
 #include "pw_kvs/fake_flash_memory.h"
@@ -266,6 +267,65 @@ TEST(InMemoryKvs, WriteAndReadOneKey) {
   EXPECT_EQ(kvs.size(), 1u);
 }
 
+TEST(InMemoryKvs, GetView_ReturnsValueInFlash) {
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  ASSERT_OK(kvs.Init());
+
+  std::array<std::byte, 100> value;
+  for (size_t i = 0; i < value.size(); ++i) {
+    value[i] = std::byte(i);
+  }
+  ASSERT_OK(kvs.Put("model", value));
+
+  Result<ConstByteSpan> view = kvs.GetView("model");
+  ASSERT_OK(view.status());
+  ASSERT_EQ(value.size(), view->size());
+  EXPECT_TRUE(std::equal(value.begin(), value.end(), view->begin()));
+  EXPECT_GE(view->data(), flash.memory.buffer().data());
+  EXPECT_LE(view->data() + view->size(),
+            flash.memory.buffer().data() + flash.memory.buffer().size());
+
+  ASSERT_OK(kvs.Delete("model"));
+  EXPECT_EQ(Status::NotFound(), kvs.GetView("model").status());
+}
+
+TEST(InMemoryKvs, GetView_CorruptValue) {
+  Flash flash;
+  ASSERT_OK(flash.partition.Erase());
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  ASSERT_OK(kvs.Init());
+  ASSERT_OK(kvs.Put("key", uint32_t(0x12345678)));
+
+  Result<ConstByteSpan> view = kvs.GetView("key");
+  ASSERT_OK(view.status());
+  flash.memory.buffer()[static_cast<size_t>(
+      view->data() - flash.memory.buffer().data())] ^= std::byte{0x01};
+  EXPECT_EQ(Status::DataLoss(), kvs.GetView("key").status());
+}
+
+// Fake flash that is not memory-mapped.
+class UnmappedFlashMemory : public FakeFlashMemoryBuffer<512, 4> {
+ public:
+  std::byte* FlashAddressToMcuAddress(Address) const override {
+    return nullptr;
+  }
+};
+
+TEST(InMemoryKvs, GetView_NotMemoryMapped) {
+  UnmappedFlashMemory flash;
+  FlashPartition partition(&flash, 0, flash.sector_count());
+  ASSERT_OK(partition.Erase());
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&partition,
+                                                          default_format);
+  ASSERT_OK(kvs.Init());
+  ASSERT_OK(kvs.Put("key", uint32_t(1)));
+  EXPECT_EQ(Status::Unimplemented(), kvs.GetView("key").status());
+}
+
 TEST(InMemoryKvs, WriteOneKeyValueMultipleTimes) {
   // Create and erase the fake flash.
   Flash flash;
@@ -475,6 +535,625 @@ TEST_F(LargeEmptyInitializedKvs, KeyDeletionMaintenance) {
   ASSERT_EQ(val, kValue2);
 }
 
+TEST(InMemoryKvs, KeyIndex_PutGetDeleteAndReinit) {
+  constexpr size_t kKeys = 100;
+  ASSERT_EQ(OkStatus(), large_test_partition.Erase());
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, 1, 1, 2 * kMaxEntries>
+      kvs(&large_test_partition, default_format);
+  ASSERT_OK(kvs.Init());
+
+  std::array<char, 16> key;
+  auto key_for = [&key](size_t i) {
+    std::snprintf(key.data(), key.size(), "key_%u", unsigned(i));
+    return Key(key.data());
+  };
+
+  for (uint32_t i = 0; i < kKeys; ++i) {
+    ASSERT_OK(kvs.Put(key_for(i), i));
+  }
+  for (uint32_t i = 0; i < kKeys; i += 2) {
+    ASSERT_OK(kvs.Delete(key_for(i)));
+  }
+
+  // Check lookups both before and after the index is rebuilt from flash.
+  for (int pass = 0; pass < 2; ++pass) {
+    EXPECT_EQ(kKeys / 2, kvs.size());
+    for (uint32_t i = 0; i < kKeys; ++i) {
+      uint32_t value = 0;
+      if (i % 2 == 0) {
+        EXPECT_EQ(Status::NotFound(), kvs.Get(key_for(i), &value));
+      } else {
+        ASSERT_OK(kvs.Get(key_for(i), &value));
+        EXPECT_EQ(i, value);
+      }
+    }
+    ASSERT_OK(kvs.Init());
+  }
+}
+
+TEST(InMemoryKvs, EntryCorpus_InitRestoresLatestValues) {
+  Flash flash;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  ASSERT_OK(kvs.Init());
+  ASSERT_OK(test::WriteEntryCorpus(kvs));
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> reloaded(
+      &flash.partition, default_format);
+  ASSERT_OK(reloaded.Init());
+  EXPECT_EQ(reloaded.size(), test::kEntryCorpusKeys);
+
+  for (size_t i = 0; i < test::kEntryCorpus.size(); ++i) {
+    const test::CorpusWrite& write = test::kEntryCorpus[i];
+    bool overwritten = false;
+    for (size_t j = i + 1; j < test::kEntryCorpus.size(); ++j) {
+      overwritten = overwritten || test::kEntryCorpus[j].key == write.key;
+    }
+    if (overwritten) {
+      continue;
+    }
+
+    std::array<std::byte, 64> value;
+    StatusWithSize result = reloaded.Get(write.key, value);
+    if (write.value.empty()) {
+      EXPECT_EQ(Status::NotFound(), result.status());
+      continue;
+    }
+    ASSERT_OK(result.status());
+    ASSERT_EQ(result.size(), write.value.size());
+    EXPECT_EQ(std::memcmp(value.data(), write.value.data(), result.size()), 0);
+  }
+}
+
+TEST_F(LargeEmptyInitializedKvs, IncrementalMaintenance_NothingToCollect) {
+  EXPECT_EQ(Status::NotFound(), kvs_.IncrementalMaintenance(1).status());
+
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint8_t(1)));
+  EXPECT_EQ(Status::NotFound(), kvs_.IncrementalMaintenance(1).status());
+}
+
+TEST_F(LargeEmptyInitializedKvs, IncrementalMaintenance_OneEntryPerStep) {
+  // Write each key, then overwrite one, leaving a stale entry in the sector.
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(keys[i], uint32_t(i)));
+  }
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(100)));
+
+  const KeyValueStore::StorageStats before = kvs_.GetStorageStats();
+  ASSERT_GT(before.reclaimable_bytes, 0u);
+
+  // With a 1-byte budget, each step relocates a single entry.
+  size_t relocation_steps = 0;
+  size_t relocated_bytes = 0;
+  for (StatusWithSize result = kvs_.IncrementalMaintenance(1);
+       result.status() != Status::NotFound();
+       result = kvs_.IncrementalMaintenance(1)) {
+    ASSERT_EQ(OkStatus(), result.status());
+    if (result.size() != 0u) {
+      relocation_steps += 1;
+      relocated_bytes += result.size();
+    }
+    ASSERT_LE(relocation_steps, keys.size());
+  }
+
+  EXPECT_EQ(keys.size(), relocation_steps);
+  EXPECT_EQ(before.in_use_bytes, relocated_bytes);
+
+  const KeyValueStore::StorageStats after = kvs_.GetStorageStats();
+  EXPECT_EQ(before.sector_erase_count + 1, after.sector_erase_count);
+  EXPECT_EQ(0u, after.reclaimable_bytes);
+  EXPECT_EQ(before.in_use_bytes, after.in_use_bytes);
+
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &value));
+  EXPECT_EQ(100u, value);
+  for (size_t i = 1; i < keys.size(); ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Get(keys[i], &value));
+    EXPECT_EQ(i, value);
+  }
+}
+
+TEST_F(LargeEmptyInitializedKvs, IncrementalMaintenance_LargeBudget) {
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(keys[i], uint32_t(i)));
+  }
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint32_t(100)));
+  const size_t in_use_bytes = kvs_.GetStorageStats().in_use_bytes;
+
+  // The first step relocates everything, and the second erases the sector.
+  StatusWithSize result = kvs_.IncrementalMaintenance(1024);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(in_use_bytes, result.size());
+  EXPECT_EQ(0u, kvs_.GetStorageStats().sector_erase_count);
+
+  result = kvs_.IncrementalMaintenance(1024);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+  EXPECT_EQ(1u, kvs_.GetStorageStats().sector_erase_count);
+
+  EXPECT_EQ(Status::NotFound(), kvs_.IncrementalMaintenance(1024).status());
+}
+
+TEST(InMemoryKvs, IncrementalMaintenance_NotInitialized) {
+  Flash flash;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  EXPECT_EQ(Status::FailedPrecondition(),
+            kvs.IncrementalMaintenance(1).status());
+}
+
+TEST_F(LargeEmptyInitializedKvs, WriteBatch_CommitAndReinit) {
+  WriteBatchBuffer<4, 64> batch;
+  ASSERT_EQ(OkStatus(), batch.Put(keys[0], uint32_t(1)));
+  ASSERT_EQ(OkStatus(), batch.Put(keys[1], uint32_t(2)));
+  ASSERT_EQ(OkStatus(), batch.Put(keys[2], uint32_t(3)));
+  ASSERT_EQ(OkStatus(), batch.Put(keys[0], uint32_t(4)));  // Replaces 1.
+  EXPECT_EQ(3u, batch.size());
+
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint32_t(100)));
+  ASSERT_EQ(OkStatus(), kvs_.Commit(batch));
+  EXPECT_EQ(3u, kvs_.size());
+
+  for (int pass = 0; pass < 2; ++pass) {
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &value));
+    EXPECT_EQ(4u, value);
+    ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &value));
+    EXPECT_EQ(2u, value);
+    ASSERT_EQ(OkStatus(), kvs_.Get(keys[2], &value));
+    EXPECT_EQ(3u, value);
+
+    // Reload the batch's entries from flash.
+    ASSERT_EQ(OkStatus(), kvs_.Init());
+    EXPECT_FALSE(kvs_.error_detected());
+  }
+}
+
+TEST_F(LargeEmptyInitializedKvs, WriteBatch_Full) {
+  WriteBatchBuffer<2, 64> batch;
+  ASSERT_EQ(OkStatus(), batch.Put(keys[0], uint8_t(1)));
+  ASSERT_EQ(OkStatus(), batch.Put(keys[1], uint8_t(2)));
+  EXPECT_EQ(Status::ResourceExhausted(), batch.Put(keys[2], uint8_t(3)));
+  EXPECT_EQ(OkStatus(), batch.Put(keys[1], uint8_t(4)));
+
+  batch.clear();
+  EXPECT_TRUE(batch.empty());
+
+  // "TestKey1" and a 1-byte value leave room for 3 more bytes.
+  WriteBatchBuffer<4, 12> small_batch;
+  ASSERT_EQ(OkStatus(), small_batch.Put(keys[0], uint8_t(1)));
+  EXPECT_EQ(Status::ResourceExhausted(), small_batch.Put(keys[1], uint8_t(2)));
+  EXPECT_EQ(OkStatus(), small_batch.Put(keys[0], uint8_t(3)));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            small_batch.Put(keys[0], uint32_t(4)));
+  EXPECT_EQ(OkStatus(), small_batch.Put(keys[0], uint16_t(5)));
+}
+
+TEST_F(LargeEmptyInitializedKvs, WriteBatch_InvalidKey_WritesNothing) {
+  WriteBatchBuffer<2, 64> batch;
+  ASSERT_EQ(OkStatus(), batch.Put(keys[0], uint8_t(1)));
+  ASSERT_EQ(OkStatus(), batch.Put("", uint8_t(2)));
+
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.Commit(batch));
+  EXPECT_EQ(0u, kvs_.size());
+  EXPECT_EQ(0u, kvs_.transaction_count());
+}
+
+TEST(InMemoryKvs, WriteBatch_UnchangedValues_NothingWrittenToFlash) {
+  Flash flash;
+  ASSERT_EQ(OkStatus(), flash.partition.Erase());
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  ASSERT_OK(kvs.Init());
+
+  WriteBatchBuffer<3, 64> batch;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(OkStatus(), batch.Put(keys[i], uint16_t(i)));
+  }
+  ASSERT_EQ(OkStatus(), kvs.Commit(batch));
+  const uint32_t transactions = kvs.transaction_count();
+  const uint16_t crc = checksum::Crc16Ccitt::Calculate(flash.memory.buffer());
+
+  ASSERT_EQ(OkStatus(), kvs.Commit(batch));
+  EXPECT_EQ(transactions, kvs.transaction_count());
+  EXPECT_EQ(crc, checksum::Crc16Ccitt::Calculate(flash.memory.buffer()));
+}
+
+TEST(InMemoryKvs, WriteBatch_Redundancy) {
+  Flash flash;
+  ASSERT_EQ(OkStatus(), flash.partition.Erase());
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors, 2> kvs(&flash.partition,
+                                                             default_format);
+  ASSERT_OK(kvs.Init());
+  ASSERT_OK(kvs.Put(keys[2], uint32_t(7)));
+
+  WriteBatchBuffer<3, 64> batch;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(OkStatus(), batch.Put(keys[i], uint32_t(i)));
+  }
+  ASSERT_EQ(OkStatus(), kvs.Commit(batch));
+  for (size_t i = 0; i < keys.size(); ++i) {
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), kvs.Get(keys[i], &value));
+    EXPECT_EQ(i, value);
+  }
+
+  ASSERT_OK(kvs.Init());
+  EXPECT_FALSE(kvs.error_detected());
+  EXPECT_EQ(0u, kvs.GetStorageStats().missing_redundant_entries_recovered);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), kvs.Get(keys[i], &value));
+    EXPECT_EQ(i, value);
+  }
+}
+
+// Counts the bytes read from a partition.
+class ReadCountingPartition final : public FlashPartition {
+ public:
+  ReadCountingPartition(FlashMemory* flash)
+      : FlashPartition(flash, 0, flash->sector_count()) {}
+
+  StatusWithSize Read(Address address, span<std::byte> output) override {
+    bytes_read += output.size();
+    return FlashPartition::Read(address, output);
+  }
+
+  size_t bytes_read = 0;
+};
+
+class KvsCheckpoint : public ::testing::Test {
+ protected:
+  KvsCheckpoint()
+      : flash_(8),
+        partition_(&flash_),
+        checkpoint_flash_(8),
+        checkpoint_partition_(
+            &checkpoint_flash_, 0, checkpoint_flash_.sector_count()),
+        kvs_(&partition_, default_format) {
+    PW_CHECK_OK(partition_.Erase());
+    PW_CHECK_OK(checkpoint_partition_.Erase());
+    PW_CHECK_OK(kvs_.Init());
+  }
+
+  // Writes enough entries that a full scan reads much more than a checkpoint.
+  void PutEntries() {
+    for (uint32_t i = 0; i < 20; ++i) {
+      ASSERT_EQ(OkStatus(), kvs_.Put(keys[i % keys.size()], i));
+    }
+    ASSERT_EQ(OkStatus(), kvs_.Put("big", std::array<uint32_t, 32>{}));
+    ASSERT_EQ(OkStatus(), kvs_.Delete(keys[1]));
+  }
+
+  void ExpectEntries() {
+    uint32_t value = 0;
+    ASSERT_EQ(OkStatus(), kvs_.Get(keys[0], &value));
+    EXPECT_EQ(18u, value);
+    EXPECT_EQ(Status::NotFound(), kvs_.Get(keys[1], &value));
+    ASSERT_EQ(OkStatus(), kvs_.Get(keys[2], &value));
+    EXPECT_EQ(17u, value);
+    EXPECT_EQ(2u + 1u, kvs_.size());
+  }
+
+  FakeFlashMemoryBuffer<512, 8> flash_;
+  ReadCountingPartition partition_;
+  FakeFlashMemoryBuffer<512, 2> checkpoint_flash_;
+  FlashPartition checkpoint_partition_;
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+};
+
+TEST_F(KvsCheckpoint, InitFromCheckpoint_RestoresIndex) {
+  PutEntries();
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint(checkpoint_partition_));
+
+  const KeyValueStore::StorageStats stats = kvs_.GetStorageStats();
+  const uint32_t transactions = kvs_.transaction_count();
+
+  partition_.bytes_read = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  const size_t full_scan_bytes = partition_.bytes_read;
+
+  partition_.bytes_read = 0;
+  ASSERT_EQ(OkStatus(), kvs_.InitFromCheckpoint(checkpoint_partition_));
+  EXPECT_LT(partition_.bytes_read, full_scan_bytes);
+  EXPECT_FALSE(kvs_.error_detected());
+
+  ExpectEntries();
+  EXPECT_EQ(transactions, kvs_.transaction_count());
+  const KeyValueStore::StorageStats restored = kvs_.GetStorageStats();
+  EXPECT_EQ(stats.writable_bytes, restored.writable_bytes);
+  EXPECT_EQ(stats.in_use_bytes, restored.in_use_bytes);
+  EXPECT_EQ(stats.reclaimable_bytes, restored.reclaimable_bytes);
+
+  // The restored KVS continues from where the checkpoint left off.
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[1], uint32_t(99)));
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get(keys[1], &value));
+  EXPECT_EQ(99u, value);
+  EXPECT_EQ(transactions + 1, kvs_.transaction_count());
+}
+
+TEST_F(KvsCheckpoint, InitFromCheckpoint_UsesNewestCheckpoint) {
+  ASSERT_EQ(OkStatus(), kvs_.Put(keys[0], uint32_t(1)));
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint(checkpoint_partition_));
+  PutEntries();
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint(checkpoint_partition_));
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint(checkpoint_partition_));
+
+  ASSERT_EQ(OkStatus(), kvs_.InitFromCheckpoint(checkpoint_partition_));
+  ExpectEntries();
+}
+
+TEST_F(KvsCheckpoint, InitFromCheckpoint_StaleCheckpoint_ScansFlash) {
+  PutEntries();
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint(checkpoint_partition_));
+  ASSERT_EQ(OkStatus(), kvs_.Put("new", uint32_t(5)));
+
+  ASSERT_EQ(OkStatus(), kvs_.InitFromCheckpoint(checkpoint_partition_));
+  uint32_t value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("new", &value));
+  EXPECT_EQ(5u, value);
+
+  // Erasing a sector after the checkpoint also makes it stale.
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint(checkpoint_partition_));
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+  ASSERT_EQ(OkStatus(), kvs_.InitFromCheckpoint(checkpoint_partition_));
+  ASSERT_EQ(OkStatus(), kvs_.Get("new", &value));
+  EXPECT_EQ(5u, value);
+  EXPECT_EQ(4u, kvs_.size());
+}
+
+TEST_F(KvsCheckpoint, InitFromCheckpoint_CorruptCheckpoint_ScansFlash) {
+  PutEntries();
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint(checkpoint_partition_));
+  checkpoint_flash_.buffer()[40] ^= std::byte{0x01};
+
+  ASSERT_EQ(OkStatus(), kvs_.InitFromCheckpoint(checkpoint_partition_));
+  EXPECT_FALSE(kvs_.error_detected());
+  ExpectEntries();
+}
+
+TEST_F(KvsCheckpoint, InitFromCheckpoint_NoCheckpoint_ScansFlash) {
+  PutEntries();
+  ASSERT_EQ(OkStatus(), kvs_.InitFromCheckpoint(checkpoint_partition_));
+  ExpectEntries();
+}
+
+TEST_F(KvsCheckpoint, InitFromCheckpoint_RestoresEraseCounts) {
+  for (uint32_t i = 0; i < 100; ++i) {
+    ASSERT_EQ(OkStatus(), kvs_.Put(keys[i % keys.size()], i));
+  }
+  ASSERT_EQ(OkStatus(), kvs_.FullMaintenance());
+  ASSERT_EQ(OkStatus(), kvs_.WriteCheckpoint(checkpoint_partition_));
+  const KeyValueStore::StorageStats stats = kvs_.GetStorageStats();
+  ASSERT_GT(stats.max_sector_erase_count, 0u);
+
+  // A new KVS, as after a reboot, continues counting from the checkpoint.
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> rebooted(&partition_,
+                                                               default_format);
+  ASSERT_EQ(OkStatus(), rebooted.InitFromCheckpoint(checkpoint_partition_));
+  KeyValueStore::StorageStats restored = rebooted.GetStorageStats();
+  EXPECT_EQ(0u, restored.sector_erase_count);
+  EXPECT_EQ(stats.min_sector_erase_count, restored.min_sector_erase_count);
+  EXPECT_EQ(stats.max_sector_erase_count, restored.max_sector_erase_count);
+
+  // The erase counts are restored even if the checkpoint is stale.
+  ASSERT_EQ(OkStatus(), kvs_.Put("new", uint32_t(5)));
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> stale(&partition_,
+                                                            default_format);
+  ASSERT_EQ(OkStatus(), stale.InitFromCheckpoint(checkpoint_partition_));
+  restored = stale.GetStorageStats();
+  EXPECT_EQ(stats.min_sector_erase_count, restored.min_sector_erase_count);
+  EXPECT_EQ(stats.max_sector_erase_count, restored.max_sector_erase_count);
+}
+
+TEST(InMemoryKvs, WriteCheckpoint_NotInitialized) {
+  Flash flash;
+  FakeFlashMemoryBuffer<512, 2> checkpoint_flash;
+  FlashPartition checkpoint_partition(&checkpoint_flash, 0, 2);
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash.partition,
+                                                          default_format);
+  EXPECT_EQ(Status::FailedPrecondition(),
+            kvs.WriteCheckpoint(checkpoint_partition));
+}
+
+class ChunkedValueKvs : public ::testing::Test {
+ protected:
+  static constexpr Options kOptions = [] {
+    Options options;
+    options.chunk_large_values = true;
+    return options;
+  }();
+
+  ChunkedValueKvs() : kvs_(&large_test_partition, default_format, kOptions) {
+    PW_CHECK_OK(large_test_partition.Erase());
+    PW_CHECK_OK(kvs_.Init());
+    for (size_t i = 0; i < value_.size(); ++i) {
+      value_[i] = std::byte(i * 7 + i / 251);
+    }
+  }
+
+  // Returns the number of keys found by iterating over the KVS.
+  size_t IteratedKeys() const {
+    size_t count = 0;
+    for (const auto& item : kvs_) {
+      static_cast<void>(item);
+      count += 1;
+    }
+    return count;
+  }
+
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs_;
+  std::array<std::byte, 3000> value_;
+};
+
+TEST_F(ChunkedValueKvs, Put_LargeValue_GetReturnsValue) {
+  ASSERT_GT(value_.size(), kvs_.max_key_value_size_bytes());
+  ASSERT_EQ(OkStatus(), kvs_.Put("table", value_));
+
+  EXPECT_EQ(value_.size(), kvs_.ValueSize("table").size());
+
+  std::array<std::byte, 3000> read{};
+  StatusWithSize result = kvs_.Get("table", read);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(value_.size(), result.size());
+  EXPECT_EQ(value_, read);
+
+  // A read that starts in one chunk and ends in the next.
+  result = kvs_.Get("table", span(read).first(100), 950);
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  ASSERT_EQ(100u, result.size());
+  EXPECT_EQ(0, std::memcmp(read.data(), &value_[950], 100));
+
+  EXPECT_EQ(Status::Unimplemented(), kvs_.GetView("table").status());
+
+  // Only the key is visible, although the chunks use entries.
+  EXPECT_EQ(1u, IteratedKeys());
+  EXPECT_GT(kvs_.size(), 1u);
+  EXPECT_STREQ("table", kvs_.begin()->key());
+}
+
+TEST_F(ChunkedValueKvs, Put_LargeValue_SurvivesInit) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("table", value_));
+  ASSERT_EQ(OkStatus(), kvs_.Init());
+  EXPECT_FALSE(kvs_.error_detected());
+
+  std::array<std::byte, 3000> read{};
+  ASSERT_EQ(OkStatus(), kvs_.Get("table", read).status());
+  EXPECT_EQ(value_, read);
+  EXPECT_EQ(1u, IteratedKeys());
+}
+
+TEST_F(ChunkedValueKvs, Put_ReplacesChunkedValue_RemovesOldChunks) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("table", value_));
+  const size_t entries_for_value = kvs_.size();
+
+  // Replace the value with a different chunked value.
+  std::array<std::byte, 3000> other_value = value_;
+  other_value[2500] = std::byte{0xFF};
+  ASSERT_EQ(OkStatus(), kvs_.Put("table", other_value));
+  EXPECT_EQ(entries_for_value, kvs_.size());
+
+  std::array<std::byte, 3000> read{};
+  ASSERT_EQ(OkStatus(), kvs_.Get("table", read).status());
+  EXPECT_EQ(other_value, read);
+
+  // Replacing it with a small value removes all of the chunks.
+  ASSERT_EQ(OkStatus(), kvs_.Put("table", uint32_t(42)));
+  EXPECT_EQ(1u, kvs_.size());
+  uint32_t small_value = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("table", &small_value));
+  EXPECT_EQ(42u, small_value);
+}
+
+TEST_F(ChunkedValueKvs, Delete_RemovesChunks) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("table", value_));
+  ASSERT_EQ(OkStatus(), kvs_.Delete("table"));
+
+  EXPECT_EQ(0u, kvs_.size());
+  EXPECT_EQ(Status::NotFound(), kvs_.ValueSize("table").status());
+}
+
+TEST_F(ChunkedValueKvs, Put_ReservedKey_InvalidArgument) {
+  EXPECT_EQ(Status::InvalidArgument(), kvs_.Put("\x1f" "key", uint8_t(1)));
+}
+
+TEST_F(ChunkedValueKvs, ValueWriter_StoresValueOnClose) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("table", uint32_t(1)));
+
+  std::array<std::byte, 64> chunk_buffer;
+  KeyValueStore::ValueWriter writer(kvs_, chunk_buffer);
+  ASSERT_EQ(OkStatus(), writer.Open("table"));
+  for (size_t offset = 0; offset < value_.size(); offset += 37) {
+    ASSERT_EQ(OkStatus(),
+              writer.Write(span(value_).subspan(
+                  offset, std::min<size_t>(37, value_.size() - offset))));
+  }
+
+  // The previous value is kept until the writer is closed.
+  uint32_t previous = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("table", &previous));
+  EXPECT_EQ(1u, previous);
+
+  ASSERT_EQ(OkStatus(), writer.Close());
+  EXPECT_EQ(value_.size(), kvs_.ValueSize("table").size());
+
+  KeyValueStore::ValueReader reader(kvs_);
+  ASSERT_EQ(OkStatus(), reader.Open("table"));
+  EXPECT_EQ(value_.size(), reader.value_size());
+
+  std::array<std::byte, 3000> read{};
+  for (size_t offset = 0; offset < read.size(); offset += 50) {
+    Result<ByteSpan> result = reader.Read(span(read).subspan(offset, 50));
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(50u, result->size());
+  }
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(read).status());
+  EXPECT_EQ(value_, read);
+  EXPECT_EQ(1u, IteratedKeys());
+}
+
+TEST_F(ChunkedValueKvs, ValueWriter_SmallValue_StoredAsEntry) {
+  std::array<std::byte, 64> chunk_buffer;
+  KeyValueStore::ValueWriter writer(kvs_, chunk_buffer);
+  ASSERT_EQ(OkStatus(), writer.Open("small"));
+  ASSERT_EQ(OkStatus(), writer.Write(span(value_).first(64)));
+  ASSERT_EQ(OkStatus(), writer.Close());
+
+  EXPECT_EQ(1u, kvs_.size());
+  Result<ConstByteSpan> view = kvs_.GetView("small");
+  ASSERT_EQ(OkStatus(), view.status());
+  EXPECT_EQ(0, std::memcmp(view->data(), value_.data(), 64));
+}
+
+TEST_F(ChunkedValueKvs, ValueWriter_Abandon_KeepsPreviousValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("table", uint32_t(1)));
+
+  std::array<std::byte, 64> chunk_buffer;
+  {
+    KeyValueStore::ValueWriter writer(kvs_, chunk_buffer);
+    ASSERT_EQ(OkStatus(), writer.Open("table"));
+    ASSERT_EQ(OkStatus(), writer.Write(span(value_).first(1000)));
+    ASSERT_EQ(OkStatus(), writer.Abandon());
+  }
+
+  uint32_t previous = 0;
+  ASSERT_EQ(OkStatus(), kvs_.Get("table", &previous));
+  EXPECT_EQ(1u, previous);
+  EXPECT_EQ(1u, IteratedKeys());
+
+  // The abandoned chunks are removed by the next chunked write.
+  KeyValueStore::ValueWriter writer(kvs_, chunk_buffer);
+  ASSERT_EQ(OkStatus(), writer.Open("table"));
+  ASSERT_EQ(OkStatus(), writer.Write(span(value_).first(200)));
+  ASSERT_EQ(OkStatus(), writer.Close());
+  EXPECT_EQ(5u, kvs_.size());  // 4 chunks and the manifest.
+
+  std::array<std::byte, 200> read{};
+  ASSERT_EQ(OkStatus(), kvs_.Get("table", read).status());
+  EXPECT_EQ(0, std::memcmp(read.data(), value_.data(), read.size()));
+}
+
+TEST_F(ChunkedValueKvs, ValueReader_SeekInRegularValue) {
+  ASSERT_EQ(OkStatus(), kvs_.Put("small", span(value_).first(100)));
+
+  KeyValueStore::ValueReader reader(kvs_);
+  ASSERT_EQ(OkStatus(), reader.Open("small"));
+  EXPECT_EQ(Status::FailedPrecondition(), reader.Open("small"));
+  ASSERT_EQ(OkStatus(), reader.Seek(90));
+
+  std::array<std::byte, 20> read{};
+  Result<ByteSpan> result = reader.Read(read);
+  ASSERT_EQ(OkStatus(), result.status());
+  ASSERT_EQ(10u, result->size());
+  EXPECT_EQ(0, std::memcmp(read.data(), &value_[90], 10));
+
+  ASSERT_EQ(OkStatus(), reader.Close());
+  EXPECT_EQ(Status::NotFound(), reader.Open("missing"));
+}
+
 TEST(InMemoryKvs, Put_MaxValueSize) {
   // Create and erase the fake flash.
   Flash flash;
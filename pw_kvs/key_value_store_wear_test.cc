@@ -73,6 +73,11 @@ TEST_F(WearTest, RepeatedLargeEntry) {
   EXPECT_GE(partition_.min_erase_count(), 7u);
   EXPECT_LE(partition_.max_erase_count(), partition_.min_erase_count() + 1u);
 
+  // The KVS's own per-sector erase counts match the partition's.
+  const KeyValueStore::StorageStats stats = kvs_.GetStorageStats();
+  EXPECT_EQ(partition_.min_erase_count(), stats.min_sector_erase_count);
+  EXPECT_EQ(partition_.max_erase_count(), stats.max_sector_erase_count);
+
   // Ignore error to allow test to pass on platforms where writing out the stats
   // is not possible.
   partition_.SaveStorageStats(kvs_, "WearTest RepeatedLargeEntry")
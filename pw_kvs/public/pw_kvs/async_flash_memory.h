@@ -0,0 +1,251 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/poll.h"
+#include "pw_bytes/span.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_result/result.h"
+#include "pw_span/span.h"
+#include "pw_status/status_with_size.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::kvs {
+
+/// An erase, read, or write of flash that can be queued on an
+/// `AsyncFlashMemory`.
+///
+/// Addresses are flash addresses, as for `FlashMemory`. Use
+/// `FlashPartition::PartitionToFlashAddress` to convert partition addresses.
+///
+/// The operation and its buffer must remain valid until it completes or is
+/// cancelled. A completed operation may be submitted again.
+class AsyncFlashOperation : public IntrusiveList<AsyncFlashOperation>::Item {
+ public:
+  enum class Type : uint8_t {
+    kErase,
+    kRead,
+    kWrite,
+  };
+
+  /// Erases `num_sectors` sectors, starting at the sector-aligned `address`.
+  static AsyncFlashOperation Erase(FlashMemory::Address address,
+                                   size_t num_sectors) {
+    return AsyncFlashOperation(
+        Type::kErase, address, num_sectors, ByteSpan(), ConstByteSpan());
+  }
+
+  /// Reads `output.size()` bytes starting at `address` into `output`.
+  static AsyncFlashOperation Read(FlashMemory::Address address,
+                                  ByteSpan output) {
+    return AsyncFlashOperation(
+        Type::kRead, address, 0, output, ConstByteSpan());
+  }
+
+  /// Writes `data` to `address`. The address and size must be aligned to the
+  /// flash's alignment.
+  static AsyncFlashOperation Write(FlashMemory::Address address,
+                                   ConstByteSpan data) {
+    return AsyncFlashOperation(Type::kWrite, address, 0, ByteSpan(), data);
+  }
+
+  AsyncFlashOperation(const AsyncFlashOperation&) = delete;
+  AsyncFlashOperation& operator=(const AsyncFlashOperation&) = delete;
+
+  Type type() const { return type_; }
+  FlashMemory::Address address() const { return address_; }
+
+  /// The number of sectors to erase. Only used by erases.
+  size_t num_sectors() const { return num_sectors_; }
+
+  /// The buffer to read into. Only used by reads.
+  ByteSpan output() const { return output_; }
+
+  /// The data to write. Only used by writes.
+  ConstByteSpan data() const { return data_; }
+
+ private:
+  friend class AsyncFlashMemory;
+
+  enum class State : uint8_t {
+    kIdle,
+    kQueued,
+    kActive,
+    kComplete,
+  };
+
+  AsyncFlashOperation(Type type,
+                      FlashMemory::Address address,
+                      size_t num_sectors,
+                      ByteSpan output,
+                      ConstByteSpan data)
+      : type_(type),
+        address_(address),
+        num_sectors_(num_sectors),
+        output_(output),
+        data_(data) {}
+
+  // Returns the number of bytes of flash that the operation covers.
+  size_t size_bytes(size_t sector_size_bytes) const;
+
+  const Type type_;
+  const FlashMemory::Address address_;
+  const size_t num_sectors_;
+  const ByteSpan output_;
+  const ConstByteSpan data_;
+
+  // Guarded by the lock of the AsyncFlashMemory the operation is submitted to.
+  State state_ = State::kIdle;
+  StatusWithSize result_;
+  async2::Waker waker_;
+};
+
+/// @brief The base driver interface for flash that runs erases, reads, and
+/// writes asynchronously, with one operation in flight per bank.
+///
+/// Many flash parts are split into banks that can be erased or programmed
+/// independently, e.g. a dual-bank MCU flash can erase a sector in one bank
+/// while code or data is read from, or written to, the other. `FlashMemory`
+/// runs one blocking operation at a time, so it cannot make use of this.
+///
+/// An `AsyncFlashMemory` lets `pw_async2` tasks submit operations and be woken
+/// when they complete. Operations are queued per bank, and each bank starts
+/// its next operation as soon as the previous one completes, typically from
+/// the flash controller's interrupt. Operations on different banks run
+/// concurrently, so, for example, the erase of a sector that was just garbage
+/// collected does not delay reads and writes of live data on the other bank.
+///
+/// Banks are equally sized and contiguous, starting at the flash's start
+/// address. An operation may not span more than one bank.
+///
+/// Backends implement `DoStartOperation` to start an operation without
+/// blocking, and call `CompleteOperation` when it finishes.
+///
+/// Note: Operations on a bank must not be mixed with blocking `FlashMemory`
+/// calls on the same bank, which are not synchronized with the queue.
+class AsyncFlashMemory {
+ public:
+  /// The queue of operations for one bank.
+  class Bank {
+   public:
+    constexpr Bank() = default;
+
+    Bank(const Bank&) = delete;
+    Bank& operator=(const Bank&) = delete;
+
+   private:
+    friend class AsyncFlashMemory;
+
+    // Guarded by the lock of the AsyncFlashMemory that owns the bank.
+    IntrusiveList<AsyncFlashOperation> queue_;
+    AsyncFlashOperation* active_ = nullptr;
+  };
+
+  virtual ~AsyncFlashMemory() = default;
+
+  AsyncFlashMemory(const AsyncFlashMemory&) = delete;
+  AsyncFlashMemory& operator=(const AsyncFlashMemory&) = delete;
+
+  /// Returns the flash memory whose geometry the operations use.
+  FlashMemory& flash() const { return flash_; }
+
+  size_t bank_count() const { return banks_.size(); }
+
+  size_t bank_size_bytes() const { return bank_size_bytes_; }
+
+  /// Returns the index of the bank that contains `address`, which must be
+  /// within the flash.
+  size_t BankOf(FlashMemory::Address address) const;
+
+  /// Returns true if the bank has an operation in progress or queued.
+  ///
+  /// Work that can be deferred, such as erasing garbage collected sectors, can
+  /// use this to prefer idle banks.
+  bool IsBankBusy(size_t bank) const PW_LOCKS_EXCLUDED(lock_);
+
+  /// Submits `operation` to its bank's queue if it is not already queued, and
+  /// returns its result once it has completed.
+  ///
+  /// The task is woken when the operation completes. Only one task may wait
+  /// for a given operation.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The operation succeeded. The size is the number of bytes read or
+  ///    written, or 0 for erases.
+  ///
+  ///    INVALID_ARGUMENT: The address or size isn't aligned, or the operation
+  ///    spans more than one bank.
+  ///
+  ///    OUT_OF_RANGE: The operation extends past the end of the flash.
+  ///
+  ///    DEADLINE_EXCEEDED: The flash controller timed out.
+  ///
+  /// @endrst
+  async2::Poll<StatusWithSize> PendOperation(async2::Context& cx,
+                                             AsyncFlashOperation& operation)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  /// Removes an operation from its bank's queue before it is started.
+  ///
+  /// Returns true if the operation was removed, in which case it will not
+  /// complete and no task will be woken for it. Returns false if the
+  /// operation is not queued, or has already been started.
+  bool Cancel(AsyncFlashOperation& operation) PW_LOCKS_EXCLUDED(lock_);
+
+ protected:
+  /// Creates an `AsyncFlashMemory` for `flash`, split into `banks.size()`
+  /// banks of equal size. Each bank must contain a whole number of sectors.
+  AsyncFlashMemory(FlashMemory& flash, span<Bank> banks);
+
+  /// Reports the result of the operation most recently passed to
+  /// `DoStartOperation` for `bank`, starts the bank's next queued operation,
+  /// if any, and wakes the task waiting for the completed one.
+  ///
+  /// This may be called from an interrupt, or from within `DoStartOperation`,
+  /// e.g. to fail an operation that cannot be started.
+  void CompleteOperation(size_t bank, StatusWithSize result)
+      PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  /// Starts `operation` on `bank`. The backend must not block, and must call
+  /// `CompleteOperation` for the bank exactly once when the operation
+  /// finishes.
+  ///
+  /// Only one operation is active per bank, but operations on different banks
+  /// may be started while others are active. This is called either from
+  /// `PendOperation` when the bank is idle, or from `CompleteOperation`.
+  virtual void DoStartOperation(size_t bank,
+                                AsyncFlashOperation& operation) = 0;
+
+  // Checks the operation's alignment and range, and returns the bank it runs
+  // on.
+  Result<size_t> Validate(const AsyncFlashOperation& operation) const;
+
+  FlashMemory& flash_;
+  const span<Bank> banks_;
+  const size_t bank_size_bytes_;
+
+  mutable sync::InterruptSpinLock lock_;
+};
+
+}  // namespace pw::kvs
@@ -0,0 +1,148 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_kvs/flash_memory.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::kvs {
+
+/// A `FlashPartition` that caches pages read from flash in RAM.
+///
+/// The cache is set-associative: each page of the partition maps to one set,
+/// and may be held in any of that set's ways. The least recently used way of
+/// a set is replaced on a miss. Writes and erases through this partition
+/// invalidate the pages they touch. Reads that cover whole uncached pages are
+/// read directly into the caller's buffer without being cached, so that large
+/// reads don't evict the small, frequently read entry headers.
+///
+/// Changes made to the flash without going through this partition, such as
+/// through another `FlashPartition` for the same memory, are not seen until
+/// `InvalidateCache()` is called.
+///
+/// Instances are declared as `CachingFlashPartitionBuffer`.
+class CachingFlashPartition : public FlashPartition {
+ public:
+  /// Bookkeeping for one cached page.
+  struct CacheLine {
+    uint32_t page;
+    uint32_t last_used;  // Value of the use counter when last accessed.
+    bool valid;
+  };
+
+  using FlashPartition::Erase;
+  using FlashPartition::Read;
+
+  Status Erase(Address address, size_t num_sectors) override;
+
+  StatusWithSize Read(Address address, span<std::byte> output) override;
+
+  StatusWithSize Write(Address address, span<const std::byte> data) override;
+
+  /// Discards all cached pages.
+  void InvalidateCache();
+
+  size_t page_size_bytes() const { return page_size_bytes_; }
+
+  /// The number of page reads served from the cache.
+  size_t cache_hits() const { return cache_hits_; }
+
+  /// The number of page reads that went to flash.
+  size_t cache_misses() const { return cache_misses_; }
+
+  void ResetCounters() {
+    cache_hits_ = 0;
+    cache_misses_ = 0;
+  }
+
+ protected:
+  CachingFlashPartition(
+      span<CacheLine> lines,
+      span<std::byte> pages,
+      size_t ways,
+      FlashMemory* flash,
+      uint32_t flash_start_sector_index,
+      uint32_t flash_sector_count,
+      uint32_t alignment_bytes = 0,  // Defaults to flash alignment
+      PartitionPermission permission = PartitionPermission::kReadAndWrite);
+
+ private:
+  CacheLine* FindLine(uint32_t page);
+
+  // Reads a page from flash into the least recently used way of its set.
+  Status FillLine(uint32_t page, CacheLine*& line);
+
+  span<std::byte> LineData(const CacheLine& line) {
+    return pages_.subspan(
+        static_cast<size_t>(&line - lines_.data()) * page_size_bytes_,
+        page_size_bytes_);
+  }
+
+  void InvalidateRange(Address address, size_t size);
+
+  span<CacheLine> Set(uint32_t page) {
+    return lines_.subspan((page % (lines_.size() / ways_)) * ways_, ways_);
+  }
+
+  const span<CacheLine> lines_;
+  const span<std::byte> pages_;
+  const size_t ways_;
+  const size_t page_size_bytes_;
+  uint32_t use_counter_;
+  size_t cache_hits_;
+  size_t cache_misses_;
+};
+
+/// Allocates a cache of `kSets` sets of `kWays` pages of `kPageSizeBytes`
+/// bytes for a `CachingFlashPartition`. `kPageSizeBytes` should match the
+/// flash's natural read size, such as a QSPI burst or page, and must evenly
+/// divide the sector size.
+template <size_t kPageSizeBytes, size_t kSets, size_t kWays = 2>
+class CachingFlashPartitionBuffer : public CachingFlashPartition {
+ public:
+  CachingFlashPartitionBuffer(
+      FlashMemory* flash,
+      uint32_t flash_start_sector_index,
+      uint32_t flash_sector_count,
+      uint32_t alignment_bytes = 0,  // Defaults to flash alignment
+      PartitionPermission permission = PartitionPermission::kReadAndWrite)
+      : CachingFlashPartition(lines_,
+                              pages_,
+                              kWays,
+                              flash,
+                              flash_start_sector_index,
+                              flash_sector_count,
+                              alignment_bytes,
+                              permission) {}
+
+  CachingFlashPartitionBuffer(FlashMemory* flash)
+      : CachingFlashPartitionBuffer(
+            flash, 0, flash->sector_count(), flash->alignment_bytes()) {}
+
+ private:
+  static_assert(kPageSizeBytes > 0u);
+  static_assert(kSets > 0u);
+  static_assert(kWays > 0u);
+
+  std::array<CacheLine, kSets * kWays> lines_;
+  std::array<std::byte, kSets * kWays * kPageSizeBytes> pages_;
+};
+
+}  // namespace pw::kvs
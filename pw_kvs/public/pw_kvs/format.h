@@ -68,7 +68,8 @@ struct EntryHeader {
 
   // The length of the key in bytes. The key is not null terminated.
   //  6 bits, 0:5 - key length - maximum 64 characters
-  //  2 bits, 6:7 - reserved
+  //  1 bit,    6 - set if the value is the manifest of a chunked value
+  //  1 bit,    7 - reserved
   uint8_t key_length_bytes;
 
   // Byte length of the value; maximum of 65534. The max uint16_t value (65535
@@ -72,6 +72,23 @@ class Entry {
         partition, address, format, key, value, value.size(), transaction_id);
   }
 
+  // Creates a new Entry for the manifest of a value that is stored in chunks.
+  static Entry ChunkManifest(FlashPartition& partition,
+                             Address address,
+                             const EntryFormat& format,
+                             Key key,
+                             span<const std::byte> manifest,
+                             uint32_t transaction_id) {
+    return Entry(partition,
+                 address,
+                 format,
+                 key,
+                 manifest,
+                 manifest.size(),
+                 transaction_id,
+                 kChunkManifestFlag);
+  }
+
   // Creates a new Entry for a tombstone entry, which marks a deleted key.
   static Entry Tombstone(FlashPartition& partition,
                          Address address,
@@ -99,6 +116,13 @@ class Entry {
 
   StatusWithSize Write(Key key, span<const std::byte> value) const;
 
+  // Writes this entry, including padding, through an AlignedWriter that is
+  // positioned at this entry's address. Does not flush the writer, so several
+  // entries written back to back are combined into fewer flash writes.
+  StatusWithSize Write(AlignedWriter& writer,
+                       Key key,
+                       span<const std::byte> value) const;
+
   // Changes the format and transcation ID for this entry. In order to calculate
   // the new checksum, the entire entry is read into a small stack-allocated
   // buffer. The updated entry may be written to flash using the Copy function.
@@ -144,6 +168,11 @@ class Entry {
 
   void set_address(Address address) { address_ = address; }
 
+  // The address of the first byte of the value.
+  Address value_address() const {
+    return address_ + sizeof(EntryHeader) + key_length();
+  }
+
   // The address at which the next possible entry could be located.
   Address next_address() const { return address() + size(); }
 
@@ -151,7 +180,14 @@ class Entry {
   size_t size() const { return AlignUp(content_size(), alignment_bytes()); }
 
   // The length of the key in bytes. Keys are not null terminated.
-  size_t key_length() const { return header_.key_length_bytes; }
+  size_t key_length() const {
+    return header_.key_length_bytes & kKeyLengthMask;
+  }
+
+  // True if the value is the manifest of a value stored in chunk entries.
+  bool chunk_manifest() const {
+    return (header_.key_length_bytes & kChunkManifestFlag) != 0u;
+  }
 
   // The size of the value, without padding. The size is 0 if this is a
   // tombstone entry.
@@ -173,13 +209,18 @@ class Entry {
  private:
   static constexpr uint16_t kDeletedValueLength = 0xFFFF;
 
+  // Bits of EntryHeader::key_length_bytes.
+  static constexpr uint8_t kKeyLengthMask = 0b0011'1111;
+  static constexpr uint8_t kChunkManifestFlag = 0b0100'0000;
+
   Entry(FlashPartition& partition,
         Address address,
         const EntryFormat& format,
         Key key,
         span<const std::byte> value,
         uint16_t value_size_bytes,
-        uint32_t transaction_id);
+        uint32_t transaction_id,
+        uint8_t key_flags = 0);
 
   constexpr Entry(FlashPartition* partition,
                   Address address,
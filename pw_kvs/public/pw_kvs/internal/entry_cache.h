@@ -152,15 +152,26 @@ class EntryCache {
   template <size_t kMaxEntries, size_t kRedundancy>
   using AddressList = Address[kMaxEntries * kRedundancy + kRedundancy];
 
+  // Slot in the optional hash index. Each slot holds one plus the index of a
+  // KeyDescriptor, or zero if the slot is empty.
+  using IndexSlot = uint16_t;
+
+  // Constructs an EntryCache. If index is non-empty, it is used as an open
+  // addressing hash table over the descriptors' key hashes, which makes
+  // lookups O(1) on average instead of a linear scan. The index must have more
+  // slots than the maximum number of descriptors and must be zero-initialized
+  // or cleared with Reset() before use.
   constexpr EntryCache(Vector<KeyDescriptor>& descriptors,
                        Address* addresses,
-                       size_t redundancy)
+                       size_t redundancy,
+                       span<IndexSlot> index = {})
       : descriptors_(descriptors),
         addresses_(addresses),
-        redundancy_(redundancy) {}
+        redundancy_(redundancy),
+        index_(index) {}
 
   // Clears all KeyDescriptors.
-  void Reset() const { descriptors_.clear(); }
+  void Reset() const;
 
   // Finds the metadata for an entry matching a particular key. Searches for a
   // KeyDescriptor that matches this key and sets *metadata to point to it if
@@ -226,6 +237,23 @@ class EntryCache {
  private:
   int FindIndex(uint32_t key_hash) const;
 
+  // Returns the index slot in which to start probing for a key hash.
+  size_t HomeSlot(uint32_t key_hash) const { return key_hash % index_.size(); }
+
+  size_t NextSlot(size_t slot) const {
+    return slot + 1 == index_.size() ? 0 : slot + 1;
+  }
+
+  // Returns the index slot that refers to the descriptor with this key hash.
+  // The descriptor MUST be in the index.
+  size_t FindSlot(uint32_t key_hash) const;
+
+  // Adds the descriptor at the specified index to the hash index, if any.
+  void IndexInsert(size_t descriptor_index) const;
+
+  // Removes the descriptor with this key hash from the hash index, if any.
+  void IndexErase(uint32_t key_hash) const;
+
   // Adds the address to the descriptor at the specified index if there is an
   // address slot available.
   void AddAddressIfRoom(size_t descriptor_index, Address address) const;
@@ -242,6 +270,7 @@ class EntryCache {
   Vector<KeyDescriptor>& descriptors_;
   FlashPartition::Address* const addresses_;
   const size_t redundancy_;
+  const span<IndexSlot> index_;
 };
 
 }  // namespace internal
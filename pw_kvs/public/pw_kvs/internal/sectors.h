@@ -81,6 +81,20 @@ class SectorDescriptor {
     return sector_size_bytes - valid_bytes_ - writable_bytes();
   }
 
+  // The number of times the KVS has erased this sector. The count is kept in
+  // RAM and persisted in index checkpoints, so it covers the sector's lifetime
+  // only as far as the checkpoints do.
+  uint32_t erase_count() const { return erase_count_; }
+
+  void set_erase_count(uint32_t erase_count) { erase_count_ = erase_count; }
+
+  // Records an erase of this sector.
+  void RecordErase() {
+    if (erase_count_ != UINT32_MAX) {
+      erase_count_ += 1;
+    }
+  }
+
   static constexpr size_t max_sector_size() { return kMaxSectorSize; }
 
  private:
@@ -89,11 +103,15 @@ class SectorDescriptor {
   static constexpr uint16_t kCorruptSector = UINT16_MAX;
   static constexpr size_t kMaxSectorSize = UINT16_MAX - 1;
 
-  explicit constexpr SectorDescriptor(uint16_t sector_size_bytes)
-      : tail_free_bytes_(sector_size_bytes), valid_bytes_(0) {}
+  explicit constexpr SectorDescriptor(uint16_t sector_size_bytes,
+                                      uint32_t erase_count = 0)
+      : tail_free_bytes_(sector_size_bytes),
+        valid_bytes_(0),
+        erase_count_(erase_count) {}
 
   uint16_t tail_free_bytes_;  // writable bytes at the end of the sector
   uint16_t valid_bytes_;      // sum of sizes of valid entries
+  uint32_t erase_count_;      // erases performed by the KVS
 };
 
 // Represents a list of sectors usable by the KVS.
@@ -109,11 +127,20 @@ class Sectors {
         last_new_(nullptr),
         temp_sectors_to_skip_(temp_sectors_to_skip) {}
 
-  // Resets the Sectors list. Must be called before using the object.
+  // Resets the Sectors list. Must be called before using the object. Erase
+  // counts are kept if the number of sectors is unchanged.
   void Reset() {
     last_new_ = descriptors_.begin();
-    descriptors_.assign(partition_.sector_count(),
-                        SectorDescriptor(partition_.sector_size_bytes()));
+    const auto sector_size_bytes =
+        static_cast<uint16_t>(partition_.sector_size_bytes());
+    if (descriptors_.size() != partition_.sector_count()) {
+      descriptors_.assign(partition_.sector_count(),
+                          SectorDescriptor(sector_size_bytes));
+      return;
+    }
+    for (SectorDescriptor& sector : descriptors_) {
+      sector = SectorDescriptor(sector_size_bytes, sector.erase_count());
+    }
   }
 
   // The last sector that was selected as the "new empty sector" to write to.
@@ -157,7 +184,7 @@ class Sectors {
   }
 
   // Finds either an existing sector with enough space that is not the sector to
-  // skip, or an empty sector. Maintains the invariant that there is always at
+  // skip, or the least erased empty sector. Maintains the invariant that there is always at
   // least 1 empty sector. Addresses in reserved_addresses are avoided.
   Status FindSpace(SectorDescriptor** found_sector,
                    size_t size,
@@ -179,8 +206,9 @@ class Sectors {
                 reserved_addresses);
   }
 
-  // Finds a sector that is ready to be garbage collected. Returns nullptr if no
-  // sectors can / need to be garbage collected.
+  // Finds a sector that is ready to be garbage collected. Among sectors that
+  // need no relocation, the least erased one is preferred. Returns nullptr if
+  // no sectors can / need to be garbage collected.
   SectorDescriptor* FindSectorToGarbageCollect(
       span<const Address> reserved_addresses) const;
 
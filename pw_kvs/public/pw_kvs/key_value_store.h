@@ -16,8 +16,10 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <type_traits>
 
+#include "pw_bytes/span.h"
 #include "pw_containers/vector.h"
 #include "pw_kvs/checksum.h"
 #include "pw_kvs/flash_memory.h"
@@ -28,9 +30,13 @@
 #include "pw_kvs/internal/sectors.h"
 #include "pw_kvs/internal/span_traits.h"
 #include "pw_kvs/key.h"
+#include "pw_kvs/write_batch.h"
+#include "pw_result/result.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
+#include "pw_stream/seek.h"
+#include "pw_stream/stream.h"
 
 namespace pw {
 namespace kvs {
@@ -78,6 +84,12 @@ struct Options {
 
   // Verify an in-flash entry's checksum after writing it.
   bool verify_on_write = true;
+
+  // Store values passed to Put that are too large for a single entry as a
+  // series of chunk entries. If false, such Put calls fail with
+  // INVALID_ARGUMENT. Values written with a ValueWriter are chunked as needed
+  // regardless of this option.
+  bool chunk_large_values = false;
 };
 
 /// Flash-backed persistent key-value store (KVS) with integrated
@@ -158,6 +170,9 @@ class KeyValueStore {
   ///    is too large.
   ///
   /// @endrst
+  ///
+  /// Values stored in chunks are reassembled transparently. To read a large
+  /// value without a buffer the size of the value, use a `ValueReader`.
   StatusWithSize Get(Key key,
                      span<std::byte> value,
                      size_t offset_bytes = 0) const;
@@ -176,6 +191,36 @@ class KeyValueStore {
     return FixedSizeGet(key, pointer, sizeof(T));
   }
 
+  /// Returns a view of a value in memory-mapped flash, without copying it to
+  /// RAM. If `Options::verify_on_read` is set, the value's checksum is
+  /// verified before the view is returned.
+  ///
+  /// The view refers to the entry in flash, so it is only valid until the KVS
+  /// is next modified. Writes and maintenance may relocate or erase the entry.
+  ///
+  /// @param[in] key The name of the key.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The view of the value.
+  ///
+  ///    NOT_FOUND: The key is not present in the KVS.
+  ///
+  ///    DATA_LOSS: Found the entry, but the data was corrupted.
+  ///
+  ///    UNIMPLEMENTED: The flash is not memory-mapped, or the value is stored
+  ///    in chunks and so is not contiguous.
+  ///
+  ///    FAILED_PRECONDITION: The KVS is not initialized. Call ``Init()``
+  ///    before calling this method.
+  ///
+  ///    INVALID_ARGUMENT: ``key`` is empty or too long.
+  ///
+  /// @endrst
+  Result<ConstByteSpan> GetView(Key key) const;
+
   /// Adds a key-value entry to the KVS. If the key was already present, its
   /// value is overwritten.
   ///
@@ -184,7 +229,8 @@ class KeyValueStore {
   /// added and @pw_status{ALREADY_EXISTS} is returned.
   ///
   /// @param[in] value The value for the key. This can be a span of bytes or a
-  /// trivially copyable object.
+  /// trivially copyable object. If `Options::chunk_large_values` is set,
+  /// values too large for a single entry are stored in chunks.
   ///
   /// @returns @rst
   ///
@@ -202,8 +248,8 @@ class KeyValueStore {
   ///    FAILED_PRECONDITION: The KVS is not initialized. Call ``Init()``
   ///    before calling this method.
   ///
-  ///    INVALID_ARGUMENT: ``key`` is empty or too long, or ``value``
-  ///    is too large.
+  ///    INVALID_ARGUMENT: ``key`` is empty, too long, or starts with the
+  ///    reserved byte ``0x1f``, or ``value`` is too large.
   ///
   /// @endrst
   template <typename T,
@@ -219,6 +265,39 @@ class KeyValueStore {
     return PutBytes(key, as_bytes(span<const T>(&value, 1)));
   }
 
+  /// Writes all puts staged in a `WriteBatch`.
+  ///
+  /// Puts whose value is already stored are skipped. The remaining entries are
+  /// written back to back into one sector per copy, so flash writes are
+  /// combined across entry boundaries instead of being flushed and padded
+  /// once per entry. A batch that does not fit in a single sector is written
+  /// one entry at a time, like a series of `Put()` calls.
+  ///
+  /// Every put is validated before anything is written. However, a batch is
+  /// not atomic across power loss: after a reset, any subset of its entries
+  /// may have been stored.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: All staged puts were written or already stored.
+  ///
+  ///    DATA_LOSS: Checksum validation failed after writing data.
+  ///
+  ///    RESOURCE_EXHAUSTED: Not enough space or entries for the batch.
+  ///
+  ///    ALREADY_EXISTS: A key's hash collides with a different key in the
+  ///    KVS. Nothing was written.
+  ///
+  ///    FAILED_PRECONDITION: The KVS is not initialized.
+  ///
+  ///    INVALID_ARGUMENT: A key is empty or too long, or a value is too
+  ///    large. Nothing was written.
+  ///
+  /// @endrst
+  Status Commit(WriteBatch& batch);
+
   /// Removes a key-value entry from the KVS.
   ///
   /// @param[in] key - The name of the key-value entry to delete.
@@ -295,8 +374,318 @@ class KeyValueStore {
   /// that makes sense for the KVS implementation.
   Status PartialMaintenance();
 
+  /// Performs one bounded step of garbage collection, so that maintenance can
+  /// be spread across many calls, for example from a work queue or a
+  /// `pw_async2` task, without blocking foreground writes for long.
+  ///
+  /// Each call either relocates valid entries out of the sector being
+  /// collected, stopping after the entry that brings the total relocated to
+  /// `max_relocation_bytes`, or erases that sector once it holds no valid
+  /// entries. At least one entry is relocated per call, so entries larger than
+  /// the budget still make progress. A sector erase is always done on its own
+  /// call. Callers that need a time bound can call this repeatedly with a small
+  /// budget and check their clock between calls.
+  ///
+  /// Foreground writes that run out of space may still garbage collect
+  /// synchronously, including finishing a partially collected sector.
+  ///
+  /// If configured for at least lazy recovery, repairs corruption before
+  /// collecting, as `PartialMaintenance()` does.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: A step was completed; the size is the number of bytes relocated,
+  ///    which is 0 if a sector was erased. Call again to continue.
+  ///
+  ///    NOT_FOUND: No sector has reclaimable space.
+  ///
+  ///    FAILED_PRECONDITION: The KVS is not initialized.
+  ///
+  /// @endrst
+  StatusWithSize IncrementalMaintenance(size_t max_relocation_bytes);
+
+  /// Initializes the KVS from the newest valid checkpoint written by
+  /// `WriteCheckpoint()` to `checkpoint_partition`, instead of reading every
+  /// entry in every sector.
+  ///
+  /// A checkpoint is used only if its checksum is valid, it matches this KVS's
+  /// configuration, and no KVS sector was written or erased after it was
+  /// taken. Checking this reads one or two entry headers per sector.
+  /// Otherwise, this falls back to a full `Init()`, still restoring the
+  /// per-sector erase counts used for wear leveling from the checkpoint.
+  ///
+  /// @returns The same codes as `Init()`.
+  Status InitFromCheckpoint(FlashPartition& checkpoint_partition);
+
+  /// Writes a checkpoint of the in-memory index of the KVS, for use by
+  /// `InitFromCheckpoint()`. Checkpoints rotate through the sectors of
+  /// `checkpoint_partition`, which must not overlap the KVS partition. Use at
+  /// least two sectors so that the previous checkpoint survives an interrupted
+  /// write. Each checkpoint has a generation counter; the newest valid one is
+  /// loaded.
+  ///
+  /// A checkpoint becomes stale as soon as the KVS is modified, so write one
+  /// when the KVS is expected to change rarely before the next boot, such as
+  /// after startup or maintenance.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The checkpoint was written.
+  ///
+  ///    FAILED_PRECONDITION: The KVS is not initialized or needs maintenance.
+  ///
+  ///    RESOURCE_EXHAUSTED: The checkpoint does not fit in one sector of
+  ///    ``checkpoint_partition``.
+  ///
+  ///    INVALID_ARGUMENT: ``checkpoint_partition``'s alignment is larger than
+  ///    ``PW_KVS_MAX_FLASH_ALIGNMENT``.
+  ///
+  /// @endrst
+  Status WriteCheckpoint(FlashPartition& checkpoint_partition);
+
   void LogDebugInfo() const;
 
+  /// Reads a value in pieces, so that values of any size can be read with a
+  /// small, constant amount of RAM. Values stored in chunks are read chunk by
+  /// chunk.
+  ///
+  /// If `Options::verify_on_read` is set, each entry's checksum is verified
+  /// from flash before any of its data is returned.
+  ///
+  /// A reader refers to the entries in flash, so it must be closed before the
+  /// KVS is next modified. Writes and maintenance may relocate or erase them.
+  class ValueReader final : public stream::SeekableReader {
+   public:
+    constexpr ValueReader(const KeyValueStore& kvs)
+        : kvs_(kvs),
+          entry_{},
+          entry_offset_(0),
+          entry_loaded_(false),
+          key_hash_(0),
+          value_size_(0),
+          chunk_size_(0),
+          generation_(0),
+          position_(0),
+          open_(false) {}
+
+    ValueReader(const ValueReader&) = delete;
+    ValueReader& operator=(const ValueReader&) = delete;
+
+    /// Opens the value of `key` for reading from its start.
+    ///
+    /// @returns @rst
+    ///
+    /// .. pw-status-codes::
+    ///
+    ///    OK: The value is open for reading.
+    ///
+    ///    NOT_FOUND: The key is not present in the KVS.
+    ///
+    ///    DATA_LOSS: Found the entry, but the data was corrupted.
+    ///
+    ///    FAILED_PRECONDITION: The reader is already open, or the KVS is not
+    ///    initialized.
+    ///
+    ///    INVALID_ARGUMENT: ``key`` is empty or too long.
+    ///
+    /// @endrst
+    Status Open(Key key);
+
+    /// Closes the reader, which can then be opened again.
+    ///
+    /// @returns @rst
+    ///
+    /// .. pw-status-codes::
+    ///
+    ///    OK: The reader was closed.
+    ///
+    ///    FAILED_PRECONDITION: The reader is not open.
+    ///
+    /// @endrst
+    Status Close() {
+      if (!open_) {
+        return Status::FailedPrecondition();
+      }
+      open_ = false;
+      return OkStatus();
+    }
+
+    bool IsOpen() const { return open_; }
+
+    /// @returns The size of the open value in bytes.
+    size_t value_size() const { return value_size_; }
+
+   private:
+    friend class KeyValueStore;
+
+    // Opens a value whose entry has already been read.
+    Status Open(uint32_t key_hash, const internal::Entry& entry);
+
+    // Reads the chunk entry that contains position_.
+    Status LoadChunk();
+
+    size_t ConservativeLimit(LimitType type) const override {
+      return open_ && type == LimitType::kRead ? value_size_ - position_ : 0;
+    }
+
+    size_t DoTell() override { return position_; }
+
+    Status DoSeek(ptrdiff_t offset, Whence origin) override {
+      if (!open_) {
+        return Status::FailedPrecondition();
+      }
+      return stream::CalculateSeek(offset, origin, value_size_, position_);
+    }
+
+    StatusWithSize DoRead(ByteSpan destination) override;
+
+    const KeyValueStore& kvs_;
+
+    // The entry that is being read, and the offset of its data in the value.
+    internal::Entry entry_;
+    size_t entry_offset_;
+    bool entry_loaded_;
+
+    // The chunk manifest, if the value is stored in chunks. Otherwise,
+    // chunk_size_ is 0.
+    uint32_t key_hash_;
+    size_t value_size_;
+    size_t chunk_size_;
+    uint8_t generation_;
+
+    size_t position_;
+    bool open_;
+  };
+
+  /// Writes a value in pieces, so that values of any size can be written
+  /// without a buffer the size of the value.
+  ///
+  /// Data is collected in `chunk_buffer` and written as a chunk entry each time
+  /// the buffer fills. `Close()` then writes a manifest entry for the key that
+  /// lists the chunks, which replaces any previous value atomically: until the
+  /// manifest is written, `Get()` returns the previous value. A value that
+  /// fits in the buffer and in a single entry is stored as a regular entry.
+  ///
+  /// Each chunk uses an entry of the KVS, so a larger buffer uses fewer
+  /// entries. Chunks are at most `max_key_value_size_bytes()` minus a few
+  /// bytes, however large the buffer is.
+  ///
+  /// The key must not be written or deleted while a writer for it is open.
+  class ValueWriter final : public stream::NonSeekableWriter {
+   public:
+    constexpr ValueWriter(KeyValueStore& kvs, ByteSpan chunk_buffer)
+        : kvs_(kvs),
+          buffer_(chunk_buffer),
+          key_buffer_{},
+          key_length_(0),
+          chunk_size_(0),
+          buffered_(0),
+          chunk_count_(0),
+          value_size_(0),
+          generation_(0),
+          open_(false) {}
+
+    ValueWriter(const ValueWriter&) = delete;
+    ValueWriter& operator=(const ValueWriter&) = delete;
+
+    /// An open writer is abandoned when it is destroyed, so the previous value
+    /// of the key is kept.
+    ~ValueWriter() override {
+      if (open_) {
+        Abandon().IgnoreError();
+      }
+    }
+
+    /// Opens a writer that replaces the value of `key`. The key is copied.
+    ///
+    /// @returns @rst
+    ///
+    /// .. pw-status-codes::
+    ///
+    ///    OK: The writer is open.
+    ///
+    ///    FAILED_PRECONDITION: The writer is already open, or the KVS is not
+    ///    initialized.
+    ///
+    ///    INVALID_ARGUMENT: ``key`` is empty, too long, or reserved, or the
+    ///    chunk buffer is empty.
+    ///
+    ///    ALREADY_EXISTS: A different key with the same hash is already in the
+    ///    KVS.
+    ///
+    ///    DATA_LOSS: The key's previous value is corrupt.
+    ///
+    /// @endrst
+    Status Open(Key key);
+
+    /// Writes the remaining data and the manifest, which stores the new value
+    /// of the key, and closes the writer. Do not retry `Close()` on error; the
+    /// writer is closed and the previous value of the key is kept.
+    ///
+    /// @returns @rst
+    ///
+    /// .. pw-status-codes::
+    ///
+    ///    OK: The value was stored.
+    ///
+    ///    FAILED_PRECONDITION: The writer is not open.
+    ///
+    ///    RESOURCE_EXHAUSTED: Not enough space or entries for the value.
+    ///
+    ///    DATA_LOSS: Checksum validation failed after writing data.
+    ///
+    /// @endrst
+    Status Close();
+
+    /// Closes the writer without storing the value, so the previous value of
+    /// the key is kept. Chunks that were already written are removed the next
+    /// time the key is written with chunks or deleted.
+    ///
+    /// @returns @rst
+    ///
+    /// .. pw-status-codes::
+    ///
+    ///    OK: The writer was closed.
+    ///
+    ///    FAILED_PRECONDITION: The writer is not open.
+    ///
+    /// @endrst
+    Status Abandon() {
+      if (!open_) {
+        return Status::FailedPrecondition();
+      }
+      open_ = false;
+      return OkStatus();
+    }
+
+    bool IsOpen() const { return open_; }
+
+   private:
+    // Writes the buffered data as the next chunk.
+    Status WriteChunk();
+
+    size_t ConservativeLimit(LimitType type) const override;
+
+    Status DoWrite(ConstByteSpan data) override;
+
+    Key key() const { return Key(key_buffer_.data(), key_length_); }
+
+    KeyValueStore& kvs_;
+    const ByteSpan buffer_;
+    internal::Entry::KeyBuffer key_buffer_;
+    size_t key_length_;
+    size_t chunk_size_;
+    size_t buffered_;
+    size_t chunk_count_;
+    size_t value_size_;
+    uint8_t generation_;
+    bool open_;
+  };
+
   // Classes and functions to support STL-style iteration.
   class iterator;
 
@@ -391,7 +780,8 @@ class KeyValueStore {
   /// @returns The last key-value entry in the container. Used for iteration.
   iterator end() const { return iterator(*this, entry_cache_.end()); }
 
-  /// @returns The number of valid entries in the KVS.
+  /// @returns The number of valid entries in the KVS. Each chunk of a value
+  /// that is stored in chunks counts as an entry.
   size_t size() const { return entry_cache_.present_entries(); }
 
   /// @returns The number of valid entries and deleted entries yet to be
@@ -426,6 +816,13 @@ class KeyValueStore {
     size_t reclaimable_bytes;
     /// The total count of individual sector erases that have been performed.
     size_t sector_erase_count;
+    /// The lowest per-sector erase count. Unlike the other statistics, the
+    /// per-sector erase counts are retained across reboots by index
+    /// checkpoints (see `WriteCheckpoint()`).
+    uint32_t min_sector_erase_count;
+    /// The highest per-sector erase count. The difference from
+    /// `min_sector_erase_count` shows how evenly the sectors wear.
+    uint32_t max_sector_erase_count;
     /// The number of corrupt sectors that have been recovered.
     size_t corrupt_sectors_recovered;
     /// The number of missing redundant copies of entries that have been
@@ -444,7 +841,8 @@ class KeyValueStore {
   /// @returns `true` if the KVS has any unrepaired errors.
   bool error_detected() const { return error_detected_; }
 
-  /// @returns The maximum number of bytes allowed for a key-value combination.
+  /// @returns The maximum number of bytes allowed for a key-value combination
+  /// in a single entry. Larger values can be stored in chunks.
   size_t max_key_value_size_bytes() const {
     return max_key_value_size_bytes(partition_.sector_size_bytes());
   }
@@ -475,12 +873,19 @@ class KeyValueStore {
                 Vector<SectorDescriptor>& sector_descriptor_list,
                 const SectorDescriptor** temp_sectors_to_skip,
                 Vector<KeyDescriptor>& key_descriptor_list,
-                Address* addresses);
+                Address* addresses,
+                span<internal::EntryCache::IndexSlot> key_index = {});
 
  private:
   using EntryMetadata = internal::EntryMetadata;
   using EntryState = internal::EntryState;
 
+  // Whether an entry holds a value, or the manifest of a chunked value.
+  enum class ValueKind : bool {
+    kValue,
+    kChunkManifest,
+  };
+
   template <typename T>
   static constexpr void CheckThatObjectCanBePutOrGet() {
     static_assert(
@@ -491,7 +896,20 @@ class KeyValueStore {
         "as_writable_bytes(span(&value, 1)).");
   }
 
+  Status CheckPartitionGeometry() const;
+
   Status InitializeMetadata();
+
+  // Restores the sectors and entry cache from a checkpoint.
+  Status LoadCheckpoint(FlashPartition& checkpoint_partition);
+
+  // Restores only the per-sector erase counts from the newest checkpoint,
+  // provided the partition geometry matches.
+  Status LoadEraseCounts(FlashPartition& checkpoint_partition);
+
+  // Reads the transaction ID of the first entry in a sector, if any.
+  Status ReadFirstTransactionId(const SectorDescriptor& sector,
+                                uint32_t& transaction_id);
   Status LoadEntry(Address entry_address, Address* next_entry_address);
   Status ScanForEntry(const SectorDescriptor& sector,
                       Address start_address,
@@ -507,6 +925,50 @@ class KeyValueStore {
 
   Status PutBytes(Key key, span<const std::byte> value);
 
+  // Writes the entry for a key and, when a plain value replaces a chunked
+  // value, removes the old chunks.
+  Status WriteValue(Key key, span<const std::byte> value, ValueKind kind);
+
+  // The largest amount of data stored in a single chunk entry.
+  size_t max_chunk_size() const;
+
+  // Stores a value that is too large for a single entry in chunks.
+  Status PutChunked(Key key, span<const std::byte> value);
+
+  // Selects the chunk generation for a new chunked value of a key. The two
+  // generations alternate, so that a new value's chunks never overwrite the
+  // chunks of the value it replaces.
+  Status NextChunkGeneration(Key key, uint8_t& generation) const;
+
+  Status WriteChunk(uint32_t key_hash,
+                    uint8_t generation,
+                    size_t index,
+                    span<const std::byte> data);
+
+  // Writes the manifest of a chunked value, then removes stale chunks.
+  Status CommitChunkedValue(Key key,
+                            size_t value_size,
+                            size_t chunk_size,
+                            size_t chunk_count,
+                            uint8_t generation);
+
+  // Deletes the chunks of a generation from first_index on, which are either
+  // stale or left over from an interrupted write. Deletes from the last chunk
+  // down, so an interrupted delete never leaves a gap.
+  Status DeleteChunks(uint32_t key_hash,
+                      uint8_t generation,
+                      size_t first_index);
+
+  Status DeleteAllChunks(uint32_t key_hash);
+
+  Status FindChunk(uint32_t key_hash,
+                   uint8_t generation,
+                   size_t index,
+                   EntryMetadata* metadata_out) const;
+
+  // True if the iterator should skip this entry: it is deleted or a chunk.
+  bool HiddenFromIteration(const EntryMetadata& metadata) const;
+
   StatusWithSize ValueSize(const EntryMetadata& metadata) const;
 
   Status ReadEntry(const EntryMetadata& metadata, Entry& entry) const;
@@ -553,13 +1015,16 @@ class KeyValueStore {
                                   Key key,
                                   span<const std::byte> value);
 
-  Status WriteEntryForNewKey(Key key, span<const std::byte> value);
+  Status WriteEntryForNewKey(Key key,
+                             span<const std::byte> value,
+                             ValueKind kind = ValueKind::kValue);
 
   Status WriteEntry(Key key,
                     span<const std::byte> value,
                     EntryState new_state,
                     EntryMetadata* prior_metadata = nullptr,
-                    const internal::Entry* prior_entry = nullptr);
+                    const internal::Entry* prior_entry = nullptr,
+                    ValueKind kind = ValueKind::kValue);
 
   EntryMetadata CreateOrUpdateKeyDescriptor(const Entry& new_entry,
                                             Key key,
@@ -581,6 +1046,14 @@ class KeyValueStore {
 
   Status AppendEntry(const Entry& entry, Key key, span<const std::byte> value);
 
+  // Writes the changed entries of a batch contiguously, starting at address.
+  Status AppendBatch(const WriteBatch& batch,
+                     Address address,
+                     uint32_t first_transaction_id);
+
+  // Writes the changed entries of a batch one at a time with PutBytes().
+  Status CommitEachPut(const WriteBatch& batch);
+
   StatusWithSize CopyEntryToSector(Entry& entry,
                                    SectorDescriptor* new_sector,
                                    Address new_address);
@@ -615,6 +1088,11 @@ class KeyValueStore {
   Status GarbageCollectSector(SectorDescriptor& sector_to_gc,
                               span<const Address> reserved_addresses);
 
+  // Relocates valid entries out of the sector, stopping after the entry that
+  // brings the total relocated to max_bytes. Returns the bytes relocated.
+  StatusWithSize RelocateEntriesInSector(SectorDescriptor& sector_to_gc,
+                                         size_t max_bytes);
+
   // Ensure that all entries are on the primary (first) format. Entries that are
   // not on the primary format are rewritten.
   //
@@ -636,7 +1114,8 @@ class KeyValueStore {
   internal::Entry CreateEntry(Address address,
                               Key key,
                               span<const std::byte> value,
-                              EntryState state);
+                              EntryState state,
+                              ValueKind kind = ValueKind::kValue);
 
   void LogSectors() const;
   void LogKeyDescriptor() const;
@@ -647,8 +1126,9 @@ class KeyValueStore {
   // List of sectors used by this KVS.
   internal::Sectors sectors_;
 
-  // Unordered list of KeyDescriptors. Finding a key requires scanning and
-  // verifying a match by reading the actual entry.
+  // Unordered list of KeyDescriptors. Finding a key requires scanning (or a
+  // hash index lookup, if one was provided) and verifying a match by reading
+  // the actual entry.
   internal::EntryCache entry_cache_;
 
   Options options_;
@@ -685,12 +1165,28 @@ class KeyValueStore {
   InternalStats internal_stats_;
 
   uint32_t last_transaction_id_;
+
+  // The sector being garbage collected by IncrementalMaintenance(), if any.
+  SectorDescriptor* incremental_gc_sector_;
+
+  // Whether the KVS may contain chunk entries, which iteration must skip.
+  // Checking for them requires reading each entry's key, so iteration only
+  // does so if chunks were written or found since Init().
+  bool chunks_present_;
 };
 
+/// Allocates the buffers for a `KeyValueStore`.
+///
+/// If `kIndexSlots` is nonzero, the KVS keeps a hash index over its key
+/// hashes so that `Get`, `Put`, and `Delete` find a key in O(1) on average
+/// rather than scanning every entry. The index costs `2 * kIndexSlots` bytes
+/// of RAM and must have more slots than `kMaxEntries`; a load factor of 50-75%
+/// (e.g. `kIndexSlots = 2 * kMaxEntries`) keeps probe sequences short.
 template <size_t kMaxEntries,
           size_t kMaxUsableSectors,
           size_t kRedundancy = 1,
-          size_t kEntryFormats = 1>
+          size_t kEntryFormats = 1,
+          size_t kIndexSlots = 0>
 class KeyValueStoreBuffer : public KeyValueStore {
  public:
   // Constructs a KeyValueStore on the partition, with support for one
@@ -719,9 +1215,11 @@ class KeyValueStoreBuffer : public KeyValueStore {
                       sectors_,
                       temp_sectors_to_skip_,
                       key_descriptors_,
-                      addresses_),
+                      addresses_,
+                      key_index_),
         sectors_(),
         key_descriptors_(),
+        key_index_(),
         formats_() {
     std::copy(formats.begin(), formats.end(), formats_.begin());
   }
@@ -731,6 +1229,12 @@ class KeyValueStoreBuffer : public KeyValueStore {
   static_assert(kMaxUsableSectors > 0u);
   static_assert(kRedundancy > 0u);
   static_assert(kEntryFormats > 0u);
+  static_assert(kIndexSlots == 0u || kIndexSlots > kMaxEntries,
+                "The key index must have more slots than kMaxEntries");
+  static_assert(kIndexSlots == 0u ||
+                    kMaxEntries < std::numeric_limits<
+                                      internal::EntryCache::IndexSlot>::max(),
+                "kMaxEntries is too large for the key index");
 
   Vector<SectorDescriptor, kMaxUsableSectors> sectors_;
 
@@ -751,6 +1255,9 @@ class KeyValueStoreBuffer : public KeyValueStore {
   // KeyDescriptors.
   internal::EntryCache::AddressList<kRedundancy, kMaxEntries> addresses_;
 
+  // Optional hash index over the KeyDescriptors' key hashes.
+  std::array<internal::EntryCache::IndexSlot, kIndexSlots> key_index_;
+
   // EntryFormats that can be read by this KeyValueStore.
   std::array<EntryFormat, kEntryFormats> formats_;
 };
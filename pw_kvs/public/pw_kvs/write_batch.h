@@ -0,0 +1,127 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+#include "pw_containers/vector.h"
+#include "pw_kvs/internal/span_traits.h"
+#include "pw_kvs/key.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw {
+namespace kvs {
+
+class KeyValueStore;
+
+/// Stages several puts to be written to a `KeyValueStore` together with
+/// `KeyValueStore::Commit()`.
+///
+/// Staged keys and values are copied into a buffer owned by the batch.
+/// Instances are declared as `pw::kvs::WriteBatchBuffer<MAX_PUTS, BYTES>`.
+class WriteBatch {
+ public:
+  WriteBatch(const WriteBatch&) = delete;
+  WriteBatch& operator=(const WriteBatch&) = delete;
+
+  /// Stages a put of `value` to `key`. If `key` is already staged, its staged
+  /// value is replaced.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The put was staged.
+  ///
+  ///    RESOURCE_EXHAUSTED: The batch has no room for another put, or its
+  ///    buffer has no room for the key and value.
+  ///
+  /// @endrst
+  Status PutBytes(Key key, span<const std::byte> value);
+
+  /// Stages a put of a span-like value or a trivially copyable object. See
+  /// `KeyValueStore::Put()`.
+  template <typename T,
+            typename std::enable_if_t<ConvertsToSpan<T>::value>* = nullptr>
+  Status Put(const Key& key, const T& value) {
+    return PutBytes(key, as_bytes(internal::make_span(value)));
+  }
+
+  template <typename T,
+            typename std::enable_if_t<!ConvertsToSpan<T>::value>* = nullptr>
+  Status Put(const Key& key, const T& value) {
+    static_assert(
+        std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value,
+        "Only trivially copyable, non-pointer objects may be Put by value.");
+    return PutBytes(key, as_bytes(span<const T>(&value, 1)));
+  }
+
+  /// Removes all staged puts.
+  void clear() {
+    puts_.clear();
+    buffer_used_ = 0;
+  }
+
+  /// The number of staged puts.
+  size_t size() const { return puts_.size(); }
+
+  /// The maximum number of puts that can be staged.
+  size_t max_size() const { return puts_.max_size(); }
+
+  bool empty() const { return puts_.empty(); }
+
+ protected:
+  struct StagedPut {
+    Key key;
+    span<const std::byte> value;
+
+    // Set by KeyValueStore::Commit() if the value is already stored.
+    bool unchanged;
+  };
+
+  WriteBatch(Vector<StagedPut>& puts, span<std::byte> buffer)
+      : puts_(puts), buffer_(buffer), buffer_used_(0) {}
+
+ private:
+  friend class KeyValueStore;
+
+  // Copies data to the unused portion of the buffer.
+  span<const std::byte> Store(span<const std::byte> data);
+
+  Vector<StagedPut>& puts_;
+  const span<std::byte> buffer_;
+  size_t buffer_used_;
+};
+
+/// Allocates the storage for a `WriteBatch` of up to `kMaxPuts` puts, whose
+/// keys and values total up to `kBufferBytes` bytes. Replacing a staged value
+/// with one of a different size does not reclaim the old value's space.
+template <size_t kMaxPuts, size_t kBufferBytes>
+class WriteBatchBuffer : public WriteBatch {
+ public:
+  WriteBatchBuffer() : WriteBatch(puts_, buffer_) {}
+
+ private:
+  static_assert(kMaxPuts > 0u);
+  static_assert(kBufferBytes > 0u);
+
+  Vector<StagedPut, kMaxPuts> puts_;
+  std::array<std::byte, kBufferBytes> buffer_;
+};
+
+}  // namespace kvs
+}  // namespace pw
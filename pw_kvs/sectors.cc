@@ -39,7 +39,7 @@ Status Sectors::Find(FindMode find_mode,
                      size_t size,
                      span<const Address> addresses_to_skip,
                      span<const Address> reserved_addresses) {
-  SectorDescriptor* first_empty_sector = nullptr;
+  SectorDescriptor* least_worn_empty_sector = nullptr;
   bool at_least_two_empty_sectors = (find_mode == kGarbageCollect);
 
   // Used for the GC reclaimable bytes check
@@ -90,8 +90,9 @@ Status Sectors::Find(FindMode find_mode,
   // sector that is found.
   //
   // Tier 2 is find sectors that are empty/erased. While scanning for a partial
-  // sector, keep track of the first empty sector and if a second empty sector
-  // was seen. If during GC then count the second empty sector as always seen.
+  // sector, keep track of the empty sector with the lowest erase count (the
+  // first one in rotation order on a tie) and if a second empty sector was
+  // seen. If during GC then count the second empty sector as always seen.
   //
   // Tier 3 is during garbage collection, find sectors with enough space that
   // are not empty but have recoverable bytes. Pick the sector with the least
@@ -124,24 +125,29 @@ Status Sectors::Find(FindMode find_mode,
     }
 
     if (sector->Empty(sector_size_bytes)) {
-      if (first_empty_sector == nullptr) {
-        first_empty_sector = sector;
+      if (least_worn_empty_sector == nullptr) {
+        least_worn_empty_sector = sector;
       } else {
         at_least_two_empty_sectors = true;
+        if (sector->erase_count() < least_worn_empty_sector->erase_count()) {
+          least_worn_empty_sector = sector;
+        }
       }
     }
   }
 
   // Tier 2 check: If the scan for a partial sector does not find a suitable
-  // sector, use the first empty sector that was found. Normally it is required
-  // to keep 1 empty sector after the sector found here, but that rule does not
-  // apply during GC.
-  if (first_empty_sector != nullptr && at_least_two_empty_sectors) {
+  // sector, use the least worn empty sector that was found. Normally it is
+  // required to keep 1 empty sector after the sector found here, but that rule
+  // does not apply during GC.
+  if (least_worn_empty_sector != nullptr && at_least_two_empty_sectors) {
     PW_LOG_DEBUG(
-        "  Found a usable empty sector; returning the first found (%u)",
-        Index(first_empty_sector));
-    last_new_ = first_empty_sector;
-    *found_sector = first_empty_sector;
+        "  Found a usable empty sector; returning the least worn (%u, %u "
+        "erases)",
+        Index(least_worn_empty_sector),
+        unsigned(least_worn_empty_sector->erase_count()));
+    last_new_ = least_worn_empty_sector;
+    *found_sector = least_worn_empty_sector;
     return OkStatus();
   }
 
@@ -181,17 +187,19 @@ SectorDescriptor* Sectors::FindSectorToGarbageCollect(
   const span sectors_to_skip(temp_sectors_to_skip_, reserved_addresses.size());
 
   // Step 1: Try to find a sectors with stale keys and no valid keys (no
-  // relocation needed). Use the first such sector found, as that will help the
-  // KVS "rotate" around the partition. Initially this would select the sector
-  // with the most reclaimable space, but that can cause GC sector selection to
-  // "ping-pong" between two sectors when updating large keys.
+  // relocation needed). Use the least erased such sector, taking the first one
+  // found on a tie, as that will help the KVS "rotate" around the partition.
+  // Initially this would select the sector with the most reclaimable space, but
+  // that can cause GC sector selection to "ping-pong" between two sectors when
+  // updating large keys.
   for (size_t i = 0; i < descriptors_.size(); ++i) {
     SectorDescriptor& sector = WearLeveledSectorFromIndex(i);
     if ((sector.valid_bytes() == 0) &&
         (sector.RecoverableBytes(sector_size_bytes) > 0) &&
-        !Contains(sectors_to_skip, &sector)) {
+        !Contains(sectors_to_skip, &sector) &&
+        (sector_candidate == nullptr ||
+         sector.erase_count() < sector_candidate->erase_count())) {
       sector_candidate = &sector;
-      break;
     }
   }
 
@@ -79,8 +79,52 @@ TEST_F(SectorsTest, NextWritableAddress_PartiallyWrittenSector) {
   EXPECT_EQ(123u, sectors_.NextWritableAddress(*sectors_.begin()));
 }
 
-// TODO(hepler): Add tests for FindSpace, FindSpaceDuringGarbageCollection, and
-// FindSectorToGarbageCollect.
+TEST_F(SectorsTest, Reset_KeepsEraseCounts) {
+  sectors_.begin()->RemoveWritableBytes(123);
+  sectors_.begin()->RecordErase();
+  sectors_.begin()->RecordErase();
+
+  sectors_.Reset();
+  EXPECT_EQ(0u, sectors_.NextWritableAddress(*sectors_.begin()));
+  EXPECT_EQ(2u, sectors_.begin()->erase_count());
+}
+
+TEST_F(SectorsTest, FindSpace_PrefersLeastErasedEmptySector) {
+  for (SectorDescriptor& sector : sectors_) {
+    sector.set_erase_count(3);
+  }
+  sectors_.FromAddress(5 * 128).set_erase_count(1);
+
+  SectorDescriptor* found = nullptr;
+  ASSERT_EQ(OkStatus(), sectors_.FindSpace(&found, 32, {}));
+  EXPECT_EQ(5u, sectors_.Index(found));
+  EXPECT_EQ(found, sectors_.last_new());
+}
+
+TEST_F(SectorsTest, FindSpace_EqualEraseCounts_RotatesThroughSectors) {
+  SectorDescriptor* found = nullptr;
+  ASSERT_EQ(OkStatus(), sectors_.FindSpace(&found, 32, {}));
+  EXPECT_EQ(1u, sectors_.Index(found));
+  ASSERT_EQ(OkStatus(), sectors_.FindSpace(&found, 128, {}));
+  EXPECT_EQ(2u, sectors_.Index(found));
+}
+
+TEST_F(SectorsTest, FindSectorToGarbageCollect_PrefersLeastErasedSector) {
+  // Sectors 2 and 4 only hold stale data.
+  SectorDescriptor& sector_2 = sectors_.FromAddress(2 * 128);
+  SectorDescriptor& sector_4 = sectors_.FromAddress(4 * 128);
+  sector_2.RemoveWritableBytes(64);
+  sector_4.RemoveWritableBytes(64);
+
+  sector_2.set_erase_count(4);
+  sector_4.set_erase_count(1);
+  EXPECT_EQ(&sector_4, sectors_.FindSectorToGarbageCollect({}));
+
+  sector_2.set_erase_count(1);
+  EXPECT_EQ(&sector_2, sectors_.FindSectorToGarbageCollect({}));
+}
+
+// TODO(hepler): Add tests for FindSpaceDuringGarbageCollection.
 
 }  // namespace
 }  // namespace pw::kvs::internal
@@ -0,0 +1,66 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_kvs/write_batch.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace pw::kvs {
+
+Status WriteBatch::PutBytes(Key key, span<const std::byte> value) {
+  const size_t buffer_remaining = buffer_.size() - buffer_used_;
+
+  for (StagedPut& put : puts_) {
+    if (put.key != key) {
+      continue;
+    }
+
+    // Overwrite the staged value in place if the new value fits.
+    if (value.size() <= put.value.size()) {
+      std::byte* data = buffer_.data() + (put.value.data() - buffer_.data());
+      if (!value.empty()) {
+        std::memmove(data, value.data(), value.size());
+      }
+      put.value = span<const std::byte>(data, value.size());
+      return OkStatus();
+    }
+
+    if (value.size() > buffer_remaining) {
+      return Status::ResourceExhausted();
+    }
+    put.value = Store(value);
+    return OkStatus();
+  }
+
+  if (puts_.full() || key.size() + value.size() > buffer_remaining) {
+    return Status::ResourceExhausted();
+  }
+
+  const span<const std::byte> stored_key = Store(as_bytes(span(key)));
+  puts_.push_back(
+      {Key(reinterpret_cast<const char*>(stored_key.data()), stored_key.size()),
+       Store(value),
+       false});
+  return OkStatus();
+}
+
+span<const std::byte> WriteBatch::Store(span<const std::byte> data) {
+  std::byte* const destination = buffer_.data() + buffer_used_;
+  std::copy(data.begin(), data.end(), destination);
+  buffer_used_ += data.size();
+  return span<const std::byte>(destination, data.size());
+}
+
+}  // namespace pw::kvs
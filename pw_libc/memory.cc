@@ -0,0 +1,294 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+// These functions implement memcpy and friends, so the compiler must not turn
+// their loops back into calls to them. Builds pass -fno-builtin; GCC also needs
+// loop pattern distribution disabled.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize("no-tree-loop-distribute-patterns")
+#endif  // defined(__GNUC__) && !defined(__clang__)
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_libc_private/memory.h"
+
+#if defined(__ARM_FEATURE_MVE)
+#include <arm_mve.h>
+#endif  // defined(__ARM_FEATURE_MVE)
+
+namespace pw::libc::internal {
+namespace {
+
+// Memory is accessed in native words: 4 bytes on Arm v7-M, v8-M and RV32.
+using Word = uintptr_t;
+
+// Words that may alias any object, as the functions copy arbitrary memory.
+// These are structs rather than attributed typedefs because attributes on
+// typedefs are dropped when the typedefs are used as template arguments.
+struct __attribute__((__may_alias__)) AlignedWord {
+  Word value;
+};
+
+// A word that may be loaded from any address.
+struct __attribute__((__may_alias__, __packed__)) UnalignedWord {
+  Word value;
+};
+
+constexpr size_t kWordSize = sizeof(Word);
+
+// Eight words are copied per iteration, which matches the eight-register
+// LDM/STM pairs that GCC and Clang emit for Arm.
+constexpr size_t kBlockSize = 8 * kWordSize;
+
+// Below this size, aligning the pointers costs more than word access saves.
+constexpr size_t kMinWordAccessSize = 2 * kWordSize;
+
+// Whether word loads from unaligned addresses are handled by the hardware. Arm
+// v7-M and v8-M Mainline support them. RISC-V cores may trap and emulate them,
+// so misaligned copies use byte access there.
+#if defined(__ARM_FEATURE_UNALIGNED) || defined(__x86_64__) || \
+    defined(__i386__) || defined(__aarch64__)
+constexpr bool kFastUnalignedAccess = true;
+#else
+constexpr bool kFastUnalignedAccess = false;
+#endif
+
+bool IsWordAligned(const void* ptr) {
+  return reinterpret_cast<uintptr_t>(ptr) % kWordSize == 0;
+}
+
+// Copies whole words forward, leaving fewer than kWordSize bytes.
+template <typename SourceWord>
+void CopyWordsForward(unsigned char*& dest,
+                      const unsigned char*& src,
+                      size_t& num_bytes) {
+  auto* d = reinterpret_cast<AlignedWord*>(dest);
+  auto* s = reinterpret_cast<const SourceWord*>(src);
+
+  for (; num_bytes >= kBlockSize; num_bytes -= kBlockSize) {
+    // Load the whole block before storing any of it, which keeps forward
+    // copies correct for overlapping buffers when dest < src.
+    const Word w0 = s[0].value;
+    const Word w1 = s[1].value;
+    const Word w2 = s[2].value;
+    const Word w3 = s[3].value;
+    const Word w4 = s[4].value;
+    const Word w5 = s[5].value;
+    const Word w6 = s[6].value;
+    const Word w7 = s[7].value;
+    d[0].value = w0;
+    d[1].value = w1;
+    d[2].value = w2;
+    d[3].value = w3;
+    d[4].value = w4;
+    d[5].value = w5;
+    d[6].value = w6;
+    d[7].value = w7;
+    s += 8;
+    d += 8;
+  }
+  for (; num_bytes >= kWordSize; num_bytes -= kWordSize) {
+    (d++)->value = (s++)->value;
+  }
+
+  dest = reinterpret_cast<unsigned char*>(d);
+  src = reinterpret_cast<const unsigned char*>(s);
+}
+
+// Copies whole words backward from the ends of the buffers, leaving fewer than
+// kWordSize bytes at their starts.
+template <typename SourceWord>
+void CopyWordsBackward(unsigned char*& dest_end,
+                       const unsigned char*& src_end,
+                       size_t& num_bytes) {
+  auto* d = reinterpret_cast<AlignedWord*>(dest_end);
+  auto* s = reinterpret_cast<const SourceWord*>(src_end);
+
+  for (; num_bytes >= kBlockSize; num_bytes -= kBlockSize) {
+    s -= 8;
+    d -= 8;
+    const Word w0 = s[0].value;
+    const Word w1 = s[1].value;
+    const Word w2 = s[2].value;
+    const Word w3 = s[3].value;
+    const Word w4 = s[4].value;
+    const Word w5 = s[5].value;
+    const Word w6 = s[6].value;
+    const Word w7 = s[7].value;
+    d[0].value = w0;
+    d[1].value = w1;
+    d[2].value = w2;
+    d[3].value = w3;
+    d[4].value = w4;
+    d[5].value = w5;
+    d[6].value = w6;
+    d[7].value = w7;
+  }
+  for (; num_bytes >= kWordSize; num_bytes -= kWordSize) {
+    (--d)->value = (--s)->value;
+  }
+
+  dest_end = reinterpret_cast<unsigned char*>(d);
+  src_end = reinterpret_cast<const unsigned char*>(s);
+}
+
+void CopyForward(unsigned char* dest,
+                 const unsigned char* src,
+                 size_t num_bytes) {
+#if defined(__ARM_FEATURE_MVE)
+  // Helium copies 16 bytes per beat from any address. The tail predicate
+  // handles the final partial vector.
+  while (num_bytes > 0) {
+    const mve_pred16_t predicate = vctp8q(static_cast<uint32_t>(num_bytes));
+    vst1q_p_u8(dest, vld1q_z_u8(src, predicate), predicate);
+    if (num_bytes <= 16) {
+      return;
+    }
+    num_bytes -= 16;
+    dest += 16;
+    src += 16;
+  }
+#else
+  if (num_bytes >= kMinWordAccessSize) {
+    while (!IsWordAligned(dest)) {
+      *dest++ = *src++;
+      num_bytes -= 1;
+    }
+    if (IsWordAligned(src)) {
+      CopyWordsForward<AlignedWord>(dest, src, num_bytes);
+    } else if constexpr (kFastUnalignedAccess) {
+      CopyWordsForward<UnalignedWord>(dest, src, num_bytes);
+    }
+  }
+  while (num_bytes > 0) {
+    *dest++ = *src++;
+    num_bytes -= 1;
+  }
+#endif  // defined(__ARM_FEATURE_MVE)
+}
+
+void CopyBackward(unsigned char* dest,
+                  const unsigned char* src,
+                  size_t num_bytes) {
+  unsigned char* dest_end = dest + num_bytes;
+  const unsigned char* src_end = src + num_bytes;
+
+#if defined(__ARM_FEATURE_MVE)
+  while (num_bytes >= 16) {
+    dest_end -= 16;
+    src_end -= 16;
+    num_bytes -= 16;
+    vst1q_u8(dest_end, vld1q_u8(src_end));
+  }
+  if (num_bytes > 0) {
+    const mve_pred16_t predicate = vctp8q(static_cast<uint32_t>(num_bytes));
+    vst1q_p_u8(dest, vld1q_z_u8(src, predicate), predicate);
+  }
+#else
+  if (num_bytes >= kMinWordAccessSize) {
+    while (!IsWordAligned(dest_end)) {
+      *--dest_end = *--src_end;
+      num_bytes -= 1;
+    }
+    if (IsWordAligned(src_end)) {
+      CopyWordsBackward<AlignedWord>(dest_end, src_end, num_bytes);
+    } else if constexpr (kFastUnalignedAccess) {
+      CopyWordsBackward<UnalignedWord>(dest_end, src_end, num_bytes);
+    }
+  }
+  while (num_bytes > 0) {
+    *--dest_end = *--src_end;
+    num_bytes -= 1;
+  }
+#endif  // defined(__ARM_FEATURE_MVE)
+}
+
+}  // namespace
+
+void* Memcpy(void* dest, const void* src, size_t num_bytes) {
+  CopyForward(static_cast<unsigned char*>(dest),
+              static_cast<const unsigned char*>(src),
+              num_bytes);
+  return dest;
+}
+
+void* Memmove(void* dest, const void* src, size_t num_bytes) {
+  const uintptr_t dest_address = reinterpret_cast<uintptr_t>(dest);
+  const uintptr_t src_address = reinterpret_cast<uintptr_t>(src);
+
+  // Copying forward is safe unless dest starts within src.
+  if (dest_address - src_address >= num_bytes) {
+    CopyForward(static_cast<unsigned char*>(dest),
+                static_cast<const unsigned char*>(src),
+                num_bytes);
+  } else if (dest_address != src_address) {
+    CopyBackward(static_cast<unsigned char*>(dest),
+                 static_cast<const unsigned char*>(src),
+                 num_bytes);
+  }
+  return dest;
+}
+
+void* Memset(void* dest, int value, size_t num_bytes) {
+  auto* d = static_cast<unsigned char*>(dest);
+  const auto byte = static_cast<unsigned char>(value);
+
+#if defined(__ARM_FEATURE_MVE)
+  const uint8x16_t vector = vdupq_n_u8(byte);
+  while (num_bytes > 0) {
+    const mve_pred16_t predicate = vctp8q(static_cast<uint32_t>(num_bytes));
+    vst1q_p_u8(d, vector, predicate);
+    if (num_bytes <= 16) {
+      break;
+    }
+    num_bytes -= 16;
+    d += 16;
+  }
+#else
+  if (num_bytes >= kMinWordAccessSize) {
+    while (!IsWordAligned(d)) {
+      *d++ = byte;
+      num_bytes -= 1;
+    }
+
+    // The byte repeated in every byte of a word.
+    const Word pattern = static_cast<Word>(-1) / 0xff * byte;
+    auto* w = reinterpret_cast<AlignedWord*>(d);
+    for (; num_bytes >= kBlockSize; num_bytes -= kBlockSize) {
+      w[0].value = pattern;
+      w[1].value = pattern;
+      w[2].value = pattern;
+      w[3].value = pattern;
+      w[4].value = pattern;
+      w[5].value = pattern;
+      w[6].value = pattern;
+      w[7].value = pattern;
+      w += 8;
+    }
+    for (; num_bytes >= kWordSize; num_bytes -= kWordSize) {
+      (w++)->value = pattern;
+    }
+    d = reinterpret_cast<unsigned char*>(w);
+  }
+  while (num_bytes > 0) {
+    *d++ = byte;
+    num_bytes -= 1;
+  }
+#endif  // defined(__ARM_FEATURE_MVE)
+  return dest;
+}
+
+}  // namespace pw::libc::internal
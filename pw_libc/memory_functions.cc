@@ -0,0 +1,38 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+// Exports pw_libc's memory functions as the C library's memcpy, memmove and
+// memset. Only link this into firmware that doesn't get these functions from
+// another libc.
+
+#include <cstddef>
+
+#include "pw_libc_private/memory.h"
+
+extern "C" {
+
+void* memcpy(void* dest, const void* src, size_t num_bytes) {
+  return pw::libc::internal::Memcpy(dest, src, num_bytes);
+}
+
+void* memmove(void* dest, const void* src, size_t num_bytes) {
+  return pw::libc::internal::Memmove(dest, src, num_bytes);
+}
+
+void* memset(void* dest, int value, size_t num_bytes) {
+  return pw::libc::internal::Memset(dest, value, num_bytes);
+}
+
+}  // extern "C"
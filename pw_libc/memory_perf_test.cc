@@ -0,0 +1,90 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+// Compares pw_libc's memory functions with those of the toolchain's C library.
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "pw_libc_private/memory.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::libc::internal {
+namespace {
+
+constexpr size_t kMaxSize = 4096;
+
+// Word-aligned buffers, with a spare byte to measure misaligned copies.
+alignas(16) std::array<std::byte, kMaxSize + 1> source;
+alignas(16) std::array<std::byte, kMaxSize + 1> destination;
+
+using MemcpyFunction = void* (*)(void*, const void*, size_t);
+using MemsetFunction = void* (*)(void*, int, size_t);
+
+// Calls through a pointer keep the compiler from inlining the C library's
+// functions as builtins, so both versions are measured as real calls.
+void* LibcMemcpy(void* dest, const void* src, size_t num_bytes) {
+  return std::memcpy(dest, src, num_bytes);
+}
+
+void* LibcMemmove(void* dest, const void* src, size_t num_bytes) {
+  return std::memmove(dest, src, num_bytes);
+}
+
+void* LibcMemset(void* dest, int value, size_t num_bytes) {
+  return std::memset(dest, value, num_bytes);
+}
+
+void CopyTest(perf_test::State& state,
+              size_t size,
+              MemcpyFunction volatile copy,
+              size_t source_offset) {
+  while (state.KeepRunning()) {
+    copy(destination.data(), source.data() + source_offset, size);
+  }
+}
+
+// Moves a block one byte up within a buffer, which copies backwards.
+void MoveOverlappingTest(perf_test::State& state,
+                         size_t size,
+                         MemcpyFunction volatile move) {
+  while (state.KeepRunning()) {
+    move(destination.data() + 1, destination.data(), size);
+  }
+}
+
+void SetTest(perf_test::State& state,
+             size_t size,
+             MemsetFunction volatile set) {
+  while (state.KeepRunning()) {
+    set(destination.data(), 0x5a, size);
+  }
+}
+
+PW_PERF_TEST_RANGE(PwMemcpyAligned, CopyTest, 16, kMaxSize, Memcpy, 0);
+PW_PERF_TEST_RANGE(LibcMemcpyAligned, CopyTest, 16, kMaxSize, LibcMemcpy, 0);
+PW_PERF_TEST_RANGE(PwMemcpyMisaligned, CopyTest, 16, kMaxSize, Memcpy, 1);
+PW_PERF_TEST_RANGE(
+    LibcMemcpyMisaligned, CopyTest, 16, kMaxSize, LibcMemcpy, 1);
+
+PW_PERF_TEST_RANGE(PwMemmove, MoveOverlappingTest, 16, kMaxSize, Memmove);
+PW_PERF_TEST_RANGE(LibcMemmove, MoveOverlappingTest, 16, kMaxSize, LibcMemmove);
+
+PW_PERF_TEST_RANGE(PwMemset, SetTest, 16, kMaxSize, Memset);
+PW_PERF_TEST_RANGE(LibcMemset, SetTest, 16, kMaxSize, LibcMemset);
+
+}  // namespace
+}  // namespace pw::libc::internal
@@ -0,0 +1,148 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+// Tests pw_libc's memcpy, memmove and memset. The functions are called through
+// their internal names so that they can be tested on hosts that link another C
+// library.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_libc_private/memory.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::libc::internal {
+namespace {
+
+// Enough room to cover several eight-word blocks on 64-bit hosts, plus every
+// misalignment of a word.
+constexpr size_t kMaxSize = 200;
+constexpr size_t kMaxOffset = 8;
+constexpr size_t kBufferSize = kMaxSize + 2 * kMaxOffset;
+
+// Avoid 0 so that untouched bytes are distinguishable from cleared ones.
+constexpr unsigned char kSentinel = 0xa5;
+
+struct alignas(16) Buffer {
+  std::array<unsigned char, kBufferSize> bytes;
+};
+
+void FillSentinel(Buffer& buffer) { buffer.bytes.fill(kSentinel); }
+
+void FillPattern(Buffer& buffer) {
+  for (size_t i = 0; i < buffer.bytes.size(); ++i) {
+    buffer.bytes[i] = static_cast<unsigned char>(i * 7 + 1);
+  }
+}
+
+// Checks that only `[offset, offset + size)` of `buffer` was written.
+void ExpectSentinelOutside(const Buffer& buffer, size_t offset, size_t size) {
+  for (size_t i = 0; i < offset; ++i) {
+    ASSERT_EQ(buffer.bytes[i], kSentinel) << "index " << i;
+  }
+  for (size_t i = offset + size; i < buffer.bytes.size(); ++i) {
+    ASSERT_EQ(buffer.bytes[i], kSentinel) << "index " << i;
+  }
+}
+
+TEST(Memcpy, AllSizesAndAlignments) {
+  Buffer src;
+  Buffer dest;
+  FillPattern(src);
+
+  for (size_t dest_offset = 0; dest_offset < kMaxOffset; ++dest_offset) {
+    for (size_t src_offset = 0; src_offset < kMaxOffset; ++src_offset) {
+      for (size_t size = 0; size <= kMaxSize; ++size) {
+        FillSentinel(dest);
+        void* result = Memcpy(&dest.bytes[dest_offset + kMaxOffset],
+                              &src.bytes[src_offset],
+                              size);
+        ASSERT_EQ(result, &dest.bytes[dest_offset + kMaxOffset]);
+        for (size_t i = 0; i < size; ++i) {
+          ASSERT_EQ(dest.bytes[dest_offset + kMaxOffset + i],
+                    src.bytes[src_offset + i]);
+        }
+        ExpectSentinelOutside(dest, dest_offset + kMaxOffset, size);
+      }
+    }
+  }
+}
+
+// Overlapping moves of every size in both directions, at every distance up to
+// a few words.
+TEST(Memmove, OverlappingAllSizesAndAlignments) {
+  Buffer buffer;
+  Buffer expected;
+
+  for (size_t src_offset = 0; src_offset < 2 * kMaxOffset; ++src_offset) {
+    for (size_t dest_offset = 0; dest_offset < 2 * kMaxOffset; ++dest_offset) {
+      for (size_t size = 0; size <= kMaxSize; ++size) {
+        FillPattern(buffer);
+        expected = buffer;
+        for (size_t i = 0; i < size; ++i) {
+          expected.bytes[dest_offset + i] = buffer.bytes[src_offset + i];
+        }
+
+        void* result = Memmove(
+            &buffer.bytes[dest_offset], &buffer.bytes[src_offset], size);
+        ASSERT_EQ(result, &buffer.bytes[dest_offset]);
+        ASSERT_EQ(buffer.bytes, expected.bytes)
+            << "src " << src_offset << ", dest " << dest_offset << ", size "
+            << size;
+      }
+    }
+  }
+}
+
+TEST(Memmove, SameBuffer) {
+  Buffer buffer;
+  FillPattern(buffer);
+  const Buffer expected = buffer;
+
+  EXPECT_EQ(Memmove(buffer.bytes.data(), buffer.bytes.data(), kBufferSize),
+            buffer.bytes.data());
+  EXPECT_EQ(buffer.bytes, expected.bytes);
+}
+
+TEST(Memset, AllSizesAndAlignments) {
+  Buffer buffer;
+
+  for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+    for (size_t size = 0; size <= kMaxSize; ++size) {
+      FillSentinel(buffer);
+      void* result = Memset(&buffer.bytes[offset], 0x3c, size);
+      ASSERT_EQ(result, &buffer.bytes[offset]);
+      for (size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(buffer.bytes[offset + i], 0x3c);
+      }
+      ExpectSentinelOutside(buffer, offset, size);
+    }
+  }
+}
+
+TEST(Memset, UsesLowByteOfValue) {
+  Buffer buffer;
+  FillSentinel(buffer);
+
+  Memset(buffer.bytes.data(), 0x1ff, kMaxSize);
+  for (size_t i = 0; i < kMaxSize; ++i) {
+    ASSERT_EQ(buffer.bytes[i], 0xff);
+  }
+  ExpectSentinelOutside(buffer, 0, kMaxSize);
+}
+
+}  // namespace
+}  // namespace pw::libc::internal
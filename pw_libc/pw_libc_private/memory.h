@@ -0,0 +1,31 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+#pragma once
+
+#include <cstddef>
+
+// Portable implementations of the libc memory functions, tuned for 32-bit
+// microcontrollers. memory_functions.cc exports them as memcpy, memmove and
+// memset; tests and benchmarks call them directly so that they can be compared
+// with the toolchain's libc on any host.
+namespace pw::libc::internal {
+
+void* Memcpy(void* dest, const void* src, size_t num_bytes);
+
+void* Memmove(void* dest, const void* src, size_t num_bytes);
+
+void* Memset(void* dest, int value, size_t num_bytes);
+
+}  // namespace pw::libc::internal
@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <limits>
+
 #include "pw_chrono/system_clock.h"
 #include "pw_log/log.h"
 
@@ -28,6 +31,13 @@
 //              two of the same logs.
 //       msg - Formattable message, same as you would use for PW_LOG or variants
 //
+//   PW_LOG_RATE_LIMITED(level, burst, refill_interval, msg, ...)
+//       level - An integer level as defined by pw_log/levels.h
+//       burst - The number of logs that may be emitted at once.
+//       refill_interval - A std::chrono::duration after which one more log may
+//              be emitted.
+//       msg - Formattable message, same as you would use for PW_LOG or variants
+//
 // Does not check that input parameters have changed to un-suppress logs.
 
 namespace pw::log::internal {
@@ -49,6 +59,28 @@ class RateLimiter {
   chrono::SystemClock::time_point last_timestamp_;
 };
 
+// A token bucket: each log takes a token, and tokens are refilled at a fixed
+// rate up to the burst size. The bucket starts full.
+class TokenBucket {
+ public:
+  struct PollResult {
+    bool log;
+    uint16_t skipped;  // Logs skipped since the last log; saturates.
+  };
+
+  constexpr TokenBucket() = default;
+
+  PollResult Poll(chrono::SystemClock::time_point now,
+                  uint16_t burst,
+                  chrono::SystemClock::duration refill_interval);
+
+ private:
+  bool started_ = false;
+  uint16_t tokens_ = 0;
+  uint16_t skipped_ = 0;
+  chrono::SystemClock::time_point last_refill_;
+};
+
 }  // namespace pw::log::internal
 
 // PW_LOG_EVERY_N_DURATION(level, min_interval_between_logs, msg, ...)
@@ -99,3 +131,48 @@ class RateLimiter {
              static_cast<unsigned>(result.logs_per_s));                     \
     }                                                                       \
   } while (0)
+
+// PW_LOG_RATE_LIMITED(level, burst, refill_interval, msg, ...)
+//
+// Logs a message at the given level, allowing bursts of up to `burst` logs and
+// then at most one log per `refill_interval` on average. Unlike
+// PW_LOG_EVERY_N_DURATION, a short burst of logs is emitted in full.
+//
+// Inputs:
+//    level - An integer level as defined by pw_log/levels.h
+//    burst - The most logs emitted back to back; at least 1
+//    refill_interval - A pw::chrono::SystemClock::duration after which one
+//      more log may be emitted
+//    msg - Formattable message, same as you would use for PW_LOG or variants
+//
+// The first log after logs were skipped includes how many were skipped.
+//
+// NOTE: This macro is NOT threadsafe, like PW_LOG_EVERY_N_DURATION. Each call
+// site has a static 16 byte object on most platforms.
+#define PW_LOG_RATE_LIMITED(level, burst, refill_interval, msg, ...)         \
+  do {                                                                      \
+    static pw::log::internal::TokenBucket token_bucket;                     \
+                                                                            \
+    if (const auto result = token_bucket.Poll(                              \
+            pw::chrono::SystemClock::now(), burst, refill_interval);        \
+        result.log) {                                                       \
+      if (result.skipped == std::numeric_limits<uint16_t>::max()) {         \
+        PW_LOG(level,                                                       \
+               PW_LOG_MODULE_NAME,                                          \
+               PW_LOG_FLAGS,                                                \
+               msg " (skipped %d or more)",                                 \
+               ##__VA_ARGS__,                                               \
+               static_cast<unsigned>(result.skipped));                      \
+      } else if (result.skipped != 0) {                                     \
+        PW_LOG(level,                                                       \
+               PW_LOG_MODULE_NAME,                                          \
+               PW_LOG_FLAGS,                                                \
+               msg " (skipped %d)",                                         \
+               ##__VA_ARGS__,                                               \
+               static_cast<unsigned>(result.skipped));                      \
+      } else {                                                              \
+        PW_LOG(                                                             \
+            level, PW_LOG_MODULE_NAME, PW_LOG_FLAGS, msg, ##__VA_ARGS__);   \
+      }                                                                     \
+    }                                                                       \
+  } while (0)
@@ -48,4 +48,38 @@ RateLimiter::PollResult RateLimiter::Poll(
   return result;
 }
 
-}  // namespace pw::log::internal
\ No newline at end of file
+TokenBucket::PollResult TokenBucket::Poll(
+    chrono::SystemClock::time_point now,
+    uint16_t burst,
+    chrono::SystemClock::duration refill_interval) {
+  if (!started_) {
+    started_ = true;
+    tokens_ = burst;
+    last_refill_ = now;
+  } else if (tokens_ < burst) {
+    const auto refills = (now - last_refill_) / refill_interval;
+    if (refills >= burst - tokens_) {
+      tokens_ = burst;
+      last_refill_ = now;
+    } else if (refills > 0) {
+      tokens_ += static_cast<uint16_t>(refills);
+      last_refill_ += refills * refill_interval;
+    }
+  } else {
+    last_refill_ = now;  // A full bucket does not accumulate time.
+  }
+
+  if (tokens_ == 0) {
+    if (skipped_ < std::numeric_limits<uint16_t>::max()) {
+      skipped_++;
+    }
+    return {.log = false, .skipped = 0};
+  }
+
+  tokens_--;
+  const PollResult result = {.log = true, .skipped = skipped_};
+  skipped_ = 0;
+  return result;
+}
+
+}  // namespace pw::log::internal
@@ -0,0 +1,98 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log/rate_limited.h"
+
+#include <chrono>
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::log::internal {
+namespace {
+
+using Clock = chrono::SystemClock;
+
+constexpr Clock::duration kInterval = Clock::for_at_least(
+    std::chrono::milliseconds(10));
+
+Clock::time_point At(int intervals) {
+  return Clock::time_point(kInterval * intervals);
+}
+
+TEST(TokenBucket, AllowsBurstThenLimits) {
+  TokenBucket bucket;
+  EXPECT_TRUE(bucket.Poll(At(0), 3, kInterval).log);
+  EXPECT_TRUE(bucket.Poll(At(0), 3, kInterval).log);
+  EXPECT_TRUE(bucket.Poll(At(0), 3, kInterval).log);
+  EXPECT_FALSE(bucket.Poll(At(0), 3, kInterval).log);
+  EXPECT_FALSE(bucket.Poll(At(0), 3, kInterval).log);
+}
+
+TEST(TokenBucket, RefillsOverTime) {
+  TokenBucket bucket;
+  EXPECT_TRUE(bucket.Poll(At(0), 2, kInterval).log);
+  EXPECT_TRUE(bucket.Poll(At(0), 2, kInterval).log);
+  EXPECT_FALSE(bucket.Poll(At(0), 2, kInterval).log);
+
+  // One token per interval.
+  EXPECT_TRUE(bucket.Poll(At(1), 2, kInterval).log);
+  EXPECT_FALSE(bucket.Poll(At(1), 2, kInterval).log);
+
+  // Refills stop at the burst size.
+  EXPECT_TRUE(bucket.Poll(At(10), 2, kInterval).log);
+  EXPECT_TRUE(bucket.Poll(At(10), 2, kInterval).log);
+  EXPECT_FALSE(bucket.Poll(At(10), 2, kInterval).log);
+}
+
+TEST(TokenBucket, PartialIntervalsAccumulate) {
+  TokenBucket bucket;
+  EXPECT_TRUE(bucket.Poll(At(0), 1, kInterval * 2).log);
+  EXPECT_FALSE(bucket.Poll(At(1), 1, kInterval * 2).log);
+  EXPECT_TRUE(bucket.Poll(At(2), 1, kInterval * 2).log);
+}
+
+TEST(TokenBucket, CountsSkippedLogs) {
+  TokenBucket bucket;
+  EXPECT_EQ(bucket.Poll(At(0), 1, kInterval).skipped, 0u);
+  EXPECT_FALSE(bucket.Poll(At(0), 1, kInterval).log);
+  EXPECT_FALSE(bucket.Poll(At(0), 1, kInterval).log);
+
+  TokenBucket::PollResult result = bucket.Poll(At(1), 1, kInterval);
+  EXPECT_TRUE(result.log);
+  EXPECT_EQ(result.skipped, 2u);
+
+  result = bucket.Poll(At(2), 1, kInterval);
+  EXPECT_TRUE(result.log);
+  EXPECT_EQ(result.skipped, 0u);
+}
+
+TEST(TokenBucket, SkippedCountSaturates) {
+  TokenBucket bucket;
+  EXPECT_TRUE(bucket.Poll(At(0), 1, kInterval).log);
+  for (uint32_t i = 0; i < 70000; ++i) {
+    EXPECT_FALSE(bucket.Poll(At(0), 1, kInterval).log);
+  }
+  EXPECT_EQ(bucket.Poll(At(1), 1, kInterval).skipped,
+            std::numeric_limits<uint16_t>::max());
+}
+
+TEST(RateLimitedLog, Compiles) {
+  for (int i = 0; i < 3; ++i) {
+    PW_LOG_RATE_LIMITED(PW_LOG_LEVEL_INFO, 2, kInterval, "Message %d", i);
+    PW_LOG_RATE_LIMITED(PW_LOG_LEVEL_INFO, 1, kInterval, "No arguments");
+  }
+}
+
+}  // namespace
+}  // namespace pw::log::internal
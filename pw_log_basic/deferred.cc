@@ -0,0 +1,182 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Captures log messages in a lock-free queue and formats them later, when
+// FormatDeferredLogs() is called.
+
+#include "pw_log_basic/deferred.h"
+
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_log_basic/log_basic.h"
+#include "pw_log_basic_private/config.h"
+#include "pw_span/span.h"
+#include "pw_tokenizer/detokenize.h"
+#include "pw_tokenizer/encode_args.h"
+
+namespace pw::log_basic {
+namespace {
+
+struct DeferredLog {
+  const char* message;
+  const char* module_name;
+  const char* file_name;
+  const char* function_name;
+  int level;
+  int line_number;
+  unsigned int flags;
+  size_t args_size;
+  std::byte args[PW_LOG_BASIC_DEFERRED_ARGS_SIZE];
+};
+
+// A bounded multi-producer, single-consumer queue. Each slot has a sequence
+// number that tells producers and the consumer whose turn it is to use the
+// slot, so producers claim slots with a single compare-and-swap and never wait
+// for each other.
+//
+// Slot i's sequence number is stored relative to i, so that the queue is ready
+// to use when zero-initialized, before static constructors run.
+class DeferredLogQueue {
+ public:
+  static constexpr size_t kSize = PW_LOG_BASIC_DEFERRED_QUEUE_SIZE;
+
+  // Positions wrap around consistently only if the size is a power of two.
+  static_assert(kSize > 0u && (kSize & (kSize - 1)) == 0u,
+                "PW_LOG_BASIC_DEFERRED_QUEUE_SIZE must be a power of two");
+
+  // Claims a slot, calls write(DeferredLog&) to fill it, then makes it
+  // available to the consumer. Returns false if the queue is full.
+  template <typename Function>
+  bool Push(Function&& write) {
+    size_t position = push_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[position % kSize];
+      const ptrdiff_t difference =
+          static_cast<ptrdiff_t>(Sequence(*slot, position) - position);
+      if (difference == 0) {
+        if (push_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;  // The consumer has not read this slot yet.
+      } else {
+        position = push_position_.load(std::memory_order_relaxed);
+      }
+    }
+
+    write(slot->log);
+    SetSequence(*slot, position, position + 1);
+    return true;
+  }
+
+  // Copies the oldest log to the provided log. Returns false if the queue is
+  // empty or the oldest log is still being written.
+  bool Pop(DeferredLog& log) {
+    const size_t position = pop_position_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[position % kSize];
+    if (Sequence(slot, position) != position + 1) {
+      return false;
+    }
+    std::memcpy(&log, &slot.log, sizeof(log));
+    SetSequence(slot, position, position + kSize);
+    pop_position_.store(position + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> relative_sequence;
+    DeferredLog log;
+  };
+
+  size_t Sequence(const Slot& slot, size_t position) const {
+    return slot.relative_sequence.load(std::memory_order_acquire) +
+           position % kSize;
+  }
+
+  void SetSequence(Slot& slot, size_t position, size_t sequence) {
+    slot.relative_sequence.store(sequence - position % kSize,
+                                 std::memory_order_release);
+  }
+
+  Slot slots_[kSize];
+  std::atomic<size_t> push_position_;
+  std::atomic<size_t> pop_position_;
+};
+
+DeferredLogQueue deferred_logs;
+std::atomic<uint32_t> dropped_logs;
+
+}  // namespace
+
+extern "C" void pw_log_basic_Defer(int level,
+                                   unsigned int flags,
+                                   const char* module_name,
+                                   const char* file_name,
+                                   int line_number,
+                                   const char* function_name,
+                                   pw_tokenizer_ArgTypes types,
+                                   const char* message,
+                                   ...) {
+  va_list args;
+  va_start(args, message);
+  const bool pushed = deferred_logs.Push([&](DeferredLog& log) {
+    log.message = message;
+    log.module_name = module_name;
+    log.file_name = file_name;
+    log.function_name = function_name;
+    log.level = level;
+    log.line_number = line_number;
+    log.flags = flags;
+    log.args_size = tokenizer::EncodeArgs(types, args, log.args);
+  });
+  va_end(args);
+
+  if (!pushed) {
+    dropped_logs.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+size_t FormatDeferredLogs(size_t max_logs) {
+  size_t count = 0;
+  DeferredLog log;
+  for (; count < max_logs && deferred_logs.Pop(log); ++count) {
+    const std::string message =
+        tokenizer::FormatString(log.message)
+            .Format(span(reinterpret_cast<const uint8_t*>(log.args),
+                         log.args_size))
+            .value();
+    pw_Log(log.level,
+           log.flags,
+           log.module_name,
+           log.file_name,
+           log.line_number,
+           log.function_name,
+           "%s",
+           message.c_str());
+  }
+  return count;
+}
+
+uint32_t DroppedDeferredLogs() {
+  return dropped_logs.load(std::memory_order_relaxed);
+}
+
+}  // namespace pw::log_basic
@@ -0,0 +1,22 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This override header points to pw_log_basic's deferred formatting backend,
+// which is used instead of the basic backend by selecting
+// pw_log_basic:deferred as the pw_log backend.
+#pragma once
+
+#include "pw_log_basic/deferred.h"
+
+#define PW_HANDLE_LOG PW_LOG_BASIC_DEFER
@@ -0,0 +1,103 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_basic/deferred.h"
+
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "pw_log/levels.h"
+#include "pw_log_basic/log_basic.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::log_basic {
+namespace {
+
+std::string last_log;
+size_t log_count = 0;
+
+void CaptureLog(std::string_view log) {
+  last_log = log;
+  log_count += 1;
+}
+
+bool EndsWith(std::string_view log, std::string_view suffix) {
+  return log.size() >= suffix.size() &&
+         log.substr(log.size() - suffix.size()) == suffix;
+}
+
+class DeferredLog : public ::testing::Test {
+ protected:
+  DeferredLog() {
+    SetOutput(CaptureLog);
+    FormatDeferredLogs();
+    last_log.clear();
+    log_count = 0;
+  }
+};
+
+TEST_F(DeferredLog, FormatsWhenRequested) {
+  PW_LOG_BASIC_DEFER(PW_LOG_LEVEL_INFO, "TST", 0, "Hello, %s!", "world");
+  EXPECT_EQ(log_count, 0u);
+
+  EXPECT_EQ(FormatDeferredLogs(), 1u);
+  EXPECT_EQ(log_count, 1u);
+  EXPECT_TRUE(EndsWith(last_log, "Hello, world!"));
+}
+
+TEST_F(DeferredLog, CopiesArguments) {
+  char name[] = "before";
+  PW_LOG_BASIC_DEFER(
+      PW_LOG_LEVEL_INFO, "TST", 0, "%s %d %c %.1f", name, -5, 'x', 1.5);
+  std::strcpy(name, "after");
+
+  EXPECT_EQ(FormatDeferredLogs(), 1u);
+  EXPECT_TRUE(EndsWith(last_log, "before -5 x 1.5"));
+}
+
+TEST_F(DeferredLog, FormatsInOrder) {
+  PW_LOG_BASIC_DEFER(PW_LOG_LEVEL_INFO, "TST", 0, "%d", 1);
+  PW_LOG_BASIC_DEFER(PW_LOG_LEVEL_INFO, "TST", 0, "%d", 2);
+  PW_LOG_BASIC_DEFER(PW_LOG_LEVEL_INFO, "TST", 0, "%d", 3);
+
+  EXPECT_EQ(FormatDeferredLogs(2), 2u);
+  EXPECT_TRUE(EndsWith(last_log, "2"));
+  EXPECT_EQ(FormatDeferredLogs(), 1u);
+  EXPECT_TRUE(EndsWith(last_log, "3"));
+  EXPECT_EQ(FormatDeferredLogs(), 0u);
+}
+
+TEST_F(DeferredLog, DropsLogsWhenFull) {
+  const uint32_t dropped = DroppedDeferredLogs();
+  int captured = 0;
+  while (DroppedDeferredLogs() == dropped) {
+    PW_LOG_BASIC_DEFER(PW_LOG_LEVEL_INFO, "TST", 0, "Log %d", captured);
+    captured += 1;
+  }
+  captured -= 1;  // The last log was dropped.
+  PW_LOG_BASIC_DEFER(PW_LOG_LEVEL_INFO, "TST", 0, "Dropped");
+  EXPECT_EQ(DroppedDeferredLogs(), dropped + 2);
+
+  EXPECT_EQ(FormatDeferredLogs(), static_cast<size_t>(captured));
+  EXPECT_TRUE(EndsWith(last_log, "Log " + std::to_string(captured - 1)));
+
+  // Space is available again after formatting.
+  PW_LOG_BASIC_DEFER(PW_LOG_LEVEL_INFO, "TST", 0, "Again");
+  EXPECT_EQ(FormatDeferredLogs(), 1u);
+  EXPECT_TRUE(EndsWith(last_log, "Again"));
+}
+
+}  // namespace
+}  // namespace pw::log_basic
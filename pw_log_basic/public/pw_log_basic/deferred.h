@@ -0,0 +1,82 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include "pw_preprocessor/arguments.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_preprocessor/util.h"
+#include "pw_tokenizer/tokenize.h"
+
+PW_EXTERN_C_START
+
+// Captures a log message without formatting it. The format string and other
+// string attributes are stored as pointers, so they must be string literals.
+// The arguments are encoded as described by types, which is produced by
+// PW_TOKENIZER_ARG_TYPES.
+void pw_log_basic_Defer(int level,
+                        unsigned int flags,
+                        const char* module_name,
+                        const char* file_name,
+                        int line_number,
+                        const char* function_name,
+                        pw_tokenizer_ArgTypes types,
+                        const char* message,
+                        ...) PW_PRINTF_FORMAT(8, 9);
+
+PW_EXTERN_C_END
+
+// Log a message with formatting deferred until
+// pw::log_basic::FormatDeferredLogs() is called.
+//
+// Capturing a log copies the arguments into a queue, which costs about as much
+// as encoding a tokenized log. Formatting, which is much slower, happens later
+// in a lower priority context.
+#define PW_LOG_BASIC_DEFER(level, module, flags, message, ...) \
+  do {                                                         \
+    pw_log_basic_Defer((level),                                \
+                       (flags),                                \
+                       module,                                 \
+                       __FILE__,                               \
+                       __LINE__,                               \
+                       __func__,                               \
+                       PW_TOKENIZER_ARG_TYPES(__VA_ARGS__),    \
+                       message PW_COMMA_ARGS(__VA_ARGS__));    \
+  } while (0)
+
+#ifdef __cplusplus
+
+#include <cstddef>
+#include <limits>
+
+namespace pw::log_basic {
+
+// Formats and outputs up to max_logs deferred log messages, oldest first.
+// Messages are output with pw_Log, so they are formatted and sent to the
+// output set with SetOutput just like immediate logs. Returns the number of
+// messages output.
+//
+// Call this from one thread only, such as a low priority logging thread.
+size_t FormatDeferredLogs(
+    size_t max_logs = std::numeric_limits<size_t>::max());
+
+// Returns the number of log messages dropped because the deferred log queue
+// was full.
+uint32_t DroppedDeferredLogs();
+
+}  // namespace pw::log_basic
+
+#endif  // __cplusplus
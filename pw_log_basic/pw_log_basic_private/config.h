@@ -74,3 +74,17 @@
 #ifndef PW_LOG_BASIC_ENTRY_SIZE
 #define PW_LOG_BASIC_ENTRY_SIZE 150
 #endif  // PW_LOG_BASIC_ENTRY_SIZE
+
+// Number of log messages that the deferred formatting backend can hold before
+// they are formatted. Must be a power of two. Log messages captured while the
+// queue is full are dropped.
+#ifndef PW_LOG_BASIC_DEFERRED_QUEUE_SIZE
+#define PW_LOG_BASIC_DEFERRED_QUEUE_SIZE 32
+#endif  // PW_LOG_BASIC_DEFERRED_QUEUE_SIZE
+
+// Maximum size of the encoded arguments of a deferred log message. Arguments
+// that do not fit are dropped and printed as their conversion specifier.
+// String arguments are copied and truncated to fit.
+#ifndef PW_LOG_BASIC_DEFERRED_ARGS_SIZE
+#define PW_LOG_BASIC_DEFERRED_ARGS_SIZE 32
+#endif  // PW_LOG_BASIC_DEFERRED_ARGS_SIZE
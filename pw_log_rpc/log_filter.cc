@@ -51,6 +51,12 @@ bool IsRuleMet(const Filter::Rule& rule,
   return true;
 }
 
+// Returns true if the rule checks more than the log level.
+bool IsConditional(const Filter::Rule& rule) {
+  return rule.any_flags_set != 0 || !rule.module_equals.empty() ||
+         !rule.thread_equals.empty();
+}
+
 }  // namespace
 
 Status Filter::UpdateRulesFromProto(ConstByteSpan buffer) {
@@ -58,6 +64,14 @@ Status Filter::UpdateRulesFromProto(ConstByteSpan buffer) {
     return Status::FailedPrecondition();
   }
 
+  // Rules may be partially updated if decoding fails, so always update the
+  // decisions.
+  const Status status = DecodeRules(buffer);
+  UpdateDecisionTable();
+  return status;
+}
+
+Status Filter::DecodeRules(ConstByteSpan buffer) {
   // Reset rules.
   for (auto& rule : rules_) {
     rule = {};
@@ -105,6 +119,30 @@ Status Filter::UpdateRulesFromProto(ConstByteSpan buffer) {
   return status.IsOutOfRange() ? OkStatus() : status;
 }
 
+void Filter::UpdateDecisionTable() {
+  for (uint32_t level = 0; level < decisions_.size(); ++level) {
+    LevelDecision& decision = decisions_[level];
+    decision = {kNoConditionalRule, false};
+
+    for (size_t i = 0; i < rules_.size(); ++i) {
+      const Rule& rule = rules_[i];
+      if (rule.action == Rule::Action::kInactive ||
+          level < static_cast<uint32_t>(rule.level_greater_than_or_equal)) {
+        continue;
+      }
+      if (IsConditional(rule)) {
+        if (decision.first_conditional_rule == kNoConditionalRule) {
+          decision.first_conditional_rule = static_cast<uint16_t>(i);
+        }
+        continue;
+      }
+      // This rule matches every log at this level, so later rules never apply.
+      decision.drop = rule.action == Rule::Action::kDrop;
+      break;
+    }
+  }
+}
+
 bool Filter::ShouldDropLog(ConstByteSpan entry) const {
   if (rules_.empty()) {
     return false;
@@ -122,6 +160,11 @@ bool Filter::ShouldDropLog(ConstByteSpan entry) const {
       if (decoder.ReadUint32(&log_level).ok()) {
         log_level &= PW_LOG_LEVEL_BITMASK;
       }
+      // Stop decoding if the level alone decides the result.
+      const LevelDecision& decision = decisions_[log_level];
+      if (decision.first_conditional_rule == kNoConditionalRule) {
+        return decision.drop;
+      }
 
     } else if (field_num == LogEntry::Fields::kModule) {
       decoder.ReadBytes(&log_module).IgnoreError();
@@ -134,8 +177,15 @@ bool Filter::ShouldDropLog(ConstByteSpan entry) const {
     }
   }
 
-  // Follow the action of the first rule whose condition is met.
-  for (const auto& rule : rules_) {
+  const LevelDecision& decision = decisions_[log_level];
+  if (decision.first_conditional_rule == kNoConditionalRule) {
+    return decision.drop;
+  }
+
+  // Follow the action of the first rule whose condition is met, starting from
+  // the first rule that could differ from the level's decision.
+  for (size_t i = decision.first_conditional_rule; i < rules_.size(); ++i) {
+    const Rule& rule = rules_[i];
     if (rule.action == Filter::Rule::Action::kInactive) {
       continue;
     }
@@ -718,5 +718,96 @@ TEST(FilterTest, UpdateFilterWithLargeThreadNameFails) {
   EXPECT_EQ(filter.UpdateRulesFromProto(ConstByteSpan(encoder)),
             Status::InvalidArgument());
 }
+
+TEST(FilterTest, LevelOnlyRulesDecideByLevel) {
+  const std::array<Filter::Rule, 3> rules{{
+      {
+          .action = Filter::Rule::Action::kKeep,
+          .level_greater_than_or_equal = FilterRule::Level::INFO_LEVEL,
+          .any_flags_set = 0,
+          .module_equals = {kSampleModuleLittleEndian.begin(),
+                            kSampleModuleLittleEndian.end()},
+          .thread_equals = {},
+      },
+      {
+          .action = Filter::Rule::Action::kKeep,
+          .level_greater_than_or_equal = FilterRule::Level::WARN_LEVEL,
+          .any_flags_set = 0,
+          .module_equals = {},
+          .thread_equals = {},
+      },
+      {
+          .action = Filter::Rule::Action::kDrop,
+          .level_greater_than_or_equal = FilterRule::Level::ANY_LEVEL,
+          .any_flags_set = 0,
+          .module_equals = {},
+          .thread_equals = {},
+      },
+  }};
+  const std::array<std::byte, cfg::kMaxFilterIdBytes> filter_id{
+      std::byte(0xfe), std::byte(0xed), std::byte(0xba), std::byte(0xb1)};
+  const Filter filter(filter_id,
+                      const_cast<std::array<Filter::Rule, 3>&>(rules));
+  constexpr uint32_t kOtherModule = 0x5678;
+
+  std::array<std::byte, 50> buffer;
+  Result<ConstByteSpan> log_entry =
+      EncodeLogEntry<PW_LOG_LEVEL_DEBUG, kSampleModule, kSampleFlags>(
+          kSampleMessage, buffer, kSampleThread);
+  ASSERT_EQ(log_entry.status(), OkStatus());
+  EXPECT_TRUE(filter.ShouldDropLog(log_entry.value()));
+
+  log_entry = EncodeLogEntry<PW_LOG_LEVEL_INFO, kSampleModule, kSampleFlags>(
+      kSampleMessage, buffer, kSampleThread);
+  ASSERT_EQ(log_entry.status(), OkStatus());
+  EXPECT_FALSE(filter.ShouldDropLog(log_entry.value()));
+
+  log_entry = EncodeLogEntry<PW_LOG_LEVEL_INFO, kOtherModule, kSampleFlags>(
+      kSampleMessage, buffer, kSampleThread);
+  ASSERT_EQ(log_entry.status(), OkStatus());
+  EXPECT_TRUE(filter.ShouldDropLog(log_entry.value()));
+
+  log_entry = EncodeLogEntry<PW_LOG_LEVEL_WARN, kOtherModule, kSampleFlags>(
+      kSampleMessage, buffer, kSampleThread);
+  ASSERT_EQ(log_entry.status(), OkStatus());
+  EXPECT_FALSE(filter.ShouldDropLog(log_entry.value()));
+}
+
+TEST(FilterTest, DecisionsFollowRuleUpdates) {
+  const std::array<std::byte, cfg::kMaxFilterIdBytes> filter_id{
+      std::byte(0xfe), std::byte(0xed), std::byte(0xba), std::byte(0xb1)};
+  std::array<Filter::Rule, 2> rules;
+  Filter filter(filter_id, rules);
+
+  std::array<std::byte, 50> buffer;
+  const Result<ConstByteSpan> log_entry_info =
+      EncodeLogEntry<PW_LOG_LEVEL_INFO, kSampleModule, kSampleFlags>(
+          kSampleMessage, buffer, kSampleThread);
+  ASSERT_EQ(log_entry_info.status(), OkStatus());
+  EXPECT_FALSE(filter.ShouldDropLog(log_entry_info.value()));
+
+  // Rules updated from a proto take effect immediately.
+  std::array<Filter::Rule, 1> drop_all_rules{{
+      {
+          .action = Filter::Rule::Action::kDrop,
+          .level_greater_than_or_equal = FilterRule::Level::ANY_LEVEL,
+          .any_flags_set = 0,
+          .module_equals = {},
+          .thread_equals = {},
+      },
+  }};
+  const Filter drop_all_filter(filter_id, drop_all_rules);
+  std::byte filter_buffer[64];
+  const Result<ConstByteSpan> encoded_filter =
+      EncodeFilter(drop_all_filter, filter_buffer);
+  ASSERT_EQ(encoded_filter.status(), OkStatus());
+  ASSERT_EQ(filter.UpdateRulesFromProto(encoded_filter.value()), OkStatus());
+  EXPECT_TRUE(filter.ShouldDropLog(log_entry_info.value()));
+
+  // Rules changed directly take effect after updating the decisions.
+  rules[0].action = Filter::Rule::Action::kKeep;
+  filter.UpdateDecisionTable();
+  EXPECT_FALSE(filter.ShouldDropLog(log_entry_info.value()));
+}
 }  // namespace
 }  // namespace pw::log_rpc
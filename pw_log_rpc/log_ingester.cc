@@ -0,0 +1,246 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/log_ingester.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "pw_base64/base64.h"
+#include "pw_json/builder.h"
+#include "pw_log/levels.h"
+#include "pw_log/proto/log.pwpb.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_status/try.h"
+#include "pw_tokenizer/config.h"
+
+namespace pw::log_rpc {
+namespace {
+
+namespace LogEntries = ::pw::log::pwpb::LogEntries;
+namespace LogEntry = ::pw::log::pwpb::LogEntry;
+
+// Lines are collected and written in chunks of about this size.
+constexpr size_t kWriteChunkSize = 64 * 1024;
+
+constexpr size_t kNoField = std::numeric_limits<size_t>::max();
+
+// Returns the detokenized field, or the field as text if it is not tokenized.
+std::string OptionallyTokenized(ConstByteSpan field,
+                                const tokenizer::DetokenizedString& result) {
+  if (result.ok()) {
+    return result.BestString();
+  }
+
+  const std::string_view text(reinterpret_cast<const char*>(field.data()),
+                              field.size());
+  if (std::all_of(text.begin(), text.end(), [](char c) {
+        return std::isprint(static_cast<unsigned char>(c)) ||
+               std::isspace(static_cast<unsigned char>(c));
+      })) {
+    return std::string(text);
+  }
+
+  // Keep unknown tokens as prefixed Base64, so they can be detokenized later.
+  std::string base64(
+      sizeof(PW_TOKENIZER_NESTED_PREFIX_STR) - 1 +
+          base64::EncodedSize(field.size()),
+      '\0');
+  base64[0] = PW_TOKENIZER_NESTED_PREFIX_STR[0];
+  base64::Encode(field, base64.data() + 1);
+  return base64;
+}
+
+}  // namespace
+
+struct LogIngester::Entry {
+  // Indices of the optionally tokenized fields, or kNoField if not present.
+  size_t message = kNoField;
+  size_t module = kNoField;
+  size_t file = kNoField;
+  size_t thread = kNoField;
+
+  uint32_t line_level = 0;
+  uint32_t flags = 0;
+  std::optional<int64_t> timestamp;
+  std::optional<int64_t> time_since_last_entry;
+  uint64_t dropped = 0;
+  uint32_t sequence_id = 0;
+};
+
+StatusWithSize LogIngester::Ingest(span<const ConstByteSpan> log_entries,
+                                   stream::Writer& output) {
+  // Decode every message first, so that all of the fields in the batch are
+  // detokenized in parallel.
+  std::vector<Entry> entries;
+  std::vector<ConstByteSpan> fields;
+  Status status;
+  for (ConstByteSpan message : log_entries) {
+    status.Update(DecodeLogEntries(message, entries, fields));
+  }
+
+  const std::vector<tokenizer::DetokenizedString> detokenized =
+      batch_.Detokenize(fields);
+
+  std::string chunk;
+  size_t written = 0;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    JsonBuilder json(line_.data(), line_.size());
+    status.Update(WriteEntry(entries[i], fields, detokenized, json));
+    chunk.append(json.data(), json.size());
+    chunk.push_back('\n');
+
+    if (chunk.size() >= kWriteChunkSize || i + 1 == entries.size()) {
+      if (Status write_status = output.Write(as_bytes(span(chunk)));
+          !write_status.ok()) {
+        return StatusWithSize(write_status, written);
+      }
+      written = i + 1;
+      chunk.clear();
+    }
+  }
+  return StatusWithSize(status, written);
+}
+
+Status LogIngester::DecodeLogEntries(ConstByteSpan log_entries,
+                                     std::vector<Entry>& entries,
+                                     std::vector<ConstByteSpan>& fields) {
+  const size_t first_entry = entries.size();
+  uint32_t first_entry_sequence_id = 0;
+
+  protobuf::Decoder decoder(log_entries);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (static_cast<LogEntries::Fields>(decoder.FieldNumber())) {
+      case LogEntries::Fields::kEntries: {
+        ConstByteSpan entry_buffer;
+        PW_TRY(decoder.ReadBytes(&entry_buffer));
+
+        Entry& entry = entries.emplace_back();
+        protobuf::Decoder entry_decoder(entry_buffer);
+        while ((status = entry_decoder.Next()).ok()) {
+          ConstByteSpan field;
+          size_t* field_index = nullptr;
+          switch (static_cast<LogEntry::Fields>(entry_decoder.FieldNumber())) {
+            case LogEntry::Fields::kMessage:
+              field_index = &entry.message;
+              break;
+            case LogEntry::Fields::kModule:
+              field_index = &entry.module;
+              break;
+            case LogEntry::Fields::kFile:
+              field_index = &entry.file;
+              break;
+            case LogEntry::Fields::kThread:
+              field_index = &entry.thread;
+              break;
+            case LogEntry::Fields::kLineLevel:
+              PW_TRY(entry_decoder.ReadUint32(&entry.line_level));
+              break;
+            case LogEntry::Fields::kFlags:
+              PW_TRY(entry_decoder.ReadUint32(&entry.flags));
+              break;
+            case LogEntry::Fields::kTimestamp:
+              PW_TRY(entry_decoder.ReadInt64(&entry.timestamp.emplace()));
+              break;
+            case LogEntry::Fields::kTimeSinceLastEntry:
+              PW_TRY(entry_decoder.ReadInt64(
+                  &entry.time_since_last_entry.emplace()));
+              break;
+            case LogEntry::Fields::kDropped: {
+              uint32_t dropped;
+              PW_TRY(entry_decoder.ReadUint32(&dropped));
+              entry.dropped += dropped;
+              break;
+            }
+          }
+          if (field_index != nullptr) {
+            PW_TRY(entry_decoder.ReadBytes(&field));
+            *field_index = fields.size();
+            fields.push_back(field);
+          }
+        }
+        if (status != Status::OutOfRange()) {
+          return Status::DataLoss();
+        }
+        break;
+      }
+      case LogEntries::Fields::kFirstEntrySequenceId:
+        PW_TRY(decoder.ReadUint32(&first_entry_sequence_id));
+        break;
+    }
+  }
+  if (status != Status::OutOfRange()) {
+    return Status::DataLoss();
+  }
+
+  // The sequence ID may follow the entries, so assign IDs after decoding.
+  const size_t count = entries.size() - first_entry;
+  if (count == 0u) {
+    return OkStatus();
+  }
+  if (next_sequence_id_.has_value() &&
+      *next_sequence_id_ != first_entry_sequence_id) {
+    entries[first_entry].dropped += first_entry_sequence_id - *next_sequence_id_;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    Entry& entry = entries[first_entry + i];
+    entry.sequence_id = first_entry_sequence_id + static_cast<uint32_t>(i);
+    dropped_ += entry.dropped;
+  }
+  next_sequence_id_ = first_entry_sequence_id + static_cast<uint32_t>(count);
+  return OkStatus();
+}
+
+Status LogIngester::WriteEntry(
+    const Entry& entry,
+    span<const ConstByteSpan> fields,
+    span<const tokenizer::DetokenizedString> detokenized,
+    JsonBuilder& json) {
+  auto add_field = [&](JsonObject& object, const char* key, size_t index) {
+    if (index != kNoField) {
+      object.Add(key, OptionallyTokenized(fields[index], detokenized[index]));
+    }
+  };
+
+  JsonObject& object = json.StartObject();
+  if (entry.timestamp.has_value()) {
+    object.Add("timestamp", *entry.timestamp);
+  }
+  if (entry.time_since_last_entry.has_value()) {
+    object.Add("time_since_last_entry", *entry.time_since_last_entry);
+  }
+  object.Add("level", entry.line_level & PW_LOG_LEVEL_BITMASK);
+  if (const uint32_t line = entry.line_level >> PW_LOG_LEVEL_BITS; line != 0u) {
+    object.Add("line", line);
+  }
+  add_field(object, "module", entry.module);
+  add_field(object, "file", entry.file);
+  add_field(object, "thread", entry.thread);
+  if (entry.flags != 0u) {
+    object.Add("flags", entry.flags);
+  }
+  if (entry.dropped != 0u) {
+    object.Add("dropped", entry.dropped);
+  }
+  add_field(object, "message", entry.message);
+  object.Add("sequence_id", entry.sequence_id);
+
+  return json.ok() ? OkStatus() : Status::ResourceExhausted();
+}
+
+}  // namespace pw::log_rpc
@@ -0,0 +1,210 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_log_rpc/log_ingester.h"
+
+#include <array>
+#include <initializer_list>
+#include <string_view>
+
+#include "pw_log/levels.h"
+#include "pw_log/proto/log.pwpb.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::log_rpc {
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+namespace LogEntries = ::pw::log::pwpb::LogEntries;
+namespace LogEntry = ::pw::log::pwpb::LogEntry;
+
+// Database with the following entries:
+// {
+//   0x00000001: "One",
+//   0x000000ff: "Number %d",
+//   0x00000010: "TST",
+// }
+constexpr char kTestDatabase[] =
+    "TOKENS\0\0"
+    "\x03\x00\x00\x00"  // Number of tokens in this database.
+    "\0\0\0\0"
+    "\x01\x00\x00\x00----"
+    "\x10\x00\x00\x00----"
+    "\xFF\x00\x00\x00----"
+    "One\0"
+    "TST\0"
+    "Number %d";
+
+constexpr tokenizer::TokenDatabase kDatabase =
+    tokenizer::TokenDatabase::Create<kTestDatabase>();
+
+struct TestEntry {
+  std::string_view message;
+  int level = PW_LOG_LEVEL_INFO;
+  uint32_t line = 0;
+  std::string_view module = "";
+  uint32_t dropped = 0;
+};
+
+ConstByteSpan EncodeEntry(const TestEntry& entry, ByteSpan buffer) {
+  protobuf::MemoryEncoder encoder(buffer);
+  encoder
+      .WriteBytes(static_cast<uint32_t>(LogEntry::Fields::kMessage),
+                  as_bytes(span(entry.message)))
+      .IgnoreError();
+  encoder
+      .WriteUint32(static_cast<uint32_t>(LogEntry::Fields::kLineLevel),
+                   (entry.line << PW_LOG_LEVEL_BITS) |
+                       static_cast<uint32_t>(entry.level))
+      .IgnoreError();
+  if (entry.dropped != 0u) {
+    encoder
+        .WriteUint32(static_cast<uint32_t>(LogEntry::Fields::kDropped),
+                     entry.dropped)
+        .IgnoreError();
+  }
+  if (!entry.module.empty()) {
+    encoder
+        .WriteBytes(static_cast<uint32_t>(LogEntry::Fields::kModule),
+                    as_bytes(span(entry.module)))
+        .IgnoreError();
+  }
+  EXPECT_EQ(encoder.status(), OkStatus());
+  return ConstByteSpan(encoder);
+}
+
+// Encodes a LogEntries message, with the sequence ID after the entries.
+class LogEntriesMessage {
+ public:
+  LogEntriesMessage(uint32_t first_entry_sequence_id,
+                    std::initializer_list<TestEntry> entries) {
+    protobuf::MemoryEncoder encoder(buffer_);
+    for (const TestEntry& entry : entries) {
+      std::array<std::byte, 64> entry_buffer;
+      encoder
+          .WriteBytes(static_cast<uint32_t>(LogEntries::Fields::kEntries),
+                      EncodeEntry(entry, entry_buffer))
+          .IgnoreError();
+    }
+    encoder
+        .WriteUint32(
+            static_cast<uint32_t>(LogEntries::Fields::kFirstEntrySequenceId),
+            first_entry_sequence_id)
+        .IgnoreError();
+    EXPECT_EQ(encoder.status(), OkStatus());
+    size_ = encoder.size();
+  }
+
+  operator ConstByteSpan() const { return span(buffer_).first(size_); }
+
+ private:
+  std::array<std::byte, 512> buffer_;
+  size_t size_;
+};
+
+std::string_view Text(const stream::MemoryWriter& writer) {
+  return std::string_view(
+      reinterpret_cast<const char*>(writer.WrittenData().data()),
+      writer.WrittenData().size());
+}
+
+class LogIngesterTest : public ::testing::Test {
+ protected:
+  LogIngesterTest()
+      : detokenizer_(tokenizer::Detokenizer::FromSortedDatabase(kDatabase)),
+        ingester_(detokenizer_, 2) {}
+
+  tokenizer::Detokenizer detokenizer_;
+  LogIngester ingester_;
+  stream::MemoryWriterBuffer<1024> output_;
+};
+
+TEST_F(LogIngesterTest, DetokenizesFields) {
+  const LogEntriesMessage message(
+      0,
+      {{.message = "\xFF\x00\x00\x00\x54"sv,
+        .level = PW_LOG_LEVEL_WARN,
+        .line = 123,
+        .module = "\x10\x00\x00\x00"sv}});
+
+  const StatusWithSize result = ingester_.Ingest(message, output_);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 1u);
+  EXPECT_EQ(Text(output_),
+            "{\"level\": 3, \"line\": 123, \"module\": \"TST\", "
+            "\"message\": \"Number 42\", \"sequence_id\": 0}\n");
+}
+
+TEST_F(LogIngesterTest, UntokenizedFields) {
+  const LogEntriesMessage message(
+      7, {{.message = "Plain \"text\""}, {.message = "\x99\x99\x99\x99"sv}});
+
+  const StatusWithSize result = ingester_.Ingest(message, output_);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 2u);
+  EXPECT_EQ(Text(output_),
+            "{\"level\": 2, \"message\": \"Plain \\\"text\\\"\", "
+            "\"sequence_id\": 7}\n"
+            "{\"level\": 2, \"message\": \"$mZmZmQ==\", \"sequence_id\": 8}\n");
+}
+
+TEST_F(LogIngesterTest, BatchKeepsOrder) {
+  const LogEntriesMessage first(0, {{.message = "\x01\x00\x00\x00"sv}});
+  const LogEntriesMessage second(1, {{.message = "\xFF\x00\x00\x00\x02"sv}});
+  const ConstByteSpan messages[] = {first, second};
+
+  const StatusWithSize result = ingester_.Ingest(messages, output_);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 2u);
+  EXPECT_EQ(Text(output_),
+            "{\"level\": 2, \"message\": \"One\", \"sequence_id\": 0}\n"
+            "{\"level\": 2, \"message\": \"Number 1\", \"sequence_id\": 1}\n");
+}
+
+TEST_F(LogIngesterTest, CountsDroppedEntries) {
+  const LogEntriesMessage first(0, {{.message = "a"}, {.message = "b"}});
+  const LogEntriesMessage second(5, {{.message = "c", .dropped = 1}});
+
+  EXPECT_EQ(ingester_.Ingest(first, output_).status(), OkStatus());
+  EXPECT_EQ(ingester_.dropped(), 0u);
+  EXPECT_EQ(ingester_.Ingest(second, output_).status(), OkStatus());
+  EXPECT_EQ(ingester_.dropped(), 4u);
+  EXPECT_TRUE(Text(output_).find("\"dropped\": 4, \"message\": \"c\"") !=
+              std::string_view::npos);
+}
+
+TEST_F(LogIngesterTest, MalformedMessage) {
+  const LogEntriesMessage valid(0, {{.message = "a"}});
+  constexpr std::byte kMalformed[] = {std::byte{0x0a}, std::byte{0x10}};
+  const ConstByteSpan messages[] = {valid, kMalformed};
+
+  const StatusWithSize result = ingester_.Ingest(messages, output_);
+  EXPECT_EQ(result.status(), Status::DataLoss());
+  EXPECT_EQ(result.size(), 1u);
+}
+
+TEST_F(LogIngesterTest, WriteFailure) {
+  const LogEntriesMessage message(0, {{.message = "a"}});
+  stream::MemoryWriterBuffer<8> small_output;
+
+  const StatusWithSize result = ingester_.Ingest(message, small_output);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(result.size(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::log_rpc
@@ -328,6 +328,7 @@ TEST_F(LogServiceTest, HandleDroppedBetweenFilteredOutLogs) {
   // Set filter to drop INFO+ and keep DEBUG logs
   rules1_[0].action = Filter::Rule::Action::kDrop;
   rules1_[0].level_greater_than_or_equal = FilterRule::Level::INFO_LEVEL;
+  filters_[0].UpdateDecisionTable();
 
   // Add log entries.
   const size_t total_entries = 5;
@@ -824,6 +825,7 @@ TEST_F(LogServiceTest, FilterLogs) {
       .any_flags_set = flags,
       .module_equals{module_little_endian.begin(), module_little_endian.end()},
       .thread_equals{kNewThread.begin(), kNewThread.end()}};
+  filters_[1].UpdateDecisionTable();
 
   // Request logs.
   LOG_SERVICE_METHOD_CONTEXT context(drain_map_);
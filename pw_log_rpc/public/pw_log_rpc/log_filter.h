@@ -14,12 +14,15 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 
 #include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
 #include "pw_containers/vector.h"
+#include "pw_log/levels.h"
 #include "pw_log/proto/log.pwpb.h"
 #include "pw_log_rpc/internal/config.h"
 #include "pw_span/span.h"
@@ -57,7 +60,9 @@ class Filter {
 
   Filter(span<const std::byte> id, span<Rule> rules) : rules_(rules) {
     PW_ASSERT(!id.empty());
+    PW_ASSERT(rules.size() <= kNoConditionalRule);
     id_.assign(id.begin(), id.end());
+    UpdateDecisionTable();
   }
 
   // Not copyable.
@@ -71,8 +76,16 @@ class Filter {
   // provided, stopping at the first rule that matches.
   // Returns true when the log should be dropped, false otherwise. Defaults to
   // false if there are no rules, or no rules were matched.
+  //
+  // The decision for each log level is precomputed, so logs whose level alone
+  // decides the result are not checked against any rules.
   bool ShouldDropLog(ConstByteSpan entry) const;
 
+  // Recomputes the per-level decisions from the rules. This is done when the
+  // filter is constructed and when its rules are updated from a proto, and
+  // must be called after modifying the rules directly.
+  void UpdateDecisionTable();
+
   // Decodes and updates the filter's rules given a buffer with a proto-encoded
   // log::Filter message. If there are more rules than this filter can hold, the
   // extra rules are discarded.
@@ -84,8 +97,24 @@ class Filter {
   Status UpdateRulesFromProto(ConstByteSpan buffer);
 
  private:
+  static constexpr uint16_t kNoConditionalRule = UINT16_MAX;
+
+  // The result for logs at one level.
+  struct LevelDecision {
+    // Index of the first active rule for this level that checks the log's
+    // flags, module, or thread, or kNoConditionalRule if the result does not
+    // depend on them.
+    uint16_t first_conditional_rule;
+
+    // The result for logs that no conditional rule matches.
+    bool drop;
+  };
+
+  Status DecodeRules(ConstByteSpan buffer);
+
   Vector<std::byte, cfg::kMaxFilterIdBytes> id_;
   span<Rule> rules_;
+  std::array<LevelDecision, PW_LOG_LEVEL_BITMASK + 1> decisions_;
 };
 
 }  // namespace pw::log_rpc
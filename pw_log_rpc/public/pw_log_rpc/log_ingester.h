@@ -0,0 +1,119 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This file provides the LogIngester class, which converts the LogEntries
+// messages streamed by the log service to JSON Lines on the host. It
+// detokenizes with std::thread, so it is only available on host platforms.
+//
+//   Detokenizer detok = Detokenizer::FromSortedDatabase(database);
+//   LogIngester ingester(detok);
+//
+//   // Called with the payloads of the LogService.Listen stream.
+//   ingester.Ingest(payloads, output_file).IgnoreError();
+//
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "pw_bytes/span.h"
+#include "pw_json/builder.h"
+#include "pw_span/span.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+#include "pw_tokenizer/batch_detokenize.h"
+#include "pw_tokenizer/detokenize.h"
+
+namespace pw::log_rpc {
+
+/// Decodes `LogEntries` messages, detokenizes their optionally tokenized
+/// fields across several threads with a `tokenizer::BatchDetokenizer`, and
+/// writes each log entry as a JSON object on its own line.
+///
+/// Each object has the fields that were present in the entry: `message`,
+/// `level`, `line`, `flags`, `timestamp` or `time_since_last_entry`,
+/// `dropped`, `module`, `file`, and `thread`, plus the entry's `sequence_id`.
+/// Fields that do not detokenize are written as text if they are printable,
+/// and as prefixed Base64 otherwise.
+///
+/// Entries that the device dropped, either as reported in an entry's `dropped`
+/// field or as a gap in sequence IDs between messages, are added to the next
+/// entry's `dropped` field and to `dropped()`.
+class LogIngester {
+ public:
+  /// The maximum size of a JSON line, excluding the newline. Fields that do
+  /// not fit are omitted.
+  static constexpr size_t kMaxLineSize = 4096;
+
+  /// @param[in] detokenizer The `Detokenizer` to use. It must outlive the
+  /// `LogIngester`.
+  ///
+  /// @param[in] threads The maximum number of threads to use for
+  /// detokenizing, including the calling thread. If 0, uses
+  /// `std::thread::hardware_concurrency()`.
+  explicit LogIngester(const tokenizer::Detokenizer& detokenizer,
+                       unsigned threads = 0)
+      : batch_(detokenizer, threads), line_(kMaxLineSize + 1) {}
+
+  /// Decodes a batch of `LogEntries` messages and writes their entries to
+  /// `output` in order. Larger batches are detokenized more efficiently.
+  ///
+  /// @returns @rst
+  /// The number of entries written, with one of these statuses:
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: All entries were written.
+  ///
+  ///    DATA_LOSS: A message could not be decoded. The entries decoded before
+  ///    the error were written.
+  ///
+  ///    RESOURCE_EXHAUSTED: A field did not fit in a JSON line and was
+  ///    omitted.
+  ///
+  /// Errors from `output` are returned as is, and no further entries are
+  /// written.
+  /// @endrst
+  StatusWithSize Ingest(span<const ConstByteSpan> log_entries,
+                        stream::Writer& output);
+
+  /// Decodes a single `LogEntries` message.
+  StatusWithSize Ingest(ConstByteSpan log_entries, stream::Writer& output) {
+    return Ingest(span(&log_entries, 1), output);
+  }
+
+  /// The total number of entries that the device dropped.
+  uint64_t dropped() const { return dropped_; }
+
+ private:
+  struct Entry;
+
+  Status DecodeLogEntries(ConstByteSpan log_entries,
+                          std::vector<Entry>& entries,
+                          std::vector<ConstByteSpan>& fields);
+
+  Status WriteEntry(const Entry& entry,
+                    span<const ConstByteSpan> fields,
+                    span<const tokenizer::DetokenizedString> detokenized,
+                    JsonBuilder& json);
+
+  tokenizer::BatchDetokenizer batch_;
+  std::vector<char> line_;
+  std::optional<uint32_t> next_sequence_id_;
+  uint64_t dropped_ = 0;
+};
+
+}  // namespace pw::log_rpc
@@ -28,6 +28,7 @@
 #include "pw_log/proto/log.pwpb.h"
 #include "pw_log_rpc/internal/config.h"
 #include "pw_log_rpc/log_filter.h"
+#include "pw_metric/metric.h"
 #include "pw_multisink/multisink.h"
 #include "pw_protobuf/serialized_size.h"
 #include "pw_result/result.h"
@@ -60,6 +61,22 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
     kCloseStreamOnWriterError,
   };
 
+  // Configures how Trickle() coalesces entries into packets. If the drain has
+  // not written a packet for max_delay, the link is considered idle and new
+  // entries are sent immediately. Otherwise, entries are held until at least
+  // max_bytes of them are unread or max_delay has passed since the last packet,
+  // so that logs arriving quickly are sent in fewer, fuller packets.
+  //
+  // A max_delay of zero, the default, disables batching.
+  struct BatchConfig {
+    size_t max_bytes = 0;
+    chrono::SystemClock::duration max_delay =
+        chrono::SystemClock::duration::zero();
+  };
+
+  // The number of power-of-two buckets in the histogram of packet sizes.
+  static constexpr size_t kPacketSizeBuckets = 12;
+
   // The minimum buffer size, without the message payload or module sizes,
   // needed to retrieve a log::pwpb::LogEntry from the attached MultiSink. The
   // user must account for the max message size to avoid log entry drops. The
@@ -135,7 +152,8 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
         max_bundles_per_trickle_(max_bundles_per_trickle),
         trickle_delay_(trickle_delay),
         no_writes_until_(chrono::SystemClock::now()),
-        on_open_callback_(nullptr) {
+        on_open_callback_(nullptr),
+        metrics_(channel_id) {
     PW_ASSERT(log_entry_buffer.size_bytes() >= kMinEntryBufferSize);
   }
 
@@ -194,6 +212,23 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
     trickle_delay_ = trickle_delay;
   }
 
+  const BatchConfig& batch_config() const { return batch_config_; }
+  void set_batch_config(const BatchConfig& batch_config) {
+    batch_config_ = batch_config;
+  }
+
+  // Metrics for the packets sent by this drain, in a group named by the
+  // channel ID: the number of packets and entries sent, and a histogram of
+  // the sizes of packets in bytes.
+  metric::Group& metric_group() { return metrics_; }
+  const metric::Group& metric_group() const { return metrics_; }
+
+  uint32_t packets_sent() const { return packets_.value(); }
+  uint32_t entries_sent() const { return entries_.value(); }
+  const metric::Histogram<kPacketSizeBuckets>& packet_sizes() const {
+    return packet_bytes_;
+  }
+
   // Stores a function that is called when Open() is successful. Pass nulltpr to
   // clear it. This is useful in cases where the owner of the drain needs to be
   // notified that the drain was opened.
@@ -205,17 +240,31 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
   enum class LogDrainState {
     kCaughtUp,
     kMoreEntriesRemaining,
+    // The entries were overwritten in the multisink while being encoded, so
+    // the packet must be discarded.
+    kEntriesOverwritten,
   };
 
+  // Returns how long to hold unread entries to batch them with later entries,
+  // or nullopt if they should be sent now.
+  std::optional<chrono::SystemClock::duration> BatchHoldTime(
+      chrono::SystemClock::time_point now) const PW_LOCKS_EXCLUDED(mutex_);
+
   LogDrainState SendLogs(size_t max_num_bundles,
                          ByteSpan encoding_buffer,
                          Status& encoding_status) PW_LOCKS_EXCLUDED(mutex_);
 
-  // Fills the outgoing buffer with as many entries as possible.
+  // Fills the outgoing buffer with as many entries as possible from one batch
+  // of entries peeked from the multisink.
   LogDrainState EncodeOutgoingPacket(
       log::pwpb::LogEntries::MemoryEncoder& encoder,
       uint32_t& packed_entry_count_out) PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Encodes drop messages for all non-zero drop counts, using
+  // log_entry_buffer_. Returns true if any message was encoded.
+  bool EncodeDropMessages(log::pwpb::LogEntries::MemoryEncoder& encoder)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   const uint32_t channel_id_;
   const LogDrainErrorHandling error_handling_;
   rpc::RawServerWriter server_writer_ PW_GUARDED_BY(mutex_);
@@ -232,6 +281,17 @@ class RpcLogDrain : public multisink::MultiSink::Drain {
   pw::chrono::SystemClock::duration trickle_delay_;
   pw::chrono::SystemClock::time_point no_writes_until_;
   pw::Function<void()> on_open_callback_;
+  BatchConfig batch_config_;
+  std::optional<chrono::SystemClock::time_point> last_write_
+      PW_GUARDED_BY(mutex_);
+
+  metric::Group metrics_;
+  PW_METRIC(metrics_, packets_, "packets", 0u);
+  PW_METRIC(metrics_, entries_, "entries", 0u);
+  PW_METRIC_HISTOGRAM(metrics_,
+                      packet_bytes_,
+                      "packet_bytes",
+                      kPacketSizeBuckets);
 };
 
 }  // namespace pw::log_rpc
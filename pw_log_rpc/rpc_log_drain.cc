@@ -14,6 +14,8 @@
 
 #include "pw_log_rpc/rpc_log_drain.h"
 
+#include <array>
+#include <cstring>
 #include <limits>
 #include <mutex>
 #include <optional>
@@ -58,6 +60,22 @@ void TryEncodeDropMessage(
   }
 }
 
+// Returns the entry's data as one span, copying it to the buffer if it wraps
+// around the end of the multisink's buffer.
+ConstByteSpan ContiguousEntry(
+    const multisink::MultiSink::Drain::PeekedEntries::Entry& entry,
+    ByteSpan buffer) {
+  if (entry.data[1].empty()) {
+    return entry.data[0];
+  }
+  PW_DCHECK_UINT_LE(entry.size_bytes(), buffer.size());
+  std::memcpy(buffer.data(), entry.data[0].data(), entry.data[0].size());
+  std::memcpy(buffer.data() + entry.data[0].size(),
+              entry.data[1].data(),
+              entry.data[1].size());
+  return buffer.first(entry.size_bytes());
+}
+
 }  // namespace
 
 Status RpcLogDrain::Open(rpc::RawServerWriter& writer) {
@@ -99,6 +117,12 @@ std::optional<chrono::SystemClock::duration> RpcLogDrain::Trickle(
     return no_writes_until_ - now;
   }
 
+  if (const std::optional<chrono::SystemClock::duration> hold =
+          BatchHoldTime(now);
+      hold.has_value()) {
+    return hold;
+  }
+
   Status encoding_status;
   if (SendLogs(max_bundles_per_trickle_, encoding_buffer, encoding_status) ==
       LogDrainState::kCaughtUp) {
@@ -109,6 +133,28 @@ std::optional<chrono::SystemClock::duration> RpcLogDrain::Trickle(
   return trickle_delay_;
 }
 
+std::optional<chrono::SystemClock::duration> RpcLogDrain::BatchHoldTime(
+    chrono::SystemClock::time_point now) const {
+  if (batch_config_.max_delay == chrono::SystemClock::duration::zero()) {
+    return std::nullopt;
+  }
+  std::lock_guard lock(mutex_);
+  if (!last_write_.has_value()) {
+    return std::nullopt;
+  }
+  // Nothing was sent for max_delay, so the link is idle; don't add latency.
+  const chrono::SystemClock::time_point hold_until =
+      last_write_.value() + batch_config_.max_delay;
+  if (hold_until <= now) {
+    return std::nullopt;
+  }
+  const size_t unread_bytes = GetUnreadEntriesSize();
+  if (unread_bytes == 0 || unread_bytes >= batch_config_.max_bytes) {
+    return std::nullopt;
+  }
+  return hold_until - now;
+}
+
 RpcLogDrain::LogDrainState RpcLogDrain::SendLogs(size_t max_num_bundles,
                                                  ByteSpan encoding_buffer,
                                                  Status& encoding_status_out) {
@@ -128,8 +174,9 @@ RpcLogDrain::LogDrainState RpcLogDrain::SendLogs(size_t max_num_bundles,
     uint32_t packed_entry_count = 0;
     log_sink_state = EncodeOutgoingPacket(encoder, packed_entry_count);
 
-    // Avoid sending empty packets.
-    if (encoder.size() == 0) {
+    // Avoid sending empty packets, or packets with overwritten entries.
+    if (encoder.size() == 0 ||
+        log_sink_state == LogDrainState::kEntriesOverwritten) {
       continue;
     }
 
@@ -138,6 +185,10 @@ RpcLogDrain::LogDrainState RpcLogDrain::SendLogs(size_t max_num_bundles,
     sequence_id_ += packed_entry_count;
     const Status status = server_writer_.Write(encoder);
     sent_bundle_count++;
+    last_write_ = chrono::SystemClock::now();
+    packets_.Increment();
+    entries_.Increment(packed_entry_count);
+    packet_bytes_.Record(static_cast<uint32_t>(encoder.size()));
 
     if (!status.ok() &&
         error_handling_ == LogDrainErrorHandling::kCloseStreamOnWriterError) {
@@ -155,115 +206,160 @@ RpcLogDrain::LogDrainState RpcLogDrain::EncodeOutgoingPacket(
     log::pwpb::LogEntries::MemoryEncoder& encoder,
     uint32_t& packed_entry_count_out) {
   const size_t total_buffer_size = encoder.ConservativeWriteLimit();
+  std::array<multisink::MultiSink::Drain::PeekedEntries::Entry,
+             cfg::kMaxEntriesPerBatch>
+      entries;
   do {
-    // Peek entry and get drop count from multisink.
+    // Save the drop counts, to restore them if the entries are overwritten
+    // while being encoded, since the multisink then reports them as dropped.
+    const uint32_t saved_drop_counts[] = {drop_count_ingress_error_,
+                                          drop_count_slow_drain_,
+                                          drop_count_small_outbound_buffer_,
+                                          drop_count_small_stack_buffer_,
+                                          drop_count_writer_error_};
+
+    // Peek a batch of entries and get drop counts from multisink. Entries take
+    // about as much space in the multisink as in the packet, so peek about a
+    // packet's worth of them.
     uint32_t drop_count = 0;
     uint32_t ingress_drop_count = 0;
-    Result<multisink::MultiSink::Drain::PeekedEntry> possible_entry =
-        PeekEntry(log_entry_buffer_, drop_count, ingress_drop_count);
+    Result<multisink::MultiSink::Drain::PeekedEntries> batch = PeekEntries(
+        entries, total_buffer_size, drop_count, ingress_drop_count);
     drop_count_ingress_error_ += ingress_drop_count;
+    drop_count_slow_drain_ += drop_count;
 
-    // Check if the entry fits in the entry buffer.
-    if (possible_entry.status().IsResourceExhausted()) {
-      ++drop_count_small_stack_buffer_;
+    // Check if the front entry is larger than the entire available buffer, in
+    // which case it was discarded.
+    if (batch.status().IsResourceExhausted()) {
+      ++drop_count_small_outbound_buffer_;
       continue;
     }
 
     // Check if there are any entries left.
-    if (possible_entry.status().IsOutOfRange()) {
-      // Stash multisink's reported drop count that will be reported later with
-      // any other drop counts.
-      drop_count_slow_drain_ += drop_count;
+    if (batch.status().IsOutOfRange()) {
       return LogDrainState::kCaughtUp;  // There are no more entries.
     }
 
     // At this point all expected errors have been handled.
-    PW_CHECK_OK(possible_entry.status());
-
-    // Check if the entry passes any set filter rules.
-    if (filter_ != nullptr &&
-        filter_->ShouldDropLog(possible_entry.value().entry())) {
-      // Add the drop count from the multisink peek, stored in `drop_count`, to
-      // the total drop count. Then drop the entry without counting it towards
-      // the total drop count. Drops will be reported later all together.
-      drop_count_slow_drain_ += drop_count;
-      PW_CHECK_OK(PopEntry(possible_entry.value()));
-      continue;
-    }
+    PW_CHECK_OK(batch.status());
 
-    // Check if the entry fits in the encoder buffer by itself.
-    const size_t encoded_entry_size =
-        possible_entry.value().entry().size() + kLogEntriesEncodeFrameSize;
-    if (encoded_entry_size + kLogEntriesEncodeFrameSize > total_buffer_size) {
-      // Entry is larger than the entire available buffer.
-      ++drop_count_small_outbound_buffer_;
-      PW_CHECK_OK(PopEntry(possible_entry.value()));
-      continue;
-    }
+    size_t handled_entry_count = 0;
+    for (const multisink::MultiSink::Drain::PeekedEntries::Entry& entry :
+         batch.value().entries()) {
+      // Entries that wrap around the end of the multisink's buffer are copied
+      // to log_entry_buffer_, so entries must fit in it.
+      if (entry.size_bytes() > log_entry_buffer_.size()) {
+        ++drop_count_small_stack_buffer_;
+        ++handled_entry_count;
+        continue;
+      }
+      ConstByteSpan log_entry = ContiguousEntry(entry, log_entry_buffer_);
 
-    // At this point, we have a valid entry that may fit in the encode buffer.
-    // Report any drop counts combined reusing the log_entry_buffer_ to encode a
-    // drop message.
-    drop_count_slow_drain_ += drop_count;
-    // Account for dropped entries too large for stack buffer, which PeekEntry()
-    // also reports.
-    drop_count_slow_drain_ -= drop_count_small_stack_buffer_;
-    bool log_entry_buffer_has_valid_entry = possible_entry.ok();
-    if (drop_count_slow_drain_ > 0) {
-      TryEncodeDropMessage(log_entry_buffer_,
-                           std::string_view(kSlowDrainErrorMessage),
-                           drop_count_slow_drain_,
-                           encoder);
-      log_entry_buffer_has_valid_entry = false;
-    }
-    if (drop_count_ingress_error_ > 0) {
-      TryEncodeDropMessage(log_entry_buffer_,
-                           std::string_view(kIngressErrorMessage),
-                           drop_count_ingress_error_,
-                           encoder);
-      log_entry_buffer_has_valid_entry = false;
-    }
-    if (drop_count_small_stack_buffer_ > 0) {
-      TryEncodeDropMessage(log_entry_buffer_,
-                           std::string_view(kSmallStackBufferErrorMessage),
-                           drop_count_small_stack_buffer_,
-                           encoder);
-      log_entry_buffer_has_valid_entry = false;
-    }
-    if (drop_count_small_outbound_buffer_ > 0) {
-      TryEncodeDropMessage(log_entry_buffer_,
-                           std::string_view(kSmallOutboundBufferErrorMessage),
-                           drop_count_small_outbound_buffer_,
-                           encoder);
-      log_entry_buffer_has_valid_entry = false;
-    }
-    if (drop_count_writer_error_ > 0) {
-      TryEncodeDropMessage(log_entry_buffer_,
-                           std::string_view(kWriterErrorMessage),
-                           drop_count_writer_error_,
-                           encoder);
-      log_entry_buffer_has_valid_entry = false;
+      // Check if the entry passes any set filter rules. Filtered entries are
+      // not counted towards the total drop count.
+      if (filter_ != nullptr && filter_->ShouldDropLog(log_entry)) {
+        ++handled_entry_count;
+        continue;
+      }
+
+      // Check if the entry fits in the encoder buffer by itself.
+      const size_t encoded_entry_size =
+          log_entry.size() + kLogEntriesEncodeFrameSize;
+      if (encoded_entry_size + kLogEntriesEncodeFrameSize > total_buffer_size) {
+        // Entry is larger than the entire available buffer.
+        ++drop_count_small_outbound_buffer_;
+        ++handled_entry_count;
+        continue;
+      }
+
+      // At this point, we have a valid entry that may fit in the encode
+      // buffer. Report any drop counts first, which reuses the
+      // log_entry_buffer_.
+      if (EncodeDropMessages(encoder)) {
+        log_entry = ContiguousEntry(entry, log_entry_buffer_);
+      }
+
+      // Check if the entry fits in the partially filled encoder buffer.
+      if (encoded_entry_size > encoder.ConservativeWriteLimit()) {
+        break;
+      }
+
+      PW_CHECK_OK(encoder.WriteBytes(
+          static_cast<uint32_t>(log::pwpb::LogEntries::Fields::kEntries),
+          log_entry));
+      ++handled_entry_count;
+      ++packed_entry_count_out;
     }
-    if (possible_entry.ok() && !log_entry_buffer_has_valid_entry) {
-      PW_CHECK_OK(PeekEntry(log_entry_buffer_, drop_count, ingress_drop_count)
-                      .status());
+
+    // Remove the handled entries from the multisink, which also checks that
+    // they were not overwritten while being encoded.
+    const Status pop_status = PopEntries(batch.value(), handled_entry_count);
+    if (!pop_status.ok()) {
+      PW_CHECK(pop_status.IsDataLoss());
+      drop_count_ingress_error_ = saved_drop_counts[0];
+      drop_count_slow_drain_ = saved_drop_counts[1];
+      drop_count_small_outbound_buffer_ = saved_drop_counts[2];
+      drop_count_small_stack_buffer_ = saved_drop_counts[3];
+      drop_count_writer_error_ = saved_drop_counts[4];
+      packed_entry_count_out = 0;
+      if (encoder.size() != 0) {
+        return LogDrainState::kEntriesOverwritten;
+      }
+      continue;
     }
 
-    // Check if the entry fits in the partially filled encoder buffer.
-    if (encoded_entry_size > encoder.ConservativeWriteLimit()) {
+    // Each packet is filled from a single batch, so that the packet can be
+    // discarded as a whole if the batch is overwritten. Only peek the next
+    // batch if every entry in this one was dropped.
+    if (encoder.size() != 0 ||
+        handled_entry_count < batch.value().entries().size()) {
       // Notify the caller there are more entries to send.
       return LogDrainState::kMoreEntriesRemaining;
     }
-
-    // Encode the entry and remove it from multisink.
-    PW_CHECK_OK(encoder.WriteBytes(
-        static_cast<uint32_t>(log::pwpb::LogEntries::Fields::kEntries),
-        possible_entry.value().entry()));
-    PW_CHECK_OK(PopEntry(possible_entry.value()));
-    ++packed_entry_count_out;
   } while (true);
 }
 
+bool RpcLogDrain::EncodeDropMessages(
+    log::pwpb::LogEntries::MemoryEncoder& encoder) {
+  bool encoded = false;
+  if (drop_count_slow_drain_ > 0) {
+    TryEncodeDropMessage(log_entry_buffer_,
+                         std::string_view(kSlowDrainErrorMessage),
+                         drop_count_slow_drain_,
+                         encoder);
+    encoded = true;
+  }
+  if (drop_count_ingress_error_ > 0) {
+    TryEncodeDropMessage(log_entry_buffer_,
+                         std::string_view(kIngressErrorMessage),
+                         drop_count_ingress_error_,
+                         encoder);
+    encoded = true;
+  }
+  if (drop_count_small_stack_buffer_ > 0) {
+    TryEncodeDropMessage(log_entry_buffer_,
+                         std::string_view(kSmallStackBufferErrorMessage),
+                         drop_count_small_stack_buffer_,
+                         encoder);
+    encoded = true;
+  }
+  if (drop_count_small_outbound_buffer_ > 0) {
+    TryEncodeDropMessage(log_entry_buffer_,
+                         std::string_view(kSmallOutboundBufferErrorMessage),
+                         drop_count_small_outbound_buffer_,
+                         encoder);
+    encoded = true;
+  }
+  if (drop_count_writer_error_ > 0) {
+    TryEncodeDropMessage(log_entry_buffer_,
+                         std::string_view(kWriterErrorMessage),
+                         drop_count_writer_error_,
+                         encoder);
+    encoded = true;
+  }
+  return encoded;
+}
+
 Status RpcLogDrain::Close() {
   std::lock_guard lock(mutex_);
   return server_writer_.Finish();
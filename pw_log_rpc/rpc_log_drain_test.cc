@@ -412,6 +412,103 @@ TEST_F(TrickleTest, LimitedFlushOverflowsToNextPayload) {
   EXPECT_EQ(entries_count, 3u);
 }
 
+TEST_F(TrickleTest, BatchingSendsImmediatelyWhenIdle) {
+  AttachDrain();
+  OpenWriter();
+  EXPECT_EQ(drains_[0].Open(writer_), OkStatus());
+  drains_[0].set_batch_config({.max_bytes = kDrainEncodeBufferSize * 4,
+                               .max_delay = std::chrono::hours(1)});
+
+  AddLogEntry(BasicLog("First"));
+  EXPECT_FALSE(drains_[0].Trickle(channel_encode_buffer_).has_value());
+  EXPECT_EQ(
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId).size(),
+      1u);
+}
+
+TEST_F(TrickleTest, BatchingHoldsEntriesAfterRecentWrite) {
+  AttachDrain();
+  OpenWriter();
+  EXPECT_EQ(drains_[0].Open(writer_), OkStatus());
+  drains_[0].set_batch_config({.max_bytes = kDrainEncodeBufferSize * 4,
+                               .max_delay = std::chrono::hours(1)});
+
+  AddLogEntry(BasicLog("First"));
+  EXPECT_FALSE(drains_[0].Trickle(channel_encode_buffer_).has_value());
+
+  // A packet was just sent, so the next entry is held for more entries.
+  AddLogEntry(BasicLog("Second"));
+  std::optional<chrono::SystemClock::duration> min_delay =
+      drains_[0].Trickle(channel_encode_buffer_);
+  ASSERT_TRUE(min_delay.has_value());
+  EXPECT_GT(min_delay.value(), chrono::SystemClock::duration::zero());
+  EXPECT_LE(min_delay.value(),
+            chrono::SystemClock::duration(std::chrono::hours(1)));
+  EXPECT_EQ(
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId).size(),
+      1u);
+
+  // Flush() sends held entries regardless of batching.
+  EXPECT_EQ(drains_[0].Flush(channel_encode_buffer_), OkStatus());
+  EXPECT_EQ(
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId).size(),
+      2u);
+}
+
+TEST_F(TrickleTest, BatchingSendsWhenByteBudgetReached) {
+  AttachDrain();
+  OpenWriter();
+  EXPECT_EQ(drains_[0].Open(writer_), OkStatus());
+  drains_[0].set_batch_config({.max_bytes = kDrainEncodeBufferSize,
+                               .max_delay = std::chrono::hours(1)});
+
+  AddLogEntry(BasicLog("First"));
+  EXPECT_FALSE(drains_[0].Trickle(channel_encode_buffer_).has_value());
+
+  AddLogEntry(BasicLog("Use longer logs in this test"));
+  EXPECT_TRUE(drains_[0].Trickle(channel_encode_buffer_).has_value());
+
+  AddLogEntry(BasicLog("I'm hungry, what's for dinner?"));
+  EXPECT_FALSE(drains_[0].Trickle(channel_encode_buffer_).has_value());
+
+  rpc::PayloadsView payloads =
+      output_.payloads<log::pw_rpc::raw::Logs::Listen>(kDrainChannelId);
+  ASSERT_EQ(payloads.size(), 2u);
+  uint32_t drop_count = 0;
+  size_t entries_count = 0;
+  protobuf::Decoder payload_decoder(payloads[1]);
+  VerifyLogEntries(payload_decoder,
+                   Vector<TestLogEntry, 2>{
+                       BasicLog("Use longer logs in this test"),
+                       BasicLog("I'm hungry, what's for dinner?")},
+                   1,
+                   entries_count,
+                   drop_count);
+  EXPECT_EQ(entries_count, 2u);
+}
+
+TEST_F(TrickleTest, MetricsCountPacketsAndEntries) {
+  AttachDrain();
+  OpenWriter();
+  EXPECT_EQ(drains_[0].Open(writer_), OkStatus());
+
+  AddLogEntries(Vector<TestLogEntry, 3>{
+      BasicLog(":D"), BasicLog("A useful log"), BasicLog("blink")});
+  EXPECT_FALSE(drains_[0].Trickle(channel_encode_buffer_).has_value());
+  AddLogEntry(BasicLog("Another"));
+  EXPECT_FALSE(drains_[0].Trickle(channel_encode_buffer_).has_value());
+
+  EXPECT_EQ(drains_[0].packets_sent(), 2u);
+  EXPECT_EQ(drains_[0].entries_sent(), 4u);
+  EXPECT_EQ(drains_[0].metric_group().name(), kDrainChannelId);
+
+  uint32_t packets_in_histogram = 0;
+  for (size_t i = 0; i < RpcLogDrain::kPacketSizeBuckets; ++i) {
+    packets_in_histogram += drains_[0].packet_sizes().count(i);
+  }
+  EXPECT_EQ(packets_in_histogram, 2u);
+}
+
 TEST(RpcLogDrain, OnOpenCallbackCalled) {
   // Create drain and log components.
   const uint32_t drain_id = 1;
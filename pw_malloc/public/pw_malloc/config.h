@@ -101,3 +101,17 @@ static_assert(((PW_MALLOC_MIN_BUCKET_SIZE - 1) & PW_MALLOC_MIN_BUCKET_SIZE) ==
 /// Defaults to 2KiB.
 #define PW_MALLOC_DUAL_FIRST_FIT_THRESHOLD 2048
 #endif  // PW_MALLOC_DUAL_FIRST_FIT_THRESHOLD
+
+#ifndef PW_MALLOC_TLSF_NUM_FIRST_LEVELS
+/// Sets the number of first-level size classes used by a
+/// `pw::allocator::TlsfBlockAllocator`.
+///
+/// Each first level covers twice the range of sizes of the one before it.
+/// Free blocks larger than those covered by the first levels are kept in a
+/// single size class that is searched linearly.
+///
+/// See also `pw::allocator::TlsfBlockAllocator`.
+///
+/// Must be between 2 and 32. Defaults to 16.
+#define PW_MALLOC_TLSF_NUM_FIRST_LEVELS 16
+#endif  // PW_MALLOC_TLSF_NUM_FIRST_LEVELS
@@ -36,3 +36,5 @@ struct TestMetrics {
 #define PW_MALLOC_MIN_BUCKET_SIZE 64
 
 #define PW_MALLOC_NUM_BUCKETS 4
+
+#define PW_MALLOC_TLSF_NUM_FIRST_LEVELS 8
@@ -43,6 +43,55 @@ struct Base64EncodedToken {
   std::array<char, 16> data;
 };
 
+// Defines the tokenized name of a histogram bucket.
+#define _PW_METRIC_BUCKET_NAME(index, name) \
+  constexpr Token kBucket##index =          \
+      PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, name)
+
+_PW_METRIC_BUCKET_NAME(0, "0");
+_PW_METRIC_BUCKET_NAME(1, "1");
+_PW_METRIC_BUCKET_NAME(2, "2");
+_PW_METRIC_BUCKET_NAME(3, "4");
+_PW_METRIC_BUCKET_NAME(4, "8");
+_PW_METRIC_BUCKET_NAME(5, "16");
+_PW_METRIC_BUCKET_NAME(6, "32");
+_PW_METRIC_BUCKET_NAME(7, "64");
+_PW_METRIC_BUCKET_NAME(8, "128");
+_PW_METRIC_BUCKET_NAME(9, "256");
+_PW_METRIC_BUCKET_NAME(10, "512");
+_PW_METRIC_BUCKET_NAME(11, "1024");
+_PW_METRIC_BUCKET_NAME(12, "2048");
+_PW_METRIC_BUCKET_NAME(13, "4096");
+_PW_METRIC_BUCKET_NAME(14, "8192");
+_PW_METRIC_BUCKET_NAME(15, "16384");
+_PW_METRIC_BUCKET_NAME(16, "32768");
+_PW_METRIC_BUCKET_NAME(17, "65536");
+_PW_METRIC_BUCKET_NAME(18, "131072");
+_PW_METRIC_BUCKET_NAME(19, "262144");
+_PW_METRIC_BUCKET_NAME(20, "524288");
+_PW_METRIC_BUCKET_NAME(21, "1048576");
+_PW_METRIC_BUCKET_NAME(22, "2097152");
+_PW_METRIC_BUCKET_NAME(23, "4194304");
+_PW_METRIC_BUCKET_NAME(24, "8388608");
+_PW_METRIC_BUCKET_NAME(25, "16777216");
+_PW_METRIC_BUCKET_NAME(26, "33554432");
+_PW_METRIC_BUCKET_NAME(27, "67108864");
+_PW_METRIC_BUCKET_NAME(28, "134217728");
+_PW_METRIC_BUCKET_NAME(29, "268435456");
+_PW_METRIC_BUCKET_NAME(30, "536870912");
+_PW_METRIC_BUCKET_NAME(31, "1073741824");
+_PW_METRIC_BUCKET_NAME(32, "2147483648");
+
+#undef _PW_METRIC_BUCKET_NAME
+
+constexpr std::array<Token, kMaxHistogramBuckets> kBucketNames = {
+    kBucket0,  kBucket1,  kBucket2,  kBucket3,  kBucket4,  kBucket5,  kBucket6,
+    kBucket7,  kBucket8,  kBucket9,  kBucket10, kBucket11, kBucket12, kBucket13,
+    kBucket14, kBucket15, kBucket16, kBucket17, kBucket18, kBucket19, kBucket20,
+    kBucket21, kBucket22, kBucket23, kBucket24, kBucket25, kBucket26, kBucket27,
+    kBucket28, kBucket29, kBucket30, kBucket31, kBucket32,
+};
+
 const char* Indent(int level) {
   static const char* kWhitespace8 = "        ";
   level = std::min(level, 4);
@@ -51,6 +100,11 @@ const char* Indent(int level) {
 
 }  // namespace
 
+Token internal::HistogramBucketName(size_t bucket) {
+  PW_DCHECK_UINT_LT(bucket, kBucketNames.size());
+  return kBucketNames[bucket];
+}
+
 // Enable easier registration when used as a member.
 Metric::Metric(Token name, float value, IntrusiveList<Metric>& metrics)
     : Metric(name, value) {
@@ -63,36 +117,48 @@ Metric::Metric(Token name, uint32_t value, IntrusiveList<Metric>& metrics)
 
 float Metric::as_float() const {
   PW_DCHECK(is_float());
-  return float_;
+  return float_.load(std::memory_order_relaxed);
 }
 
 uint32_t Metric::as_int() const {
   PW_DCHECK(is_int());
-  return uint_;
+  return uint_.load(std::memory_order_relaxed);
 }
 
 void Metric::Increment(uint32_t amount) {
   PW_DCHECK(is_int());
-  if (PW_ADD_OVERFLOW(uint_, amount, &uint_)) {
-    uint_ = std::numeric_limits<uint32_t>::max();
-  }
+  uint32_t value = uint_.load(std::memory_order_relaxed);
+  uint32_t sum;
+  do {
+    if (PW_ADD_OVERFLOW(value, amount, &sum)) {
+      sum = std::numeric_limits<uint32_t>::max();
+    }
+  } while (!uint_.compare_exchange_weak(
+      value, sum, std::memory_order_relaxed, std::memory_order_relaxed));
 }
 
 void Metric::Decrement(uint32_t amount) {
   PW_DCHECK(is_int());
-  if (PW_SUB_OVERFLOW(uint_, amount, &uint_)) {
-    uint_ = 0;
-  }
+  uint32_t value = uint_.load(std::memory_order_relaxed);
+  uint32_t difference;
+  do {
+    if (PW_SUB_OVERFLOW(value, amount, &difference)) {
+      difference = 0;
+    }
+  } while (!uint_.compare_exchange_weak(value,
+                                        difference,
+                                        std::memory_order_relaxed,
+                                        std::memory_order_relaxed));
 }
 
 void Metric::SetInt(uint32_t value) {
   PW_DCHECK(is_int());
-  uint_ = value;
+  uint_.store(value, std::memory_order_relaxed);
 }
 
 void Metric::SetFloat(float value) {
   PW_DCHECK(is_float());
-  float_ = value;
+  float_.store(value, std::memory_order_relaxed);
 }
 
 void Metric::Dump(int level) {
@@ -22,6 +22,7 @@
 #include "pw_metric_private/metric_walker.h"
 #include "pw_metric_proto/metric_service.pwpb.h"
 #include "pw_preprocessor/util.h"
+#include "pw_protobuf/decoder.h"
 #include "pw_rpc/raw/server_reader_writer.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
@@ -89,11 +90,90 @@ class PwpbMetricWriter : public virtual internal::MetricWriter {
   proto::pwpb::MetricRequest::MemoryEncoder encoder_;
   size_t metrics_count = 0;
 };
+
+using RequestPaths =
+    Vector<internal::MetricPath, MetricService::kMaxRequestPaths>;
+
+// Decodes a token path, which may be packed or not.
+Status DecodeTokenPath(ConstByteSpan metric, internal::MetricPath& path) {
+  protobuf::Decoder decoder(metric);
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() !=
+        static_cast<uint32_t>(proto::pwpb::Metric::Fields::kTokenPath)) {
+      continue;
+    }
+    uint32_t token;
+    if (decoder.ReadFixed32(&token).ok()) {
+      if (path.full()) {
+        return Status::InvalidArgument();
+      }
+      path.push_back(token);
+      continue;
+    }
+
+    ConstByteSpan packed;
+    PW_TRY(decoder.ReadBytes(&packed));
+    if (packed.size() % sizeof(token) != 0u ||
+        packed.size() / sizeof(token) > path.max_size() - path.size()) {
+      return Status::InvalidArgument();
+    }
+    for (; !packed.empty(); packed = packed.subspan(sizeof(token))) {
+      std::memcpy(&token, packed.data(), sizeof(token));
+      path.push_back(token);
+    }
+  }
+  return OkStatus();
+}
+
+Status DecodeRequest(ConstByteSpan request,
+                     RequestPaths& paths,
+                     bool& changed_only) {
+  protobuf::Decoder decoder(request);
+  while (decoder.Next().ok()) {
+    switch (decoder.FieldNumber()) {
+      case static_cast<uint32_t>(
+          proto::pwpb::MetricRequest::Fields::kMetrics): {
+        ConstByteSpan metric;
+        PW_TRY(decoder.ReadBytes(&metric));
+        if (paths.full()) {
+          return Status::ResourceExhausted();
+        }
+        paths.emplace_back();
+        PW_TRY(DecodeTokenPath(metric, paths.back()));
+        break;
+      }
+      case static_cast<uint32_t>(
+          proto::pwpb::MetricRequest::Fields::kChangedOnly):
+        PW_TRY(decoder.ReadBool(&changed_only));
+        break;
+    }
+  }
+  return OkStatus();
+}
+
 }  // namespace
 
-void MetricService::Get(ConstByteSpan /*request*/,
+void MetricService::Get(ConstByteSpan request,
                         rpc::RawServerWriter& raw_response) {
-  // For now, ignore the request and just stream all the metrics back.
+  RequestPaths paths;
+  bool changed_only = false;
+  if (Status status = DecodeRequest(request, paths, changed_only);
+      !status.ok()) {
+    raw_response.Finish(status).IgnoreError();
+    return;
+  }
+
+  // The snapshot only describes the metrics if their number is unchanged.
+  // Unless every metric is requested, only update a snapshot that describes
+  // the metrics, so that it never holds values that were not sent.
+  internal::MetricCounter counter;
+  internal::MetricWalker counter_walker(counter);
+  counter_walker.Walk(metrics_).IgnoreError();
+  counter_walker.Walk(groups_).IgnoreError();
+  const bool snapshot_valid =
+      snapshot_metrics_ != 0u && snapshot_metrics_ == counter.count();
+  const bool update_snapshot = snapshot_valid || paths.empty();
+
   // TODO(amontanez): Make this follow the metric_service.options configuration.
   constexpr size_t kSizeOfOneMetric =
       pw::metric::proto::pwpb::MetricResponse::kMaxEncodedSizeBytes +
@@ -103,7 +183,11 @@ void MetricService::Get(ConstByteSpan /*request*/,
   std::array<std::byte, kEncodeBufferSize> encode_buffer;
 
   PwpbMetricWriter writer(encode_buffer, raw_response);
-  internal::MetricWalker walker(writer);
+  internal::MetricFilter filter(writer,
+                                paths,
+                                update_snapshot ? snapshot_ : span<uint32_t>(),
+                                changed_only && snapshot_valid);
+  internal::MetricWalker walker(filter);
 
   // This will stream all the metrics in the span of this Get() method call.
   // This will have the effect of blocking the RPC thread until all the metrics
@@ -118,6 +202,12 @@ void MetricService::Get(ConstByteSpan /*request*/,
   status.Update(walker.Walk(metrics_));
   status.Update(walker.Walk(groups_));
   status.Update(writer.Flush());
+
+  if (!status.ok()) {
+    snapshot_metrics_ = 0;  // Metrics may have been recorded but not sent.
+  } else if (paths.empty()) {
+    snapshot_metrics_ = snapshot_.empty() ? 0 : counter.count();
+  }
   raw_response.Finish(status).IgnoreError();
 }
 }  // namespace pw::metric
@@ -74,6 +74,15 @@ size_t GetMetricsSum(ConstByteSpan serialized_metric_buffer) {
   return metrics_sum;
 }
 
+size_t GetTotalMetrics(const PW_RAW_TEST_METHOD_CONTEXT(MetricService, Get) &
+                       ctx) {
+  size_t total = 0;
+  for (ConstByteSpan response : ctx.responses()) {
+    total += CountEncodedMetrics(response);
+  }
+  return total;
+}
+
 TEST(MetricService, EmptyGroupAndNoMetrics) {
   // Empty root group.
   PW_METRIC_GROUP(root, "/");
@@ -214,5 +223,122 @@ TEST(MetricService, NestedGroupsWithBatches) {
                 GetMetricsSum(ctx.responses()[3]));
 }
 
+TEST(MetricService, RequestSelectsPaths) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+
+  PW_METRIC_GROUP(inner, "inner");
+  PW_METRIC(inner, x, "x", 4u);
+  PW_METRIC(inner, y, "y", 8u);
+  root.Add(inner);
+
+  // Select the inner group and the "b" metric.
+  std::array<std::byte, 64> request_buffer;
+  proto::pwpb::MetricRequest::MemoryEncoder request(request_buffer);
+  {
+    const Token inner_path[] = {inner.name()};
+    proto::pwpb::Metric::StreamEncoder path = request.GetMetricsEncoder();
+    ASSERT_EQ(OkStatus(), path.WriteTokenPath(inner_path));
+  }
+  {
+    const Token b_path[] = {b.name()};
+    proto::pwpb::Metric::StreamEncoder path = request.GetMetricsEncoder();
+    ASSERT_EQ(OkStatus(), path.WriteTokenPath(b_path));
+  }
+  ASSERT_EQ(OkStatus(), request.status());
+
+  PW_RAW_TEST_METHOD_CONTEXT(MetricService, Get)
+  ctx{root.metrics(), root.children()};
+  ctx.call(ConstByteSpan(request));
+  EXPECT_TRUE(ctx.done());
+  EXPECT_EQ(OkStatus(), ctx.status());
+
+  ASSERT_EQ(1u, ctx.responses().size());
+  EXPECT_EQ(3u, CountEncodedMetrics(ctx.responses()[0]));
+  EXPECT_EQ(14u, GetMetricsSum(ctx.responses()[0]));
+}
+
+TEST(MetricService, RequestWithTooManyPaths) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+
+  std::array<std::byte, 64> request_buffer;
+  proto::pwpb::MetricRequest::MemoryEncoder request(request_buffer);
+  for (size_t i = 0; i < MetricService::kMaxRequestPaths + 1; ++i) {
+    const Token path[] = {a.name()};
+    ASSERT_EQ(OkStatus(), request.GetMetricsEncoder().WriteTokenPath(path));
+  }
+
+  PW_RAW_TEST_METHOD_CONTEXT(MetricService, Get)
+  ctx{root.metrics(), root.children()};
+  ctx.call(ConstByteSpan(request));
+  EXPECT_TRUE(ctx.done());
+  EXPECT_EQ(Status::ResourceExhausted(), ctx.status());
+  EXPECT_EQ(0u, ctx.responses().size());
+}
+
+TEST(MetricService, ChangedOnly) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+  PW_METRIC(root, b, "b", 2u);
+  PW_METRIC(root, c, "c", 1.5f);
+
+  std::array<std::byte, 16> request_buffer;
+  proto::pwpb::MetricRequest::MemoryEncoder request(request_buffer);
+  ASSERT_EQ(OkStatus(), request.WriteChangedOnly(true));
+
+  std::array<uint32_t, 3> snapshot;
+  PW_RAW_TEST_METHOD_CONTEXT(MetricService, Get)
+  ctx{root.metrics(), root.children(), snapshot};
+
+  // Without a snapshot, all metrics are sent.
+  ctx.call(ConstByteSpan(request));
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(3u, GetTotalMetrics(ctx));
+
+  // Nothing changed.
+  ctx.call(ConstByteSpan(request));
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(0u, ctx.responses().size());
+
+  b.Increment();
+  c.Set(2.5f);
+  ctx.call(ConstByteSpan(request));
+  EXPECT_EQ(OkStatus(), ctx.status());
+  ASSERT_EQ(1u, ctx.responses().size());
+  EXPECT_EQ(2u, CountEncodedMetrics(ctx.responses()[0]));
+  EXPECT_EQ(3u, GetMetricsSum(ctx.responses()[0]));
+
+  // A request without changed_only sends every metric.
+  ctx.call({});
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(3u, GetTotalMetrics(ctx));
+}
+
+TEST(MetricService, ChangedOnlyAfterMetricAdded) {
+  PW_METRIC_GROUP(root, "/");
+  PW_METRIC(root, a, "a", 1u);
+
+  std::array<std::byte, 16> request_buffer;
+  proto::pwpb::MetricRequest::MemoryEncoder request(request_buffer);
+  ASSERT_EQ(OkStatus(), request.WriteChangedOnly(true));
+
+  std::array<uint32_t, 4> snapshot;
+  PW_RAW_TEST_METHOD_CONTEXT(MetricService, Get)
+  ctx{root.metrics(), root.children(), snapshot};
+  ctx.call({});
+  EXPECT_EQ(1u, GetTotalMetrics(ctx));
+
+  // The snapshot no longer describes the metrics, so all are sent.
+  PW_METRIC(root, b, "b", 2u);
+  ctx.call(ConstByteSpan(request));
+  EXPECT_EQ(OkStatus(), ctx.status());
+  EXPECT_EQ(2u, GetTotalMetrics(ctx));
+
+  ctx.call(ConstByteSpan(request));
+  EXPECT_EQ(0u, ctx.responses().size());
+}
+
 }  // namespace
 }  // namespace pw::metric
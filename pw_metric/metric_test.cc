@@ -55,6 +55,16 @@ TEST(Metric, IntFromObject) {
   EXPECT_EQ(m.value(), 426u);
 }
 
+TEST(Metric, IntSaturates) {
+  TypedMetric<uint32_t> m(0x1234, std::numeric_limits<uint32_t>::max() - 1);
+  m.Increment(5u);
+  EXPECT_EQ(m.value(), std::numeric_limits<uint32_t>::max());
+
+  m.Set(3u);
+  m.Decrement(5u);
+  EXPECT_EQ(m.value(), 0u);
+}
+
 TEST(m, IntFromMacroLocal) {
   PW_METRIC(m, "some_metric", 14u);
   EXPECT_TRUE(m.is_int());
@@ -237,4 +247,52 @@ TEST(Metric, StaticWithinAFunction) {
   EXPECT_EQ(metric->as_int(), 2u);
 }
 
+TEST(Histogram, BucketIndex) {
+  EXPECT_EQ(Histogram<8>::BucketIndex(0), 0u);
+  EXPECT_EQ(Histogram<8>::BucketIndex(1), 1u);
+  EXPECT_EQ(Histogram<8>::BucketIndex(2), 2u);
+  EXPECT_EQ(Histogram<8>::BucketIndex(3), 2u);
+  EXPECT_EQ(Histogram<8>::BucketIndex(4), 3u);
+  EXPECT_EQ(Histogram<8>::BucketIndex(63), 6u);
+  EXPECT_EQ(Histogram<8>::BucketIndex(64), 7u);
+  EXPECT_EQ(Histogram<8>::BucketIndex(1000), 7u);
+
+  EXPECT_EQ(Histogram<33>::BucketIndex(0x8000'0000), 32u);
+  EXPECT_EQ(Histogram<33>::BucketIndex(0xffff'ffff), 32u);
+}
+
+TEST(Histogram, Record) {
+  PW_METRIC_HISTOGRAM(latency, "latency", 4);
+  latency.Record(0);
+  latency.Record(1);
+  latency.Record(2);
+  latency.Record(3);
+  latency.Record(4);
+  latency.Record(100);
+
+  EXPECT_EQ(latency.count(0), 1u);
+  EXPECT_EQ(latency.count(1), 1u);
+  EXPECT_EQ(latency.count(2), 2u);
+  EXPECT_EQ(latency.count(3), 2u);
+}
+
+TEST(Histogram, BucketsAreMetricsInOrder) {
+  PW_METRIC_GROUP(parent, "parent");
+  PW_METRIC_HISTOGRAM(parent, latency, "latency", 3);
+  latency.Record(5);
+
+  ASSERT_EQ(parent.children().size(), 1u);
+  EXPECT_EQ(&parent.children().front(), &latency);
+  ASSERT_EQ(latency.metrics().size(), 3u);
+
+  size_t bucket = 0;
+  for (const Metric& metric : latency.metrics()) {
+    EXPECT_TRUE(metric.is_int());
+    EXPECT_EQ(metric.name(), internal::HistogramBucketName(bucket));
+    EXPECT_EQ(metric.as_int(), latency.count(bucket));
+    bucket += 1;
+  }
+  EXPECT_EQ(latency.count(2), 1u);
+}
+
 }  // namespace pw::metric
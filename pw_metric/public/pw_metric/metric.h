@@ -14,9 +14,14 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <initializer_list>
 #include <limits>
+#include <utility>
 
+#include "lib/stdcompat/bit.h"
 #include "pw_containers/intrusive_list.h"
 #include "pw_preprocessor/arguments.h"
 #include "pw_tokenizer/tokenize.h"
@@ -35,7 +40,9 @@ using tokenizer::Token;
 //
 // Size: 12 bytes / 96 bits - next, name, value.
 //
-// TODO(keir): Implement Set() and Increment() using atomics.
+// The value is atomic, so metrics may be updated from multiple threads or
+// interrupts without additional locking.
+//
 // TODO(keir): Consider an alternative structure where metrics have pointers to
 // parent groups, which would enable (1) safe destruction and (2) safe static
 // initialization, but at the cost of an additional 4 bytes per metric and 4
@@ -79,9 +86,12 @@ class Metric : public IntrusiveList<Metric>::Item {
   // a float metric at compile time.
 
   // Saturating add. Results in the max value if the addition would overflow.
+  // The update is a single atomic read-modify-write, so concurrent increments
+  // are never lost.
   void Increment(uint32_t amount = 1);
 
-  // Saturating subtract. Results in 0 if the subtraction would overflow.
+  // Saturating subtract. Results in 0 if the subtraction would overflow. Atomic
+  // like Increment().
   void Decrement(uint32_t amount = 1);
 
   void SetInt(uint32_t value);
@@ -93,9 +103,11 @@ class Metric : public IntrusiveList<Metric>::Item {
   // Last bit of the token is used to store int or float; 0 == int, 1 == float.
   Token name_and_type_;
 
+  // Accessed with relaxed memory ordering; metrics do not order other memory
+  // accesses.
   union {
-    float float_;
-    uint32_t uint_;
+    std::atomic<float> float_;
+    std::atomic<uint32_t> uint_;
   };
 
   enum : uint32_t {
@@ -149,6 +161,14 @@ class TypedMetric<uint32_t> : public Metric {
   uint32_t as_int() const { return 0; }
 };
 
+namespace internal {
+
+// Returns the tokenized name of a histogram bucket, which is the smallest value
+// that the bucket counts.
+Token HistogramBucketName(size_t bucket);
+
+}  // namespace internal
+
 // A metric tree; consisting of children groups and leaf metrics.
 //
 // Size: 16 bytes/128 bits - next, name, metrics, children.
@@ -199,6 +219,70 @@ class Group : public IntrusiveList<Group>::Item {
   IntrusiveList<Group> children_;
 };
 
+// The largest number of buckets in a Histogram: one for 0 and one for each bit
+// width of a uint32_t.
+inline constexpr size_t kMaxHistogramBuckets = 33;
+
+// A histogram of uint32_t values, such as latencies, with power-of-two
+// buckets. Bucket 0 counts zeros and bucket N counts values in [2^(N-1), 2^N);
+// the last bucket also counts all larger values.
+//
+// The histogram is a group with a uint32_t metric for each bucket, so it is
+// dumped and exported like any other group. Each bucket is named by the
+// smallest value that it counts. Recording a value is a single atomic
+// increment of one bucket, so it is safe from multiple threads or interrupts.
+//
+// Size: the size of a Group plus kBuckets metrics.
+template <size_t kBuckets>
+class Histogram : public Group {
+ public:
+  static_assert(kBuckets >= 2u && kBuckets <= kMaxHistogramBuckets,
+                "Histograms must have between 2 and 33 buckets");
+
+  Histogram(Token name)
+      : Group(name),
+        buckets_(MakeBuckets(std::make_index_sequence<kBuckets>())) {
+    AddBuckets();
+  }
+  Histogram(Token name, IntrusiveList<Group>& groups)
+      : Group(name, groups),
+        buckets_(MakeBuckets(std::make_index_sequence<kBuckets>())) {
+    AddBuckets();
+  }
+
+  // Returns the bucket that counts the value.
+  static constexpr size_t BucketIndex(uint32_t value) {
+    return std::min(static_cast<size_t>(cpp20::bit_width(value)),
+                    kBuckets - 1);
+  }
+
+  // Counts a value in its bucket.
+  void Record(uint32_t value) { buckets_[BucketIndex(value)].Increment(); }
+
+  // Returns the number of values counted in the bucket.
+  uint32_t count(size_t bucket) const { return buckets_[bucket].value(); }
+
+  static constexpr size_t buckets() { return kBuckets; }
+
+ private:
+  template <size_t... kIndices>
+  static std::array<TypedMetric<uint32_t>, kBuckets> MakeBuckets(
+      std::index_sequence<kIndices...>) {
+    return {{TypedMetric<uint32_t>(internal::HistogramBucketName(kIndices),
+                                   0u)...}};
+  }
+
+  // Groups list metrics in reverse order of addition, so add the buckets from
+  // largest to smallest.
+  void AddBuckets() {
+    for (size_t i = kBuckets; i > 0u; --i) {
+      Add(buckets_[i - 1]);
+    }
+  }
+
+  std::array<TypedMetric<uint32_t>, kBuckets> buckets_;
+};
+
 // Declare a metric, optionally adding it to a group. Use:
 //
 //   PW_METRIC(variable_name, metric_name, value)
@@ -312,4 +396,41 @@ class Group : public IntrusiveList<Group>::Item {
   static_def ::pw::metric::Group variable_name = {variable_name##_token,  \
                                                   parent.children()}
 
+// Define a histogram with the provided number of buckets, optionally adding
+// it to a parent group. Works like PW_METRIC_GROUP, and works in the same
+// contexts.
+//
+// Example:
+//
+//   class MyDriver {
+//    public:
+//     void Transfer() {
+//       const uint32_t start = GetTimeUs();
+//       ...
+//       latency_us_.Record(GetTimeUs() - start);
+//     }
+//
+//    private:
+//     PW_METRIC_GROUP(metrics_, "my_driver");
+//     PW_METRIC_HISTOGRAM(metrics_, latency_us_, "latency_us", 16);
+//   };
+//
+#define PW_METRIC_HISTOGRAM(...) \
+  PW_DELEGATE_BY_ARG_COUNT(_PW_METRIC_HISTOGRAM_, , __VA_ARGS__)
+#define PW_METRIC_HISTOGRAM_STATIC(...) \
+  PW_DELEGATE_BY_ARG_COUNT(_PW_METRIC_HISTOGRAM_, static, __VA_ARGS__)
+
+#define _PW_METRIC_HISTOGRAM_4(static_def, variable_name, name, buckets) \
+  static constexpr uint32_t variable_name##_token =                       \
+      PW_TOKENIZE_STRING_DOMAIN("metrics", name);                         \
+  static_def ::pw::metric::Histogram<buckets> variable_name = {           \
+      variable_name##_token}
+
+#define _PW_METRIC_HISTOGRAM_5(                                 \
+    static_def, parent, variable_name, name, buckets)           \
+  static constexpr uint32_t variable_name##_token =             \
+      PW_TOKENIZE_STRING_DOMAIN("metrics", name);               \
+  static_def ::pw::metric::Histogram<buckets> variable_name = { \
+      variable_name##_token, parent.children()}
+
 }  // namespace pw::metric
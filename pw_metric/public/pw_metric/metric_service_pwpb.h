@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
 
 #include "pw_bytes/span.h"
@@ -24,10 +26,15 @@
 
 namespace pw::metric {
 
-// The MetricService will send metrics when requested by Get(). For now, each
-// Get() request results in a stream of responses, containing the metrics from
-// the supplied list of groups and metrics. This includes recursive traversal
-// of subgroups. In the future, filtering will be supported.
+// The MetricService will send metrics when requested by Get(). Each Get()
+// request results in a stream of responses, containing the metrics from the
+// supplied list of groups and metrics. This includes recursive traversal of
+// subgroups.
+//
+// A request may select a subset of the metrics by their token paths; a path
+// selects the group or metric it names, including all of a group's children.
+// If the service has snapshot storage, a request may also set changed_only to
+// receive only the metrics whose values changed since they were last sent.
 //
 // An important limitation of the current implementation is that the Get()
 // method is blocking, and sends all metrics at once (though batched). In the
@@ -36,15 +43,37 @@ namespace pw::metric {
 class MetricService final
     : public proto::pw_rpc::raw::MetricService::Service<MetricService> {
  public:
+  // The most paths that a Get() request may select.
+  static constexpr size_t kMaxRequestPaths = 4;
+
   MetricService(const IntrusiveList<Metric>& metrics,
                 const IntrusiveList<Group>& groups)
-      : metrics_(metrics), groups_(groups) {}
+      : MetricService(metrics, groups, span<uint32_t>()) {}
+
+  // Creates a service that supports changed_only requests. The snapshot stores
+  // the last value sent for each metric, so it needs one entry per metric;
+  // metrics beyond its size are always sent.
+  //
+  // There is one snapshot for all clients. It is set by a request for all
+  // metrics, and updated by every later request. If metrics are added or
+  // removed, changed_only requests send every metric until the next request
+  // for all metrics.
+  MetricService(const IntrusiveList<Metric>& metrics,
+                const IntrusiveList<Group>& groups,
+                span<uint32_t> snapshot)
+      : metrics_(metrics), groups_(groups), snapshot_(snapshot) {}
 
   void Get(ConstByteSpan request, rpc::RawServerWriter& response);
 
  private:
   const IntrusiveList<Metric>& metrics_;
   const IntrusiveList<Group>& groups_;
+
+  span<uint32_t> snapshot_;
+
+  // The number of metrics when the snapshot was taken, or 0 if there is no
+  // snapshot.
+  size_t snapshot_metrics_ = 0;
 };
 
 }  // namespace pw::metric
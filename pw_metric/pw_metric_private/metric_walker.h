@@ -13,15 +13,27 @@
 // the License.
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
 #include "pw_assert/check.h"
 #include "pw_containers/intrusive_list.h"
 #include "pw_containers/vector.h"
 #include "pw_metric/metric.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 #include "pw_tokenizer/tokenize.h"
 
 namespace pw::metric::internal {
 
+// The most group and metric names in the path to a metric.
+inline constexpr size_t kMaxMetricPathTokens = 4;
+
+// The names from the root to a group or metric, as in Metric.token_path.
+using MetricPath = Vector<Token, kMaxMetricPathTokens>;
+
 class MetricWriter {
  public:
   virtual ~MetricWriter() = default;
@@ -68,8 +80,94 @@ class MetricWalker {
     MetricWalker& walker;
   };
 
-  Vector<Token, /*capacity=*/4> path_;
+  MetricPath path_;
+  MetricWriter& writer_;
+};
+
+// Counts the metrics in a tree without writing them.
+class MetricCounter : public MetricWriter {
+ public:
+  Status Write(const Metric&, const Vector<Token>&) override {
+    count_ += 1;
+    return OkStatus();
+  }
+
+  size_t count() const { return count_; }
+
+ private:
+  size_t count_ = 0;
+};
+
+// Passes a subset of the metrics on to another writer:
+//
+// - If any paths are provided, only metrics in one of the paths; i.e. whose
+//   path starts with the provided path.
+// - If changed_only is set, only metrics whose values differ from the snapshot.
+//
+// The snapshot holds the last value written for each metric, in the order the
+// walker visits them; metrics beyond the snapshot's size are always written.
+// It is updated as metrics are written.
+class MetricFilter : public MetricWriter {
+ public:
+  MetricFilter(MetricWriter& writer,
+               span<const MetricPath> paths,
+               span<uint32_t> snapshot,
+               bool changed_only)
+      : writer_(writer),
+        paths_(paths),
+        snapshot_(snapshot),
+        changed_only_(changed_only) {}
+
+  Status Write(const Metric& metric, const Vector<Token>& path) override {
+    const size_t index = visited_++;
+    if (!Selected(path)) {
+      return OkStatus();
+    }
+
+    const uint32_t value = RawValue(metric);
+    const bool in_snapshot = index < snapshot_.size();
+    if (changed_only_ && in_snapshot && snapshot_[index] == value) {
+      return OkStatus();
+    }
+
+    PW_TRY(writer_.Write(metric, path));
+    if (in_snapshot) {
+      snapshot_[index] = value;
+    }
+    return OkStatus();
+  }
+
+ private:
+  bool Selected(const Vector<Token>& path) const {
+    if (paths_.empty()) {
+      return true;
+    }
+    for (const MetricPath& prefix : paths_) {
+      if (prefix.size() <= path.size() &&
+          std::equal(prefix.begin(), prefix.end(), path.begin())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Returns the bits of the metric's value, which is compared directly since
+  // it is only checked for changes.
+  static uint32_t RawValue(const Metric& metric) {
+    if (metric.is_int()) {
+      return metric.as_int();
+    }
+    const float value = metric.as_float();
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
   MetricWriter& writer_;
+  span<const MetricPath> paths_;
+  span<uint32_t> snapshot_;
+  bool changed_only_;
+  size_t visited_ = 0;
 };
 
 }  // namespace pw::metric::internal
@@ -14,6 +14,8 @@
 
 #include "pw_multibuf/allocator.h"
 
+#include <limits>
+
 #include "pw_assert/check.h"
 
 namespace pw::multibuf {
@@ -24,7 +26,8 @@ std::optional<MultiBuf> MultiBufAllocator::Allocate(size_t size) {
 
 std::optional<MultiBuf> MultiBufAllocator::Allocate(size_t min_size,
                                                     size_t desired_size) {
-  pw::Result<MultiBuf> result = DoAllocate(min_size, desired_size, false);
+  pw::Result<MultiBuf> result =
+      AllocateWithReserve(min_size, desired_size, false);
   if (result.ok()) {
     return std::move(*result);
   }
@@ -37,7 +40,8 @@ std::optional<MultiBuf> MultiBufAllocator::AllocateContiguous(size_t size) {
 
 std::optional<MultiBuf> MultiBufAllocator::AllocateContiguous(
     size_t min_size, size_t desired_size) {
-  pw::Result<MultiBuf> result = DoAllocate(min_size, desired_size, true);
+  pw::Result<MultiBuf> result =
+      AllocateWithReserve(min_size, desired_size, true);
   if (result.ok()) {
     return std::move(*result);
   }
@@ -60,6 +64,38 @@ MultiBufAllocationFuture MultiBufAllocator::AllocateContiguousAsync(
   return MultiBufAllocationFuture(*this, min_size, desired_size, true);
 }
 
+pw::Result<MultiBuf> MultiBufAllocator::AllocateWithReserve(
+    size_t min_size, size_t desired_size, bool needs_contiguous) {
+  const size_t reserve = headroom_ + tailroom_;
+  if (reserve == 0 || desired_size == 0) {
+    return DoAllocate(min_size, desired_size, needs_contiguous);
+  }
+  if (desired_size > std::numeric_limits<size_t>::max() - reserve) {
+    return Status::OutOfRange();
+  }
+  pw::Result<MultiBuf> result =
+      DoAllocate(min_size + reserve, desired_size + reserve, needs_contiguous);
+  if (!result.ok()) {
+    return result;
+  }
+  MultiBuf& buf = *result;
+  PW_DCHECK_UINT_GE(buf.size(), min_size + reserve);
+  const size_t size = buf.size() - reserve;
+
+  Chunk& first = *buf.ChunkBegin();
+  Chunk& last = buf.Chunks().back();
+  if (&first == &last ||
+      (first.size() >= headroom_ && last.size() >= tailroom_)) {
+    first.DiscardPrefix(headroom_);
+    last.Truncate(last.size() - tailroom_);
+  } else {
+    // A small first or last chunk cannot hold its whole reserve.
+    buf.DiscardPrefix(headroom_);
+    buf.Truncate(size);
+  }
+  return result;
+}
+
 void MultiBufAllocator::MoreMemoryAvailable(size_t size_available,
                                             size_t contiguous_size_available)
     // Disable lock safety analysis: the access to `next_` requires locking
@@ -188,7 +224,7 @@ async2::Poll<std::optional<MultiBuf>> MultiBufAllocationFuture::Pend(
 }
 
 async2::Poll<std::optional<MultiBuf>> MultiBufAllocationFuture::TryAllocate() {
-  pw::Result<MultiBuf> buf_opt = waiter_.allocator().DoAllocate(
+  pw::Result<MultiBuf> buf_opt = waiter_.allocator().AllocateWithReserve(
       waiter_.min_size(), waiter_.desired_size(), waiter_.needs_contiguous());
   if (buf_opt.ok()) {
     return async2::Ready<std::optional<MultiBuf>>(std::move(*buf_opt));
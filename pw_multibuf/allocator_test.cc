@@ -17,6 +17,9 @@
 #include "gtest/gtest.h"
 #include "pw_async2/dispatcher.h"
 #include "pw_async2/poll.h"
+#include "pw_bytes/array.h"
+#include "pw_bytes/suffix.h"
+#include "pw_multibuf_private/test_utils.h"
 
 namespace pw::multibuf {
 namespace {
@@ -27,6 +30,10 @@ using ::pw::async2::Pending;
 using ::pw::async2::Poll;
 using ::pw::async2::Ready;
 using ::pw::async2::Task;
+using ::pw::multibuf::test_utils::AllocatorForTest;
+using ::pw::multibuf::test_utils::ExpectElementsEqual;
+using ::pw::multibuf::test_utils::kArbitraryAllocatorSize;
+using ::pw::multibuf::test_utils::MakeChunk;
 
 struct AllocateExpectation {
   size_t min_size;
@@ -129,5 +136,72 @@ TEST(MultiBufAllocator, AllocateAsyncWillNotPollUntilMoreMemoryAvailable) {
   EXPECT_TRUE(dispatcher.RunUntilStalled().IsReady());
 }
 
+TEST(MultiBufAllocator, AllocateWithReserveLeavesHeadroomAndTailroom) {
+  AllocatorForTest<kArbitraryAllocatorSize> chunk_alloc;
+  MockMultiBufAllocator alloc;
+  alloc.SetReserve(3, 2);
+  alloc.ExpectAllocateAndReturn(
+      15, 25, true, MultiBuf::FromChunk(MakeChunk(chunk_alloc, 20)));
+
+  std::optional<MultiBuf> buf = alloc.AllocateContiguous(10, 20);
+  ASSERT_TRUE(buf.has_value());
+  EXPECT_EQ(buf->size(), 15u);
+
+  EXPECT_EQ(buf->Prepend(bytes::Array<1, 2, 3>()), OkStatus());
+  EXPECT_EQ(buf->Append(bytes::Array<4, 5>()), OkStatus());
+  EXPECT_EQ(buf->size(), 20u);
+  EXPECT_EQ(buf->Prepend(bytes::Array<0>()), Status::ResourceExhausted());
+  EXPECT_EQ(buf->Append(bytes::Array<0>()), Status::ResourceExhausted());
+}
+
+TEST(MultiBufAllocator, AllocateWithReserveUsesFirstAndLastChunks) {
+  AllocatorForTest<kArbitraryAllocatorSize> chunk_alloc;
+  MockMultiBufAllocator alloc;
+  alloc.SetReserve(2, 1);
+  MultiBuf result;
+  result.PushBackChunk(MakeChunk(chunk_alloc, {0_b, 0_b, 1_b}));
+  result.PushBackChunk(MakeChunk(chunk_alloc, {2_b, 0_b}));
+  alloc.ExpectAllocateAndReturn(5, 5, false, std::move(result));
+
+  std::optional<MultiBuf> buf = alloc.Allocate(2);
+  ASSERT_TRUE(buf.has_value());
+  ExpectElementsEqual(*buf, {1_b, 2_b});
+  EXPECT_EQ(buf->Prepend(bytes::Array<7, 8>()), OkStatus());
+  EXPECT_EQ(buf->Append(bytes::Array<9>()), OkStatus());
+  ExpectElementsEqual(*buf, {7_b, 8_b, 1_b, 2_b, 9_b});
+}
+
+TEST(MultiBufAllocator, AllocateWithReserveSpillsPastSmallFirstChunk) {
+  AllocatorForTest<kArbitraryAllocatorSize> chunk_alloc;
+  MockMultiBufAllocator alloc;
+  alloc.SetReserve(2, 0);
+  MultiBuf result;
+  result.PushBackChunk(MakeChunk(chunk_alloc, {0_b}));
+  result.PushBackChunk(MakeChunk(chunk_alloc, {0_b, 1_b, 2_b}));
+  alloc.ExpectAllocateAndReturn(4, 4, false, std::move(result));
+
+  std::optional<MultiBuf> buf = alloc.Allocate(2);
+  ASSERT_TRUE(buf.has_value());
+  ExpectElementsEqual(*buf, {1_b, 2_b});
+  EXPECT_EQ(buf->Prepend(bytes::Array<9>()), OkStatus());
+  ExpectElementsEqual(*buf, {9_b, 1_b, 2_b});
+}
+
+TEST(MultiBufAllocator, AllocateAsyncWithReserveRequestsReservedSize) {
+  AllocatorForTest<kArbitraryAllocatorSize> chunk_alloc;
+  MockMultiBufAllocator alloc;
+  alloc.SetReserve(4, 4);
+  AllocateTask task(alloc.AllocateContiguousAsync(8));
+  alloc.ExpectAllocateAndReturn(
+      16, 16, true, MultiBuf::FromChunk(MakeChunk(chunk_alloc, 16)));
+
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), Ready());
+  ASSERT_TRUE(task.last_result_.IsReady());
+  ASSERT_TRUE(task.last_result_->has_value());
+  EXPECT_EQ((*task.last_result_)->size(), 8u);
+}
+
 }  // namespace
 }  // namespace pw::multibuf
@@ -27,17 +27,23 @@ void MultiBuf::Release() noexcept {
     first_ = first_->next_in_buf_;
     removed->Free();
   }
+  size_ = 0;
 }
 
 size_t MultiBuf::size() const {
-  size_t len = 0;
-  for (const auto& chunk : Chunks()) {
-    len += chunk.size();
+  if (size_ == kUnknownSize) {
+    size_ = 0;
+    for (const auto& chunk : Chunks()) {
+      size_ += chunk.size();
+    }
   }
-  return len;
+  return size_;
 }
 
 bool MultiBuf::empty() const {
+  if (size_ != kUnknownSize) {
+    return size_ == 0;
+  }
   return std::all_of(Chunks().begin(), Chunks().end(), [](const Chunk& c) {
     return c.empty();
   });
@@ -65,21 +71,30 @@ bool MultiBuf::ClaimPrefix(size_t bytes_to_claim) {
   if (first_ == nullptr) {
     return false;
   }
-  return first_->ClaimPrefix(bytes_to_claim);
+  if (!first_->ClaimPrefix(bytes_to_claim)) {
+    return false;
+  }
+  GrowSize(bytes_to_claim);
+  return true;
 }
 
 bool MultiBuf::ClaimSuffix(size_t bytes_to_claim) {
   if (first_ == nullptr) {
     return false;
   }
-  return Chunks().back().ClaimSuffix(bytes_to_claim);
+  if (!ChunkIterable(first_).back().ClaimSuffix(bytes_to_claim)) {
+    return false;
+  }
+  GrowSize(bytes_to_claim);
+  return true;
 }
 
 void MultiBuf::DiscardPrefix(size_t bytes_to_discard) {
   PW_DCHECK(bytes_to_discard <= size());
   while (bytes_to_discard != 0) {
-    if (ChunkBegin()->size() > bytes_to_discard) {
-      ChunkBegin()->DiscardPrefix(bytes_to_discard);
+    if (first_->size() > bytes_to_discard) {
+      first_->DiscardPrefix(bytes_to_discard);
+      ShrinkSize(bytes_to_discard);
       return;
     }
     OwnedChunk front_chunk = TakeFrontChunk();
@@ -99,6 +114,7 @@ void MultiBuf::Truncate(size_t len) {
     return;
   }
   TruncateAfter(begin() + (len - 1));
+  size_ = len;
 }
 
 void MultiBuf::TruncateAfter(iterator pos) {
@@ -108,6 +124,7 @@ void MultiBuf::TruncateAfter(iterator pos) {
   pos.chunk()->next_in_buf_ = nullptr;
   MultiBuf discard;
   discard.first_ = remainder;
+  InvalidateSize();
 }
 
 void MultiBuf::PushPrefix(MultiBuf&& front) {
@@ -118,11 +135,40 @@ void MultiBuf::PushPrefix(MultiBuf&& front) {
 void MultiBuf::PushSuffix(MultiBuf&& tail) {
   if (first_ == nullptr) {
     first_ = tail.first_;
-    tail.first_ = nullptr;
-    return;
+    size_ = tail.size_;
+  } else {
+    ChunkIterable(first_).back().next_in_buf_ = tail.first_;
+    if (tail.size_ == kUnknownSize) {
+      InvalidateSize();
+    } else {
+      GrowSize(tail.size_);
+    }
   }
-  Chunks().back().next_in_buf_ = tail.first_;
   tail.first_ = nullptr;
+  tail.size_ = 0;
+}
+
+Status MultiBuf::Prepend(ConstByteSpan header) {
+  if (header.empty()) {
+    return OkStatus();
+  }
+  if (!ClaimPrefix(header.size())) {
+    return Status::ResourceExhausted();
+  }
+  std::copy(header.begin(), header.end(), first_->begin());
+  return OkStatus();
+}
+
+Status MultiBuf::Append(ConstByteSpan footer) {
+  if (footer.empty()) {
+    return OkStatus();
+  }
+  if (!ClaimSuffix(footer.size())) {
+    return Status::ResourceExhausted();
+  }
+  Chunk& last = ChunkIterable(first_).back();
+  std::copy(footer.begin(), footer.end(), last.end() - footer.size());
+  return OkStatus();
 }
 
 StatusWithSize MultiBuf::CopyTo(ByteSpan dest, const size_t position) const {
@@ -160,11 +206,12 @@ StatusWithSize MultiBuf::CopyFromAndOptionallyTruncate(ConstByteSpan source,
     return StatusWithSize(0u);
   }
 
-  iterator byte_in_chunk = begin() + position;
+  iterator byte_in_chunk = iterator(first_) + position;
   size_t chunk_offset = byte_in_chunk.byte_index();
 
   size_t bytes_copied = 0;
-  for (ChunkIterator chunk(byte_in_chunk.chunk()); chunk != Chunks().end();
+  for (ChunkIterator chunk(byte_in_chunk.chunk());
+       chunk != ChunkIterator::end();
        ++chunk) {
     if (chunk->empty()) {
       continue;
@@ -180,6 +227,7 @@ StatusWithSize MultiBuf::CopyFromAndOptionallyTruncate(ConstByteSpan source,
         // to_copy is always at least one byte, since source.empty() is checked
         // above and empty chunks are skipped.
         TruncateAfter(iterator(&*chunk, chunk_offset + to_copy - 1));
+        size_ = position + bytes_copied;
       }
       return StatusWithSize(bytes_copied);
     }
@@ -189,6 +237,21 @@ StatusWithSize MultiBuf::CopyFromAndOptionallyTruncate(ConstByteSpan source,
   return StatusWithSize::ResourceExhausted(bytes_copied);  // ran out of space
 }
 
+std::optional<size_t> MultiBuf::Find(std::byte value, size_t position) const {
+  for (Cursor cursor(*this, position); !cursor.done();) {
+    const ConstByteSpan bytes = cursor.ContiguousSpan();
+    const void* match =
+        std::memchr(bytes.data(), static_cast<int>(value), bytes.size());
+    if (match != nullptr) {
+      return cursor.position() +
+             static_cast<size_t>(static_cast<const std::byte*>(match) -
+                                 bytes.data());
+    }
+    cursor.Skip(bytes.size());
+  }
+  return std::nullopt;
+}
+
 std::optional<MultiBuf> MultiBuf::TakePrefix(size_t bytes_to_take) {
   PW_DCHECK(bytes_to_take <= size());
   MultiBuf front;
@@ -197,13 +260,14 @@ std::optional<MultiBuf> MultiBuf::TakePrefix(size_t bytes_to_take) {
   }
   // Pointer to the last element of `front`, allowing constant-time appending.
   Chunk* last_front_chunk = nullptr;
-  while (bytes_to_take > ChunkBegin()->size()) {
+  while (bytes_to_take > first_->size()) {
     OwnedChunk new_chunk = TakeFrontChunk().Take();
     Chunk* new_chunk_ptr = &*new_chunk;
     bytes_to_take -= new_chunk.size();
     if (last_front_chunk == nullptr) {
       front.PushFrontChunk(std::move(new_chunk));
     } else {
+      front.GrowSize(new_chunk.size());
       last_front_chunk->next_in_buf_ = std::move(new_chunk).Take();
     }
     last_front_chunk = new_chunk_ptr;
@@ -213,7 +277,9 @@ std::optional<MultiBuf> MultiBuf::TakePrefix(size_t bytes_to_take) {
   }
   std::optional<OwnedChunk> last_front_bit = first_->TakePrefix(bytes_to_take);
   if (last_front_bit.has_value()) {
+    ShrinkSize(bytes_to_take);
     if (last_front_chunk != nullptr) {
+      front.GrowSize(bytes_to_take);
       Chunk* last_front_bit_ptr = std::move(*last_front_bit).Take();
       last_front_chunk->next_in_buf_ = last_front_bit_ptr;
     } else {
@@ -239,6 +305,7 @@ std::optional<MultiBuf> MultiBuf::TakeSuffix(size_t bytes_to_take) {
 
 void MultiBuf::PushFrontChunk(OwnedChunk&& chunk) {
   PW_DCHECK(chunk->next_in_buf_ == nullptr);
+  GrowSize(chunk.size());
   Chunk* new_chunk = std::move(chunk).Take();
   Chunk* old_first = first_;
   new_chunk->next_in_buf_ = old_first;
@@ -247,6 +314,7 @@ void MultiBuf::PushFrontChunk(OwnedChunk&& chunk) {
 
 void MultiBuf::PushBackChunk(OwnedChunk&& chunk) {
   PW_DCHECK(chunk->next_in_buf_ == nullptr);
+  GrowSize(chunk.size());
   Chunk* new_chunk = std::move(chunk).Take();
   if (first_ == nullptr) {
     first_ = new_chunk;
@@ -263,10 +331,11 @@ MultiBuf::ChunkIterator MultiBuf::InsertChunk(ChunkIterator position,
                                               OwnedChunk&& chunk) {
   // Note: this also catches the cases where ``first_ == nullptr``
   PW_DCHECK(chunk->next_in_buf_ == nullptr);
-  if (position == ChunkBegin()) {
+  if (position == ChunkIterator(first_)) {
     PushFrontChunk(std::move(chunk));
     return ChunkIterator(first_);
   }
+  GrowSize(chunk.size());
   Chunk* previous = Previous(position.chunk_);
   Chunk* old_next = previous->next_in_buf_;
   Chunk* new_chunk = std::move(chunk).Take();
@@ -277,6 +346,7 @@ MultiBuf::ChunkIterator MultiBuf::InsertChunk(ChunkIterator position,
 
 OwnedChunk MultiBuf::TakeFrontChunk() {
   Chunk* old_first = first_;
+  ShrinkSize(old_first->size());
   first_ = old_first->next_in_buf_;
   old_first->next_in_buf_ = nullptr;
   return OwnedChunk(old_first);
@@ -285,10 +355,11 @@ OwnedChunk MultiBuf::TakeFrontChunk() {
 std::tuple<MultiBuf::ChunkIterator, OwnedChunk> MultiBuf::TakeChunk(
     ChunkIterator position) {
   Chunk* chunk = position.chunk_;
-  if (position == ChunkBegin()) {
+  if (position == ChunkIterator(first_)) {
     OwnedChunk old_first = TakeFrontChunk();
     return std::make_tuple(ChunkIterator(first_), std::move(old_first));
   }
+  ShrinkSize(chunk->size());
   Chunk* previous = Previous(chunk);
   previous->next_in_buf_ = chunk->next_in_buf_;
   chunk->next_in_buf_ = nullptr;
@@ -332,6 +403,47 @@ MultiBuf::const_iterator& MultiBuf::const_iterator::operator+=(size_t advance) {
   return *this;
 }
 
+Cursor::Cursor(const MultiBuf& multibuf, size_t position)
+    : chunk_(multibuf.Chunks().begin()) {
+  SkipReadChunks();
+  Skip(position);
+}
+
+size_t Cursor::Skip(size_t bytes) {
+  size_t skipped = 0;
+  while (!done() && bytes - skipped >= chunk_->size() - offset_) {
+    skipped += chunk_->size() - offset_;
+    ++chunk_;
+    offset_ = 0;
+    SkipReadChunks();
+  }
+  if (!done()) {
+    // Less than the rest of the current Chunk remains to be skipped.
+    offset_ += bytes - skipped;
+    skipped = bytes;
+  }
+  position_ += skipped;
+  return skipped;
+}
+
+size_t Cursor::Read(ByteSpan dest) {
+  size_t bytes_read = 0;
+  while (bytes_read < dest.size() && !done()) {
+    const ConstByteSpan bytes = ContiguousSpan();
+    const size_t to_copy = std::min(bytes.size(), dest.size() - bytes_read);
+    std::memcpy(dest.data() + bytes_read, bytes.data(), to_copy);
+    bytes_read += Skip(to_copy);
+  }
+  return bytes_read;
+}
+
+void Cursor::SkipReadChunks() {
+  while (!done() && offset_ == chunk_->size()) {
+    ++chunk_;
+    offset_ = 0;
+  }
+}
+
 Chunk& MultiBuf::ChunkIterable::back() {
   return const_cast<Chunk&>(std::as_const(*this).back());
 }
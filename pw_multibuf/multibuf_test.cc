@@ -14,6 +14,9 @@
 
 #include "pw_multibuf/multibuf.h"
 
+#include <array>
+#include <optional>
+
 #include "pw_assert/check.h"
 #include "pw_bytes/array.h"
 #include "pw_bytes/suffix.h"
@@ -322,6 +325,51 @@ TEST(MultiBuf, PushSuffixAppendsData) {
   ExpectElementsEqual(buf2, {7_b, 8_b, 1_b, 2_b, 3_b, 4_b, 5_b, 6_b});
 }
 
+TEST(MultiBuf, PrependWritesIntoHeadroom) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  OwnedChunk chunk = MakeChunk(allocator, {0_b, 0_b, 0_b, 4_b, 5_b});
+  chunk->DiscardPrefix(3);
+  buf.PushBackChunk(std::move(chunk));
+
+  EXPECT_EQ(buf.Prepend(bytes::Array<3>()), OkStatus());
+  ExpectElementsEqual(buf, {3_b, 4_b, 5_b});
+  EXPECT_EQ(buf.Prepend(bytes::Array<1, 2>()), OkStatus());
+  ExpectElementsEqual(buf, {1_b, 2_b, 3_b, 4_b, 5_b});
+}
+
+TEST(MultiBuf, PrependWithoutHeadroomFails) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  OwnedChunk chunk = MakeChunk(allocator, {0_b, 3_b});
+  chunk->DiscardPrefix(1);
+  buf.PushBackChunk(std::move(chunk));
+
+  EXPECT_EQ(buf.Prepend(bytes::Array<1, 2>()), Status::ResourceExhausted());
+  ExpectElementsEqual(buf, {3_b});
+  EXPECT_EQ(buf.size(), 1u);
+}
+
+TEST(MultiBuf, PrependWithoutChunksFails) {
+  MultiBuf buf;
+  EXPECT_EQ(buf.Prepend(bytes::Array<1>()), Status::ResourceExhausted());
+  EXPECT_EQ(buf.Prepend(ConstByteSpan()), OkStatus());
+}
+
+TEST(MultiBuf, AppendWritesIntoTailroomOfLastChunk) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  buf.PushBackChunk(MakeChunk(allocator, {1_b}));
+  OwnedChunk chunk = MakeChunk(allocator, {2_b, 0_b, 0_b});
+  chunk->Truncate(1);
+  buf.PushBackChunk(std::move(chunk));
+
+  EXPECT_EQ(buf.Append(bytes::Array<3, 4>()), OkStatus());
+  ExpectElementsEqual(buf, {1_b, 2_b, 3_b, 4_b});
+  EXPECT_EQ(buf.Append(bytes::Array<5>()), Status::ResourceExhausted());
+  EXPECT_EQ(buf.size(), 4u);
+}
+
 TEST(MultiBuf, PushFrontChunkAddsBytesToFront) {
   AllocatorForTest<kArbitraryAllocatorSize> allocator;
   MultiBuf buf;
@@ -760,5 +808,183 @@ TEST(MultiBuf, ContiguousSpanAcrossMultipleChunks) {
   EXPECT_FALSE(buf.IsContiguous());
 }
 
+size_t CountBytes(const MultiBuf& buf) {
+  size_t bytes = 0;
+  for (const Chunk& chunk : buf.Chunks()) {
+    bytes += chunk.size();
+  }
+  return bytes;
+}
+
+TEST(MultiBuf, SizeTracksMultiBufOperations) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  buf.PushBackChunk(MakeChunk(allocator, 8));
+  buf.PushFrontChunk(MakeChunk(allocator, 6));
+  buf.PushBackChunk(MakeChunk(allocator, 4));
+  EXPECT_EQ(buf.size(), 18u);
+
+  buf.DiscardPrefix(7);
+  EXPECT_EQ(buf.size(), 11u);
+  EXPECT_EQ(buf.size(), CountBytes(buf));
+
+  EXPECT_TRUE(buf.ClaimPrefix(1));
+  EXPECT_EQ(buf.size(), 12u);
+  EXPECT_EQ(buf.size(), CountBytes(buf));
+
+  std::optional<MultiBuf> front = buf.TakePrefix(5);
+  ASSERT_TRUE(front.has_value());
+  EXPECT_EQ(front->size(), 5u);
+  EXPECT_EQ(buf.size(), 7u);
+  EXPECT_EQ(buf.size(), CountBytes(buf));
+
+  buf.PushPrefix(std::move(*front));
+  EXPECT_EQ(buf.size(), 12u);
+  EXPECT_EQ(buf.size(), CountBytes(buf));
+
+  buf.Truncate(9);
+  EXPECT_EQ(buf.size(), 9u);
+  EXPECT_EQ(buf.size(), CountBytes(buf));
+
+  OwnedChunk chunk = buf.TakeFrontChunk();
+  EXPECT_EQ(buf.size(), 9u - chunk.size());
+  EXPECT_EQ(buf.size(), CountBytes(buf));
+
+  buf.Release();
+  EXPECT_EQ(buf.size(), 0u);
+  EXPECT_TRUE(buf.empty());
+}
+
+TEST(MultiBuf, SizeRecountedAfterChunkResizedThroughChunks) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  buf.PushBackChunk(MakeChunk(allocator, 8));
+  buf.PushBackChunk(MakeChunk(allocator, 8));
+  EXPECT_EQ(buf.size(), 16u);
+
+  buf.Chunks().front().Truncate(3);
+  EXPECT_EQ(buf.size(), 11u);
+
+  buf.ChunkBegin()->DiscardPrefix(3);
+  EXPECT_EQ(buf.size(), 8u);
+  EXPECT_FALSE(buf.empty());
+}
+
+TEST(MultiBuf, SizeOfMovedMultiBuf) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf = MultiBuf::FromChunk(MakeChunk(allocator, 8));
+  MultiBuf moved = std::move(buf);
+  EXPECT_EQ(moved.size(), 8u);
+  EXPECT_EQ(buf.size(), 0u);  // NOLINT(bugprone-use-after-move)
+}
+
+TEST(MultiBuf, FindAcrossChunks) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  buf.PushBackChunk(MakeChunk(allocator, {1_b, 2_b}));
+  buf.PushBackChunk(MakeChunk(allocator, 0));
+  buf.PushBackChunk(MakeChunk(allocator, {3_b, 2_b, 4_b}));
+
+  EXPECT_EQ(buf.Find(1_b), 0u);
+  EXPECT_EQ(buf.Find(2_b), 1u);
+  EXPECT_EQ(buf.Find(4_b), 4u);
+  EXPECT_EQ(buf.Find(5_b), std::nullopt);
+}
+
+TEST(MultiBuf, FindFromPosition) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  buf.PushBackChunk(MakeChunk(allocator, {1_b, 2_b}));
+  buf.PushBackChunk(MakeChunk(allocator, {3_b, 2_b, 4_b}));
+
+  EXPECT_EQ(buf.Find(2_b, 1), 1u);
+  EXPECT_EQ(buf.Find(2_b, 2), 3u);
+  EXPECT_EQ(buf.Find(2_b, 4), std::nullopt);
+  EXPECT_EQ(buf.Find(2_b, 100), std::nullopt);
+}
+
+TEST(MultiBuf, FindInEmptyMultiBuf) {
+  MultiBuf buf;
+  EXPECT_EQ(buf.Find(0_b), std::nullopt);
+}
+
+TEST(Cursor, ContiguousSpanSkipsEmptyChunks) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  buf.PushBackChunk(MakeChunk(allocator, 0));
+  buf.PushBackChunk(MakeChunk(allocator, {1_b, 2_b}));
+  buf.PushBackChunk(MakeChunk(allocator, 0));
+  buf.PushBackChunk(MakeChunk(allocator, {3_b}));
+
+  Cursor cursor(buf);
+  EXPECT_FALSE(cursor.done());
+  ExpectElementsEqual(cursor.ContiguousSpan(), {1_b, 2_b});
+  EXPECT_EQ(cursor.ContiguousSpan().size(), 2u);
+
+  EXPECT_EQ(cursor.Skip(2), 2u);
+  EXPECT_EQ(cursor.position(), 2u);
+  ExpectElementsEqual(cursor.ContiguousSpan(), {3_b});
+  EXPECT_EQ(cursor.ContiguousSpan().size(), 1u);
+
+  EXPECT_EQ(cursor.Skip(1), 1u);
+  EXPECT_TRUE(cursor.done());
+  EXPECT_TRUE(cursor.ContiguousSpan().empty());
+}
+
+TEST(Cursor, SkipWithinAndAcrossChunks) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  buf.PushBackChunk(MakeChunk(allocator, {1_b, 2_b, 3_b}));
+  buf.PushBackChunk(MakeChunk(allocator, {4_b, 5_b}));
+  buf.PushBackChunk(MakeChunk(allocator, {6_b, 7_b, 8_b}));
+
+  Cursor cursor(buf);
+  EXPECT_EQ(cursor.Skip(1), 1u);
+  ExpectElementsEqual(cursor.ContiguousSpan(), {2_b, 3_b});
+
+  EXPECT_EQ(cursor.Skip(5), 5u);
+  EXPECT_EQ(cursor.position(), 6u);
+  ExpectElementsEqual(cursor.ContiguousSpan(), {7_b, 8_b});
+  EXPECT_EQ(cursor.ContiguousSpan().size(), 2u);
+
+  EXPECT_EQ(cursor.Skip(100), 2u);
+  EXPECT_EQ(cursor.position(), 8u);
+  EXPECT_TRUE(cursor.done());
+  EXPECT_EQ(cursor.Skip(1), 0u);
+}
+
+TEST(Cursor, StartsAtPosition) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  buf.PushBackChunk(MakeChunk(allocator, {1_b, 2_b}));
+  buf.PushBackChunk(MakeChunk(allocator, {3_b, 4_b}));
+
+  Cursor cursor(buf, 2);
+  EXPECT_EQ(cursor.position(), 2u);
+  ExpectElementsEqual(cursor.ContiguousSpan(), {3_b, 4_b});
+
+  Cursor past_end(buf, 10);
+  EXPECT_EQ(past_end.position(), 4u);
+  EXPECT_TRUE(past_end.done());
+}
+
+TEST(Cursor, ReadAcrossChunks) {
+  AllocatorForTest<kArbitraryAllocatorSize> allocator;
+  MultiBuf buf;
+  buf.PushBackChunk(MakeChunk(allocator, {1_b, 2_b}));
+  buf.PushBackChunk(MakeChunk(allocator, 0));
+  buf.PushBackChunk(MakeChunk(allocator, {3_b, 4_b, 5_b}));
+
+  Cursor cursor(buf);
+  std::array<std::byte, 4> dest{};
+  EXPECT_EQ(cursor.Read(dest), 4u);
+  ExpectElementsEqual(dest, {1_b, 2_b, 3_b, 4_b});
+  EXPECT_EQ(cursor.position(), 4u);
+
+  EXPECT_EQ(cursor.Read(dest), 1u);
+  EXPECT_EQ(dest[0], 5_b);
+  EXPECT_TRUE(cursor.done());
+}
+
 }  // namespace
 }  // namespace pw::multibuf
@@ -0,0 +1,242 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_multibuf/pool_allocator.h"
+
+#include <algorithm>
+#include <new>
+
+#include "pw_assert/check.h"
+
+namespace pw::multibuf {
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+namespace internal {
+
+void PoolRegionTracker::Destroy() { parent_.Release(*this); }
+
+void* PoolRegionTracker::AllocateChunkClass() {
+  bool in_use = false;
+  if (chunk_in_use_.compare_exchange_strong(
+          in_use, true, std::memory_order_acquire)) {
+    return chunk_storage_.data();
+  }
+  return parent_.metadata_alloc_.Allocate(allocator::Layout::Of<Chunk>());
+}
+
+void PoolRegionTracker::DeallocateChunkClass(void* ptr) {
+  if (ptr == chunk_storage_.data()) {
+    chunk_in_use_.store(false, std::memory_order_release);
+    return;
+  }
+  parent_.metadata_alloc_.Deallocate(ptr);
+}
+
+}  // namespace internal
+
+internal::PoolRegionTracker* PoolMultiBufAllocator::Pool::Pop() {
+  uint32_t head = free_list_.load(std::memory_order_acquire);
+  uint32_t new_head;
+  internal::PoolRegionTracker* tracker;
+  do {
+    const uint32_t index = head & kIndexMask;
+    if (index == kEmpty) {
+      return nullptr;
+    }
+    tracker = &trackers_[index];
+    const uint32_t counter = (head & ~kIndexMask) + (kIndexMask + 1);
+    new_head = counter | tracker->next_free_.load(std::memory_order_relaxed);
+  } while (!free_list_.compare_exchange_weak(
+      head, new_head, std::memory_order_acquire, std::memory_order_acquire));
+  available_.fetch_sub(1, std::memory_order_relaxed);
+  return tracker;
+}
+
+void PoolMultiBufAllocator::Pool::Push(internal::PoolRegionTracker& tracker) {
+  uint32_t head = free_list_.load(std::memory_order_relaxed);
+  uint32_t new_head;
+  do {
+    tracker.next_free_.store(static_cast<uint16_t>(head & kIndexMask),
+                             std::memory_order_relaxed);
+    const uint32_t counter = (head & ~kIndexMask) + (kIndexMask + 1);
+    new_head = counter | tracker.index_;
+  } while (!free_list_.compare_exchange_weak(
+      head, new_head, std::memory_order_release, std::memory_order_relaxed));
+  available_.fetch_add(1, std::memory_order_relaxed);
+}
+
+PoolMultiBufAllocator::PoolMultiBufAllocator(
+    span<Pool> pools,
+    ByteSpan data_area,
+    pw::allocator::Allocator& metadata_alloc)
+    : pools_(pools), metadata_alloc_(metadata_alloc) {
+  std::byte* data = data_area.data();
+  size_t prev_buffer_size = 0;
+  for (Pool& pool : pools_) {
+    PW_CHECK_UINT_GT(pool.buffer_size_,
+                     prev_buffer_size,
+                     "Pools must be ordered by increasing buffer size");
+    PW_CHECK_UINT_LT(pool.buffer_count_, Pool::kEmpty);
+    prev_buffer_size = pool.buffer_size_;
+
+    const size_t pool_size = pool.buffer_size_ * pool.buffer_count_;
+    PW_CHECK_UINT_LE(pool_size,
+                     static_cast<size_t>(data_area.data() + data_area.size() -
+                                         data),
+                     "Data area is too small for the pools");
+
+    if (pool.buffer_count_ != 0) {
+      pool.trackers_ = static_cast<internal::PoolRegionTracker*>(
+          metadata_alloc_.Allocate(allocator::Layout(
+              sizeof(internal::PoolRegionTracker) * pool.buffer_count_,
+              alignof(internal::PoolRegionTracker))));
+      PW_CHECK_NOTNULL(pool.trackers_,
+                       "Failed to allocate metadata for %u buffers",
+                       static_cast<unsigned>(pool.buffer_count_));
+    }
+    for (size_t i = 0; i < pool.buffer_count_; ++i) {
+      auto* tracker = new (&pool.trackers_[i])
+          internal::PoolRegionTracker(*this,
+                                      pool,
+                                      ByteSpan(data, pool.buffer_size_),
+                                      static_cast<uint16_t>(i));
+      pool.Push(*tracker);
+      data += pool.buffer_size_;
+    }
+    capacity_ += pool_size;
+  }
+}
+
+PoolMultiBufAllocator::~PoolMultiBufAllocator() {
+  for (Pool& pool : pools_) {
+    PW_CHECK_UINT_EQ(pool.available(),
+                     pool.buffer_count_,
+                     "Buffers must be freed before their allocator");
+    for (size_t i = 0; i < pool.buffer_count_; ++i) {
+      pool.trackers_[i].~PoolRegionTracker();
+    }
+    if (pool.trackers_ != nullptr) {
+      metadata_alloc_.Deallocate(pool.trackers_);
+      pool.trackers_ = nullptr;
+    }
+    pool.free_list_.store(Pool::kEmpty, std::memory_order_relaxed);
+  }
+}
+
+pw::Result<MultiBuf> PoolMultiBufAllocator::DoAllocate(size_t min_size,
+                                                       size_t desired_size,
+                                                       bool needs_contiguous) {
+  if (desired_size == 0) {
+    return MultiBuf();
+  }
+  const size_t max_buffer_size =
+      pools_.empty() ? 0 : pools_.back().buffer_size_;
+  if (min_size > (needs_contiguous ? max_buffer_size : capacity_)) {
+    return Status::OutOfRange();
+  }
+  if (min_size <= max_buffer_size) {
+    std::optional<MultiBuf> buf = AllocateBuffer(min_size, desired_size);
+    if (buf.has_value()) {
+      return std::move(*buf);
+    }
+  }
+  if (needs_contiguous) {
+    return Status::ResourceExhausted();
+  }
+  return AllocateBuffers(min_size, desired_size);
+}
+
+std::optional<MultiBuf> PoolMultiBufAllocator::AllocateBuffer(
+    size_t min_size, size_t desired_size) {
+  // The first pool with buffers that hold the whole request.
+  const auto first_fit =
+      std::find_if(pools_.begin(), pools_.end(), [desired_size](Pool& pool) {
+        return pool.buffer_size_ >= desired_size;
+      });
+
+  internal::PoolRegionTracker* tracker = nullptr;
+  for (auto pool = first_fit; pool != pools_.end() && tracker == nullptr;
+       ++pool) {
+    tracker = pool->Pop();
+  }
+  // Fall back to the largest buffer that holds at least `min_size` bytes.
+  for (auto pool = first_fit; pool != pools_.begin() && tracker == nullptr;) {
+    --pool;
+    if (pool->buffer_size_ < min_size) {
+      break;
+    }
+    tracker = pool->Pop();
+  }
+  if (tracker == nullptr) {
+    return std::nullopt;
+  }
+
+  // The inline chunk storage is always free when the buffer is.
+  std::optional<OwnedChunk> chunk = tracker->CreateFirstChunk();
+  PW_CHECK(chunk.has_value());
+  (*chunk)->Truncate(std::min(desired_size, tracker->region_.size()));
+  return MultiBuf::FromChunk(std::move(*chunk));
+}
+
+pw::Result<MultiBuf> PoolMultiBufAllocator::AllocateBuffers(
+    size_t min_size, size_t desired_size) {
+  size_t available = 0;
+  for (const Pool& pool : pools_) {
+    available += pool.available() * pool.buffer_size_;
+  }
+  if (available < min_size) {
+    return Status::ResourceExhausted();
+  }
+
+  MultiBuf buf;
+  size_t remaining = std::min(desired_size, available);
+  for (auto pool = pools_.rbegin(); pool != pools_.rend() && remaining != 0;
+       ++pool) {
+    while (remaining != 0) {
+      internal::PoolRegionTracker* tracker = pool->Pop();
+      if (tracker == nullptr) {
+        break;
+      }
+      std::optional<OwnedChunk> chunk = tracker->CreateFirstChunk();
+      PW_CHECK(chunk.has_value());
+      const size_t chunk_size = std::min(remaining, pool->buffer_size_);
+      (*chunk)->Truncate(chunk_size);
+      remaining -= chunk_size;
+      buf.PushBackChunk(std::move(*chunk));
+    }
+  }
+  // Other threads may have allocated buffers since they were counted.
+  if (buf.size() < min_size) {
+    return Status::ResourceExhausted();
+  }
+  return buf;
+}
+
+void PoolMultiBufAllocator::Release(internal::PoolRegionTracker& tracker) {
+  tracker.pool_.Push(tracker);
+
+  size_t available = 0;
+  size_t contiguous = 0;
+  for (const Pool& pool : pools_) {
+    const size_t count = pool.available();
+    available += count * pool.buffer_size_;
+    if (count != 0) {
+      contiguous = pool.buffer_size_;
+    }
+  }
+  MoreMemoryAvailable(available, contiguous);
+}
+
+}  // namespace pw::multibuf
@@ -0,0 +1,215 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_multibuf/pool_allocator.h"
+
+#include <array>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "pw_allocator/testing.h"
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/poll.h"
+
+namespace pw::multibuf {
+namespace {
+
+using ::pw::allocator::test::AllocatorForTest;
+using ::pw::async2::Context;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+using ::pw::async2::Task;
+
+using Pool = PoolMultiBufAllocator::Pool;
+
+constexpr size_t kDataSize = 2 * 64 + 2 * 256 + 1500;
+constexpr size_t kMetaSize = 2048;
+
+class PoolMultiBufAllocatorTest : public ::testing::Test {
+ protected:
+  PoolMultiBufAllocatorTest() : allocator_(pools_, data_area_, meta_alloc_) {}
+
+  bool IsInPool(const MultiBuf& buf, size_t pool_index) {
+    const std::byte* begin = data_area_.data();
+    for (size_t i = 0; i < pool_index; ++i) {
+      begin += pools_[i].buffer_size() * pools_[i].buffer_count();
+    }
+    const std::byte* end = begin + pools_[pool_index].buffer_size() *
+                                       pools_[pool_index].buffer_count();
+    const std::byte* data = buf.Chunks().begin()->data();
+    return data >= begin && data < end;
+  }
+
+  std::array<std::byte, kDataSize> data_area_;
+  AllocatorForTest<kMetaSize> meta_alloc_;
+  std::array<Pool, 3> pools_ = {Pool(64, 2), Pool(256, 2), Pool(1500, 1)};
+  PoolMultiBufAllocator allocator_;
+};
+
+TEST_F(PoolMultiBufAllocatorTest, AllocateUsesSmallestBufferThatFits) {
+  std::optional<MultiBuf> small = allocator_.Allocate(10);
+  ASSERT_TRUE(small.has_value());
+  EXPECT_EQ(small->size(), 10u);
+  EXPECT_TRUE(IsInPool(*small, 0));
+
+  std::optional<MultiBuf> medium = allocator_.Allocate(65);
+  ASSERT_TRUE(medium.has_value());
+  EXPECT_EQ(medium->size(), 65u);
+  EXPECT_TRUE(IsInPool(*medium, 1));
+
+  std::optional<MultiBuf> large = allocator_.AllocateContiguous(1500);
+  ASSERT_TRUE(large.has_value());
+  EXPECT_EQ(large->size(), 1500u);
+  EXPECT_EQ(large->Chunks().size(), 1u);
+  EXPECT_TRUE(IsInPool(*large, 2));
+
+  EXPECT_EQ(pools_[0].available(), 1u);
+  EXPECT_EQ(pools_[1].available(), 1u);
+  EXPECT_EQ(pools_[2].available(), 0u);
+}
+
+TEST_F(PoolMultiBufAllocatorTest, AllocateUsesLargerBufferWhenPoolIsEmpty) {
+  std::optional<MultiBuf> first = allocator_.Allocate(64);
+  std::optional<MultiBuf> second = allocator_.Allocate(64);
+  std::optional<MultiBuf> third = allocator_.Allocate(64);
+  ASSERT_TRUE(third.has_value());
+  EXPECT_EQ(third->size(), 64u);
+  EXPECT_TRUE(IsInPool(*third, 1));
+}
+
+TEST_F(PoolMultiBufAllocatorTest, AllocateFallsBackToLargestBufferForMinSize) {
+  std::optional<MultiBuf> large = allocator_.Allocate(1500);
+  ASSERT_TRUE(large.has_value());
+
+  std::optional<MultiBuf> buf = allocator_.AllocateContiguous(100, 1000);
+  ASSERT_TRUE(buf.has_value());
+  EXPECT_EQ(buf->size(), 256u);
+  EXPECT_TRUE(IsInPool(*buf, 1));
+
+  EXPECT_FALSE(allocator_.AllocateContiguous(300, 1000).has_value());
+}
+
+TEST_F(PoolMultiBufAllocatorTest, FreeReturnsBufferToPool) {
+  {
+    std::optional<MultiBuf> buf = allocator_.Allocate(1500);
+    ASSERT_TRUE(buf.has_value());
+    EXPECT_FALSE(allocator_.AllocateContiguous(1500).has_value());
+  }
+  EXPECT_EQ(pools_[2].available(), 1u);
+  EXPECT_TRUE(allocator_.AllocateContiguous(1500).has_value());
+}
+
+TEST_F(PoolMultiBufAllocatorTest, AllocateBuffersUntilExhausted) {
+  std::array<std::optional<MultiBuf>, 5> bufs;
+  for (auto& buf : bufs) {
+    buf = allocator_.AllocateContiguous(10);
+    ASSERT_TRUE(buf.has_value());
+  }
+  EXPECT_FALSE(allocator_.AllocateContiguous(10).has_value());
+  EXPECT_FALSE(allocator_.Allocate(10).has_value());
+}
+
+TEST_F(PoolMultiBufAllocatorTest, AllocateSpansSeveralBuffers) {
+  std::optional<MultiBuf> buf = allocator_.Allocate(2000);
+  ASSERT_TRUE(buf.has_value());
+  EXPECT_EQ(buf->size(), 2000u);
+  EXPECT_EQ(buf->Chunks().size(), 3u);
+  EXPECT_EQ(pools_[1].available(), 0u);
+  EXPECT_EQ(pools_[2].available(), 0u);
+}
+
+TEST_F(PoolMultiBufAllocatorTest, AllocateMoreThanCapacityFails) {
+  EXPECT_FALSE(allocator_.Allocate(kDataSize + 1).has_value());
+  EXPECT_FALSE(allocator_.AllocateContiguous(1501).has_value());
+  EXPECT_EQ(pools_[2].available(), 1u);
+}
+
+TEST_F(PoolMultiBufAllocatorTest, AllocateZeroReturnsEmptyMultiBuf) {
+  std::optional<MultiBuf> buf = allocator_.Allocate(0);
+  ASSERT_TRUE(buf.has_value());
+  EXPECT_EQ(buf->size(), 0u);
+}
+
+TEST_F(PoolMultiBufAllocatorTest, SplitBufferUsesMetadataAllocator) {
+  std::optional<MultiBuf> buf = allocator_.AllocateContiguous(100);
+  ASSERT_TRUE(buf.has_value());
+  OwnedChunk chunk = buf->TakeFrontChunk();
+  meta_alloc_.ResetParameters();
+
+  std::optional<OwnedChunk> prefix = chunk->TakePrefix(40);
+  ASSERT_TRUE(prefix.has_value());
+  EXPECT_EQ(prefix->size(), 40u);
+  EXPECT_EQ(chunk.size(), 60u);
+  EXPECT_EQ(meta_alloc_.allocate_size(), sizeof(Chunk));
+
+  // The buffer is returned to its pool once both chunks are freed.
+  chunk.Release();
+  EXPECT_EQ(pools_[1].available(), 1u);
+  prefix.reset();
+  EXPECT_EQ(pools_[1].available(), 2u);
+}
+
+class AllocateTask : public Task {
+ public:
+  AllocateTask(MultiBufAllocationFuture&& future)
+      : future_(std::move(future)), last_result_(Pending()) {}
+
+  MultiBufAllocationFuture future_;
+  Poll<std::optional<MultiBuf>> last_result_;
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    last_result_ = future_.Pend(cx);
+    if (last_result_.IsReady()) {
+      return Ready();
+    }
+    return Pending();
+  }
+};
+
+TEST_F(PoolMultiBufAllocatorTest, AllocateAsyncWaitsForFreeBuffer) {
+  std::optional<MultiBuf> large = allocator_.Allocate(1500);
+  ASSERT_TRUE(large.has_value());
+
+  AllocateTask task(allocator_.AllocateContiguousAsync(1000));
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsPending());
+
+  // Freeing a buffer that is too small does not complete the allocation.
+  std::optional<MultiBuf> small = allocator_.Allocate(10);
+  ASSERT_TRUE(small.has_value());
+  small.reset();
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsPending());
+
+  large.reset();
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsReady());
+  ASSERT_TRUE(task.last_result_.IsReady());
+  ASSERT_TRUE(task.last_result_->has_value());
+  EXPECT_EQ((*task.last_result_)->size(), 1000u);
+}
+
+TEST_F(PoolMultiBufAllocatorTest, AllocateAsyncTooLargeFails) {
+  AllocateTask task(allocator_.AllocateContiguousAsync(1501));
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsReady());
+  ASSERT_TRUE(task.last_result_.IsReady());
+  EXPECT_FALSE(task.last_result_->has_value());
+}
+
+}  // namespace
+}  // namespace pw::multibuf
@@ -58,6 +58,33 @@ class MultiBufAllocator {
 
   virtual ~MultiBufAllocator() {}
 
+  /// Reserves ``headroom`` bytes in front of and ``tailroom`` bytes after the
+  /// data of each ``MultiBuf`` this allocator returns.
+  ///
+  /// The reserved bytes are not included in the requested or returned size.
+  /// They remain part of the underlying region, so the layers of a protocol
+  /// stack can later add their headers and footers with
+  /// ``MultiBuf::Prepend`` and ``MultiBuf::Append`` without allocating or
+  /// copying the payload. Set the reserve to the total header and footer
+  /// sizes of the layers below the one that allocates.
+  ///
+  /// The headroom is taken from the first ``Chunk`` and the tailroom from the
+  /// last. If a non-contiguous allocation returns a first or last ``Chunk``
+  /// that is too small to hold its reserve, the reserve is discarded from
+  /// several ``Chunk``s instead and only part of it can be reclaimed.
+  ///
+  /// This must not be called concurrently with allocations.
+  void SetReserve(size_t headroom, size_t tailroom) {
+    headroom_ = headroom;
+    tailroom_ = tailroom;
+  }
+
+  /// Returns the bytes reserved in front of each allocated ``MultiBuf``.
+  size_t headroom() const { return headroom_; }
+
+  /// Returns the bytes reserved after each allocated ``MultiBuf``.
+  size_t tailroom() const { return tailroom_; }
+
   ////////////////
   // -- Sync -- //
   ////////////////
@@ -194,6 +221,12 @@ class MultiBufAllocator {
                                           size_t desired_size,
                                           bool needs_contiguous) = 0;
 
+  /// Calls ``DoAllocate`` with room for the headroom and tailroom, then
+  /// removes them from the returned ``MultiBuf``.
+  pw::Result<MultiBuf> AllocateWithReserve(size_t min_size,
+                                           size_t desired_size,
+                                           bool needs_contiguous);
+
   void AddWaiter(internal::AllocationWaiter*) PW_LOCKS_EXCLUDED(lock_);
   void AddWaiterLocked(internal::AllocationWaiter*)
       PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
@@ -203,6 +236,8 @@ class MultiBufAllocator {
 
   sync::InterruptSpinLock lock_;
   internal::AllocationWaiter* first_waiter_ PW_GUARDED_BY(lock_) = nullptr;
+  size_t headroom_ = 0;
+  size_t tailroom_ = 0;
 };
 
 namespace internal {
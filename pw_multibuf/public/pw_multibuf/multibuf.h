@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <limits>
+#include <optional>
 #include <tuple>
 
 #include "pw_multibuf/chunk.h"
@@ -32,9 +34,10 @@ class MultiBuf {
   class ConstChunkIterator;
   class ChunkIterable;
 
-  constexpr MultiBuf() : first_(nullptr) {}
+  constexpr MultiBuf() : first_(nullptr), size_(0) {}
   static MultiBuf FromChunk(OwnedChunk&& chunk) {
     MultiBuf buf;
+    buf.size_ = chunk.size();
     buf.first_ = std::move(chunk).Take();
     return buf;
   }
@@ -44,15 +47,19 @@ class MultiBuf {
   // Disable maybe-uninitialized: this check fails erroniously on Windows GCC.
   PW_MODIFY_DIAGNOSTICS_PUSH();
   PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wmaybe-uninitialized");
-  constexpr MultiBuf(MultiBuf&& other) noexcept : first_(other.first_) {
+  constexpr MultiBuf(MultiBuf&& other) noexcept
+      : first_(other.first_), size_(other.size_) {
     other.first_ = nullptr;
+    other.size_ = 0;
   }
   PW_MODIFY_DIAGNOSTICS_POP();
 
   MultiBuf& operator=(MultiBuf&& other) noexcept {
     Release();
     first_ = other.first_;
+    size_ = other.size_;
     other.first_ = nullptr;
+    other.size_ = 0;
     return *this;
   }
 
@@ -72,13 +79,21 @@ class MultiBuf {
 
   /// Returns the number of bytes in this container.
   ///
-  /// This method's complexity is ``O(Chunks().size())``.
+  /// The size is tracked by the ``MultiBuf`` methods that change it, so this
+  /// method is ``O(1)``. Since a ``Chunk`` can be resized through the mutable
+  /// ``Chunk`` access provided by ``Chunks()``, ``ChunkBegin()``, and
+  /// ``begin()``, calling those methods causes the next call to ``size()`` to
+  /// recount the bytes in ``O(Chunks().size())``.
+  ///
+  /// @warning Do not resize a ``Chunk`` through a reference or iterator that
+  /// was obtained before the most recent call to ``size()`` or ``empty()``.
+  /// Obtain it again instead, so that the size is recounted.
   [[nodiscard]] size_t size() const;
 
   /// Returns whether the container is empty (`size() == 0`).
   ///
-  /// This method's complexity is ``O(Chunks().size())``, but will be more
-  /// efficient than `size() == 0` in most cases.
+  /// This method is ``O(1)`` when ``size()`` is, and otherwise stops at the
+  /// first non-empty ``Chunk``.
   [[nodiscard]] bool empty() const;
 
   /// Returns if the `MultiBuf` is contiguous. A `MultiBuf` is contiguous if it
@@ -109,7 +124,10 @@ class MultiBuf {
   std::optional<ConstByteSpan> ContiguousSpan() const;
 
   /// Returns an iterator pointing to the first byte of this ``MultiBuf`.
-  iterator begin() { return iterator(first_); }
+  iterator begin() {
+    InvalidateSize();
+    return iterator(first_);
+  }
   /// Returns a const iterator pointing to the first byte of this ``MultiBuf`.
   const_iterator begin() const { return const_iterator(first_); }
   /// Returns a const iterator pointing to the first byte of this ``MultiBuf`.
@@ -211,6 +229,50 @@ class MultiBuf {
   /// This operation does not move any data and is ``O(Chunks().size())``.
   void PushSuffix(MultiBuf&& tail);
 
+  /// Writes ``header`` into the bytes immediately preceding this ``MultiBuf``
+  /// and grows the buffer to include them.
+  ///
+  /// The first ``Chunk`` must have at least ``header.size()`` unreferenced
+  /// bytes in front of it, e.g. headroom reserved by
+  /// ``MultiBufAllocator::SetReserve`` or bytes removed with
+  /// ``DiscardPrefix``. This allows each layer of a protocol stack to add its
+  /// header without allocating or copying the payload.
+  ///
+  /// This method will acquire a mutex and is not IRQ safe.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The header was written.
+  ///
+  ///    RESOURCE_EXHAUSTED: There is not enough room in front of the first
+  ///    ``Chunk``. The buffer is unchanged.
+  ///
+  /// @endrst
+  Status Prepend(ConstByteSpan header);
+
+  /// Writes ``footer`` into the bytes immediately following this ``MultiBuf``
+  /// and grows the buffer to include them.
+  ///
+  /// The last ``Chunk`` must have at least ``footer.size()`` unreferenced
+  /// bytes after it, e.g. tailroom reserved by ``MultiBufAllocator::SetReserve``
+  /// or bytes removed with ``Truncate``.
+  ///
+  /// This method will acquire a mutex and is not IRQ safe.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The footer was written.
+  ///
+  ///    RESOURCE_EXHAUSTED: There is not enough room after the last ``Chunk``.
+  ///    The buffer is unchanged.
+  ///
+  /// @endrst
+  Status Append(ConstByteSpan footer);
+
   /// Copies bytes from the multibuf into the provided buffer.
   ///
   /// @param[out] dest Destination into which to copy data from the `MultiBuf`.
@@ -283,6 +345,15 @@ class MultiBuf {
     return CopyFromAndOptionallyTruncate(source, position, /*truncate=*/true);
   }
 
+  /// Searches for a byte, starting at offset ``position``.
+  ///
+  /// Each ``Chunk`` is searched as a contiguous span, so this is much faster
+  /// than comparing each byte through an ``iterator``.
+  ///
+  /// @returns The offset of the first byte at or after ``position`` that is
+  /// equal to ``value``, or ``std::nullopt`` if there is none.
+  std::optional<size_t> Find(std::byte value, size_t position = 0) const;
+
   ///////////////////////////////////////////////////////////////////
   //--------------------- Chunk manipulation ----------------------//
   ///////////////////////////////////////////////////////////////////
@@ -328,14 +399,20 @@ class MultiBuf {
 
   /// Returns an iterable container which yields the ``Chunk``s in this
   /// ``MultiBuf``.
-  constexpr ChunkIterable Chunks() { return ChunkIterable(first_); }
+  constexpr ChunkIterable Chunks() {
+    InvalidateSize();
+    return ChunkIterable(first_);
+  }
 
   /// Returns an iterable container which yields the ``const Chunk``s in
   /// this ``MultiBuf``.
   constexpr const ChunkIterable Chunks() const { return ChunkIterable(first_); }
 
   /// Returns an iterator pointing to the first ``Chunk`` in this ``MultiBuf``.
-  constexpr ChunkIterator ChunkBegin() { return ChunkIterator(first_); }
+  constexpr ChunkIterator ChunkBegin() {
+    InvalidateSize();
+    return ChunkIterator(first_);
+  }
   /// Returns an iterator pointing to the end of the ``Chunk``s in this
   /// ``MultiBuf``.
   constexpr ChunkIterator ChunkEnd() { return ChunkIterator::end(); }
@@ -624,6 +701,24 @@ class MultiBuf {
   };
 
  private:
+  // size_ is set to this when a Chunk may have been resized without the
+  // MultiBuf's knowledge, so the next call to size() must count the bytes.
+  static constexpr size_t kUnknownSize = std::numeric_limits<size_t>::max();
+
+  constexpr void InvalidateSize() { size_ = kUnknownSize; }
+
+  constexpr void GrowSize(size_t bytes) {
+    if (size_ != kUnknownSize) {
+      size_ += bytes;
+    }
+  }
+
+  constexpr void ShrinkSize(size_t bytes) {
+    if (size_ != kUnknownSize) {
+      size_ -= bytes;
+    }
+  }
+
   /// Returns the ``Chunk`` preceding ``chunk`` in this ``MultiBuf``.
   ///
   /// Requires that this ``MultiBuf`` is not empty, and that ``chunk``
@@ -638,6 +733,70 @@ class MultiBuf {
                                                bool truncate);
 
   Chunk* first_;
+
+  // The number of bytes in this MultiBuf, or kUnknownSize. Computed lazily by
+  // size(), which is const, so this is mutable.
+  mutable size_t size_;
+};
+
+/// Reads the bytes of a ``MultiBuf`` one contiguous span at a time.
+///
+/// Parsers and copy loops should use a ``Cursor`` rather than a byte
+/// ``iterator``, so they can process each ``Chunk`` with bulk operations like
+/// ``std::memcpy`` and skip over data a ``Chunk`` at a time.
+///
+/// @code{.cpp}
+///   pw::checksum::Crc32 crc;
+///   for (pw::multibuf::Cursor cursor(multibuf); !cursor.done();) {
+///     pw::ConstByteSpan bytes = cursor.ContiguousSpan();
+///     crc.Update(bytes);
+///     cursor.Skip(bytes.size());
+///   }
+/// @endcode
+///
+/// The ``MultiBuf`` must not be modified while a ``Cursor`` refers to it.
+class Cursor {
+ public:
+  /// Creates a ``Cursor`` at offset ``position`` in ``multibuf``, or at the
+  /// end if ``position`` is past the end.
+  explicit Cursor(const MultiBuf& multibuf, size_t position = 0);
+
+  /// Returns the number of bytes that have been read or skipped.
+  size_t position() const { return position_; }
+
+  /// Returns whether all of the bytes have been read or skipped.
+  bool done() const { return chunk_.chunk() == nullptr; }
+
+  /// Returns the unread bytes of the current ``Chunk``. The span is only
+  /// empty once the ``Cursor`` is ``done()``.
+  ConstByteSpan ContiguousSpan() const {
+    if (done()) {
+      return ConstByteSpan();
+    }
+    return ConstByteSpan(chunk_->data() + offset_, chunk_->size() - offset_);
+  }
+
+  /// Advances past up to ``bytes`` bytes.
+  ///
+  /// This is ``O(1)`` within a ``Chunk`` and skips whole ``Chunk``s at once.
+  ///
+  /// @returns The number of bytes skipped, which is less than ``bytes`` only
+  /// if the end was reached.
+  size_t Skip(size_t bytes);
+
+  /// Copies up to ``dest.size()`` bytes into ``dest`` and advances past them.
+  ///
+  /// @returns The number of bytes copied, which is less than ``dest.size()``
+  /// only if the end was reached.
+  size_t Read(ByteSpan dest);
+
+ private:
+  // Advances to the next Chunk with data, if the current one has been read.
+  void SkipReadChunks();
+
+  MultiBuf::ConstChunkIterator chunk_;
+  size_t offset_ = 0;  // Offset within the current Chunk.
+  size_t position_ = 0;
 };
 
 }  // namespace pw::multibuf
@@ -0,0 +1,188 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/allocator.h"
+#include "pw_bytes/span.h"
+#include "pw_multibuf/allocator.h"
+#include "pw_multibuf/chunk.h"
+#include "pw_multibuf/multibuf.h"
+#include "pw_span/span.h"
+
+namespace pw::multibuf {
+
+namespace internal {
+class PoolRegionTracker;
+}  // namespace internal
+
+/// A ``MultiBufAllocator`` that hands out fixed-size buffers from pools.
+///
+/// The data area is divided into pools of equally sized buffers, e.g. one pool
+/// of 64-byte buffers for acknowledgements and one of 1500-byte buffers for
+/// full frames. Each pool keeps its free buffers in a lock-free list, so taking
+/// a buffer from a pool and returning it take constant time and never wait on
+/// a lock.
+///
+/// - Allocations are served by the smallest free buffer that holds
+///   ``desired_size`` bytes, or else by the largest free buffer that holds
+///   ``min_size`` bytes. The returned ``MultiBuf`` is truncated to the
+///   requested size.
+/// - Non-contiguous allocations that no single buffer can satisfy are made
+///   from several buffers, largest first.
+/// - Each buffer has room for the metadata of one ``Chunk``. Splitting a
+///   buffer into more ``Chunk``s allocates their metadata from
+///   ``metadata_alloc``.
+///
+/// After a buffer is returned to its pool, the allocator briefly takes its
+/// waiter lock to wake any ``MultiBufAllocationFuture`` that may now succeed.
+class PoolMultiBufAllocator : public MultiBufAllocator {
+ public:
+  /// A pool of equally sized buffers.
+  class Pool {
+   public:
+    /// @param[in] buffer_size    The size of each buffer, in bytes.
+    ///
+    /// @param[in] buffer_count   The number of buffers. Must be less than
+    ///   65536.
+    constexpr Pool(size_t buffer_size, size_t buffer_count)
+        : buffer_size_(buffer_size), buffer_count_(buffer_count) {}
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    /// Returns the size of each buffer in this pool.
+    size_t buffer_size() const { return buffer_size_; }
+
+    /// Returns the number of buffers in this pool.
+    size_t buffer_count() const { return buffer_count_; }
+
+    /// Returns the number of buffers that are not in use. This may be stale
+    /// by the time it returns if other threads are allocating or freeing.
+    size_t available() const {
+      return available_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    friend class PoolMultiBufAllocator;
+    friend class internal::PoolRegionTracker;
+
+    /// Removes a buffer from the free list. Returns null if there is none.
+    internal::PoolRegionTracker* Pop();
+
+    /// Returns a buffer to the free list.
+    void Push(internal::PoolRegionTracker& tracker);
+
+    const size_t buffer_size_;
+    const size_t buffer_count_;
+    internal::PoolRegionTracker* trackers_ = nullptr;
+
+    // The free list is a stack of indices into `trackers_`. The head holds the
+    // index of the top buffer in its low 16 bits and a counter that is
+    // incremented by every push and pop in its high 16 bits. The counter keeps
+    // a pop that is preempted between reading the head and swapping it from
+    // succeeding after other pops and pushes have reused that index (the ABA
+    // problem).
+    std::atomic<uint32_t> free_list_ = kEmpty;
+    std::atomic<size_t> available_ = 0;
+
+    static constexpr uint32_t kIndexMask = 0xFFFF;
+    static constexpr uint32_t kEmpty = kIndexMask;
+  };
+
+  /// Creates a new ``PoolMultiBufAllocator``.
+  ///
+  /// @param[in] pools            The pools of buffers, by increasing buffer
+  ///  size. The pools must outlive this allocator.
+  ///
+  /// @param[in] data_area        The region to use for storing buffers. Must be
+  ///  large enough for every buffer of every pool.
+  ///
+  /// @param[in] metadata_alloc   The allocator to use for metadata. This
+  ///  allocator allocates one region tracker per buffer when this allocator is
+  ///  constructed, and any ``Chunk``s beyond the first in a buffer. It *must*
+  ///  be thread-safe if buffers may be split on multiple threads.
+  PoolMultiBufAllocator(span<Pool> pools,
+                        ByteSpan data_area,
+                        pw::allocator::Allocator& metadata_alloc);
+
+  /// All buffers must have been freed before the allocator is destroyed.
+  ~PoolMultiBufAllocator() override;
+
+ private:
+  friend class internal::PoolRegionTracker;
+
+  pw::Result<MultiBuf> DoAllocate(size_t min_size,
+                                  size_t desired_size,
+                                  bool needs_contiguous) final;
+
+  /// Returns a single buffer of at least `min_size` bytes, truncated to at
+  /// most `desired_size` bytes.
+  std::optional<MultiBuf> AllocateBuffer(size_t min_size, size_t desired_size);
+
+  /// Returns several buffers with at least `min_size` bytes in total.
+  pw::Result<MultiBuf> AllocateBuffers(size_t min_size, size_t desired_size);
+
+  /// Returns a buffer to its pool and wakes any waiting allocations.
+  void Release(internal::PoolRegionTracker& tracker);
+
+  span<Pool> pools_;
+  pw::allocator::Allocator& metadata_alloc_;
+  size_t capacity_ = 0;
+};
+
+namespace internal {
+
+/// A ``ChunkRegionTracker`` for one buffer of a ``PoolMultiBufAllocator``.
+class PoolRegionTracker final : public ChunkRegionTracker {
+ public:
+  PoolRegionTracker(PoolMultiBufAllocator& parent,
+                    PoolMultiBufAllocator::Pool& pool,
+                    ByteSpan region,
+                    uint16_t index)
+      : parent_(parent), pool_(pool), region_(region), index_(index) {}
+
+  // PoolRegionTracker is not copyable nor movable.
+  PoolRegionTracker(const PoolRegionTracker&) = delete;
+  PoolRegionTracker& operator=(const PoolRegionTracker&) = delete;
+
+ protected:
+  void Destroy() final;
+  ByteSpan Region() const final { return region_; }
+  void* AllocateChunkClass() final;
+  void DeallocateChunkClass(void*) final;
+
+ private:
+  friend class ::pw::multibuf::PoolMultiBufAllocator;
+  friend class ::pw::multibuf::PoolMultiBufAllocator::Pool;
+
+  PoolMultiBufAllocator& parent_;
+  PoolMultiBufAllocator::Pool& pool_;
+  const ByteSpan region_;
+  const uint16_t index_;
+
+  // The index of the next buffer in the pool's free list. Atomic because a
+  // preempted pop may read it while another thread pushes this buffer.
+  std::atomic<uint16_t> next_free_ = PoolMultiBufAllocator::Pool::kEmpty;
+
+  std::atomic<bool> chunk_in_use_ = false;
+  alignas(Chunk) std::array<std::byte, sizeof(Chunk)> chunk_storage_;
+};
+
+}  // namespace internal
+}  // namespace pw::multibuf
@@ -0,0 +1,309 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_multisink/compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace pw::multisink {
+namespace {
+
+// The LZ4 block format: a series of sequences, each made of a token byte with
+// the literal length in the high nibble and the match length minus kMinMatch
+// in the low nibble, extra literal length bytes, the literals, a 16-bit little
+// endian match offset, and extra match length bytes. The last sequence only
+// has literals. Lengths of 15 continue in the following bytes, each of which
+// is added to the length, until a byte that is not 255.
+constexpr size_t kMinMatch = 4;
+constexpr size_t kMaxOffset = 65535;
+constexpr size_t kLengthMask = 15;
+
+// Matches are not started in the last kMatchStartLimit bytes, and the last
+// kLastLiterals bytes are always literals, as the LZ4 format requires.
+constexpr size_t kMatchStartLimit = 12;
+constexpr size_t kLastLiterals = 5;
+
+// The hash table holds the most recent position of each hashed 4-byte
+// sequence. It is on the stack, so it is kept small.
+constexpr unsigned kHashBits = 8;
+
+// The bytes that matches may refer to: the dictionary followed by the entry.
+class Window {
+ public:
+  Window(ConstByteSpan dictionary, const std::byte* data)
+      : dictionary_(dictionary), data_(data) {}
+
+  std::byte operator[](size_t index) const {
+    return index < dictionary_.size() ? dictionary_[index]
+                                      : data_[index - dictionary_.size()];
+  }
+
+  uint32_t Read32(size_t index) const {
+    uint32_t value = 0;
+    for (size_t i = 0; i < sizeof(value); ++i) {
+      value |= static_cast<uint32_t>((*this)[index + i]) << (8 * i);
+    }
+    return value;
+  }
+
+ private:
+  ConstByteSpan dictionary_;
+  const std::byte* data_;
+};
+
+constexpr size_t Hash(uint32_t value) {
+  return (value * 2654435761u) >> (32 - kHashBits);
+}
+
+// Writes LZ4 sequences to an output buffer, tracking whether they fit.
+class SequenceWriter {
+ public:
+  explicit SequenceWriter(ByteSpan output) : output_(output) {}
+
+  bool ok() const { return ok_; }
+  size_t size() const { return size_; }
+
+  void Sequence(ConstByteSpan literals, size_t offset, size_t match_length) {
+    const size_t match_code = match_length - kMinMatch;
+    Byte(static_cast<std::byte>(
+        (std::min(literals.size(), kLengthMask) << 4) |
+        std::min(match_code, kLengthMask)));
+    Literals(literals);
+    Byte(static_cast<std::byte>(offset & 0xff));
+    Byte(static_cast<std::byte>(offset >> 8));
+    ExtraLength(match_code);
+  }
+
+  void LastSequence(ConstByteSpan literals) {
+    Byte(static_cast<std::byte>(std::min(literals.size(), kLengthMask) << 4));
+    Literals(literals);
+  }
+
+ private:
+  void Literals(ConstByteSpan literals) {
+    ExtraLength(literals.size());
+    if (!ok_ || output_.size() - size_ < literals.size()) {
+      ok_ = false;
+      return;
+    }
+    std::memcpy(output_.data() + size_, literals.data(), literals.size());
+    size_ += literals.size();
+  }
+
+  void ExtraLength(size_t length) {
+    if (length < kLengthMask) {
+      return;
+    }
+    for (length -= kLengthMask; length >= 255; length -= 255) {
+      Byte(std::byte{255});
+    }
+    Byte(static_cast<std::byte>(length));
+  }
+
+  void Byte(std::byte value) {
+    if (!ok_ || size_ == output_.size()) {
+      ok_ = false;
+      return;
+    }
+    output_[size_++] = value;
+  }
+
+  ByteSpan output_;
+  size_t size_ = 0;
+  bool ok_ = true;
+};
+
+// Compresses the entry as an LZ4 block. Returns the block's size, or 0 if it
+// does not fit in `output`.
+size_t CompressBlock(ConstByteSpan entry,
+                     ByteSpan output,
+                     ConstByteSpan dictionary) {
+  const Window window(dictionary, entry.data());
+  const size_t base = dictionary.size();
+
+  // Positions are stored plus one, so that zero marks an empty slot.
+  std::array<size_t, size_t{1} << kHashBits> table{};
+  for (size_t i = 0; i + kMinMatch <= dictionary.size(); ++i) {
+    table[Hash(window.Read32(i))] = i + 1;
+  }
+
+  SequenceWriter writer(output);
+  size_t anchor = 0;
+  size_t pos = 0;
+  while (pos + kMatchStartLimit <= entry.size() && writer.ok()) {
+    const uint32_t value = window.Read32(base + pos);
+    size_t& slot = table[Hash(value)];
+    const size_t candidate = slot;
+    slot = base + pos + 1;
+
+    if (candidate == 0 || base + pos - (candidate - 1) > kMaxOffset ||
+        window.Read32(candidate - 1) != value) {
+      pos += 1;
+      continue;
+    }
+
+    const size_t match_start = candidate - 1;
+    size_t length = kMinMatch;
+    while (pos + length < entry.size() - kLastLiterals &&
+           window[match_start + length] == entry[pos + length]) {
+      length += 1;
+    }
+
+    writer.Sequence(entry.subspan(anchor, pos - anchor),
+                    base + pos - match_start,
+                    length);
+    pos += length;
+    anchor = pos;
+  }
+  writer.LastSequence(entry.subspan(anchor));
+  return writer.ok() ? writer.size() : 0;
+}
+
+// Reads a length that continues in the following bytes if the token's nibble
+// is 15.
+bool ReadLength(ConstByteSpan input, size_t& pos, size_t& length) {
+  if (length != kLengthMask) {
+    return true;
+  }
+  while (pos < input.size()) {
+    const size_t value = static_cast<size_t>(input[pos++]);
+    length += value;
+    if (value != 255) {
+      return true;
+    }
+  }
+  return false;
+}
+
+StatusWithSize DecompressBlock(ConstByteSpan block,
+                               ByteSpan output,
+                               ConstByteSpan dictionary) {
+  const Window window(dictionary, output.data());
+  size_t pos = 0;
+  size_t size = 0;
+  while (pos < block.size()) {
+    const size_t token = static_cast<size_t>(block[pos++]);
+
+    size_t literal_length = token >> 4;
+    if (!ReadLength(block, pos, literal_length) ||
+        block.size() - pos < literal_length) {
+      return StatusWithSize::DataLoss(size);
+    }
+    if (output.size() - size < literal_length) {
+      return StatusWithSize::ResourceExhausted(size);
+    }
+    std::memcpy(output.data() + size, block.data() + pos, literal_length);
+    pos += literal_length;
+    size += literal_length;
+
+    if (pos == block.size()) {
+      return StatusWithSize(size);  // The last sequence has no match.
+    }
+    if (block.size() - pos < 2) {
+      return StatusWithSize::DataLoss(size);
+    }
+    const size_t offset = static_cast<size_t>(block[pos]) |
+                          static_cast<size_t>(block[pos + 1]) << 8;
+    pos += 2;
+    size_t match_length = token & kLengthMask;
+    if (offset == 0 || offset > dictionary.size() + size ||
+        !ReadLength(block, pos, match_length)) {
+      return StatusWithSize::DataLoss(size);
+    }
+    match_length += kMinMatch;
+    if (output.size() - size < match_length) {
+      return StatusWithSize::ResourceExhausted(size);
+    }
+    // Copy byte by byte, since the match may overlap the bytes it produces.
+    const size_t match_start = dictionary.size() + size - offset;
+    for (size_t i = 0; i < match_length; ++i) {
+      output[size] = window[match_start + i];
+      size += 1;
+    }
+  }
+  return StatusWithSize::DataLoss(size);  // The last sequence is missing.
+}
+
+ConstByteSpan LastBytes(ConstByteSpan dictionary) {
+  return dictionary.size() > kMaxOffset ? dictionary.last(kMaxOffset)
+                                        : dictionary;
+}
+
+}  // namespace
+
+StatusWithSize CompressEntry(ConstByteSpan entry,
+                             ByteSpan output,
+                             ConstByteSpan dictionary) {
+  if (output.size() < MaxCompressedEntrySize(entry.size())) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  // Only keep the block if it is smaller than the entry.
+  const size_t block_size =
+      entry.size() < kMinMatch
+          ? 0
+          : CompressBlock(entry,
+                          output.subspan(1, entry.size() - 1),
+                          LastBytes(dictionary));
+  if (block_size != 0) {
+    output[0] = kLz4Entry;
+    return StatusWithSize(1 + block_size);
+  }
+
+  output[0] = kStoredEntry;
+  if (!entry.empty()) {
+    std::memcpy(&output[1], entry.data(), entry.size());
+  }
+  return StatusWithSize(1 + entry.size());
+}
+
+StatusWithSize DecompressEntry(ConstByteSpan compressed,
+                               ByteSpan output,
+                               ConstByteSpan dictionary) {
+  if (compressed.empty()) {
+    return StatusWithSize::DataLoss();
+  }
+  const ConstByteSpan data = compressed.subspan(1);
+  if (compressed[0] == kLz4Entry) {
+    return DecompressBlock(data, output, LastBytes(dictionary));
+  }
+  if (compressed[0] != kStoredEntry) {
+    return StatusWithSize::DataLoss();
+  }
+  if (output.size() < data.size()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  if (!data.empty()) {
+    std::memcpy(output.data(), data.data(), data.size());
+  }
+  return StatusWithSize(data.size());
+}
+
+Status HandleCompressedEntry(MultiSink& multisink,
+                             ConstByteSpan entry,
+                             ByteSpan buffer,
+                             ConstByteSpan dictionary) {
+  const StatusWithSize result = CompressEntry(entry, buffer, dictionary);
+  if (!result.ok()) {
+    multisink.HandleDropped();
+    return result.status();
+  }
+  multisink.HandleEntry(buffer.first(result.size()));
+  return OkStatus();
+}
+
+}  // namespace pw::multisink
@@ -0,0 +1,175 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_multisink/compression.h"
+
+#include <array>
+#include <cstring>
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::multisink {
+namespace {
+
+constexpr std::string_view kRepetitive =
+    "sensor: temperature=21 humidity=40; sensor: temperature=22 humidity=41; "
+    "sensor: temperature=23 humidity=42";
+
+ConstByteSpan Bytes(std::string_view data) {
+  return as_bytes(span(data.data(), data.size()));
+}
+
+bool Equal(ConstByteSpan data, std::string_view expected) {
+  return data.size() == expected.size() &&
+         std::memcmp(data.data(), expected.data(), expected.size()) == 0;
+}
+
+// Compresses and decompresses the entry, and returns the compressed size.
+size_t RoundTrip(std::string_view entry, std::string_view dictionary = {}) {
+  std::array<std::byte, 512> compressed;
+  std::array<std::byte, 512> decompressed;
+  const StatusWithSize compress_result =
+      CompressEntry(Bytes(entry), compressed, Bytes(dictionary));
+  EXPECT_EQ(compress_result.status(), OkStatus());
+  EXPECT_LE(compress_result.size(), MaxCompressedEntrySize(entry.size()));
+
+  const StatusWithSize decompress_result =
+      DecompressEntry(span(compressed).first(compress_result.size()),
+                      decompressed,
+                      Bytes(dictionary));
+  EXPECT_EQ(decompress_result.status(), OkStatus());
+  EXPECT_TRUE(
+      Equal(span(decompressed).first(decompress_result.size()), entry));
+  return compress_result.size();
+}
+
+TEST(Compression, RepetitiveEntryShrinks) {
+  EXPECT_LT(RoundTrip(kRepetitive), kRepetitive.size() * 2 / 3);
+}
+
+TEST(Compression, ShortAndIncompressibleEntriesAreStored) {
+  EXPECT_EQ(RoundTrip(""), 1u);
+  EXPECT_EQ(RoundTrip("abc"), 4u);
+  EXPECT_EQ(RoundTrip("0123456789abcdefghij"), 21u);
+
+  std::array<std::byte, 8> compressed;
+  ASSERT_EQ(CompressEntry(Bytes("abc"), compressed).status(), OkStatus());
+  EXPECT_EQ(compressed[0], kStoredEntry);
+}
+
+TEST(Compression, LongRunsUseExtendedLengths) {
+  const std::string_view kRun(
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"
+      "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab");
+  EXPECT_LT(RoundTrip(kRun), 16u);
+}
+
+TEST(Compression, DictionaryHelpsShortEntries) {
+  constexpr std::string_view kDictionary = "temperature=humidity=sensor: ";
+  constexpr std::string_view kEntry = "sensor: temperature=19";
+  EXPECT_EQ(RoundTrip(kEntry), kEntry.size() + 1);
+  EXPECT_LT(RoundTrip(kEntry, kDictionary), kEntry.size());
+}
+
+TEST(Compression, DecompressRequiresSameDictionary) {
+  constexpr std::string_view kDictionary = "temperature=humidity=sensor: ";
+  std::array<std::byte, 64> compressed;
+  const StatusWithSize result = CompressEntry(
+      Bytes("sensor: temperature=19"), compressed, Bytes(kDictionary));
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(compressed[0], kLz4Entry);
+
+  std::array<std::byte, 64> decompressed;
+  EXPECT_EQ(DecompressEntry(span(compressed).first(result.size()),
+                            decompressed)
+                .status(),
+            Status::DataLoss());
+}
+
+TEST(Compression, BufferTooSmall) {
+  std::array<std::byte, 16> small;
+  EXPECT_EQ(CompressEntry(Bytes(kRepetitive), small).status(),
+            Status::ResourceExhausted());
+
+  std::array<std::byte, 128> compressed;
+  const StatusWithSize result = CompressEntry(Bytes(kRepetitive), compressed);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(
+      DecompressEntry(span(compressed).first(result.size()), small).status(),
+      Status::ResourceExhausted());
+}
+
+TEST(Compression, MalformedEntries) {
+  std::array<std::byte, 64> output;
+  EXPECT_EQ(DecompressEntry({}, output).status(), Status::DataLoss());
+
+  constexpr std::array<std::byte, 2> kUnknownFormat = {std::byte{7},
+                                                       std::byte{0}};
+  EXPECT_EQ(DecompressEntry(kUnknownFormat, output).status(),
+            Status::DataLoss());
+
+  // One literal followed by a match at offset 2, before the start of data.
+  constexpr std::array<std::byte, 5> kBadOffset = {
+      kLz4Entry, std::byte{0x10}, std::byte{'a'}, std::byte{2}, std::byte{0}};
+  EXPECT_EQ(DecompressEntry(kBadOffset, output).status(), Status::DataLoss());
+
+  // A literal length that runs past the end of the block.
+  constexpr std::array<std::byte, 3> kTruncated = {
+      kLz4Entry, std::byte{0x50}, std::byte{'a'}};
+  EXPECT_EQ(DecompressEntry(kTruncated, output).status(), Status::DataLoss());
+}
+
+TEST(Compression, MultiSinkHoldsCompressedEntries) {
+  std::array<std::byte, 256> buffer;
+  MultiSink multisink(buffer);
+  MultiSink::Drain drain;
+  multisink.AttachDrain(drain);
+
+  std::array<std::byte, 128> scratch;
+  ASSERT_EQ(HandleCompressedEntry(multisink, Bytes(kRepetitive), scratch),
+            OkStatus());
+  std::array<std::byte, 4> too_small;
+  EXPECT_EQ(HandleCompressedEntry(multisink, Bytes(kRepetitive), too_small),
+            Status::ResourceExhausted());
+  ASSERT_EQ(HandleCompressedEntry(multisink, Bytes("abc"), scratch),
+            OkStatus());
+
+  // Drains see the compressed entries, and the dropped entry.
+  std::array<std::byte, 128> entry_buffer;
+  std::array<std::byte, 128> decompressed;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  Result<ConstByteSpan> entry =
+      drain.PopEntry(entry_buffer, drop_count, ingress_drop_count);
+  ASSERT_EQ(entry.status(), OkStatus());
+  EXPECT_LT(entry->size(), kRepetitive.size());
+  StatusWithSize result = DecompressEntry(*entry, decompressed);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_TRUE(Equal(span(decompressed).first(result.size()), kRepetitive));
+
+  entry = drain.PopEntry(entry_buffer, drop_count, ingress_drop_count);
+  ASSERT_EQ(entry.status(), OkStatus());
+  EXPECT_EQ(ingress_drop_count, 1u);
+  result = DecompressEntry(*entry, decompressed);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_TRUE(Equal(span(decompressed).first(result.size()), "abc"));
+}
+
+}  // namespace
+}  // namespace pw::multisink
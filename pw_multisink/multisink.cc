@@ -28,10 +28,54 @@ namespace pw {
 namespace multisink {
 
 void MultiSink::HandleEntry(ConstByteSpan entry) {
+  EntryReservation reservation;
+  const Status reserve_status = ReserveEntry(entry.size(), reservation);
+  if (!reserve_status.ok()) {
+    // Entries of interrupted writers may hold the space, in which case the
+    // entry is counted as an ingress drop.
+    PW_DCHECK(reserve_status.IsResourceExhausted());
+    return;
+  }
+
+  // Copy the entry without holding the lock, so that interrupts that write to
+  // the multisink are not blocked by a large entry.
+  reservation.Write(entry);
+  CommitEntry(reservation);
+}
+
+Status MultiSink::ReserveEntry(size_t size_bytes,
+                               EntryReservation& reservation_out) {
   std::lock_guard lock(lock_);
-  const Status push_back_status = ring_buffer_.PushBack(entry, sequence_id_++);
-  PW_DCHECK_OK(push_back_status);
-  NotifyListeners();
+  const Status reserve_status =
+      ring_buffer_.Reserve(size_bytes, reservation_out, sequence_id_);
+  if (!reserve_status.ok()) {
+    // The sequence ID is used anyway, so readers see the entry as dropped.
+    sequence_id_ += 1;
+    total_ingress_drops_ += 1;
+    NotifyListeners();
+    return reserve_status;
+  }
+  if (open_entry_count_ == 0) {
+    first_open_sequence_id_ = sequence_id_;
+  }
+  open_entry_count_ += 1;
+  sequence_id_ += 1;
+  return OkStatus();
+}
+
+void MultiSink::CommitEntry(EntryReservation& reservation) {
+  std::lock_guard lock(lock_);
+  PW_DCHECK_UINT_NE(open_entry_count_, 0);
+  open_entry_count_ -= 1;
+  if (ring_buffer_.Commit(reservation) != 0) {
+    NotifyListeners();
+  }
+}
+
+uint32_t MultiSink::LastPublishedSequenceId() const {
+  // Entries are made visible in order once every open entry is committed, so
+  // drains that caught up have handled the entries before the first open one.
+  return (open_entry_count_ == 0 ? sequence_id_ : first_open_sequence_id_) - 1;
 }
 
 void MultiSink::HandleDropped(uint32_t drop_count) {
@@ -96,7 +140,7 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
   if (peek_status.IsOutOfRange()) {
     // If the drain has caught up, report the last handled sequence ID so that
     // it can still process any dropped entries.
-    entry_sequence_id_out = sequence_id_ - 1;
+    entry_sequence_id_out = LastPublishedSequenceId();
   } else if (!peek_status.ok()) {
     // Discard the entry if the result isn't OK or OUT_OF_RANGE and exit, as the
     // entry_sequence_id_out cannot be used for computation. Later invocations
@@ -105,6 +149,134 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
     return peek_status;
   }
 
+  ComputeDropCounts(drain,
+                    entry_sequence_id_out,
+                    peek_status.ok(),
+                    drain_drop_count_out,
+                    ingress_drop_count_out,
+                    drain.last_handled_ingress_drop_count_);
+
+  // The Peek above may have failed due to OutOfRange, now that we've set the
+  // drop count see if we should return before attempting to pop.
+  if (peek_status.IsOutOfRange()) {
+    // No more entries, update the drain.
+    drain.last_handled_sequence_id_ = entry_sequence_id_out;
+    return peek_status;
+  }
+  if (request == Request::kPop) {
+    PW_CHECK(drain.reader_.PopFront().ok());
+    drain.last_handled_sequence_id_ = entry_sequence_id_out;
+  }
+  return as_bytes(buffer.first(bytes_read));
+}
+
+Result<MultiSink::Drain::PeekedEntries> MultiSink::PeekEntries(
+    Drain& drain,
+    span<Drain::PeekedEntries::Entry> entries_out,
+    size_t max_bytes,
+    uint32_t& drain_drop_count_out,
+    uint32_t& ingress_drop_count_out) {
+  drain_drop_count_out = 0;
+  ingress_drop_count_out = 0;
+  if (entries_out.empty()) {
+    return Status::InvalidArgument();
+  }
+
+  std::lock_guard lock(lock_);
+  PW_DCHECK_PTR_EQ(drain.multisink_, this);
+
+  ring_buffer::PrefixedEntryRingBufferMulti::EntryRun run;
+  const Status peek_status = drain.reader_.PeekFrontEntries(run, max_bytes);
+  uint32_t entry_sequence_id = 0;
+  if (peek_status.ok()) {
+    entry_sequence_id = run.begin()->preamble;
+  } else if (peek_status.IsResourceExhausted()) {
+    PW_CHECK_OK(drain.reader_.PeekFrontPreamble(entry_sequence_id));
+  } else if (peek_status.IsOutOfRange()) {
+    // Report the last handled sequence ID, as in PeekOrPopEntry().
+    entry_sequence_id = LastPublishedSequenceId();
+  } else {
+    return peek_status;
+  }
+
+  uint32_t handled_ingress_drop_count;
+  ComputeDropCounts(drain,
+                    entry_sequence_id,
+                    !peek_status.IsOutOfRange(),
+                    drain_drop_count_out,
+                    ingress_drop_count_out,
+                    handled_ingress_drop_count);
+
+  if (!peek_status.ok()) {
+    // The drain caught up, or the front entry is discarded. Either way, there
+    // is no batch to pop, so the drops are handled now.
+    if (peek_status.IsResourceExhausted()) {
+      PW_CHECK_OK(drain.reader_.PopFront());
+    }
+    drain.last_handled_sequence_id_ = entry_sequence_id;
+    drain.last_handled_ingress_drop_count_ = handled_ingress_drop_count;
+    return peek_status;
+  }
+
+  // Collect entries until the first gap in sequence IDs, which can only be
+  // caused by ingress drops, so that the batch's entries are consecutive.
+  size_t entry_count = 0;
+  size_t batch_bytes = 0;
+  for (const Drain::PeekedEntries::Entry& entry : run) {
+    if (entry_count == entries_out.size() ||
+        entry.preamble !=
+            static_cast<uint32_t>(entry_sequence_id + entry_count)) {
+      break;
+    }
+    entries_out[entry_count++] = entry;
+    batch_bytes += varint::EncodedSize(entry.preamble) +
+                   varint::EncodedSize(entry.size_bytes()) + entry.size_bytes();
+  }
+  if (entry_count < run.entry_count()) {
+    // Shorten the run to the batch, so it can be popped in one step.
+    PW_CHECK_OK(drain.reader_.PeekFrontEntries(run, batch_bytes));
+  }
+  return Drain::PeekedEntries(
+      entries_out.first(entry_count), run, handled_ingress_drop_count);
+}
+
+Status MultiSink::PopEntries(Drain& drain,
+                             const Drain::PeekedEntries& entries,
+                             size_t count) {
+  PW_DCHECK_UINT_LE(count, entries.entries().size());
+  std::lock_guard lock(lock_);
+  PW_DCHECK_PTR_EQ(drain.multisink_, this);
+
+  if (count > 0) {
+    // The batch is intact as long as its first entry is still at the front of
+    // the drain, since the ring buffer only overwrites entries after pushing
+    // every reader past them.
+    uint32_t front_sequence_id;
+    if (!drain.reader_.PeekFrontPreamble(front_sequence_id).ok() ||
+        front_sequence_id != entries.first_sequence_id()) {
+      return Status::DataLoss();
+    }
+    if (count == entries.entries().size()) {
+      PW_CHECK_OK(drain.reader_.PopFrontEntries(entries.run_));
+    } else {
+      for (size_t i = 0; i < count; ++i) {
+        PW_CHECK_OK(drain.reader_.PopFront());
+      }
+    }
+  }
+  drain.last_handled_sequence_id_ =
+      entries.first_sequence_id() + static_cast<uint32_t>(count) - 1;
+  drain.last_handled_ingress_drop_count_ = entries.handled_ingress_drop_count_;
+  return OkStatus();
+}
+
+void MultiSink::ComputeDropCounts(
+    const Drain& drain,
+    uint32_t entry_sequence_id,
+    bool entry_available,
+    uint32_t& drain_drop_count_out,
+    uint32_t& ingress_drop_count_out,
+    uint32_t& handled_ingress_drop_count_out) const {
   // Compute the drop count delta by comparing this entry's sequence ID with the
   // last sequence ID this drain successfully read.
   //
@@ -112,38 +284,29 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
   // current and last sequence IDs. Consecutive successful reads will always
   // differ by one at least, so it is subtracted out. If the read was not
   // successful, the difference is not adjusted.
-  drain_drop_count_out = entry_sequence_id_out -
-                         drain.last_handled_sequence_id_ -
-                         (peek_status.ok() ? 1 : 0);
+  uint32_t drain_drop_count = entry_sequence_id -
+                              drain.last_handled_sequence_id_ -
+                              (entry_available ? 1 : 0);
+  uint32_t ingress_drop_count = 0;
+  uint32_t handled_ingress_drop_count = drain.last_handled_ingress_drop_count_;
 
   // Only report the ingress drop count when the drain catches up to where the
   // drop happened, accounting only for the drops found and no more, as
   // indicated by the gap in sequence IDs.
-  if (drain_drop_count_out > 0) {
-    ingress_drop_count_out =
-        std::min(drain_drop_count_out,
+  if (drain_drop_count > 0) {
+    ingress_drop_count =
+        std::min(drain_drop_count,
                  total_ingress_drops_ - drain.last_handled_ingress_drop_count_);
-    // Remove the ingress drop count duplicated in drain_drop_count_out.
-    drain_drop_count_out -= ingress_drop_count_out;
+    // Remove the ingress drop count duplicated in drain_drop_count.
+    drain_drop_count -= ingress_drop_count;
     // Check if all the ingress drops were reported.
-    drain.last_handled_ingress_drop_count_ =
-        total_ingress_drops_ > ingress_drop_count_out
-            ? total_ingress_drops_ - ingress_drop_count_out
-            : total_ingress_drops_;
+    handled_ingress_drop_count = total_ingress_drops_ > ingress_drop_count
+                                     ? total_ingress_drops_ - ingress_drop_count
+                                     : total_ingress_drops_;
   }
-
-  // The Peek above may have failed due to OutOfRange, now that we've set the
-  // drop count see if we should return before attempting to pop.
-  if (peek_status.IsOutOfRange()) {
-    // No more entries, update the drain.
-    drain.last_handled_sequence_id_ = entry_sequence_id_out;
-    return peek_status;
-  }
-  if (request == Request::kPop) {
-    PW_CHECK(drain.reader_.PopFront().ok());
-    drain.last_handled_sequence_id_ = entry_sequence_id_out;
-  }
-  return as_bytes(buffer.first(bytes_read));
+  drain_drop_count_out = drain_drop_count;
+  ingress_drop_count_out = ingress_drop_count;
+  handled_ingress_drop_count_out = handled_ingress_drop_count;
 }
 
 void MultiSink::AttachDrain(Drain& drain) {
@@ -153,7 +316,7 @@ void MultiSink::AttachDrain(Drain& drain) {
 
   PW_CHECK_OK(ring_buffer_.AttachReader(drain.reader_));
   if (&drain == &oldest_entry_drain_) {
-    drain.last_handled_sequence_id_ = sequence_id_ - 1;
+    drain.last_handled_sequence_id_ = LastPublishedSequenceId();
   } else {
     drain.last_handled_sequence_id_ =
         oldest_entry_drain_.last_handled_sequence_id_;
@@ -247,6 +410,25 @@ Result<MultiSink::Drain::PeekedEntry> MultiSink::Drain::PeekEntry(
   return PeekedEntry(peek_result.value(), entry_sequence_id_out);
 }
 
+Result<MultiSink::Drain::PeekedEntries> MultiSink::Drain::PeekEntries(
+    span<PeekedEntries::Entry> entries_out,
+    size_t max_bytes,
+    uint32_t& drain_drop_count_out,
+    uint32_t& ingress_drop_count_out) {
+  PW_DCHECK_NOTNULL(multisink_);
+  return multisink_->PeekEntries(*this,
+                                 entries_out,
+                                 max_bytes,
+                                 drain_drop_count_out,
+                                 ingress_drop_count_out);
+}
+
+Status MultiSink::Drain::PopEntries(const PeekedEntries& entries,
+                                    size_t count) {
+  PW_DCHECK_NOTNULL(multisink_);
+  return multisink_->PopEntries(*this, entries, count);
+}
+
 Result<ConstByteSpan> MultiSink::Drain::PopEntry(
     ByteSpan buffer,
     uint32_t& drain_drop_count_out,
@@ -17,6 +17,7 @@
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <optional>
 #include <string_view>
 
@@ -581,6 +582,287 @@ TEST_F(MultiSinkTest, DrainUnreadEntriesSize) {
   EXPECT_EQ(drains_[1].GetUnreadEntriesCount(), 2u);
 }
 
+TEST_F(MultiSinkTest, PeekEntriesNoEntries) {
+  multisink_.AttachDrain(drains_[0]);
+
+  std::array<Drain::PeekedEntries::Entry, 4> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  EXPECT_EQ(drains_[0]
+                .PeekEntries(entries,
+                             std::numeric_limits<size_t>::max(),
+                             drop_count,
+                             ingress_drop_count)
+                .status(),
+            Status::OutOfRange());
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 0u);
+
+  EXPECT_EQ(drains_[0]
+                .PeekEntries(span<Drain::PeekedEntries::Entry>(),
+                             std::numeric_limits<size_t>::max(),
+                             drop_count,
+                             ingress_drop_count)
+                .status(),
+            Status::InvalidArgument());
+}
+
+TEST_F(MultiSinkTest, PeekAndPopEntries) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachDrain(drains_[1]);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(kMessageOther);
+  multisink_.HandleEntry(kMessage);
+
+  std::array<Drain::PeekedEntries::Entry, 4> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  Result<Drain::PeekedEntries> batch =
+      drains_[0].PeekEntries(entries,
+                             std::numeric_limits<size_t>::max(),
+                             drop_count,
+                             ingress_drop_count);
+  ASSERT_EQ(batch.status(), OkStatus());
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 0u);
+  ASSERT_EQ(batch.value().entries().size(), 3u);
+  for (size_t i = 0; i < 3; ++i) {
+    const Drain::PeekedEntries::Entry& entry = batch.value().entries()[i];
+    ConstByteSpan expected = i == 1 ? ConstByteSpan(kMessageOther)
+                                    : ConstByteSpan(kMessage);
+    ASSERT_EQ(entry.data[0].size(), expected.size());
+    EXPECT_TRUE(entry.data[1].empty());
+    EXPECT_EQ(
+        std::memcmp(entry.data[0].data(), expected.data(), expected.size()),
+        0);
+  }
+
+  // Peeking again returns the same batch.
+  batch = drains_[0].PeekEntries(entries,
+                                 std::numeric_limits<size_t>::max(),
+                                 drop_count,
+                                 ingress_drop_count);
+  ASSERT_EQ(batch.status(), OkStatus());
+  EXPECT_EQ(batch.value().entries().size(), 3u);
+
+  ASSERT_EQ(drains_[0].PopEntries(batch.value()), OkStatus());
+  EXPECT_EQ(drains_[0].GetUnreadEntriesCount(), 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u, 0u);
+
+  // The other drain is not affected.
+  EXPECT_EQ(drains_[1].GetUnreadEntriesCount(), 3u);
+  VerifyPopEntry(drains_[1], kMessage, 0u, 0u);
+}
+
+TEST_F(MultiSinkTest, PeekEntriesLimits) {
+  multisink_.AttachDrain(drains_[0]);
+  for (size_t i = 0; i < 4; ++i) {
+    multisink_.HandleEntry(kMessage);
+  }
+
+  // Limited by the number of entries.
+  std::array<Drain::PeekedEntries::Entry, 3> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  Result<Drain::PeekedEntries> batch =
+      drains_[0].PeekEntries(entries,
+                             std::numeric_limits<size_t>::max(),
+                             drop_count,
+                             ingress_drop_count);
+  ASSERT_EQ(batch.status(), OkStatus());
+  EXPECT_EQ(batch.value().entries().size(), 3u);
+
+  // Limited by size. Each entry has a byte for its sequence ID and size.
+  const size_t entry_size = sizeof(kMessage) + 2;
+  batch = drains_[0].PeekEntries(
+      entries, 2 * entry_size + 1, drop_count, ingress_drop_count);
+  ASSERT_EQ(batch.status(), OkStatus());
+  EXPECT_EQ(batch.value().entries().size(), 2u);
+
+  // Pop only one of the entries.
+  ASSERT_EQ(drains_[0].PopEntries(batch.value(), 1), OkStatus());
+  EXPECT_EQ(drains_[0].GetUnreadEntriesCount(), 3u);
+
+  batch = drains_[0].PeekEntries(entries,
+                                 std::numeric_limits<size_t>::max(),
+                                 drop_count,
+                                 ingress_drop_count);
+  ASSERT_EQ(batch.status(), OkStatus());
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(batch.value().entries().size(), 3u);
+}
+
+TEST_F(MultiSinkTest, PeekEntriesStopsAtIngressDrop) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleDropped(2);
+  multisink_.HandleEntry(kMessageOther);
+
+  std::array<Drain::PeekedEntries::Entry, 4> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  Result<Drain::PeekedEntries> batch =
+      drains_[0].PeekEntries(entries,
+                             std::numeric_limits<size_t>::max(),
+                             drop_count,
+                             ingress_drop_count);
+  ASSERT_EQ(batch.status(), OkStatus());
+  EXPECT_EQ(batch.value().entries().size(), 2u);
+  ASSERT_EQ(drains_[0].PopEntries(batch.value()), OkStatus());
+
+  // The drop is reported with the following batch.
+  batch = drains_[0].PeekEntries(entries,
+                                 std::numeric_limits<size_t>::max(),
+                                 drop_count,
+                                 ingress_drop_count);
+  ASSERT_EQ(batch.status(), OkStatus());
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 2u);
+  ASSERT_EQ(batch.value().entries().size(), 1u);
+  EXPECT_EQ(batch.value().entries()[0].data[0].size(), sizeof(kMessageOther));
+  ASSERT_EQ(drains_[0].PopEntries(batch.value()), OkStatus());
+
+  EXPECT_EQ(drains_[0]
+                .PeekEntries(entries,
+                             std::numeric_limits<size_t>::max(),
+                             drop_count,
+                             ingress_drop_count)
+                .status(),
+            Status::OutOfRange());
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 0u);
+}
+
+TEST_F(MultiSinkTest, PeekEntriesFrontEntryTooLarge) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.HandleEntry(kMessage);
+  multisink_.HandleEntry(ConstByteSpan(kMessage).first(1));
+
+  // The front entry is discarded.
+  std::array<Drain::PeekedEntries::Entry, 4> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  EXPECT_EQ(drains_[0]
+                .PeekEntries(entries, 4, drop_count, ingress_drop_count)
+                .status(),
+            Status::ResourceExhausted());
+
+  // The discarded entry is not reported as a drop.
+  Result<Drain::PeekedEntries> batch =
+      drains_[0].PeekEntries(entries, 4, drop_count, ingress_drop_count);
+  ASSERT_EQ(batch.status(), OkStatus());
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 0u);
+  EXPECT_EQ(batch.value().entries().size(), 1u);
+}
+
+TEST_F(MultiSinkTest, ReserveAndCommitEntry) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachListener(listeners_[0]);
+  ExpectNotificationCount(listeners_[0], 1u);
+
+  MultiSink::EntryReservation reservation;
+  ASSERT_EQ(multisink_.ReserveEntry(sizeof(kMessage), reservation),
+            OkStatus());
+  reservation.Write(kMessage);
+  ExpectNotificationCount(listeners_[0], 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u, 0u);
+
+  multisink_.CommitEntry(reservation);
+  ExpectNotificationCount(listeners_[0], 1u);
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+}
+
+TEST_F(MultiSinkTest, InterruptedWriterPublishesInOrder) {
+  multisink_.AttachDrain(drains_[0]);
+  multisink_.AttachListener(listeners_[0]);
+  ExpectNotificationCount(listeners_[0], 1u);
+
+  // An entry written while another writer copies its entry is held back.
+  MultiSink::EntryReservation reservation;
+  ASSERT_EQ(multisink_.ReserveEntry(sizeof(kMessage), reservation),
+            OkStatus());
+  multisink_.HandleEntry(kMessageOther);
+  ExpectNotificationCount(listeners_[0], 0u);
+  EXPECT_EQ(drains_[0].GetUnreadEntriesCount(), 0u);
+
+  reservation.Write(kMessage);
+  multisink_.CommitEntry(reservation);
+  ExpectNotificationCount(listeners_[0], 1u);
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+  VerifyPopEntry(drains_[0], kMessageOther, 0u, 0u);
+}
+
+TEST(ReserveEntry, OpenReservationCausesIngressDrop) {
+  std::array<std::byte, 16> buffer;
+  MultiSink multisink(buffer);
+  Drain drain;
+  multisink.AttachDrain(drain);
+
+  constexpr std::byte kEntry[] = {std::byte{1}, std::byte{2}, std::byte{3}};
+  MultiSink::EntryReservation reservation;
+  ASSERT_EQ(multisink.ReserveEntry(10, reservation), OkStatus());
+
+  // The open reservation leaves no space for the entry.
+  multisink.HandleEntry(kEntry);
+  multisink.CommitEntry(reservation);
+
+  std::array<std::byte, 16> entry_buffer;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  Result<ConstByteSpan> result =
+      drain.PopEntry(entry_buffer, drop_count, ingress_drop_count);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.value().size(), 10u);
+
+  multisink.HandleEntry(kEntry);
+  result = drain.PopEntry(entry_buffer, drop_count, ingress_drop_count);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 1u);
+}
+
+TEST(PeekEntries, OverwrittenBatch) {
+  std::array<std::byte, 32> buffer;
+  MultiSink multisink(buffer);
+  Drain drain;
+  multisink.AttachDrain(drain);
+
+  constexpr std::byte kEntry[] = {std::byte{1}, std::byte{2}, std::byte{3}};
+  for (size_t i = 0; i < 3; ++i) {
+    multisink.HandleEntry(kEntry);
+  }
+
+  std::array<Drain::PeekedEntries::Entry, 8> entries;
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  Result<Drain::PeekedEntries> batch =
+      drain.PeekEntries(entries,
+                        std::numeric_limits<size_t>::max(),
+                        drop_count,
+                        ingress_drop_count);
+  ASSERT_EQ(batch.status(), OkStatus());
+  EXPECT_EQ(batch.value().entries().size(), 3u);
+
+  // Entries take 5 bytes each, so the seventh entry evicts the first.
+  for (size_t i = 0; i < 4; ++i) {
+    multisink.HandleEntry(kEntry);
+  }
+  EXPECT_EQ(drain.PopEntries(batch.value()), Status::DataLoss());
+
+  // The lost entry is reported when peeking again.
+  batch = drain.PeekEntries(entries,
+                            std::numeric_limits<size_t>::max(),
+                            drop_count,
+                            ingress_drop_count);
+  ASSERT_EQ(batch.status(), OkStatus());
+  EXPECT_EQ(drop_count, 1u);
+  EXPECT_EQ(ingress_drop_count, 0u);
+  EXPECT_EQ(batch.value().entries().size(), 6u);
+  EXPECT_EQ(drain.PopEntries(batch.value()), OkStatus());
+}
+
 TEST(UnsafeGetUnreadEntriesSize, ReadFromListener) {
   std::array<std::byte, 32> buffer;
   MultiSink multisink(buffer);
@@ -0,0 +1,73 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_multisink/multisink.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::multisink {
+
+// Compressed entries start with one of these bytes, followed by the entry as
+// is, or by an LZ4 block.
+inline constexpr std::byte kStoredEntry{0};
+inline constexpr std::byte kLz4Entry{1};
+
+// The largest size of an entry of `entry_size` bytes once compressed. Entries
+// that do not compress are stored as is, so this is only one byte more.
+constexpr size_t MaxCompressedEntrySize(size_t entry_size) {
+  return entry_size + 1;
+}
+
+// Compresses an entry independently of other entries, so that it can be
+// decompressed even if the entries before it were dropped. Matches may refer
+// to the last 64 KiB of `dictionary`, which should hold data that is common to
+// many entries, such as encoded field tags, module names and common strings.
+// The same dictionary must be passed to DecompressEntry().
+//
+// Returns:
+//   OK - The compressed entry was written to `output`.
+//   RESOURCE_EXHAUSTED - `output` is smaller than MaxCompressedEntrySize().
+StatusWithSize CompressEntry(ConstByteSpan entry,
+                             ByteSpan output,
+                             ConstByteSpan dictionary = {});
+
+// Decompresses an entry compressed with CompressEntry(). This may be used on
+// the device, or on the host to decode entries forwarded by drains.
+//
+// Returns:
+//   OK - The entry was written to `output`.
+//   RESOURCE_EXHAUSTED - The entry does not fit in `output`.
+//   DATA_LOSS - The compressed entry is malformed.
+StatusWithSize DecompressEntry(ConstByteSpan compressed,
+                               ByteSpan output,
+                               ConstByteSpan dictionary = {});
+
+// Compresses an entry into `buffer` and writes it to the multisink, which then
+// holds more entries in the same space. Drains return the compressed entries,
+// so their readers must decompress them with DecompressEntry().
+//
+// Returns:
+//   OK - The entry was passed to MultiSink::HandleEntry().
+//   RESOURCE_EXHAUSTED - `buffer` is smaller than MaxCompressedEntrySize().
+//   The entry is counted as dropped.
+Status HandleCompressedEntry(MultiSink& multisink,
+                             ConstByteSpan entry,
+                             ByteSpan buffer,
+                             ConstByteSpan dictionary = {});
+
+}  // namespace pw::multisink
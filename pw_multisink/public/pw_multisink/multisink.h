@@ -33,9 +33,15 @@ namespace multisink {
 // scenarios where readers need to be aware of the input message sequence.
 //
 // This class is thread-safe but NOT IRQ-safe when
-// PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled.
+// PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled. Writers only hold the lock to
+// reserve and to commit space for an entry, not while copying it, so writing
+// large entries does not block interrupts that write to the multisink.
 class MultiSink {
  public:
+  // Space reserved for an entry with ReserveEntry().
+  using EntryReservation =
+      ring_buffer::PrefixedEntryRingBufferMulti::Reservation;
+
   // An asynchronous reader which is attached to a MultiSink via AttachDrain.
   // Each Drain holds a PrefixedEntryRingBufferMulti::Reader and abstracts away
   // entry sequence information for clients when popping.
@@ -61,6 +67,43 @@ class MultiSink {
       const uint32_t sequence_id_;
     };
 
+    // Holds the context for a batch of consecutive entries peeked with
+    // `PeekEntries`, that the user may pass to `PopEntries` to advance the
+    // drain.
+    //
+    // The entries are not copied: each entry's data refers to the multisink's
+    // buffer, and is split in two spans if it wraps around the end of the
+    // buffer. The data is read without holding the multisink's lock, so it may
+    // be overwritten by new entries if the drain falls behind. `PopEntries`
+    // reports whether that happened.
+    class PeekedEntries {
+     public:
+      using Entry = ring_buffer::PrefixedEntryRingBufferMulti::EntryRun::Entry;
+
+      // The peeked entries, oldest first. An entry's `preamble` holds its
+      // sequence ID.
+      span<const Entry> entries() const { return entries_; }
+
+     private:
+      friend MultiSink;
+      friend MultiSink::Drain;
+
+      constexpr PeekedEntries(
+          span<const Entry> entries,
+          const ring_buffer::PrefixedEntryRingBufferMulti::EntryRun& run,
+          uint32_t handled_ingress_drop_count)
+          : entries_(entries),
+            run_(run),
+            handled_ingress_drop_count_(handled_ingress_drop_count) {}
+
+      uint32_t first_sequence_id() const { return entries_.front().preamble; }
+
+      span<const Entry> entries_;
+      ring_buffer::PrefixedEntryRingBufferMulti::EntryRun run_;
+      // The drain's ingress drop count once the batch is handled.
+      uint32_t handled_ingress_drop_count_;
+    };
+
     constexpr Drain()
         : last_handled_sequence_id_(0),
           last_peek_sequence_id_(0),
@@ -198,6 +241,56 @@ class MultiSink {
                                   uint32_t& ingress_drop_count_out)
         PW_LOCKS_EXCLUDED(multisink_->lock_);
 
+    // Peeks a batch of consecutive entries from the front of the drain, with
+    // a single acquisition of the multisink's lock, and without copying them.
+    // The batch holds at most `entries_out.size()` entries, whose sizes,
+    // including the multisink's per-entry overhead, add up to at most
+    // `max_bytes`. The batch ends early at a gap in the sequence IDs, so the
+    // drop counts only ever refer to entries before the batch.
+    //
+    // The drop counts are set as in `PeekEntry`. They are not marked as
+    // handled until the batch is passed to `PopEntries`, except when the
+    // drain has caught up or the front entry is discarded.
+    //
+    // Precondition: the buffer data must not be corrupt, otherwise there will
+    // be a crash.
+    //
+    // Return values:
+    // OK - At least one entry was peeked.
+    // OUT_OF_RANGE - No entries were available.
+    // FAILED_PRECONDITION - The drain must be attached to a sink.
+    // INVALID_ARGUMENT - `entries_out` is empty.
+    // RESOURCE_EXHAUSTED - The front entry is larger than `max_bytes`, and was
+    // discarded.
+    Result<PeekedEntries> PeekEntries(span<PeekedEntries::Entry> entries_out,
+                                      size_t max_bytes,
+                                      uint32_t& drain_drop_count_out,
+                                      uint32_t& ingress_drop_count_out)
+        PW_LOCKS_EXCLUDED(multisink_->lock_);
+
+    // Removes the first `count` entries of a batch peeked with `PeekEntries`
+    // from the multisink, marking the drops reported with the batch as
+    // handled. Popping zero entries only marks the drops as handled.
+    //
+    // If the drain was advanced past the batch's first entry after it was
+    // peeked, the batch's data may have been overwritten while it was being
+    // read, and must be discarded. Nothing is removed, and the next peek
+    // reports the lost entries as drops.
+    //
+    // Precondition: the buffer data must not be corrupt, otherwise there will
+    // be a crash.
+    //
+    // Return values:
+    // OK - The entries were removed from the multisink successfully.
+    // FAILED_PRECONDITION - The drain must be attached to a sink.
+    // DATA_LOSS - The batch was overwritten after being peeked.
+    Status PopEntries(const PeekedEntries& entries, size_t count)
+        PW_LOCKS_EXCLUDED(multisink_->lock_);
+    Status PopEntries(const PeekedEntries& entries)
+        PW_LOCKS_EXCLUDED(multisink_->lock_) {
+      return PopEntries(entries, entries.entries().size());
+    }
+
     // Drains are not copyable or movable.
     Drain(const Drain&) = delete;
     Drain& operator=(const Drain&) = delete;
@@ -344,7 +437,9 @@ class MultiSink {
 #endif
         ring_buffer_(true),
         sequence_id_(0),
-        total_ingress_drops_(0) {
+        total_ingress_drops_(0),
+        open_entry_count_(0),
+        first_open_sequence_id_(0) {
     PW_ASSERT(ring_buffer_.SetBuffer(buffer).ok());
     AttachDrain(oldest_entry_drain_);
   }
@@ -355,11 +450,40 @@ class MultiSink {
   // The sequence ID of the multisink will always increment as a result of
   // calling HandleEntry, regardless of whether pushing the entry succeeds.
   //
+  // The entry is copied without holding the lock. It becomes visible to
+  // drains once it and any entries being written by interrupted writers are
+  // committed. If those entries take up the rest of the buffer, the entry is
+  // counted as an ingress drop.
+  //
   // Precondition: If PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled, this
   // function must not be called from an interrupt context.
   // Precondition: entry.size() <= `ring_buffer_` size
   void HandleEntry(ConstByteSpan entry) PW_LOCKS_EXCLUDED(lock_);
 
+  // Reserves space for an entry of size_bytes, which the caller fills in
+  // place, e.g. by encoding directly into it, then commits with CommitEntry().
+  // The lock is only held while reserving and committing. As with
+  // HandleEntry(), the oldest entries are discarded to make space and the
+  // sequence ID always increments. If no space is reserved, the entry is
+  // counted as an ingress drop.
+  //
+  // Precondition: If PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled, this
+  // function must not be called from an interrupt context.
+  // Precondition: reservation_out is not open.
+  //
+  // Return values:
+  // OK - Space for the entry was reserved.
+  // OUT_OF_RANGE - The entry is larger than the ring buffer.
+  // RESOURCE_EXHAUSTED - Entries that are still being written hold the space.
+  Status ReserveEntry(size_t size_bytes, EntryReservation& reservation_out)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  // Commits an entry reserved with ReserveEntry(). Listeners are notified
+  // once the entry, and any entries reserved before it, are committed.
+  //
+  // Precondition: reservation was returned by ReserveEntry() and is open.
+  void CommitEntry(EntryReservation& reservation) PW_LOCKS_EXCLUDED(lock_);
+
   // Notifies the multisink of messages dropped before ingress. The writer
   // may use this to signal to readers that an entry (or entries) failed
   // before being sent to the multisink (e.g. the writer failed to encode
@@ -443,16 +567,51 @@ class MultiSink {
                                        uint32_t& entry_sequence_id_out)
       PW_LOCKS_EXCLUDED(lock_);
 
+  // Peeks a batch of entries from the provided drain. See
+  // `Drain::PeekEntries`.
+  Result<Drain::PeekedEntries> PeekEntries(
+      Drain& drain,
+      span<Drain::PeekedEntries::Entry> entries_out,
+      size_t max_bytes,
+      uint32_t& drain_drop_count_out,
+      uint32_t& ingress_drop_count_out) PW_LOCKS_EXCLUDED(lock_);
+
+  // Removes the first `count` entries of a peeked batch from the front of the
+  // multisink.
+  Status PopEntries(Drain& drain,
+                    const Drain::PeekedEntries& entries,
+                    size_t count) PW_LOCKS_EXCLUDED(lock_);
+
  private:
+  // Computes the drop counts of a drain, given the sequence ID of either the
+  // drain's next entry, or the last handled sequence ID if there are no
+  // entries. `handled_ingress_drop_count_out` is set to the drain's ingress
+  // drop count once these drops are handled.
+  void ComputeDropCounts(const Drain& drain,
+                         uint32_t entry_sequence_id,
+                         bool entry_available,
+                         uint32_t& drain_drop_count_out,
+                         uint32_t& ingress_drop_count_out,
+                         uint32_t& handled_ingress_drop_count_out) const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Notifies attached listeners of new entries or an updated drop count.
   void NotifyListeners() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Returns the sequence ID of the newest entry that is visible to drains, or
+  // was dropped before any open entry.
+  uint32_t LastPublishedSequenceId() const PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   LockType lock_;
   IntrusiveList<Listener> listeners_ PW_GUARDED_BY(lock_);
   ring_buffer::PrefixedEntryRingBufferMulti ring_buffer_ PW_GUARDED_BY(lock_);
   Drain oldest_entry_drain_ PW_GUARDED_BY(lock_);
   uint32_t sequence_id_ PW_GUARDED_BY(lock_);
   uint32_t total_ingress_drops_ PW_GUARDED_BY(lock_);
+  // Entries reserved with ReserveEntry() and not committed yet, and the
+  // sequence ID of the first of them.
+  size_t open_entry_count_ PW_GUARDED_BY(lock_);
+  uint32_t first_open_sequence_id_ PW_GUARDED_BY(lock_);
 };
 
 }  // namespace multisink
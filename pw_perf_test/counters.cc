@@ -0,0 +1,214 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_perf_test/internal/counters.h"
+
+#include "pw_perf_test/config.h"
+#include "pw_preprocessor/arch.h"
+
+#if PW_PERF_TEST_COUNTERS_ENABLED
+#if _PW_ARCH_ARM_V7M || _PW_ARCH_ARM_V7EM || _PW_ARCH_ARM_V8M_MAINLINE || \
+    _PW_ARCH_ARM_V8_1M_MAINLINE
+#define _PW_PERF_TEST_DWT_COUNTERS 1
+#elif defined(__linux__)
+#define _PW_PERF_TEST_PERF_EVENT_COUNTERS 1
+#endif
+#endif  // PW_PERF_TEST_COUNTERS_ENABLED
+
+#ifndef _PW_PERF_TEST_DWT_COUNTERS
+#define _PW_PERF_TEST_DWT_COUNTERS 0
+#endif  // _PW_PERF_TEST_DWT_COUNTERS
+
+#ifndef _PW_PERF_TEST_PERF_EVENT_COUNTERS
+#define _PW_PERF_TEST_PERF_EVENT_COUNTERS 0
+#endif  // _PW_PERF_TEST_PERF_EVENT_COUNTERS
+
+#if _PW_PERF_TEST_PERF_EVENT_COUNTERS
+#include <iterator>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // _PW_PERF_TEST_PERF_EVENT_COUNTERS
+
+namespace pw::perf_test::internal {
+namespace {
+
+size_t counter_count = 0;
+
+#if _PW_PERF_TEST_DWT_COUNTERS
+
+// Data Watchpoint and Trace unit registers. See the Armv7-M Architecture
+// Reference Manual, section C1.8.
+volatile uint32_t& kDwtCtrl = *reinterpret_cast<volatile uint32_t*>(0xE0001000);
+volatile uint32_t& kDwtCpiCnt =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001008);
+volatile uint32_t& kDwtLsuCnt =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001014);
+volatile uint32_t& kDwtFoldCnt =
+    *reinterpret_cast<volatile uint32_t*>(0xE0001018);
+volatile uint32_t& kDemcr = *reinterpret_cast<volatile uint32_t*>(0xE000EDFC);
+
+constexpr uint32_t kDemcrTrcEna = 1u << 24;
+constexpr uint32_t kDwtCtrlNoPrfCnt = 1u << 24;
+constexpr uint32_t kDwtCtrlCounterEnables = (1u << 17)    // CPIEVTENA
+                                            | (1u << 20)  // LSUEVTENA
+                                            | (1u << 21);  // FOLDEVTENA
+
+// The profiling counters are 8 bits wide.
+constexpr int64_t kCounterMask = 0xff;
+
+constexpr const char* kCounterNames[] = {
+    "cpi_cycles",
+    "lsu_cycles",
+    "folded_instructions",
+};
+
+void Prepare() {
+  kDemcr |= kDemcrTrcEna;
+  if ((kDwtCtrl & kDwtCtrlNoPrfCnt) != 0) {
+    return;
+  }
+  kDwtCpiCnt = 0;
+  kDwtLsuCnt = 0;
+  kDwtFoldCnt = 0;
+  kDwtCtrl |= kDwtCtrlCounterEnables;
+  counter_count = 3;
+}
+
+void Cleanup() { kDwtCtrl &= ~kDwtCtrlCounterEnables; }
+
+void Read(CounterValues& values) {
+  values[0] = static_cast<int64_t>(kDwtCpiCnt);
+  values[1] = static_cast<int64_t>(kDwtLsuCnt);
+  values[2] = static_cast<int64_t>(kDwtFoldCnt);
+}
+
+#elif _PW_PERF_TEST_PERF_EVENT_COUNTERS
+
+constexpr int64_t kCounterMask = -1;
+
+constexpr uint64_t kCounterConfigs[] = {
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+constexpr const char* kCounterNames[] = {
+    "instructions",
+    "cache_misses",
+    "branch_misses",
+};
+
+static_assert(std::size(kCounterConfigs) == kMaxCounters);
+
+// The counters are read together through the first one.
+int group_fd = -1;
+int counter_fds[kMaxCounters];
+
+void Prepare() {
+  for (size_t i = 0; i < kMaxCounters; ++i) {
+    perf_event_attr attr = {};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = kCounterConfigs[i];
+    attr.disabled = group_fd == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    const int fd = static_cast<int>(
+        syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+    if (fd < 0) {
+      // Report the counters opened so far, which keeps their order.
+      break;
+    }
+    if (group_fd == -1) {
+      group_fd = fd;
+    }
+    counter_fds[counter_count++] = fd;
+  }
+  if (group_fd != -1) {
+    ioctl(group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  }
+}
+
+void Cleanup() {
+  if (group_fd != -1) {
+    ioctl(group_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  }
+  for (size_t i = 0; i < counter_count; ++i) {
+    close(counter_fds[i]);
+  }
+  group_fd = -1;
+}
+
+void Read(CounterValues& values) {
+  // With PERF_FORMAT_GROUP, reads return the number of counters followed by
+  // their values.
+  uint64_t buffer[1 + kMaxCounters] = {};
+  if (read(group_fd, buffer, sizeof(buffer)) < 0) {
+    return;
+  }
+  for (size_t i = 0; i < counter_count; ++i) {
+    values[i] = static_cast<int64_t>(buffer[1 + i]);
+  }
+}
+
+#else
+
+constexpr int64_t kCounterMask = -1;
+
+constexpr const char* kCounterNames[] = {""};
+
+void Prepare() {}
+
+void Cleanup() {}
+
+void Read(CounterValues&) {}
+
+#endif  // _PW_PERF_TEST_DWT_COUNTERS
+
+}  // namespace
+
+void CountersPrepare() {
+  counter_count = 0;
+  Prepare();
+}
+
+void CountersCleanup() {
+  if (counter_count != 0) {
+    Cleanup();
+  }
+  counter_count = 0;
+}
+
+size_t CounterCount() { return counter_count; }
+
+const char* CounterName(size_t index) {
+  return index < counter_count ? kCounterNames[index] : "";
+}
+
+void ReadCounters(CounterValues& values) {
+  if (counter_count != 0) {
+    Read(values);
+  }
+}
+
+int64_t CounterDelta(int64_t begin, int64_t end) {
+  return (end - begin) & kCounterMask;
+}
+
+}  // namespace pw::perf_test::internal
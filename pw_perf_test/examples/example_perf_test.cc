@@ -12,7 +12,9 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
 #include <cstddef>
+#include <utility>
 
 #include "pw_perf_test/perf_test.h"
 
@@ -54,5 +56,43 @@ PW_PERF_TEST(
     4);
 // DOCSTAG: [pw_perf_test_examples-lambda_example]
 
+// DOCSTAG: [pw_perf_test_examples-range_example]
+void SumBytes(pw::perf_test::State& state, size_t size) {
+  std::array<std::byte, 4096> buffer{};
+  while (state.KeepRunning()) {
+    volatile unsigned sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+      sum = sum + static_cast<unsigned>(buffer[i]);
+    }
+  }
+}
+PW_PERF_TEST_RANGE(SumBytes, SumBytes, 16, 4096);
+// DOCSTAG: [pw_perf_test_examples-range_example]
+
+// DOCSTAG: [pw_perf_test_examples-fixture_example]
+class FilledBuffer : public pw::perf_test::Fixture {
+ public:
+  void SetUp(const pw::perf_test::State&) override {
+    for (size_t i = 0; i < buffer_.size(); ++i) {
+      buffer_[i] = static_cast<std::byte>(i);
+    }
+  }
+
+ protected:
+  std::array<std::byte, 256> buffer_;
+};
+
+PW_PERF_TEST_F(FilledBuffer, Reverse) {
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    SimulateWork(1, 1);  // Per-iteration setup that is not measured.
+    state.ResumeTiming();
+    for (size_t i = 0; i < buffer_.size() / 2; ++i) {
+      std::swap(buffer_[i], buffer_[buffer_.size() - 1 - i]);
+    }
+  }
+}
+// DOCSTAG: [pw_perf_test_examples-fixture_example]
+
 }  // namespace
 }  // namespace pw::perf_test
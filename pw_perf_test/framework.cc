@@ -14,6 +14,9 @@
 
 #include "pw_perf_test/internal/framework.h"
 
+#include <optional>
+
+#include "pw_perf_test/internal/counters.h"
 #include "pw_perf_test/internal/test_info.h"
 #include "pw_perf_test/internal/timer.h"
 
@@ -26,20 +29,27 @@ int Framework::RunAllTests() {
     return false;
   }
 
+  internal::CountersPrepare();
+
   event_handler_->RunAllTestsStart(run_info_);
 
   for (const TestInfo* test = tests_; test != nullptr; test = test->next()) {
-    State test_state = internal::CreateState(
-        kDefaultIterations, *event_handler_, test->test_name());
-    test->Run(test_state);
+    std::optional<size_t> argument = test->first_argument();
+    do {
+      State test_state = internal::CreateState(
+          kDefaultIterations, *event_handler_, test->test_name(), argument);
+      test->Run(test_state);
+    } while (argument.has_value() &&
+             (argument = test->next_argument(*argument)).has_value());
   }
+  internal::CountersCleanup();
   internal::TimerCleanup();
   event_handler_->RunAllTestsEnd();
   return true;
 }
 
 void Framework::RegisterTest(TestInfo& new_test) {
-  ++run_info_.total_tests;
+  run_info_.total_tests += new_test.run_count();
   if (tests_ == nullptr) {
     tests_ = &new_test;
     return;
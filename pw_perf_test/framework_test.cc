@@ -0,0 +1,112 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+#include "pw_containers/vector.h"
+#include "pw_perf_test/event_handler.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::perf_test {
+namespace {
+
+struct RunRecord {
+  const char* name;
+  std::optional<size_t> argument;
+  int body_runs;
+};
+
+Vector<RunRecord, 16> runs;
+int total_tests = 0;
+int set_ups = 0;
+int tear_downs = 0;
+
+// Records the test cases that were run.
+class RecordingEventHandler : public EventHandler {
+ public:
+  void RunAllTestsStart(const TestRunInfo& info) override {
+    total_tests = info.total_tests;
+  }
+  void RunAllTestsEnd() override {}
+  void TestCaseStart(const TestCase& info) override {
+    runs.push_back({info.name, info.argument, 0});
+  }
+  void TestCaseIteration(const TestIteration&) override {}
+  void TestCaseMeasure(const TestMeasurement&) override {}
+  void TestCaseEnd(const TestCase&) override {}
+};
+
+void CountRuns(State& state, size_t argument) {
+  EXPECT_EQ(argument, state.argument());
+  while (state.KeepRunning()) {
+    ++runs.back().body_runs;
+  }
+}
+
+PW_PERF_TEST_RANGE(Range, CountRuns, 16, 100);
+
+class CountingFixture : public Fixture {
+ public:
+  void SetUp(const State&) override {
+    ++set_ups;
+    // The fixture is set up before the test case starts.
+    EXPECT_EQ(runs.size(), runs_before_);
+  }
+  void TearDown(const State&) override { ++tear_downs; }
+
+ protected:
+  size_t runs_before_ = runs.size();
+};
+
+PW_PERF_TEST_F(CountingFixture, WithFixture) {
+  EXPECT_EQ(set_ups, 1);
+  EXPECT_EQ(tear_downs, 0);
+  while (state.KeepRunning()) {
+    ++runs.back().body_runs;
+  }
+}
+
+PW_PERF_TEST_RANGE_F(CountingFixture, RangeWithFixture, 1, 2) {
+  while (state.KeepRunning()) {
+    runs.back().body_runs += static_cast<int>(state.argument());
+  }
+}
+
+TEST(FrameworkTest, RunsFixturesAndRanges) {
+  RecordingEventHandler handler;
+  RunAllTests(handler);
+
+  // Range runs with 16, 32, 64 and 100, then the fixture tests.
+  ASSERT_EQ(runs.size(), 7u);
+  EXPECT_EQ(total_tests, 7);
+  constexpr size_t kRangeArguments[] = {16, 32, 64, 100};
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(std::string_view(runs[i].name), "Range");
+    EXPECT_EQ(runs[i].argument, kRangeArguments[i]);
+  }
+  EXPECT_EQ(std::string_view(runs[4].name), "CountingFixture.WithFixture");
+  EXPECT_EQ(runs[4].argument, std::nullopt);
+  EXPECT_EQ(std::string_view(runs[5].name), "CountingFixture.RangeWithFixture");
+  EXPECT_EQ(runs[5].argument, 1u);
+  EXPECT_EQ(runs[6].argument, 2u);
+  EXPECT_EQ(runs[6].body_runs, 2 * runs[5].body_runs);
+  EXPECT_EQ(set_ups, 3);
+  EXPECT_EQ(tear_downs, 3);
+}
+
+}  // namespace
+}  // namespace pw::perf_test
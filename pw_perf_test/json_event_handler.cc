@@ -0,0 +1,73 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_perf_test/json_event_handler.h"
+
+#include "pw_perf_test/internal/timer.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::perf_test {
+
+void JsonEventHandler::TestCaseStart(const TestCase& info) {
+  // Test names are C++ identifiers, so they need no escaping.
+  test_name_ = info.name != nullptr ? info.name : "";
+  argument_ = info.argument;
+  iterations_ = 0;
+  counter_count_ = 0;
+}
+
+void JsonEventHandler::TestCaseIteration(const TestIteration& iteration) {
+  iterations_ = iteration.number;
+}
+
+void JsonEventHandler::TestCaseCounter(const TestCounter& counter) {
+  if (counter_count_ < counters_.size()) {
+    counters_[counter_count_++] = counter;
+  }
+}
+
+void JsonEventHandler::TestCaseMeasure(const TestMeasurement& measurement) {
+  StringBuffer<384> line;
+  line.Format("{\"name\":\"%s", test_name_);
+  if (argument_.has_value()) {
+    line.Format("/%lu", static_cast<unsigned long>(*argument_));
+  }
+  line.Format(
+      "\",\"unit\":\"%s\",\"iterations\":%u,\"mean\":%lu,"
+      "\"min\":%lu,\"max\":%lu,\"median\":%lu,\"p90\":%lu,\"p99\":%lu,"
+      "\"stddev\":%lu",
+      internal::GetDurationUnitStr(),
+      static_cast<unsigned>(iterations_),
+      static_cast<unsigned long>(measurement.mean),
+      static_cast<unsigned long>(measurement.min),
+      static_cast<unsigned long>(measurement.max),
+      static_cast<unsigned long>(measurement.median),
+      static_cast<unsigned long>(measurement.p90),
+      static_cast<unsigned long>(measurement.p99),
+      static_cast<unsigned long>(measurement.stddev));
+  if (counter_count_ != 0) {
+    line << ",\"counters\":{";
+    for (size_t i = 0; i < counter_count_; ++i) {
+      line.Format("%s\"%s\":%lu",
+                  i == 0 ? "" : ",",
+                  counters_[i].name,
+                  static_cast<unsigned long>(counters_[i].mean));
+    }
+    line << '}';
+  }
+  line << "}\n";
+  writer_.Write(as_bytes(span(line.view()))).IgnoreError();
+}
+
+}  // namespace pw::perf_test
@@ -0,0 +1,88 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_perf_test/json_event_handler.h"
+
+#include <string_view>
+
+#include "pw_perf_test/internal/timer.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_string/string_builder.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::perf_test {
+namespace {
+
+TEST(JsonEventHandlerTest, WritesOneLinePerTestCase) {
+  stream::MemoryWriterBuffer<512> writer;
+  JsonEventHandler handler(writer);
+
+  handler.RunAllTestsStart({.total_tests = 2, .default_iterations = 2});
+  handler.TestCaseStart({.name = "First"});
+  handler.TestCaseIteration({.number = 1, .result = 10});
+  handler.TestCaseIteration({.number = 2, .result = 14});
+  handler.TestCaseMeasure({.mean = 12,
+                           .max = 14,
+                           .min = 10,
+                           .median = 12,
+                           .p90 = 14,
+                           .p99 = 14,
+                           .stddev = 2});
+  handler.TestCaseEnd({.name = "First"});
+  handler.TestCaseStart({.name = "Second"});
+  handler.TestCaseIteration({.number = 1, .result = 5});
+  handler.TestCaseMeasure(
+      {.mean = 5, .max = 5, .min = 5, .median = 5, .p90 = 5, .p99 = 5});
+  handler.TestCaseEnd({.name = "Second"});
+  handler.RunAllTestsEnd();
+
+  StringBuffer<512> expected;
+  expected.Format(
+      "{\"name\":\"First\",\"unit\":\"%s\",\"iterations\":2,\"mean\":12,"
+      "\"min\":10,\"max\":14,\"median\":12,\"p90\":14,\"p99\":14,"
+      "\"stddev\":2}\n"
+      "{\"name\":\"Second\",\"unit\":\"%s\",\"iterations\":1,\"mean\":5,"
+      "\"min\":5,\"max\":5,\"median\":5,\"p90\":5,\"p99\":5,\"stddev\":0}\n",
+      internal::GetDurationUnitStr(),
+      internal::GetDurationUnitStr());
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(writer.data()),
+                             writer.bytes_written()),
+            expected.view());
+}
+
+TEST(JsonEventHandlerTest, WritesArgumentAndCounters) {
+  stream::MemoryWriterBuffer<512> writer;
+  JsonEventHandler handler(writer);
+
+  handler.TestCaseStart({.name = "Sweep", .argument = 64});
+  handler.TestCaseIteration({.number = 1, .result = 8});
+  handler.TestCaseCounter({.name = "instructions", .mean = 120});
+  handler.TestCaseCounter({.name = "cache_misses", .mean = 3});
+  handler.TestCaseMeasure({.mean = 8, .max = 8, .min = 8});
+  handler.TestCaseEnd({.name = "Sweep", .argument = 64});
+
+  StringBuffer<512> expected;
+  expected.Format(
+      "{\"name\":\"Sweep/64\",\"unit\":\"%s\",\"iterations\":1,"
+      "\"mean\":8,\"min\":8,\"max\":8,\"median\":0,\"p90\":0,\"p99\":0,"
+      "\"stddev\":0,\"counters\":{\"instructions\":120,\"cache_misses\":3}}"
+      "\n",
+      internal::GetDurationUnitStr());
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(writer.data()),
+                             writer.bytes_written()),
+            expected.view());
+}
+
+}  // namespace
+}  // namespace pw::perf_test
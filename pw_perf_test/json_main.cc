@@ -0,0 +1,24 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_perf_test/json_event_handler.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_stream/sys_io_stream.h"
+
+int main() {
+  pw::stream::SysIoWriter writer;
+  pw::perf_test::JsonEventHandler handler(writer);
+  pw::perf_test::RunAllTests(handler);
+  return 0;
+}
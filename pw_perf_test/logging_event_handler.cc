@@ -34,7 +34,13 @@ void LoggingEventHandler::RunAllTestsEnd() {
 }
 
 void LoggingEventHandler::TestCaseStart(const TestCase& info) {
-  PW_LOG_INFO(PW_PERF_TEST_GOOGLETEST_CASE_START, info.name);
+  if (info.argument.has_value()) {
+    PW_LOG_INFO(PW_PERF_TEST_GOOGLETEST_CASE_START_WITH_ARGUMENT,
+                info.name,
+                static_cast<unsigned long>(*info.argument));
+  } else {
+    PW_LOG_INFO(PW_PERF_TEST_GOOGLETEST_CASE_START, info.name);
+  }
 }
 
 void LoggingEventHandler::TestCaseIteration(const TestIteration& iteration) {
@@ -44,6 +50,12 @@ void LoggingEventHandler::TestCaseIteration(const TestIteration& iteration) {
                internal::GetDurationUnitStr());
 }
 
+void LoggingEventHandler::TestCaseCounter(const TestCounter& counter) {
+  PW_LOG_INFO(PW_PERF_TEST_GOOGLETEST_CASE_COUNTER,
+              counter.name,
+              static_cast<unsigned long>(counter.mean));
+}
+
 void LoggingEventHandler::TestCaseMeasure(const TestMeasurement& measurement) {
   PW_LOG_INFO(PW_PERF_TEST_GOOGLETEST_CASE_MEASUREMENT,
               static_cast<unsigned long>(measurement.mean),
@@ -52,10 +64,25 @@ void LoggingEventHandler::TestCaseMeasure(const TestMeasurement& measurement) {
               internal::GetDurationUnitStr(),
               static_cast<unsigned long>(measurement.max),
               internal::GetDurationUnitStr());
+  PW_LOG_INFO(PW_PERF_TEST_GOOGLETEST_CASE_STATISTICS,
+              static_cast<unsigned long>(measurement.median),
+              internal::GetDurationUnitStr(),
+              static_cast<unsigned long>(measurement.p90),
+              internal::GetDurationUnitStr(),
+              static_cast<unsigned long>(measurement.p99),
+              internal::GetDurationUnitStr(),
+              static_cast<unsigned long>(measurement.stddev),
+              internal::GetDurationUnitStr());
 }
 
 void LoggingEventHandler::TestCaseEnd(const TestCase& info) {
-  PW_LOG_INFO(PW_PERF_TEST_GOOGLETEST_CASE_END, info.name);
+  if (info.argument.has_value()) {
+    PW_LOG_INFO(PW_PERF_TEST_GOOGLETEST_CASE_END_WITH_ARGUMENT,
+                info.name,
+                static_cast<unsigned long>(*info.argument));
+  } else {
+    PW_LOG_INFO(PW_PERF_TEST_GOOGLETEST_CASE_END, info.name);
+  }
 }
 
 }  // namespace pw::perf_test
@@ -0,0 +1,56 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Number of measured iterations of each performance test.
+#ifndef PW_PERF_TEST_ITERATIONS
+#define PW_PERF_TEST_ITERATIONS 10
+#endif  // PW_PERF_TEST_ITERATIONS
+
+// Number of iterations of each performance test that are run, but not
+// measured, before any measured iterations. Warmup iterations let caches,
+// branch predictors and lazily initialized state settle.
+#ifndef PW_PERF_TEST_WARMUP_ITERATIONS
+#define PW_PERF_TEST_WARMUP_ITERATIONS 0
+#endif  // PW_PERF_TEST_WARMUP_ITERATIONS
+
+// Minimum duration of a measured iteration, in the units of the timer backend.
+//
+// If nonzero, each test is calibrated before it is measured: the test body is
+// run in batches of increasing size until a batch takes at least this long,
+// and each measured iteration then times a whole batch and reports the average
+// duration of one run of the body. This keeps test bodies that are much
+// shorter than the timer resolution or overhead from being reported as zero
+// or as the timer overhead.
+#ifndef PW_PERF_TEST_MIN_ITERATION_DURATION
+#define PW_PERF_TEST_MIN_ITERATION_DURATION 0
+#endif  // PW_PERF_TEST_MIN_ITERATION_DURATION
+
+// Whether to count hardware events while measuring each performance test.
+//
+// If enabled, each test also reports the mean number of events per run of the
+// test body for the counters supported by the target:
+//
+// - On Arm Cortex-M cores with a DWT unit, the CPI, LSU and folded-instruction
+//   counters. These are 8 bits wide and wrap silently, so they are only
+//   meaningful for test bodies that count fewer than 256 of each event per
+//   measured iteration. Do not combine them with calibration.
+// - On Linux, instructions, cache misses and branch mispredictions from
+//   `perf_event_open`. Counters the kernel does not allow are not reported.
+//
+// On other targets, or if the counters cannot be enabled, no counters are
+// reported.
+#ifndef PW_PERF_TEST_COUNTERS_ENABLED
+#define PW_PERF_TEST_COUNTERS_ENABLED 0
+#endif  // PW_PERF_TEST_COUNTERS_ENABLED
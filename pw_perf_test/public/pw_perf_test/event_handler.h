@@ -13,7 +13,9 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 
 namespace pw::perf_test {
 
@@ -24,10 +26,28 @@ struct TestIteration {
 };
 
 /// Data reported for each `Measurement` upon completion of a performance test.
+///
+/// All values are durations of a single run of the test body, in the units of
+/// the timer backend. Percentiles use the nearest-rank method and `stddev` is
+/// the population standard deviation of the measured iterations.
 struct TestMeasurement {
   float mean = 0;
   float max = 0;
   float min = 0;
+  float median = 0;
+  float p90 = 0;
+  float p99 = 0;
+  float stddev = 0;
+};
+
+/// Data reported for each hardware counter upon completion of a performance
+/// test, if counters are enabled. See `PW_PERF_TEST_COUNTERS_ENABLED`.
+struct TestCounter {
+  /// Name of the counted event, e.g. "instructions".
+  const char* name = nullptr;
+
+  /// Mean number of events per run of the test body.
+  float mean = 0;
 };
 
 /// Stores information on the upcoming collection of tests.
@@ -41,6 +61,9 @@ struct TestRunInfo {
 /// Describes the performance test being run.
 struct TestCase {
   const char* name = nullptr;
+
+  /// For tests defined with `PW_PERF_TEST_RANGE`, the argument of this run.
+  std::optional<size_t> argument = std::nullopt;
 };
 
 /// Collects and reports test results.
@@ -63,6 +86,11 @@ class EventHandler {
   /// A performance test case has completed an iteration.
   virtual void TestCaseIteration(const TestIteration& test_iteration) = 0;
 
+  /// A performance test case has counted events with a hardware counter.
+  ///
+  /// Called once per counter, before `TestCaseMeasure`.
+  virtual void TestCaseCounter(const TestCounter&) {}
+
   /// A performance test case has produced a `Measurement`.
   virtual void TestCaseMeasure(const TestMeasurement& test_measurement) = 0;
 
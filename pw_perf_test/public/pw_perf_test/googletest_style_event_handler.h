@@ -21,7 +21,12 @@
   "[==========] Done running all tests."
 
 #define PW_PERF_TEST_GOOGLETEST_CASE_START "[ RUN      ] %s"
+#define PW_PERF_TEST_GOOGLETEST_CASE_START_WITH_ARGUMENT "[ RUN      ] %s/%lu"
 #define PW_PERF_TEST_GOOGLETEST_CASE_ITERATION "[ Iteration ] #%u: %lu %s"
 #define PW_PERF_TEST_GOOGLETEST_CASE_MEASUREMENT \
   "[  RESULT  ] MEAN: %lu %s, MIN: %lu %s, MAX: %lu %s"
+#define PW_PERF_TEST_GOOGLETEST_CASE_STATISTICS \
+  "[  STATS   ] MEDIAN: %lu %s, P90: %lu %s, P99: %lu %s, STDDEV: %lu %s"
+#define PW_PERF_TEST_GOOGLETEST_CASE_COUNTER "[ COUNTER  ] %s: %lu per run"
 #define PW_PERF_TEST_GOOGLETEST_CASE_END "[     DONE ] %s"
+#define PW_PERF_TEST_GOOGLETEST_CASE_END_WITH_ARGUMENT "[     DONE ] %s/%lu"
@@ -0,0 +1,47 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pw::perf_test::internal {
+
+/// Maximum number of hardware counters read while measuring a test.
+inline constexpr size_t kMaxCounters = 3;
+
+using CounterValues = std::array<int64_t, kMaxCounters>;
+
+/// Enables the hardware counters of the target, if
+/// `PW_PERF_TEST_COUNTERS_ENABLED` is set and the target supports them.
+void CountersPrepare();
+
+/// Disables any counters enabled by `CountersPrepare`.
+void CountersCleanup();
+
+/// Returns the number of enabled counters, which may be zero.
+size_t CounterCount();
+
+/// Returns the name of an enabled counter.
+const char* CounterName(size_t index);
+
+/// Reads the current value of each enabled counter.
+void ReadCounters(CounterValues& values);
+
+/// Returns the number of events counted between two values of a counter,
+/// accounting for counters that are narrower than 64 bits.
+int64_t CounterDelta(int64_t begin, int64_t end);
+
+}  // namespace pw::perf_test::internal
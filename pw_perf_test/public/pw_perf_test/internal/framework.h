@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include "pw_perf_test/config.h"
 #include "pw_perf_test/event_handler.h"
 
 namespace pw::perf_test::internal {
@@ -41,7 +42,7 @@ class Framework {
   int RunAllTests();
 
  private:
-  static constexpr int kDefaultIterations = 10;
+  static constexpr int kDefaultIterations = PW_PERF_TEST_ITERATIONS;
 
   EventHandler* event_handler_;
 
@@ -13,6 +13,9 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+#include <optional>
+
 #include "pw_perf_test/state.h"
 
 namespace pw::perf_test::internal {
@@ -28,6 +31,14 @@ class TestInfo {
  public:
   TestInfo(const char* test_name, void (*function_body)(State&));
 
+  /// Creates a test that is run once for each argument in a range. The range
+  /// starts at `first_argument` and doubles up to and including
+  /// `last_argument`.
+  TestInfo(const char* test_name,
+           void (*function_body)(State&),
+           size_t first_argument,
+           size_t last_argument);
+
   // Returns the next registered test
   TestInfo* next() const { return next_; }
 
@@ -37,6 +48,17 @@ class TestInfo {
 
   const char* test_name() const { return test_name_; }
 
+  // Returns the argument of the first run, or nullopt if the test takes no
+  // argument.
+  std::optional<size_t> first_argument() const;
+
+  // Returns the argument of the run that follows the run with `argument`, or
+  // nullopt if that was the last run.
+  std::optional<size_t> next_argument(size_t argument) const;
+
+  // Returns the number of times the test is run.
+  int run_count() const;
+
  private:
   // Function pointer to the code that will be measured
   void (*run_)(State&);
@@ -45,6 +67,11 @@ class TestInfo {
   TestInfo* next_ = nullptr;
 
   const char* test_name_;
+
+  // Range of arguments, if the test takes one. A last argument of zero means
+  // the test takes no argument.
+  size_t first_argument_ = 0;
+  size_t last_argument_ = 0;
 };
 
 }  // namespace pw::perf_test::internal
@@ -0,0 +1,61 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_perf_test/event_handler.h"
+#include "pw_perf_test/internal/counters.h"
+#include "pw_stream/stream.h"
+
+namespace pw::perf_test {
+
+/// An event handler that writes the measurement of each performance test as a
+/// line of JSON, for tools that compare results across runs.
+///
+/// Each line is an object with the test `name`, the duration `unit`, the
+/// number of measured `iterations` and each field of `TestMeasurement`, e.g.
+///
+/// @code{.json}
+/// {"name":"Foo","unit":"ns","iterations":10,"mean":120,"min":110,...}
+/// @endcode
+///
+/// Durations are written as whole numbers of timer units. Runs of tests defined
+/// with `PW_PERF_TEST_RANGE` are named `name/argument`, and any hardware
+/// counters are written as a `counters` object of mean events per run.
+class JsonEventHandler : public EventHandler {
+ public:
+  explicit JsonEventHandler(stream::Writer& writer) : writer_(writer) {}
+
+  void RunAllTestsStart(const TestRunInfo&) override {}
+  void RunAllTestsEnd() override {}
+  void TestCaseStart(const TestCase& info) override;
+  void TestCaseIteration(const TestIteration& iteration) override;
+  void TestCaseCounter(const TestCounter& counter) override;
+  void TestCaseMeasure(const TestMeasurement& measurement) override;
+  void TestCaseEnd(const TestCase&) override {}
+
+ private:
+  stream::Writer& writer_;
+  const char* test_name_ = "";
+  std::optional<size_t> argument_;
+  uint32_t iterations_ = 0;
+  std::array<TestCounter, internal::kMaxCounters> counters_;
+  size_t counter_count_ = 0;
+};
+
+}  // namespace pw::perf_test
@@ -27,6 +27,7 @@ class LoggingEventHandler : public EventHandler {
   void RunAllTestsEnd() override;
   void TestCaseStart(const TestCase& info) override;
   void TestCaseIteration(const TestIteration& iteration) override;
+  void TestCaseCounter(const TestCounter& counter) override;
   void TestCaseMeasure(const TestMeasurement& measurement) override;
   void TestCaseEnd(const TestCase& info) override;
 };
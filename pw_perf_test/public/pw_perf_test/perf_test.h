@@ -66,8 +66,114 @@
       },                                                    \
       __VA_ARGS__)
 
+/// Defines a performance test that is run once for each argument in a range.
+///
+/// The range starts at `first` and doubles up to and including `last`, which
+/// suits sweeps over sizes. The provided function is passed the argument of
+/// each run after the `State`, followed by any additional arguments. Each run
+/// is reported as a separate test case named `name/argument`.
+///
+/// Example:
+/// @code{.cpp}
+///   void TestFunction(::pw::perf_test::State& state, size_t size) {
+///     // Create a buffer of `size` bytes.
+///     while (state.KeepRunning()){
+///       // Process the buffer.
+///     }
+///   }
+///   // Runs with sizes 16, 32, 64, ..., 4096.
+///   PW_PERF_TEST_RANGE(PerformanceTestName, TestFunction, 16, 4096);
+/// @endcode
+#define PW_PERF_TEST_RANGE(name, function, first, last, ...)         \
+  const ::pw::perf_test::internal::TestInfo PwPerfTest_##name(       \
+      #name,                                                         \
+      [](::pw::perf_test::State& pw_perf_test_state) {               \
+        static_cast<void>(function(pw_perf_test_state,               \
+                                   pw_perf_test_state.argument()     \
+                                       PW_COMMA_ARGS(__VA_ARGS__))); \
+      },                                                             \
+      first,                                                         \
+      last)
+
+/// Defines a performance test that uses a fixture.
+///
+/// The fixture must derive from `pw::perf_test::Fixture`. A new instance of the
+/// fixture is created for each test case, and its `SetUp` and `TearDown`
+/// methods run outside of the measured iterations. The test body is a method
+/// of a class derived from the fixture, with a `State` parameter named `state`.
+///
+/// Example:
+/// @code{.cpp}
+///   class BufferFixture : public ::pw::perf_test::Fixture {
+///    public:
+///     void SetUp(const ::pw::perf_test::State&) override {
+///       // Fill buffer_.
+///     }
+///
+///    protected:
+///     std::array<std::byte, 256> buffer_;
+///   };
+///
+///   PW_PERF_TEST_F(BufferFixture, PerformanceTestName) {
+///     while (state.KeepRunning()) {
+///       // Process buffer_.
+///     }
+///   }
+/// @endcode
+#define PW_PERF_TEST_F(fixture, name)                                          \
+  _PW_PERF_TEST_FIXTURE_CLASS(fixture, name);                                  \
+  const ::pw::perf_test::internal::TestInfo PwPerfTestInfo_##fixture##_##name( \
+      #fixture "." #name,                                                      \
+      ::pw::perf_test::internal::RunFixture<PwPerfTest_##fixture##_##name>);   \
+  void PwPerfTest_##fixture##_##name::Run(::pw::perf_test::State& state)
+
+/// Defines a performance test that uses a fixture and is run once for each
+/// argument in a range.
+///
+/// This combines `PW_PERF_TEST_F` and `PW_PERF_TEST_RANGE`. The argument of
+/// each run is available from `State::argument()`, including in the fixture's
+/// `SetUp` method.
+#define PW_PERF_TEST_RANGE_F(fixture, name, first, last)                       \
+  _PW_PERF_TEST_FIXTURE_CLASS(fixture, name);                                  \
+  const ::pw::perf_test::internal::TestInfo PwPerfTestInfo_##fixture##_##name( \
+      #fixture "." #name,                                                      \
+      ::pw::perf_test::internal::RunFixture<PwPerfTest_##fixture##_##name>,    \
+      first,                                                                   \
+      last);                                                                   \
+  void PwPerfTest_##fixture##_##name::Run(::pw::perf_test::State& state)
+
+#define _PW_PERF_TEST_FIXTURE_CLASS(fixture, name)             \
+  class PwPerfTest_##fixture##_##name final : public fixture { \
+   public:                                                     \
+    void Run(::pw::perf_test::State& state);                   \
+  }
+
 namespace pw::perf_test {
 
+/// Base class for fixtures of tests defined with `PW_PERF_TEST_F`.
+class Fixture {
+ public:
+  virtual ~Fixture() = default;
+
+  /// Prepares the fixture before the test runs. This is not measured.
+  virtual void SetUp(const State&) {}
+
+  /// Cleans up the fixture after the test runs. This is not measured.
+  virtual void TearDown(const State&) {}
+};
+
+namespace internal {
+
+template <typename TestFixture>
+void RunFixture(State& state) {
+  TestFixture test;
+  test.SetUp(state);
+  test.Run(state);
+  test.TearDown(state);
+}
+
+}  // namespace internal
+
 /// Runs all registered tests,
 ///
 /// This function should be called by `main`. The tests will use the provided
@@ -13,11 +13,16 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <optional>
 
 #include "pw_assert/assert.h"
+#include "pw_perf_test/config.h"
 #include "pw_perf_test/event_handler.h"
+#include "pw_perf_test/internal/counters.h"
 #include "pw_perf_test/internal/timer.h"
 
 namespace pw::perf_test {
@@ -30,40 +35,125 @@ namespace internal {
 // Allows access to the private State object constructor
 State CreateState(int durations,
                   EventHandler& event_handler,
-                  const char* test_name);
+                  const char* test_name,
+                  std::optional<size_t> argument = std::nullopt);
+
+State CreateState(int durations,
+                  int warmup_iterations,
+                  int64_t min_iteration_duration,
+                  EventHandler& event_handler,
+                  const char* test_name,
+                  std::optional<size_t> argument = std::nullopt);
 
 }  // namespace internal
 
 /// Records the performance of a test case over many iterations.
+///
+/// Each test case may run unmeasured warmup iterations and calibrate how many
+/// runs of the test body each measured iteration covers before it is measured.
+/// See `pw_perf_test/config.h`. The measured iterations are summarized as a
+/// `TestMeasurement`.
 class State {
  public:
+  /// Upper bound on the number of runs of the test body that a single measured
+  /// iteration covers after calibration.
+  static constexpr int kMaxBatchSize = 1 << 16;
+
   // KeepRunning() should be called in a while loop. Responsible for managing
   // iterations and timestamps.
   bool KeepRunning();
 
+  /// Stops measuring the current iteration, e.g. to exclude setup that must be
+  /// repeated for each run of the test body. `ResumeTiming()` must be called
+  /// before the next call to `KeepRunning()`.
+  ///
+  /// Pausing has an overhead of its own, so this is best suited to test bodies
+  /// that are much longer than a read of the timer.
+  void PauseTiming();
+
+  /// Resumes measuring the current iteration after `PauseTiming()`.
+  void ResumeTiming();
+
+  /// Returns the argument of the current run of a test defined with
+  /// `PW_PERF_TEST_RANGE` or `PW_PERF_TEST_RANGE_F`.
+  size_t argument() const {
+    PW_ASSERT(test_info.argument.has_value());
+    return *test_info.argument;
+  }
+
  private:
+  enum class Phase {
+    kNotStarted,
+    kWarmup,
+    kCalibrate,
+    kMeasure,
+  };
+
   // Allows the framework to create state objects and unit tests for the state
   // class
   friend State internal::CreateState(int durations,
+                                     int warmup_iterations,
+                                     int64_t min_iteration_duration,
                                      EventHandler& event_handler,
-                                     const char* test_name);
+                                     const char* test_name,
+                                     std::optional<size_t> argument);
 
   // Privated constructor to prevent unauthorized instances of the state class.
   constexpr State(int iterations,
+                  int warmup_iterations,
+                  int64_t min_iteration_duration,
                   EventHandler& event_handler,
-                  const char* test_name)
+                  const char* test_name,
+                  std::optional<size_t> argument)
       : test_iterations_(iterations),
+        warmup_iterations_(warmup_iterations),
+        min_iteration_duration_(min_iteration_duration),
         iteration_start_(),
+        pause_start_(),
         event_handler_(&event_handler),
-        test_info{.name = test_name} {
+        test_info{.name = test_name, .argument = argument} {
     PW_ASSERT(test_iterations_ > 0);
+    PW_ASSERT(static_cast<size_t>(test_iterations_) <= durations_.size());
+    PW_ASSERT(warmup_iterations_ >= 0);
   }
 
+  // Returns the phase that follows warmup.
+  Phase PhaseAfterWarmup() const {
+    return min_iteration_duration_ > 0 ? Phase::kCalibrate : Phase::kMeasure;
+  }
+
+  // Starts timing the next iteration.
+  void StartIteration();
+
+  // Adds the events counted in the current iteration to the totals.
+  void AccumulateCounters();
+
+  // Records the duration of one run of the test body in a measured iteration.
+  void RecordIteration(int64_t duration);
+
+  // Reports the statistics of all measured iterations.
+  void ReportMeasurement();
+
   int64_t mean_ = -1;
 
   // Stores the total number of iterations wanted
   int test_iterations_;
 
+  // Number of unmeasured iterations to run first.
+  int warmup_iterations_;
+
+  // Batches are grown until they take at least this long. Zero disables
+  // calibration.
+  int64_t min_iteration_duration_;
+
+  Phase phase_ = Phase::kNotStarted;
+
+  // Number of runs of the test body per iteration.
+  int batch_size_ = 1;
+
+  // Runs of the test body left in the current iteration.
+  int batch_remaining_ = 0;
+
   // Stores the total duration of the tests.
   int64_t total_duration_ = 0;
 
@@ -73,11 +163,33 @@ class State {
   // Largest value of the iterations
   int64_t max_ = std::numeric_limits<int64_t>::min();
 
+  // Duration of each measured iteration.
+  std::array<int64_t, PW_PERF_TEST_ITERATIONS> durations_{};
+
   // Time at the start of the iteration
   internal::Timestamp iteration_start_;
 
-  // The current iteration.
-  int current_iteration_ = -1;
+  // Time at which timing was last paused.
+  internal::Timestamp pause_start_;
+
+  // Time spent paused in the current iteration.
+  int64_t paused_duration_ = 0;
+
+  // Number of hardware counters read in measured iterations.
+  size_t counter_count_ = 0;
+
+  // Counter values at the start of the iteration and at the last pause.
+  internal::CounterValues counters_start_{};
+  internal::CounterValues counters_at_pause_{};
+
+  // Events counted while paused in the current iteration.
+  internal::CounterValues paused_counters_{};
+
+  // Events counted in all measured iterations.
+  internal::CounterValues counter_totals_{};
+
+  // The current iteration within the current phase.
+  int current_iteration_ = 0;
 
   EventHandler* event_handler_;
 
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+# Copyright 2024 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for the perf test result comparison."""
+
+import io
+import unittest
+
+from pw_perf_test.compare import compare, parse_results, write_report
+
+_BASELINE = [
+    'INF  {"name":"Fast","unit":"ns","iterations":10,"median":100}\n',
+    '{"name":"Slow","unit":"ns","iterations":10,"median":1000}\n',
+    '{"name":"Removed","unit":"ns","iterations":10,"median":5}\n',
+    'INF  [ RUN      ] Not JSON\n',
+]
+
+_CANDIDATE = [
+    '{"name":"Fast","unit":"ns","iterations":10,"median":110}\n',
+    '{"name":"Slow","unit":"ns","iterations":10,"median":900}\n',
+    '{"name":"Added","unit":"ns","iterations":10,"median":7}\n',
+]
+
+
+class CompareTest(unittest.TestCase):
+    """Tests for comparing perf test results."""
+
+    def test_parse_skips_log_prefixes_and_other_lines(self):
+        results = parse_results(_BASELINE)
+        self.assertEqual(sorted(results), ['Fast', 'Removed', 'Slow'])
+        self.assertEqual(results['Fast']['median'], 100)
+
+    def test_compare_only_tests_in_both_runs(self):
+        comparisons = compare(
+            parse_results(_BASELINE), parse_results(_CANDIDATE), 'median'
+        )
+        self.assertEqual([c.name for c in comparisons], ['Fast', 'Slow'])
+        self.assertAlmostEqual(comparisons[0].change, 0.1)
+        self.assertAlmostEqual(comparisons[1].change, -0.1)
+
+    def test_report_counts_regressions_over_threshold(self):
+        comparisons = compare(
+            parse_results(_BASELINE), parse_results(_CANDIDATE), 'median'
+        )
+        output = io.StringIO()
+        self.assertEqual(write_report(comparisons, 0.05, output), 1)
+        self.assertIn('REGRESSION', output.getvalue().splitlines()[0])
+        self.assertEqual(write_report(comparisons, 0.2, io.StringIO()), 0)
+
+    def test_compare_rejects_mismatched_units(self):
+        candidate = parse_results(
+            ['{"name":"Fast","unit":"clock_cycles","median":100}']
+        )
+        with self.assertRaises(ValueError):
+            compare(parse_results(_BASELINE), candidate, 'median')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,148 @@
+# Copyright 2024 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Compares two runs of pw_perf_test performance tests.
+
+Reads the output of ``pw_perf_test/json_main.cc`` (one JSON object per test)
+for a baseline and a candidate run, and reports the relative change of a
+statistic for each test. Exits with a nonzero status if any test regressed by
+more than the threshold.
+
+Lines that do not contain a JSON object are ignored, and text before the first
+``{`` is skipped, so captured device logs can be passed directly.
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import sys
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Iterable, TextIO
+
+STATISTICS = ('mean', 'min', 'max', 'median', 'p90', 'p99')
+
+
+@dataclass(frozen=True)
+class Comparison:
+    """The change of one statistic of a test between two runs."""
+
+    name: str
+    unit: str
+    baseline: float
+    candidate: float
+
+    @property
+    def change(self) -> float:
+        """The relative change from the baseline, e.g. 0.1 for 10% slower."""
+        if self.baseline == 0:
+            return 0.0 if self.candidate == 0 else float('inf')
+        return (self.candidate - self.baseline) / self.baseline
+
+    def regressed(self, threshold: float) -> bool:
+        return self.change > threshold
+
+
+def parse_results(lines: Iterable[str]) -> dict[str, dict]:
+    """Returns the results in pw_perf_test JSON output, keyed by test name."""
+    results: dict[str, dict] = {}
+    for line in lines:
+        start = line.find('{')
+        if start < 0:
+            continue
+        try:
+            result = json.loads(line[start:])
+        except json.JSONDecodeError:
+            continue
+        if isinstance(result, dict) and 'name' in result:
+            results[result['name']] = result
+    return results
+
+
+def compare(
+    baseline: dict[str, dict], candidate: dict[str, dict], statistic: str
+) -> list[Comparison]:
+    """Compares a statistic of the tests present in both runs."""
+    comparisons = []
+    for name, result in candidate.items():
+        if name not in baseline:
+            continue
+        if result.get('unit') != baseline[name].get('unit'):
+            raise ValueError(f'{name} was measured in different units')
+        comparisons.append(
+            Comparison(
+                name=name,
+                unit=result.get('unit', ''),
+                baseline=float(baseline[name][statistic]),
+                candidate=float(result[statistic]),
+            )
+        )
+    return comparisons
+
+
+def write_report(
+    comparisons: list[Comparison], threshold: float, output: TextIO
+) -> int:
+    """Writes a table of comparisons and returns the number of regressions."""
+    regressions = 0
+    width = max((len(c.name) for c in comparisons), default=0)
+    for comparison in comparisons:
+        regressed = comparison.regressed(threshold)
+        regressions += regressed
+        output.write(
+            f'{comparison.name:<{width}}  '
+            f'{comparison.baseline:>10.0f} -> {comparison.candidate:>10.0f} '
+            f'{comparison.unit:<3} {comparison.change:+8.1%}'
+            f'{"  REGRESSION" if regressed else ""}\n'
+        )
+    return regressions
+
+
+def _parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('baseline', type=Path, help='Baseline results')
+    parser.add_argument('candidate', type=Path, help='Results to check')
+    parser.add_argument(
+        '--statistic',
+        choices=STATISTICS,
+        default='median',
+        help='Statistic to compare (default: %(default)s)',
+    )
+    parser.add_argument(
+        '--threshold',
+        type=float,
+        default=5.0,
+        help='Percent increase reported as a regression (default: %(default)s)',
+    )
+    return parser.parse_args()
+
+
+def main(
+    baseline: Path, candidate: Path, statistic: str, threshold: float
+) -> int:
+    with baseline.open() as baseline_file, candidate.open() as candidate_file:
+        comparisons = compare(
+            parse_results(baseline_file),
+            parse_results(candidate_file),
+            statistic,
+        )
+    regressions = write_report(comparisons, threshold / 100, sys.stdout)
+    if regressions:
+        print(f'{regressions} of {len(comparisons)} tests regressed')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(**vars(_parse_args())))
@@ -14,6 +14,9 @@
 
 #include "pw_perf_test/state.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "pw_log/log.h"
 
 namespace pw::perf_test {
@@ -21,20 +24,134 @@ namespace internal {
 
 State CreateState(int durations,
                   EventHandler& event_handler,
-                  const char* test_name) {
-  return State(durations, event_handler, test_name);
+                  const char* test_name,
+                  std::optional<size_t> argument) {
+  return CreateState(durations,
+                     PW_PERF_TEST_WARMUP_ITERATIONS,
+                     PW_PERF_TEST_MIN_ITERATION_DURATION,
+                     event_handler,
+                     test_name,
+                     argument);
+}
+
+State CreateState(int durations,
+                  int warmup_iterations,
+                  int64_t min_iteration_duration,
+                  EventHandler& event_handler,
+                  const char* test_name,
+                  std::optional<size_t> argument) {
+  return State(durations,
+               warmup_iterations,
+               min_iteration_duration,
+               event_handler,
+               test_name,
+               argument);
 }
+
 }  // namespace internal
+namespace {
+
+// Returns the nearest-rank percentile of sorted durations.
+int64_t Percentile(const int64_t* sorted, int count, int percent) {
+  int rank = (count * percent + 99) / 100;
+  return sorted[std::max(rank, 1) - 1];
+}
+
+}  // namespace
 
 bool State::KeepRunning() {
   internal::Timestamp iteration_end = internal::GetCurrentTimestamp();
-  if (current_iteration_ < 0) {
-    current_iteration_ = 0;
+  if (phase_ == Phase::kNotStarted) {
     event_handler_->TestCaseStart(test_info);
-    iteration_start_ = internal::GetCurrentTimestamp();
+    phase_ = warmup_iterations_ > 0 ? Phase::kWarmup : PhaseAfterWarmup();
+    counter_count_ = internal::CounterCount();
+    StartIteration();
+    return true;
+  }
+
+  // Only time whole batches.
+  if (--batch_remaining_ > 0) {
     return true;
   }
-  int64_t duration = internal::GetDuration(iteration_start_, iteration_end);
+  int64_t duration =
+      internal::GetDuration(iteration_start_, iteration_end) - paused_duration_;
+
+  switch (phase_) {
+    case Phase::kWarmup:
+      if (++current_iteration_ == warmup_iterations_) {
+        current_iteration_ = 0;
+        phase_ = PhaseAfterWarmup();
+      }
+      break;
+    case Phase::kCalibrate:
+      if (duration < min_iteration_duration_ && batch_size_ < kMaxBatchSize) {
+        batch_size_ *= 2;
+      } else {
+        PW_LOG_DEBUG("Batch size: %d", batch_size_);
+        phase_ = Phase::kMeasure;
+      }
+      break;
+    case Phase::kMeasure:
+      AccumulateCounters();
+      RecordIteration(duration / batch_size_);
+      if (current_iteration_ == test_iterations_) {
+        ReportMeasurement();
+        return false;
+      }
+      break;
+    case Phase::kNotStarted:
+      break;
+  }
+
+  StartIteration();
+  return true;
+}
+
+void State::PauseTiming() {
+  pause_start_ = internal::GetCurrentTimestamp();
+  if (phase_ == Phase::kMeasure && counter_count_ != 0) {
+    internal::ReadCounters(counters_at_pause_);
+  }
+}
+
+void State::ResumeTiming() {
+  if (phase_ == Phase::kMeasure && counter_count_ != 0) {
+    internal::CounterValues counters{};
+    internal::ReadCounters(counters);
+    for (size_t i = 0; i < counter_count_; ++i) {
+      paused_counters_[i] +=
+          internal::CounterDelta(counters_at_pause_[i], counters[i]);
+    }
+  }
+  paused_duration_ +=
+      internal::GetDuration(pause_start_, internal::GetCurrentTimestamp());
+}
+
+void State::StartIteration() {
+  batch_remaining_ = batch_size_;
+  paused_duration_ = 0;
+  // Counters are read outside of the timed section.
+  if (phase_ == Phase::kMeasure && counter_count_ != 0) {
+    paused_counters_.fill(0);
+    internal::ReadCounters(counters_start_);
+  }
+  iteration_start_ = internal::GetCurrentTimestamp();
+}
+
+void State::AccumulateCounters() {
+  if (counter_count_ == 0) {
+    return;
+  }
+  internal::CounterValues counters{};
+  internal::ReadCounters(counters);
+  for (size_t i = 0; i < counter_count_; ++i) {
+    counter_totals_[i] +=
+        internal::CounterDelta(counters_start_[i], counters[i]) -
+        paused_counters_[i];
+  }
+}
+
+void State::RecordIteration(int64_t duration) {
   if (duration > max_) {
     max_ = duration;
   }
@@ -42,31 +159,61 @@ bool State::KeepRunning() {
     min_ = duration;
   }
   total_duration_ += duration;
+  durations_[static_cast<size_t>(current_iteration_)] = duration;
   ++current_iteration_;
   PW_LOG_DEBUG("Iteration number: %d - Duration: %ld",
                current_iteration_,
                static_cast<long>(duration));
   event_handler_->TestCaseIteration({static_cast<uint32_t>(current_iteration_),
                                      static_cast<float>(duration)});
-  if (current_iteration_ == test_iterations_) {
-    PW_LOG_DEBUG("Total Duration: %ld  Total Iterations: %d",
-                 static_cast<long>(total_duration_),
-                 test_iterations_);
-    mean_ = total_duration_ / test_iterations_;
-    PW_LOG_DEBUG("Mean: %ld: ", static_cast<long>(mean_));
-    PW_LOG_DEBUG("Minimum: %ld", static_cast<long>(min_));
-    PW_LOG_DEBUG("Maxmimum: %ld", static_cast<long>(max_));
-    TestMeasurement test_measurement = {
-        .mean = static_cast<float>(mean_),
-        .max = static_cast<float>(max_),
-        .min = static_cast<float>(min_),
-    };
-    event_handler_->TestCaseMeasure(test_measurement);
-    event_handler_->TestCaseEnd(test_info);
-    return false;
+}
+
+void State::ReportMeasurement() {
+  PW_LOG_DEBUG("Total Duration: %ld  Total Iterations: %d",
+               static_cast<long>(total_duration_),
+               test_iterations_);
+  mean_ = total_duration_ / test_iterations_;
+  PW_LOG_DEBUG("Mean: %ld: ", static_cast<long>(mean_));
+  PW_LOG_DEBUG("Minimum: %ld", static_cast<long>(min_));
+  PW_LOG_DEBUG("Maxmimum: %ld", static_cast<long>(max_));
+
+  const double exact_mean = static_cast<double>(total_duration_) /
+                            static_cast<double>(test_iterations_);
+  double sum_of_squares = 0;
+  for (int i = 0; i < test_iterations_; ++i) {
+    const double deviation =
+        static_cast<double>(durations_[static_cast<size_t>(i)]) - exact_mean;
+    sum_of_squares += deviation * deviation;
   }
-  iteration_start_ = internal::GetCurrentTimestamp();
-  return true;
+
+  int64_t* const durations = durations_.data();
+  std::sort(durations, durations + test_iterations_);
+  const int middle = test_iterations_ / 2;
+  const int64_t median = test_iterations_ % 2 != 0
+                             ? durations[middle]
+                             : (durations[middle - 1] + durations[middle]) / 2;
+
+  TestMeasurement test_measurement = {
+      .mean = static_cast<float>(mean_),
+      .max = static_cast<float>(max_),
+      .min = static_cast<float>(min_),
+      .median = static_cast<float>(median),
+      .p90 = static_cast<float>(Percentile(durations, test_iterations_, 90)),
+      .p99 = static_cast<float>(Percentile(durations, test_iterations_, 99)),
+      .stddev = static_cast<float>(
+          std::sqrt(sum_of_squares / static_cast<double>(test_iterations_))),
+  };
+  const double runs =
+      static_cast<double>(test_iterations_) * static_cast<double>(batch_size_);
+  for (size_t i = 0; i < counter_count_; ++i) {
+    event_handler_->TestCaseCounter({
+        .name = internal::CounterName(i),
+        .mean = static_cast<float>(static_cast<double>(counter_totals_[i]) /
+                                   runs),
+    });
+  }
+  event_handler_->TestCaseMeasure(test_measurement);
+  event_handler_->TestCaseEnd(test_info);
 }
 
 }  // namespace pw::perf_test
@@ -14,6 +14,9 @@
 
 #include "pw_perf_test/state.h"
 
+#include <cstdint>
+#include <limits>
+
 #include "pw_perf_test/event_handler.h"
 #include "pw_unit_test/framework.h"
 
@@ -32,6 +35,18 @@ class EmptyEventHandler : public EventHandler {
 
 EmptyEventHandler handler;
 
+// Records the reported iterations and measurement.
+class RecordingEventHandler : public EmptyEventHandler {
+ public:
+  void TestCaseIteration(const TestIteration&) override { ++iterations; }
+  void TestCaseMeasure(const TestMeasurement& test_measurement) override {
+    measurement = test_measurement;
+  }
+
+  int iterations = 0;
+  TestMeasurement measurement;
+};
+
 void TestFunction() {
   for (volatile int i = 0; i < 100000; i = i + 1) {
   }
@@ -59,5 +74,80 @@ TEST(StateTest, SingleTest) {
   EXPECT_EQ(total_iterations, test_iterations);
 }
 
+TEST(StateTest, WarmupIterationsAreNotMeasured) {
+  constexpr int test_iterations = 5;
+  constexpr int warmup_iterations = 3;
+  RecordingEventHandler recorder;
+  State state_obj = internal::CreateState(
+      test_iterations, warmup_iterations, 0, recorder, "");
+  int total_iterations = 0;
+  while (state_obj.KeepRunning()) {
+    ++total_iterations;
+    TestFunction();
+  }
+  EXPECT_EQ(total_iterations, warmup_iterations + test_iterations);
+  EXPECT_EQ(recorder.iterations, test_iterations);
+}
+
+TEST(StateTest, CalibrationBatchesShortIterations) {
+  constexpr int test_iterations = 2;
+  RecordingEventHandler recorder;
+  // No batch can take this long, so calibration stops at the largest batch.
+  State state_obj = internal::CreateState(test_iterations,
+                                          0,
+                                          std::numeric_limits<int64_t>::max(),
+                                          recorder,
+                                          "");
+  int total_iterations = 0;
+  while (state_obj.KeepRunning()) {
+    ++total_iterations;
+  }
+  // Calibration runs batches of 1, 2, 4, ... State::kMaxBatchSize.
+  const int calibration_iterations = 2 * State::kMaxBatchSize - 1;
+  EXPECT_EQ(total_iterations,
+            calibration_iterations + test_iterations * State::kMaxBatchSize);
+  EXPECT_EQ(recorder.iterations, test_iterations);
+}
+
+TEST(StateTest, ReportsOrderedStatistics) {
+  constexpr int test_iterations = 10;
+  RecordingEventHandler recorder;
+  State state_obj = internal::CreateState(test_iterations, recorder, "");
+  while (state_obj.KeepRunning()) {
+    TestFunction();
+  }
+  const TestMeasurement& measurement = recorder.measurement;
+  EXPECT_LE(measurement.min, measurement.median);
+  EXPECT_LE(measurement.median, measurement.p90);
+  EXPECT_LE(measurement.p90, measurement.p99);
+  EXPECT_LE(measurement.p99, measurement.max);
+  EXPECT_EQ(measurement.p99, measurement.max);
+  EXPECT_LE(measurement.min, measurement.mean);
+  EXPECT_LE(measurement.mean, measurement.max);
+  EXPECT_GE(measurement.stddev, 0.0f);
+  EXPECT_LE(measurement.stddev, measurement.max - measurement.min);
+}
+
+TEST(StateTest, PausedTimeIsNotMeasured) {
+  // Longer than an empty test body by orders of magnitude.
+  constexpr int64_t kPauseDuration = 1000000;
+  RecordingEventHandler recorder;
+  State state_obj = internal::CreateState(3, 0, 0, recorder, "");
+  while (state_obj.KeepRunning()) {
+    state_obj.PauseTiming();
+    const internal::Timestamp start = internal::GetCurrentTimestamp();
+    while (internal::GetDuration(start, internal::GetCurrentTimestamp()) <
+           kPauseDuration) {
+    }
+    state_obj.ResumeTiming();
+  }
+  EXPECT_LT(recorder.measurement.max, static_cast<float>(kPauseDuration));
+}
+
+TEST(StateTest, ReportsArgument) {
+  State state_obj = internal::CreateState(1, handler, "", 256);
+  EXPECT_EQ(state_obj.argument(), 256u);
+}
+
 }  // namespace
 }  // namespace pw::perf_test
@@ -14,6 +14,7 @@
 
 #include "pw_perf_test/internal/test_info.h"
 
+#include "pw_assert/assert.h"
 #include "pw_perf_test/internal/framework.h"
 
 namespace pw::perf_test::internal {
@@ -25,4 +26,48 @@ TestInfo::TestInfo(const char* test_name, void (*function_body)(State&))
   Framework::Get().RegisterTest(*this);
 }
 
+TestInfo::TestInfo(const char* test_name,
+                   void (*function_body)(State&),
+                   size_t first_argument,
+                   size_t last_argument)
+    : run_(function_body),
+      test_name_(test_name),
+      first_argument_(first_argument),
+      last_argument_(last_argument) {
+  // Doubling from zero would never reach the end of the range.
+  PW_ASSERT(first_argument_ > 0);
+  PW_ASSERT(first_argument_ <= last_argument_);
+  Framework::Get().RegisterTest(*this);
+}
+
+std::optional<size_t> TestInfo::first_argument() const {
+  if (last_argument_ == 0) {
+    return std::nullopt;
+  }
+  return first_argument_;
+}
+
+std::optional<size_t> TestInfo::next_argument(size_t argument) const {
+  if (argument >= last_argument_) {
+    return std::nullopt;
+  }
+  // Compare before doubling to avoid overflow.
+  if (argument > last_argument_ / 2) {
+    return last_argument_;
+  }
+  return argument * 2;
+}
+
+int TestInfo::run_count() const {
+  if (!first_argument().has_value()) {
+    return 1;
+  }
+  int count = 1;
+  for (size_t argument = first_argument_; argument < last_argument_;
+       argument = *next_argument(argument)) {
+    ++count;
+  }
+  return count;
+}
+
 }  // namespace pw::perf_test::internal
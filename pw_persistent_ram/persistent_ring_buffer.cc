@@ -0,0 +1,201 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_persistent_ram/persistent_ring_buffer.h"
+
+#include <array>
+#include <cstring>
+
+#include "pw_bytes/span.h"
+#include "pw_checksum/crc16_ccitt.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw::persistent_ram::internal {
+namespace {
+
+// Mixed into the metadata checksum so that zeroed memory is not a valid ring.
+constexpr uint32_t kMetadataMagic = 0x52505750;  // "PWPR"
+
+uint16_t ReadU16(ConstByteSpan buffer, size_t offset) {
+  uint16_t value;
+  std::memcpy(&value, buffer.data() + offset, sizeof(value));
+  return value;
+}
+
+void WriteU16(ByteSpan buffer, size_t offset, uint16_t value) {
+  std::memcpy(buffer.data() + offset, &value, sizeof(value));
+}
+
+uint16_t EntryChecksum(uint16_t size, ConstByteSpan data) {
+  return checksum::Crc16Ccitt::Calculate(
+      data, checksum::Crc16Ccitt::Calculate(as_bytes(span(&size, 1))));
+}
+
+// Entries before the tail may not wrap, so that iteration always makes
+// progress. Returns the offset of the entry header at or after offset.
+size_t SkipWrap(ConstByteSpan buffer, size_t offset, size_t tail) {
+  if (offset > tail &&
+      (buffer.size() - offset < PersistentRing::kEntryHeaderSizeBytes ||
+       ReadU16(buffer, offset) == PersistentRing::kWrapMarker)) {
+    return 0;
+  }
+  return offset;
+}
+
+// Returns the offset at which the entry that starts at offset ends, or 0 if
+// its size extends past the tail or the end of the buffer.
+size_t EntryEnd(ConstByteSpan buffer, size_t offset, size_t tail) {
+  const size_t limit = offset < tail ? tail : buffer.size();
+  if (limit - offset < PersistentRing::kEntryHeaderSizeBytes) {
+    return 0;
+  }
+  const size_t size = ReadU16(buffer, offset);
+  if (limit - offset - PersistentRing::kEntryHeaderSizeBytes < size) {
+    return 0;
+  }
+  return offset + PersistentRing::kEntryHeaderSizeBytes + size;
+}
+
+}  // namespace
+
+PersistentRing::iterator& PersistentRing::iterator::operator++() {
+  offset_ += PersistentRing::kEntryHeaderSizeBytes + entry_.size();
+  if (offset_ == buffer_.size()) {
+    offset_ = 0;
+  }
+  Load();
+  return *this;
+}
+
+void PersistentRing::iterator::Load() {
+  entry_ = {};
+  offset_ = SkipWrap(buffer_, offset_, tail_);
+  if (offset_ == tail_) {
+    return;
+  }
+
+  const size_t end = EntryEnd(buffer_, offset_, tail_);
+  if (end == 0) {
+    offset_ = tail_;
+    return;
+  }
+
+  const uint16_t size = ReadU16(buffer_, offset_);
+  const uint16_t checksum = ReadU16(buffer_, offset_ + sizeof(uint16_t));
+  ConstByteSpan data = buffer_.subspan(offset_ + kEntryHeaderSizeBytes, size);
+  if (checksum != EntryChecksum(size, data)) {
+    offset_ = tail_;
+    return;
+  }
+  entry_ = data;
+}
+
+bool PersistentRing::is_valid() const {
+  const uint32_t head = head_;
+  const uint32_t tail = tail_;
+  return head < buffer_.size() && tail < buffer_.size() &&
+         checksum_ == MetadataChecksum(head, tail);
+}
+
+uint16_t PersistentRing::MetadataChecksum(uint32_t head, uint32_t tail) const {
+  const std::array<uint32_t, 3> metadata = {kMetadataMagic, head, tail};
+  return checksum::Crc16Ccitt::Calculate(as_bytes(span(metadata)));
+}
+
+void PersistentRing::Commit(uint32_t head, uint32_t tail) {
+  head_ = head;
+  tail_ = tail;
+  checksum_ = MetadataChecksum(head, tail);
+}
+
+size_t PersistentRing::NextEntry(size_t head, size_t tail) const {
+  head = SkipWrap(buffer_, head, tail);
+  if (head == tail) {
+    return tail;
+  }
+  const size_t end = EntryEnd(buffer_, head, tail);
+  if (end == 0) {
+    return tail;  // Discard the remaining entries if they are malformed.
+  }
+  return end == buffer_.size() ? 0 : end;
+}
+
+Status PersistentRing::Write(ConstByteSpan entry) {
+  if (entry.size() > MaxEntrySizeBytes(buffer_.size())) {
+    return Status::OutOfRange();
+  }
+  if (!is_valid()) {
+    Clear();
+  }
+
+  const size_t original_head = head_;
+  const size_t original_tail = tail_;
+  size_t head = original_head;
+  size_t tail = original_tail;
+  const size_t entry_size = kEntryHeaderSizeBytes + entry.size();
+
+  // Find a contiguous free region for the entry, dropping the oldest entries
+  // until there is one. An empty ring always has room.
+  size_t offset;
+  while (true) {
+    if (head == tail) {
+      head = 0;
+      tail = 0;
+      offset = 0;
+      break;
+    }
+    if (tail > head) {
+      const size_t space_to_end = buffer_.size() - tail;
+      if (entry_size < space_to_end ||
+          (entry_size == space_to_end && head != 0)) {
+        offset = tail;
+        break;
+      }
+      if (entry_size < head) {
+        offset = 0;
+        break;
+      }
+    } else if (entry_size < head - tail) {
+      offset = tail;
+      break;
+    }
+    head = NextEntry(head, tail);
+  }
+
+  // Release the dropped entries before overwriting them, so that a reset
+  // while writing leaves a valid ring.
+  if (head != original_head || tail != original_tail) {
+    Commit(head, tail);
+  }
+
+  if (offset != tail && buffer_.size() - tail >= kEntryHeaderSizeBytes) {
+    WriteU16(buffer_, tail, kWrapMarker);
+  }
+
+  const auto size = static_cast<uint16_t>(entry.size());
+  if (!entry.empty()) {
+    std::memcpy(buffer_.data() + offset + kEntryHeaderSizeBytes,
+                entry.data(),
+                entry.size());
+  }
+  WriteU16(buffer_, offset, size);
+  WriteU16(buffer_, offset + sizeof(uint16_t), EntryChecksum(size, entry));
+
+  const size_t new_tail = offset + entry_size;
+  Commit(head, new_tail == buffer_.size() ? 0 : new_tail);
+  return OkStatus();
+}
+
+}  // namespace pw::persistent_ram::internal
@@ -0,0 +1,194 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_persistent_ram/persistent_ring_buffer.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <string_view>
+#include <vector>
+
+#include "pw_bytes/span.h"
+#include "pw_random/xor_shift.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::persistent_ram {
+namespace {
+
+class PersistentRingBufferTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kBufferSize = 64;
+  using Ring = PersistentRingBuffer<kBufferSize>;
+
+  PersistentRingBufferTest() { ZeroPersistentMemory(); }
+
+  // Emulate invalidation of persistent section(s).
+  void ZeroPersistentMemory() { std::memset(buffer_, 0, sizeof(buffer_)); }
+  void RandomFillMemory() {
+    random::XorShiftStarRng64 rng(0x9ad75);
+    rng.Get(buffer_);
+  }
+
+  Ring& GetRing() { return *(new (buffer_) Ring()); }
+
+  static std::vector<std::string_view> Entries(const Ring& ring) {
+    std::vector<std::string_view> entries;
+    for (ConstByteSpan entry : ring) {
+      entries.emplace_back(reinterpret_cast<const char*>(entry.data()),
+                           entry.size());
+    }
+    return entries;
+  }
+
+  static Status Write(Ring& ring, std::string_view entry) {
+    return ring.Write(as_bytes(span(entry)));
+  }
+
+  // Allocate a chunk of aligned storage that can be independently controlled.
+  alignas(Ring) std::byte buffer_[sizeof(Ring)];
+};
+
+TEST_F(PersistentRingBufferTest, ZeroedMemoryIsEmpty) {
+  Ring& ring = GetRing();
+  EXPECT_FALSE(ring.has_value());
+  EXPECT_EQ(ring.begin(), ring.end());
+}
+
+TEST_F(PersistentRingBufferTest, RandomMemoryIsEmpty) {
+  RandomFillMemory();
+  Ring& ring = GetRing();
+  EXPECT_FALSE(ring.has_value());
+  EXPECT_EQ(ring.begin(), ring.end());
+
+  ASSERT_EQ(OkStatus(), Write(ring, "hello"));
+  EXPECT_EQ(Entries(ring), std::vector<std::string_view>{"hello"});
+}
+
+TEST_F(PersistentRingBufferTest, EntriesSurviveReboot) {
+  {
+    Ring& ring = GetRing();
+    ASSERT_EQ(OkStatus(), Write(ring, "first"));
+    ASSERT_EQ(OkStatus(), Write(ring, ""));
+    ASSERT_EQ(OkStatus(), Write(ring, "third"));
+    ring.~Ring();  // Emulate shutdown / global destructors.
+  }
+
+  Ring& ring = GetRing();
+  EXPECT_TRUE(ring.has_value());
+  const std::vector<std::string_view> expected = {"first", "", "third"};
+  EXPECT_EQ(Entries(ring), expected);
+
+  // Entries are read in place.
+  const std::byte* data = ring.begin()->data();
+  EXPECT_GE(data, buffer_);
+  EXPECT_LT(data, buffer_ + sizeof(buffer_));
+
+  ring.clear();
+  EXPECT_FALSE(ring.has_value());
+  EXPECT_EQ(ring.begin(), ring.end());
+}
+
+TEST_F(PersistentRingBufferTest, OverwritesOldestEntries) {
+  Ring& ring = GetRing();
+  // Each entry takes 16 bytes. One byte of the ring is always left free, so
+  // three entries fit at once.
+  constexpr std::array<std::string_view, 6> kEntries = {"entry 000000",
+                                                        "entry 111111",
+                                                        "entry 222222",
+                                                        "entry 333333",
+                                                        "entry 444444",
+                                                        "entry 555555"};
+  for (std::string_view entry : kEntries) {
+    ASSERT_EQ(OkStatus(), Write(ring, entry));
+  }
+  const std::vector<std::string_view> expected = {
+      "entry 333333", "entry 444444", "entry 555555"};
+  EXPECT_EQ(Entries(ring), expected);
+}
+
+TEST_F(PersistentRingBufferTest, LargestEntry) {
+  Ring& ring = GetRing();
+  ASSERT_EQ(OkStatus(), Write(ring, "small"));
+
+  std::array<std::byte, Ring::max_entry_size_bytes() + 1> entry;
+  entry.fill(std::byte{0xAB});
+  EXPECT_EQ(Status::OutOfRange(), ring.Write(entry));
+
+  ASSERT_EQ(OkStatus(), ring.Write(span(entry).first(entry.size() - 1)));
+  auto it = ring.begin();
+  ASSERT_NE(it, ring.end());
+  EXPECT_EQ(it->size(), Ring::max_entry_size_bytes());
+  EXPECT_EQ(++it, ring.end());
+}
+
+TEST_F(PersistentRingBufferTest, CorruptEntryEndsIteration) {
+  Ring& ring = GetRing();
+  ASSERT_EQ(OkStatus(), Write(ring, "good"));
+  ASSERT_EQ(OkStatus(), Write(ring, "bad"));
+  ASSERT_EQ(OkStatus(), Write(ring, "unreachable"));
+
+  // Flip a bit in the second entry's data.
+  auto it = ring.begin();
+  ++it;
+  const size_t offset = static_cast<size_t>(it->data() - buffer_);
+  buffer_[offset] ^= std::byte{0x01};
+
+  EXPECT_EQ(Entries(ring), std::vector<std::string_view>{"good"});
+
+  // Writing still succeeds, though the newest entries are not reachable
+  // until the corrupt entry is overwritten.
+  ASSERT_EQ(OkStatus(), Write(ring, "new"));
+  EXPECT_EQ(Entries(ring), std::vector<std::string_view>{"good"});
+}
+
+TEST_F(PersistentRingBufferTest, MatchesModelWithRandomEntries) {
+  Ring& ring = GetRing();
+  random::XorShiftStarRng64 rng(0x1234);
+  std::deque<std::vector<std::byte>> model;
+  size_t model_bytes = 0;
+
+  for (int i = 0; i < 1000; ++i) {
+    uint8_t size;
+    rng.GetInt(size);
+    size %= 24;
+    std::vector<std::byte> entry(size, static_cast<std::byte>(i));
+    ASSERT_EQ(OkStatus(), ring.Write(entry));
+
+    model.push_back(entry);
+    model_bytes += 4 + size;
+
+    // The ring holds the newest entries that fit, though it may have
+    // discarded a few more to keep each entry contiguous.
+    std::vector<std::vector<std::byte>> actual;
+    for (ConstByteSpan stored : ring) {
+      actual.emplace_back(stored.begin(), stored.end());
+    }
+    ASSERT_FALSE(actual.empty());
+    while (model.size() > actual.size()) {
+      model_bytes -= 4 + model.front().size();
+      model.pop_front();
+    }
+    ASSERT_EQ(actual.size(), model.size());
+    ASSERT_LT(model_bytes, kBufferSize);
+    for (size_t j = 0; j < actual.size(); ++j) {
+      ASSERT_EQ(actual[j], model[j]);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace pw::persistent_ram
@@ -0,0 +1,216 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "pw_bytes/span.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_status/status.h"
+
+namespace pw::persistent_ram {
+namespace internal {
+
+// Implements PersistentRingBuffer on top of references to its members. This
+// object should NOT be stored in persistent RAM.
+//
+// Each entry is stored contiguously as a 16-bit size, a 16-bit CRC16-CCITT of
+// the size and the data, and then the data. An entry that does not fit before
+// the end of the buffer is written at the start instead; a size of kWrapMarker
+// (or less than a header's worth of space) at the end marks the skipped bytes.
+class PersistentRing {
+ public:
+  static constexpr size_t kEntryHeaderSizeBytes = 2 * sizeof(uint16_t);
+  static constexpr uint16_t kWrapMarker = 0xFFFF;
+
+  // Iterates over the valid entries in a ring, oldest first. Iteration stops
+  // at the first entry that fails its integrity check.
+  class iterator {
+   public:
+    using difference_type = std::ptrdiff_t;
+    using value_type = ConstByteSpan;
+    using pointer = const ConstByteSpan*;
+    using reference = const ConstByteSpan&;
+    using iterator_category = std::forward_iterator_tag;
+
+    constexpr iterator() = default;
+
+    iterator& operator++();
+    iterator operator++(int) {
+      iterator original = *this;
+      ++*this;
+      return original;
+    }
+
+    const ConstByteSpan& operator*() const { return entry_; }
+    const ConstByteSpan* operator->() const { return &entry_; }
+
+    bool operator==(const iterator& other) const {
+      return offset_ == other.offset_;
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+
+   private:
+    friend class PersistentRing;
+
+    iterator(ConstByteSpan buffer, size_t offset, size_t tail)
+        : buffer_(buffer), offset_(offset), tail_(tail) {
+      Load();
+    }
+
+    // Moves to the next entry if the current one is a wrap and reads it.
+    // Becomes the end iterator if the entry is malformed.
+    void Load();
+
+    ConstByteSpan buffer_;
+    size_t offset_ = 0;
+    size_t tail_ = 0;
+    ConstByteSpan entry_;
+  };
+
+  static constexpr size_t MaxEntrySizeBytes(size_t buffer_size_bytes) {
+    // One byte is always left free to distinguish a full ring from an empty
+    // one.
+    return std::min<size_t>(buffer_size_bytes - kEntryHeaderSizeBytes - 1,
+                            kWrapMarker - 1);
+  }
+
+  PersistentRing(ByteSpan buffer,
+                 volatile uint32_t& head,
+                 volatile uint32_t& tail,
+                 volatile uint16_t& checksum)
+      : buffer_(buffer), head_(head), tail_(tail), checksum_(checksum) {}
+
+  bool is_valid() const;
+
+  bool empty() const { return !is_valid() || head_ == tail_; }
+
+  void Clear() { Commit(0, 0); }
+
+  Status Write(ConstByteSpan entry);
+
+  iterator begin() const {
+    if (!is_valid()) {
+      return end();
+    }
+    return iterator(buffer_, head_, tail_);
+  }
+
+  iterator end() const {
+    const size_t tail = is_valid() ? tail_ : 0;
+    return iterator(buffer_, tail, tail);
+  }
+
+ private:
+  uint16_t MetadataChecksum(uint32_t head, uint32_t tail) const;
+
+  // Stores new head and tail offsets along with their checksum.
+  void Commit(uint32_t head, uint32_t tail);
+
+  // Returns the offset following the oldest entry, which starts at or after
+  // head, or tail if the entry is malformed.
+  size_t NextEntry(size_t head, size_t tail) const;
+
+  ByteSpan buffer_;
+  volatile uint32_t& head_;
+  volatile uint32_t& tail_;
+  volatile uint16_t& checksum_;
+};
+
+}  // namespace internal
+
+// The PersistentRingBuffer class intentionally uses uninitialized memory, which
+// triggers compiler warnings. Disable those warnings for this file.
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC(ignored, "-Wuninitialized");
+PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wmaybe-uninitialized");
+
+// A PersistentRingBuffer stores variable-length entries in persistent RAM,
+// overwriting the oldest entries once it is full. Like PersistentBuffer, its
+// constructor is effectively a no-op, so its contents survive soft resets and
+// it is safe to use before static constructors are called.
+//
+// The ring's offsets and each entry are checksummed separately. Writing an
+// entry only checksums that entry, and an entry that was interrupted by a
+// reset is dropped without affecting the entries before it.
+//
+// Entries are never split across the end of the buffer, so iterating over the
+// ring yields each entry as a single span directly into persistent RAM.
+template <size_t kSizeBytes>
+class PersistentRingBuffer {
+ public:
+  static_assert(kSizeBytes > internal::PersistentRing::kEntryHeaderSizeBytes,
+                "The buffer must be large enough for at least one entry");
+  static_assert(kSizeBytes <= UINT32_MAX);
+
+  using iterator = internal::PersistentRing::iterator;
+  using const_iterator = iterator;
+
+  // The default constructor intentionally does not initialize anything. See
+  // PersistentBuffer for details.
+  PersistentRingBuffer() {}
+  // Disable copy and move constructors.
+  PersistentRingBuffer(const PersistentRingBuffer&) = delete;
+  PersistentRingBuffer(PersistentRingBuffer&&) = delete;
+  // Explicit no-op destructor.
+  ~PersistentRingBuffer() {}
+
+  // The largest entry that may be written to this ring.
+  static constexpr size_t max_entry_size_bytes() {
+    return internal::PersistentRing::MaxEntrySizeBytes(kSizeBytes);
+  }
+
+  // Appends an entry, discarding the oldest entries as needed to make room.
+  // The ring is cleared first if its contents are not valid.
+  //
+  // Returns:
+  //   OK - The entry was written.
+  //   OUT_OF_RANGE - The entry is larger than max_entry_size_bytes().
+  Status Write(ConstByteSpan entry) { return Ring().Write(entry); }
+
+  // Iterates over the stored entries, oldest first. Each entry's data is
+  // checked as it is read; iteration stops at the first invalid entry.
+  //
+  // The spans refer to persistent RAM and are invalidated by Write() and
+  // clear().
+  iterator begin() const { return Ring().begin(); }
+  iterator end() const { return Ring().end(); }
+
+  bool has_value() const { return !Ring().empty(); }
+
+  void clear() { Ring().Clear(); }
+
+ private:
+  internal::PersistentRing Ring() const {
+    auto* self = const_cast<PersistentRingBuffer*>(this);
+    return internal::PersistentRing(
+        ByteSpan(const_cast<std::byte*>(self->buffer_), kSizeBytes),
+        self->head_,
+        self->tail_,
+        self->checksum_);
+  }
+
+  // None of these members are initialized by the constructor by design.
+  volatile uint16_t checksum_;
+  volatile uint32_t head_;
+  volatile uint32_t tail_;
+  volatile std::byte buffer_[kSizeBytes];
+};
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
+}  // namespace pw::persistent_ram
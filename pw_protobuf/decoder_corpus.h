@@ -0,0 +1,127 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// Seed corpus of encoded `pw.log.LogEntries` messages, shared by the decoder's
+// unit tests and its corpus benchmark.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/array.h"
+#include "pw_bytes/span.h"
+#include "pw_protobuf/stream_decoder.h"
+#include "pw_status/status.h"
+#include "pw_status/try.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::protobuf::test {
+
+// A single tokenized log entry.
+inline constexpr auto kSingleLogEntry = bytes::String(
+    "\x0a\x11\x0a\x05\x73\x7c\xc2\xcb\x54\x10\xda\x07"
+    "\x20\xb5\x88\x86\xfe\xea\x31\x10\x01");
+
+// A batch of tokenized log entries with metadata.
+inline constexpr auto kLogEntryBatch = bytes::String(
+    "\x0a\x1a\x0a\x07\xd0\x12\x16\x7e\x89\xe5\x22\x10"
+    "\xf1\x11\x28\xcd\x85\x03\x3a\x02\x42\x54\x4a\x04"
+    "\x6d\x61\x69\x6e\x0a\x1a\x0a\x07\x85\xdc\x03\x32"
+    "\xb9\xce\x31\x10\xe3\x73\x28\x85\xfa\x02\x3a\x02"
+    "\x42\x54\x4a\x04\x6d\x61\x69\x6e\x0a\x1a\x0a\x07"
+    "\x46\x22\x39\x50\xbf\x9a\x0c\x10\xfa\x79\x28\xdc"
+    "\xfb\x01\x3a\x02\x42\x54\x4a\x04\x6d\x61\x69\x6e"
+    "\x0a\x1a\x0a\x07\xa9\x77\x45\x50\x8d\xf6\x26\x10"
+    "\xed\x44\x28\xdc\xf6\x02\x3a\x02\x42\x54\x4a\x04"
+    "\x6d\x61\x69\x6e\x0a\x1a\x0a\x07\x63\xa1\xe6\x46"
+    "\x82\xb0\x36\x10\x9d\x7b\x28\x83\xa0\x05\x3a\x02"
+    "\x42\x54\x4a\x04\x6d\x61\x69\x6e\x0a\x1a\x0a\x07"
+    "\x16\xd9\xad\x06\xa9\xce\x05\x10\xfb\x49\x28\xb7"
+    "\x94\x04\x3a\x02\x42\x54\x4a\x04\x6d\x61\x69\x6e"
+    "\x10\x2a");
+
+// Plain text log entries with file and thread names.
+inline constexpr auto kTextLogEntries = bytes::String(
+    "\x0a\x5e\x0a\x2d\x46\x61\x69\x6c\x65\x64\x20\x74"
+    "\x6f\x20\x63\x6f\x6e\x6e\x65\x63\x74\x20\x74\x6f"
+    "\x20\x68\x6f\x73\x74\x3a\x20\x63\x6f\x6e\x6e\x65"
+    "\x63\x74\x69\x6f\x6e\x20\x72\x65\x66\x75\x73\x65"
+    "\x64\x10\xec\x04\x20\x98\x89\x86\xfe\xea\x31\x30"
+    "\x03\x3a\x03\x4e\x45\x54\x42\x10\x70\x77\x5f\x6e"
+    "\x65\x74\x2f\x73\x6f\x63\x6b\x65\x74\x2e\x63\x63"
+    "\x4a\x0a\x6e\x65\x74\x5f\x77\x6f\x72\x6b\x65\x72"
+    "\x0a\x41\x0a\x12\x52\x65\x74\x72\x79\x69\x6e\x67"
+    "\x20\x69\x6e\x20\x35\x30\x30\x20\x6d\x73\x10\x82"
+    "\x05\x20\xa4\x89\x86\xfe\xea\x31\x3a\x03\x4e\x45"
+    "\x54\x42\x10\x70\x77\x5f\x6e\x65\x74\x2f\x73\x6f"
+    "\x63\x6b\x65\x74\x2e\x63\x63\x4a\x0a\x6e\x65\x74"
+    "\x5f\x77\x6f\x72\x6b\x65\x72\x10\x64");
+inline constexpr std::array<ConstByteSpan, 3> kDecoderCorpus = {
+    kSingleLogEntry,
+    kLogEntryBatch,
+    kTextLogEntries,
+};
+
+// Number of log entries in kDecoderCorpus.
+inline constexpr size_t kDecoderCorpusEntries = 9;
+
+// Decodes every field of a `pw.log.LogEntry`.
+inline Status DecodeLogEntry(StreamDecoder& decoder) {
+  std::array<std::byte, 64> buffer;
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (decoder.FieldNumber().value()) {
+      case 1:  // message
+      case 7:  // module
+      case 8:  // file
+      case 9:  // thread
+        PW_TRY(decoder.ReadBytes(buffer).status());
+        break;
+      case 2:  // line_level
+      case 3:  // flags
+      case 6:  // dropped
+        PW_TRY(decoder.ReadUint32().status());
+        break;
+      case 4:  // timestamp
+      case 5:  // time_since_last_entry
+        PW_TRY(decoder.ReadInt64().status());
+        break;
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : status;
+}
+
+// Decodes a `pw.log.LogEntries` message and counts its entries.
+inline Status DecodeLogEntries(ConstByteSpan encoded, size_t& entries) {
+  stream::MemoryReader reader(encoded);
+  StreamDecoder decoder(reader);
+  Status status;
+  while ((status = decoder.Next()).ok()) {
+    switch (decoder.FieldNumber().value()) {
+      case 1: {  // entries
+        StreamDecoder entry = decoder.GetNestedDecoder();
+        PW_TRY(DecodeLogEntry(entry));
+        entries += 1;
+        break;
+      }
+      case 2:  // first_entry_sequence_id
+        PW_TRY(decoder.ReadUint32().status());
+        break;
+    }
+  }
+  return status.IsOutOfRange() ? OkStatus() : status;
+}
+
+}  // namespace pw::protobuf::test
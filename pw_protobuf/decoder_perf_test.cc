@@ -0,0 +1,35 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+#include "decoder_corpus.h"
+#include "pw_assert/assert.h"
+#include "pw_fuzzer/corpus_benchmark.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::protobuf {
+namespace {
+
+void DecodeCorpus(perf_test::State& state) {
+  size_t entries = 0;
+  fuzzer::MeasureCorpus(state, test::kDecoderCorpus, [&](ConstByteSpan input) {
+    PW_ASSERT(test::DecodeLogEntries(input, entries).ok());
+  });
+  PW_ASSERT(entries % test::kDecoderCorpusEntries == 0);
+}
+
+PW_PERF_TEST(LogEntriesDecoderCorpus, DecodeCorpus);
+
+}  // namespace
+}  // namespace pw::protobuf
@@ -18,6 +18,7 @@
 #include <cstddef>
 #include <cstring>
 #include <optional>
+#include <string_view>
 
 #include "pw_assert/check.h"
 #include "pw_bytes/span.h"
@@ -37,6 +38,350 @@ namespace pw::protobuf {
 
 using internal::VarintType;
 
+namespace {
+
+bool IsAllZero(span<const std::byte> values) {
+  return static_cast<size_t>(std::count(
+             values.begin(), values.end(), std::byte{0})) == values.size();
+}
+
+template <typename T>
+size_t SizeOfPackedVarints(uint32_t field_number,
+                           span<const T> values,
+                           VarintType encode_type) {
+  size_t payload_size = 0;
+  for (T value : values) {
+    if (encode_type == VarintType::kZigZag) {
+      payload_size += varint::EncodedSize(varint::ZigZagEncode(
+          static_cast<int64_t>(static_cast<std::make_signed_t<T>>(value))));
+    } else {
+      payload_size += varint::EncodedSize(static_cast<uint64_t>(value));
+    }
+  }
+  return SizeOfDelimitedField(field_number,
+                              static_cast<uint32_t>(payload_size));
+}
+
+template <typename T>
+size_t SizeOfPackedVector(uint32_t field_number,
+                          const std::byte* raw_vector,
+                          VarintType encode_type) {
+  const auto& vector =
+      *reinterpret_cast<const pw::Vector<const T>*>(raw_vector);
+  if (vector.empty()) {
+    return 0;
+  }
+  return SizeOfPackedVarints(
+      field_number, span(vector.data(), vector.size()), encode_type);
+}
+
+template <typename T>
+size_t SizeOfPackedArray(uint32_t field_number,
+                         span<const std::byte> values,
+                         VarintType encode_type) {
+  return SizeOfPackedVarints(field_number,
+                             span(reinterpret_cast<const T*>(values.data()),
+                                  values.size() / sizeof(T)),
+                             encode_type);
+}
+
+// Returns the contents of a use_allocator field of a message struct, whose
+// struct member is a span of the field's element type, or a std::string_view.
+span<const std::byte> AllocatedFieldBytes(const internal::MessageField& field,
+                                          span<const std::byte> values) {
+  if (field.is_string()) {
+    const auto& value =
+        *reinterpret_cast<const std::string_view*>(values.data());
+    return as_bytes(span(value.data(), value.size()));
+  }
+  if (field.elem_size() == sizeof(uint64_t)) {
+    return as_bytes(
+        *reinterpret_cast<const span<const uint64_t>*>(values.data()));
+  }
+  if (field.elem_size() == sizeof(uint32_t)) {
+    return as_bytes(
+        *reinterpret_cast<const span<const uint32_t>*>(values.data()));
+  }
+  // bytes fields and repeated bool fields have single byte elements.
+  return *reinterpret_cast<const span<const std::byte>*>(values.data());
+}
+
+// Returns the value a singular varint field of a message struct is encoded
+// as. Signed values are ZigZag encoded or sign-extended to 64 bits.
+uint64_t SingularVarintValue(const internal::MessageField& field,
+                             span<const std::byte> values) {
+  PW_CHECK(values.size() == field.elem_size(),
+           "Mismatched message field type and size");
+  if (field.elem_size() == sizeof(uint64_t)) {
+    if (field.varint_type() == VarintType::kZigZag) {
+      return varint::ZigZagEncode(
+          *reinterpret_cast<const int64_t*>(values.data()));
+    }
+    if (field.varint_type() == VarintType::kNormal) {
+      return static_cast<uint64_t>(
+          *reinterpret_cast<const int64_t*>(values.data()));
+    }
+    return *reinterpret_cast<const uint64_t*>(values.data());
+  }
+  if (field.elem_size() == sizeof(uint32_t)) {
+    if (field.varint_type() == VarintType::kZigZag) {
+      return varint::ZigZagEncode(
+          *reinterpret_cast<const int32_t*>(values.data()));
+    }
+    if (field.varint_type() == VarintType::kNormal) {
+      return static_cast<uint64_t>(
+          *reinterpret_cast<const int32_t*>(values.data()));
+    }
+    return *reinterpret_cast<const uint32_t*>(values.data());
+  }
+  if (field.elem_size() == sizeof(bool)) {
+    return *reinterpret_cast<const bool*>(values.data());
+  }
+  return 0;
+}
+
+// The maximum encoded size of a singular scalar field: its key, followed by a
+// 64-bit varint or fixed value.
+constexpr size_t kMaxScalarFieldSizeBytes =
+    varint::kMaxVarint32SizeBytes + varint::kMaxVarint64SizeBytes;
+
+// The size of the buffer in which StreamEncoder::Write() encodes consecutive
+// singular scalar fields before writing them to the stream.
+constexpr size_t kScalarFieldBufferSizeBytes = 4 * kMaxScalarFieldSizeBytes;
+
+// Encodes a singular scalar field of a message struct to `out`, which must
+// have room for kMaxScalarFieldSizeBytes. Returns the encoded size, or 0 if the
+// field has its default value and is not written.
+size_t EncodeSingularScalarField(const internal::MessageField& field,
+                                 span<const std::byte> values,
+                                 ByteSpan out) {
+  if (field.wire_type() == WireType::kVarint) {
+    const uint64_t value = SingularVarintValue(field, values);
+    if (value == 0) {
+      return 0;
+    }
+    const size_t key_size = varint::EncodeLittleEndianBase128(
+        FieldKey(field.field_number(), WireType::kVarint), out);
+    return key_size +
+           varint::EncodeLittleEndianBase128(value, out.subspan(key_size));
+  }
+
+  PW_CHECK(values.size() == field.elem_size() &&
+               field.elem_size() == (field.wire_type() == WireType::kFixed32
+                                         ? sizeof(uint32_t)
+                                         : sizeof(uint64_t)),
+           "Mismatched message field type and size");
+  if (IsAllZero(values)) {
+    return 0;
+  }
+  const size_t key_size = varint::EncodeLittleEndianBase128(
+      FieldKey(field.field_number(), field.wire_type()), out);
+  std::memcpy(out.data() + key_size, values.data(), values.size());
+  return key_size + values.size();
+}
+
+// Returns the encoded size of a single field of a message struct, as
+// StreamEncoder::Write() writes it, or std::nullopt if the field uses a
+// callback.
+std::optional<size_t> SizeOfMessageField(span<const std::byte> values,
+                                         const internal::MessageField& field);
+
+// Returns the encoded size of a message struct, as StreamEncoder::Write()
+// writes it, or std::nullopt if the size cannot be known without encoding the
+// message because it contains callback fields.
+std::optional<size_t> SizeOfMessage(span<const std::byte> message,
+                                    span<const internal::MessageField> table) {
+  size_t size = 0;
+  for (const auto& field : table) {
+    const std::optional<size_t> field_size = SizeOfMessageField(
+        message.subspan(field.field_offset(), field.field_size()), field);
+    if (!field_size.has_value()) {
+      return std::nullopt;
+    }
+    size += *field_size;
+  }
+  return size;
+}
+
+std::optional<size_t> SizeOfMessageField(span<const std::byte> values,
+                                         const internal::MessageField& field) {
+  if (field.use_callback()) {
+    return std::nullopt;
+  }
+
+  const uint32_t field_number = field.field_number();
+  if (field.use_allocator()) {
+    const span<const std::byte> data = AllocatedFieldBytes(field, values);
+    if (data.empty()) {
+      return 0;
+    }
+    if (field.wire_type() != WireType::kVarint) {
+      return SizeOfDelimitedField(field_number,
+                                  static_cast<uint32_t>(data.size()));
+    }
+    if (field.elem_size() == sizeof(uint64_t)) {
+      return SizeOfPackedArray<uint64_t>(
+          field_number, data, field.varint_type());
+    }
+    if (field.elem_size() == sizeof(uint32_t)) {
+      return SizeOfPackedArray<uint32_t>(
+          field_number, data, field.varint_type());
+    }
+    return SizeOfPackedArray<uint8_t>(field_number, data, field.varint_type());
+  }
+
+  switch (field.wire_type()) {
+    case WireType::kFixed64:
+    case WireType::kFixed32: {
+      const size_t elem_size = field.elem_size();
+      if (field.is_fixed_size()) {
+        return IsAllZero(values)
+                   ? 0
+                   : SizeOfDelimitedField(field_number,
+                                          static_cast<uint32_t>(values.size()));
+      }
+      if (field.is_repeated()) {
+        const size_t count =
+            elem_size == sizeof(uint64_t)
+                ? reinterpret_cast<const pw::Vector<const uint64_t>*>(
+                      values.data())
+                      ->size()
+                : reinterpret_cast<const pw::Vector<const uint32_t>*>(
+                      values.data())
+                      ->size();
+        return count == 0 ? 0
+                          : SizeOfDelimitedField(
+                                field_number,
+                                static_cast<uint32_t>(count * elem_size));
+      }
+      if (field.is_optional()) {
+        const bool has_value =
+            elem_size == sizeof(uint64_t)
+                ? reinterpret_cast<const std::optional<uint64_t>*>(
+                      values.data())
+                      ->has_value()
+                : reinterpret_cast<const std::optional<uint32_t>*>(
+                      values.data())
+                      ->has_value();
+        return has_value ? TagSizeBytes(field_number) + elem_size : 0;
+      }
+      return IsAllZero(values) ? 0 : TagSizeBytes(field_number) + elem_size;
+    }
+
+    case WireType::kVarint: {
+      const VarintType varint_type = field.varint_type();
+      if (field.is_fixed_size()) {
+        if (IsAllZero(values)) {
+          return 0;
+        }
+        if (field.elem_size() == sizeof(uint64_t)) {
+          return SizeOfPackedArray<uint64_t>(field_number, values, varint_type);
+        }
+        if (field.elem_size() == sizeof(uint32_t)) {
+          return SizeOfPackedArray<uint32_t>(field_number, values, varint_type);
+        }
+        return SizeOfPackedArray<uint8_t>(field_number, values, varint_type);
+      }
+      if (field.is_repeated()) {
+        if (field.elem_size() == sizeof(uint64_t)) {
+          return SizeOfPackedVector<uint64_t>(
+              field_number, values.data(), varint_type);
+        }
+        if (field.elem_size() == sizeof(uint32_t)) {
+          return SizeOfPackedVector<uint32_t>(
+              field_number, values.data(), varint_type);
+        }
+        return SizeOfPackedVector<uint8_t>(
+            field_number, values.data(), varint_type);
+      }
+
+      // Mirror the conversions of StreamEncoder::Write(), so that signed
+      // values are sign-extended to 64 bits as they are when written.
+      uint64_t value = 0;
+      if (field.is_optional()) {
+        if (field.elem_size() == sizeof(uint64_t)) {
+          if (varint_type == VarintType::kUnsigned) {
+            const auto& optional =
+                *reinterpret_cast<const std::optional<uint64_t>*>(
+                    values.data());
+            if (!optional.has_value()) {
+              return 0;
+            }
+            value = optional.value();
+          } else {
+            const auto& optional =
+                *reinterpret_cast<const std::optional<int64_t>*>(values.data());
+            if (!optional.has_value()) {
+              return 0;
+            }
+            value = varint_type == VarintType::kZigZag
+                        ? varint::ZigZagEncode(optional.value())
+                        : optional.value();
+          }
+        } else if (field.elem_size() == sizeof(uint32_t)) {
+          if (varint_type == VarintType::kUnsigned) {
+            const auto& optional =
+                *reinterpret_cast<const std::optional<uint32_t>*>(
+                    values.data());
+            if (!optional.has_value()) {
+              return 0;
+            }
+            value = optional.value();
+          } else {
+            const auto& optional =
+                *reinterpret_cast<const std::optional<int32_t>*>(values.data());
+            if (!optional.has_value()) {
+              return 0;
+            }
+            value = varint_type == VarintType::kZigZag
+                        ? varint::ZigZagEncode(optional.value())
+                        : optional.value();
+          }
+        } else if (field.elem_size() == sizeof(bool)) {
+          const auto& optional =
+              *reinterpret_cast<const std::optional<bool>*>(values.data());
+          if (!optional.has_value()) {
+            return 0;
+          }
+          value = optional.value();
+        }
+        return SizeOfVarintField(field_number, value);
+      }
+
+      value = SingularVarintValue(field, values);
+      return value == 0 ? 0 : SizeOfVarintField(field_number, value);
+    }
+
+    case WireType::kDelimited: {
+      size_t length = 0;
+      if (field.nested_message_fields()) {
+        const std::optional<size_t> nested_size =
+            SizeOfMessage(values, *field.nested_message_fields());
+        if (!nested_size.has_value()) {
+          return std::nullopt;
+        }
+        length = *nested_size;
+      } else if (field.is_fixed_size()) {
+        length = IsAllZero(values) ? 0 : values.size();
+      } else if (field.is_string()) {
+        length =
+            reinterpret_cast<const InlineString<>*>(values.data())->size();
+      } else {
+        length = reinterpret_cast<const Vector<const std::byte>*>(values.data())
+                     ->size();
+      }
+      // Empty delimited fields are not written.
+      return length == 0
+                 ? 0
+                 : SizeOfDelimitedField(field_number,
+                                        static_cast<uint32_t>(length));
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
 StreamEncoder StreamEncoder::GetNestedEncoder(uint32_t field_number,
                                               bool write_when_empty) {
   PW_CHECK(!nested_encoder_open());
@@ -244,11 +589,47 @@ Status StreamEncoder::UpdateStatusForWrite(uint32_t field_number,
   return status_;
 }
 
+Status StreamEncoder::WriteNestedMessage(
+    uint32_t field_number,
+    span<const std::byte> message,
+    span<const internal::MessageField> table,
+    size_t size) {
+  // Empty nested messages are not written, as with a nested encoder that is
+  // not written when empty.
+  if (size == 0) {
+    return status_;
+  }
+
+  if (varint::EncodedSize(size) > config::kMaxVarintSize) {
+    return status_ = Status::OutOfRange();
+  }
+
+  PW_TRY(UpdateStatusForWrite(field_number, WireType::kDelimited, size));
+  status_.Update(
+      WriteLengthDelimitedKeyAndLengthPrefix(field_number, size, writer_));
+  PW_TRY(status_);
+  return Write(message, table);
+}
+
 Status StreamEncoder::Write(span<const std::byte> message,
                             span<const internal::MessageField> table) {
   PW_CHECK(!nested_encoder_open());
   PW_TRY(status_);
 
+  // Consecutive singular scalar fields are encoded to this buffer and written
+  // to the stream together, rather than with separate writes for each key and
+  // value. The write limit is checked for each field, as for other writes.
+  std::array<std::byte, kScalarFieldBufferSizeBytes> scalar_buffer;
+  size_t scalar_bytes = 0;
+  size_t scalar_write_limit = 0;
+  const auto flush_scalar_fields = [&]() {
+    if (scalar_bytes != 0) {
+      status_.Update(writer_.Write(span(scalar_buffer).first(scalar_bytes)));
+      scalar_bytes = 0;
+    }
+    return status_;
+  };
+
   for (const auto& field : table) {
     // Calculate the span of bytes corresponding to the structure field to
     // read from.
@@ -257,6 +638,28 @@ Status StreamEncoder::Write(span<const std::byte> message,
     PW_CHECK(values.begin() >= message.begin() &&
              values.end() <= message.end());
 
+    if (field.is_singular_scalar()) {
+      if (!ValidFieldNumber(field.field_number())) {
+        PW_TRY(flush_scalar_fields());
+        return status_ = Status::InvalidArgument();
+      }
+      if (scalar_buffer.size() - scalar_bytes < kMaxScalarFieldSizeBytes) {
+        PW_TRY(flush_scalar_fields());
+      }
+      if (scalar_bytes == 0) {
+        scalar_write_limit = writer_.ConservativeWriteLimit();
+      }
+      const size_t field_size = EncodeSingularScalarField(
+          field, values, span(scalar_buffer).subspan(scalar_bytes));
+      if (scalar_bytes + field_size > scalar_write_limit) {
+        PW_TRY(flush_scalar_fields());
+        return status_ = Status::ResourceExhausted();
+      }
+      scalar_bytes += field_size;
+      continue;
+    }
+    PW_TRY(flush_scalar_fields());
+
     // If the field is using callbacks, interpret the input field accordingly
     // and allow the caller to provide custom handling.
     if (field.use_callback()) {
@@ -267,11 +670,43 @@ Status StreamEncoder::Write(span<const std::byte> message,
       continue;
     }
 
+    // If the field's contents were allocated, the struct member is a view of
+    // them. Repeated fields are written packed.
+    if (field.use_allocator()) {
+      const span<const std::byte> data = AllocatedFieldBytes(field, values);
+      if (data.empty()) {
+        continue;
+      }
+      if (!field.is_repeated()) {
+        PW_TRY(WriteLengthDelimitedField(field.field_number(), data));
+      } else if (field.wire_type() != WireType::kVarint) {
+        PW_TRY(WritePackedFixed(field.field_number(), data, field.elem_size()));
+      } else if (field.elem_size() == sizeof(uint64_t)) {
+        PW_TRY(WritePackedVarints(
+            field.field_number(),
+            span(reinterpret_cast<const uint64_t*>(data.data()),
+                 data.size() / sizeof(uint64_t)),
+            field.varint_type()));
+      } else if (field.elem_size() == sizeof(uint32_t)) {
+        PW_TRY(WritePackedVarints(
+            field.field_number(),
+            span(reinterpret_cast<const uint32_t*>(data.data()),
+                 data.size() / sizeof(uint32_t)),
+            field.varint_type()));
+      } else {
+        PW_TRY(WritePackedVarints(
+            field.field_number(),
+            span(reinterpret_cast<const uint8_t*>(data.data()), data.size()),
+            field.varint_type()));
+      }
+      continue;
+    }
+
     switch (field.wire_type()) {
       case WireType::kFixed64:
       case WireType::kFixed32: {
-        // Fixed fields call WriteFixed() for singular case and
-        // WritePackedFixed() for repeated fields.
+        // Singular fixed fields are written above. Optional fields call
+        // WriteFixed(), and repeated fields call WritePackedFixed().
         PW_CHECK(field.elem_size() == (field.wire_type() == WireType::kFixed32
                                            ? sizeof(uint32_t)
                                            : sizeof(uint64_t)),
@@ -333,20 +768,12 @@ Status StreamEncoder::Write(span<const std::byte> message,
                   WriteFixed(field.field_number(), as_bytes(span(&value, 1))));
             }
           }
-        } else {
-          PW_CHECK(values.size() == field.elem_size(),
-                   "Mismatched message field type and size");
-          if (static_cast<size_t>(
-                  std::count(values.begin(), values.end(), std::byte{0})) <
-              values.size()) {
-            PW_TRY(WriteFixed(field.field_number(), values));
-          }
         }
         break;
       }
       case WireType::kVarint: {
-        // Varint fields call WriteVarintField() for singular case and
-        // WritePackedVarints() for repeated fields.
+        // Singular varint fields are written above. Optional fields call
+        // WriteVarintField(), and repeated fields call WritePackedVarints().
         PW_CHECK(field.elem_size() == sizeof(uint64_t) ||
                      field.elem_size() == sizeof(uint32_t) ||
                      field.elem_size() == sizeof(bool),
@@ -474,46 +901,6 @@ Status StreamEncoder::Write(span<const std::byte> message,
             value = optional->value();
           }
           PW_TRY(WriteVarintField(field.field_number(), value));
-        } else {
-          // The struct member for this field is a scalar of a type
-          // corresponding to the field element size. Cast to the correct
-          // type to retrieve the value before passing to WriteVarintField()
-          // so we're not performing type aliasing (except for unsigned vs
-          // signed which is explicitly allowed).
-          PW_CHECK(values.size() == field.elem_size(),
-                   "Mismatched message field type and size");
-          uint64_t value = 0;
-          if (field.elem_size() == sizeof(uint64_t)) {
-            if (field.varint_type() == VarintType::kZigZag) {
-              value = varint::ZigZagEncode(
-                  *reinterpret_cast<const int64_t*>(values.data()));
-            } else if (field.varint_type() == VarintType::kNormal) {
-              value = *reinterpret_cast<const int64_t*>(values.data());
-            } else {
-              value = *reinterpret_cast<const uint64_t*>(values.data());
-            }
-            if (!value) {
-              continue;
-            }
-          } else if (field.elem_size() == sizeof(uint32_t)) {
-            if (field.varint_type() == VarintType::kZigZag) {
-              value = varint::ZigZagEncode(
-                  *reinterpret_cast<const int32_t*>(values.data()));
-            } else if (field.varint_type() == VarintType::kNormal) {
-              value = *reinterpret_cast<const int32_t*>(values.data());
-            } else {
-              value = *reinterpret_cast<const uint32_t*>(values.data());
-            }
-            if (!value) {
-              continue;
-            }
-          } else if (field.elem_size() == sizeof(bool)) {
-            value = *reinterpret_cast<const bool*>(values.data());
-            if (!value) {
-              continue;
-            }
-          }
-          PW_TRY(WriteVarintField(field.field_number(), value));
         }
         break;
       }
@@ -525,11 +912,26 @@ Status StreamEncoder::Write(span<const std::byte> message,
                  "Repeated delimited messages always require a callback");
         if (field.nested_message_fields()) {
           // Nested Message. Struct member is an embedded struct for the
-          // nested field. Obtain a nested encoder and recursively call Write()
-          // using the fields table pointer from this field.
-          auto nested_encoder = GetNestedEncoder(field.field_number(),
-                                                 /*write_when_empty=*/false);
-          PW_TRY(nested_encoder.Write(values, *field.nested_message_fields()));
+          // nested field.
+          const span<const internal::MessageField> nested_table =
+              *field.nested_message_fields();
+          std::optional<size_t> nested_size;
+          if constexpr (config::kPrecomputeNestedMessageSizes) {
+            nested_size = SizeOfMessage(values, nested_table);
+          }
+          if (nested_size.has_value()) {
+            // The size of the nested message is known, so write its length
+            // prefix and then its fields directly to the stream.
+            PW_TRY(WriteNestedMessage(
+                field.field_number(), values, nested_table, *nested_size));
+          } else {
+            // Obtain a nested encoder, which stages the message in the scratch
+            // buffer, and recursively call Write() using the fields table
+            // pointer from this field.
+            auto nested_encoder = GetNestedEncoder(field.field_number(),
+                                                   /*write_when_empty=*/false);
+            PW_TRY(nested_encoder.Write(values, nested_table));
+          }
         } else if (field.is_fixed_size()) {
           // Fixed-length bytes field. Struct member is a std::array<std::byte>.
           // Call WriteLengthDelimitedField() to output it to the stream.
@@ -560,7 +962,7 @@ Status StreamEncoder::Write(span<const std::byte> message,
     }
   }
 
-  return status_;
+  return flush_scalar_fields();
 }
 
 }  // namespace pw::protobuf
@@ -14,9 +14,16 @@
 
 #include "pw_protobuf/encoder.h"
 
+#include <cstddef>
+#include <string_view>
+
 #include "pw_bytes/span.h"
+#include "pw_containers/vector.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_protobuf/internal/codegen.h"
 #include "pw_span/span.h"
 #include "pw_stream/memory_stream.h"
+#include "pw_string/string.h"
 #include "pw_unit_test/framework.h"
 
 namespace pw::protobuf {
@@ -540,5 +547,313 @@ TEST(StreamEncoder, ManualCloseEncoderWrites) {
   ASSERT_EQ(parent.size(), kExpectedSize);
 }
 
+// Hand-written equivalents of the structs and field tables generated for the
+// following messages, used to test encoding message structs.
+//
+//   message InnerStruct {
+//     uint32 id = 1;
+//     string name = 2;
+//     repeated sint32 deltas = 3;
+//   }
+//
+//   message OuterStruct {
+//     int32 value = 1;
+//     InnerStruct inner = 2;
+//     InnerStruct empty = 3;
+//   }
+struct InnerStruct {
+  uint32_t id;
+  InlineString<8> name;
+  Vector<int32_t, 4> deltas;
+};
+
+struct OuterStruct {
+  int32_t value;
+  InnerStruct inner;
+  InnerStruct empty;
+};
+
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC(ignored, "-Winvalid-offsetof");
+
+constexpr internal::MessageField kInnerStructFieldsArray[] = {
+    {1,
+     WireType::kVarint,
+     sizeof(uint32_t),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(InnerStruct, id),
+     sizeof(InnerStruct::id),
+     nullptr},
+    {2,
+     WireType::kDelimited,
+     sizeof(char),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/true,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(InnerStruct, name),
+     sizeof(InnerStruct::name),
+     nullptr},
+    {3,
+     WireType::kVarint,
+     sizeof(int32_t),
+     internal::VarintType::kZigZag,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/true,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(InnerStruct, deltas),
+     sizeof(InnerStruct::deltas),
+     nullptr},
+};
+constexpr span<const internal::MessageField> kInnerStructFields(
+    kInnerStructFieldsArray);
+
+constexpr internal::MessageField kOuterStructFieldsArray[] = {
+    {1,
+     WireType::kVarint,
+     sizeof(int32_t),
+     internal::VarintType::kNormal,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(OuterStruct, value),
+     sizeof(OuterStruct::value),
+     nullptr},
+    {2,
+     WireType::kDelimited,
+     0,
+     internal::VarintType::kUnsigned,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(OuterStruct, inner),
+     sizeof(OuterStruct::inner),
+     &kInnerStructFields},
+    {3,
+     WireType::kDelimited,
+     0,
+     internal::VarintType::kUnsigned,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(OuterStruct, empty),
+     sizeof(OuterStruct::empty),
+     &kInnerStructFields},
+};
+constexpr span<const internal::MessageField> kOuterStructFields(
+    kOuterStructFieldsArray);
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
+// Exposes the struct Write() used by generated encoders.
+class StructEncoder : public StreamEncoder {
+ public:
+  using StreamEncoder::StreamEncoder;
+
+  Status Write(const OuterStruct& message) {
+    return StreamEncoder::Write(as_bytes(span(&message, 1)),
+                                kOuterStructFields);
+  }
+};
+
+OuterStruct TestOuterStruct() {
+  OuterStruct message{};
+  message.value = -2;
+  message.inner.id = 300;
+  message.inner.name = "nested";
+  message.inner.deltas.push_back(-1);
+  message.inner.deltas.push_back(64);
+  return message;
+}
+
+TEST(StreamEncoder, WriteStruct_NestedMessageWithoutScratchBuffer) {
+  const OuterStruct message = TestOuterStruct();
+
+  // Encode the same message field by field, staging the nested message.
+  std::byte expected_buffer[64];
+  MemoryEncoder expected(expected_buffer);
+  ASSERT_EQ(expected.WriteInt32(1, message.value), OkStatus());
+  {
+    StreamEncoder inner = expected.GetNestedEncoder(2);
+    ASSERT_EQ(inner.WriteUint32(1, message.inner.id), OkStatus());
+    ASSERT_EQ(inner.WriteString(2, message.inner.name), OkStatus());
+    ASSERT_EQ(inner.WriteRepeatedSint32(3, message.inner.deltas), OkStatus());
+  }
+  ASSERT_EQ(expected.status(), OkStatus());
+
+  // Nested message structs without callbacks need no scratch buffer.
+  std::byte dest_buffer[64];
+  MemoryWriter writer(dest_buffer);
+  StructEncoder encoder(writer, ByteSpan());
+  ASSERT_EQ(encoder.Write(message), OkStatus());
+
+  ASSERT_EQ(writer.bytes_written(), expected.size());
+  EXPECT_EQ(std::memcmp(dest_buffer, expected.data(), expected.size()), 0);
+}
+
+TEST(StreamEncoder, WriteStruct_NestedMessageExceedsWriteLimit) {
+  const OuterStruct message = TestOuterStruct();
+
+  std::byte dest_buffer[12];
+  MemoryWriter writer(dest_buffer);
+  StructEncoder encoder(writer, ByteSpan());
+  EXPECT_EQ(encoder.Write(message), Status::ResourceExhausted());
+}
+
+TEST(StreamEncoder, WriteStruct_ScalarFieldsStopAtWriteLimit) {
+  const OuterStruct message = TestOuterStruct();
+
+  // The outer value is written, but not the nested message after it.
+  std::byte expected_buffer[16];
+  MemoryEncoder expected(expected_buffer);
+  ASSERT_EQ(expected.WriteInt32(1, message.value), OkStatus());
+
+  std::byte dest_buffer[16];
+  MemoryWriter writer(ByteSpan(dest_buffer, expected.size() + 1));
+  StructEncoder encoder(writer, ByteSpan());
+  EXPECT_EQ(encoder.Write(message), Status::ResourceExhausted());
+  ASSERT_EQ(writer.bytes_written(), expected.size());
+  EXPECT_EQ(std::memcmp(dest_buffer, expected.data(), expected.size()), 0);
+
+  // A scalar field that does not fit is not written.
+  MemoryWriter short_writer(ByteSpan(dest_buffer, expected.size() - 1));
+  StructEncoder short_encoder(short_writer, ByteSpan());
+  EXPECT_EQ(short_encoder.Write(message), Status::ResourceExhausted());
+  EXPECT_EQ(short_writer.bytes_written(), 0u);
+}
+
+TEST(StreamEncoder, WriteStruct_DefaultScalarFieldsNotWritten) {
+  OuterStruct message{};
+  message.inner.id = 1;
+
+  std::byte dest_buffer[16];
+  MemoryWriter writer(dest_buffer);
+  StructEncoder encoder(writer, ByteSpan());
+  ASSERT_EQ(encoder.Write(message), OkStatus());
+
+  // Only the nested message and its id are written.
+  constexpr std::byte kExpected[] = {
+      std::byte{0x12}, std::byte{0x02}, std::byte{0x08}, std::byte{0x01}};
+  ASSERT_EQ(writer.bytes_written(), sizeof(kExpected));
+  EXPECT_EQ(std::memcmp(dest_buffer, kExpected, sizeof(kExpected)), 0);
+}
+
+// Hand-written equivalents of the struct and field table generated for the
+// following message with the use_allocator option on each field.
+//
+//   message AllocatedStruct {
+//     repeated uint32 values = 1;
+//     string name = 2;
+//     bytes data = 3;
+//   }
+struct AllocatedStruct {
+  span<const uint32_t> values;
+  std::string_view name;
+  span<const std::byte> data;
+};
+
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC(ignored, "-Winvalid-offsetof");
+
+constexpr internal::MessageField kAllocatedStructFieldsArray[] = {
+    {1,
+     WireType::kVarint,
+     sizeof(uint32_t),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/true,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(AllocatedStruct, values),
+     sizeof(AllocatedStruct::values),
+     nullptr,
+     /*use_allocator=*/true},
+    {2,
+     WireType::kDelimited,
+     sizeof(char),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/true,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(AllocatedStruct, name),
+     sizeof(AllocatedStruct::name),
+     nullptr,
+     /*use_allocator=*/true},
+    {3,
+     WireType::kDelimited,
+     sizeof(std::byte),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(AllocatedStruct, data),
+     sizeof(AllocatedStruct::data),
+     nullptr,
+     /*use_allocator=*/true},
+};
+constexpr span<const internal::MessageField> kAllocatedStructFields(
+    kAllocatedStructFieldsArray);
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
+class AllocatedStructEncoder : public StreamEncoder {
+ public:
+  using StreamEncoder::StreamEncoder;
+
+  Status Write(const AllocatedStruct& message) {
+    return StreamEncoder::Write(as_bytes(span(&message, 1)),
+                                kAllocatedStructFields);
+  }
+};
+
+TEST(StreamEncoder, WriteStruct_AllocatedFields) {
+  constexpr uint32_t kValues[] = {1, 150, 3};
+  constexpr std::byte kData[] = {std::byte{0xde}, std::byte{0xad}};
+  AllocatedStruct message{};
+  message.values = kValues;
+  message.name = "abc";
+  message.data = kData;
+
+  std::byte expected_buffer[32];
+  MemoryEncoder expected(expected_buffer);
+  ASSERT_EQ(expected.WritePackedUint32(1, kValues), OkStatus());
+  ASSERT_EQ(expected.WriteString(2, message.name), OkStatus());
+  ASSERT_EQ(expected.WriteBytes(3, kData), OkStatus());
+
+  std::byte dest_buffer[32];
+  MemoryWriter writer(dest_buffer);
+  AllocatedStructEncoder encoder(writer, ByteSpan());
+  ASSERT_EQ(encoder.Write(message), OkStatus());
+
+  ASSERT_EQ(writer.bytes_written(), expected.size());
+  EXPECT_EQ(std::memcmp(dest_buffer, expected.data(), expected.size()), 0);
+
+  // Empty allocated fields are not written.
+  MemoryWriter empty_writer(dest_buffer);
+  AllocatedStructEncoder empty_encoder(empty_writer, ByteSpan());
+  ASSERT_EQ(empty_encoder.Write(AllocatedStruct{}), OkStatus());
+  EXPECT_EQ(empty_writer.bytes_written(), 0u);
+}
+
 }  // namespace
 }  // namespace pw::protobuf
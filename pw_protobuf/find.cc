@@ -53,4 +53,71 @@ Status AdvanceToField(StreamDecoder& decoder, uint32_t field_number) {
   return status.IsOutOfRange() ? Status::NotFound() : status;
 }
 
+Result<size_t> FieldIndexBase::Lookup(uint32_t field_number) {
+  if (!ValidFieldNumber(field_number)) {
+    return Status::InvalidArgument();
+  }
+
+  if (field_number >= offsets_.size()) {
+    // Unindexed field; fall back to a linear scan.
+    size_t offset = 0;
+    while (true) {
+      Result<Field> field = ReadField(offset);
+      if (!field.ok()) {
+        return field.status().IsOutOfRange() ? Status::NotFound()
+                                             : field.status();
+      }
+      if (field->number == field_number) {
+        return offset;
+      }
+      offset += field->size;
+    }
+  }
+
+  if (offsets_[field_number] != 0u) {
+    return offsets_[field_number] - 1;
+  }
+
+  // Index fields until the first occurrence of this one is found. It can't
+  // have been passed already, or it would have been recorded.
+  while (scan_status_.ok()) {
+    const size_t offset = scan_offset_;
+    Result<Field> field = ReadField(offset);
+    if (!field.ok()) {
+      scan_status_ = field.status();
+      break;
+    }
+    scan_offset_ += field->size;
+
+    if (field->number < offsets_.size() && offsets_[field->number] == 0u) {
+      offsets_[field->number] = offset + 1;
+    }
+    if (field->number == field_number) {
+      return offset;
+    }
+  }
+
+  return scan_status_.IsOutOfRange() ? Status::NotFound() : scan_status_;
+}
+
+Result<FieldIndexBase::Field> BasicFieldIndex::ReadField(size_t offset) {
+  if (offset >= message_.size()) {
+    return Status::OutOfRange();
+  }
+
+  Decoder decoder(message_.subspan(offset));
+  PW_TRY(decoder.Next());
+  return Field{decoder.FieldNumber(), decoder.GetFieldSize().total()};
+}
+
+Result<FieldIndexBase::Field> BasicStreamFieldIndex::ReadField(size_t offset) {
+  PW_TRY(reader_.Seek(static_cast<ptrdiff_t>(start_ + offset)));
+
+  StreamDecoder decoder(reader_);
+  PW_TRY(decoder.Next());
+  PW_TRY_ASSIGN(const uint32_t field_number, decoder.FieldNumber());
+  PW_TRY(decoder.SkipField());
+  return Field{field_number, decoder.position_};
+}
+
 }  // namespace pw::protobuf::internal
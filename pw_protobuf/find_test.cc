@@ -14,6 +14,8 @@
 
 #include "pw_protobuf/find.h"
 
+#include <array>
+
 #include "pw_bytes/array.h"
 #include "pw_stream/memory_stream.h"
 #include "pw_string/string.h"
@@ -184,5 +186,126 @@ TEST(FindRaw, PresentField) {
   EXPECT_EQ(field7.size(), 2u);
 }
 
+TEST(FieldIndex, PresentFieldsInAnyOrder) {
+  FieldIndex<8> index(kEncodedProto);
+
+  EXPECT_EQ(index.FindFixed32(5).value(), 0xdeadbeef);
+  EXPECT_EQ(index.FindInt32(1).value(), 42);
+  EXPECT_EQ(index.FindDouble(Fields::kField4).value(), 3.14159);
+  EXPECT_EQ(index.FindSint32(2).value(), -13);
+  EXPECT_EQ(index.FindBool(3).value(), false);
+
+  Result<std::string_view> result = index.FindString(Fields::kField6);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(*result, "Hello world");
+
+  Result<ConstByteSpan> submessage = index.FindSubmessage(7);
+  ASSERT_EQ(submessage.status(), OkStatus());
+  EXPECT_EQ(FindUint32(*submessage, 1).value(), 3u);
+
+  // Fields can be read again.
+  EXPECT_EQ(index.FindInt32(1).value(), 42);
+}
+
+TEST(FieldIndex, MissingField) {
+  FieldIndex<8> index(kEncodedProto);
+  EXPECT_EQ(index.FindUint32(8).status(), Status::NotFound());
+  EXPECT_EQ(index.FindUint32(66).status(), Status::NotFound());
+  EXPECT_EQ(index.FindUint32(123456789).status(), Status::NotFound());
+
+  // Fields before the end are still found once the scan is complete.
+  EXPECT_EQ(index.FindSint32(2).value(), -13);
+}
+
+TEST(FieldIndex, FieldsPastTheIndex) {
+  FieldIndex<2> index(kEncodedProto);
+  EXPECT_EQ(index.FindBool(3).value(), false);
+  EXPECT_EQ(index.FindFixed32(5).value(), 0xdeadbeef);
+  EXPECT_EQ(index.FindInt32(1).value(), 42);
+  EXPECT_EQ(index.FindUint32(8).status(), Status::NotFound());
+}
+
+TEST(FieldIndex, InvalidFieldNumber) {
+  FieldIndex<8> index(kEncodedProto);
+  EXPECT_EQ(index.FindUint32(0).status(), Status::InvalidArgument());
+  EXPECT_EQ(index.FindUint32(uint32_t(-1)).status(),
+            Status::InvalidArgument());
+}
+
+TEST(FieldIndex, WrongWireType) {
+  FieldIndex<8> index(kEncodedProto);
+
+  // Field 5 is a fixed32, but we request a uint32 (varint).
+  EXPECT_EQ(index.FindUint32(5).status(), Status::FailedPrecondition());
+}
+
+TEST(FieldIndex, FirstOccurrenceOfRepeatedField) {
+  constexpr auto kRepeated = bytes::Array<0x08, 0x01, 0x10, 0x02, 0x08, 0x03>();
+  FieldIndex<4> index(kRepeated);
+  EXPECT_EQ(index.FindUint32(2).value(), 2u);
+  EXPECT_EQ(index.FindUint32(1).value(), 1u);
+}
+
+TEST(FieldIndex, InvalidDataAfterField) {
+  constexpr auto kInvalid = bytes::Array<0x08, 0x01, 0x12, 0x05, 0x00>();
+  FieldIndex<4> index(kInvalid);
+  EXPECT_EQ(index.FindUint32(1).value(), 1u);
+  EXPECT_EQ(index.FindBytes(2).status(), Status::DataLoss());
+  EXPECT_EQ(index.FindUint32(3).status(), Status::DataLoss());
+  EXPECT_EQ(index.FindUint32(1).value(), 1u);
+}
+
+TEST(StreamFieldIndex, PresentFieldsInAnyOrder) {
+  stream::MemoryReader reader(kEncodedProto);
+  StreamFieldIndex<8> index(reader);
+
+  EXPECT_EQ(index.FindFixed32(5).value(), 0xdeadbeef);
+  EXPECT_EQ(index.FindInt32(1).value(), 42);
+  EXPECT_EQ(index.FindDouble(Fields::kField4).value(), 3.14159);
+  EXPECT_EQ(index.FindSint32(2).value(), -13);
+  EXPECT_EQ(index.FindBool(3).value(), false);
+
+  char str[32];
+  StatusWithSize sws = index.FindString(Fields::kField6, str);
+  ASSERT_EQ(sws.status(), OkStatus());
+  ASSERT_EQ(sws.size(), 11u);
+  str[sws.size()] = '\0';
+  EXPECT_STREQ(str, "Hello world");
+
+  std::array<std::byte, 8> submessage;
+  sws = index.FindBytes(7, submessage);
+  ASSERT_EQ(sws.status(), OkStatus());
+  EXPECT_EQ(FindUint32(span(submessage).first(sws.size()), 1).value(), 3u);
+
+  EXPECT_EQ(index.FindInt32(1).value(), 42);
+}
+
+TEST(StreamFieldIndex, MissingField) {
+  stream::MemoryReader reader(kEncodedProto);
+  StreamFieldIndex<8> index(reader);
+  EXPECT_EQ(index.FindUint32(8).status(), Status::NotFound());
+  EXPECT_EQ(index.FindUint32(66).status(), Status::NotFound());
+  EXPECT_EQ(index.FindSint32(2).value(), -13);
+}
+
+TEST(StreamFieldIndex, StartsAtCurrentPosition) {
+  constexpr auto kPrefixed =
+      bytes::Concat(bytes::Array<0xde, 0xad>(), kEncodedProto);
+  stream::MemoryReader reader(kPrefixed);
+  ASSERT_EQ(reader.Seek(2), OkStatus());
+
+  StreamFieldIndex<8> index(reader);
+  EXPECT_EQ(index.FindFixed32(5).value(), 0xdeadbeef);
+  EXPECT_EQ(index.FindInt32(1).value(), 42);
+}
+
+TEST(StreamFieldIndex, WrongWireType) {
+  stream::MemoryReader reader(kEncodedProto);
+  StreamFieldIndex<8> index(reader);
+
+  // Field 5 is a fixed32, but we request a uint32 (varint).
+  EXPECT_EQ(index.FindUint32(5).status(), Status::FailedPrecondition());
+}
+
 }  // namespace
 }  // namespace pw::protobuf
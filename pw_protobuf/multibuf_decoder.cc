@@ -0,0 +1,294 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/multibuf_decoder.h"
+
+#include <array>
+#include <cstring>
+#include <limits>
+
+#include "pw_assert/check.h"
+#include "pw_varint/varint.h"
+
+namespace pw::protobuf {
+
+std::optional<ConstByteSpan> MultiBufBytes::ContiguousSpan() const {
+  ConstByteSpan bytes = FirstChunkBytes();
+  if (bytes.size() != size_) {
+    return std::nullopt;
+  }
+  return bytes;
+}
+
+StatusWithSize MultiBufBytes::CopyTo(ByteSpan dest) const {
+  const size_t to_copy = std::min(dest.size(), size_);
+  size_t copied = 0;
+  size_t offset = offset_;
+  for (auto chunk = chunk_; copied < to_copy; ++chunk) {
+    const size_t chunk_bytes =
+        std::min(chunk->size() - offset, to_copy - copied);
+    std::memcpy(dest.data() + copied, chunk->data() + offset, chunk_bytes);
+    copied += chunk_bytes;
+    offset = 0;
+  }
+
+  if (copied < size_) {
+    return StatusWithSize::ResourceExhausted(copied);
+  }
+  return StatusWithSize(copied);
+}
+
+size_t MultiBufBytes::PeekVarint(uint64_t* value) const {
+  // Most varints are entirely within the current chunk.
+  const ConstByteSpan first_chunk_bytes = FirstChunkBytes();
+  if (first_chunk_bytes.size() >= varint::kMaxVarint64SizeBytes ||
+      first_chunk_bytes.size() == size_) {
+    return varint::Decode(first_chunk_bytes, value);
+  }
+
+  // The varint may straddle a chunk boundary, so reassemble it.
+  std::array<std::byte, varint::kMaxVarint64SizeBytes> buffer;
+  const size_t copied = CopyTo(buffer).size();
+  return varint::Decode(span(buffer).first(copied), value);
+}
+
+void MultiBufBytes::DiscardPrefix(size_t size) {
+  PW_DASSERT(size <= size_);
+  offset_ += size;
+  size_ -= size;
+  SkipConsumedChunks();
+}
+
+void MultiBufBytes::SkipConsumedChunks() {
+  while (size_ != 0u && offset_ >= chunk_->size()) {
+    offset_ -= chunk_->size();
+    ++chunk_;
+  }
+}
+
+Status MultiBufDecoder::Next() {
+  if (!previous_field_consumed_) {
+    if (Status status = SkipField(); !status.ok()) {
+      return status;
+    }
+  }
+  if (proto_.empty()) {
+    return Status::OutOfRange();
+  }
+  previous_field_consumed_ = false;
+  return GetFieldSize().ok() ? OkStatus() : Status::DataLoss();
+}
+
+Status MultiBufDecoder::SkipField() {
+  if (proto_.empty()) {
+    return Status::OutOfRange();
+  }
+
+  size_t bytes_to_skip = GetFieldSize().total();
+  if (bytes_to_skip == 0) {
+    return Status::DataLoss();
+  }
+
+  proto_.DiscardPrefix(bytes_to_skip);
+  return proto_.empty() ? Status::OutOfRange() : OkStatus();
+}
+
+uint32_t MultiBufDecoder::FieldNumber() const {
+  uint64_t key;
+  if (proto_.PeekVarint(&key) == 0 || !FieldKey::IsValidKey(key)) {
+    return 0;
+  }
+  PW_DCHECK(key <= std::numeric_limits<uint32_t>::max());
+  return FieldKey(static_cast<uint32_t>(key)).field_number();
+}
+
+Status MultiBufDecoder::ReadUint32(uint32_t* out) {
+  uint64_t value = 0;
+  Status status = ReadUint64(&value);
+  if (!status.ok()) {
+    return status;
+  }
+  if (value > std::numeric_limits<uint32_t>::max()) {
+    return Status::OutOfRange();
+  }
+  *out = static_cast<uint32_t>(value);
+  return OkStatus();
+}
+
+Status MultiBufDecoder::ReadSint32(int32_t* out) {
+  int64_t value = 0;
+  Status status = ReadSint64(&value);
+  if (!status.ok()) {
+    return status;
+  }
+  if (value > std::numeric_limits<int32_t>::max() ||
+      value < std::numeric_limits<int32_t>::min()) {
+    return Status::OutOfRange();
+  }
+  *out = static_cast<int32_t>(value);
+  return OkStatus();
+}
+
+Status MultiBufDecoder::ReadSint64(int64_t* out) {
+  uint64_t value = 0;
+  Status status = ReadUint64(&value);
+  if (!status.ok()) {
+    return status;
+  }
+  *out = varint::ZigZagDecode(value);
+  return OkStatus();
+}
+
+Status MultiBufDecoder::ReadBool(bool* out) {
+  uint64_t value = 0;
+  Status status = ReadUint64(&value);
+  if (!status.ok()) {
+    return status;
+  }
+  *out = value != 0u;
+  return OkStatus();
+}
+
+MultiBufDecoder::FieldSize MultiBufDecoder::GetFieldSize() const {
+  uint64_t key;
+  size_t key_size = proto_.PeekVarint(&key);
+  if (key_size == 0 || !FieldKey::IsValidKey(key)) {
+    return FieldSize::Invalid();
+  }
+
+  MultiBufBytes remainder = proto_;
+  remainder.DiscardPrefix(key_size);
+  uint64_t value = 0;
+  size_t expected_size = 0;
+
+  PW_DCHECK(key <= std::numeric_limits<uint32_t>::max());
+  switch (FieldKey(static_cast<uint32_t>(key)).wire_type()) {
+    case WireType::kVarint:
+      expected_size = remainder.PeekVarint(&value);
+      if (expected_size == 0) {
+        return FieldSize::Invalid();
+      }
+      break;
+
+    case WireType::kDelimited: {
+      // Varint at cursor indicates size of the field.
+      const size_t delimited_size = remainder.PeekVarint(&value);
+      if (delimited_size == 0) {
+        return FieldSize::Invalid();
+      }
+      key_size += delimited_size;
+      remainder.DiscardPrefix(delimited_size);
+      if (remainder.size() < value) {
+        return FieldSize::Invalid();
+      }
+      expected_size = static_cast<size_t>(value);
+      break;
+    }
+    case WireType::kFixed32:
+      expected_size = sizeof(uint32_t);
+      break;
+
+    case WireType::kFixed64:
+      expected_size = sizeof(uint64_t);
+      break;
+  }
+
+  if (remainder.size() < expected_size) {
+    return FieldSize::Invalid();
+  }
+
+  return FieldSize{key_size, expected_size};
+}
+
+Status MultiBufDecoder::ConsumeKey(WireType expected_type) {
+  uint64_t key;
+  size_t bytes_read = proto_.PeekVarint(&key);
+  if (bytes_read == 0) {
+    return Status::FailedPrecondition();
+  }
+
+  if (!FieldKey::IsValidKey(key)) {
+    return Status::DataLoss();
+  }
+
+  PW_DCHECK(key <= std::numeric_limits<uint32_t>::max());
+  if (FieldKey(static_cast<uint32_t>(key)).wire_type() != expected_type) {
+    return Status::FailedPrecondition();
+  }
+
+  // Advance past the key.
+  proto_.DiscardPrefix(bytes_read);
+  return OkStatus();
+}
+
+Status MultiBufDecoder::ReadVarint(uint64_t* out) {
+  if (Status status = ConsumeKey(WireType::kVarint); !status.ok()) {
+    return status;
+  }
+
+  size_t bytes_read = proto_.PeekVarint(out);
+  if (bytes_read == 0) {
+    return Status::DataLoss();
+  }
+
+  // Advance to the next field.
+  proto_.DiscardPrefix(bytes_read);
+  previous_field_consumed_ = true;
+  return OkStatus();
+}
+
+Status MultiBufDecoder::ReadFixed(std::byte* out, size_t size) {
+  WireType expected_wire_type =
+      size == sizeof(uint32_t) ? WireType::kFixed32 : WireType::kFixed64;
+  Status status = ConsumeKey(expected_wire_type);
+  if (!status.ok()) {
+    return status;
+  }
+
+  if (proto_.size() < size) {
+    return Status::DataLoss();
+  }
+
+  proto_.first(size).CopyTo(span(out, size)).IgnoreError();
+  proto_.DiscardPrefix(size);
+  previous_field_consumed_ = true;
+
+  return OkStatus();
+}
+
+Status MultiBufDecoder::ReadDelimited(MultiBufBytes* out) {
+  Status status = ConsumeKey(WireType::kDelimited);
+  if (!status.ok()) {
+    return status;
+  }
+
+  uint64_t length;
+  size_t bytes_read = proto_.PeekVarint(&length);
+  if (bytes_read == 0) {
+    return Status::DataLoss();
+  }
+
+  proto_.DiscardPrefix(bytes_read);
+  if (proto_.size() < length) {
+    return Status::DataLoss();
+  }
+
+  *out = proto_.first(static_cast<size_t>(length));
+  proto_.DiscardPrefix(static_cast<size_t>(length));
+  previous_field_consumed_ = true;
+
+  return OkStatus();
+}
+
+}  // namespace pw::protobuf
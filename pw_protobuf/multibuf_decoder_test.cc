@@ -0,0 +1,211 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/multibuf_decoder.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+
+#include "pw_bytes/array.h"
+#include "pw_multibuf/simple_allocator_for_test.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::protobuf {
+namespace {
+
+using multibuf::MultiBuf;
+
+// clang-format off
+constexpr auto kEncodedProto = bytes::Array<
+  // type=int32, k=1, v=42
+  0x08, 0x2a,
+  // type=sint32, k=2, v=-13
+  0x10, 0x19,
+  // type=bool, k=3, v=false
+  0x18, 0x00,
+  // type=double, k=4, v=3.14159
+  0x21, 0x6e, 0x86, 0x1b, 0xf0, 0xf9, 0x21, 0x09, 0x40,
+  // type=fixed32, k=5, v=0xdeadbeef
+  0x2d, 0xef, 0xbe, 0xad, 0xde,
+  // type=string, k=6, v="Hello world"
+  0x32, 0x0b, 'H', 'e', 'l', 'l', 'o', ' ', 'w', 'o', 'r', 'l', 'd',
+  // type=uint64, k=7, v=0xffffffffffffffff
+  0x38, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01,
+  // type=message, k=8, v={type=uint32, k=1, v=300}
+  0x42, 0x03, 0x08, 0xac, 0x02,
+  // type=int32, k=9, v=-1 (unknown field)
+  0x48, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01
+>();
+// clang-format on
+
+class MultiBufDecoderTest : public ::testing::Test {
+ protected:
+  // Returns a MultiBuf containing `data`, split into chunks of at most
+  // `chunk_size` bytes.
+  MultiBuf Fragment(ConstByteSpan data, size_t chunk_size) {
+    MultiBuf buffer;
+    for (size_t offset = 0; offset < data.size(); offset += chunk_size) {
+      const size_t size = std::min(chunk_size, data.size() - offset);
+      std::optional<MultiBuf> chunk = allocator_.AllocateContiguous(size);
+      if (!chunk.has_value()) {
+        ADD_FAILURE();
+        break;
+      }
+      EXPECT_EQ(OkStatus(),
+                chunk->CopyFrom(data.subspan(offset, size)).status());
+      buffer.PushSuffix(std::move(*chunk));
+    }
+    return buffer;
+  }
+
+  multibuf::test::SimpleAllocatorForTest<1024, 16384> allocator_;
+};
+
+TEST_F(MultiBufDecoderTest, DecodesAcrossAnyChunkBoundaries) {
+  for (size_t chunk_size = 1; chunk_size <= kEncodedProto.size();
+       ++chunk_size) {
+    MultiBuf proto = Fragment(kEncodedProto, chunk_size);
+    MultiBufDecoder decoder(proto);
+
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    ASSERT_EQ(decoder.FieldNumber(), 1u);
+    int32_t v1 = 0;
+    EXPECT_EQ(decoder.ReadInt32(&v1), OkStatus());
+    EXPECT_EQ(v1, 42);
+
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    ASSERT_EQ(decoder.FieldNumber(), 2u);
+    int32_t v2 = 0;
+    EXPECT_EQ(decoder.ReadSint32(&v2), OkStatus());
+    EXPECT_EQ(v2, -13);
+
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    ASSERT_EQ(decoder.FieldNumber(), 3u);
+    bool v3 = true;
+    EXPECT_EQ(decoder.ReadBool(&v3), OkStatus());
+    EXPECT_FALSE(v3);
+
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    ASSERT_EQ(decoder.FieldNumber(), 4u);
+    double v4 = 0;
+    EXPECT_EQ(decoder.ReadDouble(&v4), OkStatus());
+    EXPECT_EQ(v4, 3.14159);
+
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    ASSERT_EQ(decoder.FieldNumber(), 5u);
+    uint32_t v5 = 0;
+    EXPECT_EQ(decoder.ReadFixed32(&v5), OkStatus());
+    EXPECT_EQ(v5, 0xdeadbeef);
+
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    ASSERT_EQ(decoder.FieldNumber(), 6u);
+    MultiBufBytes v6;
+    EXPECT_EQ(decoder.ReadBytes(&v6), OkStatus());
+    std::array<char, 16> str{};
+    EXPECT_EQ(v6.CopyTo(as_writable_bytes(span(str))).size(), 11u);
+    EXPECT_STREQ(str.data(), "Hello world");
+
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    ASSERT_EQ(decoder.FieldNumber(), 7u);
+    uint64_t v7 = 0;
+    EXPECT_EQ(decoder.ReadUint64(&v7), OkStatus());
+    EXPECT_EQ(v7, 0xffffffffffffffffu);
+
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    ASSERT_EQ(decoder.FieldNumber(), 8u);
+    MultiBufBytes v8;
+    EXPECT_EQ(decoder.ReadBytes(&v8), OkStatus());
+    MultiBufDecoder nested(v8);
+    EXPECT_EQ(nested.Next(), OkStatus());
+    ASSERT_EQ(nested.FieldNumber(), 1u);
+    uint32_t nested_v1 = 0;
+    EXPECT_EQ(nested.ReadUint32(&nested_v1), OkStatus());
+    EXPECT_EQ(nested_v1, 300u);
+    EXPECT_EQ(nested.Next(), Status::OutOfRange());
+
+    // Field 9 is skipped.
+    EXPECT_EQ(decoder.Next(), OkStatus());
+    ASSERT_EQ(decoder.FieldNumber(), 9u);
+    EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+  }
+}
+
+TEST_F(MultiBufDecoderTest, BytesInOneChunkAreContiguous) {
+  MultiBuf proto = Fragment(kEncodedProto, kEncodedProto.size());
+  MultiBufDecoder decoder(proto);
+
+  while (decoder.Next().ok() && decoder.FieldNumber() != 6u) {
+  }
+  MultiBufBytes bytes;
+  ASSERT_EQ(decoder.ReadBytes(&bytes), OkStatus());
+
+  std::optional<ConstByteSpan> contiguous = bytes.ContiguousSpan();
+  ASSERT_TRUE(contiguous.has_value());
+  EXPECT_EQ(contiguous->size(), 11u);
+  EXPECT_EQ(std::memcmp(contiguous->data(), "Hello world", 11), 0);
+}
+
+TEST_F(MultiBufDecoderTest, BytesAcrossChunksAreNotContiguous) {
+  MultiBuf proto = Fragment(kEncodedProto, 4);
+  MultiBufDecoder decoder(proto);
+
+  while (decoder.Next().ok() && decoder.FieldNumber() != 6u) {
+  }
+  MultiBufBytes bytes;
+  ASSERT_EQ(decoder.ReadBytes(&bytes), OkStatus());
+  EXPECT_EQ(bytes.size(), 11u);
+  EXPECT_FALSE(bytes.ContiguousSpan().has_value());
+
+  std::array<std::byte, 5> partial{};
+  StatusWithSize result = bytes.CopyTo(partial);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(result.size(), partial.size());
+  EXPECT_EQ(std::memcmp(partial.data(), "Hello", partial.size()), 0);
+}
+
+TEST_F(MultiBufDecoderTest, EmptyMultiBuf) {
+  MultiBuf proto;
+  MultiBufDecoder decoder(proto);
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST_F(MultiBufDecoderTest, TruncatedVarintAcrossChunks) {
+  constexpr auto kTruncated = bytes::Array<0x08, 0xff, 0xff, 0xff>();
+  MultiBuf proto = Fragment(kTruncated, 2);
+  MultiBufDecoder decoder(proto);
+  EXPECT_EQ(decoder.Next(), Status::DataLoss());
+}
+
+TEST_F(MultiBufDecoderTest, DelimitedFieldLongerThanMessage) {
+  constexpr auto kTruncated = bytes::Array<0x32, 0x0b, 'H', 'e', 'l', 'l'>();
+  MultiBuf proto = Fragment(kTruncated, 3);
+  MultiBufDecoder decoder(proto);
+  EXPECT_EQ(decoder.Next(), Status::DataLoss());
+}
+
+TEST_F(MultiBufDecoderTest, WrongWireType) {
+  MultiBuf proto = Fragment(kEncodedProto, 3);
+  MultiBufDecoder decoder(proto);
+
+  EXPECT_EQ(decoder.Next(), OkStatus());
+  uint32_t value;
+  EXPECT_EQ(decoder.ReadFixed32(&value), Status::FailedPrecondition());
+  MultiBufBytes bytes;
+  EXPECT_EQ(decoder.ReadBytes(&bytes), Status::FailedPrecondition());
+}
+
+}  // namespace
+}  // namespace pw::protobuf
@@ -37,8 +37,23 @@
 static_assert(PW_PROTOBUF_CFG_MAX_VARINT_SIZE > 0 &&
               PW_PROTOBUF_CFG_MAX_VARINT_SIZE <= 5);
 
+// Whether StreamEncoder::Write() computes the encoded size of each nested
+// message struct before writing it, so that the message is written directly to
+// the stream rather than staged in the scratch buffer. Nested messages that
+// contain callback fields cannot be sized in advance, and are always staged.
+//
+// Computing sizes traverses each nested message once for every level of
+// nesting above it, trading some encoding time for scratch buffer space and
+// copies.
+#ifndef PW_PROTOBUF_CFG_PRECOMPUTE_NESTED_MESSAGE_SIZES
+#define PW_PROTOBUF_CFG_PRECOMPUTE_NESTED_MESSAGE_SIZES 1
+#endif  // PW_PROTOBUF_CFG_PRECOMPUTE_NESTED_MESSAGE_SIZES
+
 namespace pw::protobuf::config {
 
 inline constexpr size_t kMaxVarintSize = PW_PROTOBUF_CFG_MAX_VARINT_SIZE;
 
+inline constexpr bool kPrecomputeNestedMessageSizes =
+    PW_PROTOBUF_CFG_PRECOMPUTE_NESTED_MESSAGE_SIZES != 0;
+
 }  // namespace pw::protobuf::config
@@ -43,6 +43,9 @@
 //   }
 //
 namespace pw::protobuf {
+namespace internal {
+class BasicFieldIndex;
+}  // namespace internal
 
 // TODO(frolv): Rename this to MemoryDecoder to match the encoder naming.
 class Decoder {
@@ -150,6 +153,9 @@ class Decoder {
   // Allow only the FindRaw function to access the raw bytes of the field.
   friend Result<ConstByteSpan> FindRaw(ConstByteSpan, uint32_t);
 
+  // Allow the FieldIndex to measure fields while indexing them.
+  friend class internal::BasicFieldIndex;
+
   // Returns the raw field value. The decoder MUST be at a valid field.
   ConstByteSpan RawFieldBytes() { return GetFieldSize().ValueBytes(proto_); }
 
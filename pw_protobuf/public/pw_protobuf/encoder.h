@@ -773,6 +773,15 @@ class StreamEncoder {
     return WriteLengthDelimitedField(field_number, as_bytes(span(container)));
   }
 
+  // Writes a nested message struct of a known encoded size directly to the
+  // stream, without staging it in the scratch buffer.
+  //
+  // Precondition: Encoder has no active child encoder.
+  Status WriteNestedMessage(uint32_t field_number,
+                            span<const std::byte> message,
+                            span<const internal::MessageField> table,
+                            size_t size);
+
   // Checks if a write is invalid or will cause the encoder to enter an error
   // state, and preemptively sets this encoder's status to that error to block
   // the write. Only the first error encountered is tracked.
@@ -21,8 +21,8 @@
 /// functions which handle this for you.
 ///
 /// @note Each call to ``Find*()`` linearly scans through the message. If you
-/// have to read multiple fields, it is more efficient to instantiate your own
-/// decoder as described above.
+/// have to read multiple fields, it is more efficient to use a ``FieldIndex``
+/// or to instantiate your own decoder as described above.
 ///
 /// @code{.cpp}
 ///
@@ -39,11 +39,21 @@
 ///
 /// @endcode
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
 #include "pw_bytes/span.h"
 #include "pw_protobuf/decoder.h"
 #include "pw_protobuf/stream_decoder.h"
 #include "pw_result/result.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 #include "pw_status/try.h"
+#include "pw_stream/stream.h"
 #include "pw_string/string.h"
 
 namespace pw::protobuf {
@@ -1041,4 +1051,493 @@ Result<ConstByteSpan> FindRaw(ConstByteSpan message, T field) {
   return FindRaw(message, static_cast<uint32_t>(field));
 }
 
+namespace internal {
+
+// Records the offset of the first occurrence of each field in a message as the
+// message is scanned. Fields are only scanned as far as needed to find the
+// requested one, so a field that is found early doesn't cost a full pass.
+class FieldIndexBase {
+ public:
+  FieldIndexBase(const FieldIndexBase&) = delete;
+  FieldIndexBase& operator=(const FieldIndexBase&) = delete;
+
+ protected:
+  // The number and encoded size of a field.
+  struct Field {
+    uint32_t number;
+    size_t size;
+  };
+
+  // The offsets are stored plus one, so that zero marks an unseen field. The
+  // storage must be zeroed before the first lookup.
+  constexpr FieldIndexBase(span<size_t> offsets)
+      : offsets_(offsets), scan_offset_(0), scan_status_(OkStatus()) {}
+
+  ~FieldIndexBase() = default;
+
+  // Returns the offset of the first field with the given number.
+  //
+  // Fields numbered past the end of the index are not recorded; they are
+  // found by scanning from the start of the message each time.
+  Result<size_t> Lookup(uint32_t field_number);
+
+ private:
+  // Returns the field at the given offset, or OUT_OF_RANGE at the end of the
+  // message.
+  virtual Result<Field> ReadField(size_t offset) = 0;
+
+  span<size_t> offsets_;
+  size_t scan_offset_;  // Offset of the first field that hasn't been indexed.
+  Status scan_status_;  // Set once the scan reaches the end or bad data.
+};
+
+class BasicFieldIndex : public FieldIndexBase {
+ public:
+  /// Finds the `uint32` field with the given number.
+  Result<uint32_t> FindUint32(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindUint32(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<uint32_t> FindUint32(T field) {
+    return FindUint32(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `int32` field with the given number.
+  Result<int32_t> FindInt32(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindInt32(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int32_t> FindInt32(T field) {
+    return FindInt32(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `sint32` field with the given number.
+  Result<int32_t> FindSint32(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindSint32(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int32_t> FindSint32(T field) {
+    return FindSint32(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `uint64` field with the given number.
+  Result<uint64_t> FindUint64(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindUint64(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<uint64_t> FindUint64(T field) {
+    return FindUint64(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `int64` field with the given number.
+  Result<int64_t> FindInt64(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindInt64(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int64_t> FindInt64(T field) {
+    return FindInt64(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `sint64` field with the given number.
+  Result<int64_t> FindSint64(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindSint64(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int64_t> FindSint64(T field) {
+    return FindSint64(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `bool` field with the given number.
+  Result<bool> FindBool(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindBool(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<bool> FindBool(T field) {
+    return FindBool(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `fixed32` field with the given number.
+  Result<uint32_t> FindFixed32(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindFixed32(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<uint32_t> FindFixed32(T field) {
+    return FindFixed32(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `fixed64` field with the given number.
+  Result<uint64_t> FindFixed64(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindFixed64(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<uint64_t> FindFixed64(T field) {
+    return FindFixed64(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `sfixed32` field with the given number.
+  Result<int32_t> FindSfixed32(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindSfixed32(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int32_t> FindSfixed32(T field) {
+    return FindSfixed32(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `sfixed64` field with the given number.
+  Result<int64_t> FindSfixed64(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindSfixed64(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int64_t> FindSfixed64(T field) {
+    return FindSfixed64(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `float` field with the given number.
+  Result<float> FindFloat(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindFloat(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<float> FindFloat(T field) {
+    return FindFloat(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `double` field with the given number.
+  Result<double> FindDouble(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindDouble(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<double> FindDouble(T field) {
+    return FindDouble(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `string` field with the given number.
+  Result<std::string_view> FindString(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindString(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<std::string_view> FindString(T field) {
+    return FindString(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `bytes` field with the given number.
+  Result<ConstByteSpan> FindBytes(uint32_t field_number) {
+    PW_TRY_ASSIGN(ConstByteSpan field, FieldAndRemainder(field_number));
+    return protobuf::FindBytes(field, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<ConstByteSpan> FindBytes(T field) {
+    return FindBytes(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the submessage field with the given number.
+  Result<ConstByteSpan> FindSubmessage(uint32_t field_number) {
+    // On the wire, a submessage is identical to bytes.
+    return FindBytes(field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<ConstByteSpan> FindSubmessage(T field) {
+    return FindSubmessage(static_cast<uint32_t>(field));
+  }
+
+ protected:
+  constexpr BasicFieldIndex(ConstByteSpan message, span<size_t> offsets)
+      : FieldIndexBase(offsets), message_(message) {}
+
+  ~BasicFieldIndex() = default;
+
+ private:
+  // Returns the message starting at the first field with the given number.
+  Result<ConstByteSpan> FieldAndRemainder(uint32_t field_number) {
+    PW_TRY_ASSIGN(size_t offset, Lookup(field_number));
+    return message_.subspan(offset);
+  }
+
+  Result<Field> ReadField(size_t offset) final;
+
+  ConstByteSpan message_;
+};
+
+class BasicStreamFieldIndex : public FieldIndexBase {
+ public:
+  /// Finds the `uint32` field with the given number.
+  Result<uint32_t> FindUint32(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindUint32(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<uint32_t> FindUint32(T field) {
+    return FindUint32(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `int32` field with the given number.
+  Result<int32_t> FindInt32(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindInt32(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int32_t> FindInt32(T field) {
+    return FindInt32(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `sint32` field with the given number.
+  Result<int32_t> FindSint32(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindSint32(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int32_t> FindSint32(T field) {
+    return FindSint32(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `uint64` field with the given number.
+  Result<uint64_t> FindUint64(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindUint64(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<uint64_t> FindUint64(T field) {
+    return FindUint64(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `int64` field with the given number.
+  Result<int64_t> FindInt64(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindInt64(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int64_t> FindInt64(T field) {
+    return FindInt64(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `sint64` field with the given number.
+  Result<int64_t> FindSint64(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindSint64(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int64_t> FindSint64(T field) {
+    return FindSint64(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `bool` field with the given number.
+  Result<bool> FindBool(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindBool(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<bool> FindBool(T field) {
+    return FindBool(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `fixed32` field with the given number.
+  Result<uint32_t> FindFixed32(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindFixed32(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<uint32_t> FindFixed32(T field) {
+    return FindFixed32(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `fixed64` field with the given number.
+  Result<uint64_t> FindFixed64(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindFixed64(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<uint64_t> FindFixed64(T field) {
+    return FindFixed64(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `sfixed32` field with the given number.
+  Result<int32_t> FindSfixed32(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindSfixed32(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int32_t> FindSfixed32(T field) {
+    return FindSfixed32(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `sfixed64` field with the given number.
+  Result<int64_t> FindSfixed64(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindSfixed64(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<int64_t> FindSfixed64(T field) {
+    return FindSfixed64(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `float` field with the given number.
+  Result<float> FindFloat(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindFloat(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<float> FindFloat(T field) {
+    return FindFloat(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `double` field with the given number.
+  Result<double> FindDouble(uint32_t field_number) {
+    PW_TRY(SeekToField(field_number));
+    return protobuf::FindDouble(reader_, field_number);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  Result<double> FindDouble(T field) {
+    return FindDouble(static_cast<uint32_t>(field));
+  }
+
+  /// Finds the `string` field with the given number and copies it to `out`.
+  /// Returns the same status codes as the stream version of `FindString()`.
+  StatusWithSize FindString(uint32_t field_number, span<char> out) {
+    if (Status status = SeekToField(field_number); !status.ok()) {
+      return StatusWithSize(status, 0);
+    }
+    return protobuf::FindString(reader_, field_number, out);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  StatusWithSize FindString(T field, span<char> out) {
+    return FindString(static_cast<uint32_t>(field), out);
+  }
+
+  /// Finds the `bytes` field with the given number and copies it to `out`.
+  /// Returns the same status codes as the stream version of `FindBytes()`.
+  StatusWithSize FindBytes(uint32_t field_number, ByteSpan out) {
+    if (Status status = SeekToField(field_number); !status.ok()) {
+      return StatusWithSize(status, 0);
+    }
+    return protobuf::FindBytes(reader_, field_number, out);
+  }
+
+  template <typename T, typename = std::enable_if_t<std::is_enum_v<T>>>
+  StatusWithSize FindBytes(T field, ByteSpan out) {
+    return FindBytes(static_cast<uint32_t>(field), out);
+  }
+
+ protected:
+  BasicStreamFieldIndex(stream::SeekableReader& reader, span<size_t> offsets)
+      : FieldIndexBase(offsets), reader_(reader), start_(reader.Tell()) {}
+
+  ~BasicStreamFieldIndex() = default;
+
+ private:
+  // Seeks the reader to the first field with the given number.
+  Status SeekToField(uint32_t field_number) {
+    PW_TRY_ASSIGN(size_t offset, Lookup(field_number));
+    return reader_.Seek(static_cast<ptrdiff_t>(start_ + offset));
+  }
+
+  Result<Field> ReadField(size_t offset) final;
+
+  stream::SeekableReader& reader_;
+  size_t start_;  // Position of the message within the reader.
+};
+
+}  // namespace internal
+
+/// An index of the fields in a serialized protobuf message, for reading several
+/// fields out of one message.
+///
+/// Each of the ``Find*()`` functions above scans the message from its start.
+/// A ``FieldIndex`` instead records the offset of each field as it scans, so
+/// the message is scanned at most once, however many fields are read. The scan
+/// is lazy: it stops as soon as the requested field is found, and resumes from
+/// there for a field that hasn't been seen yet.
+///
+/// The index stores an offset for each field number up to
+/// ``kMaxFieldNumber``. Fields numbered above it are still found, but by
+/// scanning from the start of the message on each call.
+///
+/// The ``Find*()`` member functions return the same values and status codes
+/// as the corresponding free functions. Like them, they return the first
+/// occurrence of a repeated field.
+///
+/// @code{.cpp}
+///
+///   pw::Status PrintCustomer(pw::ConstByteSpan serialized_customer) {
+///     pw::protobuf::FieldIndex<8> index(serialized_customer);
+///     PW_TRY_ASSIGN(uint32_t age, index.FindUint32(Customer::Fields::kAge));
+///     PW_TRY_ASSIGN(std::string_view name,
+///                   index.FindString(Customer::Fields::kName));
+///
+///     PW_LOG_INFO("Customer %.*s is %u",
+///                 static_cast<int>(name.size()), name.data(), age);
+///     return pw::OkStatus();
+///   }
+///
+/// @endcode
+///
+/// The serialized message must outlive the index.
+template <uint32_t kMaxFieldNumber>
+class FieldIndex final : public internal::BasicFieldIndex {
+ public:
+  explicit constexpr FieldIndex(ConstByteSpan message)
+      : internal::BasicFieldIndex(message, offsets_) {}
+
+ private:
+  std::array<size_t, kMaxFieldNumber + 1> offsets_{};
+};
+
+/// A ``FieldIndex`` for a message read from a seekable stream, starting at
+/// the stream's current position.
+///
+/// The index seeks the stream to each field it reads. The stream's position
+/// between calls is unspecified, and it must not be read from or seeked by
+/// anything else while the index is in use.
+template <uint32_t kMaxFieldNumber>
+class StreamFieldIndex final : public internal::BasicStreamFieldIndex {
+ public:
+  explicit StreamFieldIndex(stream::SeekableReader& reader)
+      : internal::BasicStreamFieldIndex(reader, offsets_) {}
+
+ private:
+  std::array<size_t, kMaxFieldNumber + 1> offsets_{};
+};
+
 }  // namespace pw::protobuf
@@ -51,6 +51,10 @@ enum class VarintType {
 //  - Individual field size (including repeated and nested messages) must be no
 //    larger than 64 KB. (This is already the maximum size of pw::Vector).
 //
+// Fields with the use_allocator codegen option are pw::span<const T> (or
+// std::string_view for strings) struct members. The decoder allocates their
+// contents from the allocator set with StreamDecoder::set_allocator().
+//
 // A complete codegen struct is represented by a span<MessageField>,
 // holding a pointer to the MessageField members themselves, and the number of
 // fields in the struct. These spans are global data, one span per protobuf
@@ -75,7 +79,8 @@ class MessageField {
                          bool use_callback,
                          size_t field_offset,
                          size_t field_size,
-                         const span<const MessageField>* nested_message_fields)
+                         const span<const MessageField>* nested_message_fields,
+                         bool use_allocator = false)
       : field_number_(field_number),
         field_info_(static_cast<uint32_t>(wire_type) << kWireTypeShift |
                     static_cast<uint32_t>(elem_size) << kElemSizeShift |
@@ -85,6 +90,7 @@ class MessageField {
                     static_cast<uint32_t>(is_repeated) << kIsRepeatedShift |
                     static_cast<uint32_t>(is_optional) << kIsOptionalShift |
                     static_cast<uint32_t>(use_callback) << kUseCallbackShift |
+                    static_cast<uint32_t>(use_allocator) << kUseAllocatorShift |
                     static_cast<uint32_t>(field_size) << kFieldSizeShift),
         field_offset_(field_offset),
         nested_message_fields_(nested_message_fields) {}
@@ -116,6 +122,15 @@ class MessageField {
   constexpr bool use_callback() const {
     return (field_info_ >> kUseCallbackShift) & 1;
   }
+  constexpr bool use_allocator() const {
+    return (field_info_ >> kUseAllocatorShift) & 1;
+  }
+  // True for a singular varint or fixed field without a callback, whose
+  // struct member is a plain integer, enum, bool, or floating point value.
+  constexpr bool is_singular_scalar() const {
+    return (field_info_ & kNonScalarMask) == 0 &&
+           wire_type() != WireType::kDelimited;
+  }
   constexpr size_t field_offset() const { return field_offset_; }
   constexpr size_t field_size() const {
     return (field_info_ >> kFieldSizeShift) & kFieldSizeMask;
@@ -140,7 +155,8 @@ class MessageField {
   //   -
   //   elem_size      : 4
   //   is_optional    : 1
-  //   [unused space] : 2
+  //   use_allocator  : 1
+  //   [unused space] : 1
   //   -
   //   field_size     : 16
   //
@@ -159,9 +175,14 @@ class MessageField {
   static constexpr unsigned int kUseCallbackShift = 23u;
   static constexpr unsigned int kElemSizeShift = 19u;
   static constexpr unsigned int kElemSizeMask = (1u << 4) - 1;
+  static constexpr unsigned int kUseAllocatorShift = 17u;
   static constexpr unsigned int kIsOptionalShift = 16u;
   static constexpr unsigned int kFieldSizeShift = 0u;
   static constexpr unsigned int kFieldSizeMask = kMaxFieldSize;
+  static constexpr uint32_t kNonScalarMask =
+      1u << kIsFixedSizeShift | 1u << kIsRepeatedShift |
+      1u << kIsOptionalShift | 1u << kUseCallbackShift |
+      1u << kUseAllocatorShift;
 
   uint32_t field_number_;
   uint32_t field_info_;
@@ -0,0 +1,259 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_bytes/span.h"
+#include "pw_multibuf/multibuf.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+// This file defines a protobuf wire format decoder that reads a message
+// directly from the chunks of a MultiBuf, without first copying it into a
+// contiguous buffer. It has the same iterator-style API as the in-memory
+// Decoder.
+//
+// Example usage:
+//
+//   MultiBufDecoder decoder(packet);
+//   while (decoder.Next().ok()) {
+//     switch (decoder.FieldNumber()) {
+//       case 1:
+//         decoder.ReadUint32(&my_uint32);
+//         break;
+//       case 2:
+//         decoder.ReadBytes(&my_payload);
+//         break;
+//       // ... and other fields.
+//     }
+//   }
+//
+namespace pw::protobuf {
+
+// A view of a range of bytes within a MultiBuf, which may span several of its
+// chunks. MultiBufDecoder returns bytes and nested message fields as
+// MultiBufBytes rather than copying them out. The MultiBuf must outlive the
+// view and must not be modified while it is in use.
+class MultiBufBytes {
+ public:
+  constexpr MultiBufBytes() : chunk_(), offset_(0), size_(0) {}
+
+  // Creates a view of all of the bytes in a MultiBuf.
+  explicit MultiBufBytes(const multibuf::MultiBuf& multibuf)
+      : MultiBufBytes(multibuf.Chunks().begin(), 0, multibuf.size()) {}
+
+  constexpr size_t size() const { return size_; }
+  constexpr bool empty() const { return size_ == 0u; }
+
+  // If the bytes are all within a single chunk, returns them as a span.
+  std::optional<ConstByteSpan> ContiguousSpan() const;
+
+  // Copies the bytes into the provided buffer.
+  //
+  // Return values:
+  //
+  //                   OK: All bytes were copied. The size is size().
+  //   RESOURCE_EXHAUSTED: dest was smaller than size(). The size is the number
+  //                       of bytes copied, which is dest.size().
+  //
+  StatusWithSize CopyTo(ByteSpan dest) const;
+
+ private:
+  friend class MultiBufDecoder;
+
+  MultiBufBytes(multibuf::MultiBuf::ConstChunkIterator chunk,
+                size_t offset,
+                size_t size)
+      : chunk_(chunk), offset_(offset), size_(size) {
+    SkipConsumedChunks();
+  }
+
+  // Returns the bytes at the start of the range that are in the first chunk.
+  ConstByteSpan FirstChunkBytes() const {
+    return empty() ? ConstByteSpan()
+                   : ConstByteSpan(chunk_->data() + offset_,
+                                   std::min(chunk_->size() - offset_, size_));
+  }
+
+  // Decodes a varint from the start of the view without consuming it. Returns
+  // the number of bytes read, or 0 if the varint is invalid.
+  size_t PeekVarint(uint64_t* value) const;
+
+  // Returns a view of the first `size` bytes. `size` must not exceed size().
+  MultiBufBytes first(size_t size) const {
+    return MultiBufBytes(chunk_, offset_, size);
+  }
+
+  // Removes the first `size` bytes from the view. `size` must not exceed
+  // size().
+  void DiscardPrefix(size_t size);
+
+  // Advances past chunks with no bytes left in the view, so that a non-empty
+  // view always starts within its first chunk.
+  void SkipConsumedChunks();
+
+  multibuf::MultiBuf::ConstChunkIterator chunk_;
+  size_t offset_;  // Offset of the first byte within *chunk_.
+  size_t size_;
+};
+
+// Decodes a protobuf message from a MultiBuf. Reading a field never requires
+// the message to be contiguous: varints and fixed-size values that straddle a
+// chunk boundary are reassembled on the stack, and bytes, string, and nested
+// message fields are returned as MultiBufBytes views.
+class MultiBufDecoder {
+ public:
+  explicit MultiBufDecoder(const multibuf::MultiBuf& proto)
+      : MultiBufDecoder(MultiBufBytes(proto)) {}
+
+  // Decodes a message from a view, such as a nested message field read by
+  // another MultiBufDecoder.
+  explicit constexpr MultiBufDecoder(const MultiBufBytes& proto)
+      : proto_(proto), previous_field_consumed_(true) {}
+
+  MultiBufDecoder(const MultiBufDecoder& other) = delete;
+  MultiBufDecoder& operator=(const MultiBufDecoder& other) = delete;
+
+  // Advances to the next field in the proto.
+  //
+  // If Next() returns OK, there is guaranteed to be a valid protobuf field at
+  // the current cursor position.
+  //
+  // Return values:
+  //
+  //             OK: Advanced to a valid proto field.
+  //   OUT_OF_RANGE: Reached the end of the proto message.
+  //      DATA_LOSS: Invalid protobuf data.
+  //
+  Status Next();
+
+  // Returns the field number of the field at the current cursor position.
+  //
+  // A return value of 0 indicates that the field number is invalid.
+  uint32_t FieldNumber() const;
+
+  // Reads a proto int32 value from the current cursor.
+  Status ReadInt32(int32_t* out) {
+    return ReadUint32(reinterpret_cast<uint32_t*>(out));
+  }
+
+  // Reads a proto uint32 value from the current cursor.
+  Status ReadUint32(uint32_t* out);
+
+  // Reads a proto int64 value from the current cursor.
+  Status ReadInt64(int64_t* out) {
+    return ReadVarint(reinterpret_cast<uint64_t*>(out));
+  }
+
+  // Reads a proto uint64 value from the current cursor.
+  Status ReadUint64(uint64_t* out) { return ReadVarint(out); }
+
+  // Reads a proto sint32 value from the current cursor.
+  Status ReadSint32(int32_t* out);
+
+  // Reads a proto sint64 value from the current cursor.
+  Status ReadSint64(int64_t* out);
+
+  // Reads a proto bool value from the current cursor.
+  Status ReadBool(bool* out);
+
+  // Reads a proto fixed32 value from the current cursor.
+  Status ReadFixed32(uint32_t* out) { return ReadFixed(out); }
+
+  // Reads a proto fixed64 value from the current cursor.
+  Status ReadFixed64(uint64_t* out) { return ReadFixed(out); }
+
+  // Reads a proto sfixed32 value from the current cursor.
+  Status ReadSfixed32(int32_t* out) {
+    return ReadFixed32(reinterpret_cast<uint32_t*>(out));
+  }
+
+  // Reads a proto sfixed64 value from the current cursor.
+  Status ReadSfixed64(int64_t* out) {
+    return ReadFixed64(reinterpret_cast<uint64_t*>(out));
+  }
+
+  // Reads a proto float value from the current cursor.
+  Status ReadFloat(float* out) {
+    static_assert(sizeof(float) == sizeof(uint32_t),
+                  "Float and uint32_t must be the same size for protobufs");
+    return ReadFixed(out);
+  }
+
+  // Reads a proto double value from the current cursor.
+  Status ReadDouble(double* out) {
+    static_assert(sizeof(double) == sizeof(uint64_t),
+                  "Double and uint64_t must be the same size for protobufs");
+    return ReadFixed(out);
+  }
+
+  // Reads a proto bytes, string, or nested message value from the current
+  // cursor and returns a view of it in `out`. No data is copied. If the field
+  // is invalid, `out` is not modified.
+  Status ReadBytes(MultiBufBytes* out) { return ReadDelimited(out); }
+
+  // Resets the decoder to start reading a new proto message.
+  void Reset(const multibuf::MultiBuf& proto) {
+    proto_ = MultiBufBytes(proto);
+    previous_field_consumed_ = true;
+  }
+
+ private:
+  // Stores the size of a field.
+  struct FieldSize {
+    static constexpr FieldSize Invalid() { return {0, 0}; }
+
+    bool ok() const { return key_size_bytes != 0; }
+
+    // Total size of the field (key and value); 0 if ok() is false.
+    size_t total() const { return key_size_bytes + value_size_bytes; }
+
+    size_t key_size_bytes;    // size of key + length (if delimited field)
+    size_t value_size_bytes;  // size of raw value only
+  };
+
+  // Advances the cursor to the next field in the proto.
+  Status SkipField();
+
+  // Returns the size of the current field as a FieldSize object.
+  FieldSize GetFieldSize() const;
+
+  Status ConsumeKey(WireType expected_type);
+
+  // Reads a varint key-value pair from the current cursor position.
+  Status ReadVarint(uint64_t* out);
+
+  // Reads a fixed-size key-value pair from the current cursor position.
+  Status ReadFixed(std::byte* out, size_t size);
+
+  template <typename T>
+  Status ReadFixed(T* out) {
+    static_assert(
+        sizeof(T) == sizeof(uint32_t) || sizeof(T) == sizeof(uint64_t),
+        "Protobuf fixed-size fields must be 32- or 64-bit");
+    return ReadFixed(reinterpret_cast<std::byte*>(out), sizeof(T));
+  }
+
+  Status ReadDelimited(MultiBufBytes* out);
+
+  MultiBufBytes proto_;
+  bool previous_field_consumed_;
+};
+
+}  // namespace pw::protobuf
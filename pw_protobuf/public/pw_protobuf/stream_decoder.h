@@ -18,6 +18,7 @@
 #include <limits>
 #include <type_traits>
 
+#include "pw_allocator/allocator.h"
 #include "pw_assert/assert.h"
 #include "pw_containers/vector.h"
 #include "pw_protobuf/internal/codegen.h"
@@ -30,6 +31,9 @@
 #include "pw_varint/varint.h"
 
 namespace pw::protobuf {
+namespace internal {
+class BasicStreamFieldIndex;
+}  // namespace internal
 
 // A low-level, event-based protobuf wire format decoder that operates on a
 // stream.
@@ -119,7 +123,8 @@ class StreamDecoder {
         parent_(nullptr),
         field_consumed_(true),
         nested_reader_open_(false),
-        status_(OkStatus()) {}
+        status_(OkStatus()),
+        allocator_(nullptr) {}
 
   StreamDecoder(const StreamDecoder& other) = delete;
   StreamDecoder& operator=(const StreamDecoder& other) = delete;
@@ -493,6 +498,20 @@ class StreamDecoder {
   // See the example in GetBytesReader() above for RAII semantics and usage.
   StreamDecoder GetNestedDecoder();
 
+  // Sets the allocator that Read() uses for the contents of struct fields
+  // with the use_allocator codegen option, such as bytes, strings, and
+  // repeated scalars. Nested decoders use their parent's allocator.
+  //
+  // The decoded struct refers to, but does not own, the allocated memory. An
+  // arena, such as pw::allocator::BumpAllocator, lets it all be released at
+  // once when the struct is no longer needed.
+  //
+  // Reading a message with use_allocator fields returns FAILED_PRECONDITION
+  // if no allocator is set, and RESOURCE_EXHAUSTED if an allocation fails.
+  constexpr void set_allocator(Allocator& allocator) {
+    allocator_ = &allocator;
+  }
+
   struct Bounds {
     size_t low;
     size_t high;
@@ -518,7 +537,8 @@ class StreamDecoder {
         parent_(other.parent_),
         field_consumed_(other.field_consumed_),
         nested_reader_open_(other.nested_reader_open_),
-        status_(other.status_) {
+        status_(other.status_),
+        allocator_(other.allocator_) {
     PW_ASSERT(!nested_reader_open_);
     // Make the nested decoder look like it has an open child to block reads for
     // the remainder of the object's life, and an invalid status to ensure it
@@ -540,6 +560,9 @@ class StreamDecoder {
  private:
   friend class BytesReader;
 
+  // Allow the stream FieldIndex to skip fields while indexing them.
+  friend class internal::BasicStreamFieldIndex;
+
   // The FieldKey class can't store an invalid key, so pick a random large key
   // to set as the initial value. This will be overwritten the first time Next()
   // is called, and FieldKey() fails if Next() is not called first -- ensuring
@@ -560,7 +583,8 @@ class StreamDecoder {
         parent_(parent),
         field_consumed_(true),
         nested_reader_open_(false),
-        status_(OkStatus()) {}
+        status_(OkStatus()),
+        allocator_(parent->allocator_) {}
 
   // Creates an unusable decoder in an error state. This is required as
   // GetNestedEncoder does not have a way to report an error in its API.
@@ -576,7 +600,8 @@ class StreamDecoder {
         parent_(parent),
         field_consumed_(true),
         nested_reader_open_(false),
-        status_(status) {
+        status_(status),
+        allocator_(nullptr) {
     PW_ASSERT(!status.ok());
   }
 
@@ -716,6 +741,15 @@ class StreamDecoder {
     return sws.status();
   }
 
+  // Reads a use_allocator field into memory from allocator_, replacing the
+  // struct member's contents, or appending to them for repeated fields.
+  Status ReadAllocatedField(span<std::byte> out,
+                            const internal::MessageField& field);
+
+  template <typename T>
+  Status ReadAllocatedRepeatedField(span<const T>& values,
+                                    const internal::MessageField& field);
+
   Status CheckOkToRead(WireType type);
 
   stream::Reader& reader_;
@@ -733,6 +767,8 @@ class StreamDecoder {
 
   Status status_;
 
+  Allocator* allocator_;
+
   friend class Message;
 };
 
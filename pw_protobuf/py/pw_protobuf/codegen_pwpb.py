@@ -429,7 +429,23 @@ class MessageProperty(ProtoMember):
         options = self._field.options()
         assert options is not None
         return options.use_callback or (
-            self._field.is_repeated() and self.max_size() == 0
+            self._field.is_repeated()
+            and self.max_size() == 0
+            and not self.use_allocator()
+        )
+
+    def use_allocator(self) -> bool:
+        """Returns whether the decoder should allocate the field's contents.
+
+        Applies to repeated scalar fields. Bytes and string fields override
+        this for their non-repeated form.
+        """
+        options = self._field.options()
+        assert options is not None
+        return (
+            options.use_allocator
+            and self._field.is_repeated()
+            and not options.use_callback
         )
 
     def is_optional(self) -> bool:
@@ -454,7 +470,7 @@ class MessageProperty(ProtoMember):
 
     def is_fixed_size(self) -> bool:
         """Returns whether the decoder should use a fixed sized field."""
-        if self._field.is_repeated():
+        if self._field.is_repeated() and not self.use_allocator():
             options = self._field.options()
             assert options is not None
             return options.fixed_count
@@ -471,6 +487,12 @@ class MessageProperty(ProtoMember):
                 f'{PROTOBUF_NAMESPACE}::Callback<StreamEncoder, StreamDecoder>'
             )
 
+        # Allocated fields are views of memory from the decoder's allocator.
+        if self.use_allocator():
+            if self.is_string():
+                return 'std::string_view'
+            return f'::pw::span<const {self.type_name(from_root)}>'
+
         # Optional fields are wrapped in std::optional
         if self.is_optional():
             return 'std::optional<{}>'.format(self.type_name(from_root))
@@ -527,6 +549,7 @@ class MessageProperty(ProtoMember):
             'offsetof(Message, {})'.format(self.name()),
             'sizeof(Message::{})'.format(self.name()),
             self.sub_table(),
+            self._bool_attr('use_allocator'),
         ]
 
     @abc.abstractmethod
@@ -654,6 +677,9 @@ class SubMessageProperty(MessageProperty):
             or self._field.is_repeated()
         )
 
+    def use_allocator(self) -> bool:
+        return False
+
     def wire_type(self) -> str:
         return 'kDelimited'
 
@@ -1985,7 +2011,12 @@ class BytesProperty(MessageProperty):
         return 'std::byte'
 
     def use_callback(self) -> bool:
-        return self.max_size() == 0
+        return self.max_size() == 0 and not self.use_allocator()
+
+    def use_allocator(self) -> bool:
+        options = self._field.options()
+        assert options is not None
+        return not self._field.is_repeated() and options.use_allocator
 
     def max_size(self) -> int:
         if not self._field.is_repeated():
@@ -1996,7 +2027,7 @@ class BytesProperty(MessageProperty):
         return 0
 
     def is_fixed_size(self) -> bool:
-        if not self._field.is_repeated():
+        if not self._field.is_repeated() and not self.use_allocator():
             options = self._field.options()
             assert options is not None
             return options.fixed_size
@@ -2013,7 +2044,7 @@ class BytesProperty(MessageProperty):
         return 'SizeOfDelimitedFieldWithoutValue'
 
     def _size_length(self) -> str | None:
-        if self.use_callback():
+        if self.use_callback() or self.use_allocator():
             return None
         return self.max_size_constant_name()
 
@@ -2116,7 +2147,12 @@ class StringProperty(MessageProperty):
         return 'char'
 
     def use_callback(self) -> bool:
-        return self.max_size() == 0
+        return self.max_size() == 0 and not self.use_allocator()
+
+    def use_allocator(self) -> bool:
+        options = self._field.options()
+        assert options is not None
+        return not self._field.is_repeated() and options.use_allocator
 
     def max_size(self) -> int:
         if not self._field.is_repeated():
@@ -2146,7 +2182,7 @@ class StringProperty(MessageProperty):
         return 'SizeOfDelimitedFieldWithoutValue'
 
     def _size_length(self) -> str | None:
-        if self.use_callback():
+        if self.use_callback() or self.use_allocator():
             return None
         return self.max_size_constant_name()
 
@@ -2930,7 +2966,13 @@ def generate_struct_for_message(
             name = prop.name()
             output.write_line(f'{type_name} {name};')
 
-            if not prop.use_callback():
+            if prop.use_allocator() and not prop.is_string():
+                # pw::span has no equality operator, so compare the contents.
+                cmp.append(
+                    f'std::equal(this->{name}.begin(), this->{name}.end(), '
+                    f'other.{name}.begin(), other.{name}.end())'
+                )
+            elif not prop.use_callback():
                 cmp.append(f'this->{name} == other.{name}')
 
         # Equality operator
@@ -19,7 +19,9 @@
 #include <cstring>
 #include <limits>
 #include <optional>
+#include <string_view>
 
+#include "pw_allocator/layout.h"
 #include "pw_assert/assert.h"
 #include "pw_assert/check.h"
 #include "pw_bytes/bit.h"
@@ -501,6 +503,139 @@ StatusWithSize StreamDecoder::ReadPackedVarintField(span<std::byte> out,
   return StatusWithSize(OkStatus(), number_out);
 }
 
+Status StreamDecoder::ReadAllocatedField(span<std::byte> out,
+                                         const internal::MessageField& field) {
+  if (allocator_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+
+  if (field.is_repeated()) {
+    // The struct member is a span of a type corresponding to the field
+    // element size.
+    if (field.elem_size() == sizeof(uint64_t)) {
+      return ReadAllocatedRepeatedField(
+          *reinterpret_cast<span<const uint64_t>*>(out.data()), field);
+    }
+    if (field.elem_size() == sizeof(uint32_t)) {
+      return ReadAllocatedRepeatedField(
+          *reinterpret_cast<span<const uint32_t>*>(out.data()), field);
+    }
+    PW_CHECK(field.elem_size() == sizeof(bool),
+             "Mismatched message field type and size");
+    return ReadAllocatedRepeatedField(
+        *reinterpret_cast<span<const bool>*>(out.data()), field);
+  }
+
+  // bytes or string field. The struct member is a span<const std::byte> for
+  // bytes or a std::string_view for string.
+  PW_CHECK(field.elem_size() == sizeof(std::byte),
+           "Mismatched message field type and size");
+  PW_TRY(CheckOkToRead(WireType::kDelimited));
+
+  const size_t size = delimited_field_size_;
+  std::byte* data = nullptr;
+  if (size != 0) {
+    data = static_cast<std::byte*>(
+        allocator_->Allocate(allocator::Layout(size, alignof(std::byte))));
+    if (data == nullptr) {
+      return Status::ResourceExhausted();
+    }
+  }
+
+  if (const StatusWithSize sws = ReadDelimitedField(span(data, size));
+      !sws.ok()) {
+    allocator_->Deallocate(data);
+    return sws.status();
+  }
+
+  // A later occurrence of the field replaces the earlier one.
+  const void* previous = nullptr;
+  if (field.is_string()) {
+    auto* value = reinterpret_cast<std::string_view*>(out.data());
+    if (!value->empty()) {
+      previous = value->data();
+    }
+    *value = std::string_view(reinterpret_cast<const char*>(data), size);
+  } else {
+    auto* value = reinterpret_cast<span<const std::byte>*>(out.data());
+    if (!value->empty()) {
+      previous = value->data();
+    }
+    *value = span<const std::byte>(data, size);
+  }
+  allocator_->Deallocate(const_cast<void*>(previous));
+  return OkStatus();
+}
+
+template <typename T>
+Status StreamDecoder::ReadAllocatedRepeatedField(
+    span<const T>& values, const internal::MessageField& field) {
+  // Repeated scalar fields may be packed into one delimited field, or
+  // encoded as one field per element. The whole packed field is allocated
+  // at once, sized for its maximum number of elements.
+  const bool packed = current_field_.wire_type() == WireType::kDelimited;
+  const bool is_varint = field.wire_type() == WireType::kVarint;
+  size_t max_count = 1;
+  if (packed) {
+    if (!is_varint && delimited_field_size_ % sizeof(T) != 0) {
+      status_ = Status::DataLoss();
+      return status_;
+    }
+    // Every varint is encoded in at least one byte.
+    max_count = is_varint ? delimited_field_size_
+                          : delimited_field_size_ / sizeof(T);
+  }
+
+  T* data = nullptr;
+  const size_t capacity = values.size() + max_count;
+  if (max_count != 0) {
+    data = static_cast<T*>(allocator_->Allocate(
+        allocator::Layout(capacity * sizeof(T), alignof(T))));
+    if (data == nullptr) {
+      return Status::ResourceExhausted();
+    }
+  }
+  const span<std::byte> out =
+      as_writable_bytes(span(data, capacity).subspan(values.size()));
+
+  size_t count = 0;
+  Status status;
+  if (packed && is_varint) {
+    const StatusWithSize sws =
+        ReadPackedVarintField(out, sizeof(T), field.varint_type());
+    status = sws.status();
+    count = sws.size();
+  } else if (packed) {
+    const StatusWithSize sws = ReadPackedFixedField(out, sizeof(T));
+    status = sws.status();
+    count = sws.size();
+  } else if (is_varint) {
+    status = ReadVarintField(out, field.varint_type());
+    count = 1;
+  } else {
+    status = ReadFixedField(out);
+    count = 1;
+  }
+  if (!status.ok()) {
+    allocator_->Deallocate(data);
+    return status;
+  }
+  if (data == nullptr) {
+    return OkStatus();  // Empty packed field.
+  }
+
+  if (!values.empty()) {
+    std::copy(values.begin(), values.end(), data);
+    allocator_->Deallocate(const_cast<T*>(values.data()));
+  }
+  values = span<const T>(data, values.size() + count);
+  if (count < max_count) {
+    // Return the unused space, if the allocator supports shrinking in place.
+    allocator_->Resize(data, values.size_bytes());
+  }
+  return OkStatus();
+}
+
 Status StreamDecoder::CheckOkToRead(WireType type) {
   PW_CHECK(!nested_reader_open_,
            "Cannot read from a decoder while a nested decoder is open");
@@ -523,17 +658,23 @@ Status StreamDecoder::Read(span<std::byte> message,
                            span<const internal::MessageField> table) {
   PW_TRY(status_);
 
+  // Fields are usually encoded in the order of the table, so the search for
+  // each field starts after the previously decoded one.
+  auto next_field = table.begin();
   while (Next().ok()) {
-    // Find the field in the table,
-    // TODO: b/234876102 - Finding the field can be made more efficient.
-    const auto field =
-        std::find(table.begin(), table.end(), current_field_.field_number());
+    // Find the field in the table.
+    const uint32_t field_number = current_field_.field_number();
+    auto field = std::find(next_field, table.end(), field_number);
     if (field == table.end()) {
-      // If the field is not found, skip to the next one.
-      // TODO: b/234873295 - Provide a way to allow the caller to inspect
-      // unknown fields, and serialize them back out later.
-      continue;
+      field = std::find(table.begin(), next_field, field_number);
+      if (field == next_field) {
+        // If the field is not found, skip to the next one.
+        // TODO: b/234873295 - Provide a way to allow the caller to inspect
+        // unknown fields, and serialize them back out later.
+        continue;
+      }
     }
+    next_field = field + 1;
 
     // Calculate the span of bytes corresponding to the structure field to
     // output into.
@@ -551,6 +692,13 @@ Status StreamDecoder::Read(span<std::byte> message,
       continue;
     }
 
+    // If the field's contents are allocated, the struct member is a view of
+    // memory from the decoder's allocator.
+    if (field->use_allocator()) {
+      PW_TRY(ReadAllocatedField(out, *field));
+      continue;
+    }
+
     // Switch on the expected wire type of the field, not the actual, to ensure
     // the remote encoder doesn't influence our decoding unexpectedly.
     switch (field->wire_type()) {
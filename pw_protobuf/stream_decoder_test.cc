@@ -14,8 +14,16 @@
 
 #include "pw_protobuf/stream_decoder.h"
 
+#include <algorithm>
 #include <array>
-
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+
+#include "decoder_corpus.h"
+#include "pw_allocator/bump_allocator.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_protobuf/internal/codegen.h"
 #include "pw_status/status.h"
 #include "pw_status/status_with_size.h"
 #include "pw_stream/memory_stream.h"
@@ -1623,5 +1631,258 @@ TEST(StreamDecoder, NestedIncompleteVarint) {
   EXPECT_EQ(nested_decoder.ReadInt32().status(), Status::DataLoss());
 }
 
+// Hand-written equivalents of the struct and field table generated for the
+// following message, used to test decoding message structs.
+//
+//   message ScalarStruct {
+//     uint32 first = 1;
+//     sint64 second = 2;
+//     fixed32 third = 3;
+//   }
+struct ScalarStruct {
+  uint32_t first;
+  int64_t second;
+  uint32_t third;
+};
+
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC(ignored, "-Winvalid-offsetof");
+
+constexpr internal::MessageField kScalarStructFieldsArray[] = {
+    {1,
+     WireType::kVarint,
+     sizeof(uint32_t),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(ScalarStruct, first),
+     sizeof(ScalarStruct::first),
+     nullptr},
+    {2,
+     WireType::kVarint,
+     sizeof(int64_t),
+     internal::VarintType::kZigZag,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(ScalarStruct, second),
+     sizeof(ScalarStruct::second),
+     nullptr},
+    {3,
+     WireType::kFixed32,
+     sizeof(uint32_t),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(ScalarStruct, third),
+     sizeof(ScalarStruct::third),
+     nullptr},
+};
+constexpr span<const internal::MessageField> kScalarStructFields(
+    kScalarStructFieldsArray);
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
+// Exposes the struct Read() used by generated decoders.
+class StructDecoder : public StreamDecoder {
+ public:
+  using StreamDecoder::StreamDecoder;
+
+  Status Read(ScalarStruct& message) {
+    return StreamDecoder::Read(as_writable_bytes(span(&message, 1)),
+                               kScalarStructFields);
+  }
+};
+
+TEST(StreamDecoder, ReadStruct_FieldsInAnyOrder) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // type=fixed32, k=3, v=0x01020304
+    0x1d, 0x04, 0x03, 0x02, 0x01,
+    // type=uint32, k=1, v=150
+    0x08, 0x96, 0x01,
+    // type=uint32, k=4 (unknown), v=7
+    0x20, 0x07,
+    // type=sint64, k=2, v=-3
+    0x10, 0x05,
+    // type=uint32, k=1, v=2 (replaces the earlier value)
+    0x08, 0x02,
+  };
+  // clang-format on
+
+  stream::MemoryReader reader(as_bytes(span(encoded_proto)));
+  StructDecoder decoder(reader);
+  ScalarStruct message{};
+  ASSERT_EQ(decoder.Read(message), OkStatus());
+  EXPECT_EQ(message.first, 2u);
+  EXPECT_EQ(message.second, -3);
+  EXPECT_EQ(message.third, 0x01020304u);
+}
+
+// Hand-written equivalents of the struct and field table generated for the
+// following message with the use_allocator option on each field.
+//
+//   message AllocatedStruct {
+//     repeated uint32 values = 1;
+//     repeated fixed64 fixed = 2;
+//     string name = 3;
+//     bytes data = 4;
+//   }
+struct AllocatedStruct {
+  span<const uint32_t> values;
+  span<const uint64_t> fixed;
+  std::string_view name;
+  span<const std::byte> data;
+};
+
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC(ignored, "-Winvalid-offsetof");
+
+constexpr internal::MessageField kAllocatedStructFieldsArray[] = {
+    {1,
+     WireType::kVarint,
+     sizeof(uint32_t),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/true,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(AllocatedStruct, values),
+     sizeof(AllocatedStruct::values),
+     nullptr,
+     /*use_allocator=*/true},
+    {2,
+     WireType::kFixed64,
+     sizeof(uint64_t),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/true,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(AllocatedStruct, fixed),
+     sizeof(AllocatedStruct::fixed),
+     nullptr,
+     /*use_allocator=*/true},
+    {3,
+     WireType::kDelimited,
+     sizeof(char),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/true,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(AllocatedStruct, name),
+     sizeof(AllocatedStruct::name),
+     nullptr,
+     /*use_allocator=*/true},
+    {4,
+     WireType::kDelimited,
+     sizeof(std::byte),
+     internal::VarintType::kUnsigned,
+     /*is_string=*/false,
+     /*is_fixed_size=*/false,
+     /*is_repeated=*/false,
+     /*is_optional=*/false,
+     /*use_callback=*/false,
+     offsetof(AllocatedStruct, data),
+     sizeof(AllocatedStruct::data),
+     nullptr,
+     /*use_allocator=*/true},
+};
+constexpr span<const internal::MessageField> kAllocatedStructFields(
+    kAllocatedStructFieldsArray);
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
+class AllocatedStructDecoder : public StreamDecoder {
+ public:
+  using StreamDecoder::StreamDecoder;
+
+  Status Read(AllocatedStruct& message) {
+    return StreamDecoder::Read(as_writable_bytes(span(&message, 1)),
+                               kAllocatedStructFields);
+  }
+};
+
+// clang-format off
+constexpr uint8_t kAllocatedStructProto[] = {
+  // type=repeated uint32, k=1, packed, v={1, 150, 3}
+  0x0a, 0x04, 0x01, 0x96, 0x01, 0x03,
+  // type=repeated uint32, k=1, unpacked, v=7
+  0x08, 0x07,
+  // type=repeated fixed64, k=2, packed, v={0x0102030405060708}
+  0x12, 0x08, 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,
+  // type=string, k=3, v="abc"
+  0x1a, 0x03, 'a', 'b', 'c',
+  // type=bytes, k=4, v={0xde, 0xad}
+  0x22, 0x02, 0xde, 0xad,
+};
+// clang-format on
+
+TEST(StreamDecoder, ReadStruct_AllocatedFields) {
+  std::array<std::byte, 128> arena;
+  allocator::BumpAllocator allocator(arena);
+
+  stream::MemoryReader reader(as_bytes(span(kAllocatedStructProto)));
+  AllocatedStructDecoder decoder(reader);
+  decoder.set_allocator(allocator);
+  AllocatedStruct message{};
+  ASSERT_EQ(decoder.Read(message), OkStatus());
+
+  constexpr uint32_t kValues[] = {1, 150, 3, 7};
+  ASSERT_EQ(message.values.size(), std::size(kValues));
+  EXPECT_TRUE(
+      std::equal(message.values.begin(), message.values.end(), kValues));
+  ASSERT_EQ(message.fixed.size(), 1u);
+  EXPECT_EQ(message.fixed[0], 0x0102030405060708u);
+  EXPECT_EQ(message.name, "abc");
+  ASSERT_EQ(message.data.size(), 2u);
+  EXPECT_EQ(message.data[0], std::byte{0xde});
+  EXPECT_EQ(message.data[1], std::byte{0xad});
+
+  // The decoded fields refer to the arena.
+  EXPECT_GE(reinterpret_cast<const std::byte*>(message.name.data()),
+            arena.data());
+  EXPECT_LT(reinterpret_cast<const std::byte*>(message.name.data()),
+            arena.data() + arena.size());
+}
+
+TEST(StreamDecoder, ReadStruct_AllocatedFieldsWithoutAllocator) {
+  stream::MemoryReader reader(as_bytes(span(kAllocatedStructProto)));
+  AllocatedStructDecoder decoder(reader);
+  AllocatedStruct message{};
+  EXPECT_EQ(decoder.Read(message), Status::FailedPrecondition());
+}
+
+TEST(StreamDecoder, ReadStruct_AllocatedFieldsExhaustAllocator) {
+  std::array<std::byte, 8> arena;
+  allocator::BumpAllocator allocator(arena);
+
+  stream::MemoryReader reader(as_bytes(span(kAllocatedStructProto)));
+  AllocatedStructDecoder decoder(reader);
+  decoder.set_allocator(allocator);
+  AllocatedStruct message{};
+  EXPECT_EQ(decoder.Read(message), Status::ResourceExhausted());
+}
+
+TEST(StreamDecoder, Corpus_DecodesAllLogEntries) {
+  size_t entries = 0;
+  for (ConstByteSpan input : test::kDecoderCorpus) {
+    EXPECT_EQ(test::DecodeLogEntries(input, entries), OkStatus());
+  }
+  EXPECT_EQ(entries, test::kDecoderCorpusEntries);
+}
+
 }  // namespace
 }  // namespace pw::protobuf
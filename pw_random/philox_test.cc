@@ -0,0 +1,122 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+#include "pw_random/philox.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::random {
+namespace {
+
+// The first block of Philox4x32-10 with a zero key and counter, from the
+// Random123 known-answer tests.
+constexpr std::array<uint32_t, 4> kZeroKeyFirstBlock = {
+    0x6627e8d5,
+    0xe169c58d,
+    0xbc57ac4c,
+    0x9b00dbd8,
+};
+
+TEST(Philox4x32Rng, MatchesKnownAnswer) {
+  Philox4x32Rng rng(0);
+  std::array<uint32_t, 4> block;
+  rng.GetInts(span(block));
+  EXPECT_EQ(block, kZeroKeyFirstBlock);
+}
+
+TEST(Philox4x32Rng, BulkFillMatchesBlockByBlock) {
+  Philox4x32Rng bulk_rng(0x0123456789abcdef);
+  std::array<uint32_t, 4 * 19> bulk;
+  bulk_rng.GetInts(span(bulk));
+
+  Philox4x32Rng block_rng(0x0123456789abcdef);
+  std::array<uint32_t, 4 * 19> blocks;
+  for (size_t i = 0; i < blocks.size(); i += 4) {
+    block_rng.GetInts(span(blocks).subspan(i, 4));
+  }
+
+  EXPECT_EQ(bulk, blocks);
+}
+
+TEST(Philox4x32Rng, PartialBlocksAreDiscarded) {
+  Philox4x32Rng rng(0);
+  std::array<std::byte, 3> partial;
+  rng.Get(partial);
+  EXPECT_EQ(std::memcmp(partial.data(), kZeroKeyFirstBlock.data(), 3), 0);
+
+  std::array<uint32_t, 4> next;
+  rng.GetInts(span(next));
+  EXPECT_NE(next, kZeroKeyFirstBlock);
+
+  Philox4x32Rng second_block_rng(0);
+  std::array<uint32_t, 8> two_blocks;
+  second_block_rng.GetInts(span(two_blocks));
+  EXPECT_TRUE(std::equal(next.begin(), next.end(), two_blocks.begin() + 4));
+}
+
+TEST(Philox4x32Rng, StreamsDiffer) {
+  Philox4x32Rng rng_1(5, 0);
+  Philox4x32Rng rng_2(5, 1);
+  uint64_t first_val = 0;
+  uint64_t second_val = 0;
+  rng_1.GetInt(first_val);
+  rng_2.GetInt(second_val);
+  EXPECT_NE(first_val, second_val);
+}
+
+TEST(Philox4x32Rng, InjectEntropyBits) {
+  Philox4x32Rng rng(0);
+  std::array<uint32_t, 4> block;
+  rng.InjectEntropyBits(0x1, 1);
+  rng.GetInts(span(block));
+  EXPECT_NE(block, kZeroKeyFirstBlock);
+}
+
+// Ensure injecting the same integer bit-by-bit applies the same transformation
+// as all in one call.
+TEST(Philox4x32Rng, IncrementalEntropy) {
+  Philox4x32Rng rng_1(5);
+  uint64_t first_val = 0;
+  rng_1.InjectEntropyBits(0x6, 3);
+  rng_1.GetInt(first_val);
+
+  Philox4x32Rng rng_2(5);
+  uint64_t second_val = 0;
+  rng_2.InjectEntropyBits(0x1, 1);
+  rng_2.InjectEntropyBits(0x1, 1);
+  rng_2.InjectEntropyBits(0x0, 1);
+  rng_2.GetInt(second_val);
+
+  EXPECT_EQ(first_val, second_val);
+}
+
+TEST(Philox4x32Rng, GetIntBoundedIsLowerThanBound) {
+  Philox4x32Rng rng(5);
+  for (uint32_t bound : {7u, 13u, 51u, 1025u, 546778u}) {
+    for (int i = 0; i < 256; ++i) {
+      uint32_t value = 0;
+      rng.GetInt(value, bound);
+      EXPECT_LT(value, bound);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace pw::random
@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <type_traits>
 
 #include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
@@ -42,6 +43,18 @@ class RandomGenerator {
     Get({reinterpret_cast<std::byte*>(&dest), sizeof(T)});
   }
 
+  /// Populates a span of integers with random values.
+  ///
+  /// This fills the whole span with one call to `Get()`, which lets
+  /// generators that produce several words at a time, such as
+  /// `Philox4x32Rng`, fill large buffers efficiently.
+  template <class T, size_t kExtent>
+  void GetInts(span<T, kExtent> dest) {
+    static_assert(std::is_integral<T>::value,
+                  "Use Get() for non-integral types");
+    Get(as_writable_bytes(dest));
+  }
+
   /// Calculates a uniformly distributed random number in the range
   /// `[0, exclusive_upper_bound)`.
   ///
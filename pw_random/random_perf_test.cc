@@ -0,0 +1,47 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_random/philox.h"
+#include "pw_random/random.h"
+#include "pw_random/xor_shift.h"
+
+namespace pw::random {
+namespace {
+
+constexpr uint64_t kSeed = 0x21feabcd5fb37474u;
+
+std::array<std::byte, 4096> buffer;
+
+void FillTest(perf_test::State& state, size_t size, RandomGenerator& rng) {
+  const ByteSpan dest = span(buffer).first(size);
+  while (state.KeepRunning()) {
+    rng.Get(dest);
+  }
+}
+
+XorShiftStarRng64 xor_shift(kSeed);
+Philox4x32Rng philox(kSeed);
+
+PW_PERF_TEST_RANGE(XorShiftStarFill, FillTest, 16, 4096, xor_shift);
+PW_PERF_TEST_RANGE(PhiloxFill, FillTest, 16, 4096, philox);
+
+}  // namespace
+}  // namespace pw::random
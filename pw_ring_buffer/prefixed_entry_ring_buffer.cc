@@ -31,9 +31,14 @@ using Reader = PrefixedEntryRingBufferMulti::Reader;
 using iterator = PrefixedEntryRingBufferMulti::iterator;
 
 void PrefixedEntryRingBufferMulti::Clear() {
-  write_idx_ = 0;
+  if (unpublished_bytes_ == 0) {
+    write_idx_ = 0;
+  }
+  // Keep any entries with open reservations, which end at the write index.
+  const size_t read_idx =
+      IncrementIndex(write_idx_, buffer_bytes_ - unpublished_bytes_);
   for (Reader& reader : readers_) {
-    reader.read_idx_ = 0;
+    reader.read_idx_ = read_idx;
     reader.entry_count_ = 0;
   }
 }
@@ -47,6 +52,9 @@ Status PrefixedEntryRingBufferMulti::SetBuffer(span<byte> buffer) {
 
   buffer_ = buffer.data();
   buffer_bytes_ = buffer.size_bytes();
+  open_reservations_ = 0;
+  unpublished_entry_count_ = 0;
+  unpublished_bytes_ = 0;
 
   Clear();
   return OkStatus();
@@ -59,7 +67,10 @@ Status PrefixedEntryRingBufferMulti::AttachReader(Reader& reader) {
   reader.buffer_ = this;
 
   if (readers_.empty()) {
-    reader.read_idx_ = write_idx_;
+    // Start before any entries with open reservations, so the reader sees
+    // them once they are committed.
+    reader.read_idx_ =
+        IncrementIndex(write_idx_, buffer_bytes_ - unpublished_bytes_);
     reader.entry_count_ = 0;
   } else {
     const Reader& slowest_reader = GetSlowestReader();
@@ -86,6 +97,20 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
     span<const byte> data,
     uint32_t user_preamble_data,
     bool pop_front_if_needed) {
+  Reservation reservation;
+  PW_TRY(InternalReserve(
+      data.size_bytes(), reservation, user_preamble_data, pop_front_if_needed));
+  reservation.Write(data);
+  Commit(reservation);
+  return OkStatus();
+}
+
+Status PrefixedEntryRingBufferMulti::InternalReserve(
+    size_t size_bytes,
+    Reservation& reservation_out,
+    uint32_t user_preamble_data,
+    bool pop_front_if_needed) {
+  PW_DCHECK(!reservation_out.open_);
   if (buffer_ == nullptr) {
     return Status::FailedPrecondition();
   }
@@ -99,16 +124,20 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
         varint::Encode<uint32_t>(user_preamble_data, preamble_buf);
   }
   size_t length_bytes =
-      varint::Encode<uint32_t>(static_cast<uint32_t>(data.size_bytes()),
+      varint::Encode<uint32_t>(static_cast<uint32_t>(size_bytes),
                                span(preamble_buf).subspan(user_preamble_bytes));
-  size_t total_write_bytes =
-      user_preamble_bytes + length_bytes + data.size_bytes();
+  size_t total_write_bytes = user_preamble_bytes + length_bytes + size_bytes;
   if (buffer_bytes_ < total_write_bytes) {
     return Status::OutOfRange();
   }
 
   if (pop_front_if_needed) {
     // PushBack() case: evict items as needed.
+    // Entries with open reservations are not visible to readers, so they are
+    // never dropped. Fail before dropping anything if they leave no space.
+    if (buffer_bytes_ - unpublished_bytes_ < total_write_bytes) {
+      return Status::ResourceExhausted();
+    }
     // Drop old entries until we have space for the new entry.
     while (RawAvailableBytes() < total_write_bytes) {
       InternalPopFrontAll();
@@ -118,15 +147,41 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
     return Status::ResourceExhausted();
   }
 
-  // Write the new entry into the ring buffer.
+  // Write the preamble, and reserve the space for the data after it.
   RawWrite(span(preamble_buf, user_preamble_bytes + length_bytes));
-  RawWrite(data);
+  const size_t start = BufferOffset(write_idx_);
+  const size_t bytes_until_wrap = std::min(size_bytes, buffer_bytes_ - start);
+  reservation_out.data_ = {span<byte>(buffer_ + start, bytes_until_wrap),
+                           span<byte>(buffer_, size_bytes - bytes_until_wrap)};
+  reservation_out.open_ = true;
+  write_idx_ = IncrementIndex(write_idx_, size_bytes);
+
+  open_reservations_ += 1;
+  unpublished_entry_count_ += 1;
+  unpublished_bytes_ += total_write_bytes;
+  return OkStatus();
+}
+
+size_t PrefixedEntryRingBufferMulti::Commit(Reservation& reservation) {
+  PW_DCHECK(reservation.open_);
+  PW_DCHECK_UINT_NE(open_reservations_, 0);
+  reservation.data_ = {};
+  reservation.open_ = false;
+
+  open_reservations_ -= 1;
+  if (open_reservations_ != 0) {
+    // An earlier entry may still be being written.
+    return 0;
+  }
 
   // Update all readers of the new count.
+  const size_t published_entry_count = unpublished_entry_count_;
   for (Reader& reader : readers_) {
-    reader.entry_count_++;
+    reader.entry_count_ += published_entry_count;
   }
-  return OkStatus();
+  unpublished_entry_count_ = 0;
+  unpublished_bytes_ = 0;
+  return published_entry_count;
 }
 
 auto GetOutput(span<byte> data_out, size_t* write_index) {
@@ -245,7 +300,7 @@ const Reader& PrefixedEntryRingBufferMulti::GetSlowestReader() const {
 }
 
 Status PrefixedEntryRingBufferMulti::Dering() {
-  if (buffer_ == nullptr || readers_.empty()) {
+  if (buffer_ == nullptr || readers_.empty() || open_reservations_ != 0) {
     return Status::FailedPrecondition();
   }
 
@@ -308,6 +363,67 @@ Status PrefixedEntryRingBufferMulti::InternalPopFront(Reader& reader) {
   return OkStatus();
 }
 
+Status PrefixedEntryRingBufferMulti::InternalPeekFrontEntries(
+    const Reader& reader, EntryRun& run_out, size_t max_bytes) const {
+  run_out = EntryRun();
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  if (reader.entry_count_ == 0) {
+    return Status::OutOfRange();
+  }
+
+  size_t run_bytes = reader.EntriesSize();
+  size_t run_entries = reader.entry_count_;
+  if (run_bytes > max_bytes) {
+    // Only part of the entries fit; find the last whole entry that does.
+    run_bytes = 0;
+    run_entries = 0;
+    size_t read_idx = reader.read_idx_;
+    while (run_entries < reader.entry_count_) {
+      Result<EntryInfo> info = RawFrontEntryInfo(read_idx);
+      PW_CHECK_OK(info.status());
+      const size_t entry_bytes = info->preamble_bytes + info->data_bytes;
+      if (entry_bytes > max_bytes - run_bytes) {
+        break;
+      }
+      run_bytes += entry_bytes;
+      run_entries += 1;
+      read_idx = IncrementIndex(read_idx, entry_bytes);
+    }
+    if (run_entries == 0) {
+      return Status::ResourceExhausted();
+    }
+  }
+
+  // Split the run where it wraps.
+  const size_t start = BufferOffset(reader.read_idx_);
+  const size_t bytes_until_wrap = std::min(run_bytes, buffer_bytes_ - start);
+  run_out.raw_data_ = {span<const byte>(buffer_ + start, bytes_until_wrap),
+                       span<const byte>(buffer_, run_bytes - bytes_until_wrap)};
+  run_out.entry_count_ = run_entries;
+  run_out.user_preamble_ = user_preamble_;
+  return OkStatus();
+}
+
+Status PrefixedEntryRingBufferMulti::InternalPopFrontEntries(
+    Reader& reader, const EntryRun& run) {
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  if (run.empty()) {
+    return OkStatus();
+  }
+  if (run.entry_count_ > reader.entry_count_ ||
+      run.raw_data_[0].data() != buffer_ + BufferOffset(reader.read_idx_)) {
+    return Status::FailedPrecondition();
+  }
+
+  reader.read_idx_ = IncrementIndex(reader.read_idx_, run.size_bytes());
+  reader.entry_count_ -= run.entry_count_;
+  return OkStatus();
+}
+
 size_t PrefixedEntryRingBufferMulti::InternalFrontEntryDataSizeBytes(
     const Reader& reader) const {
   if (reader.entry_count_ == 0) {
@@ -372,7 +488,7 @@ size_t PrefixedEntryRingBufferMulti::RawAvailableBytes() const {
   // Compute slowest reader. If no readers exist, the entire buffer can be
   // written.
   if (readers_.empty()) {
-    return buffer_bytes_;
+    return buffer_bytes_ - unpublished_bytes_;
   }
 
   size_t read_idx = GetSlowestReader().read_idx_;
@@ -385,6 +501,9 @@ size_t PrefixedEntryRingBufferMulti::RawAvailableBytes() const {
     return read_idx - write_idx_;
   }
   // Case: Matched read and write heads; empty or full.
+  if (unpublished_bytes_ != 0) {
+    return 0;
+  }
   for (const Reader& reader : readers_) {
     if (reader.read_idx_ == read_idx && reader.entry_count_ != 0) {
       return 0;
@@ -450,13 +569,17 @@ Status PrefixedEntryRingBufferMulti::Reader::PeekFrontWithPreamble(
 }
 
 size_t PrefixedEntryRingBufferMulti::Reader::EntriesSize() const {
+  // Entries that are not visible to readers yet end at the write index.
+  const size_t unpublished_bytes = buffer_->unpublished_bytes_;
+
   // Case: Not wrapped.
   if (read_idx_ < buffer_->write_idx_) {
-    return buffer_->write_idx_ - read_idx_;
+    return buffer_->write_idx_ - read_idx_ - unpublished_bytes;
   }
   // Case: Wrapped.
   if (read_idx_ > buffer_->write_idx_) {
-    return buffer_->buffer_bytes_ - (read_idx_ - buffer_->write_idx_);
+    return buffer_->buffer_bytes_ - (read_idx_ - buffer_->write_idx_) -
+           unpublished_bytes;
   }
 
   // No entries remaining.
@@ -464,7 +587,7 @@ size_t PrefixedEntryRingBufferMulti::Reader::EntriesSize() const {
     return 0;
   }
 
-  return buffer_->buffer_bytes_;
+  return buffer_->buffer_bytes_ - unpublished_bytes;
 }
 
 iterator& iterator::operator++() {
@@ -515,5 +638,74 @@ const Entry& iterator::operator*() const {
   return entry_;
 }
 
+void PrefixedEntryRingBufferMulti::Reservation::Write(span<const byte> data) {
+  PW_DCHECK_UINT_LE(data.size(), size_bytes());
+  const size_t first_bytes = std::min(data.size(), data_[0].size());
+  std::memcpy(data_[0].data(), data.data(), first_bytes);
+  std::memcpy(
+      data_[1].data(), data.data() + first_bytes, data.size() - first_bytes);
+}
+
+void PrefixedEntryRingBufferMulti::EntryRun::RawRead(byte* destination,
+                                                    size_t offset,
+                                                    size_t length) const {
+  for (span<const byte> piece : Slice(offset, length)) {
+    memcpy(destination, piece.data(), piece.size());
+    destination += piece.size();
+  }
+}
+
+std::array<span<const byte>, 2> PrefixedEntryRingBufferMulti::EntryRun::Slice(
+    size_t offset, size_t length) const {
+  const span<const byte> first = raw_data_[0];
+  if (offset >= first.size()) {
+    return {raw_data_[1].subspan(offset - first.size(), length),
+            span<const byte>()};
+  }
+  const size_t first_length = std::min(length, first.size() - offset);
+  return {first.subspan(offset, first_length),
+          raw_data_[1].first(length - first_length)};
+}
+
+void PrefixedEntryRingBufferMulti::EntryRun::iterator::Decode() {
+  // Copy the preamble out, since it may be split.
+  byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
+  const size_t preamble_buf_size =
+      std::min(sizeof(preamble_buf), run_->size_bytes() - offset_);
+  run_->RawRead(preamble_buf, offset_, preamble_buf_size);
+  span<const byte> preamble(preamble_buf, preamble_buf_size);
+
+  uint64_t user_preamble = 0;
+  size_t user_preamble_bytes = 0;
+  if (run_->user_preamble_) {
+    user_preamble_bytes = varint::Decode(preamble, &user_preamble);
+    PW_CHECK_UINT_NE(user_preamble_bytes, 0u);
+  }
+
+  uint64_t data_bytes;
+  const size_t length_bytes =
+      varint::Decode(preamble.subspan(user_preamble_bytes), &data_bytes);
+  PW_CHECK_UINT_NE(length_bytes, 0u);
+
+  const size_t preamble_bytes = user_preamble_bytes + length_bytes;
+  entry_.data =
+      run_->Slice(offset_ + preamble_bytes, static_cast<size_t>(data_bytes));
+  entry_.preamble = static_cast<uint32_t>(user_preamble);
+  entry_bytes_ = preamble_bytes + static_cast<size_t>(data_bytes);
+}
+
+PrefixedEntryRingBufferMulti::EntryRun::iterator&
+PrefixedEntryRingBufferMulti::EntryRun::iterator::operator++() {
+  PW_DCHECK_INT_NE(remaining_, 0);
+  offset_ += entry_bytes_;
+  remaining_ -= 1;
+  if (remaining_ == 0) {
+    entry_ = {};
+  } else {
+    Decode();
+  }
+  return *this;
+}
+
 }  // namespace ring_buffer
 }  // namespace pw
@@ -938,6 +938,335 @@ TEST(PrefixedEntryRingBufferMulti, IteratorBufferCorruption) {
   EXPECT_EQ(validated_entries, valid_entries);
 }
 
+
+using EntryRun = PrefixedEntryRingBufferMulti::EntryRun;
+
+// Concatenates an entry's data spans.
+size_t CopyEntryData(const EntryRun::Entry& entry, span<byte> out) {
+  PW_CHECK_UINT_LE(entry.size_bytes(), out.size());
+  std::memcpy(out.data(), entry.data[0].data(), entry.data[0].size());
+  std::memcpy(out.data() + entry.data[0].size(),
+              entry.data[1].data(),
+              entry.data[1].size());
+  return entry.size_bytes();
+}
+
+TEST(PrefixedEntryRingBuffer, PeekFrontEntries_NoEntries) {
+  PrefixedEntryRingBuffer ring;
+  EntryRun run;
+  EXPECT_EQ(ring.PeekFrontEntries(run), Status::FailedPrecondition());
+
+  byte buffer[32];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+  EXPECT_EQ(ring.PeekFrontEntries(run), Status::OutOfRange());
+  EXPECT_TRUE(run.empty());
+  EXPECT_EQ(ring.PopFrontEntries(run), OkStatus());
+}
+
+void PeekAndPopEntriesCycles(bool user_preamble) {
+  PrefixedEntryRingBuffer ring(user_preamble);
+  byte buffer[61];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  uint32_t pushed = 0;
+  uint32_t popped = 0;
+  for (int cycle = 0; cycle < 200; ++cycle) {
+    // Push entries of varying size until the next one would evict.
+    while (true) {
+      std::array<byte, 7> data;
+      const size_t size = 1 + pushed % data.size();
+      std::memset(data.data(), static_cast<int>(pushed), size);
+      if (!ring.TryPushBack(span(data).first(size), pushed).ok()) {
+        break;
+      }
+      ++pushed;
+    }
+
+    // Drain in limited batches, then in one batch.
+    const size_t max_bytes = cycle % 2 == 0 ? 20 : sizeof(buffer);
+    EntryRun run;
+    ASSERT_EQ(ring.PeekFrontEntries(run, max_bytes), OkStatus());
+    EXPECT_LE(run.size_bytes(), max_bytes);
+    ASSERT_GT(run.entry_count(), 0u);
+
+    size_t entries = 0;
+    for (const EntryRun::Entry& entry : run) {
+      std::array<byte, 7> data;
+      const size_t size = CopyEntryData(entry, data);
+      EXPECT_EQ(size, 1 + popped % data.size());
+      EXPECT_EQ(data[size - 1], static_cast<byte>(popped));
+      EXPECT_EQ(entry.preamble, user_preamble ? popped : 0u);
+      ++popped;
+      ++entries;
+    }
+    EXPECT_EQ(entries, run.entry_count());
+
+    const size_t used_bytes = ring.TotalUsedBytes();
+    ASSERT_EQ(ring.PopFrontEntries(run), OkStatus());
+    EXPECT_EQ(ring.TotalUsedBytes(), used_bytes - run.size_bytes());
+    EXPECT_EQ(ring.EntryCount(), pushed - popped);
+  }
+}
+
+TEST(PrefixedEntryRingBuffer, PeekAndPopEntries_NoPreamble) {
+  PeekAndPopEntriesCycles(false);
+}
+
+TEST(PrefixedEntryRingBuffer, PeekAndPopEntries_UserPreamble) {
+  PeekAndPopEntriesCycles(true);
+}
+
+TEST(PrefixedEntryRingBuffer, PeekFrontEntries_SplitAtWrap) {
+  PrefixedEntryRingBuffer ring;
+  byte buffer[16];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 9> kFiller{};
+  ASSERT_EQ(ring.PushBack(kFiller), OkStatus());
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+
+  // The second entry's data wraps around the end of the buffer.
+  constexpr std::array<byte, 3> kFirst = {byte(1), byte(2), byte(3)};
+  constexpr std::array<byte, 4> kSecond = {byte(4), byte(5), byte(6), byte(7)};
+  ASSERT_EQ(ring.PushBack(kFirst), OkStatus());
+  ASSERT_EQ(ring.PushBack(kSecond), OkStatus());
+
+  EntryRun run;
+  ASSERT_EQ(ring.PeekFrontEntries(run), OkStatus());
+  EXPECT_EQ(run.entry_count(), 2u);
+  EXPECT_EQ(run.raw_data()[0].size(), 6u);
+  EXPECT_EQ(run.raw_data()[1].size(), 3u);
+
+  auto it = run.begin();
+  ASSERT_EQ(it->data[0].size(), kFirst.size());
+  EXPECT_TRUE(it->data[1].empty());
+  ++it;
+  ASSERT_EQ(it->data[0].size(), 1u);
+  ASSERT_EQ(it->data[1].size(), 3u);
+  EXPECT_EQ(it->data[0][0], byte(4));
+  EXPECT_EQ(it->data[1][2], byte(7));
+  ++it;
+  EXPECT_EQ(it, run.end());
+}
+
+TEST(PrefixedEntryRingBuffer, PeekFrontEntries_FrontEntryTooLarge) {
+  PrefixedEntryRingBuffer ring;
+  byte buffer[32];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 8> kData{};
+  ASSERT_EQ(ring.PushBack(kData), OkStatus());
+  EntryRun run;
+  EXPECT_EQ(ring.PeekFrontEntries(run, kData.size()),
+            Status::ResourceExhausted());
+  EXPECT_TRUE(run.empty());
+}
+
+TEST(PrefixedEntryRingBuffer, PopFrontEntries_StaleRun) {
+  PrefixedEntryRingBuffer ring;
+  byte buffer[32];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 4> kData{};
+  ASSERT_EQ(ring.PushBack(kData), OkStatus());
+  ASSERT_EQ(ring.PushBack(kData), OkStatus());
+
+  EntryRun run;
+  ASSERT_EQ(ring.PeekFrontEntries(run), OkStatus());
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+  EXPECT_EQ(ring.PopFrontEntries(run), Status::FailedPrecondition());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+}
+
+TEST(PrefixedEntryRingBufferMulti, PopFrontEntries_OtherReaderKeepsEntries) {
+  PrefixedEntryRingBufferMulti ring;
+  byte buffer[32];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Reader fast;
+  PrefixedEntryRingBufferMulti::Reader slow;
+  ASSERT_EQ(ring.AttachReader(fast), OkStatus());
+  ASSERT_EQ(ring.AttachReader(slow), OkStatus());
+
+  constexpr std::array<byte, 4> kData{};
+  ASSERT_EQ(ring.PushBack(kData), OkStatus());
+  ASSERT_EQ(ring.PushBack(kData), OkStatus());
+
+  EntryRun run;
+  ASSERT_EQ(fast.PeekFrontEntries(run), OkStatus());
+  ASSERT_EQ(fast.PopFrontEntries(run), OkStatus());
+  EXPECT_EQ(fast.EntryCount(), 0u);
+  EXPECT_EQ(slow.EntryCount(), 2u);
+  EXPECT_EQ(ring.TotalUsedBytes(), 2 * (kData.size() + 1));
+}
+
+
+using Reservation = PrefixedEntryRingBufferMulti::Reservation;
+
+TEST(PrefixedEntryRingBuffer, Reserve_VisibleAfterCommit) {
+  PrefixedEntryRingBuffer ring(true);
+  byte buffer[32];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 4> kData{byte{1}, byte{2}, byte{3}, byte{4}};
+  Reservation reservation;
+  ASSERT_EQ(ring.Reserve(kData.size(), reservation, 7), OkStatus());
+  EXPECT_EQ(reservation.size_bytes(), kData.size());
+  reservation.Write(kData);
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.TotalUsedBytes(), kData.size() + 2);
+
+  EXPECT_EQ(ring.Commit(reservation), 1u);
+  EXPECT_EQ(ring.EntryCount(), 1u);
+
+  std::array<byte, 4> data;
+  size_t bytes_read = 0;
+  uint32_t preamble = 0;
+  ASSERT_EQ(ring.PeekFrontWithPreamble(data, preamble, bytes_read),
+            OkStatus());
+  EXPECT_EQ(bytes_read, kData.size());
+  EXPECT_EQ(preamble, 7u);
+  EXPECT_EQ(data, kData);
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_NestedCommitsPublishInOrder) {
+  PrefixedEntryRingBuffer ring(true);
+  byte buffer[32];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 2> kData{};
+  Reservation outer;
+  Reservation inner;
+  ASSERT_EQ(ring.Reserve(kData.size(), outer, 1), OkStatus());
+  ASSERT_EQ(ring.Reserve(kData.size(), inner, 2), OkStatus());
+  inner.Write(kData);
+
+  // The inner entry is not published while the outer one is being written.
+  EXPECT_EQ(ring.Commit(inner), 0u);
+  EXPECT_EQ(ring.EntryCount(), 0u);
+
+  outer.Write(kData);
+  EXPECT_EQ(ring.Commit(outer), 2u);
+  EXPECT_EQ(ring.EntryCount(), 2u);
+
+  uint32_t preamble = 0;
+  std::array<byte, 2> data;
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFrontWithPreamble(data, preamble, bytes_read),
+            OkStatus());
+  EXPECT_EQ(preamble, 1u);
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+  ASSERT_EQ(ring.PeekFrontWithPreamble(data, preamble, bytes_read),
+            OkStatus());
+  EXPECT_EQ(preamble, 2u);
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_WrapsAroundBuffer) {
+  PrefixedEntryRingBuffer ring;
+  byte buffer[16];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 9> kFiller{};
+  ASSERT_EQ(ring.PushBack(kFiller), OkStatus());
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+
+  constexpr std::array<byte, 10> kData{byte{0},
+                                       byte{1},
+                                       byte{2},
+                                       byte{3},
+                                       byte{4},
+                                       byte{5},
+                                       byte{6},
+                                       byte{7},
+                                       byte{8},
+                                       byte{9}};
+  Reservation reservation;
+  ASSERT_EQ(ring.Reserve(kData.size(), reservation), OkStatus());
+  EXPECT_EQ(reservation.data()[0].size(), 5u);
+  EXPECT_EQ(reservation.data()[1].size(), 5u);
+  reservation.Write(kData);
+  EXPECT_EQ(ring.Commit(reservation), 1u);
+
+  std::array<byte, 10> data;
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFront(data, &bytes_read), OkStatus());
+  EXPECT_EQ(bytes_read, kData.size());
+  EXPECT_EQ(data, kData);
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_OpenReservationIsNotEvicted) {
+  PrefixedEntryRingBuffer ring;
+  byte buffer[16];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 4> kData{};
+  ASSERT_EQ(ring.PushBack(kData), OkStatus());
+
+  Reservation reservation;
+  ASSERT_EQ(ring.Reserve(kData.size(), reservation), OkStatus());
+
+  // Pushed entries are published after the open reservation, and pushing
+  // evicts committed entries but never the unpublished ones.
+  ASSERT_EQ(ring.PushBack(kData), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+  ASSERT_EQ(ring.PushBack(kData), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.PushBack(kData), Status::ResourceExhausted());
+
+  Reservation too_large;
+  EXPECT_EQ(ring.Reserve(sizeof(buffer), too_large), Status::OutOfRange());
+
+  EXPECT_EQ(ring.Commit(reservation), 3u);
+  EXPECT_EQ(ring.EntryCount(), 3u);
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_ClearKeepsOpenReservation) {
+  PrefixedEntryRingBuffer ring;
+  byte buffer[16];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 3> kData{byte{1}, byte{2}, byte{3}};
+  ASSERT_EQ(ring.PushBack(kData), OkStatus());
+
+  Reservation reservation;
+  ASSERT_EQ(ring.Reserve(kData.size(), reservation), OkStatus());
+  EXPECT_EQ(ring.Dering(), Status::FailedPrecondition());
+
+  ring.Clear();
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.TotalUsedBytes(), kData.size() + 1);
+
+  reservation.Write(kData);
+  EXPECT_EQ(ring.Commit(reservation), 1u);
+  EXPECT_EQ(ring.EntryCount(), 1u);
+
+  std::array<byte, 3> data;
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFront(data, &bytes_read), OkStatus());
+  EXPECT_EQ(data, kData);
+  EXPECT_EQ(ring.Dering(), OkStatus());
+}
+
+TEST(PrefixedEntryRingBufferMulti, Reserve_ReaderAttachedDuringReservation) {
+  PrefixedEntryRingBufferMulti ring;
+  byte buffer[16];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 3> kData{};
+  Reservation reservation;
+  ASSERT_EQ(ring.Reserve(kData.size(), reservation), OkStatus());
+
+  PrefixedEntryRingBufferMulti::Reader reader;
+  ASSERT_EQ(ring.AttachReader(reader), OkStatus());
+  EXPECT_EQ(reader.EntryCount(), 0u);
+  EXPECT_EQ(reader.EntriesSize(), 0u);
+
+  reservation.Write(kData);
+  EXPECT_EQ(ring.Commit(reservation), 1u);
+  EXPECT_EQ(reader.EntryCount(), 1u);
+  EXPECT_EQ(reader.EntriesSize(), kData.size() + 1);
+}
+
 }  // namespace
 }  // namespace ring_buffer
 }  // namespace pw
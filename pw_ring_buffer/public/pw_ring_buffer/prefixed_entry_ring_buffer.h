@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
@@ -44,6 +45,132 @@ class PrefixedEntryRingBufferMulti {
  public:
   typedef Status (*ReadOutput)(span<const std::byte>);
 
+  // A run of consecutive entries at the front of a reader, returned by
+  // Reader::PeekFrontEntries(). The entries are not copied: their raw bytes,
+  // including preambles, are held in at most two contiguous spans, split where
+  // the run wraps around the end of the ring buffer. Iterating over the run
+  // decodes each entry's preamble.
+  //
+  // A run refers to the ring buffer's memory, so it is only valid until the
+  // next push to or change of the ring buffer.
+  class EntryRun {
+   public:
+    // An entry in a run. The second data span is empty unless the entry's data
+    // wraps around the end of the ring buffer.
+    struct Entry {
+      std::array<span<const std::byte>, 2> data;
+      uint32_t preamble;
+
+      size_t size_bytes() const { return data[0].size() + data[1].size(); }
+    };
+
+    class iterator {
+     public:
+      iterator& operator++();
+      iterator operator++(int) {
+        iterator original = *this;
+        ++*this;
+        return original;
+      }
+
+      const Entry& operator*() const { return entry_; }
+      const Entry* operator->() const { return &entry_; }
+
+      constexpr bool operator==(const iterator& rhs) const {
+        return remaining_ == rhs.remaining_;
+      }
+
+      constexpr bool operator!=(const iterator& rhs) const {
+        return remaining_ != rhs.remaining_;
+      }
+
+     private:
+      friend EntryRun;
+
+      iterator(const EntryRun& run, size_t remaining)
+          : run_(&run),
+            offset_(0),
+            remaining_(remaining),
+            entry_bytes_(0),
+            entry_{} {
+        if (remaining_ != 0) {
+          Decode();
+        }
+      }
+
+      // Decodes the entry at offset_ into entry_.
+      void Decode();
+
+      const EntryRun* run_;
+      size_t offset_;
+      size_t remaining_;
+      size_t entry_bytes_;
+      Entry entry_;
+    };
+
+    constexpr EntryRun()
+        : raw_data_{}, entry_count_(0), user_preamble_(false) {}
+
+    // The raw bytes of the entries, including their preambles.
+    const std::array<span<const std::byte>, 2>& raw_data() const {
+      return raw_data_;
+    }
+
+    // Total size of the entries, including their preambles.
+    size_t size_bytes() const {
+      return raw_data_[0].size() + raw_data_[1].size();
+    }
+
+    size_t entry_count() const { return entry_count_; }
+
+    bool empty() const { return entry_count_ == 0; }
+
+    iterator begin() const { return iterator(*this, entry_count_); }
+    iterator end() const { return iterator(*this, 0); }
+
+   private:
+    friend PrefixedEntryRingBufferMulti;
+
+    // Copies raw bytes starting at an offset into the run, across the split.
+    void RawRead(std::byte* destination, size_t offset, size_t length) const;
+
+    // Returns the raw bytes at an offset into the run, split in two if they
+    // cross the split.
+    std::array<span<const std::byte>, 2> Slice(size_t offset,
+                                               size_t length) const;
+
+    std::array<span<const std::byte>, 2> raw_data_;
+    size_t entry_count_;
+    bool user_preamble_;
+  };
+
+  // Space for an entry's data, returned by Reserve(). The space is split in at
+  // most two spans, where it wraps around the end of the ring buffer. The
+  // entry is not visible to readers until it is committed with Commit().
+  class Reservation {
+   public:
+    constexpr Reservation() : data_{}, open_(false) {}
+
+    Reservation(const Reservation&) = delete;
+    Reservation& operator=(const Reservation&) = delete;
+
+    // The reserved space.
+    const std::array<span<std::byte>, 2>& data() const { return data_; }
+
+    size_t size_bytes() const { return data_[0].size() + data_[1].size(); }
+
+    // Copies data to the start of the reserved space.
+    //
+    // Precondition: data fits in the reserved space.
+    void Write(span<const std::byte> data);
+
+   private:
+    friend PrefixedEntryRingBufferMulti;
+
+    std::array<span<std::byte>, 2> data_;
+    bool open_;
+  };
+
   // A reader that provides a single-reader interface into the multi-reader ring
   // buffer it has been attached to via AttachReader(). Readers maintain their
   // read position in the ring buffer as well as the remaining count of entries
@@ -132,6 +259,36 @@ class PrefixedEntryRingBufferMulti {
     // OUT_OF_RANGE - No entries in ring buffer to pop.
     Status PopFront() { return buffer_->InternalPopFront(*this); }
 
+    // Peek a run of whole entries from the front, up to max_bytes including
+    // preambles, without copying them. If all of the reader's entries fit,
+    // the entries' preambles are not decoded.
+    //
+    // Precondition: the buffer data must not be corrupt, otherwise there will
+    // be a crash.
+    //
+    // Return values:
+    // OK - run_out holds at least one entry.
+    // FAILED_PRECONDITION - Buffer not initialized.
+    // OUT_OF_RANGE - No entries in ring buffer to read.
+    // RESOURCE_EXHAUSTED - The front entry is larger than max_bytes.
+    Status PeekFrontEntries(
+        EntryRun& run_out,
+        size_t max_bytes = std::numeric_limits<size_t>::max()) const {
+      return buffer_->InternalPeekFrontEntries(*this, run_out, max_bytes);
+    }
+
+    // Pop all of the entries in a run returned by PeekFrontEntries(), in one
+    // operation.
+    //
+    // Return values:
+    // OK - The entries were popped.
+    // FAILED_PRECONDITION - Buffer not initialized, or the run is no longer at
+    // the front of this reader because entries were popped since it was
+    // peeked.
+    Status PopFrontEntries(const EntryRun& run) {
+      return buffer_->InternalPopFrontEntries(*this, run);
+    }
+
     // Get the size in bytes of the next chunk, not including preamble, to be
     // read.
     //
@@ -262,7 +419,10 @@ class PrefixedEntryRingBufferMulti {
       : buffer_(nullptr),
         buffer_bytes_(0),
         write_idx_(0),
-        user_preamble_(user_preamble) {}
+        user_preamble_(user_preamble),
+        open_reservations_(0),
+        unpublished_entry_count_(0),
+        unpublished_bytes_(0) {}
 
   // Set the raw buffer to be used by the ring buffer.
   //
@@ -301,7 +461,8 @@ class PrefixedEntryRingBufferMulti {
   // buffer.
   Status DetachReader(Reader& reader);
 
-  // Removes all data from the ring buffer.
+  // Removes all data from the ring buffer. Entries with open reservations are
+  // kept, and become visible to readers once committed.
   void Clear();
 
   // Write a chunk of data to the ring buffer. If available space is less than
@@ -316,6 +477,7 @@ class PrefixedEntryRingBufferMulti {
   // OK - Data successfully written to the ring buffer.
   // FAILED_PRECONDITION - Buffer not initialized.
   // OUT_OF_RANGE - Size of data is greater than buffer size.
+  // RESOURCE_EXHAUSTED - Open reservations hold the space that is needed.
   Status PushBack(span<const std::byte> data, uint32_t user_preamble_data = 0) {
     return InternalPushBack(data, user_preamble_data, true);
   }
@@ -353,6 +515,43 @@ class PrefixedEntryRingBufferMulti {
     return TryPushBack(data, static_cast<uint32_t>(user_preamble_data));
   }
 
+  // Reserve space for an entry of size_bytes, in two phases: the caller fills
+  // the reserved space, then commits it with Commit(). Only Reserve() and
+  // Commit() need to be serialized with other calls, so the entry's data may
+  // be copied without holding the lock that protects the ring buffer. As with
+  // PushBack(), the oldest entries are discarded to make space.
+  //
+  // Reserved entries are made visible to readers in the order they were
+  // reserved, once every open reservation is committed. Entries pushed while a
+  // reservation is open are held back in the same way. Space held by entries
+  // that are not yet visible is never discarded, so reserving or pushing may
+  // fail with RESOURCE_EXHAUSTED if they take up the rest of the buffer.
+  //
+  // Preamble argument is a caller-provided value prepended to the front of the
+  // entry. It is only used if user_preamble was set at class construction
+  // time. It is varint-encoded and written when the space is reserved.
+  //
+  // Precondition: reservation_out is not open.
+  //
+  // Return values:
+  // OK - Space for the entry was reserved.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - Size of data is greater than buffer size.
+  // RESOURCE_EXHAUSTED - Open reservations hold the space that is needed.
+  Status Reserve(size_t size_bytes,
+                 Reservation& reservation_out,
+                 uint32_t user_preamble_data = 0) {
+    return InternalReserve(
+        size_bytes, reservation_out, user_preamble_data, true);
+  }
+
+  // Commit an entry reserved with Reserve(), once its space has been filled.
+  // Returns the number of entries made visible to readers, which is zero while
+  // an earlier reservation is still open.
+  //
+  // Precondition: reservation is open.
+  size_t Commit(Reservation& reservation);
+
   // Get the size in bytes of all the current entries in the ring buffer,
   // including preamble and data chunk.
   size_t TotalUsedBytes() const { return buffer_bytes_ - RawAvailableBytes(); }
@@ -367,7 +566,8 @@ class PrefixedEntryRingBufferMulti {
   //
   // Return values:
   // OK - Buffer data successfully deringed.
-  // FAILED_PRECONDITION - Buffer not initialized.
+  // FAILED_PRECONDITION - Buffer not initialized, or there are open
+  // reservations.
   Status Dering();
 
  private:
@@ -411,6 +611,17 @@ class PrefixedEntryRingBufferMulti {
   // OUT_OF_RANGE - No entries in ring buffer to pop.
   Status InternalPopFront(Reader& reader);
 
+  Status InternalPeekFrontEntries(const Reader& reader,
+                                  EntryRun& run_out,
+                                  size_t max_bytes) const;
+  Status InternalPopFrontEntries(Reader& reader, const EntryRun& run);
+
+  // Returns the offset into the buffer of a read or write index. Indices may
+  // be equal to the buffer size, which is the same as the start.
+  size_t BufferOffset(size_t index) const {
+    return index == buffer_bytes_ ? 0 : index;
+  }
+
   // Get the size in bytes of the next chunk, not including preamble, to be
   // read.
   size_t InternalFrontEntryDataSizeBytes(const Reader& reader) const;
@@ -449,6 +660,13 @@ class PrefixedEntryRingBufferMulti {
                           uint32_t user_preamble_data,
                           bool pop_front_if_needed);
 
+  // Reserve implementation, which optionally discards front elements to fit
+  // the incoming element.
+  Status InternalReserve(size_t size_bytes,
+                         Reservation& reservation_out,
+                         uint32_t user_preamble_data,
+                         bool pop_front_if_needed);
+
   // Internal function to pop all of the slowest readers. This function may pop
   // multiple readers if multiple are slow.
   //
@@ -505,6 +723,13 @@ class PrefixedEntryRingBufferMulti {
   size_t write_idx_;
   const bool user_preamble_;
 
+  // Reserved entries are not visible to readers until every open reservation
+  // is committed. Their bytes, which end at write_idx_, and their count are
+  // tracked until then.
+  size_t open_reservations_;
+  size_t unpublished_entry_count_;
+  size_t unpublished_bytes_;
+
   // List of attached readers.
   IntrusiveList<Reader> readers_;
 
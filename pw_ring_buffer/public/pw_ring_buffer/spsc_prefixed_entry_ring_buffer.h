@@ -0,0 +1,208 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace pw {
+namespace ring_buffer {
+
+// A single-producer, single-consumer ring buffer for arbitrary length data
+// entries, which needs no locks or interrupt masking. Entries have the same
+// format as in PrefixedEntryRingBufferMulti: an optional user preamble varint,
+// a varint of the data size, and the data.
+//
+// One context, such as an ISR, may call TryPushBack() while another context,
+// such as a thread, concurrently calls the consumer functions: PeekFront(),
+// PeekFrontPreamble(), FrontEntryDataSizeBytes(), PopFront(), and Clear().
+// Each side only writes its own index, with release ordering after it has
+// finished with the entry's bytes, and reads the other side's index with
+// acquire ordering. No read-modify-write atomics are used, so this also works
+// on cores without them.
+//
+// Unlike PrefixedEntryRingBufferMulti::PushBack(), the producer cannot evict
+// old entries to make room, since that would move the consumer's index. When
+// the buffer is full, TryPushBack() fails and the entry is dropped.
+class SpscPrefixedEntryRingBuffer {
+ public:
+  typedef Status (*ReadOutput)(span<const std::byte>);
+
+  constexpr SpscPrefixedEntryRingBuffer(bool user_preamble = false)
+      : buffer_(nullptr),
+        buffer_bytes_(0),
+        user_preamble_(user_preamble),
+        write_idx_(0),
+        read_idx_(0),
+        entries_pushed_(0),
+        entries_popped_(0) {}
+
+  SpscPrefixedEntryRingBuffer(const SpscPrefixedEntryRingBuffer&) = delete;
+  SpscPrefixedEntryRingBuffer& operator=(const SpscPrefixedEntryRingBuffer&) =
+      delete;
+
+  // Set the raw buffer to be used by the ring buffer. Must not be called
+  // concurrently with any other function.
+  //
+  // Return values:
+  // OK - successfully set the raw buffer.
+  // INVALID_ARGUMENT - Argument was nullptr, size zero, or too large.
+  Status SetBuffer(span<std::byte> buffer);
+
+  // Producer: Write a chunk of data to the ring buffer if there is space
+  // available.
+  //
+  // Preamble argument is a caller-provided value prepended to the front of the
+  // entry. It is only used if user_preamble was set at class construction
+  // time. It is varint-encoded before insertion into the buffer.
+  //
+  // Return values:
+  // OK - Data successfully written to the ring buffer.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - Size of data is greater than buffer size.
+  // RESOURCE_EXHAUSTED - The ring buffer doesn't have space for the data.
+  Status TryPushBack(span<const std::byte> data,
+                     uint32_t user_preamble_data = 0);
+
+  // Consumer: Read the oldest stored data chunk of data from the ring buffer
+  // to the provided destination span. The number of bytes read is written to
+  // bytes_read_out.
+  //
+  // Return values:
+  // OK - Data successfully read from the ring buffer.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - No entries in ring buffer to read.
+  // RESOURCE_EXHAUSTED - Destination data span was smaller number of
+  // bytes than the data size of the data chunk being read.  Available
+  // destination bytes were filled, remaining bytes of the data chunk were
+  // ignored.
+  // DATA_LOSS - The entry's preamble is corrupt.
+  Status PeekFront(span<std::byte> data, size_t* bytes_read_out) const;
+
+  // Consumer: Pass the oldest stored data chunk to output, in one or two
+  // pieces if it wraps around the end of the buffer.
+  Status PeekFront(ReadOutput output) const;
+
+  // Consumer: Peek the front entry's user preamble.
+  Status PeekFrontPreamble(uint32_t& user_preamble_out) const;
+
+  // Consumer: Pop and discard the oldest stored data chunk of data from the
+  // ring buffer.
+  //
+  // Return values:
+  // OK - Data successfully read from the ring buffer.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - No entries in ring buffer to pop.
+  // DATA_LOSS - The entry's preamble is corrupt.
+  Status PopFront();
+
+  // Consumer: Get the size in bytes of the next chunk, not including preamble,
+  // to be read. Returns 0 if there are no entries.
+  size_t FrontEntryDataSizeBytes() const;
+
+  // Consumer: Removes all data from the ring buffer.
+  void Clear();
+
+  // Get the number of entries currently in the ring buffer. If called
+  // concurrently with the other side, this is a snapshot that may already be
+  // out of date.
+  size_t EntryCount() const {
+    // Load the popped count first; the producer counts an entry before
+    // publishing it, so the pushed count loaded after is never behind.
+    const size_t popped = entries_popped_.load(std::memory_order_acquire);
+    return entries_pushed_.load(std::memory_order_acquire) - popped;
+  }
+
+  // Get the size in bytes of all the current entries in the ring buffer,
+  // including preamble and data chunk. Also a snapshot if called concurrently.
+  size_t TotalUsedBytes() const {
+    return UsedBytes(write_idx_.load(std::memory_order_acquire),
+                     read_idx_.load(std::memory_order_acquire));
+  }
+
+  // Returns total size of ring buffer in bytes.
+  size_t TotalSizeBytes() const { return buffer_bytes_; }
+
+ private:
+  struct EntryInfo {
+    size_t preamble_bytes;
+    uint32_t user_preamble;
+    size_t data_bytes;
+  };
+
+  // Decodes the preamble of the entry at the read index.
+  Status FrontEntryInfo(EntryInfo& info) const {
+    return EntryInfoAt(read_idx_.load(std::memory_order_relaxed), info);
+  }
+
+  // Decodes the preamble of the entry at the given index.
+  //
+  // Returns:
+  // OK - EntryInfo containing the next entry metadata.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - No entries in ring buffer.
+  // DATA_LOSS - Failed to read the metadata at this location.
+  Status EntryInfoAt(size_t read_idx, EntryInfo& info) const;
+
+  // Indices run from 0 to twice the buffer size, so that a full buffer can be
+  // told apart from an empty one.
+  size_t UsedBytes(size_t write_idx, size_t read_idx) const {
+    return write_idx >= read_idx ? write_idx - read_idx
+                                 : write_idx + 2 * buffer_bytes_ - read_idx;
+  }
+
+  size_t IncrementIndex(size_t index, size_t count) const {
+    index += count;
+    return index >= 2 * buffer_bytes_ ? index - 2 * buffer_bytes_ : index;
+  }
+
+  size_t BufferOffset(size_t index) const {
+    return index >= buffer_bytes_ ? index - buffer_bytes_ : index;
+  }
+
+  // Copy bytes to or from the ring buffer at the given index, handling
+  // wrap-around. No safety checks.
+  void RawWrite(size_t index, span<const std::byte> source);
+  void RawRead(std::byte* destination, size_t index, size_t length) const;
+
+  static_assert(std::atomic<size_t>::is_always_lock_free);
+
+  std::byte* buffer_;
+  size_t buffer_bytes_;
+  const bool user_preamble_;
+
+  // Written only by the producer.
+  std::atomic<size_t> write_idx_;
+  // Written only by the consumer.
+  std::atomic<size_t> read_idx_;
+
+  // Written only by the producer and consumer, respectively. The difference
+  // is the entry count; unsigned wrap-around keeps it correct. Both are only
+  // used for EntryCount().
+  std::atomic<size_t> entries_pushed_;
+  std::atomic<size_t> entries_popped_;
+
+  // Maximum buffer size allowed. Restricted so that twice the buffer size can
+  // be held in an index.
+  static constexpr size_t kMaxBufferBytes =
+      std::numeric_limits<size_t>::max() / 4;
+};
+
+}  // namespace ring_buffer
+}  // namespace pw
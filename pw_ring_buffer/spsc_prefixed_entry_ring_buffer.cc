@@ -0,0 +1,233 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_ring_buffer/spsc_prefixed_entry_ring_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+namespace pw {
+namespace ring_buffer {
+
+using std::byte;
+
+Status SpscPrefixedEntryRingBuffer::SetBuffer(span<byte> buffer) {
+  if ((buffer.data() == nullptr) ||  //
+      (buffer.size_bytes() == 0) ||  //
+      (buffer.size_bytes() > kMaxBufferBytes)) {
+    return Status::InvalidArgument();
+  }
+
+  buffer_ = buffer.data();
+  buffer_bytes_ = buffer.size_bytes();
+
+  write_idx_.store(0, std::memory_order_relaxed);
+  read_idx_.store(0, std::memory_order_relaxed);
+  entries_pushed_.store(0, std::memory_order_relaxed);
+  entries_popped_.store(0, std::memory_order_relaxed);
+  return OkStatus();
+}
+
+Status SpscPrefixedEntryRingBuffer::TryPushBack(span<const byte> data,
+                                                uint32_t user_preamble_data) {
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+
+  // Prepare a single buffer that can hold both the user preamble and entry
+  // length.
+  byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
+  size_t user_preamble_bytes = 0;
+  if (user_preamble_) {
+    user_preamble_bytes =
+        varint::Encode<uint32_t>(user_preamble_data, preamble_buf);
+  }
+  size_t length_bytes =
+      varint::Encode<uint32_t>(static_cast<uint32_t>(data.size_bytes()),
+                               span(preamble_buf).subspan(user_preamble_bytes));
+  size_t total_write_bytes =
+      user_preamble_bytes + length_bytes + data.size_bytes();
+  if (buffer_bytes_ < total_write_bytes) {
+    return Status::OutOfRange();
+  }
+
+  // Only the producer writes write_idx_. The acquire load of read_idx_ ensures
+  // the consumer is done with the bytes about to be overwritten.
+  const size_t write_idx = write_idx_.load(std::memory_order_relaxed);
+  const size_t read_idx = read_idx_.load(std::memory_order_acquire);
+  if (buffer_bytes_ - UsedBytes(write_idx, read_idx) < total_write_bytes) {
+    return Status::ResourceExhausted();
+  }
+
+  const size_t preamble_size = user_preamble_bytes + length_bytes;
+  RawWrite(write_idx, span(preamble_buf, preamble_size));
+  RawWrite(IncrementIndex(write_idx, preamble_size), data);
+
+  // Count the entry before publishing it, so the count never lags the pops.
+  entries_pushed_.store(entries_pushed_.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+  write_idx_.store(IncrementIndex(write_idx, total_write_bytes),
+                   std::memory_order_release);
+  return OkStatus();
+}
+
+Status SpscPrefixedEntryRingBuffer::PeekFront(span<byte> data,
+                                              size_t* bytes_read_out) const {
+  *bytes_read_out = 0;
+  EntryInfo info;
+  PW_TRY(FrontEntryInfo(info));
+
+  const size_t read_size = std::min(data.size_bytes(), info.data_bytes);
+  RawRead(data.data(),
+          IncrementIndex(read_idx_.load(std::memory_order_relaxed),
+                         info.preamble_bytes),
+          read_size);
+  *bytes_read_out = read_size;
+  return read_size == info.data_bytes ? OkStatus()
+                                      : Status::ResourceExhausted();
+}
+
+Status SpscPrefixedEntryRingBuffer::PeekFront(ReadOutput output) const {
+  EntryInfo info;
+  PW_TRY(FrontEntryInfo(info));
+
+  const size_t data_offset = BufferOffset(IncrementIndex(
+      read_idx_.load(std::memory_order_relaxed), info.preamble_bytes));
+  const size_t first_size =
+      std::min(info.data_bytes, buffer_bytes_ - data_offset);
+  PW_TRY(output(span(buffer_ + data_offset, first_size)));
+  if (first_size < info.data_bytes) {
+    PW_TRY(output(span(buffer_, info.data_bytes - first_size)));
+  }
+  return OkStatus();
+}
+
+Status SpscPrefixedEntryRingBuffer::PeekFrontPreamble(
+    uint32_t& user_preamble_out) const {
+  EntryInfo info;
+  PW_TRY(FrontEntryInfo(info));
+  user_preamble_out = info.user_preamble;
+  return OkStatus();
+}
+
+Status SpscPrefixedEntryRingBuffer::PopFront() {
+  EntryInfo info;
+  PW_TRY(FrontEntryInfo(info));
+
+  // Only the consumer writes read_idx_. The release store hands the entry's
+  // bytes back to the producer.
+  entries_popped_.store(entries_popped_.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+  read_idx_.store(IncrementIndex(read_idx_.load(std::memory_order_relaxed),
+                                 info.preamble_bytes + info.data_bytes),
+                  std::memory_order_release);
+  return OkStatus();
+}
+
+size_t SpscPrefixedEntryRingBuffer::FrontEntryDataSizeBytes() const {
+  EntryInfo info;
+  return FrontEntryInfo(info).ok() ? info.data_bytes : 0;
+}
+
+void SpscPrefixedEntryRingBuffer::Clear() {
+  if (buffer_ == nullptr) {
+    return;
+  }
+
+  // Walk the entries up to the producer's current position rather than
+  // jumping to it, so the popped count stays consistent with the entries
+  // skipped.
+  const size_t write_idx = write_idx_.load(std::memory_order_acquire);
+  size_t read_idx = read_idx_.load(std::memory_order_relaxed);
+  size_t popped = 0;
+  EntryInfo info;
+  while (read_idx != write_idx && EntryInfoAt(read_idx, info).ok()) {
+    read_idx = IncrementIndex(read_idx, info.preamble_bytes + info.data_bytes);
+    popped += 1;
+  }
+
+  entries_popped_.store(
+      entries_popped_.load(std::memory_order_relaxed) + popped,
+      std::memory_order_release);
+  read_idx_.store(read_idx, std::memory_order_release);
+}
+
+Status SpscPrefixedEntryRingBuffer::EntryInfoAt(size_t read_idx,
+                                                EntryInfo& info) const {
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+
+  // The acquire load of write_idx_ makes the producer's writes of the entry
+  // visible.
+  const size_t used =
+      UsedBytes(write_idx_.load(std::memory_order_acquire), read_idx);
+  if (used == 0) {
+    return Status::OutOfRange();
+  }
+
+  // Copy the preamble out in case it wraps around the end of the buffer.
+  byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
+  const size_t preamble_buf_size = std::min(sizeof(preamble_buf), used);
+  RawRead(preamble_buf, read_idx, preamble_buf_size);
+  span<const byte> preamble(preamble_buf, preamble_buf_size);
+
+  info.user_preamble = 0;
+  size_t user_preamble_bytes = 0;
+  if (user_preamble_) {
+    uint64_t user_preamble_data;
+    user_preamble_bytes = varint::Decode(preamble, &user_preamble_data);
+    if (user_preamble_bytes == 0u) {
+      return Status::DataLoss();
+    }
+    info.user_preamble = static_cast<uint32_t>(user_preamble_data);
+  }
+
+  uint64_t data_bytes;
+  const size_t length_bytes =
+      varint::Decode(preamble.subspan(user_preamble_bytes), &data_bytes);
+  if (length_bytes == 0u) {
+    return Status::DataLoss();
+  }
+
+  info.preamble_bytes = user_preamble_bytes + length_bytes;
+  if (data_bytes > used - info.preamble_bytes) {
+    return Status::DataLoss();
+  }
+  info.data_bytes = static_cast<size_t>(data_bytes);
+  return OkStatus();
+}
+
+void SpscPrefixedEntryRingBuffer::RawWrite(size_t index,
+                                           span<const byte> source) {
+  const size_t offset = BufferOffset(index);
+  const size_t first_size = std::min(source.size(), buffer_bytes_ - offset);
+  std::memcpy(buffer_ + offset, source.data(), first_size);
+  std::memcpy(buffer_, source.data() + first_size, source.size() - first_size);
+}
+
+void SpscPrefixedEntryRingBuffer::RawRead(byte* destination,
+                                          size_t index,
+                                          size_t length) const {
+  const size_t offset = BufferOffset(index);
+  const size_t first_size = std::min(length, buffer_bytes_ - offset);
+  std::memcpy(destination, buffer_ + offset, first_size);
+  std::memcpy(destination + first_size, buffer_, length - first_size);
+}
+
+}  // namespace ring_buffer
+}  // namespace pw
@@ -0,0 +1,244 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_ring_buffer/spsc_prefixed_entry_ring_buffer.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+#include "pw_unit_test/framework.h"
+
+using std::byte;
+
+namespace pw {
+namespace ring_buffer {
+namespace {
+
+TEST(SpscPrefixedEntryRingBuffer, NoBuffer) {
+  SpscPrefixedEntryRingBuffer ring;
+
+  byte buf[32];
+  size_t count;
+
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.SetBuffer(span<byte>(static_cast<byte*>(nullptr), 10u)),
+            Status::InvalidArgument());
+  EXPECT_EQ(ring.SetBuffer(span(buf, 0u)), Status::InvalidArgument());
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 0u);
+
+  EXPECT_EQ(ring.TryPushBack(buf), Status::FailedPrecondition());
+  EXPECT_EQ(ring.PeekFront(buf, &count), Status::FailedPrecondition());
+  EXPECT_EQ(count, 0u);
+  EXPECT_EQ(ring.PopFront(), Status::FailedPrecondition());
+  EXPECT_EQ(ring.EntryCount(), 0u);
+}
+
+TEST(SpscPrefixedEntryRingBuffer, EmptyBuffer) {
+  SpscPrefixedEntryRingBuffer ring;
+  byte buf[32];
+  ASSERT_EQ(ring.SetBuffer(buf), OkStatus());
+
+  size_t count;
+  EXPECT_EQ(ring.PeekFront(buf, &count), Status::OutOfRange());
+  EXPECT_EQ(ring.PopFront(), Status::OutOfRange());
+  EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+  EXPECT_EQ(ring.TotalSizeBytes(), sizeof(buf));
+}
+
+// Pushes and pops entries of varying size so that entries and preambles wrap
+// around the end of the buffer at every offset.
+void PushPopCycles(bool user_preamble) {
+  SpscPrefixedEntryRingBuffer ring(user_preamble);
+  byte buffer[37];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  std::array<byte, 12> data;
+  std::array<byte, 12> read_buffer;
+  for (uint32_t i = 0; i < 500; ++i) {
+    const size_t size = 1 + i % data.size();
+    for (size_t j = 0; j < size; ++j) {
+      data[j] = static_cast<byte>(i + j);
+    }
+
+    ASSERT_EQ(ring.TryPushBack(span(data).first(size), i * 1000), OkStatus());
+    EXPECT_EQ(ring.EntryCount(), 1u);
+    EXPECT_EQ(ring.TotalUsedBytes(),
+              size + 1 + (user_preamble ? (i * 1000 < 128     ? 1
+                                           : i * 1000 < 16384 ? 2
+                                                              : 3)
+                                        : 0));
+    EXPECT_EQ(ring.FrontEntryDataSizeBytes(), size);
+
+    uint32_t preamble = 1;
+    ASSERT_EQ(ring.PeekFrontPreamble(preamble), OkStatus());
+    EXPECT_EQ(preamble, user_preamble ? i * 1000 : 0u);
+
+    size_t bytes_read = 0;
+    ASSERT_EQ(ring.PeekFront(read_buffer, &bytes_read), OkStatus());
+    EXPECT_EQ(bytes_read, size);
+    EXPECT_EQ(std::memcmp(read_buffer.data(), data.data(), size), 0);
+
+    ASSERT_EQ(ring.PopFront(), OkStatus());
+    EXPECT_EQ(ring.EntryCount(), 0u);
+    EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+  }
+}
+
+TEST(SpscPrefixedEntryRingBuffer, PushPopCycles_NoPreamble) {
+  PushPopCycles(false);
+}
+
+TEST(SpscPrefixedEntryRingBuffer, PushPopCycles_UserPreamble) {
+  PushPopCycles(true);
+}
+
+TEST(SpscPrefixedEntryRingBuffer, Full_TryPushBackFails) {
+  SpscPrefixedEntryRingBuffer ring;
+  byte buffer[20];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 9> kData{};
+  ASSERT_EQ(ring.TryPushBack(kData), OkStatus());
+  ASSERT_EQ(ring.TryPushBack(kData), OkStatus());
+  EXPECT_EQ(ring.TotalUsedBytes(), sizeof(buffer));
+  EXPECT_EQ(ring.TryPushBack(span(kData).first(1)),
+            Status::ResourceExhausted());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+
+  std::array<byte, 20> too_big{};
+  EXPECT_EQ(ring.TryPushBack(too_big), Status::OutOfRange());
+
+  // Popping makes room again.
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+  EXPECT_EQ(ring.TryPushBack(kData), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 2u);
+}
+
+TEST(SpscPrefixedEntryRingBuffer, PeekFront_TooSmall) {
+  SpscPrefixedEntryRingBuffer ring;
+  byte buffer[32];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 4> kData = {byte(1), byte(2), byte(3), byte(4)};
+  ASSERT_EQ(ring.TryPushBack(kData), OkStatus());
+
+  std::array<byte, 2> read_buffer;
+  size_t bytes_read = 0;
+  EXPECT_EQ(ring.PeekFront(read_buffer, &bytes_read),
+            Status::ResourceExhausted());
+  EXPECT_EQ(bytes_read, 2u);
+  EXPECT_EQ(read_buffer[1], byte(2));
+}
+
+size_t output_pieces;
+std::array<byte, 16> output_data;
+size_t output_size;
+
+Status CollectOutput(span<const byte> data) {
+  output_pieces += 1;
+  std::memcpy(output_data.data() + output_size, data.data(), data.size());
+  output_size += data.size();
+  return OkStatus();
+}
+
+TEST(SpscPrefixedEntryRingBuffer, PeekFrontOutput_WrappedEntry) {
+  SpscPrefixedEntryRingBuffer ring;
+  byte buffer[16];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 9> kFirst{};
+  ASSERT_EQ(ring.TryPushBack(kFirst), OkStatus());
+  ASSERT_EQ(ring.PopFront(), OkStatus());
+
+  // Starts 10 bytes into the buffer, so the data wraps after 5 bytes.
+  constexpr std::array<byte, 8> kData = {
+      byte(1), byte(2), byte(3), byte(4), byte(5), byte(6), byte(7), byte(8)};
+  ASSERT_EQ(ring.TryPushBack(kData), OkStatus());
+
+  output_pieces = 0;
+  output_size = 0;
+  ASSERT_EQ(ring.PeekFront(CollectOutput), OkStatus());
+  EXPECT_EQ(output_pieces, 2u);
+  ASSERT_EQ(output_size, kData.size());
+  EXPECT_EQ(std::memcmp(output_data.data(), kData.data(), kData.size()), 0);
+}
+
+TEST(SpscPrefixedEntryRingBuffer, InterleavedPushAndPop) {
+  SpscPrefixedEntryRingBuffer ring(true);
+  byte buffer[64];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  uint32_t pushed = 0;
+  uint32_t popped = 0;
+  for (int round = 0; round < 100; ++round) {
+    // The producer fills the buffer in bursts; the consumer drains part of it.
+    while (ring.TryPushBack(as_bytes(span(&pushed, 1)), pushed).ok()) {
+      ++pushed;
+    }
+    for (int i = 0; i < 3 && ring.EntryCount() > 0u; ++i) {
+      uint32_t value;
+      size_t bytes_read;
+      ASSERT_EQ(ring.PeekFront(as_writable_bytes(span(&value, 1)), &bytes_read),
+                OkStatus());
+      uint32_t preamble;
+      ASSERT_EQ(ring.PeekFrontPreamble(preamble), OkStatus());
+      EXPECT_EQ(value, popped);
+      EXPECT_EQ(preamble, popped);
+      ASSERT_EQ(ring.PopFront(), OkStatus());
+      ++popped;
+    }
+    EXPECT_EQ(ring.EntryCount(), pushed - popped);
+  }
+}
+
+TEST(SpscPrefixedEntryRingBuffer, Clear) {
+  SpscPrefixedEntryRingBuffer ring;
+  byte buffer[32];
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+
+  constexpr std::array<byte, 3> kData{};
+  ASSERT_EQ(ring.TryPushBack(kData), OkStatus());
+  ASSERT_EQ(ring.TryPushBack(kData), OkStatus());
+  ring.Clear();
+  EXPECT_EQ(ring.EntryCount(), 0u);
+  EXPECT_EQ(ring.TotalUsedBytes(), 0u);
+  EXPECT_EQ(ring.PopFront(), Status::OutOfRange());
+
+  ASSERT_EQ(ring.TryPushBack(kData), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+}
+
+TEST(SpscPrefixedEntryRingBuffer, SameFormatAsPrefixedEntryRingBuffer) {
+  constexpr std::array<byte, 5> kData = {
+      byte(1), byte(2), byte(3), byte(4), byte(5)};
+
+  byte spsc_buffer[16] = {};
+  SpscPrefixedEntryRingBuffer spsc(true);
+  ASSERT_EQ(spsc.SetBuffer(spsc_buffer), OkStatus());
+  ASSERT_EQ(spsc.TryPushBack(kData, 300), OkStatus());
+
+  byte buffer[16] = {};
+  PrefixedEntryRingBuffer ring(true);
+  ASSERT_EQ(ring.SetBuffer(buffer), OkStatus());
+  ASSERT_EQ(ring.TryPushBack(kData, 300), OkStatus());
+
+  EXPECT_EQ(std::memcmp(spsc_buffer, buffer, sizeof(buffer)), 0);
+}
+
+}  // namespace
+}  // namespace ring_buffer
+}  // namespace pw
@@ -13,12 +13,18 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
 #include "pw_metric/metric.h"
 #include "pw_router/egress.h"
 #include "pw_router/packet_parser.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 
 namespace pw::router {
 
@@ -37,8 +43,43 @@ class StaticRouter {
     Egress& egress;
   };
 
+  // A routing table indexed by address, for addresses in the range
+  // [0, kAddressCount). Looking up a route takes constant time, regardless of
+  // the number of routes. The table can be built at compile time from a list of
+  // routes:
+  //
+  //   constexpr StaticRouter::Route kRoutes[] = {{1, uart}, {7, ble}};
+  //   constexpr StaticRouter::RouteTable<8> kTable(kRoutes);
+  //   StaticRouter router(kTable);
+  //
+  // Each address must be less than kAddressCount and appear only once.
+  template <size_t kAddressCount>
+  class RouteTable {
+   public:
+    template <size_t kNumRoutes>
+    constexpr RouteTable(const Route (&routes)[kNumRoutes]) : egresses_() {
+      for (const Route& route : routes) {
+        PW_ASSERT(route.address < kAddressCount);
+        PW_ASSERT(egresses_[route.address] == nullptr);
+        egresses_[route.address] = &route.egress;
+      }
+    }
+
+    constexpr span<Egress* const> egresses() const { return egresses_; }
+
+   private:
+    std::array<Egress*, kAddressCount> egresses_;
+  };
+
+  // Routes packets by searching the list of routes for their address.
   StaticRouter(span<const Route> routes) : routes_(routes) {}
 
+  // Routes packets by indexing a RouteTable with their address. The table must
+  // outlive the router.
+  template <size_t kAddressCount>
+  StaticRouter(const RouteTable<kAddressCount>& table)
+      : table_(table.egresses()) {}
+
   StaticRouter(const StaticRouter&) = delete;
   StaticRouter(StaticRouter&&) = delete;
   StaticRouter& operator=(const StaticRouter&) = delete;
@@ -61,8 +102,18 @@ class StaticRouter {
   //
   Status RoutePacket(ConstByteSpan packet, PacketParser& parser);
 
+  // Routes a batch of packets, each as if by RoutePacket(). All packets are
+  // routed, even if some of them fail. Returns the number of packets sent
+  // successfully, with OK if all packets were sent or the status of the first
+  // packet that was not.
+  StatusWithSize RoutePackets(span<const ConstByteSpan> packets,
+                              PacketParser& parser);
+
  private:
+  Egress* FindEgress(uint32_t address) const;
+
   const span<const Route> routes_;
+  const span<Egress* const> table_;
   PW_METRIC_GROUP(metrics_, "static_router");
   PW_METRIC(metrics_, parser_errors_, "parser_errors", 0u);
   PW_METRIC(metrics_, route_errors_, "route_errors", 0u);
@@ -30,15 +30,13 @@ Status StaticRouter::RoutePacket(ConstByteSpan packet, PacketParser& parser) {
     return Status::DataLoss();
   }
 
-  auto route = std::find_if(routes_.begin(), routes_.end(), [&](auto r) {
-    return r.address == *maybe_address;
-  });
-  if (route == routes_.end()) {
+  Egress* egress = FindEgress(*maybe_address);
+  if (egress == nullptr) {
     route_errors_.Increment();
     return Status::NotFound();
   }
 
-  if (Status status = route->egress.SendPacket(packet, parser); !status.ok()) {
+  if (Status status = egress->SendPacket(packet, parser); !status.ok()) {
     egress_errors_.Increment();
     return Status::Unavailable();
   }
@@ -46,4 +44,29 @@ Status StaticRouter::RoutePacket(ConstByteSpan packet, PacketParser& parser) {
   return OkStatus();
 }
 
+StatusWithSize StaticRouter::RoutePackets(span<const ConstByteSpan> packets,
+                                          PacketParser& parser) {
+  Status first_error;
+  size_t sent = 0;
+  for (ConstByteSpan packet : packets) {
+    if (Status status = RoutePacket(packet, parser); status.ok()) {
+      ++sent;
+    } else {
+      first_error.Update(status);
+    }
+  }
+  return StatusWithSize(first_error, sent);
+}
+
+Egress* StaticRouter::FindEgress(uint32_t address) const {
+  if (!table_.empty()) {
+    return address < table_.size() ? table_[address] : nullptr;
+  }
+
+  auto route = std::find_if(routes_.begin(), routes_.end(), [&](auto r) {
+    return r.address == address;
+  });
+  return route != routes_.end() ? &route->egress : nullptr;
+}
+
 }  // namespace pw::router
@@ -147,5 +147,76 @@ TEST(StaticRouter, RoutePacket_TracksNumberOfDrops) {
   EXPECT_EQ(router.dropped_packets(), 3u);
 }
 
+TEST(StaticRouter, RouteTable_RoutesToAnEgress) {
+  BasicPacketParser parser;
+  static constexpr StaticRouter::Route routes[] = {{1, GoodEgress},
+                                                   {2, BadEgress}};
+  static constexpr StaticRouter::RouteTable<4> table(routes);
+  StaticRouter router(table);
+
+  EXPECT_EQ(router.RoutePacket(BasicPacket(1, 0xdddd).data(), parser),
+            OkStatus());
+  EXPECT_EQ(router.RoutePacket(BasicPacket(2, 0xdddd).data(), parser),
+            Status::Unavailable());
+}
+
+TEST(StaticRouter, RouteTable_ReturnsNotFoundOnInvalidRoute) {
+  BasicPacketParser parser;
+  static constexpr StaticRouter::Route routes[] = {{1, GoodEgress},
+                                                   {2, BadEgress}};
+  static constexpr StaticRouter::RouteTable<4> table(routes);
+  StaticRouter router(table);
+
+  EXPECT_EQ(router.RoutePacket(BasicPacket(0, 0xdddd).data(), parser),
+            Status::NotFound());
+  EXPECT_EQ(router.RoutePacket(BasicPacket(3, 0xdddd).data(), parser),
+            Status::NotFound());
+  EXPECT_EQ(router.RoutePacket(BasicPacket(42, 0xdddd).data(), parser),
+            Status::NotFound());
+  EXPECT_EQ(router.dropped_packets(), 3u);
+}
+
+TEST(StaticRouter, RoutePackets_RoutesAllPackets) {
+  int sent = 0;
+  EgressFunction counting_egress([&sent](ConstByteSpan, const PacketParser&) {
+    ++sent;
+    return OkStatus();
+  });
+  StaticRouter::Route routes[] = {{1, counting_egress}};
+  StaticRouter router(routes);
+  BasicPacketParser parser;
+
+  const BasicPacket packets[] = {BasicPacket(1, 0xaaaa),
+                                 BasicPacket(1, 0xbbbb),
+                                 BasicPacket(1, 0xcccc)};
+  const ConstByteSpan batch[] = {
+      packets[0].data(), packets[1].data(), packets[2].data()};
+
+  const StatusWithSize result = router.RoutePackets(batch, parser);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 3u);
+  EXPECT_EQ(sent, 3);
+}
+
+TEST(StaticRouter, RoutePackets_ReturnsFirstError) {
+  BasicPacketParser parser;
+  constexpr StaticRouter::Route routes[] = {{1, GoodEgress}, {2, BadEgress}};
+  StaticRouter router(routes);
+
+  const BasicPacket packets[] = {BasicPacket(1, 0xdddd),
+                                 BasicPacket(42, 0xdddd),
+                                 BasicPacket(2, 0xdddd),
+                                 BasicPacket(1, 0xdddd)};
+  const ConstByteSpan batch[] = {packets[0].data(),
+                                 packets[1].data(),
+                                 packets[2].data(),
+                                 packets[3].data()};
+
+  const StatusWithSize result = router.RoutePackets(batch, parser);
+  EXPECT_EQ(result.status(), Status::NotFound());
+  EXPECT_EQ(result.size(), 2u);
+  EXPECT_EQ(router.dropped_packets(), 2u);
+}
+
 }  // namespace
 }  // namespace pw::router
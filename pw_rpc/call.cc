@@ -152,10 +152,10 @@ void Call::MoveFrom(Call& other) {
   on_error_ = std::move(other.on_error_);
   on_next_ = std::move(other.on_next_);
 
-  // Mark the other call inactive, unregister it, and register this one.
+  // Unregister the other call, mark it inactive, and register this one.
+  endpoint().UnregisterCall(other);
   other.MarkClosed();
 
-  endpoint().UnregisterCall(other);
   endpoint().RegisterUniqueCall(*this);
 }
 
@@ -119,9 +119,9 @@ TEST_F(ServerWriterTest, DefaultConstruct_Closed) {
 
 TEST_F(ServerWriterTest, Construct_RegistersWithServer) {
   RpcLockGuard lock;
-  IntrusiveList<Call>::iterator call = context_.server().FindCall(kPacket);
-  ASSERT_NE(call, context_.server().calls_end());
-  EXPECT_EQ(static_cast<void*>(&*call), static_cast<void*>(&writer_));
+  Call* call = context_.server().FindCall(kPacket);
+  ASSERT_NE(call, nullptr);
+  EXPECT_EQ(static_cast<void*>(call), static_cast<void*>(&writer_));
 }
 
 TEST_F(ServerWriterTest, Destruct_RemovesFromServer) {
@@ -135,13 +135,13 @@ TEST_F(ServerWriterTest, Destruct_RemovesFromServer) {
   }
 
   RpcLockGuard lock;
-  EXPECT_EQ(context_.server().FindCall(kPacket), context_.server().calls_end());
+  EXPECT_EQ(context_.server().FindCall(kPacket), nullptr);
 }
 
 TEST_F(ServerWriterTest, Finish_RemovesFromServer) {
   EXPECT_EQ(OkStatus(), writer_.Finish());
   RpcLockGuard lock;
-  EXPECT_EQ(context_.server().FindCall(kPacket), context_.server().calls_end());
+  EXPECT_EQ(context_.server().FindCall(kPacket), nullptr);
 }
 
 TEST_F(ServerWriterTest, Finish_SendsResponse) {
@@ -26,6 +26,7 @@
 #include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/encoding_buffer.h"
 #include "pw_rpc/internal/packet.pwpb.h"
+#include "pw_rpc/latency.h"
 
 using pw::rpc::internal::pwpb::RpcPacket::Fields;
 
@@ -47,26 +48,41 @@ Status OverwriteChannelId(ByteSpan rpc_packet, uint32_t channel_id_under_128) {
 }
 
 Status ChannelBase::Send(const Packet& packet) {
-  ByteSpan buffer = encoding_buffer.GetPacketBuffer(packet.payload().size());
+  PW_CHECK_NOTNULL(output_);
+  const Status status = output_->EncodeAndSend(packet);
+  if (status.ok() && packet.destination() == Packet::kClient) {
+    RecordLatency(LatencyStage::kResponseSent, packet);
+  }
+  return status;
+}
+
+}  // namespace internal
+
+Status ChannelOutput::EncodeAndSend(const internal::Packet& packet) {
+  ByteSpan buffer =
+      internal::encoding_buffer.GetPacketBuffer(packet.payload().size());
   Result encoded = packet.Encode(buffer);
 
   if (!encoded.ok()) {
-    encoding_buffer.Release();
+    internal::encoding_buffer.Release();
     PW_LOG_ERROR(
         "Failed to encode RPC packet type %u to channel %u buffer, status %u",
         static_cast<unsigned>(packet.type()),
-        static_cast<unsigned>(id()),
+        static_cast<unsigned>(packet.channel_id()),
         encoded.status().code());
     return Status::Internal();
   }
 
-  PW_CHECK_NOTNULL(output_);
-  Status sent = output_->Send(encoded.value());
-  encoding_buffer.Release();
+  if (packet.destination() == internal::Packet::kClient) {
+    internal::RecordLatency(LatencyStage::kResponseEncoded, packet);
+  }
+
+  Status sent = Send(encoded.value());
+  internal::encoding_buffer.Release();
 
   if (!sent.ok()) {
     PW_LOG_DEBUG("Channel %u failed to send packet with status %u",
-                 static_cast<unsigned>(id()),
+                 static_cast<unsigned>(packet.channel_id()),
                  sent.code());
 
     return Status::Unknown();
@@ -74,8 +90,6 @@ Status ChannelBase::Send(const Packet& packet) {
   return OkStatus();
 }
 
-}  // namespace internal
-
 Result<uint32_t> ExtractChannelId(ConstByteSpan packet) {
   protobuf::Decoder decoder(packet);
 
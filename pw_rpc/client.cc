@@ -33,10 +33,13 @@ using internal::pwpb::PacketType;
 
 Status Client::ProcessPacket(ConstByteSpan data) {
   PW_TRY_ASSIGN(Packet packet, Endpoint::ProcessPacket(data, Packet::kClient));
+  return ProcessPacket(packet);
+}
 
+Status Client::ProcessPacket(internal::Packet packet) {
   // Find an existing call for this RPC, if any.
   internal::rpc_lock().lock();
-  IntrusiveList<internal::Call>::iterator call = FindCall(packet);
+  internal::Call* call = FindCall(packet);
 
   internal::ChannelBase* channel = GetInternalChannel(packet.channel_id());
 
@@ -47,7 +50,7 @@ Status Client::ProcessPacket(ConstByteSpan data) {
     return Status::Unavailable();
   }
 
-  if (call == calls_end()) {
+  if (call == nullptr) {
     // The call for the packet does not exist. If the packet is a server stream
     // message, notify the server so that it can kill the stream. Otherwise,
     // silently drop the packet (as it would terminate the RPC anyway).
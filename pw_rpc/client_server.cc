@@ -14,16 +14,20 @@
 
 #include "pw_rpc/client_server.h"
 
+#include "pw_rpc/internal/packet.h"
+#include "pw_status/try.h"
+
 namespace pw::rpc {
 
-Status ClientServer::ProcessPacket(ConstByteSpan packet) {
-  Status status = server_.ProcessPacket(packet);
-  if (status.IsInvalidArgument()) {
-    // INVALID_ARGUMENT indicates the packet is intended for a client.
-    status = client_.ProcessPacket(packet);
-  }
+Status ClientServer::ProcessPacket(ConstByteSpan packet_data) {
+  // Decode the packet once, rather than once for each endpoint it is offered
+  // to.
+  PW_TRY_ASSIGN(internal::Packet packet, Server::DecodePacket(packet_data));
 
-  return status;
+  if (packet.destination() == internal::Packet::kServer) {
+    return server_.ProcessPacket(packet);
+  }
+  return client_.ProcessPacket(packet);
 }
 
 }  // namespace pw::rpc
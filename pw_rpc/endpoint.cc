@@ -20,6 +20,7 @@
 
 #include "pw_log/log.h"
 #include "pw_rpc/internal/lock.h"
+#include "pw_status/try.h"
 
 #if PW_RPC_YIELD_MODE == PW_RPC_YIELD_MODE_BUSY_LOOP
 
@@ -87,6 +88,16 @@ void YieldRpcLock() {
 
 Result<Packet> Endpoint::ProcessPacket(span<const std::byte> data,
                                        Packet::Destination destination) {
+  PW_TRY_ASSIGN(Packet packet, DecodePacket(data));
+
+  if (packet.destination() != destination) {
+    return Status::InvalidArgument();
+  }
+
+  return packet;
+}
+
+Result<Packet> Endpoint::DecodePacket(span<const std::byte> data) {
   Result<Packet> result = Packet::FromBuffer(data);
 
   if (!result.ok()) {
@@ -102,33 +113,36 @@ Result<Packet> Endpoint::ProcessPacket(span<const std::byte> data,
     return Status::DataLoss();
   }
 
-  if (packet.destination() != destination) {
-    return Status::InvalidArgument();
-  }
-
   return result;
 }
 
 void Endpoint::RegisterCall(Call& new_call) {
+  IntrusiveList<Call>& bucket = CallBucket(new_call);
+
   // Mark any exisitng duplicate calls as cancelled.
-  auto [before_call, call] = FindIteratorsForCall(new_call);
-  if (call != calls_.end()) {
-    CloseCallAndMarkForCleanup(before_call, call, Status::Cancelled());
+  auto [before_call, call] = FindIteratorsForCall(bucket,
+                                                  new_call.channel_id_locked(),
+                                                  new_call.service_id(),
+                                                  new_call.method_id(),
+                                                  new_call.id());
+  if (call != bucket.end()) {
+    CloseCallAndMarkForCleanup(bucket, before_call, call, Status::Cancelled());
   }
 
   // Register the new call.
-  calls_.push_front(new_call);
+  bucket.push_front(new_call);
 }
 
 std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-Endpoint::FindIteratorsForCall(uint32_t channel_id,
+Endpoint::FindIteratorsForCall(IntrusiveList<Call>& bucket,
+                               uint32_t channel_id,
                                uint32_t service_id,
                                uint32_t method_id,
                                uint32_t call_id) {
-  auto previous = calls_.before_begin();
-  auto call = calls_.begin();
+  auto previous = bucket.before_begin();
+  auto call = bucket.begin();
 
-  while (call != calls_.end()) {
+  while (call != bucket.end()) {
     if (channel_id == call->channel_id_locked() &&
         service_id == call->service_id() && method_id == call->method_id()) {
       if (call_id == call->id() || call_id == kOpenCallId ||
@@ -172,17 +186,19 @@ Status Endpoint::CloseChannel(uint32_t channel_id) {
 }
 
 void Endpoint::AbortCalls(AbortIdType type, uint32_t id) {
-  auto previous = calls_.before_begin();
-  auto current = calls_.begin();
-
-  while (current != calls_.end()) {
-    if (id == (type == AbortIdType::kChannel ? current->channel_id_locked()
-                                             : current->service_id())) {
-      current =
-          CloseCallAndMarkForCleanup(previous, current, Status::Aborted());
-    } else {
-      previous = current;
-      ++current;
+  for (IntrusiveList<Call>& bucket : calls_) {
+    auto previous = bucket.before_begin();
+    auto current = bucket.begin();
+
+    while (current != bucket.end()) {
+      if (id == (type == AbortIdType::kChannel ? current->channel_id_locked()
+                                               : current->service_id())) {
+        current = CloseCallAndMarkForCleanup(
+            bucket, previous, current, Status::Aborted());
+      } else {
+        previous = current;
+        ++current;
+      }
     }
   }
 }
@@ -216,9 +232,11 @@ void Endpoint::RemoveAllCalls() {
 
   // Close all calls without invoking on_error callbacks, since the calls should
   // have been closed before the Endpoint was deleted.
-  while (!calls_.empty()) {
-    calls_.front().CloseFromDeletedEndpoint();
-    calls_.pop_front();
+  for (IntrusiveList<Call>& bucket : calls_) {
+    while (!bucket.empty()) {
+      bucket.front().CloseFromDeletedEndpoint();
+      bucket.pop_front();
+    }
   }
   while (!to_cleanup_.empty()) {
     to_cleanup_.front().CloseFromDeletedEndpoint();
@@ -0,0 +1,63 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/latency.h"
+
+#if PW_RPC_LATENCY_TRACING
+
+#include <atomic>
+
+#include "pw_rpc/internal/packet.pwpb.h"
+
+namespace pw::rpc {
+namespace {
+
+std::atomic<LatencyObserver*> latency_observer{nullptr};
+
+}  // namespace
+
+void SetLatencyObserver(LatencyObserver* observer) {
+  latency_observer.store(observer, std::memory_order_release);
+}
+
+void RecordFrameReceived() {
+  LatencyObserver* observer =
+      latency_observer.load(std::memory_order_acquire);
+  if (observer != nullptr) {
+    observer->OnLatencyEvent({LatencyStage::kFrameReceived, 0, 0, 0, 0, false});
+  }
+}
+
+namespace internal {
+
+void RecordLatency(LatencyStage stage, const Packet& packet) {
+  LatencyObserver* observer =
+      latency_observer.load(std::memory_order_acquire);
+  if (observer == nullptr) {
+    return;
+  }
+  const bool final_packet = packet.type() == pwpb::PacketType::RESPONSE ||
+                            packet.type() == pwpb::PacketType::SERVER_ERROR;
+  observer->OnLatencyEvent({stage,
+                            packet.channel_id(),
+                            packet.service_id(),
+                            packet.method_id(),
+                            packet.call_id(),
+                            final_packet});
+}
+
+}  // namespace internal
+}  // namespace pw::rpc
+
+#endif  // PW_RPC_LATENCY_TRACING
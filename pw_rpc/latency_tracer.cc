@@ -0,0 +1,207 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/latency_tracer.h"
+
+#include <chrono>
+#include <limits>
+#include <mutex>
+
+#include "pw_trace/trace.h"
+
+namespace pw::rpc {
+namespace {
+
+using chrono::SystemClock;
+
+uint32_t Microseconds(SystemClock::duration duration) {
+  const auto us =
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  if (us <= 0) {
+    return 0;
+  }
+  if (static_cast<uint64_t>(us) > std::numeric_limits<uint32_t>::max()) {
+    return std::numeric_limits<uint32_t>::max();
+  }
+  return static_cast<uint32_t>(us);
+}
+
+void TraceStage(const LatencyEvent& event) {
+  switch (event.stage) {
+    case LatencyStage::kFrameReceived:
+      PW_TRACE_INSTANT("RPC frame received", "pw_rpc");
+      break;
+    case LatencyStage::kPacketDecoded:
+      PW_TRACE_INSTANT("RPC packet decoded", "pw_rpc", event.call_id);
+      break;
+    case LatencyStage::kHandlerEntered:
+      PW_TRACE_START("RPC handler", "pw_rpc", event.call_id);
+      break;
+    case LatencyStage::kHandlerExited:
+      PW_TRACE_END("RPC handler", "pw_rpc", event.call_id);
+      break;
+    case LatencyStage::kResponseEncoded:
+      PW_TRACE_INSTANT("RPC response encoded", "pw_rpc", event.call_id);
+      break;
+    case LatencyStage::kResponseSent:
+      PW_TRACE_INSTANT("RPC response sent", "pw_rpc", event.call_id);
+      break;
+  }
+}
+
+}  // namespace
+
+LatencyTracer::MethodLatency::MethodLatency(uint32_t service, uint32_t method)
+    : service_id(service), method_id(method), group(method) {
+  service_id_metric.Set(service);
+}
+
+void LatencyTracer::OnLatencyEvent(const LatencyEvent& event) {
+  const SystemClock::time_point now = SystemClock::now();
+  TraceStage(event);
+
+  std::lock_guard lock(lock_);
+  switch (event.stage) {
+    case LatencyStage::kFrameReceived:
+      frame_received_ = now;
+      break;
+    case LatencyStage::kPacketDecoded:
+      if (frame_received_.has_value()) {
+        receive_us_.Record(Microseconds(now - *frame_received_));
+      }
+      packet_start_ = frame_received_.value_or(now);
+      packet_decoded_ = now;
+      frame_received_.reset();
+      break;
+    case LatencyStage::kHandlerEntered:
+      StartCall(event, now);
+      break;
+    case LatencyStage::kHandlerExited:
+      EndHandler(event, now);
+      break;
+    case LatencyStage::kResponseEncoded:
+      response_encoded_ = now;
+      break;
+    case LatencyStage::kResponseSent:
+      ResponseSent(event, now);
+      break;
+  }
+}
+
+LatencyTracer::MethodLatency* LatencyTracer::FindOrAddMethod(
+    uint32_t service_id, uint32_t method_id) {
+  for (MethodLatency& method : methods_) {
+    if (method.service_id == service_id && method.method_id == method_id) {
+      return &method;
+    }
+  }
+  if (methods_.full()) {
+    return nullptr;
+  }
+  methods_.emplace_back(service_id, method_id);
+  MethodLatency& method = methods_.back();
+  metrics_.Add(method.group);
+  return &method;
+}
+
+LatencyTracer::CallTimeline* LatencyTracer::FindCall(
+    const LatencyEvent& event) {
+  for (CallTimeline& call : calls_) {
+    if (call.method != nullptr && call.channel_id == event.channel_id &&
+        call.call_id == event.call_id &&
+        call.method->service_id == event.service_id &&
+        call.method->method_id == event.method_id) {
+      return &call;
+    }
+  }
+  return nullptr;
+}
+
+void LatencyTracer::StartCall(const LatencyEvent& event,
+                              SystemClock::time_point now) {
+  // The request is the last packet decoded.
+  SystemClock::time_point start = now;
+  if (packet_decoded_.has_value()) {
+    dispatch_us_.Record(Microseconds(now - *packet_decoded_));
+    start = packet_start_;
+    packet_decoded_.reset();
+  }
+
+  MethodLatency* method = FindOrAddMethod(event.service_id, event.method_id);
+  if (method == nullptr) {
+    untracked_.Increment();
+    return;
+  }
+
+  // A request for an active call replaces it, so reuse its slot.
+  CallTimeline* call = FindCall(event);
+  if (call == nullptr) {
+    for (CallTimeline& free_call : calls_) {
+      if (free_call.method == nullptr) {
+        call = &free_call;
+        break;
+      }
+    }
+  }
+  if (call == nullptr) {
+    untracked_.Increment();
+    return;
+  }
+
+  call->method = method;
+  call->channel_id = event.channel_id;
+  call->call_id = event.call_id;
+  call->start = start;
+  call->handler_entered = now;
+  call->in_handler = true;
+  call->responded = false;
+}
+
+void LatencyTracer::EndHandler(const LatencyEvent& event,
+                               SystemClock::time_point now) {
+  CallTimeline* call = FindCall(event);
+  if (call == nullptr || !call->in_handler) {
+    return;
+  }
+  call->method->handler_us.Record(Microseconds(now - call->handler_entered));
+  call->in_handler = false;
+
+  // Synchronous handlers respond before they return.
+  if (call->responded) {
+    call->method = nullptr;
+  }
+}
+
+void LatencyTracer::ResponseSent(const LatencyEvent& event,
+                                 SystemClock::time_point now) {
+  if (response_encoded_.has_value()) {
+    egress_us_.Record(Microseconds(now - *response_encoded_));
+    response_encoded_.reset();
+  }
+  if (!event.final_packet) {
+    return;
+  }
+
+  CallTimeline* call = FindCall(event);
+  if (call == nullptr || call->responded) {
+    return;
+  }
+  call->method->total_us.Record(Microseconds(now - call->start));
+  call->responded = true;
+  if (!call->in_handler) {
+    call->method = nullptr;
+  }
+}
+
+}  // namespace pw::rpc
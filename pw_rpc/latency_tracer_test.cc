@@ -0,0 +1,231 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/latency_tracer.h"
+
+#include <cstdint>
+
+#include "pw_tokenizer/tokenize.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::rpc {
+namespace {
+
+constexpr uint32_t kChannelId = 1;
+constexpr uint32_t kServiceId = 16;
+constexpr uint32_t kMethodId = 101;
+
+constexpr metric::Token kReceiveUs =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "receive_us");
+constexpr metric::Token kDispatchUs =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "dispatch_us");
+constexpr metric::Token kEgressUs =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "egress_us");
+constexpr metric::Token kHandlerUs =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "handler_us");
+constexpr metric::Token kTotalUs =
+    PW_TOKENIZE_STRING_DOMAIN("metrics", "total_us");
+constexpr metric::Token kUntracked =
+    PW_TOKENIZE_STRING_MASK("metrics", _PW_METRIC_TOKEN_MASK, "untracked");
+
+const metric::Group* FindGroup(const metric::Group& parent,
+                               metric::Token name) {
+  for (const metric::Group& child : parent.children()) {
+    if (child.name() == name) {
+      return &child;
+    }
+  }
+  return nullptr;
+}
+
+// Returns the number of durations recorded in a histogram.
+uint32_t Count(const metric::Group& parent, metric::Token histogram) {
+  const metric::Group* group = FindGroup(parent, histogram);
+  if (group == nullptr) {
+    return 0;
+  }
+  uint32_t count = 0;
+  for (const metric::Metric& bucket : group->metrics()) {
+    count += bucket.as_int();
+  }
+  return count;
+}
+
+uint32_t Untracked(const metric::Group& metrics) {
+  for (const metric::Metric& metric : metrics.metrics()) {
+    if (metric.name() == kUntracked) {
+      return metric.as_int();
+    }
+  }
+  return 0;
+}
+
+LatencyEvent Event(LatencyStage stage,
+                   uint32_t call_id,
+                   bool final_packet = false,
+                   uint32_t method_id = kMethodId) {
+  return {stage, kChannelId, kServiceId, method_id, call_id, final_packet};
+}
+
+void Request(LatencyTracer& tracer,
+             uint32_t call_id,
+             uint32_t method_id = kMethodId) {
+  tracer.OnLatencyEvent({LatencyStage::kFrameReceived, 0, 0, 0, 0, false});
+  tracer.OnLatencyEvent(
+      Event(LatencyStage::kPacketDecoded, call_id, false, method_id));
+  tracer.OnLatencyEvent(
+      Event(LatencyStage::kHandlerEntered, call_id, false, method_id));
+}
+
+void Respond(LatencyTracer& tracer,
+             uint32_t call_id,
+             bool final_packet = true,
+             uint32_t method_id = kMethodId) {
+  tracer.OnLatencyEvent(
+      Event(LatencyStage::kResponseEncoded, call_id, final_packet, method_id));
+  tracer.OnLatencyEvent(
+      Event(LatencyStage::kResponseSent, call_id, final_packet, method_id));
+}
+
+TEST(LatencyTracer, SynchronousResponse_RecordsAllStages) {
+  LatencyTracerBuffer<2> tracer;
+
+  Request(tracer, 1);
+  Respond(tracer, 1);
+  tracer.OnLatencyEvent(Event(LatencyStage::kHandlerExited, 1));
+
+  const metric::Group& metrics = tracer.metrics();
+  EXPECT_EQ(Count(metrics, kReceiveUs), 1u);
+  EXPECT_EQ(Count(metrics, kDispatchUs), 1u);
+  EXPECT_EQ(Count(metrics, kEgressUs), 1u);
+  EXPECT_EQ(Untracked(metrics), 0u);
+
+  const metric::Group* method = FindGroup(metrics, kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Count(*method, kHandlerUs), 1u);
+  EXPECT_EQ(Count(*method, kTotalUs), 1u);
+}
+
+TEST(LatencyTracer, AsynchronousResponse_RecordsTotalWhenSent) {
+  LatencyTracerBuffer<2> tracer;
+
+  Request(tracer, 1);
+  tracer.OnLatencyEvent(Event(LatencyStage::kHandlerExited, 1));
+
+  const metric::Group* method = FindGroup(tracer.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Count(*method, kHandlerUs), 1u);
+  EXPECT_EQ(Count(*method, kTotalUs), 0u);
+
+  Respond(tracer, 1);
+  EXPECT_EQ(Count(*method, kTotalUs), 1u);
+}
+
+TEST(LatencyTracer, StreamPackets_DoNotCompleteCall) {
+  LatencyTracerBuffer<2> tracer;
+
+  Request(tracer, 1);
+  tracer.OnLatencyEvent(Event(LatencyStage::kHandlerExited, 1));
+  Respond(tracer, 1, /*final_packet=*/false);
+  Respond(tracer, 1, /*final_packet=*/false);
+
+  const metric::Group* method = FindGroup(tracer.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Count(tracer.metrics(), kEgressUs), 2u);
+  EXPECT_EQ(Count(*method, kTotalUs), 0u);
+
+  Respond(tracer, 1);
+  EXPECT_EQ(Count(*method, kTotalUs), 1u);
+}
+
+TEST(LatencyTracer, CompletedCalls_FreeTheirSlots) {
+  LatencyTracerBuffer<1, 1> tracer;
+
+  for (uint32_t call_id = 1; call_id <= 3; ++call_id) {
+    Request(tracer, call_id);
+    tracer.OnLatencyEvent(Event(LatencyStage::kHandlerExited, call_id));
+    Respond(tracer, call_id);
+  }
+
+  const metric::Group* method = FindGroup(tracer.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Count(*method, kTotalUs), 3u);
+  EXPECT_EQ(Untracked(tracer.metrics()), 0u);
+}
+
+TEST(LatencyTracer, FullCallTable_CountsUntracked) {
+  LatencyTracerBuffer<1, 1> tracer;
+
+  Request(tracer, 1);
+  tracer.OnLatencyEvent(Event(LatencyStage::kHandlerExited, 1));
+  Request(tracer, 2);
+  tracer.OnLatencyEvent(Event(LatencyStage::kHandlerExited, 2));
+  Respond(tracer, 2);
+
+  EXPECT_EQ(Untracked(tracer.metrics()), 1u);
+
+  const metric::Group* method = FindGroup(tracer.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Count(*method, kHandlerUs), 1u);
+  EXPECT_EQ(Count(*method, kTotalUs), 0u);
+}
+
+TEST(LatencyTracer, FullMethodTable_CountsUntracked) {
+  LatencyTracerBuffer<1> tracer;
+
+  Request(tracer, 1, kMethodId);
+  Request(tracer, 2, kMethodId + 1);
+
+  EXPECT_EQ(Untracked(tracer.metrics()), 1u);
+  EXPECT_NE(FindGroup(tracer.metrics(), kMethodId), nullptr);
+  EXPECT_EQ(FindGroup(tracer.metrics(), kMethodId + 1), nullptr);
+
+  // Requests are still timed through dispatch.
+  EXPECT_EQ(Count(tracer.metrics(), kDispatchUs), 2u);
+}
+
+TEST(LatencyTracer, RepeatedRequest_ReplacesCall) {
+  LatencyTracerBuffer<1, 1> tracer;
+
+  Request(tracer, 1);
+  tracer.OnLatencyEvent(Event(LatencyStage::kHandlerExited, 1));
+  Request(tracer, 1);
+  tracer.OnLatencyEvent(Event(LatencyStage::kHandlerExited, 1));
+  Respond(tracer, 1);
+
+  const metric::Group* method = FindGroup(tracer.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Untracked(tracer.metrics()), 0u);
+  EXPECT_EQ(Count(*method, kHandlerUs), 2u);
+  EXPECT_EQ(Count(*method, kTotalUs), 1u);
+}
+
+TEST(LatencyTracer, NoFrame_SkipsReceiveStage) {
+  LatencyTracerBuffer<1> tracer;
+
+  tracer.OnLatencyEvent(Event(LatencyStage::kPacketDecoded, 1));
+  tracer.OnLatencyEvent(Event(LatencyStage::kHandlerEntered, 1));
+  Respond(tracer, 1);
+  tracer.OnLatencyEvent(Event(LatencyStage::kHandlerExited, 1));
+
+  EXPECT_EQ(Count(tracer.metrics(), kReceiveUs), 0u);
+  EXPECT_EQ(Count(tracer.metrics(), kDispatchUs), 1u);
+
+  const metric::Group* method = FindGroup(tracer.metrics(), kMethodId);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(Count(*method, kTotalUs), 1u);
+}
+
+}  // namespace
+}  // namespace pw::rpc
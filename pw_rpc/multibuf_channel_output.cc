@@ -0,0 +1,138 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// clang-format off
+#include "pw_rpc/internal/log_config.h"  // PW_LOG_* macros must be first.
+
+#include "pw_rpc/multibuf_channel_output.h"
+// clang-format on
+
+#include <optional>
+
+#include "pw_log/log.h"
+#include "pw_rpc/internal/call.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/latency.h"
+
+namespace pw::rpc {
+
+Status MultiBufChannelOutput::Send(span<const std::byte> buffer) {
+  std::optional<multibuf::MultiBuf> packet =
+      allocator_.AllocateContiguous(buffer.size());
+  if (!packet.has_value()) {
+    PW_LOG_WARN("%s failed to allocate a %u-byte packet buffer",
+                name(),
+                static_cast<unsigned>(buffer.size()));
+    return OkStatus();  // The channel can still send later packets.
+  }
+  packet->CopyFrom(buffer).IgnoreError();  // Sized to fit above.
+  return SendMultiBuf(*std::move(packet));
+}
+
+async2::Poll<Status> MultiBufChannelOutput::PendReadyToSend(
+    async2::Context& cx, size_t payload_size) {
+  const size_t max_size =
+      payload_size + internal::Packet::kMinEncodedSizeWithoutPayload;
+  {
+    internal::RpcLockGuard lock;
+    if (reserved_.has_value() && reserved_->size() >= max_size) {
+      allocation_.reset();
+      return async2::Ready(OkStatus());
+    }
+  }
+
+  if (!allocation_.has_value() || allocation_->min_size() != max_size) {
+    allocation_ = allocator_.AllocateContiguousAsync(max_size);
+  }
+  async2::Poll<std::optional<multibuf::MultiBuf>> buffer =
+      allocation_->Pend(cx);
+  if (buffer.IsPending()) {
+    return async2::Pending();
+  }
+  allocation_.reset();
+  if (!buffer->has_value()) {
+    return async2::Ready(Status::OutOfRange());
+  }
+
+  // Replace any smaller reservation, and free it outside of the RPC lock.
+  std::optional<multibuf::MultiBuf> previous;
+  {
+    internal::RpcLockGuard lock;
+    previous = std::move(reserved_);
+    reserved_ = std::move(*buffer);
+  }
+  return async2::Ready(OkStatus());
+}
+
+async2::Poll<Status> MultiBufChannelOutput::PendWrite(async2::Context& cx,
+                                                      Writer& writer,
+                                                      ConstByteSpan payload) {
+  while (true) {
+    async2::Poll<Status> ready = PendReadyToSend(cx, payload.size());
+    if (ready.IsPending()) {
+      return async2::Pending();
+    }
+    if (!ready->ok()) {
+      return ready;
+    }
+    // Another packet may have taken the reserved buffer. If so, wait again.
+    if (Status status = writer.Write(payload); !status.IsResourceExhausted()) {
+      return status;
+    }
+  }
+}
+
+Status MultiBufChannelOutput::EncodeAndSend(const internal::Packet& packet) {
+  const size_t max_size =
+      packet.payload().size() + internal::Packet::kMinEncodedSizeWithoutPayload;
+
+  std::optional<multibuf::MultiBuf> buffer;
+  if (reserved_.has_value() && reserved_->size() >= max_size) {
+    buffer = std::move(reserved_);
+    reserved_.reset();
+  } else {
+    buffer = allocator_.AllocateContiguous(max_size);
+  }
+  if (!buffer.has_value()) {
+    PW_LOG_WARN("Channel %u failed to allocate a %u-byte packet buffer",
+                static_cast<unsigned>(packet.channel_id()),
+                static_cast<unsigned>(max_size));
+    return Status::ResourceExhausted();
+  }
+
+  Result<ConstByteSpan> encoded = packet.Encode(*buffer->ContiguousSpan());
+  if (!encoded.ok()) {
+    PW_LOG_ERROR(
+        "Failed to encode RPC packet type %u to channel %u buffer, status %u",
+        static_cast<unsigned>(packet.type()),
+        static_cast<unsigned>(packet.channel_id()),
+        encoded.status().code());
+    return Status::Internal();
+  }
+  buffer->Truncate(encoded->size());
+  if (packet.destination() == internal::Packet::kClient) {
+    internal::RecordLatency(LatencyStage::kResponseEncoded, packet);
+  }
+
+  Status sent = SendMultiBuf(*std::move(buffer));
+  if (!sent.ok()) {
+    PW_LOG_DEBUG("Channel %u failed to send packet with status %u",
+                 static_cast<unsigned>(packet.channel_id()),
+                 sent.code());
+    return Status::Unknown();
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,182 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc/multibuf_channel_output.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_bytes/array.h"
+#include "pw_multibuf/simple_allocator_for_test.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::rpc::internal {
+namespace {
+
+class TestMultiBufOutput : public MultiBufChannelOutput {
+ public:
+  TestMultiBufOutput(multibuf::MultiBufAllocator& allocator)
+      : MultiBufChannelOutput(allocator, "TestMultiBufOutput") {}
+
+  Status SendMultiBuf(multibuf::MultiBuf&& packet) override {
+    sent_packets_ += 1;
+    last_packet_ = std::move(packet);
+    return send_status_;
+  }
+
+  size_t sent_packets() const { return sent_packets_; }
+  multibuf::MultiBuf& last_packet() { return *last_packet_; }
+  void set_send_status(Status status) { send_status_ = status; }
+
+ private:
+  size_t sent_packets_ = 0;
+  std::optional<multibuf::MultiBuf> last_packet_;
+  Status send_status_;
+};
+
+class MultiBufChannelOutputTest : public ::testing::Test {
+ protected:
+  MultiBufChannelOutputTest()
+      : output_(allocator_), channel_(Channel::Create<23>(&output_)) {}
+
+  Status SendPacket(const Packet& packet) {
+    RpcLockGuard lock;
+    return static_cast<ChannelBase&>(channel_).Send(packet);
+  }
+
+  multibuf::test::SimpleAllocatorForTest<> allocator_;
+  TestMultiBufOutput output_;
+  Channel channel_;
+};
+
+constexpr auto kPayload = bytes::Array<1, 2, 3, 4, 5>();
+
+TEST_F(MultiBufChannelOutputTest, EncodeAndSend_PacketEncodedIntoMultiBuf) {
+  const Packet packet(
+      pwpb::PacketType::SERVER_STREAM, 23, 42, 100, 7, kPayload);
+  ASSERT_EQ(OkStatus(), SendPacket(packet));
+  ASSERT_EQ(output_.sent_packets(), 1u);
+
+  std::optional<ConstByteSpan> encoded = output_.last_packet().ContiguousSpan();
+  ASSERT_TRUE(encoded.has_value());
+
+  std::array<std::byte, 32> expected_buffer;
+  Result<ConstByteSpan> expected = packet.Encode(expected_buffer);
+  ASSERT_EQ(OkStatus(), expected.status());
+  ASSERT_EQ(encoded->size(), expected->size());
+  EXPECT_EQ(0, std::memcmp(encoded->data(), expected->data(), encoded->size()));
+
+  Result<Packet> decoded = Packet::FromBuffer(*encoded);
+  ASSERT_EQ(OkStatus(), decoded.status());
+  EXPECT_EQ(decoded->call_id(), 7u);
+  EXPECT_EQ(decoded->payload().size(), kPayload.size());
+}
+
+TEST_F(MultiBufChannelOutputTest, EncodeAndSend_SendFailure_ReturnsUnknown) {
+  output_.set_send_status(Status::Unavailable());
+  const Packet packet(pwpb::PacketType::RESPONSE, 23, 42, 100, 7, kPayload);
+  EXPECT_EQ(Status::Unknown(), SendPacket(packet));
+  EXPECT_EQ(output_.sent_packets(), 1u);
+}
+
+TEST_F(MultiBufChannelOutputTest, EncodeAndSend_AllocationFailure) {
+  std::array<std::byte,
+             multibuf::test::SimpleAllocatorForTest<>::data_size_bytes()>
+      too_large{};
+  const Packet packet(pwpb::PacketType::RESPONSE, 23, 42, 100, 7, too_large);
+  EXPECT_EQ(Status::ResourceExhausted(), SendPacket(packet));
+  EXPECT_EQ(output_.sent_packets(), 0u);
+}
+
+TEST_F(MultiBufChannelOutputTest, Send_CopiesRawPacket) {
+  RpcLockGuard lock;
+  ChannelOutput& output = output_;
+  ASSERT_EQ(OkStatus(), output.Send(kPayload));
+  ASSERT_EQ(output_.sent_packets(), 1u);
+
+  std::optional<ConstByteSpan> sent = output_.last_packet().ContiguousSpan();
+  ASSERT_TRUE(sent.has_value());
+  ASSERT_EQ(sent->size(), kPayload.size());
+  EXPECT_EQ(0, std::memcmp(sent->data(), kPayload.data(), kPayload.size()));
+}
+
+// Waits until the output can send a packet with the given payload size.
+class ReadyToSendTask : public async2::Task {
+ public:
+  ReadyToSendTask(MultiBufChannelOutput& output, size_t payload_size)
+      : output_(output), payload_size_(payload_size) {}
+
+  std::optional<Status> result;
+
+ private:
+  async2::Poll<> DoPend(async2::Context& cx) override {
+    async2::Poll<Status> ready = output_.PendReadyToSend(cx, payload_size_);
+    if (ready.IsPending()) {
+      return async2::Pending();
+    }
+    result = *ready;
+    return async2::Ready();
+  }
+
+  MultiBufChannelOutput& output_;
+  size_t payload_size_;
+};
+
+TEST_F(MultiBufChannelOutputTest, PendReadyToSend_ReservedBufferIsUsed) {
+  ReadyToSendTask task(output_, kPayload.size());
+  async2::Dispatcher dispatcher;
+  dispatcher.Post(task);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), async2::Ready());
+  EXPECT_EQ(task.result, OkStatus());
+
+  // The reserved buffer is the only one left, so the packet must use it.
+  std::optional<multibuf::MultiBuf> rest =
+      allocator_.AllocateContiguous(1, allocator_.data_size_bytes());
+  ASSERT_TRUE(rest.has_value());
+
+  const Packet packet(
+      pwpb::PacketType::SERVER_STREAM, 23, 42, 100, 7, kPayload);
+  ASSERT_EQ(OkStatus(), SendPacket(packet));
+  EXPECT_EQ(output_.sent_packets(), 1u);
+}
+
+TEST_F(MultiBufChannelOutputTest, PendReadyToSend_WaitsForMemory) {
+  std::optional<multibuf::MultiBuf> all =
+      allocator_.AllocateContiguous(allocator_.data_size_bytes());
+  ASSERT_TRUE(all.has_value());
+
+  ReadyToSendTask task(output_, kPayload.size());
+  async2::Dispatcher dispatcher;
+  dispatcher.Post(task);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), async2::Pending());
+
+  all.reset();
+  EXPECT_EQ(dispatcher.RunUntilStalled(), async2::Ready());
+  EXPECT_EQ(task.result, OkStatus());
+}
+
+TEST_F(MultiBufChannelOutputTest, PendReadyToSend_PayloadTooLarge) {
+  ReadyToSendTask task(output_, allocator_.data_size_bytes());
+  async2::Dispatcher dispatcher;
+  dispatcher.Post(task);
+  EXPECT_EQ(dispatcher.RunUntilStalled(), async2::Ready());
+  EXPECT_EQ(task.result, Status::OutOfRange());
+}
+
+}  // namespace
+}  // namespace pw::rpc::internal
@@ -34,6 +34,7 @@ class InvocationContext;  // Forward declaration for friend statement
 
 }  // namespace test
 
+class ChannelBase;  // Forward declaration for friend statement
 class ChannelList;  // Forward declaration for friend statement
 
 Status OverwriteChannelId(ByteSpan rpc_packet, uint32_t channel_id_under_128);
@@ -143,6 +144,18 @@ class ChannelOutput {
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) = 0;
 
  private:
+  friend class internal::ChannelBase;
+
+  // Encodes and sends an RPC packet. The default implementation encodes the
+  // packet into pw_rpc's shared encoding buffer and passes it to Send().
+  // Outputs that supply their own packet memory, such as
+  // MultiBufChannelOutput, override this to encode directly into it.
+  //
+  // Returns OK if the packet was sent, INTERNAL if it could not be encoded, or
+  // UNKNOWN if the output failed to send it.
+  virtual Status EncodeAndSend(const internal::Packet& packet)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
   const char* name_;
 };
 
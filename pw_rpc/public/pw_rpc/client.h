@@ -48,6 +48,13 @@ class Client : public internal::Endpoint {
       PW_LOCKS_EXCLUDED(internal::rpc_lock());
 
  private:
+  // ClientServer decodes each packet once and passes it to the client or the
+  // server directly.
+  friend class ClientServer;
+
+  Status ProcessPacket(internal::Packet packet)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
   // Remove these internal::Endpoint functions from the public interface.
   using Endpoint::active_call_count;
   using Endpoint::ClaimLocked;
@@ -32,7 +32,8 @@ class ClientServer {
       : client_(channels), server_(channels) {}
 
   // Sends a packet to either the client or the server, depending on its type.
-  Status ProcessPacket(ConstByteSpan packet);
+  // The packet is decoded only once.
+  Status ProcessPacket(ConstByteSpan packet_data);
 
   constexpr Client& client() { return client_; }
   constexpr Server& server() { return server_; }
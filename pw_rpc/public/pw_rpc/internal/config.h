@@ -75,6 +75,26 @@
 #define PW_RPC_USE_GLOBAL_MUTEX 1
 #endif  // PW_RPC_USE_GLOBAL_MUTEX
 
+/// If @c_macro{PW_RPC_USE_GLOBAL_MUTEX} is enabled, this macro names the type
+/// of the global RPC lock. The type must be default constructible, provide
+/// `lock()` and `unlock()`, and be annotated with `PW_LOCKABLE`. Defaults to
+/// @cpp_class{pw::sync::Mutex}.
+///
+/// The RPC lock guards state shared by all endpoints (channels, which may be
+/// shared between servers and clients, and the packet encoding buffer), so it
+/// cannot be split per endpoint. On multi-core systems where endpoints contend
+/// for the lock, a lock type that spins briefly before blocking can reduce the
+/// cost of short critical sections such as packet dispatch.
+#ifndef PW_RPC_LOCK_TYPE
+#define PW_RPC_LOCK_TYPE ::pw::sync::Mutex
+#endif  // PW_RPC_LOCK_TYPE
+
+/// If @c_macro{PW_RPC_USE_GLOBAL_MUTEX} is enabled, this header is included to
+/// declare @c_macro{PW_RPC_LOCK_TYPE}. Defaults to `"pw_sync/mutex.h"`.
+#ifndef PW_RPC_LOCK_INCLUDE
+#define PW_RPC_LOCK_INCLUDE "pw_sync/mutex.h"
+#endif  // PW_RPC_LOCK_INCLUDE
+
 /// pw_rpc must yield the current thread when waiting for a callback to complete
 /// in a different thread. PW_RPC_YIELD_MODE determines how to yield. There are
 /// three supported settings:
@@ -233,6 +253,44 @@ static_assert(
 #define PW_RPC_MAKE_UNIQUE_PTR_INCLUDE <memory>
 #endif  // PW_RPC_MAKE_UNIQUE_PTR_INCLUDE
 
+/// Maximum number of services to track in a `pw::rpc::Server`'s sorted service
+/// index. When nonzero, each server keeps an array of this many service
+/// pointers ordered by service ID, and incoming packets are dispatched with a
+/// binary search instead of a linear scan of the registered services. Services
+/// registered beyond this count are still found, but disable the index for
+/// that server until the extra services are unregistered.
+///
+/// This is disabled (0) by default.
+#ifndef PW_RPC_SERVICE_INDEX_SIZE
+#define PW_RPC_SERVICE_INDEX_SIZE 0
+#endif  // PW_RPC_SERVICE_INDEX_SIZE
+
+/// Number of buckets in each endpoint's table of active calls. Calls are
+/// distributed across buckets by a hash of their channel, service, and method
+/// IDs, so finding the call for an incoming packet only scans calls for RPCs
+/// that share a bucket. Each bucket costs one
+/// @cpp_class{pw::IntrusiveList} head per `pw::rpc::Server` or
+/// `pw::rpc::Client`.
+///
+/// Defaults to 1, which keeps all calls in a single list.
+#ifndef PW_RPC_CALL_BUCKETS
+#define PW_RPC_CALL_BUCKETS 1
+#endif  // PW_RPC_CALL_BUCKETS
+
+static_assert(PW_RPC_CALL_BUCKETS >= 1,
+              "PW_RPC_CALL_BUCKETS must be at least 1");
+
+/// Enables reporting the stages of handling each RPC request to a
+/// @cpp_class{pw::rpc::LatencyObserver}, such as a
+/// @cpp_class{pw::rpc::LatencyTracer}. Set the observer with
+/// @cpp_func{pw::rpc::SetLatencyObserver}.
+///
+/// This is disabled (0) by default. When disabled, the reporting hooks compile
+/// to nothing.
+#ifndef PW_RPC_LATENCY_TRACING
+#define PW_RPC_LATENCY_TRACING 0
+#endif  // PW_RPC_LATENCY_TRACING
+
 /// Size of the global RPC packet encoding buffer in bytes. If dynamic
 /// allocation is enabled, this value is only used for test helpers that
 /// allocate RPC encoding buffers.
@@ -269,8 +327,13 @@ inline constexpr size_t kNanopbStructMinBufferSize =
 inline constexpr size_t kEncodingBufferSizeBytes =
     PW_RPC_ENCODING_BUFFER_SIZE_BYTES;
 
+inline constexpr size_t kServiceIndexSize = PW_RPC_SERVICE_INDEX_SIZE;
+
+inline constexpr size_t kCallBuckets = PW_RPC_CALL_BUCKETS;
+
 #undef PW_RPC_NANOPB_STRUCT_MIN_BUFFER_SIZE
 #undef PW_RPC_ENCODING_BUFFER_SIZE_BYTES
+#undef PW_RPC_CALL_BUCKETS
 
 }  // namespace pw::rpc::cfg
 
@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <tuple>
 
 #include "pw_assert/assert.h"
@@ -21,6 +22,7 @@
 #include "pw_rpc/channel.h"
 #include "pw_rpc/internal/call.h"
 #include "pw_rpc/internal/channel_list.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_span/span.h"
@@ -72,7 +74,11 @@ class Endpoint {
   // Returns the number calls in the RPC calls list.
   size_t active_call_count() const PW_LOCKS_EXCLUDED(rpc_lock()) {
     RpcLockGuard lock;
-    return calls_.size();
+    size_t count = 0;
+    for (const IntrusiveList<Call>& bucket : calls_) {
+      count += bucket.size();
+    }
+    return count;
   }
 
   // Claims that `rpc_lock()` is held, returning a wrapped endpoint.
@@ -115,20 +121,21 @@ class Endpoint {
                                Packet::Destination destination)
       PW_LOCKS_EXCLUDED(rpc_lock());
 
-  // Finds a call object for an ongoing call associated with this packet, if
-  // any. The iterator will be calls_end() if no match was found.
-  IntrusiveList<Call>::iterator FindCall(const Packet& packet)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return std::get<1>(FindIteratorsForCall(packet.channel_id(),
-                                            packet.service_id(),
-                                            packet.method_id(),
-                                            packet.call_id()));
-  }
+  // Parses an RPC packet and checks that it addresses a call. Returns the
+  // parsed packet, or DATA_LOSS if it is malformed.
+  static Result<Packet> DecodePacket(span<const std::byte> data);
 
-  // Used to check if a call iterator is valid or not.
-  IntrusiveList<Call>::const_iterator calls_end() const
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return calls_.end();
+  // Finds a call object for an ongoing call associated with this packet, if
+  // any. Returns nullptr if no match was found.
+  Call* FindCall(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    IntrusiveList<Call>& bucket = CallBucket(
+        packet.channel_id(), packet.service_id(), packet.method_id());
+    auto call = std::get<1>(FindIteratorsForCall(bucket,
+                                                 packet.channel_id(),
+                                                 packet.service_id(),
+                                                 packet.method_id(),
+                                                 packet.call_id()));
+    return call == bucket.end() ? nullptr : &(*call);
   }
 
   // Aborts calls associated with a particular service. Calls to
@@ -144,20 +151,23 @@ class Endpoint {
   // This method is protected so it can be exposed in tests.
   void CloseCallAndMarkForCleanup(Call& call, Status error)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    // Remove the call before closing it, since closing clears the channel ID
+    // that selects its bucket.
+    CallBucket(call).remove(call);
     call.CloseAndMarkForCleanupFromEndpoint(error);
-    calls_.remove(call);
     to_cleanup_.push_front(call);
   }
 
   // Iterator version of CloseCallAndMarkForCleanup. Returns the iterator to the
-  // item after the closed call.
+  // item after the closed call in its bucket.
   IntrusiveList<Call>::iterator CloseCallAndMarkForCleanup(
+      IntrusiveList<Call>& bucket,
       IntrusiveList<Call>::iterator before_call,
       IntrusiveList<Call>::iterator call_iterator,
       Status error) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     Call& call = *call_iterator;
     call.CloseAndMarkForCleanupFromEndpoint(error);
-    auto next = calls_.erase_after(before_call);
+    auto next = bucket.erase_after(before_call);
     to_cleanup_.push_front(call);
     return next;
   }
@@ -197,7 +207,7 @@ class Endpoint {
   // Registers a call that is known to be unique. The calls list is NOT checked
   // for existing calls.
   void RegisterUniqueCall(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    calls_.push_front(call);
+    CallBucket(call).push_front(call);
   }
 
   void CleanUpCall(Call& call) PW_UNLOCK_FUNCTION(rpc_lock()) {
@@ -206,29 +216,46 @@ class Endpoint {
     call.CleanUpFromEndpoint();
   }
 
-  // Removes the provided call from the call registry.
+  // Removes the provided call from the call registry. The call must still be
+  // active, since its channel ID selects its bucket.
   void UnregisterCall(const Call& call)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    bool closed_call_was_in_list = calls_.remove(call);
+    bool closed_call_was_in_list = CallBucket(call).remove(call);
     PW_DASSERT(closed_call_was_in_list);
   }
 
+  // Returns the list that holds calls for this channel, service, and method.
+  IntrusiveList<Call>& CallBucket(uint32_t channel_id,
+                                  uint32_t service_id,
+                                  uint32_t method_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    if constexpr (cfg::kCallBuckets == 1) {
+      static_cast<void>(channel_id);
+      static_cast<void>(service_id);
+      static_cast<void>(method_id);
+      return calls_[0];
+    } else {
+      // Service and method IDs are already hashes, so a cheap mix suffices.
+      const uint32_t hash = (channel_id * 0x9e3779b1u) ^ service_id ^
+                            (method_id * 0x85ebca6bu);
+      return calls_[hash % cfg::kCallBuckets];
+    }
+  }
+
+  IntrusiveList<Call>& CallBucket(const Call& call)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return CallBucket(
+        call.channel_id_locked(), call.service_id(), call.method_id());
+  }
+
   std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-  FindIteratorsForCall(uint32_t channel_id,
+  FindIteratorsForCall(IntrusiveList<Call>& bucket,
+                       uint32_t channel_id,
                        uint32_t service_id,
                        uint32_t method_id,
                        uint32_t call_id)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
-  std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-  FindIteratorsForCall(const Call& call)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return FindIteratorsForCall(call.channel_id_locked(),
-                                call.service_id(),
-                                call.method_id(),
-                                call.id());
-  }
-
   // Silently closes all calls. Called by the destructor. This is a
   // non-destructor function so that Clang's lock safety analysis applies.
   //
@@ -242,9 +269,11 @@ class Endpoint {
 
   ChannelList channels_ PW_GUARDED_BY(rpc_lock());
 
-  // List of all active calls associated with this endpoint. Calls are added to
-  // this list when they start and removed from it when they finish.
-  IntrusiveList<Call> calls_ PW_GUARDED_BY(rpc_lock());
+  // All active calls associated with this endpoint, bucketed by channel,
+  // service, and method ID. Calls are added when they start and removed when
+  // they finish.
+  std::array<IntrusiveList<Call>, cfg::kCallBuckets> calls_
+      PW_GUARDED_BY(rpc_lock());
 
   // List of all inactive calls that need to have their on_error callbacks
   // called. Calling on_error requires releasing the RPC lock, so calls are
@@ -19,7 +19,7 @@
 
 #if PW_RPC_USE_GLOBAL_MUTEX
 
-#include "pw_sync/mutex.h"  // nogncheck
+#include PW_RPC_LOCK_INCLUDE  // nogncheck
 
 #endif  // PW_RPC_USE_GLOBAL_MUTEX
 
@@ -27,7 +27,7 @@ namespace pw::rpc::internal {
 
 #if PW_RPC_USE_GLOBAL_MUTEX
 
-using RpcLock = sync::Mutex;
+using RpcLock = PW_RPC_LOCK_TYPE;
 
 #else
 
@@ -0,0 +1,105 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_rpc/internal/config.h"
+#include "pw_rpc/internal/packet.h"
+
+namespace pw::rpc {
+
+/// The stages of handling an RPC request, in the order they occur.
+enum class LatencyStage : uint8_t {
+  /// The transport received a complete frame, such as an HDLC frame, that
+  /// holds an RPC packet. Reported by the transport with
+  /// `RecordFrameReceived()`.
+  kFrameReceived,
+
+  /// The server decoded an RPC packet.
+  kPacketDecoded,
+
+  /// The server is about to invoke the method for a request. The handler's
+  /// time includes decoding the request payload.
+  kHandlerEntered,
+
+  /// The method invocation returned. A synchronous handler has sent its
+  /// response by now; an asynchronous one may respond later.
+  kHandlerExited,
+
+  /// A packet from the server to a client was encoded.
+  kResponseEncoded,
+
+  /// A packet from the server to a client was written to its channel output.
+  kResponseSent,
+};
+
+/// A stage of handling an RPC, and the packet it applies to.
+struct LatencyEvent {
+  LatencyStage stage;
+
+  /// IDs from the packet. Zero for `kFrameReceived`, which precedes decoding.
+  uint32_t channel_id;
+  uint32_t service_id;
+  uint32_t method_id;
+  uint32_t call_id;
+
+  /// True for a response or server error packet, which completes the call.
+  /// False for server stream packets and for stages before the response.
+  bool final_packet;
+};
+
+/// Receives the stages of handling RPCs when @c_macro{PW_RPC_LATENCY_TRACING}
+/// is enabled.
+class LatencyObserver {
+ public:
+  virtual ~LatencyObserver() = default;
+
+  /// Called at each stage. Some stages are reported with the RPC lock held, so
+  /// implementations must return quickly and must not call into `pw_rpc`.
+  virtual void OnLatencyEvent(const LatencyEvent& event) = 0;
+};
+
+#if PW_RPC_LATENCY_TRACING
+
+/// Sets the observer that receives the stages of handling RPCs, or stops
+/// reporting them if `observer` is null. The observer must outlive its use.
+void SetLatencyObserver(LatencyObserver* observer);
+
+/// Reports that the transport received a complete frame holding an RPC packet.
+/// Call this just before passing the packet to `Server::ProcessPacket()`.
+void RecordFrameReceived();
+
+#else
+
+inline void SetLatencyObserver(LatencyObserver*) {}
+inline void RecordFrameReceived() {}
+
+#endif  // PW_RPC_LATENCY_TRACING
+
+namespace internal {
+
+#if PW_RPC_LATENCY_TRACING
+
+// Reports a stage to the observer, if one is set.
+void RecordLatency(LatencyStage stage, const Packet& packet);
+
+#else
+
+inline void RecordLatency(LatencyStage, const Packet&) {}
+
+#endif  // PW_RPC_LATENCY_TRACING
+
+}  // namespace internal
+}  // namespace pw::rpc
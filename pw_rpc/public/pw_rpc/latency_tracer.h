@@ -0,0 +1,148 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_containers/vector.h"
+#include "pw_metric/metric.h"
+#include "pw_rpc/latency.h"
+#include "pw_span/span.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::rpc {
+
+/// Times the stages of handling RPC requests and records them in `pw_metric`
+/// histograms. Each histogram counts durations in microseconds, in buckets
+/// named by the smallest duration they count.
+///
+/// Stages are also emitted as `pw_trace` events in the `pw_rpc` group, with
+/// the call ID as the trace ID. With `pw_trace_tokenized` as the trace
+/// backend, they appear alongside the rest of the system's trace.
+///
+/// `LatencyTracer` pairs a received frame and a decoded packet with the
+/// request that follows them. Packets must therefore be processed by one
+/// thread, as they are by the `pw_hdlc` and `pw_system` RPC servers. Responses
+/// may be sent from any thread.
+///
+/// Use `LatencyTracerBuffer` to declare a tracer.
+class LatencyTracer : public LatencyObserver {
+ public:
+  /// Histograms have 20 buckets, so the last one counts durations of at least
+  /// 2^18 us (about 262 ms).
+  static constexpr size_t kHistogramBuckets = 20;
+
+  /// The `rpc_latency` metric group, which holds:
+  ///
+  /// - `receive_us`: from a received frame to its decoded packet.
+  /// - `dispatch_us`: from a decoded request to its handler.
+  /// - `egress_us`: from an encoded response to its write to the channel.
+  /// - `untracked`: requests that could not be timed because the method or
+  ///   call table was full.
+  /// - One group per method, named by its method ID, that holds:
+  ///
+  ///   - `service_id`: the ID of the method's service.
+  ///   - `handler_us`: time spent in the method invocation.
+  ///   - `total_us`: from a received frame, or the decoded request if the
+  ///     transport does not report frames, to the response or error that
+  ///     completes the call.
+  metric::Group& metrics() { return metrics_; }
+
+  void OnLatencyEvent(const LatencyEvent& event) override;
+
+ protected:
+  struct MethodLatency {
+    MethodLatency(uint32_t service, uint32_t method);
+
+    uint32_t service_id;
+    uint32_t method_id;
+    metric::Group group;
+    PW_METRIC(group, service_id_metric, "service_id", 0u);
+    PW_METRIC_HISTOGRAM(group, handler_us, "handler_us", kHistogramBuckets);
+    PW_METRIC_HISTOGRAM(group, total_us, "total_us", kHistogramBuckets);
+  };
+
+  // A call whose final response has not been sent, or whose handler has not
+  // returned.
+  struct CallTimeline {
+    MethodLatency* method = nullptr;  // nullptr if the slot is free
+    uint32_t channel_id = 0;
+    uint32_t call_id = 0;
+    chrono::SystemClock::time_point start;
+    chrono::SystemClock::time_point handler_entered;
+    bool in_handler = false;
+    bool responded = false;
+  };
+
+  LatencyTracer(Vector<MethodLatency>& methods, span<CallTimeline> calls)
+      : methods_(methods), calls_(calls) {}
+
+ private:
+  MethodLatency* FindOrAddMethod(uint32_t service_id, uint32_t method_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  CallTimeline* FindCall(const LatencyEvent& event)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  void StartCall(const LatencyEvent& event, chrono::SystemClock::time_point now)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  void EndHandler(const LatencyEvent& event,
+                  chrono::SystemClock::time_point now)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  void ResponseSent(const LatencyEvent& event,
+                    chrono::SystemClock::time_point now)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  sync::InterruptSpinLock lock_;
+
+  std::optional<chrono::SystemClock::time_point> frame_received_
+      PW_GUARDED_BY(lock_);
+  std::optional<chrono::SystemClock::time_point> packet_decoded_
+      PW_GUARDED_BY(lock_);
+  // When the last decoded packet's frame was received, or when it was decoded
+  // if the transport did not report its frame.
+  chrono::SystemClock::time_point packet_start_ PW_GUARDED_BY(lock_);
+  std::optional<chrono::SystemClock::time_point> response_encoded_
+      PW_GUARDED_BY(lock_);
+
+  Vector<MethodLatency>& methods_ PW_GUARDED_BY(lock_);
+  span<CallTimeline> calls_ PW_GUARDED_BY(lock_);
+
+  PW_METRIC_GROUP(metrics_, "rpc_latency");
+  PW_METRIC_HISTOGRAM(metrics_, receive_us_, "receive_us", kHistogramBuckets);
+  PW_METRIC_HISTOGRAM(metrics_, dispatch_us_, "dispatch_us", kHistogramBuckets);
+  PW_METRIC_HISTOGRAM(metrics_, egress_us_, "egress_us", kHistogramBuckets);
+  PW_METRIC(metrics_, untracked_, "untracked", 0u);
+};
+
+/// A `LatencyTracer` with histograms for up to `kMaxMethods` methods, which
+/// times up to `kMaxCalls` calls at once.
+template <size_t kMaxMethods, size_t kMaxCalls = 4>
+class LatencyTracerBuffer : public LatencyTracer {
+ public:
+  LatencyTracerBuffer() : LatencyTracer(methods_, calls_) {}
+
+ private:
+  Vector<MethodLatency, kMaxMethods> methods_;
+  std::array<CallTimeline, kMaxCalls> calls_;
+};
+
+}  // namespace pw::rpc
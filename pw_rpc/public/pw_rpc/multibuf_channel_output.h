@@ -0,0 +1,117 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/poll.h"
+#include "pw_bytes/span.h"
+#include "pw_multibuf/allocator.h"
+#include "pw_multibuf/multibuf.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_rpc/writer.h"
+#include "pw_status/status.h"
+
+namespace pw::rpc {
+
+/// A `ChannelOutput` that hands each outgoing packet to the transport as a
+/// `pw::multibuf::MultiBuf`.
+///
+/// Packets are encoded directly into a contiguous chunk allocated from the
+/// provided `MultiBufAllocator`, rather than into pw_rpc's shared encoding
+/// buffer. The transport takes ownership of the chunk, so it does not need to
+/// copy the packet before `SendMultiBuf()` returns.
+///
+/// Because packets are allocated from the transport's allocator, the transport
+/// can apply backpressure. When its allocator is out of memory, writes to RPCs
+/// on the channel fail with `RESOURCE_EXHAUSTED`. Asynchronous producers can
+/// instead use `PendWrite()`, which waits until a buffer is available rather
+/// than failing.
+class MultiBufChannelOutput : public ChannelOutput {
+ public:
+  constexpr MultiBufChannelOutput(multibuf::MultiBufAllocator& allocator,
+                                  const char* name)
+      : ChannelOutput(name), allocator_(allocator) {}
+
+  /// Sends an encoded RPC packet, taking ownership of its buffer.
+  ///
+  /// The same restrictions apply as for `ChannelOutput::Send()`: the RPC lock
+  /// is held, and no pw_rpc APIs may be called from this function.
+  ///
+  /// @returns OK if further packets may be sent, even if the current packet
+  /// could not be sent. Any other status indicates that the channel is no
+  /// longer able to send packets.
+  virtual Status SendMultiBuf(multibuf::MultiBuf&& packet)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) = 0;
+
+  /// Waits until a packet with a payload of up to `payload_size` bytes can be
+  /// sent. This reserves a packet buffer from the allocator, which is used by
+  /// the next packet sent through this output that fits in it.
+  ///
+  /// Only one task may wait on a `MultiBufChannelOutput` at a time.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: A packet buffer is reserved.
+  ///
+  ///    OUT_OF_RANGE: The allocator can never provide a buffer large enough
+  ///    for the payload.
+  ///
+  /// @endrst
+  async2::Poll<Status> PendReadyToSend(async2::Context& cx,
+                                       size_t payload_size)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
+  /// Writes a payload to an RPC, first waiting until there is memory to send
+  /// it. The writer's call must use a channel with this output.
+  ///
+  /// Unlike `Writer::Write()`, this does not fail with `RESOURCE_EXHAUSTED`
+  /// when the transport is out of memory. The task is instead woken to retry
+  /// once the transport frees a buffer.
+  ///
+  /// @returns The status of the write, or `OUT_OF_RANGE` if the payload can
+  /// never fit in a packet buffer.
+  async2::Poll<Status> PendWrite(async2::Context& cx,
+                                 Writer& writer,
+                                 ConstByteSpan payload)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
+ protected:
+  multibuf::MultiBufAllocator& allocator() const { return allocator_; }
+
+ private:
+  /// Copies an already encoded packet into a `MultiBuf` and sends it. This is
+  /// only used for packets that are not encoded by pw_rpc itself.
+  Status Send(span<const std::byte> buffer) final
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
+  Status EncodeAndSend(const internal::Packet& packet) final
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
+  multibuf::MultiBufAllocator& allocator_;
+
+  // Pending allocation for PendReadyToSend().
+  std::optional<multibuf::MultiBufAllocationFuture> allocation_;
+
+  // Buffer reserved by PendReadyToSend() for the next packet.
+  std::optional<multibuf::MultiBuf> reserved_
+      PW_GUARDED_BY(internal::rpc_lock());
+};
+
+}  // namespace pw::rpc
@@ -13,12 +13,14 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <tuple>
 
 #include "pw_containers/intrusive_list.h"
 #include "pw_rpc/channel.h"
 #include "pw_rpc/internal/call.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/endpoint.h"
 #include "pw_rpc/internal/grpc.h"
 #include "pw_rpc/internal/lock.h"
@@ -54,11 +56,11 @@ class Server : public internal::Endpoint {
   void RegisterService(Service& service, OtherServices&... services)
       PW_LOCKS_EXCLUDED(internal::rpc_lock()) {
     internal::RpcLockGuard lock;
-    services_.push_front(service);  // Register the first service
+    RegisterServiceLocked(service);  // Register the first service
 
     // Register any additional services by expanding the parameter pack. This
     // is a fold expression of the comma operator.
-    (services_.push_front(services), ...);
+    (RegisterServiceLocked(services), ...);
   }
 
   // Returns whether a service is registered.
@@ -101,6 +103,10 @@ class Server : public internal::Endpoint {
   friend class internal::Call;
   friend class ServerTestHelper;
 
+  // ClientServer decodes each packet once and passes it to the client or the
+  // server directly.
+  friend class ClientServer;
+
   // Give gRPC integration access to FindMethod and internal::Packet version of
   // ProcessPacket
   friend class pw::grpc::PwRpcHandler;
@@ -189,18 +195,23 @@ class Server : public internal::Endpoint {
 
   void HandleCompletionRequest(const internal::Packet& packet,
                                internal::ChannelBase& channel,
-                               IntrusiveList<internal::Call>::iterator call)
+                               internal::Call* call)
       const PW_UNLOCK_FUNCTION(internal::rpc_lock());
 
   void HandleClientStreamPacket(const internal::Packet& packet,
                                 internal::ChannelBase& channel,
-                                IntrusiveList<internal::Call>::iterator call)
+                                internal::Call* call)
       const PW_UNLOCK_FUNCTION(internal::rpc_lock());
 
+  void RegisterServiceLocked(Service& service)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
   template <typename... OtherServices>
   void UnregisterServiceLocked(Service& service, OtherServices&... services)
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
-    services_.remove(service);
+    if (services_.remove(service)) {
+      RemoveFromServiceIndex(service);
+    }
     UnregisterServiceLocked(services...);
     AbortCallsForService(service);
   }
@@ -216,7 +227,23 @@ class Server : public internal::Endpoint {
   using Endpoint::CleanUpCalls;
   using Endpoint::GetInternalChannel;
 
+  // Removes a service from the sorted service index, if it is enabled.
+  void RemoveFromServiceIndex(const Service& service)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
+  Service* FindServiceLocked(uint32_t service_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
   IntrusiveList<Service> services_ PW_GUARDED_BY(internal::rpc_lock());
+
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+  // Registered services sorted by service ID. Only used while every
+  // registered service fits; services_ is scanned otherwise.
+  std::array<Service*, PW_RPC_SERVICE_INDEX_SIZE> service_index_
+      PW_GUARDED_BY(internal::rpc_lock()) = {};
+  size_t indexed_services_ PW_GUARDED_BY(internal::rpc_lock()) = 0;
+  size_t unindexed_services_ PW_GUARDED_BY(internal::rpc_lock()) = 0;
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
 };
 
 }  // namespace pw::rpc
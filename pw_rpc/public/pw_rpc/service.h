@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
@@ -71,13 +72,22 @@ class Service : public IntrusiveList<Service>::Item {
   friend class Server;
   friend class ServiceTestHelper;
 
+  // Checks whether the methods are in strictly increasing method ID order.
+  // Generated services sort their method tables, which allows FindMethod to
+  // use a binary search. Called when the service is registered, since methods
+  // may not be initialized when the Service base is constructed.
+  void CheckMethodOrder();
+
   // Finds the method with the provided method_id. Returns nullptr if no match.
   const internal::Method* FindMethod(uint32_t method_id) const;
 
+  const internal::Method& MethodAt(size_t index) const;
+
   const uint32_t id_;
   const internal::MethodUnion* const methods_;
   const uint16_t method_size_;
   const uint16_t method_count_;
+  bool methods_sorted_ = false;
 };
 
 }  // namespace pw::rpc
@@ -0,0 +1,264 @@
+# Copyright 2024 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Throughput and latency benchmarks for the pw.rpc.Benchmark service.
+
+The benchmarks run against any client object exposing the ``pw.rpc.Benchmark``
+service, so the same suite can be run over a loopback channel, a local socket,
+or an HDLC-framed serial port. For example:
+
+.. code-block:: python
+
+   from pw_rpc import benchmark
+
+   runner = benchmark.Benchmark(rpcs.pw.rpc.Benchmark)
+   results = runner.sweep(payload_sizes=(1, 32, 128), concurrency=(1, 4))
+   print(benchmark.format_results(results))
+"""
+
+from __future__ import annotations
+
+import collections
+import dataclasses
+import math
+import threading
+import time
+from typing import Any, Callable, Iterable, Sequence
+
+from pw_rpc.callback_client.errors import RpcError, RpcTimeout
+
+# The C++ UnaryEcho implementation responds with up to 32 bytes.
+MAX_UNARY_PAYLOAD_SIZE = 32
+
+DEFAULT_PAYLOAD_SIZES = (1, 8, 32, 64, 128, 256)
+DEFAULT_CONCURRENCY = (1, 2, 4, 8)
+
+
+def percentile(sorted_values: Sequence[float], fraction: float) -> float:
+    """Returns the nearest-rank percentile of an already sorted sequence."""
+    if not sorted_values:
+        return math.nan
+
+    if not 0.0 <= fraction <= 1.0:
+        raise ValueError(f'Percentile {fraction} is not in [0, 1]')
+
+    rank = max(1, math.ceil(fraction * len(sorted_values)))
+    return sorted_values[rank - 1]
+
+
+@dataclasses.dataclass
+class Result:
+    """Measurements from one benchmark run.
+
+    Latencies are round-trip times in seconds. Packet and byte counts include
+    both requests and responses.
+    """
+
+    name: str
+    payload_size: int
+    concurrency: int
+    duration_s: float
+    latencies_s: list[float] = dataclasses.field(default_factory=list)
+    errors: int = 0
+
+    @property
+    def round_trips(self) -> int:
+        return len(self.latencies_s)
+
+    @property
+    def packets(self) -> int:
+        return 2 * self.round_trips
+
+    @property
+    def payload_bytes(self) -> int:
+        return self.packets * self.payload_size
+
+    @property
+    def p50_s(self) -> float:
+        return percentile(sorted(self.latencies_s), 0.50)
+
+    @property
+    def p99_s(self) -> float:
+        return percentile(sorted(self.latencies_s), 0.99)
+
+    @property
+    def packets_per_s(self) -> float:
+        return self.packets / self.duration_s if self.duration_s else 0.0
+
+    @property
+    def bytes_per_s(self) -> float:
+        return self.payload_bytes / self.duration_s if self.duration_s else 0.0
+
+
+def format_results(results: Iterable[Result]) -> str:
+    """Formats benchmark results as a plain text table."""
+    header = (
+        f'{"benchmark":<14} {"payload":>8} {"calls":>6} {"p50 (us)":>10} '
+        f'{"p99 (us)":>10} {"packets/s":>11} {"bytes/s":>12} {"errors":>7}'
+    )
+    lines = [header, '-' * len(header)]
+    for result in results:
+        lines.append(
+            f'{result.name:<14} {result.payload_size:>8} '
+            f'{result.concurrency:>6} {result.p50_s * 1e6:>10.1f} '
+            f'{result.p99_s * 1e6:>10.1f} {result.packets_per_s:>11.1f} '
+            f'{result.bytes_per_s:>12.1f} {result.errors:>7}'
+        )
+    return '\n'.join(lines)
+
+
+class Benchmark:
+    """Runs latency and throughput measurements against pw.rpc.Benchmark."""
+
+    def __init__(
+        self,
+        service: Any,
+        timeout_s: float = 5.0,
+        clock: Callable[[], float] = time.perf_counter,
+    ) -> None:
+        """Creates a benchmark runner.
+
+        Args:
+          service: the ``pw.rpc.Benchmark`` service from a callback client,
+              e.g. ``rpcs.pw.rpc.Benchmark``
+          timeout_s: how long to wait for each response
+          clock: monotonic clock used for timing, in seconds
+        """
+        self._service = service
+        self._timeout_s = timeout_s
+        self._clock = clock
+
+    def unary(self, payload_size: int, iterations: int) -> Result:
+        """Measures sequential UnaryEcho round trips."""
+        if payload_size > MAX_UNARY_PAYLOAD_SIZE:
+            raise ValueError(
+                f'UnaryEcho echoes at most {MAX_UNARY_PAYLOAD_SIZE} bytes; '
+                f'use bidirectional() for {payload_size}-byte payloads'
+            )
+
+        payload = _payload(payload_size)
+        result = Result('unary', payload_size, 1, 0.0)
+
+        start = self._clock()
+        for _ in range(iterations):
+            sent = self._clock()
+            try:
+                status, response = self._service.UnaryEcho(
+                    payload=payload, pw_rpc_timeout_s=self._timeout_s
+                )
+            except (RpcError, RpcTimeout):
+                result.errors += 1
+                continue
+
+            if status.ok() and response.payload == payload:
+                result.latencies_s.append(self._clock() - sent)
+            else:
+                result.errors += 1
+        result.duration_s = self._clock() - start
+        return result
+
+    def bidirectional(
+        self, payload_size: int, iterations: int, concurrency: int = 1
+    ) -> Result:
+        """Measures BidirectionalEcho round trips across concurrent calls.
+
+        Opens ``concurrency`` calls and sends ``iterations`` requests on each,
+        keeping one request in flight per call. Latency is measured from each
+        send to the matching echoed response.
+        """
+        payload = _payload(payload_size)
+        result = Result('bidirectional', payload_size, concurrency, 0.0)
+
+        condition = threading.Condition()
+        send_times: list[collections.deque[float]] = [
+            collections.deque() for _ in range(concurrency)
+        ]
+        received = [0] * concurrency
+
+        def on_next(index: int, _: Any, response: Any) -> None:
+            now = self._clock()
+            with condition:
+                if not send_times[index]:
+                    result.errors += 1  # Unexpected response.
+                elif response.payload != payload:
+                    send_times[index].popleft()
+                    result.errors += 1
+                else:
+                    result.latencies_s.append(now - send_times[index].popleft())
+                received[index] += 1
+                condition.notify_all()
+
+        def make_callback(index: int) -> Callable[[Any, Any], None]:
+            return lambda call, response: on_next(index, call, response)
+
+        calls = [
+            self._service.BidirectionalEcho.invoke(
+                on_next=make_callback(i), timeout_s=None
+            )
+            for i in range(concurrency)
+        ]
+
+        try:
+            start = self._clock()
+            for iteration in range(iterations):
+                for index, call in enumerate(calls):
+                    with condition:
+                        send_times[index].append(self._clock())
+                    call.send(payload=payload)
+
+                with condition:
+                    done = condition.wait_for(
+                        lambda: all(r > iteration for r in received),
+                        timeout=self._timeout_s,
+                    )
+                if not done:
+                    missing = sum(1 for r in received if r <= iteration)
+                    result.errors += missing + (
+                        iterations - iteration - 1
+                    ) * len(calls)
+                    break
+            result.duration_s = self._clock() - start
+        finally:
+            for call in calls:
+                call.cancel()
+
+        return result
+
+    def sweep(
+        self,
+        payload_sizes: Iterable[int] = DEFAULT_PAYLOAD_SIZES,
+        concurrency: Iterable[int] = DEFAULT_CONCURRENCY,
+        iterations: int = 100,
+    ) -> list[Result]:
+        """Runs each benchmark over a grid of payload sizes and call counts.
+
+        Unary calls are measured for payloads UnaryEcho can echo; streaming
+        calls are measured for every payload size and concurrency level.
+        """
+        payload_sizes = tuple(payload_sizes)
+        concurrency = tuple(concurrency)
+        results = []
+
+        for size in payload_sizes:
+            if size <= MAX_UNARY_PAYLOAD_SIZE:
+                results.append(self.unary(size, iterations))
+
+        for size in payload_sizes:
+            for calls in concurrency:
+                results.append(self.bidirectional(size, iterations, calls))
+
+        return results
+
+
+def _payload(size: int) -> bytes:
+    return bytes(i % 256 for i in range(size))
@@ -418,7 +418,7 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
         )
 
         with gen.indent(4):
-            for method in service.methods():
+            for method in _methods_by_id(service):
                 gen.method_descriptor(method)
 
         gen.line('};\n')
@@ -429,6 +429,14 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
     gen.line('};')
 
 
+def _methods_by_id(service: ProtoService) -> list[ProtoServiceMethod]:
+    """Returns the service's methods sorted by method ID.
+
+    The server binary searches method tables that are in ID order.
+    """
+    return sorted(service.methods(), key=lambda m: ids.calculate(m.name()))
+
+
 def _method_lookup_table(gen: CodeGenerator, service: ProtoService) -> None:
     """Generates array of method IDs for looking up methods at compile time."""
     gen.line(
@@ -437,7 +445,7 @@ def _method_lookup_table(gen: CodeGenerator, service: ProtoService) -> None:
     )
 
     with gen.indent(4):
-        for method in service.methods():
+        for method in _methods_by_id(service):
             gen.line(f'{get_id(method)},  // Hash of "{method.name()}"')
 
     gen.line('};')
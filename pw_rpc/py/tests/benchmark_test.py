@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+# Copyright 2024 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests the pw.rpc.Benchmark throughput and latency harness."""
+
+import math
+import types
+import unittest
+
+from pw_status import Status
+
+from pw_rpc import benchmark
+
+
+class _FakeClock:
+    def __init__(self) -> None:
+        self.now = 0.0
+
+    def __call__(self) -> float:
+        self.now += 0.001
+        return self.now
+
+
+class _FakeBidirectionalCall:
+    def __init__(self, on_next, drop: bool) -> None:
+        self._on_next = on_next
+        self._drop = drop
+        self.cancelled = False
+
+    def send(self, payload: bytes) -> None:
+        if not self._drop:
+            self._on_next(self, types.SimpleNamespace(payload=payload))
+
+    def cancel(self) -> bool:
+        self.cancelled = True
+        return True
+
+
+class _FakeBidirectionalEcho:
+    def __init__(self) -> None:
+        self.drop = False
+        self.calls: list[_FakeBidirectionalCall] = []
+
+    def invoke(self, on_next, timeout_s=None):
+        del timeout_s
+        call = _FakeBidirectionalCall(on_next, self.drop)
+        self.calls.append(call)
+        return call
+
+
+class _FakeService:
+    """Echoes requests synchronously, like a loopback transport."""
+
+    def __init__(self) -> None:
+        self.unary_requests: list[bytes] = []
+        self.BidirectionalEcho = _FakeBidirectionalEcho()
+
+    # pylint: disable-next=invalid-name
+    def UnaryEcho(self, payload: bytes, pw_rpc_timeout_s=None):
+        del pw_rpc_timeout_s
+        self.unary_requests.append(payload)
+        return Status.OK, types.SimpleNamespace(payload=payload)
+
+
+class PercentileTest(unittest.TestCase):
+    """Tests nearest-rank percentile calculation."""
+
+    def test_empty(self) -> None:
+        self.assertTrue(math.isnan(benchmark.percentile([], 0.5)))
+
+    def test_nearest_rank(self) -> None:
+        values = list(range(1, 101))
+        self.assertEqual(benchmark.percentile(values, 0.50), 50)
+        self.assertEqual(benchmark.percentile(values, 0.99), 99)
+        self.assertEqual(benchmark.percentile(values, 1.0), 100)
+        self.assertEqual(benchmark.percentile(values, 0.0), 1)
+
+    def test_out_of_range(self) -> None:
+        with self.assertRaises(ValueError):
+            benchmark.percentile([1.0], 1.5)
+
+
+class ResultTest(unittest.TestCase):
+    """Tests derived throughput and latency statistics."""
+
+    def test_rates(self) -> None:
+        result = benchmark.Result(
+            'unary', 10, 1, duration_s=2.0, latencies_s=[0.1, 0.3, 0.2]
+        )
+        self.assertEqual(result.packets, 6)
+        self.assertEqual(result.payload_bytes, 60)
+        self.assertEqual(result.packets_per_s, 3.0)
+        self.assertEqual(result.bytes_per_s, 30.0)
+        self.assertEqual(result.p50_s, 0.2)
+        self.assertEqual(result.p99_s, 0.3)
+
+    def test_format_results(self) -> None:
+        result = benchmark.Result('unary', 10, 1, 1.0, [0.001])
+        table = benchmark.format_results([result])
+        self.assertIn('p99 (us)', table)
+        self.assertIn('unary', table.splitlines()[2])
+
+
+class BenchmarkTest(unittest.TestCase):
+    """Tests running benchmarks against a fake service."""
+
+    def setUp(self) -> None:
+        self._service = _FakeService()
+        self._benchmark = benchmark.Benchmark(
+            self._service, timeout_s=0.01, clock=_FakeClock()
+        )
+
+    def test_unary(self) -> None:
+        result = self._benchmark.unary(payload_size=16, iterations=5)
+        self.assertEqual(result.round_trips, 5)
+        self.assertEqual(result.errors, 0)
+        self.assertEqual(len(self._service.unary_requests), 5)
+        self.assertEqual(len(self._service.unary_requests[0]), 16)
+        self.assertGreater(result.duration_s, 0)
+
+    def test_unary_payload_too_large(self) -> None:
+        with self.assertRaises(ValueError):
+            self._benchmark.unary(benchmark.MAX_UNARY_PAYLOAD_SIZE + 1, 1)
+
+    def test_bidirectional_concurrent_calls(self) -> None:
+        result = self._benchmark.bidirectional(
+            payload_size=100, iterations=4, concurrency=3
+        )
+        self.assertEqual(result.round_trips, 12)
+        self.assertEqual(result.errors, 0)
+        self.assertEqual(len(self._service.BidirectionalEcho.calls), 3)
+        self.assertTrue(
+            all(c.cancelled for c in self._service.BidirectionalEcho.calls)
+        )
+
+    def test_bidirectional_timeout_counts_errors(self) -> None:
+        self._service.BidirectionalEcho.drop = True
+        runner = benchmark.Benchmark(self._service, timeout_s=0.001)
+        outcome = runner.bidirectional(8, iterations=3, concurrency=2)
+        self.assertEqual(outcome.round_trips, 0)
+        self.assertEqual(outcome.errors, 6)
+
+    def test_sweep(self) -> None:
+        results = self._benchmark.sweep(
+            payload_sizes=(8, 64), concurrency=(1, 2), iterations=2
+        )
+        self.assertEqual(
+            [(r.name, r.payload_size, r.concurrency) for r in results],
+            [
+                ('unary', 8, 1),
+                ('bidirectional', 8, 1),
+                ('bidirectional', 8, 2),
+                ('bidirectional', 64, 1),
+                ('bidirectional', 64, 2),
+            ],
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
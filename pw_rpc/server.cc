@@ -23,6 +23,7 @@
 #include "pw_log/log.h"
 #include "pw_rpc/internal/endpoint.h"
 #include "pw_rpc/internal/packet.h"
+#include "pw_rpc/latency.h"
 #include "pw_rpc/service_id.h"
 
 namespace pw::rpc {
@@ -31,6 +32,12 @@ namespace {
 using internal::Packet;
 using internal::pwpb::PacketType;
 
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+bool CompareServiceId(const Service* service, uint32_t id) {
+  return internal::UnwrapServiceId(service->service_id()) < id;
+}
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
+
 }  // namespace
 
 Status Server::ProcessPacket(ConstByteSpan packet_data) {
@@ -40,6 +47,7 @@ Status Server::ProcessPacket(ConstByteSpan packet_data) {
 }
 
 Status Server::ProcessPacket(internal::Packet packet) {
+  internal::RecordLatency(LatencyStage::kPacketDecoded, packet);
   internal::rpc_lock().lock();
 
   // Verbose log for debugging.
@@ -78,18 +86,20 @@ Status Server::ProcessPacket(internal::Packet packet) {
   if (packet.type() == PacketType::REQUEST) {
     const internal::CallContext context(
         *this, packet.channel_id(), *service, *method, packet.call_id());
+    internal::RecordLatency(LatencyStage::kHandlerEntered, packet);
     method->Invoke(context, packet);
+    internal::RecordLatency(LatencyStage::kHandlerExited, packet);
     return OkStatus();
   }
 
-  IntrusiveList<internal::Call>::iterator call = FindCall(packet);
+  internal::Call* call = FindCall(packet);
 
   switch (packet.type()) {
     case PacketType::CLIENT_STREAM:
       HandleClientStreamPacket(packet, *channel, call);
       break;
     case PacketType::CLIENT_ERROR:
-      if (call != calls_end()) {
+      if (call != nullptr) {
         call->HandleError(packet.status());
       } else {
         internal::rpc_lock().unlock();
@@ -119,22 +129,86 @@ std::tuple<Service*, const internal::Method*> Server::FindMethod(
 
 std::tuple<Service*, const internal::Method*> Server::FindMethodLocked(
     uint32_t service_id, uint32_t method_id) {
+  Service* service = FindServiceLocked(service_id);
+
+  if (service == nullptr) {
+    return {};
+  }
+
+  return {service, service->FindMethod(method_id)};
+}
+
+void Server::RegisterServiceLocked(Service& service) {
+  service.CheckMethodOrder();
+  services_.push_front(service);
+
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+  if (indexed_services_ == service_index_.size()) {
+    PW_LOG_DEBUG(
+        "pw_rpc service index is full; service %08x uses a linear lookup",
+        static_cast<unsigned>(internal::UnwrapServiceId(service.service_id())));
+    unindexed_services_ += 1;
+    return;
+  }
+
+  // Insert before services with the same ID so that the most recently
+  // registered service is found first, matching the order of services_.
+  const uint32_t id = internal::UnwrapServiceId(service.service_id());
+  auto end = service_index_.begin() + indexed_services_;
+  auto position =
+      std::lower_bound(service_index_.begin(), end, id, CompareServiceId);
+  std::move_backward(position, end, end + 1);
+  *position = &service;
+  indexed_services_ += 1;
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
+}
+
+void Server::RemoveFromServiceIndex([[maybe_unused]] const Service& service) {
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+  auto end = service_index_.begin() + indexed_services_;
+  auto position = std::find(service_index_.begin(), end, &service);
+  if (position == end) {
+    if (unindexed_services_ > 0) {
+      unindexed_services_ -= 1;
+    }
+    return;
+  }
+  std::move(position + 1, end, position);
+  indexed_services_ -= 1;
+  service_index_[indexed_services_] = nullptr;
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
+}
+
+Service* Server::FindServiceLocked(uint32_t service_id) {
+#if PW_RPC_SERVICE_INDEX_SIZE > 0
+  // The index is only authoritative while it holds every registered service.
+  if (unindexed_services_ == 0) {
+    auto end = service_index_.begin() + indexed_services_;
+    auto position = std::lower_bound(
+        service_index_.begin(), end, service_id, CompareServiceId);
+    if (position != end &&
+        internal::UnwrapServiceId((*position)->service_id()) == service_id) {
+      return *position;
+    }
+    return nullptr;
+  }
+#endif  // PW_RPC_SERVICE_INDEX_SIZE > 0
+
   auto service = std::find_if(services_.begin(), services_.end(), [&](auto& s) {
     return internal::UnwrapServiceId(s.service_id()) == service_id;
   });
 
   if (service == services_.end()) {
-    return {};
+    return nullptr;
   }
-
-  return {&(*service), service->FindMethod(method_id)};
+  return &(*service);
 }
 
 void Server::HandleCompletionRequest(
     const internal::Packet& packet,
     internal::ChannelBase& channel,
-    IntrusiveList<internal::Call>::iterator call) const {
-  if (call == calls_end()) {
+    internal::Call* call) const {
+  if (call == nullptr) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
     internal::rpc_lock().unlock();
@@ -162,8 +236,8 @@ void Server::HandleCompletionRequest(
 void Server::HandleClientStreamPacket(
     const internal::Packet& packet,
     internal::ChannelBase& channel,
-    IntrusiveList<internal::Call>::iterator call) const {
-  if (call == calls_end()) {
+    internal::Call* call) const {
+  if (call == nullptr) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
     internal::rpc_lock().unlock();
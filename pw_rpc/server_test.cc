@@ -431,6 +431,39 @@ TEST_F(BasicServer, FindMethod_NotFound) {
   }
 }
 
+TEST(Server, FindMethod_ManyServicesInAnyOrder) {
+  std::array<Channel, 1> channels;
+  Server server(channels);
+
+  TestService service_5(5);
+  TestService service_3(3);
+  TestService service_9(9);
+  TestService service_1(1);
+  TestService service_7(7);
+  server.RegisterService(service_5, service_3, service_9);
+  server.RegisterService(service_1, service_7);
+
+  for (TestService* service :
+       {&service_1, &service_3, &service_5, &service_7, &service_9}) {
+    const uint32_t id = internal::UnwrapServiceId(service->service_id());
+    const auto [found, method] = ServerTestHelper::FindMethod(server, id, 200);
+    EXPECT_EQ(found, service);
+    EXPECT_EQ(method, &service->method(200));
+  }
+
+  server.UnregisterService(service_5, service_1);
+
+  EXPECT_EQ(std::get<0>(ServerTestHelper::FindMethod(server, 5, 100)), nullptr);
+  EXPECT_EQ(std::get<0>(ServerTestHelper::FindMethod(server, 1, 100)), nullptr);
+  EXPECT_EQ(std::get<0>(ServerTestHelper::FindMethod(server, 2, 100)), nullptr);
+  EXPECT_EQ(std::get<0>(ServerTestHelper::FindMethod(server, 3, 100)),
+            &service_3);
+  EXPECT_EQ(std::get<0>(ServerTestHelper::FindMethod(server, 9, 100)),
+            &service_9);
+
+  server.UnregisterService(service_3, service_7, service_9);
+}
+
 class BidiMethod : public BasicServer {
  protected:
   BidiMethod() {
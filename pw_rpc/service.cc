@@ -19,18 +19,48 @@
 
 namespace pw::rpc {
 
+const internal::Method& Service::MethodAt(size_t index) const {
+  const auto raw = reinterpret_cast<const std::byte*>(methods_);
+  return reinterpret_cast<const internal::MethodUnion*>(raw +
+                                                         index * method_size_)
+      ->method();
+}
+
+void Service::CheckMethodOrder() {
+  methods_sorted_ = true;
+  for (size_t i = 1; i < method_count_; ++i) {
+    if (MethodAt(i - 1).id() >= MethodAt(i).id()) {
+      methods_sorted_ = false;
+      return;
+    }
+  }
+}
+
 const internal::Method* Service::FindMethod(uint32_t method_id) const {
-  const internal::MethodUnion* method_impl = methods_;
+  if (methods_sorted_) {
+    size_t low = 0;
+    size_t high = method_count_;
 
-  for (size_t i = 0; i < method_count_; ++i) {
-    const internal::Method* method = &method_impl->method();
-    if (method->id() == method_id) {
-      return method;
+    while (low < high) {
+      const size_t mid = low + (high - low) / 2;
+      const internal::Method& method = MethodAt(mid);
+      if (method.id() == method_id) {
+        return &method;
+      }
+      if (method.id() < method_id) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
     }
+    return nullptr;
+  }
 
-    const auto raw = reinterpret_cast<const std::byte*>(method_impl);
-    method_impl =
-        reinterpret_cast<const internal::MethodUnion*>(raw + method_size_);
+  for (size_t i = 0; i < method_count_; ++i) {
+    const internal::Method& method = MethodAt(i);
+    if (method.id() == method_id) {
+      return &method;
+    }
   }
 
   return nullptr;
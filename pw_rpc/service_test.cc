@@ -24,6 +24,12 @@ class ServiceTestHelper {
   static const internal::Method* FindMethod(Service& service, uint32_t id) {
     return service.FindMethod(id);
   }
+
+  static void CheckMethodOrder(Service& service) { service.CheckMethodOrder(); }
+
+  static bool MethodsSorted(const Service& service) {
+    return service.methods_sorted_;
+  }
 };
 
 namespace {
@@ -80,6 +86,46 @@ TEST(Service, MultipleMethods_FindMethod_NotPresent) {
   EXPECT_EQ(ServiceTestHelper::FindMethod(service, 999), nullptr);
 }
 
+TEST(Service, SortedMethods_FindMethod_UsesSortedLookup) {
+  TestService service;
+  ServiceTestHelper::CheckMethodOrder(service);
+  ASSERT_TRUE(ServiceTestHelper::MethodsSorted(service));
+
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 123),
+            &TestService::kMethods[0].method());
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 456),
+            &TestService::kMethods[1].method());
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 789),
+            &TestService::kMethods[2].method());
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 0), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 457), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 999), nullptr);
+}
+
+class UnsortedTestService : public Service {
+ public:
+  constexpr UnsortedTestService() : Service(0xabcd, kMethods) {}
+
+  static constexpr std::array<ServiceTestMethodUnion, 4> kMethods = {
+      ServiceTestMethod(789, 'a'),
+      ServiceTestMethod(123, 'b'),
+      ServiceTestMethod(999, 'c'),
+      ServiceTestMethod(456, 'd'),
+  };
+};
+
+TEST(Service, UnsortedMethods_FindMethod_Present) {
+  UnsortedTestService service;
+  ServiceTestHelper::CheckMethodOrder(service);
+  ASSERT_FALSE(ServiceTestHelper::MethodsSorted(service));
+
+  for (const ServiceTestMethodUnion& method : UnsortedTestService::kMethods) {
+    EXPECT_EQ(ServiceTestHelper::FindMethod(service, method.method().id()),
+              &method.method());
+  }
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 457), nullptr);
+}
+
 class EmptyTestService : public Service {
  public:
   constexpr EmptyTestService() : Service(0xabcd, kMethods) {}
@@ -0,0 +1,139 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PW_RPC"
+
+#include "pw_rpc_transport/channel_rpc_transport.h"
+
+#include <array>
+
+#include "pw_assert/check.h"
+#include "pw_log/log.h"
+#include "pw_multibuf/multibuf.h"
+#include "pw_status/try.h"
+
+namespace pw::rpc {
+
+ChannelRpcTransport::ChannelRpcTransport(channel::ByteReaderWriter& channel,
+                                         ByteSpan tx_buffer,
+                                         size_t mtu)
+    : channel_(channel),
+      mtu_(mtu),
+      tx_queue_(tx_buffer),
+      tx_writer_(tx_queue_) {
+  PW_CHECK_UINT_NE(mtu_, 0);
+  PW_CHECK_UINT_LE(mtu_, tx_queue_.max_write_size());
+}
+
+Status ChannelRpcTransport::Send(RpcFrame frame) {
+  const std::array<ConstByteSpan, 2> buffers = {frame.header, frame.payload};
+  return tx_writer_.Write(buffers);
+}
+
+async2::Poll<> ChannelRpcTransport::DoPend(async2::Context& cx) {
+  Status status = ReadIncoming(cx);
+  if (status.ok()) {
+    status = WriteOutgoing(cx);
+  }
+  if (!status.ok()) {
+    PW_LOG_ERROR("ChannelRpcTransport: channel error. Status %d",
+                 status.code());
+    tx_queue_.Close();
+    return async2::Ready();
+  }
+  return async2::Pending();
+}
+
+Status ChannelRpcTransport::ReadIncoming(async2::Context& cx) {
+  while (true) {
+    async2::Poll<Result<multibuf::MultiBuf>> read = channel_.PendRead(cx);
+    if (read.IsPending()) {
+      return OkStatus();
+    }
+    if (!read->ok()) {
+      return read->status();
+    }
+    if (ingress_ == nullptr) {
+      PW_LOG_ERROR("ChannelRpcTransport: no ingress handler, dropping data");
+      continue;
+    }
+    for (const multibuf::Chunk& chunk : (*read)->Chunks()) {
+      const Status status =
+          ingress_->ProcessIncomingData(ConstByteSpan(chunk.data(), chunk.size()));
+      if (!status.ok()) {
+        PW_LOG_ERROR("ChannelRpcTransport: ingress handler error. Status %d",
+                     status.code());
+      }
+    }
+  }
+}
+
+Status ChannelRpcTransport::WriteOutgoing(async2::Context& cx) {
+  bool wrote = false;
+  while (true) {
+    if (!write_buffer_.has_value()) {
+      if (tx_queue_.PendReadable(cx).IsPending()) {
+        break;
+      }
+      async2::Poll<Status> ready = channel_.PendReadyToWrite(cx);
+      if (ready.IsPending()) {
+        break;
+      }
+      if (!ready->ok()) {
+        return *ready;
+      }
+      write_buffer_ = channel_.GetWriteAllocator().AllocateAsync(1, mtu_);
+    }
+
+    async2::Poll<std::optional<multibuf::MultiBuf>> buffer =
+        write_buffer_->Pend(cx);
+    if (buffer.IsPending()) {
+      break;
+    }
+    write_buffer_.reset();
+    if (!buffer->has_value()) {
+      return Status::ResourceExhausted();
+    }
+
+    // Fill the buffer with as many queued bytes as fit.
+    multibuf::MultiBuf& data = **buffer;
+    size_t size = 0;
+    for (multibuf::Chunk& chunk : data.Chunks()) {
+      Result<ByteSpan> result = tx_queue_.Read(ByteSpan(chunk.data(), chunk.size()));
+      if (!result.ok()) {
+        break;
+      }
+      size += result->size();
+      if (result->size() < chunk.size()) {
+        break;
+      }
+    }
+    if (size == 0) {
+      break;
+    }
+    data.Truncate(size);
+    PW_TRY(channel_.Write(std::move(data)).status());
+    wrote = true;
+  }
+
+  if (wrote) {
+    async2::Poll<Result<channel::WriteToken>> flushed = channel_.PendFlush(cx);
+    if (flushed.IsReady() && !flushed->ok()) {
+      return flushed->status();
+    }
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::rpc
@@ -0,0 +1,139 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_rpc_transport/channel_rpc_transport.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "pw_allocator/testing.h"
+#include "pw_async2/dispatcher.h"
+#include "pw_bytes/array.h"
+#include "pw_channel/forwarding_channel.h"
+#include "pw_multibuf/simple_allocator.h"
+#include "pw_rpc_transport/rpc_transport.h"
+#include "pw_status/status.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::rpc {
+namespace {
+
+using ::pw::async2::Context;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::Waker;
+
+constexpr size_t kMtu = 32;
+
+// An ingress handler that stores all received data.
+class TestIngress : public RpcIngressHandler {
+ public:
+  Status ProcessIncomingData(ConstByteSpan buffer) override {
+    data_.insert(data_.end(), buffer.begin(), buffer.end());
+    return OkStatus();
+  }
+
+  const std::vector<std::byte>& data() const { return data_; }
+
+ private:
+  std::vector<std::byte> data_;
+};
+
+class ChannelRpcTransportTest : public ::testing::Test {
+ protected:
+  ChannelRpcTransportTest()
+      : simple_allocator_(data_area_, meta_alloc_),
+        pair_(simple_allocator_),
+        transport_a_(pair_.first(), tx_buffer_a_, kMtu, ingress_a_),
+        transport_b_(pair_.second(), tx_buffer_b_, kMtu, ingress_b_) {
+    dispatcher_.Post(transport_a_);
+    dispatcher_.Post(transport_b_);
+  }
+
+  std::array<std::byte, 1024> data_area_;
+  allocator::test::AllocatorForTest<2048> meta_alloc_;
+  multibuf::SimpleAllocator simple_allocator_;
+  channel::ForwardingByteChannelPair pair_;
+
+  alignas(uint32_t) std::array<std::byte, 128> tx_buffer_a_;
+  alignas(uint32_t) std::array<std::byte, 128> tx_buffer_b_;
+  TestIngress ingress_a_;
+  TestIngress ingress_b_;
+  ChannelRpcTransport transport_a_;
+  ChannelRpcTransport transport_b_;
+  Dispatcher dispatcher_;
+};
+
+TEST_F(ChannelRpcTransportTest, SendsFramesToPeer) {
+  constexpr auto kHeader = bytes::Array<1, 2>();
+  constexpr auto kPayload = bytes::Array<3, 4, 5>();
+  EXPECT_EQ(transport_a_.MaximumTransmissionUnit(), kMtu);
+  EXPECT_EQ(transport_a_.Send({.header = kHeader, .payload = kPayload}),
+            OkStatus());
+  EXPECT_EQ(transport_a_.Send({.header = {}, .payload = kPayload}),
+            OkStatus());
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+
+  constexpr auto kExpected = bytes::Array<1, 2, 3, 4, 5, 3, 4, 5>();
+  EXPECT_TRUE(std::equal(ingress_b_.data().begin(),
+                         ingress_b_.data().end(),
+                         kExpected.begin(),
+                         kExpected.end()));
+  EXPECT_TRUE(ingress_a_.data().empty());
+}
+
+TEST_F(ChannelRpcTransportTest, SendsInBothDirections) {
+  constexpr auto kRequest = bytes::Array<0x10, 0x11>();
+  constexpr auto kResponse = bytes::Array<0x20, 0x21, 0x22>();
+  EXPECT_EQ(transport_a_.Send({.header = {}, .payload = kRequest}), OkStatus());
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  EXPECT_EQ(transport_b_.Send({.header = {}, .payload = kResponse}),
+            OkStatus());
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+
+  EXPECT_EQ(ingress_b_.data().size(), kRequest.size());
+  EXPECT_EQ(ingress_a_.data().size(), kResponse.size());
+}
+
+TEST_F(ChannelRpcTransportTest, SendFailsWhenQueueIsFull) {
+  std::array<std::byte, kMtu> frame{};
+  size_t sent = 0;
+  while (transport_a_.Send({.header = {}, .payload = frame}).ok()) {
+    ++sent;
+  }
+  EXPECT_EQ(sent, 3u);
+  EXPECT_EQ(transport_a_.Send({.header = {}, .payload = frame}),
+            Status::ResourceExhausted());
+
+  // Once the task drains the queue, frames can be sent again.
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  EXPECT_EQ(ingress_b_.data().size(), sent * kMtu);
+  EXPECT_EQ(transport_a_.Send({.header = {}, .payload = frame}), OkStatus());
+}
+
+TEST_F(ChannelRpcTransportTest, StopsWhenChannelCloses) {
+  Waker empty_waker;
+  Context empty_cx(dispatcher_, empty_waker);
+  EXPECT_EQ(pair_.second().PendClose(empty_cx), async2::Ready(OkStatus()));
+
+  // transport_a_ sees the closed channel and finishes. transport_b_ is left
+  // with a closed channel, which fails its reads.
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsReady());
+  constexpr auto kPayload = bytes::Array<1>();
+  EXPECT_EQ(transport_a_.Send({.header = {}, .payload = kPayload}),
+            Status::OutOfRange());
+}
+
+}  // namespace
+}  // namespace pw::rpc
@@ -402,5 +402,42 @@ TEST(RpcEgressIngressTest, EgressSendFailureForIncomingPacket) {
   EXPECT_EQ(ingress.num_egress_errors(), 1u);
 }
 
+TEST(RpcEgressIngressTest, SendRpcPacketsSendsAllPacketsInOrder) {
+  constexpr size_t kMtu = 16;
+  TestTransport transport(kMtu);
+  SimpleRpcEgress<kMaxPacketSize> egress("egress", transport);
+
+  std::array<std::byte, 20> first;
+  std::array<std::byte, 5> second;
+  std::fill(first.begin(), first.end(), std::byte{0x11});
+  std::fill(second.begin(), second.end(), std::byte{0x22});
+  const std::array<ConstByteSpan, 2> packets = {first, second};
+  EXPECT_EQ(egress.SendRpcPackets(packets), OkStatus());
+
+  std::vector<std::vector<std::byte>> received;
+  SimpleRpcPacketDecoder<kMaxPacketSize> decoder;
+  EXPECT_EQ(decoder.Decode(transport.buffer(),
+                           [&received](ConstByteSpan packet) {
+                             received.emplace_back(packet.begin(),
+                                                   packet.end());
+                           }),
+            OkStatus());
+  ASSERT_EQ(received.size(), 2u);
+  EXPECT_TRUE(std::equal(
+      received[0].begin(), received[0].end(), first.begin(), first.end()));
+  EXPECT_TRUE(std::equal(
+      received[1].begin(), received[1].end(), second.begin(), second.end()));
+}
+
+TEST(RpcEgressIngressTest, SendRpcPacketsStopsAtFirstFailure) {
+  TestTransport transport(kMaxPacketSize, /*is_faulty=*/true);
+  SimpleRpcEgress<kMaxPacketSize> egress("egress", transport);
+
+  std::array<std::byte, 8> packet{};
+  const std::array<ConstByteSpan, 2> packets = {packet, packet};
+  EXPECT_EQ(egress.SendRpcPackets(packets), Status::Internal());
+  EXPECT_TRUE(transport.buffer().empty());
+}
+
 }  // namespace
 }  // namespace pw::rpc
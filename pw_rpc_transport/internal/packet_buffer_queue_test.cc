@@ -47,6 +47,20 @@ TEST(PacketBufferQueueTest, CopyAndGetPacket) {
   EXPECT_EQ(packet_buffer.CopyPacket(long_input), Status::ResourceExhausted());
 }
 
+TEST(PacketBufferQueueTest, FillStorageInPlace) {
+  PacketBufferQueue<kMaxPacketSize>::PacketBuffer packet_buffer = {};
+  ByteSpan storage = packet_buffer.storage();
+  ASSERT_EQ(storage.size(), kMaxPacketSize);
+
+  std::fill(storage.begin(), storage.begin() + 10, std::byte{0x42});
+  packet_buffer.set_packet_size(10);
+
+  auto packet = packet_buffer.GetPacket();
+  ASSERT_EQ(packet.status(), OkStatus());
+  ASSERT_EQ(packet->size(), 10ul);
+  EXPECT_EQ(packet->data(), storage.data());
+}
+
 TEST(PacketBufferQueueTest, PopWhenEmptyFails) {
   PacketBufferQueue<kMaxPacketSize> queue;
   EXPECT_EQ(queue.Pop().status(), Status::ResourceExhausted());
@@ -79,5 +93,40 @@ TEST(PacketQueueTest, PushPopSucceeds) {
   EXPECT_EQ(popped_packet_buffer.status(), OkStatus());
 }
 
+TEST(LockFreePacketBufferQueueTest, PopWhenEmptyFails) {
+  LockFreePacketBufferQueue<kMaxPacketSize, 3> queue;
+  EXPECT_EQ(queue.Pop().status(), Status::ResourceExhausted());
+}
+
+TEST(LockFreePacketBufferQueueTest, PopAllSucceeds) {
+  constexpr auto kPacketQueueSize = 3;
+  using Queue = LockFreePacketBufferQueue<kMaxPacketSize, kPacketQueueSize>;
+
+  std::array<Queue::PacketBuffer, kPacketQueueSize> packets;
+  Queue queue(packets);
+
+  for (size_t i = 0; i < kPacketQueueSize; ++i) {
+    EXPECT_EQ(queue.Pop().status(), OkStatus());
+  }
+
+  EXPECT_EQ(queue.Pop().status(), Status::ResourceExhausted());
+}
+
+TEST(LockFreePacketBufferQueueTest, PopsInPushOrder) {
+  constexpr auto kPacketQueueSize = 3;
+  using Queue = LockFreePacketBufferQueue<kMaxPacketSize, kPacketQueueSize>;
+
+  std::array<Queue::PacketBuffer, kPacketQueueSize> packets;
+  Queue queue;
+  queue.Push(packets[1]);
+  queue.Push(packets[0]);
+  queue.Push(packets[2]);
+
+  EXPECT_EQ(queue.Pop().value(), &packets[1]);
+  EXPECT_EQ(queue.Pop().value(), &packets[0]);
+  EXPECT_EQ(queue.Pop().value(), &packets[2]);
+  EXPECT_EQ(queue.Pop().status(), Status::ResourceExhausted());
+}
+
 }  // namespace
 }  // namespace pw::rpc::internal
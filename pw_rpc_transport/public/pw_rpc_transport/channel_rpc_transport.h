@@ -0,0 +1,84 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_bytes/span.h"
+#include "pw_channel/channel.h"
+#include "pw_multibuf/allocator.h"
+#include "pw_rpc_transport/rpc_transport.h"
+#include "pw_status/status.h"
+#include "pw_stream/lock_free_mpsc_stream.h"
+
+namespace pw::rpc {
+
+// RPC transport over a pw_channel byte channel. The transport is a pw_async2
+// Task: once posted to a dispatcher, it passes the data it reads from the
+// channel to its ingress handler and writes queued frames to the channel. A
+// single dispatcher can serve any number of these transports without a thread
+// per connection.
+//
+// Frames sent with Send() are queued in a lock-free ring buffer, so Send()
+// never blocks and may be called from any thread. The task completes once the
+// channel fails or is closed, after which Send() fails.
+class ChannelRpcTransport : public RpcFrameSender, public async2::Task {
+ public:
+  // `tx_buffer` holds frames until the task writes them to the channel. Its
+  // size must be a power of two, and it must be 4-byte aligned. `mtu` must
+  // leave room for a 4-byte header per frame in `tx_buffer`.
+  ChannelRpcTransport(channel::ByteReaderWriter& channel,
+                      ByteSpan tx_buffer,
+                      size_t mtu);
+
+  ChannelRpcTransport(channel::ByteReaderWriter& channel,
+                      ByteSpan tx_buffer,
+                      size_t mtu,
+                      RpcIngressHandler& ingress)
+      : ChannelRpcTransport(channel, tx_buffer, mtu) {
+    ingress_ = &ingress;
+  }
+
+  size_t MaximumTransmissionUnit() const override { return mtu_; }
+
+  // Must be set before the task is posted to a dispatcher.
+  void set_ingress(RpcIngressHandler& ingress) { ingress_ = &ingress; }
+
+  // Queues the frame to be written to the channel. Returns RESOURCE_EXHAUSTED
+  // if the transmit buffer is full, or OUT_OF_RANGE if the transport has
+  // stopped.
+  Status Send(RpcFrame frame) override;
+
+ private:
+  async2::Poll<> DoPend(async2::Context& cx) override;
+
+  // Passes all data that is available from the channel to the ingress.
+  // Returns OK once the channel has no more data for now.
+  Status ReadIncoming(async2::Context& cx);
+
+  // Writes all queued frames that the channel accepts. Returns OK once the
+  // queue is empty or the channel cannot accept more data for now.
+  Status WriteOutgoing(async2::Context& cx);
+
+  channel::ByteReaderWriter& channel_;
+  RpcIngressHandler* ingress_ = nullptr;
+  const size_t mtu_;
+  stream::LockFreeMpscReader tx_queue_;
+  stream::LockFreeMpscWriter tx_writer_;
+  std::optional<multibuf::MultiBufAllocationFuture> write_buffer_;
+};
+
+}  // namespace pw::rpc
@@ -24,7 +24,9 @@
 #include "pw_rpc_transport/hdlc_framing.h"
 #include "pw_rpc_transport/rpc_transport.h"
 #include "pw_rpc_transport/simple_framing.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 #include "pw_sync/lock_annotations.h"
 #include "pw_sync/mutex.h"
 #include "rpc_transport.h"
@@ -58,6 +60,25 @@ class RpcEgress : public RpcEgressHandler, public ChannelOutput {
   // internals.
   Status SendRpcPacket(ConstByteSpan rpc_packet) override {
     std::lock_guard lock(mutex_);
+    return SendLocked(rpc_packet);
+  }
+
+  // Sends several packets in order while holding the mutex once, rather than
+  // once per packet. Stops at the first packet that fails to send.
+  Status SendRpcPackets(span<const ConstByteSpan> rpc_packets) {
+    std::lock_guard lock(mutex_);
+    for (ConstByteSpan rpc_packet : rpc_packets) {
+      PW_TRY(SendLocked(rpc_packet));
+    }
+    return OkStatus();
+  }
+
+  // Implements ChannelOutput.
+  Status Send(ConstByteSpan buffer) override { return SendRpcPacket(buffer); }
+
+ private:
+  Status SendLocked(ConstByteSpan rpc_packet)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
     return encoder_.Encode(rpc_packet,
                            transport_.MaximumTransmissionUnit(),
                            [this](RpcFrame& frame) {
@@ -69,10 +90,6 @@ class RpcEgress : public RpcEgressHandler, public ChannelOutput {
                            });
   }
 
-  // Implements ChannelOutput.
-  Status Send(ConstByteSpan buffer) override { return SendRpcPacket(buffer); }
-
- private:
   sync::Mutex mutex_;
   RpcFrameSender& transport_;
   Encoder encoder_ PW_GUARDED_BY(mutex_);
@@ -13,9 +13,13 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <mutex>
+#include <optional>
 
+#include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
+#include "pw_containers/inline_mpmc_queue.h"
 #include "pw_containers/intrusive_list.h"
 #include "pw_result/result.h"
 #include "pw_span/span.h"
@@ -46,6 +50,15 @@ class PacketBufferQueue {
       return buffer_span.first(size_);
     }
 
+    // Returns the whole buffer, so that a packet can be encoded into it in
+    // place. The packet's size must then be set with set_packet_size().
+    ByteSpan storage() { return buffer_; }
+
+    void set_packet_size(size_t size) {
+      PW_ASSERT(size <= buffer_.size());
+      size_ = size;
+    }
+
    protected:
     friend PacketBufferQueue;
 
@@ -89,4 +102,49 @@ class PacketBufferQueue {
   IntrusiveList<PacketBuffer> packet_list_ PW_GUARDED_BY(lock_);
 };
 
+// A lock-free alternative to PacketBufferQueue that holds up to `kCapacity`
+// packets. Push() and Pop() never block, so concurrent senders never contend
+// on a lock. Pushing more than `kCapacity` packets is a fatal error.
+template <size_t kMaxPacketSize, size_t kCapacity>
+class LockFreePacketBufferQueue {
+ public:
+  using PacketBuffer = typename PacketBufferQueue<kMaxPacketSize>::PacketBuffer;
+
+  LockFreePacketBufferQueue() = default;
+  explicit LockFreePacketBufferQueue(span<PacketBuffer> packets) {
+    for (auto& packet : packets) {
+      Push(packet);
+    }
+  }
+
+  // Push a packet to the end of the queue.
+  void Push(PacketBuffer& packet) {
+    const bool pushed = queue_.TryPush(&packet);
+    PW_ASSERT(pushed);
+  }
+
+  // Pop a packet from the head of the queue.
+  // Returns a pointer to the packet popped from the queue, or
+  // ResourceExhausted() if the queue is empty.
+  Result<PacketBuffer*> Pop() {
+    std::optional<PacketBuffer*> packet = queue_.TryPop();
+    if (!packet.has_value()) {
+      return Status::ResourceExhausted();
+    }
+    return *packet;
+  }
+
+ private:
+  // InlineMpmcQueue requires a power-of-two capacity of at least 2.
+  static constexpr size_t QueueCapacity() {
+    size_t capacity = 2;
+    while (capacity < kCapacity) {
+      capacity *= 2;
+    }
+    return capacity;
+  }
+
+  InlineMpmcQueue<PacketBuffer*, QueueCapacity()> queue_;
+};
+
 }  // namespace pw::rpc::internal
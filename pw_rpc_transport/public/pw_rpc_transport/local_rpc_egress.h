@@ -19,9 +19,12 @@
 #include "pw_bytes/span.h"
 #include "pw_result/result.h"
 #include "pw_rpc/channel.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_rpc/internal/packet.h"
 #include "pw_rpc_transport/internal/packet_buffer_queue.h"
 #include "pw_rpc_transport/rpc_transport.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 #include "pw_sync/thread_notification.h"
 #include "pw_thread/thread_core.h"
 #include "rpc_transport.h"
@@ -42,8 +45,9 @@ template <size_t kPacketQueueSize, size_t kMaxPacketSize>
 class LocalRpcEgress : public RpcEgressHandler,
                        public ChannelOutput,
                        public thread::ThreadCore {
-  using PacketBuffer =
-      typename internal::PacketBufferQueue<kMaxPacketSize>::PacketBuffer;
+  using PacketBufferQueue =
+      internal::LockFreePacketBufferQueue<kMaxPacketSize, kPacketQueueSize>;
+  using PacketBuffer = typename PacketBufferQueue::PacketBuffer;
 
  public:
   LocalRpcEgress() : ChannelOutput("RPC local egress") {}
@@ -59,7 +63,8 @@ class LocalRpcEgress : public RpcEgressHandler,
   // by another thread. Implements RpcEgressHandler.
   Status SendRpcPacket(ConstByteSpan rpc_packet) override;
 
-  // Implements ChannelOutput.
+  // Implements ChannelOutput. Only used for packets that are not encoded by
+  // pw_rpc itself; see EncodeAndSend().
   Status Send(ConstByteSpan buffer) override { return SendRpcPacket(buffer); }
 
   // Once stopped, LocalRpcEgress will no longer process data and
@@ -74,43 +79,91 @@ class LocalRpcEgress : public RpcEgressHandler,
   }
 
  private:
+  // Encodes packets sent by pw_rpc directly into a queued packet buffer,
+  // rather than into pw_rpc's shared encoding buffer, from which Send() would
+  // have to copy them.
+  Status EncodeAndSend(const internal::Packet& packet) override
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock());
+
+  // Takes a free packet buffer from the pool.
+  Result<PacketBuffer*> AcquirePacketBuffer();
+
+  // Queues a filled packet buffer for processing.
+  Status Enqueue(PacketBuffer& packet_buffer);
+
   void Run() override;
 
   sync::ThreadNotification process_queue_;
   RpcPacketProcessor* packet_processor_ = nullptr;
   std::array<PacketBuffer, kPacketQueueSize> packet_storage_;
-  internal::PacketBufferQueue<kMaxPacketSize> packet_queue_{packet_storage_};
-  internal::PacketBufferQueue<kMaxPacketSize> transmit_queue_ = {};
+  PacketBufferQueue packet_queue_{packet_storage_};
+  PacketBufferQueue transmit_queue_ = {};
   std::atomic<bool> stopped_ = false;
 };
 
 template <size_t kPacketQueueSize, size_t kMaxPacketSize>
 Status LocalRpcEgress<kPacketQueueSize, kMaxPacketSize>::SendRpcPacket(
     ConstByteSpan packet) {
-  if (!packet_processor_) {
-    internal::LogNoRpcServiceRegistryError();
-    return Status::FailedPrecondition();
-  }
   if (packet.size() > kMaxPacketSize) {
     internal::LogPacketSizeTooLarge(packet.size(), kMaxPacketSize);
     return Status::InvalidArgument();
   }
+
+  // Grab a free packet from the egress' pool, copy incoming frame and
+  // push it the queue for processing.
+  PW_TRY_ASSIGN(PacketBuffer * packet_buffer, AcquirePacketBuffer());
+  if (const Status status = packet_buffer->CopyPacket(packet); !status.ok()) {
+    packet_queue_.Push(*packet_buffer);
+    return status;
+  }
+  return Enqueue(*packet_buffer);
+}
+
+template <size_t kPacketQueueSize, size_t kMaxPacketSize>
+Status LocalRpcEgress<kPacketQueueSize, kMaxPacketSize>::EncodeAndSend(
+    const internal::Packet& packet) {
+  Result<PacketBuffer*> packet_buffer = AcquirePacketBuffer();
+  if (!packet_buffer.ok()) {
+    return Status::Unknown();
+  }
+
+  Result<ConstByteSpan> encoded = packet.Encode((*packet_buffer)->storage());
+  if (!encoded.ok()) {
+    packet_queue_.Push(**packet_buffer);
+    internal::LogPacketSizeTooLarge(
+        packet.payload().size() +
+            internal::Packet::kMinEncodedSizeWithoutPayload,
+        kMaxPacketSize);
+    return Status::Unknown();
+  }
+  (*packet_buffer)->set_packet_size(encoded->size());
+
+  return Enqueue(**packet_buffer).ok() ? OkStatus() : Status::Unknown();
+}
+
+template <size_t kPacketQueueSize, size_t kMaxPacketSize>
+Result<typename LocalRpcEgress<kPacketQueueSize, kMaxPacketSize>::PacketBuffer*>
+LocalRpcEgress<kPacketQueueSize, kMaxPacketSize>::AcquirePacketBuffer() {
+  if (!packet_processor_) {
+    internal::LogNoRpcServiceRegistryError();
+    return Status::FailedPrecondition();
+  }
   if (stopped_) {
     internal::LogEgressThreadNotRunningError();
     return Status::FailedPrecondition();
   }
 
-  // Grab a free packet from the egress' pool, copy incoming frame and
-  // push it the queue for processing.
-  auto packet_buffer = packet_queue_.Pop();
+  Result<PacketBuffer*> packet_buffer = packet_queue_.Pop();
   if (!packet_buffer.ok()) {
     internal::LogNoPacketAvailable(packet_buffer.status());
-    return packet_buffer.status();
   }
+  return packet_buffer;
+}
 
-  PW_TRY(packet_buffer.value()->CopyPacket(packet));
-
-  transmit_queue_.Push(**packet_buffer);
+template <size_t kPacketQueueSize, size_t kMaxPacketSize>
+Status LocalRpcEgress<kPacketQueueSize, kMaxPacketSize>::Enqueue(
+    PacketBuffer& packet_buffer) {
+  transmit_queue_.Push(packet_buffer);
 
   process_queue_.release();
 
@@ -15,6 +15,7 @@
 
 #include <signal.h>
 
+#include <array>
 #include <atomic>
 #include <mutex>
 
@@ -75,11 +76,11 @@ class SocketRpcTransport : public RpcFrameSender, public thread::ThreadCore {
   size_t port() const { return port_; }
   void set_ingress(RpcIngressHandler& ingress) { ingress_ = &ingress; }
 
+  // Sends the frame's header and payload with a single vectored write.
   Status Send(RpcFrame frame) override {
     std::lock_guard lock(write_mutex_);
-    PW_TRY(socket_stream_.Write(frame.header));
-    PW_TRY(socket_stream_.Write(frame.payload));
-    return OkStatus();
+    const std::array<ConstByteSpan, 2> buffers = {frame.header, frame.payload};
+    return socket_stream_.Write(buffers);
   }
 
   // Returns once the transport is connected to its peer.
@@ -13,9 +13,10 @@
 // the License.
 #pragma once
 
+#include <array>
+
 #include "pw_rpc_transport/rpc_transport.h"
 #include "pw_status/status.h"
-#include "pw_status/try.h"
 #include "pw_stream/stream.h"
 
 namespace pw::rpc {
@@ -29,10 +30,8 @@ class StreamRpcFrameSender : public RpcFrameSender {
   size_t MaximumTransmissionUnit() const override { return kMtu; }
 
   Status Send(RpcFrame frame) override {
-    if (!frame.header.empty()) {
-      PW_TRY(writer_.Write(frame.header));
-    }
-    return writer_.Write(frame.payload);
+    const std::array<ConstByteSpan, 2> buffers = {frame.header, frame.payload};
+    return writer_.Write(buffers);
   }
 
  private:
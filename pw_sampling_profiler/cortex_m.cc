@@ -0,0 +1,71 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sampling_profiler/cortex_m.h"
+
+#include <atomic>
+
+#include "pw_cpu_exception_cortex_m/cpu_state.h"
+#include "pw_preprocessor/arch.h"
+#include "pw_preprocessor/compiler.h"
+
+#if !_PW_ARCH_ARM_CORTEX_M
+#error "pw_sampling_profiler:cortex_m only supports ARM Cortex-M cores"
+#endif  // !_PW_ARCH_ARM_CORTEX_M
+
+namespace pw::sampling_profiler::cortex_m {
+namespace {
+
+std::atomic<Profiler*> sample_isr_profiler = nullptr;
+
+}  // namespace
+
+void SetSampleIsrProfiler(Profiler& profiler) {
+  sample_isr_profiler.store(&profiler, std::memory_order_release);
+}
+
+}  // namespace pw::sampling_profiler::cortex_m
+
+// Called by pw_sampling_profiler_cortex_m_SampleIsr() with LR still holding
+// EXC_RETURN, so returning from this function returns from the exception.
+extern "C" void pw_sampling_profiler_cortex_m_RecordSample(
+    const pw::cpu_exception::cortex_m::ExceptionRegisters* frame) {
+  pw_sampling_profiler_cortex_m_AcknowledgeSampleInterrupt();
+
+  pw::sampling_profiler::Profiler* profiler =
+      pw::sampling_profiler::cortex_m::sample_isr_profiler.load(
+          std::memory_order_acquire);
+  if (profiler != nullptr) {
+    profiler->RecordSample(frame->pc, frame->lr);
+  }
+}
+
+// The exception frame is on the stack the interrupted context was using, so
+// the stack pointer must be read before anything is pushed to it. This is
+// written in Thumb-1 assembly so it also runs on ARMv6-M cores.
+PW_NO_PROLOGUE void pw_sampling_profiler_cortex_m_SampleIsr() {
+  asm volatile(
+      // Bit 2 of EXC_RETURN is set if the frame is on the process stack.
+      "mov r0, lr                                        \n"
+      "movs r1, #4                                       \n"
+      "tst r0, r1                                        \n"
+      "bne 1f                                            \n"
+      "mrs r0, msp                                       \n"
+      "b 2f                                              \n"
+      "1:                                                \n"
+      "mrs r0, psp                                       \n"
+      "2:                                                \n"
+      "ldr r1, =pw_sampling_profiler_cortex_m_RecordSample\n"
+      "bx r1                                             \n");
+}
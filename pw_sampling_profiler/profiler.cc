@@ -0,0 +1,40 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_TRACE_MODULE_NAME "pw_sampling_profiler"
+
+#include "pw_sampling_profiler/profiler.h"
+
+#include <array>
+
+#include "pw_trace/trace.h"
+
+namespace pw::sampling_profiler {
+
+size_t Profiler::DrainToTrace() {
+  std::array<Sample, 8> samples;
+  size_t total = 0;
+  size_t count;
+  while ((count = ReadSamples(samples)) != 0) {
+    for (size_t i = 0; i < count; ++i) {
+      const std::array<uint32_t, 2> data = {samples[i].pc, samples[i].lr};
+      PW_TRACE_INSTANT_DATA(
+          "sample", "@pw_py_struct_fmt:<II", data.data(), sizeof(data));
+    }
+    total += count;
+  }
+  return total;
+}
+
+}  // namespace pw::sampling_profiler
@@ -0,0 +1,71 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sampling_profiler/profiler.h"
+
+#include <array>
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::sampling_profiler {
+namespace {
+
+class ProfilerTest : public ::testing::Test {
+ protected:
+  ProfilerTest() : profiler_(buffer_) {}
+
+  SampleBuffer<4> buffer_;
+  Profiler profiler_;
+};
+
+TEST_F(ProfilerTest, IgnoresSamplesUntilStarted) {
+  EXPECT_FALSE(profiler_.running());
+  profiler_.RecordSample(0x100, 0x200);
+
+  std::array<Sample, 4> samples{};
+  EXPECT_EQ(profiler_.ReadSamples(samples), 0u);
+}
+
+TEST_F(ProfilerTest, RecordsSamplesWhileRunning) {
+  profiler_.Start();
+  EXPECT_TRUE(profiler_.running());
+  profiler_.RecordSample(0x100, 0x200);
+  profiler_.Stop();
+  profiler_.RecordSample(0x104, 0x204);
+
+  std::array<Sample, 4> samples{};
+  ASSERT_EQ(profiler_.ReadSamples(samples), 1u);
+  EXPECT_EQ(samples[0].pc, 0x100u);
+  EXPECT_EQ(samples[0].lr, 0x200u);
+}
+
+TEST_F(ProfilerTest, CountsDroppedSamples) {
+  profiler_.Start();
+  for (uint32_t i = 0; i < 6; ++i) {
+    profiler_.RecordSample(i, 0);
+  }
+  EXPECT_EQ(profiler_.dropped_samples(), 2u);
+}
+
+TEST_F(ProfilerTest, DrainToTraceRemovesAllSamples) {
+  profiler_.Start();
+  for (uint32_t i = 0; i < 4; ++i) {
+    profiler_.RecordSample(i, 0);
+  }
+  EXPECT_EQ(profiler_.DrainToTrace(), 4u);
+  EXPECT_EQ(profiler_.DrainToTrace(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::sampling_profiler
@@ -0,0 +1,49 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_preprocessor/util.h"
+
+#ifdef __cplusplus
+
+#include "pw_sampling_profiler/profiler.h"
+
+namespace pw::sampling_profiler::cortex_m {
+
+/// Sets the profiler that `pw_sampling_profiler_cortex_m_SampleIsr()` records
+/// samples to. Samples are discarded until this is called.
+void SetSampleIsrProfiler(Profiler& profiler);
+
+}  // namespace pw::sampling_profiler::cortex_m
+
+#endif  // __cplusplus
+
+PW_EXTERN_C_START
+
+/// Interrupt handler for the sampling timer. Install it in the vector table
+/// entry of a periodic timer interrupt, such as SysTick or a spare hardware
+/// timer, with a priority higher than the code to profile.
+///
+/// The handler reads the PC and LR of the interrupted context from the
+/// exception frame the core stacked on entry, which has the layout of
+/// `pw::cpu_exception::cortex_m::ExceptionRegisters`. It then calls
+/// `pw_sampling_profiler_cortex_m_AcknowledgeSampleInterrupt()` and records
+/// the sample.
+void pw_sampling_profiler_cortex_m_SampleIsr(void);
+
+/// Clears the pending sampling timer interrupt, so that the interrupt doesn't
+/// fire again until the next period. This must be implemented by the target.
+void pw_sampling_profiler_cortex_m_AcknowledgeSampleInterrupt(void);
+
+PW_EXTERN_C_END
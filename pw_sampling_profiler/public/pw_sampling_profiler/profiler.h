@@ -0,0 +1,77 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_sampling_profiler/sample_buffer.h"
+#include "pw_span/span.h"
+
+namespace pw::sampling_profiler {
+
+/// Collects samples of the program counter from a periodic interrupt, to show
+/// where CPU time is spent.
+///
+/// The sampling interrupt calls `RecordSample()` with the state of the context
+/// it interrupted, which only queues the sample. A thread periodically calls
+/// `DrainToTrace()` to move queued samples out of the interrupt's way, as
+/// trace events that `pw_trace_tokenized` transports to the host.
+class Profiler {
+ public:
+  explicit constexpr Profiler(GenericSampleBuffer& buffer) : buffer_(buffer) {}
+
+  Profiler(const Profiler&) = delete;
+  Profiler& operator=(const Profiler&) = delete;
+
+  /// Starts recording samples. Samples are ignored until this is called.
+  void Start() { running_.store(true, std::memory_order_relaxed); }
+
+  /// Stops recording samples. Queued samples can still be drained.
+  void Stop() { running_.store(false, std::memory_order_relaxed); }
+
+  bool running() const { return running_.load(std::memory_order_relaxed); }
+
+  /// Queues a sample if the profiler is running. Must only be called from the
+  /// sampling interrupt.
+  void RecordSample(uint32_t pc, uint32_t lr) {
+    if (running()) {
+      buffer_.TryPush({pc, lr});
+    }
+  }
+
+  /// Removes up to `samples.size()` queued samples, oldest first.
+  ///
+  /// @returns The number of samples removed.
+  size_t ReadSamples(span<Sample> samples) { return buffer_.Pop(samples); }
+
+  /// Removes all queued samples and emits each as an instant trace event of
+  /// the `pw_sampling_profiler` module, labelled `sample`. The event's data is
+  /// the sample's PC followed by its LR, as little-endian `uint32_t`s. Tracing
+  /// must be enabled for the events to be recorded.
+  ///
+  /// @returns The number of samples drained.
+  size_t DrainToTrace();
+
+  /// @returns The number of samples dropped because the queue was full. If
+  /// this grows, drain more often or queue more samples.
+  uint32_t dropped_samples() const { return buffer_.dropped(); }
+
+ private:
+  GenericSampleBuffer& buffer_;
+  std::atomic<bool> running_ = false;
+};
+
+}  // namespace pw::sampling_profiler
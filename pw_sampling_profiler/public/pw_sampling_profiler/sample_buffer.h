@@ -0,0 +1,105 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+
+namespace pw::sampling_profiler {
+
+/// The state of an interrupted context, recorded by a sampling interrupt.
+struct Sample {
+  /// The address of the instruction that was interrupted.
+  uint32_t pc;
+
+  /// The link register, which is usually the return address into the caller
+  /// of the interrupted function. It may be stale in functions that have
+  /// already saved it and called other functions.
+  uint32_t lr;
+};
+
+/// A lock-free queue of samples with a single producer, the sampling
+/// interrupt, and a single consumer, the thread that drains samples.
+///
+/// Pushing and popping only use atomic loads and stores, which are lock-free
+/// on every core, including ARMv6-M cores without exclusive access
+/// instructions. A sample pushed while the queue is full is dropped and
+/// counted, so the interrupt never waits for the consumer.
+///
+/// `GenericSampleBuffer` is the size-independent interface to `SampleBuffer`.
+class GenericSampleBuffer {
+ public:
+  GenericSampleBuffer(const GenericSampleBuffer&) = delete;
+  GenericSampleBuffer& operator=(const GenericSampleBuffer&) = delete;
+
+  /// Adds a sample to the queue. Must only be called by the producer.
+  ///
+  /// @returns `false` if the queue is full and the sample was dropped.
+  bool TryPush(const Sample& sample);
+
+  /// Removes up to `samples.size()` samples from the queue, oldest first.
+  /// Must only be called by the consumer.
+  ///
+  /// @returns The number of samples removed.
+  size_t Pop(span<Sample> samples);
+
+  /// @returns The number of samples that are queued. This is only exact when
+  /// called by the producer or the consumer.
+  size_t size() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+
+  size_t capacity() const { return storage_.size(); }
+
+  /// @returns The number of samples dropped because the queue was full.
+  uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+ protected:
+  // The size of storage must be a power of two, which SampleBuffer checks.
+  explicit GenericSampleBuffer(span<Sample> storage) : storage_(storage) {}
+
+  ~GenericSampleBuffer() = default;
+
+ private:
+  // Free-running counts of the samples pushed and popped, which index storage_
+  // modulo its size. Since the size is a power of two, this stays correct when
+  // the counts wrap.
+  std::atomic<uint32_t> head_ = 0;  // Only written by the consumer.
+  std::atomic<uint32_t> tail_ = 0;  // Only written by the producer.
+
+  // Only written by the producer.
+  std::atomic<uint32_t> dropped_ = 0;
+
+  span<Sample> storage_;
+};
+
+/// A `GenericSampleBuffer` with storage for `kCapacity` samples.
+template <size_t kCapacity>
+class SampleBuffer final : public GenericSampleBuffer {
+ public:
+  static_assert(kCapacity > 0 && (kCapacity & (kCapacity - 1)) == 0,
+                "The capacity of a SampleBuffer must be a power of two");
+
+  SampleBuffer() : GenericSampleBuffer(storage_) {}
+
+ private:
+  std::array<Sample, kCapacity> storage_;
+};
+
+}  // namespace pw::sampling_profiler
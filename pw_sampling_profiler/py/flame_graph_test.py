@@ -0,0 +1,119 @@
+# Copyright 2024 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Tests for pw_sampling_profiler.flame_graph."""
+
+import io
+import unittest
+
+from pw_symbolizer import FakeSymbolizer, Symbol
+from pw_trace.trace import TraceEvent, TraceType
+
+from pw_sampling_profiler.flame_graph import (
+    Sample,
+    fold_samples,
+    samples_from_trace,
+    write_folded,
+)
+
+# Every address within these functions symbolizes to the function.
+_FUNCTIONS = {
+    'main': range(0x1000, 0x1100),
+    'Filter': range(0x2000, 0x2100),
+    'Idle': range(0x3000, 0x3100),
+}
+_SYMBOLIZER = FakeSymbolizer(
+    Symbol(address, name)
+    for name, addresses in _FUNCTIONS.items()
+    for address in addresses
+)
+
+
+def _event(module: str, label: str, data: bytes) -> TraceEvent:
+    return TraceEvent(
+        event_type=TraceType.INSTANTANEOUS,
+        module=module,
+        label=label,
+        timestamp_us=0,
+        has_data=True,
+        data_fmt='@pw_py_struct_fmt:<II',
+        data=data,
+    )
+
+
+class SamplesFromTraceTest(unittest.TestCase):
+    """Tests extracting samples from trace events."""
+
+    def test_decodes_sample_events(self) -> None:
+        events = [
+            _event(
+                'pw_sampling_profiler',
+                'sample',
+                bytes.fromhex('00200000 05100000'),
+            ),
+            _event('other_module', 'sample', bytes(8)),
+            _event('pw_sampling_profiler', 'other', bytes(8)),
+            _event('pw_sampling_profiler', 'sample', bytes(4)),
+        ]
+        self.assertEqual(
+            list(samples_from_trace(events)), [Sample(0x2000, 0x1005)]
+        )
+
+
+class FoldSamplesTest(unittest.TestCase):
+    """Tests folding samples into stacks."""
+
+    def test_folds_caller_and_function(self) -> None:
+        stacks = fold_samples(
+            [
+                Sample(pc=0x2010, lr=0x1041),
+                Sample(pc=0x2020, lr=0x1041),
+                Sample(pc=0x3000, lr=0x1081),
+            ],
+            _SYMBOLIZER,
+        )
+        self.assertEqual(stacks, {'main;Filter': 2, 'main;Idle': 1})
+
+    def test_omits_invalid_caller(self) -> None:
+        stacks = fold_samples(
+            [Sample(pc=0x3000, lr=0xFFFFFFFD), Sample(pc=0x3004, lr=0)],
+            _SYMBOLIZER,
+        )
+        self.assertEqual(stacks, {'Idle': 2})
+
+    def test_omits_stale_lr_in_same_function(self) -> None:
+        stacks = fold_samples([Sample(pc=0x2000, lr=0x2041)], _SYMBOLIZER)
+        self.assertEqual(stacks, {'Filter': 1})
+
+    def test_unknown_addresses_use_hex(self) -> None:
+        stacks = fold_samples([Sample(pc=0x8000, lr=0)], _SYMBOLIZER)
+        self.assertEqual(stacks, {'0x00008000': 1})
+
+    def test_write_folded_most_common_first(self) -> None:
+        output = io.StringIO()
+        write_folded(
+            fold_samples(
+                [
+                    Sample(pc=0x3000, lr=0),
+                    Sample(pc=0x2000, lr=0x1041),
+                    Sample(pc=0x2000, lr=0x1041),
+                ],
+                _SYMBOLIZER,
+            ),
+            output,
+        )
+        self.assertEqual(output.getvalue(), 'main;Filter 2\nIdle 1\n')
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,174 @@
+# Copyright 2024 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Builds flame graphs from pw_sampling_profiler samples.
+
+Samples are read from a tokenized trace, symbolized with pw_symbolizer, and
+written as folded stacks, one line per distinct stack followed by its sample
+count. Folded stacks can be rendered by flamegraph.pl, speedscope, or
+inferno-flamegraph.
+
+Each sample only holds the PC and LR of the interrupted code, so stacks are at
+most two frames deep: the sampled function and, usually, its caller.
+"""
+
+import argparse
+from collections import Counter
+import logging
+from pathlib import Path
+import struct
+import sys
+from typing import Iterable, Iterator, NamedTuple, TextIO
+
+from pw_symbolizer import LlvmSymbolizer, Symbol, Symbolizer
+from pw_tokenizer import database
+from pw_trace.trace import TraceEvent
+from pw_trace_tokenized import trace_tokenized
+
+_LOG = logging.getLogger('pw_sampling_profiler')
+
+# Trace events emitted by pw::sampling_profiler::Profiler::DrainToTrace().
+_SAMPLE_MODULE = 'pw_sampling_profiler'
+_SAMPLE_LABEL = 'sample'
+_SAMPLE_STRUCT = struct.Struct('<II')
+
+# LR values at or above this are EXC_RETURN values or otherwise not code.
+_EXC_RETURN_MIN = 0xF0000000
+
+
+class Sample(NamedTuple):
+    pc: int
+    lr: int
+
+
+def samples_from_trace(events: Iterable[TraceEvent]) -> Iterator[Sample]:
+    """Extracts the profiler's samples from decoded trace events."""
+    for event in events:
+        if event.module != _SAMPLE_MODULE or event.label != _SAMPLE_LABEL:
+            continue
+        if len(event.data) != _SAMPLE_STRUCT.size:
+            _LOG.warning('Skipping sample with %d bytes', len(event.data))
+            continue
+        yield Sample(*_SAMPLE_STRUCT.unpack(event.data))
+
+
+def _call_site(lr: int) -> int | None:
+    """Returns an address within the call instruction that set LR."""
+    if lr == 0 or lr >= _EXC_RETURN_MIN:
+        return None
+    # Clear the Thumb bit, and step back from the return address into the
+    # branch-and-link instruction.
+    return (lr & ~1) - 1
+
+
+def _frame_name(symbol: Symbol) -> str:
+    return symbol.name if symbol.name else f'0x{symbol.address:08X}'
+
+
+def fold_samples(
+    samples: Iterable[Sample], symbolizer: Symbolizer
+) -> Counter[str]:
+    """Counts samples by folded stack, e.g. "caller;function".
+
+    Addresses are symbolized in one batch. The caller is omitted if the LR
+    isn't a return address, or is stale and points into the sampled function.
+    """
+    samples = list(samples)
+    addresses = {sample.pc for sample in samples}
+    addresses.update(
+        site for site in map(_call_site, (s.lr for s in samples)) if site
+    )
+    ordered = sorted(addresses)
+    names = dict(
+        zip(ordered, map(_frame_name, symbolizer.symbolize_all(ordered)))
+    )
+
+    stacks: Counter[str] = Counter()
+    for sample in samples:
+        function = names[sample.pc]
+        site = _call_site(sample.lr)
+        caller = names[site] if site is not None else None
+        if caller is None or caller == function:
+            stacks[function] += 1
+        else:
+            stacks[f'{caller};{function}'] += 1
+    return stacks
+
+
+def write_folded(stacks: Counter[str], output: TextIO) -> None:
+    """Writes folded stacks, most sampled first."""
+    for stack, count in stacks.most_common():
+        output.write(f'{stack} {count}\n')
+
+
+def _parse_args() -> argparse.Namespace:
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        'databases',
+        nargs='+',
+        action=database.LoadTokenDatabases,
+        help='Databases (ELF, binary, or CSV) to use to lookup trace tokens.',
+    )
+    parser.add_argument(
+        '-i',
+        '--input',
+        dest='input_file',
+        required=True,
+        help='The binary tokenized trace containing samples.',
+    )
+    parser.add_argument(
+        '-e',
+        '--elf',
+        type=Path,
+        required=True,
+        help='The ELF file of the profiled firmware, used for symbolization.',
+    )
+    parser.add_argument(
+        '-o',
+        '--output',
+        type=argparse.FileType('w'),
+        default=sys.stdout,
+        help='The file to write folded stacks to (default: stdout).',
+    )
+    parser.add_argument(
+        '--compact',
+        action='store_true',
+        help=(
+            'Decode compact records, from a device built with '
+            'PW_TRACE_CONFIG_COMPACT_RECORDS.'
+        ),
+    )
+    return parser.parse_args()
+
+
+def _main(args: argparse.Namespace) -> int:
+    events = trace_tokenized.get_trace_events_from_file(
+        args.databases,
+        args.input_file,
+        ticks_per_second=1000,
+        time_offset=0,
+        compact=args.compact,
+    )
+    samples = list(samples_from_trace(events))
+    if not samples:
+        _LOG.error('No samples found in %s', args.input_file)
+        return 1
+
+    write_folded(fold_samples(samples, LlvmSymbolizer(args.elf)), args.output)
+    _LOG.info('Folded %d samples', len(samples))
+    return 0
+
+
+if __name__ == '__main__':
+    logging.basicConfig(level=logging.INFO)
+    sys.exit(_main(_parse_args()))
@@ -0,0 +1,47 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sampling_profiler/sample_buffer.h"
+
+#include <algorithm>
+
+namespace pw::sampling_profiler {
+
+bool GenericSampleBuffer::TryPush(const Sample& sample) {
+  const uint32_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == storage_.size()) {
+    // There are no read-modify-write atomics on ARMv6-M, but only the
+    // producer writes this count.
+    dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+    return false;
+  }
+  storage_[tail & (storage_.size() - 1)] = sample;
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+size_t GenericSampleBuffer::Pop(span<Sample> samples) {
+  const uint32_t head = head_.load(std::memory_order_relaxed);
+  const size_t count =
+      std::min<size_t>(samples.size(),
+                       tail_.load(std::memory_order_acquire) - head);
+  for (size_t i = 0; i < count; ++i) {
+    samples[i] = storage_[(head + i) & (storage_.size() - 1)];
+  }
+  head_.store(head + static_cast<uint32_t>(count), std::memory_order_release);
+  return count;
+}
+
+}  // namespace pw::sampling_profiler
@@ -0,0 +1,86 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sampling_profiler/sample_buffer.h"
+
+#include <array>
+#include <cstdint>
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::sampling_profiler {
+namespace {
+
+TEST(SampleBuffer, PopsSamplesInOrder) {
+  SampleBuffer<4> buffer;
+  EXPECT_EQ(buffer.capacity(), 4u);
+  EXPECT_TRUE(buffer.TryPush({0x100, 0x200}));
+  EXPECT_TRUE(buffer.TryPush({0x104, 0x204}));
+  EXPECT_EQ(buffer.size(), 2u);
+
+  std::array<Sample, 4> samples{};
+  ASSERT_EQ(buffer.Pop(samples), 2u);
+  EXPECT_EQ(samples[0].pc, 0x100u);
+  EXPECT_EQ(samples[0].lr, 0x200u);
+  EXPECT_EQ(samples[1].pc, 0x104u);
+  EXPECT_EQ(samples[1].lr, 0x204u);
+  EXPECT_EQ(buffer.size(), 0u);
+  EXPECT_EQ(buffer.Pop(samples), 0u);
+}
+
+TEST(SampleBuffer, PopsAtMostSpanSize) {
+  SampleBuffer<4> buffer;
+  for (uint32_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(buffer.TryPush({i, 0}));
+  }
+
+  std::array<Sample, 2> samples{};
+  ASSERT_EQ(buffer.Pop(samples), 2u);
+  EXPECT_EQ(samples[1].pc, 1u);
+  ASSERT_EQ(buffer.Pop(samples), 1u);
+  EXPECT_EQ(samples[0].pc, 2u);
+}
+
+TEST(SampleBuffer, DropsSamplesWhenFull) {
+  SampleBuffer<2> buffer;
+  EXPECT_TRUE(buffer.TryPush({1, 0}));
+  EXPECT_TRUE(buffer.TryPush({2, 0}));
+  EXPECT_FALSE(buffer.TryPush({3, 0}));
+  EXPECT_FALSE(buffer.TryPush({4, 0}));
+  EXPECT_EQ(buffer.dropped(), 2u);
+
+  // The queued samples are kept, and there is room again once popped.
+  std::array<Sample, 1> samples{};
+  ASSERT_EQ(buffer.Pop(samples), 1u);
+  EXPECT_EQ(samples[0].pc, 1u);
+  EXPECT_TRUE(buffer.TryPush({5, 0}));
+  EXPECT_EQ(buffer.dropped(), 2u);
+}
+
+TEST(SampleBuffer, WrapsAround) {
+  SampleBuffer<4> buffer;
+  std::array<Sample, 3> samples{};
+  for (uint32_t i = 0; i < 10; ++i) {
+    ASSERT_TRUE(buffer.TryPush({3 * i, 0}));
+    ASSERT_TRUE(buffer.TryPush({3 * i + 1, 0}));
+    ASSERT_TRUE(buffer.TryPush({3 * i + 2, 0}));
+    ASSERT_EQ(buffer.Pop(samples), 3u);
+    EXPECT_EQ(samples[0].pc, 3 * i);
+    EXPECT_EQ(samples[2].pc, 3 * i + 2);
+  }
+  EXPECT_EQ(buffer.dropped(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::sampling_profiler
@@ -0,0 +1,182 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "pw_span/span.h"
+
+namespace pw::sensor {
+
+/// The fixed header of a `SampleFrame`.
+///
+/// Samples within a frame are evenly spaced, so only the first timestamp and
+/// the sample period are stored.
+struct SampleFrameHeader {
+  /// The measurement type, e.g. `kAccelerationMeasurement::kMeasurementType`.
+  uint64_t measurement_type;
+  /// Timestamp of the first sample, in nanoseconds.
+  uint64_t first_timestamp_ns;
+  /// Time between consecutive samples, in nanoseconds.
+  uint32_t sample_period_ns;
+  /// Number of valid samples in the frame.
+  uint16_t sample_count;
+  /// Number of values per sample, e.g. 3 for an X/Y/Z accelerometer.
+  uint8_t channel_count;
+  uint8_t reserved;
+};
+
+static_assert(sizeof(SampleFrameHeader) == 24);
+
+/// A batch of samples with a fixed memory layout: a `SampleFrameHeader`
+/// followed by up to `kMaxSamples` samples of `kChannels` values each.
+///
+/// Frames are trivially copyable, so they may be sent as raw bytes, e.g. over
+/// RPC, and decoded by a host with the same layout.
+template <typename T, size_t kChannels, size_t kMaxSamples>
+struct SampleFrame {
+  static_assert(std::is_arithmetic_v<T>);
+  static_assert(kChannels > 0 && kChannels <= UINT8_MAX);
+  static_assert(kMaxSamples > 0 && kMaxSamples <= UINT16_MAX);
+
+  using value_type = T;
+  static constexpr size_t kChannelCount = kChannels;
+  static constexpr size_t kMaxSampleCount = kMaxSamples;
+
+  /// Returns the values of sample `index`.
+  span<T, kChannels> sample(size_t index) {
+    return span<T, kChannels>(&values[index * kChannels], kChannels);
+  }
+  span<const T, kChannels> sample(size_t index) const {
+    return span<const T, kChannels>(&values[index * kChannels], kChannels);
+  }
+
+  /// Returns the timestamp of sample `index`.
+  uint64_t timestamp_ns(size_t index) const {
+    return header.first_timestamp_ns +
+           static_cast<uint64_t>(index) * header.sample_period_ns;
+  }
+
+  /// Returns storage for all samples, for drivers that read a sensor FIFO
+  /// directly into the frame.
+  span<T> all_values() { return values; }
+
+  SampleFrameHeader header;
+  std::array<T, kChannels * kMaxSamples> values;
+};
+
+/// A single-producer, single-consumer queue of `kFrames` sample frames that
+/// needs no locks or interrupt masking.
+///
+/// Frames are filled and read in place: the producer, typically a sensor
+/// driver's FIFO interrupt or thread, fills the frame returned by
+/// `AcquireFrame()` and publishes it with `CommitFrame()`; the consumer reads
+/// the frame returned by `PeekFrame()` and returns it with `ReleaseFrame()`.
+/// Each side only writes its own index, with release ordering once it is done
+/// with a frame, so no samples are copied between contexts.
+///
+/// When the consumer falls behind, `AcquireFrame()` fails and the producer
+/// should drop the batch; the number of dropped batches is available from
+/// `dropped_frames()`.
+template <typename Frame, size_t kFrames>
+class SampleStream {
+ public:
+  static_assert(kFrames > 0);
+  static_assert(std::is_trivially_copyable_v<Frame>);
+
+  constexpr SampleStream() = default;
+
+  SampleStream(const SampleStream&) = delete;
+  SampleStream& operator=(const SampleStream&) = delete;
+
+  /// Producer: Returns the next free frame, or `nullptr` if all frames are in
+  /// use, in which case the drop is counted.
+  Frame* AcquireFrame() {
+    const size_t write_idx = write_idx_.load(std::memory_order_relaxed);
+    if (Used(write_idx, read_idx_.load(std::memory_order_acquire)) ==
+        kFrames) {
+      dropped_frames_.store(
+          dropped_frames_.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+      return nullptr;
+    }
+    return &frames_[Slot(write_idx)];
+  }
+
+  /// Producer: Publishes the frame returned by the last `AcquireFrame()`.
+  void CommitFrame() {
+    write_idx_.store(Increment(write_idx_.load(std::memory_order_relaxed)),
+                     std::memory_order_release);
+  }
+
+  /// Consumer: Returns the oldest published frame, or `nullptr` if there are
+  /// none. The frame remains valid until `ReleaseFrame()`.
+  const Frame* PeekFrame() const {
+    const size_t read_idx = read_idx_.load(std::memory_order_relaxed);
+    if (Used(write_idx_.load(std::memory_order_acquire), read_idx) == 0) {
+      return nullptr;
+    }
+    return &frames_[Slot(read_idx)];
+  }
+
+  /// Consumer: Returns the frame from `PeekFrame()` to the producer.
+  void ReleaseFrame() {
+    read_idx_.store(Increment(read_idx_.load(std::memory_order_relaxed)),
+                    std::memory_order_release);
+  }
+
+  /// Returns the number of published frames. This is a snapshot if called
+  /// concurrently with either side.
+  size_t size() const {
+    return Used(write_idx_.load(std::memory_order_acquire),
+                read_idx_.load(std::memory_order_acquire));
+  }
+
+  /// Returns the number of frames the producer could not acquire.
+  uint32_t dropped_frames() const {
+    return dropped_frames_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Indices run from 0 to twice the frame count, so that a full queue can be
+  // told apart from an empty one.
+  static constexpr size_t Used(size_t write_idx, size_t read_idx) {
+    return write_idx >= read_idx ? write_idx - read_idx
+                                 : write_idx + 2 * kFrames - read_idx;
+  }
+
+  static constexpr size_t Increment(size_t index) {
+    return index + 1 == 2 * kFrames ? 0 : index + 1;
+  }
+
+  static constexpr size_t Slot(size_t index) {
+    return index >= kFrames ? index - kFrames : index;
+  }
+
+  static_assert(std::atomic<size_t>::is_always_lock_free);
+
+  std::array<Frame, kFrames> frames_{};
+
+  // Written only by the producer.
+  std::atomic<size_t> write_idx_ = 0;
+  std::atomic<uint32_t> dropped_frames_ = 0;
+  // Written only by the consumer.
+  std::atomic<size_t> read_idx_ = 0;
+};
+
+}  // namespace pw::sensor
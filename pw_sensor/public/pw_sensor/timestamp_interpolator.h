@@ -0,0 +1,72 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pw::sensor {
+
+/// Assigns timestamps to samples read from a sensor FIFO in batches.
+///
+/// A FIFO interrupt only gives the time at which the newest sample became
+/// available. The interpolator estimates the sensor's actual sample period
+/// from the time between batches, smoothing out interrupt latency jitter, and
+/// spaces the earlier samples of each batch evenly before the newest one. The
+/// estimate tracks drift of the sensor's oscillator, which at high output data
+/// rates quickly adds up to whole samples.
+class TimestampInterpolator {
+ public:
+  /// Timestamps for a batch of samples.
+  struct Batch {
+    uint64_t first_timestamp_ns;
+    uint32_t sample_period_ns;
+  };
+
+  /// @param nominal_period_ns The configured sample period, e.g. 156250 for
+  ///                          6.4 kHz. Measurements more than a factor of two
+  ///                          away from it are ignored.
+  explicit constexpr TimestampInterpolator(uint32_t nominal_period_ns)
+      : nominal_period_ns_(nominal_period_ns),
+        period_(static_cast<uint64_t>(nominal_period_ns) << kFractionBits) {}
+
+  /// Timestamps a batch of `sample_count` samples, the newest of which became
+  /// available at `timestamp_ns`.
+  Batch Interpolate(uint64_t timestamp_ns, size_t sample_count);
+
+  /// Forgets the previous batch, e.g. after the FIFO was flushed or
+  /// overflowed. The period estimate is kept.
+  void Reset() { has_last_timestamp_ = false; }
+
+  /// Returns the current estimate of the sample period.
+  uint32_t sample_period_ns() const {
+    return static_cast<uint32_t>((period_ + kHalf) >> kFractionBits);
+  }
+
+ private:
+  // The period is tracked in fixed point, so that rounding does not
+  // accumulate across the samples of a batch.
+  static constexpr int kFractionBits = 8;
+  static constexpr uint64_t kHalf = uint64_t{1} << (kFractionBits - 1);
+
+  // Each measurement moves the estimate by 1/2^kSmoothingShift of the error.
+  static constexpr int kSmoothingShift = 3;
+
+  const uint32_t nominal_period_ns_;
+  uint64_t period_;
+  uint64_t last_timestamp_ns_ = 0;
+  bool has_last_timestamp_ = false;
+};
+
+}  // namespace pw::sensor
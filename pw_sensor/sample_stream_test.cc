@@ -0,0 +1,85 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sensor/sample_stream.h"
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::sensor {
+namespace {
+
+using Frame = SampleFrame<int16_t, 3, 4>;
+
+TEST(SampleFrame, Layout) {
+  static_assert(sizeof(Frame) == sizeof(SampleFrameHeader) + 3 * 4 * 2);
+  Frame frame{};
+  frame.header.first_timestamp_ns = 1000;
+  frame.header.sample_period_ns = 10;
+  frame.sample(1)[2] = 7;
+  EXPECT_EQ(frame.values[5], 7);
+  EXPECT_EQ(frame.timestamp_ns(3), 1030u);
+  EXPECT_EQ(frame.all_values().size(), 12u);
+}
+
+TEST(SampleStream, EmptyHasNoFrames) {
+  SampleStream<Frame, 2> stream;
+  EXPECT_EQ(stream.PeekFrame(), nullptr);
+  EXPECT_EQ(stream.size(), 0u);
+}
+
+TEST(SampleStream, FramesAreReadInPlaceInOrder) {
+  SampleStream<Frame, 3> stream;
+  for (uint16_t i = 0; i < 10; ++i) {
+    Frame* frame = stream.AcquireFrame();
+    ASSERT_NE(frame, nullptr);
+    frame->header.sample_count = i;
+    stream.CommitFrame();
+
+    const Frame* read = stream.PeekFrame();
+    ASSERT_EQ(read, frame);
+    EXPECT_EQ(read->header.sample_count, i);
+    stream.ReleaseFrame();
+  }
+  EXPECT_EQ(stream.dropped_frames(), 0u);
+}
+
+TEST(SampleStream, FullStreamDropsFrames) {
+  SampleStream<Frame, 2> stream;
+  for (uint16_t i = 0; i < 2; ++i) {
+    Frame* frame = stream.AcquireFrame();
+    ASSERT_NE(frame, nullptr);
+    frame->header.sample_count = i;
+    stream.CommitFrame();
+  }
+  EXPECT_EQ(stream.size(), 2u);
+  EXPECT_EQ(stream.AcquireFrame(), nullptr);
+  EXPECT_EQ(stream.AcquireFrame(), nullptr);
+  EXPECT_EQ(stream.dropped_frames(), 2u);
+
+  ASSERT_NE(stream.PeekFrame(), nullptr);
+  EXPECT_EQ(stream.PeekFrame()->header.sample_count, 0u);
+  stream.ReleaseFrame();
+  EXPECT_NE(stream.AcquireFrame(), nullptr);
+}
+
+TEST(SampleStream, UncommittedFrameIsNotVisible) {
+  SampleStream<Frame, 2> stream;
+  ASSERT_NE(stream.AcquireFrame(), nullptr);
+  EXPECT_EQ(stream.PeekFrame(), nullptr);
+  stream.CommitFrame();
+  EXPECT_NE(stream.PeekFrame(), nullptr);
+}
+
+}  // namespace
+}  // namespace pw::sensor
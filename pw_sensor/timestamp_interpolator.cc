@@ -0,0 +1,47 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sensor/timestamp_interpolator.h"
+
+namespace pw::sensor {
+
+TimestampInterpolator::Batch TimestampInterpolator::Interpolate(
+    uint64_t timestamp_ns, size_t sample_count) {
+  if (sample_count == 0) {
+    return {timestamp_ns, sample_period_ns()};
+  }
+
+  if (has_last_timestamp_ && timestamp_ns > last_timestamp_ns_) {
+    const uint64_t measured =
+        ((timestamp_ns - last_timestamp_ns_) << kFractionBits) / sample_count;
+    const uint64_t nominal = static_cast<uint64_t>(nominal_period_ns_)
+                             << kFractionBits;
+    // Ignore batches that were delayed or cut short, e.g. by a missed
+    // interrupt or a FIFO overflow.
+    if (measured >= nominal / 2 && measured <= nominal * 2) {
+      const int64_t error =
+          static_cast<int64_t>(measured) - static_cast<int64_t>(period_);
+      period_ = static_cast<uint64_t>(static_cast<int64_t>(period_) +
+                                      error / (int64_t{1} << kSmoothingShift));
+    }
+  }
+  last_timestamp_ns_ = timestamp_ns;
+  has_last_timestamp_ = true;
+
+  const uint64_t span =
+      (period_ * (sample_count - 1) + kHalf) >> kFractionBits;
+  return {span < timestamp_ns ? timestamp_ns - span : 0, sample_period_ns()};
+}
+
+}  // namespace pw::sensor
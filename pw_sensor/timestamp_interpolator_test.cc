@@ -0,0 +1,75 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sensor/timestamp_interpolator.h"
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::sensor {
+namespace {
+
+constexpr uint32_t kPeriodNs = 156250;  // 6.4 kHz
+
+TEST(TimestampInterpolator, FirstBatchUsesNominalPeriod) {
+  TimestampInterpolator interpolator(kPeriodNs);
+  TimestampInterpolator::Batch batch =
+      interpolator.Interpolate(10'000'000, 16);
+  EXPECT_EQ(batch.sample_period_ns, kPeriodNs);
+  EXPECT_EQ(batch.first_timestamp_ns, 10'000'000u - 15 * kPeriodNs);
+}
+
+TEST(TimestampInterpolator, TracksActualPeriodThroughJitter) {
+  // The sensor runs 1% slow, and interrupts are serviced with up to 20 us of
+  // latency.
+  constexpr uint64_t kActualPeriodNs = kPeriodNs * 101 / 100;
+  constexpr uint32_t kJitterNs[] = {0, 20'000, 5'000, 15'000, 10'000};
+  TimestampInterpolator interpolator(kPeriodNs);
+
+  TimestampInterpolator::Batch batch{};
+  uint64_t newest_sample_ns = 0;
+  for (size_t i = 0; i < 100; ++i) {
+    newest_sample_ns += 16 * kActualPeriodNs;
+    batch = interpolator.Interpolate(newest_sample_ns + kJitterNs[i % 5], 16);
+  }
+  EXPECT_NEAR(batch.sample_period_ns, kActualPeriodNs, 100);
+  EXPECT_NEAR(static_cast<double>(batch.first_timestamp_ns),
+              static_cast<double>(newest_sample_ns - 15 * kActualPeriodNs),
+              25'000);
+}
+
+TEST(TimestampInterpolator, IgnoresOutliers) {
+  TimestampInterpolator interpolator(kPeriodNs);
+  interpolator.Interpolate(1'000'000, 8);
+  // A missed interrupt makes the next batch appear to have a long period.
+  interpolator.Interpolate(1'000'000 + 8 * 3 * kPeriodNs, 8);
+  EXPECT_EQ(interpolator.sample_period_ns(), kPeriodNs);
+}
+
+TEST(TimestampInterpolator, ResetForgetsPreviousBatch) {
+  TimestampInterpolator interpolator(kPeriodNs);
+  interpolator.Interpolate(1'000'000, 8);
+  interpolator.Reset();
+  interpolator.Interpolate(1'000'000 + 8 * kPeriodNs * 3 / 2, 8);
+  EXPECT_EQ(interpolator.sample_period_ns(), kPeriodNs);
+}
+
+TEST(TimestampInterpolator, EmptyBatch) {
+  TimestampInterpolator interpolator(kPeriodNs);
+  TimestampInterpolator::Batch batch = interpolator.Interpolate(500, 0);
+  EXPECT_EQ(batch.first_timestamp_ns, 500u);
+  EXPECT_EQ(batch.sample_period_ns, kPeriodNs);
+}
+
+}  // namespace
+}  // namespace pw::sensor
@@ -0,0 +1,168 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_snapshot/flash_snapshot.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "pw_bytes/alignment.h"
+#include "pw_bytes/endian.h"
+#include "pw_status/try.h"
+
+namespace pw::snapshot {
+namespace {
+
+// The header is stored as four little-endian 32-bit words: a magic value, the
+// size of the snapshot, the CRC32 of the snapshot, and the complement of the
+// size.
+constexpr uint32_t kHeaderMagic = 0x53534e50;  // "PNSS"
+constexpr size_t kHeaderWords = 4;
+constexpr size_t kHeaderSizeBytes = kHeaderWords * sizeof(uint32_t);
+
+size_t AlignedHeaderSize(const kvs::FlashPartition& partition) {
+  return AlignUp(kHeaderSizeBytes, partition.alignment_bytes());
+}
+
+void EncodeHeader(uint32_t size, uint32_t crc, ByteSpan header) {
+  const std::array<uint32_t, kHeaderWords> words = {
+      kHeaderMagic, size, crc, ~size};
+  std::byte* out = header.data();
+  for (uint32_t word : words) {
+    const auto bytes = bytes::CopyInOrder(endian::little, word);
+    std::memcpy(out, bytes.data(), bytes.size());
+    out += bytes.size();
+  }
+}
+
+}  // namespace
+
+size_t FlashSnapshotWriter::HeaderSizeBytes() const {
+  return AlignedHeaderSize(partition_);
+}
+
+Status FlashSnapshotWriter::Begin() {
+  const size_t alignment = partition_.alignment_bytes();
+  if (staging_buffer_.size() < std::max(alignment, HeaderSizeBytes()) ||
+      HeaderSizeBytes() >= partition_.size_bytes()) {
+    return Status::InvalidArgument();
+  }
+
+  // Drop any previous capture before erasing, since destroying the aligned
+  // writer flushes it.
+  aligned_writer_.reset();
+  state_ = State::kError;
+  PW_TRY(partition_.Erase());
+
+  size_ = 0;
+  crc_.clear();
+  output_.emplace(partition_, HeaderSizeBytes());
+  aligned_writer_.emplace(staging_buffer_, alignment, *output_);
+  state_ = State::kWriting;
+  return OkStatus();
+}
+
+Status FlashSnapshotWriter::DoWrite(ConstByteSpan data) {
+  if (state_ != State::kWriting) {
+    return Status::FailedPrecondition();
+  }
+  if (data.size() > ConservativeLimit(LimitType::kWrite)) {
+    state_ = State::kError;
+    return Status::ResourceExhausted();
+  }
+  const StatusWithSize result = aligned_writer_->Write(data);
+  if (!result.ok()) {
+    state_ = State::kError;
+    return result.status();
+  }
+  crc_.Update(data);
+  size_ += data.size();
+  return OkStatus();
+}
+
+size_t FlashSnapshotWriter::ConservativeLimit(LimitType type) const {
+  if (type != LimitType::kWrite || state_ != State::kWriting) {
+    return 0;
+  }
+  return partition_.size_bytes() - HeaderSizeBytes() - size_;
+}
+
+Status FlashSnapshotWriter::Finish() {
+  if (state_ != State::kWriting) {
+    return Status::FailedPrecondition();
+  }
+  state_ = State::kError;
+  PW_TRY(aligned_writer_->Flush().status());
+
+  // The staging buffer is free once flushed, so the header is built in it.
+  const ByteSpan header = staging_buffer_.first(HeaderSizeBytes());
+  std::fill(header.begin(), header.end(), std::byte{0});
+  EncodeHeader(static_cast<uint32_t>(size_), crc_.value(), header);
+  PW_TRY(partition_.Write(0, header).status());
+
+  state_ = State::kIdle;
+  return OkStatus();
+}
+
+Status FlashSnapshotReader::Open() {
+  size_ = 0;
+  position_ = 0;
+  header_size_ = AlignedHeaderSize(partition_);
+  if (header_size_ >= partition_.size_bytes()) {
+    return Status::NotFound();
+  }
+
+  std::array<std::byte, kHeaderSizeBytes> header;
+  PW_TRY(partition_.Read(0, header).status());
+  std::array<uint32_t, kHeaderWords> words;
+  for (size_t i = 0; i < kHeaderWords; ++i) {
+    words[i] = bytes::ReadInOrder<uint32_t>(endian::little,
+                                            &header[i * sizeof(uint32_t)]);
+  }
+  const uint32_t size = words[1];
+  if (words[0] != kHeaderMagic || words[3] != ~size ||
+      size > partition_.size_bytes() - header_size_) {
+    return Status::NotFound();
+  }
+
+  checksum::Crc32 crc;
+  std::array<std::byte, 32> buffer;
+  for (size_t offset = 0; offset < size;) {
+    const size_t chunk = std::min(buffer.size(), size - offset);
+    PW_TRY(partition_.Read(header_size_ + offset, span(buffer).first(chunk))
+               .status());
+    crc.Update(span(buffer).first(chunk));
+    offset += chunk;
+  }
+  if (crc.value() != words[2]) {
+    return Status::DataLoss();
+  }
+
+  size_ = size;
+  return OkStatus();
+}
+
+StatusWithSize FlashSnapshotReader::DoRead(ByteSpan destination) {
+  if (position_ >= size_) {
+    return StatusWithSize::OutOfRange();
+  }
+  const size_t to_read = std::min(destination.size(), size_ - position_);
+  const StatusWithSize result =
+      partition_.Read(header_size_ + position_, destination.first(to_read));
+  position_ += result.size();
+  return result;
+}
+
+}  // namespace pw::snapshot
@@ -0,0 +1,208 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_snapshot/flash_snapshot.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_status/status.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::snapshot {
+namespace {
+
+constexpr uint32_t kSectionField = 18;
+constexpr uint32_t kIdField = 1;
+constexpr uint32_t kPayloadField = 2;
+constexpr size_t kNumSections = 40;
+
+class FlashSnapshotTest : public ::testing::Test {
+ protected:
+  FlashSnapshotTest() : flash_(kFlashAlignment), partition_(&flash_) {}
+
+  // Encodes a snapshot of `num_sections` nested sections. Each section is
+  // buffered in the small scratch buffer, while the snapshot as a whole is
+  // much larger than any buffer.
+  Status EncodeSnapshot(FlashSnapshotWriter& writer, size_t num_sections) {
+    std::array<std::byte, 48> scratch;
+    protobuf::StreamEncoder encoder(writer, scratch);
+    std::array<std::byte, 20> payload;
+    for (size_t i = 0; i < num_sections; ++i) {
+      payload.fill(static_cast<std::byte>(i));
+      protobuf::StreamEncoder section = encoder.GetNestedEncoder(kSectionField);
+      section.WriteUint32(kIdField, static_cast<uint32_t>(i)).IgnoreError();
+      section.WriteBytes(kPayloadField, payload).IgnoreError();
+    }
+    return encoder.status();
+  }
+
+  static constexpr size_t kFlashAlignment = 16;
+  static constexpr size_t kSectorSize = 512;
+  static constexpr size_t kSectorCount = 4;
+
+  kvs::FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash_;
+  kvs::FlashPartition partition_;
+  std::array<std::byte, 32> staging_buffer_;
+};
+
+TEST_F(FlashSnapshotTest, WritesAndReadsSnapshot) {
+  FlashSnapshotWriter writer(partition_, staging_buffer_);
+  ASSERT_EQ(writer.Begin(), OkStatus());
+  ASSERT_EQ(EncodeSnapshot(writer, kNumSections), OkStatus());
+  ASSERT_EQ(writer.Finish(), OkStatus());
+  EXPECT_GT(writer.size(), staging_buffer_.size() * 10);
+
+  FlashSnapshotReader reader(partition_);
+  ASSERT_EQ(reader.Open(), OkStatus());
+  ASSERT_EQ(reader.size(), writer.size());
+
+  std::array<std::byte, kSectorSize * kSectorCount> snapshot;
+  Result<ByteSpan> read = reader.Read(snapshot);
+  ASSERT_EQ(read.status(), OkStatus());
+  ASSERT_EQ(read->size(), writer.size());
+
+  protobuf::Decoder decoder(*read);
+  size_t sections = 0;
+  while (decoder.Next().ok()) {
+    ASSERT_EQ(decoder.FieldNumber(), kSectionField);
+    ConstByteSpan section_bytes;
+    ASSERT_EQ(decoder.ReadBytes(&section_bytes), OkStatus());
+
+    protobuf::Decoder section(section_bytes);
+    ASSERT_EQ(section.Next(), OkStatus());
+    uint32_t id = 0;
+    ASSERT_EQ(section.ReadUint32(&id), OkStatus());
+    EXPECT_EQ(id, sections);
+    ASSERT_EQ(section.Next(), OkStatus());
+    ConstByteSpan payload;
+    ASSERT_EQ(section.ReadBytes(&payload), OkStatus());
+    EXPECT_EQ(payload.size(), 20u);
+    EXPECT_EQ(payload[0], static_cast<std::byte>(sections));
+    ++sections;
+  }
+  EXPECT_EQ(sections, kNumSections);
+}
+
+TEST_F(FlashSnapshotTest, ReaderSeeks) {
+  FlashSnapshotWriter writer(partition_, staging_buffer_);
+  ASSERT_EQ(writer.Begin(), OkStatus());
+  constexpr std::array<std::byte, 3> kData = {
+      std::byte{1}, std::byte{2}, std::byte{3}};
+  ASSERT_EQ(writer.Write(kData), OkStatus());
+  ASSERT_EQ(writer.Finish(), OkStatus());
+
+  FlashSnapshotReader reader(partition_);
+  ASSERT_EQ(reader.Open(), OkStatus());
+  ASSERT_EQ(reader.Seek(2), OkStatus());
+  std::array<std::byte, 4> buffer;
+  Result<ByteSpan> read = reader.Read(buffer);
+  ASSERT_EQ(read.status(), OkStatus());
+  ASSERT_EQ(read->size(), 1u);
+  EXPECT_EQ((*read)[0], std::byte{3});
+  EXPECT_EQ(reader.Read(buffer).status(), Status::OutOfRange());
+}
+
+TEST_F(FlashSnapshotTest, UnfinishedSnapshotIsNotFound) {
+  FlashSnapshotWriter writer(partition_, staging_buffer_);
+  ASSERT_EQ(writer.Begin(), OkStatus());
+  ASSERT_EQ(EncodeSnapshot(writer, 5), OkStatus());
+
+  FlashSnapshotReader reader(partition_);
+  EXPECT_EQ(reader.Open(), Status::NotFound());
+  EXPECT_EQ(reader.size(), 0u);
+}
+
+TEST_F(FlashSnapshotTest, BeginInvalidatesPreviousSnapshot) {
+  FlashSnapshotWriter writer(partition_, staging_buffer_);
+  ASSERT_EQ(writer.Begin(), OkStatus());
+  ASSERT_EQ(EncodeSnapshot(writer, 5), OkStatus());
+  ASSERT_EQ(writer.Finish(), OkStatus());
+
+  ASSERT_EQ(writer.Begin(), OkStatus());
+  FlashSnapshotReader reader(partition_);
+  EXPECT_EQ(reader.Open(), Status::NotFound());
+
+  ASSERT_EQ(EncodeSnapshot(writer, 2), OkStatus());
+  ASSERT_EQ(writer.Finish(), OkStatus());
+  ASSERT_EQ(reader.Open(), OkStatus());
+  EXPECT_EQ(reader.size(), writer.size());
+}
+
+TEST_F(FlashSnapshotTest, CorruptedSnapshotIsDataLoss) {
+  FlashSnapshotWriter writer(partition_, staging_buffer_);
+  ASSERT_EQ(writer.Begin(), OkStatus());
+  ASSERT_EQ(EncodeSnapshot(writer, 5), OkStatus());
+  ASSERT_EQ(writer.Finish(), OkStatus());
+
+  flash_.buffer()[kFlashAlignment + 3] ^= std::byte{0x1};
+  FlashSnapshotReader reader(partition_);
+  EXPECT_EQ(reader.Open(), Status::DataLoss());
+}
+
+TEST_F(FlashSnapshotTest, FullPartitionKeepsSectionsThatFit) {
+  FlashSnapshotWriter writer(partition_, staging_buffer_);
+  ASSERT_EQ(writer.Begin(), OkStatus());
+  EXPECT_EQ(EncodeSnapshot(writer, 1000), Status::ResourceExhausted());
+  ASSERT_EQ(writer.Finish(), OkStatus());
+
+  // The encoder only writes sections that fit, so the snapshot remains a
+  // well-formed proto.
+  FlashSnapshotReader reader(partition_);
+  ASSERT_EQ(reader.Open(), OkStatus());
+  std::array<std::byte, kSectorSize * kSectorCount> snapshot;
+  Result<ByteSpan> read = reader.Read(snapshot);
+  ASSERT_EQ(read.status(), OkStatus());
+  protobuf::Decoder decoder(*read);
+  size_t sections = 0;
+  while (decoder.Next().ok()) {
+    ConstByteSpan section;
+    ASSERT_EQ(decoder.ReadBytes(&section), OkStatus());
+    ++sections;
+  }
+  EXPECT_GT(sections, kNumSections);
+  EXPECT_LT(sections, 1000u);
+}
+
+TEST_F(FlashSnapshotTest, WritePastEndFailsSnapshot) {
+  FlashSnapshotWriter writer(partition_, staging_buffer_);
+  ASSERT_EQ(writer.Begin(), OkStatus());
+  std::array<std::byte, kSectorSize * kSectorCount> too_large{};
+  EXPECT_EQ(writer.Write(too_large), Status::ResourceExhausted());
+  EXPECT_EQ(writer.Finish(), Status::FailedPrecondition());
+
+  FlashSnapshotReader reader(partition_);
+  EXPECT_EQ(reader.Open(), Status::NotFound());
+}
+
+TEST_F(FlashSnapshotTest, WriteBeforeBeginFails) {
+  FlashSnapshotWriter writer(partition_, staging_buffer_);
+  constexpr std::array<std::byte, 1> kData = {std::byte{1}};
+  EXPECT_EQ(writer.Write(kData), Status::FailedPrecondition());
+  EXPECT_EQ(writer.Finish(), Status::FailedPrecondition());
+}
+
+TEST_F(FlashSnapshotTest, StagingBufferSmallerThanAlignmentIsRejected) {
+  std::array<std::byte, kFlashAlignment - 1> small_buffer;
+  FlashSnapshotWriter writer(partition_, small_buffer);
+  EXPECT_EQ(writer.Begin(), Status::InvalidArgument());
+}
+
+}  // namespace
+}  // namespace pw::snapshot
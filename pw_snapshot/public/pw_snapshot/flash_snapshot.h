@@ -0,0 +1,158 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_bytes/span.h"
+#include "pw_checksum/crc32.h"
+#include "pw_kvs/alignment.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_stream/seek.h"
+#include "pw_stream/stream.h"
+
+namespace pw::snapshot {
+
+// Streams a snapshot into a FlashPartition as it is encoded.
+//
+// A snapshot is encoded with a pw_protobuf `Snapshot::StreamEncoder` that
+// writes to this writer, so only one section (e.g. a single thread or log
+// entry) at a time is held in the encoder's scratch buffer, and only one
+// flash write block is held in this writer's staging buffer. The RAM needed to
+// capture a snapshot no longer scales with the size of the snapshot, which
+// makes it suitable for use from a crash handler.
+//
+// The partition holds a small header followed by the encoded snapshot. The
+// header, which records the snapshot's size and CRC32, is only written by
+// `Finish()`, so a capture that is interrupted (e.g. by a second fault) leaves
+// no valid snapshot behind.
+//
+// If the partition fills up, the pw_protobuf encoder skips the sections that
+// do not fit, and Finish() commits the well-formed snapshot of those that did.
+// Check the encoder's status to detect a truncated snapshot.
+//
+//   FlashSnapshotWriter writer(partition, staging_buffer);
+//   writer.Begin();
+//   {
+//     Snapshot::StreamEncoder encoder(writer, submessage_buffer);
+//     ... encode sections ...
+//   }
+//   writer.Finish();
+class FlashSnapshotWriter final : public stream::NonSeekableWriter {
+ public:
+  // `staging_buffer` holds bytes until a full flash write block is available.
+  // It must be at least as large as the partition's alignment and the header;
+  // larger buffers result in fewer, larger flash writes.
+  FlashSnapshotWriter(kvs::FlashPartition& partition, ByteSpan staging_buffer)
+      : partition_(partition), staging_buffer_(staging_buffer) {}
+
+  FlashSnapshotWriter(const FlashSnapshotWriter&) = delete;
+  FlashSnapshotWriter& operator=(const FlashSnapshotWriter&) = delete;
+
+  // Erases the partition, invalidating any previous snapshot, and starts a new
+  // snapshot.
+  //
+  // Returns:
+  //   OK - The partition is ready for a new snapshot.
+  //   INVALID_ARGUMENT - The staging buffer is too small for the partition.
+  //   Any error from erasing the partition.
+  Status Begin();
+
+  // Flushes the remaining bytes and commits the snapshot's header.
+  //
+  // Returns:
+  //   OK - The snapshot was committed.
+  //   FAILED_PRECONDITION - Begin() was not called, or a write to the
+  //     partition failed.
+  //   Any error from writing to the partition.
+  Status Finish();
+
+  // Number of bytes of the snapshot written so far.
+  size_t size() const { return size_; }
+
+ private:
+  enum class State {
+    kIdle,
+    kWriting,
+    kError,
+  };
+
+  Status DoWrite(ConstByteSpan data) override;
+
+  size_t DoTell() override { return size_; }
+
+  size_t ConservativeLimit(LimitType type) const override;
+
+  size_t HeaderSizeBytes() const;
+
+  kvs::FlashPartition& partition_;
+  ByteSpan staging_buffer_;
+  State state_ = State::kIdle;
+  size_t size_ = 0;
+  checksum::Crc32 crc_;
+  std::optional<kvs::FlashPartition::Output> output_;
+  std::optional<AlignedWriter> aligned_writer_;
+};
+
+// Reads a snapshot committed by FlashSnapshotWriter.
+class FlashSnapshotReader final : public stream::SeekableReader {
+ public:
+  explicit FlashSnapshotReader(kvs::FlashPartition& partition)
+      : partition_(partition) {}
+
+  FlashSnapshotReader(const FlashSnapshotReader&) = delete;
+  FlashSnapshotReader& operator=(const FlashSnapshotReader&) = delete;
+
+  // Checks the header and CRC32 of the snapshot in the partition. Reads are
+  // only possible after a successful Open().
+  //
+  // Returns:
+  //   OK - A valid snapshot was found; its size is available from size().
+  //   NOT_FOUND - The partition does not hold a committed snapshot.
+  //   DATA_LOSS - The snapshot does not match its CRC32.
+  //   Any error from reading the partition.
+  Status Open();
+
+  // Size of the snapshot, or 0 if it has not been opened.
+  size_t size() const { return size_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override;
+
+  Status DoSeek(ptrdiff_t offset, Whence origin) override {
+    return stream::CalculateSeek(offset, origin, size_, position_);
+  }
+
+  size_t DoTell() override { return position_; }
+
+  size_t ConservativeLimit(LimitType type) const override {
+    return type == LimitType::kRead ? size_ - position_ : 0;
+  }
+
+  kvs::FlashPartition& partition_;
+  size_t header_size_ = 0;
+  size_t size_ = 0;
+  size_t position_ = 0;
+};
+
+// Invalidates the snapshot in the partition, if any, by erasing it.
+inline Status EraseFlashSnapshot(kvs::FlashPartition& partition) {
+  return partition.Erase();
+}
+
+}  // namespace pw::snapshot
@@ -14,7 +14,6 @@
 """Tool for processing and outputting Snapshot protos as text"""
 
 import argparse
-import functools
 import logging
 import sys
 from pathlib import Path
@@ -188,6 +187,26 @@ def _snapshot_symbolizer_matcher(
     return LlvmSymbolizer(matching_elf)
 
 
+class _BuildIdSymbolizerMatcher:
+    """Reuses one symbolizer for all snapshots with the same build ID.
+
+    Related snapshots often come from the same build, so sharing a symbolizer
+    means its ELF is only loaded, and each address only resolved, once.
+    """
+
+    def __init__(self, artifacts_dir: Path):
+        self._artifacts_dir = artifacts_dir
+        self._symbolizers: dict[bytes, LlvmSymbolizer] = {}
+
+    def __call__(self, snapshot: snapshot_pb2.Snapshot) -> LlvmSymbolizer:
+        build_id = snapshot.metadata.software_build_uuid
+        if build_id not in self._symbolizers:
+            self._symbolizers[build_id] = _snapshot_symbolizer_matcher(
+                self._artifacts_dir, snapshot
+            )
+        return self._symbolizers[build_id]
+
+
 def _load_and_dump_snapshots(
     in_file: BinaryIO,
     out_file: TextIO,
@@ -199,9 +218,7 @@ def _load_and_dump_snapshots(
         detokenizer = pw_tokenizer.Detokenizer(token_db)
     symbolizer_matcher: SymbolizerMatcher | None = None
     if artifacts_dir:
-        symbolizer_matcher = functools.partial(
-            _snapshot_symbolizer_matcher, artifacts_dir
-        )
+        symbolizer_matcher = _BuildIdSymbolizerMatcher(artifacts_dir)
     out_file.write(
         process_snapshots(
             serialized_snapshot=in_file.read(),
@@ -352,29 +352,43 @@ void BundledUpdateService::DoApply() {
     stream::IntervalReader file_reader =
         bundle_.GetTargetPayload(file_name_view);
     if (file_reader.status().IsNotFound()) {
-      PW_LOG_INFO(
-          "Contents of file %s missing from bundle; ignoring",
-          pw::MakeString<MAX_TARGET_NAME_LENGTH>(file_name_view).c_str());
-      continue;
+      // The file may be in the bundle as a delta patch instead.
+      if (bundle_.GetTargetDelta(file_name_view).status().IsNotFound()) {
+        PW_LOG_INFO(
+            "Contents of file %s missing from bundle; ignoring",
+            pw::MakeString<MAX_TARGET_NAME_LENGTH>(file_name_view).c_str());
+        continue;
+      }
+      const Result<uint64_t> delta_target_bytes =
+          bundle_.ApplyTargetDelta(file_name_view);
+      if (!delta_target_bytes.ok()) {
+        SET_ERROR(BundledUpdateResult::Enum::kApplyFailed,
+                  "Failed to apply target file delta: %d",
+                  static_cast<int>(delta_target_bytes.status().code()));
+        return;
+      }
+      target_file_bytes_applied +=
+          static_cast<size_t>(delta_target_bytes.value());
+    } else {
+      if (!file_reader.ok()) {
+        SET_ERROR(BundledUpdateResult::Enum::kApplyFailed,
+                  "Could not open contents of file %s from bundle; "
+                  "aborting update apply phase",
+                  MakeString<MAX_TARGET_NAME_LENGTH>(file_name_view).c_str());
+        return;
+      }
+
+      const size_t bundle_offset = file_reader.start();
+      if (const Status status = backend_.ApplyTargetFile(
+              file_name_view, file_reader, bundle_offset);
+          !status.ok()) {
+        SET_ERROR(BundledUpdateResult::Enum::kApplyFailed,
+                  "Failed to apply target file: %d",
+                  static_cast<int>(status.code()));
+        return;
+      }
+      target_file_bytes_applied += file_reader.interval_size();
     }
-    if (!file_reader.ok()) {
-      SET_ERROR(BundledUpdateResult::Enum::kApplyFailed,
-                "Could not open contents of file %s from bundle; "
-                "aborting update apply phase",
-                MakeString<MAX_TARGET_NAME_LENGTH>(file_name_view).c_str());
-      return;
-    }
-
-    const size_t bundle_offset = file_reader.start();
-    if (const Status status = backend_.ApplyTargetFile(
-            file_name_view, file_reader, bundle_offset);
-        !status.ok()) {
-      SET_ERROR(BundledUpdateResult::Enum::kApplyFailed,
-                "Failed to apply target file: %d",
-                static_cast<int>(status.code()));
-      return;
-    }
-    target_file_bytes_applied += file_reader.interval_size();
     const uint32_t progress_hundreth_percent =
         (static_cast<uint64_t>(target_file_bytes_applied) * 100 * 100) /
         target_file_bytes_to_apply;
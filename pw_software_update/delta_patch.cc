@@ -0,0 +1,206 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PWSU"
+#define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
+
+#include "pw_software_update/delta_patch.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "pw_log/log.h"
+#include "pw_status/try.h"
+#include "pw_varint/stream.h"
+
+namespace pw::software_update {
+namespace {
+
+constexpr std::array<std::byte, 4> kMagic = {
+    std::byte{'p'}, std::byte{'w'}, std::byte{'d'}, std::byte{'1'}};
+
+// Fills `destination` from `reader`. Running out of data is DATA_LOSS, since
+// the patch and the base are always read within their expected lengths.
+Status ReadExactly(stream::Reader& reader, ByteSpan destination) {
+  while (!destination.empty()) {
+    Result<ByteSpan> result = reader.Read(destination);
+    if (result.status().IsOutOfRange()) {
+      return Status::DataLoss();
+    }
+    PW_TRY(result.status());
+    destination = destination.subspan(result->size());
+  }
+  return OkStatus();
+}
+
+template <typename T>
+Status ReadVarint(stream::Reader& reader, T& value) {
+  StatusWithSize result = varint::Read(reader, &value);
+  return result.ok() ? OkStatus() : Status::DataLoss();
+}
+
+}  // namespace
+
+Result<DeltaPatchHeader> ReadDeltaPatchHeader(stream::Reader& patch) {
+  std::array<std::byte, kMagic.size()> magic;
+  PW_TRY(ReadExactly(patch, magic));
+  if (magic != kMagic) {
+    PW_LOG_ERROR("Not a delta patch");
+    return Status::DataLoss();
+  }
+
+  DeltaPatchHeader header;
+  PW_TRY(ReadVarint(patch, header.base_length));
+  PW_TRY(ReadExactly(patch, header.base_sha256));
+  PW_TRY(ReadVarint(patch, header.target_length));
+  PW_TRY(ReadExactly(patch, header.target_sha256));
+
+  if (header.base_length > PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE ||
+      header.target_length > PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE) {
+    PW_LOG_ERROR("Delta patch target too big. Maximum is %u bytes",
+                 PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE);
+    return Status::OutOfRange();
+  }
+  return header;
+}
+
+StatusWithSize DeltaPatchReader::DoRead(ByteSpan destination) {
+  if (!status_.ok()) {
+    return StatusWithSize(status_, 0);
+  }
+  if (!header_.has_value()) {
+    if (Status status = Start(); !status.ok()) {
+      return Fail(status);
+    }
+  }
+  if (produced_ == header_->target_length) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  size_t size = 0;
+  while (size < destination.size() && produced_ < header_->target_length) {
+    if (operation_remaining_ == 0) {
+      if (Status status = StartOperation(); !status.ok()) {
+        return Fail(status);
+      }
+    }
+    const size_t chunk_size = static_cast<size_t>(
+        std::min<uint64_t>(destination.size() - size, operation_remaining_));
+    ByteSpan chunk = destination.subspan(size, chunk_size);
+    if (Status status = Produce(chunk); !status.ok()) {
+      return Fail(status);
+    }
+    hasher_->Update(chunk);
+    operation_remaining_ -= chunk_size;
+    produced_ += chunk_size;
+    size += chunk_size;
+  }
+
+  // The last bytes of the target are only returned once it is verified.
+  if (produced_ == header_->target_length) {
+    if (Status status = Finish(); !status.ok()) {
+      return Fail(status);
+    }
+  }
+  return StatusWithSize(size);
+}
+
+Status DeltaPatchReader::Start() {
+  Result<DeltaPatchHeader> header = ReadDeltaPatchHeader(patch_);
+  PW_TRY(header.status());
+  header_ = *header;
+  hasher_.emplace();
+  return OkStatus();
+}
+
+Status DeltaPatchReader::StartOperation() {
+  uint64_t word;
+  PW_TRY(ReadVarint(patch_, word));
+  const uint64_t length = word >> 2;
+  if (length == 0 || length > header_->target_length - produced_) {
+    PW_LOG_ERROR("Delta patch operation exceeds the target");
+    return Status::DataLoss();
+  }
+
+  operation_ = static_cast<Operation>(word & 0x3);
+  switch (operation_) {
+    case Operation::kCopy:
+    case Operation::kAdd: {
+      int64_t offset;
+      PW_TRY(ReadVarint(patch_, offset));
+      // Check the new position is within the base without overflowing.
+      const uint64_t magnitude =
+          offset < 0 ? static_cast<uint64_t>(-(offset + 1)) + 1
+                     : static_cast<uint64_t>(offset);
+      if ((offset < 0 && magnitude > base_position_) ||
+          (offset >= 0 && magnitude > header_->base_length - base_position_)) {
+        PW_LOG_ERROR("Delta patch operation is outside of the base");
+        return Status::DataLoss();
+      }
+      const uint64_t position =
+          offset < 0 ? base_position_ - magnitude : base_position_ + magnitude;
+      if (length > header_->base_length - position) {
+        PW_LOG_ERROR("Delta patch operation is outside of the base");
+        return Status::DataLoss();
+      }
+      PW_TRY(base_.Seek(static_cast<ptrdiff_t>(position)));
+      base_position_ = position;
+      break;
+    }
+    case Operation::kInsert:
+      break;
+    default:
+      PW_LOG_ERROR("Unknown delta patch operation");
+      return Status::DataLoss();
+  }
+  operation_remaining_ = length;
+  return OkStatus();
+}
+
+Status DeltaPatchReader::Produce(ByteSpan destination) {
+  switch (operation_) {
+    case Operation::kCopy:
+      PW_TRY(ReadExactly(base_, destination));
+      break;
+    case Operation::kAdd:
+      PW_TRY(ReadExactly(base_, destination));
+      for (size_t i = 0; i < destination.size(); i += buffer_.size()) {
+        ByteSpan difference = span(buffer_).first(
+            std::min(buffer_.size(), destination.size() - i));
+        PW_TRY(ReadExactly(patch_, difference));
+        for (size_t j = 0; j < difference.size(); ++j) {
+          destination[i + j] = static_cast<std::byte>(
+              static_cast<uint8_t>(destination[i + j]) +
+              static_cast<uint8_t>(difference[j]));
+        }
+      }
+      break;
+    case Operation::kInsert:
+      return ReadExactly(patch_, destination);
+  }
+  base_position_ += destination.size();
+  return OkStatus();
+}
+
+Status DeltaPatchReader::Finish() {
+  std::array<std::byte, crypto::sha256::kDigestSizeBytes> sha256;
+  PW_TRY(hasher_->Final(sha256));
+  if (sha256 != header_->target_sha256) {
+    PW_LOG_ERROR("Target reconstructed from delta patch has a bad hash");
+    return Status::Unauthenticated();
+  }
+  return OkStatus();
+}
+
+}  // namespace pw::software_update
@@ -0,0 +1,295 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_software_update/delta_patch.h"
+
+#include <array>
+#include <cstring>
+
+#include "pw_bytes/array.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_unit_test/framework.h"
+#include "pw_varint/varint.h"
+
+namespace pw::software_update {
+namespace {
+
+constexpr auto kBase = bytes::String("The quick brown fox jumps over the dog");
+
+// Builds delta patches operation by operation.
+class PatchBuilder {
+ public:
+  PatchBuilder(ConstByteSpan base, ConstByteSpan target) {
+    Append(bytes::String("pwd1"));
+    AppendVarint(base.size());
+    AppendSha256(base);
+    AppendVarint(target.size());
+    AppendSha256(target);
+  }
+
+  PatchBuilder& Copy(int64_t offset, size_t length) {
+    AppendVarint(length << 2 | 0);
+    AppendVarint(offset);
+    return *this;
+  }
+
+  PatchBuilder& Add(int64_t offset, ConstByteSpan differences) {
+    AppendVarint(differences.size() << 2 | 1);
+    AppendVarint(offset);
+    Append(differences);
+    return *this;
+  }
+
+  PatchBuilder& Insert(ConstByteSpan data) {
+    AppendVarint(data.size() << 2 | 2);
+    Append(data);
+    return *this;
+  }
+
+  PatchBuilder& Operation(uint64_t word) {
+    AppendVarint(word);
+    return *this;
+  }
+
+  ConstByteSpan data() const { return writer_.WrittenData(); }
+
+ private:
+  void Append(ConstByteSpan data) {
+    EXPECT_EQ(OkStatus(), writer_.Write(data));
+  }
+
+  template <typename T>
+  void AppendVarint(T value) {
+    std::array<std::byte, varint::kMaxVarint64SizeBytes> buffer;
+    Append(span(buffer).first(varint::Encode(value, buffer)));
+  }
+
+  void AppendSha256(ConstByteSpan data) {
+    std::array<std::byte, crypto::sha256::kDigestSizeBytes> sha256;
+    EXPECT_EQ(OkStatus(), crypto::sha256::Hash(data, sha256));
+    Append(sha256);
+  }
+
+  stream::MemoryWriterBuffer<256> writer_;
+};
+
+// Reads the whole target in reads of at most `chunk_size` bytes.
+Status ReadTarget(DeltaPatchReader& reader,
+                  ByteSpan target,
+                  size_t chunk_size,
+                  size_t& target_size) {
+  target_size = 0;
+  while (true) {
+    const size_t size = std::min(chunk_size, target.size() - target_size);
+    Result<ByteSpan> result = reader.Read(target.subspan(target_size, size));
+    if (!result.ok()) {
+      return result.status();
+    }
+    target_size += result->size();
+  }
+}
+
+void ExpectPatchProduces(ConstByteSpan patch, ConstByteSpan expected) {
+  for (size_t chunk_size : {size_t{1}, size_t{3}, size_t{64}}) {
+    stream::MemoryReader base(kBase);
+    stream::MemoryReader patch_reader(patch);
+    DeltaPatchReader reader(base, patch_reader);
+
+    std::array<std::byte, 64> target;
+    size_t target_size;
+    EXPECT_EQ(Status::OutOfRange(),
+              ReadTarget(reader, target, chunk_size, target_size));
+    EXPECT_EQ(OkStatus(), reader.status());
+    EXPECT_TRUE(reader.verified());
+    EXPECT_EQ(expected.size(), reader.bytes_produced());
+    ASSERT_EQ(expected.size(), target_size);
+    EXPECT_EQ(0, std::memcmp(expected.data(), target.data(), target_size));
+  }
+}
+
+TEST(DeltaPatch, ReadHeader) {
+  constexpr auto kTarget = bytes::String("target");
+  PatchBuilder patch(kBase, kTarget);
+  stream::MemoryReader reader(patch.data());
+
+  Result<DeltaPatchHeader> header = ReadDeltaPatchHeader(reader);
+  ASSERT_EQ(OkStatus(), header.status());
+  EXPECT_EQ(kBase.size(), header->base_length);
+  EXPECT_EQ(kTarget.size(), header->target_length);
+
+  std::array<std::byte, crypto::sha256::kDigestSizeBytes> sha256;
+  ASSERT_EQ(OkStatus(), crypto::sha256::Hash(kTarget, sha256));
+  EXPECT_EQ(sha256, header->target_sha256);
+  EXPECT_EQ(patch.data().size(), reader.Tell());
+}
+
+TEST(DeltaPatch, ReadHeader_BadMagic) {
+  constexpr auto kNotAPatch = bytes::String("pwd2 and more bytes");
+  stream::MemoryReader reader(kNotAPatch);
+  EXPECT_EQ(Status::DataLoss(), ReadDeltaPatchHeader(reader).status());
+}
+
+TEST(DeltaPatch, ReadHeader_Truncated) {
+  PatchBuilder patch(kBase, kBase);
+  stream::MemoryReader reader(patch.data().first(patch.data().size() - 1));
+  EXPECT_EQ(Status::DataLoss(), ReadDeltaPatchHeader(reader).status());
+}
+
+TEST(DeltaPatch, Copy) {
+  PatchBuilder patch(kBase, kBase);
+  patch.Copy(0, kBase.size());
+  ExpectPatchProduces(patch.data(), kBase);
+}
+
+TEST(DeltaPatch, CopyWithOffsets) {
+  constexpr auto kTarget = bytes::String("quick fox brown dog");
+  PatchBuilder patch(kBase, kTarget);
+  patch.Copy(4, 6)   // "quick "
+      .Copy(6, 4)    // "fox "
+      .Copy(-10, 5)  // "brown"
+      .Copy(0, 1)    // " "
+      .Copy(19, 3);  // "dog"
+  ExpectPatchProduces(patch.data(), kTarget);
+}
+
+TEST(DeltaPatch, Insert) {
+  constexpr auto kTarget = bytes::String("The slow brown fox");
+  PatchBuilder patch(kBase, kTarget);
+  patch.Copy(0, 4).Insert(bytes::String("slow")).Copy(5, 10);
+  ExpectPatchProduces(patch.data(), kTarget);
+}
+
+TEST(DeltaPatch, InsertOnly) {
+  constexpr auto kTarget = bytes::String("Unrelated");
+  PatchBuilder patch(kBase, kTarget);
+  patch.Insert(kTarget);
+  ExpectPatchProduces(patch.data(), kTarget);
+}
+
+TEST(DeltaPatch, Add) {
+  // Add 1 to each byte of "quick", and wrap the following space around to 0.
+  constexpr auto kTarget = bytes::Concat(bytes::String("rvjdl"), uint8_t{0});
+  constexpr auto kDifferences = bytes::Array<1, 1, 1, 1, 1, 0xe0>();
+  PatchBuilder patch(kBase, kTarget);
+  patch.Add(4, kDifferences);
+  ExpectPatchProduces(patch.data(), kTarget);
+}
+
+TEST(DeltaPatch, AddLargerThanBuffer) {
+  std::array<std::byte, PW_SOFTWARE_UPDATE_DELTA_PATCH_BUFFER_SIZE + 5>
+      differences;
+  differences.fill(std::byte{0});
+  differences[1] = static_cast<std::byte>('a' - 'h');
+  differences.back() = std::byte{1};
+
+  std::array<std::byte, differences.size()> target;
+  std::memcpy(target.data(), kBase.data(), target.size());
+  target[1] = std::byte{'a'};
+  target.back() = static_cast<std::byte>(static_cast<uint8_t>(target.back()) +
+                                         1);
+
+  PatchBuilder patch(kBase, target);
+  patch.Add(0, differences);
+  ExpectPatchProduces(patch.data(), target);
+}
+
+TEST(DeltaPatch, EmptyTarget) {
+  PatchBuilder patch(kBase, ConstByteSpan());
+  stream::MemoryReader base(kBase);
+  stream::MemoryReader patch_reader(patch.data());
+  DeltaPatchReader reader(base, patch_reader);
+
+  std::array<std::byte, 8> target;
+  EXPECT_EQ(Status::OutOfRange(), reader.Read(target).status());
+  EXPECT_TRUE(reader.verified());
+}
+
+TEST(DeltaPatch, WrongTargetHash_FailsLastRead) {
+  constexpr auto kTarget = bytes::String("The quick");
+  PatchBuilder patch(kBase, kTarget);
+  patch.Copy(0, 4).Insert(bytes::String("QUICK"));
+
+  stream::MemoryReader base(kBase);
+  stream::MemoryReader patch_reader(patch.data());
+  DeltaPatchReader reader(base, patch_reader);
+
+  std::array<std::byte, 8> target;
+  EXPECT_EQ(OkStatus(), reader.Read(target).status());
+  EXPECT_FALSE(reader.verified());
+  EXPECT_EQ(Status::Unauthenticated(), reader.Read(target).status());
+  EXPECT_EQ(Status::Unauthenticated(), reader.status());
+  EXPECT_FALSE(reader.verified());
+  EXPECT_EQ(Status::Unauthenticated(), reader.Read(target).status());
+}
+
+TEST(DeltaPatch, OperationOutsideOfBase_IsDataLoss) {
+  constexpr auto kTarget = bytes::String("dog!");
+  for (int64_t offset : {int64_t{-1}, static_cast<int64_t>(kBase.size() - 3)}) {
+    PatchBuilder patch(kBase, kTarget);
+    patch.Copy(offset, 4);
+
+    stream::MemoryReader base(kBase);
+    stream::MemoryReader patch_reader(patch.data());
+    DeltaPatchReader reader(base, patch_reader);
+
+    std::array<std::byte, 8> target;
+    EXPECT_EQ(Status::DataLoss(), reader.Read(target).status());
+  }
+}
+
+TEST(DeltaPatch, OperationLongerThanTarget_IsDataLoss) {
+  constexpr auto kTarget = bytes::String("The");
+  PatchBuilder patch(kBase, kTarget);
+  patch.Copy(0, 4);
+
+  stream::MemoryReader base(kBase);
+  stream::MemoryReader patch_reader(patch.data());
+  DeltaPatchReader reader(base, patch_reader);
+
+  std::array<std::byte, 8> target;
+  EXPECT_EQ(Status::DataLoss(), reader.Read(target).status());
+}
+
+TEST(DeltaPatch, InvalidOperation_IsDataLoss) {
+  constexpr auto kTarget = bytes::String("The");
+  for (uint64_t word : {uint64_t{3 << 2 | 3}, uint64_t{0 << 2 | 2}}) {
+    PatchBuilder patch(kBase, kTarget);
+    patch.Operation(word).Insert(kTarget);
+
+    stream::MemoryReader base(kBase);
+    stream::MemoryReader patch_reader(patch.data());
+    DeltaPatchReader reader(base, patch_reader);
+
+    std::array<std::byte, 8> target;
+    EXPECT_EQ(Status::DataLoss(), reader.Read(target).status());
+  }
+}
+
+TEST(DeltaPatch, TruncatedPatch_IsDataLoss) {
+  constexpr auto kTarget = bytes::String("The fox");
+  PatchBuilder patch(kBase, kTarget);
+  patch.Copy(0, 4).Insert(bytes::String("fox"));
+
+  stream::MemoryReader base(kBase);
+  stream::MemoryReader patch_reader(
+      patch.data().first(patch.data().size() - 1));
+  DeltaPatchReader reader(base, patch_reader);
+
+  std::array<std::byte, 8> target;
+  EXPECT_EQ(Status::DataLoss(), reader.Read(target).status());
+  EXPECT_FALSE(reader.verified());
+}
+
+}  // namespace
+}  // namespace pw::software_update
@@ -0,0 +1,278 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PWSU"
+#define PW_LOG_LEVEL PW_LOG_LEVEL_WARN
+
+#include "pw_software_update/payload_digest_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_log/log.h"
+#include "pw_software_update/update_bundle.pwpb.h"
+
+namespace pw::software_update {
+namespace {
+
+// Protobuf wire types.
+constexpr uint32_t kWireTypeVarint = 0;
+constexpr uint32_t kWireTypeFixed64 = 1;
+constexpr uint32_t kWireTypeDelimited = 2;
+constexpr uint32_t kWireTypeFixed32 = 5;
+
+// Field numbers of a `map<string, bytes>` entry.
+constexpr uint32_t kMapEntryKey = 1;
+constexpr uint32_t kMapEntryValue = 2;
+
+constexpr uint32_t kMaxVarintShift = 63;
+
+}  // namespace
+
+void PayloadDigestWriter::Reset() {
+  state_ = State::kFieldKey;
+  varint_ = 0;
+  varint_shift_ = 0;
+  field_number_ = 0;
+  field_remaining_ = 0;
+  entry_remaining_ = 0;
+  entry_hasher_.reset();
+  digests_.clear();
+}
+
+const PayloadDigestWriter::TargetDigest* PayloadDigestWriter::FindDigest(
+    std::string_view target_name) const {
+  for (const TargetDigest& digest : digests_) {
+    if (digest.name() == target_name) {
+      return &digest;
+    }
+  }
+  return nullptr;
+}
+
+Status PayloadDigestWriter::DoWrite(ConstByteSpan data) {
+  if (Status status = destination_.Write(data); !status.ok()) {
+    // The staged bundle no longer matches what was parsed.
+    state_ = State::kError;
+    return status;
+  }
+  Parse(data);
+  return OkStatus();
+}
+
+void PayloadDigestWriter::Parse(ConstByteSpan data) {
+  while (!data.empty() && state_ != State::kError) {
+    const bool was_in_entry = InEntry();
+    size_t consumed = 1;
+
+    switch (state_) {
+      case State::kFieldKey:
+      case State::kEntryFieldKey:
+        if (ReadVarintByte(data[0])) {
+          HandleFieldKey(was_in_entry);
+        }
+        break;
+      case State::kFieldLength:
+      case State::kEntryFieldLength:
+        if (ReadVarintByte(data[0])) {
+          HandleFieldLength(was_in_entry);
+        }
+        break;
+      case State::kSkipVarint:
+      case State::kEntrySkipVarint:
+        if (ReadVarintByte(data[0])) {
+          state_ = was_in_entry ? State::kEntryFieldKey : State::kFieldKey;
+        }
+        break;
+      case State::kSkipBytes:
+      case State::kEntrySkipBytes:
+      case State::kEntryName:
+      case State::kEntryPayload:
+        consumed = static_cast<size_t>(
+            std::min<uint64_t>(data.size(), field_remaining_));
+        HandleFieldBytes(data.first(consumed));
+        field_remaining_ -= consumed;
+        if (field_remaining_ == 0) {
+          state_ = was_in_entry ? State::kEntryFieldKey : State::kFieldKey;
+        }
+        break;
+      case State::kError:
+        return;
+    }
+
+    if (was_in_entry && state_ != State::kError) {
+      if (consumed > entry_remaining_) {
+        PW_LOG_WARN("Malformed target payload entry; stop measuring");
+        state_ = State::kError;
+        return;
+      }
+      entry_remaining_ -= consumed;
+      if (entry_remaining_ == 0) {
+        if (state_ != State::kEntryFieldKey || varint_shift_ != 0) {
+          PW_LOG_WARN("Truncated target payload entry; stop measuring");
+          state_ = State::kError;
+          return;
+        }
+        state_ = State::kFieldKey;
+        FinishEntry();
+      }
+    }
+    data = data.subspan(consumed);
+  }
+}
+
+bool PayloadDigestWriter::ReadVarintByte(std::byte byte) {
+  if (varint_shift_ > kMaxVarintShift) {
+    state_ = State::kError;
+    return false;
+  }
+  varint_ |= static_cast<uint64_t>(byte & std::byte{0x7f}) << varint_shift_;
+  if ((byte & std::byte{0x80}) != std::byte{0}) {
+    varint_shift_ += 7;
+    return false;
+  }
+  varint_shift_ = 0;
+  return true;
+}
+
+void PayloadDigestWriter::HandleFieldKey(bool in_entry) {
+  const uint64_t key = varint_;
+  varint_ = 0;
+  field_number_ = static_cast<uint32_t>(key >> 3);
+  if (field_number_ == 0) {
+    state_ = State::kError;
+    return;
+  }
+
+  switch (static_cast<uint32_t>(key & 0x7)) {
+    case kWireTypeVarint:
+      state_ = in_entry ? State::kEntrySkipVarint : State::kSkipVarint;
+      break;
+    case kWireTypeFixed64:
+      field_remaining_ = sizeof(uint64_t);
+      state_ = in_entry ? State::kEntrySkipBytes : State::kSkipBytes;
+      break;
+    case kWireTypeDelimited:
+      state_ = in_entry ? State::kEntryFieldLength : State::kFieldLength;
+      break;
+    case kWireTypeFixed32:
+      field_remaining_ = sizeof(uint32_t);
+      state_ = in_entry ? State::kEntrySkipBytes : State::kSkipBytes;
+      break;
+    default:
+      PW_LOG_WARN("Unsupported wire type in bundle; stop measuring");
+      state_ = State::kError;
+      break;
+  }
+}
+
+void PayloadDigestWriter::HandleFieldLength(bool in_entry) {
+  const uint64_t length = varint_;
+  varint_ = 0;
+
+  if (!in_entry) {
+    if (field_number_ !=
+        static_cast<uint32_t>(UpdateBundle::Fields::kTargetPayloads)) {
+      field_remaining_ = length;
+      state_ = length == 0 ? State::kFieldKey : State::kSkipBytes;
+      return;
+    }
+
+    // Start of a `target_payloads` map entry.
+    entry_remaining_ = length;
+    entry_ = {};
+    entry_has_name_ = false;
+    entry_name_too_long_ = false;
+    entry_hasher_.reset();
+    if (length == 0) {
+      state_ = State::kFieldKey;
+      return;
+    }
+    state_ = State::kEntryFieldKey;
+    return;
+  }
+
+  if ((field_number_ == kMapEntryKey && entry_has_name_) ||
+      (field_number_ == kMapEntryValue && entry_hasher_.has_value())) {
+    // Repeated fields within an entry are resolved by the bundle parser, so
+    // leave them to it.
+    PW_LOG_WARN("Repeated field in target payload entry; stop measuring");
+    state_ = State::kError;
+    return;
+  }
+
+  field_remaining_ = length;
+  switch (field_number_) {
+    case kMapEntryKey:
+      entry_has_name_ = true;
+      state_ = State::kEntryName;
+      break;
+    case kMapEntryValue:
+      entry_.length = length;
+      entry_hasher_.emplace();
+      state_ = State::kEntryPayload;
+      break;
+    default:
+      state_ = State::kEntrySkipBytes;
+      break;
+  }
+  if (length == 0) {
+    state_ = State::kEntryFieldKey;
+  }
+}
+
+void PayloadDigestWriter::HandleFieldBytes(ConstByteSpan bytes) {
+  switch (state_) {
+    case State::kEntryName: {
+      const size_t available = entry_.name_buffer.size() - entry_.name_size;
+      if (bytes.size() > available) {
+        entry_name_too_long_ = true;
+        return;
+      }
+      std::memcpy(entry_.name_buffer.data() + entry_.name_size,
+                  bytes.data(),
+                  bytes.size());
+      entry_.name_size += bytes.size();
+      break;
+    }
+    case State::kEntryPayload:
+      entry_hasher_->Update(bytes);
+      break;
+    default:
+      break;
+  }
+}
+
+void PayloadDigestWriter::FinishEntry() {
+  if (!entry_has_name_ || entry_name_too_long_ || !entry_hasher_.has_value()) {
+    return;
+  }
+  if (FindDigest(entry_.name()) != nullptr) {
+    // Which of the duplicate entries is verified is up to the bundle parser,
+    // so none of the digests can be trusted to match it.
+    PW_LOG_WARN("Duplicate target payload in bundle; stop measuring");
+    digests_.clear();
+    state_ = State::kError;
+    return;
+  }
+  if (digests_.full()) {
+    return;
+  }
+  if (!entry_hasher_->Final(entry_.sha256).ok()) {
+    return;
+  }
+  digests_.push_back(entry_);
+}
+
+}  // namespace pw::software_update
@@ -18,6 +18,7 @@
 
 #include "pw_result/result.h"
 #include "pw_software_update/manifest_accessor.h"
+#include "pw_software_update/payload_digest_writer.h"
 #include "pw_software_update/update_bundle_accessor.h"
 #include "pw_status/status.h"
 #include "pw_stream/interval_reader.h"
@@ -67,6 +68,15 @@ class BundledUpdateBackend {
   // Perform any product-specific tasks needed before starting verification.
   virtual Status BeforeBundleVerify() { return OkStatus(); }
 
+  // Returns the target payload digests measured while the bundle was staged,
+  // if the bundle transfer handler wrote it through a `PayloadDigestWriter`.
+  // Verification then compares these digests instead of re-reading the
+  // measured payloads from storage. Returns null to hash all payloads from
+  // storage.
+  virtual const PayloadDigestWriter* GetStreamedPayloadDigests() {
+    return nullptr;
+  }
+
   // Perform any product-specific bundle verification tasks (e.g. hw version
   // match check), done after TUF bundle verification process.
   virtual Status VerifyManifest(
@@ -90,6 +100,32 @@ class BundledUpdateBackend {
                                  stream::SeekableReader& target_payload,
                                  size_t update_bundle_offset) = 0;
 
+  // Returns a reader for the version of a target file currently installed on
+  // the device, which delta patches in the bundle apply to. The reader must
+  // remain valid until `ApplyTargetFileFromDelta()` for the target returns.
+  //
+  // The installed target must match the on-device manifest, which is how a
+  // delta patch is checked to apply to it before it is applied.
+  virtual Result<stream::SeekableReader*> GetInstalledTargetReader(
+      [[maybe_unused]] std::string_view target_file_name) {
+    return Status::Unimplemented();
+  }
+
+  // Update the specific target file on the device from a target that is
+  // reconstructed by applying a delta patch to the installed version, as it is
+  // read. The installed version is read while this runs, so the new version
+  // must be written elsewhere, e.g. to a staging blob store.
+  //
+  // The target is only verified once it has been read to the end: a read fails
+  // if the reconstructed target does not match the manifest. Only use the new
+  // target if a read returns OUT_OF_RANGE; on any other error, discard it and
+  // return the error.
+  virtual Status ApplyTargetFileFromDelta(
+      [[maybe_unused]] std::string_view target_file_name,
+      [[maybe_unused]] stream::Reader& target_payload) {
+    return Status::Unimplemented();
+  }
+
   // Backend to probe the device manifest and prepare a ready-to-go reader
   // for it. See the comments to `GetCurrentManfestReader()` for more context.
   virtual Status BeforeManifestRead() {
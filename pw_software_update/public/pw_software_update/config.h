@@ -26,6 +26,20 @@
 #define PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE (100 * 1024 * 1024)
 #endif  // PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE
 
+// The maximum number of target payloads that a PayloadDigestWriter measures
+// while a bundle is staged. Payloads beyond this are hashed from storage during
+// verification.
+#ifndef PW_SOFTWARE_UPDATE_MAX_STREAMED_TARGETS
+#define PW_SOFTWARE_UPDATE_MAX_STREAMED_TARGETS 8
+#endif  // PW_SOFTWARE_UPDATE_MAX_STREAMED_TARGETS
+
+// The size of the buffer a DeltaPatchReader uses to combine a patch's
+// difference bytes with the installed target. Apart from this buffer, applying
+// a delta patch uses a fixed amount of memory, regardless of target size.
+#ifndef PW_SOFTWARE_UPDATE_DELTA_PATCH_BUFFER_SIZE
+#define PW_SOFTWARE_UPDATE_DELTA_PATCH_BUFFER_SIZE 32
+#endif  // PW_SOFTWARE_UPDATE_DELTA_PATCH_BUFFER_SIZE
+
 // Not recommended. Disable compilation of bundle verification.
 #ifndef PW_SOFTWARE_UPDATE_DISABLE_BUNDLE_VERIFICATION
 #define PW_SOFTWARE_UPDATE_DISABLE_BUNDLE_VERIFICATION (false)
@@ -0,0 +1,149 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_bytes/span.h"
+#include "pw_crypto/sha256.h"
+#include "pw_result/result.h"
+#include "pw_software_update/config.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::software_update {
+
+// A delta patch describes a target file in terms of the version of the target
+// that is currently installed on the device (the "base"), so that an update
+// bundle only needs to carry what changed. Delta patches are carried in the
+// `target_deltas` map of `message UpdateBundle{...}` and are generated by
+// `pw_software_update.delta` in Python.
+//
+// A patch starts with a header:
+//
+//   magic          4 bytes, "pwd1"
+//   base_length    varint
+//   base_sha256    32 bytes
+//   target_length  varint
+//   target_sha256  32 bytes
+//
+// followed by operations that produce the target in order. Each operation
+// starts with a varint of `(length << 2) | type`, where `length` is nonzero:
+//
+//   COPY (0)    zigzag varint `offset`, then copies `length` bytes of the base.
+//   ADD (1)     zigzag varint `offset`, then `length` bytes, each of which is
+//               added (modulo 256) to the corresponding base byte.
+//   INSERT (2)  `length` bytes, which are copied to the target as is.
+//
+// The base position of COPY and ADD is `offset` bytes from the end of the
+// previous COPY or ADD, or from the start of the base for the first one. ADD
+// is the bsdiff-style operation for code that moved: most of its difference
+// bytes are zero, which compresses well if the bundle is compressed in
+// transit.
+struct DeltaPatchHeader {
+  uint64_t base_length;
+  std::array<std::byte, crypto::sha256::kDigestSizeBytes> base_sha256;
+  uint64_t target_length;
+  std::array<std::byte, crypto::sha256::kDigestSizeBytes> target_sha256;
+};
+
+// Reads the header of a delta patch, leaving `patch` at the first operation.
+//
+// Returns:
+// OK - The header was read.
+// DATA_LOSS - The patch is not a delta patch or is truncated.
+// OUT_OF_RANGE - The base or target is larger than
+//     PW_SOFTWARE_UPDATE_MAX_TARGET_PAYLOAD_SIZE.
+Result<DeltaPatchHeader> ReadDeltaPatchHeader(stream::Reader& patch);
+
+// DeltaPatchReader reconstructs a target file by applying a delta patch to the
+// installed version of the target, as it is read.
+//
+// The target is never held in memory: each read produces as many bytes as
+// requested from the patch and the base, and also hashes them. Once the whole
+// target has been produced, its SHA256 hash is compared with the one in the
+// patch header, and the read that produces the last bytes fails unless the
+// hashes match. A consumer that writes the target somewhere, e.g. to a blob
+// store, must therefore only keep it after a read returns OUT_OF_RANGE.
+//
+// The patch header must be verified against the trusted target metadata before
+// the target is used. `UpdateBundleAccessor` does this for `target_deltas`.
+class DeltaPatchReader final : public stream::NonSeekableReader {
+ public:
+  // base - The installed version of the target.
+  // patch - The delta patch, at its first byte.
+  DeltaPatchReader(stream::SeekableReader& base, stream::Reader& patch)
+      : base_(base), patch_(patch) {}
+
+  // Returns the error that stopped reconstruction, if any. Once an error
+  // occurs, all reads fail with it.
+  Status status() const { return status_; }
+
+  // Returns the number of target bytes produced so far.
+  uint64_t bytes_produced() const { return produced_; }
+
+  // Returns true once the whole target has been produced and matches the hash
+  // in the patch header.
+  bool verified() const {
+    return status_.ok() && header_.has_value() &&
+           produced_ == header_->target_length;
+  }
+
+ private:
+  enum class Operation : uint8_t {
+    kCopy = 0,
+    kAdd = 1,
+    kInsert = 2,
+  };
+
+  StatusWithSize DoRead(ByteSpan destination) override;
+
+  // Reads the header and starts hashing the target.
+  Status Start();
+
+  // Reads the next operation and positions the base for it.
+  Status StartOperation();
+
+  // Produces `destination.size()` bytes of the current operation.
+  Status Produce(ByteSpan destination);
+
+  // Compares the hash of the produced target with the header.
+  Status Finish();
+
+  StatusWithSize Fail(Status status) {
+    status_ = status;
+    return StatusWithSize(status, 0);
+  }
+
+  stream::SeekableReader& base_;
+  stream::Reader& patch_;
+  Status status_;
+
+  std::optional<DeltaPatchHeader> header_;
+  std::optional<crypto::sha256::Sha256> hasher_;
+  uint64_t produced_ = 0;
+
+  Operation operation_ = Operation::kCopy;
+  uint64_t operation_remaining_ = 0;
+  uint64_t base_position_ = 0;
+
+  // Holds difference bytes of an ADD operation.
+  std::array<std::byte, PW_SOFTWARE_UPDATE_DELTA_PATCH_BUFFER_SIZE> buffer_;
+};
+
+}  // namespace pw::software_update
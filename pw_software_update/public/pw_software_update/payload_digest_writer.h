@@ -0,0 +1,122 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_containers/vector.h"
+#include "pw_crypto/sha256.h"
+#include "pw_software_update/config.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::software_update {
+
+// PayloadDigestWriter measures the target payloads of an update bundle while
+// the bundle is being staged.
+//
+// It forwards all bytes to the writer that stages the bundle (e.g. a blob store
+// writer fed by the bundle transfer handler) and, in the same pass, follows the
+// serialized `UpdateBundle` to compute the length and SHA256 hash of each entry
+// in `target_payloads`. A backend that exposes these digests through
+// `BundledUpdateBackend::GetStreamedPayloadDigests()` spares
+// `UpdateBundleAccessor` from re-reading every payload from storage during
+// verification; the accessor then only compares digests.
+//
+// The digests are advisory: any target that was not measured, including all
+// targets after malformed input, is hashed from storage as before.
+//
+// `Reset()` must be called before staging a new bundle.
+class PayloadDigestWriter final : public stream::NonSeekableWriter {
+ public:
+  struct TargetDigest {
+    std::string_view name() const {
+      return std::string_view(name_buffer.data(), name_size);
+    }
+
+    std::array<char, MAX_TARGET_NAME_LENGTH> name_buffer;
+    size_t name_size;
+    uint64_t length;
+    std::array<std::byte, crypto::sha256::kDigestSizeBytes> sha256;
+  };
+
+  explicit PayloadDigestWriter(stream::Writer& destination)
+      : destination_(destination) {}
+
+  // Discards all digests and starts measuring a new bundle.
+  void Reset();
+
+  // Returns the digest of the in-bundle payload of the named target, or null
+  // if the target was not measured.
+  const TargetDigest* FindDigest(std::string_view target_name) const;
+
+ private:
+  enum class State {
+    kFieldKey,
+    kFieldLength,
+    kSkipVarint,
+    kSkipBytes,
+    kEntryFieldKey,
+    kEntryFieldLength,
+    kEntrySkipVarint,
+    kEntrySkipBytes,
+    kEntryName,
+    kEntryPayload,
+    kError,
+  };
+
+  Status DoWrite(ConstByteSpan data) override;
+
+  // Advances the parser over `data`.
+  void Parse(ConstByteSpan data);
+
+  // Accumulates one byte of a varint. Returns true once the varint is
+  // complete, at which point its value is in `varint_`.
+  bool ReadVarintByte(std::byte byte);
+
+  void HandleFieldKey(bool in_entry);
+  void HandleFieldLength(bool in_entry);
+  void HandleFieldBytes(ConstByteSpan bytes);
+
+  // Records the digest of the map entry that just ended, if it was complete.
+  void FinishEntry();
+
+  bool InEntry() const {
+    return state_ >= State::kEntryFieldKey && state_ <= State::kEntryPayload;
+  }
+
+  stream::Writer& destination_;
+  State state_ = State::kFieldKey;
+
+  uint64_t varint_ = 0;
+  uint32_t varint_shift_ = 0;
+  uint32_t field_number_ = 0;
+  uint64_t field_remaining_ = 0;
+  uint64_t entry_remaining_ = 0;
+
+  // The `target_payloads` map entry being measured.
+  TargetDigest entry_ = {};
+  bool entry_has_name_ = false;
+  bool entry_name_too_long_ = false;
+  std::optional<crypto::sha256::Sha256> entry_hasher_;
+
+  Vector<TargetDigest, PW_SOFTWARE_UPDATE_MAX_STREAMED_TARGETS> digests_;
+};
+
+}  // namespace pw::software_update
@@ -103,6 +103,11 @@ class UpdateBundleAccessor {
   //    stripped of any target payloads that the device already have. For those
   //    personalized-out targets, verification relies on the cached manifest of
   //    a previous successful update to verify target length and hash.
+  // 6. Supports delta patches, which reconstruct a target from the version
+  //    installed on the device. The patch header must name the target length
+  //    and hash in the manifest, and an installed version that matches the
+  //    cached manifest. The reconstructed target is verified as it is applied;
+  //    see `DeltaPatchReader`.
   //
   // Returns:
   // OK - Bundle was successfully opened and verified.
@@ -130,12 +135,32 @@ class UpdateBundleAccessor {
   stream::IntervalReader GetTargetPayload(std::string_view target_name);
   stream::IntervalReader GetTargetPayload(protobuf::String target_name);
 
+  // Returns a reader for the delta patch of a specified target file, for
+  // targets that are not in the bundle in full. The patch header has been
+  // verified; the target it produces is verified by `DeltaPatchReader`.
+  //
+  // Returns:
+  // A reader instance for the delta patch, or NOT_FOUND.
+  stream::IntervalReader GetTargetDelta(std::string_view target_name);
+
+  // Applies the delta patch of a specified target file, by passing the target
+  // it reconstructs from the installed version of the target to
+  // `BundledUpdateBackend::ApplyTargetFileFromDelta()`.
+  //
+  // Returns:
+  // The length of the target, once it has been applied and verified.
+  // NOT_FOUND - The bundle has no delta patch for the target.
+  // UNAUTHENTICATED - The reconstructed target does not match the manifest.
+  // DATA_LOSS - The delta patch is malformed, or the backend did not read the
+  //     whole target.
+  Result<uint64_t> ApplyTargetDelta(std::string_view target_name);
+
   // Exposes "manifest" information from the incoming update bundle once it has
   // passed verification.
   ManifestAccessor GetManifest();
 
   // Returns the total number of bytes of all target payloads listed in the
-  // manifest *AND* exists in the bundle.
+  // manifest *AND* exists in the bundle, in full or as a delta patch.
   Result<uint64_t> GetTotalPayloadSize();
 
  private:
@@ -227,8 +252,10 @@ class UpdateBundleAccessor {
                              protobuf::Bytes expected_sha256);
 
   // For a target the payload of which is included in the bundle, verify
-  // it measures up to the expected length and sha256 hash.
-  Status VerifyInBundleTargetPayload(protobuf::Uint64 expected_length,
+  // it measures up to the expected length and sha256 hash. The payload is only
+  // hashed if the backend did not measure it while the bundle was staged.
+  Status VerifyInBundleTargetPayload(std::string_view name,
+                                     protobuf::Uint64 expected_length,
                                      protobuf::Bytes expected_sha256,
                                      stream::IntervalReader payload_reader);
 
@@ -238,6 +265,14 @@ class UpdateBundleAccessor {
   Status VerifyOutOfBundleTargetPayload(std::string_view name,
                                         protobuf::Uint64 expected_length,
                                         protobuf::Bytes expected_sha256);
+
+  // For a target carried as a delta patch, verify the patch produces the
+  // expected length and sha256 hash, and applies to the installed version of
+  // the target recorded in the on-device manifest.
+  Status VerifyDeltaTargetPayload(std::string_view name,
+                                  protobuf::Uint64 expected_length,
+                                  protobuf::Bytes expected_sha256,
+                                  stream::IntervalReader delta_reader);
 };
 
 }  // namespace pw::software_update
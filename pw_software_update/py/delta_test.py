@@ -0,0 +1,104 @@
+# Copyright 2024 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Unit tests for pw_software_update/delta.py."""
+
+import hashlib
+import random
+import unittest
+
+from pw_software_update import delta
+
+
+def _random_bytes(rng: random.Random, size: int) -> bytes:
+    return bytes(rng.getrandbits(8) for _ in range(size))
+
+
+class DeltaPatchTest(unittest.TestCase):
+    """Test creating and applying delta patches."""
+
+    def setUp(self):
+        self.rng = random.Random(0x5EED)
+        self.base = _random_bytes(self.rng, 4096)
+
+    def _check_round_trip(self, target: bytes) -> bytes:
+        patch = delta.create_patch(self.base, target)
+        self.assertEqual(target, delta.apply_patch(self.base, patch))
+        return patch
+
+    def test_header(self):
+        target = b'new target'
+        patch = delta.create_patch(self.base, target)
+        self.assertEqual(
+            (
+                len(self.base),
+                hashlib.sha256(self.base).digest(),
+                len(target),
+                hashlib.sha256(target).digest(),
+            ),
+            delta.read_header(patch),
+        )
+
+    def test_identical_target_is_small(self):
+        patch = self._check_round_trip(self.base)
+        self.assertLess(len(patch), 100)
+
+    def test_inserted_and_removed_data(self):
+        target = (
+            self.base[:1000]
+            + _random_bytes(self.rng, 50)
+            + self.base[1000:3000]
+            + self.base[3500:]
+        )
+        patch = self._check_round_trip(target)
+        self.assertLess(len(patch), 200)
+
+    def test_reordered_data(self):
+        target = self.base[2048:] + self.base[:2048]
+        patch = self._check_round_trip(target)
+        self.assertLess(len(patch), 100)
+
+    def test_sparse_changes_use_add(self):
+        target = bytearray(self.base)
+        for offset in range(100, len(target), 64):
+            target[offset] ^= 0x01
+        patch = self._check_round_trip(bytes(target))
+        # The changes become mostly zero difference bytes.
+        self.assertGreater(patch.count(0), len(target) * 9 // 10)
+
+    def test_unrelated_and_empty_targets(self):
+        self._check_round_trip(_random_bytes(self.rng, 1000))
+        self._check_round_trip(b'')
+        self.base = b''
+        self._check_round_trip(b'no base')
+
+    def test_wrong_base_is_rejected(self):
+        patch = delta.create_patch(self.base, self.base[::-1])
+        with self.assertRaises(delta.DeltaPatchError):
+            delta.apply_patch(self.base[1:], patch)
+
+    def test_truncated_patch_is_rejected(self):
+        patch = delta.create_patch(self.base, self.base[100:])
+        with self.assertRaises(delta.DeltaPatchError):
+            delta.apply_patch(self.base, patch[:-1])
+
+    def test_corrupted_patch_is_rejected(self):
+        target = _random_bytes(self.rng, 100)
+        patch = bytearray(delta.create_patch(self.base, target))
+        patch[-1] ^= 0xFF
+        with self.assertRaises(delta.DeltaPatchError):
+            delta.apply_patch(self.base, bytes(patch))
+
+
+if __name__ == '__main__':
+    unittest.main()
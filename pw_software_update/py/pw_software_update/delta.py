@@ -0,0 +1,238 @@
+# Copyright 2024 The Pigweed Authors
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not
+# use this file except in compliance with the License. You may obtain a copy of
+# the License at
+#
+#     https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+# License for the specific language governing permissions and limitations under
+# the License.
+"""Create and apply delta patches for target files.
+
+The patch format is documented in pw_software_update/delta_patch.h, which
+applies patches on device.
+"""
+
+import hashlib
+
+MAGIC = b'pwd1'
+
+COPY = 0
+ADD = 1
+INSERT = 2
+
+# Size of the base blocks that are indexed to find matches.
+_BLOCK_SIZE = 16
+
+# Number of bytes past the last match an ADD operation looks for more matches.
+_ADD_LOOKAHEAD = 32
+
+
+class DeltaPatchError(Exception):
+    """Raised when a delta patch is malformed or does not apply."""
+
+
+def _encode_varint(value: int) -> bytes:
+    encoded = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            encoded.append(byte | 0x80)
+        else:
+            encoded.append(byte)
+            return bytes(encoded)
+
+
+def _encode_zigzag(value: int) -> bytes:
+    return _encode_varint(value * 2 if value >= 0 else -value * 2 - 1)
+
+
+class _PatchReader:
+    """Reads the fields of a patch in order."""
+
+    def __init__(self, patch: bytes):
+        self._patch = patch
+        self._position = 0
+
+    def read(self, size: int) -> bytes:
+        if size > len(self._patch) - self._position:
+            raise DeltaPatchError('Patch is truncated')
+        data = self._patch[self._position : self._position + size]
+        self._position += size
+        return data
+
+    def read_varint(self) -> int:
+        value = 0
+        shift = 0
+        while True:
+            byte = self.read(1)[0]
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    def read_zigzag(self) -> int:
+        value = self.read_varint()
+        return value >> 1 if not value & 1 else -(value >> 1) - 1
+
+
+def _match_length(
+    base: bytes, base_start: int, target: bytes, start: int
+) -> int:
+    length = 0
+    limit = min(len(base) - base_start, len(target) - start)
+    while (
+        length < limit and base[base_start + length] == target[start + length]
+    ):
+        length += 1
+    return length
+
+
+def _add_length(
+    base: bytes, base_start: int, target: bytes, start: int
+) -> int:
+    """Returns how far an ADD operation should extend a match.
+
+    Like bsdiff, extends over bytes that mostly match, so that code which moved
+    but references moved addresses becomes a run of mostly zero differences.
+    """
+    limit = min(len(base) - base_start, len(target) - start)
+    best_score = 0
+    best_length = 0
+    score = 0
+    length = 0
+    while length < limit and length - best_length < _ADD_LOOKAHEAD:
+        if base[base_start + length] == target[start + length]:
+            score += 1
+        else:
+            score -= 1
+        length += 1
+        if score > best_score:
+            best_score = score
+            best_length = length
+    return best_length
+
+
+def create_patch(base: bytes, target: bytes) -> bytes:
+    """Creates a patch that produces target from base."""
+    index: dict[bytes, int] = {}
+    for offset in range(0, len(base) - _BLOCK_SIZE + 1, _BLOCK_SIZE):
+        index.setdefault(base[offset : offset + _BLOCK_SIZE], offset)
+
+    patch = bytearray(MAGIC)
+    patch += _encode_varint(len(base))
+    patch += hashlib.sha256(base).digest()
+    patch += _encode_varint(len(target))
+    patch += hashlib.sha256(target).digest()
+
+    def add_operation(operation: int, length: int) -> None:
+        patch.extend(_encode_varint(length << 2 | operation))
+
+    base_position = 0
+    literal_start = 0
+    position = 0
+    while position + _BLOCK_SIZE <= len(target):
+        base_start = index.get(target[position : position + _BLOCK_SIZE])
+        if base_start is None:
+            position += 1
+            continue
+
+        # Extend the match backwards over bytes that would be inserted.
+        while (
+            position > literal_start
+            and base_start > 0
+            and target[position - 1] == base[base_start - 1]
+        ):
+            position -= 1
+            base_start -= 1
+
+        if position > literal_start:
+            add_operation(INSERT, position - literal_start)
+            patch += target[literal_start:position]
+
+        copy_length = _match_length(base, base_start, target, position)
+        add_operation(COPY, copy_length)
+        patch += _encode_zigzag(base_start - base_position)
+        position += copy_length
+        base_position = base_start + copy_length
+
+        add_length = _add_length(base, base_position, target, position)
+        if add_length:
+            add_operation(ADD, add_length)
+            patch += _encode_zigzag(0)
+            patch += bytes(
+                (target[position + i] - base[base_position + i]) & 0xFF
+                for i in range(add_length)
+            )
+            position += add_length
+            base_position += add_length
+
+        literal_start = position
+
+    if literal_start < len(target):
+        add_operation(INSERT, len(target) - literal_start)
+        patch += target[literal_start:]
+
+    return bytes(patch)
+
+
+def read_header(patch: bytes) -> tuple[int, bytes, int, bytes]:
+    """Returns the base length and hash and target length and hash."""
+    return _read_header(_PatchReader(patch))
+
+
+def _read_header(reader: _PatchReader) -> tuple[int, bytes, int, bytes]:
+    if reader.read(len(MAGIC)) != MAGIC:
+        raise DeltaPatchError('Not a delta patch')
+    return (
+        reader.read_varint(),
+        reader.read(hashlib.sha256().digest_size),
+        reader.read_varint(),
+        reader.read(hashlib.sha256().digest_size),
+    )
+
+
+def apply_patch(base: bytes, patch: bytes) -> bytes:
+    """Applies a patch to base and returns the target it produces."""
+    reader = _PatchReader(patch)
+    base_length, base_sha256, target_length, target_sha256 = _read_header(
+        reader
+    )
+
+    if len(base) != base_length or hashlib.sha256(base).digest() != base_sha256:
+        raise DeltaPatchError('Patch does not apply to this base')
+
+    target = bytearray()
+    base_position = 0
+    while len(target) < target_length:
+        word = reader.read_varint()
+        operation = word & 0x3
+        length = word >> 2
+        if length == 0 or length > target_length - len(target):
+            raise DeltaPatchError('Operation exceeds the target')
+
+        if operation == INSERT:
+            target += reader.read(length)
+            continue
+        if operation not in (COPY, ADD):
+            raise DeltaPatchError(f'Unknown operation {operation}')
+
+        base_position += reader.read_zigzag()
+        if base_position < 0 or base_position + length > len(base):
+            raise DeltaPatchError('Operation is outside of the base')
+        source = base[base_position : base_position + length]
+        if operation == ADD:
+            source = bytes(
+                (a + b) & 0xFF for a, b in zip(source, reader.read(length))
+            )
+        target += source
+        base_position += length
+
+    if hashlib.sha256(target).digest() != target_sha256:
+        raise DeltaPatchError('Patched target has a bad hash')
+    return bytes(target)
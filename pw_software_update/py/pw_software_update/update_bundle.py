@@ -20,7 +20,7 @@ from pathlib import Path
 import shutil
 from typing import Iterable
 
-from pw_software_update import metadata
+from pw_software_update import delta, metadata
 from pw_software_update.tuf_pb2 import SignedRootMetadata, SignedTargetsMetadata
 from pw_software_update.update_bundle_pb2 import UpdateBundle
 
@@ -168,6 +168,32 @@ def gen_unsigned_update_bundle(
     )
 
 
+def add_target_deltas(
+    bundle: UpdateBundle, installed_targets: dict[str, bytes]
+) -> None:
+    """Replaces target payloads with delta patches where they are smaller.
+
+    Args:
+      bundle: The bundle to modify.
+      installed_targets: A dict mapping target names to the contents of the
+        targets currently installed on the device the bundle is for.
+
+    Each patch applies to the given installed version of its target only. The
+    device verifies the target it reconstructs against the hash in the targets
+    metadata, which is unchanged, so this may be done before or after signing.
+    """
+    for target_name, base in installed_targets.items():
+        if target_name not in bundle.target_payloads:
+            continue
+        payload = bundle.target_payloads[target_name]
+        patch = delta.create_patch(base, payload)
+        if len(patch) >= len(payload):
+            _LOG.info('Delta for "%s" is not smaller; skipping', target_name)
+            continue
+        del bundle.target_payloads[target_name]
+        bundle.target_deltas[target_name] = patch
+
+
 def parse_target_arg(target_arg: str) -> tuple[Path, str]:
     """Parse an individual target string passed in to the --targets argument.
 
@@ -234,6 +260,17 @@ def parse_args() -> argparse.Namespace:
         default=None,
         help='Path to the signed Root metadata',
     )
+    parser.add_argument(
+        '--installed-targets',
+        type=str,
+        nargs='+',
+        default=(),
+        help=(
+            'Strings defining the targets installed on the device, in the'
+            ' same form as --targets. Bundled targets are replaced by delta'
+            ' patches against these where that makes them smaller'
+        ),
+    )
     return parser.parse_args()
 
 
@@ -244,6 +281,7 @@ def main(
     targets_metadata_version: int = metadata.DEFAULT_METADATA_VERSION,
     targets_metadata_version_file: Path | None = None,
     signed_root_metadata: Path | None = None,
+    installed_targets: Iterable[str] = (),
 ) -> None:
     """Generates an UpdateBundle and serializes it to disk."""
     target_dict = {}
@@ -265,6 +303,12 @@ def main(
         target_dict, persist, targets_metadata_version, root_metadata
     )
 
+    installed_dict = {}
+    for target_arg in installed_targets:
+        path, target_name = parse_target_arg(target_arg)
+        installed_dict[target_name] = path.read_bytes()
+    add_target_deltas(bundle, installed_dict)
+
     out.write_bytes(bundle.SerializeToString())
 
 
@@ -27,7 +27,9 @@
 #include "pw_protobuf/message.h"
 #include "pw_result/result.h"
 #include "pw_software_update/config.h"
+#include "pw_software_update/delta_patch.h"
 #include "pw_software_update/manifest_accessor.h"
+#include "pw_software_update/payload_digest_writer.h"
 #include "pw_software_update/update_bundle.pwpb.h"
 #include "pw_stream/interval_reader.h"
 #include "pw_stream/memory_stream.h"
@@ -246,6 +248,22 @@ Result<std::string_view> ReadProtoString(protobuf::String str,
   return std::string_view(buffer.data(), res.value().size());
 }
 
+// Returns the SHA256 hash of a `message TargetFile{...}`.
+protobuf::Bytes GetTargetSha256(protobuf::Message target_file) {
+  protobuf::RepeatedMessages hashes = target_file.AsRepeatedMessages(
+      static_cast<uint32_t>(TargetFile::Fields::kHashes));
+  for (protobuf::Message hash : hashes) {
+    protobuf::Uint32 hash_function =
+        hash.AsUint32(static_cast<uint32_t>(Hash::Fields::kFunction));
+    PW_TRY(hash_function.status());
+
+    if (hash_function.value() == static_cast<uint32_t>(HashFunction::SHA256)) {
+      return hash.AsBytes(static_cast<uint32_t>(Hash::Fields::kHash));
+    }
+  }
+  return Status::NotFound();
+}
+
 }  // namespace
 
 Status UpdateBundleAccessor::OpenAndVerify() {
@@ -271,6 +289,8 @@ Result<uint64_t> UpdateBundleAccessor::GetTotalPayloadSize() {
   protobuf::StringToBytesMap bundled_payloads = bundle_.AsStringToBytesMap(
       static_cast<uint32_t>(UpdateBundle::Fields::kTargetPayloads));
   PW_TRY(bundled_payloads.status());
+  protobuf::StringToBytesMap bundled_deltas = bundle_.AsStringToBytesMap(
+      static_cast<uint32_t>(UpdateBundle::Fields::kTargetDeltas));
 
   uint64_t total_bytes = 0;
   std::array<std::byte, MAX_TARGET_NAME_LENGTH> name_buffer = {};
@@ -291,7 +311,7 @@ Result<uint64_t> UpdateBundleAccessor::GetTotalPayloadSize() {
     std::string_view name_view(reinterpret_cast<const char*>(name_span.data()),
                                name_span.size_bytes());
 
-    if (!bundled_payloads[name_view].ok()) {
+    if (!bundled_payloads[name_view].ok() && !bundled_deltas[name_view].ok()) {
       continue;
     }
     protobuf::Uint64 target_length =
@@ -323,6 +343,39 @@ stream::IntervalReader UpdateBundleAccessor::GetTargetPayload(
   return GetTargetPayload(name_view.value());
 }
 
+stream::IntervalReader UpdateBundleAccessor::GetTargetDelta(
+    std::string_view target_name) {
+  protobuf::Message manifest_entry = GetManifest().GetTargetFile(target_name);
+  PW_TRY(manifest_entry.status());
+
+  protobuf::StringToBytesMap deltas_map = bundle_.AsStringToBytesMap(
+      static_cast<uint32_t>(UpdateBundle::Fields::kTargetDeltas));
+  return deltas_map[target_name].GetBytesReader();
+}
+
+Result<uint64_t> UpdateBundleAccessor::ApplyTargetDelta(
+    std::string_view target_name) {
+  stream::IntervalReader delta_reader = GetTargetDelta(target_name);
+  PW_TRY(delta_reader.status());
+
+  Result<stream::SeekableReader*> installed =
+      backend_.GetInstalledTargetReader(target_name);
+  PW_TRY(installed.status());
+  PW_CHECK_NOTNULL(installed.value());
+
+  DeltaPatchReader target_reader(*installed.value(), delta_reader);
+  PW_TRY(backend_.ApplyTargetFileFromDelta(target_name, target_reader));
+
+  // Nothing the backend did with the target counts unless all of it was read
+  // and verified.
+  if (!target_reader.verified()) {
+    PW_LOG_ERROR("Target from delta patch was not verified");
+    return target_reader.status().ok() ? Status::DataLoss()
+                                       : target_reader.status();
+  }
+  return target_reader.bytes_produced();
+}
+
 Status UpdateBundleAccessor::PersistManifest() {
   ManifestAccessor manifest = GetManifest();
   // GetManifest() fails if the bundle is yet to be verified.
@@ -670,21 +723,7 @@ Status UpdateBundleAccessor::VerifyTargetsPayloads() {
     }
 
     // Get target SHA256 hash.
-    protobuf::Bytes target_sha256 = Status::NotFound();
-    protobuf::RepeatedMessages hashes = target_file.AsRepeatedMessages(
-        static_cast<uint32_t>(TargetFile::Fields::kHashes));
-    for (protobuf::Message hash : hashes) {
-      protobuf::Uint32 hash_function =
-          hash.AsUint32(static_cast<uint32_t>(Hash::Fields::kFunction));
-      PW_TRY(hash_function.status());
-
-      if (hash_function.value() ==
-          static_cast<uint32_t>(HashFunction::SHA256)) {
-        target_sha256 =
-            hash.AsBytes(static_cast<uint32_t>(Hash::Fields::kHash));
-        break;
-      }
-    }
+    protobuf::Bytes target_sha256 = GetTargetSha256(target_file);
     PW_TRY(target_sha256.status());
 
     if (Status status = VerifyTargetPayload(
@@ -709,11 +748,19 @@ Status UpdateBundleAccessor::VerifyTargetPayload(
   stream::IntervalReader payload_reader =
       payloads_map[target_name].GetBytesReader();
 
+  protobuf::StringToBytesMap deltas_map = bundle_.AsStringToBytesMap(
+      static_cast<uint32_t>(UpdateBundle::Fields::kTargetDeltas));
+  stream::IntervalReader delta_reader =
+      deltas_map[target_name].GetBytesReader();
+
   Status status;
 
   if (payload_reader.ok()) {
     status = VerifyInBundleTargetPayload(
-        expected_length, expected_sha256, payload_reader);
+        target_name, expected_length, expected_sha256, payload_reader);
+  } else if (delta_reader.ok()) {
+    status = VerifyDeltaTargetPayload(
+        target_name, expected_length, expected_sha256, delta_reader);
   } else {
     status = VerifyOutOfBundleTargetPayload(
         target_name, expected_length, expected_sha256);
@@ -759,19 +806,7 @@ Status UpdateBundleAccessor::VerifyOutOfBundleTargetPayload(
     return Status::Unauthenticated();
   }
 
-  protobuf::Bytes cached_sha256 = Status::NotFound();
-  protobuf::RepeatedMessages hashes = cached.AsRepeatedMessages(
-      static_cast<uint32_t>(TargetFile::Fields::kHashes));
-  for (protobuf::Message hash : hashes) {
-    protobuf::Uint32 hash_function =
-        hash.AsUint32(static_cast<uint32_t>(Hash::Fields::kFunction));
-    PW_TRY(hash_function.status());
-
-    if (hash_function.value() == static_cast<uint32_t>(HashFunction::SHA256)) {
-      cached_sha256 = hash.AsBytes(static_cast<uint32_t>(Hash::Fields::kHash));
-      break;
-    }
-  }
+  protobuf::Bytes cached_sha256 = GetTargetSha256(cached);
   std::byte sha256[crypto::sha256::kDigestSizeBytes] = {};
   PW_TRY(cached_sha256.GetBytesReader().Read(sha256));
 
@@ -790,6 +825,7 @@ Status UpdateBundleAccessor::VerifyOutOfBundleTargetPayload(
 }
 
 Status UpdateBundleAccessor::VerifyInBundleTargetPayload(
+    std::string_view target_name,
     protobuf::Uint64 expected_length,
     protobuf::Bytes expected_sha256,
     stream::IntervalReader payload_reader) {
@@ -804,7 +840,19 @@ Status UpdateBundleAccessor::VerifyInBundleTargetPayload(
   }
 
   std::byte actual_sha256[crypto::sha256::kDigestSizeBytes] = {};
-  PW_TRY(crypto::sha256::Hash(payload_reader, actual_sha256));
+  const PayloadDigestWriter* streamed_digests =
+      backend_.GetStreamedPayloadDigests();
+  const PayloadDigestWriter::TargetDigest* streamed_digest =
+      streamed_digests != nullptr ? streamed_digests->FindDigest(target_name)
+                                  : nullptr;
+  if (streamed_digest != nullptr && streamed_digest->length == actual_length) {
+    // The payload was measured as the bundle was staged.
+    std::memcpy(actual_sha256,
+                streamed_digest->sha256.data(),
+                sizeof(actual_sha256));
+  } else {
+    PW_TRY(crypto::sha256::Hash(payload_reader, actual_sha256));
+  }
   Result<bool> hash_equal = expected_sha256.Equal(actual_sha256);
   PW_TRY(hash_equal.status());
   if (!hash_equal.value()) {
@@ -815,6 +863,71 @@ Status UpdateBundleAccessor::VerifyInBundleTargetPayload(
   return OkStatus();
 }
 
+Status UpdateBundleAccessor::VerifyDeltaTargetPayload(
+    std::string_view target_name,
+    protobuf::Uint64 expected_length,
+    protobuf::Bytes expected_sha256,
+    stream::IntervalReader delta_reader) {
+  // The target is only produced when the patch is applied, so check that the
+  // patch claims to produce the expected target. `DeltaPatchReader` then
+  // holds the produced target to the claim.
+  Result<DeltaPatchHeader> header = ReadDeltaPatchHeader(delta_reader);
+  if (!header.ok()) {
+    PW_LOG_ERROR("Malformed delta patch");
+    return Status::Unauthenticated();
+  }
+
+  if (header->target_length != expected_length.value()) {
+    PW_LOG_ERROR("Wrong delta target length. Expected: %u, actual: %u",
+                 static_cast<unsigned>(expected_length.value()),
+                 static_cast<unsigned>(header->target_length));
+    return Status::Unauthenticated();
+  }
+
+  Result<bool> hash_equal = expected_sha256.Equal(header->target_sha256);
+  PW_TRY(hash_equal.status());
+  if (!hash_equal.value()) {
+    PW_LOG_ERROR("Wrong delta target sha256 hash");
+    return Status::Unauthenticated();
+  }
+
+  if (self_verification_) {
+    PW_LOG_WARN("Self verification skips delta patch base check");
+    return OkStatus();
+  }
+
+  // The patch only applies to the installed version it was made against,
+  // which the on-device manifest describes.
+  ManifestAccessor device_manifest = GetOnDeviceManifest();
+  if (!device_manifest.ok()) {
+    PW_LOG_ERROR(
+        "Can't apply delta patch because on-device manifest is not found");
+    return Status::FailedPrecondition();
+  }
+
+  protobuf::Message installed = device_manifest.GetTargetFile(target_name);
+  if (!installed.ok()) {
+    PW_LOG_ERROR(
+        "Can't apply delta patch because target is not found from on-device "
+        "manifest");
+    return Status::FailedPrecondition();
+  }
+
+  protobuf::Uint64 installed_length =
+      installed.AsUint64(static_cast<uint32_t>(TargetFile::Fields::kLength));
+  PW_TRY(installed_length.status());
+  protobuf::Bytes installed_sha256 = GetTargetSha256(installed);
+  PW_TRY(installed_sha256.status());
+  hash_equal = installed_sha256.Equal(header->base_sha256);
+  PW_TRY(hash_equal.status());
+  if (installed_length.value() != header->base_length || !hash_equal.value()) {
+    PW_LOG_ERROR("Delta patch does not apply to the installed target");
+    return Status::FailedPrecondition();
+  }
+
+  return OkStatus();
+}
+
 ManifestAccessor UpdateBundleAccessor::GetManifest() {
   if (!bundle_verified_) {
     PW_LOG_DEBUG("Bundled has not passed verification yet");
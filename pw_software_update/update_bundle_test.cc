@@ -12,13 +12,16 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <algorithm>
 #include <array>
+#include <cstring>
 
 #include "pw_blob_store/blob_store.h"
 #include "pw_kvs/fake_flash_memory.h"
 #include "pw_kvs/test_key_value_store.h"
 #include "pw_software_update/blob_store_openable_reader.h"
 #include "pw_software_update/bundled_update_backend.h"
+#include "pw_software_update/payload_digest_writer.h"
 #include "pw_software_update/update_bundle_accessor.h"
 #include "pw_stream/memory_stream.h"
 #include "pw_unit_test/framework.h"
@@ -116,6 +119,14 @@ class TestBundledUpdateBackend final : public BundledUpdateBackend {
 
   bool IsNewRootPersisted() const { return new_root_persisted_; }
 
+  void SetStreamedPayloadDigests(const PayloadDigestWriter* digests) {
+    streamed_payload_digests_ = digests;
+  }
+
+  const PayloadDigestWriter* GetStreamedPayloadDigests() override {
+    return streamed_payload_digests_;
+  }
+
  private:
   stream::IntervalReader trusted_root_reader_;
   stream::MemoryReader manifest_reader_;
@@ -124,6 +135,7 @@ class TestBundledUpdateBackend final : public BundledUpdateBackend {
   bool before_manifest_write_called_ = false;
   bool after_manifest_write_called_ = false;
   bool new_root_persisted_ = false;
+  const PayloadDigestWriter* streamed_payload_digests_ = nullptr;
 
   // A memory reader for buffer passed by SetTrustedRoot(). This will be used
   // to back `trusted_root_reader_`
@@ -199,6 +211,18 @@ class UpdateBundleTest : public testing::Test {
   TestBundledUpdateBackend backend_;
 };
 
+// Writes `bundle_data` through `writer` in `chunk_size` pieces, as a bundle
+// transfer handler would.
+void WriteInChunks(stream::Writer& writer,
+                   ConstByteSpan bundle_data,
+                   size_t chunk_size) {
+  while (!bundle_data.empty()) {
+    const size_t size = std::min(chunk_size, bundle_data.size());
+    ASSERT_OK(writer.Write(bundle_data.first(size)));
+    bundle_data = bundle_data.subspan(size);
+  }
+}
+
 }  // namespace
 
 TEST_F(UpdateBundleTest, GetTargetPayload) {
@@ -527,4 +551,73 @@ TEST_F(UpdateBundleTest,
   ASSERT_FAIL(update_bundle.OpenAndVerify());
 }
 
+TEST_F(UpdateBundleTest, PayloadDigestWriterMeasuresTargetPayloads) {
+  stream::MemoryWriterBuffer<sizeof(kTestDevBundle)> staged;
+  PayloadDigestWriter digests(staged);
+  WriteInChunks(digests, kTestDevBundle, 7);
+  ASSERT_EQ(staged.bytes_written(), sizeof(kTestDevBundle));
+  ASSERT_EQ(
+      std::memcmp(staged.data(), kTestDevBundle, sizeof(kTestDevBundle)), 0);
+
+  backend().SetTrustedRoot(kDevSignedRoot);
+  StageTestBundle(kTestDevBundle);
+  UpdateBundleAccessor update_bundle(blob_reader(), backend());
+  ASSERT_OK(update_bundle.OpenAndVerify());
+
+  for (std::string_view name : {"file1", "file2"}) {
+    stream::IntervalReader payload = update_bundle.GetTargetPayload(name);
+    ASSERT_OK(payload.status());
+    const PayloadDigestWriter::TargetDigest* digest = digests.FindDigest(name);
+    ASSERT_NE(digest, nullptr);
+    EXPECT_EQ(digest->length, payload.interval_size());
+
+    std::byte sha256[crypto::sha256::kDigestSizeBytes] = {};
+    ASSERT_OK(crypto::sha256::Hash(payload, sha256));
+    EXPECT_EQ(std::memcmp(digest->sha256.data(), sha256, sizeof(sha256)), 0);
+  }
+  EXPECT_EQ(digests.FindDigest("non-exist"), nullptr);
+}
+
+TEST_F(UpdateBundleTest, OpenAndVerifyUsesStreamedPayloadDigests) {
+  backend().SetTrustedRoot(kDevSignedRoot);
+  StageTestBundle(kTestDevBundle);
+
+  stream::MemoryWriterBuffer<sizeof(kTestDevBundle)> staged;
+  PayloadDigestWriter digests(staged);
+  WriteInChunks(digests, kTestDevBundle, 64);
+  backend().SetStreamedPayloadDigests(&digests);
+
+  UpdateBundleAccessor update_bundle(blob_reader(), backend());
+  ASSERT_OK(update_bundle.OpenAndVerify());
+  ASSERT_OK(update_bundle.Close());
+}
+
+TEST_F(UpdateBundleTest, OpenAndVerifyFailsOnMismatchedStreamedDigest) {
+  backend().SetTrustedRoot(kDevSignedRoot);
+  StageTestBundle(kTestDevBundle);
+
+  // Measure a copy of the bundle in which the payload of file1 differs from
+  // the staged bundle.
+  std::array<std::byte, sizeof(kTestDevBundle)> tampered;
+  std::memcpy(tampered.data(), kTestDevBundle, sizeof(kTestDevBundle));
+  constexpr std::string_view kFile1Content = "file 1 content";
+  auto content = std::search(
+      tampered.begin(),
+      tampered.end(),
+      reinterpret_cast<const std::byte*>(kFile1Content.data()),
+      reinterpret_cast<const std::byte*>(kFile1Content.data()) +
+          kFile1Content.size());
+  ASSERT_NE(content, tampered.end());
+  *content = std::byte{'F'};
+
+  stream::MemoryWriterBuffer<sizeof(kTestDevBundle)> staged;
+  PayloadDigestWriter digests(staged);
+  WriteInChunks(digests, tampered, 64);
+  ASSERT_NE(digests.FindDigest("file1"), nullptr);
+  backend().SetStreamedPayloadDigests(&digests);
+
+  UpdateBundleAccessor update_bundle(blob_reader(), backend());
+  CheckOpenAndVerifyFail(update_bundle, false);
+}
+
 }  // namespace pw::software_update
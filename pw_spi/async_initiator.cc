@@ -0,0 +1,92 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_spi/async_initiator.h"
+
+#include <mutex>
+#include <utility>
+
+#include "pw_assert/check.h"
+
+namespace pw::spi {
+
+async2::Poll<Status> AsyncInitiator::PendWriteReadBatch(async2::Context& cx,
+                                                        AsyncBatch& batch) {
+  {
+    std::lock_guard lock(lock_);
+    switch (batch.state_) {
+      case AsyncBatch::State::kComplete:
+        batch.state_ = AsyncBatch::State::kIdle;
+        return async2::Ready(Status(batch.status_));
+      case AsyncBatch::State::kQueued:
+      case AsyncBatch::State::kActive:
+        batch.waker_ = cx.GetWaker(async2::WaitReason::Unspecified());
+        return async2::Pending();
+      case AsyncBatch::State::kIdle:
+        break;
+    }
+
+    batch.waker_ = cx.GetWaker(async2::WaitReason::Unspecified());
+    if (active_ != nullptr) {
+      batch.state_ = AsyncBatch::State::kQueued;
+      queue_.push_back(batch);
+      return async2::Pending();
+    }
+    batch.state_ = AsyncBatch::State::kActive;
+    active_ = &batch;
+  }
+
+  DoStartBatch(batch);
+  return async2::Pending();
+}
+
+bool AsyncInitiator::Cancel(AsyncBatch& batch) {
+  std::lock_guard lock(lock_);
+  if (batch.state_ != AsyncBatch::State::kQueued) {
+    return false;
+  }
+  queue_.remove(batch);
+  batch.state_ = AsyncBatch::State::kIdle;
+  batch.waker_.Clear();
+  return true;
+}
+
+void AsyncInitiator::CompleteBatch(Status status) {
+  async2::Waker waker;
+  AsyncBatch* next = nullptr;
+  {
+    std::lock_guard lock(lock_);
+    PW_CHECK_NOTNULL(active_, "No SPI batch is active");
+    AsyncBatch& completed = *active_;
+    completed.status_ = status;
+    completed.state_ = AsyncBatch::State::kComplete;
+    waker = std::move(completed.waker_);
+
+    if (!queue_.empty()) {
+      next = &queue_.front();
+      queue_.pop_front();
+      next->state_ = AsyncBatch::State::kActive;
+    }
+    active_ = next;
+  }
+
+  // Start the next batch before waking the task, so the bus is idle for as
+  // little time as possible.
+  if (next != nullptr) {
+    DoStartBatch(*next);
+  }
+  std::move(waker).Wake();
+}
+
+}  // namespace pw::spi
@@ -0,0 +1,151 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_spi/async_initiator.h"
+
+#include <array>
+#include <optional>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_containers/vector.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::spi {
+namespace {
+
+using ::pw::async2::Context;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+
+// An initiator whose batches are completed by the test.
+class TestAsyncInitiator : public AsyncInitiator {
+ public:
+  const Vector<AsyncBatch*, 4>& started() const { return started_; }
+
+  void Complete(Status status) { CompleteBatch(status); }
+
+ private:
+  void DoStartBatch(AsyncBatch& batch) override {
+    started_.push_back(&batch);
+    if (batch.segments().empty()) {
+      CompleteBatch(OkStatus());
+    }
+  }
+
+  Vector<AsyncBatch*, 4> started_;
+};
+
+// A task that submits a batch and records its result.
+class BatchTask : public async2::Task {
+ public:
+  BatchTask(AsyncInitiator& initiator, AsyncBatch& batch)
+      : initiator_(initiator), batch_(batch) {}
+
+  const std::optional<Status>& result() const { return result_; }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    Poll<Status> status = initiator_.PendWriteReadBatch(cx, batch_);
+    if (status.IsPending()) {
+      return Pending();
+    }
+    result_ = *status;
+    return Ready();
+  }
+
+  AsyncInitiator& initiator_;
+  AsyncBatch& batch_;
+  std::optional<Status> result_;
+};
+
+class AsyncInitiatorTest : public ::testing::Test {
+ protected:
+  AsyncInitiatorTest()
+      : segments_{WriteReadSegment{.write_buffer = command_,
+                                   .read_buffer = {},
+                                   .deselect_after = false},
+                  WriteReadSegment{.write_buffer = {},
+                                   .read_buffer = response_,
+                                   .deselect_after = false}},
+        batch_1_(segments_),
+        batch_2_(span(segments_).first(1)),
+        task_1_(initiator_, batch_1_),
+        task_2_(initiator_, batch_2_) {}
+
+  Dispatcher dispatcher_;
+  TestAsyncInitiator initiator_;
+  std::array<std::byte, 1> command_{};
+  std::array<std::byte, 4> response_{};
+  std::array<WriteReadSegment, 2> segments_;
+  AsyncBatch batch_1_;
+  AsyncBatch batch_2_;
+  BatchTask task_1_;
+  BatchTask task_2_;
+};
+
+TEST_F(AsyncInitiatorTest, CompletesBatchOnce) {
+  dispatcher_.Post(task_1_);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  ASSERT_EQ(initiator_.started().size(), 1u);
+  EXPECT_EQ(initiator_.started()[0]->segments().size(), 2u);
+
+  initiator_.Complete(OkStatus());
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_EQ(task_1_.result(), OkStatus());
+}
+
+TEST_F(AsyncInitiatorTest, StartsQueuedBatchOnCompletion) {
+  dispatcher_.Post(task_1_);
+  dispatcher_.Post(task_2_);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  EXPECT_EQ(initiator_.started().size(), 1u);
+
+  initiator_.Complete(Status::DataLoss());
+  ASSERT_EQ(initiator_.started().size(), 2u);
+  EXPECT_EQ(initiator_.started()[1], &batch_2_);
+  initiator_.Complete(OkStatus());
+
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_EQ(task_1_.result(), Status::DataLoss());
+  EXPECT_EQ(task_2_.result(), OkStatus());
+}
+
+TEST_F(AsyncInitiatorTest, CancelRemovesQueuedBatch) {
+  dispatcher_.Post(task_1_);
+  dispatcher_.Post(task_2_);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+
+  EXPECT_FALSE(initiator_.Cancel(batch_1_));
+  EXPECT_TRUE(initiator_.Cancel(batch_2_));
+  initiator_.Complete(OkStatus());
+  EXPECT_EQ(initiator_.started().size(), 1u);
+
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Pending());
+  EXPECT_EQ(task_1_.result(), OkStatus());
+  EXPECT_FALSE(task_2_.result().has_value());
+  task_2_.Deregister();
+}
+
+TEST_F(AsyncInitiatorTest, BatchCompletedWhileStartingIsReady) {
+  AsyncBatch empty_batch({});
+  BatchTask task(initiator_, empty_batch);
+  dispatcher_.Post(task);
+  EXPECT_EQ(dispatcher_.RunUntilStalled(), Ready());
+  EXPECT_EQ(task.result(), OkStatus());
+}
+
+}  // namespace
+}  // namespace pw::spi
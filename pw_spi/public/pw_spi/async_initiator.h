@@ -0,0 +1,123 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/poll.h"
+#include "pw_containers/intrusive_list.h"
+#include "pw_span/span.h"
+#include "pw_spi/initiator.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::spi {
+
+/// A batch of SPI read/write segments that can be queued on an
+/// `AsyncInitiator`.
+///
+/// The segments are transferred back-to-back, in order, as a single transfer
+/// with a single completion.
+///
+/// The batch, its segments, and their buffers must remain valid until it
+/// completes or is cancelled. A completed batch may be submitted again.
+class AsyncBatch : public IntrusiveList<AsyncBatch>::Item {
+ public:
+  constexpr explicit AsyncBatch(span<const WriteReadSegment> segments)
+      : segments_(segments) {}
+
+  AsyncBatch(const AsyncBatch&) = delete;
+  AsyncBatch& operator=(const AsyncBatch&) = delete;
+
+  span<const WriteReadSegment> segments() const { return segments_; }
+
+ private:
+  friend class AsyncInitiator;
+
+  enum class State : uint8_t {
+    kIdle,
+    kQueued,
+    kActive,
+    kComplete,
+  };
+
+  const span<const WriteReadSegment> segments_;
+
+  // Guarded by the lock of the AsyncInitiator the batch is submitted to.
+  State state_ = State::kIdle;
+  Status status_;
+  async2::Waker waker_;
+};
+
+/// @brief The base interface for submitting batches of SPI transfers from
+/// `pw_async2` tasks.
+///
+/// Batches from any number of tasks are queued, and each one is started by the
+/// backend as soon as the previous one completes, typically from the transfer
+/// complete interrupt. The task that submitted a batch is woken once, when the
+/// whole batch has completed.
+///
+/// The bus must be configured, and the responder selected, through the
+/// backend's own API before batches are submitted.
+///
+/// Backends implement `DoStartBatch` to start a batch without blocking, and
+/// call `CompleteBatch` when it finishes.
+class AsyncInitiator {
+ public:
+  virtual ~AsyncInitiator() = default;
+
+  /// Submits `batch` to the queue if it is not already queued, and returns its
+  /// result once it has completed.
+  ///
+  /// The task is woken when the batch completes. Only one task may wait for a
+  /// given batch.
+  ///
+  /// @returns ``OK`` if every segment was transferred, or the
+  /// implementation-specific error of the first segment that failed.
+  async2::Poll<Status> PendWriteReadBatch(async2::Context& cx,
+                                          AsyncBatch& batch)
+      PW_LOCKS_EXCLUDED(lock_);
+
+  /// Removes a batch from the queue before it is started.
+  ///
+  /// Returns true if the batch was removed, in which case it will not complete
+  /// and no task will be woken for it. Returns false if the batch is not
+  /// queued, or has already been started.
+  bool Cancel(AsyncBatch& batch) PW_LOCKS_EXCLUDED(lock_);
+
+ protected:
+  /// Reports the result of the batch most recently passed to `DoStartBatch`,
+  /// starts the next queued batch, if any, and wakes the task waiting for the
+  /// completed one.
+  ///
+  /// This may be called from an interrupt, or from within `DoStartBatch`, e.g.
+  /// to fail a batch that cannot be started.
+  void CompleteBatch(Status status) PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  /// Starts the given batch. The backend must not block, and must call
+  /// `CompleteBatch` exactly once when the batch finishes.
+  ///
+  /// Only one batch is active at a time. This is called either from
+  /// `PendWriteReadBatch` when the bus is idle, or from `CompleteBatch`.
+  virtual void DoStartBatch(AsyncBatch& batch) = 0;
+
+  sync::InterruptSpinLock lock_;
+  IntrusiveList<AsyncBatch> queue_ PW_GUARDED_BY(lock_);
+  AsyncBatch* active_ PW_GUARDED_BY(lock_) = nullptr;
+};
+
+}  // namespace pw::spi
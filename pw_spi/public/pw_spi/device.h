@@ -17,6 +17,7 @@
 #include <utility>
 
 #include "pw_bytes/span.h"
+#include "pw_span/span.h"
 #include "pw_spi/chip_selector.h"
 #include "pw_spi/initiator.h"
 #include "pw_status/status.h"
@@ -81,6 +82,21 @@ class Device {
         .WriteRead(write_buffer, read_buffer);
   }
 
+  // Perform a batch of read/write transfers with the SPI responder, as a
+  // single transfer on the initiator. Chip select is activated before the
+  // first segment and deactivated after the last one.
+  // This call will configure the bus and activate/deactivate chip select
+  // for the batch
+  //
+  // Note: This call will block in the event that other clients
+  // are currently performing transactions using the same SPI Initiator.
+  // Returns OkStatus() on success, and implementation-specific values on
+  // failure.
+  Status WriteReadBatch(span<const WriteReadSegment> segments) {
+    return StartTransaction(ChipSelectBehavior::kPerWriteRead)
+        .WriteReadBatch(segments);
+  }
+
   // RAII Object providing exclusive access to the SPI device.  Enables
   // thread-safe Read()/Write()/WriteRead() operations, as well as composite
   // operations consisting of multiple, uninterrupted transfers, with
@@ -168,6 +184,32 @@ class Device {
       return status;
     }
 
+    // Perform a batch of read/write transfers on the SPI bus, as a single
+    // transfer on the initiator. Chip-select is applied around the whole batch
+    // in the same way as around a single WriteRead() call.
+    //
+    // Returns OkStatus() on success, and implementation-specific values on
+    // failure.
+    Status WriteReadBatch(span<const WriteReadSegment> segments) {
+      if (first_write_read_) {
+        PW_TRY(initiator_->Configure(config_));
+      }
+
+      if ((behavior_ == ChipSelectBehavior::kPerWriteRead) ||
+          (first_write_read_)) {
+        PW_TRY(selector_->Activate());
+        first_write_read_ = false;
+      }
+
+      auto status = initiator_->WriteReadBatch(segments);
+
+      if (behavior_ == ChipSelectBehavior::kPerWriteRead) {
+        PW_TRY(selector_->Deactivate());
+      }
+
+      return status;
+    }
+
    private:
     friend Device;
     explicit Transaction(sync::BorrowedPointer<Initiator> initiator,
@@ -19,7 +19,9 @@
 
 #include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 
 namespace pw::spi {
 
@@ -76,6 +78,19 @@ struct Config {
 static_assert(sizeof(Config) == sizeof(uint32_t),
               "Ensure that the config struct fits in 32-bits");
 
+// One read/write operation within a batch. Each segment behaves like a single
+// WriteRead() call with the same buffers.
+struct WriteReadSegment {
+  ConstByteSpan write_buffer;
+  ByteSpan read_buffer;
+
+  // Releases chip-select between this segment and the next one, for devices
+  // that expect several commands in one batch. Chip-select is always released
+  // after the last segment. Only honored by initiators that drive the
+  // chip-select signal themselves.
+  bool deselect_after = false;
+};
+
 // The Initiator class provides an abstract interface used to configure and
 // transmit data using a SPI bus.
 class Initiator {
@@ -101,6 +116,21 @@ class Initiator {
   // failure.
   virtual Status WriteRead(ConstByteSpan write_buffer,
                            ByteSpan read_buffer) = 0;
+
+  // Perform a batch of read/write operations on the SPI bus, in order, as one
+  // transfer. Initiators that can queue several operations in hardware or in
+  // the kernel override this to transfer the whole batch with a single
+  // request and completion, instead of one per segment.
+  // The default implementation calls WriteRead() for each segment, and stops
+  // at the first failure.
+  // Returns OkStatus() on success, and implementation-specific values on
+  // failure.
+  virtual Status WriteReadBatch(span<const WriteReadSegment> segments) {
+    for (const WriteReadSegment& segment : segments) {
+      PW_TRY(WriteRead(segment.write_buffer, segment.read_buffer));
+    }
+    return OkStatus();
+  }
 };
 
 }  // namespace pw::spi
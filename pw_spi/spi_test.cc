@@ -11,6 +11,8 @@
 // WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
 // License for the specific language governing permissions and limitations under
 // the License.
+#include <array>
+
 #include "pw_spi/chip_selector.h"
 #include "pw_spi/device.h"
 #include "pw_spi/initiator.h"
@@ -91,5 +93,77 @@ TEST_F(SpiTestDevice, CompilationSucceeds) {
 // Simple test ensuring the SPI Responder HAL compiles
 TEST_F(SpiResponderTestDevice, CompilationSucceeds) { EXPECT_TRUE(true); }
 
+// An initiator that counts transfers, and uses the default WriteReadBatch().
+class CountingInitiator : public Initiator {
+ public:
+  Status Configure(const Config&) override { return OkStatus(); }
+  Status WriteRead(ConstByteSpan write_buffer, ByteSpan read_buffer) override {
+    ++write_reads;
+    bytes_written += write_buffer.size();
+    bytes_read += read_buffer.size();
+    return write_reads == fail_on_write_read ? Status::Internal() : OkStatus();
+  }
+
+  int write_reads = 0;
+  int fail_on_write_read = 0;
+  size_t bytes_written = 0;
+  size_t bytes_read = 0;
+};
+
+class CountingChipSelector : public ChipSelector {
+ public:
+  Status SetActive(bool active) override {
+    (active ? activations : deactivations)++;
+    return OkStatus();
+  }
+
+  int activations = 0;
+  int deactivations = 0;
+};
+
+class SpiBatchTest : public ::testing::Test {
+ protected:
+  SpiBatchTest()
+      : borrowable_initiator_(initiator_, initiator_lock_),
+        device_(borrowable_initiator_, kConfig, chip_selector_) {}
+
+  CountingInitiator initiator_;
+  CountingChipSelector chip_selector_;
+  sync::VirtualMutex initiator_lock_;
+  sync::Borrowable<Initiator> borrowable_initiator_;
+  Device device_;
+};
+
+TEST_F(SpiBatchTest, BatchSelectsDeviceOnce) {
+  std::array<std::byte, 2> command{};
+  std::array<std::byte, 4> response{};
+  const std::array<WriteReadSegment, 3> segments = {
+      WriteReadSegment{.write_buffer = command, .read_buffer = {}},
+      WriteReadSegment{.write_buffer = {}, .read_buffer = response},
+      WriteReadSegment{.write_buffer = command, .read_buffer = response},
+  };
+
+  EXPECT_EQ(device_.WriteReadBatch(segments), OkStatus());
+  EXPECT_EQ(initiator_.write_reads, 3);
+  EXPECT_EQ(initiator_.bytes_written, 4u);
+  EXPECT_EQ(initiator_.bytes_read, 8u);
+  EXPECT_EQ(chip_selector_.activations, 1);
+  EXPECT_EQ(chip_selector_.deactivations, 1);
+}
+
+TEST_F(SpiBatchTest, BatchStopsAtFirstFailure) {
+  std::array<std::byte, 2> command{};
+  const std::array<WriteReadSegment, 3> segments = {
+      WriteReadSegment{.write_buffer = command, .read_buffer = {}},
+      WriteReadSegment{.write_buffer = command, .read_buffer = {}},
+      WriteReadSegment{.write_buffer = command, .read_buffer = {}},
+  };
+  initiator_.fail_on_write_read = 2;
+
+  EXPECT_EQ(device_.WriteReadBatch(segments), Status::Internal());
+  EXPECT_EQ(initiator_.write_reads, 2);
+  EXPECT_EQ(chip_selector_.deactivations, 1);
+}
+
 }  // namespace
 }  // namespace pw::spi
@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include "pw_bytes/span.h"
@@ -26,6 +27,9 @@ namespace pw::spi {
 // Linux userspace implementation of the SPI Initiator
 class LinuxInitiator : public Initiator {
  public:
+  // Maximum number of segments in a WriteReadBatch() call.
+  static constexpr size_t kMaxBatchSegments = 16;
+
   // Configure the Linux Initiator object for use with a bus file descriptor,
   // and maximum bus-speed (in hz).
   constexpr LinuxInitiator(int fd, uint32_t max_speed_hz)
@@ -36,6 +40,11 @@ class LinuxInitiator : public Initiator {
   Status Configure(const Config& config) override;
   Status WriteRead(ConstByteSpan write_buffer, ByteSpan read_buffer) override;
 
+  // Transfers the whole batch with one SPI_IOC_MESSAGE ioctl(), so the kernel
+  // runs it as a single message without returning to userspace between
+  // segments. Honors `WriteReadSegment::deselect_after`.
+  Status WriteReadBatch(span<const WriteReadSegment> segments) override;
+
  private:
   uint32_t max_speed_hz_;
   int fd_;
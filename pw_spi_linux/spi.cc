@@ -20,6 +20,7 @@
 #include <sys/ioctl.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstring>
 
 #include "pw_log/log.h"
@@ -73,32 +74,49 @@ Status LinuxInitiator::Configure(const Config& config) {
   return OkStatus();
 }
 
-Status LinuxInitiator::WriteRead(ConstByteSpan write_buffer,
-                                 ByteSpan read_buffer) {
-  // Configure a full-duplex transfer using ioctl()
+namespace {
 
-  struct spi_ioc_transfer transaction[2] = {};
-  unsigned long request = SPI_IOC_MESSAGE(1);  // macro arg must be constant
+// Fills in the transfers for one read/write operation, and returns how many
+// were used (1 or 2). `transfers` must be zero-initialized.
+size_t FillTransfers(ConstByteSpan write_buffer,
+                     ByteSpan read_buffer,
+                     struct spi_ioc_transfer* transfers) {
   const size_t common_len = std::min(write_buffer.size(), read_buffer.size());
 
-  transaction[0].tx_buf = reinterpret_cast<uintptr_t>(write_buffer.data());
-  transaction[0].rx_buf = reinterpret_cast<uintptr_t>(read_buffer.data());
-  transaction[0].len = common_len;
+  transfers[0].tx_buf = reinterpret_cast<uintptr_t>(write_buffer.data());
+  transfers[0].rx_buf = reinterpret_cast<uintptr_t>(read_buffer.data());
+  transfers[0].len = common_len;
 
   // Handle different-sized buffers with a compound transaction
   if (write_buffer.size() > common_len) {
     auto write_remainder = write_buffer.subspan(common_len);
-    transaction[1].tx_buf = reinterpret_cast<uintptr_t>(write_remainder.data());
-    transaction[1].len = write_remainder.size();
-    request = SPI_IOC_MESSAGE(2);
-  } else if (read_buffer.size() > common_len) {
+    transfers[1].tx_buf = reinterpret_cast<uintptr_t>(write_remainder.data());
+    transfers[1].len = write_remainder.size();
+    return 2;
+  }
+  if (read_buffer.size() > common_len) {
     auto read_remainder = read_buffer.subspan(common_len);
-    transaction[1].rx_buf = reinterpret_cast<uintptr_t>(read_remainder.data());
-    transaction[1].len = read_remainder.size();
-    request = SPI_IOC_MESSAGE(2);
+    transfers[1].rx_buf = reinterpret_cast<uintptr_t>(read_remainder.data());
+    transfers[1].len = read_remainder.size();
+    return 2;
   }
+  return 1;
+}
+
+// Equivalent to SPI_IOC_MESSAGE(count), which requires a constant argument.
+unsigned long SpiMessageRequest(size_t count) {
+  return _IOC(_IOC_WRITE, SPI_IOC_MAGIC, 0, SPI_MSGSIZE(count));
+}
+
+}  // namespace
+
+Status LinuxInitiator::WriteRead(ConstByteSpan write_buffer,
+                                 ByteSpan read_buffer) {
+  // Configure a full-duplex transfer using ioctl()
+  struct spi_ioc_transfer transaction[2] = {};
+  const size_t count = FillTransfers(write_buffer, read_buffer, transaction);
 
-  if (ioctl(fd_, request, transaction) < 0) {
+  if (ioctl(fd_, SpiMessageRequest(count), transaction) < 0) {
     PW_LOG_ERROR("Unable to perform SPI transfer");
     return Status::Unknown();
   }
@@ -106,6 +124,40 @@ Status LinuxInitiator::WriteRead(ConstByteSpan write_buffer,
   return OkStatus();
 }
 
+Status LinuxInitiator::WriteReadBatch(span<const WriteReadSegment> segments) {
+  if (segments.size() > kMaxBatchSegments) {
+    PW_LOG_ERROR("SPI batch of %u segments exceeds the maximum of %u",
+                 static_cast<unsigned>(segments.size()),
+                 static_cast<unsigned>(kMaxBatchSegments));
+    return Status::InvalidArgument();
+  }
+  if (segments.empty()) {
+    return OkStatus();
+  }
+
+  // Each segment needs up to two transfers for different-sized buffers.
+  struct spi_ioc_transfer transfers[2 * kMaxBatchSegments] = {};
+  size_t count = 0;
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const WriteReadSegment& segment = segments[i];
+    count += FillTransfers(
+        segment.write_buffer, segment.read_buffer, &transfers[count]);
+
+    // cs_change on the last transfer of a message keeps the device selected
+    // instead, so only set it between segments.
+    if (segment.deselect_after && i + 1 < segments.size()) {
+      transfers[count - 1].cs_change = 1;
+    }
+  }
+
+  if (ioctl(fd_, SpiMessageRequest(count), transfers) < 0) {
+    PW_LOG_ERROR("Unable to perform SPI batch transfer");
+    return Status::Unknown();
+  }
+
+  return OkStatus();
+}
+
 Status LinuxChipSelector::SetActive(bool /*active*/) {
   // Note: For Linux' SPI userspace support, chip-select control is not exposed
   // directly to the user.  This limits our ability to use the SPI HAL to do
@@ -216,5 +216,56 @@ TEST(LinuxSpiTest, ReadLargerThanWriteSize) {
   EXPECT_NE(xfer1.rx_buf, 0u);
 }
 
+TEST(LinuxSpiTest, WriteReadBatchIsOneMessage) {
+  ioctl_requests.clear();
+  ioctl_transfers.clear();
+
+  LinuxInitiator initiator(kFakeFd, kMaxSpeed);
+
+  std::array<std::byte, 2> command = {1_b, 2_b};
+  std::array<std::byte, 2> read_buf;
+  std::array<std::byte, 3> long_read_buf;
+  const std::array<WriteReadSegment, 3> segments = {
+      WriteReadSegment{.write_buffer = command,
+                       .read_buffer = read_buf,
+                       .deselect_after = true},
+      WriteReadSegment{.write_buffer = command,
+                       .read_buffer = long_read_buf,
+                       .deselect_after = false},
+      WriteReadSegment{.write_buffer = command,
+                       .read_buffer = read_buf,
+                       .deselect_after = true},
+  };
+
+  EXPECT_EQ(initiator.WriteReadBatch(segments), OkStatus());
+
+  ASSERT_EQ(ioctl_requests.size(), 1u);
+  EXPECT_EQ(ioctl_requests[0], SPI_IOC_MESSAGE(4));
+  ASSERT_EQ(ioctl_transfers.size(), 4u);
+
+  EXPECT_EQ(ioctl_transfers[0].len, 2u);
+  EXPECT_EQ(ioctl_transfers[0].cs_change, 1u);
+  EXPECT_EQ(ioctl_transfers[1].len, 2u);
+  EXPECT_EQ(ioctl_transfers[1].cs_change, 0u);
+  EXPECT_EQ(ioctl_transfers[2].len, 1u);  // Read remainder.
+  EXPECT_EQ(ioctl_transfers[2].tx_buf, 0u);
+  EXPECT_EQ(ioctl_transfers[2].cs_change, 0u);
+  // The last segment never sets cs_change, which would keep the device
+  // selected after the message.
+  EXPECT_EQ(ioctl_transfers[3].len, 2u);
+  EXPECT_EQ(ioctl_transfers[3].cs_change, 0u);
+}
+
+TEST(LinuxSpiTest, WriteReadBatchTooLarge) {
+  ioctl_requests.clear();
+
+  LinuxInitiator initiator(kFakeFd, kMaxSpeed);
+  std::array<WriteReadSegment, LinuxInitiator::kMaxBatchSegments + 1>
+      segments{};
+
+  EXPECT_EQ(initiator.WriteReadBatch(segments), Status::InvalidArgument());
+  EXPECT_TRUE(ioctl_requests.empty());
+}
+
 }  // namespace
 }  // namespace pw::spi
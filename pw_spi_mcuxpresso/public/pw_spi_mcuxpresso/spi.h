@@ -19,6 +19,7 @@
 #include <optional>
 
 #include "fsl_spi.h"
+#include "pw_spi/async_initiator.h"
 #include "pw_spi/chip_selector.h"
 #include "pw_spi/initiator.h"
 #include "pw_status/status.h"
@@ -28,8 +29,15 @@
 
 namespace pw::spi {
 
-// Mcuxpresso SDK implementation of the SPI Initiator
-class McuxpressoInitiator : public Initiator {
+// Mcuxpresso SDK implementation of the SPI Initiator.
+//
+// A non-blocking initiator also implements AsyncInitiator: each batch runs
+// from the transfer complete interrupt, starting the next segment as soon as
+// the previous one finishes, and the task that submitted it is woken once at
+// the end. Configure() and SetChipSelect() must be called before batches are
+// submitted, and synchronous transfers must not be started while a batch is in
+// progress.
+class McuxpressoInitiator : public Initiator, public AsyncInitiator {
  public:
   McuxpressoInitiator(SPI_Type* register_map,
                       uint32_t max_speed_hz,
@@ -45,6 +53,8 @@ class McuxpressoInitiator : public Initiator {
   Status Configure(const Config& config) PW_LOCKS_EXCLUDED(mutex_) override;
   Status WriteRead(ConstByteSpan write_buffer, ByteSpan read_buffer)
       PW_LOCKS_EXCLUDED(mutex_) override;
+  Status WriteReadBatch(span<const WriteReadSegment> segments)
+      PW_LOCKS_EXCLUDED(mutex_) override;
 
   Status SetChipSelect(uint32_t pin) PW_LOCKS_EXCLUDED(mutex_);
 
@@ -58,6 +68,17 @@ class McuxpressoInitiator : public Initiator {
   Status DoConfigure(const Config& config,
                      const std::lock_guard<sync::Mutex>& lock);
 
+  Status DoTransfer(spi_transfer_t& transfer,
+                    const std::lock_guard<sync::Mutex>& lock);
+
+  // Implements pw::spi::AsyncInitiator
+  void DoStartBatch(AsyncBatch& batch) override;
+
+  // Starts the current segment of the active batch, or completes the batch if
+  // it cannot be started.
+  void StartBatchSegment();
+  void FinishBatch(Status status);
+
   bool is_initialized() { return !!current_config_; }
 
   SPI_Type* register_map_;
@@ -71,6 +92,12 @@ class McuxpressoInitiator : public Initiator {
   bool blocking_;
   std::optional<const Config> current_config_;
   uint32_t pin_ = 0;
+
+  // The segments of the active batch. Only accessed while a batch is active,
+  // which serializes access between the starting thread and the interrupt.
+  span<const WriteReadSegment> batch_segments_;
+  size_t batch_index_ = 0;
+  bool batch_active_ = false;
 };
 
 // Mcuxpresso userspace implementation of SPI ChipSelector
@@ -54,6 +54,34 @@ pw::Status ToPwStatus(int32_t status) {
   }
 }
 
+// inclusive-language: disable
+spi_transfer_t MakeTransfer(ConstByteSpan write_buffer,
+                            ByteSpan read_buffer,
+                            bool deselect_after) {
+  spi_transfer_t transfer = {};
+
+  transfer.txData =
+      reinterpret_cast<uint8_t*>(const_cast<std::byte*>(write_buffer.data()));
+  transfer.rxData = reinterpret_cast<uint8_t*>(read_buffer.data());
+  if (write_buffer.data() == nullptr && read_buffer.data() != nullptr) {
+    // Read only transaction
+    transfer.dataSize = read_buffer.size();
+  } else if (read_buffer.data() == nullptr && write_buffer.data() != nullptr) {
+    // Write only transaction
+    transfer.dataSize = write_buffer.size();
+  } else {
+    // Take the smallest as the size of transaction
+    transfer.dataSize = write_buffer.size() < read_buffer.size()
+                            ? write_buffer.size()
+                            : read_buffer.size();
+  }
+  // Without kSPI_FrameAssert, chip select stays asserted into the next
+  // transfer.
+  transfer.configFlags = deselect_after ? kSPI_FrameAssert : 0;
+  return transfer;
+}
+// inclusive-language: enable
+
 }  // namespace
 
 McuxpressoInitiator::~McuxpressoInitiator() {
@@ -68,6 +96,16 @@ void McuxpressoInitiator::SpiCallback(SPI_Type*,
                                       status_t status,
                                       void* context) {
   auto* driver = static_cast<McuxpressoInitiator*>(context);
+  if (driver->batch_active_) {
+    const Status segment_status = ToPwStatus(status);
+    if (!segment_status.ok() ||
+        ++driver->batch_index_ == driver->batch_segments_.size()) {
+      driver->FinishBatch(segment_status);
+      return;
+    }
+    driver->StartBatchSegment();
+    return;
+  }
   driver->last_transfer_status_ = ToPwStatus(status);
   driver->transfer_semaphore_.release();
 }
@@ -128,30 +166,36 @@ Status McuxpressoInitiator::DoConfigure(const Config& config,
 
 Status McuxpressoInitiator::WriteRead(ConstByteSpan write_buffer,
                                       ByteSpan read_buffer) {
-  spi_transfer_t transfer = {};
+  spi_transfer_t transfer =
+      MakeTransfer(write_buffer, read_buffer, /*deselect_after=*/true);
 
-  transfer.txData =
-      reinterpret_cast<uint8_t*>(const_cast<std::byte*>(write_buffer.data()));
-  transfer.rxData = reinterpret_cast<uint8_t*>(read_buffer.data());
-  if (write_buffer.data() == nullptr && read_buffer.data() != nullptr) {
-    // Read only transaction
-    transfer.dataSize = read_buffer.size();
-  } else if (read_buffer.data() == nullptr && write_buffer.data() != nullptr) {
-    // Write only transaction
-    transfer.dataSize = write_buffer.size();
-  } else {
-    // Take the smallest as the size of transaction
-    transfer.dataSize = write_buffer.size() < read_buffer.size()
-                            ? write_buffer.size()
-                            : read_buffer.size();
+  std::lock_guard lock(mutex_);
+  if (!current_config_) {
+    PW_LOG_ERROR("Mcuxpresso SPI must be configured before use.");
+    return Status::FailedPrecondition();
   }
-  transfer.configFlags = kSPI_FrameAssert;
+  return DoTransfer(transfer, lock);
+}
 
+Status McuxpressoInitiator::WriteReadBatch(
+    span<const WriteReadSegment> segments) {
   std::lock_guard lock(mutex_);
   if (!current_config_) {
     PW_LOG_ERROR("Mcuxpresso SPI must be configured before use.");
     return Status::FailedPrecondition();
   }
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const bool last = i + 1 == segments.size();
+    spi_transfer_t transfer = MakeTransfer(segments[i].write_buffer,
+                                           segments[i].read_buffer,
+                                           last || segments[i].deselect_after);
+    PW_TRY(DoTransfer(transfer, lock));
+  }
+  return OkStatus();
+}
+
+Status McuxpressoInitiator::DoTransfer(spi_transfer_t& transfer,
+                                       const std::lock_guard<sync::Mutex>&) {
   if (blocking_) {
     return ToPwStatus(SPI_MasterTransferBlocking(register_map_, &transfer));
   }
@@ -164,6 +208,42 @@ Status McuxpressoInitiator::WriteRead(ConstByteSpan write_buffer,
   }
   return last_transfer_status_;
 }
+
+void McuxpressoInitiator::DoStartBatch(AsyncBatch& batch) {
+  // Batches complete from the transfer interrupt, which a blocking initiator
+  // does not use.
+  if (blocking_ || !current_config_) {
+    CompleteBatch(Status::FailedPrecondition());
+    return;
+  }
+  if (batch.segments().empty()) {
+    CompleteBatch(OkStatus());
+    return;
+  }
+  batch_segments_ = batch.segments();
+  batch_index_ = 0;
+  batch_active_ = true;
+  StartBatchSegment();
+}
+
+void McuxpressoInitiator::StartBatchSegment() {
+  const WriteReadSegment& segment = batch_segments_[batch_index_];
+  const bool last = batch_index_ + 1 == batch_segments_.size();
+  spi_transfer_t transfer = MakeTransfer(segment.write_buffer,
+                                         segment.read_buffer,
+                                         last || segment.deselect_after);
+  const Status status = ToPwStatus(
+      SPI_MasterTransferNonBlocking(register_map_, &driver_handle_, &transfer));
+  if (!status.ok()) {
+    FinishBatch(status);
+  }
+}
+
+void McuxpressoInitiator::FinishBatch(Status status) {
+  batch_active_ = false;
+  batch_segments_ = {};
+  CompleteBatch(status);
+}
 // inclusive-language: enable
 
 Status McuxpressoInitiator::SetChipSelect(uint32_t pin) {
@@ -0,0 +1,172 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/buffered_stream.h"
+
+#include <algorithm>
+
+#include "pw_assert/assert.h"
+#include "pw_status/try.h"
+
+namespace pw::stream {
+
+BufferedReader::BufferedReader(Reader& source, ByteSpan buffer)
+    : source_(source), buffer_(buffer) {
+  PW_ASSERT(!buffer_.empty());
+}
+
+StatusWithSize BufferedReader::DoRead(ByteSpan destination) {
+  if (begin_ == end_) {
+    // Large reads go straight to the destination rather than through the
+    // buffer.
+    if (destination.empty() || destination.size() >= buffer_.size()) {
+      Result<ByteSpan> result = source_.Read(destination);
+      if (!result.ok()) {
+        return StatusWithSize(result.status(), 0);
+      }
+      return StatusWithSize(result->size());
+    }
+
+    Result<ByteSpan> result = source_.Read(buffer_);
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), 0);
+    }
+    begin_ = 0;
+    end_ = result->size();
+  }
+
+  const size_t size = std::min(destination.size(), end_ - begin_);
+  std::copy_n(buffer_.data() + begin_, size, destination.data());
+  begin_ += size;
+  return StatusWithSize(size);
+}
+
+Status BufferedReader::DoSeek(ptrdiff_t offset, Whence origin) {
+  const size_t buffered = end_ - begin_;
+  Status status;
+
+  switch (origin) {
+    case Whence::kCurrent:
+      if (offset >= -static_cast<ptrdiff_t>(begin_) &&
+          offset <= static_cast<ptrdiff_t>(buffered)) {
+        begin_ = static_cast<size_t>(static_cast<ptrdiff_t>(begin_) + offset);
+        return OkStatus();
+      }
+      // The source is ahead of this reader by the buffered data.
+      status = source_.Seek(offset - static_cast<ptrdiff_t>(buffered),
+                            Whence::kCurrent);
+      break;
+
+    case Whence::kBeginning: {
+      // If the source knows its position, the target may be in the buffer.
+      const size_t source_position = source_.Tell();
+      if (offset >= 0 && source_position != kUnknownPosition &&
+          source_position >= end_) {
+        const size_t buffer_start = source_position - end_;
+        const size_t target = static_cast<size_t>(offset);
+        if (target >= buffer_start && target <= source_position) {
+          begin_ = target - buffer_start;
+          return OkStatus();
+        }
+      }
+      status = source_.Seek(offset, Whence::kBeginning);
+      break;
+    }
+
+    case Whence::kEnd:
+      status = source_.Seek(offset, Whence::kEnd);
+      break;
+  }
+
+  if (status.ok()) {
+    DiscardBuffer();
+  }
+  return status;
+}
+
+size_t BufferedReader::DoTell() {
+  const size_t source_position = source_.Tell();
+  if (source_position == kUnknownPosition ||
+      source_position < buffered_bytes()) {
+    return kUnknownPosition;
+  }
+  return source_position - buffered_bytes();
+}
+
+size_t BufferedReader::ConservativeLimit(LimitType limit) const {
+  if (limit != LimitType::kRead) {
+    return 0;
+  }
+  const size_t source_limit = source_.ConservativeReadLimit();
+  if (source_limit > kUnlimited - buffered_bytes()) {
+    return kUnlimited;
+  }
+  return source_limit + buffered_bytes();
+}
+
+BufferedWriter::BufferedWriter(Writer& sink, ByteSpan buffer)
+    : sink_(sink), buffer_(buffer) {
+  PW_ASSERT(!buffer_.empty());
+}
+
+BufferedWriter::~BufferedWriter() { Flush().IgnoreError(); }
+
+Status BufferedWriter::Flush() {
+  if (size_ == 0) {
+    return OkStatus();
+  }
+  PW_TRY(sink_.Write(buffer_.first(size_)));
+  size_ = 0;
+  return OkStatus();
+}
+
+Status BufferedWriter::DoWrite(ConstByteSpan data) {
+  if (data.size() > buffer_.size() - size_) {
+    PW_TRY(Flush());
+  }
+  // Large writes go straight to the sink rather than through the buffer.
+  if (data.size() >= buffer_.size()) {
+    return sink_.Write(data);
+  }
+  std::copy_n(data.data(), data.size(), buffer_.data() + size_);
+  size_ += data.size();
+  return OkStatus();
+}
+
+Status BufferedWriter::DoSeek(ptrdiff_t offset, Whence origin) {
+  PW_TRY(Flush());
+  return sink_.Seek(offset, origin);
+}
+
+size_t BufferedWriter::DoTell() {
+  const size_t sink_position = sink_.Tell();
+  if (sink_position == kUnknownPosition) {
+    return kUnknownPosition;
+  }
+  return sink_position + size_;
+}
+
+size_t BufferedWriter::ConservativeLimit(LimitType limit) const {
+  if (limit != LimitType::kWrite) {
+    return 0;
+  }
+  // Buffered data counts against the sink's limit once it is flushed.
+  const size_t sink_limit = sink_.ConservativeWriteLimit();
+  if (sink_limit == kUnlimited) {
+    return kUnlimited;
+  }
+  return sink_limit > size_ ? sink_limit - size_ : 0;
+}
+
+}  // namespace pw::stream
@@ -0,0 +1,319 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/buffered_stream.h"
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/array.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::stream {
+namespace {
+
+constexpr auto kData = bytes::Initialized<32>([](size_t i) { return i; });
+
+// Seekable reader that counts the reads of its data.
+class CountingReader : public SeekableReader {
+ public:
+  CountingReader() : reader_(kData) {}
+
+  int reads() const { return reads_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    reads_ += 1;
+    Result<ByteSpan> result = reader_.Read(destination);
+    return result.ok() ? StatusWithSize(result->size())
+                       : StatusWithSize(result.status(), 0);
+  }
+  Status DoSeek(ptrdiff_t offset, Whence origin) override {
+    return reader_.Seek(offset, origin);
+  }
+  size_t DoTell() override { return reader_.Tell(); }
+  size_t ConservativeLimit(LimitType limit) const override {
+    return limit == LimitType::kRead ? reader_.ConservativeReadLimit() : 0;
+  }
+
+  MemoryReader reader_;
+  int reads_ = 0;
+};
+
+// Reader that does not support seeking, such as a socket.
+class NonSeekableCountingReader : public NonSeekableReader {
+ public:
+  NonSeekableCountingReader() : reader_(kData) {}
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    Result<ByteSpan> result = reader_.Read(destination);
+    return result.ok() ? StatusWithSize(result->size())
+                       : StatusWithSize(result.status(), 0);
+  }
+
+  MemoryReader reader_;
+};
+
+// Seekable writer that counts the writes to its buffer.
+class CountingWriter : public SeekableWriter {
+ public:
+  CountingWriter() : writer_(data_) {}
+
+  int writes() const { return writes_; }
+  ConstByteSpan written() const { return writer_.WrittenData(); }
+  ConstByteSpan data() const { return data_; }
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    writes_ += 1;
+    return writer_.Write(data);
+  }
+  Status DoSeek(ptrdiff_t offset, Whence origin) override {
+    return writer_.Seek(offset, origin);
+  }
+  size_t DoTell() override { return writer_.Tell(); }
+  size_t ConservativeLimit(LimitType limit) const override {
+    return limit == LimitType::kWrite ? writer_.ConservativeWriteLimit() : 0;
+  }
+
+  std::array<std::byte, 32> data_{};
+  MemoryWriter writer_;
+  int writes_ = 0;
+};
+
+TEST(BufferedReader, SmallReads_ReadSourceOncePerBuffer) {
+  CountingReader source;
+  std::array<std::byte, 8> buffer;
+  BufferedReader reader(source, buffer);
+
+  for (size_t i = 0; i < 16; ++i) {
+    std::byte b;
+    ASSERT_EQ(reader.Read(&b, 1).status(), OkStatus());
+    EXPECT_EQ(b, kData[i]);
+  }
+  EXPECT_EQ(source.reads(), 2);
+  EXPECT_EQ(reader.Tell(), 16u);
+}
+
+TEST(BufferedReader, ReadSpanningBuffer_ReturnsBufferedBytes) {
+  CountingReader source;
+  std::array<std::byte, 8> buffer;
+  BufferedReader reader(source, buffer);
+
+  std::array<std::byte, 6> dest;
+  ASSERT_EQ(reader.Read(dest).status(), OkStatus());
+
+  Result<ByteSpan> result = reader.Read(dest);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result->size(), 2u);
+  EXPECT_EQ((*result)[0], kData[6]);
+  EXPECT_EQ(reader.buffered_bytes(), 0u);
+}
+
+TEST(BufferedReader, LargeRead_BypassesBuffer) {
+  CountingReader source;
+  std::array<std::byte, 8> buffer;
+  BufferedReader reader(source, buffer);
+
+  std::array<std::byte, 20> dest;
+  Result<ByteSpan> result = reader.Read(dest);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result->size(), 20u);
+  EXPECT_EQ(reader.buffered_bytes(), 0u);
+  EXPECT_EQ(dest[19], kData[19]);
+  EXPECT_EQ(source.reads(), 1);
+}
+
+TEST(BufferedReader, Exhausted_ReturnsOutOfRange) {
+  CountingReader source;
+  std::array<std::byte, 12> buffer;
+  BufferedReader reader(source, buffer);
+
+  std::array<std::byte, 5> dest;
+  for (size_t read = 0; read < kData.size();) {
+    Result<ByteSpan> result = reader.Read(dest);
+    ASSERT_EQ(result.status(), OkStatus());
+    read += result->size();
+  }
+  EXPECT_EQ(reader.Read(dest).status(), Status::OutOfRange());
+  EXPECT_EQ(reader.ConservativeReadLimit(), 0u);
+}
+
+TEST(BufferedReader, SeekWithinBuffer_DoesNotReadSource) {
+  CountingReader source;
+  std::array<std::byte, 8> buffer;
+  BufferedReader reader(source, buffer);
+
+  std::array<std::byte, 4> dest;
+  ASSERT_EQ(reader.Read(dest).status(), OkStatus());
+  EXPECT_EQ(reader.ConservativeReadLimit(), kData.size() - 4);
+
+  ASSERT_EQ(reader.Seek(-3, Stream::kCurrent), OkStatus());
+  EXPECT_EQ(reader.Tell(), 1u);
+  ASSERT_EQ(reader.Seek(6, Stream::kBeginning), OkStatus());
+  EXPECT_EQ(reader.Tell(), 6u);
+
+  std::byte b;
+  ASSERT_EQ(reader.Read(&b, 1).status(), OkStatus());
+  EXPECT_EQ(b, kData[6]);
+  EXPECT_EQ(source.reads(), 1);
+}
+
+TEST(BufferedReader, SeekOutsideBuffer_SeeksSource) {
+  CountingReader source;
+  std::array<std::byte, 8> buffer;
+  BufferedReader reader(source, buffer);
+
+  std::byte b;
+  ASSERT_EQ(reader.Read(&b, 1).status(), OkStatus());
+
+  ASSERT_EQ(reader.Seek(10, Stream::kCurrent), OkStatus());
+  EXPECT_EQ(reader.Tell(), 11u);
+  ASSERT_EQ(reader.Read(&b, 1).status(), OkStatus());
+  EXPECT_EQ(b, kData[11]);
+
+  ASSERT_EQ(reader.Seek(-1, Stream::kEnd), OkStatus());
+  ASSERT_EQ(reader.Read(&b, 1).status(), OkStatus());
+  EXPECT_EQ(b, kData[31]);
+
+  ASSERT_EQ(reader.Seek(0, Stream::kBeginning), OkStatus());
+  ASSERT_EQ(reader.Read(&b, 1).status(), OkStatus());
+  EXPECT_EQ(b, kData[0]);
+  EXPECT_EQ(source.reads(), 4);
+}
+
+TEST(BufferedReader, FailedSeek_KeepsBufferedData) {
+  CountingReader source;
+  std::array<std::byte, 8> buffer;
+  BufferedReader reader(source, buffer);
+
+  std::byte b;
+  ASSERT_EQ(reader.Read(&b, 1).status(), OkStatus());
+  EXPECT_NE(reader.Seek(100, Stream::kCurrent), OkStatus());
+  EXPECT_EQ(reader.buffered_bytes(), 7u);
+  EXPECT_EQ(reader.Tell(), 1u);
+}
+
+TEST(BufferedReader, NonSeekableSource_SeeksWithinBuffer) {
+  NonSeekableCountingReader source;
+  std::array<std::byte, 8> buffer;
+  BufferedReader reader(source, buffer);
+
+  std::array<std::byte, 4> dest;
+  ASSERT_EQ(reader.Read(dest).status(), OkStatus());
+  EXPECT_EQ(reader.Seek(-4, Stream::kCurrent), OkStatus());
+  EXPECT_EQ(reader.Seek(-1, Stream::kCurrent), Status::Unimplemented());
+  EXPECT_EQ(reader.Tell(), Stream::kUnknownPosition);
+
+  ASSERT_EQ(reader.Read(dest).status(), OkStatus());
+  EXPECT_EQ(dest[0], kData[0]);
+}
+
+TEST(BufferedWriter, SmallWrites_WriteSinkOncePerBuffer) {
+  CountingWriter sink;
+  std::array<std::byte, 8> buffer;
+  BufferedWriter writer(sink, buffer);
+
+  for (size_t i = 0; i < 12; ++i) {
+    ASSERT_EQ(writer.Write(kData[i]), OkStatus());
+  }
+  EXPECT_EQ(sink.writes(), 1);
+  EXPECT_EQ(sink.written().size(), 8u);
+  EXPECT_EQ(writer.buffered_bytes(), 4u);
+  EXPECT_EQ(writer.Tell(), 12u);
+
+  ASSERT_EQ(writer.Flush(), OkStatus());
+  EXPECT_EQ(sink.writes(), 2);
+  ASSERT_EQ(sink.written().size(), 12u);
+  EXPECT_EQ(sink.written()[11], kData[11]);
+}
+
+TEST(BufferedWriter, LargeWrite_BypassesBuffer) {
+  CountingWriter sink;
+  std::array<std::byte, 8> buffer;
+  BufferedWriter writer(sink, buffer);
+
+  ASSERT_EQ(writer.Write(span(kData).first(2)), OkStatus());
+  ASSERT_EQ(writer.Write(span(kData).subspan(2, 10)), OkStatus());
+  EXPECT_EQ(writer.buffered_bytes(), 0u);
+  EXPECT_EQ(sink.writes(), 2);
+  ASSERT_EQ(sink.written().size(), 12u);
+  EXPECT_EQ(sink.written()[2], kData[2]);
+}
+
+TEST(BufferedWriter, VectoredWrite_IsBuffered) {
+  CountingWriter sink;
+  std::array<std::byte, 8> buffer;
+  BufferedWriter writer(sink, buffer);
+
+  ConstByteSpan data(kData);
+  std::array<ConstByteSpan, 2> buffers = {data.first(2), data.subspan(2, 3)};
+  ASSERT_EQ(writer.Write(buffers), OkStatus());
+  EXPECT_EQ(sink.writes(), 0);
+  EXPECT_EQ(writer.buffered_bytes(), 5u);
+}
+
+TEST(BufferedWriter, Destructor_Flushes) {
+  CountingWriter sink;
+  {
+    std::array<std::byte, 8> buffer;
+    BufferedWriter writer(sink, buffer);
+    ASSERT_EQ(writer.Write(kData[0]), OkStatus());
+    EXPECT_EQ(sink.writes(), 0);
+  }
+  EXPECT_EQ(sink.writes(), 1);
+  EXPECT_EQ(sink.written().size(), 1u);
+}
+
+TEST(BufferedWriter, Seek_FlushesFirst) {
+  CountingWriter sink;
+  std::array<std::byte, 8> buffer;
+  BufferedWriter writer(sink, buffer);
+
+  ASSERT_EQ(writer.Write(span(kData).first(4)), OkStatus());
+  ASSERT_EQ(writer.Seek(1), OkStatus());
+  EXPECT_EQ(writer.buffered_bytes(), 0u);
+  EXPECT_EQ(writer.Tell(), 1u);
+
+  ASSERT_EQ(writer.Write(std::byte{0xff}), OkStatus());
+  ASSERT_EQ(writer.Flush(), OkStatus());
+  EXPECT_EQ(sink.data()[0], kData[0]);
+  EXPECT_EQ(sink.data()[1], std::byte{0xff});
+  EXPECT_EQ(sink.data()[2], kData[2]);
+}
+
+TEST(BufferedWriter, ConservativeWriteLimit_IncludesBufferedData) {
+  CountingWriter sink;
+  std::array<std::byte, 8> buffer;
+  BufferedWriter writer(sink, buffer);
+
+  ASSERT_EQ(writer.Write(span(kData).first(4)), OkStatus());
+  EXPECT_EQ(writer.ConservativeWriteLimit(), 28u);
+}
+
+TEST(BufferedWriter, FailedFlush_KeepsBufferedData) {
+  CountingWriter sink;
+  std::array<std::byte, 8> buffer;
+  BufferedWriter writer(sink, buffer);
+
+  ASSERT_EQ(writer.Write(span(kData).first(30)), OkStatus());
+  ASSERT_EQ(writer.Write(span(kData).first(4)), OkStatus());
+  EXPECT_EQ(writer.Flush(), Status::ResourceExhausted());
+  EXPECT_EQ(writer.buffered_bytes(), 4u);
+}
+
+}  // namespace
+}  // namespace pw::stream
@@ -0,0 +1,199 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/lock_free_mpsc_stream.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::stream {
+namespace {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+constexpr size_t RoundUpToHeader(size_t size) {
+  return (size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+}
+
+}  // namespace
+
+LockFreeMpscReader::LockFreeMpscReader(ByteSpan buffer)
+    : buffer_(buffer), mask_(buffer.size() - 1) {
+  PW_CHECK_UINT_GE(buffer_.size(), 2 * kHeaderSize);
+  PW_CHECK_UINT_EQ(buffer_.size() & mask_, 0, "Size must be a power of two");
+  const auto address = reinterpret_cast<uintptr_t>(buffer_.data());
+  PW_CHECK_UINT_EQ(address & (alignof(std::atomic<uint32_t>) - 1),
+                   0,
+                   "Buffer must be 4-byte aligned");
+  std::memset(buffer_.data(), 0, buffer_.size());
+}
+
+async2::Poll<> LockFreeMpscReader::PendReadable(async2::Context& cx) {
+  if (HasData() || closed()) {
+    return async2::Ready();
+  }
+  {
+    std::lock_guard lock(lock_);
+    waker_ = cx.GetWaker(async2::WaitReason::Unspecified());
+    waiting_.store(true, std::memory_order_relaxed);
+  }
+  // Check again, in case data was committed before the waker was stored.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (HasData() || closed()) {
+    return async2::Ready();
+  }
+  return async2::Pending();
+}
+
+void LockFreeMpscReader::Close() {
+  closed_.store(true, std::memory_order_release);
+  WakeReader();
+}
+
+Status LockFreeMpscReader::Commit(span<const ConstByteSpan> data) {
+  if (closed()) {
+    return Status::OutOfRange();
+  }
+  size_t size = 0;
+  for (ConstByteSpan bytes : data) {
+    size += bytes.size();
+  }
+  if (size == 0) {
+    return OkStatus();
+  }
+  if (size > max_write_size() || size > std::numeric_limits<uint32_t>::max()) {
+    return Status::OutOfRange();
+  }
+
+  // Reserve space for the record. The tail is loaded before the head, so that
+  // the head is never behind it.
+  const size_t record_size = kHeaderSize + RoundUpToHeader(size);
+  size_t head;
+  do {
+    const size_t tail = read_tail_.load(std::memory_order_acquire);
+    head = reserve_head_.load(std::memory_order_relaxed);
+    if (head - tail + record_size > buffer_.size()) {
+      return Status::ResourceExhausted();
+    }
+  } while (!reserve_head_.compare_exchange_weak(head,
+                                                head + record_size,
+                                                std::memory_order_relaxed,
+                                                std::memory_order_relaxed));
+
+  size_t pos = head + kHeaderSize;
+  for (ConstByteSpan bytes : data) {
+    CopyIn(pos, bytes);
+    pos += bytes.size();
+  }
+  HeaderAt(head).store(static_cast<uint32_t>(size), std::memory_order_release);
+  WakeReader();
+  return OkStatus();
+}
+
+void LockFreeMpscReader::WakeReader() {
+  // Pairs with the fence in PendReadable, so that either this sees the waiting
+  // task or the task sees the new record.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!waiting_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  async2::Waker waker;
+  {
+    std::lock_guard lock(lock_);
+    waiting_.store(false, std::memory_order_relaxed);
+    waker = std::move(waker_);
+  }
+  std::move(waker).Wake();
+}
+
+bool LockFreeMpscReader::HasData() const {
+  const size_t tail = read_tail_.load(std::memory_order_relaxed);
+  return HeaderAt(tail).load(std::memory_order_acquire) != 0;
+}
+
+std::atomic<uint32_t>& LockFreeMpscReader::HeaderAt(size_t pos) const {
+  return *reinterpret_cast<std::atomic<uint32_t>*>(buffer_.data() +
+                                                   (pos & mask_));
+}
+
+void LockFreeMpscReader::CopyIn(size_t pos, ConstByteSpan data) {
+  const size_t offset = pos & mask_;
+  const size_t first = std::min(data.size(), buffer_.size() - offset);
+  std::memcpy(buffer_.data() + offset, data.data(), first);
+  std::memcpy(buffer_.data(), data.data() + first, data.size() - first);
+}
+
+void LockFreeMpscReader::CopyOut(size_t pos, ByteSpan dest) const {
+  const size_t offset = pos & mask_;
+  const size_t first = std::min(dest.size(), buffer_.size() - offset);
+  std::memcpy(dest.data(), buffer_.data() + offset, first);
+  std::memcpy(dest.data() + first, buffer_.data(), dest.size() - first);
+}
+
+void LockFreeMpscReader::Clear(size_t pos, size_t size) {
+  const size_t offset = pos & mask_;
+  const size_t first = std::min(size, buffer_.size() - offset);
+  std::memset(buffer_.data() + offset, 0, first);
+  std::memset(buffer_.data(), 0, size - first);
+}
+
+StatusWithSize LockFreeMpscReader::DoRead(ByteSpan destination) {
+  size_t tail = read_tail_.load(std::memory_order_relaxed);
+  size_t read = 0;
+  while (read < destination.size()) {
+    std::atomic<uint32_t>& header = HeaderAt(tail);
+    const size_t size = header.load(std::memory_order_acquire);
+    if (size == 0) {
+      break;
+    }
+    const size_t num_bytes =
+        std::min(destination.size() - read, size - record_offset_);
+    CopyOut(tail + kHeaderSize + record_offset_,
+            destination.subspan(read, num_bytes));
+    read += num_bytes;
+    record_offset_ += num_bytes;
+    if (record_offset_ < size) {
+      break;
+    }
+
+    // The record has been consumed. Zero it before releasing its space, so
+    // that writers that reserve it find uncommitted headers.
+    header.store(0, std::memory_order_relaxed);
+    Clear(tail + kHeaderSize, RoundUpToHeader(size));
+    tail += kHeaderSize + RoundUpToHeader(size);
+    record_offset_ = 0;
+  }
+  read_tail_.store(tail, std::memory_order_release);
+
+  if (read != 0) {
+    return StatusWithSize(read);
+  }
+  return closed() ? StatusWithSize::OutOfRange()
+                  : StatusWithSize::ResourceExhausted();
+}
+
+Status LockFreeMpscWriter::DoWrite(ConstByteSpan data) {
+  return reader_->Commit(span<const ConstByteSpan>(&data, 1));
+}
+
+Status LockFreeMpscWriter::DoWriteVectored(span<const ConstByteSpan> buffers) {
+  return reader_->Commit(buffers);
+}
+
+}  // namespace pw::stream
@@ -0,0 +1,248 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/lock_free_mpsc_stream.h"
+
+#include <array>
+#include <cstdint>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_bytes/array.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::stream {
+namespace {
+
+using ::pw::async2::Context;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+using ::pw::async2::Task;
+
+constexpr auto kData = bytes::Array<1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11>();
+
+TEST(LockFreeMpscStreamTest, ReadEmptyIsResourceExhausted) {
+  BufferedLockFreeMpscReader<64> reader;
+  std::array<std::byte, 16> buffer;
+  EXPECT_EQ(reader.Read(buffer).status(), Status::ResourceExhausted());
+}
+
+TEST(LockFreeMpscStreamTest, WriteThenRead) {
+  BufferedLockFreeMpscReader<64> reader;
+  LockFreeMpscWriter writer(reader);
+  EXPECT_EQ(writer.Write(kData), OkStatus());
+
+  std::array<std::byte, 32> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result->size(), kData.size());
+  EXPECT_TRUE(std::equal(result->begin(), result->end(), kData.begin()));
+  EXPECT_EQ(reader.Read(buffer).status(), Status::ResourceExhausted());
+}
+
+TEST(LockFreeMpscStreamTest, ReadSpansRecords) {
+  BufferedLockFreeMpscReader<64> reader;
+  LockFreeMpscWriter writer1(reader);
+  LockFreeMpscWriter writer2(writer1);
+  EXPECT_EQ(writer1.Write(span(kData).first(3)), OkStatus());
+  EXPECT_EQ(writer2.Write(span(kData).subspan(3)), OkStatus());
+
+  std::array<std::byte, 32> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result->size(), kData.size());
+  EXPECT_TRUE(std::equal(result->begin(), result->end(), kData.begin()));
+}
+
+TEST(LockFreeMpscStreamTest, ReadPartialRecord) {
+  BufferedLockFreeMpscReader<64> reader;
+  LockFreeMpscWriter writer(reader);
+  EXPECT_EQ(writer.Write(kData), OkStatus());
+
+  std::array<std::byte, 4> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result->size(), 4u);
+  EXPECT_EQ((*result)[3], std::byte(4));
+
+  result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ((*result)[0], std::byte(5));
+
+  result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result->size(), 3u);
+  EXPECT_EQ((*result)[2], std::byte(11));
+}
+
+TEST(LockFreeMpscStreamTest, WriteFailsWhenFull) {
+  BufferedLockFreeMpscReader<32> reader;
+  LockFreeMpscWriter writer(reader);
+
+  // Each record of 11 bytes uses 16 bytes of the buffer.
+  EXPECT_EQ(writer.Write(kData), OkStatus());
+  EXPECT_EQ(writer.Write(kData), OkStatus());
+  EXPECT_EQ(writer.Write(kData), Status::ResourceExhausted());
+
+  std::array<std::byte, 11> buffer;
+  EXPECT_EQ(reader.Read(buffer).status(), OkStatus());
+  EXPECT_EQ(writer.Write(kData), OkStatus());
+}
+
+TEST(LockFreeMpscStreamTest, WriteTooLargeIsOutOfRange) {
+  BufferedLockFreeMpscReader<16> reader;
+  LockFreeMpscWriter writer(reader);
+  EXPECT_EQ(reader.max_write_size(), 12u);
+  EXPECT_EQ(writer.ConservativeWriteLimit(), 12u);
+  EXPECT_EQ(writer.Write(kData), OkStatus());
+
+  std::array<std::byte, 16> buffer;
+  EXPECT_EQ(reader.Read(buffer).status(), OkStatus());
+  EXPECT_EQ(writer.Write(bytes::Initialized<13>(0)), Status::OutOfRange());
+}
+
+TEST(LockFreeMpscStreamTest, RecordsWrapAroundBuffer) {
+  BufferedLockFreeMpscReader<32> reader;
+  LockFreeMpscWriter writer(reader);
+  std::array<std::byte, 11> buffer;
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(writer.Write(kData), OkStatus());
+    Result<ByteSpan> result = reader.Read(buffer);
+    ASSERT_EQ(result.status(), OkStatus());
+    ASSERT_EQ(result->size(), kData.size());
+    EXPECT_TRUE(std::equal(result->begin(), result->end(), kData.begin()));
+  }
+}
+
+TEST(LockFreeMpscStreamTest, VectoredWriteIsOneRecord) {
+  BufferedLockFreeMpscReader<32> reader;
+  LockFreeMpscWriter writer(reader);
+  const std::array<ConstByteSpan, 3> buffers = {
+      span(kData).first(2), span(kData).subspan(2, 5), span(kData).subspan(7)};
+  EXPECT_EQ(writer.Write(buffers), OkStatus());
+  EXPECT_EQ(writer.ConservativeWriteLimit(), 28u);
+
+  std::array<std::byte, 32> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result->size(), kData.size());
+  EXPECT_TRUE(std::equal(result->begin(), result->end(), kData.begin()));
+}
+
+TEST(LockFreeMpscStreamTest, CloseFailsWritesAndDrainsReader) {
+  BufferedLockFreeMpscReader<64> reader;
+  LockFreeMpscWriter writer(reader);
+  EXPECT_EQ(writer.Write(kData), OkStatus());
+  reader.Close();
+  EXPECT_TRUE(reader.closed());
+  EXPECT_EQ(writer.Write(kData), Status::OutOfRange());
+  EXPECT_EQ(writer.ConservativeWriteLimit(), 0u);
+
+  std::array<std::byte, 32> buffer;
+  EXPECT_EQ(reader.Read(buffer).status(), OkStatus());
+  EXPECT_EQ(reader.Read(buffer).status(), Status::OutOfRange());
+}
+
+class ReadTask : public Task {
+ public:
+  explicit ReadTask(LockFreeMpscReader& reader) : reader_(reader) {}
+
+  size_t total_read() const { return total_read_; }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    while (true) {
+      if (reader_.PendReadable(cx).IsPending()) {
+        return Pending();
+      }
+      std::array<std::byte, 16> buffer;
+      Result<ByteSpan> result = reader_.Read(buffer);
+      if (result.status().IsOutOfRange()) {
+        return Ready();
+      }
+      total_read_ += result->size();
+    }
+  }
+
+  LockFreeMpscReader& reader_;
+  size_t total_read_ = 0;
+};
+
+TEST(LockFreeMpscStreamTest, PendReadableWakesOnWriteAndClose) {
+  BufferedLockFreeMpscReader<64> reader;
+  LockFreeMpscWriter writer(reader);
+  ReadTask task(reader);
+  Dispatcher dispatcher;
+  dispatcher.Post(task);
+
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsPending());
+  EXPECT_EQ(writer.Write(kData), OkStatus());
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsPending());
+  EXPECT_EQ(task.total_read(), kData.size());
+
+  reader.Close();
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsReady());
+}
+
+TEST(LockFreeMpscStreamTest, ConcurrentWritersKeepRecordsIntact) {
+  constexpr size_t kNumWriters = 2;
+  constexpr uint32_t kNumRecords = 1000;
+  BufferedLockFreeMpscReader<128> reader;
+
+  struct Producer {
+    LockFreeMpscWriter writer;
+    uint32_t id;
+  };
+  std::array<Producer, kNumWriters> producers = {
+      Producer{LockFreeMpscWriter(reader), 0},
+      Producer{LockFreeMpscWriter(reader), 1},
+  };
+  std::array<thread::test::TestThreadContext, kNumWriters> contexts;
+  std::array<thread::Thread, kNumWriters> threads;
+  for (size_t i = 0; i < kNumWriters; ++i) {
+    Producer& producer = producers[i];
+    threads[i] = thread::Thread(contexts[i].options(), [&producer]() {
+      for (uint32_t seq = 0; seq < kNumRecords;) {
+        const std::array<uint32_t, 2> record = {producer.id, seq};
+        if (producer.writer.Write(as_bytes(span(record))).ok()) {
+          ++seq;
+        }
+      }
+    });
+  }
+
+  std::array<uint32_t, kNumWriters> next_seq = {};
+  for (uint32_t received = 0; received < kNumWriters * kNumRecords;) {
+    std::array<uint32_t, 2> record;
+    Result<ByteSpan> result = reader.Read(as_writable_bytes(span(record)));
+    if (!result.ok()) {
+      continue;
+    }
+    ASSERT_EQ(result->size(), sizeof(record));
+    ASSERT_LT(record[0], kNumWriters);
+    ASSERT_EQ(record[1], next_seq[record[0]]);
+    ++next_seq[record[0]];
+    ++received;
+  }
+  for (thread::Thread& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+}  // namespace pw::stream
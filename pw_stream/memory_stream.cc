@@ -36,7 +36,11 @@ Status MemoryWriter::DoWrite(ConstByteSpan data) {
     // call when data is an empty span.
     return OkStatus();
   }
-  std::memmove(dest_.data() + position_, data.data(), bytes_to_write);
+  // Data that was produced in place, e.g. read directly into the buffer being
+  // encoded, does not need to be moved.
+  if (dest_.data() + position_ != data.data()) {
+    std::memmove(dest_.data() + position_, data.data(), bytes_to_write);
+  }
   position_ += bytes_to_write;
 
   return OkStatus();
@@ -158,6 +158,22 @@ TEST_F(MemoryWriterTest, OverlappingBuffer) {
                kTestString.data());
 }
 
+TEST_F(MemoryWriterTest, DataAlreadyInPlace) {
+  constexpr std::string_view kTestString("This was read into place");
+  MemoryWriter memory_writer(memory_buffer_);
+  ASSERT_TRUE(memory_writer.Write(std::byte('>')).ok());
+
+  // Stage the data where the writer will write it next.
+  std::byte* const kInPlaceStart = memory_buffer_.data() + 1;
+  std::memcpy(kInPlaceStart, kTestString.data(), kTestString.size());
+  EXPECT_TRUE(memory_writer.Write(kInPlaceStart, kTestString.size()).ok());
+  EXPECT_TRUE(memory_writer.Write(std::byte(0)).ok());
+  EXPECT_EQ(memory_writer.bytes_written(), kTestString.size() + 2);
+
+  EXPECT_STREQ(reinterpret_cast<const char*>(memory_writer.data()) + 1,
+               kTestString.data());
+}
+
 TEST_F(MemoryWriterTest, Clear) {
   MemoryWriter writer(memory_buffer_);
   EXPECT_EQ(OkStatus(), writer.Write(std::byte{1}));
@@ -0,0 +1,98 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/mmap_file_stream.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "pw_log/log.h"
+#include "pw_stream/seek.h"
+
+namespace pw::stream {
+
+Status MmapFileReader::Open(const char* path) {
+  Close();
+
+  const int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    const int error = errno;
+    PW_LOG_ERROR("Failed to open '%s', %s", path, std::strerror(error));
+    if (error == ENOENT) {
+      return Status::NotFound();
+    }
+    if (error == EACCES) {
+      return Status::PermissionDenied();
+    }
+    return Status::Unknown();
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    PW_LOG_ERROR("Failed to stat '%s', %s", path, std::strerror(errno));
+    close(fd);
+    return Status::Unknown();
+  }
+
+  // mmap() rejects empty mappings, so an empty file is left unmapped.
+  const size_t size = static_cast<size_t>(file_stat.st_size);
+  if (size != 0) {
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      PW_LOG_ERROR("Failed to map '%s', %s", path, std::strerror(errno));
+      close(fd);
+      return Status::Unknown();
+    }
+    data_ = ConstByteSpan(static_cast<const std::byte*>(mapping), size);
+  }
+
+  // The mapping keeps its own reference to the file.
+  close(fd);
+  return OkStatus();
+}
+
+void MmapFileReader::Close() {
+  if (!data_.empty()) {
+    munmap(const_cast<std::byte*>(data_.data()), data_.size());
+  }
+  data_ = ConstByteSpan();
+  position_ = 0;
+}
+
+StatusWithSize MmapFileReader::DoRead(ByteSpan dest) {
+  if (position_ == data_.size()) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  const size_t bytes_to_read = std::min(dest.size(), data_.size() - position_);
+  if (bytes_to_read == 0) {
+    return StatusWithSize(0);
+  }
+
+  std::memcpy(dest.data(), data_.data() + position_, bytes_to_read);
+  position_ += bytes_to_read;
+  return StatusWithSize(bytes_to_read);
+}
+
+Status MmapFileReader::DoSeek(ptrdiff_t offset, Whence origin) {
+  return CalculateSeek(offset, origin, data_.size(), position_);
+}
+
+}  // namespace pw::stream
@@ -0,0 +1,118 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream/mmap_file_stream.h"
+
+#include <unistd.h>
+
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::stream {
+namespace {
+
+constexpr std::string_view kTestData(
+    "This is a test string used to verify correctness!");
+
+// Creates a temporary file with the given contents, deleted on destruction.
+class TempFile {
+ public:
+  TempFile(std::string_view contents) {
+    const char* dir = std::getenv("TMPDIR");
+    path_ = std::string(dir != nullptr ? dir : "/tmp") + "/MmapFileXXXXXX";
+    const int fd = mkstemp(path_.data());
+    EXPECT_GE(fd, 0);
+    EXPECT_EQ(write(fd, contents.data(), contents.size()),
+              static_cast<ssize_t>(contents.size()));
+    close(fd);
+  }
+
+  ~TempFile() { unlink(path_.c_str()); }
+
+  const char* path() const { return path_.c_str(); }
+
+ private:
+  std::string path_;
+};
+
+TEST(MmapFileReader, OpenMissingFileReturnsNotFound) {
+  MmapFileReader reader;
+  EXPECT_EQ(reader.Open("/this/file/does/not/exist"), Status::NotFound());
+  EXPECT_TRUE(reader.data().empty());
+}
+
+TEST(MmapFileReader, DataReturnsFileContents) {
+  TempFile file(kTestData);
+  MmapFileReader reader;
+  ASSERT_EQ(reader.Open(file.path()), OkStatus());
+
+  ConstByteSpan data = reader.data();
+  ASSERT_EQ(data.size(), kTestData.size());
+  EXPECT_EQ(std::memcmp(data.data(), kTestData.data(), kTestData.size()), 0);
+}
+
+TEST(MmapFileReader, ReadAndSeek) {
+  TempFile file(kTestData);
+  MmapFileReader reader;
+  ASSERT_EQ(reader.Open(file.path()), OkStatus());
+  EXPECT_EQ(reader.ConservativeReadLimit(), kTestData.size());
+
+  std::array<std::byte, 4> buffer;
+  Result<ByteSpan> result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(std::memcmp(result->data(), "This", 4), 0);
+  EXPECT_EQ(reader.Tell(), 4u);
+
+  ASSERT_EQ(reader.Seek(-12, Stream::kEnd), OkStatus());
+  result = reader.Read(buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(std::memcmp(result->data(), "corr", 4), 0);
+  EXPECT_EQ(reader.ConservativeReadLimit(), 8u);
+
+  EXPECT_EQ(reader.Seek(1, Stream::kEnd), Status::OutOfRange());
+  EXPECT_EQ(reader.Seek(0, Stream::kEnd), OkStatus());
+  EXPECT_EQ(reader.Read(buffer).status(), Status::OutOfRange());
+}
+
+TEST(MmapFileReader, EmptyFile) {
+  TempFile file("");
+  MmapFileReader reader;
+  ASSERT_EQ(reader.Open(file.path()), OkStatus());
+  EXPECT_TRUE(reader.data().empty());
+
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(reader.Read(buffer).status(), Status::OutOfRange());
+}
+
+TEST(MmapFileReader, CloseUnmapsFile) {
+  TempFile file(kTestData);
+  MmapFileReader reader;
+  ASSERT_EQ(reader.Open(file.path()), OkStatus());
+  ASSERT_EQ(reader.Seek(10), OkStatus());
+
+  reader.Close();
+  EXPECT_TRUE(reader.data().empty());
+  EXPECT_EQ(reader.Tell(), 0u);
+  EXPECT_EQ(reader.ConservativeReadLimit(), 0u);
+}
+
+}  // namespace
+}  // namespace pw::stream
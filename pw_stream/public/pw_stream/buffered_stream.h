@@ -0,0 +1,114 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+/// Reader that reads from another reader in chunks the size of its buffer.
+///
+/// Small reads, such as the single-byte reads of varint decoding, are served
+/// from the buffer, so the source is only read once per buffer's worth of
+/// data. Reads at least as large as the buffer bypass it when it is empty.
+///
+/// Seeking from the current position within the buffered data is always
+/// supported, even if the source is not seekable. Other seeks discard the
+/// buffered data and seek the source, so they succeed only if the source
+/// supports them. `Tell()` accounts for the buffered data.
+///
+/// The source must not be read or seeked directly while the `BufferedReader`
+/// holds buffered data.
+class BufferedReader final : public RelativeSeekableReader {
+ public:
+  /// @param source  The reader to read from.
+  /// @param buffer  Buffer for data read from the source but not yet consumed.
+  ///                Must not be empty.
+  BufferedReader(Reader& source, ByteSpan buffer);
+
+  /// Returns the number of bytes read from the source that have not been
+  /// consumed.
+  size_t buffered_bytes() const { return end_ - begin_; }
+
+  /// Discards the buffered data, so that the next read reads from the source.
+  /// The source's position is not changed.
+  void DiscardBuffer() { begin_ = end_ = 0; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override;
+  Status DoSeek(ptrdiff_t offset, Whence origin) override;
+  size_t DoTell() override;
+  size_t ConservativeLimit(LimitType limit) const override;
+
+  Reader& source_;
+  ByteSpan buffer_;
+  size_t begin_ = 0;  // Offset of the next byte to read in buffer_.
+  size_t end_ = 0;    // Number of bytes in buffer_ read from the source.
+};
+
+/// Writer that collects small writes in a buffer and writes them to another
+/// writer in chunks the size of the buffer.
+///
+/// Writes that do not fit in the rest of the buffer flush it first. Writes at
+/// least as large as the buffer are written to the sink directly, after any
+/// buffered data.
+///
+/// Buffered data is written to the sink by `Flush()`, before seeking, and when
+/// the `BufferedWriter` is destroyed. Call `Flush()` explicitly to find out
+/// whether the sink accepted the data. Seeks are forwarded to the sink after
+/// flushing, so they succeed only if the sink supports them.
+class BufferedWriter final : public RelativeSeekableWriter {
+ public:
+  /// @param sink    The writer to write to.
+  /// @param buffer  Buffer for data that has not been written to the sink.
+  ///                Must not be empty.
+  BufferedWriter(Writer& sink, ByteSpan buffer);
+
+  /// Flushes the buffered data, ignoring errors.
+  ~BufferedWriter() override;
+
+  /// Returns the number of bytes that have not been written to the sink.
+  size_t buffered_bytes() const { return size_; }
+
+  /// Writes the buffered data to the sink.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The sink accepted all of the buffered data.
+  ///
+  /// @endrst
+  ///
+  /// Otherwise, returns the sink's error. The buffered data is kept, so the
+  /// flush may be retried, though the sink may have accepted part of it.
+  Status Flush();
+
+ private:
+  Status DoWrite(ConstByteSpan data) override;
+  Status DoSeek(ptrdiff_t offset, Whence origin) override;
+  size_t DoTell() override;
+  size_t ConservativeLimit(LimitType limit) const override;
+
+  Writer& sink_;
+  ByteSpan buffer_;
+  size_t size_ = 0;  // Number of bytes in buffer_ not written to the sink.
+};
+
+}  // namespace pw::stream
@@ -0,0 +1,208 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+/// @file
+/// This file defines a multi-producer, single-consumer stream backed by a
+/// lock-free ring buffer.
+///
+/// Unlike `MpscReader` and `MpscWriter`, writers never wait for the reader.
+/// Each write atomically reserves space for its data in the reader's ring
+/// buffer, copies the data in, and commits it. If the buffer is full, the
+/// write fails immediately with `RESOURCE_EXHAUSTED`. The reader may poll with
+/// `Read()`, or wait for data from a `pw::async2` task with `PendReadable()`.
+///
+/// Example:
+///
+/// @code{.cpp}
+///    BufferedLockFreeMpscReader<1024> reader;
+///
+///    void ProducerThreadRoutine() {
+///      LockFreeMpscWriter writer(reader);
+///      ConstByteSpan data = GenerateSomeData();
+///      if (!writer.Write(data).ok()) {
+///        ++dropped;
+///      }
+///    }
+///
+///    Poll<> ConsumerTask::DoPend(Context& cx) {
+///      while (true) {
+///        PW_TRY_READY(reader.PendReadable(cx));
+///        std::byte buffer[kBufSize];
+///        if (auto result = reader.Read(buffer); result.ok()) {
+///          ProcessSomeData(*result);
+///        }
+///      }
+///    }
+/// @endcode
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_bytes/span.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::stream {
+
+/// Reader for a lock-free, multi-producer, single consumer stream.
+///
+/// Data is stored in a ring buffer as a sequence of records, one per call to
+/// `LockFreeMpscWriter::Write()`. The bytes of each write are contiguous in
+/// the stream, even when several writers write concurrently. Records are
+/// stored with a 4-byte header and are padded to a multiple of 4 bytes.
+///
+/// Only one thread may read at a time. `Close()` may be called from any
+/// thread.
+class LockFreeMpscReader : public NonSeekableReader {
+ public:
+  /// Creates a reader that stores data in the given buffer.
+  ///
+  /// @param[in]  buffer  The ring buffer. Its size must be a power of two of
+  ///   at least 8 bytes, and it must be 4-byte aligned.
+  explicit LockFreeMpscReader(ByteSpan buffer);
+
+  LockFreeMpscReader(const LockFreeMpscReader&) = delete;
+  LockFreeMpscReader& operator=(const LockFreeMpscReader&) = delete;
+
+  /// Returns the largest amount of data a single write can store.
+  size_t max_write_size() const { return buffer_.size() - kHeaderSize; }
+
+  /// Returns `Ready` if data is available to read or the reader is closed.
+  /// Otherwise returns `Pending` and wakes the task when a writer commits
+  /// data.
+  ///
+  /// Only one task should wait in `PendReadable` at a time, since each call
+  /// replaces the `Waker` of the previous one.
+  async2::Poll<> PendReadable(async2::Context& cx);
+
+  /// Closes the stream. Subsequent writes fail with `OUT_OF_RANGE`. Data that
+  /// was already committed may still be read.
+  void Close();
+
+  /// Returns whether the stream has been closed.
+  bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+ private:
+  friend class LockFreeMpscWriter;
+
+  static constexpr size_t kHeaderSize = sizeof(uint32_t);
+
+  /// Reserves space for, copies, and commits a single record.
+  Status Commit(span<const ConstByteSpan> data);
+
+  /// Wakes the task waiting in `PendReadable`, if any.
+  void WakeReader();
+
+  /// Returns whether a committed record is waiting at `read_tail_`.
+  bool HasData() const;
+
+  /// Returns the record header for the given stream position.
+  std::atomic<uint32_t>& HeaderAt(size_t pos) const;
+
+  /// Copies bytes between the stream position and a buffer, wrapping around
+  /// the end of the ring buffer as needed.
+  void CopyIn(size_t pos, ConstByteSpan data);
+  void CopyOut(size_t pos, ByteSpan dest) const;
+
+  /// Zeroes `size` bytes starting at the stream position.
+  void Clear(size_t pos, size_t size);
+
+  /// @copydoc Reader::Read
+  StatusWithSize DoRead(ByteSpan destination) override;
+
+  const ByteSpan buffer_;
+  const size_t mask_;
+
+  // Stream positions increase monotonically and are reduced modulo the buffer
+  // size when accessing the buffer. `reserve_head_` is advanced by writers as
+  // they reserve space; `read_tail_` is advanced by the reader once it has
+  // consumed a record and zeroed its space. Free space is always zeroed, so a
+  // zero header marks a record that has been reserved but not yet committed.
+  std::atomic<size_t> reserve_head_ = 0;
+  std::atomic<size_t> read_tail_ = 0;
+  std::atomic<bool> closed_ = false;
+
+  // Offset of the next byte to read from the record at `read_tail_`. Only
+  // accessed by the reader.
+  size_t record_offset_ = 0;
+
+  std::atomic<bool> waiting_ = false;
+  sync::InterruptSpinLock lock_;
+  async2::Waker waker_ PW_GUARDED_BY(lock_);
+};
+
+/// Writer for a lock-free, multi-producer, single consumer stream.
+///
+/// Writers are cheap to create and copy, and any number of threads or
+/// interrupt handlers may write concurrently, even using the same writer.
+/// Writers must not outlive their reader.
+class LockFreeMpscWriter : public NonSeekableWriter {
+ public:
+  explicit LockFreeMpscWriter(LockFreeMpscReader& reader) : reader_(&reader) {}
+
+  LockFreeMpscWriter(const LockFreeMpscWriter&) = default;
+  LockFreeMpscWriter& operator=(const LockFreeMpscWriter&) = default;
+
+ private:
+  /// Writes the data as a single record.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The data was committed to the stream.
+  ///
+  ///    RESOURCE_EXHAUSTED: The ring buffer does not have room for the data
+  ///    at this time. No data was written.
+  ///
+  ///    OUT_OF_RANGE: The reader has been closed, or the data is larger than
+  ///    the reader's ``max_write_size()``. No data was written.
+  ///
+  /// @endrst
+  Status DoWrite(ConstByteSpan data) override;
+
+  /// Writes all of the buffers as a single record.
+  Status DoWriteVectored(span<const ConstByteSpan> buffers) override;
+
+  size_t ConservativeLimit(LimitType type) const override {
+    return type == LimitType::kWrite && !reader_->closed()
+               ? reader_->max_write_size()
+               : 0;
+  }
+
+  LockFreeMpscReader* reader_;
+};
+
+/// Lock-free reader with an included buffer.
+///
+/// @tparam kCapacity   Size of the ring buffer. Must be a power of two of at
+///   least 8 bytes.
+template <size_t kCapacity>
+class BufferedLockFreeMpscReader : public LockFreeMpscReader {
+ public:
+  BufferedLockFreeMpscReader() : LockFreeMpscReader(buffer_) {}
+
+ private:
+  alignas(uint32_t) std::array<std::byte, kCapacity> buffer_ = {};
+};
+
+}  // namespace pw::stream
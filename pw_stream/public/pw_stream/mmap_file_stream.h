@@ -0,0 +1,74 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+
+namespace pw::stream {
+
+/// Reads a file that is mapped into memory. Only available on POSIX hosts.
+///
+/// Reads copy directly from the mapped pages, without an intermediate stdio
+/// buffer. The mapped contents are also available as a span from ``data()``,
+/// so parsers that accept a span, such as ``pw::protobuf::Decoder``, can
+/// process the file without copying it.
+class MmapFileReader final : public SeekableReader {
+ public:
+  MmapFileReader() = default;
+  ~MmapFileReader() override { Close(); }
+
+  MmapFileReader(const MmapFileReader&) = delete;
+  MmapFileReader& operator=(const MmapFileReader&) = delete;
+
+  /// Maps the file at ``path``, unmapping any previously opened file.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The file was mapped.
+  ///
+  ///    NOT_FOUND: The file does not exist.
+  ///
+  ///    PERMISSION_DENIED: The file could not be opened for reading.
+  ///
+  ///    UNKNOWN: The file could not be mapped.
+  ///
+  /// @endrst
+  Status Open(const char* path);
+
+  /// Unmaps the file. Spans returned by ``data()`` are no longer valid.
+  void Close();
+
+  /// Returns the contents of the whole file, regardless of the current
+  /// position. The span is valid until the reader is closed or destroyed.
+  ConstByteSpan data() const { return data_; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan dest) override;
+  Status DoSeek(ptrdiff_t offset, Whence origin) override;
+  size_t DoTell() override { return position_; }
+  size_t ConservativeLimit(LimitType type) const override {
+    return type == LimitType::kRead ? data_.size() - position_ : 0;
+  }
+
+  ConstByteSpan data_;
+  size_t position_ = 0;
+};
+
+}  // namespace pw::stream
@@ -84,6 +84,8 @@ class SocketStream : public NonSeekableReaderWriter {
 
   Status DoWrite(span<const std::byte> data) override;
 
+  Status DoWriteVectored(span<const ConstByteSpan> data) override;
+
   StatusWithSize DoRead(ByteSpan dest) override;
 
   // Take ownership of the connection. There may be multiple owners. Each time
@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <type_traits>
 
 #include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
@@ -178,6 +179,43 @@ class Stream {
   /// @overload
   Status Write(const std::byte b) { return Write(&b, 1); }
 
+  /// Writes several buffers to this stream, in order, as if by calling
+  /// Write() for each of them. This allows writing a header and a payload
+  /// that are stored separately without copying them into one buffer first.
+  /// ``data`` may be any container of ``ConstByteSpan``s, such as a
+  /// ``std::array<ConstByteSpan, 2>`` or a ``span<const ConstByteSpan>``.
+  ///
+  /// Streams backed by a file descriptor write all of the buffers with as few
+  /// system calls as possible. Other streams write the buffers one at a time;
+  /// if one of them fails, the preceding buffers may have been written.
+  ///
+  /// Derived classes should NOT try to override the public Write methods.
+  /// Instead, provide an implementation by overriding DoWriteVectored().
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: All of the data was successfully accepted by the stream.
+  ///
+  ///    UNIMPLEMENTED: This stream does not support writing.
+  ///
+  ///    FAILED_PRECONDITION: The writer is not in a state to accept data.
+  ///
+  ///    RESOURCE_EXHAUSTED: The writer was unable to write all of requested
+  ///    data at this time.
+  ///
+  ///    OUT_OF_RANGE: The Writer has been exhausted, similar to EOF.
+  ///
+  /// @endrst
+  template <typename Buffers,
+            typename = std::enable_if_t<std::is_convertible_v<
+                const Buffers&,
+                span<const ConstByteSpan>>>>
+  Status Write(const Buffers& data) {
+    return DoWriteVectored(span<const ConstByteSpan>(data));
+  }
+
   /// Changes the current position in the stream for both reading and writing,
   /// if supported.
   ///
@@ -284,6 +322,21 @@ class Stream {
   /// Virtual Write() function implemented by derived classes.
   virtual Status DoWrite(ConstByteSpan data) = 0;
 
+  /// Virtual vectored Write() function optionally implemented by derived
+  /// classes. The default implementation calls DoWrite() for each non-empty
+  /// buffer and stops at the first error.
+  virtual Status DoWriteVectored(span<const ConstByteSpan> data) {
+    for (ConstByteSpan buffer : data) {
+      if (buffer.empty()) {
+        continue;
+      }
+      if (Status status = DoWrite(buffer); !status.ok()) {
+        return status;
+      }
+    }
+    return OkStatus();
+  }
+
   /// Virtual Seek() function implemented by derived classes.
   virtual Status DoSeek(ptrdiff_t offset, Whence origin) = 0;
 
@@ -333,6 +386,9 @@ class Reader : public Stream {
   using Stream::Write;
 
   Status DoWrite(ConstByteSpan) final { return Status::Unimplemented(); }
+  Status DoWriteVectored(span<const ConstByteSpan>) final {
+    return Status::Unimplemented();
+  }
 };
 
 /// A Reader that supports at least relative seeking within some range of the
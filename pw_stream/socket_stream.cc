@@ -27,9 +27,12 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif  // defined(_WIN32) && _WIN32
 
+#include <algorithm>
+#include <array>
 #include <cerrno>
 #include <cstring>
 
@@ -44,6 +47,14 @@ namespace {
 constexpr uint32_t kServerBacklogLength = 1;
 constexpr const char* kLocalhostAddress = "localhost";
 
+#if defined(__linux__)
+// Use MSG_NOSIGNAL to avoid getting a SIGPIPE signal when the remote peer drops
+// the connection. This is supported on Linux only.
+constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr int kSendFlags = 0;
+#endif  // defined(__linux__)
+
 // Set necessary options on a socket file descriptor.
 void ConfigureSocket([[maybe_unused]] int socket) {
 #if defined(__APPLE__)
@@ -185,13 +196,6 @@ void SocketStream::Close() {
 }
 
 Status SocketStream::DoWrite(span<const std::byte> data) {
-  int send_flags = 0;
-#if defined(__linux__)
-  // Use MSG_NOSIGNAL to avoid getting a SIGPIPE signal when the remote
-  // peer drops the connection. This is supported on Linux only.
-  send_flags |= MSG_NOSIGNAL;
-#endif  // defined(__linux__)
-
   ssize_t bytes_sent;
   {
     ConnectionOwnership ownership(this);
@@ -201,7 +205,7 @@ Status SocketStream::DoWrite(span<const std::byte> data) {
     bytes_sent = send(ownership.fd(),
                       reinterpret_cast<const char*>(data.data()),
                       data.size_bytes(),
-                      send_flags);
+                      kSendFlags);
   }
 
   if (bytes_sent < 0 || static_cast<size_t>(bytes_sent) != data.size()) {
@@ -216,6 +220,47 @@ Status SocketStream::DoWrite(span<const std::byte> data) {
   return OkStatus();
 }
 
+Status SocketStream::DoWriteVectored(span<const ConstByteSpan> data) {
+#if defined(_WIN32) && _WIN32
+  return NonSeekableReaderWriter::DoWriteVectored(data);
+#else
+  ConnectionOwnership ownership(this);
+  if (ownership.fd() == kInvalidFd) {
+    return Status::Unknown();
+  }
+
+  // Send up to this many buffers with each sendmsg() call.
+  constexpr size_t kMaxBuffersPerSend = 16;
+
+  while (!data.empty()) {
+    std::array<iovec, kMaxBuffersPerSend> iov;
+    const size_t count = std::min(data.size(), iov.size());
+    size_t total_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+      // iovec is shared with readv(), so its base is not const.
+      iov[i].iov_base = const_cast<std::byte*>(data[i].data());
+      iov[i].iov_len = data[i].size_bytes();
+      total_size += data[i].size_bytes();
+    }
+
+    msghdr message = {};
+    message.msg_iov = iov.data();
+    message.msg_iovlen = count;
+    const ssize_t bytes_sent = sendmsg(ownership.fd(), &message, kSendFlags);
+    if (bytes_sent < 0 || static_cast<size_t>(bytes_sent) != total_size) {
+      if (errno == EPIPE) {
+        // An EPIPE indicates that the connection is closed.  Return an
+        // OutOfRange error.
+        return Status::OutOfRange();
+      }
+      return Status::Unknown();
+    }
+    data = data.subspan(count);
+  }
+  return OkStatus();
+#endif  // defined(_WIN32) && _WIN32
+}
+
 StatusWithSize SocketStream::DoRead(ByteSpan dest) {
   ConnectionOwnership ownership(this);
   if (ownership.fd() == kInvalidFd) {
@@ -14,6 +14,7 @@
 
 #include "pw_stream/socket_stream.h"
 
+#include <array>
 #include <thread>
 
 #include "pw_result/result.h"
@@ -136,6 +137,55 @@ TEST(SocketStreamTest, ReadWrite) {
   server.Close();
 }
 
+TEST(SocketStreamTest, WriteVectored) {
+  ServerSocket server;
+  EXPECT_EQ(server.Listen(), OkStatus());
+
+  Result<SocketStream> server_stream = Status::Unavailable();
+  auto accept_thread = std::thread{[&]() { server_stream = server.Accept(); }};
+
+  SocketStream client;
+  EXPECT_EQ(client.Connect("localhost", server.port()), OkStatus());
+
+  accept_thread.join();
+  ASSERT_EQ(server_stream.status(), OkStatus());
+
+  // Use more buffers than are passed to a single sendmsg() call.
+  constexpr size_t kBufferCount = 20;
+  std::array<std::byte, kBufferCount> bytes;
+  std::array<ConstByteSpan, kBufferCount> buffers;
+  for (size_t i = 0; i < kBufferCount; ++i) {
+    bytes[i] = static_cast<std::byte>(i);
+    // Every third buffer is empty.
+    buffers[i] = span(bytes).subspan(i, i % 3 == 0 ? 0 : 1);
+  }
+  EXPECT_EQ(client.Write(buffers), OkStatus());
+  client.Close();
+
+  std::array<std::byte, kBufferCount> read_buffer{};
+  size_t total_read = 0;
+  while (true) {
+    Result<ByteSpan> read_result =
+        server_stream->Read(span(read_buffer).subspan(total_read));
+    if (!read_result.ok()) {
+      EXPECT_EQ(read_result.status(), Status::OutOfRange());
+      break;
+    }
+    total_read += read_result->size();
+  }
+
+  ASSERT_EQ(total_read, kBufferCount - 7);
+  size_t read_index = 0;
+  for (size_t i = 0; i < kBufferCount; ++i) {
+    if (i % 3 != 0) {
+      EXPECT_EQ(read_buffer[read_index++], bytes[i]);
+    }
+  }
+
+  server_stream->Close();
+  server.Close();
+}
+
 TEST(SocketStreamTest, MultipleClients) {
   ServerSocket server;
   EXPECT_EQ(server.Listen(), OkStatus());
@@ -14,6 +14,7 @@
 
 #include "pw_stream/stream.h"
 
+#include <array>
 #include <limits>
 
 #include "pw_unit_test/framework.h"
@@ -132,6 +133,8 @@ void TestStreamImpl() {
   ASSERT_EQ(readable ? OkStatus() : Status::Unimplemented(),
             stream.Read({}).status());
   ASSERT_EQ(writable ? OkStatus() : Status::Unimplemented(), stream.Write({}));
+  ASSERT_EQ(writable ? OkStatus() : Status::Unimplemented(),
+            stream.Write(span<const ConstByteSpan>()));
   ASSERT_EQ(seekable ? OkStatus() : Status::Unimplemented(), stream.Seek(0));
 
   // Check ConservativeLimits()
@@ -193,5 +196,46 @@ TEST(Stream, SeekableReaderWriter) {
   TestStreamImpl<TestSeekableReaderWriter, kReadable, kWritable, kSeekable>();
 }
 
+class RecordingWriter : public NonSeekableWriter {
+ public:
+  std::array<size_t, 4> write_sizes{};
+  size_t write_count = 0;
+  Status next_status = OkStatus();
+
+ private:
+  Status DoWrite(ConstByteSpan data) override {
+    write_sizes[write_count++] = data.size();
+    return next_status;
+  }
+};
+
+TEST(Stream, WriteVectoredWritesEachNonEmptyBuffer) {
+  constexpr std::array<std::byte, 6> kData{};
+  const std::array<ConstByteSpan, 4> buffers = {
+      span(kData).first(1),
+      ConstByteSpan(),
+      span(kData).subspan(1, 2),
+      span(kData).subspan(3),
+  };
+
+  RecordingWriter writer;
+  EXPECT_EQ(writer.Write(buffers), OkStatus());
+  ASSERT_EQ(writer.write_count, 3u);
+  EXPECT_EQ(writer.write_sizes[0], 1u);
+  EXPECT_EQ(writer.write_sizes[1], 2u);
+  EXPECT_EQ(writer.write_sizes[2], 3u);
+}
+
+TEST(Stream, WriteVectoredStopsAtFirstError) {
+  constexpr std::array<std::byte, 2> kData{};
+  const std::array<ConstByteSpan, 2> buffers = {span(kData).first(1),
+                                                span(kData).last(1)};
+
+  RecordingWriter writer;
+  writer.next_status = Status::ResourceExhausted();
+  EXPECT_EQ(writer.Write(buffers), Status::ResourceExhausted());
+  EXPECT_EQ(writer.write_count, 1u);
+}
+
 }  // namespace
 }  // namespace pw::stream
@@ -65,6 +65,7 @@ class UartStreamLinux : public NonSeekableReaderWriter {
   static constexpr int kInvalidFd = -1;
 
   Status DoWrite(ConstByteSpan data) override;
+  Status DoWriteVectored(span<const ConstByteSpan> data) override;
   StatusWithSize DoRead(ByteSpan dest) override;
 
   int fd_ = kInvalidFd;
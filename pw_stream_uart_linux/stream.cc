@@ -15,11 +15,15 @@
 #include "pw_stream_uart_linux/stream.h"
 
 #include <fcntl.h>
+#include <sys/uio.h>
 #include <termios.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <cerrno>
 #include <cinttypes>
+#include <cstring>
 
 #include "pw_log/log.h"
 
@@ -137,6 +141,39 @@ Status UartStreamLinux::DoWrite(ConstByteSpan data) {
   return OkStatus();
 }
 
+Status UartStreamLinux::DoWriteVectored(span<const ConstByteSpan> data) {
+  // Write up to this many buffers with each writev() call.
+  constexpr size_t kMaxBuffersPerWrite = 16;
+
+  // The number of bytes of data.front() that have already been written.
+  size_t offset = 0;
+  while (!data.empty()) {
+    std::array<iovec, kMaxBuffersPerWrite> iov;
+    const size_t count = std::min(data.size(), iov.size());
+    for (size_t i = 0; i < count; ++i) {
+      const size_t skip = i == 0 ? offset : 0;
+      // iovec is shared with readv(), so its base is not const.
+      iov[i].iov_base = const_cast<std::byte*>(data[i].data() + skip);
+      iov[i].iov_len = data[i].size_bytes() - skip;
+    }
+
+    const ssize_t bytes = writev(fd_, iov.data(), static_cast<int>(count));
+    if (bytes < 0) {
+      PW_LOG_ERROR("Failed to write to UART, %s", std::strerror(errno));
+      return Status::Unknown();
+    }
+
+    // Drop the buffers that were written completely.
+    size_t written = offset + static_cast<size_t>(bytes);
+    while (!data.empty() && written >= data.front().size_bytes()) {
+      written -= data.front().size_bytes();
+      data = data.subspan(1);
+    }
+    offset = written;
+  }
+  return OkStatus();
+}
+
 StatusWithSize UartStreamLinux::DoRead(ByteSpan dest) {
   int bytes = read(fd_, &dest[0], dest.size_bytes());
   if (bytes < 0) {
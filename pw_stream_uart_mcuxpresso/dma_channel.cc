@@ -0,0 +1,188 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_stream_uart_mcuxpresso/dma_channel.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "pw_assert/check.h"
+#include "pw_status/try.h"
+
+namespace pw::stream {
+
+void UartDmaChannelMcuxpresso::Deinit() {
+  if (!initialized_) {
+    return;
+  }
+
+  {
+    std::lock_guard lock(interrupt_lock_);
+    USART_TransferAbortReceiveDMA(config_.usart_base, &uart_dma_handle_);
+    USART_TransferAbortSendDMA(config_.usart_base, &uart_dma_handle_);
+    tx_dma_.Disable();
+    rx_dma_.Disable();
+  }
+
+  USART_Deinit(config_.usart_base);
+  clock_tree_element_controller_.Release().IgnoreError();
+  initialized_ = false;
+}
+
+UartDmaChannelMcuxpresso::~UartDmaChannelMcuxpresso() { Deinit(); }
+
+Status UartDmaChannelMcuxpresso::Init(uint32_t srcclk) {
+  if (srcclk == 0 || config_.usart_base == nullptr || config_.baud_rate == 0 ||
+      config_.rx_ring.empty()) {
+    return Status::InvalidArgument();
+  }
+
+  usart_config_t defconfig;
+  USART_GetDefaultConfig(&defconfig);
+  defconfig.baudRate_Bps = config_.baud_rate;
+  defconfig.parityMode = config_.parity;
+  defconfig.stopBitCount = config_.stop_bits;
+  defconfig.enableTx = true;
+  defconfig.enableRx = true;
+
+  PW_TRY(clock_tree_element_controller_.Acquire());
+  if (USART_Init(config_.usart_base, &defconfig, srcclk) != kStatus_Success) {
+    clock_tree_element_controller_.Release().IgnoreError();
+    return Status::Internal();
+  }
+
+  tx_dma_.Init();
+  rx_dma_.Init();
+
+  {
+    // The input mux is shared among DMA peripherals. Holding the
+    // interrupt_lock_ gives exclusive access to it on non-SMP systems.
+    std::lock_guard lock(interrupt_lock_);
+    INPUTMUX_Init(INPUTMUX);
+    INPUTMUX_EnableSignal(
+        INPUTMUX, config_.rx_input_mux_dmac_ch_request_en, true);
+    INPUTMUX_EnableSignal(
+        INPUTMUX, config_.tx_input_mux_dmac_ch_request_en, true);
+    INPUTMUX_Deinit(INPUTMUX);
+  }
+
+  tx_dma_.Enable();
+  rx_dma_.Enable();
+
+  if (USART_TransferCreateHandleDMA(config_.usart_base,
+                                    &uart_dma_handle_,
+                                    TxRxCompletionCallback,
+                                    this,
+                                    tx_dma_.handle(),
+                                    rx_dma_.handle()) != kStatus_Success) {
+    tx_dma_.Disable();
+    rx_dma_.Disable();
+    USART_Deinit(config_.usart_base);
+    clock_tree_element_controller_.Release().IgnoreError();
+    return Status::Internal();
+  }
+
+  {
+    std::lock_guard lock(interrupt_lock_);
+    TriggerReadDma();
+  }
+
+  initialized_ = true;
+  return OkStatus();
+}
+
+// Receives the next part of the ring buffer. Transfers never wrap, so the
+// completion callback always advances the write index to the end of the
+// transfer.
+void UartDmaChannelMcuxpresso::TriggerReadDma() {
+  const ByteSpan ring = rx_ring();
+  size_t transfer_size = config_.rx_transfer_size != 0
+                             ? config_.rx_transfer_size
+                             : ring.size() / kUsartRxRingBufferSplitCount;
+  transfer_size = std::clamp<size_t>(
+      transfer_size, 1, std::min(ring.size() / 2, kUsartDmaMaxTransferCount));
+
+  rx_transfer_.data = reinterpret_cast<uint8_t*>(&ring[rx_write_idx_]);
+  rx_transfer_.dataSize = std::min(transfer_size, ring.size() - rx_write_idx_);
+  USART_TransferReceiveDMA(
+      config_.usart_base, &uart_dma_handle_, &rx_transfer_);
+}
+
+Status UartDmaChannelMcuxpresso::TriggerWriteDma() {
+  tx_transfer_.txData =
+      reinterpret_cast<const uint8_t*>(&tx_buffer_[tx_idx_]);
+  tx_transfer_.dataSize =
+      std::min(tx_buffer_.size() - tx_idx_, kUsartDmaMaxTransferCount);
+  if (USART_TransferSendDMA(config_.usart_base,
+                            &uart_dma_handle_,
+                            &tx_transfer_) != kStatus_Success) {
+    return Status::Unavailable();
+  }
+  return OkStatus();
+}
+
+Status UartDmaChannelMcuxpresso::DoStartTransmit(ConstByteSpan data) {
+  std::lock_guard lock(interrupt_lock_);
+  tx_buffer_ = data;
+  tx_idx_ = 0;
+  return TriggerWriteDma();
+}
+
+void UartDmaChannelMcuxpresso::DoUpdateReceiveProgress() {
+  std::lock_guard lock(interrupt_lock_);
+  uint32_t count = 0;
+  // If no transfer is in progress, count remains 0.
+  (void)USART_TransferGetReceiveCountDMA(
+      config_.usart_base, &uart_dma_handle_, &count);
+  // Report progress with the lock held so that a completion callback cannot
+  // report a later position first.
+  ReceiveProgress(rx_write_idx_ + count);
+}
+
+void UartDmaChannelMcuxpresso::TxRxCompletionCallback(
+    USART_Type* /* base */,
+    usart_dma_handle_t* /* state */,
+    status_t status,
+    void* param) {
+  UartDmaChannelMcuxpresso* channel =
+      reinterpret_cast<UartDmaChannelMcuxpresso*>(param);
+
+  if (status == kStatus_USART_RxIdle) {
+    std::lock_guard lock(channel->interrupt_lock_);
+    channel->rx_write_idx_ += channel->rx_transfer_.dataSize;
+    PW_DCHECK_INT_LE(channel->rx_write_idx_, channel->rx_ring().size());
+    if (channel->rx_write_idx_ == channel->rx_ring().size()) {
+      channel->rx_write_idx_ = 0;
+    }
+    channel->TriggerReadDma();
+    channel->ReceiveProgress(channel->rx_write_idx_);
+  } else if (status == kStatus_USART_TxIdle) {
+    Status tx_status;
+    {
+      std::lock_guard lock(channel->interrupt_lock_);
+      channel->tx_idx_ += channel->tx_transfer_.dataSize;
+      if (channel->tx_idx_ < channel->tx_buffer_.size()) {
+        tx_status = channel->TriggerWriteDma();
+        if (tx_status.ok()) {
+          return;
+        }
+      }
+    }
+    // The chunk is sent, or the next transfer failed to start. This may start
+    // the next chunk, so it must not hold the interrupt_lock_.
+    channel->TransmitComplete(tx_status);
+  }
+}
+
+}  // namespace pw::stream
@@ -0,0 +1,111 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "fsl_inputmux.h"
+#include "fsl_usart_dma.h"
+#include "pw_bytes/span.h"
+#include "pw_clock_tree/clock_tree.h"
+#include "pw_dma_mcuxpresso/dma.h"
+#include "pw_multibuf/allocator.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_uart/uart_dma_channel.h"
+
+namespace pw::stream {
+
+// A UART byte channel that receives continuously with DMA into a ring buffer
+// and transmits each written MultiBuf chunk with DMA.
+//
+// The Flexcomm USART cannot interrupt when the receive line goes idle, so
+// received data is reported to readers whenever a receive DMA transfer of
+// `rx_transfer_size` bytes completes, and whenever a reader polls the channel.
+// Smaller transfers wake readers sooner at the cost of more interrupts.
+class UartDmaChannelMcuxpresso final : public uart::UartDmaChannel {
+ public:
+  // Configuration structure
+  struct Config {
+    USART_Type* usart_base;            // Base of USART control struct
+    uint32_t baud_rate;                // Desired communication speed
+    usart_parity_mode_t parity;        // Parity setting
+    usart_stop_bit_count_t stop_bits;  // Number of stop bits to use
+    inputmux_signal_t rx_input_mux_dmac_ch_request_en;  // Rx input mux signal
+    inputmux_signal_t tx_input_mux_dmac_ch_request_en;  // Tx input mux signal
+    ByteSpan rx_ring;                         // Receive ring buffer
+    size_t rx_transfer_size{};                // Defaults to 1/4 of rx_ring
+    pw::clock_tree::ClockTree* clock_tree{};  // Optional clock Tree
+    pw::clock_tree::Element*
+        clock_tree_element{};  // Optional clock tree element
+  };
+
+  // The DMA channels must have static lifetime; see McuxpressoDmaChannel.
+  UartDmaChannelMcuxpresso(dma::McuxpressoDmaChannel& tx_dma,
+                           dma::McuxpressoDmaChannel& rx_dma,
+                           multibuf::MultiBufAllocator& allocator,
+                           const Config& config)
+      : UartDmaChannel(config.rx_ring, allocator),
+        tx_dma_(tx_dma),
+        rx_dma_(rx_dma),
+        config_(config),
+        clock_tree_element_controller_(config.clock_tree,
+                                       config.clock_tree_element) {}
+
+  ~UartDmaChannelMcuxpresso();
+
+  pw::Status Init(uint32_t srcclk);
+
+ private:
+  // Since we are calling USART_TransferGetReceiveCountDMA we may only
+  // transfer DMA_MAX_TRANSFER_COUNT - 1 bytes per DMA transfer.
+  static constexpr size_t kUsartDmaMaxTransferCount =
+      DMA_MAX_TRANSFER_COUNT - 1;
+
+  // Receive at least this often so that a reader that keeps up never loses
+  // data.
+  static constexpr size_t kUsartRxRingBufferSplitCount = 4;
+
+  // pw::uart::UartDmaChannel implementation.
+  Status DoStartTransmit(ConstByteSpan data) override;
+  void DoUpdateReceiveProgress() override;
+
+  void Deinit();
+  void TriggerReadDma() PW_EXCLUSIVE_LOCKS_REQUIRED(interrupt_lock_);
+  Status TriggerWriteDma() PW_EXCLUSIVE_LOCKS_REQUIRED(interrupt_lock_);
+  static void TxRxCompletionCallback(USART_Type* base,
+                                     usart_dma_handle_t* state,
+                                     status_t status,
+                                     void* param);
+
+  dma::McuxpressoDmaChannel& tx_dma_;
+  dma::McuxpressoDmaChannel& rx_dma_;
+
+  // Lock to synchronize with the interrupt handler and to guarantee exclusive
+  // access to DMA control registers.
+  pw::sync::InterruptSpinLock interrupt_lock_;
+  usart_dma_handle_t uart_dma_handle_;
+
+  // The chunk being transmitted, which may take several DMA transfers.
+  ConstByteSpan tx_buffer_ PW_GUARDED_BY(interrupt_lock_);
+  size_t tx_idx_ PW_GUARDED_BY(interrupt_lock_) = 0;
+  usart_transfer_t tx_transfer_ PW_GUARDED_BY(interrupt_lock_){};
+
+  size_t rx_write_idx_ PW_GUARDED_BY(interrupt_lock_) = 0;
+  usart_transfer_t rx_transfer_ PW_GUARDED_BY(interrupt_lock_){};
+
+  Config const config_;
+  pw::clock_tree::ElementController clock_tree_element_controller_;
+  bool initialized_ = false;
+};
+
+}  // namespace pw::stream
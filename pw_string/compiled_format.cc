@@ -0,0 +1,180 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/compiled_format.h"
+
+#include <array>
+
+#include "pw_preprocessor/compiler.h"
+#include "pw_string/type_to_string.h"
+#include "pw_string/util.h"
+
+namespace pw::string::internal {
+namespace {
+
+bool HasFlag(const FormatSegment& spec, FormatSegment::Flag flag) {
+  return (spec.flags & flag) != 0;
+}
+
+// Returns the number of spaces needed to pad text to the field width.
+size_t Padding(size_t length, const FormatSegment& spec) {
+  const size_t width = spec.width < 0 ? 0 : static_cast<size_t>(spec.width);
+  return width > length ? width - length : 0;
+}
+
+}  // namespace
+
+void AppendInteger(StringBuilder& out,
+                   uint64_t magnitude,
+                   bool negative,
+                   const FormatSegment& spec) {
+  uint64_t base = 10;
+  const char* digit_chars = "0123456789abcdef";
+  if (spec.conversion == 'o') {
+    base = 8;
+  } else if (spec.conversion == 'x') {
+    base = 16;
+  } else if (spec.conversion == 'X') {
+    base = 16;
+    digit_chars = "0123456789ABCDEF";
+  }
+
+  // Octal needs the most digits, 22 for a 64-bit value.
+  std::array<char, 22> digits;
+  size_t digit_count = 0;
+  for (uint64_t value = magnitude; value != 0; value /= base) {
+    digit_count += 1;
+    digits[digits.size() - digit_count] = digit_chars[value % base];
+  }
+
+  // The precision is the minimum number of digits. A zero value with a
+  // precision of zero has no digits.
+  size_t min_digits =
+      spec.precision < 0 ? 1 : static_cast<size_t>(spec.precision);
+  if (base == 8 && HasFlag(spec, FormatSegment::kAlternate) &&
+      min_digits <= digit_count) {
+    min_digits = digit_count + 1;  // '#' ensures a leading zero.
+  }
+
+  std::array<char, 2> prefix;
+  size_t prefix_size = 0;
+  if (negative) {
+    prefix[prefix_size++] = '-';
+  } else if (spec.conversion == 'd' || spec.conversion == 'i') {
+    if (HasFlag(spec, FormatSegment::kPlusSign)) {
+      prefix[prefix_size++] = '+';
+    } else if (HasFlag(spec, FormatSegment::kSpaceSign)) {
+      prefix[prefix_size++] = ' ';
+    }
+  } else if (base == 16 && HasFlag(spec, FormatSegment::kAlternate) &&
+             magnitude != 0) {
+    prefix[prefix_size++] = '0';
+    prefix[prefix_size++] = spec.conversion;
+  }
+
+  size_t zeros = min_digits > digit_count ? min_digits - digit_count : 0;
+  size_t padding = Padding(prefix_size + zeros + digit_count, spec);
+  const bool left_justify = HasFlag(spec, FormatSegment::kLeftJustify);
+  if (HasFlag(spec, FormatSegment::kZeroPad) && !left_justify &&
+      spec.precision < 0) {
+    zeros += padding;
+    padding = 0;
+  }
+
+  if (!left_justify) {
+    out.append(padding, ' ');
+  }
+  out.append(prefix.data(), prefix_size);
+  out.append(zeros, '0');
+  out.append(digits.data() + digits.size() - digit_count, digit_count);
+  if (left_justify) {
+    out.append(padding, ' ');
+  }
+}
+
+void AppendPadded(StringBuilder& out,
+                  std::string_view text,
+                  const FormatSegment& spec) {
+  if (spec.conversion == 's' && spec.precision >= 0) {
+    text = text.substr(0, static_cast<size_t>(spec.precision));
+  }
+  const size_t padding = Padding(text.size(), spec);
+  const bool left_justify = HasFlag(spec, FormatSegment::kLeftJustify);
+  if (!left_justify) {
+    out.append(padding, ' ');
+  }
+  out.append(text);
+  if (left_justify) {
+    out.append(padding, ' ');
+  }
+}
+
+void AppendCString(StringBuilder& out,
+                   const char* text,
+                   const FormatSegment& spec) {
+  if (text == nullptr) {
+    AppendPadded(out, kNullPointerString, spec);
+    return;
+  }
+  // With a precision, the string need not be null-terminated. Without one,
+  // reading one more character than fits is enough to detect truncation.
+  const size_t max_length = spec.precision < 0
+                                ? out.max_size() + 1
+                                : static_cast<size_t>(spec.precision);
+  AppendPadded(out, ClampedCString(text, max_length), spec);
+}
+
+void AppendPointer(StringBuilder& out,
+                   uintptr_t address,
+                   const FormatSegment& spec) {
+  std::array<char, 2 + 2 * sizeof(uintptr_t)> text = {'0', 'x'};
+  const size_t digits = HexDigitCount(address);
+  for (size_t i = 0; i < digits; ++i) {
+    text[1 + digits - i] = "0123456789abcdef"[(address >> (4 * i)) & 0xF];
+  }
+  AppendPadded(out, std::string_view(text.data(), 2 + digits), spec);
+}
+
+void AppendFloat(StringBuilder& out, double value, const FormatSegment& spec) {
+  // Floating point conversions are delegated to vsnprintf, with a format
+  // string for just this conversion.
+  StringBuffer<24> format;
+  format.push_back('%');
+  constexpr std::array<std::pair<FormatSegment::Flag, char>, 5> kFlags = {{
+      {FormatSegment::kLeftJustify, '-'},
+      {FormatSegment::kPlusSign, '+'},
+      {FormatSegment::kSpaceSign, ' '},
+      {FormatSegment::kAlternate, '#'},
+      {FormatSegment::kZeroPad, '0'},
+  }};
+  for (const auto& [flag, character] : kFlags) {
+    if (HasFlag(spec, flag)) {
+      format.push_back(character);
+    }
+  }
+  if (spec.width >= 0) {
+    format << spec.width;
+  }
+  if (spec.precision >= 0) {
+    format << '.' << spec.precision;
+  }
+  format.push_back(spec.conversion);
+
+  PW_MODIFY_DIAGNOSTICS_PUSH();
+  PW_MODIFY_DIAGNOSTIC(ignored, "-Wformat-nonliteral");
+  out.Format(format.c_str(), value);
+  PW_MODIFY_DIAGNOSTICS_POP();
+}
+
+}  // namespace pw::string::internal
@@ -0,0 +1,222 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_string/compiled_format.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+#include "pw_compilation_testing/negative_compilation.h"
+#include "pw_span/span.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::string {
+namespace {
+
+// Checks that PW_STRING_FORMAT matches snprintf for the same arguments.
+#define EXPECT_FORMAT_MATCHES(format, ...)                                 \
+  do {                                                                     \
+    char expected[64];                                                     \
+    std::snprintf(expected, sizeof(expected), format, __VA_ARGS__);        \
+    char actual[64];                                                       \
+    StatusWithSize result = PW_STRING_FORMAT(actual, format, __VA_ARGS__); \
+    EXPECT_EQ(OkStatus(), result.status());                                \
+    EXPECT_EQ(std::string_view(expected).size(), result.size());           \
+    EXPECT_STREQ(expected, actual);                                        \
+  } while (0)
+
+TEST(CompiledFormat, LiteralText) {
+  char buffer[32];
+  StatusWithSize result = PW_STRING_FORMAT(buffer, "-_-");
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(3u, result.size());
+  EXPECT_STREQ("-_-", buffer);
+}
+
+TEST(CompiledFormat, PercentSign) {
+  char buffer[32];
+  StatusWithSize result = PW_STRING_FORMAT(buffer, "100%% of %d%%", 5);
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_STREQ("100% of 5%", buffer);
+}
+
+TEST(CompiledFormat, SignedIntegers) {
+  EXPECT_FORMAT_MATCHES("%d4%s", 123, "5");
+  EXPECT_FORMAT_MATCHES("%d|%i", -1, 0);
+  EXPECT_FORMAT_MATCHES("%d", INT32_MIN);
+  EXPECT_FORMAT_MATCHES("%lld", static_cast<long long>(INT64_MIN));
+  EXPECT_FORMAT_MATCHES("%+d|% d|%+d", 7, 7, -7);
+  EXPECT_FORMAT_MATCHES("[%5d][%-5d][%05d]", -42, -42, -42);
+  EXPECT_FORMAT_MATCHES("[%.3d][%8.3d][%-8.3d]", 7, -7, 7);
+  EXPECT_FORMAT_MATCHES("[%.0d][%3.0d]", 0, 0);
+}
+
+TEST(CompiledFormat, UnsignedIntegers) {
+  EXPECT_FORMAT_MATCHES("%u|%u", 0u, UINT32_MAX);
+  EXPECT_FORMAT_MATCHES("%llu", static_cast<unsigned long long>(UINT64_MAX));
+  EXPECT_FORMAT_MATCHES("%x|%X|%o", 0xbeefu, 0xbeefu, 8u);
+  EXPECT_FORMAT_MATCHES("%#x|%#X|%#o|%#o|%#x", 255u, 255u, 8u, 0u, 0u);
+  EXPECT_FORMAT_MATCHES("[%#10x][%#010x][%-#10x]", 255u, 255u, 255u);
+  EXPECT_FORMAT_MATCHES("[%.4x][%#.4o]", 31u, 31u);
+  EXPECT_FORMAT_MATCHES("%lo", static_cast<unsigned long>(UINT64_MAX));
+}
+
+TEST(CompiledFormat, NegativeValueAsUnsigned) {
+  EXPECT_FORMAT_MATCHES("%u|%x", -1, -2);
+}
+
+TEST(CompiledFormat, LengthModifiers) {
+  EXPECT_FORMAT_MATCHES("%hhd|%hhu|%hhx", 300, 300, -1);
+  EXPECT_FORMAT_MATCHES("%hd|%hu|%hx", 70000, 70000, -1);
+  EXPECT_FORMAT_MATCHES("%zu|%ld", sizeof(int), -5L);
+}
+
+TEST(CompiledFormat, Characters) {
+  EXPECT_FORMAT_MATCHES("%c%c|%3c|%-3c|", 'h', 'i', 'x', 'y');
+}
+
+TEST(CompiledFormat, Strings) {
+  EXPECT_FORMAT_MATCHES("%s|%8s|%-8s|", "abc", "def", "ghi");
+  EXPECT_FORMAT_MATCHES("%.2s|%5.1s|%.0s|", "abc", "def", "ghi");
+}
+
+TEST(CompiledFormat, StringPrecision_DoesNotReadPastPrecision) {
+  const char unterminated[] = {'a', 'b', 'c'};
+  char buffer[32];
+  StatusWithSize result = PW_STRING_FORMAT(buffer, "%.3s", unterminated);
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_STREQ("abc", buffer);
+}
+
+TEST(CompiledFormat, StringView) {
+  constexpr std::string_view kText = "hello world";
+  char buffer[32];
+  StatusWithSize result =
+      PW_STRING_FORMAT(buffer, "[%s][%7.5s]", kText.substr(6), kText);
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_STREQ("[world][  hello]", buffer);
+}
+
+TEST(CompiledFormat, NullString) {
+  const char* null_string = nullptr;
+  char buffer[32];
+  StatusWithSize result = PW_STRING_FORMAT(buffer, "%s", null_string);
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_STREQ("(null)", buffer);
+}
+
+TEST(CompiledFormat, Pointers) {
+  char buffer[32];
+  StatusWithSize result = PW_STRING_FORMAT(buffer,
+                                           "%p|%p|%6p",
+                                           reinterpret_cast<void*>(0xbeef),
+                                           nullptr,
+                                           reinterpret_cast<int*>(0x1));
+
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_STREQ("0xbeef|0x0|   0x1", buffer);
+}
+
+TEST(CompiledFormat, FloatingPoint) {
+  EXPECT_FORMAT_MATCHES("%f|%.2f|%8.3f|%-8.1e|", 1.5, 2.125, -3.0, 1e10);
+  EXPECT_FORMAT_MATCHES("%+g|%G|%#.0f|%010.4f", 0.25f, 1e-20, 3.0, -1.5);
+}
+
+TEST(CompiledFormat, FormatLargerThanBuffer_ReturnsResourceExhausted) {
+  char buffer[5];
+  StatusWithSize result = PW_STRING_FORMAT(buffer, "2big!");
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(4u, result.size());
+  EXPECT_STREQ("2big", buffer);
+}
+
+TEST(CompiledFormat, ArgumentLargerThanBuffer_ReturnsResourceExhausted) {
+  char buffer[5];
+  StatusWithSize result = PW_STRING_FORMAT(buffer, "%d", 123456);
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(4u, result.size());
+  EXPECT_STREQ("1234", buffer);
+}
+
+TEST(CompiledFormat, EmptyBuffer_ReturnsResourceExhausted) {
+  StatusWithSize result = PW_STRING_FORMAT(span<char>(), "?");
+
+  EXPECT_EQ(Status::ResourceExhausted(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST(CompiledFormat, StringBuilder_Appends) {
+  StringBuffer<32> builder;
+  builder << "x=";
+  PW_STRING_BUILDER_FORMAT(builder, "%d, y=%s", 1, "2") << '!';
+
+  EXPECT_EQ(OkStatus(), builder.status());
+  EXPECT_STREQ("x=1, y=2!", builder.c_str());
+}
+
+TEST(CompiledFormat, StringBuilder_Truncates) {
+  StringBuffer<4> builder;
+  PW_STRING_BUILDER_FORMAT(builder, "%s", "too long");
+
+  EXPECT_EQ(Status::ResourceExhausted(), builder.status());
+  EXPECT_STREQ("too", builder.c_str());
+}
+
+#if PW_NC_TEST(TooFewArguments)
+PW_NC_EXPECT("number of arguments does not match");
+[[maybe_unused]] void ShouldAssert(span<char> buffer) {
+  PW_STRING_FORMAT(buffer, "%d %d", 1);
+}
+#elif PW_NC_TEST(TooManyArguments)
+PW_NC_EXPECT("number of arguments does not match");
+[[maybe_unused]] void ShouldAssert(span<char> buffer) {
+  PW_STRING_FORMAT(buffer, "%d", 1, 2);
+}
+#elif PW_NC_TEST(MismatchedArgumentType)
+PW_NC_EXPECT("type does not match its conversion");
+[[maybe_unused]] void ShouldAssert(span<char> buffer) {
+  PW_STRING_FORMAT(buffer, "%s", 1);
+}
+#elif PW_NC_TEST(FloatForInteger)
+PW_NC_EXPECT("type does not match its conversion");
+[[maybe_unused]] void ShouldAssert(StringBuilder& builder) {
+  PW_STRING_BUILDER_FORMAT(builder, "%d", 1.5);
+}
+#elif PW_NC_TEST(ArgumentWidth)
+PW_NC_EXPECT("Width and precision must be in the format string");
+[[maybe_unused]] void ShouldAssert(span<char> buffer) {
+  PW_STRING_FORMAT(buffer, "%*d", 3, 1);
+}
+#elif PW_NC_TEST(UnsupportedConversion)
+PW_NC_EXPECT("unsupported conversion");
+[[maybe_unused]] void ShouldAssert(span<char> buffer) {
+  PW_STRING_FORMAT(buffer, "%n", nullptr);
+}
+#elif PW_NC_TEST(IncompleteConversion)
+PW_NC_EXPECT("incomplete conversion");
+[[maybe_unused]] void ShouldAssert(span<char> buffer) {
+  PW_STRING_FORMAT(buffer, "100%");
+}
+#endif  // PW_NC_TEST
+
+}  // namespace
+}  // namespace pw::string
@@ -0,0 +1,768 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Shortest round-trip floating point to string conversion.
+//
+// This is an implementation of the Ryu algorithm, described in Ulf Adams,
+// "Ryū: fast float-to-string conversion", PLDI 2018, and published at
+// https://github.com/ulfjack/ryu under the Apache 2.0 license. Ryu finds the
+// shortest decimal that rounds to the same binary floating point value using
+// only fixed-size integer arithmetic, so it needs no dynamic memory and only a
+// few words of stack.
+//
+// To reduce code size, the double-precision tables are compressed: only every
+// 26th power of 5 is stored, and the powers in between are computed by
+// multiplying with a small power of 5 (5^0 through 5^25). The 2-bit offsets
+// correct the rounding error of that multiplication, so the computed values
+// exactly match the full tables.
+//
+// The tables may be regenerated with arbitrary-precision integers:
+//
+//   pow5_split(i, bits)     = 5^i >> (bit_length(5^i) - bits)
+//   pow5_inv_split(i, bits) = 2^(bit_length(5^i) - 1 + bits) // 5^i + 1
+//
+// The float tables use 59 bits for inverse powers and 61 bits for powers. The
+// double tables use 125 bits for both.
+
+#include <cstdint>
+#include <cstring>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_string/type_to_string.h"
+
+namespace pw::string {
+namespace {
+
+// A binary floating point number converted to digits * 10^exponent.
+struct Decimal {
+  uint64_t digits;
+  int32_t exponent;
+};
+
+// Returns ceil(log_2(5^e)), or 1 if e is 0. Valid for 0 <= e <= 3528.
+constexpr int32_t Pow5Bits(int32_t e) {
+  return static_cast<int32_t>((static_cast<uint32_t>(e) * 1217359u) >> 19) + 1;
+}
+
+// Returns floor(log_10(2^e)). Valid for 0 <= e <= 1650.
+constexpr int32_t Log10Pow2(int32_t e) {
+  return static_cast<int32_t>((static_cast<uint32_t>(e) * 78913u) >> 18);
+}
+
+// Returns floor(log_10(5^e)). Valid for 0 <= e <= 2620.
+constexpr int32_t Log10Pow5(int32_t e) {
+  return static_cast<int32_t>((static_cast<uint32_t>(e) * 732923u) >> 20);
+}
+
+template <typename T>
+constexpr bool MultipleOfPowerOf5(T value, int32_t p) {
+  int32_t count = 0;
+  while (value % 5 == 0) {
+    value /= 5;
+    count += 1;
+  }
+  return count >= p;
+}
+
+template <typename T>
+constexpr bool MultipleOfPowerOf2(T value, int32_t p) {
+  return (value & ((T{1} << p) - 1)) == 0;
+}
+
+// Single precision
+
+constexpr int32_t kFloatMantissaBits = 23;
+constexpr int32_t kFloatBias = 127;
+constexpr int32_t kFloatPow5InvBitCount = 59;
+constexpr int32_t kFloatPow5BitCount = 61;
+
+constexpr uint64_t kFloatPow5InvSplit[31] = {
+    0x0800000000000001u,
+    0x0666666666666667u,
+    0x051eb851eb851eb9u,
+    0x04189374bc6a7efau,
+    0x068db8bac710cb2au,
+    0x053e2d6238da3c22u,
+    0x0431bde82d7b634eu,
+    0x06b5fca6af2bd216u,
+    0x055e63b88c230e78u,
+    0x044b82fa09b5a52du,
+    0x06df37f675ef6eaeu,
+    0x057f5ff85e592558u,
+    0x0465e6604b7a8447u,
+    0x0709709a125da071u,
+    0x05a126e1a84ae6c1u,
+    0x0480ebe7b9d58567u,
+    0x0734aca5f6226f0bu,
+    0x05c3bd5191b525a3u,
+    0x049c97747490eae9u,
+    0x0760f253edb4ab0eu,
+    0x05e72843249088d8u,
+    0x04b8ed0283a6d3e0u,
+    0x078e480405d7b966u,
+    0x060b6cd004ac9452u,
+    0x04d5f0a66a23a9dbu,
+    0x07bcb43d769f762bu,
+    0x063090312bb2c4efu,
+    0x04f3a68dbc8f03f3u,
+    0x07ec3daf94180651u,
+    0x065697bfa9acd1dau,
+    0x051212ffbaf0a7e2u,
+};
+
+constexpr uint64_t kFloatPow5Split[47] = {
+    0x1000000000000000u,
+    0x1400000000000000u,
+    0x1900000000000000u,
+    0x1f40000000000000u,
+    0x1388000000000000u,
+    0x186a000000000000u,
+    0x1e84800000000000u,
+    0x1312d00000000000u,
+    0x17d7840000000000u,
+    0x1dcd650000000000u,
+    0x12a05f2000000000u,
+    0x174876e800000000u,
+    0x1d1a94a200000000u,
+    0x12309ce540000000u,
+    0x16bcc41e90000000u,
+    0x1c6bf52634000000u,
+    0x11c37937e0800000u,
+    0x16345785d8a00000u,
+    0x1bc16d674ec80000u,
+    0x1158e460913d0000u,
+    0x15af1d78b58c4000u,
+    0x1b1ae4d6e2ef5000u,
+    0x10f0cf064dd59200u,
+    0x152d02c7e14af680u,
+    0x1a784379d99db420u,
+    0x108b2a2c28029094u,
+    0x14adf4b7320334b9u,
+    0x19d971e4fe8401e7u,
+    0x1027e72f1f128130u,
+    0x1431e0fae6d7217cu,
+    0x193e5939a08ce9dbu,
+    0x1f8def8808b02452u,
+    0x13b8b5b5056e16b3u,
+    0x18a6e32246c99c60u,
+    0x1ed09bead87c0378u,
+    0x13426172c74d822bu,
+    0x1812f9cf7920e2b6u,
+    0x1e17b84357691b64u,
+    0x12ced32a16a1b11eu,
+    0x178287f49c4a1d66u,
+    0x1d6329f1c35ca4bfu,
+    0x125dfa371a19e6f7u,
+    0x16f578c4e0a060b5u,
+    0x1cb2d6f618c878e3u,
+    0x11efc659cf7d4b8du,
+    0x166bb7f0435c9e71u,
+    0x1c06a5ec5433c60du,
+};
+// Returns (m * factor) >> shift. shift must be greater than 32.
+uint32_t MulShift32(uint32_t m, uint64_t factor, int32_t shift) {
+  const uint64_t bits0 = uint64_t{m} * static_cast<uint32_t>(factor);
+  const uint64_t bits1 = uint64_t{m} * (factor >> 32);
+  const uint64_t sum = (bits0 >> 32) + bits1;
+  return static_cast<uint32_t>(sum >> (shift - 32));
+}
+
+Decimal FloatToDecimal(uint32_t ieee_mantissa, uint32_t ieee_exponent) {
+  int32_t e2;
+  uint32_t m2;
+  if (ieee_exponent == 0) {  // Subnormal
+    e2 = 1 - kFloatBias - kFloatMantissaBits - 2;
+    m2 = ieee_mantissa;
+  } else {
+    e2 = static_cast<int32_t>(ieee_exponent) - kFloatBias -
+         kFloatMantissaBits - 2;
+    m2 = (1u << kFloatMantissaBits) | ieee_mantissa;
+  }
+  const bool accept_bounds = (m2 & 1) == 0;
+
+  // Step 2: Determine the interval of valid decimal representations.
+  const uint32_t mv = 4 * m2;
+  const uint32_t mp = 4 * m2 + 2;
+  const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1 ? 1 : 0;
+  const uint32_t mm = 4 * m2 - 1 - mm_shift;
+
+  // Step 3: Convert to a decimal power base.
+  uint32_t vr;
+  uint32_t vp;
+  uint32_t vm;
+  int32_t e10;
+  bool vm_is_trailing_zeros = false;
+  bool vr_is_trailing_zeros = false;
+  uint32_t last_removed_digit = 0;
+
+  if (e2 >= 0) {
+    const int32_t q = Log10Pow2(e2);
+    e10 = q;
+    const int32_t k = kFloatPow5InvBitCount + Pow5Bits(q) - 1;
+    const int32_t i = -e2 + q + k;
+    vr = MulShift32(mv, kFloatPow5InvSplit[q], i);
+    vp = MulShift32(mp, kFloatPow5InvSplit[q], i);
+    vm = MulShift32(mm, kFloatPow5InvSplit[q], i);
+    if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+      // The loop below removes no digits, so compute the last removed digit
+      // here to round correctly.
+      const int32_t l = kFloatPow5InvBitCount + Pow5Bits(q - 1) - 1;
+      last_removed_digit =
+          MulShift32(mv, kFloatPow5InvSplit[q - 1], -e2 + q - 1 + l) % 10;
+    }
+    if (q <= 9) {
+      // Only one of mp, mv, and mm can be a multiple of 5, if any.
+      if (mv % 5 == 0) {
+        vr_is_trailing_zeros = MultipleOfPowerOf5(mv, q);
+      } else if (accept_bounds) {
+        vm_is_trailing_zeros = MultipleOfPowerOf5(mm, q);
+      } else {
+        vp -= MultipleOfPowerOf5(mp, q) ? 1 : 0;
+      }
+    }
+  } else {
+    const int32_t q = Log10Pow5(-e2);
+    e10 = q + e2;
+    const int32_t i = -e2 - q;
+    const int32_t k = Pow5Bits(i) - kFloatPow5BitCount;
+    int32_t j = q - k;
+    vr = MulShift32(mv, kFloatPow5Split[i], j);
+    vp = MulShift32(mp, kFloatPow5Split[i], j);
+    vm = MulShift32(mm, kFloatPow5Split[i], j);
+    if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+      j = q - 1 - (Pow5Bits(i + 1) - kFloatPow5BitCount);
+      last_removed_digit = MulShift32(mv, kFloatPow5Split[i + 1], j) % 10;
+    }
+    if (q <= 1) {
+      // mv has at least q trailing 0 bits, since it is a multiple of 4.
+      vr_is_trailing_zeros = true;
+      if (accept_bounds) {
+        vm_is_trailing_zeros = mm_shift == 1;
+      } else {
+        vp -= 1;
+      }
+    } else if (q < 31) {
+      vr_is_trailing_zeros = MultipleOfPowerOf2(mv, q - 1);
+    }
+  }
+
+  // Step 4: Find the shortest decimal representation in the interval.
+  int32_t removed = 0;
+  uint32_t output;
+  if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+    // General case, which happens rarely.
+    while (vp / 10 > vm / 10) {
+      vm_is_trailing_zeros &= vm % 10 == 0;
+      vr_is_trailing_zeros &= last_removed_digit == 0;
+      last_removed_digit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      removed += 1;
+    }
+    if (vm_is_trailing_zeros) {
+      while (vm % 10 == 0) {
+        vr_is_trailing_zeros &= last_removed_digit == 0;
+        last_removed_digit = vr % 10;
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        removed += 1;
+      }
+    }
+    if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+      last_removed_digit = 4;  // Round even if the number ends in exactly .5.
+    }
+    output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) ||
+                           last_removed_digit >= 5
+                       ? 1
+                       : 0);
+  } else {
+    // Specialized for the common case.
+    while (vp / 10 > vm / 10) {
+      last_removed_digit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      removed += 1;
+    }
+    output = vr + (vr == vm || last_removed_digit >= 5 ? 1 : 0);
+  }
+  return {output, e10 + removed};
+}
+
+// Double precision
+
+constexpr int32_t kDoubleMantissaBits = 52;
+constexpr int32_t kDoubleBias = 1023;
+constexpr int32_t kDoublePow5InvBitCount = 125;
+constexpr int32_t kDoublePow5BitCount = 125;
+
+constexpr uint32_t kPow5TableSize = 26;
+
+constexpr uint64_t kPow5Table[kPow5TableSize] = {
+    1u,
+    5u,
+    25u,
+    125u,
+    625u,
+    3125u,
+    15625u,
+    78125u,
+    390625u,
+    1953125u,
+    9765625u,
+    48828125u,
+    244140625u,
+    1220703125u,
+    6103515625u,
+    30517578125u,
+    152587890625u,
+    762939453125u,
+    3814697265625u,
+    19073486328125u,
+    95367431640625u,
+    476837158203125u,
+    2384185791015625u,
+    11920928955078125u,
+    59604644775390625u,
+    298023223876953125u,
+};
+
+constexpr uint64_t kDoublePow5Split2[13][2] = {
+    {0x0000000000000000u, 0x1000000000000000u},
+    {0x0000000000000000u, 0x14adf4b7320334b9u},
+    {0x0e549208b31adb10u, 0x1aba4714957d300du},
+    {0x6dc6ad264d8f0866u, 0x1145b7e285bf98f5u},
+    {0xeb1dbd923d8596cau, 0x1652efdc6018a1fcu},
+    {0xb4c1b80b22ae923cu, 0x1cda62055b2d9d83u},
+    {0x5bb28b4e8f7e4c30u, 0x12a5568b9f52f416u},
+    {0xf08aed437682d4fbu, 0x1819651531f9e78fu},
+    {0xb4ee134ad99bf150u, 0x1f25c186a6f04c28u},
+    {0x16499ecb70c25f03u, 0x1420eb449c8842e6u},
+    {0x85a56ead360865b0u, 0x1a03fde214caf085u},
+    {0x093db1d57999890bu, 0x10cfeb353a97dad8u},
+    {0xcf38bb735e3f36acu, 0x15baaf44fa52673eu},
+};
+
+constexpr uint32_t kPow5Offsets[21] = {
+    0x00000000u,
+    0x00000000u,
+    0x00000000u,
+    0x00000000u,
+    0x40000000u,
+    0x59695995u,
+    0x55545555u,
+    0x56555515u,
+    0x41150504u,
+    0x40555410u,
+    0x44555145u,
+    0x44504540u,
+    0x45555550u,
+    0x40004000u,
+    0x96440440u,
+    0x55565565u,
+    0x54454045u,
+    0x40154151u,
+    0x55559155u,
+    0x51405555u,
+    0x00000105u,
+};
+
+constexpr uint64_t kDoublePow5InvSplit2[13][2] = {
+    {0x0000000000000001u, 0x2000000000000000u},
+    {0x52a6c95fc0655034u, 0x18c240c4aecb13bbu},
+    {0x7ca8d50071dfc806u, 0x1327fc58da0f6ff5u},
+    {0x6520247d3556476eu, 0x1da48ce468e7c702u},
+    {0x6139cdd76802e6e9u, 0x16ef5b40c2fc7779u},
+    {0xf951a7ff43de8c79u, 0x11bebdf578b2f391u},
+    {0x7be8bee8d6e957e8u, 0x1b758d848fac54b0u},
+    {0x8bd3f9e999a423eau, 0x153eda614071a3b7u},
+    {0x0848f973cb3ee3ceu, 0x10701bd527b4978cu},
+    {0x153285ebb9efbfa2u, 0x196fbb9bb44db44du},
+    {0xadeee7f86c07b696u, 0x13ae3591f5b4d936u},
+    {0x4d686a4eaf182222u, 0x1e74404f3daada91u},
+    {0x98c0a106e09ebd9fu, 0x17900ea4fda7c257u},
+};
+
+constexpr uint32_t kPow5InvOffsets[19] = {
+    0x54544554u,
+    0x04055545u,
+    0x10041000u,
+    0x00400414u,
+    0x40010000u,
+    0x41155555u,
+    0x00000454u,
+    0x00010044u,
+    0x40000000u,
+    0x44000041u,
+    0x50454450u,
+    0x55550054u,
+    0x51655554u,
+    0x40004000u,
+    0x01000001u,
+    0x00010500u,
+    0x51515411u,
+    0x05555554u,
+    0x00000000u,
+};
+
+// Returns the 128-bit product of a and b.
+uint64_t UMul128(uint64_t a, uint64_t b, uint64_t& product_high) {
+#ifdef __SIZEOF_INT128__
+  const unsigned __int128 product =
+      static_cast<unsigned __int128>(a) * static_cast<unsigned __int128>(b);
+  product_high = static_cast<uint64_t>(product >> 64);
+  return static_cast<uint64_t>(product);
+#else
+  const uint64_t a_lo = static_cast<uint32_t>(a);
+  const uint64_t a_hi = a >> 32;
+  const uint64_t b_lo = static_cast<uint32_t>(b);
+  const uint64_t b_hi = b >> 32;
+
+  const uint64_t b00 = a_lo * b_lo;
+  const uint64_t b01 = a_lo * b_hi;
+  const uint64_t b10 = a_hi * b_lo;
+  const uint64_t b11 = a_hi * b_hi;
+
+  const uint64_t mid1 = b10 + (b00 >> 32);
+  const uint64_t mid2 = b01 + static_cast<uint32_t>(mid1);
+
+  product_high = b11 + (mid1 >> 32) + (mid2 >> 32);
+  return (mid2 << 32) | static_cast<uint32_t>(b00);
+#endif  // __SIZEOF_INT128__
+}
+
+// Shifts a 128-bit value right. Requires 0 < distance < 64.
+constexpr uint64_t ShiftRight128(uint64_t low,
+                                 uint64_t high,
+                                 uint32_t distance) {
+  return (high << (64 - distance)) | (low >> distance);
+}
+
+// Computes 5^i in the form used by Ryu, equivalent to pow5_split(i, 125).
+void ComputePow5(uint32_t i, uint64_t (&result)[2]) {
+  const uint32_t base = i / kPow5TableSize;
+  const uint32_t base2 = base * kPow5TableSize;
+  const uint32_t offset = i - base2;
+  const uint64_t* const mul = kDoublePow5Split2[base];
+  if (offset == 0) {
+    result[0] = mul[0];
+    result[1] = mul[1];
+    return;
+  }
+  const uint64_t m = kPow5Table[offset];
+  uint64_t high1;
+  const uint64_t low1 = UMul128(m, mul[1], high1);
+  uint64_t high0;
+  const uint64_t low0 = UMul128(m, mul[0], high0);
+  const uint64_t sum = high0 + low1;
+  if (sum < high0) {
+    high1 += 1;  // Overflow into high1.
+  }
+  const uint32_t delta = static_cast<uint32_t>(
+      Pow5Bits(static_cast<int32_t>(i)) - Pow5Bits(static_cast<int32_t>(base2)));
+  result[0] = ShiftRight128(low0, sum, delta) +
+              ((kPow5Offsets[i / 16] >> ((i % 16) << 1)) & 3);
+  result[1] = ShiftRight128(sum, high1, delta);
+}
+
+// Computes 5^-i in the form used by Ryu, equivalent to pow5_inv_split(i, 125).
+void ComputeInvPow5(uint32_t i, uint64_t (&result)[2]) {
+  const uint32_t base = (i + kPow5TableSize - 1) / kPow5TableSize;
+  const uint32_t base2 = base * kPow5TableSize;
+  const uint32_t offset = base2 - i;
+  const uint64_t* const mul = kDoublePow5InvSplit2[base];  // 1 / 5^base2
+  if (offset == 0) {
+    result[0] = mul[0];
+    result[1] = mul[1];
+    return;
+  }
+  const uint64_t m = kPow5Table[offset];
+  uint64_t high1;
+  const uint64_t low1 = UMul128(m, mul[1], high1);
+  uint64_t high0;
+  const uint64_t low0 = UMul128(m, mul[0] - 1, high0);
+  const uint64_t sum = high0 + low1;
+  if (sum < high0) {
+    high1 += 1;  // Overflow into high1.
+  }
+  const uint32_t delta = static_cast<uint32_t>(
+      Pow5Bits(static_cast<int32_t>(base2)) - Pow5Bits(static_cast<int32_t>(i)));
+  result[0] = ShiftRight128(low0, sum, delta) + 1 +
+              ((kPow5InvOffsets[i / 16] >> ((i % 16) << 1)) & 3);
+  result[1] = ShiftRight128(sum, high1, delta);
+}
+
+// Returns (m * mul) >> j, where mul is a 128-bit value. m is at most 55 bits
+// and 64 < j < 128.
+uint64_t MulShift64(uint64_t m, const uint64_t (&mul)[2], int32_t j) {
+  uint64_t high1;
+  const uint64_t low1 = UMul128(m, mul[1], high1);
+  uint64_t high0;
+  UMul128(m, mul[0], high0);
+  const uint64_t sum = high0 + low1;
+  if (sum < high0) {
+    high1 += 1;  // Overflow into high1.
+  }
+  return ShiftRight128(sum, high1, static_cast<uint32_t>(j - 64));
+}
+
+Decimal DoubleToDecimal(uint64_t ieee_mantissa, uint32_t ieee_exponent) {
+  int32_t e2;
+  uint64_t m2;
+  if (ieee_exponent == 0) {  // Subnormal
+    e2 = 1 - kDoubleBias - kDoubleMantissaBits - 2;
+    m2 = ieee_mantissa;
+  } else {
+    e2 = static_cast<int32_t>(ieee_exponent) - kDoubleBias -
+         kDoubleMantissaBits - 2;
+    m2 = (uint64_t{1} << kDoubleMantissaBits) | ieee_mantissa;
+  }
+  const bool accept_bounds = (m2 & 1) == 0;
+
+  // Step 2: Determine the interval of valid decimal representations.
+  const uint64_t mv = 4 * m2;
+  const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1 ? 1 : 0;
+
+  // Step 3: Convert to a decimal power base. q is one less than necessary,
+  // so that the loop below always determines the last removed digit.
+  uint64_t vr;
+  uint64_t vp;
+  uint64_t vm;
+  int32_t e10;
+  bool vm_is_trailing_zeros = false;
+  bool vr_is_trailing_zeros = false;
+  uint64_t pow5[2];
+
+  if (e2 >= 0) {
+    const int32_t q = Log10Pow2(e2) - (e2 > 3 ? 1 : 0);
+    e10 = q;
+    const int32_t k = kDoublePow5InvBitCount + Pow5Bits(q) - 1;
+    const int32_t i = -e2 + q + k;
+    ComputeInvPow5(static_cast<uint32_t>(q), pow5);
+    vr = MulShift64(4 * m2, pow5, i);
+    vp = MulShift64(4 * m2 + 2, pow5, i);
+    vm = MulShift64(4 * m2 - 1 - mm_shift, pow5, i);
+    if (q <= 21) {
+      // Only one of mp, mv, and mm can be a multiple of 5, if any.
+      if (mv % 5 == 0) {
+        vr_is_trailing_zeros = MultipleOfPowerOf5(mv, q);
+      } else if (accept_bounds) {
+        vm_is_trailing_zeros = MultipleOfPowerOf5(mv - 1 - mm_shift, q);
+      } else {
+        vp -= MultipleOfPowerOf5(mv + 2, q) ? 1 : 0;
+      }
+    }
+  } else {
+    const int32_t q = Log10Pow5(-e2) - (-e2 > 1 ? 1 : 0);
+    e10 = q + e2;
+    const int32_t i = -e2 - q;
+    const int32_t k = Pow5Bits(i) - kDoublePow5BitCount;
+    const int32_t j = q - k;
+    ComputePow5(static_cast<uint32_t>(i), pow5);
+    vr = MulShift64(4 * m2, pow5, j);
+    vp = MulShift64(4 * m2 + 2, pow5, j);
+    vm = MulShift64(4 * m2 - 1 - mm_shift, pow5, j);
+    if (q <= 1) {
+      // mv has at least q trailing 0 bits, since it is a multiple of 4.
+      vr_is_trailing_zeros = true;
+      if (accept_bounds) {
+        vm_is_trailing_zeros = mm_shift == 1;
+      } else {
+        vp -= 1;
+      }
+    } else if (q < 63) {
+      vr_is_trailing_zeros = MultipleOfPowerOf2(mv, q);
+    }
+  }
+
+  // Step 4: Find the shortest decimal representation in the interval.
+  int32_t removed = 0;
+  uint64_t last_removed_digit = 0;
+  uint64_t output;
+  if (vm_is_trailing_zeros || vr_is_trailing_zeros) {
+    // General case, which happens rarely.
+    while (vp / 10 > vm / 10) {
+      vm_is_trailing_zeros &= vm % 10 == 0;
+      vr_is_trailing_zeros &= last_removed_digit == 0;
+      last_removed_digit = vr % 10;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      removed += 1;
+    }
+    if (vm_is_trailing_zeros) {
+      while (vm % 10 == 0) {
+        vr_is_trailing_zeros &= last_removed_digit == 0;
+        last_removed_digit = vr % 10;
+        vr /= 10;
+        vp /= 10;
+        vm /= 10;
+        removed += 1;
+      }
+    }
+    if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+      last_removed_digit = 4;  // Round even if the number ends in exactly .5.
+    }
+    output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) ||
+                           last_removed_digit >= 5
+                       ? 1
+                       : 0);
+  } else {
+    // Specialized for the common case. Removing two digits at a time first
+    // reduces the number of 64-bit divisions.
+    bool round_up = false;
+    if (vp / 100 > vm / 100) {
+      round_up = vr % 100 >= 50;
+      vr /= 100;
+      vp /= 100;
+      vm /= 100;
+      removed += 2;
+    }
+    while (vp / 10 > vm / 10) {
+      round_up = vr % 10 >= 5;
+      vr /= 10;
+      vp /= 10;
+      vm /= 10;
+      removed += 1;
+    }
+    output = vr + (vr == vm || round_up ? 1 : 0);
+  }
+  return {output, e10 + removed};
+}
+
+// Formatting
+
+// Writes "inf", "-inf", "NaN", or "-NaN", matching FloatAsIntToString.
+StatusWithSize WriteSpecial(bool negative, bool nan, span<char> buffer) {
+  if (nan) {
+    return CopyEntireStringOrNull(negative ? "-NaN" : "NaN", buffer);
+  }
+  return CopyEntireStringOrNull(negative ? "-inf" : "inf", buffer);
+}
+
+// Writes the decimal in fixed or scientific notation, whichever is shorter,
+// preferring fixed notation. This matches std::to_chars without a format.
+StatusWithSize WriteDecimal(bool negative,
+                            const Decimal& decimal,
+                            span<char> buffer) {
+  char digits[20];
+  const size_t length = IntToString(decimal.digits, digits).size();
+  const int32_t exponent = decimal.exponent;
+  const int32_t digit_count = static_cast<int32_t>(length);
+
+  // Scientific notation: d[.ddd]e+XX
+  const int32_t scientific_exponent = exponent + digit_count - 1;
+  const int32_t abs_scientific_exponent =
+      scientific_exponent < 0 ? -scientific_exponent : scientific_exponent;
+  const int32_t scientific_size = digit_count + (digit_count > 1 ? 1 : 0) +
+                                  2 + (abs_scientific_exponent >= 100 ? 3 : 2);
+
+  // Fixed notation: ddd000, dd.dd, or 0.000ddd
+  int32_t fixed_size;
+  if (exponent >= 0) {
+    fixed_size = digit_count + exponent;
+  } else if (-exponent < digit_count) {
+    fixed_size = digit_count + 1;
+  } else {
+    fixed_size = 2 - exponent;
+  }
+
+  const bool fixed = fixed_size <= scientific_size;
+  const size_t size = static_cast<size_t>(fixed ? fixed_size : scientific_size) +
+                      (negative ? 1 : 0);
+  if (size >= buffer.size()) {
+    return internal::HandleExhaustedBuffer(buffer);
+  }
+
+  char* out = buffer.data();
+  if (negative) {
+    *out++ = '-';
+  }
+
+  if (!fixed) {
+    *out++ = digits[0];
+    if (length > 1) {
+      *out++ = '.';
+      std::memcpy(out, &digits[1], length - 1);
+      out += length - 1;
+    }
+    *out++ = 'e';
+    *out++ = scientific_exponent < 0 ? '-' : '+';
+    if (abs_scientific_exponent >= 100) {
+      *out++ = static_cast<char>('0' + abs_scientific_exponent / 100);
+    }
+    *out++ = static_cast<char>('0' + abs_scientific_exponent / 10 % 10);
+    *out++ = static_cast<char>('0' + abs_scientific_exponent % 10);
+  } else if (exponent >= 0) {
+    std::memcpy(out, digits, length);
+    out += length;
+    std::memset(out, '0', static_cast<size_t>(exponent));
+    out += exponent;
+  } else if (-exponent < digit_count) {
+    const size_t integer_digits = static_cast<size_t>(digit_count + exponent);
+    std::memcpy(out, digits, integer_digits);
+    out += integer_digits;
+    *out++ = '.';
+    std::memcpy(out, &digits[integer_digits], length - integer_digits);
+    out += length - integer_digits;
+  } else {
+    const size_t leading_zeros = static_cast<size_t>(-exponent - digit_count);
+    *out++ = '0';
+    *out++ = '.';
+    std::memset(out, '0', leading_zeros);
+    out += leading_zeros;
+    std::memcpy(out, digits, length);
+    out += length;
+  }
+
+  *out = '\0';
+  return StatusWithSize(size);
+}
+
+}  // namespace
+
+StatusWithSize FloatToString(float value, span<char> buffer) {
+  const uint32_t bits = cpp20::bit_cast<uint32_t>(value);
+  const bool negative = (bits >> 31) != 0;
+  const uint32_t mantissa = bits & ((1u << kFloatMantissaBits) - 1);
+  const uint32_t exponent = (bits >> kFloatMantissaBits) & 0xffu;
+
+  if (exponent == 0xffu) {
+    return WriteSpecial(negative, mantissa != 0, buffer);
+  }
+  if (exponent == 0 && mantissa == 0) {
+    return CopyEntireStringOrNull(negative ? "-0" : "0", buffer);
+  }
+  return WriteDecimal(negative, FloatToDecimal(mantissa, exponent), buffer);
+}
+
+StatusWithSize FloatToString(double value, span<char> buffer) {
+  const uint64_t bits = cpp20::bit_cast<uint64_t>(value);
+  const bool negative = (bits >> 63) != 0;
+  const uint64_t mantissa = bits & ((uint64_t{1} << kDoubleMantissaBits) - 1);
+  const uint32_t exponent =
+      static_cast<uint32_t>(bits >> kDoubleMantissaBits) & 0x7ffu;
+
+  if (exponent == 0x7ffu) {
+    return WriteSpecial(negative, mantissa != 0, buffer);
+  }
+  if (exponent == 0 && mantissa == 0) {
+    return CopyEntireStringOrNull(negative ? "-0" : "0", buffer);
+  }
+  return WriteDecimal(negative, DoubleToDecimal(mantissa, exponent), buffer);
+}
+
+}  // namespace pw::string
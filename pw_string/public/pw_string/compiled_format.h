@@ -0,0 +1,457 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+/// @file pw_string/compiled_format.h
+///
+/// Type-safe alternatives to `pw::string::Format` and
+/// `pw::StringBuilder::Format` that parse and check the `printf`-style format
+/// string at compile time.
+///
+/// A format string with a mismatched number or type of arguments fails to
+/// compile. The format string is split into literal text and conversions when
+/// compiling, so formatting appends each piece directly, without `va_list`
+/// arguments or parsing the format string at runtime. Only floating point
+/// conversions call `std::vsnprintf`.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "pw_preprocessor/arguments.h"
+#include "pw_span/span.h"
+#include "pw_status/status_with_size.h"
+#include "pw_string/string_builder.h"
+
+/// Writes a `printf`-style formatted string to a buffer, like
+/// `pw::string::Format()`. The format string must be a string literal or other
+/// constant expression, and is checked against the arguments at compile time.
+///
+/// @code{.cpp}
+///   std::array<char, 32> buffer;
+///   pw::StatusWithSize result =
+///       PW_STRING_FORMAT(buffer, "%s: %3d%%", name, percent);
+/// @endcode
+///
+/// Supports the `d`, `i`, `u`, `o`, `x`, `X`, `c`, `s`, `p`, and floating
+/// point conversions, with flags, width, precision, and length modifiers.
+/// Width and precision must be given in the format string, not as `*`
+/// arguments. `%s` accepts C strings and anything convertible to
+/// `std::string_view`. `%p` prints `0x` followed by lowercase hex digits.
+///
+/// @returns @rst
+///
+/// .. pw-status-codes::
+///
+///    OK: Returns the number of characters written, excluding the null
+///    terminator. The buffer is always null-terminated unless it is empty.
+///
+///    RESOURCE_EXHAUSTED: The buffer was too small to fit the output.
+///
+/// @endrst
+#define PW_STRING_FORMAT(buffer, format, ...)                               \
+  [&]() -> ::pw::StatusWithSize {                                           \
+    struct PwStringFormat {                                                 \
+      static constexpr ::std::string_view Get() { return format; }          \
+    };                                                                      \
+    return ::pw::string::internal::CompiledFormat<PwStringFormat>(          \
+        ::pw::span<char>(buffer) PW_COMMA_ARGS(__VA_ARGS__));               \
+  }()
+
+/// Appends a `printf`-style formatted string to a `pw::StringBuilder`, like
+/// `pw::StringBuilder::Format()`, with the checks and conversions of
+/// `PW_STRING_FORMAT`. If the formatted string does not fit, it is truncated
+/// and the builder's status is set to `RESOURCE_EXHAUSTED`.
+///
+/// @returns The `pw::StringBuilder&`.
+#define PW_STRING_BUILDER_FORMAT(builder, format, ...)                      \
+  [&]() -> ::pw::StringBuilder& {                                           \
+    struct PwStringFormat {                                                 \
+      static constexpr ::std::string_view Get() { return format; }          \
+    };                                                                      \
+    return ::pw::string::internal::CompiledFormat<PwStringFormat>(          \
+        static_cast<::pw::StringBuilder&>(builder)                          \
+            PW_COMMA_ARGS(__VA_ARGS__));                                    \
+  }()
+
+namespace pw::string::internal {
+
+// One piece of a parsed format string: either literal text or a conversion.
+struct FormatSegment {
+  enum Flag : uint8_t {
+    kLeftJustify = 1 << 0,  // '-'
+    kPlusSign = 1 << 1,     // '+'
+    kSpaceSign = 1 << 2,    // ' '
+    kAlternate = 1 << 3,    // '#'
+    kZeroPad = 1 << 4,      // '0'
+  };
+
+  enum Length : uint8_t {
+    kDefault,
+    kChar,   // hh
+    kShort,  // h
+    kLong,   // l, ll, j, z, t, or L
+  };
+
+  // The conversion character, or '\0' for literal text.
+  char conversion = '\0';
+  uint8_t flags = 0;
+  Length length = kDefault;
+  int width = -1;      // -1 if not specified.
+  int precision = -1;  // -1 if not specified.
+
+  // For literal text, its position in the format string. For conversions,
+  // the index of the argument to convert.
+  size_t offset = 0;
+  size_t size = 0;
+  size_t argument = 0;
+
+  constexpr bool is_literal() const { return conversion == '\0'; }
+};
+
+enum class FormatError {
+  kNone,
+  kIncompleteConversion,
+  kUnsupportedConversion,
+  kArgumentWidthOrPrecision,
+};
+
+// Parses the format string into segments, or returns the first error. Adjacent
+// literal text, such as the '%' of "%%" and the text after it, is merged into
+// one segment. If out is null, only counts the segments.
+constexpr FormatError ParseFormat(std::string_view format,
+                                  FormatSegment* out,
+                                  size_t& count) {
+  count = 0;
+  size_t arguments = 0;
+  size_t literal_end = std::string_view::npos;
+
+  const auto add_literal = [&](size_t offset, size_t size) {
+    if (size == 0) {
+      return;
+    }
+    if (offset == literal_end) {
+      if (out != nullptr) {
+        out[count - 1].size += size;
+      }
+    } else {
+      if (out != nullptr) {
+        out[count] = FormatSegment{};
+        out[count].offset = offset;
+        out[count].size = size;
+      }
+      count += 1;
+    }
+    literal_end = offset + size;
+  };
+
+  size_t i = 0;
+  while (i < format.size()) {
+    const size_t percent = format.find('%', i);
+    if (percent == std::string_view::npos) {
+      add_literal(i, format.size() - i);
+      break;
+    }
+    add_literal(i, percent - i);
+    i = percent + 1;
+    if (i < format.size() && format[i] == '%') {
+      add_literal(i, 1);
+      i += 1;
+      continue;
+    }
+
+    FormatSegment segment;
+    for (; i < format.size(); ++i) {
+      const char c = format[i];
+      if (c == '-') {
+        segment.flags |= FormatSegment::kLeftJustify;
+      } else if (c == '+') {
+        segment.flags |= FormatSegment::kPlusSign;
+      } else if (c == ' ') {
+        segment.flags |= FormatSegment::kSpaceSign;
+      } else if (c == '#') {
+        segment.flags |= FormatSegment::kAlternate;
+      } else if (c == '0') {
+        segment.flags |= FormatSegment::kZeroPad;
+      } else {
+        break;
+      }
+    }
+    if (i < format.size() && format[i] == '*') {
+      return FormatError::kArgumentWidthOrPrecision;
+    }
+    for (; i < format.size() && format[i] >= '0' && format[i] <= '9'; ++i) {
+      segment.width = (segment.width < 0 ? 0 : segment.width * 10) +
+                      (format[i] - '0');
+    }
+    if (i < format.size() && format[i] == '.') {
+      i += 1;
+      if (i < format.size() && format[i] == '*') {
+        return FormatError::kArgumentWidthOrPrecision;
+      }
+      segment.precision = 0;
+      for (; i < format.size() && format[i] >= '0' && format[i] <= '9'; ++i) {
+        segment.precision = segment.precision * 10 + (format[i] - '0');
+      }
+    }
+    if (i < format.size() && format[i] == 'h') {
+      i += 1;
+      segment.length = FormatSegment::kShort;
+      if (i < format.size() && format[i] == 'h') {
+        i += 1;
+        segment.length = FormatSegment::kChar;
+      }
+    } else if (i < format.size() &&
+               std::string_view("ljztL").find(format[i]) !=
+                   std::string_view::npos) {
+      i += 1;
+      segment.length = FormatSegment::kLong;
+      if (i < format.size() && format[i - 1] == 'l' && format[i] == 'l') {
+        i += 1;
+      }
+    }
+    if (i == format.size()) {
+      return FormatError::kIncompleteConversion;
+    }
+    if (std::string_view("diuoxXcspfFeEgGaA").find(format[i]) ==
+        std::string_view::npos) {
+      return FormatError::kUnsupportedConversion;
+    }
+
+    segment.conversion = format[i];
+    segment.argument = arguments++;
+    if (out != nullptr) {
+      out[count] = segment;
+    }
+    count += 1;
+    literal_end = std::string_view::npos;
+    i += 1;
+  }
+  return FormatError::kNone;
+}
+
+// The segments of a format string, parsed at compile time. Format is a type
+// with a constexpr Get() function that returns the format string.
+template <typename Format>
+class ParsedFormat {
+ private:
+  static constexpr FormatError Parse(size_t& count) {
+    return ParseFormat(Format::Get(), nullptr, count);
+  }
+
+  static constexpr size_t SegmentCount() {
+    size_t count = 0;
+    return Parse(count) == FormatError::kNone ? count : 0;
+  }
+
+ public:
+  static constexpr FormatError kError = [] {
+    size_t count = 0;
+    return Parse(count);
+  }();
+
+  static constexpr size_t kSegmentCount = SegmentCount();
+
+  static constexpr std::array<FormatSegment, kSegmentCount> kSegments = [] {
+    std::array<FormatSegment, kSegmentCount> segments{};
+    if constexpr (kSegmentCount > 0) {
+      size_t count = 0;
+      ParseFormat(Format::Get(), segments.data(), count);
+    }
+    return segments;
+  }();
+
+  static constexpr size_t kArgumentCount = [] {
+    size_t arguments = 0;
+    for (const FormatSegment& segment : kSegments) {
+      if (!segment.is_literal()) {
+        arguments += 1;
+      }
+    }
+    return arguments;
+  }();
+
+  // The conversion character for each argument.
+  static constexpr std::array<char, kArgumentCount> kConversions = [] {
+    std::array<char, kArgumentCount> conversions{};
+    for (const FormatSegment& segment : kSegments) {
+      if (!segment.is_literal()) {
+        conversions[segment.argument] = segment.conversion;
+      }
+    }
+    return conversions;
+  }();
+};
+
+// Returns whether an argument of type T may be converted with the conversion.
+template <typename T>
+constexpr bool ArgumentMatches(char conversion) {
+  using Arg = std::decay_t<T>;
+  switch (conversion) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    case 'c':
+      return std::is_integral_v<Arg>;
+    case 's':
+      return std::is_convertible_v<const Arg&, const char*> ||
+             std::is_convertible_v<const Arg&, std::string_view>;
+    case 'p':
+      return std::is_pointer_v<Arg> || std::is_null_pointer_v<Arg>;
+    default:
+      return std::is_floating_point_v<Arg>;
+  }
+}
+
+template <typename Parsed, typename... Args, size_t... kIndex>
+constexpr bool ArgumentsMatch(std::index_sequence<kIndex...>) {
+  return (ArgumentMatches<Args>(Parsed::kConversions[kIndex]) && ...);
+}
+
+// Conversions that are not inlined, to keep each formatting call small.
+void AppendInteger(StringBuilder& out,
+                   uint64_t magnitude,
+                   bool negative,
+                   const FormatSegment& spec);
+void AppendPadded(StringBuilder& out,
+                  std::string_view text,
+                  const FormatSegment& spec);
+void AppendCString(StringBuilder& out,
+                   const char* text,
+                   const FormatSegment& spec);
+void AppendPointer(StringBuilder& out,
+                   uintptr_t address,
+                   const FormatSegment& spec);
+void AppendFloat(StringBuilder& out, double value, const FormatSegment& spec);
+
+// Converts an integer as printf does: after integer promotion, narrowed by the
+// hh or h length modifier, and then reinterpreted as signed for d and i, or as
+// unsigned for the other conversions.
+template <FormatSegment::Length kLength, bool kSigned, typename T>
+void AppendIntegerArgument(StringBuilder& out,
+                           T value,
+                           const FormatSegment& spec) {
+  using Promoted = decltype(+value);
+  using Narrowed = std::conditional_t<
+      kLength == FormatSegment::kChar,
+      char,
+      std::conditional_t<kLength == FormatSegment::kShort, short, Promoted>>;
+  if constexpr (kSigned) {
+    const auto signed_value =
+        static_cast<std::make_signed_t<Narrowed>>(static_cast<Narrowed>(value));
+    const uint64_t magnitude = static_cast<uint64_t>(signed_value);
+    AppendInteger(out,
+                  signed_value < 0 ? 0 - magnitude : magnitude,
+                  signed_value < 0,
+                  spec);
+  } else {
+    AppendInteger(out,
+                  static_cast<std::make_unsigned_t<Narrowed>>(
+                      static_cast<Narrowed>(value)),
+                  false,
+                  spec);
+  }
+}
+
+template <typename Format, size_t kSegment, typename... Args>
+void AppendSegment(StringBuilder& out, const std::tuple<const Args&...>& args) {
+  static constexpr FormatSegment kSpec =
+      ParsedFormat<Format>::kSegments[kSegment];
+
+  if constexpr (kSpec.is_literal()) {
+    constexpr std::string_view kText =
+        Format::Get().substr(kSpec.offset, kSpec.size);
+    out.append(kText.data(), kText.size());
+  } else {
+    const auto& arg = std::get<kSpec.argument>(args);
+    using Arg = std::decay_t<decltype(arg)>;
+
+    if constexpr (kSpec.conversion == 'd' || kSpec.conversion == 'i') {
+      AppendIntegerArgument<kSpec.length, true>(out, arg, kSpec);
+    } else if constexpr (kSpec.conversion == 'u' || kSpec.conversion == 'o' ||
+                         kSpec.conversion == 'x' || kSpec.conversion == 'X') {
+      AppendIntegerArgument<kSpec.length, false>(out, arg, kSpec);
+    } else if constexpr (kSpec.conversion == 'c') {
+      const char character = static_cast<char>(arg);
+      AppendPadded(out, std::string_view(&character, 1), kSpec);
+    } else if constexpr (kSpec.conversion == 's') {
+      if constexpr (std::is_convertible_v<const Arg&, const char*>) {
+        AppendCString(out, arg, kSpec);
+      } else {
+        AppendPadded(out, std::string_view(arg), kSpec);
+      }
+    } else if constexpr (kSpec.conversion == 'p') {
+      if constexpr (std::is_null_pointer_v<Arg>) {
+        AppendPointer(out, 0, kSpec);
+      } else {
+        AppendPointer(out, reinterpret_cast<uintptr_t>(arg), kSpec);
+      }
+    } else {
+      AppendFloat(out, static_cast<double>(arg), kSpec);
+    }
+  }
+}
+
+template <typename Format, typename... Args, size_t... kSegment>
+void AppendSegments(StringBuilder& out,
+                    const std::tuple<const Args&...>& args,
+                    std::index_sequence<kSegment...>) {
+  (AppendSegment<Format, kSegment>(out, args), ...);
+}
+
+template <typename Format, typename... Args>
+StringBuilder& CompiledFormat(StringBuilder& out, const Args&... args) {
+  using Parsed = ParsedFormat<Format>;
+  static_assert(Parsed::kError != FormatError::kIncompleteConversion,
+                "The format string ends with an incomplete conversion");
+  static_assert(Parsed::kError != FormatError::kUnsupportedConversion,
+                "The format string has an unsupported conversion; only d, i, "
+                "u, o, x, X, c, s, p, f, F, e, E, g, G, a, and A are "
+                "supported");
+  static_assert(Parsed::kError != FormatError::kArgumentWidthOrPrecision,
+                "Width and precision must be in the format string, rather "
+                "than '*' arguments");
+  static_assert(Parsed::kArgumentCount == sizeof...(Args),
+                "The number of arguments does not match the format string");
+
+  if constexpr (Parsed::kArgumentCount == sizeof...(Args)) {
+    static_assert(
+        ArgumentsMatch<Parsed, Args...>(std::index_sequence_for<Args...>()),
+        "An argument's type does not match its conversion in the format "
+        "string");
+    AppendSegments<Format>(out,
+                           std::tuple<const Args&...>(args...),
+                           std::make_index_sequence<Parsed::kSegmentCount>());
+  }
+  return out;
+}
+
+template <typename Format, typename... Args>
+StatusWithSize CompiledFormat(span<char> buffer, const Args&... args) {
+  StringBuilder builder(buffer);
+  CompiledFormat<Format>(builder, args...);
+  if (buffer.empty()) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  return builder.status_with_size();
+}
+
+}  // namespace pw::string::internal
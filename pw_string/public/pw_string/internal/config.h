@@ -14,13 +14,10 @@
 #pragma once
 
 // PW_STRING_ENABLE_DECIMAL_FLOAT_EXPANSION controls whether floating point
-// values passed to the ToString function will be expanded after a decimal
-// point, or just rounded to the nearest int. Enabling decimal expansion may
-// significantly increase code size.
-//
-// Note: This currently relies on floating point support for `snprintf`, which
-// might require extra compiler configuration, e.g. `-u_printf_float` for
-// newlib-nano.
+// values passed to the ToString function will be written with the shortest
+// decimal representation that round trips (see pw::string::FloatToString), or
+// just rounded to the nearest int. Enabling decimal expansion adds about 2 KB of
+// code and tables.
 #ifndef PW_STRING_ENABLE_DECIMAL_FLOAT_EXPANSION
 #define PW_STRING_ENABLE_DECIMAL_FLOAT_EXPANSION 0
 #endif
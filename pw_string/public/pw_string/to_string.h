@@ -123,9 +123,11 @@ StatusWithSize ToString(const T& value, span<char> buffer) {
     return string::IntToString(std::underlying_type_t<T>(value), buffer);
   } else if constexpr (std::is_floating_point_v<T>) {
     if constexpr (string::internal::config::kEnableDecimalFloatExpansion) {
-      // TODO(hepler): Look into using the float overload of std::to_chars when
-      // it is available.
-      return string::Format(buffer, "%.3f", value);
+      if constexpr (std::is_same_v<std::remove_cv_t<T>, float>) {
+        return string::FloatToString(value, buffer);
+      } else {
+        return string::FloatToString(static_cast<double>(value), buffer);
+      }
     } else {
       return string::FloatAsIntToString(static_cast<float>(value), buffer);
     }
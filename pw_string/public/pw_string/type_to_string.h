@@ -95,6 +95,29 @@ StatusWithSize IntToHexString(uint64_t value,
 //
 StatusWithSize FloatAsIntToString(float value, span<char> buffer);
 
+// Writes a floating point number as a null-terminated string, using the
+// shortest sequence of digits that converts back to the same value. Returns the
+// number of characters written, excluding the null terminator, and the status.
+//
+// Numbers are written in fixed or scientific notation, whichever is shorter,
+// which matches std::to_chars without a format argument. The float overload
+// writes at most 15 characters, and the double overload at most 24. Infinity
+// and NaN are written as with FloatAsIntToString.
+//
+// Numbers are never truncated; if the entire number does not fit, only a null
+// terminator is written and the status is RESOURCE_EXHAUSTED.
+//
+// Examples:
+//
+//   FloatToString(1.25f, buffer)     -> writes "1.25" to the buffer
+//   FloatToString(0.1, buffer)       -> writes "0.1" to the buffer
+//   FloatToString(-3e-20f, buffer)   -> writes "-3e-20" to the buffer
+//   FloatToString(1e6, buffer)       -> writes "1000000" to the buffer
+//   FloatToString(-NAN, buffer)      -> writes "-NaN" to the buffer
+//
+StatusWithSize FloatToString(float value, span<char> buffer);
+StatusWithSize FloatToString(double value, span<char> buffer);
+
 // Writes a bool as "true" or "false". Semantics match CopyEntireString.
 StatusWithSize BoolToString(bool value, span<char> buffer);
 
@@ -184,6 +207,15 @@ inline constexpr std::array<uint64_t, 20> kPowersOf10{
     10000000000000000000ull,  // 10^19
 };
 
+// The decimal digits of 00 through 99. Writing two digits at a time halves the
+// number of divisions when converting integers to strings.
+inline constexpr char kDigitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
 constexpr StatusWithSize HandleExhaustedBuffer(span<char> buffer) {
   if (!buffer.empty()) {
     buffer[0] = '\0';
@@ -211,9 +243,8 @@ constexpr uint_fast8_t DecimalDigitCount(uint64_t integer) {
 // think std::to_chars will be faster, so I kept this implementation for now.
 template <>
 constexpr StatusWithSize IntToString(uint64_t value, span<char> buffer) {
-  constexpr uint32_t base = 10;
-  constexpr uint32_t max_uint32_base_power = 1'000'000'000;
-  constexpr uint_fast8_t max_uint32_base_power_exponent = 9;
+  constexpr uint32_t chunk_base_power = 100'000'000;
+  constexpr uint32_t pairs_per_chunk = 4;
 
   const uint_fast8_t total_digits = DecimalDigitCount(value);
 
@@ -223,27 +254,36 @@ constexpr StatusWithSize IntToString(uint64_t value, span<char> buffer) {
 
   buffer[total_digits] = '\0';
 
-  uint_fast8_t remaining = total_digits;
-  while (remaining > 0u) {
-    uint32_t lower_digits = 0;     // the value of the lower digits to write
-    uint_fast8_t digit_count = 0;  // the number of lower digits to write
-
-    // 64-bit division is slow on 32-bit platforms, so print large numbers in
-    // 32-bit chunks to minimize the number of 64-bit divisions.
-    if (value <= std::numeric_limits<uint32_t>::max()) {
-      lower_digits = static_cast<uint32_t>(value);
-      digit_count = remaining;
-    } else {
-      lower_digits = static_cast<uint32_t>(value % max_uint32_base_power);
-      digit_count = max_uint32_base_power_exponent;
-      value /= max_uint32_base_power;
+  // Digits are written two at a time from a table, which halves the number of
+  // divisions. Write pairs of digits into buffer[index - 2] and
+  // buffer[index - 1].
+  size_t index = total_digits;
+  auto write_pair = [&buffer, &index](uint32_t pair) {
+    index -= 2;
+    buffer[index] = internal::kDigitPairs[2 * pair];
+    buffer[index + 1] = internal::kDigitPairs[2 * pair + 1];
+  };
+
+  // 64-bit division is slow on 32-bit platforms, so print large numbers in
+  // 8-digit chunks to minimize the number of 64-bit divisions.
+  while (value > std::numeric_limits<uint32_t>::max()) {
+    uint32_t chunk = static_cast<uint32_t>(value % chunk_base_power);
+    value /= chunk_base_power;
+    for (uint32_t i = 0; i < pairs_per_chunk; ++i) {
+      write_pair(chunk % 100);
+      chunk /= 100;
     }
+  }
 
-    // Write the specified number of digits, with leading 0s.
-    for (uint_fast8_t i = 0; i < digit_count; ++i) {
-      buffer[--remaining] = static_cast<char>(lower_digits % base + '0');
-      lower_digits /= base;
-    }
+  uint32_t remaining = static_cast<uint32_t>(value);
+  while (remaining >= 100) {
+    write_pair(remaining % 100);
+    remaining /= 100;
+  }
+  if (remaining >= 10) {
+    write_pair(remaining);
+  } else {
+    buffer[index - 1] = static_cast<char>('0' + remaining);
   }
   return StatusWithSize(total_digits);
 }
@@ -21,7 +21,9 @@
 #include <string_view>
 
 #include "pw_result/result.h"
+#include "pw_span/span.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 #include "pw_string/string_builder.h"
 
 namespace pw {
@@ -249,6 +251,70 @@ constexpr Result<EncodedCodePoint> EncodeCodePoint(uint32_t code_point) {
 /// Helper that writes a code point to the provided `pw::StringBuilder`.
 Status WriteCodePoint(uint32_t code_point, pw::StringBuilder& output);
 
+/// @brief Checks that `str` is well-formed UTF-8.
+///
+/// Unlike `pw::utf8::IsStringValid()`, this follows the definition of
+/// well-formed UTF-8 in the Unicode Standard (Table 3-7): overlong encodings,
+/// surrogates, and truncated sequences are rejected, while non-characters are
+/// allowed. Runs of ASCII are checked 16 bytes at a time, and SSSE3 or AVX2
+/// builds check every 16 or 32 bytes at a time, so this is much faster than
+/// reading one code point at a time.
+///
+/// @return @rst
+///
+/// .. pw-status-codes::
+///
+///    OK: The string is valid. The size is ``str.size()``.
+///
+///    INVALID_ARGUMENT: The string is malformed. The size is the offset of the
+///    first byte of the first malformed sequence, which is also the length of
+///    the longest valid prefix.
+///
+/// @endrst
+StatusWithSize Validate(std::string_view str);
+
+/// @brief Decodes a UTF-8 string into code points (UTF-32).
+///
+/// The input must be well-formed as defined by `pw::utf8::Validate()`. Runs
+/// of ASCII are decoded 8 bytes at a time.
+///
+/// @return @rst
+///
+/// .. pw-status-codes::
+///
+///    OK: The number of code points written.
+///
+///    INVALID_ARGUMENT: The string is malformed. The size is the number of
+///    code points written before the malformed sequence.
+///
+///    RESOURCE_EXHAUSTED: ``code_points`` is too small. The size is the number
+///    of code points written.
+///
+/// @endrst
+StatusWithSize ReadCodePoints(std::string_view str,
+                              span<uint32_t> code_points);
+
+/// @brief Encodes code points (UTF-32) as a UTF-8 string.
+///
+/// The output is not null-terminated. Runs of ASCII are encoded 4 code points
+/// at a time.
+///
+/// @return @rst
+///
+/// .. pw-status-codes::
+///
+///    OK: The number of bytes written.
+///
+///    OUT_OF_RANGE: A code point is a surrogate or larger than ``0x10FFFF``.
+///    The size is the number of bytes written before it.
+///
+///    RESOURCE_EXHAUSTED: ``output`` is too small for the next code point. The
+///    size is the number of bytes written.
+///
+/// @endrst
+StatusWithSize WriteCodePoints(span<const uint32_t> code_points,
+                               span<char> output);
+
 }  // namespace utf8
 
 }  // namespace pw
@@ -123,14 +123,16 @@ TEST(ToString, Integer_BufferTooSmall_WritesNullTerminator) {
 
 TEST(ToString, Float) {
   if (string::internal::config::kEnableDecimalFloatExpansion) {
-    EXPECT_EQ(5u, ToString(0.0f, buffer).size());
-    EXPECT_STREQ("0.000", buffer);
+    EXPECT_EQ(1u, ToString(0.0f, buffer).size());
+    EXPECT_STREQ("0", buffer);
     EXPECT_EQ(6u, ToString(33.444f, buffer).size());
     EXPECT_STREQ("33.444", buffer);
+    EXPECT_EQ(3u, ToString(0.1, buffer).size());
+    EXPECT_STREQ("0.1", buffer);
     EXPECT_EQ(3u, ToString(INFINITY, buffer).size());
     EXPECT_STREQ("inf", buffer);
     EXPECT_EQ(3u, ToString(NAN, buffer).size());
-    EXPECT_STREQ("nan", buffer);
+    EXPECT_STREQ("NaN", buffer);
   } else {
     EXPECT_EQ(1u, ToString(0.0f, buffer).size());
     EXPECT_STREQ("0", buffer);
@@ -0,0 +1,117 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares pw_string's number conversions with std::snprintf.
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_string/type_to_string.h"
+
+namespace pw::string {
+namespace {
+
+constexpr std::array<uint64_t, 8> kIntegers = {
+    0u,
+    7u,
+    42u,
+    1234u,
+    987654u,
+    4294967295u,
+    1234567890123u,
+    18446744073709551615u,
+};
+
+constexpr std::array<float, 8> kFloats = {
+    0.0f,
+    1.0f,
+    -0.5f,
+    3.14159265f,
+    100.25f,
+    -273.15f,
+    6.02214076e23f,
+    1.17549435e-38f,
+};
+
+constexpr std::array<double, 8> kDoubles = {
+    0.0,
+    1.0,
+    -0.5,
+    3.141592653589793,
+    100.25,
+    -273.15,
+    6.02214076e23,
+    2.2250738585072014e-308,
+};
+
+void IntToStringTest(perf_test::State& state) {
+  std::array<char, 24> buffer;
+  while (state.KeepRunning()) {
+    for (uint64_t value : kIntegers) {
+      IntToString(value, buffer);
+    }
+  }
+}
+
+void IntSnprintfTest(perf_test::State& state) {
+  std::array<char, 24> buffer;
+  while (state.KeepRunning()) {
+    for (uint64_t value : kIntegers) {
+      std::snprintf(buffer.data(),
+                    buffer.size(),
+                    "%llu",
+                    static_cast<unsigned long long>(value));
+    }
+  }
+}
+
+template <typename T, size_t kSize>
+void FloatToStringTest(perf_test::State& state,
+                       const std::array<T, kSize>& values) {
+  std::array<char, 32> buffer;
+  while (state.KeepRunning()) {
+    for (T value : values) {
+      FloatToString(value, buffer);
+    }
+  }
+}
+
+// %.9g and %.17g are the shortest printf formats that always round trip
+// float and double, respectively.
+template <typename T, size_t kSize>
+void FloatSnprintfTest(perf_test::State& state,
+                       const std::array<T, kSize>& values,
+                       const char* format) {
+  std::array<char, 32> buffer;
+  while (state.KeepRunning()) {
+    for (T value : values) {
+      std::snprintf(
+          buffer.data(), buffer.size(), format, static_cast<double>(value));
+    }
+  }
+}
+
+PW_PERF_TEST(IntToString, IntToStringTest);
+PW_PERF_TEST(IntSnprintf, IntSnprintfTest);
+
+PW_PERF_TEST(FloatToString, FloatToStringTest<float, 8>, kFloats);
+PW_PERF_TEST(FloatSnprintf, FloatSnprintfTest<float, 8>, kFloats, "%.9g");
+
+PW_PERF_TEST(DoubleToString, FloatToStringTest<double, 8>, kDoubles);
+PW_PERF_TEST(DoubleSnprintf, FloatSnprintfTest<double, 8>, kDoubles, "%.17g");
+
+}  // namespace
+}  // namespace pw::string
@@ -15,6 +15,8 @@
 #include "pw_string/type_to_string.h"
 
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <limits>
 #include <string_view>
@@ -278,6 +280,23 @@ TEST(IntToString, UnsignedSweep) {
   }
 }
 
+TEST(IntToString, PowersOfTen) {
+  uint64_t power = 1;
+  for (int i = 0; i < 20; ++i, power *= 10) {
+    for (uint64_t value : {power - 1, power, power + 1, power * 7 + 3}) {
+      char buffer[sizeof(kUint64Max)];
+      char printf_buffer[sizeof(kUint64Max)];
+      int written = std::snprintf(printf_buffer,
+                                  sizeof(printf_buffer),
+                                  "%llu",
+                                  static_cast<unsigned long long>(value));
+      auto result = IntToString(value, buffer);
+      ASSERT_EQ(static_cast<size_t>(written), result.size());
+      ASSERT_STREQ(printf_buffer, buffer);
+    }
+  }
+}
+
 class IntToHexStringTest : public TestWithBuffer {};
 
 TEST_F(IntToHexStringTest, Sweep) {
@@ -419,6 +438,105 @@ TEST_F(FloatAsIntToStringTest, TooSmall_NaN_NullTerminates) {
   EXPECT_STREQ("", buffer_);
 }
 
+class FloatToStringTest : public ::testing::Test {
+ protected:
+  template <typename T>
+  std::string_view Write(T value) {
+    auto result = FloatToString(value, buffer_);
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(result.size(), std::strlen(buffer_));
+    return std::string_view(buffer_, result.size());
+  }
+
+  char buffer_[32];
+};
+
+TEST_F(FloatToStringTest, Zero) {
+  EXPECT_EQ(Write(0.0f), "0");
+  EXPECT_EQ(Write(-0.0f), "-0");
+  EXPECT_EQ(Write(0.0), "0");
+  EXPECT_EQ(Write(-0.0), "-0");
+}
+
+TEST_F(FloatToStringTest, InfinityAndNan) {
+  EXPECT_EQ(Write(INFINITY), "inf");
+  EXPECT_EQ(Write(-INFINITY), "-inf");
+  EXPECT_EQ(Write(static_cast<double>(NAN)), "NaN");
+  EXPECT_EQ(Write(-NAN), "-NaN");
+}
+
+TEST_F(FloatToStringTest, Float_Shortest) {
+  EXPECT_EQ(Write(0.1f), "0.1");
+  EXPECT_EQ(Write(1.25f), "1.25");
+  EXPECT_EQ(Write(-33.444f), "-33.444");
+  EXPECT_EQ(Write(16777216.0f), "16777216");
+  EXPECT_EQ(Write(1e6f), "1e+06");
+  EXPECT_EQ(Write(0.001f), "0.001");
+  EXPECT_EQ(Write(-3e-20f), "-3e-20");
+  EXPECT_EQ(Write(std::numeric_limits<float>::max()), "3.4028235e+38");
+  EXPECT_EQ(Write(std::numeric_limits<float>::min()), "1.1754944e-38");
+  EXPECT_EQ(Write(std::numeric_limits<float>::denorm_min()), "1e-45");
+}
+
+TEST_F(FloatToStringTest, Double_Shortest) {
+  EXPECT_EQ(Write(0.1), "0.1");
+  EXPECT_EQ(Write(0.1 + 0.2), "0.30000000000000004");
+  EXPECT_EQ(Write(123456.789), "123456.789");
+  EXPECT_EQ(Write(1e21), "1e+21");
+  EXPECT_EQ(Write(1e-7), "1e-07");
+  EXPECT_EQ(Write(-2.5e-100), "-2.5e-100");
+  EXPECT_EQ(Write(std::numeric_limits<double>::max()),
+            "1.7976931348623157e+308");
+  EXPECT_EQ(Write(std::numeric_limits<double>::lowest()),
+            "-1.7976931348623157e+308");
+  EXPECT_EQ(Write(std::numeric_limits<double>::min()),
+            "2.2250738585072014e-308");
+  EXPECT_EQ(Write(std::numeric_limits<double>::denorm_min()), "5e-324");
+}
+
+TEST_F(FloatToStringTest, LargeInteger_WritesZerosForUnneededDigits) {
+  // The nearest float is 1801611640832, but 1801611600000 is the shortest
+  // number that converts back to it.
+  EXPECT_EQ(Write(1801611640832.0f), "1801611600000");
+  EXPECT_EQ(Write(9007199254740993.0), "9007199254740992");
+}
+
+TEST_F(FloatToStringTest, RoundTrips) {
+  for (uint32_t bits = 0; bits < 0x7f800000u; bits += 0x00012345u) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    Write(value);
+    ASSERT_EQ(std::strtof(buffer_, nullptr), value);
+
+    const double double_value = static_cast<double>(value) * 1.000000001;
+    Write(double_value);
+    ASSERT_EQ(std::strtod(buffer_, nullptr), double_value);
+  }
+}
+
+TEST_F(FloatToStringTest, ExactFit) {
+  EXPECT_EQ(FloatToString(-1.5f, span(buffer_, 5)).size(), 4u);
+  EXPECT_STREQ("-1.5", buffer_);
+  EXPECT_EQ(FloatToString(1e-7, span(buffer_, 6)).size(), 5u);
+  EXPECT_STREQ("1e-07", buffer_);
+}
+
+TEST_F(FloatToStringTest, TooSmall_NullTerminates) {
+  auto result = FloatToString(-1.5f, span(buffer_, 4));
+  EXPECT_EQ(0u, result.size());
+  EXPECT_FALSE(result.ok());
+  EXPECT_STREQ("", buffer_);
+
+  result = FloatToString(std::numeric_limits<double>::max(), span(buffer_, 23));
+  EXPECT_EQ(0u, result.size());
+  EXPECT_FALSE(result.ok());
+  EXPECT_STREQ("", buffer_);
+
+  result = FloatToString(-INFINITY, span(buffer_, 4));
+  EXPECT_FALSE(result.ok());
+  EXPECT_STREQ("", buffer_);
+}
+
 class CopyStringOrNullTest : public TestWithBuffer {};
 
 using namespace std::literals::string_view_literals;
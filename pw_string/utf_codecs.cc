@@ -15,11 +15,408 @@
 #include "pw_string/utf_codecs.h"
 
 #include <cstdint>
+#include <cstring>
 
 #include "pw_status/status.h"
 
+#if defined(__SSSE3__)
+#include <immintrin.h>
+#define _PW_UTF8_X86_SSSE3 1
+#endif
+
+#if defined(__AVX2__) && defined(__SSSE3__)
+#define _PW_UTF8_X86_AVX2 1
+#endif
+
+#ifndef _PW_UTF8_X86_SSSE3
+#define _PW_UTF8_X86_SSSE3 0
+#endif  // _PW_UTF8_X86_SSSE3
+
+#ifndef _PW_UTF8_X86_AVX2
+#define _PW_UTF8_X86_AVX2 0
+#endif  // _PW_UTF8_X86_AVX2
+
 namespace pw {
 namespace utf8 {
+namespace {
+
+constexpr uint64_t kAsciiMask = 0x8080808080808080u;
+
+constexpr bool IsContinuation(uint8_t byte) { return (byte & 0xC0) == 0x80; }
+
+uint64_t LoadWord(const uint8_t* data) {
+  uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+// Returns the number of ASCII bytes at the start of data.
+size_t AsciiPrefixLength(const uint8_t* data, size_t size) {
+  size_t i = 0;
+  while (i + 2 * sizeof(uint64_t) <= size &&
+         ((LoadWord(&data[i]) | LoadWord(&data[i + sizeof(uint64_t)])) &
+          kAsciiMask) == 0) {
+    i += 2 * sizeof(uint64_t);
+  }
+  while (i < size && data[i] < 0x80) {
+    i += 1;
+  }
+  return i;
+}
+
+// Decodes the sequence at the start of data. Returns its length, or 0 if it is
+// not well-formed as defined by Table 3-7 of the Unicode Standard. Restricting
+// the range of the second byte after some leading bytes rejects overlong
+// encodings, surrogates, and code points larger than 0x10FFFF.
+size_t DecodeSequence(const uint8_t* data, size_t size, uint32_t& code_point) {
+  const uint8_t leading_byte = data[0];
+  if (leading_byte < 0x80) {
+    code_point = leading_byte;
+    return 1;
+  }
+
+  uint8_t min_second_byte = 0x80;
+  uint8_t max_second_byte = 0xBF;
+  size_t byte_count;
+  if (leading_byte < 0xC2) {
+    return 0;  // Continuation byte or overlong 2-byte sequence.
+  } else if (leading_byte < 0xE0) {
+    byte_count = 2;
+    code_point = leading_byte & 0x1Fu;
+  } else if (leading_byte < 0xF0) {
+    byte_count = 3;
+    code_point = leading_byte & 0x0Fu;
+    if (leading_byte == 0xE0) {
+      min_second_byte = 0xA0;
+    } else if (leading_byte == 0xED) {
+      max_second_byte = 0x9F;
+    }
+  } else if (leading_byte < 0xF5) {
+    byte_count = 4;
+    code_point = leading_byte & 0x07u;
+    if (leading_byte == 0xF0) {
+      min_second_byte = 0x90;
+    } else if (leading_byte == 0xF4) {
+      max_second_byte = 0x8F;
+    }
+  } else {
+    return 0;
+  }
+
+  if (size < byte_count || data[1] < min_second_byte ||
+      data[1] > max_second_byte) {
+    return 0;
+  }
+  code_point = (code_point << 6) | (data[1] & 0x3Fu);
+  for (size_t i = 2; i < byte_count; ++i) {
+    if (!IsContinuation(data[i])) {
+      return 0;
+    }
+    code_point = (code_point << 6) | (data[i] & 0x3Fu);
+  }
+  return byte_count;
+}
+
+// Vectorized validation
+//
+// The kernels implement the lookup algorithm from Keiser and Lemire,
+// "Validating UTF-8 In Less Than One Instruction Per Byte" (2021). Every error
+// except a sequence truncated by the end of the input shows up in the high and
+// low nibbles of two consecutive bytes, or as a continuation byte that is
+// missing two or three bytes after a 3- or 4-byte leading byte. Three 16-entry
+// table lookups find the former.
+//
+// The kernels return the offset of a code point boundary before which the
+// input is known to be valid. The scalar loop validates the rest of the input,
+// and finds the exact offset of the error if a kernel found one.
+#if _PW_UTF8_X86_SSSE3
+
+// Returns an offset at which to restart scalar validation so that a sequence
+// that straddles offset is checked in full.
+size_t SequenceStart(const uint8_t* data, size_t offset) {
+  for (size_t back = 1; back <= 3 && back <= offset; ++back) {
+    const uint8_t byte = data[offset - back];
+    if (byte < 0x80) {
+      return offset;
+    }
+    if (byte >= 0xC0) {
+      return offset - back;
+    }
+  }
+  return offset;
+}
+
+// Error bits set by the lookup tables, with the pairs of bytes that set them.
+//
+// 11______ 0_______
+// 11______ 11______
+constexpr uint8_t kTooShort = 1 << 0;
+// 0_______ 10______
+constexpr uint8_t kTooLong = 1 << 1;
+// 11100000 100_____
+constexpr uint8_t kOverlong3 = 1 << 2;
+// 11110100 1001____, 11110100 101_____
+// 11110101 1001____, 11110101 101_____
+// 1111011_ 1001____, 1111011_ 101_____
+// 11111___ 1001____, 11111___ 101_____
+constexpr uint8_t kTooLarge = 1 << 3;
+// 11101101 101_____
+constexpr uint8_t kSurrogate = 1 << 4;
+// 1100000_ 10______
+constexpr uint8_t kOverlong2 = 1 << 5;
+// 11110101 1000____, 1111011_ 1000____, 11111___ 1000____
+constexpr uint8_t kTooLarge1000 = 1 << 6;
+// 11110000 1000____
+constexpr uint8_t kOverlong4 = 1 << 6;
+// 10______ 10______
+constexpr uint8_t kTwoContinuations = 1 << 7;
+
+// Errors that only depend on the high nibble of the first byte.
+constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoContinuations;
+
+// Indexed by the high nibble of the first byte of a pair.
+constexpr uint8_t kFirstByteHighTable[16] = {
+    // 0_______ ________
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    kTooLong,
+    // 10______ ________
+    kTwoContinuations,
+    kTwoContinuations,
+    kTwoContinuations,
+    kTwoContinuations,
+    // 1100____ ________
+    kTooShort | kOverlong2,
+    // 1101____ ________
+    kTooShort,
+    // 1110____ ________
+    kTooShort | kOverlong3 | kSurrogate,
+    // 1111____ ________
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+
+// Indexed by the low nibble of the first byte of a pair.
+constexpr uint8_t kFirstByteLowTable[16] = {
+    // ____0000 ________
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    // ____0001 ________
+    kCarry | kOverlong2,
+    // ____001_ ________
+    kCarry,
+    kCarry,
+    // ____0100 ________
+    kCarry | kTooLarge,
+    // ____0101 ________
+    kCarry | kTooLarge | kTooLarge1000,
+    // ____011_ ________
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    // ____1___ ________
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    // ____1101 ________
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+
+// Indexed by the high nibble of the second byte of a pair.
+constexpr uint8_t kSecondByteHighTable[16] = {
+    // ________ 0_______
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    // ________ 1000____
+    kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge1000 |
+        kOverlong4,
+    // ________ 1001____
+    kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge,
+    // ________ 101_____
+    kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,
+    // ________ 11______
+    kTooShort,
+    kTooShort,
+    kTooShort,
+    kTooShort,
+};
+
+// The largest values of the last bytes of a block that do not start a
+// sequence that continues into the next block: ... 1111____ 111_____ 11______
+constexpr uint8_t kIncompleteMax[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1,
+};
+
+__m128i LoadTable(const uint8_t (&table)[16]) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+}
+
+// Returns the error bits for a 16-byte block, given the previous block.
+__m128i CheckBlock(__m128i input, __m128i previous) {
+  const __m128i low_nibble = _mm_set1_epi8(0x0F);
+
+  // Bytes 1, 2 and 3 positions before each byte in input.
+  const __m128i previous1 = _mm_alignr_epi8(input, previous, 15);
+  const __m128i previous2 = _mm_alignr_epi8(input, previous, 14);
+  const __m128i previous3 = _mm_alignr_epi8(input, previous, 13);
+
+  const __m128i first_high = _mm_shuffle_epi8(
+      LoadTable(kFirstByteHighTable),
+      _mm_and_si128(_mm_srli_epi16(previous1, 4), low_nibble));
+  const __m128i first_low = _mm_shuffle_epi8(
+      LoadTable(kFirstByteLowTable), _mm_and_si128(previous1, low_nibble));
+  const __m128i second_high =
+      _mm_shuffle_epi8(LoadTable(kSecondByteHighTable),
+                       _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+  const __m128i special_cases =
+      _mm_and_si128(_mm_and_si128(first_high, first_low), second_high);
+
+  // Bytes after a 3-byte (111_____) or 4-byte (1111____) leading byte must be
+  // continuations. The saturating subtractions set the high bit only for
+  // those. The tables flag two continuations in a row, which clears the bit
+  // when expected.
+  const __m128i must_be_continuation =
+      _mm_and_si128(_mm_or_si128(_mm_subs_epu8(previous2, _mm_set1_epi8(0x60)),
+                                 _mm_subs_epu8(previous3, _mm_set1_epi8(0x70))),
+                    _mm_set1_epi8(static_cast<char>(0x80)));
+  return _mm_xor_si128(must_be_continuation, special_cases);
+}
+
+// Returns nonzero bytes if the block ends with an incomplete sequence.
+__m128i IsIncomplete(__m128i input) {
+  return _mm_subs_epu8(
+      input,
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+          &kIncompleteMax[sizeof(kIncompleteMax) - sizeof(__m128i)])));
+}
+
+bool IsZero(__m128i value) {
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(value, _mm_setzero_si128())) ==
+         0xFFFF;
+}
+
+[[maybe_unused]] size_t ValidateBlocksSsse3(const uint8_t* data,
+                                            size_t size) {
+  __m128i previous = _mm_setzero_si128();
+  __m128i previous_incomplete = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+    const __m128i input =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&data[i]));
+    __m128i error;
+    if (_mm_movemask_epi8(input) == 0) {
+      // An ASCII block is only invalid if it interrupts a sequence.
+      error = previous_incomplete;
+    } else {
+      error = CheckBlock(input, previous);
+      previous_incomplete = IsIncomplete(input);
+    }
+    if (!IsZero(error)) {
+      break;
+    }
+    previous = input;
+  }
+  return SequenceStart(data, i);
+}
+
+#endif  // _PW_UTF8_X86_SSSE3
+
+#if _PW_UTF8_X86_AVX2
+
+__m256i LoadTable256(const uint8_t (&table)[16]) {
+  return _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+// Same as CheckBlock, for 32-byte blocks. _mm256_alignr_epi8 shifts within
+// each 128-bit lane, so combine input with the upper lane of previous first.
+__m256i CheckBlock256(__m256i input, __m256i previous) {
+  const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+  const __m256i shifted = _mm256_permute2x128_si256(previous, input, 0x21);
+
+  const __m256i previous1 = _mm256_alignr_epi8(input, shifted, 15);
+  const __m256i previous2 = _mm256_alignr_epi8(input, shifted, 14);
+  const __m256i previous3 = _mm256_alignr_epi8(input, shifted, 13);
+
+  const __m256i first_high = _mm256_shuffle_epi8(
+      LoadTable256(kFirstByteHighTable),
+      _mm256_and_si256(_mm256_srli_epi16(previous1, 4), low_nibble));
+  const __m256i first_low =
+      _mm256_shuffle_epi8(LoadTable256(kFirstByteLowTable),
+                          _mm256_and_si256(previous1, low_nibble));
+  const __m256i second_high = _mm256_shuffle_epi8(
+      LoadTable256(kSecondByteHighTable),
+      _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+  const __m256i special_cases =
+      _mm256_and_si256(_mm256_and_si256(first_high, first_low), second_high);
+
+  const __m256i must_be_continuation = _mm256_and_si256(
+      _mm256_or_si256(_mm256_subs_epu8(previous2, _mm256_set1_epi8(0x60)),
+                      _mm256_subs_epu8(previous3, _mm256_set1_epi8(0x70))),
+      _mm256_set1_epi8(static_cast<char>(0x80)));
+  return _mm256_xor_si256(must_be_continuation, special_cases);
+}
+
+__m256i IsIncomplete256(__m256i input) {
+  return _mm256_subs_epu8(
+      input,
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kIncompleteMax)));
+}
+
+size_t ValidateBlocksAvx2(const uint8_t* data, size_t size) {
+  __m256i previous = _mm256_setzero_si256();
+  __m256i previous_incomplete = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+    const __m256i input =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&data[i]));
+    __m256i error;
+    if (_mm256_movemask_epi8(input) == 0) {
+      error = previous_incomplete;
+    } else {
+      error = CheckBlock256(input, previous);
+      previous_incomplete = IsIncomplete256(input);
+    }
+    if (!_mm256_testz_si256(error, error)) {
+      break;
+    }
+    previous = input;
+  }
+  return SequenceStart(data, i);
+}
+
+#endif  // _PW_UTF8_X86_AVX2
+
+// Returns the length of a prefix of data that is known to be valid and ends
+// on a code point boundary.
+size_t ValidateBlocks([[maybe_unused]] const uint8_t* data,
+                      [[maybe_unused]] size_t size) {
+#if _PW_UTF8_X86_AVX2
+  return ValidateBlocksAvx2(data, size);
+#elif _PW_UTF8_X86_SSSE3
+  return ValidateBlocksSsse3(data, size);
+#else
+  return 0;
+#endif
+}
+
+}  // namespace
+
 Status WriteCodePoint(uint32_t code_point, pw::StringBuilder& output) {
   const auto rslt = EncodeCodePoint(code_point);
   if (rslt.ok()) {
@@ -29,5 +426,95 @@ Status WriteCodePoint(uint32_t code_point, pw::StringBuilder& output) {
   // Error encoding code point.
   return rslt.status();
 }
+
+StatusWithSize Validate(std::string_view str) {
+  const auto* data = reinterpret_cast<const uint8_t*>(str.data());
+  const size_t size = str.size();
+
+  size_t i = ValidateBlocks(data, size);
+  while (i < size) {
+    i += AsciiPrefixLength(&data[i], size - i);
+    if (i == size) {
+      break;
+    }
+    uint32_t code_point;
+    const size_t byte_count = DecodeSequence(&data[i], size - i, code_point);
+    if (byte_count == 0) {
+      return StatusWithSize::InvalidArgument(i);
+    }
+    i += byte_count;
+  }
+  return StatusWithSize(size);
+}
+
+StatusWithSize ReadCodePoints(std::string_view str,
+                              span<uint32_t> code_points) {
+  const auto* data = reinterpret_cast<const uint8_t*>(str.data());
+  const size_t size = str.size();
+
+  size_t i = 0;
+  size_t count = 0;
+  while (i < size) {
+    while (i + sizeof(uint64_t) <= size &&
+           count + sizeof(uint64_t) <= code_points.size() &&
+           (LoadWord(&data[i]) & kAsciiMask) == 0) {
+      for (size_t j = 0; j < sizeof(uint64_t); ++j) {
+        code_points[count + j] = data[i + j];
+      }
+      i += sizeof(uint64_t);
+      count += sizeof(uint64_t);
+    }
+    if (i == size) {
+      break;
+    }
+    if (count == code_points.size()) {
+      return StatusWithSize::ResourceExhausted(count);
+    }
+    const size_t byte_count =
+        DecodeSequence(&data[i], size - i, code_points[count]);
+    if (byte_count == 0) {
+      return StatusWithSize::InvalidArgument(count);
+    }
+    i += byte_count;
+    count += 1;
+  }
+  return StatusWithSize(count);
+}
+
+StatusWithSize WriteCodePoints(span<const uint32_t> code_points,
+                               span<char> output) {
+  constexpr size_t kAsciiRun = 4;
+
+  size_t i = 0;
+  size_t written = 0;
+  while (i < code_points.size()) {
+    while (i + kAsciiRun <= code_points.size() &&
+           written + kAsciiRun <= output.size() &&
+           (code_points[i] | code_points[i + 1] | code_points[i + 2] |
+            code_points[i + 3]) < 0x80u) {
+      for (size_t j = 0; j < kAsciiRun; ++j) {
+        output[written + j] = static_cast<char>(code_points[i + j]);
+      }
+      i += kAsciiRun;
+      written += kAsciiRun;
+    }
+    if (i == code_points.size()) {
+      break;
+    }
+    if (!utf::IsValidCodepoint(code_points[i])) {
+      return StatusWithSize::OutOfRange(written);
+    }
+    const auto encoded = EncodeCodePoint(code_points[i]);
+    const std::string_view bytes = encoded->as_view();
+    if (bytes.size() > output.size() - written) {
+      return StatusWithSize::ResourceExhausted(written);
+    }
+    std::memcpy(&output[written], bytes.data(), bytes.size());
+    i += 1;
+    written += bytes.size();
+  }
+  return StatusWithSize(written);
+}
+
 }  // namespace utf8
 }  // namespace pw
@@ -0,0 +1,64 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Compares bulk UTF-8 validation with reading one code point at a time.
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_string/utf_codecs.h"
+
+namespace pw::utf8 {
+namespace {
+
+constexpr std::string_view kAscii =
+    "{\"name\": \"Living room sensor\", \"firmware\": \"1.2.3\", \"rssi\": -67, "
+    "\"values\": [21.5, 21.7, 21.6, 21.4], \"status\": \"ok\"}";
+
+constexpr std::string_view kMixed =
+    "{\"name\": \"Capteur du salon \xE2\x80\x93 \xC3\xA9tage\", \"unit\": "
+    "\"\xC2\xB0" "C\", \"note\": \"\xE6\xB8\xA9\xE5\xBA\xA6\", \"emoji\": "
+    "\"\xF0\x9F\x8C\xA1\"}";
+
+void IsStringValidTest(perf_test::State& state, std::string_view str) {
+  while (state.KeepRunning()) {
+    IsStringValid(str);
+  }
+}
+
+void ValidateTest(perf_test::State& state, std::string_view str) {
+  while (state.KeepRunning()) {
+    Validate(str);
+  }
+}
+
+void ReadCodePointsTest(perf_test::State& state, std::string_view str) {
+  std::array<uint32_t, 128> code_points;
+  while (state.KeepRunning()) {
+    ReadCodePoints(str, code_points);
+  }
+}
+
+PW_PERF_TEST(IsStringValidAscii, IsStringValidTest, kAscii);
+PW_PERF_TEST(ValidateAscii, ValidateTest, kAscii);
+PW_PERF_TEST(ReadCodePointsAscii, ReadCodePointsTest, kAscii);
+
+PW_PERF_TEST(IsStringValidMixed, IsStringValidTest, kMixed);
+PW_PERF_TEST(ValidateMixed, ValidateTest, kMixed);
+PW_PERF_TEST(ReadCodePointsMixed, ReadCodePointsTest, kMixed);
+
+}  // namespace
+}  // namespace pw::utf8
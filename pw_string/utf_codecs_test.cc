@@ -15,6 +15,7 @@
 #include "pw_string/utf_codecs.h"
 
 #include <array>
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -314,5 +315,219 @@ TEST(UtfCodecs, EncodeCodePoint) {
   }
 }
 
+// Mixes 1, 2, 3 and 4 byte sequences: $, £, €, 𐍈 and the largest code point.
+constexpr std::string_view kMixed =
+    "Just some ascii! $\xC2\xA3\xE2\x82\xAC\xF0\x90\x8D\x88\xF4\x8F\xBF\xBF"
+    " and a bit more ascii.\xEF\xBF\xBF\xED\x9F\xBF\xEE\x80\x80\xC3\xA9";
+
+// Returns the offset of the first malformed sequence in str, or str.size().
+// Checks each sequence with ReadCodePoint, which does not reject overlong
+// encodings or leading continuation bytes on its own.
+size_t ReferenceValidate(std::string_view str) {
+  size_t offset = 0;
+  while (offset < str.size()) {
+    if ((static_cast<uint8_t>(str[offset]) & 0xC0) == 0x80) {
+      return offset;
+    }
+    auto rslt = utf8::ReadCodePoint(str.substr(offset));
+    if (!rslt.ok() || rslt->size() != utf8::EncodeCodePoint(rslt->code_point())
+                                          ->as_view()
+                                          .size()) {
+      return offset;
+    }
+    offset += rslt->size();
+  }
+  return offset;
+}
+
+// A long string that crosses several 16 and 32 byte blocks.
+std::string LongMixedString() {
+  std::string str;
+  for (int i = 0; i < 4; ++i) {
+    str.append(kMixed);
+  }
+  return str;
+}
+
+TEST(UtfCodecs, Validate) {
+  StatusWithSize result = utf8::Validate("");
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 0u);
+
+  result = utf8::Validate("Just some ascii!");
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 16u);
+
+  result = utf8::Validate(kMixed);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), kMixed.size());
+
+  // Non-characters are well-formed.
+  result = utf8::Validate("\xEF\xBF\xBE");
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 3u);
+  EXPECT_FALSE(utf8::IsStringValid("\xEF\xBF\xBE"));
+}
+
+TEST(UtfCodecs, Validate_Malformed) {
+  constexpr std::string_view kMalformed[] = {
+      "\x80",                  // Continuation without a leading byte
+      "\xBF",                  // Continuation without a leading byte
+      "\xC0\x80",              // Overlong 2-byte sequence
+      "\xC1\xBF",              // Overlong 2-byte sequence
+      "\xE0\x80\x80",          // Overlong 3-byte sequence
+      "\xE0\x9F\xBF",          // Overlong 3-byte sequence
+      "\xF0\x80\x80\x80",      // Overlong 4-byte sequence
+      "\xF0\x8F\xBF\xBF",      // Overlong 4-byte sequence
+      "\xED\xA0\x80",          // Surrogate
+      "\xED\xBF\xBF",          // Surrogate
+      "\xF4\x90\x80\x80",      // Larger than 0x10FFFF
+      "\xF5\x80\x80\x80",      // Invalid leading byte
+      "\xFF",                  // Invalid leading byte
+      "\xC3",                  // Truncated
+      "\xE2\x82",              // Truncated
+      "\xF0\x90\x8D",          // Truncated
+      "\xC3" "A",              // Missing continuation
+      "\xE2\x82\xE2\x82\xAC",  // Missing continuation
+  };
+
+  const std::string str = LongMixedString();
+  for (std::string_view malformed : kMalformed) {
+    StatusWithSize result = utf8::Validate(malformed);
+    EXPECT_EQ(result.status(), Status::InvalidArgument());
+    EXPECT_EQ(result.size(), 0u);
+
+    // Check that the offset is reported at every code point boundary in a
+    // long string.
+    size_t offset = 0;
+    while (true) {
+      std::string invalid = str;
+      invalid.insert(offset, malformed);
+      result = utf8::Validate(invalid);
+      ASSERT_EQ(result.status(), Status::InvalidArgument());
+      ASSERT_EQ(result.size(), offset);
+      if (offset == str.size()) {
+        break;
+      }
+      offset += utf8::ReadCodePoint(std::string_view(str).substr(offset))->size();
+    }
+  }
+}
+
+TEST(UtfCodecs, Validate_Truncated) {
+  const std::string str = LongMixedString();
+  for (size_t size = 0; size <= str.size(); ++size) {
+    const std::string_view prefix = std::string_view(str).substr(0, size);
+    const size_t expected = ReferenceValidate(prefix);
+    const StatusWithSize result = utf8::Validate(prefix);
+    EXPECT_EQ(result.ok(), expected == size);
+    EXPECT_EQ(result.size(), expected);
+  }
+}
+
+TEST(UtfCodecs, Validate_MatchesReference) {
+  constexpr uint8_t kBytes[] = {
+      0x00, 0x41, 0x7F, 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF, 0xC0,
+      0xC1, 0xC2, 0xDF, 0xE0, 0xED, 0xEF, 0xF0, 0xF4, 0xF5, 0xFF,
+  };
+  const std::string str = LongMixedString();
+  for (size_t offset = 0; offset < str.size(); ++offset) {
+    for (uint8_t byte : kBytes) {
+      std::string modified = str;
+      modified[offset] = static_cast<char>(byte);
+      const size_t expected = ReferenceValidate(modified);
+      const StatusWithSize result = utf8::Validate(modified);
+      ASSERT_EQ(result.ok(), expected == modified.size());
+      ASSERT_EQ(result.size(), expected);
+    }
+  }
+}
+
+TEST(UtfCodecs, ReadCodePoints) {
+  std::array<uint32_t, 64> code_points{};
+  const StatusWithSize result = utf8::ReadCodePoints(kMixed, code_points);
+  ASSERT_EQ(result.status(), OkStatus());
+
+  std::string_view remaining = kMixed;
+  for (size_t i = 0; i < result.size(); ++i) {
+    auto rslt = utf8::ReadCodePoint(remaining);
+    ASSERT_TRUE(rslt.ok());
+    EXPECT_EQ(code_points[i], rslt->code_point());
+    remaining.remove_prefix(rslt->size());
+  }
+  EXPECT_TRUE(remaining.empty());
+}
+
+TEST(UtfCodecs, ReadCodePoints_Malformed) {
+  std::array<uint32_t, 16> code_points{};
+  StatusWithSize result =
+      utf8::ReadCodePoints("Twelve chars\xC0\x80", code_points);
+  EXPECT_EQ(result.status(), Status::InvalidArgument());
+  EXPECT_EQ(result.size(), 12u);
+
+  result = utf8::ReadCodePoints("\xE2\x82\xAC\xED\xA0\x80", code_points);
+  EXPECT_EQ(result.status(), Status::InvalidArgument());
+  EXPECT_EQ(result.size(), 1u);
+
+  result = utf8::ReadCodePoints("\xE2\x82", code_points);
+  EXPECT_EQ(result.status(), Status::InvalidArgument());
+  EXPECT_EQ(result.size(), 0u);
+}
+
+TEST(UtfCodecs, ReadCodePoints_OutputTooSmall) {
+  std::array<uint32_t, 10> code_points{};
+  StatusWithSize result = utf8::ReadCodePoints("0123456789", code_points);
+  EXPECT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), 10u);
+
+  result = utf8::ReadCodePoints("0123456789A", code_points);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(result.size(), 10u);
+
+  result = utf8::ReadCodePoints("01234567\xE2\x82\xAC\xE2\x82\xAC\xE2\x82\xAC",
+                                code_points);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(result.size(), 10u);
+}
+
+TEST(UtfCodecs, WriteCodePoints) {
+  std::array<uint32_t, 64> code_points{};
+  const StatusWithSize read = utf8::ReadCodePoints(kMixed, code_points);
+  ASSERT_EQ(read.status(), OkStatus());
+
+  std::array<char, 128> buffer{};
+  const StatusWithSize written =
+      utf8::WriteCodePoints(span(code_points).first(read.size()), buffer);
+  ASSERT_EQ(written.status(), OkStatus());
+  EXPECT_EQ(std::string_view(buffer.data(), written.size()), kMixed);
+}
+
+TEST(UtfCodecs, WriteCodePoints_InvalidCodePoint) {
+  std::array<char, 16> buffer{};
+  constexpr uint32_t kSurrogate[] = {'a', 'b', 'c', 'd', 'e', 0xD800u};
+  StatusWithSize result = utf8::WriteCodePoints(kSurrogate, buffer);
+  EXPECT_EQ(result.status(), Status::OutOfRange());
+  EXPECT_EQ(result.size(), 5u);
+
+  constexpr uint32_t kTooLarge[] = {0x20ACu, 0x110000u};
+  result = utf8::WriteCodePoints(kTooLarge, buffer);
+  EXPECT_EQ(result.status(), Status::OutOfRange());
+  EXPECT_EQ(result.size(), 3u);
+}
+
+TEST(UtfCodecs, WriteCodePoints_OutputTooSmall) {
+  std::array<char, 5> buffer{};
+  constexpr uint32_t kAscii[] = {'a', 'b', 'c', 'd', 'e', 'f'};
+  StatusWithSize result = utf8::WriteCodePoints(kAscii, buffer);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(result.size(), 5u);
+
+  constexpr uint32_t kEuros[] = {0x20ACu, 0x20ACu};
+  result = utf8::WriteCodePoints(kEuros, buffer);
+  EXPECT_EQ(result.status(), Status::ResourceExhausted());
+  EXPECT_EQ(result.size(), 3u);
+  EXPECT_EQ(std::string_view(buffer.data(), 3), "\xE2\x82\xAC");
+}
+
 }  // namespace
 }  // namespace pw
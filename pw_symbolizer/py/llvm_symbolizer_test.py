@@ -43,6 +43,15 @@ class TestSymbolizer(unittest.TestCase):
                 self.assertEqual(result.file, _CPP_TEST_FILE_NAME)
                 self.assertEqual(result.line, expected_symbol['Line'])
 
+        # Batched symbolization, including repeated addresses, matches
+        # symbolizing one address at a time.
+        addresses = [symbol['Address'] for symbol in expected_symbols]
+        addresses += addresses[::-1]
+        self.assertEqual(
+            symbolizer.symbolize_all(addresses),
+            [symbolizer.symbolize(address) for address in addresses],
+        )
+
     def _parameterized_test_symbolization(self, **llvm_symbolizer_kwargs):
         """Tests that the symbolizer can symbolize addresses properly."""
         self.assertTrue('PW_PIGWEED_CIPD_INSTALL_DIR' in os.environ)
@@ -18,6 +18,7 @@ import subprocess
 import threading
 import json
 from pathlib import Path
+from typing import Iterable
 from pw_symbolizer import symbolizer
 
 # If the script is being run through Bazel, our support binaries are provided
@@ -32,6 +33,12 @@ try:
 except ImportError:
     _LLVM_SYMBOLIZER = 'llvm-symbolizer'
 
+# Maximum number of addresses written to llvm-symbolizer before its results
+# are read. Requests are small, so a batch always fits in the stdin pipe buffer
+# and writing it cannot block while llvm-symbolizer waits for its output to be
+# read.
+_BATCH_SIZE = 1024
+
 
 class LlvmSymbolizer(symbolizer.Symbolizer):
     """A symbolizer that wraps llvm-symbolizer."""
@@ -44,6 +51,7 @@ class LlvmSymbolizer(symbolizer.Symbolizer):
     ):
         # Lets destructor return cleanly if the binary is not found.
         self._symbolizer = None
+        self._cache: dict[int, symbolizer.Symbol] = {}
         if llvm_symbolizer_binary:
             self._symbolizer_binary = str(llvm_symbolizer_binary)
         else:
@@ -169,23 +177,50 @@ class LlvmSymbolizer(symbolizer.Symbolizer):
 
     def symbolize(self, address: int) -> symbolizer.Symbol:
         """Symbolizes an address using the loaded ELF file."""
+        return self.symbolize_all((address,))[0]
+
+    def symbolize_all(
+        self, addresses: Iterable[int]
+    ) -> list[symbolizer.Symbol]:
+        """Symbolizes a batch of addresses using the loaded ELF file.
+
+        Results are cached, so each distinct address is only resolved by
+        llvm-symbolizer once for the life of this symbolizer. Addresses that
+        are not cached are sent in sorted batches, with all of a batch's
+        requests written before any results are read, rather than making a
+        round trip to llvm-symbolizer for every address.
+        """
+        addresses = list(addresses)
         if not self._symbolizer:
-            return symbolizer.Symbol(address=address, name='', file='', line=0)
+            return [symbolizer.Symbol(address=address) for address in addresses]
 
         with self._lock:
-            if self._symbolizer.returncode is not None:
-                raise ValueError('llvm-symbolizer closed unexpectedly')
+            uncached = sorted(set(addresses).difference(self._cache))
+            for start in range(0, len(uncached), _BATCH_SIZE):
+                self._symbolize_batch(uncached[start : start + _BATCH_SIZE])
 
-            stdin = self._symbolizer.stdin
-            stdout = self._symbolizer.stdout
+            return [self._cache[address] for address in addresses]
 
-            assert stdin is not None
-            assert stdout is not None
+    def _symbolize_batch(self, addresses: list[int]) -> None:
+        """Resolves addresses with llvm-symbolizer and caches the results."""
+        assert self._symbolizer is not None
+        if self._symbolizer.returncode is not None:
+            raise ValueError('llvm-symbolizer closed unexpectedly')
 
-            stdin.write(f'0x{address:08X}\n'.encode())
-            stdin.flush()
+        stdin = self._symbolizer.stdin
+        stdout = self._symbolizer.stdout
 
-            if self._json_mode:
-                return LlvmSymbolizer._read_json_symbol(address, stdout)
+        assert stdin is not None
+        assert stdout is not None
 
-            return LlvmSymbolizer._read_llvm_symbol(address, stdout)
+        stdin.write(
+            ''.join(f'0x{address:08X}\n' for address in addresses).encode()
+        )
+        stdin.flush()
+
+        for address in addresses:
+            if self._json_mode:
+                symbol = LlvmSymbolizer._read_json_symbol(address, stdout)
+            else:
+                symbol = LlvmSymbolizer._read_llvm_symbol(address, stdout)
+            self._cache[address] = symbol
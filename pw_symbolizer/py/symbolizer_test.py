@@ -91,6 +91,23 @@ class TestFakeSymbolizer(unittest.TestCase):
         self.assertEqual(symbol.file, 'source/globals.cc')
         self.assertEqual(symbol.line, 21)
 
+    def test_symbolize_all(self):
+        known_symbols = (
+            pw_symbolizer.Symbol(0x404, 'do_a_flip(int n)', 'tricks.cc', 1403),
+            pw_symbolizer.Symbol(0x808, 'do_a_barrel_roll()', 'tricks.cc', 42),
+        )
+        symbolizer = pw_symbolizer.FakeSymbolizer(known_symbols)
+
+        symbols = symbolizer.symbolize_all([0x808, 0x123, 0x404, 0x808])
+        self.assertEqual(
+            [0x808, 0x123, 0x404, 0x808], [s.address for s in symbols]
+        )
+        self.assertEqual(
+            [known_symbols[1], known_symbols[0], known_symbols[1]],
+            [symbols[0], symbols[2], symbols[3]],
+        )
+        self.assertEqual('', symbols[1].name)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,108 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/adaptive_mutex.h"
+
+#include <chrono>
+
+#include "pw_sync/thread_notification.h"
+#include "pw_sync_private/borrow_lockable_tests.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::sync {
+namespace {
+
+using namespace std::chrono_literals;
+
+TEST(AdaptiveMutex, LockUnlock) {
+  AdaptiveMutex mutex;
+  mutex.lock();
+  mutex.unlock();
+  EXPECT_EQ(mutex.metrics().uncontended, 1u);
+  EXPECT_EQ(mutex.metrics().spun, 0u);
+  EXPECT_EQ(mutex.metrics().blocked, 0u);
+}
+
+TEST(AdaptiveMutex, TryLockUnlock) {
+  AdaptiveMutex mutex;
+  const bool locked = mutex.try_lock();
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock();
+  }
+  EXPECT_EQ(mutex.metrics().uncontended, 1u);
+}
+
+PW_SYNC_ADD_BORROWABLE_LOCK_NAMED_TESTS(BorrowableAdaptiveMutex, AdaptiveMutex);
+
+/// Locks a mutex from another thread, after the test has locked it.
+class ContendedLock {
+ public:
+  explicit ContendedLock(AdaptiveMutex& mutex) : mutex_(mutex) {}
+
+  /// Starts a thread that locks the mutex, and waits until it is about to.
+  void Start() {
+    thread_ = thread::Thread(context_.options(), [this] {
+      started_.release();
+      mutex_.lock();
+      mutex_.unlock();
+    });
+    started_.acquire();
+  }
+
+  void Join() { thread_.join(); }
+
+ private:
+  AdaptiveMutex& mutex_;
+  ThreadNotification started_;
+  thread::test::TestThreadContext context_;
+  thread::Thread thread_;
+};
+
+TEST(AdaptiveMutex, BlocksWithoutSpinning) {
+  AdaptiveMutex mutex(0);
+  ContendedLock contended(mutex);
+  mutex.lock();
+  contended.Start();
+
+  // Give the other thread time to find the mutex held.
+  this_thread::sleep_for(10ms);
+  mutex.unlock();
+  contended.Join();
+
+  EXPECT_EQ(mutex.metrics().uncontended, 1u);
+  EXPECT_EQ(mutex.metrics().spun, 0u);
+  EXPECT_EQ(mutex.metrics().blocked, 1u);
+}
+
+TEST(AdaptiveMutex, SpinsBeforeBlocking) {
+  AdaptiveMutex mutex(AdaptiveMutex::kDefaultMaxSpins);
+  ContendedLock contended(mutex);
+  mutex.lock();
+  contended.Start();
+  this_thread::sleep_for(10ms);
+  mutex.unlock();
+  contended.Join();
+
+  // Whether the other thread acquires the mutex while spinning depends on
+  // scheduling, but it must have found the mutex held.
+  EXPECT_EQ(mutex.metrics().uncontended, 1u);
+  EXPECT_EQ(mutex.metrics().spun + mutex.metrics().blocked, 1u);
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -30,6 +30,12 @@ pw_add_backend_variable(pw_sync.mutex_BACKEND)
 # Backend for the pw_sync module's timed mutex.
 pw_add_backend_variable(pw_sync.timed_mutex_BACKEND)
 
+# Backend for the pw_sync module's shared mutex.
+pw_add_backend_variable(pw_sync.shared_mutex_BACKEND)
+
+# Backend for the pw_sync module's timed shared mutex.
+pw_add_backend_variable(pw_sync.timed_shared_mutex_BACKEND)
+
 # Backend for the pw_sync module's recursive mutex.
 pw_add_backend_variable(pw_sync.recursive_mutex_BACKEND)
 
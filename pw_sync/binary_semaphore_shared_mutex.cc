@@ -0,0 +1,134 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/backends/binary_semaphore_shared_mutex_native.h"
+
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::sync::backend {
+
+NativeSharedMutex::~NativeSharedMutex() {
+  const bool exclusively_locked = !gate_.try_acquire();
+  PW_CHECK(!exclusively_locked,
+           "SharedMutex was locked when it went out of scope");
+  std::lock_guard lock(state_lock_);
+  PW_CHECK_UINT_EQ(readers_,
+                   0,
+                   "SharedMutex was shared locked when it went out of scope");
+}
+
+bool NativeSharedMutex::AcquireGate(
+    std::optional<chrono::SystemClock::time_point> deadline) {
+  if (!deadline.has_value()) {
+    gate_.acquire();
+    return true;
+  }
+  return gate_.try_acquire_until(*deadline);
+}
+
+bool NativeSharedMutex::LockUntil(
+    std::optional<chrono::SystemClock::time_point> deadline) {
+  if (!AcquireGate(deadline)) {
+    return false;
+  }
+  {
+    std::lock_guard lock(state_lock_);
+    if (readers_ == 0) {
+      return true;
+    }
+    writer_waiting_ = true;
+  }
+
+  // New readers are held at the gate; wait for the remaining ones to leave.
+  if (!deadline.has_value()) {
+    readers_done_.acquire();
+    return true;
+  }
+  if (readers_done_.try_acquire_until(*deadline)) {
+    return true;
+  }
+  bool timed_out;
+  {
+    std::lock_guard lock(state_lock_);
+    timed_out = writer_waiting_;
+    writer_waiting_ = false;
+  }
+  if (!timed_out) {
+    // The last reader left between the timeout and this check. Consume its
+    // release, which does not block, and keep the lock.
+    readers_done_.acquire();
+    return true;
+  }
+  gate_.release();
+  return false;
+}
+
+bool NativeSharedMutex::TryLock() {
+  if (!gate_.try_acquire()) {
+    return false;
+  }
+  {
+    std::lock_guard lock(state_lock_);
+    if (readers_ == 0) {
+      return true;
+    }
+  }
+  gate_.release();
+  return false;
+}
+
+bool NativeSharedMutex::LockSharedUntil(
+    std::optional<chrono::SystemClock::time_point> deadline) {
+  if (!AcquireGate(deadline)) {
+    return false;
+  }
+  {
+    std::lock_guard lock(state_lock_);
+    ++readers_;
+  }
+  gate_.release();
+  return true;
+}
+
+bool NativeSharedMutex::TryLockShared() {
+  if (!gate_.try_acquire()) {
+    return false;
+  }
+  {
+    std::lock_guard lock(state_lock_);
+    ++readers_;
+  }
+  gate_.release();
+  return true;
+}
+
+void NativeSharedMutex::UnlockShared() {
+  bool wake_writer;
+  {
+    std::lock_guard lock(state_lock_);
+    PW_CHECK_UINT_NE(readers_, 0, "Called unlock_shared() while not locked");
+    --readers_;
+    wake_writer = readers_ == 0 && writer_waiting_;
+    if (wake_writer) {
+      writer_waiting_ = false;
+    }
+  }
+  if (wake_writer) {
+    readers_done_.release();
+  }
+}
+
+}  // namespace pw::sync::backend
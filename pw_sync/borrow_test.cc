@@ -58,9 +58,68 @@ TEST(BorrowedPointerTest, MoveAssign) {
   EXPECT_EQ(borrowed->value(), 2);
 }
 
+TEST(SharedBorrowedPointerTest, MoveConstruct) {
+  Derived derived(3);
+  FakeSharedLockable lock;
+  Borrowable<Derived, FakeSharedLockable> borrowable(derived, lock);
+  SharedBorrowedPointer<Base, FakeSharedLockable> borrowed(
+      borrowable.acquire_shared());
+  EXPECT_EQ(borrowed->value(), 3);
+  EXPECT_EQ(lock.shared_count(), 1u);
+}
+
+TEST(SharedBorrowedPointerTest, MoveAssignReleasesPreviousLock) {
+  Derived derived(4);
+  FakeSharedLockable lock;
+  Borrowable<Derived, FakeSharedLockable> borrowable(derived, lock);
+  SharedBorrowedPointer<Derived, FakeSharedLockable> borrowed =
+      borrowable.acquire_shared();
+  borrowed = borrowable.acquire_shared();
+  EXPECT_EQ(borrowed->value(), 4);
+  EXPECT_EQ(lock.shared_count(), 1u);
+}
+
+TEST(BorrowableTest, AcquireShared) {
+  Derived derived(5);
+  FakeSharedLockable lock;
+  Borrowable<Derived, FakeSharedLockable> borrowable(derived, lock);
+  {
+    SharedBorrowedPointer<Derived, FakeSharedLockable> first =
+        borrowable.acquire_shared();
+    SharedBorrowedPointer<Derived, FakeSharedLockable> second =
+        borrowable.acquire_shared();
+    EXPECT_EQ(lock.shared_count(), 2u);
+    EXPECT_EQ((*first).value(), 5);
+    EXPECT_EQ(second->value(), 5);
+    EXPECT_FALSE(borrowable.try_acquire().has_value());
+  }
+  EXPECT_EQ(lock.shared_count(), 0u);
+}
+
+TEST(BorrowableTest, TryAcquireSharedFailsWhileAcquired) {
+  Derived derived(6);
+  FakeSharedLockable lock;
+  Borrowable<Derived, FakeSharedLockable> borrowable(derived, lock);
+  {
+    BorrowedPointer<Derived, FakeSharedLockable> borrowed =
+        borrowable.acquire();
+    EXPECT_FALSE(borrowable.try_acquire_shared().has_value());
+    EXPECT_FALSE(
+        borrowable.try_acquire_shared_for(FakeClock::duration(1)).has_value());
+    EXPECT_FALSE(
+        borrowable.try_acquire_shared_until(FakeClock::time_point())
+            .has_value());
+  }
+  std::optional<SharedBorrowedPointer<Derived, FakeSharedLockable>> borrowed =
+      borrowable.try_acquire_shared();
+  ASSERT_TRUE(borrowed.has_value());
+  EXPECT_EQ((*borrowed)->value(), 6);
+}
+
 PW_SYNC_ADD_BORROWABLE_LOCK_TESTS(FakeBasicLockable);
 PW_SYNC_ADD_BORROWABLE_LOCK_TESTS(FakeLockable);
 PW_SYNC_ADD_BORROWABLE_TIMED_LOCK_TESTS(FakeTimedLockable, FakeClock);
+PW_SYNC_ADD_BORROWABLE_TIMED_LOCK_TESTS(FakeSharedLockable, FakeClock);
 
 }  // namespace
 }  // namespace pw::sync::test
@@ -41,4 +41,33 @@ bool FakeLockable::try_lock() {
   return true;
 }
 
+bool FakeSharedLockable::try_lock() {
+  return shared_count_ == 0 && FakeLockable::try_lock();
+}
+
+void FakeSharedLockable::DoLockOperation(Operation operation) {
+  if (operation == Operation::kLock) {
+    PW_CHECK_UINT_EQ(shared_count_, 0, "Lock while shared locked detected");
+  }
+  FakeBasicLockable::DoLockOperation(operation);
+}
+
+void FakeSharedLockable::lock_shared() {
+  PW_CHECK(!locked(), "Shared lock while exclusively locked detected");
+  ++shared_count_;
+}
+
+bool FakeSharedLockable::try_lock_shared() {
+  if (locked()) {
+    return false;
+  }
+  ++shared_count_;
+  return true;
+}
+
+void FakeSharedLockable::unlock_shared() {
+  PW_CHECK_UINT_NE(shared_count_, 0, "Shared unlock while unlocked detected");
+  --shared_count_;
+}
+
 }  // namespace pw::sync::test
@@ -59,4 +59,26 @@ TEST(LockTraitsTest, IsTimedLockable) {
   EXPECT_TRUE((is_timed_lockable_v<FakeTimedLockable, FakeClock>));
 }
 
+TEST(LockTraitsTest, IsSharedLockable) {
+  EXPECT_FALSE(is_shared_lockable_v<NotALock>);
+  EXPECT_FALSE(is_shared_lockable_v<FakeLockable>);
+  EXPECT_FALSE(is_shared_lockable_v<FakeTimedLockable>);
+  EXPECT_TRUE(is_shared_lockable_v<FakeSharedLockable>);
+}
+
+TEST(LockTraitsTest, IsSharedLockableForAndUntil) {
+  EXPECT_FALSE(
+      (is_shared_lockable_for_v<FakeTimedLockable, FakeClock::duration>));
+  EXPECT_FALSE(
+      (is_shared_lockable_for_v<FakeSharedLockable, NotAClock::duration>));
+  EXPECT_TRUE(
+      (is_shared_lockable_for_v<FakeSharedLockable, FakeClock::duration>));
+  EXPECT_FALSE(
+      (is_shared_lockable_until_v<FakeTimedLockable, FakeClock::time_point>));
+  EXPECT_FALSE(
+      (is_shared_lockable_until_v<FakeSharedLockable, NotAClock::time_point>));
+  EXPECT_TRUE(
+      (is_shared_lockable_until_v<FakeSharedLockable, FakeClock::time_point>));
+}
+
 }  // namespace pw::sync::test
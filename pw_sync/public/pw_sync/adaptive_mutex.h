@@ -0,0 +1,147 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_sync/yield_core.h"
+
+namespace pw::sync {
+
+/// The `AdaptiveMutex` is a `Mutex` that briefly spins before blocking.
+///
+/// When a critical section is very short, a thread that finds the mutex held
+/// is likely to see it released within a few hundred cycles. Blocking in that
+/// case costs two context switches, which can take far longer than the
+/// critical section itself. An `AdaptiveMutex` instead polls the mutex up to
+/// a bounded number of times, hinting to the core that it is spinning between
+/// polls, and only blocks on the underlying `Mutex` if it is still held.
+///
+/// Spinning only helps when the holder can make progress at the same time,
+/// i.e. on a multi-core system. On a single core, construct the mutex with a
+/// `max_spins` of 0 so it blocks immediately.
+///
+/// The mutex records how often it was acquired without contention, after
+/// spinning, and after blocking. These metrics can be used to tune
+/// `max_spins`: if most contended acquisitions block, spinning only wastes
+/// cycles, and if most succeed after spinning, the critical sections are short
+/// enough to benefit from it.
+///
+/// Like `Mutex`, this is thread safe, but NOT IRQ safe.
+class PW_LOCKABLE("pw::sync::AdaptiveMutex") AdaptiveMutex {
+ public:
+  /// Counts of how the mutex was acquired.
+  ///
+  /// The counts are updated while the mutex is held, so they are only
+  /// consistent when read with the mutex held.
+  struct Metrics {
+    /// Acquisitions that found the mutex free.
+    uint32_t uncontended = 0;
+
+    /// Acquisitions that found the mutex held, and acquired it by spinning.
+    uint32_t spun = 0;
+
+    /// Acquisitions that found the mutex held, and blocked after spinning.
+    uint32_t blocked = 0;
+  };
+
+  /// Default maximum number of times to poll a held mutex before blocking.
+  static constexpr uint32_t kDefaultMaxSpins = 100;
+
+  /// Constructs the mutex.
+  ///
+  /// @param max_spins  Maximum number of times to poll the mutex before
+  ///                   blocking, when it is held by another thread.
+  explicit AdaptiveMutex(uint32_t max_spins = kDefaultMaxSpins)
+      : max_spins_(max_spins) {}
+
+  AdaptiveMutex(const AdaptiveMutex&) = delete;
+  AdaptiveMutex(AdaptiveMutex&&) = delete;
+  AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+  AdaptiveMutex& operator=(AdaptiveMutex&&) = delete;
+
+  /// Locks the mutex, spinning and then blocking indefinitely. Failures are
+  /// fatal.
+  ///
+  /// @b PRECONDITION:
+  ///   The lock isn't already held by this thread. Recursive locking is
+  ///   undefined behavior.
+  void lock() PW_EXCLUSIVE_LOCK_FUNCTION() {
+    if (mutex_.try_lock()) {
+      held_.store(true, std::memory_order_relaxed);
+      ++metrics_.uncontended;
+      return;
+    }
+    if (Spin()) {
+      ++metrics_.spun;
+      return;
+    }
+    mutex_.lock();
+    held_.store(true, std::memory_order_relaxed);
+    ++metrics_.blocked;
+  }
+
+  /// Attempts to lock the mutex in a non-blocking manner.
+  /// Returns true if the mutex was successfully acquired.
+  ///
+  /// @b PRECONDITION:
+  ///   The lock isn't already held by this thread. Recursive locking is
+  ///   undefined behavior.
+  bool try_lock() PW_EXCLUSIVE_TRYLOCK_FUNCTION(true) {
+    if (!mutex_.try_lock()) {
+      return false;
+    }
+    held_.store(true, std::memory_order_relaxed);
+    ++metrics_.uncontended;
+    return true;
+  }
+
+  /// Unlocks the mutex. Failures are fatal.
+  ///
+  /// @b PRECONDITION:
+  ///   The mutex is held by this thread.
+  void unlock() PW_UNLOCK_FUNCTION() {
+    held_.store(false, std::memory_order_relaxed);
+    mutex_.unlock();
+  }
+
+  /// Returns counts of how the mutex was acquired.
+  const Metrics& metrics() const { return metrics_; }
+
+ private:
+  /// Polls the mutex until it is acquired or `max_spins_` polls have been made.
+  /// Returns whether the mutex was acquired.
+  bool Spin() PW_NO_LOCK_SAFETY_ANALYSIS {
+    for (uint32_t i = 0; i < max_spins_; ++i) {
+      PW_SYNC_YIELD_CORE_FOR_SMT();
+      // Only try the mutex when it appears to be free, to avoid the cost of
+      // calling into the RTOS on every iteration.
+      if (!held_.load(std::memory_order_relaxed) && mutex_.try_lock()) {
+        held_.store(true, std::memory_order_relaxed);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  Mutex mutex_;
+  std::atomic<bool> held_ = false;
+  const uint32_t max_spins_;
+  Metrics metrics_;
+};
+
+}  // namespace pw::sync
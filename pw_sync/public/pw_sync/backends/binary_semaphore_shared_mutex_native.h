@@ -0,0 +1,74 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_sync/binary_semaphore.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::sync::backend {
+
+// Portable reader-writer lock for kernels without one, built from a pair of
+// binary semaphores and an interrupt spin lock.
+//
+// Writers and new readers pass through `gate_`. A writer keeps the gate until
+// it unlocks, which blocks new readers and so keeps a steady stream of readers
+// from starving writers. While holding the gate, the writer waits on
+// `readers_done_` until the readers that were already inside have left.
+//
+// Readers only hold the gate long enough to increment the reader count, so a
+// failed `try_lock_shared` may be spurious if another reader is entering at
+// the same time.
+class NativeSharedMutex {
+ public:
+  NativeSharedMutex() { gate_.release(); }
+
+  ~NativeSharedMutex();
+
+  void Lock() { LockUntil(std::nullopt); }
+  bool TryLock();
+  bool TryLockUntil(chrono::SystemClock::time_point deadline) {
+    return LockUntil(deadline);
+  }
+  void Unlock() { gate_.release(); }
+
+  void LockShared() { LockSharedUntil(std::nullopt); }
+  bool TryLockShared();
+  bool TryLockSharedUntil(chrono::SystemClock::time_point deadline) {
+    return LockSharedUntil(deadline);
+  }
+  void UnlockShared();
+
+ private:
+  // Acquires the gate, waiting until the deadline if one is given.
+  bool AcquireGate(std::optional<chrono::SystemClock::time_point> deadline);
+
+  bool LockUntil(std::optional<chrono::SystemClock::time_point> deadline);
+  bool LockSharedUntil(
+      std::optional<chrono::SystemClock::time_point> deadline);
+
+  BinarySemaphore gate_;
+  BinarySemaphore readers_done_;
+  InterruptSpinLock state_lock_;
+  size_t readers_ PW_GUARDED_BY(state_lock_) = 0;
+  bool writer_waiting_ PW_GUARDED_BY(state_lock_) = false;
+};
+
+using NativeSharedMutexHandle = NativeSharedMutex&;
+
+}  // namespace pw::sync::backend
@@ -143,6 +143,108 @@ class BorrowedPointer {
   friend class BorrowedPointer;
 };
 
+/// The `SharedBorrowedPointer` is an RAII handle which wraps a pointer to a
+/// borrowed object along with a held shared lock which is guarding the object.
+/// When destroyed, the shared lock is released.
+///
+/// Since other threads may hold shared locks at the same time, only const
+/// access to the borrowed object is provided.
+template <typename GuardedType, typename Lock>
+class SharedBorrowedPointer {
+ public:
+  /// Release the shared lock on destruction.
+  ~SharedBorrowedPointer() {
+    if (lock_ != nullptr) {
+      lock_->unlock_shared();
+    }
+  }
+
+  /// Move-constructs a ``SharedBorrowedPointer<T>`` from a
+  /// ``SharedBorrowedPointer<U>``.
+  ///
+  /// As with ``BorrowedPointer``, ``GuardedType`` may be a base class of
+  /// ``OtherType`` and ``Lock`` may be a base class of ``OtherLock``.
+  ///
+  /// @b Postcondition: The other SharedBorrowedPointer is no longer valid and
+  ///     will assert if the GuardedType is accessed.
+  template <typename OtherType, typename OtherLock>
+  SharedBorrowedPointer(SharedBorrowedPointer<OtherType, OtherLock>&& other)
+      : lock_(other.lock_), object_(other.object_) {
+    static_assert(
+        std::is_assignable_v<const GuardedType*&, const OtherType*>,
+        "Attempted to construct a SharedBorrowedPointer from another whose "
+        "GuardedType* is not assignable to this object's GuardedType*.");
+    static_assert(
+        std::is_assignable_v<Lock*&, OtherLock*>,
+        "Attempted to construct a SharedBorrowedPointer from another whose "
+        "Lock* is not assignable to this object's Lock*.");
+    other.lock_ = nullptr;
+    other.object_ = nullptr;
+  }
+
+  /// Move-assigns a ``SharedBorrowedPointer<T>`` from a
+  /// ``SharedBorrowedPointer<U>``.
+  ///
+  /// @b Postcondition: The other SharedBorrowedPointer is no longer valid and
+  ///     will assert if the GuardedType is accessed.
+  template <typename OtherType, typename OtherLock>
+  SharedBorrowedPointer& operator=(
+      SharedBorrowedPointer<OtherType, OtherLock>&& other) {
+    static_assert(
+        std::is_assignable_v<const GuardedType*&, const OtherType*>,
+        "Attempted to construct a SharedBorrowedPointer from another whose "
+        "GuardedType* is not assignable to this object's GuardedType*.");
+    static_assert(
+        std::is_assignable_v<Lock*&, OtherLock*>,
+        "Attempted to construct a SharedBorrowedPointer from another whose "
+        "Lock* is not assignable to this object's Lock*.");
+    if (lock_ != nullptr) {
+      lock_->unlock_shared();
+    }
+    lock_ = other.lock_;
+    object_ = other.object_;
+    other.lock_ = nullptr;
+    other.object_ = nullptr;
+    return *this;
+  }
+  SharedBorrowedPointer(const SharedBorrowedPointer&) = delete;
+  SharedBorrowedPointer& operator=(const SharedBorrowedPointer&) = delete;
+
+  /// Provides read-only access to the borrowed object's members.
+  const GuardedType* operator->() const {
+    PW_ASSERT(object_ != nullptr);  // Ensure this isn't a stale moved instance.
+    return object_;
+  }
+
+  /// Provides read-only access to the borrowed object directly.
+  ///
+  /// @rst
+  /// .. warning:
+  ///    Be careful not to leak references to the borrowed object!
+  /// @endrst
+  const GuardedType& operator*() const {
+    PW_ASSERT(object_ != nullptr);  // Ensure this isn't a stale moved instance.
+    return *object_;
+  }
+
+ private:
+  /// Allow SharedBorrowedPointer creation inside of Borrowable's acquire
+  /// methods.
+  template <typename G, typename L>
+  friend class Borrowable;
+
+  constexpr SharedBorrowedPointer(Lock& lock, const GuardedType& object)
+      : lock_(&lock), object_(&object) {}
+
+  Lock* lock_;
+  const GuardedType* object_;
+
+  /// Allow converting move constructor and assignment to access fields of
+  /// this class.
+  template <typename OtherType, typename OtherLock>
+  friend class SharedBorrowedPointer;
+};
+
 /// The `Borrowable` is a helper construct that enables callers to borrow an
 /// object which is guarded by a lock.
 ///
@@ -154,7 +256,9 @@ class BorrowedPointer {
 /// https://clang.llvm.org/docs/ThreadSafetyAnalysis.html#no-conditionally-held-locks
 ///
 /// This class is compatible with locks which comply with `BasicLockable`,
-/// `Lockable`, and `TimedLockable` C++ named requirements.
+/// `Lockable`, and `TimedLockable` C++ named requirements. If the lock also
+/// complies with `SharedLockable`, e.g. `pw::sync::SharedMutex`, the object can
+/// be borrowed for reading by several callers at once using `acquire_shared`.
 ///
 /// `Borrowable<T>` is covariant with respect to `T`, so that `Borrowable<U>`
 /// can be converted to `Borrowable<T>`, if `U` is a subclass of `T`.
@@ -235,6 +339,71 @@ class Borrowable {
     return BorrowedPointer<GuardedType, Lock>(*lock_, *object_);
   }
 
+  /// Blocks indefinitely until the object can be borrowed for reading.
+  /// Failures are fatal.
+  template <int&... ExplicitArgumentBarrier,
+            typename T = Lock,
+            typename = std::enable_if_t<is_shared_lockable_v<T>>>
+  SharedBorrowedPointer<GuardedType, Lock> acquire_shared() const
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    lock_->lock_shared();
+    return SharedBorrowedPointer<GuardedType, Lock>(*lock_, *object_);
+  }
+
+  /// Tries to borrow the object for reading in a non-blocking manner. Returns a
+  /// `SharedBorrowedPointer` on success, otherwise `std::nullopt` (nothing).
+  template <int&... ExplicitArgumentBarrier,
+            typename T = Lock,
+            typename = std::enable_if_t<is_shared_lockable_v<T>>>
+  std::optional<SharedBorrowedPointer<GuardedType, Lock>> try_acquire_shared()
+      const PW_NO_LOCK_SAFETY_ANALYSIS {
+    if (!lock_->try_lock_shared()) {
+      return std::nullopt;
+    }
+    return SharedBorrowedPointer<GuardedType, Lock>(*lock_, *object_);
+  }
+
+  /// Tries to borrow the object for reading. Blocks until the specified timeout
+  /// has elapsed or the object has been borrowed, whichever comes first.
+  /// Returns a `SharedBorrowedPointer` on success, otherwise `std::nullopt`
+  /// (nothing).
+  template <class Rep,
+            class Period,
+            int&... ExplicitArgumentBarrier,
+            typename T = Lock,
+            typename = std::enable_if_t<
+                is_shared_lockable_for_v<T,
+                                         std::chrono::duration<Rep, Period>>>>
+  std::optional<SharedBorrowedPointer<GuardedType, Lock>>
+  try_acquire_shared_for(std::chrono::duration<Rep, Period> timeout) const
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    if (!lock_->try_lock_shared_for(timeout)) {
+      return std::nullopt;
+    }
+    return SharedBorrowedPointer<GuardedType, Lock>(*lock_, *object_);
+  }
+
+  /// Tries to borrow the object for reading. Blocks until the specified
+  /// deadline has passed or the object has been borrowed, whichever comes
+  /// first. Returns a `SharedBorrowedPointer` on success, otherwise
+  /// `std::nullopt` (nothing).
+  template <class Clock,
+            class Duration,
+            int&... ExplicitArgumentBarrier,
+            typename T = Lock,
+            typename = std::enable_if_t<is_shared_lockable_until_v<
+                T,
+                std::chrono::time_point<Clock, Duration>>>>
+  std::optional<SharedBorrowedPointer<GuardedType, Lock>>
+  try_acquire_shared_until(
+      std::chrono::time_point<Clock, Duration> deadline) const
+      PW_NO_LOCK_SAFETY_ANALYSIS {
+    if (!lock_->try_lock_shared_until(deadline)) {
+      return std::nullopt;
+    }
+    return SharedBorrowedPointer<GuardedType, Lock>(*lock_, *object_);
+  }
+
  private:
   Lock* lock_;
   GuardedType* object_;
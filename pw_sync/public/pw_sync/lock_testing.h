@@ -17,6 +17,7 @@
 /// but do no actual locking. They are only intended for use in tests.
 
 #include <chrono>
+#include <cstddef>
 #include <ratio>
 
 #include "pw_sync/virtual_basic_lockable.h"
@@ -31,10 +32,9 @@ class FakeBasicLockable : public VirtualBasicLockable {
   bool locked() const { return locked_; }
 
  protected:
-  bool locked_ = false;
-
- private:
   void DoLockOperation(Operation operation) override;
+
+  bool locked_ = false;
 };
 
 /// Fake lock that meet's C++'s \em Lockable named requirement.
@@ -69,4 +69,29 @@ class FakeTimedLockable : public FakeLockable {
   bool try_lock_until(const FakeClock::time_point&) { return try_lock(); }
 };
 
+/// Fake lock that meet's C++'s \em SharedLockable and \em SharedTimedLockable
+/// named requirements, in addition to \em TimedLockable.
+class FakeSharedLockable : public FakeTimedLockable {
+ public:
+  size_t shared_count() const { return shared_count_; }
+
+  bool try_lock();
+
+  void lock_shared();
+  bool try_lock_shared();
+  void unlock_shared();
+
+  bool try_lock_shared_for(const FakeClock::duration&) {
+    return try_lock_shared();
+  }
+  bool try_lock_shared_until(const FakeClock::time_point&) {
+    return try_lock_shared();
+  }
+
+ private:
+  void DoLockOperation(Operation operation) override;
+
+  size_t shared_count_ = 0;
+};
+
 }  // namespace pw::sync::test
@@ -17,7 +17,8 @@
 #include <utility>
 
 /// This file provide trait types that can be used to check C++ lock-related
-/// named requirements: BasicLockable, Lockable, and TimedLockable.
+/// named requirements: BasicLockable, Lockable, TimedLockable, and
+/// SharedLockable.
 
 namespace pw::sync {
 
@@ -120,4 +121,75 @@ template <typename Lock, typename Clock>
 inline constexpr bool is_timed_lockable_v =
     is_timed_lockable<Lock, Clock>::value;
 
+/// Checks if a type can be locked for shared ownership.
+///
+/// If `Lock` has valid `lock_shared`, `try_lock_shared`, and `unlock_shared`
+/// methods, as described by C++'s \em SharedLockable named requirement,
+/// provides the member constant value equal to true. Otherwise value is false.
+///
+/// @{
+template <typename Lock, typename = void>
+struct is_shared_lockable : std::false_type {};
+
+template <typename Lock>
+struct is_shared_lockable<
+    Lock,
+    std::void_t<decltype(std::declval<Lock>().lock_shared()),
+                decltype(std::declval<Lock>().try_lock_shared()),
+                decltype(std::declval<Lock>().unlock_shared())>>
+    : std::true_type {};
+/// @}
+
+/// Helper variable template for `is_shared_lockable<Lock>::value`.
+template <typename Lock>
+inline constexpr bool is_shared_lockable_v = is_shared_lockable<Lock>::value;
+
+/// Checks if a type can be locked for shared ownership within a set time.
+///
+/// If `Lock` has a valid `try_lock_shared_for` method, as described by C++'s
+/// \em SharedTimedLockable named requirement, provides the member constant
+/// value equal to true. Otherwise value is false.
+///
+/// @{
+template <typename Lock, typename Duration, typename = void>
+struct is_shared_lockable_for : std::false_type {};
+
+template <typename Lock, typename Duration>
+struct is_shared_lockable_for<
+    Lock,
+    Duration,
+    std::void_t<decltype(std::declval<Lock>().try_lock_shared_for(
+        std::declval<Duration>()))>> : is_shared_lockable<Lock> {};
+/// @}
+
+/// Helper variable template for
+/// `is_shared_lockable_for<Lock, Duration>::value`.
+template <typename Lock, typename Duration>
+inline constexpr bool is_shared_lockable_for_v =
+    is_shared_lockable_for<Lock, Duration>::value;
+
+/// Checks if a type can be locked for shared ownership by a set time.
+///
+/// If `Lock` has a valid `try_lock_shared_until` method, as described by C++'s
+/// \em SharedTimedLockable named requirement, provides the member constant
+/// value equal to true. Otherwise value is false.
+///
+/// @{
+template <typename Lock, typename TimePoint, typename = void>
+struct is_shared_lockable_until : std::false_type {};
+
+template <typename Lock, typename TimePoint>
+struct is_shared_lockable_until<
+    Lock,
+    TimePoint,
+    std::void_t<decltype(std::declval<Lock>().try_lock_shared_until(
+        std::declval<TimePoint>()))>> : is_shared_lockable<Lock> {};
+/// @}
+
+/// Helper variable template for
+/// `is_shared_lockable_until<Lock, TimePoint>::value`.
+template <typename Lock, typename TimePoint>
+inline constexpr bool is_shared_lockable_until_v =
+    is_shared_lockable_until<Lock, TimePoint>::value;
+
 }  // namespace pw::sync
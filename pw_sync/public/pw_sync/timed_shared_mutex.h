@@ -0,0 +1,86 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_chrono/system_clock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/shared_mutex.h"
+
+namespace pw::sync {
+
+/// The `TimedSharedMutex` extends the `SharedMutex` with timeouts and
+/// deadlines for both exclusive and shared ownership. This is thread safe, but
+/// NOT IRQ safe.
+///
+/// @rst
+/// .. warning::
+///
+///    In order to support global statically constructed TimedSharedMutexes,
+///    the user and/or backend MUST ensure that any initialization required in
+///    your environment is done prior to the creation and/or initialization of
+///    the native synchronization primitives (e.g. kernel initialization).
+/// @endrst
+class TimedSharedMutex : public SharedMutex {
+ public:
+  TimedSharedMutex() = default;
+  ~TimedSharedMutex() = default;
+  TimedSharedMutex(const TimedSharedMutex&) = delete;
+  TimedSharedMutex(TimedSharedMutex&&) = delete;
+  TimedSharedMutex& operator=(const TimedSharedMutex&) = delete;
+  TimedSharedMutex& operator=(TimedSharedMutex&&) = delete;
+
+  /// Tries to lock the mutex for exclusive ownership. Blocks until the
+  /// specified timeout has elapsed or the lock is acquired, whichever comes
+  /// first. Returns true if the mutex was successfully acquired.
+  ///
+  /// @b PRECONDITION:
+  ///   The lock isn't already held by this thread. Recursive locking is
+  ///   undefined behavior.
+  bool try_lock_for(chrono::SystemClock::duration timeout)
+      PW_EXCLUSIVE_TRYLOCK_FUNCTION(true);
+
+  /// Tries to lock the mutex for exclusive ownership. Blocks until the
+  /// specified deadline has been reached or the lock is acquired, whichever
+  /// comes first. Returns true if the mutex was successfully acquired.
+  ///
+  /// @b PRECONDITION:
+  ///   The lock isn't already held by this thread. Recursive locking is
+  ///   undefined behavior.
+  bool try_lock_until(chrono::SystemClock::time_point deadline)
+      PW_EXCLUSIVE_TRYLOCK_FUNCTION(true);
+
+  /// Tries to lock the mutex for shared ownership. Blocks until the specified
+  /// timeout has elapsed or the lock is acquired, whichever comes first.
+  /// Returns true if the mutex was successfully acquired.
+  ///
+  /// @b PRECONDITION:
+  ///   The lock isn't already held by this thread. Recursive locking is
+  ///   undefined behavior.
+  bool try_lock_shared_for(chrono::SystemClock::duration timeout)
+      PW_SHARED_TRYLOCK_FUNCTION(true);
+
+  /// Tries to lock the mutex for shared ownership. Blocks until the specified
+  /// deadline has been reached or the lock is acquired, whichever comes first.
+  /// Returns true if the mutex was successfully acquired.
+  ///
+  /// @b PRECONDITION:
+  ///   The lock isn't already held by this thread. Recursive locking is
+  ///   undefined behavior.
+  bool try_lock_shared_until(chrono::SystemClock::time_point deadline)
+      PW_SHARED_TRYLOCK_FUNCTION(true);
+};
+
+}  // namespace pw::sync
+
+#include "pw_sync_backend/timed_shared_mutex_inline.h"
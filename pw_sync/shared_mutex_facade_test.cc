@@ -0,0 +1,152 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/shared_mutex.h"
+
+#include <atomic>
+#include <chrono>
+
+#include "pw_sync_private/borrow_lockable_tests.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::sync {
+namespace {
+
+using namespace std::chrono_literals;
+
+// Runs `body` on another thread and waits for it to finish.
+template <typename Body>
+void RunOnOtherThread(Body& body) {
+  thread::test::TestThreadContext context;
+  thread::Thread thread(context.options(), [&body] { body(); });
+  thread.join();
+}
+
+TEST(SharedMutex, LockUnlock) {
+  SharedMutex mutex;
+  mutex.lock();
+  mutex.unlock();
+}
+
+SharedMutex static_mutex;
+TEST(SharedMutex, LockUnlockStatic) {
+  static_mutex.lock();
+  static_mutex.unlock();
+}
+
+TEST(SharedMutex, TryLockUnlock) {
+  SharedMutex mutex;
+  const bool locked = mutex.try_lock();
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock();
+  }
+}
+
+TEST(SharedMutex, LockSharedUnlockShared) {
+  SharedMutex mutex;
+  mutex.lock_shared();
+  mutex.unlock_shared();
+  const bool locked = mutex.try_lock_shared();
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock_shared();
+  }
+}
+
+TEST(SharedMutex, SharedLockAllowsOtherReaders) {
+  SharedMutex mutex;
+  bool shared_locked = false;
+  bool locked = true;
+  auto try_both = [&] {
+    shared_locked = mutex.try_lock_shared();
+    if (shared_locked) {
+      mutex.unlock_shared();
+    }
+    locked = mutex.try_lock();
+    if (locked) {
+      mutex.unlock();
+    }
+  };
+
+  mutex.lock_shared();
+  RunOnOtherThread(try_both);
+  mutex.unlock_shared();
+  EXPECT_TRUE(shared_locked);
+  EXPECT_FALSE(locked);
+}
+
+TEST(SharedMutex, LockExcludesReaders) {
+  SharedMutex mutex;
+  bool shared_locked = true;
+  auto try_lock_shared = [&] {
+    shared_locked = mutex.try_lock_shared();
+    if (shared_locked) {
+      mutex.unlock_shared();
+    }
+  };
+
+  mutex.lock();
+  RunOnOtherThread(try_lock_shared);
+  mutex.unlock();
+  EXPECT_FALSE(shared_locked);
+}
+
+TEST(SharedMutex, WriterWaitsForReaders) {
+  struct {
+    SharedMutex mutex;
+    std::atomic<bool> locked = false;
+  } state;
+
+  state.mutex.lock_shared();
+  thread::test::TestThreadContext context;
+  thread::Thread writer(context.options(), [&state] {
+    state.mutex.lock();
+    state.locked = true;
+    state.mutex.unlock();
+  });
+
+  // Give the writer time to find the mutex shared.
+  this_thread::sleep_for(10ms);
+  EXPECT_FALSE(state.locked);
+  state.mutex.unlock_shared();
+  writer.join();
+  EXPECT_TRUE(state.locked);
+}
+
+PW_SYNC_ADD_BORROWABLE_LOCK_NAMED_TESTS(BorrowableSharedMutex, SharedMutex);
+
+TEST(SharedMutex, BorrowableAcquireShared) {
+  SharedMutex mutex;
+  int value = 42;
+  Borrowable<int, SharedMutex> borrowable(value, mutex);
+  {
+    SharedBorrowedPointer<int, SharedMutex> borrowed =
+        borrowable.acquire_shared();
+    EXPECT_EQ(*borrowed, 42);
+  }
+  {
+    std::optional<SharedBorrowedPointer<int, SharedMutex>> borrowed =
+        borrowable.try_acquire_shared();
+    ASSERT_TRUE(borrowed.has_value());
+    EXPECT_EQ(**borrowed, 42);
+  }
+  EXPECT_TRUE(borrowable.try_acquire().has_value());
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -0,0 +1,166 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/timed_shared_mutex.h"
+
+#include <chrono>
+
+#include "pw_chrono/system_clock.h"
+#include "pw_sync_private/borrow_lockable_tests.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::sync {
+namespace {
+
+using ::pw::chrono::SystemClock;
+using namespace std::chrono_literals;
+
+// We can't control the SystemClock's period configuration, so just in case
+// duration cannot be accurately expressed in integer ticks, round the
+// duration up.
+constexpr SystemClock::duration kRoundedArbitraryDuration =
+    SystemClock::for_at_least(42ms);
+
+// Runs `body` on another thread and waits for it to finish.
+template <typename Body>
+void RunOnOtherThread(Body& body) {
+  thread::test::TestThreadContext context;
+  thread::Thread thread(context.options(), [&body] { body(); });
+  thread.join();
+}
+
+TEST(TimedSharedMutex, TryLockUnlockFor) {
+  TimedSharedMutex mutex;
+  SystemClock::time_point before = SystemClock::now();
+  const bool locked = mutex.try_lock_for(kRoundedArbitraryDuration);
+  EXPECT_TRUE(locked);
+  if (locked) {
+    SystemClock::duration time_elapsed = SystemClock::now() - before;
+    EXPECT_LT(time_elapsed, kRoundedArbitraryDuration);
+    mutex.unlock();
+  }
+}
+
+TEST(TimedSharedMutex, TryLockUnlockUntil) {
+  TimedSharedMutex mutex;
+  const SystemClock::time_point deadline =
+      SystemClock::now() + kRoundedArbitraryDuration;
+  const bool locked = mutex.try_lock_until(deadline);
+  EXPECT_TRUE(locked);
+  if (locked) {
+    EXPECT_LT(SystemClock::now(), deadline);
+    mutex.unlock();
+  }
+}
+
+TEST(TimedSharedMutex, TryLockSharedUnlockSharedFor) {
+  TimedSharedMutex mutex;
+  const bool locked = mutex.try_lock_shared_for(kRoundedArbitraryDuration);
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock_shared();
+  }
+}
+
+TEST(TimedSharedMutex, TryLockSharedUnlockSharedUntil) {
+  TimedSharedMutex mutex;
+  const bool locked = mutex.try_lock_shared_until(SystemClock::now() +
+                                                  kRoundedArbitraryDuration);
+  EXPECT_TRUE(locked);
+  if (locked) {
+    mutex.unlock_shared();
+  }
+}
+
+TEST(TimedSharedMutex, TryLockForTimesOutWhileShared) {
+  TimedSharedMutex mutex;
+  bool locked = true;
+  SystemClock::duration time_elapsed{};
+  auto try_lock_for = [&] {
+    const SystemClock::time_point before = SystemClock::now();
+    locked = mutex.try_lock_for(kRoundedArbitraryDuration);
+    time_elapsed = SystemClock::now() - before;
+    if (locked) {
+      mutex.unlock();
+    }
+  };
+
+  mutex.lock_shared();
+  RunOnOtherThread(try_lock_for);
+  EXPECT_FALSE(locked);
+  EXPECT_GE(time_elapsed, kRoundedArbitraryDuration);
+
+  // The writer that timed out must not keep out new readers.
+  bool shared_locked = false;
+  auto try_lock_shared = [&] {
+    shared_locked = mutex.try_lock_shared();
+    if (shared_locked) {
+      mutex.unlock_shared();
+    }
+  };
+  RunOnOtherThread(try_lock_shared);
+  EXPECT_TRUE(shared_locked);
+  mutex.unlock_shared();
+
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
+
+TEST(TimedSharedMutex, TryLockSharedForTimesOutWhileLocked) {
+  TimedSharedMutex mutex;
+  bool shared_locked = true;
+  SystemClock::duration time_elapsed{};
+  auto try_lock_shared_for = [&] {
+    const SystemClock::time_point before = SystemClock::now();
+    shared_locked = mutex.try_lock_shared_for(kRoundedArbitraryDuration);
+    time_elapsed = SystemClock::now() - before;
+    if (shared_locked) {
+      mutex.unlock_shared();
+    }
+  };
+
+  mutex.lock();
+  RunOnOtherThread(try_lock_shared_for);
+  mutex.unlock();
+  EXPECT_FALSE(shared_locked);
+  EXPECT_GE(time_elapsed, kRoundedArbitraryDuration);
+}
+
+PW_SYNC_ADD_BORROWABLE_TIMED_LOCK_NAMED_TESTS(BorrowableTimedSharedMutex,
+                                              TimedSharedMutex,
+                                              SystemClock);
+
+TEST(TimedSharedMutex, BorrowableTryAcquireSharedFor) {
+  TimedSharedMutex mutex;
+  int value = 42;
+  Borrowable<int, TimedSharedMutex> borrowable(value, mutex);
+  {
+    std::optional<SharedBorrowedPointer<int, TimedSharedMutex>> borrowed =
+        borrowable.try_acquire_shared_for(kRoundedArbitraryDuration);
+    ASSERT_TRUE(borrowed.has_value());
+    EXPECT_EQ(**borrowed, 42);
+  }
+  {
+    std::optional<SharedBorrowedPointer<int, TimedSharedMutex>> borrowed =
+        borrowable.try_acquire_shared_until(SystemClock::now() +
+                                            kRoundedArbitraryDuration);
+    ASSERT_TRUE(borrowed.has_value());
+    EXPECT_EQ(**borrowed, 42);
+  }
+}
+
+}  // namespace
+}  // namespace pw::sync
@@ -0,0 +1,33 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync/binary_semaphore.h"
+
+using pw::chrono::SystemClock;
+
+namespace pw::sync {
+
+void BinarySemaphore::release() { native_type_.ReleaseBinary(); }
+
+void BinarySemaphore::acquire() { native_type_.Acquire(); }
+
+bool BinarySemaphore::try_acquire() noexcept {
+  return native_type_.TryAcquire();
+}
+
+bool BinarySemaphore::try_acquire_until(SystemClock::time_point deadline) {
+  return native_type_.TryAcquireUntil(deadline);
+}
+
+}  // namespace pw::sync
@@ -0,0 +1,120 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync_stl/futex_semaphore.h"
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+using pw::chrono::SystemClock;
+
+namespace pw::sync::backend {
+namespace {
+
+// Sleeps until woken if *word is still 0, or until the timeout expires.
+// Returns early on spurious wakeups and signals, so callers must recheck.
+void FutexWait(std::atomic<uint32_t>& word, const timespec* timeout) {
+  syscall(SYS_futex,
+          reinterpret_cast<uint32_t*>(&word),
+          FUTEX_WAIT_PRIVATE,
+          0u,
+          timeout,
+          nullptr,
+          0u);
+}
+
+void FutexWake(std::atomic<uint32_t>& word, uint32_t count) {
+  syscall(SYS_futex,
+          reinterpret_cast<uint32_t*>(&word),
+          FUTEX_WAKE_PRIVATE,
+          count,
+          nullptr,
+          nullptr,
+          0u);
+}
+
+}  // namespace
+
+// A sleeping thread increments sleepers_ before the kernel checks that count_
+// is 0, and a releasing thread checks sleepers_ after updating count_. Since
+// both are sequentially consistent, either the release sees the sleeper and
+// wakes it, or the kernel sees the new count and doesn't put the thread to
+// sleep.
+
+void FutexSemaphore::Release(uint32_t update) {
+  count_.fetch_add(update);
+  Wake(update);
+}
+
+void FutexSemaphore::ReleaseBinary() {
+  count_.store(1);
+  Wake(1);
+}
+
+void FutexSemaphore::Wake(uint32_t count) {
+  if (sleepers_.load() != 0) {
+    FutexWake(count_, std::min(count, kMaxCount));
+  }
+}
+
+void FutexSemaphore::Acquire() {
+  while (!TryAcquire()) {
+    sleepers_.fetch_add(1);
+    FutexWait(count_, nullptr);
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+bool FutexSemaphore::TryAcquire() {
+  uint32_t count = count_.load(std::memory_order_relaxed);
+  while (count != 0) {
+    if (count_.compare_exchange_weak(count,
+                                     count - 1,
+                                     std::memory_order_acquire,
+                                     std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool FutexSemaphore::TryAcquireUntil(SystemClock::time_point deadline) {
+  // The timeout is recomputed from the deadline after every wakeup, so
+  // spurious wakeups don't extend the effective deadline.
+  while (!TryAcquire()) {
+    const SystemClock::time_point now = SystemClock::now();
+    if (now >= deadline) {
+      return false;
+    }
+    const auto remaining =
+        std::chrono::ceil<std::chrono::nanoseconds>(deadline - now);
+    const auto seconds = std::chrono::floor<std::chrono::seconds>(remaining);
+    timespec timeout;
+    timeout.tv_sec = static_cast<decltype(timeout.tv_sec)>(seconds.count());
+    timeout.tv_nsec =
+        static_cast<decltype(timeout.tv_nsec)>((remaining - seconds).count());
+
+    sleepers_.fetch_add(1);
+    FutexWait(count_, &timeout);
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+}  // namespace pw::sync::backend
@@ -0,0 +1,105 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_sync_stl/futex_semaphore.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "pw_unit_test/framework.h"
+
+using pw::chrono::SystemClock;
+using namespace std::chrono_literals;
+
+namespace pw::sync::backend {
+namespace {
+
+TEST(FutexSemaphore, TryAcquire) {
+  FutexSemaphore semaphore;
+  EXPECT_FALSE(semaphore.TryAcquire());
+  semaphore.Release(2);
+  EXPECT_TRUE(semaphore.TryAcquire());
+  EXPECT_TRUE(semaphore.TryAcquire());
+  EXPECT_FALSE(semaphore.TryAcquire());
+}
+
+TEST(FutexSemaphore, ReleaseBinary_IsAcquiredOnce) {
+  FutexSemaphore semaphore;
+  semaphore.ReleaseBinary();
+  semaphore.ReleaseBinary();
+  EXPECT_TRUE(semaphore.TryAcquire());
+  EXPECT_FALSE(semaphore.TryAcquire());
+}
+
+TEST(FutexSemaphore, TryAcquireUntil_TimesOut) {
+  FutexSemaphore semaphore;
+  const SystemClock::time_point deadline = SystemClock::now() + 10ms;
+  EXPECT_FALSE(semaphore.TryAcquireUntil(deadline));
+  EXPECT_GE(SystemClock::now(), deadline);
+}
+
+TEST(FutexSemaphore, TryAcquireUntil_Released) {
+  FutexSemaphore semaphore;
+  std::thread releaser([&semaphore] {
+    std::this_thread::sleep_for(10ms);
+    semaphore.Release(1);
+  });
+  EXPECT_TRUE(semaphore.TryAcquireUntil(SystemClock::now() + 60s));
+  releaser.join();
+}
+
+TEST(FutexSemaphore, Acquire_WakesSleepingThreads) {
+  FutexSemaphore semaphore;
+  std::atomic<int> acquired = 0;
+  std::array<std::thread, 4> threads;
+  for (std::thread& thread : threads) {
+    thread = std::thread([&] {
+      semaphore.Acquire();
+      acquired.fetch_add(1);
+    });
+  }
+
+  std::this_thread::sleep_for(10ms);
+  EXPECT_EQ(acquired.load(), 0);
+
+  semaphore.Release(static_cast<uint32_t>(threads.size()));
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(acquired.load(), static_cast<int>(threads.size()));
+  EXPECT_FALSE(semaphore.TryAcquire());
+}
+
+TEST(FutexSemaphore, PingPong) {
+  // Each release must wake the other thread, or this deadlocks.
+  constexpr int kRounds = 10000;
+  FutexSemaphore ping;
+  FutexSemaphore pong;
+  std::thread ponger([&] {
+    for (int i = 0; i < kRounds; ++i) {
+      ping.Acquire();
+      pong.ReleaseBinary();
+    }
+  });
+  for (int i = 0; i < kRounds; ++i) {
+    ping.ReleaseBinary();
+    pong.Acquire();
+  }
+  ponger.join();
+}
+
+}  // namespace
+}  // namespace pw::sync::backend
@@ -0,0 +1,70 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+#include "pw_chrono/system_clock.h"
+
+namespace pw::sync::backend {
+
+// A semaphore built directly on a Linux futex, which backs the futex variants
+// of the pw::sync::BinarySemaphore and pw::sync::CountingSemaphore backends.
+//
+// The count is a futex word, so releasing and acquiring without contention
+// are single atomic operations. A thread only makes a syscall to sleep when
+// the count is zero, and a release only makes a syscall to wake a thread when
+// another thread is sleeping.
+class FutexSemaphore {
+ public:
+  static constexpr uint32_t kMaxCount = std::numeric_limits<int32_t>::max();
+
+  constexpr FutexSemaphore() = default;
+
+  FutexSemaphore(const FutexSemaphore&) = delete;
+  FutexSemaphore& operator=(const FutexSemaphore&) = delete;
+
+  // Adds update to the count, and wakes up to update sleeping threads.
+  void Release(uint32_t update);
+
+  // Sets the count to 1, and wakes a sleeping thread. A count of 1 is only
+  // acquired once, however many times it was released.
+  void ReleaseBinary();
+
+  // Decrements the count, sleeping until it is nonzero.
+  void Acquire();
+
+  // Decrements the count if it is nonzero.
+  bool TryAcquire();
+
+  // Decrements the count, sleeping until it is nonzero or the deadline passes.
+  bool TryAcquireUntil(chrono::SystemClock::time_point deadline);
+
+ private:
+  void Wake(uint32_t count);
+
+  static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                    sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "The count must be usable as a futex word");
+
+  std::atomic<uint32_t> count_ = 0;
+
+  // The number of threads that may be sleeping on count_, which are only woken
+  // when this is nonzero.
+  std::atomic<uint32_t> sleepers_ = 0;
+};
+
+}  // namespace pw::sync::backend
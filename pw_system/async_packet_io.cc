@@ -16,6 +16,8 @@
 
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
+#include "pw_protobuf/multibuf_decoder.h"
+#include "pw_rpc/internal/packet.h"
 #include "pw_system/config.h"
 #include "pw_thread/detached_thread.h"
 
@@ -55,69 +57,146 @@ Status RpcChannelOutputQueue::Send(ConstByteSpan datagram) {
   return OkStatus();
 }
 
-RpcServerThread::RpcServerThread(Allocator& allocator, rpc::Server& server)
-    : allocator_(allocator), rpc_server_(server) {
-  PW_CHECK_OK(rpc_server_.OpenChannel(1, rpc_packet_queue_));
+bool RpcServiceLanes::Assign(const rpc::Service& service, size_t lane) {
+  const uint32_t service_id =
+      rpc::internal::UnwrapServiceId(service.service_id());
+  std::lock_guard lock(mutex_);
+  for (auto entry = entries_.begin(); entry != entries_.end(); ++entry) {
+    if (entry->service_id == service_id) {
+      entries_.erase(entry);
+      break;
+    }
+  }
+  if (lane == 0) {
+    return true;  // Lane 0 is the default.
+  }
+  if (entries_.full()) {
+    return false;
+  }
+  entries_.push_back({service_id, lane});
+  return true;
+}
+
+size_t RpcServiceLanes::LaneForPacket(const multibuf::MultiBuf& packet) const {
+  std::lock_guard lock(mutex_);
+  if (entries_.empty()) {
+    return 0;  // Skip decoding when all services run in lane 0.
+  }
+
+  protobuf::MultiBufDecoder decoder(packet);
+  while (decoder.Next().ok()) {
+    if (decoder.FieldNumber() ==
+        static_cast<uint32_t>(
+            rpc::internal::pwpb::RpcPacket::Fields::kServiceId)) {
+      uint32_t service_id;
+      if (!decoder.ReadFixed32(&service_id).ok()) {
+        break;
+      }
+      return LaneForService(service_id);
+    }
+  }
+  return 0;
+}
+
+size_t RpcServiceLanes::LaneForService(uint32_t service_id) const {
+  for (const Entry& entry : entries_) {
+    if (entry.service_id == service_id) {
+      return entry.lane;
+    }
+  }
+  return 0;
+}
+
+async2::Poll<> RpcServerThread::PendReadyForPacket(async2::Context& cx) {
+  if (ReadyForPacket()) {
+    return async2::Ready();
+  }
+  std::lock_guard lock(mutex_);
+  ready_to_receive_packet_ = cx.GetWaker(async2::WaitReason::Unspecified());
+
+  // Check again now that the waker is stored, in case the RPC thread finished
+  // a packet in between.
+  if (ReadyForPacket()) {
+    return async2::Ready();
+  }
+  return async2::Pending();
 }
 
 void RpcServerThread::PushPacket(multibuf::MultiBuf&& packet) {
   PACKET_IO_DEBUG_LOG("Received %zu B RPC packet", packet.size());
-  std::lock_guard lock(mutex_);
-  ready_for_packet_ = false;
-  packet_multibuf_ = std::move(packet);
+  packets_in_flight_.fetch_add(1, std::memory_order_relaxed);
+  PW_CHECK(inbound_packets_.TryPush(std::move(packet)),
+           "RPC packet pushed without waiting for PendReadyForPacket()");
   new_packet_available_.release();
 }
 
 void RpcServerThread::RunOnce() {
   new_packet_available_.acquire();
 
-  std::optional<ConstByteSpan> span = packet_multibuf_.ContiguousSpan();
+  // The notification may cover several packets.
+  while (std::optional<multibuf::MultiBuf> packet = inbound_packets_.TryPop()) {
+    ProcessPacket(*packet);
+    packet->Release();
+
+    packets_in_flight_.fetch_sub(1, std::memory_order_release);
+    std::lock_guard lock(mutex_);
+    std::move(ready_to_receive_packet_).Wake();
+  }
+}
+
+void RpcServerThread::ProcessPacket(multibuf::MultiBuf& packet) {
+  std::optional<ConstByteSpan> span = packet.ContiguousSpan();
   if (span.has_value()) {
     rpc_server_.ProcessPacket(*span).IgnoreError();
-  } else {
-    // Copy the packet into a contiguous buffer.
-    // TODO: b/349440355 - Consider a global buffer instead of repeated allocs.
-    const size_t packet_size = packet_multibuf_.size();
-    std::byte* buffer = static_cast<std::byte*>(
-        allocator_.Allocate({packet_size, alignof(std::byte)}));
+    return;
+  }
 
-    auto copy_result = packet_multibuf_.CopyTo({buffer, packet_size});
-    PW_DCHECK_OK(copy_result.status());
-    rpc_server_.ProcessPacket({buffer, packet_size}).IgnoreError();
+  // Copy the packet into a contiguous buffer.
+  // TODO: b/349440355 - Consider a global buffer instead of repeated allocs.
+  const size_t packet_size = packet.size();
+  std::byte* buffer = static_cast<std::byte*>(
+      allocator_.Allocate({packet_size, alignof(std::byte)}));
 
-    allocator_.Deallocate(buffer);
-  }
+  auto copy_result = packet.CopyTo({buffer, packet_size});
+  PW_DCHECK_OK(copy_result.status());
+  rpc_server_.ProcessPacket({buffer, packet_size}).IgnoreError();
 
-  packet_multibuf_.Release();
-  std::lock_guard lock(mutex_);
-  ready_for_packet_ = true;
-  std::move(ready_to_receive_packet_).Wake();
+  allocator_.Deallocate(buffer);
 }
 
 PacketIO::PacketIO(channel::ByteReaderWriter& io_channel,
                    ByteSpan buffer,
                    Allocator& allocator,
-                   rpc::Server& rpc_server)
+                   rpc::Server& rpc_server,
+                   const RpcServiceLanes& service_lanes)
     : allocator_(allocator),
       mb_allocator_(mb_allocator_buffer_, allocator_),
       channels_(mb_allocator_),
       router_(io_channel, buffer),
-      rpc_server_thread_(allocator_, rpc_server),
+      service_lanes_(service_lanes),
+      rpc_lanes_(CreateRpcLanes(
+          allocator_, rpc_server, std::make_index_sequence<kRpcLanes>())),
       packet_reader_(*this),
       packet_writer_(*this),
       packet_flusher_(*this) {
   PW_CHECK_OK(router_.AddChannel(channels_.second(),
                                  PW_SYSTEM_DEFAULT_RPC_HDLC_ADDRESS,
                                  PW_SYSTEM_DEFAULT_RPC_HDLC_ADDRESS));
+  // All lanes share the channel, so responses are sent in the order the RPC
+  // threads produce them.
+  PW_CHECK_OK(rpc_server.OpenChannel(1, rpc_packet_queue_));
 }
 
-void PacketIO::Start(async2::Dispatcher& dispatcher,
-                     const thread::Options& thread_options) {
+void PacketIO::Start(
+    async2::Dispatcher& dispatcher,
+    const thread::Options& (*lane_thread_options)(size_t lane)) {
   dispatcher.Post(packet_reader_);
   dispatcher.Post(packet_writer_);
   dispatcher.Post(packet_flusher_);
 
-  thread::DetachedThread(thread_options, rpc_server_thread_);
+  for (size_t lane = 0; lane < kRpcLanes; ++lane) {
+    thread::DetachedThread(lane_thread_options(lane), rpc_lanes_[lane]);
+  }
 }
 
 async2::Poll<> PacketIO::PacketReader::DoPend(async2::Context& cx) {
@@ -126,30 +205,47 @@ async2::Poll<> PacketIO::PacketReader::DoPend(async2::Context& cx) {
     return async2::Ready();  // channel is closed, we're done here
   }
 
-  // If the dispatcher isn't ready for another packet, wait.
-  if (io_.rpc_server_thread_.PendReadyForPacket(cx).IsPending()) {
-    return async2::Pending();  // Nothing else to do for now
+  if (!packet_.has_value()) {
+    // With a single lane, wait for it to be ready before reading a packet.
+    if (kRpcLanes == 1 &&
+        io_.rpc_lanes_[0].PendReadyForPacket(cx).IsPending()) {
+      return async2::Pending();  // Nothing else to do for now
+    }
+
+    // Read a packet from the router.
+    auto read = io_.channel().PendRead(cx);
+    if (read.IsPending()) {
+      return async2::Pending();  // Nothing else to do for now
+    }
+    if (!read->ok()) {
+      PW_LOG_ERROR("Channel::PendRead() returned status %s",
+                   read->status().str());
+      return async2::Ready();  // Channel is broken
+    }
+    packet_lane_ = io_.service_lanes_.LaneForPacket(**read);
+    packet_ = *std::move(*read);
   }
 
-  // Read a packet from the router and provide it to the RPC thread.
-  auto read = io_.channel().PendRead(cx);
-  if (read.IsPending()) {
+  // If the packet's lane isn't ready for another packet, wait. Packets for
+  // other lanes wait behind this one.
+  RpcServerThread& lane = io_.rpc_lanes_[packet_lane_];
+  if (lane.PendReadyForPacket(cx).IsPending()) {
     return async2::Pending();  // Nothing else to do for now
   }
-  if (!read->ok()) {
-    PW_LOG_ERROR("Channel::PendRead() returned status %s",
-                 read->status().str());
-    return async2::Ready();  // Channel is broken
-  }
-  // Push the packet into the RPC thread.
-  io_.rpc_server_thread_.PushPacket(*std::move(*read));
-  return async2::Pending();  // Nothing else to do for now
+
+  // Push the packet into the lane's RPC thread.
+  lane.PushPacket(*std::move(packet_));
+  packet_.reset();
+
+  // Pushed one packet, let other tasks run.
+  cx.ReEnqueue();
+  return async2::Pending();
 }
 
 async2::Poll<> PacketIO::PacketWriter::DoPend(async2::Context& cx) {
   // Get the next packet to send, if any.
   if (outbound_packet_.IsPending()) {
-    outbound_packet_ = io_.rpc_server_thread_.PendOutgoingDatagram(cx);
+    outbound_packet_ = io_.rpc_packet_queue_.PendOutgoingDatagram(cx);
   }
 
   if (outbound_packet_.IsPending()) {
@@ -193,7 +289,7 @@ async2::Poll<> PacketIO::PacketWriter::DoPend(async2::Context& cx) {
   auto [first, second] = outbound_packet_->contiguous_data();
   PW_CHECK_OK((*mb)->CopyFrom(first).status());
   PW_CHECK_OK((*mb)->CopyFromAndTruncate(second, first.size()).status());
-  io_.rpc_server_thread_.PopOutboundPacket();
+  io_.rpc_packet_queue_.Pop();
 
   PACKET_IO_DEBUG_LOG("Writing %zu B outbound packet", (**mb).size());
   auto write_result = io_.channel().Write(**std::move(mb));
@@ -14,11 +14,19 @@
 
 #include "pw_system/internal/async_packet_io.h"
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
 
 #include "pw_allocator/testing.h"
+#include "pw_assert/assert.h"
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/pend_func_task.h"
 #include "pw_channel/loopback_channel.h"
 #include "pw_multibuf/simple_allocator_for_test.h"
+#include "pw_rpc/echo_service_pwpb.h"
 #include "pw_rpc/server.h"
 #include "pw_unit_test/framework.h"
 
@@ -33,8 +41,96 @@ TEST(AsyncPacketIo, Instantiate) {
   std::byte buffer[256];
   pw::rpc::Channel rpc_channel[1];
   pw::rpc::Server rpc_server(rpc_channel);
+  pw::system::internal::RpcServiceLanes service_lanes;
 
-  pw::system::internal::PacketIO packet_io(channel, buffer, alloc, rpc_server);
+  pw::system::internal::PacketIO packet_io(
+      channel, buffer, alloc, rpc_server, service_lanes);
+}
+
+pw::multibuf::MultiBuf MakePacket(pw::multibuf::MultiBufAllocator& alloc,
+                                  pw::ConstByteSpan data) {
+  std::optional<pw::multibuf::MultiBuf> packet =
+      alloc.AllocateContiguous(data.size());
+  PW_ASSERT(packet.has_value());
+  PW_ASSERT(packet->CopyFrom(data).ok());
+  return *std::move(packet);
+}
+
+// Encodes an RPC request packet without a payload.
+pw::multibuf::MultiBuf EncodeRequest(pw::multibuf::MultiBufAllocator& alloc,
+                                     uint32_t service_id) {
+  const std::array<std::byte, 11> packet = {
+      std::byte{0x08},  // type: REQUEST
+      std::byte{0x00},
+      std::byte{0x10},  // channel_id: 1
+      std::byte{0x01},
+      std::byte{0x1d},  // service_id
+      static_cast<std::byte>(service_id),
+      static_cast<std::byte>(service_id >> 8),
+      static_cast<std::byte>(service_id >> 16),
+      static_cast<std::byte>(service_id >> 24),
+      std::byte{0x30},  // call_id: 1
+      std::byte{0x01},
+  };
+  return MakePacket(alloc, packet);
+}
+
+TEST(RpcServiceLanes, RoutesPacketsByServiceId) {
+  pw::multibuf::test::SimpleAllocatorForTest mb_alloc;
+  pw::system::internal::RpcServiceLanes service_lanes;
+  pw::rpc::EchoService echo_service;
+  const uint32_t echo_id =
+      pw::rpc::internal::UnwrapServiceId(echo_service.service_id());
+
+  // Without assignments, every packet goes to lane 0.
+  EXPECT_EQ(service_lanes.LaneForPacket(EncodeRequest(mb_alloc, echo_id)), 0u);
+
+  EXPECT_TRUE(service_lanes.Assign(echo_service, 1));
+  EXPECT_EQ(service_lanes.LaneForPacket(EncodeRequest(mb_alloc, echo_id)), 1u);
+  EXPECT_EQ(service_lanes.LaneForPacket(EncodeRequest(mb_alloc, echo_id + 1)),
+            0u);
+
+  // Packets without a service ID go to lane 0.
+  constexpr std::array<std::byte, 2> kNoServiceId = {std::byte{0x08},
+                                                     std::byte{0x00}};
+  EXPECT_EQ(service_lanes.LaneForPacket(MakePacket(mb_alloc, kNoServiceId)),
+            0u);
+
+  EXPECT_TRUE(service_lanes.Assign(echo_service, 0));
+  EXPECT_EQ(service_lanes.LaneForPacket(EncodeRequest(mb_alloc, echo_id)), 0u);
+}
+
+TEST(RpcServerThread, AcceptsUpToMaxInboundPackets) {
+  using pw::system::internal::RpcServerThread;
+
+  pw::allocator::test::AllocatorForTest<kArbitrarySize> alloc;
+  pw::rpc::Channel rpc_channel[1];
+  pw::rpc::Server rpc_server(rpc_channel);
+  pw::multibuf::test::SimpleAllocatorForTest mb_alloc;
+  RpcServerThread rpc_server_thread(alloc, rpc_server);
+
+  // The RPC thread is not running, so pushed packets stay in flight.
+  size_t packets_pushed = 0;
+  pw::async2::Dispatcher dispatcher;
+  pw::async2::PendFuncTask task(
+      [&](pw::async2::Context& cx) -> pw::async2::Poll<> {
+        while (rpc_server_thread.PendReadyForPacket(cx).IsReady()) {
+          std::optional<pw::multibuf::MultiBuf> packet =
+              mb_alloc.AllocateContiguous(1);
+          if (!packet.has_value()) {
+            ADD_FAILURE();
+            return pw::async2::Ready();
+          }
+          rpc_server_thread.PushPacket(std::move(*packet));
+          packets_pushed += 1;
+        }
+        return pw::async2::Pending();
+      });
+  dispatcher.Post(task);
+
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsPending());
+  EXPECT_EQ(packets_pushed, RpcServerThread::kMaxInboundPackets);
+  task.Deregister();
 }
 
 }  // namespace
@@ -25,6 +25,7 @@
 #include "pw_hdlc/rpc_channel.h"
 #include "pw_log/log.h"
 #include "pw_rpc/channel.h"
+#include "pw_rpc/latency.h"
 #include "pw_sync/mutex.h"
 #include "pw_system/config.h"
 #include "pw_system/io.h"
@@ -124,6 +125,7 @@ class RpcDispatchThread final : public thread::ThreadCore {
           PW_TRACE_SCOPE("RPC process frame");
           if (frame.address() == PW_SYSTEM_DEFAULT_RPC_HDLC_ADDRESS ||
               frame.address() == PW_SYSTEM_LOGGING_RPC_HDLC_ADDRESS) {
+            rpc::RecordFrameReceived();
             if (!server.ProcessPacket(frame.data()).ok()) {
               PW_LOG_ERROR("Failed to process packet");
             }
@@ -112,6 +112,17 @@
 #define PW_SYSTEM_WORK_QUEUE_MAX_ENTRIES 32
 #endif  // PW_SYSTEM_WORK_QUEUE_MAX_ENTRIES
 
+// PW_SYSTEM_WORK_QUEUE_LANES specifies how many work queues pw_system runs,
+// each on its own thread. Lane 0 has the lowest thread priority and each
+// further lane runs one priority step above the previous one, so latency
+// critical work is not delayed behind bulk work such as crash uploads. Only
+// pw_system:async starts threads for lanes other than 0.
+//
+// Defaults to 1.
+#ifndef PW_SYSTEM_WORK_QUEUE_LANES
+#define PW_SYSTEM_WORK_QUEUE_LANES 1
+#endif  // PW_SYSTEM_WORK_QUEUE_LANES
+
 // PW_SYSTEM_SOCKET_IO_PORT specifies the port number to use for the socket
 // stream implementation of pw_system's I/O interface.
 //
@@ -132,6 +143,43 @@
 #define PW_SYSTEM_ASYNC_RPC_THREAD_STACK_SIZE_BYTES 2048
 #endif  // PW_SYSTEM_ASYNC_RPC_THREAD_STACK_SIZE_BYTES
 
+// PW_SYSTEM_ASYNC_MAX_INBOUND_RPC_PACKETS specifies how many received RPC
+// packets may be handed to the RPC thread at once, including the packet it is
+// processing.
+//
+// With the default of 1, HDLC decoding waits for each packet to be processed.
+// Larger values pipeline packet I/O with RPC dispatch: the dispatcher thread
+// decodes the next packets into a lock-free queue while the RPC thread handles
+// the current one. This pays off when the RPC thread runs on a different core
+// than the dispatcher, which targets arrange through RpcThreadOptions() and
+// DispatcherThreadOptions(). Each additional packet reserves another MTU of
+// MultiBuf memory.
+#ifndef PW_SYSTEM_ASYNC_MAX_INBOUND_RPC_PACKETS
+#define PW_SYSTEM_ASYNC_MAX_INBOUND_RPC_PACKETS 1
+#endif  // PW_SYSTEM_ASYNC_MAX_INBOUND_RPC_PACKETS
+
+// PW_SYSTEM_ASYNC_RPC_LANES specifies how many threads process inbound RPC
+// packets. Like work queue lanes, lane 0 has the lowest thread priority and
+// each further lane runs one priority step higher. Services are assigned to a
+// lane with pw::System().RegisterService(); all others run in lane 0.
+//
+// Each lane holds up to PW_SYSTEM_ASYNC_MAX_INBOUND_RPC_PACKETS packets, which
+// are reserved from the MultiBuf memory. With more than one lane, one more MTU
+// is reserved for the packet being routed.
+//
+// Defaults to 1.
+#ifndef PW_SYSTEM_ASYNC_RPC_LANES
+#define PW_SYSTEM_ASYNC_RPC_LANES 1
+#endif  // PW_SYSTEM_ASYNC_RPC_LANES
+
+// PW_SYSTEM_ASYNC_MAX_RPC_LANE_SERVICES specifies how many services may be
+// assigned to RPC lanes other than lane 0.
+//
+// Defaults to 8.
+#ifndef PW_SYSTEM_ASYNC_MAX_RPC_LANE_SERVICES
+#define PW_SYSTEM_ASYNC_MAX_RPC_LANE_SERVICES 8
+#endif  // PW_SYSTEM_ASYNC_MAX_RPC_LANE_SERVICES
+
 // PW_SYSTEM_ASYNC_TRANSFER_THREAD_STACK_SIZE_BYTES specifies the size of the
 // internal pw_transfer thread stack.
 #ifndef PW_SYSTEM_ASYNC_TRANSFER_THREAD_STACK_SIZE_BYTES
@@ -198,6 +246,12 @@ inline constexpr size_t kDispatcherThreadStackSizeBytes =
 inline constexpr size_t kWorkQueueThreadStackSizeBytes =
     PW_SYSTEM_ASYNC_WORK_QUEUE_THREAD_STACK_SIZE_BYTES;
 
+inline constexpr size_t kWorkQueueLanes = PW_SYSTEM_WORK_QUEUE_LANES;
+inline constexpr size_t kRpcLanes = PW_SYSTEM_ASYNC_RPC_LANES;
+static_assert(kWorkQueueLanes >= 1,
+              "PW_SYSTEM_WORK_QUEUE_LANES must be at least 1");
+static_assert(kRpcLanes >= 1, "PW_SYSTEM_ASYNC_RPC_LANES must be at least 1");
+
 #undef PW_SYSTEM_ASYNC_LOG_THREAD_STACK_SIZE_BYTES
 #undef PW_SYSTEM_ASYNC_RPC_THREAD_STACK_SIZE_BYTES
 #undef PW_SYSTEM_ASYNC_TRANSFER_THREAD_STACK_SIZE_BYTES
@@ -13,20 +13,25 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <mutex>
 #include <optional>
+#include <utility>
 
 #include "pw_allocator/allocator.h"
 #include "pw_async2/dispatcher.h"
 #include "pw_channel/channel.h"
 #include "pw_channel/forwarding_channel.h"
+#include "pw_containers/inline_mpmc_queue.h"
 #include "pw_containers/inline_var_len_entry_queue.h"
+#include "pw_containers/vector.h"
 #include "pw_hdlc/router.h"
 #include "pw_multibuf/multibuf.h"
 #include "pw_multibuf/simple_allocator.h"
 #include "pw_rpc/server.h"
+#include "pw_rpc/service.h"
 #include "pw_sync/lock_annotations.h"
 #include "pw_sync/mutex.h"
 #include "pw_sync/thread_notification.h"
@@ -68,29 +73,65 @@ class RpcChannelOutputQueue final : public rpc::ChannelOutput {
   uint32_t dropped_packets_ PW_GUARDED_BY(mutex_);
 };
 
+// Maps RPC services to the lanes whose threads process their packets. Services
+// without an entry, and packets that cannot be decoded, go to lane 0.
+class RpcServiceLanes {
+ public:
+  static constexpr size_t kMaxServices = PW_SYSTEM_ASYNC_MAX_RPC_LANE_SERVICES;
+
+  RpcServiceLanes() = default;
+
+  // Assigns a service to a lane. Returns false if kMaxServices services are
+  // already assigned to lanes other than 0.
+  bool Assign(const rpc::Service& service, size_t lane);
+
+  // Returns the lane of the service that an encoded RPC packet is addressed to.
+  size_t LaneForPacket(const multibuf::MultiBuf& packet) const;
+
+ private:
+  struct Entry {
+    uint32_t service_id;
+    size_t lane;
+  };
+
+  size_t LaneForService(uint32_t service_id) const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable sync::Mutex mutex_;
+  Vector<Entry, kMaxServices> entries_ PW_GUARDED_BY(mutex_);
+};
+
+// Returns the smallest InlineMpmcQueue capacity, a power of two, that holds
+// the given number of packets.
+constexpr size_t InboundQueueCapacity(size_t packets) {
+  size_t capacity = 2;
+  while (capacity < packets) {
+    capacity *= 2;
+  }
+  return capacity;
+}
+
 // Thread that receives inbound RPC packets and calls
 // pw::rpc::Server::ProcessPacket() with them.
+//
+// Packets are handed over through a lock-free queue, so the dispatcher thread
+// can decode further packets while this thread processes one.
 class RpcServerThread final : public thread::ThreadCore {
  public:
-  RpcServerThread(Allocator& allocator, rpc::Server& server);
+  // The number of packets that may be pushed but not yet fully processed.
+  static constexpr size_t kMaxInboundPackets =
+      PW_SYSTEM_ASYNC_MAX_INBOUND_RPC_PACKETS;
+  static_assert(kMaxInboundPackets >= 1,
+                "PW_SYSTEM_ASYNC_MAX_INBOUND_RPC_PACKETS must be at least 1");
 
-  async2::Poll<InlineVarLenEntryQueue<>::Entry> PendOutgoingDatagram(
-      async2::Context& cx) {
-    return rpc_packet_queue_.PendOutgoingDatagram(cx);
-  }
-
-  void PopOutboundPacket() { return rpc_packet_queue_.Pop(); }
+  RpcServerThread(Allocator& allocator, rpc::Server& server)
+      : allocator_(allocator), rpc_server_(server) {}
 
   // This approach only works with a single producer.
-  async2::Poll<> PendReadyForPacket(async2::Context& cx) {
-    std::lock_guard lock(mutex_);
-    if (ready_for_packet_) {
-      return async2::Ready();
-    }
-    ready_to_receive_packet_ = cx.GetWaker(async2::WaitReason::Unspecified());
-    return async2::Pending();
-  }
+  async2::Poll<> PendReadyForPacket(async2::Context& cx);
 
+  // Queues a packet for the RPC thread. PendReadyForPacket() must have
+  // returned Ready since the last call.
   void PushPacket(multibuf::MultiBuf&& packet);
 
  private:
@@ -102,13 +143,24 @@ class RpcServerThread final : public thread::ThreadCore {
 
   void RunOnce();
 
+  void ProcessPacket(multibuf::MultiBuf& packet);
+
+  bool ReadyForPacket() const {
+    return packets_in_flight_.load(std::memory_order_acquire) <
+           kMaxInboundPackets;
+  }
+
   Allocator& allocator_;
+
+  // Only guards the waker; packets are passed through inbound_packets_.
   sync::Mutex mutex_;
-  bool ready_for_packet_ PW_GUARDED_BY(mutex_) = true;
   async2::Waker ready_to_receive_packet_ PW_GUARDED_BY(mutex_);
-  multibuf::MultiBuf packet_multibuf_;
+
+  InlineMpmcQueue<multibuf::MultiBuf,
+                  InboundQueueCapacity(PW_SYSTEM_ASYNC_MAX_INBOUND_RPC_PACKETS)>
+      inbound_packets_;
+  std::atomic<size_t> packets_in_flight_{0};
   sync::ThreadNotification new_packet_available_;
-  RpcChannelOutputQueue rpc_packet_queue_;
   rpc::Server& rpc_server_;
 };
 
@@ -117,20 +169,26 @@ class PacketIO {
   PacketIO(channel::ByteReaderWriter& io_channel,
            ByteSpan buffer,
            Allocator& allocator,
-           rpc::Server& rpc_server);
+           rpc::Server& rpc_server,
+           const RpcServiceLanes& service_lanes);
 
+  // Posts the packet I/O tasks and starts a thread for each RPC lane.
   void Start(async2::Dispatcher& dispatcher,
-             const thread::Options& thread_options);
+             const thread::Options& (*lane_thread_options)(size_t lane));
 
  private:
   class PacketReader : public async2::Task {
    public:
-    constexpr PacketReader(PacketIO& io) : io_(io) {}
+    PacketReader(PacketIO& io) : io_(io) {}
 
    private:
     async2::Poll<> DoPend(async2::Context& cx) override;
 
     PacketIO& io_;
+
+    // A packet read from the router that waits for its lane to accept it.
+    std::optional<multibuf::MultiBuf> packet_;
+    size_t packet_lane_ = 0;
   };
 
   class PacketWriter : public async2::Task {
@@ -165,14 +223,34 @@ class PacketIO {
     async2::Waker waker_;
   };
 
+  // Inbound packets held by the RPC lanes, plus the packet being routed. With a
+  // single lane, the reader waits for the lane before reading a packet, so it
+  // never holds one.
+  static constexpr size_t kMaxInboundPackets =
+      kRpcLanes * RpcServerThread::kMaxInboundPackets + (kRpcLanes > 1 ? 1 : 0);
+
+  template <size_t... kLanes>
+  static std::array<RpcServerThread, kRpcLanes> CreateRpcLanes(
+      Allocator& allocator,
+      rpc::Server& rpc_server,
+      std::index_sequence<kLanes...>) {
+    return {{(static_cast<void>(kLanes),
+              RpcServerThread(allocator, rpc_server))...}};
+  }
+
   channel::DatagramReaderWriter& channel() { return channels_.first(); }
 
-  std::byte mb_allocator_buffer_[PW_SYSTEM_MAX_TRANSMISSION_UNIT * 2];
+  // One MTU for each inbound packet, and one for the outbound packet being
+  // written.
+  std::byte mb_allocator_buffer_[PW_SYSTEM_MAX_TRANSMISSION_UNIT *
+                                 (kMaxInboundPackets + 1)];
   Allocator& allocator_;
   multibuf::SimpleAllocator mb_allocator_;
   channel::ForwardingDatagramChannelPair channels_;
   hdlc::Router router_;
-  RpcServerThread rpc_server_thread_;
+  RpcChannelOutputQueue rpc_packet_queue_;
+  const RpcServiceLanes& service_lanes_;
+  std::array<RpcServerThread, kRpcLanes> rpc_lanes_;
 
   PacketReader packet_reader_;
   PacketWriter packet_writer_;
@@ -13,12 +13,15 @@
 // the License.
 #pragma once
 
+#include <cstddef>
 #include <tuple>
+#include <utility>
 
 #include "pw_allocator/allocator.h"
 #include "pw_channel/channel.h"
 #include "pw_function/function.h"
 #include "pw_rpc/server.h"
+#include "pw_rpc/service.h"
 
 namespace pw {
 namespace system {
@@ -56,7 +59,25 @@ class AsyncCore {
   ///
   /// @returns true if the function was enqueued to run, false if the function
   /// queue is full
-  [[nodiscard]] bool RunOnce(Function<void()>&& function);
+  [[nodiscard]] bool RunOnce(Function<void()>&& function) {
+    return RunOnce(std::move(function), 0);
+  }
+
+  /// Runs a function once on the thread of a work queue lane. Higher lanes run
+  /// at higher thread priorities, so functions in them are not delayed by
+  /// blocking functions in lower lanes. See `PW_SYSTEM_WORK_QUEUE_LANES`.
+  ///
+  /// @returns true if the function was enqueued to run, false if the lane's
+  /// function queue is full
+  [[nodiscard]] bool RunOnce(Function<void()>&& function, size_t lane);
+
+  /// Registers a service with the RPC server and processes its requests on the
+  /// thread of an RPC lane. Higher lanes run at higher thread priorities, so
+  /// latency-critical services are not delayed by bulk services in lower
+  /// lanes. See `PW_SYSTEM_ASYNC_RPC_LANES`.
+  ///
+  /// Services registered directly with `rpc_server()` run in lane 0.
+  void RegisterService(rpc::Service& service, size_t lane);
 
  private:
   friend AsyncCore& pw::System();
@@ -14,10 +14,16 @@
 
 #pragma once
 
+#include <cstddef>
+
 #include "pw_work_queue/work_queue.h"
 
 namespace pw::system {
 
+// Returns the work queue of lane 0, which has the lowest thread priority.
 work_queue::WorkQueue& GetWorkQueue();
 
+// Returns the work queue of a lane. See PW_SYSTEM_WORK_QUEUE_LANES.
+work_queue::WorkQueue& GetWorkQueue(size_t lane);
+
 }  // namespace pw::system
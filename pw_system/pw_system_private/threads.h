@@ -13,14 +13,21 @@
 // the License.
 #pragma once
 
+#include <cstddef>
+
+#include "pw_thread/thread.h"
+
 namespace pw::system {
 
 [[noreturn]] void StartScheduler();
 
 const thread::Options& LogThreadOptions();
-const thread::Options& RpcThreadOptions();
 const thread::Options& TransferThreadOptions();
 const thread::Options& DispatcherThreadOptions();
-const thread::Options& WorkQueueThreadOptions();
+
+// Options for the threads of each lane. See PW_SYSTEM_ASYNC_RPC_LANES and
+// PW_SYSTEM_WORK_QUEUE_LANES.
+const thread::Options& RpcThreadOptions(size_t lane);
+const thread::Options& WorkQueueThreadOptions(size_t lane);
 
 }  // namespace pw::system
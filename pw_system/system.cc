@@ -59,11 +59,20 @@ using pw::allocator::SynchronizedAllocator;
 // TODO: b/349654108 - Standardize component declaration and initialization.
 alignas(internal::PacketIO) std::byte packet_io_[sizeof(internal::PacketIO)];
 
+internal::RpcServiceLanes& ServiceLanes() {
+  static internal::RpcServiceLanes service_lanes;
+  return service_lanes;
+}
+
 internal::PacketIO& InitializePacketIoGlobal(
     channel::ByteReaderWriter& io_channel) {
   static std::byte buffer[256];
-  internal::PacketIO* packet_io = new (packet_io_) internal::PacketIO(
-      io_channel, buffer, System().allocator(), System().rpc_server());
+  internal::PacketIO* packet_io =
+      new (packet_io_) internal::PacketIO(io_channel,
+                                          buffer,
+                                          System().allocator(),
+                                          System().rpc_server(),
+                                          ServiceLanes());
   return *packet_io;
 }
 
@@ -100,8 +109,15 @@ Allocator& AsyncCore::allocator() {
   return sync_allocator;
 }
 
-bool AsyncCore::RunOnce(Function<void()>&& function) {
-  return GetWorkQueue().PushWork(std::move(function)).ok();
+bool AsyncCore::RunOnce(Function<void()>&& function, size_t lane) {
+  return GetWorkQueue(lane).PushWork(std::move(function)).ok();
+}
+
+void AsyncCore::RegisterService(rpc::Service& service, size_t lane) {
+  PW_CHECK_UINT_LT(lane, kRpcLanes, "Invalid RPC lane");
+  PW_CHECK(ServiceLanes().Assign(service, lane),
+           "Increase PW_SYSTEM_ASYNC_MAX_RPC_LANE_SERVICES");
+  rpc_server().RegisterService(service);
 }
 
 void AsyncCore::Init(channel::ByteReaderWriter& io_channel) {
@@ -129,12 +145,14 @@ void AsyncCore::Init(channel::ByteReaderWriter& io_channel) {
 
   // Initialize the packet_io subsystem
   internal::PacketIO& packet_io = InitializePacketIoGlobal(io_channel);
-  packet_io.Start(System().dispatcher(), RpcThreadOptions());
+  packet_io.Start(System().dispatcher(), RpcThreadOptions);
 
   thread::DetachedThread(DispatcherThreadOptions(),
                          [] { System().dispatcher().RunToCompletion(); });
 
-  thread::DetachedThread(WorkQueueThreadOptions(), GetWorkQueue());
+  for (size_t lane = 0; lane < kWorkQueueLanes; ++lane) {
+    thread::DetachedThread(WorkQueueThreadOptions(lane), GetWorkQueue(lane));
+  }
 }
 
 async2::Poll<> AsyncCore::InitTask(async2::Context&) {
@@ -25,7 +25,11 @@
 
 #if __has_include("FreeRTOS.h")
 
+#include <array>
+#include <utility>
+
 #include "FreeRTOS.h"
+#include "pw_assert/check.h"
 #include "pw_thread_freertos/options.h"
 #include "task.h"
 
@@ -58,6 +62,34 @@ enum class ThreadPriority : UBaseType_t {
 static_assert(static_cast<UBaseType_t>(ThreadPriority::kNumPriorities) <=
               configMAX_PRIORITIES);
 
+namespace {
+
+// Each lane runs one priority step above the previous one.
+constexpr UBaseType_t LanePriority(ThreadPriority lowest, size_t lane) {
+  return static_cast<UBaseType_t>(lowest) + static_cast<UBaseType_t>(lane);
+}
+
+static_assert(LanePriority(ThreadPriority::kRpc, kRpcLanes - 1) <
+                  configMAX_PRIORITIES,
+              "Too many RPC lanes for configMAX_PRIORITIES");
+static_assert(LanePriority(ThreadPriority::kWorkQueue, kWorkQueueLanes - 1) <
+                  configMAX_PRIORITIES,
+              "Too many work queue lanes for configMAX_PRIORITIES");
+
+template <typename Context, size_t... kLanes>
+constexpr std::array<thread::freertos::Options, sizeof...(kLanes)>
+LaneThreadOptions(const char* name,
+                  std::array<Context, sizeof...(kLanes)>& contexts,
+                  ThreadPriority lowest,
+                  std::index_sequence<kLanes...>) {
+  return {thread::freertos::Options()
+              .set_name(name)
+              .set_static_context(contexts[kLanes])
+              .set_priority(LanePriority(lowest, kLanes))...};
+}
+
+}  // namespace
+
 const thread::Options& LogThreadOptions() {
   static thread::freertos::StaticContextWithStack<ToWords(
       kLogThreadStackSizeBytes)>
@@ -70,16 +102,18 @@ const thread::Options& LogThreadOptions() {
   return options;
 }
 
-const thread::Options& RpcThreadOptions() {
-  static thread::freertos::StaticContextWithStack<ToWords(
-      kRpcThreadStackSizeBytes)>
-      context;
+const thread::Options& RpcThreadOptions(size_t lane) {
+  static std::array<thread::freertos::StaticContextWithStack<ToWords(
+                        kRpcThreadStackSizeBytes)>,
+                    kRpcLanes>
+      contexts;
   static constexpr auto options =
-      pw::thread::freertos::Options()
-          .set_name("RpcThread")
-          .set_static_context(context)
-          .set_priority(static_cast<UBaseType_t>(ThreadPriority::kRpc));
-  return options;
+      LaneThreadOptions("RpcThread",
+                        contexts,
+                        ThreadPriority::kRpc,
+                        std::make_index_sequence<kRpcLanes>());
+  PW_CHECK_UINT_LT(lane, kRpcLanes, "Invalid RPC lane");
+  return options[lane];
 }
 
 const thread::Options& TransferThreadOptions() {
@@ -106,16 +140,18 @@ const thread::Options& DispatcherThreadOptions() {
   return options;
 }
 
-const thread::Options& WorkQueueThreadOptions() {
-  static thread::freertos::StaticContextWithStack<ToWords(
-      kWorkQueueThreadStackSizeBytes)>
-      context;
+const thread::Options& WorkQueueThreadOptions(size_t lane) {
+  static std::array<thread::freertos::StaticContextWithStack<ToWords(
+                        kWorkQueueThreadStackSizeBytes)>,
+                    kWorkQueueLanes>
+      contexts;
   static constexpr auto options =
-      pw::thread::freertos::Options()
-          .set_name("WorkQueueThread")
-          .set_static_context(context)
-          .set_priority(static_cast<UBaseType_t>(ThreadPriority::kWorkQueue));
-  return options;
+      LaneThreadOptions("WorkQueueThread",
+                        contexts,
+                        ThreadPriority::kWorkQueue,
+                        std::make_index_sequence<kWorkQueueLanes>());
+  PW_CHECK_UINT_LT(lane, kWorkQueueLanes, "Invalid work queue lane");
+  return options[lane];
 }
 
 }  // namespace pw::system
@@ -142,13 +178,15 @@ thread::stl::Options stl_thread_options;
 
 const thread::Options& LogThreadOptions() { return stl_thread_options; }
 
-const thread::Options& RpcThreadOptions() { return stl_thread_options; }
+const thread::Options& RpcThreadOptions(size_t) { return stl_thread_options; }
 
 const thread::Options& TransferThreadOptions() { return stl_thread_options; }
 
 const thread::Options& DispatcherThreadOptions() { return stl_thread_options; }
 
-const thread::Options& WorkQueueThreadOptions() { return stl_thread_options; }
+const thread::Options& WorkQueueThreadOptions(size_t) {
+  return stl_thread_options;
+}
 
 }  // namespace pw::system
 
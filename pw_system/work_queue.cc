@@ -14,6 +14,9 @@
 
 #include "pw_system/work_queue.h"
 
+#include <array>
+
+#include "pw_assert/check.h"
 #include "pw_system/config.h"
 #include "pw_work_queue/work_queue.h"
 
@@ -21,11 +24,16 @@ namespace pw::system {
 
 // TODO: b/234876895 - Consider switching this to a "NoDestroy" wrapped type to
 // allow the static destructor to be optimized out.
-work_queue::WorkQueue& GetWorkQueue() {
+work_queue::WorkQueue& GetWorkQueue() { return GetWorkQueue(0); }
+
+work_queue::WorkQueue& GetWorkQueue(size_t lane) {
   static constexpr size_t kMaxWorkQueueEntries =
       PW_SYSTEM_WORK_QUEUE_MAX_ENTRIES;
-  static pw::work_queue::WorkQueueWithBuffer<kMaxWorkQueueEntries> work_queue;
-  return work_queue;
+  static std::array<pw::work_queue::WorkQueueWithBuffer<kMaxWorkQueueEntries>,
+                    kWorkQueueLanes>
+      work_queues;
+  PW_CHECK_UINT_LT(lane, kWorkQueueLanes, "Invalid work queue lane");
+  return work_queues[lane];
 }
 
 }  // namespace pw::system
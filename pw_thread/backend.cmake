@@ -27,6 +27,9 @@ pw_add_backend_variable(pw_thread.thread_BACKEND)
 # Backend for the pw_thread module's pw::thread::thread_iteration.
 pw_add_backend_variable(pw_thread.thread_iteration_BACKEND)
 
+# Backend for the pw_thread module's pw::thread::ThreadLocal.
+pw_add_backend_variable(pw_thread.thread_local_BACKEND)
+
 # Backend for the pw_thread module's pw::thread::yield.
 pw_add_backend_variable(pw_thread.yield_BACKEND)
 
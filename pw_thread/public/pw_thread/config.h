@@ -27,3 +27,9 @@
 #ifndef PW_THREAD_NUM_BUNDLED_THREADS
 #define PW_THREAD_NUM_BUNDLED_THREADS 3
 #endif  // PW_THREAD_MAXIMUM_THREADS
+
+// The max length of a thread name tracked by the thread profiler. Longer names
+// are truncated.
+#ifndef PW_THREAD_PROFILER_MAX_NAME_LENGTH
+#define PW_THREAD_PROFILER_MAX_NAME_LENGTH 16
+#endif  // PW_THREAD_PROFILER_MAX_NAME_LENGTH
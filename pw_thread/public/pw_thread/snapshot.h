@@ -51,4 +51,29 @@ Status SnapshotStack(const StackContext& stack,
                      proto::pwpb::Thread::StreamEncoder& encoder,
                      const ProcessThreadStackCallback& thread_stack_callback);
 
+// Writes the stack to the raw_stack_rle field, compressing it as it's copied.
+// Suitable as (or for use in) a ProcessThreadStackCallback.
+//
+// Captures the following proto fields:
+//   pw.thread.Thread:
+//     raw_stack_rle
+Status SnapshotCompressedStack(proto::pwpb::Thread::StreamEncoder& encoder,
+                               ConstByteSpan stack);
+
+// Scans the stack from the stack pointer towards the stack base for words
+// that is_return_address() accepts, and writes up to max_depth of them to the
+// raw_backtrace field, most recent first. This is much faster and smaller than
+// capturing the stack, at the cost of a heuristic backtrace: stale return
+// addresses left on the stack by earlier calls may appear in it. Suitable for
+// use in a ProcessThreadStackCallback.
+//
+// Captures the following proto fields:
+//   pw.thread.Thread:
+//     raw_backtrace
+Status SnapshotStackScanBacktrace(
+    proto::pwpb::Thread::StreamEncoder& encoder,
+    ConstByteSpan stack,
+    const Function<bool(uintptr_t)>& is_return_address,
+    size_t max_depth);
+
 }  // namespace pw::thread
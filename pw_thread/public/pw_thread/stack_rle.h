@@ -0,0 +1,80 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::thread {
+
+// Compresses a captured stack into the run-length encoding of the
+// pw.thread.Thread raw_stack_rle field, as a stream.
+//
+// Encoding happens incrementally as the reader is read, using no buffers and
+// only a handful of loads and compares per word, so that a crash handler can
+// write a compressed stack straight to a snapshot encoder with
+// `WriteBytesFromStream()`. Stack space that is filled with a pattern (or
+// zeroes) compresses to a few bytes.
+class StackRleReader final : public stream::NonSeekableReader {
+ public:
+  // The kinds of runs in the encoding.
+  static constexpr uint32_t kLiteralWords = 0;
+  static constexpr uint32_t kRepeatedWord = 1;
+  static constexpr uint32_t kLiteralBytes = 2;
+
+  // `stack` must remain valid while the reader is used.
+  explicit StackRleReader(ConstByteSpan stack);
+
+  // The total size of the compressed stack.
+  size_t encoded_size() const { return encoded_size_; }
+
+ private:
+  struct Run {
+    uint32_t kind;
+    size_t count;
+  };
+
+  StatusWithSize DoRead(ByteSpan destination) override;
+
+  size_t ConservativeLimit(LimitType type) const override {
+    return type == LimitType::kRead ? encoded_size_ - position_ : 0;
+  }
+
+  // Returns the run that starts at `word`.
+  Run NextRun(size_t word) const;
+
+  uint32_t Word(size_t index) const;
+
+  // Queues the header and payload of the next run.
+  void StartRun();
+
+  size_t num_words() const { return stack_.size() / sizeof(uint32_t); }
+
+  ConstByteSpan stack_;
+  size_t encoded_size_ = 0;
+  size_t position_ = 0;
+
+  size_t next_word_ = 0;
+  bool tail_done_ = false;
+  std::array<std::byte, 5> header_;
+  ConstByteSpan pending_header_;
+  ConstByteSpan pending_payload_;
+};
+
+}  // namespace pw::thread
@@ -29,6 +29,9 @@ namespace pw::thread {
 //     stack_end_pointer
 //     stack_est_peak_pointer
 //     thread_name
+//     run_time
+//     context_switches
+//     ready_time_ns
 class ThreadInfo {
  public:
   ThreadInfo() = default;
@@ -85,6 +88,38 @@ class ThreadInfo {
 
   void clear_thread_name() { clear_stack_info_ptr(kThreadName); }
 
+  // Total time the thread has spent running, in backend-defined units (e.g.
+  // run time counter ticks or cycles). Only meaningful relative to the run
+  // times of other threads reported by the same backend.
+  constexpr std::optional<uint64_t> run_time() const {
+    return get_runtime_stat(kRunTime);
+  }
+
+  void set_run_time(uint64_t val) { set_runtime_stat(kRunTime, val); }
+
+  void clear_run_time() { clear_stack_info_ptr(kRunTime); }
+
+  // Number of times the thread has been switched in.
+  constexpr std::optional<uint64_t> context_switches() const {
+    return get_runtime_stat(kContextSwitches);
+  }
+
+  void set_context_switches(uint64_t val) {
+    set_runtime_stat(kContextSwitches, val);
+  }
+
+  void clear_context_switches() { clear_stack_info_ptr(kContextSwitches); }
+
+  // Total time the thread has spent ready to run but waiting for the CPU, in
+  // nanoseconds.
+  constexpr std::optional<uint64_t> ready_time_ns() const {
+    return get_runtime_stat(kReadyTimeNs);
+  }
+
+  void set_ready_time_ns(uint64_t val) { set_runtime_stat(kReadyTimeNs, val); }
+
+  void clear_ready_time_ns() { clear_stack_info_ptr(kReadyTimeNs); }
+
  private:
   enum ThreadInfoIndex {
     kStackLowAddress,
@@ -92,6 +127,9 @@ class ThreadInfo {
     kStackPointer,
     kStackPeakAddress,
     kThreadName,
+    kRunTime,
+    kContextSwitches,
+    kReadyTimeNs,
     kMaxNumMembersDoNotUse,
   };
 
@@ -110,8 +148,22 @@ class ThreadInfo {
     has_value_.set(index, false);
   }
 
+  constexpr std::optional<uint64_t> get_runtime_stat(
+      ThreadInfoIndex index) const {
+    return has_value_[index]
+               ? std::make_optional(runtime_stats_[index - kRunTime])
+               : std::nullopt;
+  }
+
+  void set_runtime_stat(ThreadInfoIndex index, uint64_t val) {
+    runtime_stats_[index - kRunTime] = val;
+    has_value_.set(index, true);
+  }
+
   std::bitset<ThreadInfoIndex::kMaxNumMembersDoNotUse> has_value_;
-  uintptr_t stack_info_ptrs_[ThreadInfoIndex::kMaxNumMembersDoNotUse];
+  uintptr_t stack_info_ptrs_[ThreadInfoIndex::kThreadName];
+  uint64_t runtime_stats_[ThreadInfoIndex::kMaxNumMembersDoNotUse -
+                          ThreadInfoIndex::kRunTime];
   span<const std::byte> thread_name_;
 };
 
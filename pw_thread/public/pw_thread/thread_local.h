@@ -0,0 +1,125 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+#include "pw_assert/check.h"
+#include "pw_thread/config.h"
+#include "pw_thread_backend/thread_local_native.h"
+
+namespace pw::thread {
+namespace backend {
+
+// The backend provides `inline constexpr size_t kNumThreadLocalSlots`, the
+// number of thread-local pointers available to ThreadLocal objects.
+
+// Returns the calling thread's pointer in the given thread-local slot, or null
+// if the thread has not set it.
+void* GetThreadLocalPointer(size_t slot);
+
+// Sets the calling thread's pointer in the given thread-local slot.
+void SetThreadLocalPointer(size_t slot, void* pointer);
+
+}  // namespace backend
+
+namespace internal {
+
+// Claims an unused thread-local slot. Slots are never released, since threads
+// may still refer to them. Crashes if all of the backend's slots are claimed.
+size_t AcquireThreadLocalSlot();
+
+}  // namespace internal
+
+// A value of type T for each thread that accesses it.
+//
+// Each thread's value is default-constructed on its first access, and is only
+// accessed by that thread, so no locking is needed. Values are stored in this
+// object rather than allocated: up to kMaxThreads threads may hold a value at
+// the same time, and a thread holding a value past that crashes.
+//
+// Each ThreadLocal uses one of the backend's thread-local slots for the life
+// of the program, so ThreadLocal objects should have static storage duration.
+//
+// A thread's value is not destroyed when the thread exits. Threads that exit
+// should call Release() first so that another thread can reuse the storage.
+//
+// This is not IRQ safe.
+template <typename T, size_t kMaxThreads = PW_THREAD_MAXIMUM_THREADS>
+class ThreadLocal {
+ public:
+  ThreadLocal() : slot_(internal::AcquireThreadLocalSlot()) {
+    static_assert(backend::kNumThreadLocalSlots > 0,
+                  "The pw_thread thread_local backend has no slots; check "
+                  "its configuration");
+  }
+
+  ThreadLocal(const ThreadLocal&) = delete;
+  ThreadLocal& operator=(const ThreadLocal&) = delete;
+
+  // Returns the calling thread's value, constructing it if needed.
+  T& get() {
+    void* pointer = backend::GetThreadLocalPointer(slot_);
+    if (pointer != nullptr) {
+      return **static_cast<std::optional<T>*>(pointer);
+    }
+    return Claim();
+  }
+
+  T& operator*() { return get(); }
+  T* operator->() { return &get(); }
+
+  // Returns whether the calling thread currently has a value.
+  bool has_value() const {
+    return backend::GetThreadLocalPointer(slot_) != nullptr;
+  }
+
+  // Destroys the calling thread's value, if any, and makes its storage
+  // available to other threads.
+  void Release() {
+    auto* value =
+        static_cast<std::optional<T>*>(backend::GetThreadLocalPointer(slot_));
+    if (value == nullptr) {
+      return;
+    }
+    value->reset();
+    backend::SetThreadLocalPointer(slot_, nullptr);
+    in_use_[static_cast<size_t>(value - values_.data())].store(
+        false, std::memory_order_release);
+  }
+
+ private:
+  T& Claim() {
+    for (size_t i = 0; i < kMaxThreads; ++i) {
+      if (!in_use_[i].exchange(true, std::memory_order_acquire)) {
+        T& value = values_[i].emplace();
+        backend::SetThreadLocalPointer(slot_, &values_[i]);
+        return value;
+      }
+    }
+    PW_CRASH("More than %u threads hold a ThreadLocal value",
+             static_cast<unsigned>(kMaxThreads));
+  }
+
+  const size_t slot_;
+  std::array<std::atomic<bool>, kMaxThreads> in_use_{};
+  std::array<std::optional<T>, kMaxThreads> values_;
+};
+
+}  // namespace pw::thread
+
+#include "pw_thread_backend/thread_local_inline.h"
@@ -0,0 +1,314 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "pw_span/span.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/thread_core.h"
+
+static_assert(PW_THREAD_JOINING_ENABLED,
+              "pw::thread::ThreadPool joins its workers, so it requires a "
+              "pw_thread_THREAD backend with joining enabled");
+
+namespace pw::thread {
+
+/// A fixed set of worker threads that run data-parallel jobs.
+///
+/// A job is split into chunks, which are processed by the pool's workers and
+/// by the thread that started the job. Each of these threads starts with an
+/// even share of the chunks, processing them in order from the front. A
+/// thread that runs out of chunks steals the back half of the remaining chunks
+/// of another thread, so work is balanced even when chunks take different
+/// amounts of time or threads are scheduled unevenly.
+///
+/// Jobs are usually run with `ParallelFor` or `ParallelReduce`. Jobs run one
+/// at a time; a thread that starts a job while another is running blocks until
+/// the running job finishes.
+///
+/// `GenericThreadPool` is the size-independent interface to `ThreadPool`.
+class GenericThreadPool {
+ public:
+  /// Iterates over the chunks that one thread processes for a job.
+  class Chunks {
+   public:
+    /// Claims the next chunk to process, stealing chunks from other threads
+    /// once this thread's own chunks run out.
+    ///
+    /// @returns `true` and sets `chunk` to the index of the chunk to process,
+    /// or `false` if there are no chunks left to claim.
+    bool Next(size_t& chunk) { return pool_.Claim(participant_, chunk); }
+
+   private:
+    friend class GenericThreadPool;
+
+    constexpr Chunks(GenericThreadPool& pool, size_t participant)
+        : pool_(pool), participant_(participant) {}
+
+    GenericThreadPool& pool_;
+    size_t participant_;
+  };
+
+  /// Processes the chunks of a job, until `chunks.Next()` returns `false`.
+  using JobFunction = void (*)(void* context, Chunks& chunks);
+
+  GenericThreadPool(const GenericThreadPool&) = delete;
+  GenericThreadPool& operator=(const GenericThreadPool&) = delete;
+
+  /// @returns The number of threads that process each job: the pool's workers
+  /// and the thread that starts the job.
+  size_t concurrency() const { return workers_.size() + 1; }
+
+  /// @returns The number of items per chunk to split `item_count` items into,
+  /// so that each thread processes several chunks. Chunks have at least
+  /// `min_chunk_size` items, which should be large enough that processing a
+  /// chunk takes much longer than claiming one.
+  size_t ChunkSize(size_t item_count, size_t min_chunk_size = 1) const;
+
+  /// Runs a job of `chunk_count` chunks, and returns once every chunk has been
+  /// processed. `function` is called with `context` once on each thread of the
+  /// pool, and on the calling thread.
+  ///
+  /// Must not be called from within a job.
+  void Run(size_t chunk_count, JobFunction function, void* context)
+      PW_LOCKS_EXCLUDED(job_mutex_);
+
+ protected:
+  // The chunks that remain to be claimed by one thread.
+  struct ChunkRange {
+    sync::InterruptSpinLock lock;
+    size_t begin PW_GUARDED_BY(lock) = 0;
+    size_t end PW_GUARDED_BY(lock) = 0;
+  };
+
+  class Worker final : public ThreadCore {
+   public:
+    Worker() = default;
+
+   private:
+    friend class GenericThreadPool;
+
+    void Run() override;
+
+    GenericThreadPool* pool_ = nullptr;
+    size_t participant_ = 0;
+    ChunkRange range_;
+    sync::ThreadNotification work_;
+    Thread thread_;
+  };
+
+  explicit GenericThreadPool(span<Worker> workers) : workers_(workers) {}
+
+  ~GenericThreadPool() = default;
+
+  // Starts a thread for each worker with the corresponding options.
+  void Start(span<const Options* const> options);
+
+  // Stops and joins all workers.
+  void Stop() PW_LOCKS_EXCLUDED(job_mutex_);
+
+ private:
+  // Participant 0 is the thread that runs the job, and participant N is
+  // worker N - 1.
+  ChunkRange& range(size_t participant) {
+    return participant == 0 ? caller_range_ : workers_[participant - 1].range_;
+  }
+
+  void Participate(size_t participant) {
+    Chunks chunks(*this, participant);
+    function_(context_, chunks);
+  }
+
+  bool Claim(size_t participant, size_t& chunk);
+
+  // Moves the back half of another participant's remaining chunks to this
+  // participant. Returns false if no participant has chunks left.
+  bool Steal(size_t participant);
+
+  span<Worker> workers_;
+
+  sync::Mutex job_mutex_;
+
+  // Set with job_mutex_ held before waking workers, which read these after
+  // waking.
+  bool stop_requested_ = false;
+  JobFunction function_ = nullptr;
+  void* context_ = nullptr;
+
+  ChunkRange caller_range_;
+
+  // The number of participants that have not finished the current job. The
+  // last worker to finish notifies the caller if the caller is waiting.
+  std::atomic<size_t> active_ = 0;
+  sync::ThreadNotification done_;
+};
+
+/// A `GenericThreadPool` with `kWorkerCount` workers, which are started when
+/// the pool is constructed and joined when it is destroyed.
+///
+/// @code{.cpp}
+///   pw::thread::ThreadPool pool(worker_options_0, worker_options_1);
+///
+///   pw::thread::ParallelFor(
+///       pool, pw::span(samples), [](pw::span<Sample> chunk) {
+///         for (Sample& sample : chunk) {
+///           Filter(sample);
+///         }
+///       });
+/// @endcode
+template <size_t kWorkerCount>
+class ThreadPool final : public GenericThreadPool {
+ public:
+  static_assert(kWorkerCount > 0, "A ThreadPool must have at least 1 worker");
+
+  /// Starts one worker with each of the given thread options.
+  template <typename... WorkerOptions,
+            typename = std::enable_if_t<
+                sizeof...(WorkerOptions) == kWorkerCount &&
+                (std::is_base_of_v<Options, WorkerOptions> && ...)>>
+  explicit ThreadPool(const WorkerOptions&... options)
+      : GenericThreadPool(workers_) {
+    const std::array<const Options*, kWorkerCount> worker_options = {
+        &options...};
+    Start(worker_options);
+  }
+
+  ~ThreadPool() { Stop(); }
+
+ private:
+  std::array<Worker, kWorkerCount> workers_;
+};
+
+template <typename... WorkerOptions>
+ThreadPool(const WorkerOptions&...) -> ThreadPool<sizeof...(WorkerOptions)>;
+
+namespace internal {
+
+template <typename T>
+span<T> Chunk(span<T> items, size_t chunk_size, size_t chunk) {
+  const size_t offset = chunk * chunk_size;
+  return items.subspan(offset, std::min(chunk_size, items.size() - offset));
+}
+
+inline size_t ChunkCount(size_t item_count, size_t chunk_size) {
+  return item_count / chunk_size + (item_count % chunk_size != 0 ? 1 : 0);
+}
+
+}  // namespace internal
+
+/// Calls `body` with consecutive chunks of `items` on the threads of `pool`,
+/// and returns once every item has been processed.
+///
+/// `body` is a callable taking a `span<T>`. It is called concurrently from
+/// several threads, each time with a different chunk of at least
+/// `min_chunk_size` items (except for the last chunk).
+template <typename T, size_t kExtent, typename Body>
+void ParallelFor(GenericThreadPool& pool,
+                 span<T, kExtent> items,
+                 Body&& body,
+                 size_t min_chunk_size = 1) {
+  struct Job {
+    span<T> items;
+    size_t chunk_size;
+    std::remove_reference_t<Body>& body;
+  } job{items, pool.ChunkSize(items.size(), min_chunk_size), body};
+
+  pool.Run(
+      internal::ChunkCount(items.size(), job.chunk_size),
+      [](void* context, GenericThreadPool::Chunks& chunks) {
+        Job& current = *static_cast<Job*>(context);
+        size_t chunk;
+        while (chunks.Next(chunk)) {
+          current.body(
+              internal::Chunk(current.items, current.chunk_size, chunk));
+        }
+      },
+      &job);
+}
+
+/// Reduces `items` to a single value on the threads of `pool`.
+///
+/// Each thread combines `map(chunk)` for the chunks it processes into a
+/// partial result, starting from `identity`, and the partial results are then
+/// combined. Since chunks may be processed and combined in any order,
+/// `combine` must be associative and commutative, and `identity` must not
+/// change a value it is combined with.
+///
+/// @param map Callable that takes a `span<T>` chunk and returns a `Result`.
+/// It is called concurrently from several threads.
+/// @param combine Callable that takes two `Result`s and returns a `Result`.
+template <typename T,
+          size_t kExtent,
+          typename Result,
+          typename Map,
+          typename Combine>
+Result ParallelReduce(GenericThreadPool& pool,
+                      span<T, kExtent> items,
+                      Result identity,
+                      Map&& map,
+                      Combine&& combine,
+                      size_t min_chunk_size = 1) {
+  struct Job {
+    span<T> items;
+    size_t chunk_size;
+    const Result& identity;
+    std::remove_reference_t<Map>& map;
+    std::remove_reference_t<Combine>& combine;
+    Result result;
+    sync::Mutex mutex;
+  } job{items,
+        pool.ChunkSize(items.size(), min_chunk_size),
+        identity,
+        map,
+        combine,
+        identity,
+        {}};
+
+  pool.Run(
+      internal::ChunkCount(items.size(), job.chunk_size),
+      [](void* context, GenericThreadPool::Chunks& chunks) {
+        Job& current = *static_cast<Job*>(context);
+        size_t chunk;
+        if (!chunks.Next(chunk)) {
+          return;
+        }
+        Result partial = current.identity;
+        do {
+          partial = current.combine(
+              std::move(partial),
+              current.map(
+                  internal::Chunk(current.items, current.chunk_size, chunk)));
+        } while (chunks.Next(chunk));
+
+        std::lock_guard lock(current.mutex);
+        current.result =
+            current.combine(std::move(current.result), std::move(partial));
+      },
+      &job);
+
+  return std::move(job.result);
+}
+
+}  // namespace pw::thread
@@ -0,0 +1,131 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_containers/vector.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_thread/config.h"
+#include "pw_thread/thread_info.h"
+#include "pw_thread/thread_iteration.h"
+
+namespace pw::thread {
+
+// Per-thread runtime usage over one profiling interval.
+struct ThreadUsage {
+  span<const std::byte> name;
+
+  // Share of the run time of all threads during the interval, in hundredths
+  // of a percent (e.g. 5.00% = 500). On backends that report the idle thread
+  // this is the thread's share of the CPU.
+  std::optional<uint32_t> cpu_usage_hundredths;
+
+  // Number of times the thread was switched in during the interval.
+  std::optional<uint64_t> context_switches;
+
+  // Average time the thread waited for the CPU after becoming ready, in
+  // nanoseconds, over the interval.
+  std::optional<uint64_t> average_scheduling_latency_ns;
+};
+
+// ThreadProfiler computes per-thread CPU usage, context switches and
+// scheduling latency from the cumulative counters that the thread_iteration
+// backend reports in ThreadInfo.
+//
+// Each call to Sample() iterates all threads and measures the interval since
+// the previous call; the first call only establishes a baseline. Threads are
+// identified by name, so names should be unique.
+//
+// Which statistics are available depends on the backend: FreeRTOS reports run
+// time when configGENERATE_RUN_TIME_STATS is enabled, Zephyr reports run time
+// when CONFIG_SCHED_THREAD_USAGE is enabled, and Linux reports all of them.
+class ThreadProfiler {
+ public:
+  using ForEachThreadFunction = Status (*)(const ThreadCallback&);
+
+  class Entry {
+   public:
+    const ThreadUsage& usage() const { return usage_; }
+
+   private:
+    friend class ThreadProfiler;
+
+    std::array<std::byte, PW_THREAD_PROFILER_MAX_NAME_LENGTH> name_{};
+    size_t name_size_ = 0;
+
+    // Counters from the previous sample.
+    std::optional<uint64_t> run_time_;
+    std::optional<uint64_t> context_switches_;
+    std::optional<uint64_t> ready_time_ns_;
+
+    std::optional<uint64_t> run_time_delta_;
+    ThreadUsage usage_;
+    bool seen_ = false;
+  };
+
+  // `for_each_thread` may be overridden to profile threads from a source other
+  // than the thread_iteration backend.
+  explicit ThreadProfiler(Vector<Entry>& entries,
+                          ForEachThreadFunction for_each_thread = ForEachThread)
+      : entries_(entries), for_each_thread_(for_each_thread) {}
+
+  // Measures thread usage since the previous call.
+  //
+  // Returns:
+  //   OK - Usage was updated.
+  //   RESOURCE_EXHAUSTED - More threads exist than there are entries; threads
+  //       that did not fit were not profiled.
+  //   Any error from the thread_iteration backend.
+  Status Sample();
+
+  // Usage of each thread over the last interval, in iteration order.
+  span<const Entry> entries() const { return entries_; }
+
+  // Discards all measurements; the next Sample() establishes a new baseline.
+  void Reset() {
+    entries_.clear();
+    sampled_ = false;
+  }
+
+ private:
+  // Records a thread's counters. Runs from ForEachThread(), possibly with the
+  // scheduler disabled, so this must not block or log.
+  bool Record(const ThreadInfo& info);
+
+  Entry* Find(span<const std::byte> name);
+
+  Vector<Entry>& entries_;
+  ForEachThreadFunction for_each_thread_;
+  bool sampled_ = false;
+  bool overflowed_ = false;
+};
+
+// A ThreadProfiler with storage for `kMaxThreads` threads.
+template <size_t kMaxThreads = PW_THREAD_MAXIMUM_THREADS>
+class ThreadProfilerBuffer : public ThreadProfiler {
+ public:
+  explicit ThreadProfilerBuffer(
+      ForEachThreadFunction for_each_thread = ForEachThread)
+      : ThreadProfiler(entries_, for_each_thread) {}
+
+ private:
+  Vector<Entry, kMaxThreads> entries_;
+};
+
+}  // namespace pw::thread
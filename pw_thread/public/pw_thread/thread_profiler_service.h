@@ -0,0 +1,92 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_status/status.h"
+#include "pw_sync/lock_annotations.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/config.h"
+#include "pw_thread/thread_profiler.h"
+#include "pw_thread_protos/thread.pwpb.h"
+#include "pw_thread_protos/thread_profiler_service.raw_rpc.pb.h"
+
+namespace pw::thread::proto {
+
+// Calculates the encode buffer size needed to report `num_threads` threads.
+constexpr size_t RequiredProfilerBufferSize(
+    size_t num_threads = PW_THREAD_MAXIMUM_THREADS) {
+  return (pwpb::SnapshotThreadInfo::kMaxEncodedSizeBytes +
+          pwpb::Thread::kMaxEncodedSizeBytes) *
+         num_threads;
+}
+
+// The ThreadProfilerService streams per-thread CPU usage, context switches and
+// scheduling latency to a client that calls StreamThreadUsage().
+//
+// The service does not sample on its own. The application calls
+// PublishUsage() at the desired reporting period (e.g. from a timer or a work
+// queue), which samples the profiler and sends the results to the open
+// stream. Threads are sent in bundles of `num_bundled_threads` per message.
+class ThreadProfilerService
+    : public pw_rpc::raw::ThreadProfilerService::Service<
+          ThreadProfilerService> {
+ public:
+  ThreadProfilerService(
+      ThreadProfiler& profiler,
+      ByteSpan encode_buffer,
+      size_t num_bundled_threads = PW_THREAD_NUM_BUNDLED_THREADS)
+      : profiler_(profiler),
+        encode_buffer_(encode_buffer),
+        num_bundled_threads_(num_bundled_threads) {}
+
+  void StreamThreadUsage(ConstByteSpan request, rpc::RawServerWriter& writer);
+
+  // Samples thread usage and sends it to the open stream, if any. The first
+  // call only establishes a baseline and sends nothing.
+  //
+  // Returns:
+  //   OK - Usage was sent, or there is no open stream.
+  //   RESOURCE_EXHAUSTED - The encode buffer or profiler is too small.
+  //   Any error from sampling threads or writing to the stream.
+  Status PublishUsage() PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  sync::Mutex lock_;
+  ThreadProfiler& profiler_;
+  ByteSpan encode_buffer_ PW_GUARDED_BY(lock_);
+  const size_t num_bundled_threads_;
+  rpc::RawServerWriter writer_ PW_GUARDED_BY(lock_);
+  bool has_baseline_ PW_GUARDED_BY(lock_) = false;
+};
+
+// A ThreadProfilerService that allocates the profiler and encode buffer for
+// `kNumThreads` threads.
+template <size_t kNumThreads = PW_THREAD_MAXIMUM_THREADS>
+class ThreadProfilerServiceBuffer : public ThreadProfilerService {
+ public:
+  ThreadProfilerServiceBuffer()
+      : ThreadProfilerService(profiler_, encode_buffer_) {}
+
+ private:
+  ThreadProfilerBuffer<kNumThreads> profiler_;
+  std::array<std::byte, RequiredProfilerBufferSize(kNumThreads)>
+      encode_buffer_;
+};
+
+}  // namespace pw::thread::proto
@@ -30,6 +30,48 @@ THREAD_STATE_TO_STRING: Mapping[int, str] = {
     thread_pb2.ThreadState.Enum.INACTIVE: 'INACTIVE',
 }
 
+_RLE_LITERAL_WORDS = 0
+_RLE_REPEATED_WORD = 1
+_RLE_LITERAL_BYTES = 2
+_RLE_WORD_SIZE = 4
+
+
+def decode_stack_rle(encoded: bytes) -> bytes:
+    """Decodes the run-length encoded raw_stack_rle field of a thread."""
+    stack = bytearray()
+    pos = 0
+    while pos < len(encoded):
+        header = 0
+        shift = 0
+        while True:
+            if pos >= len(encoded):
+                raise ValueError('Truncated raw_stack_rle header')
+            byte = encoded[pos]
+            pos += 1
+            header |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+
+        kind = header & 0x3
+        count = header >> 2
+        if kind == _RLE_LITERAL_WORDS:
+            size = count * _RLE_WORD_SIZE
+        elif kind == _RLE_REPEATED_WORD:
+            size = _RLE_WORD_SIZE
+        elif kind == _RLE_LITERAL_BYTES:
+            size = count
+        else:
+            raise ValueError(f'Unknown raw_stack_rle run kind {kind}')
+
+        payload = encoded[pos : pos + size]
+        if len(payload) != size:
+            raise ValueError('Truncated raw_stack_rle payload')
+        pos += size
+        stack += payload * count if kind == _RLE_REPEATED_WORD else payload
+
+    return bytes(stack)
+
 
 def process_snapshot(
     serialized_snapshot: bytes,
@@ -264,6 +306,14 @@ class ThreadSnapshotAnalyzer:
             self._threads.remove(requesting_thread)
             self._threads.insert(0, requesting_thread)
 
+        # Resolve every thread's backtrace in one batch, so symbolizers that
+        # cache results don't resolve addresses one at a time per thread.
+        self._symbolizer.symbolize_all(
+            address
+            for thread in self._threads
+            for address in thread.raw_backtrace
+        )
+
         for thread in self._threads:
             thread_name = thread.name.decode()
             if not thread_name:
@@ -281,12 +331,13 @@ class ThreadSnapshotAnalyzer:
                 output.append(
                     self._symbolizer.dump_stack_trace(thread.raw_backtrace)
                 )
-            if thread.raw_stack:
+            raw_stack = thread.raw_stack
+            if not raw_stack and thread.raw_stack_rle:
+                raw_stack = decode_stack_rle(thread.raw_stack_rle)
+            if raw_stack:
                 output.append('Raw Stack')
                 output.append(
-                    binascii.hexlify(thread.raw_stack, b'\n', 32).decode(
-                        'utf-8'
-                    )
+                    binascii.hexlify(raw_stack, b'\n', 32).decode('utf-8')
                 )
             # Blank line between threads for nicer formatting.
             output.append('')
@@ -15,7 +15,11 @@
 """Tests for the thread analyzer."""
 
 import unittest
-from pw_thread.thread_analyzer import ThreadInfo, ThreadSnapshotAnalyzer
+from pw_thread.thread_analyzer import (
+    ThreadInfo,
+    ThreadSnapshotAnalyzer,
+    decode_stack_rle,
+)
 from pw_thread_protos import thread_pb2
 import pw_tokenizer
 from pw_tokenizer import tokens
@@ -380,5 +384,41 @@ class ThreadSnapshotAnalyzerTest(unittest.TestCase):
         self.assertEqual(str(analyzer), expected)
 
 
+class DecodeStackRleTest(unittest.TestCase):
+    """Tests decoding of the raw_stack_rle field."""
+
+    def test_empty(self):
+        self.assertEqual(decode_stack_rle(b''), b'')
+
+    def test_runs(self):
+        encoded = (
+            b'\x09\xaa\xbb\xcc\xdd'  # 2 repeated words.
+            b'\x04\x01\x02\x03\x04'  # 1 literal word.
+            b'\x0a\x05\x06'  # 2 literal bytes.
+        )
+        self.assertEqual(
+            decode_stack_rle(encoded),
+            b'\xaa\xbb\xcc\xdd\xaa\xbb\xcc\xdd\x01\x02\x03\x04\x05\x06',
+        )
+
+    def test_multibyte_header(self):
+        # 256 repeated words; header (256 << 2 | 1) = 1025.
+        encoded = b'\x81\x08\x00\x00\x00\x00'
+        self.assertEqual(decode_stack_rle(encoded), bytes(256 * 4))
+
+    def test_truncated(self):
+        with self.assertRaises(ValueError):
+            decode_stack_rle(b'\x08\x01\x02\x03\x04')
+
+    def test_analyzer_prints_decoded_stack(self):
+        snapshot = thread_pb2.SnapshotThreadInfo()
+        thread = thread_pb2.Thread(
+            name=b'Idle', raw_stack_rle=b'\x09\x00\x00\x00\x00'
+        )
+        snapshot.threads.append(thread)
+        analyzer = ThreadSnapshotAnalyzer(snapshot)
+        self.assertIn('Raw Stack\n0000000000000000', str(analyzer))
+
+
 if __name__ == '__main__':
     unittest.main()
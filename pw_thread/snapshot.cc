@@ -16,7 +16,9 @@
 
 #include "pw_thread/snapshot.h"
 
+#include <array>
 #include <cinttypes>
+#include <cstring>
 #include <string_view>
 
 #include "pw_bytes/span.h"
@@ -24,7 +26,9 @@
 #include "pw_log/log.h"
 #include "pw_protobuf/encoder.h"
 #include "pw_status/status.h"
+#include "pw_status/try.h"
 #include "pw_thread/config.h"
+#include "pw_thread/stack_rle.h"
 #include "pw_thread_protos/thread.pwpb.h"
 
 namespace pw::thread {
@@ -82,4 +86,35 @@ Status SnapshotStack(const StackContext& stack,
                     stack.stack_high_addr - stack.stack_pointer));
 }
 
+Status SnapshotCompressedStack(proto::pwpb::Thread::StreamEncoder& encoder,
+                               ConstByteSpan stack) {
+  StackRleReader reader(stack);
+  std::array<std::byte, 32> pipe_buffer;
+  return encoder.WriteBytesFromStream(
+      static_cast<uint32_t>(proto::pwpb::Thread::Fields::kRawStackRle),
+      reader,
+      reader.encoded_size(),
+      pipe_buffer);
+}
+
+Status SnapshotStackScanBacktrace(
+    proto::pwpb::Thread::StreamEncoder& encoder,
+    ConstByteSpan stack,
+    const Function<bool(uintptr_t)>& is_return_address,
+    size_t max_depth) {
+  size_t depth = 0;
+  for (size_t offset = 0;
+       depth < max_depth && offset + sizeof(uintptr_t) <= stack.size();
+       offset += sizeof(uintptr_t)) {
+    uintptr_t word;
+    std::memcpy(&word, &stack[offset], sizeof(word));
+    if (!is_return_address(word)) {
+      continue;
+    }
+    PW_TRY(encoder.WriteRawBacktrace(word));
+    ++depth;
+  }
+  return encoder.status();
+}
+
 }  // namespace pw::thread
@@ -0,0 +1,117 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/stack_rle.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_varint/varint.h"
+
+namespace pw::thread {
+namespace {
+
+// Largest count that fits in a header along with the run kind.
+constexpr size_t kMaxRunCount = (uint32_t{1} << 29) - 1;
+
+constexpr uint32_t Header(uint32_t kind, size_t count) {
+  return static_cast<uint32_t>(count << 2) | kind;
+}
+
+}  // namespace
+
+StackRleReader::StackRleReader(ConstByteSpan stack) : stack_(stack) {
+  for (size_t word = 0; word < num_words();) {
+    const Run run = NextRun(word);
+    encoded_size_ += varint::EncodedSize(Header(run.kind, run.count));
+    encoded_size_ += run.kind == kRepeatedWord
+                         ? sizeof(uint32_t)
+                         : run.count * sizeof(uint32_t);
+    word += run.count;
+  }
+  const size_t tail = stack_.size() % sizeof(uint32_t);
+  if (tail != 0) {
+    encoded_size_ += varint::EncodedSize(Header(kLiteralBytes, tail)) + tail;
+  }
+}
+
+uint32_t StackRleReader::Word(size_t index) const {
+  uint32_t word;
+  std::memcpy(&word, &stack_[index * sizeof(uint32_t)], sizeof(word));
+  return word;
+}
+
+StackRleReader::Run StackRleReader::NextRun(size_t word) const {
+  const size_t end = std::min(num_words(), word + kMaxRunCount);
+
+  // Two or more equal words are cheaper as a repeated run.
+  size_t repeat_end = word + 1;
+  while (repeat_end < end && Word(repeat_end) == Word(word)) {
+    ++repeat_end;
+  }
+  if (repeat_end - word >= 2) {
+    return {kRepeatedWord, repeat_end - word};
+  }
+
+  // Otherwise, copy words up to the start of the next repeated run.
+  size_t literal_end = word + 1;
+  while (literal_end < end &&
+         !(literal_end + 1 < num_words() &&
+           Word(literal_end) == Word(literal_end + 1))) {
+    ++literal_end;
+  }
+  return {kLiteralWords, literal_end - word};
+}
+
+void StackRleReader::StartRun() {
+  uint32_t header;
+  if (next_word_ < num_words()) {
+    const Run run = NextRun(next_word_);
+    header = Header(run.kind, run.count);
+    const size_t payload_words = run.kind == kRepeatedWord ? 1 : run.count;
+    pending_payload_ = stack_.subspan(next_word_ * sizeof(uint32_t),
+                                      payload_words * sizeof(uint32_t));
+    next_word_ += run.count;
+  } else {
+    const size_t tail = stack_.size() % sizeof(uint32_t);
+    header = Header(kLiteralBytes, tail);
+    pending_payload_ = stack_.last(tail);
+    tail_done_ = true;
+  }
+  pending_header_ = span(header_).first(varint::Encode(header, header_));
+}
+
+StatusWithSize StackRleReader::DoRead(ByteSpan destination) {
+  if (position_ == encoded_size_) {
+    return StatusWithSize::OutOfRange();
+  }
+
+  size_t written = 0;
+  while (written < destination.size() && position_ < encoded_size_) {
+    if (pending_header_.empty() && pending_payload_.empty()) {
+      StartRun();
+    }
+    ConstByteSpan& pending =
+        pending_header_.empty() ? pending_payload_ : pending_header_;
+    const size_t to_copy =
+        std::min(pending.size(), destination.size() - written);
+    std::memcpy(&destination[written], pending.data(), to_copy);
+    pending = pending.subspan(to_copy);
+    written += to_copy;
+    position_ += to_copy;
+  }
+  return StatusWithSize(written);
+}
+
+}  // namespace pw::thread
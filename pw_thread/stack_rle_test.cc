@@ -0,0 +1,140 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/stack_rle.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "pw_bytes/array.h"
+#include "pw_unit_test/framework.h"
+#include "pw_varint/varint.h"
+
+namespace pw::thread {
+namespace {
+
+// Reference decoder for the raw_stack_rle encoding.
+std::vector<std::byte> Decode(ConstByteSpan encoded) {
+  std::vector<std::byte> decoded;
+  while (!encoded.empty()) {
+    uint64_t header;
+    const size_t header_size = varint::Decode(encoded, &header);
+    EXPECT_NE(header_size, 0u);
+    if (header_size == 0) {
+      return decoded;
+    }
+    encoded = encoded.subspan(header_size);
+    const size_t count = static_cast<size_t>(header >> 2);
+    switch (header & 0x3) {
+      case StackRleReader::kLiteralWords:
+        decoded.insert(decoded.end(),
+                       encoded.begin(),
+                       encoded.begin() + count * sizeof(uint32_t));
+        encoded = encoded.subspan(count * sizeof(uint32_t));
+        break;
+      case StackRleReader::kRepeatedWord:
+        for (size_t i = 0; i < count; ++i) {
+          decoded.insert(decoded.end(),
+                         encoded.begin(),
+                         encoded.begin() + sizeof(uint32_t));
+        }
+        encoded = encoded.subspan(sizeof(uint32_t));
+        break;
+      case StackRleReader::kLiteralBytes:
+        decoded.insert(
+            decoded.end(), encoded.begin(), encoded.begin() + count);
+        encoded = encoded.subspan(count);
+        break;
+      default:
+        ADD_FAILURE();
+        return decoded;
+    }
+  }
+  return decoded;
+}
+
+// Reads the whole stream `chunk_size` bytes at a time.
+std::vector<std::byte> ReadAll(StackRleReader& reader, size_t chunk_size) {
+  std::vector<std::byte> encoded;
+  std::array<std::byte, 64> buffer;
+  while (true) {
+    Result<ByteSpan> result = reader.Read(span(buffer).first(chunk_size));
+    if (!result.ok()) {
+      EXPECT_EQ(result.status(), Status::OutOfRange());
+      break;
+    }
+    encoded.insert(encoded.end(), result->begin(), result->end());
+  }
+  return encoded;
+}
+
+void ExpectRoundTrip(ConstByteSpan stack) {
+  for (size_t chunk_size : {1u, 3u, 7u, 64u}) {
+    StackRleReader reader(stack);
+    const std::vector<std::byte> encoded = ReadAll(reader, chunk_size);
+    EXPECT_EQ(encoded.size(), reader.encoded_size());
+    const std::vector<std::byte> decoded = Decode(encoded);
+    ASSERT_EQ(decoded.size(), stack.size());
+    EXPECT_EQ(std::memcmp(decoded.data(), stack.data(), stack.size()), 0);
+  }
+}
+
+TEST(StackRle, EmptyStack) {
+  StackRleReader reader(ConstByteSpan{});
+  EXPECT_EQ(reader.encoded_size(), 0u);
+  std::array<std::byte, 4> buffer;
+  EXPECT_EQ(reader.Read(buffer).status(), Status::OutOfRange());
+}
+
+TEST(StackRle, RepeatedWordsCompress) {
+  std::array<uint32_t, 256> stack;
+  stack.fill(0xdeadbeef);
+  StackRleReader reader(as_bytes(span(stack)));
+  // One two-byte header and one word.
+  EXPECT_EQ(reader.encoded_size(), 2u + sizeof(uint32_t));
+  ExpectRoundTrip(as_bytes(span(stack)));
+}
+
+TEST(StackRle, LiteralWords) {
+  constexpr std::array<uint32_t, 4> kStack = {1, 2, 3, 4};
+  StackRleReader reader(as_bytes(span(kStack)));
+  EXPECT_EQ(reader.encoded_size(), 1u + sizeof(kStack));
+  ExpectRoundTrip(as_bytes(span(kStack)));
+}
+
+TEST(StackRle, MixedRuns) {
+  constexpr std::array<uint32_t, 12> kStack = {
+      0, 0, 0, 0, 0x08001235, 0x20001000, 7, 7, 0x08004321, 0, 0, 9};
+  ExpectRoundTrip(as_bytes(span(kStack)));
+}
+
+TEST(StackRle, TrailingBytes) {
+  constexpr auto kStack = bytes::Array<0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3>();
+  StackRleReader reader(kStack);
+  // Repeated zero word, then three literal bytes.
+  EXPECT_EQ(reader.encoded_size(), 1u + 4u + 1u + 3u);
+  ExpectRoundTrip(kStack);
+}
+
+TEST(StackRle, UnalignedStack) {
+  alignas(uint32_t) std::array<std::byte, 23> buffer = {};
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<std::byte>(i < 12 ? 0xaa : i);
+  }
+  ExpectRoundTrip(span(buffer).subspan(1));
+}
+
+}  // namespace
+}  // namespace pw::thread
@@ -95,5 +95,27 @@ TEST(ThreadInfo, PeakAddr) {
   EXPECT_EQ(thread_info.stack_peak_addr(), std::nullopt);
 }
 
+TEST(ThreadInfo, RuntimeStats) {
+  ThreadInfo thread_info;
+  // Getters.
+  EXPECT_EQ(thread_info.run_time(), std::nullopt);
+  EXPECT_EQ(thread_info.context_switches(), std::nullopt);
+  EXPECT_EQ(thread_info.ready_time_ns(), std::nullopt);
+  // Setters.
+  thread_info.set_run_time(0x123456789abcdefu);
+  thread_info.set_context_switches(42u);
+  thread_info.set_ready_time_ns(1000u);
+  EXPECT_EQ(thread_info.run_time(), 0x123456789abcdefu);
+  EXPECT_EQ(thread_info.context_switches(), 42u);
+  EXPECT_EQ(thread_info.ready_time_ns(), 1000u);
+  // Clear.
+  thread_info.clear_run_time();
+  thread_info.clear_context_switches();
+  thread_info.clear_ready_time_ns();
+  EXPECT_EQ(thread_info.run_time(), std::nullopt);
+  EXPECT_EQ(thread_info.context_switches(), std::nullopt);
+  EXPECT_EQ(thread_info.ready_time_ns(), std::nullopt);
+}
+
 }  // namespace
 }  // namespace pw::thread
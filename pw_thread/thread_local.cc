@@ -0,0 +1,32 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_local.h"
+
+#include <atomic>
+
+#include "pw_assert/check.h"
+
+namespace pw::thread::internal {
+
+size_t AcquireThreadLocalSlot() {
+  static std::atomic<size_t> next_slot = 0;
+  const size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+  PW_CHECK_UINT_LT(slot,
+                   backend::kNumThreadLocalSlots,
+                   "All pw_thread thread-local slots are in use");
+  return slot;
+}
+
+}  // namespace pw::thread::internal
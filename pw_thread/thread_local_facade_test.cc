@@ -0,0 +1,107 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_local.h"
+
+#include "pw_sync/binary_semaphore.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::thread {
+namespace {
+
+using test::TestThreadContext;
+
+struct Counter {
+  int value = 0;
+};
+
+ThreadLocal<Counter, 2> counter;
+ThreadLocal<int, 2> other;
+
+TEST(ThreadLocal, ConstructsValueOnFirstAccess) {
+  counter.Release();
+  EXPECT_FALSE(counter.has_value());
+  EXPECT_EQ(counter->value, 0);
+  EXPECT_TRUE(counter.has_value());
+
+  counter->value = 5;
+  EXPECT_EQ(counter.get().value, 5);
+  EXPECT_EQ((*counter).value, 5);
+}
+
+TEST(ThreadLocal, ObjectsAreIndependent) {
+  counter->value = 1;
+  *other = 2;
+  EXPECT_EQ(counter->value, 1);
+  EXPECT_EQ(*other, 2);
+}
+
+TEST(ThreadLocal, ReleaseDestroysValue) {
+  counter->value = 7;
+  counter.Release();
+  EXPECT_FALSE(counter.has_value());
+  EXPECT_EQ(counter->value, 0);
+}
+
+TEST(ThreadLocal, EachThreadHasItsOwnValue) {
+  counter->value = 1;
+
+  struct {
+    sync::BinarySemaphore done;
+    int initial_value = -1;
+    int final_value = -1;
+  } result;
+
+  TestThreadContext context;
+  Thread thread(context.options(), [&result] {
+    result.initial_value = counter->value;
+    counter->value = 100;
+    result.final_value = counter->value;
+    counter.Release();
+    result.done.release();
+  });
+  thread.detach();
+  result.done.acquire();
+
+  EXPECT_EQ(result.initial_value, 0);
+  EXPECT_EQ(result.final_value, 100);
+  EXPECT_EQ(counter->value, 1);
+}
+
+TEST(ThreadLocal, ReleasedStorageIsReused) {
+  counter->value = 1;
+
+  // Only one more thread fits; each releases its value before exiting.
+  for (int i = 0; i < 3; ++i) {
+    struct {
+      sync::BinarySemaphore done;
+      int value;
+    } run{.done = {}, .value = i};
+
+    TestThreadContext context;
+    Thread thread(context.options(), [&run] {
+      counter->value = run.value;
+      counter.Release();
+      run.done.release();
+    });
+    thread.detach();
+    run.done.acquire();
+  }
+  EXPECT_EQ(counter->value, 1);
+}
+
+}  // namespace
+}  // namespace pw::thread
@@ -0,0 +1,151 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_pool.h"
+
+#include "pw_assert/check.h"
+
+namespace pw::thread {
+namespace {
+
+// Splitting a job into several chunks per thread lets threads that finish
+// early, or start late, balance the work by stealing chunks.
+constexpr size_t kChunksPerThread = 8;
+
+}  // namespace
+
+size_t GenericThreadPool::ChunkSize(size_t item_count,
+                                    size_t min_chunk_size) const {
+  const size_t chunk_size =
+      internal::ChunkCount(item_count, concurrency() * kChunksPerThread);
+  return std::max({chunk_size, min_chunk_size, size_t{1}});
+}
+
+void GenericThreadPool::Run(size_t chunk_count,
+                            JobFunction function,
+                            void* context) {
+  std::lock_guard job_lock(job_mutex_);
+  function_ = function;
+  context_ = context;
+
+  // Workers are idle between jobs and have no chunks, so a job with a single
+  // chunk runs on the calling thread without waking them.
+  if (chunk_count <= 1) {
+    {
+      std::lock_guard lock(caller_range_.lock);
+      caller_range_.begin = 0;
+      caller_range_.end = chunk_count;
+    }
+    Participate(0);
+    return;
+  }
+
+  // Give each participant an even share of the chunks, computed without
+  // multiplying chunk_count so it cannot overflow.
+  const size_t participants = concurrency();
+  const size_t share = chunk_count / participants;
+  const size_t extra = chunk_count % participants;
+  for (size_t i = 0; i < participants; ++i) {
+    ChunkRange& chunks = range(i);
+    std::lock_guard lock(chunks.lock);
+    chunks.begin = i * share + std::min(i, extra);
+    chunks.end = chunks.begin + share + (i < extra ? 1 : 0);
+  }
+
+  active_.store(participants, std::memory_order_relaxed);
+  for (Worker& worker : workers_) {
+    worker.work_.release();
+  }
+
+  Participate(0);
+
+  // The job's context must outlive every worker's use of it.
+  if (active_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    done_.acquire();
+  }
+}
+
+void GenericThreadPool::Start(span<const Options* const> options) {
+  PW_CHECK_UINT_EQ(options.size(), workers_.size());
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    Worker& worker = workers_[i];
+    worker.pool_ = this;
+    worker.participant_ = i + 1;
+    worker.thread_ = Thread(*options[i], worker);
+  }
+}
+
+void GenericThreadPool::Stop() {
+  std::lock_guard job_lock(job_mutex_);
+  stop_requested_ = true;
+  for (Worker& worker : workers_) {
+    worker.work_.release();
+  }
+  for (Worker& worker : workers_) {
+    worker.thread_.join();
+  }
+}
+
+bool GenericThreadPool::Claim(size_t participant, size_t& chunk) {
+  ChunkRange& own = range(participant);
+  do {
+    std::lock_guard lock(own.lock);
+    if (own.begin != own.end) {
+      chunk = own.begin++;
+      return true;
+    }
+  } while (Steal(participant));
+  return false;
+}
+
+bool GenericThreadPool::Steal(size_t participant) {
+  for (size_t i = 1; i < concurrency(); ++i) {
+    ChunkRange& victim = range((participant + i) % concurrency());
+    size_t begin;
+    size_t end;
+    {
+      std::lock_guard lock(victim.lock);
+      const size_t remaining = victim.end - victim.begin;
+      if (remaining == 0) {
+        continue;
+      }
+      // The victim keeps the front half, which it processes next.
+      end = victim.end;
+      victim.end -= remaining - remaining / 2;
+      begin = victim.end;
+    }
+
+    ChunkRange& own = range(participant);
+    std::lock_guard lock(own.lock);
+    own.begin = begin;
+    own.end = end;
+    return true;
+  }
+  return false;
+}
+
+void GenericThreadPool::Worker::Run() {
+  while (true) {
+    work_.acquire();
+    if (pool_->stop_requested_) {
+      return;
+    }
+    pool_->Participate(participant_);
+    if (pool_->active_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      pool_->done_.release();
+    }
+  }
+}
+
+}  // namespace pw::thread
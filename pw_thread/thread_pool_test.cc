@@ -0,0 +1,145 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_pool.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/id.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::thread {
+namespace {
+
+class ThreadPoolTest : public ::testing::Test {
+ protected:
+  ThreadPoolTest()
+      : pool_(contexts_[0].options(),
+              contexts_[1].options(),
+              contexts_[2].options()) {}
+
+  std::array<test::TestThreadContext, 3> contexts_;
+  ThreadPool<3> pool_;
+};
+
+TEST_F(ThreadPoolTest, Concurrency) { EXPECT_EQ(pool_.concurrency(), 4u); }
+
+TEST_F(ThreadPoolTest, ChunkSize) {
+  EXPECT_EQ(pool_.ChunkSize(0), 1u);
+  EXPECT_EQ(pool_.ChunkSize(1000), 32u);
+  EXPECT_EQ(pool_.ChunkSize(1000, 100), 100u);
+}
+
+TEST_F(ThreadPoolTest, ParallelFor_ProcessesEachItemOnce) {
+  std::array<uint32_t, 1000> items{};
+  std::atomic<size_t> chunks = 0;
+
+  ParallelFor(pool_, span(items), [&chunks](span<uint32_t> chunk) {
+    for (uint32_t& item : chunk) {
+      item += 1;
+    }
+    chunks.fetch_add(1);
+  });
+
+  for (uint32_t item : items) {
+    EXPECT_EQ(item, 1u);
+  }
+  EXPECT_EQ(chunks.load(), 1000u / 32 + 1);
+}
+
+TEST_F(ThreadPoolTest, ParallelFor_NoItems) {
+  bool called = false;
+  ParallelFor(pool_, span<int>(), [&called](span<int>) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+TEST_F(ThreadPoolTest, ParallelFor_SingleChunkRunsOnCallingThread) {
+  std::array<int, 10> items{};
+  const Id caller = this_thread::get_id();
+  Id id;
+
+  ParallelFor(
+      pool_,
+      span(items),
+      [&id](span<int>) { id = this_thread::get_id(); },
+      /*min_chunk_size=*/items.size());
+
+  EXPECT_EQ(id, caller);
+}
+
+TEST_F(ThreadPoolTest, ParallelFor_RunsChunksConcurrently) {
+  // Processing either chunk blocks until the other one has started, so this
+  // only completes if two threads process chunks at the same time.
+  std::array<int, 2> items{};
+  std::array<sync::ThreadNotification, 2> started;
+
+  ParallelFor(pool_, span(items), [&](span<int> chunk) {
+    const size_t index = static_cast<size_t>(chunk.data() - items.data());
+    started[1 - index].release();
+    started[index].acquire();
+  });
+}
+
+TEST_F(ThreadPoolTest, ParallelReduce_Sum) {
+  std::array<uint32_t, 1234> items;
+  for (size_t i = 0; i < items.size(); ++i) {
+    items[i] = static_cast<uint32_t>(i);
+  }
+
+  const uint64_t sum = ParallelReduce(
+      pool_,
+      span<const uint32_t>(items),
+      uint64_t{0},
+      [](span<const uint32_t> chunk) {
+        uint64_t chunk_sum = 0;
+        for (uint32_t item : chunk) {
+          chunk_sum += item;
+        }
+        return chunk_sum;
+      },
+      [](uint64_t lhs, uint64_t rhs) { return lhs + rhs; });
+
+  EXPECT_EQ(sum, uint64_t{1234} * 1233 / 2);
+}
+
+TEST_F(ThreadPoolTest, ParallelReduce_NoItemsReturnsIdentity) {
+  const int max = ParallelReduce(
+      pool_,
+      span<const int>(),
+      -1,
+      [](span<const int>) { return 100; },
+      [](int lhs, int rhs) { return std::max(lhs, rhs); });
+  EXPECT_EQ(max, -1);
+}
+
+TEST_F(ThreadPoolTest, RunsManyJobs) {
+  std::array<uint32_t, 100> items{};
+  for (int i = 0; i < 100; ++i) {
+    ParallelFor(pool_, span(items), [](span<uint32_t> chunk) {
+      for (uint32_t& item : chunk) {
+        item += 1;
+      }
+    });
+  }
+  for (uint32_t item : items) {
+    EXPECT_EQ(item, 100u);
+  }
+}
+
+}  // namespace
+}  // namespace pw::thread
@@ -0,0 +1,143 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace pw::thread {
+namespace {
+
+constexpr uint64_t kHundredthsPerWhole = 10000;
+
+// Returns how much a cumulative counter advanced. A counter that went
+// backwards belongs to a new thread that reused the name.
+std::optional<uint64_t> Delta(std::optional<uint64_t> previous,
+                              std::optional<uint64_t> current) {
+  if (!previous.has_value() || !current.has_value()) {
+    return std::nullopt;
+  }
+  if (*current < *previous) {
+    return *current;
+  }
+  return *current - *previous;
+}
+
+uint32_t Hundredths(uint64_t part, uint64_t total) {
+  if (part <= std::numeric_limits<uint64_t>::max() / kHundredthsPerWhole) {
+    return static_cast<uint32_t>(part * kHundredthsPerWhole / total);
+  }
+  return static_cast<uint32_t>(part / (total / kHundredthsPerWhole));
+}
+
+}  // namespace
+
+Status ThreadProfiler::Sample() {
+  for (Entry& entry : entries_) {
+    entry.seen_ = false;
+  }
+  overflowed_ = false;
+
+  Status status = for_each_thread_(
+      [this](const ThreadInfo& info) { return Record(info); });
+  if (!status.ok()) {
+    return status;
+  }
+
+  // Forget threads that no longer exist.
+  entries_.erase(
+      std::remove_if(entries_.begin(),
+                     entries_.end(),
+                     [](const Entry& entry) { return !entry.seen_; }),
+      entries_.end());
+
+  uint64_t total_run_time = 0;
+  for (const Entry& entry : entries_) {
+    total_run_time += entry.run_time_delta_.value_or(0);
+  }
+
+  for (Entry& entry : entries_) {
+    entry.usage_.name = span(entry.name_).first(entry.name_size_);
+    entry.usage_.cpu_usage_hundredths.reset();
+    if (entry.run_time_delta_.has_value()) {
+      entry.usage_.cpu_usage_hundredths =
+          total_run_time == 0 ? 0
+                              : Hundredths(*entry.run_time_delta_,
+                                           total_run_time);
+    }
+  }
+
+  sampled_ = true;
+  return overflowed_ ? Status::ResourceExhausted() : OkStatus();
+}
+
+bool ThreadProfiler::Record(const ThreadInfo& info) {
+  if (!info.thread_name().has_value()) {
+    return true;
+  }
+  span<const std::byte> name = *info.thread_name();
+  name = name.first(
+      std::min(name.size(), size_t{PW_THREAD_PROFILER_MAX_NAME_LENGTH}));
+
+  Entry* entry = Find(name);
+  if (entry == nullptr) {
+    if (entries_.full()) {
+      overflowed_ = true;
+      return true;
+    }
+    entries_.emplace_back();
+    entry = &entries_.back();
+    std::memcpy(entry->name_.data(), name.data(), name.size());
+    entry->name_size_ = name.size();
+    if (sampled_) {
+      // The thread started during the interval, so all of its activity falls
+      // within it.
+      entry->run_time_ = 0;
+      entry->context_switches_ = 0;
+      entry->ready_time_ns_ = 0;
+    }
+  }
+
+  entry->run_time_delta_ = Delta(entry->run_time_, info.run_time());
+  const std::optional<uint64_t> switches =
+      Delta(entry->context_switches_, info.context_switches());
+  const std::optional<uint64_t> ready_time =
+      Delta(entry->ready_time_ns_, info.ready_time_ns());
+
+  entry->usage_.context_switches = switches;
+  entry->usage_.average_scheduling_latency_ns.reset();
+  if (switches.has_value() && ready_time.has_value() && *switches != 0) {
+    entry->usage_.average_scheduling_latency_ns = *ready_time / *switches;
+  }
+
+  entry->run_time_ = info.run_time();
+  entry->context_switches_ = info.context_switches();
+  entry->ready_time_ns_ = info.ready_time_ns();
+  entry->seen_ = true;
+  return true;
+}
+
+ThreadProfiler::Entry* ThreadProfiler::Find(span<const std::byte> name) {
+  for (Entry& entry : entries_) {
+    if (entry.name_size_ == name.size() &&
+        std::equal(name.begin(), name.end(), entry.name_.begin())) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace pw::thread
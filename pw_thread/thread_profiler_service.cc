@@ -0,0 +1,88 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "PW_THREAD"
+
+#include "pw_thread/thread_profiler_service.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "pw_log/log.h"
+#include "pw_status/try.h"
+
+namespace pw::thread::proto {
+namespace {
+
+Status EncodeThreadUsage(pwpb::SnapshotThreadInfo::MemoryEncoder& encoder,
+                         const ThreadUsage& usage) {
+  pwpb::Thread::StreamEncoder thread = encoder.GetThreadsEncoder();
+  PW_TRY(thread.WriteName(usage.name));
+  if (usage.cpu_usage_hundredths.has_value()) {
+    PW_TRY(thread.WriteCpuUsageHundredths(*usage.cpu_usage_hundredths));
+  }
+  if (usage.context_switches.has_value()) {
+    PW_TRY(thread.WriteContextSwitches(*usage.context_switches));
+  }
+  if (usage.average_scheduling_latency_ns.has_value()) {
+    PW_TRY(thread.WriteAverageSchedulingLatencyNs(
+        *usage.average_scheduling_latency_ns));
+  }
+  return thread.status();
+}
+
+}  // namespace
+
+void ThreadProfilerService::StreamThreadUsage(ConstByteSpan,
+                                              rpc::RawServerWriter& writer) {
+  std::lock_guard lock(lock_);
+  writer_ = std::move(writer);
+}
+
+Status ThreadProfilerService::PublishUsage() {
+  std::lock_guard lock(lock_);
+
+  // Keep sampling while no client is connected so that the first report
+  // after a client connects covers a full interval.
+  const Status sample_status = profiler_.Sample();
+  if (!sample_status.ok() && !sample_status.IsResourceExhausted()) {
+    return sample_status;
+  }
+  if (!has_baseline_) {
+    has_baseline_ = true;
+    return sample_status;
+  }
+  if (!writer_.active()) {
+    return OkStatus();
+  }
+
+  span<const ThreadProfiler::Entry> entries = profiler_.entries();
+  for (size_t i = 0; i < entries.size(); i += num_bundled_threads_) {
+    pwpb::SnapshotThreadInfo::MemoryEncoder encoder(encode_buffer_);
+    const size_t end = std::min(entries.size(), i + num_bundled_threads_);
+    for (size_t j = i; j < end; ++j) {
+      PW_TRY(EncodeThreadUsage(encoder, entries[j].usage()));
+    }
+    PW_TRY(encoder.status());
+    if (Status status =
+            writer_.Write(ConstByteSpan(encoder.data(), encoder.size()));
+        !status.ok()) {
+      PW_LOG_ERROR("Failed to send thread usage, error %d", status.code());
+      return status;
+    }
+  }
+  return sample_status;
+}
+
+}  // namespace pw::thread::proto
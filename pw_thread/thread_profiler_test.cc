@@ -0,0 +1,172 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_thread/thread_profiler.h"
+
+#include <optional>
+#include <string_view>
+
+#include "pw_containers/vector.h"
+#include "pw_span/span.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::thread {
+namespace {
+
+struct FakeThread {
+  std::string_view name;
+  std::optional<uint64_t> run_time;
+  std::optional<uint64_t> context_switches;
+  std::optional<uint64_t> ready_time_ns;
+};
+
+Vector<FakeThread, 8> fake_threads;
+
+Status ForEachFakeThread(const ThreadCallback& cb) {
+  for (const FakeThread& thread : fake_threads) {
+    ThreadInfo info;
+    info.set_thread_name(as_bytes(span(thread.name)));
+    if (thread.run_time.has_value()) {
+      info.set_run_time(*thread.run_time);
+    }
+    if (thread.context_switches.has_value()) {
+      info.set_context_switches(*thread.context_switches);
+    }
+    if (thread.ready_time_ns.has_value()) {
+      info.set_ready_time_ns(*thread.ready_time_ns);
+    }
+    if (!cb(info)) {
+      break;
+    }
+  }
+  return OkStatus();
+}
+
+Status ForEachThreadUnimplemented(const ThreadCallback&) {
+  return Status::Unimplemented();
+}
+
+std::string_view Name(const ThreadUsage& usage) {
+  return std::string_view(reinterpret_cast<const char*>(usage.name.data()),
+                          usage.name.size());
+}
+
+class ThreadProfilerTest : public ::testing::Test {
+ protected:
+  void SetUp() override { fake_threads.clear(); }
+
+  ThreadProfilerBuffer<3> profiler_{ForEachFakeThread};
+};
+
+TEST_F(ThreadProfilerTest, FirstSampleIsBaseline) {
+  fake_threads.push_back({"main", 100, 10, 1000});
+  ASSERT_EQ(profiler_.Sample(), OkStatus());
+
+  ASSERT_EQ(profiler_.entries().size(), 1u);
+  const ThreadUsage& usage = profiler_.entries()[0].usage();
+  EXPECT_EQ(Name(usage), "main");
+  EXPECT_EQ(usage.cpu_usage_hundredths, std::nullopt);
+  EXPECT_EQ(usage.context_switches, std::nullopt);
+  EXPECT_EQ(usage.average_scheduling_latency_ns, std::nullopt);
+}
+
+TEST_F(ThreadProfilerTest, ComputesUsageOverInterval) {
+  fake_threads.push_back({"idle", 1000, 5, 0});
+  fake_threads.push_back({"worker", 500, 20, 4000});
+  ASSERT_EQ(profiler_.Sample(), OkStatus());
+
+  fake_threads[0].run_time = 1750;      // +750
+  fake_threads[0].context_switches = 6;  // +1
+  fake_threads[1].run_time = 750;       // +250
+  fake_threads[1].context_switches = 30;  // +10
+  fake_threads[1].ready_time_ns = 9000;   // +5000
+  ASSERT_EQ(profiler_.Sample(), OkStatus());
+
+  ASSERT_EQ(profiler_.entries().size(), 2u);
+  const ThreadUsage& idle = profiler_.entries()[0].usage();
+  EXPECT_EQ(Name(idle), "idle");
+  EXPECT_EQ(idle.cpu_usage_hundredths, 7500u);
+  EXPECT_EQ(idle.context_switches, 1u);
+  EXPECT_EQ(idle.average_scheduling_latency_ns, 0u);
+
+  const ThreadUsage& worker = profiler_.entries()[1].usage();
+  EXPECT_EQ(Name(worker), "worker");
+  EXPECT_EQ(worker.cpu_usage_hundredths, 2500u);
+  EXPECT_EQ(worker.context_switches, 10u);
+  EXPECT_EQ(worker.average_scheduling_latency_ns, 500u);
+}
+
+TEST_F(ThreadProfilerTest, OnlyReportsAvailableStatistics) {
+  fake_threads.push_back({"a", 10, std::nullopt, std::nullopt});
+  fake_threads.push_back({"b", std::nullopt, std::nullopt, std::nullopt});
+  ASSERT_EQ(profiler_.Sample(), OkStatus());
+  fake_threads[0].run_time = 20;
+  ASSERT_EQ(profiler_.Sample(), OkStatus());
+
+  const ThreadUsage& a = profiler_.entries()[0].usage();
+  EXPECT_EQ(a.cpu_usage_hundredths, 10000u);
+  EXPECT_EQ(a.context_switches, std::nullopt);
+  EXPECT_EQ(a.average_scheduling_latency_ns, std::nullopt);
+
+  const ThreadUsage& b = profiler_.entries()[1].usage();
+  EXPECT_EQ(b.cpu_usage_hundredths, std::nullopt);
+}
+
+TEST_F(ThreadProfilerTest, TracksThreadsStartingAndExiting) {
+  fake_threads.push_back({"a", 100, std::nullopt, std::nullopt});
+  fake_threads.push_back({"b", 100, std::nullopt, std::nullopt});
+  ASSERT_EQ(profiler_.Sample(), OkStatus());
+
+  // "a" exits and "c" starts; all of c's run time is within the interval.
+  fake_threads.erase(fake_threads.begin());
+  fake_threads[0].run_time = 200;
+  fake_threads.push_back({"c", 300, std::nullopt, std::nullopt});
+  ASSERT_EQ(profiler_.Sample(), OkStatus());
+
+  ASSERT_EQ(profiler_.entries().size(), 2u);
+  EXPECT_EQ(Name(profiler_.entries()[0].usage()), "b");
+  EXPECT_EQ(profiler_.entries()[0].usage().cpu_usage_hundredths, 2500u);
+  EXPECT_EQ(Name(profiler_.entries()[1].usage()), "c");
+  EXPECT_EQ(profiler_.entries()[1].usage().cpu_usage_hundredths, 7500u);
+}
+
+TEST_F(ThreadProfilerTest, ReportsTooManyThreads) {
+  fake_threads.push_back({"a", 1, std::nullopt, std::nullopt});
+  fake_threads.push_back({"b", 1, std::nullopt, std::nullopt});
+  fake_threads.push_back({"c", 1, std::nullopt, std::nullopt});
+  fake_threads.push_back({"d", 1, std::nullopt, std::nullopt});
+  EXPECT_EQ(profiler_.Sample(), Status::ResourceExhausted());
+  EXPECT_EQ(profiler_.entries().size(), 3u);
+}
+
+TEST_F(ThreadProfilerTest, TruncatesLongNames) {
+  constexpr std::string_view kLongName =
+      "a thread name that is longer than the profiler keeps";
+  static_assert(kLongName.size() > PW_THREAD_PROFILER_MAX_NAME_LENGTH);
+  fake_threads.push_back({kLongName, 1, std::nullopt, std::nullopt});
+  ASSERT_EQ(profiler_.Sample(), OkStatus());
+  ASSERT_EQ(profiler_.Sample(), OkStatus());
+
+  ASSERT_EQ(profiler_.entries().size(), 1u);
+  EXPECT_EQ(Name(profiler_.entries()[0].usage()),
+            kLongName.substr(0, PW_THREAD_PROFILER_MAX_NAME_LENGTH));
+}
+
+TEST(ThreadProfiler, PropagatesIterationErrors) {
+  ThreadProfilerBuffer<1> profiler(ForEachThreadUnimplemented);
+  EXPECT_EQ(profiler.Sample(), Status::Unimplemented());
+}
+
+}  // namespace
+}  // namespace pw::thread
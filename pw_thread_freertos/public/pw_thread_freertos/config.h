@@ -63,6 +63,14 @@
 #define PW_THREAD_FREERTOS_CONFIG_MAXIMUM_PRIORITY (configMAX_PRIORITIES - 1)
 #endif  // PW_THREAD_FREERTOS_CONFIG_MAXIMUM_PRIORITY
 
+// The first FreeRTOS thread local storage pointer index used by
+// pw::thread::ThreadLocal. ThreadLocal objects use the indices from this one up
+// to configNUM_THREAD_LOCAL_STORAGE_POINTERS - 1, so lower indices remain
+// available to other users.
+#ifndef PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_STORAGE_FIRST_INDEX
+#define PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_STORAGE_FIRST_INDEX 0
+#endif  // PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_STORAGE_FIRST_INDEX
+
 // The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_THREAD_FREERTOS_CONFIG_LOG_LEVEL
 #define PW_THREAD_FREERTOS_CONFIG_LOG_LEVEL PW_LOG_LEVEL_DEBUG
@@ -0,0 +1,40 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "FreeRTOS.h"
+#include "pw_thread/thread_local.h"
+#include "pw_thread_freertos/config.h"
+#include "task.h"
+
+namespace pw::thread::backend {
+
+inline void* GetThreadLocalPointer(size_t slot) {
+  return pvTaskGetThreadLocalStoragePointer(
+      nullptr,
+      static_cast<BaseType_t>(
+          PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_STORAGE_FIRST_INDEX + slot));
+}
+
+inline void SetThreadLocalPointer(size_t slot, void* pointer) {
+  vTaskSetThreadLocalStoragePointer(
+      nullptr,
+      static_cast<BaseType_t>(
+          PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_STORAGE_FIRST_INDEX + slot),
+      pointer);
+}
+
+}  // namespace pw::thread::backend
@@ -0,0 +1,34 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "FreeRTOS.h"
+#include "pw_thread_freertos/config.h"
+#include "task.h"
+
+namespace pw::thread::backend {
+
+#ifdef configNUM_THREAD_LOCAL_STORAGE_POINTERS
+static_assert(PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_STORAGE_FIRST_INDEX <=
+              configNUM_THREAD_LOCAL_STORAGE_POINTERS);
+inline constexpr size_t kNumThreadLocalSlots =
+    configNUM_THREAD_LOCAL_STORAGE_POINTERS -
+    PW_THREAD_FREERTOS_CONFIG_THREAD_LOCAL_STORAGE_FIRST_INDEX;
+#else
+inline constexpr size_t kNumThreadLocalSlots = 0;
+#endif  // configNUM_THREAD_LOCAL_STORAGE_POINTERS
+
+}  // namespace pw::thread::backend
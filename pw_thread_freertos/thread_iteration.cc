@@ -59,6 +59,10 @@ bool StackInfoCollector(TaskHandle_t current_thread,
 #endif  // INCLUDE_uxTaskGetStackHighWaterMark
 #endif  // configRECORD_STACK_HIGH_ADDRESS
 
+#if configGENERATE_RUN_TIME_STATS
+  thread_info.set_run_time(tcb.ulRunTimeCounter);
+#endif  // configGENERATE_RUN_TIME_STATS
+
   return cb(thread_info);
 }
 
@@ -0,0 +1,29 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace pw::thread::backend {
+
+inline constexpr size_t kNumThreadLocalSlots = 16;
+
+namespace internal {
+
+inline thread_local std::array<void*, kNumThreadLocalSlots>
+    thread_local_pointers{};
+
+}  // namespace internal
+}  // namespace pw::thread::backend
@@ -16,12 +16,113 @@
 
 #include "pw_status/status.h"
 
+#if defined(__linux__)
+#include <dirent.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+#include "pw_span/span.h"
+#endif  // defined(__linux__)
+
 namespace pw::thread {
 
+#if defined(__linux__)
+
+namespace {
+
+// Reads a small procfs file into `buffer` as a null-terminated string.
+// Returns the number of characters read, or 0 if the file could not be read.
+size_t ReadProcFile(const char* path, span<char> buffer) {
+  std::FILE* file = std::fopen(path, "r");
+  if (file == nullptr) {
+    return 0;
+  }
+  const size_t length = std::fread(buffer.data(), 1, buffer.size() - 1, file);
+  std::fclose(file);
+  buffer[length] = '\0';
+  return length;
+}
+
+}  // namespace
+
+// Iterates the threads of the current process through procfs. Thread names
+// are "<tid>:<comm>", since threads of a process commonly share a comm.
+//
+// Run time, ready time and context switches come from each thread's
+// schedstat file, which requires a kernel built with CONFIG_SCHED_INFO. Stack
+// information is not available.
+Status ForEachThread(const pw::thread::ThreadCallback& cb) {
+  DIR* tasks = opendir("/proc/self/task");
+  if (tasks == nullptr) {
+    return Status::Unavailable();
+  }
+
+  while (const dirent* task = readdir(tasks)) {
+    char* end;
+    const unsigned long tid = std::strtoul(task->d_name, &end, 10);
+    if (end == task->d_name || *end != '\0') {
+      continue;  // Not a thread, e.g. "." or "..".
+    }
+
+    char path[64];
+    char comm[32];
+    std::snprintf(path, sizeof(path), "/proc/self/task/%lu/comm", tid);
+    size_t comm_length = ReadProcFile(path, comm);
+    if (comm_length == 0) {
+      continue;  // The thread exited.
+    }
+    if (comm[comm_length - 1] == '\n') {
+      comm[comm_length - 1] = '\0';
+    }
+
+    char name[64];
+    const int name_length =
+        std::snprintf(name, sizeof(name), "%lu:%s", tid, comm);
+    if (name_length <= 0) {
+      continue;
+    }
+
+    ThreadInfo thread_info;
+    thread_info.set_thread_name(as_bytes(span(
+        name,
+        std::min(static_cast<size_t>(name_length), sizeof(name) - 1))));
+
+    char schedstat[96];
+    std::snprintf(path, sizeof(path), "/proc/self/task/%lu/schedstat", tid);
+    uint64_t run_time_ns;
+    uint64_t ready_time_ns;
+    uint64_t timeslices;
+    if (ReadProcFile(path, schedstat) != 0 &&
+        std::sscanf(schedstat,
+                    "%" SCNu64 " %" SCNu64 " %" SCNu64,
+                    &run_time_ns,
+                    &ready_time_ns,
+                    &timeslices) == 3) {
+      thread_info.set_run_time(run_time_ns);
+      thread_info.set_ready_time_ns(ready_time_ns);
+      thread_info.set_context_switches(timeslices);
+    }
+
+    if (!cb(thread_info)) {
+      break;
+    }
+  }
+
+  closedir(tasks);
+  return OkStatus();
+}
+
+#else
+
 // Stub backend implementation for STL. Unable to provide real implementation
 // for thread iteration on STL targets.
 Status ForEachThread([[maybe_unused]] const pw::thread::ThreadCallback& cb) {
   return Status::Unimplemented();
 }
 
+#endif  // defined(__linux__)
+
 }  // namespace pw::thread
@@ -35,6 +35,13 @@ void zephyr_adapter(const struct k_thread* thread, void* user_data) {
                                 thread->stack_info.size);
 #endif
 
+#ifdef CONFIG_SCHED_THREAD_USAGE
+  k_thread_runtime_stats_t stats;
+  if (k_thread_runtime_stats_get((k_tid_t)thread, &stats) == 0) {
+    thread_info.set_run_time(stats.execution_cycles);
+  }
+#endif
+
   cb(thread_info);
 }
 }  // namespace zephyr
@@ -0,0 +1,79 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tls_client/kvs_session_cache.h"
+
+#include <cstdint>
+
+#include "pw_assert/check.h"
+
+namespace pw::tls_client {
+namespace {
+
+// A '#' and 8 hex digits.
+constexpr size_t kHashLength = 9;
+
+// 32-bit FNV-1a, which spreads similar names well and is tiny.
+uint32_t HashServerName(std::string_view server_name) {
+  uint32_t hash = 2166136261u;
+  for (char c : server_name) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+}  // namespace
+
+KvsSessionCache::KvsSessionCache(kvs::KeyValueStore& kvs,
+                                 std::string_view key_prefix)
+    : kvs_(kvs), key_prefix_(key_prefix) {
+  static_assert(kMaxKeyLength == kvs::internal::Entry::kMaxKeyLength);
+  PW_CHECK_UINT_LE(key_prefix_.size() + kHashLength, kMaxKeyLength);
+}
+
+Status KvsSessionCache::DoStore(std::string_view server_name,
+                                ConstByteSpan session) {
+  return kvs_.Put(MakeKey(server_name), session);
+}
+
+StatusWithSize KvsSessionCache::DoLoad(std::string_view server_name,
+                                       ByteSpan dest) {
+  return kvs_.Get(MakeKey(server_name), dest);
+}
+
+Status KvsSessionCache::DoErase(std::string_view server_name) {
+  return kvs_.Delete(MakeKey(server_name));
+}
+
+KvsSessionCache::Key KvsSessionCache::MakeKey(
+    std::string_view server_name) const {
+  Key key(key_prefix_);
+  if (key.size() + server_name.size() <= kMaxKeyLength) {
+    key.append(server_name);
+    return key;
+  }
+
+  // Keep as much of the name as fits, so keys remain recognizable.
+  key.append(server_name.substr(0, kMaxKeyLength - kHashLength - key.size()));
+  constexpr char kHexDigits[] = "0123456789abcdef";
+  const uint32_t hash = HashServerName(server_name);
+  key.push_back('#');
+  for (int shift = 28; shift >= 0; shift -= 4) {
+    key.push_back(kHexDigits[(hash >> shift) & 0xF]);
+  }
+  return key;
+}
+
+}  // namespace pw::tls_client
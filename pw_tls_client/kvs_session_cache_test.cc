@@ -0,0 +1,129 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tls_client/kvs_session_cache.h"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::tls_client {
+namespace {
+
+constexpr std::array<std::byte, 4> kSession = {
+    std::byte{0x01}, std::byte{0x02}, std::byte{0x03}, std::byte{0x04}};
+
+class KvsSessionCacheTest : public ::testing::Test {
+ protected:
+  KvsSessionCacheTest()
+      : flash_(16),
+        partition_(&flash_),
+        kvs_(&partition_, {.magic = 0x5e55c0de, .checksum = &checksum_}),
+        cache_(kvs_) {}
+
+  void SetUp() override {
+    ASSERT_EQ(partition_.Erase(), OkStatus());
+    ASSERT_EQ(kvs_.Init(), OkStatus());
+  }
+
+  kvs::FakeFlashMemoryBuffer<512, 4> flash_;
+  kvs::FlashPartition partition_;
+  kvs::ChecksumCrc16 checksum_;
+  kvs::KeyValueStoreBuffer<8, 4> kvs_;
+  KvsSessionCache cache_;
+};
+
+TEST_F(KvsSessionCacheTest, StoreAndLoad) {
+  ASSERT_EQ(cache_.Store("example.com", kSession), OkStatus());
+
+  std::array<std::byte, 16> buffer{};
+  StatusWithSize result = cache_.Load("example.com", buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), kSession.size());
+  EXPECT_TRUE(std::equal(kSession.begin(), kSession.end(), buffer.begin()));
+
+  // Sessions are stored under the prefix and the server name.
+  EXPECT_EQ(kvs_.ValueSize("tls_session/example.com").status(), OkStatus());
+}
+
+TEST_F(KvsSessionCacheTest, SessionsArePerServer) {
+  ASSERT_EQ(cache_.Store("example.com", kSession), OkStatus());
+
+  std::array<std::byte, 16> buffer{};
+  EXPECT_EQ(cache_.Load("example.org", buffer).status(), Status::NotFound());
+}
+
+TEST_F(KvsSessionCacheTest, StoreReplacesSession) {
+  constexpr std::array<std::byte, 2> kNewSession = {std::byte{0xAA},
+                                                    std::byte{0xBB}};
+  ASSERT_EQ(cache_.Store("example.com", kSession), OkStatus());
+  ASSERT_EQ(cache_.Store("example.com", kNewSession), OkStatus());
+
+  std::array<std::byte, 16> buffer{};
+  StatusWithSize result = cache_.Load("example.com", buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  ASSERT_EQ(result.size(), kNewSession.size());
+  EXPECT_EQ(buffer[0], std::byte{0xAA});
+}
+
+TEST_F(KvsSessionCacheTest, Erase) {
+  ASSERT_EQ(cache_.Store("example.com", kSession), OkStatus());
+  EXPECT_EQ(cache_.Erase("example.com"), OkStatus());
+  EXPECT_EQ(cache_.Erase("example.com"), Status::NotFound());
+
+  std::array<std::byte, 16> buffer{};
+  EXPECT_EQ(cache_.Load("example.com", buffer).status(), Status::NotFound());
+}
+
+TEST_F(KvsSessionCacheTest, LoadIntoSmallBuffer) {
+  ASSERT_EQ(cache_.Store("example.com", kSession), OkStatus());
+
+  std::array<std::byte, 2> buffer{};
+  EXPECT_EQ(cache_.Load("example.com", buffer).status(),
+            Status::ResourceExhausted());
+}
+
+TEST_F(KvsSessionCacheTest, LongServerNamesAreHashed) {
+  constexpr std::string_view kLongName1 =
+      "a-very-long-subdomain-name.of-a-long-domain-name.example.com";
+  constexpr std::string_view kLongName2 =
+      "a-very-long-subdomain-name.of-a-long-domain-name.example.org";
+  constexpr std::array<std::byte, 1> kOtherSession = {std::byte{0xFF}};
+  ASSERT_EQ(cache_.Store(kLongName1, kSession), OkStatus());
+  ASSERT_EQ(cache_.Store(kLongName2, kOtherSession), OkStatus());
+
+  // Names that only differ after the truncated part have separate sessions.
+  std::array<std::byte, 16> buffer{};
+  StatusWithSize result = cache_.Load(kLongName1, buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), kSession.size());
+  result = cache_.Load(kLongName2, buffer);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_EQ(result.size(), kOtherSession.size());
+}
+
+TEST_F(KvsSessionCacheTest, CustomPrefix) {
+  KvsSessionCache cache(kvs_, "cloud/");
+  ASSERT_EQ(cache.Store("example.com", kSession), OkStatus());
+  EXPECT_EQ(kvs_.ValueSize("cloud/example.com").status(), OkStatus());
+}
+
+}  // namespace
+}  // namespace pw::tls_client
@@ -0,0 +1,61 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <string_view>
+
+#include "pw_kvs/key_value_store.h"
+#include "pw_string/string.h"
+#include "pw_tls_client/session_cache.h"
+
+namespace pw::tls_client {
+
+// A SessionCache that persists sessions in a key-value store, so that they
+// survive reboots as well as reconnections.
+//
+// Each server's session is stored under |key_prefix| followed by the server
+// name. Server names that don't fit in a KVS key are hashed instead. Hashes
+// of different names may collide, in which case the servers take turns
+// evicting each other's sessions, and connections fall back to full
+// handshakes.
+//
+// Each session is written to flash once per full handshake. Servers that issue
+// a new ticket on every resumption cause a write per connection, so consider
+// the flash's endurance when enabling resumption with such servers.
+class KvsSessionCache final : public SessionCache {
+ public:
+  static constexpr std::string_view kDefaultKeyPrefix = "tls_session/";
+
+  // |key_prefix| must leave room for at least 9 characters of key.
+  explicit KvsSessionCache(kvs::KeyValueStore& kvs,
+                           std::string_view key_prefix = kDefaultKeyPrefix);
+
+ private:
+  // The maximum length of a KVS key.
+  static constexpr size_t kMaxKeyLength = 63;
+
+  using Key = InlineString<kMaxKeyLength>;
+
+  Status DoStore(std::string_view server_name, ConstByteSpan session) override;
+  StatusWithSize DoLoad(std::string_view server_name, ByteSpan dest) override;
+  Status DoErase(std::string_view server_name) override;
+
+  Key MakeKey(std::string_view server_name) const;
+
+  kvs::KeyValueStore& kvs_;
+  const std::string_view key_prefix_;
+};
+
+}  // namespace pw::tls_client
@@ -20,6 +20,7 @@
 #include "pw_assert/check.h"
 #include "pw_stream/stream.h"
 #include "pw_string/util.h"
+#include "pw_tls_client/session_cache.h"
 
 namespace pw::tls_client {
 
@@ -47,13 +48,25 @@ class SessionOptions {
     return *this;
   }
 
+  // Sets a cache of sessions for resuming earlier sessions with the server.
+  // When set, the backend offers the session cached for the server name, if
+  // any, during the handshake, and caches the session after each successful
+  // handshake. The cache must outlive the Session instance to be built.
+  constexpr SessionOptions& set_session_cache(SessionCache& session_cache) {
+    session_cache_ = &session_cache;
+    return *this;
+  }
+
   constexpr pw::stream::ReaderWriter* transport() const { return transport_; }
 
+  constexpr SessionCache* session_cache() const { return session_cache_; }
+
   constexpr std::string_view server_name() const { return server_name_; }
 
  private:
   std::string_view server_name_;
   pw::stream::ReaderWriter* transport_ = nullptr;
+  SessionCache* session_cache_ = nullptr;
 
   // TODO(zyecheng): Expand the list as necessary to cover aspects such as
   // certificate verification/revocation check policies.
@@ -0,0 +1,67 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw::tls_client {
+
+// Stores TLS sessions across connections, so that a later connection to the
+// same server can resume a session with an abbreviated handshake instead of
+// performing a full one. This saves several round trips and the public key
+// operations of the full handshake.
+//
+// Sessions are stored in the backend's serialized form, which includes the
+// session ticket or session ID and the session's master secret. Anyone who can
+// read a stored session can decrypt the traffic of connections that resume it,
+// so implementations should keep sessions in storage that is as protected as
+// the device's other keys.
+//
+// A stored session that the server no longer accepts is harmless: the backend
+// falls back to a full handshake and stores the new session.
+class SessionCache {
+ public:
+  virtual ~SessionCache() = default;
+
+  // Stores |session| for |server_name|, replacing any session stored for it.
+  Status Store(std::string_view server_name, ConstByteSpan session) {
+    return DoStore(server_name, session);
+  }
+
+  // Loads the session stored for |server_name| into |dest|.
+  //
+  // Returns NOT_FOUND if no session is stored for |server_name|, or
+  // RESOURCE_EXHAUSTED if |dest| is too small for the session.
+  StatusWithSize Load(std::string_view server_name, ByteSpan dest) {
+    return DoLoad(server_name, dest);
+  }
+
+  // Erases the session stored for |server_name|, if any. Returns NOT_FOUND if
+  // no session is stored.
+  Status Erase(std::string_view server_name) { return DoErase(server_name); }
+
+ private:
+  virtual Status DoStore(std::string_view server_name,
+                         ConstByteSpan session) = 0;
+  virtual StatusWithSize DoLoad(std::string_view server_name,
+                                ByteSpan dest) = 0;
+  virtual Status DoErase(std::string_view server_name) = 0;
+};
+
+}  // namespace pw::tls_client
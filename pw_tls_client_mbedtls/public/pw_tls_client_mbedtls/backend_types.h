@@ -36,6 +36,13 @@ class SessionImplementation {
   void SetTlsStatus(TLSStatus status) { tls_status_ = status; }
   TLSStatus GetTlsStatus() { return tls_status_; }
 
+  // Offers the session cached for the server, if any, for resumption in the
+  // next handshake. Cached sessions that can't be loaded are erased.
+  void RestoreSession();
+
+  // Caches the session negotiated by the last successful handshake.
+  Status SaveSession();
+
   // The method is for test only. When given a non-Ok status, it will override
   // the status returned by entropy source pw::tls_client::GetRandomBytes();
   static void SetEntropySourceStatus(Status status);
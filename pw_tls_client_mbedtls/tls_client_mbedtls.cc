@@ -12,6 +12,9 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
+
+#include "mbedtls/platform_util.h"
 #include "pw_assert/check.h"
 #include "pw_log/log.h"
 #include "pw_tls_client/entropy.h"
@@ -20,6 +23,13 @@
 
 namespace pw::tls_client {
 namespace backend {
+namespace {
+
+// The largest serialized session that is cached. Sessions with tickets are
+// usually a few hundred bytes.
+constexpr size_t kMaxSerializedSessionSize = 1024;
+
+}  // namespace
 
 int SessionImplementation::MbedTlsWrite(void* ctx,
                                         const uint8_t* buf,
@@ -162,9 +172,64 @@ Status SessionImplementation::Setup() {
     return Status::Internal();
   }
 
+  RestoreSession();
   return OkStatus();
 }
 
+void SessionImplementation::RestoreSession() {
+  SessionCache* cache = session_options_.session_cache();
+  if (cache == nullptr) {
+    return;
+  }
+
+  std::array<unsigned char, kMaxSerializedSessionSize> buffer;
+  const StatusWithSize loaded = cache->Load(session_options_.server_name(),
+                                            as_writable_bytes(span(buffer)));
+  if (!loaded.ok()) {
+    return;
+  }
+
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  if (mbedtls_ssl_session_load(&session, buffer.data(), loaded.size()) == 0 &&
+      mbedtls_ssl_set_session(&ssl_ctx_, &session) == 0) {
+    PW_LOG_DEBUG("Offering a cached session for resumption");
+  } else {
+    // The session is corrupt, or was saved by an incompatible version or
+    // configuration of MbedTLS.
+    PW_LOG_DEBUG("Failed to load the cached session");
+    cache->Erase(session_options_.server_name()).IgnoreError();
+  }
+  mbedtls_ssl_session_free(&session);
+  mbedtls_platform_zeroize(buffer.data(), buffer.size());
+}
+
+Status SessionImplementation::SaveSession() {
+  SessionCache* cache = session_options_.session_cache();
+  if (cache == nullptr) {
+    return OkStatus();
+  }
+
+  std::array<unsigned char, kMaxSerializedSessionSize> buffer;
+  size_t size = 0;
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  int ret = mbedtls_ssl_get_session(&ssl_ctx_, &session);
+  if (ret == 0) {
+    ret = mbedtls_ssl_session_save(
+        &session, buffer.data(), buffer.size(), &size);
+  }
+  mbedtls_ssl_session_free(&session);
+
+  Status status = Status::Internal();
+  if (ret == 0) {
+    status = cache->Store(session_options_.server_name(),
+                          as_bytes(span(buffer.data(), size)));
+  }
+  mbedtls_platform_zeroize(buffer.data(), buffer.size());
+  return status;
+}
+
 }  // namespace backend
 
 Session::Session(const SessionOptions& options) : session_impl_(options) {}
@@ -197,7 +262,8 @@ Result<Session*> Session::Create(const SessionOptions& options) {
 }
 
 Status Session::Open() {
-  // TODO: b/235289501 - To implement
+  // TODO: b/235289501 - To implement. Call session_impl_.SaveSession() once
+  // the handshake succeeds, so the next connection can resume the session.
   return Status::Unimplemented();
 }
 
@@ -12,6 +12,9 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <algorithm>
+#include <string_view>
+
 #include "pw_stream/null_stream.h"
 #include "pw_tls_client/session.h"
 #include "pw_unit_test/framework.h"
@@ -31,6 +34,48 @@ TEST(TLSClientMbedTLS, CreateFailOnMissingTransport) {
   ASSERT_NE(res.status(), OkStatus());
 }
 
+// A session cache holding a single session, which records erasures.
+class TestSessionCache : public SessionCache {
+ public:
+  explicit TestSessionCache(ConstByteSpan session) : session_(session) {}
+
+  bool erased() const { return erased_; }
+
+ private:
+  Status DoStore(std::string_view, ConstByteSpan) override {
+    return OkStatus();
+  }
+
+  StatusWithSize DoLoad(std::string_view, ByteSpan dest) override {
+    if (erased_) {
+      return StatusWithSize::NotFound();
+    }
+    std::copy(session_.begin(), session_.end(), dest.begin());
+    return StatusWithSize(session_.size());
+  }
+
+  Status DoErase(std::string_view) override {
+    erased_ = true;
+    return OkStatus();
+  }
+
+  ConstByteSpan session_;
+  bool erased_ = false;
+};
+
+TEST(TLSClientMbedTLS, CreateErasesInvalidCachedSession) {
+  constexpr std::byte kInvalidSession[] = {std::byte{0xde}, std::byte{0xad}};
+  TestSessionCache cache(kInvalidSession);
+  auto options = SessionOptions()
+                     .set_server_name("example.com")
+                     .set_transport(stream::NullStream::Instance())
+                     .set_session_cache(cache);
+  auto res = Session::Create(options);
+  ASSERT_EQ(res.status(), OkStatus());
+  EXPECT_TRUE(cache.erased());
+  delete res.value();
+}
+
 TEST(TLSClientMbedTLS, EntropySourceFail) {
   backend::SessionImplementation::SetEntropySourceStatus(Status::Internal());
   auto options = SessionOptions().set_transport(stream::NullStream::Instance());
@@ -0,0 +1,91 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tokenizer/batch_detokenize.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace pw::tokenizer {
+
+BatchDetokenizer::BatchDetokenizer(const Detokenizer& detokenizer,
+                                   unsigned threads)
+    : detokenizer_(detokenizer),
+      threads_(threads != 0u
+                   ? threads
+                   : std::max(1u, std::thread::hardware_concurrency())) {}
+
+template <typename Function>
+void BatchDetokenizer::ForEach(size_t count, const Function& detokenize) const {
+  // Threads claim blocks of messages until none are left, which balances the
+  // work when some messages take longer than others.
+  std::atomic<size_t> next_block = 0;
+
+  auto work = [&]() {
+    Detokenizer::EntryCache cache;
+    while (true) {
+      const size_t start = kMessagesPerBlock * next_block.fetch_add(1);
+      if (start >= count) {
+        return;
+      }
+      const size_t end = std::min(count, start + kMessagesPerBlock);
+      for (size_t i = start; i < end; ++i) {
+        detokenize(i, &cache);
+      }
+    }
+  };
+
+  const size_t blocks = (count + kMessagesPerBlock - 1) / kMessagesPerBlock;
+  const size_t thread_count = std::min<size_t>(threads_, blocks);
+
+  // The calling thread does its share of the work too.
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < thread_count; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+std::vector<DetokenizedString> BatchDetokenizer::Detokenize(
+    span<const span<const std::byte>> messages) const {
+  std::vector<DetokenizedString> results(messages.size());
+  ForEach(messages.size(), [&](size_t i, Detokenizer::EntryCache* cache) {
+    results[i] = detokenizer_.DetokenizeImpl(messages[i], cache);
+  });
+  return results;
+}
+
+std::vector<DetokenizedString> BatchDetokenizer::DetokenizeBase64Messages(
+    span<const std::string_view> messages) const {
+  std::vector<DetokenizedString> results(messages.size());
+  ForEach(messages.size(), [&](size_t i, Detokenizer::EntryCache* cache) {
+    results[i] = detokenizer_.DetokenizeBase64MessageImpl(messages[i], cache);
+  });
+  return results;
+}
+
+std::vector<std::string> BatchDetokenizer::DetokenizeText(
+    span<const std::string_view> texts, unsigned max_passes) const {
+  std::vector<std::string> results(texts.size());
+  ForEach(texts.size(), [&](size_t i, Detokenizer::EntryCache* cache) {
+    results[i] = detokenizer_.DetokenizeTextImpl(texts[i], max_passes, cache);
+  });
+  return results;
+}
+
+}  // namespace pw::tokenizer
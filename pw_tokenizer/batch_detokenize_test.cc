@@ -0,0 +1,143 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_tokenizer/batch_detokenize.h"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::tokenizer {
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+// Database with the following entries:
+// {
+//   0x00000001: "One",
+//   0x00000005: "TWO",
+//   0x000000ff: "Number %d",
+//   0xDDEEEEFF: "FOUR",
+//   0xEEEEEEEE: "$AQAAAA==",  # Nested Base64 token for "One"
+// }
+constexpr char kTestDatabase[] =
+    "TOKENS\0\0"
+    "\x05\x00\x00\x00"  // Number of tokens in this database.
+    "\0\0\0\0"
+    "\x01\x00\x00\x00----"
+    "\x05\x00\x00\x00----"
+    "\xFF\x00\x00\x00----"
+    "\xFF\xEE\xEE\xDD----"
+    "\xEE\xEE\xEE\xEE----"
+    "One\0"
+    "TWO\0"
+    "Number %d\0"
+    "FOUR\0"
+    "$AQAAAA==";
+
+constexpr TokenDatabase kDatabase = TokenDatabase::Create<kTestDatabase>();
+
+constexpr std::string_view kMessages[] = {
+    "\x01\x00\x00\x00"sv,
+    "\xFF\x00\x00\x00\x54"sv,
+    "\x05\x00\x00\x00"sv,
+    "\x99\x99\x99\x99"sv,
+    "\xFF\xEE\xEE\xDD"sv,
+};
+
+constexpr std::string_view kExpected[] = {
+    "One", "Number 42", "TWO", "", "FOUR"};
+
+// Tests run with both a hash table and a sorted database Detokenizer.
+class BatchDetokenize : public ::testing::Test {
+ protected:
+  BatchDetokenize()
+      : detokenizers_{Detokenizer(kDatabase),
+                      Detokenizer::FromSortedDatabase(kDatabase)} {}
+
+  std::array<Detokenizer, 2> detokenizers_;
+};
+
+TEST_F(BatchDetokenize, ResultsInInputOrder) {
+  std::vector<span<const std::byte>> messages;
+  std::vector<std::string_view> expected;
+  for (size_t i = 0; i < 1000; ++i) {
+    const std::string_view message = kMessages[i % std::size(kMessages)];
+    messages.push_back(as_bytes(span(message)));
+    expected.push_back(kExpected[i % std::size(kExpected)]);
+  }
+
+  for (const Detokenizer& detok : detokenizers_) {
+    BatchDetokenizer batch(detok, 4);
+    std::vector<DetokenizedString> results = batch.Detokenize(messages);
+
+    ASSERT_EQ(results.size(), expected.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+      EXPECT_EQ(results[i].BestString(), expected[i]);
+    }
+  }
+}
+
+TEST_F(BatchDetokenize, Base64Messages) {
+  constexpr std::string_view kBase64[] = {
+      "$AQAAAA==", "$BQAAAA==", "$/wAAAFQ="};
+
+  for (const Detokenizer& detok : detokenizers_) {
+    BatchDetokenizer batch(detok, 2);
+    std::vector<DetokenizedString> results =
+        batch.DetokenizeBase64Messages(kBase64);
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].BestString(), "One");
+    EXPECT_EQ(results[1].BestString(), "TWO");
+    EXPECT_EQ(results[2].BestString(), "Number 42");
+  }
+}
+
+TEST_F(BatchDetokenize, Text) {
+  std::vector<std::string_view> texts;
+  for (size_t i = 0; i < 300; ++i) {
+    texts.push_back(i % 2 == 0 ? "Nested: $7u7u7g==!"sv
+                               : "$BQAAAA== $AQAAAA=="sv);
+  }
+
+  for (const Detokenizer& detok : detokenizers_) {
+    BatchDetokenizer batch(detok, 3);
+    std::vector<std::string> results = batch.DetokenizeText(texts);
+
+    ASSERT_EQ(results.size(), texts.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+      EXPECT_EQ(results[i], i % 2 == 0 ? "Nested: One!" : "TWO One");
+    }
+
+    // A single pass leaves the nested message.
+    EXPECT_EQ(batch.DetokenizeText(span(texts).first(1), 1)[0],
+              "Nested: $AQAAAA==!");
+  }
+}
+
+TEST_F(BatchDetokenize, EmptyBatch) {
+  for (const Detokenizer& detok : detokenizers_) {
+    BatchDetokenizer batch(detok);
+    EXPECT_GE(batch.threads(), 1u);
+    EXPECT_TRUE(batch.Detokenize({}).empty());
+    EXPECT_TRUE(batch.DetokenizeText({}).empty());
+  }
+}
+
+}  // namespace
+}  // namespace pw::tokenizer
@@ -15,6 +15,7 @@
 #include "pw_tokenizer/detokenize.h"
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <cstring>
 #include <string_view>
@@ -23,6 +24,7 @@
 #include "pw_bytes/bit.h"
 #include "pw_bytes/endian.h"
 #include "pw_result/result.h"
+#include "pw_status/try.h"
 #include "pw_tokenizer/base64.h"
 #include "pw_tokenizer/internal/decode.h"
 #include "pw_tokenizer/nested_tokenization.h"
@@ -30,10 +32,13 @@
 namespace pw::tokenizer {
 namespace {
 
+// Detokenizes the nested messages in text. DetokenizeBase64Message is called
+// with each Base64 message and returns its DetokenizedString.
+template <typename DetokenizeBase64Message>
 class NestedMessageDetokenizer {
  public:
-  NestedMessageDetokenizer(const Detokenizer& detokenizer)
-      : detokenizer_(detokenizer) {}
+  NestedMessageDetokenizer(DetokenizeBase64Message detokenize_base64_message)
+      : detokenize_base64_message_(detokenize_base64_message) {}
 
   void Detokenize(std::string_view chunk) {
     for (char next_char : chunk) {
@@ -85,7 +90,7 @@ class NestedMessageDetokenizer {
 
  private:
   void HandleEndOfMessage() {
-    if (auto result = detokenizer_.DetokenizeBase64Message(message_buffer_);
+    if (auto result = detokenize_base64_message_(message_buffer_);
         result.ok()) {
       output_ += result.BestString();
       output_changed_ = true;
@@ -95,7 +100,7 @@ class NestedMessageDetokenizer {
     message_buffer_.clear();
   }
 
-  const Detokenizer& detokenizer_;
+  DetokenizeBase64Message detokenize_base64_message_;
   std::string output_;
   std::string message_buffer_;
 
@@ -115,6 +120,19 @@ std::string UnknownTokenMessage(uint32_t value) {
   return output;
 }
 
+// Size of an entry in a binary token database: a token and a removal date.
+constexpr size_t kEntrySizeBytes = 2 * sizeof(uint32_t);
+
+// Layout of a binary token database's optional token index. The reserved word
+// in the database header holds the index's offset, or 0 if there is none.
+constexpr size_t kDatabaseHeaderSizeBytes = 16;
+constexpr size_t kDatabaseIndexOffsetField = 12;
+constexpr std::array<char, 8> kIndexMagicAndVersion = {
+    'T', 'O', 'K', 'I', 'D', 'X', '\0', '\0'};
+constexpr size_t kIndexBucketBitsField = 8;
+constexpr size_t kIndexHeaderSizeBytes = 16;
+constexpr uint32_t kMaxIndexBucketBits = 24;
+
 // Decoding result with the date removed, for sorting.
 using DecodingResult = std::pair<DecodedFormatString, uint32_t>;
 
@@ -234,8 +252,226 @@ Result<Detokenizer> Detokenizer::FromElfSection(
   return Detokenizer(std::move(database));
 }
 
-DetokenizedString Detokenizer::Detokenize(
-    const span<const std::byte>& encoded) const {
+Detokenizer Detokenizer::FromSortedDatabase(const TokenDatabase& database) {
+  SortedDatabase sorted_database(database);
+  if (!sorted_database.ok()) {
+    return Detokenizer(database);  // Binary search requires sorted entries.
+  }
+  return Detokenizer(std::move(sorted_database));
+}
+
+Detokenizer Detokenizer::FromSortedDatabase(span<const std::byte> database) {
+  const TokenDatabase token_database = TokenDatabase::Create(span<const char>(
+      reinterpret_cast<const char*>(database.data()), database.size()));
+  SortedDatabase indexed_database;
+  if (indexed_database.LoadIndex(token_database, database)) {
+    return Detokenizer(std::move(indexed_database));
+  }
+  return FromSortedDatabase(token_database);
+}
+
+bool Detokenizer::SortedDatabase::LoadIndex(const TokenDatabase& database,
+                                            span<const std::byte> bytes) {
+  if (!database.ok()) {
+    return false;
+  }
+
+  const uint64_t index_offset = bytes::ReadInOrder<uint32_t>(
+      endian::little, bytes.data() + kDatabaseIndexOffsetField);
+  const size_t size = database.size();
+  const uint64_t strings_offset =
+      kDatabaseHeaderSizeBytes + uint64_t{size} * kEntrySizeBytes;
+  if (index_offset == 0u || index_offset < strings_offset ||
+      index_offset % sizeof(uint32_t) != 0u ||
+      index_offset + kIndexHeaderSizeBytes > bytes.size()) {
+    return false;
+  }
+
+  // The string table must end with a null terminator, so that every string
+  // offset in the index refers to a terminated string.
+  if (index_offset > strings_offset &&
+      bytes[index_offset - 1] != std::byte{0}) {
+    return false;
+  }
+
+  const std::byte* index = bytes.data() + index_offset;
+  if (std::memcmp(index,
+                  kIndexMagicAndVersion.data(),
+                  kIndexMagicAndVersion.size()) != 0) {
+    return false;
+  }
+
+  const uint32_t bucket_bits = bytes::ReadInOrder<uint32_t>(
+      endian::little, index + kIndexBucketBitsField);
+  if (bucket_bits > kMaxIndexBucketBits) {
+    return false;
+  }
+
+  // The bucket table has one more element than there are buckets, so that
+  // each bucket ends where the next one starts.
+  const uint64_t tables_size =
+      ((uint64_t{1} << bucket_bits) + 1 + size) * sizeof(uint32_t);
+  if (index_offset + kIndexHeaderSizeBytes + tables_size > bytes.size()) {
+    return false;
+  }
+
+  entries_ = bytes.data() + kDatabaseHeaderSizeBytes;
+  size_ = size;
+  bucket_bits_ = bucket_bits;
+  buckets_ = index + kIndexHeaderSizeBytes;
+  string_offsets_ =
+      buckets_ + ((size_t{1} << bucket_bits) + 1) * sizeof(uint32_t);
+  strings_ = reinterpret_cast<const char*>(bytes.data()) + strings_offset;
+  strings_size_ = static_cast<size_t>(index_offset - strings_offset);
+  return true;
+}
+
+Detokenizer::SortedDatabase::SortedDatabase(const TokenDatabase& database) {
+  if (!database.ok()) {
+    return;
+  }
+
+  // The entries immediately precede the string table, which starts with the
+  // first entry's string.
+  const char* string = database.begin()->string;
+  const size_t size = database.size();
+  const std::byte* entries =
+      reinterpret_cast<const std::byte*>(string) - size * kEntrySizeBytes;
+
+  string_index_.reserve((size + kStringIndexInterval - 1) /
+                        kStringIndexInterval);
+  uint32_t previous_token = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const uint32_t token = bytes::ReadInOrder<uint32_t>(
+        endian::little, entries + i * kEntrySizeBytes);
+    if (token < previous_token) {
+      string_index_.clear();
+      return;
+    }
+    previous_token = token;
+
+    if (i % kStringIndexInterval == 0u) {
+      string_index_.push_back(string);
+    }
+    string += std::strlen(string) + 1;
+  }
+
+  entries_ = entries;
+  size_ = size;
+}
+
+uint32_t Detokenizer::SortedDatabase::ReadEntryField(size_t index,
+                                                     size_t offset) const {
+  return bytes::ReadInOrder<uint32_t>(
+      endian::little, entries_ + index * kEntrySizeBytes + offset);
+}
+
+uint32_t Detokenizer::SortedDatabase::ReadIndexWord(const std::byte* table,
+                                                    size_t index) const {
+  return bytes::ReadInOrder<uint32_t>(endian::little,
+                                      table + index * sizeof(uint32_t));
+}
+
+void Detokenizer::SortedDatabase::FindInIndex(
+    uint32_t token, std::vector<TokenizedStringEntry>& entries) const {
+  const size_t bucket =
+      bucket_bits_ == 0u ? 0u : token >> (32u - bucket_bits_);
+  const size_t end = std::min<size_t>(ReadIndexWord(buckets_, bucket + 1),
+                                      size_);
+
+  // The index is validated as it is used, so a corrupt index cannot cause an
+  // out-of-bounds read.
+  for (size_t i = ReadIndexWord(buckets_, bucket); i < end; ++i) {
+    if (ReadEntryField(i, 0) != token) {
+      continue;
+    }
+    const uint32_t string_offset = ReadIndexWord(string_offsets_, i);
+    if (string_offset < strings_size_) {
+      entries.emplace_back(strings_ + string_offset,
+                           ReadEntryField(i, sizeof(uint32_t)));
+    }
+  }
+}
+
+void Detokenizer::SortedDatabase::Find(
+    uint32_t token, std::vector<TokenizedStringEntry>& entries) const {
+  if (buckets_ != nullptr) {
+    FindInIndex(token, entries);
+    return;
+  }
+
+  // Binary search for the first entry with this token.
+  size_t first = 0;
+  size_t count = size_;
+  while (count > 0u) {
+    const size_t step = count / 2;
+    if (ReadEntryField(first + step, 0) < token) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+
+  if (first == size_ || ReadEntryField(first, 0) != token) {
+    return;
+  }
+
+  // Find the entry's string from the nearest indexed string.
+  const char* string = string_index_[first / kStringIndexInterval];
+  for (size_t i = 0; i < first % kStringIndexInterval; ++i) {
+    string += std::strlen(string) + 1;
+  }
+
+  for (size_t i = first; i < size_ && ReadEntryField(i, 0) == token; ++i) {
+    entries.emplace_back(string, ReadEntryField(i, sizeof(uint32_t)));
+    string += std::strlen(string) + 1;
+  }
+}
+
+span<const TokenizedStringEntry> Detokenizer::EntryCache::Find(
+    const SortedDatabase& database, uint32_t token) {
+  // Tokens are hashes, so their low bits are well distributed.
+  Slot& slot = slots_[token % slots_.size()];
+  if (!slot.valid || slot.token != token) {
+    slot.entries.clear();
+    database.Find(token, slot.entries);
+    slot.token = token;
+    slot.valid = true;
+  }
+  return slot.entries;
+}
+
+Detokenizer::FormatStringCache::~FormatStringCache() {
+  for (size_t i = 0; i < kSlots; ++i) {
+    delete slots_[i].load(std::memory_order_relaxed);
+  }
+}
+
+const std::vector<TokenizedStringEntry>* Detokenizer::FormatStringCache::Find(
+    const SortedDatabase& database, uint32_t token) {
+  std::atomic<const Slot*>& slot = slots_[token % kSlots];
+
+  const Slot* cached = slot.load(std::memory_order_acquire);
+  if (cached == nullptr) {
+    auto parsed = std::make_unique<Slot>();
+    parsed->token = token;
+    database.Find(token, parsed->entries);
+
+    // If another thread claimed the slot first, use its entry instead.
+    if (slot.compare_exchange_strong(cached,
+                                     parsed.get(),
+                                     std::memory_order_acq_rel,
+                                     std::memory_order_acquire)) {
+      cached = parsed.release();
+    }
+  }
+
+  return cached->token == token ? &cached->entries : nullptr;
+}
+
+DetokenizedString Detokenizer::DetokenizeImpl(
+    const span<const std::byte>& encoded, EntryCache* cache) const {
   // The token is missing from the encoded data; there is nothing to do.
   if (encoded.empty()) {
     return DetokenizedString();
@@ -244,26 +480,48 @@ DetokenizedString Detokenizer::Detokenize(
   uint32_t token = bytes::ReadInOrder<uint32_t>(
       endian::little, encoded.data(), encoded.size());
 
+  const span<const std::byte> arguments =
+      encoded.size() < sizeof(token) ? span<const std::byte>()
+                                     : encoded.subspan(sizeof(token));
+
+  if (sorted_database_.ok()) {
+    if (const std::vector<TokenizedStringEntry>* entries =
+            format_strings_->Find(sorted_database_, token);
+        entries != nullptr) {
+      return DetokenizedString(token, *entries, arguments);
+    }
+    if (cache != nullptr) {
+      return DetokenizedString(
+          token, cache->Find(sorted_database_, token), arguments);
+    }
+    std::vector<TokenizedStringEntry> entries;
+    sorted_database_.Find(token, entries);
+    return DetokenizedString(token, entries, arguments);
+  }
+
   const auto result = database_.find(token);
 
-  return DetokenizedString(
-      token,
-      result == database_.end() ? span<TokenizedStringEntry>()
-                                : span(result->second),
-      encoded.size() < sizeof(token) ? span<const std::byte>()
-                                     : encoded.subspan(sizeof(token)));
+  return DetokenizedString(token,
+                           result == database_.end()
+                               ? span<TokenizedStringEntry>()
+                               : span(result->second),
+                           arguments);
 }
 
-DetokenizedString Detokenizer::DetokenizeBase64Message(
-    std::string_view text) const {
+DetokenizedString Detokenizer::DetokenizeBase64MessageImpl(
+    std::string_view text, EntryCache* cache) const {
   std::string buffer(text);
   buffer.resize(PrefixedBase64DecodeInPlace(buffer));
-  return Detokenize(buffer);
+  return DetokenizeImpl(as_bytes(span(buffer)), cache);
 }
 
-std::string Detokenizer::DetokenizeText(std::string_view text,
-                                        const unsigned max_passes) const {
-  NestedMessageDetokenizer detokenizer(*this);
+std::string Detokenizer::DetokenizeTextImpl(std::string_view text,
+                                            const unsigned max_passes,
+                                            EntryCache* cache) const {
+  NestedMessageDetokenizer detokenizer(
+      [this, cache](std::string_view message) {
+        return DetokenizeBase64MessageImpl(message, cache);
+      });
   detokenizer.Detokenize(text);
 
   std::string result;
@@ -280,6 +538,73 @@ std::string Detokenizer::DetokenizeText(std::string_view text,
   return result;
 }
 
+std::string StreamingDetokenizer::Detokenize(std::string_view chunk) {
+  std::string output;
+  for (char next_char : chunk) {
+    if (message_.empty()) {
+      if (next_char == PW_TOKENIZER_NESTED_PREFIX) {
+        message_.push_back(next_char);
+      } else {
+        output.push_back(next_char);
+      }
+    } else if (base64::IsValidChar(next_char)) {
+      message_.push_back(next_char);
+    } else {
+      HandleEndOfMessage(output);
+      if (next_char == PW_TOKENIZER_NESTED_PREFIX) {
+        message_.push_back(next_char);
+      } else {
+        output.push_back(next_char);
+      }
+    }
+  }
+  return output;
+}
+
+std::string StreamingDetokenizer::Flush() {
+  std::string output;
+  if (!message_.empty()) {
+    HandleEndOfMessage(output);
+  }
+  return output;
+}
+
+Status StreamingDetokenizer::Detokenize(stream::Reader& reader,
+                                        stream::Writer& writer) {
+  std::array<std::byte, 256> buffer;
+
+  while (true) {
+    const Result<ByteSpan> read = reader.Read(buffer);
+    const std::string output =
+        read.ok() ? Detokenize(std::string_view(
+                        reinterpret_cast<const char*>(read->data()),
+                        read->size()))
+                  : Flush();
+
+    if (!output.empty()) {
+      PW_TRY(writer.Write(as_bytes(span(output))));
+    }
+
+    if (!read.ok()) {
+      return read.status().IsOutOfRange() ? OkStatus() : read.status();
+    }
+  }
+}
+
+void StreamingDetokenizer::HandleEndOfMessage(std::string& output) {
+  const DetokenizedString result =
+      detokenizer_.DetokenizeBase64Message(message_);
+  if (!result.ok()) {
+    output += message_;  // Keep the original if it doesn't decode.
+  } else if (max_depth_ > 1u) {
+    // Only the decoded message is scanned again for nested messages.
+    output += detokenizer_.DetokenizeText(result.BestString(), max_depth_ - 1);
+  } else {
+    output += result.BestString();
+  }
+  message_.clear();
+}
+
 std::string Detokenizer::DecodeOptionallyTokenizedData(
     const ConstByteSpan& optionally_tokenized_data) {
   // Try detokenizing as binary using the best result if available, else use
@@ -0,0 +1,36 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+#include "pw_assert/assert.h"
+#include "pw_fuzzer/corpus_benchmark.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_tokenizer/detokenize.h"
+#include "pw_tokenizer_private/detokenize_corpus.h"
+
+namespace pw::tokenizer {
+namespace {
+
+void DetokenizeCorpus(perf_test::State& state) {
+  Detokenizer detok(TokenDatabase::Create<test::kCorpusDatabase>());
+  fuzzer::MeasureCorpus(
+      state, test::kDetokenizeCorpus, [&detok](std::string_view input) {
+        PW_ASSERT(detok.Detokenize(input).ok());
+      });
+}
+
+PW_PERF_TEST(DetokenizeCorpus, DetokenizeCorpus);
+
+}  // namespace
+}  // namespace pw::tokenizer
@@ -14,10 +14,14 @@
 
 #include "pw_tokenizer/detokenize.h"
 
+#include <cstdint>
 #include <string>
 #include <string_view>
+#include <vector>
 
+#include "pw_stream/memory_stream.h"
 #include "pw_tokenizer/example_binary_with_tokenized_strings.h"
+#include "pw_tokenizer_private/detokenize_corpus.h"
 #include "pw_unit_test/framework.h"
 
 namespace pw::tokenizer {
@@ -91,6 +95,196 @@ TEST_F(Detokenize, FromElfSection) {
             "Jello, world!");
 }
 
+TEST(DetokenizeFromSortedDatabase, NoFormatting) {
+  const Detokenizer detok =
+      Detokenizer::FromSortedDatabase(TokenDatabase::Create<kTestDatabase>());
+  EXPECT_EQ(detok.Detokenize("\1\0\0\0"sv).BestString(), "One");
+  EXPECT_EQ(detok.Detokenize("\5\0\0\0"sv).BestString(), "TWO");
+  EXPECT_EQ(detok.Detokenize("\xff\x00\x00\x00"sv).BestString(), "333");
+  EXPECT_EQ(detok.Detokenize("\xff\xee\xee\xdd"sv).BestString(), "FOUR");
+  EXPECT_EQ(detok.DetokenizeText("$7u7u7g=="), "One");
+}
+
+TEST(DetokenizeFromSortedDatabase, UnknownToken) {
+  const Detokenizer detok =
+      Detokenizer::FromSortedDatabase(TokenDatabase::Create<kTestDatabase>());
+  EXPECT_TRUE(detok.Detokenize("\0\0\0\0"sv).matches().empty());
+  EXPECT_TRUE(detok.Detokenize("\2\0\0\0"sv).matches().empty());
+  EXPECT_TRUE(detok.Detokenize("\xff\xff\xff\xff"sv).matches().empty());
+}
+
+// Tokens that map to the same slot in the Detokenizer's format string cache.
+constexpr char kCollidingTokensDatabase[] =
+    "TOKENS\0\0"
+    "\x03\x00\x00\x00"
+    "\0\0\0\0"
+    "\x01\x00\x00\x00----"
+    "\x01\x10\x00\x00----"
+    "\x01\x20\x00\x00----"
+    "First %d\0"
+    "Second %d\0"
+    "Third %d";
+
+TEST(DetokenizeFromSortedDatabase, FormatStringCacheCollisions) {
+  const Detokenizer detok = Detokenizer::FromSortedDatabase(
+      TokenDatabase::Create<kCollidingTokensDatabase>());
+
+  // Decode each message twice, so both the cached and uncached entries are
+  // used again.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ(detok.Detokenize("\x01\x10\x00\x00\x02"sv).BestString(),
+              "Second 1");
+    EXPECT_EQ(detok.Detokenize("\x01\x00\x00\x00\x04"sv).BestString(),
+              "First 2");
+    EXPECT_EQ(detok.Detokenize("\x01\x20\x00\x00\x06"sv).BestString(),
+              "Third 3");
+  }
+}
+
+TEST(DetokenizeFromSortedDatabase, InvalidDatabase) {
+  const Detokenizer detok = Detokenizer::FromSortedDatabase(TokenDatabase());
+  EXPECT_TRUE(detok.Detokenize("\1\0\0\0"sv).matches().empty());
+}
+
+TEST(DetokenizeFromSortedDatabase, LargeDatabase) {
+  // Build a database with enough entries to use several indexed strings.
+  constexpr uint32_t kEntries = 300;
+  std::vector<char> database = {'T', 'O', 'K', 'E', 'N', 'S', '\0', '\0'};
+  for (int shift = 0; shift < 32; shift += 8) {
+    database.push_back(static_cast<char>((kEntries >> shift) & 0xff));
+  }
+  database.resize(database.size() + 4);  // Reserved
+  for (uint32_t i = 0; i < kEntries; ++i) {
+    const uint32_t token = 3 * i;
+    for (int shift = 0; shift < 32; shift += 8) {
+      database.push_back(static_cast<char>((token >> shift) & 0xff));
+    }
+    database.insert(database.end(), 4, '\xff');  // Never removed
+  }
+  for (uint32_t i = 0; i < kEntries; ++i) {
+    const std::string string = "String " + std::to_string(i);
+    database.insert(database.end(), string.begin(), string.end() + 1);
+  }
+
+  const Detokenizer detok =
+      Detokenizer::FromSortedDatabase(TokenDatabase::Create(database));
+  for (uint32_t i = 0; i < kEntries; ++i) {
+    const uint32_t token = 3 * i;
+    EXPECT_EQ(detok.Detokenize(&token, sizeof(token)).BestString(),
+              "String " + std::to_string(i));
+    const uint32_t unknown = token + 1;
+    EXPECT_TRUE(detok.Detokenize(&unknown, sizeof(unknown)).matches().empty());
+  }
+}
+
+void AppendUint32(std::vector<std::byte>& data, uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    data.push_back(static_cast<std::byte>((value >> shift) & 0xff));
+  }
+}
+
+// Builds a binary token database with a token index. Entries must be sorted.
+std::vector<std::byte> IndexedDatabase(
+    const std::vector<std::pair<uint32_t, std::string>>& entries,
+    uint32_t bucket_bits) {
+  std::vector<std::byte> strings;
+  std::vector<uint32_t> string_offsets;
+  for (const auto& [token, string] : entries) {
+    string_offsets.push_back(static_cast<uint32_t>(strings.size()));
+    for (char c : string) {
+      strings.push_back(static_cast<std::byte>(c));
+    }
+    strings.push_back(std::byte{0});
+  }
+  strings.resize((strings.size() + 3) / 4 * 4);  // Align the index.
+
+  std::vector<std::byte> database;
+  for (char c : "TOKENS\0") {  // Magic and version, with the implicit \0.
+    database.push_back(static_cast<std::byte>(c));
+  }
+  AppendUint32(database, static_cast<uint32_t>(entries.size()));
+  AppendUint32(database,
+               static_cast<uint32_t>(16 + 8 * entries.size() + strings.size()));
+  for (const auto& entry : entries) {
+    AppendUint32(database, entry.first);
+    AppendUint32(database, TokenDatabase::kDateRemovedNever);
+  }
+  database.insert(database.end(), strings.begin(), strings.end());
+
+  for (char c : "TOKIDX\0") {
+    database.push_back(static_cast<std::byte>(c));
+  }
+  AppendUint32(database, bucket_bits);
+  AppendUint32(database, 0);  // Reserved
+  size_t entry = 0;
+  for (uint32_t bucket = 0; bucket <= (1u << bucket_bits); ++bucket) {
+    while (entry < entries.size() && bucket_bits != 0u &&
+           (entries[entry].first >> (32 - bucket_bits)) < bucket) {
+      ++entry;
+    }
+    AppendUint32(database,
+                 bucket == (1u << bucket_bits) ? entries.size() : entry);
+  }
+  for (uint32_t offset : string_offsets) {
+    AppendUint32(database, offset);
+  }
+  return database;
+}
+
+const std::vector<std::pair<uint32_t, std::string>> kIndexedEntries = {
+    {0x00000001, "One"},
+    {0x40000005, "Five"},
+    {0x40000005, "Also five"},
+    {0x40000007, "Seven"},
+    {0xC0000000, "Big"},
+    {0xFFFFFFFF, "Biggest"},
+};
+
+TEST(DetokenizeFromSortedDatabase, IndexedDatabase) {
+  for (uint32_t bucket_bits : {0u, 2u, 8u}) {
+    const std::vector<std::byte> database =
+        IndexedDatabase(kIndexedEntries, bucket_bits);
+    const Detokenizer detok = Detokenizer::FromSortedDatabase(database);
+
+    EXPECT_EQ(detok.Detokenize("\x01\0\0\0"sv).BestString(), "One");
+    EXPECT_EQ(detok.Detokenize("\x07\0\0\x40"sv).BestString(), "Seven");
+    EXPECT_EQ(detok.Detokenize("\0\0\0\xc0"sv).BestString(), "Big");
+    EXPECT_EQ(detok.Detokenize("\xff\xff\xff\xff"sv).BestString(),
+              "Biggest");
+    EXPECT_EQ(detok.Detokenize("\x05\0\0\x40"sv).matches().size(), 2u);
+
+    EXPECT_TRUE(detok.Detokenize("\0\0\0\0"sv).matches().empty());
+    EXPECT_TRUE(detok.Detokenize("\x06\0\0\x40"sv).matches().empty());
+    EXPECT_TRUE(detok.Detokenize("\0\0\0\x80"sv).matches().empty());
+  }
+}
+
+TEST(DetokenizeFromSortedDatabase, InvalidIndexIsNotUsed) {
+  std::vector<std::byte> database = IndexedDatabase(kIndexedEntries, 2);
+
+  // Corrupt the index magic. The entries are sorted, so they are searched
+  // without the index.
+  const size_t index_offset = static_cast<size_t>(database[12]);
+  database[index_offset] = std::byte{'X'};
+  const Detokenizer detok = Detokenizer::FromSortedDatabase(database);
+  EXPECT_EQ(detok.Detokenize("\x07\0\0\x40"sv).BestString(), "Seven");
+}
+
+TEST(DetokenizeFromSortedDatabase, OutOfRangeIndexValuesAreIgnored) {
+  std::vector<std::byte> database = IndexedDatabase(kIndexedEntries, 0);
+  const size_t index_offset = static_cast<size_t>(database[12]);
+
+  // Point the string offset of the first entry past the string table.
+  const size_t string_offsets = index_offset + 16 + 2 * sizeof(uint32_t);
+  database[string_offsets + 3] = std::byte{0x7f};
+  // Extend the only bucket past the end of the entries.
+  database[index_offset + 16 + 4 + 3] = std::byte{0x7f};
+
+  const Detokenizer detok = Detokenizer::FromSortedDatabase(database);
+  EXPECT_TRUE(detok.Detokenize("\x01\0\0\0"sv).matches().empty());
+  EXPECT_EQ(detok.Detokenize("\x07\0\0\x40"sv).BestString(), "Seven");
+}
+
 TEST_F(Detokenize, BestString_MissingToken_IsEmpty) {
   EXPECT_FALSE(detok_.Detokenize("").ok());
   EXPECT_TRUE(detok_.Detokenize("", 0u).BestString().empty());
@@ -196,6 +390,65 @@ TEST_F(Detokenize, OptionallyTokenizedData) {
   }
 }
 
+TEST_F(Detokenize, Streaming_OutputsTextOutsideMessagesImmediately) {
+  StreamingDetokenizer streaming(detok_);
+  EXPECT_EQ(streaming.Detokenize("Hello, $AQ"), "Hello, ");
+  EXPECT_EQ(streaming.Detokenize("AAAA"), "");
+  EXPECT_EQ(streaming.Detokenize("==! $BQAAAA=="), "One! ");
+  EXPECT_EQ(streaming.Flush(), "TWO");
+  EXPECT_EQ(streaming.Flush(), "");
+}
+
+TEST_F(Detokenize, Streaming_MatchesDetokenizeText) {
+  for (auto [data, expected] : TestCases(
+           Case{"$AQAAAA==$BQAAAA==$/wAAAA==", "OneTWO333"},
+           Case{"$$$AQAAAA==$$", "$$One$$"},
+           Case{"$AQAAAA==$AQAAAA", "One$AQAAAA"},
+           Case{"nested: $7u7u7g==!", "nested: One!"},
+           Case{"$", "$"},
+           Case{"$=", "$="},
+           Case{"", ""})) {
+    EXPECT_EQ(detok_.DetokenizeText(data), expected);
+
+    // Split the text into chunks of every size.
+    for (size_t chunk_size = 1; chunk_size <= data.size(); ++chunk_size) {
+      StreamingDetokenizer streaming(detok_);
+      std::string output;
+      for (size_t i = 0; i < data.size(); i += chunk_size) {
+        output += streaming.Detokenize(data.substr(i, chunk_size));
+      }
+      output += streaming.Flush();
+      EXPECT_EQ(output, expected);
+    }
+  }
+}
+
+TEST_F(Detokenize, Streaming_MaxDepth) {
+  StreamingDetokenizer streaming(detok_, 1);
+  EXPECT_EQ(streaming.Detokenize("$7u7u7g== "), "$AQAAAA== ");
+}
+
+TEST_F(Detokenize, Streaming_FromReaderToWriter) {
+  constexpr std::string_view kText = "Log: $AQAAAA==, $7u7u7g==\nEnd $BQAAAA==";
+  stream::MemoryReader reader(as_bytes(span(kText)));
+  stream::MemoryWriterBuffer<64> writer;
+
+  StreamingDetokenizer streaming(detok_);
+  ASSERT_EQ(streaming.Detokenize(reader, writer), OkStatus());
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(writer.data()),
+                             writer.size()),
+            "Log: One, One\nEnd TWO");
+}
+
+TEST_F(Detokenize, Streaming_WriterError) {
+  constexpr std::string_view kText = "Log: $AQAAAA==, $7u7u7g==\nEnd $BQAAAA==";
+  stream::MemoryReader reader(as_bytes(span(kText)));
+  stream::MemoryWriterBuffer<8> writer;
+
+  StreamingDetokenizer streaming(detok_);
+  EXPECT_EQ(streaming.Detokenize(reader, writer), Status::ResourceExhausted());
+}
+
 constexpr char kDataWithArguments[] =
     "TOKENS\0\0"
     "\x09\x00\x00\x00"
@@ -255,6 +508,17 @@ TEST_F(DetokenizeWithArgs, Successful) {
   }
 }
 
+TEST(DetokenizeFromSortedDatabase, UnsortedDatabase) {
+  // The entries in kWithArgs are not sorted, so the detokenizer falls back to
+  // a hash table.
+  const Detokenizer detok = Detokenizer::FromSortedDatabase(kWithArgs);
+  EXPECT_EQ(detok.Detokenize("\x0A\x0B\x0C\x0D\5force\4Luke"sv).BestString(),
+            "Use the force, Luke.");
+  EXPECT_EQ(detok.Detokenize("\xEE\xEE\xEE\xEE\xfe\xff\x07"sv).BestString(),
+            "65535!");
+  EXPECT_EQ(detok.Detokenize("\x00\x00\x00\x00"sv).matches().size(), 1u);
+}
+
 TEST_F(DetokenizeWithArgs, ExtraDataError) {
   auto error = detok_.Detokenize("\x00\x00\x00\x00MORE data"sv);
   EXPECT_FALSE(error.ok());
@@ -376,5 +640,24 @@ TEST_F(DetokenizeWithCollisions, Collision_TracksAllMatches) {
   EXPECT_EQ(result.matches().size(), 7u);
 }
 
+TEST(DetokenizeFromSortedDatabase, Collisions) {
+  const Detokenizer detok = Detokenizer::FromSortedDatabase(kWithCollisions);
+  EXPECT_EQ(detok.Detokenize("\0\0\0\0"sv).matches().size(), 7u);
+  EXPECT_EQ(detok.Detokenize("\xAA\xAA\xAA\xAA"sv).BestString(),
+            "This one is present");
+  EXPECT_EQ(detok.Detokenize("\xDD\xDD\xDD\xDD\x01\x02\x01\x04\x05"sv)
+                .BestString(),
+            "Five -1 1 -1 2 %s");
+}
+
+TEST(DetokenizeCorpus, DetokenizesAllMessages) {
+  Detokenizer detok(TokenDatabase::Create<test::kCorpusDatabase>());
+  for (size_t i = 0; i < test::kDetokenizeCorpus.size(); ++i) {
+    DetokenizedString result = detok.Detokenize(test::kDetokenizeCorpus[i]);
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(result.BestString(), test::kDetokenizeCorpusResults[i]);
+  }
+}
+
 }  // namespace
 }  // namespace pw::tokenizer
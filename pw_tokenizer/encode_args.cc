@@ -53,7 +53,11 @@ size_t EncodeFloat(float value, const span<std::byte>& output) {
   return sizeof(value);
 }
 
-size_t EncodeString(const char* string, const span<std::byte>& output) {
+}  // namespace
+
+namespace internal {
+
+size_t EncodeString(const char* string, span<std::byte> output) {
   // The top bit of the status byte indicates if the string was truncated.
   static constexpr size_t kMaxStringLength = 0x7Fu;
 
@@ -87,7 +91,7 @@ size_t EncodeString(const char* string, const span<std::byte>& output) {
   return bytes_to_copy + 1;  // include the status byte in the total
 }
 
-}  // namespace
+}  // namespace internal
 
 size_t EncodeArgs(pw_tokenizer_ArgTypes types,
                   va_list args,
@@ -112,7 +116,8 @@ size_t EncodeArgs(pw_tokenizer_ArgTypes types,
             EncodeFloat(static_cast<float>(va_arg(args, double)), output);
         break;
       case ArgType::kString:
-        argument_bytes = EncodeString(va_arg(args, const char*), output);
+        argument_bytes =
+            internal::EncodeString(va_arg(args, const char*), output);
         break;
     }
 
@@ -14,6 +14,11 @@
 
 #include "pw_tokenizer/encode_args.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdarg>
+#include <cstdint>
+
 #include "pw_unit_test/framework.h"
 
 namespace pw {
@@ -50,5 +55,66 @@ TEST(TokenizerCEncodingFunctions, EncodeInt64) {
   EXPECT_EQ(buffer[0], 2);  // 1 encodes to 2 with ZigZag
 }
 
+// Encodes the arguments with the va_list version of EncodeArgs.
+size_t EncodeVaList(span<std::byte> output, pw_tokenizer_ArgTypes types, ...) {
+  va_list args;
+  va_start(args, types);
+  const size_t size = EncodeArgs(types, args, output);
+  va_end(args);
+  return size;
+}
+
+// Checks that the compile-time and va_list encoders produce the same output.
+#define EXPECT_ENCODES_SAME(buffer_size, ...)                                 \
+  do {                                                                        \
+    std::array<std::byte, buffer_size> expected{};                            \
+    std::array<std::byte, buffer_size> actual{};                              \
+    const size_t expected_size = EncodeVaList(                                \
+        expected, PW_TOKENIZER_ARG_TYPES(__VA_ARGS__), __VA_ARGS__);          \
+    ASSERT_EQ(EncodeArgs(actual, __VA_ARGS__), expected_size);                \
+    EXPECT_TRUE(std::equal(                                                   \
+        expected.begin(), expected.begin() + expected_size, actual.begin())); \
+  } while (0)
+
+enum Color : uint8_t { kRed = 200 };
+
+TEST(EncodeArgsTemplate, NoArguments) {
+  std::array<std::byte, 4> buffer{};
+  EXPECT_EQ(EncodeArgs(buffer), 0u);
+}
+
+TEST(EncodeArgsTemplate, MatchesVaListEncoding) {
+  int value = 0;
+  EXPECT_ENCODES_SAME(64, 0, -1, 1, INT32_MIN, INT32_MAX);
+  EXPECT_ENCODES_SAME(64, 0u, UINT32_MAX, 0x80000000u);
+  EXPECT_ENCODES_SAME(64, true, 'c', static_cast<short>(-300));
+  EXPECT_ENCODES_SAME(64, INT64_MIN, INT64_MAX, uint64_t{1} << 63);
+  EXPECT_ENCODES_SAME(64, 1.5f, -2.25, 1e100);
+  EXPECT_ENCODES_SAME(64, "Hello", static_cast<const char*>(nullptr), "");
+  EXPECT_ENCODES_SAME(64, &value, static_cast<void*>(nullptr));
+  EXPECT_ENCODES_SAME(64, kRed);
+  EXPECT_ENCODES_SAME(64, "mixed", 123, 4.5f, int64_t{-7}, "args");
+}
+
+TEST(EncodeArgsTemplate, StopsWhenBufferIsFull) {
+  // Each of these buffer sizes cuts off a different argument.
+  EXPECT_ENCODES_SAME(0, 1000, "string", 1.0f);
+  EXPECT_ENCODES_SAME(1, 1000, "string", 1.0f);
+  EXPECT_ENCODES_SAME(2, 1000, "string", 1.0f);
+  EXPECT_ENCODES_SAME(3, 1000, "string", 1.0f);
+  EXPECT_ENCODES_SAME(6, 1000, "string", 1.0f);
+  EXPECT_ENCODES_SAME(9, 1000, "string", 1.0f);
+  EXPECT_ENCODES_SAME(13, 1000, "string", 1.0f);
+}
+
+TEST(EncodeArgsTemplate, FitsInMinEncodingBufferSize) {
+  std::array<std::byte,
+             MinEncodingBufferSizeBytes<int, int64_t, float, const char*>() -
+                 sizeof(pw_tokenizer_Token)>
+      buffer;
+  EXPECT_EQ(EncodeArgs(buffer, INT32_MIN, INT64_MIN, 1.0f, "truncated"),
+            buffer.size());
+}
+
 }  // namespace tokenizer
 }  // namespace pw
@@ -0,0 +1,90 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// This file provides the BatchDetokenizer class, which detokenizes many
+// messages in parallel with a shared Detokenizer. It uses std::thread, so it is
+// only available on host platforms.
+//
+//   Detokenizer detok = Detokenizer::FromSortedDatabase(database);
+//   BatchDetokenizer batch(detok);
+//
+//   std::vector<std::string> lines = batch.DetokenizeText(log_lines);
+//
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "pw_span/span.h"
+#include "pw_tokenizer/detokenize.h"
+
+namespace pw::tokenizer {
+
+/// @defgroup pw_tokenizer_batch_detokenize
+/// @{
+
+/// Detokenizes batches of messages across several threads, which share one
+/// read-only `Detokenizer`. Results are returned in the same order as the
+/// messages.
+///
+/// For a `Detokenizer` created with `Detokenizer::FromSortedDatabase`, each
+/// thread also remembers the entries for recent tokens that did not fit in the
+/// `Detokenizer`'s own format string cache. This avoids repeatedly searching
+/// the database and parsing the format strings of frequently logged messages.
+class BatchDetokenizer {
+ public:
+  /// Messages are handed out to threads in blocks of this many.
+  static constexpr size_t kMessagesPerBlock = 64;
+
+  /// @param[in] detokenizer The `Detokenizer` to use. It must outlive the
+  /// `BatchDetokenizer`.
+  ///
+  /// @param[in] threads The maximum number of threads to use, including the
+  /// calling thread. If 0, uses `std::thread::hardware_concurrency()`.
+  explicit BatchDetokenizer(const Detokenizer& detokenizer,
+                            unsigned threads = 0);
+
+  /// Decodes and detokenizes binary encoded messages, as with
+  /// `Detokenizer::Detokenize`.
+  std::vector<DetokenizedString> Detokenize(
+      span<const span<const std::byte>> messages) const;
+
+  /// Decodes and detokenizes Base64-encoded messages, as with
+  /// `Detokenizer::DetokenizeBase64Message`.
+  std::vector<DetokenizedString> DetokenizeBase64Messages(
+      span<const std::string_view> messages) const;
+
+  /// Decodes and detokenizes nested tokenized messages in strings, as with
+  /// `Detokenizer::DetokenizeText`.
+  std::vector<std::string> DetokenizeText(span<const std::string_view> texts,
+                                          unsigned max_passes = 3) const;
+
+  /// The maximum number of threads used to detokenize a batch.
+  unsigned threads() const { return threads_; }
+
+ private:
+  // Calls detokenize(index, cache) for each index in [0, count) across the
+  // threads. Each thread has its own cache.
+  template <typename Function>
+  void ForEach(size_t count, const Function& detokenize) const;
+
+  const Detokenizer& detokenizer_;
+  unsigned threads_;
+};
+
+/// @}
+
+}  // namespace pw::tokenizer
@@ -24,8 +24,10 @@
 //
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -33,6 +35,8 @@
 
 #include "pw_result/result.h"
 #include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
 #include "pw_tokenizer/internal/decode.h"
 #include "pw_tokenizer/token_database.h"
 
@@ -77,8 +81,10 @@ class DetokenizedString {
   std::vector<DecodedFormatString> matches_;
 };
 
-/// Decodes and detokenizes from a token database. This class builds a hash
-/// table of tokens to give `O(1)` token lookups.
+/// Decodes and detokenizes from a token database. By default, this class
+/// builds a hash table of tokens to give `O(1)` token lookups. Detokenizers
+/// created with `FromSortedDatabase` instead search the binary database in
+/// place.
 class Detokenizer {
  public:
   /// Constructs a detokenizer from a `TokenDatabase`. The `TokenDatabase` is
@@ -101,9 +107,37 @@ class Detokenizer {
     return FromElfSection(as_bytes(elf_section));
   }
 
+  /// Constructs a detokenizer that looks up tokens directly in a binary token
+  /// database, such as a memory-mapped file, rather than copying it into a
+  /// hash table. Lookups binary search the database's sorted entries, so they
+  /// are `O(log n)`. Construction makes one pass over the string table to note
+  /// the location of every 64th string, which takes far less time and memory
+  /// than building the hash table for a large database. Each format string is
+  /// parsed the first time its token is decoded, and the result is reused.
+  ///
+  /// Unlike the other constructors, the `Detokenizer` references the
+  /// `TokenDatabase`'s memory, which must outlive it. If the database's entries
+  /// are not sorted by token, this falls back to building the hash table.
+  static Detokenizer FromSortedDatabase(const TokenDatabase& database);
+
+  /// Overload of `FromSortedDatabase` for the bytes of a binary token database.
+  /// If the database has a token index, which `pw_tokenizer.database create
+  /// --type binary --index` adds, lookups use it and are `O(1)`. Construction
+  /// only validates the index header, so no pass is made over the entries or
+  /// strings. Databases without a token index are handled like the
+  /// `TokenDatabase` overload.
+  static Detokenizer FromSortedDatabase(span<const std::byte> database);
+
+  /// Overload of `FromSortedDatabase` for a `uint8_t` span.
+  static Detokenizer FromSortedDatabase(span<const uint8_t> database) {
+    return FromSortedDatabase(as_bytes(database));
+  }
+
   /// Decodes and detokenizes the binary encoded message. Returns a
   /// `DetokenizedString` that stores all possible detokenized string results.
-  DetokenizedString Detokenize(const span<const std::byte>& encoded) const;
+  DetokenizedString Detokenize(const span<const std::byte>& encoded) const {
+    return DetokenizeImpl(encoded, nullptr);
+  }
 
   /// Overload of `Detokenize` for `span<const uint8_t>`.
   DetokenizedString Detokenize(const span<const uint8_t>& encoded) const {
@@ -122,7 +156,9 @@ class Detokenizer {
 
   /// Decodes and detokenizes a Base64-encoded message. Returns a
   /// `DetokenizedString` that stores all possible detokenized string results.
-  DetokenizedString DetokenizeBase64Message(std::string_view text) const;
+  DetokenizedString DetokenizeBase64Message(std::string_view text) const {
+    return DetokenizeBase64MessageImpl(text, nullptr);
+  }
 
   /// Decodes and detokenizes nested tokenized messages in a string.
   ///
@@ -138,7 +174,9 @@ class Detokenizer {
   /// @returns The original string with nested tokenized messages decoded in
   ///     context. Messages that fail to decode are left as-is.
   std::string DetokenizeText(std::string_view text,
-                             unsigned max_passes = 3) const;
+                             unsigned max_passes = 3) const {
+    return DetokenizeTextImpl(text, max_passes, nullptr);
+  }
 
   /// Deprecated version of `DetokenizeText` with no recursive detokenization.
   /// @deprecated Call `DetokenizeText` instead.
@@ -164,7 +202,185 @@ class Detokenizer {
       const span<const std::byte>& optionally_tokenized_data);
 
  private:
+  friend class BatchDetokenizer;
+
+  // Finds tokens in a binary token database without copying it.
+  class SortedDatabase {
+   public:
+    SortedDatabase() = default;
+
+    explicit SortedDatabase(const TokenDatabase& database);
+
+    // Uses the token index of the database, whose bytes are `bytes`. Returns
+    // false if the database does not have a valid index.
+    bool LoadIndex(const TokenDatabase& database, span<const std::byte> bytes);
+
+    // True if this refers to a valid database with sorted entries.
+    bool ok() const { return entries_ != nullptr; }
+
+    // Appends the entries for the token to `entries`.
+    void Find(uint32_t token,
+              std::vector<TokenizedStringEntry>& entries) const;
+
+   private:
+    // Every string_index_ element points to the string for this many entries.
+    static constexpr size_t kStringIndexInterval = 64;
+
+    uint32_t ReadEntryField(size_t index, size_t offset) const;
+
+    uint32_t ReadIndexWord(const std::byte* table, size_t index) const;
+
+    void FindInIndex(uint32_t token,
+                     std::vector<TokenizedStringEntry>& entries) const;
+
+    const std::byte* entries_ = nullptr;
+    size_t size_ = 0;
+    std::vector<const char*> string_index_;
+
+    // Set if the database has a token index. Entries are grouped into buckets
+    // by the top bucket_bits_ bits of their tokens.
+    const std::byte* buckets_ = nullptr;
+    const std::byte* string_offsets_ = nullptr;
+    uint32_t bucket_bits_ = 0;
+    const char* strings_ = nullptr;
+    size_t strings_size_ = 0;
+  };
+
+  // Caches the entries for recently found tokens in a SortedDatabase that are
+  // not in the FormatStringCache. Not thread safe.
+  class EntryCache {
+   public:
+    EntryCache() : slots_(kSlots) {}
+
+    // Returns the entries for the token, finding them in the database if they
+    // are not cached. The entries are valid until the next call.
+    span<const TokenizedStringEntry> Find(const SortedDatabase& database,
+                                          uint32_t token);
+
+   private:
+    static constexpr size_t kSlots = 256;
+
+    struct Slot {
+      uint32_t token = 0;
+      bool valid = false;
+      std::vector<TokenizedStringEntry> entries;
+    };
+
+    std::vector<Slot> slots_;
+  };
+
+  // Keeps the parsed entries for tokens found in a SortedDatabase, so that
+  // each format string is parsed once rather than on every decode. Each slot
+  // is claimed by the first token that maps to it and is never replaced, so
+  // lookups are lock free and the entries stay valid until the cache is
+  // destroyed. Tokens whose slot is taken are not cached.
+  class FormatStringCache {
+   public:
+    static constexpr size_t kSlots = 4096;
+
+    FormatStringCache() : slots_(new std::atomic<const Slot*>[kSlots]()) {}
+
+    FormatStringCache(const FormatStringCache&) = delete;
+    FormatStringCache& operator=(const FormatStringCache&) = delete;
+
+    ~FormatStringCache();
+
+    // Returns the entries for the token, parsing and caching them if needed.
+    // Returns nullptr if the token's slot belongs to another token.
+    const std::vector<TokenizedStringEntry>* Find(
+        const SortedDatabase& database, uint32_t token);
+
+   private:
+    struct Slot {
+      uint32_t token;
+      std::vector<TokenizedStringEntry> entries;
+    };
+
+    std::unique_ptr<std::atomic<const Slot*>[]> slots_;
+  };
+
+  explicit Detokenizer(SortedDatabase&& sorted_database)
+      : sorted_database_(std::move(sorted_database)),
+        format_strings_(std::make_shared<FormatStringCache>()) {}
+
+  // Implement the public functions. Use the cache, if one is provided.
+  DetokenizedString DetokenizeImpl(const span<const std::byte>& encoded,
+                                   EntryCache* cache) const;
+
+  DetokenizedString DetokenizeBase64MessageImpl(std::string_view text,
+                                                EntryCache* cache) const;
+
+  std::string DetokenizeTextImpl(std::string_view text,
+                                 unsigned max_passes,
+                                 EntryCache* cache) const;
+
   std::unordered_map<uint32_t, std::vector<TokenizedStringEntry>> database_;
+
+  // If valid, tokens are found in this database instead of database_.
+  SortedDatabase sorted_database_;
+
+  // Parsed entries from sorted_database_. Copies of a Detokenizer share it.
+  std::shared_ptr<FormatStringCache> format_strings_;
+};
+
+/// Detokenizes nested Base64 tokenized messages in text that arrives in
+/// chunks, such as from a serial port or socket. Unlike
+/// `Detokenizer::DetokenizeText`, the text is scanned once and decoded text is
+/// returned as soon as it is complete. Only a message that may continue in the
+/// next chunk is held back.
+///
+/// Messages that decode to text with further nested messages are expanded
+/// recursively, up to `max_depth` levels.
+///
+/// @code{.cpp}
+///
+///   StreamingDetokenizer streaming(detokenizer);
+///   while (true) {
+///     std::cout << streaming.Detokenize(ReadFromSerialPort());
+///   }
+///
+/// @endcode
+class StreamingDetokenizer {
+ public:
+  /// @param[in] detokenizer The `Detokenizer` to use, which must outlive the
+  /// `StreamingDetokenizer`.
+  ///
+  /// @param[in] max_depth The maximum number of levels of nested messages to
+  /// detokenize (0 is equivalent to 1).
+  explicit StreamingDetokenizer(const Detokenizer& detokenizer,
+                                unsigned max_depth = 3)
+      : detokenizer_(detokenizer), max_depth_(max_depth) {}
+
+  /// Processes a chunk of text and returns the detokenized text that is ready
+  /// for output.
+  std::string Detokenize(std::string_view chunk);
+
+  /// Returns the text that is being held back, detokenizing it if it is a
+  /// message. Call this at the end of the text or after a timeout.
+  std::string Flush();
+
+  /// Reads text from `reader` and writes the detokenized text to `writer` after
+  /// each read, until the reader reaches the end of its data.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The reader reached the end of its data and all of the text was
+  ///    written, including any held back text.
+  ///
+  ///    Other errors from reading or writing are returned.
+  ///
+  /// @endrst
+  Status Detokenize(stream::Reader& reader, stream::Writer& writer);
+
+ private:
+  // Detokenizes the message in message_ and appends the result to output.
+  void HandleEndOfMessage(std::string& output);
+
+  const Detokenizer& detokenizer_;
+  unsigned max_depth_;
+  std::string message_;  // A message that may continue in the next chunk.
 };
 
 /// @}
@@ -24,7 +24,9 @@
 
 #if PW_CXX_STANDARD_IS_SUPPORTED(17)
 
+#include <cstddef>
 #include <cstring>
+#include <type_traits>
 
 #include "pw_polyfill/standard.h"
 #include "pw_span/span.h"
@@ -51,6 +53,64 @@ constexpr size_t ArgEncodedSizeBytes() {
   }
 }
 
+// Encodes a zig-zag encoded integer as a varint. Returns 0 if it did not fit.
+template <typename Unsigned>
+constexpr size_t EncodeVarint(Unsigned value, span<std::byte> output) {
+  size_t written = 0;
+  do {
+    if (written == output.size()) {
+      return 0;
+    }
+    output[written++] = static_cast<std::byte>((value & 0x7Fu) | 0x80u);
+    value >>= 7;
+  } while (value != 0u);
+
+  output[written - 1] &= std::byte{0x7F};  // Clear the last byte's "more" bit.
+  return written;
+}
+
+// Encodes a string argument. Defined out of line, since every string is
+// encoded the same way.
+size_t EncodeString(const char* string, span<std::byte> output);
+
+// Converts a pointer, enum, or other integer-like argument to an integer, as
+// it would be read from a va_list.
+template <typename T>
+constexpr auto AsInteger(T value) {
+  if constexpr (std::is_null_pointer_v<T>) {
+    return 0;
+  } else if constexpr (std::is_pointer_v<T>) {
+    return reinterpret_cast<uintptr_t>(value);
+  } else {
+    return value;
+  }
+}
+
+// Encodes one argument, selecting its encoding at compile time. The result
+// matches what EncodeArgs produces for the argument when read from a va_list.
+// Returns 0 if the argument did not fit.
+template <typename T>
+size_t EncodeArg(T value, span<std::byte> output) {
+  constexpr pw_tokenizer_ArgTypes kType = VarargsType<T>();
+  if constexpr (kType == PW_TOKENIZER_ARG_TYPE_DOUBLE) {
+    const float float_value = static_cast<float>(value);
+    if (output.size() < sizeof(float_value)) {
+      return 0;
+    }
+    std::memcpy(output.data(), &float_value, sizeof(float_value));
+    return sizeof(float_value);
+  } else if constexpr (kType == PW_TOKENIZER_ARG_TYPE_STRING) {
+    return EncodeString(value, output);
+  } else if constexpr (kType == PW_TOKENIZER_ARG_TYPE_INT64) {
+    return EncodeVarint(
+        pw_varint_ZigZagEncode64(static_cast<int64_t>(AsInteger(value))),
+        output);
+  } else {
+    return EncodeVarint(
+        pw_varint_ZigZagEncode32(static_cast<int>(AsInteger(value))), output);
+  }
+}
+
 }  // namespace internal
 
 /// Calculates the minimum buffer size to allocate that is guaranteed to support
@@ -83,6 +143,44 @@ size_t EncodeArgs(pw_tokenizer_ArgTypes types,
                   va_list args,
                   span<std::byte> output);
 
+/// Encodes a tokenized string's arguments to a buffer, with the encoding for
+/// each argument selected at compile time from its type. The arguments are
+/// encoded with straight-line code instead of by walking a
+/// @cpp_type{pw_tokenizer_ArgTypes} at runtime. The result is the same as
+/// that of the `va_list` overload.
+///
+/// Use `MinEncodingBufferSizeBytes` to size the buffer at compile time:
+///
+/// @code{.cpp}
+///   std::array<std::byte, MinEncodingBufferSizeBytes<int, float>()> buffer;
+///   std::memcpy(buffer.data(), &token, sizeof(token));
+///   size_t size = sizeof(token) +
+///                 EncodeArgs(span(buffer).subspan(sizeof(token)), 42, 1.5f);
+/// @endcode
+///
+/// @returns The number of bytes written. If an argument does not fit, it and
+/// the arguments after it are not encoded.
+template <typename... ArgTypes>
+size_t EncodeArgs([[maybe_unused]] span<std::byte> output,
+                  const ArgTypes&... args) {
+  size_t encoded_bytes = 0;
+  [[maybe_unused]] bool full = false;
+
+  // Encode each argument in order. Stop when an argument doesn't fit.
+  (
+      [&](const auto& arg) {
+        if (!full) {
+          const size_t argument_bytes =
+              internal::EncodeArg(arg, output.subspan(encoded_bytes));
+          full = argument_bytes == 0u;
+          encoded_bytes += argument_bytes;
+        }
+      }(args),
+      ...);
+
+  return encoded_bytes;
+}
+
 /// Encodes a tokenized message to a fixed size buffer. This class is used to
 /// encode tokenized messages passed in from tokenization macros.
 ///
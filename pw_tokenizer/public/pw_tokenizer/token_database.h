@@ -51,7 +51,7 @@ namespace pw::tokenizer {
 ///        0     6  Magic number (``TOKENS``)
 ///        6     2  Version (``00 00``)
 ///        8     4  Entry count
-///       12     4  Reserved
+///       12     4  Token index offset (0 if none)
 ///   ======  ====  =========================
 ///
 ///   ======  ====  ==================================
@@ -69,9 +69,14 @@ namespace pw::tokenizer {
 /// Entries are sorted by token. A string table with a null-terminated string
 /// for each entry in order follows the entries.
 ///
+/// An optional token index may follow the string table. The index is not
+/// used by `TokenDatabase`; `Detokenizer::FromSortedDatabase` uses it to look
+/// up tokens in `O(1)`. See the token database format documentation.
+///
 /// Entries are accessed by iterating over the database. A O(n) `Find` function
 /// is also provided. In typical use, a `TokenDatabase` is preprocessed by a
-/// `pw::tokenizer::Detokenizer` into a `std::unordered_map`.
+/// `pw::tokenizer::Detokenizer` into a `std::unordered_map`, or searched in
+/// place by a `Detokenizer` created with `Detokenizer::FromSortedDatabase`.
 class TokenDatabase {
  private:
   // Internal struct that describes how the underlying binary token database
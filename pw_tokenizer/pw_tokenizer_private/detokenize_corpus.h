@@ -0,0 +1,67 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Seed corpus of tokenized messages for the detokenizer, shared by its unit
+// tests and its corpus benchmark.
+#pragma once
+
+#include <array>
+#include <string_view>
+
+namespace pw::tokenizer::test {
+
+using namespace std::literals::string_view_literals;
+
+// Token database for the corpus, with arbitrary token values:
+// {
+//   0x0a0b0c0d: "Battery voltage: %d mV",
+//   0x12345678: "Connected to %s on channel %u",
+//   0x2badf00d: "Temperature %f C",
+//   0x31415926: "Boot complete",
+// }
+inline constexpr char kCorpusDatabase[] =
+    "TOKENS\0\0"
+    "\x04\x00\x00\x00"  // Number of tokens in this database.
+    "\0\0\0\0"
+    "\x0d\x0c\x0b\x0a----"
+    "\x78\x56\x34\x12----"
+    "\x0d\xf0\xad\x2b----"
+    "\x26\x59\x41\x31----"
+    "Battery voltage: %d mV\0"
+    "Connected to %s on channel %u\0"
+    "Temperature %f C\0"
+    "Boot complete";
+
+// clang-format off
+inline constexpr std::array<std::string_view, 6> kDetokenizeCorpus = {
+    "\x26\x59\x41\x31"sv,
+    "\x0d\x0c\x0b\x0a\x80\x3a"sv,
+    "\x78\x56\x34\x12\x0a" "pigweed-ap" "\x16"sv,
+    "\x0d\xf0\xad\x2b\x00\x00\xac\x41"sv,
+    "\x0d\x0c\x0b\x0a\x09"sv,
+    "\x78\x56\x34\x12\x1a" "a-much-longer-network-name" "\xaa\x02"sv,
+};
+// clang-format on
+
+// The detokenized message for each input in kDetokenizeCorpus.
+inline constexpr std::array<std::string_view, 6> kDetokenizeCorpusResults = {
+    "Boot complete"sv,
+    "Battery voltage: 3712 mV"sv,
+    "Connected to pigweed-ap on channel 11"sv,
+    "Temperature 21.500000 C"sv,
+    "Battery voltage: -5 mV"sv,
+    "Connected to a-much-longer-network-name on channel 149"sv,
+};
+
+}  // namespace pw::tokenizer::test
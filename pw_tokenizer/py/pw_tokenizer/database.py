@@ -21,6 +21,7 @@ maintaining token databases.
 import argparse
 from datetime import datetime
 import glob
+import io
 import itertools
 import json
 import logging
@@ -73,6 +74,10 @@ def _read_tokenized_entries(
 ) -> Iterator[tokens.TokenizedStringEntry]:
     index = 0
 
+    # Firmware images contain many entries but few domains, so match and decode
+    # each distinct domain only once.
+    domains: dict[bytes, str | None] = {}
+
     while index + _ENTRY.size <= len(data):
         magic, token, domain_len, string_len = _ENTRY.unpack_from(data, index)
 
@@ -85,23 +90,31 @@ def _read_tokenized_entries(
         start = index + _ENTRY.size
         index = start + domain_len + string_len
 
-        # Create the entries, trimming null terminators.
-        entry = tokens.TokenizedStringEntry(
-            token,
-            data[start + domain_len : index - 1].decode(errors=_ERROR_HANDLER),
-            data[start : start + domain_len - 1].decode(errors=_ERROR_HANDLER),
+        # Trim null terminators.
+        raw_domain = data[start : start + domain_len - 1]
+        string = data[start + domain_len : index - 1].decode(
+            errors=_ERROR_HANDLER
         )
 
         if data[start + domain_len - 1] != 0:
             raise Error(
-                f'Domain {entry.domain} for {entry.string} not null terminated'
+                f'Domain {raw_domain.decode(errors=_ERROR_HANDLER)} for '
+                f'{string} not null terminated'
             )
 
         if data[index - 1] != 0:
-            raise Error(f'String {entry.string} is not null terminated')
+            raise Error(f'String {string} is not null terminated')
+
+        try:
+            entry_domain = domains[raw_domain]
+        except KeyError:
+            entry_domain = raw_domain.decode(errors=_ERROR_HANDLER)
+            if not domain.fullmatch(entry_domain):
+                entry_domain = None
+            domains[raw_domain] = entry_domain
 
-        if domain.fullmatch(entry.domain):
-            yield entry
+        if entry_domain is not None:
+            yield tokens.TokenizedStringEntry(token, string, entry_domain)
 
 
 def _database_from_elf(elf, domain: Pattern[str]) -> tokens.Database:
@@ -285,6 +298,7 @@ def _handle_create(
     include: list,
     exclude: list,
     replace: list,
+    index: bool = False,
 ) -> None:
     """Creates a token database file from one or more ELF files."""
     if not force and database.exists():
@@ -305,27 +319,32 @@ def _handle_create(
         database = database / f'database{tokens.DIR_DB_SUFFIX}'
         output_type = 'csv'
 
-    if str(database) == '-':
-        # Must write bytes to stdout; use sys.stdout.buffer.
-        fd = sys.stdout.buffer
-    else:
-        fd = database.open('wb')
-
     db = tokens.Database.merged(*databases)
     db.filter(include, exclude, replace)
 
-    with fd:
+    with io.BytesIO() as fd:
         if output_type == 'csv':
             tokens.write_csv(db, fd)
         elif output_type == 'binary':
-            tokens.write_binary(db, fd)
+            tokens.write_binary(db, fd, index=index)
         else:
             raise ValueError(f'Unknown database type "{output_type}"')
 
+        data = fd.getvalue()
+
+    if str(database) == '-':
+        # Must write bytes to stdout; use sys.stdout.buffer.
+        sys.stdout.buffer.write(data)
+    elif not tokens.write_if_changed(database, data):
+        _LOG.info(
+            'Database %s with %d entries is unchanged', database, len(db)
+        )
+        return
+
     _LOG.info(
         'Wrote database with %d entries to %s as %s',
         len(db),
-        fd.name,
+        database,
         output_type,
     )
 
@@ -556,6 +575,14 @@ def _parse_args():
         default='csv',
         help='Which type of database to create. (default: csv)',
     )
+    subparser.add_argument(
+        '--index',
+        action='store_true',
+        help=(
+            'Add a token index to a binary database, so that detokenizers '
+            'can look up tokens in place without loading the database.'
+        ),
+    )
     subparser.add_argument(
         '-f',
         '--force',
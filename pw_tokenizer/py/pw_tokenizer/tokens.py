@@ -16,6 +16,8 @@
 from __future__ import annotations
 
 from abc import abstractmethod
+import array
+import bisect
 import collections
 import csv
 from dataclasses import dataclass
@@ -26,6 +28,7 @@ from pathlib import Path
 import re
 import struct
 import subprocess
+import sys
 from typing import (
     BinaryIO,
     Callable,
@@ -232,9 +235,11 @@ class Database:
         self._cache = None
 
         for new_entry in entries:
+            key = new_entry.key()
+
             # Update an existing entry or create a new one.
             try:
-                entry = self._database[new_entry.key()]
+                entry = self._database[key]
                 entry.domain = new_entry.domain
 
                 # Keep the latest removal date between the two entries.
@@ -247,8 +252,11 @@ class Database:
                     entry.date_removed = new_entry.date_removed
             except KeyError:
                 # Make a copy to avoid unintentially updating the database.
-                self._database[new_entry.key()] = TokenizedStringEntry(
-                    **vars(new_entry)
+                self._database[key] = TokenizedStringEntry(
+                    new_entry.token,
+                    new_entry.string,
+                    new_entry.domain,
+                    new_entry.date_removed,
                 )
 
     def purge(
@@ -373,9 +381,27 @@ def parse_csv(fd: TextIO) -> Iterable[TokenizedStringEntry]:
     return entries
 
 
+def _sorted_entries(
+    entries: Iterable[TokenizedStringEntry],
+) -> list[TokenizedStringEntry]:
+    """Sorts entries in the same order as TokenizedStringEntry.__lt__.
+
+    Sorting with __lt__ calls back into Python for every comparison, which
+    dominates the time to write large databases. Instead, sort by each field
+    from least to most significant. Python's sort is stable, so each pass keeps
+    the order of the previous passes for equal keys.
+    """
+    result = sorted(entries, key=lambda entry: entry.string)
+    result.sort(
+        key=lambda entry: entry.date_removed or datetime.max, reverse=True
+    )
+    result.sort(key=lambda entry: entry.token)
+    return result
+
+
 def write_csv(database: Database, fd: BinaryIO) -> None:
     """Writes the database as CSV to the provided binary file."""
-    for entry in sorted(database.entries()):
+    for entry in _sorted_entries(database.entries()):
         _write_csv_line(fd, entry)
 
 
@@ -396,8 +422,13 @@ class _BinaryFileFormat(NamedTuple):
     """Attributes of the binary token database file format."""
 
     magic: bytes = b'TOKENS\0\0'
-    header: struct.Struct = struct.Struct('<8sI4x')
+    # The last header field is the offset of the token index, or 0 if there is
+    # no index.
+    header: struct.Struct = struct.Struct('<8sII')
     entry: struct.Struct = struct.Struct('<IBBH')
+    index_magic: bytes = b'TOKIDX\0\0'
+    index_header: struct.Struct = struct.Struct('<8sI4x')
+    max_index_bucket_bits: int = 24
 
 
 BINARY_FORMAT = _BinaryFileFormat()
@@ -443,7 +474,7 @@ def _check_that_file_is_csv_database(path: Path) -> None:
 
 def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
     """Parses TokenizedStringEntries from a binary token database file."""
-    magic, entry_count = BINARY_FORMAT.header.unpack(
+    magic, entry_count, _ = BINARY_FORMAT.header.unpack(
         fd.read(BINARY_FORMAT.header.size)
     )
 
@@ -468,6 +499,7 @@ def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
         entries.append((token, date_removed))
 
     # Read the entire string table and define a function for looking up strings.
+    # Any token index follows the string table and is ignored.
     string_table = fd.read()
 
     def read_string(start):
@@ -483,13 +515,71 @@ def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
         yield TokenizedStringEntry(token, string, DEFAULT_DOMAIN, removed)
 
 
-def write_binary(database: Database, fd: BinaryIO) -> None:
-    """Writes the database as packed binary to the provided binary file."""
-    entries = sorted(database.entries())
+def binary_database_has_index(fd: BinaryIO) -> bool:
+    """True if the binary database file has a token index."""
+    fd.seek(0)
+    header = fd.read(BINARY_FORMAT.header.size)
+    fd.seek(0)
+    if len(header) != BINARY_FORMAT.header.size:
+        return False
+    return BINARY_FORMAT.header.unpack(header)[2] != 0
+
+
+def _index_bucket_bits(entry_count: int) -> int:
+    """Selects the number of token bits to bucket entries by.
+
+    Uses at least as many buckets as entries, so each bucket holds about one
+    entry on average since tokens are hashes.
+    """
+    return min(entry_count.bit_length(), BINARY_FORMAT.max_index_bucket_bits)
+
+
+def _write_binary_index(
+    tokens: list[int], string_offsets: list[int], fd: BinaryIO
+) -> None:
+    """Writes the token index for the sorted tokens."""
+    bucket_bits = _index_bucket_bits(len(tokens))
+    fd.write(
+        BINARY_FORMAT.index_header.pack(BINARY_FORMAT.index_magic, bucket_bits)
+    )
+
+    # Each bucket stores the index of its first entry. A final element marks
+    # the end of the last bucket.
+    buckets = [
+        token >> (32 - bucket_bits) if bucket_bits else 0 for token in tokens
+    ]
+    bucket_starts = array.array(
+        'I',
+        (
+            bisect.bisect_left(buckets, bucket)
+            for bucket in range((1 << bucket_bits) + 1)
+        ),
+    )
+
+    offsets = array.array('I', string_offsets)
+    if sys.byteorder != 'little':
+        bucket_starts.byteswap()
+        offsets.byteswap()
+    fd.write(bucket_starts.tobytes())
+    fd.write(offsets.tobytes())
+
+
+def write_binary(
+    database: Database, fd: BinaryIO, *, index: bool = False
+) -> None:
+    """Writes the database as packed binary to the provided binary file.
 
-    fd.write(BINARY_FORMAT.header.pack(BINARY_FORMAT.magic, len(entries)))
+    If index is True, a token index is appended after the string table. The
+    header's last field holds the index's offset. The index maps each token to
+    its entries and each entry to its string, so a detokenizer can look tokens
+    up in place without loading the database. Readers that do not use the
+    index ignore it.
+    """
+    entries = _sorted_entries(database.entries())
 
     string_table = bytearray()
+    string_offsets: list[int] = []
+    entry_data = bytearray()
 
     for entry in entries:
         if entry.date_removed:
@@ -504,17 +594,60 @@ def write_binary(database: Database, fd: BinaryIO) -> None:
             removed_month = 0xFF
             removed_year = 0xFFFF
 
+        string_offsets.append(len(string_table))
         string_table += entry.string.encode()
         string_table.append(0)
 
-        fd.write(
-            BINARY_FORMAT.entry.pack(
-                entry.token, removed_day, removed_month, removed_year
-            )
+        entry_data += BINARY_FORMAT.entry.pack(
+            entry.token, removed_day, removed_month, removed_year
         )
 
+    index_offset = 0
+    if index:
+        # Pad the string table with null bytes to align the index.
+        string_table += bytes(-len(string_table) % 4)
+        index_offset = (
+            BINARY_FORMAT.header.size + len(entry_data) + len(string_table)
+        )
+
+    fd.write(
+        BINARY_FORMAT.header.pack(
+            BINARY_FORMAT.magic, len(entries), index_offset
+        )
+    )
+    fd.write(entry_data)
     fd.write(string_table)
 
+    if index:
+        _write_binary_index(
+            [entry.token for entry in entries], string_offsets, fd
+        )
+
+
+def write_if_changed(path: Path, data: bytes) -> bool:
+    """Writes data to path unless the file already contains exactly data.
+
+    Leaving an unchanged database untouched preserves its modification time,
+    so build steps and auto-updating detokenizers that watch the file do not
+    rebuild or reload it. Returns True if the file was written.
+    """
+    try:
+        if path.stat().st_size == len(data) and path.read_bytes() == data:
+            return False
+    except FileNotFoundError:
+        pass
+
+    path.write_bytes(data)
+    return True
+
+
+def _serialize(
+    write: Callable[..., None], database: Database, **kwargs
+) -> bytes:
+    with io.BytesIO() as fd:
+        write(database, fd, **kwargs)
+        return fd.getvalue()
+
 
 class DatabaseFile(Database):
     """A token database that is associated with a particular file.
@@ -561,13 +694,15 @@ class DatabaseFile(Database):
 
 class _BinaryDatabase(DatabaseFile):
     def __init__(self, path: Path, fd: BinaryIO) -> None:
+        self._index = binary_database_has_index(fd)
         super().__init__(path, parse_binary(fd))
 
     def write_to_file(self, *, rewrite: bool = False) -> None:
         """Exports in the binary format to the original path."""
         del rewrite  # Binary databases are always rewritten
-        with self.path.open('wb') as fd:
-            write_binary(self, fd)
+        write_if_changed(
+            self.path, _serialize(write_binary, self, index=self._index)
+        )
 
     def add_and_discard_temporary(
         self, entries: Iterable[TokenizedStringEntry], commit: str
@@ -588,8 +723,7 @@ class _CSVDatabase(DatabaseFile):
     def write_to_file(self, *, rewrite: bool = False) -> None:
         """Exports in the CSV format to the original path."""
         del rewrite  # CSV databases are always rewritten
-        with self.path.open('wb') as fd:
-            write_csv(self, fd)
+        write_if_changed(self.path, _serialize(write_csv, self))
 
     def add_and_discard_temporary(
         self, entries: Iterable[TokenizedStringEntry], commit: str
@@ -624,10 +758,17 @@ class _DirectoryDatabase(DatabaseFile):
     def write_to_file(self, *, rewrite: bool = False) -> None:
         """Creates a new CSV file in the directory with any new tokens."""
         if rewrite:
+            data = _serialize(write_csv, self)
+
+            # If the directory is already compacted into one up-to-date CSV,
+            # leave it as is.
+            csv_files = list(self.path.glob(DIR_DB_GLOB))
+            if len(csv_files) == 1 and csv_files[0].read_bytes() == data:
+                return
+
             # Write the entire database to a new CSV file
             new_file = self._create_filename()
-            with new_file.open('wb') as fd:
-                write_csv(self, fd)
+            new_file.write_bytes(data)
 
             # Delete all CSV files except for the new CSV with everything.
             for csv_file in self.path.glob(DIR_DB_GLOB):
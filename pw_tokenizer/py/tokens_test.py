@@ -17,8 +17,10 @@
 from datetime import datetime
 import io
 import logging
+import os
 from pathlib import Path
 import shutil
+import struct
 import tempfile
 from typing import Iterator
 import unittest
@@ -192,6 +194,15 @@ class TokenDatabaseTest(unittest.TestCase):
             ),
         )
 
+    def test_sorted_entries_matches_entry_order(self) -> None:
+        entries = [
+            tokens.TokenizedStringEntry(token, string, '', date)
+            for date in (datetime(2020, 1, 1), None, datetime(2021, 1, 1))
+            for string in ('a', 'b')
+            for token in (2, 1)
+        ]
+        self.assertEqual(tokens._sorted_entries(entries), sorted(entries))
+
     def test_bad_csv(self) -> None:
         with self.assertLogs(_LOG, logging.ERROR) as logs:
             db = read_db_from_csv(INVALID_CSV)
@@ -556,6 +567,45 @@ class TokenDatabaseTest(unittest.TestCase):
 
         self.assertEqual(str(db), CSV_DATABASE)
 
+    def test_binary_format_write_with_index(self) -> None:
+        db = read_db_from_csv(CSV_DATABASE)
+
+        with io.BytesIO() as fd:
+            tokens.write_binary(db, fd, index=True)
+            binary_db = fd.getvalue()
+
+        # Readers that do not use the index parse the database as before.
+        with io.BytesIO(binary_db) as fd:
+            self.assertTrue(tokens.binary_database_has_index(fd))
+            self.assertEqual(
+                str(tokens.Database(tokens.parse_binary(fd))), CSV_DATABASE
+            )
+
+        # Look up each token through the index.
+        _, entry_count, index_offset = struct.unpack_from('<8sII', binary_db)
+        strings_offset = 16 + 8 * entry_count
+        magic, bucket_bits = struct.unpack_from('<8sI', binary_db, index_offset)
+        self.assertEqual(magic, b'TOKIDX\0\0')
+        buckets_offset = index_offset + 16
+        string_offsets_offset = buckets_offset + 4 * ((1 << bucket_bits) + 1)
+
+        for entry in db.entries():
+            bucket = entry.token >> (32 - bucket_bits) if bucket_bits else 0
+            start, end = struct.unpack_from(
+                '<II', binary_db, buckets_offset + 4 * bucket
+            )
+            found = []
+            for i in range(start, end):
+                (token,) = struct.unpack_from('<I', binary_db, 16 + 8 * i)
+                (offset,) = struct.unpack_from(
+                    '<I', binary_db, string_offsets_offset + 4 * i
+                )
+                if token == entry.token:
+                    string_start = strings_offset + offset
+                    string_end = binary_db.index(b'\0', string_start)
+                    found.append(binary_db[string_start:string_end].decode())
+            self.assertIn(entry.string, found)
+
 
 class TestDatabaseFile(unittest.TestCase):
     """Tests the DatabaseFile class."""
@@ -582,6 +632,33 @@ class TestDatabaseFile(unittest.TestCase):
             CSV_DATABASE + 'ffffffff,          ,"New entry!"\n',
         )
 
+    def test_update_binary_file_keeps_index(self) -> None:
+        with self._path.open('wb') as fd:
+            tokens.write_binary(
+                read_db_from_csv(CSV_DATABASE), fd, index=True
+            )
+
+        db = tokens.DatabaseFile.load(self._path)
+        db.add([tokens.TokenizedStringEntry(0xFFFFFFFF, 'New entry!')])
+        db.write_to_file()
+
+        with self._path.open('rb') as fd:
+            self.assertTrue(tokens.binary_database_has_index(fd))
+            entries = list(tokens.parse_binary(fd))
+        self.assertEqual(entries[-1].string, 'New entry!')
+
+    def test_unchanged_file_is_not_rewritten(self) -> None:
+        self._path.write_text(CSV_DATABASE)
+        os.utime(self._path, (0, 0))
+
+        db = tokens.DatabaseFile.load(self._path)
+        db.write_to_file()
+        self.assertEqual(self._path.stat().st_mtime, 0)
+
+        db.add([tokens.TokenizedStringEntry(0xFFFFFFFF, 'New entry!')])
+        db.write_to_file()
+        self.assertNotEqual(self._path.stat().st_mtime, 0)
+
     def test_csv_file_too_short_raises_exception(self) -> None:
         self._path.write_text('1234')
 
@@ -762,6 +839,18 @@ class TestDirectoryDatabase(unittest.TestCase):
         directory_db = tokens.DatabaseFile.load(self._db_dir)
         self.assertEqual(str(all_databases_merged), str(directory_db))
 
+    def test_rewrite_compacted_directory_keeps_file(self) -> None:
+        self._db_csv.write_text(CSV_DATABASE_3)
+        directory_db = tokens.DatabaseFile.load(self._db_dir)
+        directory_db.write_to_file(rewrite=True)
+        compacted = list(self._db_dir.glob(f'*{DIR_DB_SUFFIX}'))
+
+        directory_db = tokens.DatabaseFile.load(self._db_dir)
+        directory_db.write_to_file(rewrite=True)
+        self.assertEqual(
+            compacted, list(self._db_dir.glob(f'*{DIR_DB_SUFFIX}'))
+        )
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -45,6 +45,9 @@ pw_set_backend(pw_sync.counting_semaphore
                pw_sync_stl.counting_semaphore_backend)
 pw_set_backend(pw_sync.mutex pw_sync_stl.mutex_backend)
 pw_set_backend(pw_sync.timed_mutex pw_sync_stl.timed_mutex_backend)
+pw_set_backend(pw_sync.shared_mutex pw_sync_stl.shared_mutex_backend)
+pw_set_backend(pw_sync.timed_shared_mutex
+               pw_sync_stl.timed_shared_mutex_backend)
 pw_set_backend(pw_sync.thread_notification
                pw_sync.binary_semaphore_thread_notification_backend)
 pw_set_backend(pw_sync.timed_thread_notification
@@ -60,12 +63,15 @@ pw_set_backend(pw_rpc.system_server targets.host.system_rpc_server)
 # Configure backend for pw_chrono's facades.
 pw_set_backend(pw_chrono.system_clock pw_chrono_stl.system_clock)
 pw_set_backend(pw_chrono.system_timer pw_chrono_stl.system_timer)
+pw_set_backend(pw_chrono.high_resolution_clock
+               pw_chrono_stl.high_resolution_clock)
 
 # Configure backend for pw_perf_test's facade.
 pw_perf_test(pw_perf_test.timer pw_perf_test.chrono_timer)
 
 # Configure backends for pw_thread's facades.
 pw_set_backend(pw_thread.id pw_thread_stl.id)
+pw_set_backend(pw_thread.thread_local pw_thread_stl.thread_local)
 pw_set_backend(pw_thread.yield pw_thread_stl.yield)
 pw_set_backend(pw_thread.sleep pw_thread_stl.sleep)
 pw_set_backend(pw_thread.thread pw_thread_stl.thread)
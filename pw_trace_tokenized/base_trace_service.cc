@@ -24,7 +24,14 @@ BaseTraceService::BaseTraceService(TokenizedTracer& tokenized_tracer,
   tokenized_tracer_.Enable(false);
 }
 
-Status BaseTraceService::Start() {
+BaseTraceService::BaseTraceService(TokenizedTracer& tokenized_tracer,
+                                   PerCoreTraceBufferBase& per_core_buffer,
+                                   stream::Writer& trace_writer)
+    : BaseTraceService(tokenized_tracer, trace_writer) {
+  per_core_buffer_ = &per_core_buffer;
+}
+
+Status BaseTraceService::Start(bool streaming) {
   PW_LOG_INFO("Starting Tracing");
 
   if (tokenized_tracer_.IsEnabled()) {
@@ -32,6 +39,18 @@ Status BaseTraceService::Start() {
     return Status::FailedPrecondition();
   }
 
+  if (streaming && per_core_buffer_ != nullptr) {
+    PW_LOG_ERROR("Streaming is not supported with a per-core trace buffer");
+    return Status::Unimplemented();
+  }
+
+  streaming_ = streaming;
+  dropped_events_ = 0;
+  if (streaming_) {
+    trace::ClearBuffer();
+  }
+  trace::SetStreamingMode(streaming_);
+
   tokenized_tracer_.Enable(true);
 
   return OkStatus();
@@ -47,6 +66,13 @@ Status BaseTraceService::Stop() {
 
   tokenized_tracer_.Enable(false);
 
+  if (per_core_buffer_ != nullptr) {
+    return StopPerCore();
+  }
+  if (streaming_) {
+    return StopStreaming();
+  }
+
   auto ring_buffer = trace::GetBuffer();
 
   if (ring_buffer->EntryCount() == 0) {
@@ -73,4 +99,59 @@ Status BaseTraceService::Stop() {
   return OkStatus();
 }
 
+Status BaseTraceService::Flush() {
+  if (!streaming_) {
+    return Status::FailedPrecondition();
+  }
+  return trace::DrainBuffer(trace_writer_).status();
+}
+
+Status BaseTraceService::StopStreaming() {
+  streaming_ = false;
+
+  StatusWithSize result = trace::DrainBuffer(trace_writer_);
+
+  // Entries that the writer did not accept are discarded, so count them as
+  // dropped.
+  const size_t dropped =
+      trace::GetDroppedEventCount() + trace::GetBuffer()->EntryCount();
+  dropped_events_ = static_cast<uint32_t>(dropped);
+  trace::SetStreamingMode(false);
+  trace::ClearBuffer();
+
+  if (!result.ok()) {
+    PW_LOG_ERROR("Failed to write trace data: %d)", result.status().code());
+    return result.status();
+  }
+  if (dropped != 0u) {
+    PW_LOG_WARN("Dropped(%zu)", dropped);
+  }
+
+  return OkStatus();
+}
+
+Status BaseTraceService::StopPerCore() {
+  if (per_core_buffer_->dropped() != 0u) {
+    PW_LOG_WARN("Dropped(%zu)", per_core_buffer_->dropped());
+  }
+
+  const size_t entry_count = per_core_buffer_->EntryCount();
+  if (entry_count == 0) {
+    PW_LOG_WARN("EntryCount(%zu)", entry_count);
+    return Status::Unavailable();
+  }
+
+  PW_LOG_INFO("EntryCount(%zu)", entry_count);
+
+  if (auto status = per_core_buffer_->Drain(trace_writer_);
+      status != OkStatus()) {
+    PW_LOG_ERROR("Failed to write trace data: %d)", status.code());
+    return status;
+  }
+
+  per_core_buffer_->Clear();
+
+  return OkStatus();
+}
+
 }  // namespace pw::trace
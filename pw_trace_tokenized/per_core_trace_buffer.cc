@@ -0,0 +1,157 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/per_core_trace_buffer.h"
+
+#include <cstring>
+
+#include "pw_trace/trace.h"
+#include "pw_varint/varint.h"
+
+namespace pw::trace {
+
+bool PerCoreTraceBufferBase::Record(size_t lane_index,
+                                    const pw_trace_tokenized_TraceEvent& event,
+                                    PW_TRACE_TIME_TYPE time) {
+  if (lane_index >= lanes_.size() ||
+      event.data_size > PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  Lane& lane = lanes_[lane_index];
+  if (lane.recording_.exchange(true, std::memory_order_acquire)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;  // Interrupted another recording on this lane.
+  }
+
+  const size_t head = lane.head_.load(std::memory_order_relaxed);
+  const bool full =
+      head - lane.tail_.load(std::memory_order_acquire) == events_per_lane_;
+  if (!full) {
+    Event& slot = Slot(lane_index, head);
+    slot.time = time;
+    slot.trace_token = event.trace_token;
+    slot.trace_id = event.trace_id;
+    slot.event_type = event.event_type;
+    slot.data_size = event.data_size;
+    if (event.data_size > 0u) {
+      std::memcpy(slot.data, event.data_buffer, event.data_size);
+    }
+    lane.head_.store(head + 1, std::memory_order_release);
+  } else {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  lane.recording_.store(false, std::memory_order_release);
+  return !full;
+}
+
+Status PerCoreTraceBufferBase::RegisterWith(Callbacks& callbacks,
+                                            GetLaneFunction get_lane) {
+  get_lane_ = get_lane;
+  return callbacks.RegisterEventCallback(
+      RecordCallback, Callbacks::kCallOnlyWhenEnabled, this);
+}
+
+pw_trace_TraceEventReturnFlags PerCoreTraceBufferBase::RecordCallback(
+    void* user_data, pw_trace_tokenized_TraceEvent* event) {
+  auto* buffer = static_cast<PerCoreTraceBufferBase*>(user_data);
+  buffer->Record(buffer->get_lane_(), *event, pw_trace_GetTraceTime());
+  return PW_TRACE_EVENT_RETURN_FLAGS_SKIP_EVENT;
+}
+
+Status PerCoreTraceBufferBase::Drain(stream::Writer& writer) {
+  // Bound the drain to the events present when it starts, so that producers
+  // cannot keep it running indefinitely.
+  size_t remaining = EntryCount();
+  bool first_event = true;
+  PW_TRACE_TIME_TYPE last_time = 0;
+  internal::RecordEncoder<PW_TRACE_CONFIG_COMPACT_RECORDS> encoder;
+
+  for (; remaining > 0u; --remaining) {
+    // Find the lane whose oldest event is the oldest overall. Each lane is
+    // already in time order, so this merges them.
+    size_t next_lane = lanes_.size();
+    const Event* next = nullptr;
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+      const size_t tail = lanes_[i].tail_.load(std::memory_order_relaxed);
+      if (tail == lanes_[i].head_.load(std::memory_order_acquire)) {
+        continue;
+      }
+      const Event& candidate = Slot(i, tail);
+      if (next == nullptr || candidate.time < next->time) {
+        next_lane = i;
+        next = &candidate;
+      }
+    }
+    if (next == nullptr) {
+      break;
+    }
+
+    // Encode the entry as TokenizedTracer does, preceded by its size as in the
+    // trace buffer's PrefixedEntryRingBuffer.
+    std::byte entry[varint::kMaxVarint32SizeBytes +
+                    PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES];
+    std::byte* const body = entry + varint::kMaxVarint32SizeBytes;
+    const ByteSpan body_span(body, PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES);
+
+    const PW_TRACE_TIME_TYPE delta =
+        first_event ? 0 : PW_TRACE_GET_TIME_DELTA(last_time, next->time);
+    size_t body_size =
+        encoder.EncodeHeader(next->trace_token,
+                             delta,
+                             PW_TRACE_HAS_TRACE_ID(next->event_type),
+                             next->trace_id,
+                             body_span);
+    std::memcpy(body + body_size, next->data, next->data_size);
+    body_size += next->data_size;
+
+    // Write the size prefix immediately before the body.
+    std::byte prefix[varint::kMaxVarint32SizeBytes];
+    const size_t prefix_size = varint::Encode(body_size, prefix);
+    std::byte* const start = body - prefix_size;
+    std::memcpy(start, prefix, prefix_size);
+
+    if (Status status = writer.Write(start, prefix_size + body_size);
+        !status.ok()) {
+      return status;
+    }
+
+    first_event = false;
+    last_time = next->time;
+    Lane& lane = lanes_[next_lane];
+    lane.tail_.store(lane.tail_.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+  }
+  return OkStatus();
+}
+
+size_t PerCoreTraceBufferBase::EntryCount() const {
+  size_t count = 0;
+  for (const Lane& lane : lanes_) {
+    count += lane.head_.load(std::memory_order_acquire) -
+             lane.tail_.load(std::memory_order_relaxed);
+  }
+  return count;
+}
+
+void PerCoreTraceBufferBase::Clear() {
+  for (Lane& lane : lanes_) {
+    lane.tail_.store(lane.head_.load(std::memory_order_acquire),
+                     std::memory_order_release);
+  }
+}
+
+}  // namespace pw::trace
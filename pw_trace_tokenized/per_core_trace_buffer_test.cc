@@ -0,0 +1,229 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/per_core_trace_buffer.h"
+
+#include <cstring>
+
+#include "pw_bytes/span.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_unit_test/framework.h"
+#include "pw_varint/varint.h"
+
+namespace pw::trace {
+namespace {
+
+struct DecodedEntry {
+  uint32_t trace_token;
+  uint64_t time_delta;
+  uint64_t trace_id;
+  ConstByteSpan data;
+};
+
+pw_trace_tokenized_TraceEvent MakeEvent(uint32_t trace_token,
+                                        EventType event_type,
+                                        uint32_t trace_id = 0,
+                                        const void* data = nullptr,
+                                        size_t data_size = 0) {
+  return {
+      .trace_token = trace_token,
+      .event_type = event_type,
+      .module = "TST",
+      .flags = 0,
+      .trace_id = trace_id,
+      .data_size = data_size,
+      .data_buffer = data,
+  };
+}
+
+// Decodes the next size-prefixed entry from the drained data. The trace ID is
+// only present for async events.
+DecodedEntry DecodeEntry(ConstByteSpan& data, bool has_trace_id) {
+  DecodedEntry decoded{};
+  uint64_t size = 0;
+  const size_t prefix_size = varint::Decode(data, &size);
+  EXPECT_NE(prefix_size, 0u);
+  ConstByteSpan entry = data.subspan(prefix_size, static_cast<size_t>(size));
+  data = data.subspan(prefix_size + static_cast<size_t>(size));
+
+  std::memcpy(&decoded.trace_token, entry.data(), sizeof(uint32_t));
+  entry = entry.subspan(sizeof(uint32_t));
+  entry = entry.subspan(varint::Decode(entry, &decoded.time_delta));
+  if (has_trace_id) {
+    entry = entry.subspan(varint::Decode(entry, &decoded.trace_id));
+  }
+  decoded.data = entry;
+  return decoded;
+}
+
+TEST(PerCoreTraceBuffer, MergesLanesByTimestamp) {
+  PerCoreTraceBuffer<3, 4> buffer;
+  EXPECT_TRUE(buffer.Record(0, MakeEvent(1, PW_TRACE_EVENT_TYPE_INSTANT), 10));
+  EXPECT_TRUE(buffer.Record(1, MakeEvent(2, PW_TRACE_EVENT_TYPE_INSTANT), 12));
+  EXPECT_TRUE(buffer.Record(2, MakeEvent(3, PW_TRACE_EVENT_TYPE_INSTANT), 5));
+  EXPECT_TRUE(buffer.Record(0, MakeEvent(4, PW_TRACE_EVENT_TYPE_INSTANT), 20));
+  EXPECT_TRUE(buffer.Record(1, MakeEvent(5, PW_TRACE_EVENT_TYPE_INSTANT), 15));
+  EXPECT_EQ(buffer.EntryCount(), 5u);
+
+  std::array<std::byte, 128> output;
+  stream::MemoryWriter writer(output);
+  ASSERT_EQ(buffer.Drain(writer), OkStatus());
+  EXPECT_EQ(buffer.EntryCount(), 0u);
+
+  ConstByteSpan data = writer.WrittenData();
+  constexpr struct {
+    uint32_t token;
+    uint64_t delta;
+  } kExpected[] = {{3, 0}, {1, 5}, {2, 2}, {5, 3}, {4, 5}};
+  for (const auto& expected : kExpected) {
+    DecodedEntry entry = DecodeEntry(data, false);
+    EXPECT_EQ(entry.trace_token, expected.token);
+    EXPECT_EQ(entry.time_delta, expected.delta);
+    EXPECT_TRUE(entry.data.empty());
+  }
+  EXPECT_TRUE(data.empty());
+}
+
+TEST(PerCoreTraceBuffer, EncodesTraceIdAndData) {
+  PerCoreTraceBuffer<2, 2> buffer;
+  constexpr char kData[] = "data";
+  EXPECT_TRUE(
+      buffer.Record(1,
+                    MakeEvent(7, PW_TRACE_EVENT_TYPE_ASYNC_START, 300),
+                    1));
+  EXPECT_TRUE(buffer.Record(
+      0,
+      MakeEvent(8, PW_TRACE_EVENT_TYPE_INSTANT, 0, kData, sizeof(kData)),
+      2));
+
+  std::array<std::byte, 128> output;
+  stream::MemoryWriter writer(output);
+  ASSERT_EQ(buffer.Drain(writer), OkStatus());
+
+  ConstByteSpan data = writer.WrittenData();
+  DecodedEntry first = DecodeEntry(data, true);
+  EXPECT_EQ(first.trace_token, 7u);
+  EXPECT_EQ(first.trace_id, 300u);
+  EXPECT_TRUE(first.data.empty());
+
+  DecodedEntry second = DecodeEntry(data, false);
+  EXPECT_EQ(second.trace_token, 8u);
+  EXPECT_EQ(second.time_delta, 1u);
+  ASSERT_EQ(second.data.size(), sizeof(kData));
+  EXPECT_EQ(std::memcmp(second.data.data(), kData, sizeof(kData)), 0);
+  EXPECT_TRUE(data.empty());
+}
+
+TEST(PerCoreTraceBuffer, DropsEventsWhenLaneIsFull) {
+  PerCoreTraceBuffer<2, 2> buffer;
+  EXPECT_TRUE(buffer.Record(0, MakeEvent(1, PW_TRACE_EVENT_TYPE_INSTANT), 1));
+  EXPECT_TRUE(buffer.Record(0, MakeEvent(2, PW_TRACE_EVENT_TYPE_INSTANT), 2));
+  EXPECT_FALSE(buffer.Record(0, MakeEvent(3, PW_TRACE_EVENT_TYPE_INSTANT), 3));
+
+  // Other lanes are unaffected.
+  EXPECT_TRUE(buffer.Record(1, MakeEvent(4, PW_TRACE_EVENT_TYPE_INSTANT), 4));
+  EXPECT_EQ(buffer.EntryCount(), 3u);
+  EXPECT_EQ(buffer.dropped(), 1u);
+
+  // Draining frees space in the lane.
+  std::array<std::byte, 128> output;
+  stream::MemoryWriter writer(output);
+  ASSERT_EQ(buffer.Drain(writer), OkStatus());
+  EXPECT_TRUE(buffer.Record(0, MakeEvent(5, PW_TRACE_EVENT_TYPE_INSTANT), 5));
+}
+
+TEST(PerCoreTraceBuffer, DropsInvalidEvents) {
+  PerCoreTraceBuffer<2, 2> buffer;
+  EXPECT_FALSE(buffer.Record(2, MakeEvent(1, PW_TRACE_EVENT_TYPE_INSTANT), 1));
+
+  std::array<std::byte, PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES + 1> too_large{};
+  EXPECT_FALSE(buffer.Record(
+      0,
+      MakeEvent(
+          2, PW_TRACE_EVENT_TYPE_INSTANT, 0, too_large.data(), too_large.size()),
+      2));
+
+  EXPECT_EQ(buffer.EntryCount(), 0u);
+  EXPECT_EQ(buffer.dropped(), 2u);
+}
+
+TEST(PerCoreTraceBuffer, FailedWriteKeepsEvent) {
+  PerCoreTraceBuffer<1, 2> buffer;
+  EXPECT_TRUE(buffer.Record(0, MakeEvent(1, PW_TRACE_EVENT_TYPE_INSTANT), 1));
+  EXPECT_TRUE(buffer.Record(0, MakeEvent(2, PW_TRACE_EVENT_TYPE_INSTANT), 2));
+
+  // Room for the first entry (1 byte size, 4 byte token, 1 byte delta) only.
+  std::array<std::byte, 6> output;
+  stream::MemoryWriter writer(output);
+  EXPECT_EQ(buffer.Drain(writer), Status::OutOfRange());
+  EXPECT_EQ(writer.bytes_written(), 6u);
+  EXPECT_EQ(buffer.EntryCount(), 1u);
+}
+
+TEST(PerCoreTraceBuffer, Clear) {
+  PerCoreTraceBuffer<2, 2> buffer;
+  EXPECT_TRUE(buffer.Record(0, MakeEvent(1, PW_TRACE_EVENT_TYPE_INSTANT), 1));
+  EXPECT_TRUE(buffer.Record(1, MakeEvent(2, PW_TRACE_EVENT_TYPE_INSTANT), 2));
+  buffer.Clear();
+  EXPECT_EQ(buffer.EntryCount(), 0u);
+
+  std::array<std::byte, 16> output;
+  stream::MemoryWriter writer(output);
+  EXPECT_EQ(buffer.Drain(writer), OkStatus());
+  EXPECT_EQ(writer.bytes_written(), 0u);
+}
+
+size_t current_lane = 0;
+size_t GetCurrentLane() { return current_lane; }
+
+size_t sink_calls = 0;
+void CountSinkCalls(void*, size_t) { ++sink_calls; }
+
+TEST(PerCoreTraceBuffer, RecordsEventsFromTracer) {
+  Callbacks callbacks{};
+  TokenizedTracer tracer(callbacks);
+  PerCoreTraceBuffer<2, 4> buffer;
+  ASSERT_EQ(buffer.RegisterWith(callbacks, GetCurrentLane), OkStatus());
+  ASSERT_EQ(callbacks.RegisterSink(CountSinkCalls, nullptr, nullptr),
+            OkStatus());
+  sink_calls = 0;
+
+  // Events are only recorded while tracing is enabled.
+  tracer.HandleTraceEvent(
+      1, PW_TRACE_EVENT_TYPE_INSTANT, "TST", 0, 0, nullptr, 0);
+  EXPECT_EQ(buffer.EntryCount(), 0u);
+
+  tracer.Enable(true);
+  current_lane = 1;
+  tracer.HandleTraceEvent(
+      2, PW_TRACE_EVENT_TYPE_INSTANT, "TST", 0, 0, nullptr, 0);
+  current_lane = 0;
+  tracer.HandleTraceEvent(
+      3, PW_TRACE_EVENT_TYPE_INSTANT, "TST", 0, 0, nullptr, 0);
+  EXPECT_EQ(buffer.EntryCount(), 2u);
+
+  // The events bypass the tracer's queue and sinks.
+  EXPECT_EQ(sink_calls, 0u);
+
+  std::array<std::byte, 64> output;
+  stream::MemoryWriter writer(output);
+  ASSERT_EQ(buffer.Drain(writer), OkStatus());
+  ConstByteSpan data = writer.WrittenData();
+  EXPECT_EQ(DecodeEntry(data, false).trace_token, 2u);
+  EXPECT_EQ(DecodeEntry(data, false).trace_token, 3u);
+  EXPECT_TRUE(data.empty());
+}
+
+}  // namespace
+}  // namespace pw::trace
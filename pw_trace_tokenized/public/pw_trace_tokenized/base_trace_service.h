@@ -18,6 +18,7 @@
 
 #include "pw_status/status.h"
 #include "pw_stream/stream.h"
+#include "pw_trace_tokenized/per_core_trace_buffer.h"
 #include "pw_trace_tokenized/trace_tokenized.h"
 
 namespace pw::trace {
@@ -26,18 +27,44 @@ class BaseTraceService {
   BaseTraceService(TokenizedTracer& tokenized_tracer,
                    stream::Writer& trace_writer);
 
+  // Reads trace data from a per-core trace buffer, merging its lanes, instead
+  // of from the global trace buffer.
+  BaseTraceService(TokenizedTracer& tokenized_tracer,
+                   PerCoreTraceBufferBase& per_core_buffer,
+                   stream::Writer& trace_writer);
+
   void SetTransferId(uint32_t id) { transfer_id_ = id; }
 
+  // Writes the trace data recorded so far to the trace writer while a
+  // streaming trace is running, as much as the writer accepts. Call this
+  // periodically, for example from a work queue, to stream captures that are
+  // longer than the trace buffer. Must not be called concurrently with Stop.
+  //
+  // Returns FAILED_PRECONDITION if a streaming trace is not running, or the
+  // writer's status if a write failed.
+  Status Flush();
+
  protected:
-  Status Start();
+  // Starts tracing. If streaming is true, trace data is written to the trace
+  // writer by Flush() while tracing runs, and new events are dropped while the
+  // trace buffer is full. Otherwise, the trace buffer is written on Stop.
+  Status Start(bool streaming = false);
   Status Stop();
 
  private:
+  Status StopPerCore();
+  Status StopStreaming();
+
   TokenizedTracer& tokenized_tracer_;
   stream::Writer& trace_writer_;
+  PerCoreTraceBufferBase* per_core_buffer_ = nullptr;
+  bool streaming_ = false;
 
  protected:
   std::optional<uint32_t> transfer_id_;
+
+  // Number of events dropped during the last streaming trace.
+  uint32_t dropped_events_ = 0;
 };
 
 }  // namespace pw::trace
@@ -28,6 +28,23 @@
 #define PW_TRACE_QUEUE_SIZE_EVENTS 5
 #endif  // PW_TRACE_QUEUE_SIZE_EVENTS
 
+// PW_TRACE_CONFIG_COMPACT_RECORDS selects the compact record encoding, which
+// starts each record with a bitfield byte. Small time deltas are stored in that
+// byte, and a token that was used in one of the previous few records is stored
+// as a reference to it. Decoders must be told which encoding is in use, for
+// example with --compact for the Python decoder.
+#ifndef PW_TRACE_CONFIG_COMPACT_RECORDS
+#define PW_TRACE_CONFIG_COMPACT_RECORDS 0
+#endif  // PW_TRACE_CONFIG_COMPACT_RECORDS
+
+// PW_TRACE_CONFIG_COMPILED_CATEGORIES is the mask of the trace categories whose
+// events are compiled in. Events from source files with a PW_TRACE_CATEGORY
+// that is not in the mask are removed at compile time. By default, all
+// categories are compiled in.
+#ifndef PW_TRACE_CONFIG_COMPILED_CATEGORIES
+#define PW_TRACE_CONFIG_COMPILED_CATEGORIES 0xffffffffu
+#endif  // PW_TRACE_CONFIG_COMPILED_CATEGORIES
+
 // --- Config options for time source ----
 
 // PW_TRACE_TIME_TYPE sets the type for trace time.
@@ -129,7 +146,8 @@ static_assert(
 
 #ifndef PW_TRACE_BUFFER_MAX_HEADER_SIZE_BYTES
 #define PW_TRACE_BUFFER_MAX_HEADER_SIZE_BYTES                                  \
-  (pw::varint::kMaxVarint64SizeBytes) +     /* worst case delta time varint */ \
+  (PW_TRACE_CONFIG_COMPACT_RECORDS ? 1 : 0) + /* compact record bitfield */    \
+      (pw::varint::kMaxVarint64SizeBytes) + /* worst case delta time varint */ \
       (sizeof(uint32_t)) +                  /* trace token size */             \
       (pw::varint::kMaxVarint64SizeBytes) + /* worst case trace id varint */
 #endif  // PW_TRACE_BUFFER_MAX_HEADER_SIZE_BYTES
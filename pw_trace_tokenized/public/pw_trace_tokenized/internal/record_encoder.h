@@ -0,0 +1,125 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// This file provides the encoder for the header of each tokenized trace record.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_span/span.h"
+#include "pw_trace_tokenized/config.h"
+#include "pw_varint/varint.h"
+
+namespace pw::trace::internal {
+
+// Encodes the header of each trace record, which is followed by the record's
+// data. The standard header is:
+//
+//   token (4 bytes) | time delta (varint) | [trace ID (varint)]
+//
+// The compact header starts with a bitfield byte:
+//
+//   bits 0-2: 0 if the token follows, or N if the token is the same as the
+//             token of the record N records earlier.
+//   bits 3-7: the time delta if it is less than kVarintDelta, otherwise
+//             kVarintDelta to indicate the delta follows as a varint.
+//
+// followed by: [token (4 bytes)] | [time delta (varint)] | [trace ID (varint)]
+//
+// Tracing a short loop therefore takes one header byte per record instead of
+// five or more. Since token references are relative to the preceding records,
+// a decoder that starts partway through the records, such as after the oldest
+// records were overwritten in a ring buffer, loses at most kTokenHistory
+// records. Every sink must store either all records or none of them.
+template <bool kCompact>
+class RecordEncoder {
+ public:
+  static constexpr size_t kTokenHistory = 7;
+  static constexpr uint32_t kVarintDelta = 31;
+
+  static constexpr size_t kMaxHeaderSizeBytes =
+      (kCompact ? 1 : 0) + sizeof(uint32_t) + varint::kMaxVarint64SizeBytes +
+      varint::kMaxVarint64SizeBytes;
+
+  // Forgets the preceding tokens, so that the next record is self-contained.
+  void Reset() { history_size_ = 0; }
+
+  // Encodes a record header to the provided buffer, which must be at least
+  // kMaxHeaderSizeBytes. Returns the number of bytes written.
+  size_t EncodeHeader(uint32_t trace_token,
+                      PW_TRACE_TIME_TYPE time_delta,
+                      bool has_trace_id,
+                      uint32_t trace_id,
+                      span<std::byte> header) {
+    size_t size = 0;
+    if constexpr (kCompact) {
+      const size_t token_ref = FindToken(trace_token);
+      const uint32_t inline_delta =
+          time_delta < kVarintDelta ? static_cast<uint32_t>(time_delta)
+                                    : kVarintDelta;
+      header[size++] = static_cast<std::byte>(token_ref | (inline_delta << 3));
+      if (token_ref == 0) {
+        size += EncodeToken(trace_token, header.subspan(size));
+      }
+      if (inline_delta == kVarintDelta) {
+        size += varint::Encode(time_delta, header.subspan(size));
+      }
+      AddToHistory(trace_token);
+    } else {
+      size += EncodeToken(trace_token, header);
+      size += varint::Encode(time_delta, header.subspan(size));
+    }
+    if (has_trace_id) {
+      size += varint::Encode(trace_id, header.subspan(size));
+    }
+    return size;
+  }
+
+ private:
+  static size_t EncodeToken(uint32_t trace_token, span<std::byte> header) {
+    std::memcpy(header.data(), &trace_token, sizeof(trace_token));
+    return sizeof(trace_token);
+  }
+
+  // Returns how many records ago the token was last used, or 0 if it was not
+  // used in the last kTokenHistory records.
+  size_t FindToken(uint32_t trace_token) const {
+    for (size_t i = 1; i <= history_size_; ++i) {
+      if (history_[(next_ + kTokenHistory - i) % kTokenHistory] ==
+          trace_token) {
+        return i;
+      }
+    }
+    return 0;
+  }
+
+  void AddToHistory(uint32_t trace_token) {
+    history_[next_] = trace_token;
+    next_ = (next_ + 1) % kTokenHistory;
+    if (history_size_ < kTokenHistory) {
+      history_size_ += 1;
+    }
+  }
+
+  std::array<uint32_t, kTokenHistory> history_{};
+  size_t next_ = 0;
+  size_t history_size_ = 0;
+};
+
+}  // namespace pw::trace::internal
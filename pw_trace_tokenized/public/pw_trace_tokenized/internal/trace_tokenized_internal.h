@@ -48,6 +48,16 @@
 #define PW_TRACE_TYPE_ASYNC_INSTANT PW_TRACE_EVENT_TYPE_ASYNC_STEP
 #define PW_TRACE_TYPE_ASYNC_END PW_TRACE_EVENT_TYPE_ASYNC_END
 
+// The trace category of the events in a source file, which is a bit mask with
+// one bit set. Like PW_TRACE_MODULE_NAME, this can be defined before including
+// pw_trace/trace.h. Events are only compiled in if their category is in
+// PW_TRACE_CONFIG_COMPILED_CATEGORIES, and are only passed to the tracer if
+// their category is enabled with PW_TRACE_SET_ENABLED_CATEGORIES.
+#define PW_TRACE_CATEGORY_DEFAULT (1u << 0)
+#ifndef PW_TRACE_CATEGORY
+#define PW_TRACE_CATEGORY PW_TRACE_CATEGORY_DEFAULT
+#endif  // PW_TRACE_CATEGORY
+
 PW_EXTERN_C_START
 
 typedef enum {
@@ -88,32 +98,56 @@ void pw_trace_Enable(bool enabled);
 // Returns true if tracing is currently enabled.
 bool pw_trace_IsEnabled(void);
 
+// This should not be called directly, instead use:
+// PW_TRACE_SET_ENABLED_CATEGORIES
+void pw_trace_SetEnabledCategories(uint32_t categories);
+
+// Returns the mask of the trace categories that are enabled at runtime.
+uint32_t pw_trace_EnabledCategories(void);
+
+// The mask of the categories whose events are passed to pw_trace_TraceEvent.
+// This is 0 while tracing is disabled and no event callback is registered to be
+// called on every event, so that disabled trace events cost a load and a branch
+// rather than a call. Do not modify directly.
+extern uint32_t _pw_trace_tokenized_gate;
+
 PW_EXTERN_C_END
 
+// True if events of the current PW_TRACE_CATEGORY are compiled in and should
+// be passed to the tracer. The first term is constant, so events of categories
+// that are not compiled in are removed entirely.
+#define _PW_TRACE_TOKENIZED_CATEGORY_ACTIVE()                              \
+  (((PW_TRACE_CATEGORY) & (PW_TRACE_CONFIG_COMPILED_CATEGORIES)) != 0u && \
+   __builtin_expect((_pw_trace_tokenized_gate & (PW_TRACE_CATEGORY)) != 0u, 0))
+
 // These are what the facade actually calls.
-#define PW_TRACE(event_type, flags, label, group, trace_id)                  \
-  do {                                                                       \
-    static const uint32_t kLabelToken =                                      \
-        PW_TRACE_REF(event_type, PW_TRACE_MODULE_NAME, label, flags, group); \
-    pw_trace_TraceEvent(kLabelToken,                                         \
-                        event_type,                                          \
-                        PW_TRACE_MODULE_NAME,                                \
-                        trace_id,                                            \
-                        flags,                                               \
-                        NULL,                                                \
-                        0);                                                  \
+#define PW_TRACE(event_type, flags, label, group, trace_id)                    \
+  do {                                                                         \
+    if (_PW_TRACE_TOKENIZED_CATEGORY_ACTIVE()) {                               \
+      static const uint32_t kLabelToken =                                      \
+          PW_TRACE_REF(event_type, PW_TRACE_MODULE_NAME, label, flags, group); \
+      pw_trace_TraceEvent(kLabelToken,                                         \
+                          event_type,                                          \
+                          PW_TRACE_MODULE_NAME,                                \
+                          trace_id,                                            \
+                          flags,                                               \
+                          NULL,                                                \
+                          0);                                                  \
+    }                                                                          \
   } while (0)
 
-#define PW_TRACE_DATA(                                                \
-    event_type, flags, label, group, trace_id, type, data, size)      \
-  do {                                                                \
-    static const uint32_t kLabelToken = PW_TRACE_REF_DATA(            \
-        event_type, PW_TRACE_MODULE_NAME, label, flags, group, type); \
-    pw_trace_TraceEvent(kLabelToken,                                  \
-                        event_type,                                   \
-                        PW_TRACE_MODULE_NAME,                         \
-                        trace_id,                                     \
-                        flags,                                        \
-                        data,                                         \
-                        size);                                        \
+#define PW_TRACE_DATA(                                                  \
+    event_type, flags, label, group, trace_id, type, data, size)        \
+  do {                                                                  \
+    if (_PW_TRACE_TOKENIZED_CATEGORY_ACTIVE()) {                        \
+      static const uint32_t kLabelToken = PW_TRACE_REF_DATA(            \
+          event_type, PW_TRACE_MODULE_NAME, label, flags, group, type); \
+      pw_trace_TraceEvent(kLabelToken,                                  \
+                          event_type,                                   \
+                          PW_TRACE_MODULE_NAME,                         \
+                          trace_id,                                     \
+                          flags,                                        \
+                          data,                                         \
+                          size);                                        \
+    }                                                                   \
   } while (0)
@@ -0,0 +1,168 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//==============================================================================
+//
+// The per-core trace buffer records trace events into one lock-free buffer per
+// core (or per thread), rather than funneling every event through the tracer's
+// queue and critical section. The buffers are merged by timestamp when they are
+// read out, producing the same encoding as the trace buffer in trace_buffer.h.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_stream/stream.h"
+#include "pw_trace_tokenized/config.h"
+#include "pw_trace_tokenized/trace_callback.h"
+#include "pw_trace_tokenized/trace_tokenized.h"
+
+namespace pw::trace {
+
+// Non-templated base of PerCoreTraceBuffer, which provides the storage.
+class PerCoreTraceBufferBase {
+ public:
+  // Returns the lane for the calling context, e.g. the current core's ID or a
+  // thread-local index. Must return a value less than the number of lanes;
+  // events from other lanes are dropped.
+  using GetLaneFunction = size_t (*)();
+
+  // A trace event as stored in a lane, with an absolute timestamp so that the
+  // lanes can be merged.
+  struct Event {
+    PW_TRACE_TIME_TYPE time;
+    uint32_t trace_token;
+    uint32_t trace_id;
+    EventType event_type;
+    size_t data_size;
+    std::byte data[PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES];
+  };
+
+  // A single-producer, single-consumer ring of events.
+  class Lane {
+   public:
+    constexpr Lane() = default;
+
+    Lane(const Lane&) = delete;
+    Lane& operator=(const Lane&) = delete;
+
+   private:
+    friend class PerCoreTraceBufferBase;
+
+    // Both indices increase monotonically; the slot is the index modulo the
+    // lane's capacity.
+    std::atomic<size_t> head_ = 0;  // Next slot to write, set by the producer.
+    std::atomic<size_t> tail_ = 0;  // Next slot to read, set by the consumer.
+
+    // Set while an event is being recorded, so that a recording that
+    // interrupts another on the same lane drops its event instead of
+    // corrupting the lane.
+    std::atomic<bool> recording_ = false;
+  };
+
+  PerCoreTraceBufferBase(const PerCoreTraceBufferBase&) = delete;
+  PerCoreTraceBufferBase& operator=(const PerCoreTraceBufferBase&) = delete;
+
+  size_t lanes() const { return lanes_.size(); }
+
+  // Records an event in the provided lane. This never blocks. Returns false if
+  // the event was dropped because the lane is full or busy, the lane does not
+  // exist, or the data is larger than PW_TRACE_BUFFER_MAX_DATA_SIZE_BYTES.
+  //
+  // Each lane may have only one producer at a time. A producer that interrupts
+  // another on the same lane (e.g. an interrupt handler on the same core) has
+  // its event dropped.
+  bool Record(size_t lane,
+              const pw_trace_tokenized_TraceEvent& event,
+              PW_TRACE_TIME_TYPE time);
+
+  // Registers an event callback which records every enabled trace event into
+  // the lane returned by get_lane, and tells the tracer to skip its own queue
+  // and sinks. The tracer still calls the other event callbacks, but their
+  // SKIP_EVENT flags do not stop the event from being recorded here.
+  Status RegisterWith(Callbacks& callbacks, GetLaneFunction get_lane);
+
+  // Writes the events from all lanes to the writer, merged in timestamp order,
+  // and removes them from the lanes. Each event is written as a varint size
+  // prefix followed by the entry, encoded as the tokenized tracer encodes it,
+  // so the output has the same format as DeringAndViewRawBuffer(). The first
+  // event written has a time delta of 0.
+  //
+  // Timestamps are compared directly, so they must not wrap while events are
+  // buffered. Drain may run concurrently with producers; events recorded
+  // during the drain may be written or left for the next drain.
+  //
+  // Returns the writer's status if a write fails. The event that failed to be
+  // written remains in its lane.
+  Status Drain(stream::Writer& writer);
+
+  // Returns the number of events currently buffered in all lanes.
+  size_t EntryCount() const;
+
+  // Returns the number of events dropped since construction.
+  size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  // Discards all buffered events. Must only be called from the consumer.
+  void Clear();
+
+ protected:
+  PerCoreTraceBufferBase(span<Lane> lanes, span<Event> events)
+      : lanes_(lanes),
+        events_(events),
+        events_per_lane_(events.size() / lanes.size()) {}
+
+ private:
+  static pw_trace_TraceEventReturnFlags RecordCallback(
+      void* user_data, pw_trace_tokenized_TraceEvent* event);
+
+  Event& Slot(size_t lane, size_t index) {
+    return events_[lane * events_per_lane_ + index % events_per_lane_];
+  }
+
+  span<Lane> lanes_;
+  span<Event> events_;
+  size_t events_per_lane_;
+  GetLaneFunction get_lane_ = nullptr;
+  std::atomic<size_t> dropped_ = 0;
+};
+
+// Trace buffer with kLanes lock-free lanes, each of which holds up to
+// kEventsPerLane events.
+//
+// Example:
+//
+//   size_t GetCurrentCore() { return ...; }
+//
+//   pw::trace::PerCoreTraceBuffer<kNumCores, 64> trace_buffer;
+//   trace_buffer.RegisterWith(pw::trace::GetCallbacks(), GetCurrentCore);
+//
+template <size_t kLanes, size_t kEventsPerLane>
+class PerCoreTraceBuffer final : public PerCoreTraceBufferBase {
+ public:
+  static_assert(kLanes > 0u);
+  static_assert(kEventsPerLane > 0u);
+
+  PerCoreTraceBuffer()
+      : PerCoreTraceBufferBase(lane_storage_, event_storage_) {}
+
+ private:
+  std::array<Lane, kLanes> lane_storage_;
+  std::array<Event, kLanes * kEventsPerLane> event_storage_;
+};
+
+}  // namespace pw::trace
@@ -18,6 +18,8 @@
 
 #include "pw_bytes/span.h"
 #include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
 #include "pw_trace_tokenized/config.h"
 #include "pw_trace_tokenized/trace_tokenized.h"
 #include "pw_varint/varint.h"
@@ -38,5 +40,30 @@ pw::ring_buffer::PrefixedEntryRingBuffer* GetBuffer();
 // when calling this function.
 ConstByteSpan DeringAndViewRawBuffer();
 
+// Selects what happens to a new trace event when the buffer is full. By
+// default the oldest events are overwritten, which suits reading the buffer
+// after tracing stops. In streaming mode the new event is dropped instead and
+// counted, so that a reader draining the buffer with DrainBuffer() while
+// tracing never silently misses events.
+void SetStreamingMode(bool streaming);
+
+// Returns the number of events dropped in streaming mode since the buffer was
+// last cleared.
+size_t GetDroppedEventCount();
+
+// Moves whole entries from the front of the buffer to the writer while tracing
+// continues. The entries are written in the same format as
+// DeringAndViewRawBuffer(). No more than the writer's ConservativeWriteLimit()
+// is written, so entries stay in the buffer while the writer is backed up.
+//
+// Entries are copied out of the buffer under PW_TRACE_LOCK(), which must be
+// configured if events can be traced concurrently with the drain. The writer is
+// called without holding the lock.
+//
+// Returns the number of bytes written, with OK if the buffer was drained or
+// the writer is full, or with the writer's status if a write failed. Entries
+// that failed to be written are lost.
+StatusWithSize DrainBuffer(stream::Writer& writer);
+
 }  // namespace trace
 }  // namespace pw
@@ -24,6 +24,10 @@ class TraceService final
  public:
   TraceService(TokenizedTracer& tokenized_tracer, stream::Writer& trace_writer);
 
+  TraceService(TokenizedTracer& tokenized_tracer,
+               PerCoreTraceBufferBase& per_core_buffer,
+               stream::Writer& trace_writer);
+
   Status Start(const proto::pwpb::StartRequest::Message& request,
                proto::pwpb::StartResponse::Message& response);
 
@@ -34,6 +34,8 @@
 #include "pw_trace_tokenized/internal/trace_tokenized_internal.h"
 
 #ifdef __cplusplus
+#include "pw_trace_tokenized/internal/record_encoder.h"
+
 namespace pw {
 namespace trace {
 
@@ -41,6 +43,10 @@ using EventType = pw_trace_EventType;
 
 namespace internal {
 
+// Recomputes _pw_trace_tokenized_gate from the state of the global tracer and
+// callbacks. Called whenever that state changes.
+void UpdateTraceGate();
+
 // Simple ring buffer which is suitable for use in a critical section.
 template <size_t kSize>
 class TraceQueue {
@@ -125,8 +131,10 @@ class TokenizedTracer {
   void Enable(bool enable) {
     if (enable != enabled_ && enable) {
       event_queue_.Clear();
+      record_encoder_.Reset();
     }
     enabled_ = enable;
+    internal::UpdateTraceGate();
   }
   bool IsEnabled() const { return enabled_; }
 
@@ -143,6 +151,7 @@ class TokenizedTracer {
   PW_TRACE_TIME_TYPE last_trace_time_ = 0;
   bool enabled_ = false;
   TraceQueue event_queue_;
+  internal::RecordEncoder<PW_TRACE_CONFIG_COMPACT_RECORDS> record_encoder_;
   Callbacks& callbacks_;
 
   void HandleNextItemInQueue(
@@ -159,6 +168,16 @@ TokenizedTracer& GetTokenizedTracer();
 // PW_TRACE_SET_ENABLED is used to enable or disable tracing.
 #define PW_TRACE_SET_ENABLED(enabled) pw_trace_Enable(enabled)
 
+// PW_TRACE_SET_ENABLED_CATEGORIES sets the mask of the trace categories whose
+// events are traced while tracing is enabled. By default, all categories are
+// enabled. Events of disabled categories are not passed to event callbacks.
+//
+// For example, to only trace events from files with PW_TRACE_CATEGORY set to
+// kRadioCategory:
+//   PW_TRACE_SET_ENABLED_CATEGORIES(kRadioCategory);
+#define PW_TRACE_SET_ENABLED_CATEGORIES(categories) \
+  pw_trace_SetEnabledCategories(categories)
+
 // PW_TRACE_REF provides the uint32_t token value for a specific trace event.
 // this can be used in the callback to perform specific actions for that trace.
 // All the fields must match exactly to generate the correct trace reference.
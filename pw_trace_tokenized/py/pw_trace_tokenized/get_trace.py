@@ -188,6 +188,14 @@ def _parse_args():
         default=0,
         help=('Time offset (us) of the trace events (Default 0).'),
     )
+    parser.add_argument(
+        '--compact',
+        action='store_true',
+        help=(
+            'Decode compact records, from a device built with '
+            'PW_TRACE_CONFIG_COMPACT_RECORDS.'
+        ),
+    )
     return parser.parse_args()
 
 
@@ -199,7 +207,11 @@ def _main(args):
     client = get_hdlc_rpc_client(**vars(args))
     data = get_trace_data_from_device(client)
     events = trace_tokenized.get_trace_events(
-        [token_database], data, args.ticks_per_second, args.time_offset
+        [token_database],
+        data,
+        args.ticks_per_second,
+        args.time_offset,
+        args.compact,
     )
     json_lines = trace.generate_trace_json(events)
     trace_tokenized.save_trace_file(json_lines, args.trace_output_file)
@@ -22,6 +22,7 @@ out/pw_strict_host_clang_debug/obj/pw_trace_tokenized/bin/trace_tokenized_exampl
 """  # pylint: disable=line-too-long
 # pylint: enable=line-too-long
 
+from collections import deque
 from enum import IntEnum
 import argparse
 import logging
@@ -32,6 +33,13 @@ from pw_trace import trace
 
 _LOG = logging.getLogger('pw_trace_tokenizer')
 
+# Compact records (PW_TRACE_CONFIG_COMPACT_RECORDS) start with a bitfield byte.
+# Bits 0-2 are 0 if the token follows, or N if the token is that of the record
+# N records earlier. Bits 3-7 are the time delta, or _COMPACT_VARINT_DELTA if
+# the delta follows as a varint.
+_COMPACT_TOKEN_HISTORY = 7
+_COMPACT_VARINT_DELTA = 31
+
 
 def varint_decode(encoded):
     # Taken from pw_tokenizer.decode._decode_signed_integer
@@ -110,13 +118,48 @@ def create_trace_event(token_string, timestamp_us, trace_id, data):
     )
 
 
-def parse_trace_event(buffer, db, last_time, ticks_per_second):
-    """Parse a single trace event from bytes"""
+def parse_trace_event(
+    buffer, db, last_time, ticks_per_second, recent_tokens=None
+):
+    """Parse a single trace event from bytes.
+
+    recent_tokens must be provided to parse compact records. It holds the
+    tokens of the preceding records, and this record's token is appended.
+    """
     us_per_tick = 1000000 / ticks_per_second
     idx = 0
-    # Read token
-    token = struct.unpack('I', buffer[idx : idx + 4])[0]
-    idx += 4
+    if recent_tokens is None:
+        # Read token
+        token = struct.unpack('I', buffer[idx : idx + 4])[0]
+        idx += 4
+
+        # Read time
+        time_delta, time_bytes = varint_decode(buffer[idx:])
+        idx += time_bytes
+    else:
+        header = buffer[idx]
+        idx += 1
+        token_ref = header & 0x07
+        time_delta = header >> 3
+
+        # Read or look up token
+        if token_ref == 0:
+            token = struct.unpack('I', buffer[idx : idx + 4])[0]
+            idx += 4
+        elif token_ref <= len(recent_tokens):
+            token = recent_tokens[-token_ref]
+        else:
+            token = None
+        recent_tokens.append(token)
+
+        # Read time
+        if time_delta == _COMPACT_VARINT_DELTA:
+            time_delta, time_bytes = varint_decode(buffer[idx:])
+            idx += time_bytes
+
+        if token is None:
+            _LOG.error("token refers to a record before the start of the trace")
+            return None
 
     # Decode token
     if len(db.token_to_entries[token]) == 0:
@@ -125,10 +168,7 @@ def parse_trace_event(buffer, db, last_time, ticks_per_second):
 
     token_string = str(db.token_to_entries[token][0])
 
-    # Read time
-    time_delta, time_bytes = varint_decode(buffer[idx:])
     timestamp_us = last_time + us_per_tick * time_delta
-    idx += time_bytes
 
     # Trace ID
     trace_id = None
@@ -146,11 +186,19 @@ def parse_trace_event(buffer, db, last_time, ticks_per_second):
 
 
 def get_trace_events(
-    databases, raw_trace_data, ticks_per_second, time_offset: int
+    databases,
+    raw_trace_data,
+    ticks_per_second,
+    time_offset: int,
+    compact: bool = False,
 ):
-    """Handles the decoding traces."""
+    """Handles the decoding traces.
+
+    Set compact if the device was built with PW_TRACE_CONFIG_COMPACT_RECORDS.
+    """
 
     db = tokens.Database.merged(*databases)
+    recent_tokens = deque(maxlen=_COMPACT_TOKEN_HISTORY) if compact else None
     last_timestamp = time_offset
     events = []
     idx = 0
@@ -167,6 +215,7 @@ def get_trace_events(
             db,
             last_timestamp,
             ticks_per_second,
+            recent_tokens,
         )
         if event:
             last_timestamp = event.timestamp_us
@@ -192,12 +241,16 @@ def save_trace_file(trace_lines, file_name):
 
 
 def get_trace_events_from_file(
-    databases, input_file_name, ticks_per_second, time_offset: int
+    databases,
+    input_file_name,
+    ticks_per_second,
+    time_offset: int,
+    compact: bool = False,
 ):
     """Get trace events from a file."""
     raw_trace_data = get_trace_data_from_file(input_file_name)
     return get_trace_events(
-        databases, raw_trace_data, ticks_per_second, time_offset
+        databases, raw_trace_data, ticks_per_second, time_offset, compact
     )
 
 
@@ -241,13 +294,25 @@ def _parse_args():
         default=0,
         help=('Time offset (us) of the trace events (Default 0).'),
     )
+    parser.add_argument(
+        '--compact',
+        action='store_true',
+        help=(
+            'Decode compact records, from a device built with '
+            'PW_TRACE_CONFIG_COMPACT_RECORDS.'
+        ),
+    )
 
     return parser.parse_args()
 
 
 def _main(args):
     events = get_trace_events_from_file(
-        args.databases, args.input_file, args.ticks_per_second, args.time_offset
+        args.databases,
+        args.input_file,
+        args.ticks_per_second,
+        args.time_offset,
+        args.compact,
     )
     json_lines = trace.generate_trace_json(events)
     save_trace_file(json_lines, args.output_file)
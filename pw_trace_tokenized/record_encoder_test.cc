@@ -0,0 +1,124 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_trace_tokenized/internal/record_encoder.h"
+
+#include <array>
+
+#include "pw_bytes/array.h"
+#include "pw_bytes/span.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::trace::internal {
+namespace {
+
+using StandardEncoder = RecordEncoder<false>;
+using CompactEncoder = RecordEncoder<true>;
+
+template <typename Encoder>
+class Header {
+ public:
+  Header(Encoder& encoder,
+         uint32_t trace_token,
+         PW_TRACE_TIME_TYPE time_delta,
+         bool has_trace_id = false,
+         uint32_t trace_id = 0)
+      : size_(encoder.EncodeHeader(
+            trace_token, time_delta, has_trace_id, trace_id, buffer_)) {}
+
+  ConstByteSpan bytes() const { return span(buffer_).first(size_); }
+
+ private:
+  std::array<std::byte, Encoder::kMaxHeaderSizeBytes> buffer_;
+  size_t size_;
+};
+
+template <typename Encoder>
+bool Equal(const Header<Encoder>& header, ConstByteSpan expected) {
+  return header.bytes().size() == expected.size() &&
+         std::equal(
+             expected.begin(), expected.end(), header.bytes().begin());
+}
+
+TEST(StandardRecordEncoder, TokenAndDelta) {
+  StandardEncoder encoder;
+  EXPECT_TRUE(Equal(Header(encoder, 0x12345678, 0),
+                    bytes::Array<0x78, 0x56, 0x34, 0x12, 0x00>()));
+  EXPECT_TRUE(Equal(Header(encoder, 0x12345678, 300),
+                    bytes::Array<0x78, 0x56, 0x34, 0x12, 0xac, 0x02>()));
+}
+
+TEST(StandardRecordEncoder, TraceId) {
+  StandardEncoder encoder;
+  EXPECT_TRUE(Equal(Header(encoder, 0x01020304, 1, true, 300),
+                    bytes::Array<0x04, 0x03, 0x02, 0x01, 0x01, 0xac, 0x02>()));
+}
+
+TEST(CompactRecordEncoder, NewTokenAndSmallDelta) {
+  CompactEncoder encoder;
+  EXPECT_TRUE(Equal(Header(encoder, 0x12345678, 5),
+                    bytes::Array<(5 << 3), 0x78, 0x56, 0x34, 0x12>()));
+}
+
+TEST(CompactRecordEncoder, LargeDeltaFollowsAsVarint) {
+  CompactEncoder encoder;
+  EXPECT_TRUE(Equal(Header(encoder, 0x12345678, 30),
+                    bytes::Array<(30 << 3), 0x78, 0x56, 0x34, 0x12>()));
+  EXPECT_TRUE(Equal(Header(encoder, 0x12345678, 31),
+                    bytes::Array<(31 << 3) | 1, 31>()));
+  EXPECT_TRUE(Equal(Header(encoder, 0x12345678, 300),
+                    bytes::Array<(31 << 3) | 1, 0xac, 0x02>()));
+}
+
+TEST(CompactRecordEncoder, RepeatedTokensAreReferenced) {
+  CompactEncoder encoder;
+  EXPECT_EQ(Header(encoder, 0xaaaaaaaa, 1).bytes().size(), 5u);
+  EXPECT_EQ(Header(encoder, 0xbbbbbbbb, 1).bytes().size(), 5u);
+
+  // 0xaaaaaaaa was used two records ago and 0xbbbbbbbb two records before
+  // this one.
+  EXPECT_TRUE(
+      Equal(Header(encoder, 0xaaaaaaaa, 2), bytes::Array<(2 << 3) | 2>()));
+  EXPECT_TRUE(
+      Equal(Header(encoder, 0xbbbbbbbb, 3), bytes::Array<(3 << 3) | 2>()));
+  EXPECT_TRUE(
+      Equal(Header(encoder, 0xbbbbbbbb, 4), bytes::Array<(4 << 3) | 1>()));
+}
+
+TEST(CompactRecordEncoder, TokensOutsideHistoryAreEncoded) {
+  CompactEncoder encoder;
+  EXPECT_EQ(Header(encoder, 0xaaaaaaaa, 0).bytes().size(), 5u);
+  for (uint32_t token = 1; token <= CompactEncoder::kTokenHistory; ++token) {
+    EXPECT_EQ(Header(encoder, token, 0).bytes().size(), 5u);
+  }
+  EXPECT_EQ(Header(encoder, 0xaaaaaaaa, 0).bytes().size(), 5u);
+}
+
+TEST(CompactRecordEncoder, ResetForgetsTokens) {
+  CompactEncoder encoder;
+  EXPECT_EQ(Header(encoder, 0xaaaaaaaa, 0).bytes().size(), 5u);
+  EXPECT_EQ(Header(encoder, 0xaaaaaaaa, 0).bytes().size(), 1u);
+  encoder.Reset();
+  EXPECT_EQ(Header(encoder, 0xaaaaaaaa, 0).bytes().size(), 5u);
+}
+
+TEST(CompactRecordEncoder, TraceIdFollows) {
+  CompactEncoder encoder;
+  EXPECT_EQ(Header(encoder, 0xaaaaaaaa, 0).bytes().size(), 5u);
+  EXPECT_TRUE(Equal(Header(encoder, 0xaaaaaaaa, 1, true, 300),
+                    bytes::Array<(1 << 3) | 1, 0xac, 0x02>()));
+}
+
+}  // namespace
+}  // namespace pw::trace::internal
@@ -19,7 +19,6 @@
 #include "pw_preprocessor/util.h"
 #include "pw_trace_tokenized/trace_callback.h"
 #include "pw_trace_tokenized/trace_tokenized.h"
-#include "pw_varint/varint.h"
 
 namespace pw {
 namespace trace {
@@ -32,6 +31,23 @@ Callbacks& GetCallbacks() {
 TokenizedTracer tokenized_tracer(GetCallbacks());
 TokenizedTracer& GetTokenizedTracer() { return tokenized_tracer; }
 
+namespace {
+
+uint32_t enabled_categories = 0xffffffffu;
+
+}  // namespace
+
+namespace internal {
+
+void UpdateTraceGate() {
+  const bool events_needed =
+      GetCallbacks().GetCalledOnEveryEventCount() != 0 ||
+      GetTokenizedTracer().IsEnabled();
+  _pw_trace_tokenized_gate = events_needed ? enabled_categories : 0u;
+}
+
+}  // namespace internal
+
 using TraceEvent = pw_trace_tokenized_TraceEvent;
 
 void TokenizedTracer::HandleTraceEvent(uint32_t trace_token,
@@ -105,6 +121,7 @@ void TokenizedTracer::HandleTraceEvent(uint32_t trace_token,
   // Disable after processing if an event callback had set the flag.
   if (PW_TRACE_EVENT_RETURN_FLAGS_DISABLE_AFTER_PROCESSING & ret_flags) {
     enabled_ = false;
+    internal::UpdateTraceGate();
   }
 }
 
@@ -120,11 +137,8 @@ void TokenizedTracer::HandleNextItemInQueue(
 
   // Create header to store trace info
   static constexpr size_t kMaxHeaderSize =
-      sizeof(trace_token) + pw::varint::kMaxVarint64SizeBytes +  // time
-      pw::varint::kMaxVarint64SizeBytes;                         // trace_id
+      decltype(record_encoder_)::kMaxHeaderSizeBytes;
   std::byte header[kMaxHeaderSize];
-  memcpy(header, &trace_token, sizeof(trace_token));
-  size_t header_size = sizeof(trace_token);
 
   // Compute delta of time elapsed since last trace entry.
   PW_TRACE_TIME_TYPE trace_time = pw_trace_GetTraceTime();
@@ -132,17 +146,14 @@ void TokenizedTracer::HandleNextItemInQueue(
       (last_trace_time_ == 0)
           ? 0
           : PW_TRACE_GET_TIME_DELTA(last_trace_time_, trace_time);
-  header_size += pw::varint::Encode(
-      delta,
-      span<std::byte>(&header[header_size], kMaxHeaderSize - header_size));
   last_trace_time_ = trace_time;
 
-  // Calculate packet id if needed.
-  if (PW_TRACE_HAS_TRACE_ID(event_type)) {
-    header_size += pw::varint::Encode(
-        trace_id,
-        span<std::byte>(&header[header_size], kMaxHeaderSize - header_size));
-  }
+  const size_t header_size =
+      record_encoder_.EncodeHeader(trace_token,
+                                   delta,
+                                   PW_TRACE_HAS_TRACE_ID(event_type),
+                                   trace_id,
+                                   header);
 
   // Send encoded output to any registered trace sinks.
   callbacks_.CallSinks(
@@ -257,6 +268,7 @@ pw::Status Callbacks::RegisterEventCallback(
       break;
     }
   }
+  internal::UpdateTraceGate();
   PW_TRACE_UNLOCK();
   return status;
 }
@@ -268,9 +280,10 @@ pw::Status Callbacks::UnregisterEventCallback(EventCallbackHandle handle) {
   }
   event_callbacks_[handle].callback = nullptr;
   event_callbacks_[handle].user_data = nullptr;
-  called_on_every_event_count_ +=
+  called_on_every_event_count_ -=
       event_callbacks_[handle].called_on_every_event ? 1 : 0;
   event_callbacks_[handle].called_on_every_event = kCallOnlyWhenEnabled;
+  internal::UpdateTraceGate();
   PW_TRACE_UNLOCK();
   return PW_STATUS_OK;
 }
@@ -295,10 +308,21 @@ Callbacks::EventCallbacks* Callbacks::GetEventCallback(
 
 PW_EXTERN_C_START
 
+uint32_t _pw_trace_tokenized_gate = 0;
+
 void pw_trace_Enable(bool enable) { GetTokenizedTracer().Enable(enable); }
 
 bool pw_trace_IsEnabled() { return GetTokenizedTracer().IsEnabled(); }
 
+void pw_trace_SetEnabledCategories(uint32_t categories) {
+  PW_TRACE_LOCK();
+  enabled_categories = categories;
+  internal::UpdateTraceGate();
+  PW_TRACE_UNLOCK();
+}
+
+uint32_t pw_trace_EnabledCategories() { return enabled_categories; }
+
 void pw_trace_TraceEvent(uint32_t trace_token,
                          pw_trace_EventType event_type,
                          const char* module,
@@ -15,6 +15,9 @@
 //
 #include "pw_trace_tokenized/trace_buffer.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
 #include "pw_span/span.h"
 #include "pw_trace_tokenized/trace_callback.h"
@@ -61,16 +64,66 @@ class TraceBuffer {
     if (buffer->block_idx_ != buffer->block_size_) {
       return;  // Block is too large, skipping.
     }
-    buffer->ring_buffer_
-        .PushBack(span<const std::byte>(&buffer->current_block_[0],
-                                        buffer->block_size_))
-        .IgnoreError();  // TODO: b/242598609 - Handle Status properly
+    const span<const std::byte> block(&buffer->current_block_[0],
+                                      buffer->block_size_);
+    if (!buffer->streaming_) {
+      buffer->ring_buffer_.PushBack(block)
+          .IgnoreError();  // TODO: b/242598609 - Handle Status properly
+    } else if (!buffer->ring_buffer_.TryPushBack(block).ok()) {
+      buffer->dropped_events_ += 1;
+    }
   }
 
   pw::ring_buffer::PrefixedEntryRingBuffer& RingBuffer() {
     return ring_buffer_;
   }
 
+  void Clear() {
+    ring_buffer_.Clear();
+    dropped_events_ = 0;
+  }
+
+  void SetStreamingMode(bool streaming) { streaming_ = streaming; }
+
+  size_t dropped_events() const { return dropped_events_; }
+
+  StatusWithSize Drain(stream::Writer& writer) {
+    // Room for at least one entry of the maximum size and its size prefix.
+    constexpr size_t kChunkSizeBytes =
+        2 * (varint::kMaxVarint32SizeBytes +
+             (PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES));
+    std::byte chunk[kChunkSizeBytes];
+    size_t total_written = 0;
+
+    while (true) {
+      const size_t max_bytes =
+          std::min(kChunkSizeBytes, writer.ConservativeWriteLimit());
+      size_t chunk_size = 0;
+
+      PW_TRACE_LOCK();
+      ring_buffer::PrefixedEntryRingBuffer::EntryRun run;
+      if (ring_buffer_.PeekFrontEntries(run, max_bytes).ok()) {
+        for (ConstByteSpan data : run.raw_data()) {
+          std::memcpy(&chunk[chunk_size], data.data(), data.size());
+          chunk_size += data.size();
+        }
+        ring_buffer_.PopFrontEntries(run)
+            .IgnoreError();  // Cannot fail while the lock is held.
+      }
+      PW_TRACE_UNLOCK();
+
+      // Stop when the buffer is empty or the writer cannot accept the next
+      // entry.
+      if (chunk_size == 0) {
+        return StatusWithSize(total_written);
+      }
+      if (Status status = writer.Write(chunk, chunk_size); !status.ok()) {
+        return StatusWithSize(status, total_written);
+      }
+      total_written += chunk_size;
+    }
+  }
+
   ConstByteSpan DeringAndViewRawBuffer() {
     ring_buffer_.Dering()
         .IgnoreError();  // TODO: b/242598609 - Handle Status properly
@@ -84,6 +137,8 @@ class TraceBuffer {
   std::byte current_block_[PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES];
   std::byte raw_buffer_[PW_TRACE_BUFFER_SIZE_BYTES];
   pw::ring_buffer::PrefixedEntryRingBuffer ring_buffer_{false};
+  bool streaming_ = false;
+  size_t dropped_events_ = 0;
 };
 
 #if PW_TRACE_BUFFER_SIZE_BYTES > 0
@@ -92,7 +147,7 @@ TraceBuffer trace_buffer_instance(GetCallbacks());
 
 }  // namespace
 
-void ClearBuffer() { trace_buffer_instance.RingBuffer().Clear(); }
+void ClearBuffer() { trace_buffer_instance.Clear(); }
 
 pw::ring_buffer::PrefixedEntryRingBuffer* GetBuffer() {
   return &trace_buffer_instance.RingBuffer();
@@ -102,5 +157,15 @@ ConstByteSpan DeringAndViewRawBuffer() {
   return trace_buffer_instance.DeringAndViewRawBuffer();
 }
 
+void SetStreamingMode(bool streaming) {
+  trace_buffer_instance.SetStreamingMode(streaming);
+}
+
+size_t GetDroppedEventCount() { return trace_buffer_instance.dropped_events(); }
+
+StatusWithSize DrainBuffer(stream::Writer& writer) {
+  return trace_buffer_instance.Drain(writer);
+}
+
 }  // namespace trace
 }  // namespace pw
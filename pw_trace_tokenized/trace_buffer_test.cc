@@ -16,6 +16,11 @@
 
 #include "pw_trace_tokenized/trace_buffer.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "pw_stream/memory_stream.h"
 #include "pw_trace/trace.h"
 #include "pw_unit_test/framework.h"
 
@@ -163,3 +168,80 @@ TEST(TokenizedTrace, DeringAndViewRawBuffer) {
   buf = pw::trace::DeringAndViewRawBuffer();
   EXPECT_GT(buf.size(), size_start);
 }
+
+TEST(TokenizedTrace, StreamingModeDropsNewEvents) {
+  PW_TRACE_SET_ENABLED(true);
+  pw::trace::ClearBuffer();
+  pw::trace::SetStreamingMode(true);
+  pw::ring_buffer::PrefixedEntryRingBuffer* buf = pw::trace::GetBuffer();
+
+  // Add samples until entry count stops increasing.
+  size_t count = 0;
+  size_t last_entry_count = 0;
+  while (buf->EntryCount() == 0 || buf->EntryCount() > last_entry_count) {
+    last_entry_count = buf->EntryCount();
+    PW_TRACE_INSTANT_DATA("Test", "count", &count, sizeof(count));
+    count++;
+  }
+  EXPECT_EQ(pw::trace::GetDroppedEventCount(), 1u);
+
+  // The oldest sample was kept.
+  std::byte value[PW_TRACE_BUFFER_MAX_BLOCK_SIZE_BYTES];
+  size_t bytes_read = 0;
+  ASSERT_EQ(buf->PeekFront(pw::span<std::byte>(value), &bytes_read),
+            pw::OkStatus());
+  size_t first_count;
+  memcpy(&first_count, &value[bytes_read - sizeof(size_t)], sizeof(size_t));
+  EXPECT_EQ(first_count, 0u);
+
+  pw::trace::SetStreamingMode(false);
+  pw::trace::ClearBuffer();
+  EXPECT_EQ(pw::trace::GetDroppedEventCount(), 0u);
+}
+
+TEST(TokenizedTrace, DrainBuffer) {
+  PW_TRACE_SET_ENABLED(true);
+  pw::trace::ClearBuffer();
+  pw::ring_buffer::PrefixedEntryRingBuffer* buf = pw::trace::GetBuffer();
+
+  PW_TRACE_INSTANT("Test");
+  PW_TRACE_INSTANT("Test");
+  const pw::ConstByteSpan expected = pw::trace::DeringAndViewRawBuffer();
+  std::array<std::byte, PW_TRACE_BUFFER_SIZE_BYTES> expected_copy;
+  std::copy(expected.begin(), expected.end(), expected_copy.begin());
+  const size_t expected_size = expected.size();
+
+  std::array<std::byte, PW_TRACE_BUFFER_SIZE_BYTES> output;
+  pw::stream::MemoryWriter writer(output);
+  pw::StatusWithSize result = pw::trace::DrainBuffer(writer);
+  EXPECT_EQ(result.status(), pw::OkStatus());
+  EXPECT_EQ(result.size(), expected_size);
+  EXPECT_EQ(buf->EntryCount(), 0u);
+  ASSERT_EQ(writer.bytes_written(), expected_size);
+  EXPECT_TRUE(std::equal(writer.WrittenData().begin(),
+                         writer.WrittenData().end(),
+                         expected_copy.begin()));
+
+  // Tracing continues after a drain.
+  PW_TRACE_INSTANT("Test");
+  EXPECT_EQ(buf->EntryCount(), 1u);
+}
+
+TEST(TokenizedTrace, DrainBufferStopsWhenWriterIsFull) {
+  PW_TRACE_SET_ENABLED(true);
+  pw::trace::ClearBuffer();
+  pw::ring_buffer::PrefixedEntryRingBuffer* buf = pw::trace::GetBuffer();
+
+  PW_TRACE_INSTANT("Test");
+  PW_TRACE_INSTANT("Test");
+  const size_t first_entry_size = buf->FrontEntryTotalSizeBytes();
+
+  // Only the first entry fits in the writer.
+  std::array<std::byte, PW_TRACE_BUFFER_SIZE_BYTES> output;
+  pw::stream::MemoryWriter writer(
+      pw::ByteSpan(output).first(first_entry_size + 1));
+  pw::StatusWithSize result = pw::trace::DrainBuffer(writer);
+  EXPECT_EQ(result.status(), pw::OkStatus());
+  EXPECT_EQ(result.size(), first_entry_size);
+  EXPECT_EQ(buf->EntryCount(), 1u);
+}
@@ -22,10 +22,15 @@ TraceService::TraceService(TokenizedTracer& tokenized_tracer,
                            stream::Writer& trace_writer)
     : BaseTraceService(tokenized_tracer, trace_writer) {}
 
+TraceService::TraceService(TokenizedTracer& tokenized_tracer,
+                           PerCoreTraceBufferBase& per_core_buffer,
+                           stream::Writer& trace_writer)
+    : BaseTraceService(tokenized_tracer, per_core_buffer, trace_writer) {}
+
 Status TraceService::Start(
-    const proto::pwpb::StartRequest::Message& /*request*/,
+    const proto::pwpb::StartRequest::Message& request,
     proto::pwpb::StartResponse::Message& /*response*/) {
-  return BaseTraceService::Start();
+  return BaseTraceService::Start(request.streaming);
 }
 
 Status TraceService::Stop(const proto::pwpb::StopRequest::Message& /*request*/,
@@ -35,6 +40,7 @@ Status TraceService::Stop(const proto::pwpb::StopRequest::Message& /*request*/,
   }
 
   response.file_id = transfer_id_;
+  response.dropped_events = dropped_events_;
   return pw::OkStatus();
 }
 
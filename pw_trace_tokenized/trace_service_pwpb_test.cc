@@ -107,6 +107,37 @@ TEST_F(TraceServiceTest, StopNoData) {
   ASSERT_EQ(context.call({}), Status::Unavailable());
 }
 
+TEST_F(TraceServiceTest, Streaming) {
+  auto& tracer = trace::GetTokenizedTracer();
+
+  std::array<std::byte, PW_TRACE_BUFFER_SIZE_BYTES> dest_buffer;
+  stream::MemoryWriter writer(dest_buffer);
+  PW_PWPB_TEST_METHOD_CONTEXT(TraceService, Start)
+  context(tracer, writer);
+
+  ASSERT_EQ(context.call({.streaming = true}), OkStatus());
+  ASSERT_TRUE(tracer.IsEnabled());
+
+  // Trace data is written on each flush while tracing runs.
+  PW_TRACE_INSTANT("TestTrace");
+  ASSERT_EQ(context.service().Flush(), OkStatus());
+  const size_t first_flush_bytes = writer.bytes_written();
+  EXPECT_LT(0u, first_flush_bytes);
+
+  PW_TRACE_INSTANT("TestTrace");
+  ASSERT_EQ(context.service().Flush(), OkStatus());
+  EXPECT_LT(first_flush_bytes, writer.bytes_written());
+  EXPECT_TRUE(tracer.IsEnabled());
+
+  proto::pwpb::StopResponse::Message response;
+  ASSERT_EQ(context.service().Stop({}, response), OkStatus());
+  ASSERT_FALSE(tracer.IsEnabled());
+  EXPECT_EQ(response.dropped_events, 0u);
+
+  // Flushing requires a streaming trace.
+  EXPECT_EQ(context.service().Flush(), Status::FailedPrecondition());
+}
+
 TEST_F(TraceServiceTest, GetClockParameters) {
   auto& tracer = trace::GetTokenizedTracer();
 
@@ -544,6 +544,62 @@ TEST(TokenizedTrace, Data) {
   EXPECT_TRUE(test_interface.GetEvents().empty());
 }
 
+TEST(TokenizedTrace, GateClosedWhileDisabled) {
+  {
+    TraceTestInterface test_interface;
+    EXPECT_EQ(_pw_trace_tokenized_gate, pw_trace_EnabledCategories());
+  }
+  PW_TRACE_SET_ENABLED(false);
+  EXPECT_EQ(_pw_trace_tokenized_gate, 0u);
+}
+
+TEST(TokenizedTrace, DisabledCategory) {
+  TraceTestInterface test_interface;
+  constexpr uint32_t kOtherCategory = 1u << 5;
+  PW_TRACE_SET_ENABLED_CATEGORIES(~kOtherCategory);
+
+#undef PW_TRACE_CATEGORY
+#define PW_TRACE_CATEGORY kOtherCategory
+  PW_TRACE_INSTANT("Test1");
+#undef PW_TRACE_CATEGORY
+#define PW_TRACE_CATEGORY PW_TRACE_CATEGORY_DEFAULT
+  PW_TRACE_INSTANT("Test2");
+
+  PW_TRACE_SET_ENABLED_CATEGORIES(0xffffffffu);
+
+  // Check results
+  EXPECT_TRACE(test_interface, PW_TRACE_TYPE_INSTANT, "Test2");
+  EXPECT_TRUE(test_interface.GetEvents().empty());
+}
+
+pw_trace_TraceEventReturnFlags CountEvents(void* user_data,
+                                           pw_trace_tokenized_TraceEvent*) {
+  ++*static_cast<int*>(user_data);
+  return 0;
+}
+
+TEST(TokenizedTrace, CallbackOnEveryEventWhileDisabled) {
+  PW_TRACE_SET_ENABLED(false);
+  int events = 0;
+  pw::trace::Callbacks::EventCallbackHandle handle;
+  ASSERT_EQ(pw::OkStatus(),
+            pw::trace::GetCallbacks().RegisterEventCallback(
+                CountEvents,
+                pw::trace::Callbacks::kCallOnEveryEvent,
+                &events,
+                &handle));
+
+  PW_TRACE_INSTANT("Test1");
+  EXPECT_EQ(events, 1);
+
+  ASSERT_EQ(pw::OkStatus(),
+            pw::trace::GetCallbacks().UnregisterEventCallback(handle));
+  EXPECT_EQ(_pw_trace_tokenized_gate, 0u);
+
+  PW_TRACE_INSTANT("Test2");
+  EXPECT_EQ(events, 1);
+}
+
 // Create some helper macros that generated some test trace data based from a
 // number, and can check that it is correct.
 constexpr std::byte kTestData[] = {
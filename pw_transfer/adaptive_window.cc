@@ -0,0 +1,82 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/adaptive_window.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace pw::transfer::internal {
+
+void AdaptiveWindow::Reset(uint32_t offset,
+                           chrono::SystemClock::time_point now) {
+  *this = AdaptiveWindow();
+  window_start_offset_ = offset;
+  window_start_time_ = now;
+}
+
+void AdaptiveWindow::EndWindow(uint32_t offset,
+                               chrono::SystemClock::time_point now) {
+  const auto elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                              now - window_start_time_)
+                              .count();
+  const uint32_t bytes = offset - window_start_offset_;
+  window_start_offset_ = offset;
+  window_start_time_ = now;
+  if (elapsed_us <= 0 || bytes == 0) {
+    return;
+  }
+
+  constexpr uint64_t kMicrosecondsPerSecond = 1'000'000;
+  last_rate_ = static_cast<uint64_t>(bytes) * kMicrosecondsPerSecond /
+               static_cast<uint64_t>(elapsed_us);
+  if (last_rate_ >= max_rate_ + max_rate_ / 4) {
+    windows_without_rate_growth_ = 0;
+  } else {
+    ++windows_without_rate_growth_;
+  }
+  max_rate_ = std::max(max_rate_, last_rate_);
+
+  if (windows_since_loss_ < kIsolatedLossWindows) {
+    ++windows_since_loss_;
+  }
+}
+
+bool AdaptiveWindow::ShouldGrow() {
+  if (last_rate_ > rate_at_last_growth_ + rate_at_last_growth_ / 16 ||
+      ++windows_without_growth_ >= kProbeWindows) {
+    rate_at_last_growth_ = last_rate_;
+    windows_without_growth_ = 0;
+    return true;
+  }
+  return false;
+}
+
+uint32_t AdaptiveWindow::RecordLoss(uint32_t multiplier,
+                                    uint32_t offset,
+                                    chrono::SystemClock::time_point now) {
+  const bool isolated = windows_since_loss_ >= kIsolatedLossWindows;
+  windows_since_loss_ = 0;
+
+  // The window restarts at the retransmitted offset, and the rate measured
+  // before the loss no longer reflects the new window.
+  window_start_offset_ = offset;
+  window_start_time_ = now;
+  rate_at_last_growth_ = 0;
+
+  const uint32_t reduction = isolated ? multiplier / 4 : multiplier / 2;
+  return std::max(multiplier - reduction, static_cast<uint32_t>(1));
+}
+
+}  // namespace pw::transfer::internal
@@ -0,0 +1,143 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/adaptive_window.h"
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::transfer::internal {
+namespace {
+
+using namespace std::chrono_literals;
+
+using chrono::SystemClock;
+
+// Receives windows of `window_bytes` each taking `elapsed`, and returns the
+// offset after the last.
+uint32_t ReceiveWindows(AdaptiveWindow& window,
+                        SystemClock::time_point& now,
+                        uint32_t offset,
+                        uint32_t window_bytes,
+                        SystemClock::duration elapsed,
+                        int count) {
+  for (int i = 0; i < count; ++i) {
+    offset += window_bytes;
+    now += elapsed;
+    window.EndWindow(offset, now);
+  }
+  return offset;
+}
+
+TEST(AdaptiveWindow, PipeNotFullWhileRateGrows) {
+  AdaptiveWindow window;
+  SystemClock::time_point now;
+  window.Reset(0, now);
+
+  // Doubling windows over a fast link double the rate.
+  uint32_t offset = 0;
+  for (uint32_t bytes = 64; bytes <= 1024; bytes *= 2) {
+    offset = ReceiveWindows(window, now, offset, bytes, 10ms, 1);
+    EXPECT_FALSE(window.pipe_full());
+  }
+  EXPECT_EQ(window.max_rate_bytes_per_second(), 1024u * 100);
+}
+
+TEST(AdaptiveWindow, PipeFullOnceRatePlateaus) {
+  AdaptiveWindow window;
+  SystemClock::time_point now;
+  window.Reset(0, now);
+
+  uint32_t offset = ReceiveWindows(window, now, 0, 1000, 10ms, 1);
+  EXPECT_FALSE(window.pipe_full());
+
+  // The window doubles, but so does the time to receive it.
+  offset = ReceiveWindows(window, now, offset, 2000, 20ms, 1);
+  EXPECT_FALSE(window.pipe_full());
+  offset = ReceiveWindows(window, now, offset, 4000, 40ms, 1);
+  EXPECT_FALSE(window.pipe_full());
+  ReceiveWindows(window, now, offset, 8000, 80ms, 1);
+  EXPECT_TRUE(window.pipe_full());
+  EXPECT_EQ(window.max_rate_bytes_per_second(), 100'000u);
+}
+
+TEST(AdaptiveWindow, GrowsWhileRateIncreases) {
+  AdaptiveWindow window;
+  SystemClock::time_point now;
+  window.Reset(0, now);
+
+  uint32_t offset = ReceiveWindows(window, now, 0, 1000, 10ms, 1);
+  EXPECT_TRUE(window.ShouldGrow());
+  offset = ReceiveWindows(window, now, offset, 1100, 10ms, 1);
+  EXPECT_TRUE(window.ShouldGrow());
+
+  // Growing the window no longer increases the rate.
+  offset = ReceiveWindows(window, now, offset, 1200, 11ms, 1);
+  EXPECT_FALSE(window.ShouldGrow());
+}
+
+TEST(AdaptiveWindow, ProbesPeriodically) {
+  AdaptiveWindow window;
+  SystemClock::time_point now;
+  window.Reset(0, now);
+
+  uint32_t offset = ReceiveWindows(window, now, 0, 1000, 10ms, 1);
+  EXPECT_TRUE(window.ShouldGrow());
+
+  for (uint32_t i = 1; i < AdaptiveWindow::kProbeWindows; ++i) {
+    offset = ReceiveWindows(window, now, offset, 1000, 10ms, 1);
+    EXPECT_FALSE(window.ShouldGrow());
+  }
+  ReceiveWindows(window, now, offset, 1000, 10ms, 1);
+  EXPECT_TRUE(window.ShouldGrow());
+}
+
+TEST(AdaptiveWindow, IsolatedLossShrinksByQuarter) {
+  AdaptiveWindow window;
+  SystemClock::time_point now;
+  window.Reset(0, now);
+
+  EXPECT_EQ(window.RecordLoss(16, 0, now), 12u);
+
+  // Another loss soon after halves the window.
+  uint32_t offset = ReceiveWindows(window, now, 0, 1000, 10ms, 1);
+  EXPECT_EQ(window.RecordLoss(12, offset, now), 6u);
+
+  // Losses after enough windows are isolated again.
+  offset = ReceiveWindows(
+      window, now, offset, 1000, 10ms, AdaptiveWindow::kIsolatedLossWindows);
+  EXPECT_EQ(window.RecordLoss(8, offset, now), 6u);
+}
+
+TEST(AdaptiveWindow, LossNeverShrinksBelowOneChunk) {
+  AdaptiveWindow window;
+  SystemClock::time_point now;
+  window.Reset(0, now);
+
+  EXPECT_EQ(window.RecordLoss(1, 0, now), 1u);
+  EXPECT_EQ(window.RecordLoss(1, 0, now), 1u);
+}
+
+TEST(AdaptiveWindow, IgnoresEmptyWindows) {
+  AdaptiveWindow window;
+  SystemClock::time_point now;
+  window.Reset(100, now);
+
+  window.EndWindow(100, now + 10ms);
+  window.EndWindow(200, now + 10ms);
+  EXPECT_EQ(window.max_rate_bytes_per_second(), 0u);
+  EXPECT_FALSE(window.pipe_full());
+}
+
+}  // namespace
+}  // namespace pw::transfer::internal
@@ -85,18 +85,7 @@ Result<Client::Handle> Client::Write(
     return Status::InvalidArgument();
   }
 
-  if (!has_write_stream_) {
-    rpc::RawClientReaderWriter write_stream =
-        client_.Write(nullptr,  // on_next will be set by the transfer thread.
-                      [this](Status status) {
-                        OnRpcError(status, internal::TransferType::kTransmit);
-                      });
-    transfer_thread_.SetClientWriteStream(
-        write_stream, [this](ConstByteSpan chunk) {
-          transfer_thread_.ProcessClientChunk(chunk);
-        });
-    has_write_stream_ = true;
-  }
+  OpenWriteStream();
 
   Handle handle = AssignHandle();
 
@@ -116,6 +105,53 @@ Result<Client::Handle> Client::Write(
   return handle;
 }
 
+Status Client::AddDataPath(uint32_t channel_id) {
+  if constexpr (cfg::kMaxDataPaths == 1) {
+    return Status::FailedPrecondition();
+  }
+
+  if (channel_id == client_.channel_id()) {
+    return Status::InvalidArgument();
+  }
+
+  // Data paths carry data alongside the primary write stream, which must be
+  // open first so that the transfer thread does not replace it.
+  OpenWriteStream();
+
+  rpc::RawClientReaderWriter data_path =
+      Transfer::Client(client_.client(), channel_id)
+          .Write(nullptr,  // on_next will be set by the transfer thread.
+                 [channel_id](Status status) {
+                   PW_LOG_WARN(
+                       "Client data path on channel %u terminated with "
+                       "status %d",
+                       static_cast<unsigned>(channel_id),
+                       status.code());
+                 });
+  transfer_thread_.AddClientWriteDataPath(
+      data_path, [this](ConstByteSpan chunk) {
+        transfer_thread_.ProcessClientChunk(chunk);
+      });
+  return OkStatus();
+}
+
+void Client::OpenWriteStream() {
+  if (has_write_stream_) {
+    return;
+  }
+
+  rpc::RawClientReaderWriter write_stream =
+      client_.Write(nullptr,  // on_next will be set by the transfer thread.
+                    [this](Status status) {
+                      OnRpcError(status, internal::TransferType::kTransmit);
+                    });
+  transfer_thread_.SetClientWriteStream(
+      write_stream, [this](ConstByteSpan chunk) {
+        transfer_thread_.ProcessClientChunk(chunk);
+      });
+  has_write_stream_ = true;
+}
+
 Client::Handle Client::AssignHandle() {
   uint32_t handle_id = next_handle_id_++;
   if (handle_id == Handle::kUnassignedHandleId) {
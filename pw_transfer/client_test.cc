@@ -1887,6 +1887,16 @@ TEST_F(WriteTransfer, ManualCancel_Duplicate) {
   EXPECT_EQ(transfer_status, Status::Unknown());
 }
 
+TEST_F(WriteTransfer, AddDataPath_RequiresAnotherChannel) {
+  if constexpr (cfg::kMaxDataPaths == 1) {
+    EXPECT_EQ(client_.AddDataPath(context_.channel().id() + 1),
+              Status::FailedPrecondition());
+  } else {
+    EXPECT_EQ(client_.AddDataPath(context_.channel().id()),
+              Status::InvalidArgument());
+  }
+}
+
 TEST_F(ReadTransfer, Version2_SingleChunk) {
   stream::MemoryWriterBuffer<64> writer;
   Status transfer_status = Status::Unknown();
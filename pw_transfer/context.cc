@@ -174,6 +174,7 @@ bool Context::StartTransferAsServer(const NewTransferEvent& new_transfer) {
 
   // Initialize doesn't set the handler since it's specific to server transfers.
   static_cast<ServerContext&>(*this).set_handler(*new_transfer.handler);
+  scheduling_weight_ = new_transfer.handler->scheduling_weight();
 
   // Server transfers use the stream provided by the handler rather than the
   // stream included in the NewTransferEvent.
@@ -206,13 +207,20 @@ void Context::UpdateTransferParameters(TransmitAction action) {
       case TransmitAction::kBegin:
       case TransmitAction::kFirstParameters:
         // A transfer always begins with a window size of one chunk, set during
-        // initialization. No further handling is required.
+        // initialization. With adaptive windowing, start measuring the first
+        // window.
+        if (max_parameters_->adaptive_window()) {
+          adaptive_window_.Reset(offset_, chrono::SystemClock::now());
+        }
         break;
 
       case TransmitAction::kExtend:
         // Window was received successfully without packet loss and should grow.
         // Double the window size during slow start, or increase it by a single
         // chunk in congestion avoidance.
+        if (max_parameters_->adaptive_window() && !AdaptiveWindowShouldGrow()) {
+          break;
+        }
         if (transmit_phase_ == TransmitPhase::kCongestionAvoidance) {
           window_size_multiplier_ += 1;
         } else {
@@ -235,6 +243,11 @@ void Context::UpdateTransferParameters(TransmitAction action) {
         if (transmit_phase_ == TransmitPhase::kSlowStart) {
           transmit_phase_ = TransmitPhase::kCongestionAvoidance;
         }
+        if (max_parameters_->adaptive_window()) {
+          window_size_multiplier_ = adaptive_window_.RecordLoss(
+              window_size_multiplier_, offset_, chrono::SystemClock::now());
+          break;
+        }
         window_size_multiplier_ =
             std::max(window_size_multiplier_ / static_cast<uint32_t>(2),
                      static_cast<uint32_t>(1));
@@ -251,6 +264,26 @@ void Context::UpdateTransferParameters(TransmitAction action) {
   window_end_offset_ = offset_ + window_size;
 }
 
+bool Context::AdaptiveWindowShouldGrow() {
+  adaptive_window_.EndWindow(offset_, chrono::SystemClock::now());
+
+  if (transmit_phase_ == TransmitPhase::kCongestionAvoidance) {
+    return adaptive_window_.ShouldGrow();
+  }
+
+  if (adaptive_window_.pipe_full()) {
+    // The rate stopped growing with the window, so the link is saturated.
+    // Stop doubling the window, as doing so would only queue more data.
+    PW_LOG_DEBUG(
+        "Transfer %u: throughput reached %u B/s, ending slow start",
+        id_for_log(),
+        static_cast<unsigned>(adaptive_window_.max_rate_bytes_per_second()));
+    transmit_phase_ = TransmitPhase::kCongestionAvoidance;
+    return false;
+  }
+  return true;
+}
+
 void Context::SetTransferParameters(Chunk& parameters) {
   parameters.set_window_end_offset(window_end_offset_)
       .set_max_chunk_size_bytes(max_chunk_size_bytes_)
@@ -369,6 +402,7 @@ void Context::Initialize(const NewTransferEvent& new_transfer) {
   max_retries_ = new_transfer.max_retries;
   lifetime_retries_ = 0;
   max_lifetime_retries_ = new_transfer.max_lifetime_retries;
+  scheduling_weight_ = cfg::kDefaultSchedulingWeight;
 
   if (desired_protocol_version_ == ProtocolVersion::kLegacy) {
     // In a legacy transfer, there is no protocol negotiation stage.
@@ -391,6 +425,7 @@ void Context::Initialize(const NewTransferEvent& new_transfer) {
 
   window_size_multiplier_ = 1;
   transmit_phase_ = TransmitPhase::kSlowStart;
+  adaptive_window_ = AdaptiveWindow();
 
   max_parameters_ = new_transfer.max_parameters;
   thread_ = new_transfer.transfer_thread;
@@ -696,8 +731,9 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
 
   // Reserve space for the data proto field overhead and use the remainder of
   // the buffer for the chunk data.
+  constexpr size_t kDataKeySize = 1;
   size_t reserved_size =
-      chunk.EncodedSize() + 1 /* data key */ + 5 /* data size */;
+      chunk.EncodedSize() + kDataKeySize + varint::kMaxVarint32SizeBytes;
 
   size_t total_size = TransferSizeBytes();
   if (total_size != std::numeric_limits<size_t>::max()) {
@@ -709,16 +745,17 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
   Result<ByteSpan> data;
 
   if (offset_ < total_size) {
-    // Read the next chunk of data into the encode buffer.
-    ByteSpan data_buffer = buffer.subspan(reserved_size);
-    size_t max_bytes_to_send =
-        std::min(window_end_offset_ - offset_, max_chunk_size_bytes_);
-
-    if (max_bytes_to_send < data_buffer.size()) {
-      data_buffer = data_buffer.first(max_bytes_to_send);
-    }
-
-    data = reader().Read(data_buffer);
+    size_t max_bytes_to_send = std::min(
+        {static_cast<size_t>(window_end_offset_ - offset_),
+         static_cast<size_t>(max_chunk_size_bytes_),
+         buffer.size() > reserved_size ? buffer.size() - reserved_size : 0});
+
+    // Read the next chunk of data into the encode buffer, directly where it
+    // is encoded: the data field is encoded first, following its key and
+    // length. The remaining fields are encoded after the data, so unless a
+    // short read shrinks the encoded length, encoding does not move the data.
+    size_t data_start = kDataKeySize + varint::EncodedSize(max_bytes_to_send);
+    data = reader().Read(buffer.subspan(data_start, max_bytes_to_send));
   } else {
     // The user-specified resource size has been reached: respect it.
     data = Status::OutOfRange();
@@ -777,7 +814,9 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
     return;
   }
 
-  if (const Status status = rpc_writer_->Write(*encoded_chunk); !status.ok()) {
+  if (const Status status =
+          thread_->WriteDataChunk(*rpc_writer_, *encoded_chunk);
+      !status.ok()) {
     PW_LOG_ERROR("Transfer %u failed to send transmit chunk, status %u",
                  static_cast<unsigned>(session_id_),
                  status.code());
@@ -793,6 +832,10 @@ void Context::TransmitNextChunk(bool retransmit_requested) {
     // receiver.
     set_transfer_state(TransferState::kWaiting);
     SetTimeout(chunk_timeout_);
+
+    if (data.ok() && offset_ != total_size) {
+      TransmitWindowSent();
+    }
   } else {
     // More data is to be sent. Set a timeout to send the next chunk following
     // the chunk delay.
@@ -881,6 +924,10 @@ void Context::HandleReceiveChunk(const Chunk& chunk) {
 
 void Context::HandleReceivedData(const Chunk& chunk) {
   if (chunk.offset() != offset_) {
+    if (chunk.offset() > offset_ && HoldOutOfOrderChunk(chunk)) {
+      return;
+    }
+
     // Bad offset; reset window size to send another parameters chunk.
     PW_LOG_DEBUG(
         "Transfer %u expected offset %u, received %u; entering recovery "
@@ -889,6 +936,9 @@ void Context::HandleReceivedData(const Chunk& chunk) {
         static_cast<unsigned>(offset_),
         static_cast<unsigned>(chunk.offset()));
 
+    // The transmitter resends everything from the offset, so chunks held
+    // beyond it are no longer needed.
+    thread_->reorder_buffer().Clear(this);
     set_transfer_state(TransferState::kRecovery);
     SetTimeout(chunk_timeout_);
 
@@ -948,6 +998,10 @@ void Context::HandleReceivedData(const Chunk& chunk) {
     return;
   }
 
+  if (!WriteHeldChunks()) {
+    return;
+  }
+
   if (chunk.window_end_offset() != 0) {
     if (chunk.window_end_offset() < offset_) {
       PW_LOG_ERROR(
@@ -1001,6 +1055,61 @@ void Context::HandleReceivedData(const Chunk& chunk) {
   }
 }
 
+bool Context::HoldOutOfOrderChunk(const Chunk& chunk) {
+  if (chunk.type() != Chunk::Type::kData ||
+      (!chunk.has_payload() && !chunk.IsFinalTransmitChunk()) ||
+      chunk.offset() + chunk.payload().size() > window_end_offset_) {
+    return false;
+  }
+
+  if (!thread_->reorder_buffer().Hold(this,
+                                      chunk.offset(),
+                                      chunk.payload(),
+                                      chunk.IsFinalTransmitChunk())) {
+    return false;
+  }
+
+  PW_LOG_DEBUG("Transfer %u holding chunk offset=%u size=%u until offset %u",
+               id_for_log(),
+               static_cast<unsigned>(chunk.offset()),
+               static_cast<unsigned>(chunk.payload().size()),
+               static_cast<unsigned>(offset_));
+  SetTimeout(chunk_timeout_);
+  return true;
+}
+
+bool Context::WriteHeldChunks() {
+  ReorderBuffer& held_chunks = thread_->reorder_buffer();
+  held_chunks.ReleaseBefore(this, offset_);
+
+  std::optional<ReorderBuffer::HeldChunk> held;
+  while ((held = held_chunks.Find(this, offset_)).has_value()) {
+    if (!held->payload.empty()) {
+      if (Status status = writer().Write(held->payload); !status.ok()) {
+        PW_LOG_ERROR(
+            "Transfer %u write of %u B held chunk failed with status %u; "
+            "aborting with DATA_LOSS",
+            id_for_log(),
+            static_cast<unsigned>(held->payload.size()),
+            status.code());
+        TerminateTransfer(Status::DataLoss());
+        return false;
+      }
+      transfer_rate_.Update(held->payload.size());
+    }
+
+    last_chunk_offset_ = offset_;
+    offset_ += held->payload.size();
+
+    if (held->final_chunk) {
+      TerminateTransfer(OkStatus());
+      return false;
+    }
+    held_chunks.ReleaseBefore(this, offset_);
+  }
+  return true;
+}
+
 void Context::HandleTerminatingChunk(const Chunk& chunk) {
   switch (chunk.type()) {
     case Chunk::Type::kCompletion:
@@ -1091,6 +1200,8 @@ void Context::SendFinalStatusChunk(bool with_resource_id) {
 void Context::Finish(Status status) {
   PW_DCHECK(active());
 
+  thread_->reorder_buffer().Clear(this);
+
   status.Update(FinalCleanup(status));
   status_ = status;
 
@@ -1319,10 +1430,11 @@ void Context::LogTransferConfiguration() {
 
   PW_LOG_DEBUG(
       "Local transfer windowing configuration: max_window_size_bytes=%u, "
-      "extend_window_divisor=%u, max_chunk_size_bytes=%u",
+      "extend_window_divisor=%u, max_chunk_size_bytes=%u, adaptive_window=%d",
       static_cast<unsigned>(max_parameters_->max_window_size_bytes()),
       static_cast<unsigned>(max_parameters_->extend_window_divisor()),
-      static_cast<unsigned>(max_parameters_->max_chunk_size_bytes()));
+      static_cast<unsigned>(max_parameters_->max_chunk_size_bytes()),
+      static_cast<int>(max_parameters_->adaptive_window()));
 }
 
 }  // namespace pw::transfer::internal
@@ -37,5 +37,12 @@ TEST(Handlers, ReadWrite) {
   EXPECT_EQ(OkStatus(), handler.PrepareWrite());
 }
 
+TEST(Handlers, SchedulingWeight) {
+  ReadOnlyHandler handler(123);
+  EXPECT_EQ(handler.scheduling_weight(), cfg::kDefaultSchedulingWeight);
+  handler.set_scheduling_weight(4);
+  EXPECT_EQ(handler.scheduling_weight(), 4u);
+}
+
 }  // namespace
 }  // namespace pw::transfer
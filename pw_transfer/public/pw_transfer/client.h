@@ -161,6 +161,22 @@ class Client {
                  initial_offset);
   }
 
+  // Opens a write stream to the transfer service on another RPC channel, such
+  // as one over a second physical link. Write transfers stripe their data
+  // chunks across the client's channel and its data paths, in proportion to
+  // the measured throughput of each, so large uploads use the combined
+  // bandwidth of the links. Transfer control chunks stay on the client's
+  // channel.
+  //
+  // The server must be built with PW_TRANSFER_MAX_DATA_PATHS greater than 1
+  // and should be given a reorder buffer, so that data chunks which overtake
+  // each other on different channels do not cause retransmissions.
+  //
+  // Returns FAILED_PRECONDITION if multipath transfers are disabled, and
+  // INVALID_ARGUMENT if channel_id is the client's channel. If all
+  // PW_TRANSFER_MAX_DATA_PATHS paths are in use, the stream is closed.
+  Status AddDataPath(uint32_t channel_id);
+
   Status set_extend_window_divisor(uint32_t extend_window_divisor) {
     if (extend_window_divisor <= 1) {
       return Status::InvalidArgument();
@@ -170,6 +186,13 @@ class Client {
     return OkStatus();
   }
 
+  // Sets whether read transfers adapt their window sizes to the measured
+  // throughput and losses of the transfer, up to the maximum window size.
+  // Should be set while no transfers are active.
+  void set_adaptive_window(bool adaptive_window) {
+    max_parameters_.set_adaptive_window(adaptive_window);
+  }
+
   constexpr Status set_max_retries(uint32_t max_retries) {
     if (max_retries < 1 || max_retries > max_lifetime_retries_) {
       return Status::InvalidArgument();
@@ -210,6 +233,9 @@ class Client {
 
   void OnRpcError(Status status, internal::TransferType type);
 
+  // Opens the Write() stream if it is not open.
+  void OpenWriteStream();
+
   Handle AssignHandle();
 
   Transfer::Client client_;
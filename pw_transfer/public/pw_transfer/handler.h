@@ -19,6 +19,7 @@
 #include "pw_containers/intrusive_list.h"
 #include "pw_status/status.h"
 #include "pw_stream/stream.h"
+#include "pw_transfer/internal/config.h"
 #include "pw_transfer/internal/event.h"
 
 namespace pw::transfer {
@@ -40,6 +41,19 @@ class Handler : public IntrusiveList<Handler>::Item {
 
   constexpr uint32_t id() const { return resource_id_; }
 
+  // The number of data chunks a read transfer of this resource may send each
+  // time the transfer thread services its transmitting transfers in turn.
+  // Raising the weight of a resource gives its reads a larger share of the
+  // link while other transfers are sending data.
+  constexpr uint8_t scheduling_weight() const { return scheduling_weight_; }
+
+  // Sets the scheduling weight, which must be positive. Takes effect for
+  // transfers started after the call.
+  void set_scheduling_weight(uint8_t weight) {
+    PW_ASSERT(weight > 0);
+    scheduling_weight_ = weight;
+  }
+
   // Called at the beginning of a read transfer. The stream::Reader must be
   // ready to read after a successful PrepareRead() call. Returning a non-OK
   // status aborts the read.
@@ -62,6 +76,12 @@ class Handler : public IntrusiveList<Handler>::Item {
   // indicates whether the data transfer was successful or not.
   virtual void FinalizeRead(Status) {}
 
+  // Called on the transfer thread when a read transfer has sent all of the
+  // data that the receiver requested and is waiting for it to request more.
+  // Handlers for slow storage may use this time to fetch the data that
+  // follows, for example with a ReadAheadReader.
+  virtual void PrefetchRead() {}
+
   // Called at the beginning of a write transfer. The stream::Writer must be
   // ready to read after a successful PrepareRead() call. Returning a non-OK
   // status aborts the write.
@@ -141,6 +161,7 @@ class Handler : public IntrusiveList<Handler>::Item {
   }
 
   uint32_t resource_id_;
+  uint8_t scheduling_weight_ = cfg::kDefaultSchedulingWeight;
 
   // Use a union to support constexpr construction.
   union {
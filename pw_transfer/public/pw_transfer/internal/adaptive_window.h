@@ -0,0 +1,88 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "pw_chrono/system_clock.h"
+
+namespace pw::transfer::internal {
+
+// Measures the throughput and losses of a receive transfer to decide how its
+// window should change, when adaptive windowing is enabled.
+//
+// The receiver measures the rate at which data arrives between consecutive
+// parameters chunks. Like the full bandwidth detection of BBR, slow start ends
+// once the rate has not grown by at least a quarter for several windows, as a
+// larger window only queues more data in the link. In congestion avoidance,
+// the window only grows while doing so noticeably increases the rate, or
+// periodically to probe for more bandwidth.
+//
+// Isolated losses, such as occasional corruption on a noisy link, shrink the
+// window by a quarter. Losses in close succession indicate congestion, and
+// halve it.
+class AdaptiveWindow {
+ public:
+  // Number of windows without the rate growing by a quarter after which slow
+  // start ends.
+  static constexpr uint32_t kFullPipeWindows = 3;
+
+  // Number of windows without growth after which congestion avoidance grows
+  // the window regardless of the rate.
+  static constexpr uint32_t kProbeWindows = 8;
+
+  // Number of windows that must separate losses for them to be isolated.
+  static constexpr uint32_t kIsolatedLossWindows = 4;
+
+  constexpr AdaptiveWindow() = default;
+
+  // Starts measuring the first window of a transfer at `offset`.
+  void Reset(uint32_t offset, chrono::SystemClock::time_point now);
+
+  // Measures the rate of the window that ended at `offset`, and starts a new
+  // window.
+  void EndWindow(uint32_t offset, chrono::SystemClock::time_point now);
+
+  // Returns whether slow start should end, as the rate has stopped growing.
+  bool pipe_full() const {
+    return windows_without_rate_growth_ >= kFullPipeWindows;
+  }
+
+  // Returns whether the window should grow in congestion avoidance. Must be
+  // called once per window.
+  bool ShouldGrow();
+
+  // Records a retransmission from `offset`, and returns the new window size
+  // multiplier, reduced from `multiplier`.
+  uint32_t RecordLoss(uint32_t multiplier,
+                      uint32_t offset,
+                      chrono::SystemClock::time_point now);
+
+  // The highest rate measured for a window, in bytes per second.
+  uint64_t max_rate_bytes_per_second() const { return max_rate_; }
+
+ private:
+  chrono::SystemClock::time_point window_start_time_;
+  uint32_t window_start_offset_ = 0;
+
+  uint64_t max_rate_ = 0;
+  uint64_t last_rate_ = 0;
+  uint64_t rate_at_last_growth_ = 0;
+
+  uint32_t windows_without_rate_growth_ = 0;
+  uint32_t windows_without_growth_ = 0;
+  uint32_t windows_since_loss_ = kIsolatedLossWindows;
+};
+
+}  // namespace pw::transfer::internal
@@ -17,6 +17,7 @@
 
 #include <chrono>
 #include <cinttypes>
+#include <cstddef>
 #include <limits>
 
 #include "pw_chrono/system_clock.h"
@@ -167,6 +168,39 @@ static_assert(PW_TRANSFER_DEFAULT_INITIAL_TIMEOUT_MS > 0);
 
 static_assert(PW_TRANSFER_DEFAULT_EXTEND_WINDOW_DIVISOR > 1);
 
+// Whether receive transfers adapt their window sizes to the measured
+// throughput and losses of the transfer by default, rather than growing them
+// until they reach the maximum window size.
+//
+// With adaptive windowing, slow start ends once the throughput stops growing,
+// and isolated losses shrink the window less than repeated ones. The maximum
+// window size remains an upper bound.
+#ifndef PW_TRANSFER_DEFAULT_ADAPTIVE_WINDOW
+#define PW_TRANSFER_DEFAULT_ADAPTIVE_WINDOW 0
+#endif  // PW_TRANSFER_DEFAULT_ADAPTIVE_WINDOW
+
+// The default scheduling weight of a transfer: the maximum number of data
+// chunks it may send each time the transfer thread services its transmitting
+// transfers in turn. Server transfers take their weight from their handler.
+#ifndef PW_TRANSFER_DEFAULT_SCHEDULING_WEIGHT
+#define PW_TRANSFER_DEFAULT_SCHEDULING_WEIGHT 1
+#endif  // PW_TRANSFER_DEFAULT_SCHEDULING_WEIGHT
+
+static_assert(PW_TRANSFER_DEFAULT_SCHEDULING_WEIGHT > 0 &&
+              PW_TRANSFER_DEFAULT_SCHEDULING_WEIGHT <=
+                  static_cast<uint32_t>(std::numeric_limits<uint8_t>::max()));
+
+// The maximum number of RPC channels over which the data of a write transfer
+// is sent, including the channel of the transfer's Write() stream. Data
+// chunks are striped across the channels in proportion to their measured
+// throughput, and reordered by the receiver. Transfer clients add channels
+// with Client::AddDataPath(). 1 disables multipath transfers.
+#ifndef PW_TRANSFER_MAX_DATA_PATHS
+#define PW_TRANSFER_MAX_DATA_PATHS 1
+#endif  // PW_TRANSFER_MAX_DATA_PATHS
+
+static_assert(PW_TRANSFER_MAX_DATA_PATHS > 0);
+
 // Number of chunks to send repetitative logs at full rate before reducing to
 // rate_limit. Retransmit parameter chunks will restart at this chunk count
 // limit.
@@ -222,6 +256,14 @@ inline constexpr chrono::SystemClock::duration kDefaultInitialChunkTimeout =
 inline constexpr uint32_t kDefaultExtendWindowDivisor =
     PW_TRANSFER_DEFAULT_EXTEND_WINDOW_DIVISOR;
 
+inline constexpr bool kDefaultAdaptiveWindow =
+    PW_TRANSFER_DEFAULT_ADAPTIVE_WINDOW != 0;
+
+inline constexpr uint8_t kDefaultSchedulingWeight =
+    PW_TRANSFER_DEFAULT_SCHEDULING_WEIGHT;
+
+inline constexpr size_t kMaxDataPaths = PW_TRANSFER_MAX_DATA_PATHS;
+
 inline constexpr uint16_t kLogDefaultChunksBeforeRateLimit =
     PW_TRANSFER_LOG_DEFAULT_CHUNKS_BEFORE_RATE_LIMIT;
 inline constexpr chrono::SystemClock::duration kLogDefaultRateLimit =
@@ -23,6 +23,7 @@
 #include "pw_rpc/writer.h"
 #include "pw_status/status.h"
 #include "pw_stream/stream.h"
+#include "pw_transfer/internal/adaptive_window.h"
 #include "pw_transfer/internal/chunk.h"
 #include "pw_transfer/internal/config.h"
 #include "pw_transfer/internal/event.h"
@@ -35,12 +36,15 @@ class TransferThread;
 
 class TransferParameters {
  public:
-  constexpr TransferParameters(uint32_t max_window_size_bytes,
-                               uint32_t max_chunk_size_bytes,
-                               uint32_t extend_window_divisor)
+  constexpr TransferParameters(
+      uint32_t max_window_size_bytes,
+      uint32_t max_chunk_size_bytes,
+      uint32_t extend_window_divisor,
+      bool adaptive_window = cfg::kDefaultAdaptiveWindow)
       : max_window_size_bytes_(max_window_size_bytes),
         max_chunk_size_bytes_(max_chunk_size_bytes),
-        extend_window_divisor_(extend_window_divisor) {
+        extend_window_divisor_(extend_window_divisor),
+        adaptive_window_(adaptive_window) {
     PW_ASSERT(max_window_size_bytes > 0);
     PW_ASSERT(max_chunk_size_bytes > 0);
     PW_ASSERT(extend_window_divisor > 1);
@@ -68,10 +72,18 @@ class TransferParameters {
     extend_window_divisor_ = extend_window_divisor;
   }
 
+  // Whether receive transfers size their windows based on measured
+  // throughput and losses, up to max_window_size_bytes. See AdaptiveWindow.
+  constexpr bool adaptive_window() const { return adaptive_window_; }
+  constexpr void set_adaptive_window(bool adaptive_window) {
+    adaptive_window_ = adaptive_window;
+  }
+
  private:
   uint32_t max_window_size_bytes_;
   uint32_t max_chunk_size_bytes_;
   uint32_t extend_window_divisor_;
+  bool adaptive_window_;
 };
 
 // Information about a single transfer.
@@ -112,6 +124,15 @@ class Context {
            chrono::SystemClock::now() >= next_timeout.value();
   }
 
+  // True if the transfer is sending data chunks to its receiver.
+  bool transmitting() const {
+    return transfer_state_ == TransferState::kTransmitting;
+  }
+
+  // The maximum number of data chunks the transfer sends each time the
+  // transfer thread services it.
+  constexpr uint8_t scheduling_weight() const { return scheduling_weight_; }
+
   // Processes an event for this transfer.
   void HandleEvent(const Event& event);
 
@@ -130,6 +151,7 @@ class Context {
         max_retries_(0),
         lifetime_retries_(0),
         max_lifetime_retries_(0),
+        scheduling_weight_(cfg::kDefaultSchedulingWeight),
         stream_(nullptr),
         rpc_writer_(nullptr),
         offset_(0),
@@ -138,6 +160,7 @@ class Context {
         max_chunk_size_bytes_(std::numeric_limits<uint32_t>::max()),
         window_size_multiplier_(1),
         transmit_phase_(TransmitPhase::kSlowStart),
+        adaptive_window_(),
         max_parameters_(nullptr),
         thread_(nullptr),
         last_chunk_sent_(Chunk::Type::kData),
@@ -286,6 +309,10 @@ class Context {
   // seek method.
   virtual Status SeekReader(uint32_t offset) = 0;
 
+  // Called when a transmitting transfer has sent every chunk in the current
+  // window and more data remains.
+  virtual void TransmitWindowSent() {}
+
   // Processes a chunk in either a transfer or receive transfer.
   void HandleChunkEvent(const ChunkEvent& event);
 
@@ -309,6 +336,14 @@ class Context {
   // Processes a data chunk in a received while in the kWaiting state.
   void HandleReceivedData(const Chunk& chunk);
 
+  // Holds a data chunk that is ahead of the offset in the transfer thread's
+  // reorder buffer. Returns false if the chunk cannot be held.
+  bool HoldOutOfOrderChunk(const Chunk& chunk);
+
+  // Writes held chunks that continue from the offset. Returns false if the
+  // transfer ended.
+  bool WriteHeldChunks();
+
   // Sends the first chunk in a legacy transmit transfer.
   void SendInitialLegacyTransmitChunk();
 
@@ -316,6 +351,10 @@ class Context {
   // configuration.
   void UpdateTransferParameters(TransmitAction action);
 
+  // Measures the window that was just received, and returns whether the
+  // window should grow. May end slow start. Only used with adaptive windowing.
+  bool AdaptiveWindowShouldGrow();
+
   // Populates the transfer parameters fields on a chunk object.
   void SetTransferParameters(Chunk& parameters);
 
@@ -404,6 +443,7 @@ class Context {
   uint8_t max_retries_;
   uint32_t lifetime_retries_;
   uint32_t max_lifetime_retries_;
+  uint8_t scheduling_weight_;
 
   // The stream from which to read or to which to write data.
   stream::Stream* stream_;
@@ -416,6 +456,7 @@ class Context {
 
   uint32_t window_size_multiplier_;
   TransmitPhase transmit_phase_;
+  AdaptiveWindow adaptive_window_;
 
   const TransferParameters* max_parameters_;
   TransferThread* thread_;
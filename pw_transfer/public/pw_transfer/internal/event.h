@@ -34,6 +34,10 @@ enum class TransferStream {
   kClientWrite,
   kServerRead,
   kServerWrite,
+
+  // Additional write streams on other channels, which only carry data chunks.
+  kClientWriteDataPath,
+  kServerWriteDataPath,
 };
 
 enum class IdentifierType {
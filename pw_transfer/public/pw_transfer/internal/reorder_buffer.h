@@ -0,0 +1,82 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_bytes/span.h"
+
+namespace pw::transfer::internal {
+
+// Holds data chunks of a receive transfer that arrive ahead of the transfer's
+// offset until the data before them arrives, so that they need not be
+// retransmitted. Chunks arrive out of order when a transmitter stripes a
+// window across several RPC channels with different latencies.
+//
+// The buffer is shared by the transfers of a transfer thread, but holds the
+// chunks of one transfer at a time, identified by an owner pointer. Chunks are
+// stored back to back, each behind a small header.
+class ReorderBuffer {
+ public:
+  struct HeldChunk {
+    uint32_t offset;
+    ConstByteSpan payload;
+    bool final_chunk;
+  };
+
+  constexpr ReorderBuffer() = default;
+  explicit constexpr ReorderBuffer(ByteSpan buffer) : buffer_(buffer) {}
+
+  bool enabled() const { return !buffer_.empty(); }
+  bool empty() const { return used_ == 0; }
+
+  // Copies a chunk into the buffer. Returns false if the buffer holds the
+  // chunks of another transfer or has no space for the chunk. Holding a chunk
+  // at an offset that is already held does nothing.
+  bool Hold(const void* owner,
+            uint32_t offset,
+            ConstByteSpan payload,
+            bool final_chunk);
+
+  // Returns the chunk held for `owner` at `offset`, if any. The payload is
+  // valid until the buffer is next modified.
+  std::optional<HeldChunk> Find(const void* owner, uint32_t offset) const;
+
+  // Releases the chunks held for `owner` that start before `offset`.
+  void ReleaseBefore(const void* owner, uint32_t offset);
+
+  // Releases all chunks held for `owner`.
+  void Clear(const void* owner) {
+    if (owner == owner_) {
+      used_ = 0;
+    }
+  }
+
+ private:
+  struct Header {
+    uint32_t offset;
+    uint32_t size;
+    bool final_chunk;
+  };
+
+  Header HeaderAt(size_t position) const;
+
+  ByteSpan buffer_;
+  size_t used_ = 0;
+  const void* owner_ = nullptr;
+};
+
+}  // namespace pw::transfer::internal
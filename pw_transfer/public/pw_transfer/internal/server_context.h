@@ -50,6 +50,8 @@ class ServerContext final : public Context {
   // offset
   Status SeekReader(uint32_t offset) override;
 
+  void TransmitWindowSent() override { handler_->PrefetchRead(); }
+
   Handler* handler_;
 };
 
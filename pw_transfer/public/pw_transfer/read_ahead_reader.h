@@ -0,0 +1,112 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+#include "pw_stream/stream.h"
+
+namespace pw::transfer {
+
+/// `ReadAheadReader` double-buffers reads from a slow `SeekableReader`, such
+/// as a file in flash, for a read transfer handler.
+///
+/// The transfer thread reads one chunk at a time. Reading each chunk directly
+/// from storage stalls the transfer on storage latency for every chunk. This
+/// reader instead fetches large blocks into one half of its buffer while the
+/// transfer is served from the other. A handler calls `Prefetch()` from
+/// `Handler::PrefetchRead()`, so the data for the next window is read while
+/// the receiver processes the current one:
+///
+/// @code{.cpp}
+///   class FileHandler : public pw::transfer::ReadOnlyHandler {
+///    public:
+///     FileHandler(uint32_t id, pw::stream::SeekableReader& file)
+///         : ReadOnlyHandler(id, read_ahead_), read_ahead_(file, buffer_) {}
+///
+///     pw::Status PrepareRead() override { return PrepareRead(0); }
+///     pw::Status PrepareRead(uint32_t offset) override {
+///       read_ahead_.Reset();
+///       return read_ahead_.Seek(offset);
+///     }
+///     void PrefetchRead() override { read_ahead_.Prefetch(); }
+///
+///    private:
+///     std::array<std::byte, 2048> buffer_;
+///     pw::transfer::ReadAheadReader read_ahead_;
+///   };
+/// @endcode
+///
+/// Each half of the buffer should be at least as large as the transfer window
+/// for reads to be served entirely from prefetched data.
+///
+/// Only the position of the `ReadAheadReader` is meaningful; it seeks the
+/// source as needed before each fetch.
+class ReadAheadReader final : public stream::SeekableReader {
+ public:
+  /// @param[in] source The reader to fetch data from.
+  ///
+  /// @param[in] buffer Storage for read-ahead data, split into two halves.
+  ReadAheadReader(stream::SeekableReader& source, ByteSpan buffer);
+
+  /// Fetches data from the source, if not already buffered, for the reads that
+  /// follow the current position. Errors are not reported; they are returned
+  /// by the `Read()` that needs the data instead.
+  void Prefetch();
+
+  /// Discards all buffered data and returns to position 0. Must be called if
+  /// the source's contents change.
+  void Reset();
+
+ private:
+  // A block of data read from the source.
+  struct Block {
+    bool Contains(size_t position) const {
+      return position >= start && position < start + size;
+    }
+
+    ByteSpan storage;
+    size_t start = 0;
+    size_t size = 0;
+  };
+
+  StatusWithSize DoRead(ByteSpan destination) override;
+  Status DoSeek(ptrdiff_t offset, Whence origin) override;
+  size_t DoTell() override { return position_; }
+
+  // Returns the block that holds the current position, if any.
+  Block* CurrentBlock();
+
+  // Returns the block to fill when neither holds the current position.
+  Block& BlockToReplace();
+
+  // Fills the block with data from the source starting at position.
+  Status Fill(Block& block, size_t position);
+
+  stream::SeekableReader& source_;
+  std::array<Block, 2> blocks_;
+  size_t position_ = 0;
+
+  // Where the source is positioned, or kUnknownPosition before the first read.
+  size_t source_position_ = kUnknownPosition;
+
+  // The position at which the source reported the end of its data, if known.
+  size_t end_ = kUnknownPosition;
+};
+
+}  // namespace pw::transfer
@@ -123,6 +123,13 @@ class TransferService : public pw_rpc::raw::Transfer::Service<TransferService> {
     return OkStatus();
   }
 
+  // Sets whether write transfers adapt their window sizes to the measured
+  // throughput and losses of the transfer, up to the maximum window size.
+  // Should be set while no transfers are active.
+  constexpr void set_adaptive_window(bool adaptive_window) {
+    max_parameters_.set_adaptive_window(adaptive_window);
+  }
+
  private:
   void HandleChunk(ConstByteSpan message, internal::TransferType type);
   void ResourceStatusCallback(Status status,
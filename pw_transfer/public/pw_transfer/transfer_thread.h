@@ -13,6 +13,7 @@
 // the License.
 #pragma once
 
+#include <array>
 #include <cstdint>
 
 #include "pw_assert/assert.h"
@@ -30,6 +31,7 @@
 #include "pw_transfer/internal/config.h"
 #include "pw_transfer/internal/context.h"
 #include "pw_transfer/internal/event.h"
+#include "pw_transfer/internal/reorder_buffer.h"
 #include "pw_transfer/internal/server_context.h"
 
 namespace pw::transfer {
@@ -43,12 +45,14 @@ class TransferThread : public thread::ThreadCore {
   TransferThread(span<ClientContext> client_transfers,
                  span<ServerContext> server_transfers,
                  ByteSpan chunk_buffer,
-                 ByteSpan encode_buffer)
+                 ByteSpan encode_buffer,
+                 ByteSpan reorder_buffer = {})
       : client_transfers_(client_transfers),
         server_transfers_(server_transfers),
         next_session_id_(1),
         chunk_buffer_(chunk_buffer),
-        encode_buffer_(encode_buffer) {}
+        encode_buffer_(encode_buffer),
+        reorder_buffer_(reorder_buffer) {}
 
   void StartClientTransfer(TransferType type,
                            ProtocolVersion version,
@@ -187,6 +191,20 @@ class TransferThread : public thread::ThreadCore {
     SetStream(TransferStream::kClientWrite);
   }
 
+  /// Adds a client write stream on another channel than the client write
+  /// stream, over which write transfers also send data chunks.
+  ///
+  /// Data chunks are striped across the write streams in proportion to their
+  /// measured throughput. Transfer control chunks are only sent on the primary
+  /// client write stream. If `PW_TRANSFER_MAX_DATA_PATHS` streams are already
+  /// in use, the provided stream is cancelled.
+  void AddClientWriteDataPath(rpc::RawClientReaderWriter& write_stream,
+                              Function<void(ConstByteSpan)>&& on_next) {
+    staged_client_stream_ = std::move(write_stream);
+    staged_client_on_next_ = std::move(on_next);
+    SetStream(TransferStream::kClientWriteDataPath);
+  }
+
   /// Updates the transfer thread's server read stream.
   ///
   /// The provided stream should not have an on_next function set. Instead,
@@ -213,8 +231,22 @@ class TransferThread : public thread::ThreadCore {
   ///
   /// If the thread has an existing active server write stream, closes it and
   /// terminates any transfers running on it.
+  ///
+  /// If multipath transfers are enabled and the existing stream is active on
+  /// another channel, the provided stream is instead kept alongside it to
+  /// receive data chunks of write transfers, which clients send on several
+  /// channels. If `PW_TRANSFER_MAX_DATA_PATHS` streams are already in use, the
+  /// provided stream is finished with `RESOURCE_EXHAUSTED`.
   void SetServerWriteStream(rpc::RawServerReaderWriter& write_stream,
                             Function<void(ConstByteSpan)>&& on_next) {
+    if (cfg::kMaxDataPaths > 1 && server_write_stream_.active() &&
+        write_stream.channel_id() != server_write_stream_.channel_id()) {
+      staged_server_stream_ = std::move(write_stream);
+      staged_server_on_next_ = std::move(on_next);
+      SetStream(TransferStream::kServerWriteDataPath);
+      return;
+    }
+
     // Clear the existing callback to prevent incoming chunks from blocking on
     // the transfer thread and preventing the call's cleanup.
     server_write_stream_.set_on_next(nullptr);
@@ -327,8 +359,17 @@ class TransferThread : public thread::ThreadCore {
 
   const ByteSpan& encode_buffer() const { return encode_buffer_; }
 
+  ReorderBuffer& reorder_buffer() { return reorder_buffer_; }
+
+  // Writes a data chunk of a transfer whose primary stream is `primary`. Client
+  // write transfers send the chunk on the data path that is expected to finish
+  // sending it first; other transfers send it on `primary`.
+  Status WriteDataChunk(rpc::Writer& primary, ConstByteSpan chunk);
+
   void Run() final;
 
+  // Handles the timeouts of all timed out transfers. Transmitting transfers
+  // are serviced in weighted round-robin order.
   void HandleTimeouts();
 
   rpc::Writer& stream_for(TransferStream stream) {
@@ -336,10 +377,12 @@ class TransferThread : public thread::ThreadCore {
       case TransferStream::kClientRead:
         return client_read_stream_.as_writer();
       case TransferStream::kClientWrite:
+      case TransferStream::kClientWriteDataPath:
         return client_write_stream_.as_writer();
       case TransferStream::kServerRead:
         return server_read_stream_.as_writer();
       case TransferStream::kServerWrite:
+      case TransferStream::kServerWriteDataPath:
         return server_write_stream_.as_writer();
     }
     // An unknown TransferStream value was passed, which means this function
@@ -391,6 +434,10 @@ class TransferThread : public thread::ThreadCore {
   void SetStream(TransferStream stream);
   void HandleSetStreamEvent(TransferStream stream);
 
+  // Returns the index of the client write data path on which to send a data
+  // chunk of `size_bytes`, where 0 is the primary client write stream.
+  size_t SelectClientDataPath(size_t size_bytes) const;
+
   void TransferHandlerEvent(EventType type, Handler& handler);
 
   void HandleEvent(const Event& event);
@@ -416,6 +463,24 @@ class TransferThread : public thread::ThreadCore {
   rpc::RawServerReaderWriter staged_server_stream_;
   Function<void(ConstByteSpan)> staged_server_on_next_;
 
+  // Write streams on other channels than the primary write streams, which
+  // carry data chunks of multipath write transfers.
+  std::array<rpc::RawClientReaderWriter, cfg::kMaxDataPaths - 1>
+      client_data_paths_;
+  std::array<rpc::RawServerReaderWriter, cfg::kMaxDataPaths - 1>
+      server_data_paths_;
+
+  // The throughput of a client write data path, measured as the time spent
+  // writing data chunks to it. Unlike the overall RateEstimate of a transfer,
+  // this excludes the time the path is idle while other paths are written.
+  struct DataPathRate {
+    uint64_t bytes_written = 0;
+    chrono::SystemClock::duration write_time{};
+  };
+
+  // Rates of the primary client write stream, followed by the data paths.
+  std::array<DataPathRate, cfg::kMaxDataPaths> client_data_path_rates_;
+
   span<ClientContext> client_transfers_;
   span<ServerContext> server_transfers_;
 
@@ -426,6 +491,10 @@ class TransferThread : public thread::ThreadCore {
   // reset to 1.
   uint32_t next_session_id_;
 
+  // Index of the context that HandleTimeouts() services first, counting client
+  // contexts before server contexts.
+  size_t next_scheduled_transfer_ = 0;
+
   // All registered transfer handlers.
   IntrusiveList<Handler> handlers_;
 
@@ -436,6 +505,9 @@ class TransferThread : public thread::ThreadCore {
   // transfer thread, so no locking is required.
   ByteSpan encode_buffer_;
 
+  // Holds data chunks that a receive transfer gets ahead of its offset.
+  ReorderBuffer reorder_buffer_;
+
   ResourceStatusCallback resource_status_callback_ = nullptr;
 };
 
@@ -447,9 +519,18 @@ template <size_t kMaxConcurrentClientTransfers,
           size_t kMaxConcurrentServerTransfers>
 class Thread final : public internal::TransferThread {
  public:
-  Thread(ByteSpan chunk_buffer, ByteSpan encode_buffer)
-      : internal::TransferThread(
-            client_contexts_, server_contexts_, chunk_buffer, encode_buffer) {}
+  // If a `reorder_buffer` is provided, receive transfers hold data chunks that
+  // arrive out of order in it, rather than requesting retransmission. It
+  // should fit at least a few chunks of the largest size that transmitters
+  // send, plus a small header for each.
+  Thread(ByteSpan chunk_buffer,
+         ByteSpan encode_buffer,
+         ByteSpan reorder_buffer = {})
+      : internal::TransferThread(client_contexts_,
+                                 server_contexts_,
+                                 chunk_buffer,
+                                 encode_buffer,
+                                 reorder_buffer) {}
 
  private:
   std::array<internal::ClientContext, kMaxConcurrentClientTransfers>
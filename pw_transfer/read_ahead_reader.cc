@@ -0,0 +1,160 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/read_ahead_reader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pw_assert/check.h"
+#include "pw_result/result.h"
+#include "pw_status/try.h"
+
+namespace pw::transfer {
+
+ReadAheadReader::ReadAheadReader(stream::SeekableReader& source,
+                                 ByteSpan buffer)
+    : source_(source) {
+  PW_CHECK_UINT_GE(buffer.size(), 2u);
+  const size_t half = buffer.size() / 2;
+  blocks_[0].storage = buffer.first(half);
+  blocks_[1].storage = buffer.subspan(half, half);
+}
+
+void ReadAheadReader::Reset() {
+  for (Block& block : blocks_) {
+    block.size = 0;
+  }
+  position_ = 0;
+  source_position_ = kUnknownPosition;
+  end_ = kUnknownPosition;
+}
+
+ReadAheadReader::Block* ReadAheadReader::CurrentBlock() {
+  for (Block& block : blocks_) {
+    if (block.Contains(position_)) {
+      return &block;
+    }
+  }
+  return nullptr;
+}
+
+ReadAheadReader::Block& ReadAheadReader::BlockToReplace() {
+  // Prefer an empty block, then the block that is furthest behind.
+  if (blocks_[0].size == 0) {
+    return blocks_[0];
+  }
+  if (blocks_[1].size == 0) {
+    return blocks_[1];
+  }
+  return blocks_[0].start <= blocks_[1].start ? blocks_[0] : blocks_[1];
+}
+
+void ReadAheadReader::Prefetch() {
+  Block* current = CurrentBlock();
+  if (current == nullptr) {
+    if (position_ >= end_) {
+      return;
+    }
+    current = &BlockToReplace();
+    if (!Fill(*current, position_).ok() || current->size == 0) {
+      return;
+    }
+  }
+
+  const size_t next = current->start + current->size;
+  Block& other = current == &blocks_[0] ? blocks_[1] : blocks_[0];
+  if (next < end_ && !other.Contains(next)) {
+    Fill(other, next).IgnoreError();  // Read() reports any error.
+  }
+}
+
+StatusWithSize ReadAheadReader::DoRead(ByteSpan destination) {
+  size_t copied = 0;
+
+  while (copied < destination.size()) {
+    Block* block = CurrentBlock();
+    if (block == nullptr) {
+      if (position_ >= end_) {
+        break;
+      }
+      block = &BlockToReplace();
+      if (Status status = Fill(*block, position_); !status.ok()) {
+        if (copied != 0) {
+          break;  // Return what was read; the next read reports the error.
+        }
+        return StatusWithSize(status, 0);
+      }
+      if (block->size == 0) {
+        break;
+      }
+    }
+
+    const size_t offset = position_ - block->start;
+    const size_t count =
+        std::min(destination.size() - copied, block->size - offset);
+    std::memcpy(
+        destination.data() + copied, block->storage.data() + offset, count);
+    copied += count;
+    position_ += count;
+  }
+
+  if (copied == 0 && !destination.empty()) {
+    return StatusWithSize::OutOfRange();
+  }
+  return StatusWithSize(copied);
+}
+
+Status ReadAheadReader::Fill(Block& block, size_t position) {
+  block.size = 0;
+  if (source_position_ != position) {
+    source_position_ = kUnknownPosition;
+    PW_TRY(source_.Seek(static_cast<ptrdiff_t>(position)));
+    source_position_ = position;
+  }
+
+  Result<ByteSpan> result = source_.Read(block.storage);
+  if (result.status().IsOutOfRange()) {
+    end_ = position;
+    return OkStatus();
+  }
+  PW_TRY(result.status());
+
+  block.start = position;
+  block.size = result->size();
+  source_position_ = position + block.size;
+  return OkStatus();
+}
+
+Status ReadAheadReader::DoSeek(ptrdiff_t offset, Whence origin) {
+  ptrdiff_t base;
+  switch (origin) {
+    case Whence::kBeginning:
+      base = 0;
+      break;
+    case Whence::kCurrent:
+      base = static_cast<ptrdiff_t>(position_);
+      break;
+    case Whence::kEnd:
+    default:
+      return Status::Unimplemented();
+  }
+  if (offset < -base) {
+    return Status::OutOfRange();
+  }
+  position_ = static_cast<size_t>(base + offset);
+  return OkStatus();
+}
+
+}  // namespace pw::transfer
@@ -0,0 +1,163 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/read_ahead_reader.h"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+#include "pw_bytes/span.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::transfer {
+namespace {
+
+// A source that counts how often it is read.
+class CountingReader : public stream::SeekableReader {
+ public:
+  explicit CountingReader(ConstByteSpan data) : reader_(data) {}
+
+  size_t reads() const { return reads_; }
+  void set_status(Status status) { status_ = status; }
+
+ private:
+  StatusWithSize DoRead(ByteSpan destination) override {
+    ++reads_;
+    if (!status_.ok()) {
+      return StatusWithSize(status_, 0);
+    }
+    Result<ByteSpan> result = reader_.Read(destination);
+    if (!result.ok()) {
+      return StatusWithSize(result.status(), 0);
+    }
+    return StatusWithSize(result->size());
+  }
+
+  Status DoSeek(ptrdiff_t offset, Whence origin) override {
+    return reader_.Seek(offset, origin);
+  }
+
+  stream::MemoryReader reader_;
+  size_t reads_ = 0;
+  Status status_;
+};
+
+class ReadAheadReaderTest : public ::testing::Test {
+ protected:
+  ReadAheadReaderTest() : source_(data_), reader_(source_, buffer_) {
+    for (size_t i = 0; i < data_.size(); ++i) {
+      data_[i] = static_cast<std::byte>(i);
+    }
+  }
+
+  // Reads size bytes and checks that they match the source at the position.
+  void ExpectRead(size_t size) {
+    const size_t position = reader_.Tell();
+    std::array<std::byte, 64> chunk{};
+    Result<ByteSpan> result = reader_.Read(span(chunk).first(size));
+    ASSERT_EQ(result.status(), OkStatus());
+    ASSERT_EQ(result->size(), size);
+    EXPECT_EQ(std::memcmp(result->data(), data_.data() + position, size), 0);
+  }
+
+  std::array<std::byte, 100> data_{};
+  CountingReader source_;
+  std::array<std::byte, 32> buffer_;
+  ReadAheadReader reader_;
+};
+
+TEST_F(ReadAheadReaderTest, ReadsInBlocks) {
+  for (int i = 0; i < 4; ++i) {
+    ExpectRead(4);
+  }
+  EXPECT_EQ(source_.reads(), 1u);
+
+  // A read that spans blocks is not shortened.
+  ExpectRead(10);
+  EXPECT_EQ(source_.reads(), 2u);
+  EXPECT_EQ(reader_.Tell(), 26u);
+}
+
+TEST_F(ReadAheadReaderTest, PrefetchFillsNextBlock) {
+  reader_.Prefetch();
+  EXPECT_EQ(source_.reads(), 2u);
+
+  ExpectRead(32);
+  EXPECT_EQ(source_.reads(), 2u);
+
+  // Prefetching again fetches the next two blocks.
+  reader_.Prefetch();
+  EXPECT_EQ(source_.reads(), 4u);
+  reader_.Prefetch();
+  EXPECT_EQ(source_.reads(), 4u);
+  ExpectRead(32);
+  EXPECT_EQ(source_.reads(), 4u);
+}
+
+TEST_F(ReadAheadReaderTest, ReadsToEnd) {
+  reader_.Prefetch();
+  for (int i = 0; i < 6; ++i) {
+    ExpectRead(16);
+  }
+  ExpectRead(4);
+
+  std::array<std::byte, 16> chunk;
+  EXPECT_EQ(reader_.Read(chunk).status(), Status::OutOfRange());
+
+  // The end is remembered, so further reads and prefetches are free.
+  const size_t reads = source_.reads();
+  EXPECT_EQ(reader_.Read(chunk).status(), Status::OutOfRange());
+  reader_.Prefetch();
+  EXPECT_EQ(source_.reads(), reads);
+}
+
+TEST_F(ReadAheadReaderTest, SeekWithinBufferedData) {
+  reader_.Prefetch();
+  ExpectRead(20);
+
+  // Seeking back, as for a retransmit, reuses the buffered data.
+  ASSERT_EQ(reader_.Seek(8), OkStatus());
+  ExpectRead(20);
+  EXPECT_EQ(source_.reads(), 2u);
+
+  ASSERT_EQ(reader_.Seek(70), OkStatus());
+  ExpectRead(8);
+  EXPECT_EQ(source_.reads(), 3u);
+}
+
+TEST_F(ReadAheadReaderTest, ReportsSourceErrors) {
+  source_.set_status(Status::DataLoss());
+  reader_.Prefetch();
+
+  std::array<std::byte, 4> chunk;
+  EXPECT_EQ(reader_.Read(chunk).status(), Status::DataLoss());
+
+  source_.set_status(OkStatus());
+  ExpectRead(4);
+}
+
+TEST_F(ReadAheadReaderTest, Reset) {
+  ExpectRead(8);
+  reader_.Reset();
+  EXPECT_EQ(reader_.Tell(), 0u);
+
+  data_[0] = std::byte{0xFF};
+  ExpectRead(8);
+  EXPECT_EQ(source_.reads(), 2u);
+}
+
+}  // namespace
+}  // namespace pw::transfer
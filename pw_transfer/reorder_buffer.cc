@@ -0,0 +1,100 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/reorder_buffer.h"
+
+#include <cstring>
+
+namespace pw::transfer::internal {
+
+ReorderBuffer::Header ReorderBuffer::HeaderAt(size_t position) const {
+  Header header;
+  std::memcpy(&header, &buffer_[position], sizeof(header));
+  return header;
+}
+
+bool ReorderBuffer::Hold(const void* owner,
+                         uint32_t offset,
+                         ConstByteSpan payload,
+                         bool final_chunk) {
+  if (used_ != 0 && owner != owner_) {
+    return false;
+  }
+  if (Find(owner, offset).has_value()) {
+    return true;
+  }
+
+  const size_t record_size = sizeof(Header) + payload.size();
+  if (record_size > buffer_.size() - used_) {
+    return false;
+  }
+
+  const Header header{
+      offset,
+      static_cast<uint32_t>(payload.size()),
+      final_chunk,
+  };
+  std::memcpy(&buffer_[used_], &header, sizeof(header));
+  if (!payload.empty()) {
+    std::memcpy(
+        &buffer_[used_ + sizeof(header)], payload.data(), payload.size());
+  }
+  used_ += record_size;
+  owner_ = owner;
+  return true;
+}
+
+std::optional<ReorderBuffer::HeldChunk> ReorderBuffer::Find(
+    const void* owner, uint32_t offset) const {
+  if (owner != owner_) {
+    return std::nullopt;
+  }
+
+  for (size_t position = 0; position < used_;) {
+    const Header header = HeaderAt(position);
+    if (header.offset == offset) {
+      return HeldChunk{
+          offset,
+          ConstByteSpan(buffer_).subspan(position + sizeof(header),
+                                         header.size),
+          header.final_chunk,
+      };
+    }
+    position += sizeof(header) + header.size;
+  }
+  return std::nullopt;
+}
+
+void ReorderBuffer::ReleaseBefore(const void* owner, uint32_t offset) {
+  if (owner != owner_) {
+    return;
+  }
+
+  // Compact the chunks that are kept towards the start of the buffer.
+  size_t kept = 0;
+  for (size_t position = 0; position < used_;) {
+    const Header header = HeaderAt(position);
+    const size_t record_size = sizeof(header) + header.size;
+    if (header.offset >= offset) {
+      if (kept != position) {
+        std::memmove(&buffer_[kept], &buffer_[position], record_size);
+      }
+      kept += record_size;
+    }
+    position += record_size;
+  }
+  used_ = kept;
+}
+
+}  // namespace pw::transfer::internal
@@ -0,0 +1,97 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_transfer/internal/reorder_buffer.h"
+
+#include <array>
+#include <cstring>
+
+#include "pw_bytes/array.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::transfer::internal {
+namespace {
+
+constexpr auto kData = bytes::Initialized<32>([](size_t i) { return i; });
+
+class ReorderBufferTest : public ::testing::Test {
+ protected:
+  ReorderBufferTest() : reorder_(buffer_) {}
+
+  const int transfer_ = 0;
+  const int other_transfer_ = 0;
+
+  std::array<std::byte, 64> buffer_{};
+  ReorderBuffer reorder_;
+};
+
+TEST_F(ReorderBufferTest, HeldChunkIsFoundAtItsOffset) {
+  ASSERT_TRUE(reorder_.Hold(&transfer_, 16, span(kData).subspan(16, 8), false));
+  EXPECT_FALSE(reorder_.empty());
+  EXPECT_FALSE(reorder_.Find(&transfer_, 8).has_value());
+
+  std::optional<ReorderBuffer::HeldChunk> chunk = reorder_.Find(&transfer_, 16);
+  ASSERT_TRUE(chunk.has_value());
+  EXPECT_EQ(chunk->offset, 16u);
+  EXPECT_FALSE(chunk->final_chunk);
+  ASSERT_EQ(chunk->payload.size(), 8u);
+  EXPECT_EQ(std::memcmp(chunk->payload.data(), &kData[16], 8), 0);
+}
+
+TEST_F(ReorderBufferTest, HoldsChunksOfOneTransferAtATime) {
+  ASSERT_TRUE(reorder_.Hold(&transfer_, 8, span(kData).subspan(8, 8), false));
+  EXPECT_FALSE(
+      reorder_.Hold(&other_transfer_, 8, span(kData).subspan(8, 8), false));
+  EXPECT_FALSE(reorder_.Find(&other_transfer_, 8).has_value());
+
+  reorder_.Clear(&other_transfer_);
+  EXPECT_FALSE(reorder_.empty());
+  reorder_.Clear(&transfer_);
+  EXPECT_TRUE(reorder_.empty());
+
+  EXPECT_TRUE(
+      reorder_.Hold(&other_transfer_, 8, span(kData).subspan(8, 8), false));
+}
+
+TEST_F(ReorderBufferTest, RejectsChunksThatDoNotFit) {
+  ASSERT_TRUE(reorder_.Hold(&transfer_, 8, span(kData).subspan(8, 24), false));
+  EXPECT_FALSE(reorder_.Hold(&transfer_, 32, kData, false));
+
+  // Holding a chunk again does not use more space.
+  EXPECT_TRUE(reorder_.Hold(&transfer_, 8, span(kData).subspan(8, 24), false));
+}
+
+TEST_F(ReorderBufferTest, ReleaseBefore_KeepsLaterChunks) {
+  ASSERT_TRUE(reorder_.Hold(&transfer_, 24, span(kData).subspan(24, 8), true));
+  ASSERT_TRUE(reorder_.Hold(&transfer_, 8, span(kData).subspan(8, 8), false));
+  ASSERT_TRUE(reorder_.Hold(&transfer_, 16, span(kData).subspan(16, 8), false));
+
+  reorder_.ReleaseBefore(&transfer_, 16);
+  EXPECT_FALSE(reorder_.Find(&transfer_, 8).has_value());
+
+  std::optional<ReorderBuffer::HeldChunk> chunk = reorder_.Find(&transfer_, 16);
+  ASSERT_TRUE(chunk.has_value());
+  EXPECT_EQ(std::memcmp(chunk->payload.data(), &kData[16], 8), 0);
+
+  chunk = reorder_.Find(&transfer_, 24);
+  ASSERT_TRUE(chunk.has_value());
+  EXPECT_TRUE(chunk->final_chunk);
+  EXPECT_EQ(std::memcmp(chunk->payload.data(), &kData[24], 8), 0);
+
+  reorder_.ReleaseBefore(&transfer_, 32);
+  EXPECT_TRUE(reorder_.empty());
+}
+
+}  // namespace
+}  // namespace pw::transfer::internal
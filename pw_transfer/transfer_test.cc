@@ -97,6 +97,8 @@ class SimpleReadTransfer : public ReadOnlyHandler {
     finalize_read_status = status;
   }
 
+  void PrefetchRead() final { prefetch_read_calls += 1; }
+
   size_t ResourceSize() const final { return resource_size_; }
 
   void set_resource_size(size_t resource_size) {
@@ -107,6 +109,7 @@ class SimpleReadTransfer : public ReadOnlyHandler {
 
   bool prepare_read_called;
   bool finalize_read_called;
+  int prefetch_read_calls = 0;
   Status prepare_read_return_status;
   Status finalize_read_status;
   size_t resource_size_;
@@ -211,6 +214,9 @@ TEST_F(ReadTransfer, MultiChunk) {
   EXPECT_EQ(std::memcmp(c0.payload().data(), kData.data(), c0.payload().size()),
             0);
 
+  // The handler may fetch the next window while waiting for the receiver.
+  EXPECT_EQ(handler_.prefetch_read_calls, 1);
+
   ctx_.SendClientStream(EncodeChunk(
       Chunk(ProtocolVersion::kLegacy, Chunk::Type::kParametersContinue)
           .set_session_id(3)
@@ -242,6 +248,7 @@ TEST_F(ReadTransfer, MultiChunk) {
   EXPECT_FALSE(c2.has_payload());
   ASSERT_TRUE(c2.remaining_bytes().has_value());
   EXPECT_EQ(c2.remaining_bytes().value(), 0u);
+  EXPECT_EQ(handler_.prefetch_read_calls, 2);
 
   ctx_.SendClientStream(
       EncodeChunk(Chunk::Final(ProtocolVersion::kLegacy, 3, OkStatus())));
@@ -1044,6 +1051,121 @@ TEST_F(WriteTransfer, ExtendWindow) {
   EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
 }
 
+class WriteTransferWithReorderBuffer : public ::testing::Test {
+ protected:
+  WriteTransferWithReorderBuffer()
+      : buffer{},
+        handler_(7, buffer),
+        transfer_thread_(data_buffer_, encode_buffer_, reorder_buffer_),
+        system_thread_(TransferThreadOptions(), transfer_thread_),
+        ctx_(transfer_thread_,
+             64,
+             // Use a long timeout to avoid accidentally triggering timeouts.
+             std::chrono::minutes(1),
+             /*max_retries=*/3) {
+    ctx_.service().RegisterHandler(handler_);
+    ctx_.call();  // Open the write stream
+    transfer_thread_.WaitUntilEventIsProcessed();
+  }
+
+  ~WriteTransferWithReorderBuffer() override {
+    transfer_thread_.Terminate();
+    system_thread_.join();
+  }
+
+  std::array<std::byte, kData.size()> buffer;
+  SimpleWriteTransfer handler_;
+
+  Thread<1, 1> transfer_thread_;
+  thread::Thread system_thread_;
+  std::array<std::byte, 64> data_buffer_;
+  std::array<std::byte, 64> encode_buffer_;
+  std::array<std::byte, 64> reorder_buffer_;
+  PW_RAW_TEST_METHOD_CONTEXT(TransferService, Write) ctx_;
+};
+
+TEST_F(WriteTransferWithReorderBuffer, ChunksAheadOfOffset_AreHeld) {
+  ctx_.SendClientStream(EncodeChunk(
+      Chunk(ProtocolVersion::kLegacy, Chunk::Type::kStart).set_session_id(7)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.window_end_offset(), 32u);
+
+  constexpr span data(kData);
+
+  // Chunks striped across channels arrive out of order.
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                      .set_session_id(7)
+                      .set_offset(8)
+                      .set_payload(data.subspan(8, 8))));
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                      .set_session_id(7)
+                      .set_offset(0)
+                      .set_payload(data.first(8))));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  // Both chunks were written, so the window is extended rather than
+  // retransmitted.
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.offset(), 16u);
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersContinue);
+  EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), 16), 0);
+
+  // The final chunk is held until the data before it arrives.
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                      .set_session_id(7)
+                      .set_offset(24)
+                      .set_payload(data.subspan(24))
+                      .set_remaining_bytes(0)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  EXPECT_FALSE(handler_.finalize_write_called);
+
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                      .set_session_id(7)
+                      .set_offset(16)
+                      .set_payload(data.subspan(16, 8))));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  ASSERT_EQ(ctx_.total_responses(), 3u);
+  chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.session_id(), 7u);
+  ASSERT_TRUE(chunk.status().has_value());
+  EXPECT_EQ(chunk.status().value(), OkStatus());
+
+  EXPECT_TRUE(handler_.finalize_write_called);
+  EXPECT_EQ(handler_.finalize_write_status, OkStatus());
+  EXPECT_EQ(std::memcmp(buffer.data(), kData.data(), kData.size()), 0);
+}
+
+TEST_F(WriteTransferWithReorderBuffer, ChunkBeyondWindow_EntersRecovery) {
+  ctx_.SendClientStream(EncodeChunk(
+      Chunk(ProtocolVersion::kLegacy, Chunk::Type::kStart).set_session_id(7)));
+  transfer_thread_.WaitUntilEventIsProcessed();
+  ASSERT_EQ(ctx_.total_responses(), 1u);
+
+  ctx_.SendClientStream(
+      EncodeChunk(Chunk(ProtocolVersion::kLegacy, Chunk::Type::kData)
+                      .set_session_id(7)
+                      .set_offset(28)
+                      .set_payload(span(kData).first(8))));
+  transfer_thread_.WaitUntilEventIsProcessed();
+
+  // The chunk does not fit in the window, so it is not held.
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  Chunk chunk = DecodeChunk(ctx_.responses().back());
+  EXPECT_EQ(chunk.session_id(), 7u);
+  EXPECT_EQ(chunk.offset(), 0u);
+  EXPECT_EQ(chunk.type(), Chunk::Type::kParametersRetransmit);
+}
+
 class WriteTransferMaxBytes16 : public WriteTransfer {
  protected:
   WriteTransferMaxBytes16() : WriteTransfer(/*max_bytes_to_receive=*/16) {}
@@ -28,6 +28,29 @@ PW_MODIFY_DIAGNOSTICS_PUSH();
 PW_MODIFY_DIAGNOSTIC(ignored, "-Wmissing-field-initializers");
 
 namespace pw::transfer::internal {
+namespace {
+
+// Amount of data sent on a client data path after which the rates of all
+// paths start to decay.
+constexpr uint64_t kDataPathRateWindowBytes = 64 * 1024;
+
+// Moves `stream` into the first inactive data path, and returns whether there
+// was one.
+template <typename DataPaths, typename Stream>
+bool AddDataPath(DataPaths& data_paths,
+                 Stream& stream,
+                 Function<void(ConstByteSpan)>& on_next) {
+  for (Stream& data_path : data_paths) {
+    if (!data_path.active()) {
+      data_path = std::move(stream);
+      data_path.set_on_next(std::move(on_next));
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
 
 void TransferThread::Terminate() {
   next_event_ownership_.acquire();
@@ -69,17 +92,45 @@ void TransferThread::Run() {
 
     // Regardless of whether an event was received or not, check for any
     // transfers which have timed out and process them if so.
-    for (Context& context : client_transfers_) {
-      if (context.timed_out()) {
-        context.HandleEvent({.type = EventType::kClientTimeout});
-      }
-    }
-    for (Context& context : server_transfers_) {
-      if (context.timed_out()) {
-        context.HandleEvent({.type = EventType::kServerTimeout});
-      }
+    HandleTimeouts();
+  }
+}
+
+void TransferThread::HandleTimeouts() {
+  const size_t num_client_transfers = client_transfers_.size();
+  const size_t num_transfers = num_client_transfers + server_transfers_.size();
+  if (num_transfers == 0) {
+    return;
+  }
+
+  // Contexts are serviced in turn, starting one later on each pass, so that no
+  // transfer is consistently served ahead of the others.
+  for (size_t i = 0; i < num_transfers; ++i) {
+    const size_t index = (next_scheduled_transfer_ + i) % num_transfers;
+    const bool is_client = index < num_client_transfers;
+    Context& context =
+        is_client
+            ? static_cast<Context&>(client_transfers_[index])
+            : static_cast<Context&>(
+                  server_transfers_[index - num_client_transfers]);
+
+    if (!context.timed_out()) {
+      continue;
     }
+
+    // A transmitting transfer whose inter-chunk delay has elapsed sends up to
+    // its scheduling weight of chunks before the next transfer is serviced.
+    // Any other timeout is handled once.
+    const Event timeout = {.type = is_client ? EventType::kClientTimeout
+                                             : EventType::kServerTimeout};
+    uint8_t chunks = 0;
+    do {
+      context.HandleEvent(timeout);
+    } while (++chunks < context.scheduling_weight() &&
+             context.transmitting() && context.timed_out());
   }
+
+  next_scheduled_transfer_ = (next_scheduled_transfer_ + 1) % num_transfers;
 }
 
 chrono::SystemClock::time_point TransferThread::GetNextTransferTimeout() const {
@@ -339,6 +390,12 @@ void TransferThread::HandleEvent(const internal::Event& event) {
       client_write_stream_.Cancel().IgnoreError();
       server_read_stream_.Finish(Status::Aborted()).IgnoreError();
       server_write_stream_.Finish(Status::Aborted()).IgnoreError();
+      for (rpc::RawClientReaderWriter& data_path : client_data_paths_) {
+        data_path.Cancel().IgnoreError();
+      }
+      for (rpc::RawServerReaderWriter& data_path : server_data_paths_) {
+        data_path.Finish(Status::Aborted()).IgnoreError();
+      }
       return;
 
     case EventType::kSendStatusChunk:
@@ -566,7 +623,100 @@ void TransferThread::HandleSetStreamEvent(TransferStream stream) {
       server_write_stream_ = std::move(staged_server_stream_);
       server_write_stream_.set_on_next(std::move(staged_server_on_next_));
       break;
+    case TransferStream::kClientWriteDataPath:
+      if (!AddDataPath(client_data_paths_,
+                       staged_client_stream_,
+                       staged_client_on_next_)) {
+        PW_LOG_WARN("No free client data path for channel %u",
+                    static_cast<unsigned>(staged_client_stream_.channel_id()));
+        staged_client_stream_.Cancel().IgnoreError();
+        break;
+      }
+      // Measure the throughput of every path afresh, so that the new path is
+      // not sent all data until its write time catches up with the others.
+      client_data_path_rates_.fill({});
+      break;
+    case TransferStream::kServerWriteDataPath:
+      if (!AddDataPath(server_data_paths_,
+                       staged_server_stream_,
+                       staged_server_on_next_)) {
+        PW_LOG_WARN("No free server data path for channel %u",
+                    static_cast<unsigned>(staged_server_stream_.channel_id()));
+        staged_server_stream_.Finish(Status::ResourceExhausted())
+            .IgnoreError();
+      }
+      break;
+  }
+}
+
+size_t TransferThread::SelectClientDataPath(size_t size_bytes) const {
+  // Send the chunk on the path whose total write time would be lowest after
+  // sending it at the path's measured rate. Over time, this keeps every path
+  // busy for the same share of time, so each is sent data in proportion to its
+  // throughput. Ties, e.g. between paths that have not been measured yet, go
+  // to the path that has been sent the least data.
+  const auto projected_write_time = [this, size_bytes](size_t index) {
+    const DataPathRate& rate = client_data_path_rates_[index];
+    const uint64_t write_time = static_cast<uint64_t>(rate.write_time.count());
+    if (rate.bytes_written == 0) {
+      return write_time;
+    }
+    return write_time + write_time * size_bytes / rate.bytes_written;
+  };
+
+  size_t selected = 0;
+  uint64_t selected_time = projected_write_time(0);
+  for (size_t i = 1; i < client_data_path_rates_.size(); ++i) {
+    if (!client_data_paths_[i - 1].active()) {
+      continue;
+    }
+    const uint64_t time = projected_write_time(i);
+    if (time < selected_time ||
+        (time == selected_time &&
+         client_data_path_rates_[i].bytes_written <
+             client_data_path_rates_[selected].bytes_written)) {
+      selected = i;
+      selected_time = time;
+    }
+  }
+  return selected;
+}
+
+Status TransferThread::WriteDataChunk(rpc::Writer& primary,
+                                      ConstByteSpan chunk) {
+  if constexpr (cfg::kMaxDataPaths > 1) {
+    if (&primary == &client_write_stream_.as_writer()) {
+      const size_t path = SelectClientDataPath(chunk.size());
+      rpc::Writer& writer =
+          path == 0 ? primary : client_data_paths_[path - 1].as_writer();
+
+      const chrono::SystemClock::time_point start = chrono::SystemClock::now();
+      Status status = writer.Write(chunk);
+      if (!status.ok() && path != 0) {
+        // The data path failed; fall back to the primary stream.
+        PW_LOG_WARN("Client data path on channel %u failed with status %d",
+                    static_cast<unsigned>(writer.channel_id()),
+                    status.code());
+        client_data_paths_[path - 1].Cancel().IgnoreError();
+        return primary.Write(chunk);
+      }
+
+      DataPathRate& rate = client_data_path_rates_[path];
+      rate.bytes_written += chunk.size();
+      rate.write_time += chrono::SystemClock::now() - start;
+
+      // Halve the measurements of all paths once they cover enough data, so
+      // that the rates follow changes in the links.
+      if (rate.bytes_written >= kDataPathRateWindowBytes) {
+        for (DataPathRate& path_rate : client_data_path_rates_) {
+          path_rate.bytes_written /= 2;
+          path_rate.write_time /= 2;
+        }
+      }
+      return status;
+    }
   }
+  return primary.Write(chunk);
 }
 
 // Adds GetResourceStatusEvent to the queue. Will fail if there is already a
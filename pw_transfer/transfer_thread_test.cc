@@ -203,6 +203,41 @@ TEST_F(TransferThreadTest, ProcessChunk_SendsWindow) {
   transfer_thread_.RemoveTransferHandler(handler);
 }
 
+TEST_F(TransferThreadTest, ProcessChunk_SchedulingWeightStopsAtWindowEnd) {
+  auto reader_writer = ctx_.reader_writer();
+  transfer_thread_.SetServerReadStream(reader_writer, [](ConstByteSpan) {});
+
+  SimpleReadTransfer handler(3, kData);
+  handler.set_scheduling_weight(4);
+  transfer_thread_.AddTransferHandler(handler);
+
+  rpc::test::WaitForPackets(ctx_.output(), 2, [this] {
+    transfer_thread_.StartServerTransfer(
+        internal::TransferType::kTransmit,
+        ProtocolVersion::kLegacy,
+        3,
+        3,
+        EncodeChunk(
+            Chunk(ProtocolVersion::kLegacy, Chunk::Type::kParametersRetransmit)
+                .set_session_id(3)
+                .set_window_end_offset(16)
+                .set_max_chunk_size_bytes(8)
+                .set_offset(0)),
+        max_parameters_,
+        kNeverTimeout,
+        3,
+        10);
+  });
+
+  // Servicing the transfer more than once does not send past the window.
+  transfer_thread_.WaitUntilEventIsProcessed();
+  ASSERT_EQ(ctx_.total_responses(), 2u);
+  EXPECT_EQ(DecodeChunk(ctx_.responses()[0]).offset(), 0u);
+  EXPECT_EQ(DecodeChunk(ctx_.responses()[1]).offset(), 8u);
+
+  transfer_thread_.RemoveTransferHandler(handler);
+}
+
 TEST_F(TransferThreadTest, StartTransferExhausted_Server) {
   auto reader_writer = ctx_.reader_writer();
   transfer_thread_.SetServerReadStream(reader_writer, [](ConstByteSpan) {});
@@ -0,0 +1,134 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/poll.h"
+#include "pw_bytes/span.h"
+#include "pw_channel/channel.h"
+#include "pw_multibuf/allocator.h"
+#include "pw_multibuf/multibuf.h"
+#include "pw_result/result.h"
+#include "pw_status/status.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/lock_annotations.h"
+
+namespace pw::uart {
+
+/// @addtogroup pw_uart
+/// @{
+
+/// @brief Base class for UART drivers that move data with DMA and expose it as
+/// a `pw_channel` byte channel.
+///
+/// Reception runs continuously: the backend programs a circular DMA transfer
+/// into `rx_ring()` and reports how far it has written by calling
+/// `ReceiveProgress` from its half-full, full, and idle-line interrupts. Each
+/// `PendRead` returns everything received since the previous read, copied
+/// into a `MultiBuf` from the channel's allocator, so data is delivered once
+/// per burst rather than per byte. The backend must report progress at least
+/// once every half ring; if unread data is overwritten, the next read returns
+/// `DATA_LOSS` and reception resumes with new data.
+///
+/// Each written `MultiBuf` is transmitted one chunk at a time with
+/// `DoStartTransmit`, and the backend reports each chunk with
+/// `TransmitComplete`.
+///
+/// `ReceiveProgress` and `TransmitComplete` may be called from interrupts.
+class UartDmaChannel : public channel::ByteReaderWriter {
+ public:
+  /// @param rx_ring    The buffer the backend's circular receive DMA writes
+  ///                   into. Its size bounds how long reads may be delayed.
+  /// @param allocator  Allocates the `MultiBuf` returned by each read, and is
+  ///                   the channel's write allocator.
+  UartDmaChannel(ByteSpan rx_ring, multibuf::MultiBufAllocator& allocator)
+      : rx_ring_(rx_ring), allocator_(allocator) {}
+
+  UartDmaChannel(const UartDmaChannel&) = delete;
+  UartDmaChannel& operator=(const UartDmaChannel&) = delete;
+
+ protected:
+  ByteSpan rx_ring() const { return rx_ring_; }
+
+  /// Reports that the receive DMA has written the ring up to, but not
+  /// including, `write_index`, and wakes the reader if there is new data.
+  void ReceiveProgress(size_t write_index) PW_LOCKS_EXCLUDED(lock_);
+
+  /// Reports that received data was lost before reaching the ring, e.g. due
+  /// to a UART overrun. The next read returns `DATA_LOSS`.
+  void ReceiveError() PW_LOCKS_EXCLUDED(lock_);
+
+  /// Reports that the transmission started by the last call to
+  /// `DoStartTransmit` finished, and starts the next chunk of the write.
+  void TransmitComplete(Status status) PW_LOCKS_EXCLUDED(lock_);
+
+ private:
+  /// Starts transmitting `data` without blocking. The backend calls
+  /// `TransmitComplete` once it has been sent. Returning an error ends the
+  /// current write with that error.
+  virtual Status DoStartTransmit(ConstByteSpan data) = 0;
+
+  /// Called before each read. Backends that cannot raise an interrupt when
+  /// the line goes idle may sample the DMA position here and call
+  /// `ReceiveProgress`.
+  virtual void DoUpdateReceiveProgress() {}
+
+  // pw::channel::ByteReaderWriter implementation.
+  async2::Poll<Result<multibuf::MultiBuf>> DoPendRead(
+      async2::Context& cx) override;
+  multibuf::MultiBufAllocator& DoGetWriteAllocator() override {
+    return allocator_;
+  }
+  async2::Poll<Status> DoPendReadyToWrite(async2::Context& cx) override;
+  Result<channel::WriteToken> DoWrite(multibuf::MultiBuf&& data) override;
+  async2::Poll<Result<channel::WriteToken>> DoPendFlush(
+      async2::Context& cx) override;
+  async2::Poll<Status> DoPendClose(async2::Context& cx) override;
+
+  // Copies `size` bytes of the ring, starting at `index`, into `buffer`.
+  void CopyFromRing(size_t index, size_t size, multibuf::MultiBuf& buffer);
+
+  // Ends the current write, and returns the waker to wake.
+  async2::Waker FinishTransmitLocked(Status status)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  sync::InterruptSpinLock lock_;
+  const ByteSpan rx_ring_;
+  multibuf::MultiBufAllocator& allocator_;
+
+  // Receive state.
+  size_t rx_read_index_ PW_GUARDED_BY(lock_) = 0;
+  size_t rx_write_index_ PW_GUARDED_BY(lock_) = 0;
+  size_t rx_available_ PW_GUARDED_BY(lock_) = 0;
+  bool rx_data_lost_ PW_GUARDED_BY(lock_) = false;
+  async2::Waker read_waker_ PW_GUARDED_BY(lock_);
+  std::optional<multibuf::MultiBufAllocationFuture> read_allocation_;
+
+  // Transmit state. While a write is in progress, tx_data_ is only accessed
+  // from TransmitComplete.
+  multibuf::MultiBuf tx_data_;
+  multibuf::MultiBuf::ChunkIterator tx_chunk_ PW_GUARDED_BY(lock_);
+  bool tx_busy_ PW_GUARDED_BY(lock_) = false;
+  Status tx_status_ PW_GUARDED_BY(lock_);
+  uint32_t write_token_ PW_GUARDED_BY(lock_) = 0;
+  async2::Waker write_waker_ PW_GUARDED_BY(lock_);
+};
+
+/// @}
+
+}  // namespace pw::uart
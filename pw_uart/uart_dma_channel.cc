@@ -0,0 +1,240 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_uart/uart_dma_channel.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "pw_assert/check.h"
+
+namespace pw::uart {
+
+using ::pw::async2::Context;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+using ::pw::async2::WaitReason;
+using ::pw::async2::Waker;
+using ::pw::channel::WriteToken;
+using ::pw::multibuf::MultiBuf;
+
+void UartDmaChannel::ReceiveProgress(size_t write_index) {
+  Waker waker;
+  {
+    std::lock_guard lock(lock_);
+    const size_t ring_size = rx_ring_.size();
+    write_index %= ring_size;
+    const size_t received =
+        (write_index + ring_size - rx_write_index_) % ring_size;
+    if (received == 0) {
+      return;
+    }
+    rx_write_index_ = write_index;
+    rx_available_ += received;
+    if (rx_available_ > ring_size) {
+      // The DMA overwrote data that had not been read. Drop everything that
+      // was in the ring and resume from the current position.
+      rx_data_lost_ = true;
+      rx_available_ = 0;
+      rx_read_index_ = rx_write_index_;
+    }
+    waker = std::move(read_waker_);
+  }
+  std::move(waker).Wake();
+}
+
+void UartDmaChannel::ReceiveError() {
+  Waker waker;
+  {
+    std::lock_guard lock(lock_);
+    rx_data_lost_ = true;
+    waker = std::move(read_waker_);
+  }
+  std::move(waker).Wake();
+}
+
+void UartDmaChannel::TransmitComplete(Status status) {
+  Waker waker;
+  ConstByteSpan next;
+  {
+    std::lock_guard lock(lock_);
+    if (!tx_busy_) {
+      return;
+    }
+    if (status.ok()) {
+      do {
+        ++tx_chunk_;
+      } while (tx_chunk_ != tx_data_.Chunks().end() && tx_chunk_->empty());
+    }
+    if (!status.ok() || tx_chunk_ == tx_data_.Chunks().end()) {
+      waker = FinishTransmitLocked(status);
+    } else {
+      next = ConstByteSpan(tx_chunk_->data(), tx_chunk_->size());
+    }
+  }
+
+  if (!next.empty()) {
+    if (Status start_status = DoStartTransmit(next); !start_status.ok()) {
+      std::lock_guard lock(lock_);
+      waker = FinishTransmitLocked(start_status);
+    }
+  }
+  std::move(waker).Wake();
+}
+
+Waker UartDmaChannel::FinishTransmitLocked(Status status) {
+  tx_busy_ = false;
+  tx_status_.Update(status);
+  return std::move(write_waker_);
+}
+
+Poll<Result<MultiBuf>> UartDmaChannel::DoPendRead(Context& cx) {
+  DoUpdateReceiveProgress();
+
+  {
+    std::lock_guard lock(lock_);
+    if (rx_data_lost_) {
+      rx_data_lost_ = false;
+      read_allocation_.reset();
+      return Ready(Result<MultiBuf>(Status::DataLoss()));
+    }
+    if (rx_available_ == 0) {
+      read_waker_ = cx.GetWaker(WaitReason::Unspecified());
+      return Pending();
+    }
+    if (!read_allocation_.has_value()) {
+      read_allocation_ = allocator_.AllocateAsync(1, rx_available_);
+    }
+  }
+
+  Poll<std::optional<MultiBuf>> allocation = read_allocation_->Pend(cx);
+  if (allocation.IsPending()) {
+    return Pending();
+  }
+  read_allocation_.reset();
+  if (!allocation->has_value()) {
+    return Ready(Result<MultiBuf>(Status::ResourceExhausted()));
+  }
+  MultiBuf& buffer = **allocation;
+
+  // More data may have arrived while waiting for the allocation.
+  size_t index;
+  size_t size;
+  {
+    std::lock_guard lock(lock_);
+    index = rx_read_index_;
+    size = std::min(rx_available_, buffer.size());
+  }
+
+  // The DMA only writes past the bytes counted as available, so they can be
+  // copied without holding the lock.
+  CopyFromRing(index, size, buffer);
+  buffer.Truncate(size);
+
+  std::lock_guard lock(lock_);
+  if (rx_data_lost_) {
+    // The ring wrapped while copying, so the copied bytes may be corrupt.
+    rx_data_lost_ = false;
+    return Ready(Result<MultiBuf>(Status::DataLoss()));
+  }
+  rx_read_index_ = (index + size) % rx_ring_.size();
+  rx_available_ -= size;
+  return Ready(Result<MultiBuf>(std::move(buffer)));
+}
+
+void UartDmaChannel::CopyFromRing(size_t index,
+                                  size_t size,
+                                  MultiBuf& buffer) {
+  const size_t first = std::min(size, rx_ring_.size() - index);
+  buffer.CopyFrom(rx_ring_.subspan(index, first));
+  if (first < size) {
+    buffer.CopyFrom(rx_ring_.first(size - first), first);
+  }
+}
+
+Poll<Status> UartDmaChannel::DoPendReadyToWrite(Context& cx) {
+  {
+    std::lock_guard lock(lock_);
+    if (tx_busy_) {
+      write_waker_ = cx.GetWaker(WaitReason::Unspecified());
+      return Pending();
+    }
+  }
+  // The previous write is finished, so its buffers can be returned.
+  tx_data_.Release();
+  return Ready(OkStatus());
+}
+
+Result<WriteToken> UartDmaChannel::DoWrite(MultiBuf&& data) {
+  ConstByteSpan first;
+  uint32_t token;
+  {
+    std::lock_guard lock(lock_);
+    PW_CHECK(!tx_busy_, "Write() called before PendReadyToWrite() completed");
+    token = ++write_token_;
+    tx_data_ = std::move(data);
+    tx_chunk_ = tx_data_.Chunks().begin();
+    while (tx_chunk_ != tx_data_.Chunks().end() && tx_chunk_->empty()) {
+      ++tx_chunk_;
+    }
+    if (tx_chunk_ == tx_data_.Chunks().end()) {
+      return CreateWriteToken(token);
+    }
+    first = ConstByteSpan(tx_chunk_->data(), tx_chunk_->size());
+    tx_busy_ = true;
+  }
+
+  if (Status status = DoStartTransmit(first); !status.ok()) {
+    Waker waker;
+    {
+      std::lock_guard lock(lock_);
+      waker = FinishTransmitLocked(status);
+    }
+    std::move(waker).Wake();
+  }
+  return CreateWriteToken(token);
+}
+
+Poll<Result<WriteToken>> UartDmaChannel::DoPendFlush(Context& cx) {
+  std::lock_guard lock(lock_);
+  if (tx_busy_) {
+    write_waker_ = cx.GetWaker(WaitReason::Unspecified());
+    return Pending();
+  }
+  if (!tx_status_.ok()) {
+    const Status status = tx_status_;
+    tx_status_ = OkStatus();
+    return Ready(Result<WriteToken>(status));
+  }
+  return Ready(Result<WriteToken>(CreateWriteToken(write_token_)));
+}
+
+Poll<Status> UartDmaChannel::DoPendClose(Context& cx) {
+  Status status;
+  {
+    std::lock_guard lock(lock_);
+    if (tx_busy_) {
+      write_waker_ = cx.GetWaker(WaitReason::Unspecified());
+      return Pending();
+    }
+    status = tx_status_.ok() ? OkStatus() : Status::DataLoss();
+    tx_status_ = OkStatus();
+  }
+  tx_data_.Release();
+  read_allocation_.reset();
+  return status;
+}
+
+}  // namespace pw::uart
@@ -0,0 +1,249 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_uart/uart_dma_channel.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "pw_allocator/testing.h"
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/pend_func_task.h"
+#include "pw_bytes/array.h"
+#include "pw_multibuf/simple_allocator.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::uart {
+namespace {
+
+using ::pw::async2::Context;
+using ::pw::async2::Dispatcher;
+using ::pw::async2::Pending;
+using ::pw::async2::Poll;
+using ::pw::async2::Ready;
+using ::pw::async2::Task;
+using ::pw::multibuf::MultiBuf;
+
+constexpr size_t kRingSize = 8;
+
+// A UartDmaChannel whose "DMA" is driven by the test.
+class FakeUartDmaChannel : public UartDmaChannel {
+ public:
+  FakeUartDmaChannel(multibuf::MultiBufAllocator& allocator)
+      : UartDmaChannel(ring_, allocator) {}
+
+  // Writes bytes into the ring as the receive DMA would, and reports the new
+  // position.
+  void Receive(ConstByteSpan data) {
+    for (std::byte b : data) {
+      ring_[dma_index_] = b;
+      dma_index_ = (dma_index_ + 1) % ring_.size();
+    }
+    ReceiveProgress(dma_index_);
+  }
+
+  void Overrun() { ReceiveError(); }
+
+  void CompleteTransmit(Status status = OkStatus()) {
+    TransmitComplete(status);
+  }
+
+  const std::vector<std::vector<std::byte>>& transmits() const {
+    return transmits_;
+  }
+
+  Status start_status = OkStatus();
+
+ private:
+  Status DoStartTransmit(ConstByteSpan data) override {
+    transmits_.emplace_back(data.begin(), data.end());
+    return start_status;
+  }
+
+  std::array<std::byte, kRingSize> ring_{};
+  size_t dma_index_ = 0;
+  std::vector<std::vector<std::byte>> transmits_;
+};
+
+// Reads from the channel once per run and records the result.
+class ReadTask : public Task {
+ public:
+  ReadTask(UartDmaChannel& channel) : channel_(channel) {}
+
+  std::vector<std::byte> data;
+  Status status;
+  int reads = 0;
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    while (true) {
+      Poll<Result<MultiBuf>> result = channel_.PendRead(cx);
+      if (result.IsPending()) {
+        return Pending();
+      }
+      ++reads;
+      if (!result->ok()) {
+        status = result->status();
+        continue;
+      }
+      for (const multibuf::Chunk& chunk : (*result)->Chunks()) {
+        data.insert(data.end(), chunk.begin(), chunk.end());
+      }
+    }
+  }
+
+  UartDmaChannel& channel_;
+};
+
+class UartDmaChannelTest : public ::testing::Test {
+ protected:
+  UartDmaChannelTest()
+      : allocator_(data_area_, meta_alloc_), channel_(allocator_) {}
+
+  MultiBuf Allocate(ConstByteSpan data) {
+    std::optional<MultiBuf> buffer = allocator_.Allocate(data.size());
+    EXPECT_TRUE(buffer.has_value());
+    EXPECT_TRUE(buffer->CopyFrom(data).ok());
+    return std::move(*buffer);
+  }
+
+  std::array<std::byte, 256> data_area_;
+  allocator::test::AllocatorForTest<2048> meta_alloc_;
+  multibuf::SimpleAllocator allocator_;
+  FakeUartDmaChannel channel_;
+  Dispatcher dispatcher_;
+};
+
+TEST_F(UartDmaChannelTest, ReadReturnsEverythingReceived) {
+  ReadTask task(channel_);
+  dispatcher_.Post(task);
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  EXPECT_EQ(task.reads, 0);
+
+  channel_.Receive(bytes::Array<1, 2, 3>());
+  channel_.Receive(bytes::Array<4>());
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  EXPECT_EQ(task.reads, 1);
+
+  constexpr auto kExpected = bytes::Array<1, 2, 3, 4>();
+  EXPECT_TRUE(std::equal(
+      task.data.begin(), task.data.end(), kExpected.begin(), kExpected.end()));
+  task.Deregister();
+}
+
+TEST_F(UartDmaChannelTest, ReadAcrossRingWrap) {
+  ReadTask task(channel_);
+  dispatcher_.Post(task);
+  channel_.Receive(bytes::Array<1, 2, 3, 4, 5, 6>());
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  channel_.Receive(bytes::Array<7, 8, 9, 10, 11>());
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  EXPECT_EQ(task.reads, 2);
+
+  constexpr auto kExpected =
+      bytes::Array<1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11>();
+  EXPECT_TRUE(std::equal(
+      task.data.begin(), task.data.end(), kExpected.begin(), kExpected.end()));
+  EXPECT_EQ(task.status, OkStatus());
+  task.Deregister();
+}
+
+TEST_F(UartDmaChannelTest, OverwrittenDataIsReportedAsDataLoss) {
+  ReadTask task(channel_);
+  channel_.Receive(bytes::Array<1, 2, 3, 4, 5, 6>());
+  channel_.Receive(bytes::Array<7, 8, 9, 10, 11>());
+  dispatcher_.Post(task);
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  EXPECT_EQ(task.status, Status::DataLoss());
+  EXPECT_TRUE(task.data.empty());
+
+  // Reception resumes with new data.
+  channel_.Receive(bytes::Array<12, 13>());
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  constexpr auto kExpected = bytes::Array<12, 13>();
+  EXPECT_TRUE(std::equal(
+      task.data.begin(), task.data.end(), kExpected.begin(), kExpected.end()));
+  task.Deregister();
+}
+
+TEST_F(UartDmaChannelTest, ReceiveErrorIsReportedAsDataLoss) {
+  ReadTask task(channel_);
+  dispatcher_.Post(task);
+  channel_.Overrun();
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  EXPECT_EQ(task.reads, 1);
+  EXPECT_EQ(task.status, Status::DataLoss());
+  task.Deregister();
+}
+
+TEST_F(UartDmaChannelTest, WriteTransmitsEachChunk) {
+  MultiBuf data = Allocate(bytes::Array<1, 2>());
+  data.PushSuffix(Allocate(bytes::Array<3>()));
+
+  Poll<Result<channel::WriteToken>> flush = Pending();
+  async2::PendFuncTask task([&](Context& cx) -> Poll<> {
+    if (channel_.PendReadyToWrite(cx).IsPending()) {
+      return Pending();
+    }
+    if (!data.empty()) {
+      EXPECT_EQ(channel_.Write(std::move(data)).status(), OkStatus());
+      data = MultiBuf();
+    }
+    flush = channel_.PendFlush(cx);
+    if (flush.IsPending()) {
+      return Pending();
+    }
+    return Ready();
+  });
+  dispatcher_.Post(task);
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  ASSERT_EQ(channel_.transmits().size(), 1u);
+  EXPECT_EQ(channel_.transmits()[0].size(), 2u);
+
+  channel_.CompleteTransmit();
+  ASSERT_EQ(channel_.transmits().size(), 2u);
+  EXPECT_EQ(channel_.transmits()[1].size(), 1u);
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsPending());
+  EXPECT_TRUE(flush.IsPending());
+
+  channel_.CompleteTransmit();
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsReady());
+  ASSERT_TRUE(flush.IsReady());
+  EXPECT_EQ(flush->status(), OkStatus());
+}
+
+TEST_F(UartDmaChannelTest, TransmitErrorIsReportedByFlush) {
+  channel_.start_status = Status::Unavailable();
+  Poll<Result<channel::WriteToken>> flush = Pending();
+  bool written = false;
+  async2::PendFuncTask task([&](Context& cx) -> Poll<> {
+    if (!written) {
+      EXPECT_EQ(channel_.PendReadyToWrite(cx), Ready(OkStatus()));
+      EXPECT_EQ(channel_.Write(Allocate(bytes::Array<1>())).status(),
+                OkStatus());
+      written = true;
+    }
+    flush = channel_.PendFlush(cx);
+    return flush.IsReady() ? Ready() : Pending();
+  });
+  dispatcher_.Post(task);
+  EXPECT_TRUE(dispatcher_.RunUntilStalled().IsReady());
+  ASSERT_TRUE(flush.IsReady());
+  EXPECT_EQ(flush->status(), Status::Unavailable());
+}
+
+}  // namespace
+}  // namespace pw::uart
@@ -67,7 +67,13 @@ int Framework::RunAllTests() {
   if (event_handler_ != nullptr) {
     event_handler_->RunAllTestsStart();
   }
-  for (const TestInfo* test = tests_; test != nullptr; test = test->next()) {
+  size_t index = 0;
+  for (const TestInfo* test = tests_; test != nullptr;
+       test = test->next(), ++index) {
+    if (!InShard(index)) {
+      continue;  // Another shard runs or reports this test.
+    }
+    current_test_index_ = index;
     if (ShouldRunTest(*test)) {
       test->run();
     } else if (!test->enabled()) {
@@ -91,8 +97,11 @@ void Framework::SetUpTestSuiteIfNeeded(SetUpTestSuiteFunc set_up_ts) const {
     return;
   }
 
-  for (TestInfo* info = tests_; info != current_test_; info = info->next()) {
-    if (info->test_case().suite_name == current_test_->test_case().suite_name) {
+  size_t index = 0;
+  for (TestInfo* info = tests_; info != current_test_;
+       info = info->next(), ++index) {
+    if (info->test_case().suite_name == current_test_->test_case().suite_name &&
+        WillRunTest(*info, index)) {
       return;
     }
   }
@@ -106,9 +115,11 @@ void Framework::TearDownTestSuiteIfNeeded(
     return;
   }
 
+  size_t index = current_test_index_ + 1;
   for (TestInfo* info = current_test_->next(); info != nullptr;
-       info = info->next()) {
-    if (info->test_case().suite_name == current_test_->test_case().suite_name) {
+       info = info->next(), ++index) {
+    if (info->test_case().suite_name == current_test_->test_case().suite_name &&
+        WillRunTest(*info, index)) {
       return;
     }
   }
@@ -455,6 +455,9 @@ class Framework {
                            .disabled_tests = 0},
         exit_status_(0),
         event_handler_(nullptr),
+        current_test_index_(0),
+        shard_index_(0),
+        shard_count_(1),
         memory_pool_() {}
 
   static Framework& Get() { return framework_; }
@@ -483,6 +486,15 @@ class Framework {
   }
 #endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
 
+  // Only run the tests in one of `shard_count` disjoint subsets during the next
+  // test runs. Tests are assigned to shards round-robin in registration order,
+  // so running every shard runs every test exactly once. Disabled tests are
+  // reported only by the shard to which they are assigned.
+  void SetShard(size_t shard_index, size_t shard_count) {
+    shard_index_ = shard_index;
+    shard_count_ = shard_count == 0 ? 1 : shard_count;
+  }
+
   bool ShouldRunTest(const TestInfo& test_info) const;
 
   // Whether the current test is skipped.
@@ -625,6 +637,17 @@ class Framework {
     return std::forward<T>(value);
   }
 
+  // Whether the test at the given position in the test list belongs to the
+  // current shard.
+  bool InShard(size_t test_index) const {
+    return test_index % shard_count_ == shard_index_;
+  }
+
+  // Whether the test at the given position in the test list runs.
+  bool WillRunTest(const TestInfo& test_info, size_t test_index) const {
+    return InShard(test_index) && ShouldRunTest(test_info);
+  }
+
   // If current_test_ will be first of its suite, call set_up_ts
   void SetUpTestSuiteIfNeeded(SetUpTestSuiteFunc set_up_ts) const;
 
@@ -659,6 +682,13 @@ class Framework {
   // Handler to which to dispatch test events.
   EventHandler* event_handler_;
 
+  // Position of current_test_ in the test list.
+  size_t current_test_index_;
+
+  // The subset of tests to run; see SetShard().
+  size_t shard_index_;
+  size_t shard_count_;
+
 #if PW_CXX_STANDARD_IS_SUPPORTED(17)
   span<std::string_view> test_suites_to_run_;
 #else
@@ -788,6 +818,12 @@ inline void SetTestSuitesToRun(span<std::string_view> test_suites) {
 }
 #endif  // PW_CXX_STANDARD_IS_SUPPORTED(17)
 
+/// Restricts subsequent test runs to shard `shard_index` of `shard_count`.
+/// Call `SetShard(0, 1)` to run all tests again.
+inline void SetShard(size_t shard_index, size_t shard_count) {
+  internal::Framework::Get().SetShard(shard_index, shard_count);
+}
+
 }  // namespace unit_test
 }  // namespace pw
 
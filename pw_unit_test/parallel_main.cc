@@ -0,0 +1,35 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+#include <cstdlib>
+#include <thread>
+
+#include "pw_unit_test/framework.h"
+#include "pw_unit_test/logging_event_handler.h"
+#include "pw_unit_test/parallel_runner.h"
+
+// Runs the tests in as many worker processes as the host has cores, or as many
+// as the PW_UNIT_TEST_JOBS environment variable specifies.
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  size_t num_workers = std::thread::hardware_concurrency();
+  if (const char* jobs = std::getenv("PW_UNIT_TEST_JOBS"); jobs != nullptr) {
+    num_workers = std::strtoul(jobs, nullptr, 10);
+  }
+
+  pw::unit_test::LoggingEventHandler handler;
+  return pw::unit_test::RunAllTestsInParallel(handler, num_workers);
+}
@@ -0,0 +1,332 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+
+#include "pw_unit_test/parallel_runner.h"
+
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "pw_unit_test/framework.h"
+
+namespace pw::unit_test {
+namespace {
+
+// Longest evaluated expression forwarded from a worker. Matches the buffer the
+// light framework formats expectations into.
+constexpr size_t kMaxEvaluatedExpressionSize = 192;
+
+// A test event sent from a worker to the parent.
+//
+// Workers are forked from the parent, so the test case names and expression
+// strings, which are string literals, are at the same addresses in both
+// processes. Only the evaluated expression, which is formatted at run time, is
+// copied.
+struct Message {
+  enum class Type : int {
+    kTestCaseStart,
+    kTestCaseExpect,
+    kTestCaseEnd,
+    kTestCaseDisabled,
+    kRunAllTestsEnd,
+  };
+
+  Type type;
+  TestCase test_case;
+  TestResult result;
+  const char* expression;
+  int line_number;
+  bool success;
+  char evaluated_expression[kMaxEvaluatedExpressionSize];
+  RunTestsSummary summary;
+};
+
+// Messages no larger than PIPE_BUF are written atomically, so a message is
+// never split across reads.
+static_assert(sizeof(Message) <= 512, "Messages must fit in PIPE_BUF");
+
+// Runs in a worker, forwarding events to the parent through a pipe.
+class WorkerEventHandler final : public EventHandler {
+ public:
+  explicit WorkerEventHandler(int fd) : fd_(fd) {}
+
+  void TestProgramStart(const ProgramSummary&) override {}
+  void EnvironmentsSetUpEnd() override {}
+  void TestSuiteStart(const TestSuite&) override {}
+  void TestSuiteEnd(const TestSuite&) override {}
+  void EnvironmentsTearDownEnd() override {}
+  void TestProgramEnd(const ProgramSummary&) override {}
+  void RunAllTestsStart() override {}
+
+  void RunAllTestsEnd(const RunTestsSummary& run_tests_summary) override {
+    Message message = {};
+    message.type = Message::Type::kRunAllTestsEnd;
+    message.summary = run_tests_summary;
+    Send(message);
+  }
+
+  void TestCaseStart(const TestCase& test_case) override {
+    Message message = {};
+    message.type = Message::Type::kTestCaseStart;
+    message.test_case = test_case;
+    Send(message);
+  }
+
+  void TestCaseEnd(const TestCase& test_case, TestResult result) override {
+    Message message = {};
+    message.type = Message::Type::kTestCaseEnd;
+    message.test_case = test_case;
+    message.result = result;
+    Send(message);
+  }
+
+  void TestCaseExpect(const TestCase& test_case,
+                      const TestExpectation& expectation) override {
+    Message message = {};
+    message.type = Message::Type::kTestCaseExpect;
+    message.test_case = test_case;
+    message.expression = expectation.expression;
+    message.line_number = expectation.line_number;
+    message.success = expectation.success;
+    if (expectation.evaluated_expression != nullptr) {
+      std::strncpy(message.evaluated_expression,
+                   expectation.evaluated_expression,
+                   sizeof(message.evaluated_expression) - 1);
+    }
+    Send(message);
+  }
+
+  void TestCaseDisabled(const TestCase& test_case) override {
+    Message message = {};
+    message.type = Message::Type::kTestCaseDisabled;
+    message.test_case = test_case;
+    Send(message);
+  }
+
+ private:
+  void Send(const Message& message) {
+    ssize_t result;
+    do {
+      result = write(fd_, &message, sizeof(message));
+    } while (result < 0 && errno == EINTR);
+  }
+
+  int fd_;
+};
+
+// The parent's view of one worker.
+struct Worker {
+  pid_t pid = -1;
+  int fd = -1;
+  bool finished = false;
+
+  // Events of the test case the worker is running, which are forwarded once
+  // the test case ends.
+  std::vector<Message> pending;
+};
+
+// Reads one message. Returns false at end of file.
+bool Receive(int fd, Message& message) {
+  auto* data = reinterpret_cast<char*>(&message);
+  size_t received = 0;
+  while (received < sizeof(message)) {
+    const ssize_t result =
+        read(fd, data + received, sizeof(message) - received);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      return false;
+    }
+    received += static_cast<size_t>(result);
+  }
+  return true;
+}
+
+void Forward(EventHandler& handler, const Message& message) {
+  switch (message.type) {
+    case Message::Type::kTestCaseStart:
+      handler.TestCaseStart(message.test_case);
+      break;
+    case Message::Type::kTestCaseExpect:
+      handler.TestCaseExpect(message.test_case,
+                             {
+                                 .expression = message.expression,
+                                 .evaluated_expression =
+                                     message.evaluated_expression,
+                                 .line_number = message.line_number,
+                                 .success = message.success,
+                             });
+      break;
+    case Message::Type::kTestCaseEnd:
+      handler.TestCaseEnd(message.test_case, message.result);
+      break;
+    case Message::Type::kTestCaseDisabled:
+      handler.TestCaseDisabled(message.test_case);
+      break;
+    case Message::Type::kRunAllTestsEnd:
+      break;
+  }
+}
+
+void AddSummary(RunTestsSummary& total, const RunTestsSummary& summary) {
+  total.passed_tests += summary.passed_tests;
+  total.failed_tests += summary.failed_tests;
+  total.skipped_tests += summary.skipped_tests;
+  total.disabled_tests += summary.disabled_tests;
+}
+
+// Reports the test a crashed worker was running as failed.
+void ReportCrash(EventHandler& handler, Worker& worker) {
+  for (const Message& message : worker.pending) {
+    Forward(handler, message);
+  }
+  const TestCase& test_case = worker.pending.front().test_case;
+  handler.TestCaseExpect(test_case,
+                         {
+                             .expression = "(test worker exited)",
+                             .evaluated_expression = "(test worker exited)",
+                             .line_number = 0,
+                             .success = false,
+                         });
+  handler.TestCaseEnd(test_case, TestResult::kFailure);
+  worker.pending.clear();
+}
+
+[[noreturn]] void RunWorker(int fd, size_t index, size_t num_workers) {
+  WorkerEventHandler handler(fd);
+  RegisterEventHandler(&handler);
+  SetShard(index, num_workers);
+  const int status = RUN_ALL_TESTS();
+  std::fflush(nullptr);
+  _exit(status);
+}
+
+}  // namespace
+
+int RunAllTestsInParallel(EventHandler& handler, size_t num_workers) {
+  if (num_workers == 0) {
+    num_workers = 1;
+  }
+
+  // Flush buffered output so that workers don't inherit and repeat it.
+  std::fflush(nullptr);
+
+  std::vector<Worker> workers(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+      std::perror("pipe");
+      return 1;
+    }
+    const pid_t pid = fork();
+    if (pid < 0) {
+      std::perror("fork");
+      return 1;
+    }
+    if (pid == 0) {
+      close(fds[0]);
+      for (size_t j = 0; j < i; ++j) {
+        close(workers[j].fd);
+      }
+      RunWorker(fds[1], i, num_workers);
+    }
+    close(fds[1]);
+    workers[i].pid = pid;
+    workers[i].fd = fds[0];
+  }
+
+  handler.RunAllTestsStart();
+
+  int exit_status = 0;
+  RunTestsSummary summary = {};
+  size_t open_workers = num_workers;
+  std::vector<pollfd> fds(num_workers);
+
+  while (open_workers > 0) {
+    for (size_t i = 0; i < num_workers; ++i) {
+      fds[i] = {.fd = workers[i].fd, .events = POLLIN, .revents = 0};
+    }
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      std::perror("poll");
+      return 1;
+    }
+
+    for (size_t i = 0; i < num_workers; ++i) {
+      if (fds[i].revents == 0) {
+        continue;
+      }
+      Worker& worker = workers[i];
+      Message message;
+      if (!Receive(worker.fd, message)) {
+        close(worker.fd);
+        worker.fd = -1;  // poll() ignores negative descriptors.
+        open_workers -= 1;
+        if (!worker.pending.empty()) {
+          ReportCrash(handler, worker);
+          summary.failed_tests += 1;
+        }
+        if (!worker.finished) {
+          exit_status = 1;
+        }
+        continue;
+      }
+
+      switch (message.type) {
+        case Message::Type::kTestCaseStart:
+        case Message::Type::kTestCaseExpect:
+          worker.pending.push_back(message);
+          break;
+        case Message::Type::kTestCaseEnd:
+          for (const Message& pending : worker.pending) {
+            Forward(handler, pending);
+          }
+          worker.pending.clear();
+          Forward(handler, message);
+          break;
+        case Message::Type::kTestCaseDisabled:
+          Forward(handler, message);
+          break;
+        case Message::Type::kRunAllTestsEnd:
+          AddSummary(summary, message.summary);
+          worker.finished = true;
+          break;
+      }
+    }
+  }
+
+  for (const Worker& worker : workers) {
+    int status;
+    while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+      exit_status = 1;
+    }
+  }
+
+  handler.RunAllTestsEnd(summary);
+  return exit_status;
+}
+
+}  // namespace pw::unit_test
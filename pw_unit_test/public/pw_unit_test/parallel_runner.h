@@ -0,0 +1,42 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+//
+#pragma once
+
+#include <cstddef>
+
+#include "pw_unit_test/event_handler.h"
+
+namespace pw::unit_test {
+
+/// Runs all registered tests in `num_workers` forked processes and reports
+/// their combined results to `handler`.
+///
+/// Each worker runs one shard of the tests (see `SetShard()`), so a test
+/// binary with thousands of cases uses all host cores. Workers stream their
+/// events back to the parent, which forwards them to `handler` one complete
+/// test case at a time, so output from different workers is never interleaved
+/// within a test. The `RunAllTestsEnd` summary covers all workers.
+///
+/// If a worker crashes, the test it was running is reported as failed and the
+/// run returns nonzero. The remaining tests in its shard are not run.
+///
+/// This is only available on POSIX hosts with the light backend. Test suite
+/// filters set with `SetTestSuitesToRun()` apply to every worker.
+///
+/// @returns 0 if all tests passed, or nonzero otherwise, like
+/// `RUN_ALL_TESTS()`.
+int RunAllTestsInParallel(EventHandler& handler, size_t num_workers);
+
+}  // namespace pw::unit_test
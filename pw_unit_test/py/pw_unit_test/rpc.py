@@ -154,16 +154,24 @@ def run_tests(
     test_suites: Iterable[str] = (),
     event_handlers: Iterable[EventHandler] = (LoggingEventHandler(),),
     timeout_s: OptionalTimeout = UseDefault.VALUE,
+    shard_index: int = 0,
+    shard_count: int = 1,
 ) -> TestRecord:
     """Runs unit tests on a device over :ref:`module-pw_rpc`.
 
     Calls each of the provided event handlers as test events occur, and returns
     ``True`` if all tests pass.
+
+    With ``shard_count`` greater than 1, only runs the tests in shard
+    ``shard_index``, so that a test binary can be split across several devices
+    or processes.
     """
     unit_test_service = rpcs.pw.unit_test.UnitTest  # type: ignore[attr-defined]
     request = unit_test_service.Run.request(
         report_passed_expectations=report_passed_expectations,
         test_suite=test_suites,
+        shard_index=shard_index,
+        shard_count=shard_count,
     )
     call = unit_test_service.Run.invoke(request, timeout_s=timeout_s)
     test_responses = iter(call)
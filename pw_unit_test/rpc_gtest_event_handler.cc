@@ -29,12 +29,19 @@ RpcEventHandler::RpcEventHandler(UnitTestService& service) : service_(service) {
   delete default_listener;
 }
 
-void RpcEventHandler::ExecuteTests(span<std::string_view> suites_to_run) {
+void RpcEventHandler::ExecuteTests(span<std::string_view> suites_to_run,
+                                   size_t,
+                                   size_t shard_count) {
   if (!suites_to_run.empty()) {
     PW_LOG_WARN(
         "GoogleTest backend does not support test suite filtering. Running all "
         "suites.");
   }
+  if (shard_count > 1) {
+    PW_LOG_WARN(
+        "GoogleTest backend does not support sharding over RPC. Running all "
+        "tests.");
+  }
   if (service_.verbose_) {
     PW_LOG_WARN(
         "GoogleTest backend does not support reporting passed expectations.");
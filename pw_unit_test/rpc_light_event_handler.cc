@@ -20,9 +20,12 @@ namespace pw::unit_test::internal {
 RpcEventHandler::RpcEventHandler(UnitTestService& service)
     : service_(service) {}
 
-void RpcEventHandler::ExecuteTests(span<std::string_view> suites_to_run) {
+void RpcEventHandler::ExecuteTests(span<std::string_view> suites_to_run,
+                                   size_t shard_index,
+                                   size_t shard_count) {
   RegisterEventHandler(this);
   SetTestSuitesToRun(suites_to_run);
+  SetShard(shard_index, shard_count);
 
   PW_LOG_DEBUG("%u test suite filters applied",
                static_cast<unsigned>(suites_to_run.size()));
@@ -31,6 +34,7 @@ void RpcEventHandler::ExecuteTests(span<std::string_view> suites_to_run) {
 
   RegisterEventHandler(nullptr);
   SetTestSuitesToRun({});
+  SetShard(0, 1);
 }
 
 void RpcEventHandler::RunAllTestsStart() { service_.WriteTestRunStart(); }
@@ -26,7 +26,9 @@ namespace internal {
 class RpcEventHandler : public EventHandler {
  public:
   RpcEventHandler(UnitTestService& service);
-  void ExecuteTests(span<std::string_view> suites_to_run);
+  void ExecuteTests(span<std::string_view> suites_to_run,
+                    size_t shard_index,
+                    size_t shard_count);
 
   void TestProgramStart(const ProgramSummary&) override {}
   void EnvironmentsSetUpEnd() override {}
@@ -29,6 +29,8 @@ void UnitTestService::Run(ConstByteSpan request, RawServerWriter& writer) {
   // data in the raw protobuf request message, so it is only valid for the
   // duration of this function.
   pw::Vector<std::string_view, 16> suites_to_run;
+  uint32_t shard_index = 0;
+  uint32_t shard_count = 0;
 
   protobuf::Decoder decoder(request);
 
@@ -58,6 +60,16 @@ void UnitTestService::Run(ConstByteSpan request, RawServerWriter& writer) {
 
         break;
       }
+
+      case pwpb::TestRunRequest::Fields::kShardIndex:
+        decoder.ReadUint32(&shard_index)
+            .IgnoreError();  // TODO: b/242598609 - Handle Status properly
+        break;
+
+      case pwpb::TestRunRequest::Fields::kShardCount:
+        decoder.ReadUint32(&shard_count)
+            .IgnoreError();  // TODO: b/242598609 - Handle Status properly
+        break;
     }
   }
 
@@ -67,8 +79,20 @@ void UnitTestService::Run(ConstByteSpan request, RawServerWriter& writer) {
     return;
   }
 
+  if (shard_count == 0) {
+    shard_count = 1;
+  }
+  if (shard_index >= shard_count) {
+    PW_LOG_ERROR("Shard %u is out of range for %u shards",
+                 static_cast<unsigned>(shard_index),
+                 static_cast<unsigned>(shard_count));
+    writer_.Finish(Status::InvalidArgument())
+        .IgnoreError();  // TODO: b/242598609 - Handle Status properly
+    return;
+  }
+
   PW_LOG_INFO("Starting unit test run");
-  handler_.ExecuteTests(suites_to_run);
+  handler_.ExecuteTests(suites_to_run, shard_index, shard_count);
   PW_LOG_INFO("Unit test run complete");
 
   writer_.Finish().IgnoreError();  // TODO: b/242598609 - Handle Status properly
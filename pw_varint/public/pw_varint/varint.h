@@ -301,6 +301,43 @@ inline size_t Decode(const span<const std::byte>& input, uint64_t* value) {
   return pw_varint_Decode64(input.data(), input.size(), value);
 }
 
+/// Decodes consecutive LEB128 varints from `input` into `output`, until either
+/// is exhausted. The values are the same as those returned by calling `Decode`
+/// repeatedly, but continuation bits are scanned a 64-bit word at a time,
+/// which is considerably faster for long runs of varints, such as packed
+/// repeated fields.
+///
+/// Decoding stops at the first varint that is truncated or longer than 10
+/// bytes; `bytes_read` then refers to the start of that varint.
+///
+/// @param[in] input The encoded varints.
+///
+/// @param[out] output The decoded values.
+///
+/// @param[out] bytes_read Set to the number of bytes of `input` that were
+/// decoded.
+///
+/// @returns The number of values written to `output`.
+size_t DecodeMany(span<const std::byte> input,
+                  span<uint64_t> output,
+                  size_t* bytes_read);
+
+/// Encodes `input` as consecutive LEB128 varints into `output`, until either
+/// is exhausted or the next value does not fit. The bytes are the same as
+/// those written by calling `Encode` repeatedly, but values of up to 56 bits
+/// are each encoded with a few word operations rather than byte by byte.
+///
+/// @param[in] input The values to encode.
+///
+/// @param[out] output The buffer to encode into.
+///
+/// @param[out] bytes_written Set to the number of bytes written to `output`.
+///
+/// @returns The number of values from `input` that were encoded.
+size_t EncodeMany(span<const uint64_t> input,
+                  span<std::byte> output,
+                  size_t* bytes_written);
+
 /// Describes a custom varint format.
 enum class Format {
   kZeroTerminatedLeastSignificant = PW_VARINT_ZERO_TERMINATED_LEAST_SIGNIFICANT,
@@ -16,6 +16,11 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif  // defined(__BMI2__)
 
 namespace pw {
 namespace varint {
@@ -29,6 +34,45 @@ inline bool LeastSignificant(pw_varint_Format format) {
   return (static_cast<unsigned>(format) & 0b01) == 0;
 }
 
+// The word-at-a-time kernels load and store varints as little-endian words.
+constexpr bool kWordAtATime = cpp20::endian::native == cpp20::endian::little;
+
+constexpr uint64_t kContinuationBits = 0x8080808080808080u;
+constexpr uint64_t kValueBits = 0x7f7f7f7f7f7f7f7fu;
+
+// Varints of up to this many bytes are decoded from a single word.
+constexpr size_t kMaxWordVarintSizeBytes = sizeof(uint64_t);
+
+inline uint64_t LoadWord(const std::byte* data) {
+  uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+// Packs the low seven bits of each byte of `word` into its low 56 bits.
+inline uint64_t CompactSevenBitGroups(uint64_t word) {
+#if defined(__BMI2__)
+  return _pext_u64(word, kValueBits);
+#else
+  word &= kValueBits;
+  word = ((word & 0x7f007f007f007f00u) >> 1) | (word & 0x007f007f007f007fu);
+  word = ((word & 0x3fff00003fff0000u) >> 2) | (word & 0x00003fff00003fffu);
+  return ((word & 0x0fffffff00000000u) >> 4) | (word & 0x000000000fffffffu);
+#endif  // defined(__BMI2__)
+}
+
+// Spreads the low 56 bits of `value` into the low seven bits of each byte. The
+// inverse of `CompactSevenBitGroups`.
+inline uint64_t SpreadSevenBitGroups(uint64_t value) {
+#if defined(__BMI2__)
+  return _pdep_u64(value, kValueBits);
+#else
+  value = ((value & 0x00fffffff0000000u) << 4) | (value & 0x000000000fffffffu);
+  value = ((value & 0x0fffc0000fffc000u) << 2) | (value & 0x00003fff00003fffu);
+  return ((value & 0x3f803f803f803f80u) << 1) | (value & 0x007f007f007f007fu);
+#endif  // defined(__BMI2__)
+}
+
 }  // namespace
 
 extern "C" size_t pw_varint_EncodeCustom(uint64_t integer,
@@ -122,6 +166,85 @@ extern "C" size_t pw_varint_DecodeCustom(const void* input,
   return count;
 }
 
+size_t DecodeMany(span<const std::byte> input,
+                  span<uint64_t> output,
+                  size_t* bytes_read) {
+  size_t offset = 0;
+  size_t count = 0;
+
+  while (count < output.size() && offset < input.size()) {
+    if (kWordAtATime && input.size() - offset >= sizeof(uint64_t)) {
+      const uint64_t word = LoadWord(&input[offset]);
+      const uint64_t last_bytes = ~word & kContinuationBits;
+
+      // Runs of single-byte varints, common for small values and lengths, are
+      // copied out without any further bit manipulation.
+      if (last_bytes == kContinuationBits &&
+          output.size() - count >= sizeof(uint64_t)) {
+        for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+          output[count + i] = (word >> (8 * i)) & 0xffu;
+        }
+        count += sizeof(uint64_t);
+        offset += sizeof(uint64_t);
+        continue;
+      }
+
+      // The lowest cleared continuation bit marks the end of the varint.
+      if (last_bytes != 0u) {
+        const size_t size =
+            static_cast<size_t>(cpp20::countr_zero(last_bytes)) / 8 + 1;
+        const uint64_t mask = size == kMaxWordVarintSizeBytes
+                                  ? ~uint64_t(0)
+                                  : (uint64_t(1) << (8 * size)) - 1;
+        output[count++] = CompactSevenBitGroups(word & mask);
+        offset += size;
+        continue;
+      }
+      // Varints longer than a word are decoded byte by byte below.
+    }
+
+    uint64_t value;
+    const size_t size = Decode(input.subspan(offset), &value);
+    if (size == 0u) {
+      break;
+    }
+    output[count++] = value;
+    offset += size;
+  }
+
+  *bytes_read = offset;
+  return count;
+}
+
+size_t EncodeMany(span<const uint64_t> input,
+                  span<std::byte> output,
+                  size_t* bytes_written) {
+  size_t offset = 0;
+  size_t count = 0;
+
+  for (; count < input.size(); ++count) {
+    const uint64_t value = input[count];
+    const size_t size = EncodedSize(value);
+    if (size > output.size() - offset) {
+      break;
+    }
+
+    if (kWordAtATime && size <= kMaxWordVarintSizeBytes) {
+      // Set the continuation bit of every byte but the last.
+      const uint64_t word =
+          SpreadSevenBitGroups(value) |
+          (kContinuationBits & ((uint64_t(1) << (8 * (size - 1))) - 1));
+      std::memcpy(&output[offset], &word, size);
+    } else {
+      EncodeLittleEndianBase128(value, output.subspan(offset));
+    }
+    offset += size;
+  }
+
+  *bytes_written = offset;
+  return count;
+}
+
 extern "C" size_t pw_varint_EncodedSizeBytes(uint64_t integer) {
   return EncodedSize(integer);
 }
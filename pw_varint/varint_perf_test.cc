@@ -0,0 +1,110 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+#include "pw_varint/varint.h"
+
+namespace pw::varint {
+namespace {
+
+// Small values, such as lengths and enums in packed fields, which encode to a
+// single byte each.
+constexpr std::array<uint64_t, 64> kSmallValues = [] {
+  std::array<uint64_t, 64> values{};
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = i;
+  }
+  return values;
+}();
+
+// Values spanning every encoded size from one to ten bytes.
+constexpr std::array<uint64_t, 64> kMixedValues = [] {
+  std::array<uint64_t, 64> values{};
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = MaxValueInBytes(i % kMaxVarint64SizeBytes + 1);
+  }
+  return values;
+}();
+
+struct Encoded {
+  std::array<std::byte, 64 * kMaxVarint64SizeBytes> buffer;
+  size_t size;
+};
+
+Encoded EncodeAll(span<const uint64_t> values) {
+  Encoded encoded{};
+  for (uint64_t value : values) {
+    encoded.size += Encode(value, span(encoded.buffer).subspan(encoded.size));
+  }
+  return encoded;
+}
+
+const Encoded kSmallEncoded = EncodeAll(kSmallValues);
+const Encoded kMixedEncoded = EncodeAll(kMixedValues);
+
+void DecodeEachTest(perf_test::State& state, const Encoded& encoded) {
+  const span<const std::byte> input = span(encoded.buffer).first(encoded.size);
+  std::array<uint64_t, 64> values;
+  while (state.KeepRunning()) {
+    size_t offset = 0;
+    for (uint64_t& value : values) {
+      offset += Decode(input.subspan(offset), &value);
+    }
+  }
+}
+
+void DecodeManyTest(perf_test::State& state, const Encoded& encoded) {
+  const span<const std::byte> input = span(encoded.buffer).first(encoded.size);
+  std::array<uint64_t, 64> values;
+  size_t bytes_read;
+  while (state.KeepRunning()) {
+    DecodeMany(input, values, &bytes_read);
+  }
+}
+
+void EncodeEachTest(perf_test::State& state, span<const uint64_t> values) {
+  std::array<std::byte, 64 * kMaxVarint64SizeBytes> buffer;
+  while (state.KeepRunning()) {
+    size_t offset = 0;
+    for (uint64_t value : values) {
+      offset += Encode(value, span(buffer).subspan(offset));
+    }
+  }
+}
+
+void EncodeManyTest(perf_test::State& state, span<const uint64_t> values) {
+  std::array<std::byte, 64 * kMaxVarint64SizeBytes> buffer;
+  size_t bytes_written;
+  while (state.KeepRunning()) {
+    EncodeMany(values, buffer, &bytes_written);
+  }
+}
+
+PW_PERF_TEST(DecodeEachSmallTest, DecodeEachTest, kSmallEncoded);
+PW_PERF_TEST(DecodeManySmallTest, DecodeManyTest, kSmallEncoded);
+PW_PERF_TEST(DecodeEachMixedTest, DecodeEachTest, kMixedEncoded);
+PW_PERF_TEST(DecodeManyMixedTest, DecodeManyTest, kMixedEncoded);
+
+PW_PERF_TEST(EncodeEachSmallTest, EncodeEachTest, kSmallValues);
+PW_PERF_TEST(EncodeManySmallTest, EncodeManyTest, kSmallValues);
+PW_PERF_TEST(EncodeEachMixedTest, EncodeEachTest, kMixedValues);
+PW_PERF_TEST(EncodeManyMixedTest, EncodeManyTest, kMixedValues);
+
+}  // namespace
+}  // namespace pw::varint
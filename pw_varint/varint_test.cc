@@ -14,6 +14,7 @@
 
 #include "pw_varint/varint.h"
 
+#include <array>
 #include <cinttypes>
 #include <cstdint>
 #include <cstring>
@@ -1158,5 +1159,118 @@ TEST(Varint, MaxValueInBytes) {
   static_assert(MaxValueInBytes(100) == std::numeric_limits<uint64_t>::max());
 }
 
+// Values of every encoded size, including runs of single-byte values.
+constexpr std::array<uint64_t, 24> kManyValues = {
+    0,
+    1,
+    127,
+    128,
+    0x3fff,
+    0x4000,
+    0x1fffff,
+    0x200000,
+    0x0fffffff,
+    0x10000000,
+    MaxValueInBytes(5),
+    MaxValueInBytes(6),
+    MaxValueInBytes(7),
+    MaxValueInBytes(8),
+    MaxValueInBytes(8) + 1,
+    MaxValueInBytes(9) + 1,
+    std::numeric_limits<uint64_t>::max(),
+    2,
+    3,
+    4,
+    5,
+    6,
+    7,
+    8,
+};
+
+TEST(VarintDecodeMany, MatchesDecode) {
+  std::array<std::byte, kManyValues.size() * kMaxVarint64SizeBytes> buffer;
+  size_t size = 0;
+  for (uint64_t value : kManyValues) {
+    size += Encode(value, span(buffer).subspan(size));
+  }
+
+  std::array<uint64_t, kManyValues.size()> values{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(DecodeMany(span(buffer).first(size), values, &bytes_read),
+            kManyValues.size());
+  EXPECT_EQ(bytes_read, size);
+  EXPECT_EQ(values, kManyValues);
+}
+
+TEST(VarintDecodeMany, SingleByteValues) {
+  std::array<std::byte, 21> buffer;
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<std::byte>(i * 5);
+  }
+
+  std::array<uint64_t, buffer.size()> values{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(DecodeMany(buffer, values, &bytes_read), buffer.size());
+  EXPECT_EQ(bytes_read, buffer.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], i * 5);
+  }
+}
+
+TEST(VarintDecodeMany, StopsWhenOutputIsFull) {
+  std::array<std::byte, 12> buffer{};
+  std::array<uint64_t, 3> values{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(DecodeMany(buffer, values, &bytes_read), 3u);
+  EXPECT_EQ(bytes_read, 3u);
+}
+
+TEST(VarintDecodeMany, StopsAtTruncatedVarint) {
+  const auto buffer =
+      MakeBuffer("\x01\x02\xff\xff\xff\xff\xff\xff\xff\xff");
+  std::array<uint64_t, 4> values{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(DecodeMany(buffer, values, &bytes_read), 2u);
+  EXPECT_EQ(bytes_read, 2u);
+  EXPECT_EQ(values[0], 1u);
+  EXPECT_EQ(values[1], 2u);
+}
+
+TEST(VarintDecodeMany, StopsAtOverlongVarint) {
+  std::array<std::byte, 12> buffer;
+  std::memset(buffer.data(), 0x80, buffer.size());
+  buffer.back() = std::byte{0};
+
+  std::array<uint64_t, 4> values{};
+  size_t bytes_read = 0;
+  EXPECT_EQ(DecodeMany(buffer, values, &bytes_read), 0u);
+  EXPECT_EQ(bytes_read, 0u);
+}
+
+TEST(VarintEncodeMany, MatchesEncode) {
+  std::array<std::byte, kManyValues.size() * kMaxVarint64SizeBytes> expected;
+  size_t expected_size = 0;
+  for (uint64_t value : kManyValues) {
+    expected_size += Encode(value, span(expected).subspan(expected_size));
+  }
+
+  std::array<std::byte, kManyValues.size() * kMaxVarint64SizeBytes> buffer;
+  size_t bytes_written = 0;
+  EXPECT_EQ(EncodeMany(kManyValues, buffer, &bytes_written),
+            kManyValues.size());
+  ASSERT_EQ(bytes_written, expected_size);
+  EXPECT_EQ(std::memcmp(buffer.data(), expected.data(), expected_size), 0);
+}
+
+TEST(VarintEncodeMany, StopsWhenValueDoesNotFit) {
+  constexpr std::array<uint64_t, 3> kValues = {1, 0x4000, 2};
+  std::array<std::byte, 3> buffer{};
+  size_t bytes_written = 0;
+  EXPECT_EQ(EncodeMany(kValues, buffer, &bytes_written), 1u);
+  EXPECT_EQ(bytes_written, 1u);
+  EXPECT_EQ(buffer[0], std::byte{1});
+  EXPECT_EQ(buffer[1], std::byte{0});
+}
+
 }  // namespace
 }  // namespace pw::varint
@@ -0,0 +1,81 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/lock_free_work_queue.h"
+
+#include "pw_assert/check.h"
+
+namespace pw::work_queue {
+
+void LockFreeWorkQueue::RequestStop() {
+  stop_requested_.store(true, std::memory_order_release);
+  work_notification_.release();
+}
+
+void LockFreeWorkQueue::Run() {
+  while (true) {
+    work_notification_.acquire();
+
+    // Clear the flag before draining, so that work pushed after the queue is
+    // drained notifies the worker again. Acquiring the flag also makes the
+    // items pushed before it was set visible.
+    notified_.exchange(false, std::memory_order_acq_rel);
+
+    // Update the watermarks for the queue.
+    const uint32_t queue_entries = static_cast<uint32_t>(QueueSize());
+    if (queue_entries > max_queue_used_.value()) {
+      max_queue_used_.Set(queue_entries);
+    }
+    const uint32_t queue_remaining = queue_capacity_ - queue_entries;
+    if (queue_remaining < min_queue_remaining_.value()) {
+      min_queue_remaining_.Set(queue_remaining);
+    }
+
+    // Run every queued item, including any that are pushed in the meantime.
+    while (std::optional<WorkItem> work_item = TryPopItem()) {
+      PW_CHECK(*work_item != nullptr);
+      (*work_item)();
+    }
+
+    // Queue was drained, return if we've been requested to stop.
+    if (stop_requested_.load(std::memory_order_acquire)) {
+      return;
+    }
+  }
+}
+
+void LockFreeWorkQueue::CheckPushWork(WorkItem&& work_item) {
+  PW_CHECK_OK(PushWork(std::move(work_item)),
+              "Failed to push work item into the work queue");
+}
+
+Status LockFreeWorkQueue::PushWork(WorkItem&& work_item) {
+  if (stop_requested_.load(std::memory_order_acquire)) {
+    // Entries are not permitted to be enqueued once stop has been requested.
+    return Status::FailedPrecondition();
+  }
+  if (!TryPushItem(std::move(work_item))) {
+    return Status::ResourceExhausted();
+  }
+  Notify();
+  return OkStatus();
+}
+
+void LockFreeWorkQueue::Notify() {
+  if (!notified_.exchange(true, std::memory_order_acq_rel)) {
+    work_notification_.release();
+  }
+}
+
+}  // namespace pw::work_queue
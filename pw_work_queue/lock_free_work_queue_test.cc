@@ -0,0 +1,78 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_work_queue/lock_free_work_queue.h"
+
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+#include "pw_work_queue/test_thread.h"
+
+namespace pw::work_queue {
+namespace {
+
+TEST(LockFreeWorkQueue, PingPong) {
+  struct {
+    int counter = 0;
+    sync::ThreadNotification worker_ping;
+  } context;
+
+  LockFreeWorkQueueWithBuffer<8> work_queue;
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+
+  // Pick a number bigger than the queue to ensure we loop around.
+  const int kPingPongs = 300;
+
+  for (int i = 0; i < kPingPongs; ++i) {
+    EXPECT_EQ(OkStatus(), work_queue.PushWork([&context] {
+      context.counter++;
+      context.worker_ping.release();
+    }));
+    EXPECT_EQ(OkStatus(), work_queue.PushWork([] {}));
+    context.worker_ping.acquire();
+  }
+
+  work_queue.RequestStop();
+  work_thread.join();
+
+  EXPECT_EQ(context.counter, kPingPongs);
+}
+
+TEST(LockFreeWorkQueue, RunsWorkQueuedBeforeWorkerStarts) {
+  int counter = 0;
+  LockFreeWorkQueueWithBuffer<4> work_queue;
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(OkStatus(), work_queue.PushWork([&counter] { counter++; }));
+  }
+  EXPECT_EQ(Status::ResourceExhausted(), work_queue.PushWork([] {}));
+
+  // A single wakeup runs every queued item.
+  work_queue.RequestStop();
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+  work_thread.join();
+
+  EXPECT_EQ(counter, 4);
+}
+
+TEST(LockFreeWorkQueue, RejectsWorkAfterStop) {
+  LockFreeWorkQueueWithBuffer<4> work_queue;
+  thread::Thread work_thread(test::WorkQueueThreadOptions(), work_queue);
+  work_queue.RequestStop();
+  work_thread.join();
+
+  EXPECT_EQ(Status::FailedPrecondition(), work_queue.PushWork([] {}));
+}
+
+}  // namespace
+}  // namespace pw::work_queue
@@ -0,0 +1,133 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_containers/inline_mpmc_queue.h"
+#include "pw_metric/metric.h"
+#include "pw_status/status.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread_core.h"
+#include "pw_work_queue/work_queue.h"
+
+namespace pw::work_queue {
+
+/// A work queue with the same API as `pw::work_queue::WorkQueue` whose
+/// producers never take a lock.
+///
+/// Work items are stored in a lock-free `pw::InlineMpmcQueue`, so threads and
+/// interrupts may push work concurrently without contending on a spin lock.
+/// Producers only release the worker's notification if the worker has not
+/// already been notified since it last woke up, and the worker runs every
+/// queued item each time it wakes. Under load, many pushes share a single
+/// wakeup.
+///
+/// Construct a `pw::work_queue::LockFreeWorkQueueWithBuffer`, whose capacity
+/// must be a power of two. Like `WorkQueue`, this is a `pw::thread::ThreadCore`
+/// that must run on a single thread.
+class LockFreeWorkQueue : public thread::ThreadCore {
+ public:
+  LockFreeWorkQueue(const LockFreeWorkQueue&) = delete;
+  LockFreeWorkQueue& operator=(const LockFreeWorkQueue&) = delete;
+
+  /// Enqueues a `work_item` for execution by the work queue thread.
+  ///
+  /// @param[in] work_item The entry to enqueue.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Success. Entry was enqueued for execution.
+  ///
+  ///    FAILED_PRECONDITION: The work queue is shutting down. Entries are no
+  ///    longer permitted.
+  ///
+  ///    RESOURCE_EXHAUSTED: Internal work queue is full. Entry was not
+  ///    enqueued.
+  ///
+  /// @endrst
+  Status PushWork(WorkItem&& work_item);
+
+  /// Queues work for execution. Crashes if the work cannot be queued due to a
+  /// full queue or a stopped worker thread.
+  ///
+  /// @param[in] work_item The entry to enqueue.
+  ///
+  /// @pre
+  /// * The queue must not overflow, i.e. be full.
+  /// * The queue must not have been requested to stop, i.e. it must
+  ///   not be in the process of shutting down.
+  void CheckPushWork(WorkItem&& work_item);
+
+  /// Prevents further work from being enqueued, finishes outstanding work,
+  /// then shuts down the worker thread.
+  ///
+  /// Since producers do not take a lock, an item pushed at the same time as
+  /// `RequestStop` is called may be discarded without running.
+  void RequestStop();
+
+ protected:
+  explicit LockFreeWorkQueue(size_t queue_capacity)
+      : stop_requested_(false),
+        notified_(false),
+        queue_capacity_(static_cast<uint32_t>(queue_capacity)) {
+    min_queue_remaining_.Set(queue_capacity_);
+  }
+
+  ~LockFreeWorkQueue() override = default;
+
+ private:
+  void Run() override;
+
+  // Releases the worker's notification, unless it has already been released
+  // since the worker last woke up.
+  void Notify();
+
+  virtual bool TryPushItem(WorkItem&& work_item) = 0;
+  virtual std::optional<WorkItem> TryPopItem() = 0;
+  virtual size_t QueueSize() const = 0;
+
+  std::atomic<bool> stop_requested_;
+  std::atomic<bool> notified_;
+  const uint32_t queue_capacity_;
+  sync::ThreadNotification work_notification_;
+
+  // The queue watermarks are sampled by the worker thread each time it wakes,
+  // since producers do not share a lock to update them.
+  PW_METRIC_GROUP(metrics_, "pw::work_queue::LockFreeWorkQueue");
+  PW_METRIC(metrics_, max_queue_used_, "max_queue_used", 0u);
+  PW_METRIC(metrics_, min_queue_remaining_, "min_queue_remaining", 0u);
+};
+
+template <size_t kWorkQueueEntries>
+class LockFreeWorkQueueWithBuffer final : public LockFreeWorkQueue {
+ public:
+  LockFreeWorkQueueWithBuffer() : LockFreeWorkQueue(kWorkQueueEntries) {}
+
+ private:
+  bool TryPushItem(WorkItem&& work_item) override {
+    return queue_.TryPush(std::move(work_item));
+  }
+  std::optional<WorkItem> TryPopItem() override { return queue_.TryPop(); }
+  size_t QueueSize() const override { return queue_.size(); }
+
+  InlineMpmcQueue<WorkItem, kWorkQueueEntries> queue_;
+};
+
+}  // namespace pw::work_queue